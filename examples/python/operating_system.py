@@ -24,6 +24,17 @@ class PlugIn(object):
                 ]
         return self.threads
     
+    def get_thread_info_changes(self, since_stop_id, stop_id):
+        '''Optional. Return only the threads that changed since the thread
+        info LLDB got at stop "since_stop_id", as a dictionary with the keys
+        'added' and 'changed' (lists of thread dictionaries like the ones
+        get_thread_info() returns) and 'removed' (a list of thread IDs).
+        Return None if that isn't known and get_thread_info() will be
+        called instead. The threads in this example never change.'''
+        if not self.threads:
+            return None
+        return { 'added' : [], 'changed' : [], 'removed' : [] }
+    
     def get_register_info(self):
         if self.registers == None:
             self.registers = dict()            
@@ -13,6 +13,8 @@ class StdListSynthProvider:
 		logger = lldb.formatters.Logger.Logger()
 		self.valobj = valobj
 		self.count = None
+		self.last_index = None
+		self.last_node = None
 		logger >> "Providing synthetic children for a map named " + str(valobj.GetName())
 
 	def next_node(self,node):
@@ -47,18 +49,31 @@ class StdListSynthProvider:
 			slow = self.next_node(slow)
 		return False
 
-	def num_children(self):
+	# when max_count is given, LLDB only needs to know whether there are more
+	# than max_count children, so we stop walking the list there - a count
+	# that hit the limit is not the real size and is not remembered
+	def num_children(self, max_count=None):
 		global _list_capping_size
 		logger = lldb.formatters.Logger.Logger()
-		if self.count == None:
-			self.count = self.num_children_impl()
-			if self.count > _list_capping_size:
-				self.count = _list_capping_size
-		return self.count
-
-	def num_children_impl(self):
+		if self.count != None:
+			if max_count != None and self.count > max_count:
+				return max_count
+			return self.count
+		limit = _list_capping_size
+		if max_count != None and max_count < limit:
+			limit = max_count
+		count = self.num_children_impl(limit)
+		if count > limit:
+			count = limit
+		if count < limit or limit == _list_capping_size:
+			self.count = count
+		return count
+
+	def num_children_impl(self, limit=None):
 		logger = lldb.formatters.Logger.Logger()
 		global _list_capping_size
+		if limit == None:
+			limit = _list_capping_size
 		try:
 			next_val = self.next.GetValueAsUnsigned(0)
 			prev_val = self.prev.GetValueAsUnsigned(0)
@@ -76,8 +91,8 @@ class StdListSynthProvider:
 			while current.GetChildMemberWithName('_M_next').GetValueAsUnsigned(0) != self.node_address:
 				size = size + 1
 				current = current.GetChildMemberWithName('_M_next')
-				if size > _list_capping_size:
-					return _list_capping_size
+				if size > limit:
+					return limit
 			return (size - 1)
 		except:
 			return 0;
@@ -92,16 +107,29 @@ class StdListSynthProvider:
 	def get_child_at_index(self,index):
 		logger = lldb.formatters.Logger.Logger()
 		logger >> "Fetching child " + str(index)
-		if index < 0:
+		global _list_capping_size
+		if index < 0 or index >= _list_capping_size:
 			return None;
-		if index >= self.num_children():
+		if self.count != None and index >= self.count:
 			return None;
 		try:
-			offset = index
-			current = self.next
+			# children are usually fetched in order, one page at a time, so
+			# resume walking from the last node we handed out if we can
+			if self.last_index != None and self.last_index <= index:
+				offset = index - self.last_index
+				current = self.last_node
+			else:
+				offset = index
+				current = self.next
 			while offset > 0:
 				current = current.GetChildMemberWithName('_M_next')
+				if self.value(current) == self.node_address or self.value(current) == 0:
+					return None
 				offset = offset - 1
+			if self.value(current) == self.node_address or self.value(current) == 0:
+				return None
+			self.last_index = index
+			self.last_node = current
 			return current.CreateChildAtOffset('['+str(index)+']',2*current.GetType().GetByteSize(),self.data_type)
 		except:
 			return None
@@ -121,6 +149,8 @@ class StdListSynthProvider:
 		logger = lldb.formatters.Logger.Logger()
 		# preemptively setting this to None - we might end up changing our mind later
 		self.count = None
+		self.last_index = None
+		self.last_node = None
 		try:
 			impl = self.valobj.GetChildMemberWithName('_M_impl')
 			node = impl.GetChildMemberWithName('_M_node')
@@ -233,6 +263,8 @@ class StdMapSynthProvider:
 		logger = lldb.formatters.Logger.Logger()
 		self.valobj = valobj;
 		self.count = None
+		self.last_index = None
+		self.last_node = None
 		logger >> "Providing synthetic children for a map named " + str(valobj.GetName())
 		
 	# we need this function as a temporary workaround for rdar://problem/10801549
@@ -258,6 +290,8 @@ class StdMapSynthProvider:
 		logger = lldb.formatters.Logger.Logger()
 		# preemptively setting this to None - we might end up changing our mind later
 		self.count = None
+		self.last_index = None
+		self.last_node = None
 		try:
 			# we will set this to True if we find out that discovering a node in the map takes more steps than the overall size of the RB tree
 			# if this gets set to True, then we will merrily return None for any child from that moment on
@@ -311,13 +345,16 @@ class StdMapSynthProvider:
 		except:
 			pass
 
-	def num_children(self):
+	# the size of the tree is stored in the map, so max_count only clamps it
+	def num_children(self, max_count=None):
 		global _map_capping_size
 		logger = lldb.formatters.Logger.Logger()
 		if self.count == None:
 			self.count = self.num_children_impl()
 			if self.count > _map_capping_size:
 				self.count = _map_capping_size
+		if max_count != None and self.count > max_count:
+			return max_count
 		return self.count
 
 	def num_children_impl(self):
@@ -350,11 +387,21 @@ class StdMapSynthProvider:
 			logger >> "Returning None since we are a garbage tree"
 			return None
 		try:
-			offset = index
-			current = self.left(self.Mheader);
+			# resume the in-order walk from the last node we handed out
+			# instead of starting over from the leftmost node every time
+			if self.last_index != None and self.last_index <= index:
+				offset = index - self.last_index
+				current = self.last_node
+			else:
+				offset = index
+				current = self.left(self.Mheader);
 			while offset > 0:
 				current = self.increment_node(current)
+				if current == None:
+					return None
 				offset = offset - 1;
+			self.last_index = index
+			self.last_node = current
 			# skip all the base stuff and get at the data
 			return current.CreateChildAtOffset('['+str(index)+']',self.skip_size,self.data_type)
 		except:
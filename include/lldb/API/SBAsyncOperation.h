@@ -0,0 +1,101 @@
+//===-- SBAsyncOperation.h --------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLDB_SBAsyncOperation_h_
+#define LLDB_SBAsyncOperation_h_
+
+#include "lldb/API/SBDefines.h"
+#include "lldb/API/SBError.h"
+#include "lldb/API/SBSymbolContextList.h"
+#include "lldb/API/SBValue.h"
+
+namespace lldb {
+
+//------------------------------------------------------------------
+/// A handle to work that was started on a background thread by one of
+/// the *Async() calls, like SBFrame::EvaluateExpressionAsync().
+///
+/// The results can be used once IsDone() returns true. Copies of a
+/// handle all refer to the same operation.
+//------------------------------------------------------------------
+class SBAsyncOperation
+{
+public:
+    SBAsyncOperation ();
+
+    SBAsyncOperation (const lldb::SBAsyncOperation &rhs);
+
+    ~SBAsyncOperation ();
+
+    const lldb::SBAsyncOperation &
+    operator = (const lldb::SBAsyncOperation &rhs);
+
+    bool
+    IsValid () const;
+
+    bool
+    IsDone () const;
+
+    //------------------------------------------------------------------
+    /// Wait up to \a timeout_usec microseconds for the operation to
+    /// finish, or until it is done if \a timeout_usec is zero. Returns
+    /// true if it is done.
+    //------------------------------------------------------------------
+    bool
+    Wait (uint32_t timeout_usec = 0);
+
+    //------------------------------------------------------------------
+    /// Ask the operation to stop early. It gives up the next time it
+    /// gets somewhere it is safe to, and then finishes with an error.
+    //------------------------------------------------------------------
+    void
+    Cancel ();
+
+    bool
+    IsCancelled () const;
+
+    lldb::SBError
+    GetError () const;
+
+    //------------------------------------------------------------------
+    /// The value fetched by SBValue::FetchAsync() or the result of
+    /// SBFrame::EvaluateExpressionAsync().
+    //------------------------------------------------------------------
+    lldb::SBValue
+    GetValue () const;
+
+    //------------------------------------------------------------------
+    /// The functions found by SBTarget::FindFunctionsAsync(), or one
+    /// symbol context for each frame found by SBThread::GetFramesAsync().
+    //------------------------------------------------------------------
+    lldb::SBSymbolContextList
+    GetSymbolContextList () const;
+
+    //------------------------------------------------------------------
+    /// The number of children of the value for SBValue::FetchAsync(),
+    /// or the number of frames for SBThread::GetFramesAsync().
+    //------------------------------------------------------------------
+    uint32_t
+    GetCount () const;
+
+protected:
+    friend class SBFrame;
+    friend class SBTarget;
+    friend class SBThread;
+    friend class SBValue;
+
+    SBAsyncOperation (const lldb::AsyncOperationSP &op_sp);
+
+private:
+    lldb::AsyncOperationSP m_opaque_sp;
+};
+
+} // namespace lldb
+
+#endif // LLDB_SBAsyncOperation_h_
@@ -0,0 +1,93 @@
+//===-- SBCommandBatch.h ----------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLDB_SBCommandBatch_h_
+#define LLDB_SBCommandBatch_h_
+
+#include "lldb/API/SBDefines.h"
+
+namespace lldb {
+
+//------------------------------------------------------------------
+/// A list of command lines for SBCommandInterpreter::HandleCommandBatch().
+///
+/// A batch that is run over and over only looks up its commands and
+/// splits up their arguments the first time. The status, output and
+/// error text of each command that ran are kept separately. Copies of
+/// a batch all refer to the same list.
+//------------------------------------------------------------------
+class SBCommandBatch
+{
+public:
+    SBCommandBatch ();
+
+    SBCommandBatch (const lldb::SBCommandBatch &rhs);
+
+    ~SBCommandBatch ();
+
+    const lldb::SBCommandBatch &
+    operator = (const lldb::SBCommandBatch &rhs);
+
+    bool
+    IsValid () const;
+
+    void
+    AppendCommand (const char *command_line);
+
+    void
+    AppendCommands (lldb::SBStringList &command_lines);
+
+    uint32_t
+    GetNumCommands () const;
+
+    const char *
+    GetCommandAtIndex (uint32_t idx) const;
+
+    void
+    Clear ();
+
+    //------------------------------------------------------------------
+    /// The number of commands that ran the last time the batch was run.
+    /// The results below are only valid for these.
+    //------------------------------------------------------------------
+    uint32_t
+    GetNumCommandsRun () const;
+
+    lldb::ReturnStatus
+    GetStatusAtIndex (uint32_t idx) const;
+
+    bool
+    SucceededAtIndex (uint32_t idx) const;
+
+    const char *
+    GetOutputAtIndex (uint32_t idx) const;
+
+    const char *
+    GetErrorAtIndex (uint32_t idx) const;
+
+    //------------------------------------------------------------------
+    /// Each command line that ran followed by its output and error
+    /// text, for callers that want it all as text.
+    //------------------------------------------------------------------
+    bool
+    GetDescription (lldb::SBStream &description);
+
+protected:
+    friend class SBCommandInterpreter;
+
+    lldb_private::CommandBatch *
+    get () const;
+
+private:
+    lldb::CommandBatchSP m_opaque_sp;
+};
+
+} // namespace lldb
+
+#endif // LLDB_SBCommandBatch_h_
@@ -75,6 +75,16 @@ public:
     lldb::ReturnStatus
     HandleCommand (const char *command_line, lldb::SBCommandReturnObject &result, bool add_to_history = false);
 
+    //------------------------------------------------------------------
+    /// Run the commands in \a batch in order, keeping the status and
+    /// output of each one in the batch. The commands aren't added to
+    /// the history. Returns the number of commands that ran, which is
+    /// less than the number in the batch if one failed and
+    /// \a stop_on_error is true.
+    //------------------------------------------------------------------
+    uint32_t
+    HandleCommandBatch (lldb::SBCommandBatch &batch, bool stop_on_error = true);
+
     // This interface is not useful in SWIG, since the cursor & last_char arguments are string pointers INTO current_line
     // and you can't do that in a scripting language interface in general... 
     int
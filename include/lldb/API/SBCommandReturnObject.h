@@ -82,6 +82,21 @@ public:
     
     void
     SetImmediateErrorFile (FILE *fh);
+
+    void
+    SetImmediateOutputCallback (lldb::LogOutputCallback log_callback, void *baton);
+
+    //------------------------------------------------------------------
+    /// Only write output to the immediate output file or callback as
+    /// the command produces it, instead of also collecting it for
+    /// GetOutput(). Commands that print a lot show their output right
+    /// away and don't hold on to all of it.
+    //------------------------------------------------------------------
+    void
+    SetStreamOutput (bool stream_output);
+
+    bool
+    GetStreamOutput ();
     
     void
     PutCString(const char* string, int len = -1);
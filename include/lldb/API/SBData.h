@@ -93,6 +93,13 @@ public:
                  void *buf,
                  size_t size);
     
+    // The bytes themselves, without copying them. They stay valid for as
+    // long as this object, or a copy of it, still refers to them. The
+    // Python interface uses this to hand out the data as a read only
+    // memoryview, see GetBuffer() in python-extensions.swig.
+    const void *
+    GetDataBytes ();
+    
     bool
     GetDescription (lldb::SBStream &description, lldb::addr_t base_addr = LLDB_INVALID_ADDRESS);
     
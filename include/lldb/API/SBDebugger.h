@@ -178,6 +178,9 @@ public:
     static const char *
     GetVersionString ();
 
+    static bool
+    GetStatistics (lldb::SBStream &json);
+
     static const char *
     StateAsCString (lldb::StateType state);
 
@@ -25,10 +25,12 @@
 namespace lldb {
 
 class SBAddress;
+class SBAsyncOperation;
 class SBBlock;
 class SBBreakpoint;
 class SBBreakpointLocation;
 class SBBroadcaster;
+class SBCommandBatch;
 class SBCommandInterpreter;
 class SBCommandReturnObject;
 class SBCommunication;
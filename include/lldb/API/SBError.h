@@ -67,6 +67,7 @@ public:
 protected:
 
     friend class SBArguments;
+    friend class SBAsyncOperation;
     friend class SBData;
     friend class SBDebugger;
     friend class SBCommunication;
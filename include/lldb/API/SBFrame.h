@@ -106,6 +106,11 @@ public:
     lldb::SBValue
     EvaluateExpression (const char *expr, lldb::DynamicValueType use_dynamic, bool unwind_on_error);
 
+    /// Evaluate the expression on a background thread. The result is
+    /// the value of the returned operation once it is done.
+    lldb::SBAsyncOperation
+    EvaluateExpressionAsync (const char *expr, lldb::DynamicValueType use_dynamic, bool unwind_on_error);
+
     /// Gets the lexical block that defines the stack frame. Another way to think
     /// of this is it will return the block that contains all of the variables
     /// for a stack frame. Inlined functions are represented as SBBlock objects
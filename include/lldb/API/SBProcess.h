@@ -30,7 +30,8 @@ public:
         eBroadcastBitStateChanged   = (1 << 0),
         eBroadcastBitInterrupt      = (1 << 1),
         eBroadcastBitSTDOUT         = (1 << 2),
-        eBroadcastBitSTDERR         = (1 << 3)
+        eBroadcastBitSTDERR         = (1 << 3),
+        eBroadcastBitProfileData    = (1 << 4)
     };
 
     SBProcess ();
@@ -68,6 +69,36 @@ public:
     size_t
     GetSTDERR (char *dst, size_t dst_len) const;
 
+    //------------------------------------------------------------------
+    /// Write all the STDOUT or STDERR that is currently available to
+    /// \a out in one go, without copying it into a buffer first.
+    ///
+    /// @return
+    ///     The number of bytes written.
+    //------------------------------------------------------------------
+    size_t
+    DrainSTDOUT (FILE *out) const;
+
+    size_t
+    DrainSTDERR (FILE *out) const;
+
+    //------------------------------------------------------------------
+    /// Have the process plug-in sample the process every
+    /// \a interval_usec microseconds while it runs. \a scan_type is a
+    /// mask of lldb::ProfileDataScanType bits that selects the thread
+    /// stacks (up to \a max_frames deep), the thread CPU times and the
+    /// memory usage. Listen for eBroadcastBitProfileData events and read
+    /// the samples with GetAsyncProfileData().
+    //------------------------------------------------------------------
+    lldb::SBError
+    EnableAsyncProfiling (uint32_t interval_usec, uint32_t max_frames, uint32_t scan_type);
+
+    lldb::SBError
+    DisableAsyncProfiling ();
+
+    size_t
+    GetAsyncProfileData (char *dst, size_t dst_len) const;
+
     void
     ReportEventState (const lldb::SBEvent &event, FILE *out) const;
 
@@ -176,6 +207,9 @@ public:
     lldb::addr_t
     ReadPointerFromMemory (addr_t addr, lldb::SBError &error);
 
+    lldb::addr_t
+    FindInMemory (addr_t start_addr, addr_t end_addr, const void *buf, size_t size, lldb::SBError &error);
+
     // Events
     static lldb::StateType
     GetStateFromEvent (const lldb::SBEvent &event);
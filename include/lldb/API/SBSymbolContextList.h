@@ -50,6 +50,7 @@ public:
 
 protected:
 
+    friend class SBAsyncOperation;
     friend class SBModule;
     friend class SBTarget;
 
@@ -158,6 +158,12 @@ public:
     void
     SetIgnoreExisting (bool b);
     
+    bool
+    GetDeferSymbolLoading ();
+    
+    void
+    SetDeferSymbolLoading (bool b);
+    
     uint32_t
     GetResumeCount ();
     
@@ -453,6 +459,30 @@ public:
                    const char *plugin_name,
                    SBError& error);
     
+    //------------------------------------------------------------------
+    /// Load a core file as the process of this target.
+    ///
+    /// @param[in] listener
+    ///     An optional listener that will receive all process events.
+    ///     If \a listener is valid then \a listener will listen to all
+    ///     process events. If not valid, then this target's debugger
+    ///     (SBTarget::GetDebugger()) will listen to all process events.
+    ///
+    /// @param[in] core_file
+    ///     The path to the core file.
+    ///
+    /// @param[out]
+    ///     An error explaining what went wrong if the core file can't
+    ///     be loaded.
+    ///
+    /// @return
+    ///      A process object for the core file.
+    //------------------------------------------------------------------
+    lldb::SBProcess
+    LoadCore (SBListener &listener,
+              const char *core_file,
+              SBError& error);
+    
     lldb::SBFileSpec
     GetExecutable ();
 
@@ -584,6 +614,15 @@ public:
     FindFunctions (const char *name, 
                    uint32_t name_type_mask = lldb::eFunctionNameTypeAny);
 
+    //------------------------------------------------------------------
+    /// Find functions by name on a background thread, the matches are
+    /// in the symbol context list of the returned operation once it is
+    /// done.
+    //------------------------------------------------------------------
+    lldb::SBAsyncOperation
+    FindFunctionsAsync (const char *name, 
+                        uint32_t name_type_mask = lldb::eFunctionNameTypeAny);
+
     //------------------------------------------------------------------
     /// Find global and static variables by name.
     ///
@@ -611,6 +650,37 @@ public:
     ResolveSymbolContextForAddress (const SBAddress& addr, 
                                     uint32_t resolve_scope);
 
+    //------------------------------------------------------------------
+    /// Resolve the symbol contexts for many load addresses at once.
+    ///
+    /// This is much faster than calling ResolveLoadAddress() and
+    /// ResolveSymbolContextForAddress() for each address when there
+    /// are many addresses to symbolicate, like the samples from a
+    /// profiler.
+    ///
+    /// @param[in] array
+    ///     The load addresses to resolve.
+    ///
+    /// @param[in] array_len
+    ///     The number of addresses in \a array.
+    ///
+    /// @param[in] resolve_scope
+    ///     The lldb::SymbolContextItem bits to resolve.
+    ///
+    /// @param[out] sc_list
+    ///     One symbol context is appended for each address, in the same
+    ///     order as \a array.
+    ///
+    /// @return
+    ///     The number of addresses that resolved to a module.
+    //------------------------------------------------------------------
+    uint32_t
+    ResolveLoadAddresses (uint64_t *array,
+                          size_t array_len,
+                          uint32_t resolve_scope,
+                          lldb::SBSymbolContextList &sc_list);
+
+
     lldb::SBBreakpoint
     BreakpointCreateByLocation (const char *file, uint32_t line);
 
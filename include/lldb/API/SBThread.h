@@ -135,6 +135,17 @@ public:
     uint32_t
     GetNumFrames ();
 
+    //------------------------------------------------------------------
+    /// Unwind and symbolicate up to \a max_frames frames, or all of them
+    /// if \a max_frames is zero, on a background thread. The operation
+    /// has a symbol context for each frame once it is done.
+    //------------------------------------------------------------------
+    lldb::SBAsyncOperation
+    GetFramesAsync (uint32_t max_frames);
+
+    uint32_t
+    GetFramePCs (lldb::addr_t *pcs, uint32_t max_pcs);
+
     lldb::SBFrame
     GetFrameAtIndex (uint32_t idx);
 
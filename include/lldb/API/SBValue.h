@@ -203,6 +203,24 @@ public:
                      lldb::DynamicValueType use_dynamic,
                      bool can_create_synthetic);
 
+    //------------------------------------------------------------------
+    /// Get up to \a count children starting at index \a start_idx.
+    ///
+    /// This returns the same values as calling GetChildAtIndex() for
+    /// each index, but only takes the target and process locks once,
+    /// which makes it much cheaper for scripts and synthetic child
+    /// providers that walk large arrays. The list stops early at the
+    /// last child, or at the first index that has no child.
+    //------------------------------------------------------------------
+    lldb::SBValueList
+    GetChildren (uint32_t start_idx, uint32_t count);
+
+    lldb::SBValueList
+    GetChildren (uint32_t start_idx,
+                 uint32_t count,
+                 lldb::DynamicValueType use_dynamic,
+                 bool can_create_synthetic);
+
     // Matches children of this object only and will match base classes and
     // member names if this is a clang typed object.
     uint32_t
@@ -222,6 +240,12 @@ public:
     lldb::SBValue
     GetValueForExpressionPath(const char* expr_path);
     
+    // Reads the value and works out its summary and number of children
+    // on a background thread, so that GetValue(), GetSummary() and
+    // GetNumChildren() don't block once the operation is done
+    lldb::SBAsyncOperation
+    FetchAsync ();
+    
     lldb::SBValue
     AddressOf();
     
@@ -272,6 +296,18 @@ public:
     uint32_t
     GetNumChildren ();
 
+    //------------------------------------------------------------------
+    /// Get the number of children of this value, or \a max if it has
+    /// at least that many.
+    ///
+    /// Synthetic children providers for big containers can stop walking
+    /// the container once they have found \a max children, so this is a
+    /// lot cheaper than GetNumChildren() when only one page of children
+    /// is going to be shown.
+    //------------------------------------------------------------------
+    uint32_t
+    GetNumChildren (uint32_t max);
+
     void *
     GetOpaqueType();
 
@@ -45,6 +45,18 @@ public:
     lldb::SBValue
     FindValueObjectByUID (lldb::user_id_t uid);
 
+    //------------------------------------------------------------------
+    /// Fill in \a values with what SBValue::GetValueAsUnsigned() would
+    /// return for each of the first \a max_values values in the list,
+    /// taking the target and process locks once instead of once for
+    /// each value.
+    ///
+    /// @return
+    ///     The number of values filled in.
+    //------------------------------------------------------------------
+    uint32_t
+    GetValuesAsUnsigned (uint64_t *values, uint32_t max_values, uint64_t fail_value = 0);
+
     const lldb::SBValueList &
     operator = (const lldb::SBValueList &rhs);
 
@@ -128,16 +128,16 @@ public:
         Dump (Stream *s) const;
 
         static lldb::BreakpointEventType
-        GetBreakpointEventTypeFromEvent (const lldb::EventSP &event_sp);
+        GetBreakpointEventTypeFromEvent (const lldb::EventIntrusiveSP &event_sp);
 
         static lldb::BreakpointSP
-        GetBreakpointFromEvent (const lldb::EventSP &event_sp);
+        GetBreakpointFromEvent (const lldb::EventIntrusiveSP &event_sp);
 
         static lldb::BreakpointLocationSP
-        GetBreakpointLocationAtIndexFromEvent (const lldb::EventSP &event_sp, uint32_t loc_idx);
+        GetBreakpointLocationAtIndexFromEvent (const lldb::EventIntrusiveSP &event_sp, uint32_t loc_idx);
         
         static uint32_t
-        GetNumBreakpointLocationsFromEvent (const lldb::EventSP &event_sp);
+        GetNumBreakpointLocationsFromEvent (const lldb::EventIntrusiveSP &event_sp);
 
         static const BreakpointEventData *
         GetEventDataFromEvent (const Event *event_sp);
@@ -173,6 +173,15 @@ public:
     bool
     IsInternal () const;
 
+    //------------------------------------------------------------------
+    /// Tell whether this breakpoint finds its locations by looking up
+    /// function names or source lines in the symbols of each module.
+    /// @return
+    ///     Returns \b true if the resolver does symbol lookups, \b false otherwise.
+    //------------------------------------------------------------------
+    bool
+    ResolvesBySymbolLookup () const;
+
     //------------------------------------------------------------------
     /// Standard "Dump" method.  At present it does nothing.
     //------------------------------------------------------------------
@@ -330,6 +339,25 @@ public:
     bool
     IsEnabled ();
 
+    //------------------------------------------------------------------
+    /// If \a tracepoint is \b true, make this breakpoint a tracepoint.
+    ///
+    /// Hits of a tracepoint are counted and recorded in the target's
+    /// TraceBuffer, and the process is resumed right away without a
+    /// public stop. Conditions, callbacks and commands aren't run for
+    /// tracepoints.
+    //------------------------------------------------------------------
+    void
+    SetTracepoint (bool tracepoint);
+
+    //------------------------------------------------------------------
+    /// Check whether this breakpoint is a tracepoint.
+    /// @return
+    ///     \b true if hits of this breakpoint are only recorded.
+    //------------------------------------------------------------------
+    bool
+    IsTracepoint () const;
+
     //------------------------------------------------------------------
     /// Set the breakpoint to ignore the next \a count breakpoint hits.
     /// @param[in] count
@@ -569,6 +597,7 @@ private:
     // For Breakpoint only
     //------------------------------------------------------------------
     bool m_being_created;
+    bool m_is_tracepoint;                     // Hits are recorded in the target's TraceBuffer instead of stopping.
     Target &m_target;                         // The target that holds this breakpoint.
     lldb::SearchFilterSP m_filter_sp;         // The filter that constrains the breakpoint's domain.
     lldb::BreakpointResolverSP m_resolver_sp; // The resolver that defines this breakpoint.
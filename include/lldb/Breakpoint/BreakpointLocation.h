@@ -93,6 +93,25 @@ public:
     bool
     ShouldStop (StoppointCallbackContext *context);
 
+    //------------------------------------------------------------------
+    /// Count a hit of this location when its breakpoint is a
+    /// tracepoint. Unlike ShouldStop, this doesn't evaluate the
+    /// condition or run the callback.
+    ///
+    /// @return
+    ///     \b true if the hit should be recorded, \b false if this
+    ///     location is disabled or ignoring hits.
+    //------------------------------------------------------------------
+    bool
+    TracepointWasHit ();
+
+    //------------------------------------------------------------------
+    /// Count hits of this location that the remote stub evaluated the
+    /// condition for and didn't stop at.
+    //------------------------------------------------------------------
+    void
+    AddFilteredHits (uint32_t num_hits);
+
     //------------------------------------------------------------------
     // The next section deals with various breakpoint options.
     //------------------------------------------------------------------
@@ -178,6 +197,22 @@ public:
     const char *
     GetConditionText () const;
 
+    //------------------------------------------------------------------
+    /// Evaluate the condition for a hit of this location.
+    ///
+    /// @param[in] exe_ctx
+    ///    The execution context of the hit.
+    ///
+    /// @param[out] error
+    ///    Set to an error if the condition couldn't be parsed or run.
+    ///
+    /// @return
+    ///    \b false if the condition says we shouldn't stop, \b true
+    ///    otherwise.
+    //------------------------------------------------------------------
+    bool
+    ConditionSaysStop (ExecutionContext &exe_ctx, Error &error);
+
 
     //------------------------------------------------------------------
     /// Set the valid thread to be checked when the breakpoint is hit.
@@ -227,12 +262,18 @@ public:
     /// Clear this breakpoint location's breakpoint site - for instance
     /// when disabling the breakpoint.
     ///
+    /// @param[in] unowned_sites
+    ///     If not NULL, a site that has no owners left once this location
+    ///     is removed from it is added to this list instead of being
+    ///     disabled and removed right away, so the caller can hand many
+    ///     of them to Process::RemoveUnownedBreakpointSites() at once.
+    ///
     /// @return
     ///     \b true if there was a breakpoint site to be cleared, \b false
     ///     otherwise.
     //------------------------------------------------------------------
     bool
-    ClearBreakpointSite ();
+    ClearBreakpointSite (BreakpointSiteList *unowned_sites = NULL);
 
     //------------------------------------------------------------------
     /// Return whether this breakpoint location has a breakpoint site.
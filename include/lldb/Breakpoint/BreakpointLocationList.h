@@ -149,6 +149,17 @@ public:
     void
     ResolveAllBreakpointSites ();
 
+    //------------------------------------------------------------------
+    /// Resolve the breakpoint sites of the locations in \a bp_locs, which
+    /// must belong to this list, all at once so the process can enable
+    /// the new sites together.
+    ///
+    /// @result
+    ///     The number of locations that have a breakpoint site afterwards.
+    //------------------------------------------------------------------
+    size_t
+    ResolveBreakpointSites (const BreakpointLocationCollection &bp_locs);
+
     //------------------------------------------------------------------
     /// Returns the number of breakpoint locations in this list with
     /// resolved breakpoints.
@@ -12,6 +12,7 @@
 
 // C Includes
 // C++ Includes
+#include <map>
 #include <memory>
 // Other libraries and framework includes
 // Project includes
@@ -145,7 +146,7 @@ public:
     /// @return
     ///     The synchronicity of our callback.
     //------------------------------------------------------------------
-    bool IsCallbackSynchronous () {
+    bool IsCallbackSynchronous () const {
         return m_callback_is_synchronous;
     }
     
@@ -184,6 +185,34 @@ public:
     //     condition has been set.
     //------------------------------------------------------------------
     const char *GetConditionText () const;
+
+    //------------------------------------------------------------------
+    /// Evaluate the condition expression in \a exe_ctx.
+    ///
+    /// Conditions that have to be JIT compiled are only parsed once for
+    /// each block they are evaluated in, and later hits in that block,
+    /// from any location that uses these options, run the same code
+    /// again. Conditions that the IR interpreter can evaluate don't
+    /// need any code in the inferior, but they are parsed for every
+    /// hit since the interpreter computes them while parsing.
+    ///
+    /// @param[in] exe_ctx
+    ///    The execution context of the breakpoint hit.
+    ///
+    /// @param[out] error
+    ///    Set to an error if the condition couldn't be parsed or run.
+    ///
+    /// @return
+    ///    \b false if the condition is false, \b true if it is true or
+    ///    couldn't be evaluated, or if there is no condition.
+    //------------------------------------------------------------------
+    bool ConditionSaysStop (ExecutionContext &exe_ctx, Error &error);
+
+    //------------------------------------------------------------------
+    /// Throw away the compiled copies of the condition, for instance
+    /// because the process they were compiled for is going away.
+    //------------------------------------------------------------------
+    void ClearConditionCache ();
     
     //------------------------------------------------------------------
     // Enabled/Ignore Count
@@ -248,7 +277,7 @@ public:
     /// Returns true if the breakpoint option has a callback set.
     //------------------------------------------------------------------
     bool
-    HasCallback();
+    HasCallback() const;
 
     //------------------------------------------------------------------
     /// This is the default empty callback.
@@ -318,6 +347,14 @@ private:
     std::auto_ptr<ThreadSpec> m_thread_spec_ap; // Thread for which this breakpoint will take
     std::auto_ptr<ClangUserExpression> m_condition_ap;  // The condition to test.
 
+    struct CachedCondition
+    {
+        lldb::ModuleWP module_wp; // The module of the block the condition was compiled for
+        STD_SHARED_PTR(ClangUserExpression) expr_sp;
+    };
+    typedef std::map<const void *, CachedCondition> ConditionCache;
+    ConditionCache m_condition_cache; // Compiled copies of the condition, keyed by the block (or function or symbol) they were compiled in
+
 };
 
 } // namespace lldb_private
@@ -12,9 +12,14 @@
 
 // C Includes
 // C++ Includes
+#include <map>
+#include <vector>
+
 // Other libraries and framework includes
 // Project includes
 #include "lldb/Breakpoint/BreakpointResolver.h"
+#include "lldb/Host/FileSpec.h"
+#include "lldb/Host/TimeValue.h"
 
 namespace lldb_private {
 
@@ -57,7 +62,35 @@ public:
 
 protected:
     friend class Breakpoint;
+
+    //------------------------------------------------------------------
+    // The lines of a source file that match m_regex. Breakpoints get
+    // resolved again every time a module is loaded, and many compile
+    // units can share a header, so each file is only searched once
+    // unless it changes on disk.
+    //------------------------------------------------------------------
+    struct FileMatches
+    {
+        FileMatches () :
+            mod_time (),
+            end_line (1),
+            match_lines ()
+        {
+        }
+
+        TimeValue mod_time;
+        uint32_t end_line;                  // The lines before this one have been searched
+        std::vector<uint32_t> match_lines;  // Sorted matching line numbers
+    };
+    typedef std::map<FileSpec, FileMatches> FileMatchesMap;
+
+    const std::vector<uint32_t> &
+    GetMatchingLines (SourceManager &source_manager,
+                      FileSpec &file_spec,
+                      uint32_t end_line);
+
     RegularExpression m_regex; // This is the line expression that we are looking for.
+    FileMatchesMap m_file_matches;
 
 private:
     DISALLOW_COPY_AND_ASSIGN(BreakpointResolverFileRegex);
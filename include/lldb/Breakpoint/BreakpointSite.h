@@ -141,6 +141,42 @@ public:
     virtual bool
     ShouldStop (StoppointCallbackContext *context);
 
+    //------------------------------------------------------------------
+    /// Tells whether all the breakpoint locations at this site belong
+    /// to tracepoints, so that hits of this site are recorded instead
+    /// of stopping.
+    ///
+    /// @return
+    ///    \b true if this site has owners and they are all tracepoints,
+    ///    \b false otherwise.
+    //------------------------------------------------------------------
+    bool
+    IsTracepointSite ();
+
+    //------------------------------------------------------------------
+    /// Count a hit of this site and of its tracepoint locations. This
+    /// is called instead of ShouldStop for tracepoint sites, and
+    /// doesn't run any conditions or callbacks.
+    ///
+    /// @param[out] loc_sp
+    ///    Filled in with the first location that wants this hit
+    ///    recorded.
+    ///
+    /// @return
+    ///    \b true if any location is enabled and past its ignore
+    ///    count, \b false otherwise.
+    //------------------------------------------------------------------
+    bool
+    TracepointWasHit (lldb::BreakpointLocationSP &loc_sp);
+
+    //------------------------------------------------------------------
+    /// Count hits of this site that the remote stub evaluated the
+    /// conditions for and didn't stop at. Every location counts them,
+    /// like they do in ShouldStop.
+    //------------------------------------------------------------------
+    void
+    AddFilteredHits (uint32_t num_hits);
+
     //------------------------------------------------------------------
     /// Standard Dump method
     ///
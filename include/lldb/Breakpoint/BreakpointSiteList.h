@@ -13,7 +13,9 @@
 // C Includes
 // C++ Includes
 #include <map>
+#include <vector>
 // Other libraries and framework includes
+#include "llvm/ADT/DenseMap.h"
 // Project includes
 #include "lldb/Breakpoint/BreakpointSite.h"
 
@@ -204,6 +206,17 @@ public:
     bool
     ShouldStop (StoppointCallbackContext *context, lldb::break_id_t breakID);
 
+    //------------------------------------------------------------------
+    /// Append all of the breakpoint sites in this list, in address
+    /// order, to \a bp_sites. This is much cheaper than calling
+    /// GetByIndex() for each site.
+    ///
+    /// @return
+    ///     The number of sites that were appended.
+    //------------------------------------------------------------------
+    size_t
+    GetSites (std::vector<lldb::BreakpointSiteSP> &bp_sites) const;
+
     //------------------------------------------------------------------
     /// Returns the number of elements in the list.
     ///
@@ -229,7 +242,21 @@ protected:
     const collection *
     GetMap ();
 
+    // Hash tables over the sites in m_bp_site_list. Finding the site at
+    // the PC of a stopped thread, or the site with a given ID, happens on
+    // every stop, so those lookups shouldn't have to walk the map.
+    typedef llvm::DenseMap<lldb::addr_t, lldb::BreakpointSiteSP> addr_index;
+    typedef llvm::DenseMap<lldb::break_id_t, lldb::BreakpointSiteSP> id_index;
+
+    void
+    AddToIndexes (const lldb::BreakpointSiteSP &bp_site_sp);
+
+    void
+    RemoveFromIndexes (const lldb::BreakpointSiteSP &bp_site_sp);
+
     collection m_bp_site_list;  // The breakpoint site list.
+    addr_index m_addr_index;    // The sites in m_bp_site_list by load address
+    id_index m_id_index;        // The sites in m_bp_site_list by ID
 };
 
 } // namespace lldb_private
@@ -63,6 +63,8 @@ public:
     // Snapshot management interface.
     bool        IsWatchVariable() const;
     void        SetWatchVariable(bool val);
+    lldb::Encoding GetWatchVariableEncoding() const;
+    void        SetWatchVariableEncoding (lldb::Encoding encoding);
     std::string GetOldSnapshot() const;
     void        SetOldSnapshot (const std::string &str);
     std::string GetNewSnapshot() const;
@@ -170,6 +172,7 @@ private:
     bool        m_enabled;             // Is this watchpoint enabled
     bool        m_is_hardware;         // Is this a hardware watchpoint
     bool        m_is_watch_variable;   // True if set via 'watchpoint set variable'.
+    lldb::Encoding m_watch_variable_encoding; // eEncodingSint or eEncodingUint if the watched variable is an integer.
     bool        m_is_ephemeral;        // True if the watchpoint is in the ephemeral mode, meaning that it is
                                        // undergoing a pair of temporary disable/enable actions to avoid recursively
                                        // triggering further watchpoint events.
@@ -0,0 +1,143 @@
+//===-- AsyncOperation.h ----------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_AsyncOperation_h_
+#define liblldb_AsyncOperation_h_
+
+// C Includes
+// C++ Includes
+// Other libraries and framework includes
+// Project includes
+#include "lldb/lldb-private.h"
+#include "lldb/Core/Error.h"
+#include "lldb/Host/Predicate.h"
+#include "lldb/Symbol/SymbolContext.h"
+
+namespace lldb_private {
+
+//----------------------------------------------------------------------
+/// @class AsyncOperation AsyncOperation.h "lldb/Core/AsyncOperation.h"
+/// @brief A piece of work that runs on its own thread and can be
+/// cancelled while it runs.
+///
+/// Subclasses do the work in DoExecute() and leave what they found in
+/// the result members. Clients that can't block, like an IDE that wants
+/// to keep its UI responsive, poll IsDone() or Wait() for the results.
+///
+/// Cancelling is cooperative: Cancel() only sets a flag, and the work
+/// stops the next time it reaches a place where it is safe to give up,
+/// which checks for it with AsyncOperation::ShouldCancel(). Work that
+/// isn't running on an operation's thread never gets cancelled.
+//----------------------------------------------------------------------
+class AsyncOperation :
+    public STD_ENABLE_SHARED_FROM_THIS(AsyncOperation)
+{
+public:
+    AsyncOperation ();
+
+    virtual
+    ~AsyncOperation ();
+
+    //------------------------------------------------------------------
+    /// Start DoExecute() on a new thread. The thread keeps a reference
+    /// to this object until it is done, so it must be owned by an
+    /// lldb::AsyncOperationSP.
+    ///
+    /// @return
+    ///     False if the thread couldn't be made, in which case the
+    ///     operation is done with an error.
+    //------------------------------------------------------------------
+    bool
+    Start ();
+
+    void
+    Cancel ();
+
+    bool
+    IsCancelled () const
+    {
+        return m_cancelled != 0;
+    }
+
+    bool
+    IsDone () const
+    {
+        return m_done.GetValue();
+    }
+
+    //------------------------------------------------------------------
+    /// Wait for the operation to finish.
+    ///
+    /// @param[in] timeout_usec
+    ///     How long to wait, or zero to wait until it is done.
+    ///
+    /// @return
+    ///     True if it is done.
+    //------------------------------------------------------------------
+    bool
+    Wait (uint32_t timeout_usec);
+
+    //------------------------------------------------------------------
+    /// The results, which can only be used once IsDone() returns true.
+    //------------------------------------------------------------------
+    const Error &
+    GetError () const
+    {
+        return m_error;
+    }
+
+    const lldb::ValueObjectSP &
+    GetValueObject () const
+    {
+        return m_valobj_sp;
+    }
+
+    const SymbolContextList &
+    GetSymbolContextList () const
+    {
+        return m_sc_list;
+    }
+
+    uint32_t
+    GetCount () const
+    {
+        return m_count;
+    }
+
+    //------------------------------------------------------------------
+    /// Returns true if the current thread is running an operation that
+    /// was cancelled. Long running code calls this at points where it
+    /// can stop early and still leave everything it touched in a good
+    /// state.
+    //------------------------------------------------------------------
+    static bool
+    ShouldCancel ();
+
+protected:
+    virtual void
+    DoExecute () = 0;
+
+    Error m_error;
+    lldb::ValueObjectSP m_valobj_sp;
+    SymbolContextList m_sc_list;
+    uint32_t m_count;
+
+private:
+    static void *
+    ThreadFunction (void *arg);
+
+    Predicate<bool> m_done;
+    volatile uint32_t m_cancelled;
+
+    DISALLOW_COPY_AND_ASSIGN (AsyncOperation);
+};
+
+} // namespace lldb_private
+
+#endif  // liblldb_AsyncOperation_h_
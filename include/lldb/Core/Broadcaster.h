@@ -22,6 +22,8 @@
 //#include "lldb/Core/Flags.h"
 #include "lldb/Core/ConstString.h"
 #include "lldb/Core/Listener.h"
+#include "lldb/Host/Condition.h"
+#include "lldb/Host/Mutex.h"
 
 namespace lldb_private {
 
@@ -277,10 +279,10 @@ public:
     ///
     //------------------------------------------------------------------
     void
-    BroadcastEvent (lldb::EventSP &event_sp);
+    BroadcastEvent (lldb::EventIntrusiveSP &event_sp);
 
     void
-    BroadcastEventIfUnique (lldb::EventSP &event_sp);
+    BroadcastEventIfUnique (lldb::EventIntrusiveSP &event_sp);
 
     void
     BroadcastEvent (uint32_t event_type, EventData *event_data = NULL);
@@ -438,12 +440,38 @@ protected:
 
     
     void
-    PrivateBroadcastEvent (lldb::EventSP &event_sp, bool unique);
+    PrivateBroadcastEvent (lldb::EventIntrusiveSP &event_sp, bool unique);
 
     //------------------------------------------------------------------
     // Classes that inherit from Broadcaster can see and modify these
     //------------------------------------------------------------------
     typedef std::vector< std::pair<Listener*,uint32_t> > collection;
+
+    //------------------------------------------------------------------
+    // An immutable copy of the listeners, which is what events are
+    // broadcast to so that broadcasting doesn't need m_listeners_mutex.
+    // A new one is published whenever the listeners or the hijacking
+    // listener change, and the old one is deleted once no broadcast is
+    // using it anymore, so once a listener has been removed it will not
+    // be sent any more events.
+    //------------------------------------------------------------------
+    struct ListenerSnapshot
+    {
+        collection listeners;
+        Listener *hijacking_listener;
+        uint32_t hijacking_mask;
+    };
+
+    // Must be called with m_listeners_mutex locked
+    void
+    UpdateListenerSnapshot ();
+
+    ListenerSnapshot *
+    AcquireListenerSnapshot ();
+
+    void
+    ReleaseListenerSnapshot ();
+
     typedef std::map<uint32_t, std::string> event_names_map;
     // Prefix the name of our member variables with "m_broadcaster_"
     // since this is a class that gets subclassed.
@@ -454,6 +482,11 @@ protected:
     std::vector<Listener *> m_hijacking_listeners;  // A simple mechanism to intercept events from a broadcaster 
     std::vector<uint32_t> m_hijacking_masks;        // At some point we may want to have a stack or Listener
                                                     // collections, but for now this is just for private hijacking.
+    ListenerSnapshot * volatile m_listener_snapshot;    ///< What PrivateBroadcastEvent() sends events to.
+    volatile uint32_t m_listener_snapshot_readers;      ///< How many threads are using \a m_listener_snapshot.
+    volatile uint32_t m_listener_snapshot_waiters;      ///< How many threads are waiting for the readers to finish.
+    Mutex m_listener_snapshot_mutex;                    ///< Only taken when a thread has to wait for the readers.
+    Condition m_listener_snapshot_condition;            ///< Signaled when the last reader finishes while someone waits.
     BroadcasterManager *m_manager;
     
 private:
@@ -10,7 +10,11 @@
 #ifndef liblldb_CXXFormatterFunctions_h_
 #define liblldb_CXXFormatterFunctions_h_
 
+#include <vector>
+
 #include "lldb/lldb-forward.h"
+#include "lldb/Core/FormatClasses.h"
+#include "lldb/Symbol/ClangASTType.h"
 #ifdef _MSC_VER
 typedef unsigned __int64 uint64_t;
 #endif
@@ -54,6 +58,204 @@ namespace lldb_private {
         template bool
         NSData_SummaryProvider<false> (ValueObject&, Stream&) ;
         
+        //----------------------------------------------------------------------
+        // Synthetic children for the common C++ containers. These read the
+        // container's storage out of the process directly instead of making
+        // SBValue calls from Python for every child.
+        //----------------------------------------------------------------------
+        
+        // std::vector, whose elements live between a start and a finish pointer
+        class StdVectorSyntheticFrontEnd : public SyntheticChildrenFrontEnd
+        {
+        public:
+            StdVectorSyntheticFrontEnd (lldb::ValueObjectSP valobj_sp);
+            
+            virtual
+            ~StdVectorSyntheticFrontEnd ();
+            
+            virtual uint32_t
+            CalculateNumChildren ();
+            
+            virtual lldb::ValueObjectSP
+            GetChildAtIndex (uint32_t idx, bool can_create);
+            
+            virtual uint32_t
+            GetIndexOfChildWithName (const ConstString &name);
+            
+        protected:
+            void
+            Clear ();
+            
+            // Called by subclasses from Update() with the values of the
+            // pointers to the first element and past the last element
+            void
+            SetStorage (const lldb::ValueObjectSP &start_sp,
+                        const lldb::ValueObjectSP &finish_sp);
+            
+            lldb::addr_t m_start;
+            lldb::addr_t m_finish;
+            ClangASTType m_element_type;
+            uint32_t m_element_size;
+            lldb::addr_t m_prefetched_start;    // The storage we last read ahead
+            lldb::addr_t m_prefetched_end;
+            
+        private:
+            DISALLOW_COPY_AND_ASSIGN(StdVectorSyntheticFrontEnd);
+        };
+        
+        class LibstdcppVectorSyntheticFrontEnd : public StdVectorSyntheticFrontEnd
+        {
+        public:
+            LibstdcppVectorSyntheticFrontEnd (lldb::ValueObjectSP valobj_sp);
+            
+            virtual bool
+            Update ();
+        };
+        
+        class LibcxxVectorSyntheticFrontEnd : public StdVectorSyntheticFrontEnd
+        {
+        public:
+            LibcxxVectorSyntheticFrontEnd (lldb::ValueObjectSP valobj_sp);
+            
+            virtual bool
+            Update ();
+        };
+        
+        // std::list, a circular doubly linked list of nodes around a sentinel
+        class StdListSyntheticFrontEnd : public SyntheticChildrenFrontEnd
+        {
+        public:
+            StdListSyntheticFrontEnd (lldb::ValueObjectSP valobj_sp);
+            
+            virtual
+            ~StdListSyntheticFrontEnd ();
+            
+            virtual uint32_t
+            CalculateNumChildren ();
+            
+            virtual uint32_t
+            CalculateNumChildrenUpTo (uint32_t max);
+            
+            virtual lldb::ValueObjectSP
+            GetChildAtIndex (uint32_t idx, bool can_create);
+            
+            virtual uint32_t
+            GetIndexOfChildWithName (const ConstString &name);
+            
+        protected:
+            void
+            Clear ();
+            
+            // Walk the list until we know the address of the node at "idx",
+            // returns false if the list has fewer nodes than that
+            bool
+            FindNodes (uint32_t idx);
+            
+            lldb::addr_t m_sentinel;        // The node that the list starts and ends with
+            lldb::addr_t m_first;           // The first node that holds a value
+            uint32_t m_next_offset;         // Offset of the "next" pointer in a node
+            uint32_t m_value_offset;        // Offset of the value in a node
+            ClangASTType m_element_type;
+            std::vector<lldb::addr_t> m_nodes;  // The nodes we walked through so far
+            bool m_found_end;
+            
+        private:
+            DISALLOW_COPY_AND_ASSIGN(StdListSyntheticFrontEnd);
+        };
+        
+        class LibstdcppListSyntheticFrontEnd : public StdListSyntheticFrontEnd
+        {
+        public:
+            LibstdcppListSyntheticFrontEnd (lldb::ValueObjectSP valobj_sp);
+            
+            virtual bool
+            Update ();
+        };
+        
+        class LibcxxListSyntheticFrontEnd : public StdListSyntheticFrontEnd
+        {
+        public:
+            LibcxxListSyntheticFrontEnd (lldb::ValueObjectSP valobj_sp);
+            
+            virtual bool
+            Update ();
+        };
+        
+        // std::map, a red-black tree whose nodes are visited in order
+        class StdMapSyntheticFrontEnd : public SyntheticChildrenFrontEnd
+        {
+        public:
+            StdMapSyntheticFrontEnd (lldb::ValueObjectSP valobj_sp);
+            
+            virtual
+            ~StdMapSyntheticFrontEnd ();
+            
+            virtual uint32_t
+            CalculateNumChildren ();
+            
+            virtual lldb::ValueObjectSP
+            GetChildAtIndex (uint32_t idx, bool can_create);
+            
+            virtual uint32_t
+            GetIndexOfChildWithName (const ConstString &name);
+            
+        protected:
+            void
+            Clear ();
+            
+            // Find the in-order successor of "node", or return
+            // LLDB_INVALID_ADDRESS if the tree doesn't look sane
+            lldb::addr_t
+            GetNextNode (lldb::addr_t node);
+            
+            lldb::addr_t m_begin;           // The leftmost node of the tree
+            uint32_t m_count;
+            uint32_t m_left_offset;         // Offsets of the links in a node
+            uint32_t m_right_offset;
+            uint32_t m_parent_offset;
+            uint32_t m_value_offset;        // Offset of the value in a node
+            ClangASTType m_element_type;
+            std::vector<lldb::addr_t> m_nodes;  // The nodes we walked through so far
+            
+        private:
+            DISALLOW_COPY_AND_ASSIGN(StdMapSyntheticFrontEnd);
+        };
+        
+        class LibstdcppMapSyntheticFrontEnd : public StdMapSyntheticFrontEnd
+        {
+        public:
+            LibstdcppMapSyntheticFrontEnd (lldb::ValueObjectSP valobj_sp);
+            
+            virtual bool
+            Update ();
+        };
+        
+        class LibcxxMapSyntheticFrontEnd : public StdMapSyntheticFrontEnd
+        {
+        public:
+            LibcxxMapSyntheticFrontEnd (lldb::ValueObjectSP valobj_sp);
+            
+            virtual bool
+            Update ();
+        };
+        
+        SyntheticChildrenFrontEnd*
+        LibstdcppVectorSyntheticFrontEndCreator (CXXSyntheticChildren*, lldb::ValueObjectSP);
+        
+        SyntheticChildrenFrontEnd*
+        LibstdcppListSyntheticFrontEndCreator (CXXSyntheticChildren*, lldb::ValueObjectSP);
+        
+        SyntheticChildrenFrontEnd*
+        LibstdcppMapSyntheticFrontEndCreator (CXXSyntheticChildren*, lldb::ValueObjectSP);
+        
+        SyntheticChildrenFrontEnd*
+        LibcxxVectorSyntheticFrontEndCreator (CXXSyntheticChildren*, lldb::ValueObjectSP);
+        
+        SyntheticChildrenFrontEnd*
+        LibcxxListSyntheticFrontEndCreator (CXXSyntheticChildren*, lldb::ValueObjectSP);
+        
+        SyntheticChildrenFrontEnd*
+        LibcxxMapSyntheticFrontEndCreator (CXXSyntheticChildren*, lldb::ValueObjectSP);
     }
 }
 
@@ -351,12 +351,38 @@ protected:
     lldb::thread_t m_read_thread; ///< The read thread handle in case we need to cancel the thread.
     bool m_read_thread_enabled;
     std::string m_bytes;    ///< A buffer to cache bytes read in the ReadThread function.
+    size_t m_bytes_pos;     ///< The offset in \a m_bytes of the first byte that hasn't been consumed.
     Mutex m_bytes_mutex;    ///< A mutex to protect multi-threaded access to the cached bytes.
     Mutex m_write_mutex;    ///< Don't let multiple threads write at the same time...
     ReadThreadBytesReceived m_callback;
     void *m_callback_baton;
     bool m_close_on_eof;
 
+    //------------------------------------------------------------------
+    // The cached bytes are consumed by moving \a m_bytes_pos forward,
+    // the consumed bytes at the front of \a m_bytes are only dropped
+    // once they make up half of it so consuming many small pieces of a
+    // large read doesn't move the rest of it every time. These must be
+    // called with \a m_bytes_mutex locked.
+    //------------------------------------------------------------------
+    size_t
+    GetNumCachedBytes () const
+    {
+        return m_bytes.size() - m_bytes_pos;
+    }
+
+    const char *
+    GetCachedBytesStart () const
+    {
+        return m_bytes.data() + m_bytes_pos;
+    }
+
+    void
+    AppendCachedBytes (const void *src, size_t src_len);
+
+    void
+    ConsumeCachedBytes (size_t len);
+
     size_t
     ReadFromConnection (void *dst, 
                         size_t dst_len, 
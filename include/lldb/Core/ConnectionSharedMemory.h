@@ -12,21 +12,39 @@
 
 // C Includes
 // C++ Includes
-#include <string>
+#include <memory>
 
 // Other libraries and framework includes
 // Project includes
 #include "lldb/Core/Connection.h"
-#include "lldb/Core/DataBufferMemoryMap.h"
+#include "lldb/Host/Mutex.h"
+#include "Utility/SharedMemoryTransport.h"
 
 namespace lldb_private {
 
+//----------------------------------------------------------------------
+/// @class ConnectionSharedMemory ConnectionSharedMemory.h "lldb/Core/ConnectionSharedMemory.h"
+/// @brief A connection to a process on the same host that moves its
+/// bytes through shared memory.
+///
+/// It starts out passing everything through to the connection it was
+/// made with. Once the process on the other end has mapped the region
+/// made by Create(), Activate() switches the bytes over to the shared
+/// memory rings and the first connection is only used to wake up the
+/// other side when it is waiting for bytes, and to notice when it goes
+/// away. See SharedMemoryTransport for how the rings work.
+//----------------------------------------------------------------------
 class ConnectionSharedMemory :
     public Connection
 {
 public:
 
-    ConnectionSharedMemory ();
+    //------------------------------------------------------------------
+    /// @param[in] connection
+    ///     The connection to the other process, this object takes
+    ///     ownership of it.
+    //------------------------------------------------------------------
+    ConnectionSharedMemory (Connection *connection);
 
     virtual
     ~ConnectionSharedMemory ();
@@ -34,9 +52,6 @@ public:
     virtual bool
     IsConnected () const;
 
-    virtual lldb::ConnectionStatus
-    BytesAvailable (uint32_t timeout_usec, Error *error_ptr);
-
     virtual lldb::ConnectionStatus
     Connect (const char *s, Error *error_ptr);
 
@@ -44,23 +59,57 @@ public:
     Disconnect (Error *error_ptr);
 
     virtual size_t
-    Read (void *dst, 
-          size_t dst_len, 
+    Read (void *dst,
+          size_t dst_len,
           uint32_t timeout_usec,
-          lldb::ConnectionStatus &status, 
+          lldb::ConnectionStatus &status,
           Error *error_ptr);
 
     virtual size_t
     Write (const void *src, size_t src_len, lldb::ConnectionStatus &status, Error *error_ptr);
 
-    lldb::ConnectionStatus
-    Open (bool create, const char *name, size_t size, Error *error_ptr);
+    //------------------------------------------------------------------
+    /// Make the shared memory region with a ring of \a ring_size bytes
+    /// for each direction. Bytes still go over the first connection
+    /// until Activate() is called.
+    //------------------------------------------------------------------
+    bool
+    Create (size_t ring_size, Error *error_ptr);
+
+    //------------------------------------------------------------------
+    /// The name the other process opens the region with.
+    //------------------------------------------------------------------
+    const char *
+    GetName () const
+    {
+        return m_transport.GetName();
+    }
+
+    //------------------------------------------------------------------
+    /// Start moving bytes through shared memory, once the other process
+    /// has the region mapped and nothing more is coming the old way.
+    //------------------------------------------------------------------
+    void
+    Activate ();
+
+    //------------------------------------------------------------------
+    /// Throw the region away and keep using the first connection.
+    //------------------------------------------------------------------
+    void
+    Abandon ();
+
+    bool
+    IsActive () const
+    {
+        return m_active;
+    }
 
 protected:
 
-    std::string m_name;
-    int m_fd;    // One buffer that contains all we need
-    DataBufferMemoryMap m_mmap;
+    std::auto_ptr<Connection> m_connection_ap;
+    SharedMemoryTransport m_transport;
+    Mutex m_write_mutex;
+    bool m_active;
 private:
     DISALLOW_COPY_AND_ASSIGN (ConnectionSharedMemory);
 };
@@ -0,0 +1,90 @@
+//===-- ConnectionSimulatedLink.h -------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_ConnectionSimulatedLink_h_
+#define liblldb_ConnectionSimulatedLink_h_
+
+// C Includes
+// C++ Includes
+#include <memory>
+
+// Other libraries and framework includes
+// Project includes
+#include "lldb/Core/Connection.h"
+
+namespace lldb_private {
+
+//----------------------------------------------------------------------
+/// @class ConnectionSimulatedLink ConnectionSimulatedLink.h "lldb/Core/ConnectionSimulatedLink.h"
+/// @brief A connection that makes another connection look like it goes
+/// over a slow network.
+///
+/// Every write is held back by the latency, and reads and writes both
+/// take as long as their bytes would need at the bandwidth. This lets
+/// the effect of features like packet pipelining and compression on a
+/// far away device be measured against a local debug server.
+//----------------------------------------------------------------------
+class ConnectionSimulatedLink :
+    public Connection
+{
+public:
+
+    //------------------------------------------------------------------
+    /// @param[in] connection
+    ///     The connection to slow down, this object takes ownership
+    ///     of it.
+    ///
+    /// @param[in] latency_usec
+    ///     The number of microseconds added to each write, which is
+    ///     the round trip time each packet exchange pays.
+    ///
+    /// @param[in] bytes_per_second
+    ///     The bandwidth of the link, or zero for no limit.
+    //------------------------------------------------------------------
+    ConnectionSimulatedLink (Connection *connection,
+                             uint32_t latency_usec,
+                             uint64_t bytes_per_second);
+
+    virtual
+    ~ConnectionSimulatedLink ();
+
+    virtual bool
+    IsConnected () const;
+
+    virtual lldb::ConnectionStatus
+    Connect (const char *s, Error *error_ptr);
+
+    virtual lldb::ConnectionStatus
+    Disconnect (Error *error_ptr);
+
+    virtual size_t
+    Read (void *dst, 
+          size_t dst_len, 
+          uint32_t timeout_usec,
+          lldb::ConnectionStatus &status, 
+          Error *error_ptr);
+
+    virtual size_t
+    Write (const void *src, size_t src_len, lldb::ConnectionStatus &status, Error *error_ptr);
+
+protected:
+
+    void
+    SleepForBytes (size_t num_bytes);
+
+    std::auto_ptr<Connection> m_connection_ap;
+    uint32_t m_latency_usec;
+    uint64_t m_bytes_per_second;
+private:
+    DISALLOW_COPY_AND_ASSIGN (ConnectionSimulatedLink);
+};
+
+} // namespace lldb_private
+
+#endif  // liblldb_ConnectionSimulatedLink_h_
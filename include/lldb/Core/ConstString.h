@@ -424,6 +424,16 @@ public:
     bool
     GetMangledCounterpart (ConstString &counterpart) const;
 
+    //------------------------------------------------------------------
+    /// Record that this mangled ConstString can't be demangled.
+    ///
+    /// The counterpart of this string is set to the empty string, so
+    /// GetMangledCounterpart() fills in an empty, but not NULL, string
+    /// and the demangler doesn't need to be run on this name again.
+    //------------------------------------------------------------------
+    void
+    SetEmptyMangledCounterpart () const;
+
     //------------------------------------------------------------------
     /// Set the C string value with length.
     ///
@@ -13,12 +13,106 @@
 
 
 #include "lldb/lldb-private.h"
+#include "lldb/Host/Endian.h"
+#include "llvm/Support/SwapByteOrder.h"
 #include <limits.h>
 #include <stdint.h>
 #include <string.h>
 
 namespace lldb_private {
 
+//----------------------------------------------------------------------
+/// @class DataBlockCursor DataExtractor.h "lldb/Core/DataExtractor.h"
+/// @brief Reads fixed size values from a block of data whose bounds
+/// were already checked.
+///
+/// Symbol tables and debug information are made of many records whose
+/// size is known up front. Checking the bounds and the byte order for
+/// each value read from them costs more than reading the value, so a
+/// cursor is made for a whole record instead: its bounds are checked
+/// once and its byte order is a template parameter. Nothing a cursor
+/// reads is checked, get the block from DataExtractor::ExtractRecords()
+/// or from DataExtractor::GetData() with the size of everything that
+/// will be read.
+//----------------------------------------------------------------------
+template <bool swap>
+class DataBlockCursor
+{
+public:
+    DataBlockCursor (const uint8_t *bytes) :
+        m_bytes (bytes)
+    {
+    }
+
+    uint8_t
+    GetU8 ()
+    {
+        return *m_bytes++;
+    }
+
+    uint16_t
+    GetU16 ()
+    {
+        uint16_t val;
+        ::memcpy (&val, m_bytes, sizeof(val));
+        m_bytes += sizeof(val);
+        return swap ? llvm::ByteSwap_16 (val) : val;
+    }
+
+    uint32_t
+    GetU32 ()
+    {
+        uint32_t val;
+        ::memcpy (&val, m_bytes, sizeof(val));
+        m_bytes += sizeof(val);
+        return swap ? llvm::ByteSwap_32 (val) : val;
+    }
+
+    uint64_t
+    GetU64 ()
+    {
+        uint64_t val;
+        ::memcpy (&val, m_bytes, sizeof(val));
+        m_bytes += sizeof(val);
+        return swap ? llvm::ByteSwap_64 (val) : val;
+    }
+
+    //------------------------------------------------------------------
+    /// Read a 1, 2, 4 or 8 byte unsigned value. Other sizes are skipped
+    /// and read as zero.
+    //------------------------------------------------------------------
+    uint64_t
+    GetMaxU64 (uint32_t byte_size)
+    {
+        switch (byte_size)
+        {
+        case 1: return GetU8();
+        case 2: return GetU16();
+        case 4: return GetU32();
+        case 8: return GetU64();
+        default:
+            break;
+        }
+        m_bytes += byte_size;
+        return 0;
+    }
+
+    void
+    Skip (uint32_t byte_size)
+    {
+        m_bytes += byte_size;
+    }
+
+    const uint8_t *
+    GetBytes () const
+    {
+        return m_bytes;
+    }
+
+private:
+    const uint8_t *m_bytes;
+};
+
 //----------------------------------------------------------------------
 /// @class DataExtractor DataExtractor.h "lldb/Core/DataExtractor.h"
 /// @brief An data extractor class.
@@ -1213,6 +1307,55 @@ public:
     bool
     ValidOffsetForDataOfSize (uint32_t offset, uint32_t length) const;
 
+    //------------------------------------------------------------------
+    /// Parse up to \a max_count records of \a record_size bytes each,
+    /// starting at \a *offset_ptr.
+    ///
+    /// Only the records that fit entirely in the data are parsed. Their
+    /// bounds are checked and the byte order of the data is looked at
+    /// once, then \a parser is called for each record with a
+    /// DataBlockCursor at its start:
+    ///
+    /// @code
+    ///     template <bool swap>
+    ///     bool
+    ///     ParseRecord (DataBlockCursor<swap> &cursor, uint32_t idx);
+    /// @endcode
+    ///
+    /// where \a idx counts the records from zero. Returning false stops
+    /// the parse after that record, which is how lists that end with a
+    /// terminating record are parsed.
+    ///
+    /// @param[in,out] offset_ptr
+    ///     Advanced past every record that was given to \a parser.
+    ///
+    /// @return
+    ///     The number of records \a parser returned true for.
+    //------------------------------------------------------------------
+    template <class RecordParser>
+    uint32_t
+    ExtractRecords (uint32_t *offset_ptr,
+                    uint32_t record_size,
+                    uint32_t max_count,
+                    RecordParser &parser) const
+    {
+        const uint32_t offset = *offset_ptr;
+        if (record_size == 0 || !ValidOffset (offset))
+            return 0;
+        uint32_t count = (GetByteSize() - offset) / record_size;
+        if (count > max_count)
+            count = max_count;
+
+        uint32_t num_consumed = 0;
+        uint32_t num_parsed;
+        if (m_byte_order == lldb::endian::InlHostByteOrder())
+            num_parsed = ParseRecords<false> (m_start + offset, record_size, count, parser, num_consumed);
+        else
+            num_parsed = ParseRecords<true> (m_start + offset, record_size, count, parser, num_consumed);
+        *offset_ptr = offset + num_consumed * record_size;
+        return num_parsed;
+    }
+
     size_t
     Copy (DataExtractor& dest_data) const;
     
@@ -1223,6 +1366,27 @@ public:
     Append (void* bytes, uint32_t length);
     
 protected:
+    template <bool swap, class RecordParser>
+    static uint32_t
+    ParseRecords (const uint8_t *bytes,
+                  uint32_t record_size,
+                  uint32_t count,
+                  RecordParser &parser,
+                  uint32_t &num_consumed)
+    {
+        for (uint32_t idx = 0; idx < count; ++idx)
+        {
+            DataBlockCursor<swap> cursor (bytes + idx * record_size);
+            if (!parser.ParseRecord (cursor, idx))
+            {
+                num_consumed = idx + 1;
+                return idx;
+            }
+        }
+        num_consumed = count;
+        return count;
+    }
+
     //------------------------------------------------------------------
     // Member variables
     //------------------------------------------------------------------
@@ -22,11 +22,13 @@
 #include "lldb/Core/FormatManager.h"
 #include "lldb/Core/InputReaderStack.h"
 #include "lldb/Core/Listener.h"
+#include "lldb/Core/PromptFormat.h"
 #include "lldb/Core/StreamFile.h"
 #include "lldb/Core/SourceManager.h"
 #include "lldb/Core/UserID.h"
 #include "lldb/Core/UserSettingsController.h"
 #include "lldb/Interpreter/OptionValueProperties.h"
+#include "lldb/Interpreter/PropertyHandle.h"
 #include "lldb/Target/ExecutionContext.h"
 #include "lldb/Target/Platform.h"
 #include "lldb/Target/TargetList.h"
@@ -231,6 +233,14 @@ public:
                   const char **end,
                   ValueObject* valobj = NULL);
 
+    static bool
+    FormatPrompt (const PromptFormat &format,
+                  const SymbolContext *sc,
+                  const ExecutionContext *exe_ctx,
+                  const Address *addr,
+                  Stream &s,
+                  ValueObject* valobj = NULL);
+
 
     void
     CleanUpInputReaders ();
@@ -275,6 +285,18 @@ public:
     
     const char *
     GetThreadFormat() const;
+
+    //------------------------------------------------------------------
+    /// The frame-format and thread-format settings parsed for
+    /// FormatPrompt(). They are parsed again only when the setting has
+    /// changed, so a long backtrace doesn't parse the same format for
+    /// every frame.
+    //------------------------------------------------------------------
+    lldb::PromptFormatSP
+    GetCompiledFrameFormat ();
+
+    lldb::PromptFormatSP
+    GetCompiledThreadFormat ();
     
     lldb::ScriptLanguage
     GetScriptLanguage() const;
@@ -288,6 +310,12 @@ public:
     bool
     SetTerminalWidth (uint32_t term_width);
     
+    uint32_t
+    GetThreadPoolSize () const;
+
+    uint32_t
+    GetFileCacheTimeout () const;
+    
     const char *
     GetPrompt() const;
     
@@ -356,6 +384,12 @@ protected:
     LogStreamMap m_log_streams;
     lldb::StreamSP m_log_callback_stream_sp;
     ConstString m_instance_name;
+    // Read every time a frame or thread is shown
+    PropertyHandle m_frame_format;
+    PropertyHandle m_thread_format;
+    Mutex m_compiled_formats_mutex;
+    lldb::PromptFormatSP m_compiled_frame_format_sp;
+    lldb::PromptFormatSP m_compiled_thread_format_sp;
 
 private:
 
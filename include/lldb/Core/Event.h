@@ -118,8 +118,14 @@ private:
 
 //----------------------------------------------------------------------
 // lldb::Event
+//
+// Every stop and state change sends events through several listeners,
+// so events carry their own atomic reference count instead of having
+// a separately allocated one. lldb passes them around in
+// lldb::EventIntrusiveSP; lldb::EventSP is only used by the public API,
+// whose SBEvent layout must not change.
 //----------------------------------------------------------------------
-class Event
+class Event : public ReferenceCountedBase<Event>
 {
     friend class Broadcaster;
     friend class Listener;
@@ -133,6 +139,27 @@ public:
 
     ~Event ();
 
+    //------------------------------------------------------------------
+    /// Wrap an event in the shared pointer the public API uses.
+    ///
+    /// The shared pointer holds a reference on the event's own count
+    /// until its last copy goes away, so the event stays alive as long
+    /// as either kind of pointer refers to it.
+    //------------------------------------------------------------------
+    static lldb::EventSP
+    MakePublicSP (const lldb::EventIntrusiveSP &event_sp);
+
+    //------------------------------------------------------------------
+    /// Get the event in a shared pointer from the public API back into
+    /// the pointer lldb uses. Only valid for shared pointers made with
+    /// MakePublicSP().
+    //------------------------------------------------------------------
+    static lldb::EventIntrusiveSP
+    MakeIntrusiveSP (const lldb::EventSP &event_sp)
+    {
+        return lldb::EventIntrusiveSP (event_sp.get());
+    }
+
     void
     Dump (Stream *s) const;
 
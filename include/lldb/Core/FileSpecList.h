@@ -13,6 +13,7 @@
 
 #include "lldb/lldb-private.h"
 #include "lldb/Host/FileSpec.h"
+#include "lldb/Host/FileSpecTable.h"
 #include <vector>
 
 namespace lldb_private {
@@ -190,12 +191,12 @@ public:
     {
         if (idx < m_files.size())
         {
-            m_files.insert(m_files.begin() + idx, file);
+            m_files.insert(m_files.begin() + idx, FileSpecTable::GetIndexForFileSpec (file));
             return true;
         }
         else if (idx == m_files.size())
         {
-            m_files.push_back(file);
+            m_files.push_back(FileSpecTable::GetIndexForFileSpec (file));
             return true;
         }
         return false;
@@ -206,7 +207,7 @@ public:
     {
         if (idx < m_files.size())
         {
-            m_files[idx] = file;
+            m_files[idx] = FileSpecTable::GetIndexForFileSpec (file);
             return true;
         }
         return false;
@@ -226,8 +227,10 @@ public:
     static size_t GetFilesMatchingPartialPath (const char *path, bool dir_okay, FileSpecList &matches);
 
 protected:
-    typedef std::vector<FileSpec> collection;   ///< The collection type for the file list.
-    collection m_files; ///< A collection of FileSpec objects.
+    typedef std::vector<uint32_t> collection;   ///< The collection type for the file list.
+    collection m_files; ///< FileSpecTable indexes of the files, support
+                        ///< file lists of many compile units share the
+                        ///< same entries.
 };
 
 } // namespace lldb_private
@@ -23,6 +23,7 @@
 #include "lldb/lldb-public.h"
 #include "lldb/lldb-enumerations.h"
 
+#include "lldb/Core/PromptFormat.h"
 #include "lldb/Core/ValueObject.h"
 #include "lldb/Interpreter/ScriptInterpreterPython.h"
 #include "lldb/Symbol/Type.h"
@@ -239,6 +240,16 @@ public:
     virtual uint32_t
     CalculateNumChildren() = 0;
     
+    // front-ends that have to walk their backend to count its children can
+    // stop once they have seen "max" of them; a count smaller than "max"
+    // must be the real number of children
+    virtual uint32_t
+    CalculateNumChildrenUpTo (uint32_t max)
+    {
+        const uint32_t num_children = CalculateNumChildren();
+        return num_children < max ? num_children : max;
+    }
+    
     virtual lldb::ValueObjectSP
     GetChildAtIndex (uint32_t idx, bool can_create) = 0;
     
@@ -351,6 +362,22 @@ public:
             return *this;
         }
         
+        bool
+        GetNotCacheable () const
+        {
+            return (m_flags & lldb::eTypeOptionNotCacheable) == lldb::eTypeOptionNotCacheable;
+        }
+        
+        Flags&
+        SetNotCacheable (bool value = true)
+        {
+            if (value)
+                m_flags |= lldb::eTypeOptionNotCacheable;
+            else
+                m_flags &= ~lldb::eTypeOptionNotCacheable;
+            return *this;
+        }
+        
         uint32_t
         GetValue ()
         {
@@ -393,6 +420,17 @@ public:
         return m_flags.GetSkipReferences();
     }
     
+    //------------------------------------------------------------------
+    // A cacheable provider gives the same children as long as the bytes
+    // of the value and the memory they point to are the same, so it
+    // doesn't need to be updated again after an expression was run.
+    //------------------------------------------------------------------
+    bool
+    IsCacheable () const
+    {
+        return !m_flags.GetNotCacheable();
+    }
+    
     void
     SetCascades (bool value)
     {
@@ -411,6 +449,12 @@ public:
         m_flags.SetSkipReferences(value);
     }
     
+    void
+    SetIsCacheable (bool value)
+    {
+        m_flags.SetNotCacheable(!value);
+    }
+    
     uint32_t
     GetOptions ()
     {
@@ -601,6 +645,46 @@ private:
     DISALLOW_COPY_AND_ASSIGN(TypeFilterImpl);
 };
 
+// synthetic children computed by a front-end written in C++, for types
+// that are common enough that going through Python for each child is too slow
+class CXXSyntheticChildren : public SyntheticChildren
+{
+public:
+    typedef SyntheticChildrenFrontEnd* (*CreateFrontEndCallback) (CXXSyntheticChildren*, lldb::ValueObjectSP);
+protected:
+    CreateFrontEndCallback m_create_callback;
+    std::string m_description;
+public:
+    CXXSyntheticChildren(const SyntheticChildren::Flags& flags,
+                         const char* description,
+                         CreateFrontEndCallback callback) :
+        SyntheticChildren(flags),
+        m_create_callback(callback),
+        m_description(description ? description : "")
+    {
+    }
+
+    bool
+    IsScripted()
+    {
+        return false;
+    }
+
+    std::string
+    GetDescription();
+
+    virtual SyntheticChildrenFrontEnd::AutoPointer
+    GetFrontEnd(ValueObject &backend)
+    {
+        if (!m_create_callback)
+            return SyntheticChildrenFrontEnd::AutoPointer(NULL);
+        return SyntheticChildrenFrontEnd::AutoPointer(m_create_callback(this, backend.GetSP()));
+    }
+
+private:
+    DISALLOW_COPY_AND_ASSIGN(CXXSyntheticChildren);
+};
+
 #ifndef LLDB_DISABLE_PYTHON
 
 class TypeSyntheticImpl : public SyntheticChildren
@@ -672,10 +756,16 @@ public:
         
         virtual uint32_t
         CalculateNumChildren()
+        {
+            return CalculateNumChildrenUpTo(UINT32_MAX);
+        }
+        
+        virtual uint32_t
+        CalculateNumChildrenUpTo (uint32_t max)
         {
             if (!m_wrapper_sp || m_interpreter == NULL)
                 return 0;
-            return m_interpreter->CalculateNumChildren(m_wrapper_sp);
+            return m_interpreter->CalculateNumChildren(m_wrapper_sp, max);
         }
         
         virtual lldb::ValueObjectSP
@@ -1010,6 +1100,22 @@ public:
             return *this;
         }
         
+        bool
+        GetNotCacheable () const
+        {
+            return (m_flags & lldb::eTypeOptionNotCacheable) == lldb::eTypeOptionNotCacheable;
+        }
+        
+        Flags&
+        SetNotCacheable (bool value = true)
+        {
+            if (value)
+                m_flags |= lldb::eTypeOptionNotCacheable;
+            else
+                m_flags &= ~lldb::eTypeOptionNotCacheable;
+            return *this;
+        }
+        
         bool
         GetDontShowChildren () const
         {
@@ -1140,6 +1246,17 @@ public:
         return m_flags.GetHideItemNames();
     }
     
+    //------------------------------------------------------------------
+    // A cacheable summary gives the same string as long as the bytes of
+    // the value and the memory they point to are the same, so it doesn't
+    // need to be run again after an expression was run.
+    //------------------------------------------------------------------
+    bool
+    IsCacheable () const
+    {
+        return !m_flags.GetNotCacheable();
+    }
+    
     void
     SetCascades (bool value)
     {
@@ -1182,6 +1299,12 @@ public:
         m_flags.SetHideItemNames(value);
     }
     
+    void
+    SetIsCacheable (bool value)
+    {
+        m_flags.SetNotCacheable(!value);
+    }
+    
     uint32_t
     GetOptions ()
     {
@@ -1237,6 +1360,7 @@ private:
 struct StringSummaryFormat : public TypeSummaryImpl
 {
     std::string m_format;
+    PromptFormat m_compiled_format;     // m_format parsed once for all the values it summarizes
     
     StringSummaryFormat(const TypeSummaryImpl::Flags& flags,
                         const char* f);
@@ -1254,6 +1378,7 @@ struct StringSummaryFormat : public TypeSummaryImpl
                 m_format.assign(data);
         else
                 m_format.clear();
+        m_compiled_format.Compile(m_format.c_str());
     }
     
     virtual
@@ -12,6 +12,7 @@
 
 // C Includes
 // C++ Includes
+#include <map>
 
 // Other libraries and framework includes
 // Project includes
@@ -343,7 +344,7 @@ public:
     static const Position Last = UINT32_MAX;
     
     CategoryMap (IFormatChangeListener* lst) :
-        m_map_mutex(Mutex::eMutexTypeRecursive),
+        m_map_lock(),
         listener(lst),
         m_map(),
         m_active_categories()
@@ -358,7 +359,7 @@ public:
     Add (KeyType name,
          const ValueSP& entry)
     {
-        Mutex::Locker(m_map_mutex);
+        ReadWriteLock::WriteLocker locker(m_map_lock);
         m_map[name] = entry;
         if (listener)
             listener->Changed();
@@ -367,12 +368,13 @@ public:
     bool
     Delete (KeyType name)
     {
-        Mutex::Locker(m_map_mutex);
+        ReadWriteLock::WriteLocker locker(m_map_lock);
         MapIterator iter = m_map.find(name);
         if (iter == m_map.end())
             return false;
-        m_map.erase(name);
-        Disable(name);
+        ValueSP category = iter->second;
+        m_map.erase(iter);
+        DisableUnlocked(category);
         if (listener)
             listener->Changed();
         return true;
@@ -382,70 +384,42 @@ public:
     Enable (KeyType category_name,
             Position pos = Default)
     {
-        Mutex::Locker(m_map_mutex);
+        ReadWriteLock::WriteLocker locker(m_map_lock);
         ValueSP category;
-        if (!Get(category_name,category))
+        if (!GetUnlocked(category_name,category))
             return false;
-        return Enable(category, pos);
+        return EnableUnlocked(category, pos);
     }
     
     bool
     Disable (KeyType category_name)
     {
-        Mutex::Locker(m_map_mutex);
+        ReadWriteLock::WriteLocker locker(m_map_lock);
         ValueSP category;
-        if (!Get(category_name,category))
+        if (!GetUnlocked(category_name,category))
             return false;
-        return Disable(category);
+        return DisableUnlocked(category);
     }
     
     bool
     Enable (ValueSP category,
             Position pos = Default)
     {
-        Mutex::Locker(m_map_mutex);
-        if (category.get())
-        {
-            Position pos_w = pos;
-            if (pos == First || m_active_categories.size() == 0)
-                m_active_categories.push_front(category);
-            else if (pos == Last || pos == m_active_categories.size())
-                m_active_categories.push_back(category);
-            else if (pos < m_active_categories.size())
-            {
-                ActiveCategoriesList::iterator iter = m_active_categories.begin();
-                while (pos_w)
-                {
-                    pos_w--,iter++;
-                }
-                m_active_categories.insert(iter,category);
-            }
-            else
-                return false;
-            category->Enable(true,
-                             pos);
-            return true;
-        }
-        return false;
+        ReadWriteLock::WriteLocker locker(m_map_lock);
+        return EnableUnlocked(category, pos);
     }
     
     bool
     Disable (ValueSP category)
     {
-        Mutex::Locker(m_map_mutex);
-        if (category.get())
-        {
-            m_active_categories.remove_if(delete_matching_categories(category));
-            category->Disable();
-            return true;
-        }
-        return false;
+        ReadWriteLock::WriteLocker locker(m_map_lock);
+        return DisableUnlocked(category);
     }
     
     void
     Clear ()
     {
-        Mutex::Locker(m_map_mutex);
+        ReadWriteLock::WriteLocker locker(m_map_lock);
         m_map.clear();
         m_active_categories.clear();
         if (listener)
@@ -456,19 +430,15 @@ public:
     Get (KeyType name,
          ValueSP& entry)
     {
-        Mutex::Locker(m_map_mutex);
-        MapIterator iter = m_map.find(name);
-        if (iter == m_map.end())
-            return false;
-        entry = iter->second;
-        return true;
+        ReadWriteLock::ReadLocker locker(m_map_lock);
+        return GetUnlocked(name, entry);
     }
     
     bool
     Get (uint32_t pos,
          ValueSP& entry)
     {
-        Mutex::Locker(m_map_mutex);
+        ReadWriteLock::ReadLocker locker(m_map_lock);
         MapIterator iter = m_map.begin();
         MapIterator end = m_map.end();
         while (pos > 0)
@@ -526,7 +496,64 @@ private:
         }
     };
     
-    Mutex m_map_mutex;
+    // The unlocked versions must be called with m_map_lock held, and the
+    // ones that change the active categories with it held for writing
+    bool
+    GetUnlocked (KeyType name,
+                 ValueSP& entry)
+    {
+        MapIterator iter = m_map.find(name);
+        if (iter == m_map.end())
+            return false;
+        entry = iter->second;
+        return true;
+    }
+    
+    bool
+    EnableUnlocked (ValueSP category,
+                    Position pos)
+    {
+        if (category.get())
+        {
+            Position pos_w = pos;
+            if (pos == First || m_active_categories.size() == 0)
+                m_active_categories.push_front(category);
+            else if (pos == Last || pos == m_active_categories.size())
+                m_active_categories.push_back(category);
+            else if (pos < m_active_categories.size())
+            {
+                ActiveCategoriesList::iterator iter = m_active_categories.begin();
+                while (pos_w)
+                {
+                    pos_w--,iter++;
+                }
+                m_active_categories.insert(iter,category);
+            }
+            else
+                return false;
+            category->Enable(true,
+                             pos);
+            return true;
+        }
+        return false;
+    }
+    
+    bool
+    DisableUnlocked (ValueSP category)
+    {
+        if (category.get())
+        {
+            m_active_categories.remove_if(delete_matching_categories(category));
+            category->Disable();
+            return true;
+        }
+        return false;
+    }
+    
+    // Every value that gets displayed looks through the active categories,
+    // and they only change when the user edits them, so lookups share
+    // the lock
+    ReadWriteLock m_map_lock;
     IFormatChangeListener* listener;
     
     MapType m_map;
@@ -542,11 +569,6 @@ private:
         return m_active_categories;
     }
     
-    Mutex& mutex ()
-    {
-        return m_map_mutex;
-    }
-    
     friend class FormatNavigator<KeyType, ValueType>;
     friend class FormatManager;
 };
@@ -646,12 +668,18 @@ public:
     GetCategory (const ConstString& category_name,
                  bool can_create = true);
     
+    //------------------------------------------------------------------
+    // The formatters picked for a value are remembered by clang type, so
+    // looking them up again for another value of the same type doesn't
+    // have to go through every category.
+    //------------------------------------------------------------------
+    lldb::TypeFormatImplSP
+    GetFormat (ValueObject& valobj,
+               lldb::DynamicValueType use_dynamic);
+    
     lldb::TypeSummaryImplSP
     GetSummaryFormat (ValueObject& valobj,
-                      lldb::DynamicValueType use_dynamic)
-    {
-        return m_categories_map.GetSummaryFormat(valobj, use_dynamic);
-    }
+                      lldb::DynamicValueType use_dynamic);
     
     lldb::TypeSummaryImplSP
     GetSummaryForType (lldb::TypeNameSpecifierImplSP type_sp);
@@ -672,10 +700,7 @@ public:
 #ifndef LLDB_DISABLE_PYTHON
     lldb::SyntheticChildrenSP
     GetSyntheticChildren (ValueObject& valobj,
-                          lldb::DynamicValueType use_dynamic)
-    {
-        return m_categories_map.GetSyntheticChildren(valobj, use_dynamic);
-    }
+                          lldb::DynamicValueType use_dynamic);
 #endif
     
     bool
@@ -736,10 +761,42 @@ public:
     }
     
 private:    
+    struct FormatCacheEntry
+    {
+        FormatCacheEntry () :
+            has_format (false),
+            has_summary (false),
+            has_synthetic (false)
+        {
+        }
+        
+        bool has_format;
+        bool has_summary;
+        bool has_synthetic;
+        lldb::TypeFormatImplSP format_sp;
+        lldb::TypeSummaryImplSP summary_sp;
+        lldb::SyntheticChildrenSP synthetic_sp;
+    };
+    typedef std::pair<lldb::clang_type_t, lldb::DynamicValueType> FormatCacheKey;
+    typedef std::map<FormatCacheKey, FormatCacheEntry> FormatCacheMap;
+    
+    static bool
+    IsFormatCacheable (ValueObject& valobj,
+                       lldb::DynamicValueType use_dynamic);
+    
+    // Returns the cache entry for "key" or NULL if the formatters changed
+    // since "revision". Call with m_format_cache_mutex locked.
+    FormatCacheEntry *
+    GetFormatCacheEntry (const FormatCacheKey &key,
+                         uint32_t revision);
+    
     ValueNavigator m_value_nav;
     NamedSummariesMap m_named_summaries_map;
     uint32_t m_last_revision;
     CategoryMap m_categories_map;
+    Mutex m_format_cache_mutex;
+    FormatCacheMap m_format_cache;
+    uint32_t m_format_cache_revision;  // The revision m_format_cache is valid for
     
     ConstString m_default_category_name;
     ConstString m_system_category_name;
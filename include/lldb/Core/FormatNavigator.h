@@ -25,6 +25,7 @@
 #include "lldb/Core/Log.h"
 #include "lldb/Core/RegularExpression.h"
 #include "lldb/Core/ValueObject.h"
+#include "lldb/Host/ReadWriteLock.h"
 #include "lldb/Target/ObjCLanguageRuntime.h"
 #include "lldb/Target/Process.h"
 #include "lldb/Target/StackFrame.h"
@@ -112,7 +113,7 @@ public:
     
     FormatMap(IFormatChangeListener* lst) :
     m_map(),
-    m_map_mutex(Mutex::eMutexTypeRecursive),
+    m_map_lock(),
     listener(lst)
     {
     }
@@ -126,7 +127,7 @@ public:
         else
             entry->GetRevision() = 0;
 
-        Mutex::Locker(m_map_mutex);
+        ReadWriteLock::WriteLocker locker(m_map_lock);
         m_map[name] = entry;
         if (listener)
             listener->Changed();
@@ -135,7 +136,7 @@ public:
     bool
     Delete (KeyType name)
     {
-        Mutex::Locker(m_map_mutex);
+        ReadWriteLock::WriteLocker locker(m_map_lock);
         MapIterator iter = m_map.find(name);
         if (iter == m_map.end())
             return false;
@@ -148,7 +149,7 @@ public:
     void
     Clear ()
     {
-        Mutex::Locker(m_map_mutex);
+        ReadWriteLock::WriteLocker locker(m_map_lock);
         m_map.clear();
         if (listener)
             listener->Changed();
@@ -158,7 +159,7 @@ public:
     Get(KeyType name,
         ValueSP& entry)
     {
-        Mutex::Locker(m_map_mutex);
+        ReadWriteLock::ReadLocker locker(m_map_lock);
         MapIterator iter = m_map.find(name);
         if (iter == m_map.end())
             return false;
@@ -171,7 +172,7 @@ public:
     {
         if (callback)
         {
-            Mutex::Locker(m_map_mutex);
+            ReadWriteLock::ReadLocker locker(m_map_lock);
             MapIterator pos, end = m_map.end();
             for (pos = m_map.begin(); pos != end; pos++)
             {
@@ -191,7 +192,7 @@ public:
     ValueSP
     GetValueAtIndex (uint32_t index)
     {
-        Mutex::Locker(m_map_mutex);
+        ReadWriteLock::ReadLocker locker(m_map_lock);
         MapIterator iter = m_map.begin();
         MapIterator end = m_map.end();
         while (index > 0)
@@ -207,7 +208,7 @@ public:
     KeyType
     GetKeyAtIndex (uint32_t index)
     {
-        Mutex::Locker(m_map_mutex);
+        ReadWriteLock::ReadLocker locker(m_map_lock);
         MapIterator iter = m_map.begin();
         MapIterator end = m_map.end();
         while (index > 0)
@@ -222,7 +223,10 @@ public:
     
 protected:
     MapType m_map;    
-    Mutex m_map_mutex;
+    // Formatters are looked up for every value that gets displayed, and
+    // only change when the user adds or deletes one, so lookups share
+    // the lock
+    ReadWriteLock m_map_lock;
     IFormatChangeListener* listener;
     
     MapType&
@@ -231,10 +235,10 @@ protected:
         return m_map;
     }
     
-    Mutex&
-    mutex ()
+    ReadWriteLock&
+    lock ()
     {
-        return m_map_mutex;
+        return m_map_lock;
     }
     
     friend class FormatNavigator<KeyType, ValueType>;
@@ -372,8 +376,7 @@ protected:
     bool
     Delete_Impl (ConstString type, lldb::RegularExpressionSP *dummy)
     {
-       Mutex& x_mutex = m_format_map.mutex();
-        lldb_private::Mutex::Locker locker(x_mutex);
+       ReadWriteLock::WriteLocker locker(m_format_map.lock());
        MapIterator pos, end = m_format_map.map().end();
        for (pos = m_format_map.map().begin(); pos != end; pos++)
        {
@@ -425,8 +428,7 @@ protected:
     bool
     Get_Impl (ConstString key, MapValueType& value, lldb::RegularExpressionSP *dummy)
     {
-       Mutex& x_mutex = m_format_map.mutex();
-       lldb_private::Mutex::Locker locker(x_mutex);
+       ReadWriteLock::ReadLocker locker(m_format_map.lock());
        MapIterator pos, end = m_format_map.map().end();
        for (pos = m_format_map.map().begin(); pos != end; pos++)
        {
@@ -443,8 +445,7 @@ protected:
     bool
     GetExact_Impl (ConstString key, MapValueType& value, lldb::RegularExpressionSP *dummy)
     {
-        Mutex& x_mutex = m_format_map.mutex();
-        lldb_private::Mutex::Locker locker(x_mutex);
+        ReadWriteLock::ReadLocker locker(m_format_map.lock());
         MapIterator pos, end = m_format_map.map().end();
         for (pos = m_format_map.map().begin(); pos != end; pos++)
         {
@@ -0,0 +1,126 @@
+//===-- IndexCache.h --------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_IndexCache_h_
+#define liblldb_IndexCache_h_
+
+// C Includes
+// C++ Includes
+// Other libraries and framework includes
+// Project includes
+#include "lldb/lldb-private.h"
+#include "lldb/Core/DataExtractor.h"
+#include "lldb/Core/UniqueCStringMap.h"
+
+namespace lldb_private {
+
+//----------------------------------------------------------------------
+/// @class IndexCache IndexCache.h "lldb/Core/IndexCache.h"
+/// @brief Saves and loads module indexes to and from an on-disk cache.
+///
+/// Indexes that are expensive to build (symbol table name indexes,
+/// DWARF name indexes) can be saved to the directory specified by the
+/// "target.index-cache-path" setting. Each cache file is keyed by the
+/// UUID and the modification time of the module it was built for, so
+/// a stale cache file is never used for a module that has changed.
+///
+/// A cache file starts with a header that contains the key and a
+/// version number supplied by the client. The rest of the file is
+/// whatever the client encoded, usually one or more UniqueCStringMap
+/// objects encoded with IndexCache::EncodeNameMap(). Cache files are
+/// memory mapped when they are loaded.
+//----------------------------------------------------------------------
+class IndexCache
+{
+public:
+    typedef UniqueCStringMap<uint32_t> NameMap;
+
+    //------------------------------------------------------------------
+    /// Load the cached data for an index of a module.
+    ///
+    /// @param[in] module
+    ///     The module the index was built for.
+    ///
+    /// @param[in] index_name
+    ///     A unique name for the index within the module.
+    ///
+    /// @param[in] version
+    ///     The version of the client's encoding. Cache files with a
+    ///     different version are ignored.
+    ///
+    /// @param[out] data
+    ///     The memory mapped contents of the cache file.
+    ///
+    /// @param[out] offset_ptr
+    ///     Filled in with the offset of the first byte after the cache
+    ///     file header.
+    ///
+    /// @return
+    ///     \b true if a valid cache file was found, \b false otherwise.
+    //------------------------------------------------------------------
+    static bool
+    Load (Module *module,
+          const char *index_name,
+          uint32_t version,
+          DataExtractor &data,
+          uint32_t *offset_ptr);
+
+    //------------------------------------------------------------------
+    /// Save the data for an index of a module to the cache.
+    ///
+    /// @param[in] module
+    ///     The module the index was built for.
+    ///
+    /// @param[in] index_name
+    ///     A unique name for the index within the module.
+    ///
+    /// @param[in] version
+    ///     The version of the client's encoding.
+    ///
+    /// @param[in] data
+    ///     The encoded index data to save after the header.
+    ///
+    /// @return
+    ///     \b true if the cache file was written, \b false otherwise.
+    //------------------------------------------------------------------
+    static bool
+    Save (Module *module,
+          const char *index_name,
+          uint32_t version,
+          const std::string &data);
+
+    //------------------------------------------------------------------
+    /// Returns \b true if index caching is enabled, and the module can
+    /// be cached.
+    //------------------------------------------------------------------
+    static bool
+    IsEnabledForModule (Module *module);
+
+    //------------------------------------------------------------------
+    /// Encode and decode a name map. Names are stored as C strings so
+    /// decoded maps are re-uniqued and sorted with ConstString.
+    //------------------------------------------------------------------
+    static void
+    EncodeNameMap (Stream &strm, const NameMap &map);
+
+    static bool
+    DecodeNameMap (const DataExtractor &data, uint32_t *offset_ptr, NameMap &map);
+
+private:
+    static bool
+    GetCacheFileForModule (Module *module,
+                           const char *index_name,
+                           FileSpec &cache_file);
+
+    DISALLOW_COPY_AND_ASSIGN (IndexCache);
+};
+
+} // namespace lldb_private
+
+#endif  // liblldb_IndexCache_h_
@@ -30,7 +30,7 @@ namespace lldb_private {
 class Listener
 {
 public:
-    typedef bool (*HandleBroadcastCallback) (lldb::EventSP &event_sp, void *baton);
+    typedef bool (*HandleBroadcastCallback) (lldb::EventIntrusiveSP &event_sp, void *baton);
 
     friend class Broadcaster;
     friend class BroadcasterManager;
@@ -43,7 +43,7 @@ public:
     ~Listener ();
 
     void
-    AddEvent (lldb::EventSP &event);
+    AddEvent (lldb::EventIntrusiveSP &event);
 
     void
     Clear ();
@@ -79,18 +79,18 @@ public:
     // Returns true if an event was recieved, false if we timed out.
     bool
     WaitForEvent (const TimeValue *timeout,
-                  lldb::EventSP &event_sp);
+                  lldb::EventIntrusiveSP &event_sp);
 
     bool
     WaitForEventForBroadcaster (const TimeValue *timeout,
                                 Broadcaster *broadcaster,
-                                lldb::EventSP &event_sp);
+                                lldb::EventIntrusiveSP &event_sp);
 
     bool
     WaitForEventForBroadcasterWithType (const TimeValue *timeout,
                                         Broadcaster *broadcaster,
                                         uint32_t event_type_mask,
-                                        lldb::EventSP &event_sp);
+                                        lldb::EventIntrusiveSP &event_sp);
 
     Event *
     PeekAtNextEvent ();
@@ -103,19 +103,19 @@ public:
                                            uint32_t event_type_mask);
 
     bool
-    GetNextEvent (lldb::EventSP &event_sp);
+    GetNextEvent (lldb::EventIntrusiveSP &event_sp);
 
     bool
     GetNextEventForBroadcaster (Broadcaster *broadcaster,
-                                lldb::EventSP &event_sp);
+                                lldb::EventIntrusiveSP &event_sp);
 
     bool
     GetNextEventForBroadcasterWithType (Broadcaster *broadcaster,
                                         uint32_t event_type_mask,
-                                        lldb::EventSP &event_sp);
+                                        lldb::EventIntrusiveSP &event_sp);
 
     size_t
-    HandleBroadcastEvent (lldb::EventSP &event_sp);
+    HandleBroadcastEvent (lldb::EventIntrusiveSP &event_sp);
 
 protected:
 
@@ -137,7 +137,7 @@ protected:
     };
 
     typedef std::multimap<Broadcaster*, BroadcasterInfo> broadcaster_collection;
-    typedef std::list<lldb::EventSP> event_collection;
+    typedef std::list<lldb::EventIntrusiveSP> event_collection;
     typedef std::vector<BroadcasterManager *> broadcaster_manager_collection;
 
     bool
@@ -145,7 +145,7 @@ protected:
                            const ConstString *sources, // NULL for any event
                            uint32_t num_sources,
                            uint32_t event_type_mask,
-                           lldb::EventSP &event_sp,
+                           lldb::EventIntrusiveSP &event_sp,
                            bool remove);
 
     bool
@@ -153,7 +153,7 @@ protected:
                           const ConstString *sources, // NULL for any event
                           uint32_t num_sources,
                           uint32_t event_type_mask,
-                          lldb::EventSP &event_sp);
+                          lldb::EventIntrusiveSP &event_sp);
 
     bool
     WaitForEventsInternal (const TimeValue *timeout,
@@ -161,13 +161,30 @@ protected:
                            const ConstString *sources, // NULL for any event
                            uint32_t num_sources,
                            uint32_t event_type_mask,
-                           lldb::EventSP &event_sp);
+                           lldb::EventIntrusiveSP &event_sp);
+
+    //------------------------------------------------------------------
+    // Events are added by broadcasters on any thread without taking a
+    // lock: AddEvent() pushes them onto a lock free stack of pending
+    // events, and whoever looks at the events next moves them over to
+    // m_events while holding m_events_mutex.
+    //------------------------------------------------------------------
+    struct PendingEvent
+    {
+        lldb::EventIntrusiveSP event_sp;
+        PendingEvent *next;
+    };
+
+    // Must be called with m_events_mutex locked
+    void
+    MovePendingEvents ();
 
     std::string m_name;
     broadcaster_collection m_broadcasters;
     Mutex m_broadcasters_mutex; // Protects m_broadcasters
     event_collection m_events;
     Mutex m_events_mutex; // Protects m_broadcasters and m_events
+    PendingEvent * volatile m_pending_events; // Events added since m_events was last updated, newest first
     Predicate<bool> m_cond_wait;
     broadcaster_manager_collection m_broadcaster_managers;
 
@@ -44,6 +44,7 @@
 #define LLDB_LOG_OPTION_PREPEND_TIMESTAMP       (1u << 4)
 #define LLDB_LOG_OPTION_PREPEND_PROC_AND_THREAD (1u << 5)
 #define LLDB_LOG_OPTION_PREPEND_THREAD_NAME     (1U << 6)
+#define LLDB_LOG_OPTION_BINARY                  (1U << 7)   // Record into a LogBuffer instead of formatting, see "log dump"
 
 //----------------------------------------------------------------------
 // Logging Functions
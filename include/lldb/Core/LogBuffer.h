@@ -0,0 +1,78 @@
+//===-- LogBuffer.h ---------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_LogBuffer_h_
+#define liblldb_LogBuffer_h_
+
+// C Includes
+#include <stdarg.h>
+#include <stdint.h>
+
+// C++ Includes
+// Other libraries and framework includes
+// Project includes
+#include "lldb/lldb-private.h"
+
+namespace lldb_private {
+
+//----------------------------------------------------------------------
+/// @class LogBuffer LogBuffer.h "lldb/Core/LogBuffer.h"
+/// @brief Binary ring buffers for logs enabled with "log enable --binary".
+///
+/// Formatting a log line and writing it to a stream on every call is
+/// what makes logs like "gdb-remote packets" slow. A log with the
+/// LLDB_LOG_OPTION_BINARY option instead hands its format string and
+/// arguments to LogBuffer::Record(), which copies the raw arguments
+/// (and the bytes of any strings) into a ring buffer that belongs to
+/// the calling thread, without taking any locks or formatting anything.
+///
+/// The format string itself isn't copied, its address identifies it,
+/// so a binary log must only be given string literals as formats (as
+/// every log in LLDB does). The records are turned into text only when
+/// they are asked for with LogBuffer::Dump(), which "log dump" does.
+//----------------------------------------------------------------------
+class LogBuffer
+{
+public:
+    //------------------------------------------------------------------
+    /// Record a log line for the current thread.
+    ///
+    /// Only the first eMaxArguments arguments and eMaxStringBytes bytes
+    /// of string arguments are kept, anything past that shows up as
+    /// "<truncated>" when the record is dumped.
+    //------------------------------------------------------------------
+    static void
+    Record (const char *format, va_list args);
+
+    //------------------------------------------------------------------
+    /// Format the records of all threads, oldest first, one per line.
+    ///
+    /// @return
+    ///     The number of records that were dumped.
+    //------------------------------------------------------------------
+    static size_t
+    Dump (Stream &s);
+
+    //------------------------------------------------------------------
+    /// Throw away the records of all threads.
+    //------------------------------------------------------------------
+    static void
+    Clear ();
+
+    enum
+    {
+        eNumRecordsPerThread = 1024,
+        eMaxArguments = 12,
+        eMaxStringBytes = 256
+    };
+};
+
+} // namespace lldb_private
+
+#endif // liblldb_LogBuffer_h_
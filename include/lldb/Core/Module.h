@@ -10,7 +10,11 @@
 #ifndef liblldb_Module_h_
 #define liblldb_Module_h_
 
+#include <map>
+#include <vector>
+
 #include "lldb/Core/ArchSpec.h"
+#include "lldb/Core/NameBloomFilter.h"
 #include "lldb/Core/UUID.h"
 #include "lldb/Host/FileSpec.h"
 #include "lldb/Host/Mutex.h"
@@ -503,6 +507,8 @@ public:
         m_symfile_spec = file;
         m_symfile_ap.reset();
         m_did_load_symbol_vendor = false;
+        // The name filter has the names of the old symbol file
+        m_did_init_name_filter = false;
     }
 
     const TimeValue &
@@ -597,6 +603,203 @@ public:
     virtual SymbolVendor*
     GetSymbolVendor(bool can_create = true);
 
+    //------------------------------------------------------------------
+    /// Build the symbol table and symbol file name indexes for this
+    /// module ahead of time.
+    ///
+    /// Lookups by name build these indexes on demand. Clients that are
+    /// about to do lookups in many modules can call this for each of
+    /// the modules on separate threads first.
+    //------------------------------------------------------------------
+    void
+    PreloadSymbols ();
+
+    //------------------------------------------------------------------
+    /// Only use the symbol table of this module until
+    /// LoadSymbolsOnDemand() is called. Until then GetSymbolVendor()
+    /// returns NULL and lookups only find symbols. This has no effect
+    /// if the symbol vendor was already loaded.
+    //------------------------------------------------------------------
+    void
+    SetSymbolsOnDemand ();
+
+    //------------------------------------------------------------------
+    /// @return
+    ///     \b true if the debug information of this module isn't loaded
+    ///     until LoadSymbolsOnDemand() is called.
+    //------------------------------------------------------------------
+    bool
+    GetSymbolsOnDemand () const;
+
+    //------------------------------------------------------------------
+    /// Let this module load its debug information the next time it is
+    /// needed. Called when one of the module's addresses is in a
+    /// backtrace, or a lookup by name might find something in it.
+    ///
+    /// @return
+    ///     \b true if the debug information was being held back before
+    ///     this call, \b false otherwise.
+    //------------------------------------------------------------------
+    bool
+    LoadSymbolsOnDemand ();
+
+    //------------------------------------------------------------------
+    /// Check whether a symbol, function or global variable named
+    /// \a name could be in this module, using a Bloom filter built from
+    /// the names in the symbol table and the symbol file's indexes. The
+    /// filter has the mangled, demangled and base names, so "foo",
+    /// "ns::foo" and "Class::foo(int)" all match a symbol for
+    /// "ns::Class::foo(int)". The filter is saved in the index cache.
+    ///
+    /// Symbol files that can't list their names, like DWARF with
+    /// accelerator tables, make this always return \b true once they
+    /// are loaded.
+    ///
+    /// @param[in] can_build
+    ///     If \b false, return \b true instead of building the filter
+    ///     when it hasn't been built yet. Lookups that only use the
+    ///     symbol table pass \b false so they don't index the symbol
+    ///     file.
+    ///
+    /// @return
+    ///     \b false if the module has nothing with that name, \b true
+    ///     if it might.
+    //------------------------------------------------------------------
+    bool
+    MayContainName (const ConstString &name, bool can_build = true);
+
+    //------------------------------------------------------------------
+    /// Check whether any compile unit of this module was built from, or
+    /// includes, \a file_spec. Only the compile units and their line
+    /// table file lists are parsed, even for a module that holds back
+    /// its debug information, so file and line lookups can tell when to
+    /// call LoadSymbolsOnDemand().
+    ///
+    /// @return
+    ///     \b true if a compile unit uses the file, \b false otherwise.
+    //------------------------------------------------------------------
+    bool
+    MayContainFile (const FileSpec &file_spec);
+
+    //------------------------------------------------------------------
+    /// Get a number that changes every time any module loads its debug
+    /// information on demand, so clients can tell when they need to
+    /// look for the modules that did.
+    //------------------------------------------------------------------
+    static uint32_t
+    GetSymbolsLoadedOnDemandGeneration ();
+
+    //------------------------------------------------------------------
+    /// Free the symbol vendor, the symbol table and the types parsed
+    /// for this module.
+    ///
+    /// The object file and its section list are kept, so the module
+    /// can still be found in module lists and the freed data will be
+    /// parsed again the next time it is needed. Only call this on a
+    /// module that nothing else is using.
+    //------------------------------------------------------------------
+    void
+    ClearParsedData ();
+
+    //------------------------------------------------------------------
+    /// @return
+    ///     \b true if the symbol vendor or the types for this module
+    ///     have been parsed, \b false otherwise.
+    //------------------------------------------------------------------
+    bool
+    HasParsedData () const;
+
+    //------------------------------------------------------------------
+    /// Get an estimate of how much memory the parsed data for this
+    /// module uses. We approximate it with the size of the object file
+    /// and of the symbol file.
+    //------------------------------------------------------------------
+    uint64_t
+    GetParsedDataByteSizeEstimate ();
+
+    //------------------------------------------------------------------
+    /// Get the instructions that were decoded before from the code at
+    /// \a file_addr in this module's object file.
+    ///
+    /// The code in a module's object file never changes, so
+    /// Disassembler::ParseInstructions caches what it decodes from the
+    /// code sections of a module, keyed by the disassembler plug-in,
+    /// the architecture and the file address range.
+    ///
+    /// @param[out] instructions
+    ///     The cached instructions are appended to this list.
+    ///
+    /// @param[out] decoded_byte_size
+    ///     Filled in with the number of bytes the instructions cover.
+    ///
+    /// @return
+    ///     \b true if the range was found in the cache, \b false
+    ///     otherwise.
+    //------------------------------------------------------------------
+    bool
+    GetCachedInstructions (const ConstString &plugin_name,
+                           const ArchSpec &arch,
+                           lldb::addr_t file_addr,
+                           lldb::addr_t byte_size,
+                           InstructionList &instructions,
+                           size_t &decoded_byte_size);
+
+    void
+    CacheInstructions (const ConstString &plugin_name,
+                       const ArchSpec &arch,
+                       lldb::addr_t file_addr,
+                       lldb::addr_t byte_size,
+                       const InstructionList &instructions,
+                       size_t decoded_byte_size);
+
+    void
+    ClearDisassemblyCache ();
+
+    //------------------------------------------------------------------
+    /// Get the call sites of the inlined functions that contain \a
+    /// so_addr, innermost first.
+    ///
+    /// StackFrameList asks for these each time it unwinds a frame, and
+    /// a stepping thread stops at the same few addresses over and
+    /// over, so the answers are cached by file address. The cache is
+    /// dropped along with the symbol file.
+    ///
+    /// @param[in] so_addr
+    ///     A section offset address in this module. Callers that look
+    ///     up a return address must back it up into the call
+    ///     instruction first.
+    ///
+    /// @param[out] call_sites
+    ///     Filled in with the address in each containing function that
+    ///     the next inlined function was expanded at.
+    ///
+    /// @return
+    ///     \b true if \a so_addr is inside at least one inlined
+    ///     function, \b false otherwise.
+    //------------------------------------------------------------------
+    bool
+    GetInlinedCallSites (const Address &so_addr,
+                         std::vector<Address> &call_sites);
+
+    void
+    ClearInlinedCallSites ();
+
+    //------------------------------------------------------------------
+    /// The shared module list stamps modules each time they are handed
+    /// out so it can tell which ones were used least recently.
+    //------------------------------------------------------------------
+    uint32_t
+    GetSharedModuleStamp () const
+    {
+        return m_shared_module_stamp;
+    }
+
+    void
+    SetSharedModuleStamp (uint32_t stamp)
+    {
+        m_shared_module_stamp = stamp;
+    }
+
     //------------------------------------------------------------------
     /// Get accessor the type list for this module.
     ///
@@ -867,12 +1070,40 @@ protected:
     std::auto_ptr<SymbolVendor> m_symfile_ap;   ///< A pointer to the symbol vendor for this module.
     ClangASTContext             m_ast;          ///< The AST context for this module.
     PathMappingList             m_source_mappings; ///< Module specific source remappings for when you have debug info for a module that doesn't match where the sources currently are
+    uint32_t                    m_shared_module_stamp; ///< When this module was last handed out by the shared module list
+
+    struct DisassemblyCacheKey
+    {
+        ConstString plugin_name;
+        ConstString triple;
+        lldb::addr_t file_addr;
+        lldb::addr_t byte_size;
+
+        bool
+        operator < (const DisassemblyCacheKey &rhs) const;
+    };
+
+    struct DisassemblyCacheEntry
+    {
+        std::vector<lldb::InstructionSP> instructions;
+        size_t decoded_byte_size;
+    };
+
+    typedef std::map<DisassemblyCacheKey, DisassemblyCacheEntry> DisassemblyCache;
+    DisassemblyCache            m_disassembly_cache;    ///< Decoded instructions by file address range, see GetCachedInstructions()
+    size_t                      m_disassembly_cache_byte_size; ///< The number of bytes of code in m_disassembly_cache
+    typedef std::map<lldb::addr_t, std::vector<Address> > InlinedCallSiteMap;
+    InlinedCallSiteMap          m_inlined_call_sites;   ///< Inlined call sites by file address, see GetInlinedCallSites()
+    NameBloomFilter             m_name_filter;          ///< The names in this module, see MayContainName()
 
     bool                        m_did_load_objfile:1,
                                 m_did_load_symbol_vendor:1,
                                 m_did_parse_uuid:1,
                                 m_did_init_ast:1,
-                                m_is_dynamic_loader_module:1;
+                                m_is_dynamic_loader_module:1,
+                                m_symbols_on_demand:1,  ///< Don't load the symbol vendor until LoadSymbolsOnDemand()
+                                m_did_init_name_filter:1,
+                                m_name_filter_is_complete:1; ///< False if m_name_filter is missing the symbol file's names
     mutable bool                m_file_has_changed:1,
                                 m_first_file_changed_log:1;   /// See if the module was modified after it was initially opened.
     
@@ -921,6 +1152,14 @@ protected:
     SymbolIndicesToSymbolContextList (Symtab *symtab, 
                                       std::vector<uint32_t> &symbol_indexes, 
                                       SymbolContextList &sc_list);
+
+    void
+    InitializeNameFilter ();
+
+    // Create the symbol vendor even if the module holds back its debug
+    // information, see GetSymbolVendor()
+    SymbolVendor*
+    LoadSymbolVendor (bool can_create);
     
     bool
     SetArchitecture (const ArchSpec &new_arch);
@@ -401,6 +401,16 @@ public:
     
     bool
     FindSourceFile (const FileSpec &orig_spec, FileSpec &new_spec) const;
+
+    //------------------------------------------------------------------
+    /// Build the name indexes of all modules in this list, using
+    /// multiple threads when the "target.parallel-module-search"
+    /// setting allows it.
+    ///
+    /// @see Module::PreloadSymbols ()
+    //------------------------------------------------------------------
+    void
+    PreloadSymbols ();
     
     bool
     Remove (const lldb::ModuleSP &module_sp);
@@ -466,6 +476,14 @@ public:
                      bool *did_create_ptr,
                      bool always_create = false);
 
+    //------------------------------------------------------------------
+    /// Add a module that was created outside of GetSharedModule() to
+    /// the global shared module list, replacing any module with the
+    /// same file, architecture and object name.
+    //------------------------------------------------------------------
+    static void
+    AddSharedModule (const lldb::ModuleSP &module_sp);
+
     static bool
     RemoveSharedModule (lldb::ModuleSP &module_sp);
 
@@ -479,12 +497,38 @@ public:
     static bool
     RemoveSharedModuleIfOrphaned (const Module *module_ptr);
 
+    //------------------------------------------------------------------
+    /// Free the parsed data of orphaned shared modules, least recently
+    /// used first, until the rest use no more than \a max_byte_size
+    /// bytes as estimated by Module::GetParsedDataByteSizeEstimate().
+    ///
+    /// The modules stay in the shared module list so they can be found
+    /// again without re-reading their object files.
+    ///
+    /// @param[in] max_byte_size
+    ///     The memory budget for orphaned modules, zero means no limit.
+    ///
+    /// @return
+    ///     The number of modules whose parsed data was freed.
+    //------------------------------------------------------------------
+    static size_t
+    TrimSharedModuleCache (uint64_t max_byte_size);
+
 protected:
     //------------------------------------------------------------------
     // Class typedefs.
     //------------------------------------------------------------------
     typedef std::vector<lldb::ModuleSP> collection; ///< The module collection type.
 
+    //------------------------------------------------------------------
+    /// Copy the modules out so that a search can go through them
+    /// without holding m_modules_mutex. Searches can take a long time
+    /// and call back into the list, and holding the mutex for them
+    /// would make lookups from different threads wait on each other.
+    //------------------------------------------------------------------
+    void
+    GetModulesSnapshot (collection &modules) const;
+
     //------------------------------------------------------------------
     // Member variables.
     //------------------------------------------------------------------
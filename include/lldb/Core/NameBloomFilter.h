@@ -0,0 +1,78 @@
+//===-- NameBloomFilter.h ---------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_NameBloomFilter_h_
+#define liblldb_NameBloomFilter_h_
+#if defined(__cplusplus)
+
+// C Includes
+// C++ Includes
+#include <vector>
+
+// Other libraries and framework includes
+// Project includes
+#include "lldb/lldb-private.h"
+
+namespace lldb_private {
+
+//----------------------------------------------------------------------
+/// @class NameBloomFilter NameBloomFilter.h "lldb/Core/NameBloomFilter.h"
+/// @brief A Bloom filter over a set of names.
+///
+/// MayContain() never returns \b false for a name that was inserted,
+/// and returns \b true for a name that wasn't about one time in a
+/// hundred. Each name takes about ten bits, and a lookup hashes the
+/// name twice and tests a few bits, so a module can reject a lookup by
+/// name without touching its symbol table or debug information
+/// indexes.
+//----------------------------------------------------------------------
+class NameBloomFilter
+{
+public:
+    NameBloomFilter ();
+
+    //------------------------------------------------------------------
+    /// Drop all names and size the filter for \a num_names names.
+    //------------------------------------------------------------------
+    void
+    Reset (uint32_t num_names);
+
+    void
+    Clear ();
+
+    void
+    Insert (const char *name);
+
+    bool
+    MayContain (const char *name) const;
+
+    size_t
+    GetByteSize () const
+    {
+        return m_words.size() * sizeof(uint32_t);
+    }
+
+    //------------------------------------------------------------------
+    /// Encode and decode the filter for the index cache.
+    //------------------------------------------------------------------
+    void
+    Encode (Stream &strm) const;
+
+    bool
+    Decode (const DataExtractor &data, uint32_t *offset_ptr);
+
+protected:
+    std::vector<uint32_t> m_words;
+    uint32_t m_num_bits;
+};
+
+} // namespace lldb_private
+
+#endif  // #if defined(__cplusplus)
+#endif  // liblldb_NameBloomFilter_h_
@@ -0,0 +1,111 @@
+//===-- PromptFormat.h ------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_PromptFormat_h_
+#define liblldb_PromptFormat_h_
+#if defined(__cplusplus)
+
+// C Includes
+// C++ Includes
+#include <string>
+#include <vector>
+
+// Other libraries and framework includes
+// Project includes
+#include "lldb/lldb-private.h"
+
+namespace lldb_private {
+
+//----------------------------------------------------------------------
+/// @class PromptFormat PromptFormat.h "lldb/Core/PromptFormat.h"
+/// @brief A format string for Debugger::FormatPrompt() that has been
+/// parsed once.
+///
+/// Frame, thread and summary format strings are used over and over,
+/// once for every frame in a backtrace or every value of a type. A
+/// PromptFormat splits the string up front into its plain text, its
+/// escaped characters, its "${...}" variables and its "{...}" scopes,
+/// so formatting only has to walk the tokens.
+//----------------------------------------------------------------------
+class PromptFormat
+{
+public:
+    enum TokenKind
+    {
+        eTokenText,         // Plain text, only printed if nothing before it failed
+        eTokenEscape,       // Escaped characters, which are always printed
+        eTokenVariable,     // A "${...}" variable
+        eTokenScope,        // A "{...}" scope made of the next num_scope_tokens tokens
+        eTokenError         // A scope that wasn't closed
+    };
+
+    struct Token
+    {
+        TokenKind kind;
+        std::string text;           // For variables, the name and its closing '}'
+        uint32_t num_scope_tokens;
+    };
+
+    PromptFormat ();
+
+    PromptFormat (const char *format);
+
+    ~PromptFormat ();
+
+    void
+    Compile (const char *format);
+
+    const char *
+    GetFormat () const
+    {
+        return m_format.c_str();
+    }
+
+    //------------------------------------------------------------------
+    /// The offset in the format string where parsing stopped, which is
+    /// the end of the string unless it has a stray '}' or a variable
+    /// that isn't closed.
+    //------------------------------------------------------------------
+    size_t
+    GetEndOffset () const
+    {
+        return m_end_offset;
+    }
+
+    const Token *
+    GetTokens () const
+    {
+        if (m_tokens.empty())
+            return NULL;
+        return &m_tokens[0];
+    }
+
+    size_t
+    GetNumTokens () const
+    {
+        return m_tokens.size();
+    }
+
+protected:
+    void
+    CompileScope (const char *&p);
+
+    void
+    AppendToken (TokenKind kind, const char *text, size_t text_len);
+
+    std::string m_format;
+    std::vector<Token> m_tokens;
+    size_t m_first_mergeable_token;     // Tokens before this are in a scope that has been closed
+    size_t m_end_offset;
+};
+
+} // namespace lldb_private
+
+#endif  // #if defined(__cplusplus)
+#endif  // liblldb_PromptFormat_h_
@@ -740,6 +740,35 @@ namespace lldb_private {
             return NULL;
         }
         
+        //------------------------------------------------------------------
+        // Find the entry with the largest base address that is less than
+        // or equal to "addr" and return it if it contains "addr". If more
+        // than one entry has that base the last one is used, so each entry
+        // should have a unique base address. The binary search doesn't
+        // branch on the comparisons, so it stays fast even when lookups
+        // are unpredictable.
+        //------------------------------------------------------------------
+        const Entry *
+        FindClosestEntryThatContains (B addr) const
+        {
+#ifdef ASSERT_RANGEMAP_ARE_SORTED
+            assert (IsSorted());
+#endif
+            size_t num_entries = m_entries.size();
+            if (num_entries == 0)
+                return NULL;
+            const Entry *entry = &m_entries[0];
+            while (num_entries > 1)
+            {
+                const size_t half = num_entries / 2;
+                entry = (entry[half].GetRangeBase() <= addr) ? entry + half : entry;
+                num_entries -= half;
+            }
+            if (entry->Contains(addr))
+                return entry;
+            return NULL;
+        }
+
         Entry *
         Back()
         {
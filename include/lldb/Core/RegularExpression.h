@@ -113,7 +113,9 @@ public:
     ///     The string to match against the compile regular expression.
     ///
     /// @param[in] match_count
-    ///     The number of regmatch_t objects in \a match_ptr
+    ///     The number of regmatch_t objects in \a match_ptr. When this
+    ///     is zero no matches are saved for GetMatchAtIndex(), and it is
+    ///     safe to call from several threads at once.
     ///
     /// @param[in] execute_flags
     ///     Flags to pass to the \c regexec() function.
@@ -178,6 +180,7 @@ private:
     // Member variables
     //------------------------------------------------------------------
     mutable std::string m_re;   ///< A copy of the original regular expression text
+    std::string m_required_literal; ///< Text that every string the expression matches must contain, or empty if there isn't any
     mutable llvm::Regex m_regex;     ///< The compiled regular expression
     int     m_compile_flags; ///< Stores the flags from the last compile.
 
@@ -50,9 +50,12 @@ public:
     Scalar(float v)             : m_type(e_float),          m_data() { m_data.flt       = v; }
     Scalar(double v)            : m_type(e_double),         m_data() { m_data.dbl       = v; }
     Scalar(long double v)       : m_type(e_long_double),    m_data() { m_data.ldbl      = v; }
-    Scalar(const Scalar& rhs);
+    Scalar(const Scalar& rhs)   : m_type(rhs.m_type),       m_data(rhs.m_data) {}
     //Scalar(const RegisterValue& reg_value);
-    virtual ~Scalar();
+
+    // Nothing derives from Scalar, so it has no vtable and copying one is
+    // just copying its type and value.
+    ~Scalar() {}
 
     bool
     SignExtend (uint32_t bit_pos);
@@ -130,7 +133,12 @@ public:
     Scalar& operator= (float v);
     Scalar& operator= (double v);
     Scalar& operator= (long double v);
-    Scalar& operator= (const Scalar& rhs);      // Assignment operator
+    Scalar& operator= (const Scalar& rhs)       // Assignment operator
+    {
+        m_type = rhs.m_type;
+        m_data = rhs.m_data;
+        return *this;
+    }
     Scalar& operator+= (const Scalar& rhs);
     Scalar& operator<<= (const Scalar& rhs);    // Shift left
     Scalar& operator>>= (const Scalar& rhs);    // Shift right (arithmetic)
@@ -69,6 +69,12 @@ public:
         bool
         CalculateLineOffsets (uint32_t line = UINT32_MAX);
 
+        // Get the contents of a source file from the cache that is shared
+        // by all debuggers, reading or mapping it if it isn't there or is
+        // older than "mod_time".
+        static lldb::DataBufferSP
+        GetFileContents (const FileSpec &file_spec, const TimeValue &mod_time);
+
         FileSpec m_file_spec_orig;  // The original file spec that was used (can be different from m_file_spec)
         FileSpec m_file_spec;       // The actualy file spec being used (if the target has source mappings, this might be different from m_file_spec_orig)
         TimeValue m_mod_time;       // Keep the modification time that this file data is valid for
@@ -166,6 +172,15 @@ public:
                             uint32_t end_line, 
                             std::vector<uint32_t> &match_lines);
 
+    //------------------------------------------------------------------
+    // Get the modification time of the file that "file_spec" is read
+    // from once source path remappings are applied, so that callers
+    // that hold on to FindLinesMatchingRegex() results can tell when
+    // they are out of date.
+    //------------------------------------------------------------------
+    TimeValue
+    GetFileModificationTime (const FileSpec &file_spec);
+
 protected:
 
     FileSP
@@ -0,0 +1,149 @@
+//===-- Statistics.h --------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_Statistics_h_
+#define liblldb_Statistics_h_
+
+// C Includes
+#include <stdint.h>
+
+// C++ Includes
+// Other libraries and framework includes
+// Project includes
+#include "lldb/lldb-private.h"
+
+namespace lldb_private {
+
+//----------------------------------------------------------------------
+/// @class StatisticsCounter Statistics.h "lldb/Core/Statistics.h"
+/// @brief A named count that any thread can add to.
+///
+/// Counters are made once and never go away, so the place that counts
+/// something looks its counter up the first time through and keeps a
+/// reference:
+///
+/// @code
+///     static StatisticsCounter &g_bytes_read = Statistics::GetCounter ("process.memory.bytes-read");
+///     g_bytes_read.Add (bytes_read);
+/// @endcode
+///
+/// after which counting is a single atomic add.
+//----------------------------------------------------------------------
+class StatisticsCounter
+{
+public:
+    StatisticsCounter () :
+        m_value (0)
+    {
+    }
+
+    void
+    Add (uint64_t amount = 1)
+    {
+        __sync_add_and_fetch (&m_value, amount);
+    }
+
+    uint64_t
+    GetValue () const
+    {
+        return __sync_add_and_fetch (const_cast<uint64_t *>(&m_value), 0);
+    }
+
+    void
+    Reset ()
+    {
+        __sync_lock_test_and_set (&m_value, 0);
+    }
+
+protected:
+    uint64_t m_value;
+
+private:
+    DISALLOW_COPY_AND_ASSIGN (StatisticsCounter);
+};
+
+//----------------------------------------------------------------------
+/// @class StatisticsHistogram Statistics.h "lldb/Core/Statistics.h"
+/// @brief A named distribution of values that any thread can add to.
+///
+/// Values are counted in power of two buckets: bucket 0 holds zero,
+/// and bucket N holds the values from 2^(N-1) up to 2^N - 1. The
+/// count, sum and largest value are kept as well.
+//----------------------------------------------------------------------
+class StatisticsHistogram
+{
+public:
+    enum
+    {
+        eNumBuckets = 65
+    };
+
+    StatisticsHistogram ();
+
+    void
+    Add (uint64_t value);
+
+    uint64_t
+    GetCount () const;
+
+    uint64_t
+    GetSum () const;
+
+    uint64_t
+    GetMaximum () const;
+
+    uint64_t
+    GetBucketCount (uint32_t bucket_idx) const;
+
+    void
+    Reset ();
+
+protected:
+    uint64_t m_count;
+    uint64_t m_sum;
+    uint64_t m_maximum;
+    uint64_t m_buckets[eNumBuckets];
+
+private:
+    DISALLOW_COPY_AND_ASSIGN (StatisticsHistogram);
+};
+
+//----------------------------------------------------------------------
+/// @class Statistics Statistics.h "lldb/Core/Statistics.h"
+/// @brief The registry of all counters and histograms.
+///
+/// Names are dotted paths like "gdb-remote.packets.sent", which is how
+/// "statistics dump" groups them.
+//----------------------------------------------------------------------
+class Statistics
+{
+public:
+    static StatisticsCounter &
+    GetCounter (const char *name);
+
+    static StatisticsHistogram &
+    GetHistogram (const char *name);
+
+    //------------------------------------------------------------------
+    /// Dump every counter and histogram as a tree grouped by name, or
+    /// as a JSON object with an object for each level of the names.
+    //------------------------------------------------------------------
+    static void
+    Dump (Stream &s, bool json);
+
+    //------------------------------------------------------------------
+    /// Set every counter and histogram back to zero.
+    //------------------------------------------------------------------
+    static void
+    Reset ();
+};
+
+} // namespace lldb_private
+
+#endif // liblldb_Statistics_h_
@@ -0,0 +1,79 @@
+//===-- SymbolPreloader.h ---------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_SymbolPreloader_h_
+#define liblldb_SymbolPreloader_h_
+
+// C Includes
+// C++ Includes
+// Other libraries and framework includes
+// Project includes
+#include "lldb/lldb-private.h"
+
+namespace lldb_private {
+
+//----------------------------------------------------------------------
+/// @class SymbolPreloader SymbolPreloader.h "lldb/Core/SymbolPreloader.h"
+/// @brief Builds module symbol indexes on background threads.
+///
+/// Targets with the "target.preload-symbols" setting enabled hand the
+/// modules they load to the preloader, which calls
+/// Module::PreloadSymbols() for them on a few tasks in the shared
+/// ThreadPool. The queue is shared by all debuggers in the process, and
+/// a module that is queued by more than one target is only preloaded
+/// once.
+///
+/// Preloading is cooperative: a worker only starts on a module when it
+/// can take the module's mutex without waiting, so a module that the
+/// foreground is already using is put back at the end of the queue
+/// instead of making either thread wait on the other.
+//----------------------------------------------------------------------
+class SymbolPreloader
+{
+public:
+    //------------------------------------------------------------------
+    /// Queue the modules in a module list for preloading.
+    ///
+    /// @param[in] module_list
+    ///     The modules to preload.
+    ///
+    /// @param[in] owner
+    ///     An opaque key for the client that queued the modules, which
+    ///     can be used to cancel them with SymbolPreloader::Cancel().
+    ///
+    /// @param[in] prioritize
+    ///     If \b true, put the modules at the front of the queue, moving
+    ///     them there if they were already queued.
+    //------------------------------------------------------------------
+    static void
+    Enqueue (ModuleList &module_list, const void *owner, bool prioritize = false);
+
+    //------------------------------------------------------------------
+    /// Remove all modules that were queued by \a owner and that no
+    /// worker has started on yet.
+    //------------------------------------------------------------------
+    static void
+    Cancel (const void *owner);
+
+    //------------------------------------------------------------------
+    /// Drop all queued modules and wait for the running preload tasks.
+    //------------------------------------------------------------------
+    static void
+    Terminate ();
+
+private:
+    static void
+    PreloadTask (void *baton);
+
+    DISALLOW_COPY_AND_ASSIGN (SymbolPreloader);
+};
+
+} // namespace lldb_private
+
+#endif  // liblldb_SymbolPreloader_h_
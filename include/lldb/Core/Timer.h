@@ -14,6 +14,7 @@
 #include <memory>
 #include <stdio.h>
 #include "lldb/lldb-private.h"
+#include "lldb/Core/Error.h"
 #include "lldb/Host/TimeValue.h"
 
 namespace lldb_private {
@@ -38,13 +39,22 @@ public:
 
     //--------------------------------------------------------------
     /// Default constructor.
+    ///
+    /// While timers are disabled (the display depth is zero) this
+    /// only reads the display depth. Enabled timers add their times
+    /// to the category times of the current thread, which
+    /// DumpCategoryTimes() adds up over all threads.
     //--------------------------------------------------------------
     Timer(const char *category, const char *format, ...)  LLDB_ATTR(__attribute__ ((format (printf, 3, 4))));
 
     //--------------------------------------------------------------
     /// Desstructor
     //--------------------------------------------------------------
-    ~Timer();
+    ~Timer()
+    {
+        if (m_started)
+            Stop ();
+    }
 
     void
     Dump ();
@@ -61,8 +71,28 @@ public:
     static void
     ResetCategoryTimes ();
 
+    //--------------------------------------------------------------
+    /// Record when each timer starts and stops, on every thread, until
+    /// StopRecording() writes the events to \a path as a Chrome trace
+    /// (JSON that chrome://tracing and flame graph tools load).
+    ///
+    /// Timers are enabled while recording, and go back to the display
+    /// depth they had when recording stops.
+    //--------------------------------------------------------------
+    static Error
+    StartRecording (const char *path);
+
+    static bool
+    IsRecording ();
+
+    static Error
+    StopRecording (size_t &num_events);
+
 protected:
 
+    void
+    Stop ();
+
     void
     ChildStarted (const TimeValue& time);
 
@@ -83,7 +113,8 @@ protected:
     TimeValue m_timer_start;
     uint64_t m_total_ticks; // Total running time for this timer including when other timers below this are running
     uint64_t m_timer_ticks; // Ticks for this timer that do not include when other timers below this one are running
-    static uint32_t g_depth;
+    bool m_started;         // True if timers were enabled when this one was made
+    bool m_traced;          // True if this timer recorded a start event
     static uint32_t g_display_depth;
     static FILE * g_file;
 private:
@@ -16,6 +16,7 @@
 #include <vector>
 
 #include "lldb/Core/RegularExpression.h"
+#include "lldb/Host/ThreadPool.h"
 
 namespace lldb_private {
 
@@ -81,6 +82,17 @@ public:
         m_map.push_back (e);
     }
 
+    //------------------------------------------------------------------
+    // Append all of the entries in "rhs" with at most one reallocation.
+    // Like the other Append() functions, this should be followed by a
+    // call to UniqueCStringMap::Sort().
+    //------------------------------------------------------------------
+    void
+    Append (const UniqueCStringMap<T> &rhs)
+    {
+        m_map.insert (m_map.end(), rhs.m_map.begin(), rhs.m_map.end());
+    }
+
     void
     Clear ()
     {
@@ -236,10 +248,19 @@ public:
     {
         const size_t start_size = values.size();
 
+        // Entries with the same name are next to each other once the map
+        // is sorted, so only run the regular expression once per name
+        const char *last_cstring = NULL;
+        bool last_matched = false;
         const_iterator pos, end = m_map.end();
         for (pos = m_map.begin(); pos != end; ++pos)
         {
-            if (regex.Execute(pos->cstring))
+            if (pos->cstring != last_cstring)
+            {
+                last_cstring = pos->cstring;
+                last_matched = regex.Execute(pos->cstring);
+            }
+            if (last_matched)
                 values.push_back (pos->value);
         }
 
@@ -294,6 +315,53 @@ public:
     {
         std::sort (m_map.begin(), m_map.end());
     }
+
+    //------------------------------------------------------------------
+    // Sort the contents of this map in up to "max_threads" pieces on the
+    // shared thread pool. The map is split into runs that are sorted
+    // concurrently, then pairs of neighboring runs are merged
+    // concurrently until one run is left. Maps that are too small to
+    // make this worth it are sorted on the calling thread.
+    //------------------------------------------------------------------
+    void
+    Sort (uint32_t max_threads)
+    {
+        const size_t size = m_map.size();
+        size_t num_runs = std::min<size_t> (max_threads, size / MinEntriesPerSortThread);
+        if (num_runs <= 1)
+        {
+            Sort ();
+            return;
+        }
+
+        std::vector<size_t> run_starts;
+        for (size_t i=0; i<num_runs; ++i)
+            run_starts.push_back (i * size / num_runs);
+        run_starts.push_back (size);
+
+        std::vector<SortTask> tasks;
+        for (size_t i=0; i<num_runs; ++i)
+            tasks.push_back (SortTask (&m_map, run_starts[i], run_starts[i + 1], run_starts[i + 1]));
+        RunSortTasks (tasks);
+
+        while (run_starts.size() > 2)
+        {
+            std::vector<size_t> merged_run_starts;
+            tasks.clear();
+            size_t i;
+            for (i=0; i + 2 < run_starts.size(); i += 2)
+            {
+                tasks.push_back (SortTask (&m_map, run_starts[i], run_starts[i + 1], run_starts[i + 2]));
+                merged_run_starts.push_back (run_starts[i]);
+            }
+            // An odd run out is merged in the next round
+            if (i + 1 < run_starts.size())
+                merged_run_starts.push_back (run_starts[i]);
+            merged_run_starts.push_back (size);
+            RunSortTasks (tasks);
+            run_starts.swap (merged_run_starts);
+        }
+    }
     
     //------------------------------------------------------------------
     // Since we are using a vector to contain our items it will always 
@@ -318,6 +386,53 @@ protected:
     typedef typename collection::iterator iterator;
     typedef typename collection::const_iterator const_iterator;
     collection m_map;
+
+private:
+    // Don't bother making a task to sort fewer entries than this
+    enum { MinEntriesPerSortThread = 64 * 1024 };
+
+    // Sorts [start, end) if middle == end, else merges the sorted ranges
+    // [start, middle) and [middle, end). Tasks only touch their own
+    // range of the collection so they can run concurrently.
+    struct SortTask
+    {
+        SortTask (collection *c, size_t s, size_t m, size_t e) :
+            map (c),
+            start (s),
+            middle (m),
+            end (e)
+        {
+        }
+
+        collection *map;
+        size_t start;
+        size_t middle;
+        size_t end;
+    };
+
+    static void
+    RunSortTask (void *baton)
+    {
+        SortTask *task = (SortTask *)baton;
+        iterator begin = task->map->begin();
+        if (task->middle == task->end)
+            std::sort (begin + task->start, begin + task->end);
+        else
+            std::inplace_merge (begin + task->start, begin + task->middle, begin + task->end);
+    }
+
+    static void
+    RunSortTasks (std::vector<SortTask> &tasks)
+    {
+        if (tasks.empty())
+            return;
+        // Waiting runs the tasks that haven't started on this thread, so
+        // this is safe to call from a task on the pool
+        ThreadPool::TaskGroup task_group (ThreadPool::GetSharedThreadPool());
+        for (size_t i=0; i<tasks.size(); ++i)
+            task_group.AddTask (RunSortTask, &tasks[i]);
+        task_group.Wait();
+    }
 };
 
 
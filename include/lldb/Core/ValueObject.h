@@ -740,6 +740,15 @@ public:
     uint32_t
     GetNumChildren ();
 
+    //------------------------------------------------------------------
+    // Like GetNumChildren(), but values whose children are expensive to
+    // count, like the synthetic children of a big container, can stop
+    // counting at "max". A result smaller than "max" is the real number
+    // of children.
+    //------------------------------------------------------------------
+    uint32_t
+    GetNumChildren (uint32_t max);
+
     const Value &
     GetValue() const;
 
@@ -759,6 +768,51 @@ public:
     GetSummaryAsCString (TypeSummaryImpl* summary_ptr,
                          std::string& destination);
     
+    //------------------------------------------------------------------
+    /// Get what the results of data formatters for this value can be
+    /// cached against.
+    ///
+    /// Running an expression bumps the stop ID and makes every value
+    /// update, but a formatter that only reads the value and the memory
+    /// it points to will give the same result as long as the process
+    /// hasn't stopped for any other reason, nothing wrote to its memory
+    /// and the bytes of the value are the same, so scripted summaries and
+    /// synthetic children are only run again when one of these changes.
+    ///
+    /// @param[out] natural_stop_id
+    ///     The process' natural stop ID, see ProcessModID::GetNaturalStopID().
+    ///
+    /// @param[out] memory_id
+    ///     The process' memory ID, which changes with every memory write
+    ///     so that a value pointing at memory an expression wrote to is
+    ///     formatted again.
+    ///
+    /// @param[out] data
+    ///     A copy of the bytes of this value.
+    ///
+    /// @return
+    ///     False if this value can't be cached against, because it has
+    ///     no process or no bytes.
+    //------------------------------------------------------------------
+    bool
+    GetFormatterCacheKey (uint32_t &natural_stop_id,
+                          uint32_t &memory_id,
+                          std::string &data);
+    
+    //------------------------------------------------------------------
+    /// Get the range of load addresses this value was read from the
+    /// last time it was updated, without updating it.
+    ///
+    /// Lets the memory of many values be read ahead with one read
+    /// before they are updated, see ValueObjectList::PrefetchMemory().
+    ///
+    /// @return
+    ///     False if the value wasn't read from process memory.
+    //------------------------------------------------------------------
+    bool
+    GetLastLoadAddressRange (lldb::addr_t &load_addr,
+                             size_t &byte_size) const;
+    
     const char *
     GetObjectDescription ();
     
@@ -1051,11 +1105,13 @@ public:
 protected:
     typedef ClusterManager<ValueObject> ValueObjectManager;
     
+    // The children of a value are guarded by the mutex of the whole
+    // cluster, rather than each value in a big tree having its own
     class ChildrenManager
     {
     public:
-        ChildrenManager() :
-        m_mutex(Mutex::eMutexTypeRecursive),
+        ChildrenManager(Mutex &mutex) :
+        m_mutex(mutex),
         m_children(),
         m_children_count(0)
         {}
@@ -1063,7 +1119,7 @@ protected:
         bool
         HasChildAtIndex (uint32_t idx)
         {
-            Mutex::Locker(m_mutex);
+            Mutex::Locker locker(m_mutex);
             ChildrenIterator iter = m_children.find(idx);
             ChildrenIterator end = m_children.end();
             return (iter != end);
@@ -1072,7 +1128,7 @@ protected:
         ValueObject*
         GetChildAtIndex (uint32_t idx)
         {
-            Mutex::Locker(m_mutex);
+            Mutex::Locker locker(m_mutex);
             ChildrenIterator iter = m_children.find(idx);
             ChildrenIterator end = m_children.end();
             if (iter == end)
@@ -1085,7 +1141,7 @@ protected:
         SetChildAtIndex (uint32_t idx, ValueObject* valobj)
         {
             ChildrenPair pair(idx,valobj); // we do not need to be mutex-protected to make a pair
-            Mutex::Locker(m_mutex);
+            Mutex::Locker locker(m_mutex);
             m_children.insert(pair);
         }
         
@@ -1104,8 +1160,8 @@ protected:
         void
         Clear()
         {
+            Mutex::Locker locker(m_mutex);
             m_children_count = 0;
-            Mutex::Locker(m_mutex);
             m_children.clear();
         }
         
@@ -1113,7 +1169,7 @@ protected:
         typedef std::map<uint32_t, ValueObject*> ChildrenMap;
         typedef ChildrenMap::iterator ChildrenIterator;
         typedef ChildrenMap::value_type ChildrenPair;
-        Mutex m_mutex;
+        Mutex &m_mutex;
         ChildrenMap m_children;
         uint32_t m_children_count;
     };
@@ -1163,10 +1219,24 @@ protected:
     ProcessModID                m_user_id_of_forced_summary;
     AddressType                 m_address_type_of_ptr_or_ref_children;
     
+    // The last result of a summary that isn't a summary string, which is
+    // reused while the formatter cache key stays the same
+    TypeSummaryImpl *           m_cached_summary_format;
+    uint32_t                    m_cached_summary_format_mgr_revision;
+    uint32_t                    m_cached_summary_stop_id;
+    uint32_t                    m_cached_summary_memory_id;
+    std::string                 m_cached_summary_data;
+    std::string                 m_cached_summary_str;
+    
+    // A hash of m_data from the last update, so that an update that
+    // finds the same bytes can keep the strings made from them
+    uint64_t                    m_data_hash;
+    
     bool                m_value_is_valid:1,
                         m_value_did_change:1,
                         m_children_count_valid:1,
                         m_old_value_valid:1,
+                        m_data_hash_valid:1,
                         m_is_deref_of_parent:1,
                         m_is_array_item_for_pointer:1,
                         m_is_bitfield_for_scalar:1,
@@ -1223,6 +1293,14 @@ protected:
     virtual uint32_t
     CalculateNumChildren() = 0;
 
+    // Should only be called by ValueObject::GetNumChildren(uint32_t)
+    virtual uint32_t
+    CalculateNumChildrenUpTo (uint32_t max)
+    {
+        const uint32_t num_children = CalculateNumChildren();
+        return num_children < max ? num_children : max;
+    }
+
     void
     SetNumChildren (uint32_t num_children);
 
@@ -1235,6 +1313,14 @@ protected:
     void
     ClearUserVisibleData(uint32_t items = ValueObject::eClearUserVisibleDataItemsAllStrings);
     
+    //------------------------------------------------------------------
+    // Returns true if the value, summary and description strings can
+    // only change when the bytes of this value do, so an update that
+    // finds the same bytes can keep them.
+    //------------------------------------------------------------------
+    bool
+    DisplayDependsOnlyOnData ();
+    
     void
     AddSyntheticChild (const ConstString &key,
                        ValueObject *valobj);
@@ -81,6 +81,12 @@ protected:
     virtual bool
     UpdateValue ();
 
+    bool
+    GetDataFromParent (ValueObject &parent);
+
+    void
+    PrefetchPointee (ValueObject &parent, lldb::addr_t addr);
+
     virtual clang::ASTContext *
     GetClangASTImpl ()
     {
@@ -91,6 +91,7 @@ public:
     SetClangAST (clang::ASTContext *ast)
     {
         m_clang_ast = ast;
+        RetainScratchClangASTContext ();
         return true;
     }
 
@@ -150,9 +151,14 @@ protected:
     uint32_t m_byte_size;
     
     ValueObjectConstResultImpl m_impl;
+    lldb::ClangASTContextSP m_scratch_ast_context_sp; // Keeps m_clang_ast alive if it is a target's scratch AST context
 
 private:
     friend class ValueObjectConstResultImpl;
+    
+    void
+    RetainScratchClangASTContext ();
+    
     ValueObjectConstResult (ExecutionContextScope *exe_scope,
                             lldb::ByteOrder byte_order, 
                             uint32_t addr_byte_size,
@@ -75,6 +75,24 @@ public:
     void
     Swap (ValueObjectList &value_object_list);
     
+    //------------------------------------------------------------------
+    /// Read the memory of all the values in the list into the process'
+    /// memory cache with one batched read before they get updated after
+    /// a stop, using the addresses they had when they were last updated.
+    /// Values that moved just read their memory on their own.
+    //------------------------------------------------------------------
+    void
+    PrefetchMemory ();
+
+    //------------------------------------------------------------------
+    /// Read the start of the C strings that the char pointers in the
+    /// list point to into the process' memory cache with one batched
+    /// read, so that their summaries don't each have to read from the
+    /// process. The char pointers get updated.
+    //------------------------------------------------------------------
+    void
+    PrefetchPointedStrings ();
+    
 protected:
     typedef std::vector<lldb::ValueObjectSP> collection;
     //------------------------------------------------------------------
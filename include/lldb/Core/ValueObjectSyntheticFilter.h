@@ -42,6 +42,9 @@ public:
     virtual uint32_t
     CalculateNumChildren();
 
+    virtual uint32_t
+    CalculateNumChildrenUpTo (uint32_t max);
+
     virtual lldb::ValueType
     GetValueType() const;
     
@@ -124,6 +127,13 @@ protected:
     ByIndexMap      m_children_byindex;
     NameToIndexMap  m_name_toindex;
     uint32_t        m_synthetic_children_count; // FIXME use the ValueObject's ChildrenManager instead of a special purpose solution
+    
+    // The parent's formatter cache key the last time the front end was
+    // updated, it doesn't need to be updated again while it stays the same
+    bool            m_update_key_valid;
+    uint32_t        m_update_stop_id;
+    uint32_t        m_update_memory_id;
+    std::string     m_update_parent_data;
 
 private:
     friend class ValueObject;
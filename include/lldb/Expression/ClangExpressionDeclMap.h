@@ -106,6 +106,23 @@ public:
     //------------------------------------------------------------------
     void 
     DidParse ();
+
+    //------------------------------------------------------------------
+    /// [Used by ClangUserExpression] Point the state that was set up
+    /// for parsing at a new execution context, so that the expression
+    /// can be materialized and run there without being parsed again.
+    /// The next run gets a new result variable, so the results of
+    /// earlier runs are left alone.
+    ///
+    /// @param[in] exe_ctx
+    ///     The execution context to materialize the expression in next.
+    ///
+    /// @return
+    ///     True on success; false if the parser state is gone or a
+    ///     new result variable couldn't be made.
+    //------------------------------------------------------------------
+    bool
+    ResetExecutionContext (ExecutionContext &exe_ctx);
     
     //------------------------------------------------------------------
     /// [Used by IRForTarget] Get a new result variable name of the form
@@ -723,6 +740,7 @@ private:
             m_struct_size(0),
             m_struct_laid_out(false),
             m_result_name(),
+            m_result_flags(0),
             m_object_pointer_type(NULL, NULL)
         {
         }
@@ -731,6 +749,7 @@ private:
         size_t                      m_struct_size;              ///< The size of the struct in bytes.
         bool                        m_struct_laid_out;          ///< True if the struct has been laid out and the layout is valid (that is, no new fields have been added since).
         ConstString                 m_result_name;              ///< The name of the result variable ($1, for example)
+        ClangExpressionVariable::FlagType m_result_flags;       ///< The flags the result variable was created with, used to make a new one when the expression is run again
         TypeFromUser                m_object_pointer_type;      ///< The type of the "this" variable, if one exists
     };
     
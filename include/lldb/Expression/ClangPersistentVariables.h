@@ -63,6 +63,29 @@ public:
     clang::TypeDecl *
     GetPersistentType (const ConstString &name);
     
+    //----------------------------------------------------------------------
+    /// Get the number of bytes the values of the persistent variables take
+    /// up in LLDB.
+    //----------------------------------------------------------------------
+    size_t
+    GetValueByteSize ();
+    
+    //----------------------------------------------------------------------
+    /// Move the persistent variables and types that use types from
+    /// \a src_ast over to \a dst_ast, so \a src_ast can be thrown away.
+    /// The variables get new value objects, since the old ones may have
+    /// children that use types from \a src_ast.
+    ///
+    /// @return
+    ///     True if everything was moved.  If anything couldn't be, nothing
+    ///     is changed.
+    //----------------------------------------------------------------------
+    bool
+    MigrateToASTContext (ClangASTImporter &importer,
+                         ExecutionContextScope *exe_scope,
+                         clang::ASTContext *dst_ast,
+                         clang::ASTContext *src_ast);
+    
 private:
     uint32_t                                                m_next_persistent_variable_id;  ///< The counter used by GetNextResultName().
     
@@ -146,6 +146,25 @@ public:
              ClangUserExpressionSP &shared_ptr_to_me,
              lldb::ClangExpressionVariableSP &result,
              uint32_t single_thread_timeout_usec = 500000);
+
+    //------------------------------------------------------------------
+    /// Point an expression that was parsed and JIT compiled at a new
+    /// execution context, so it can be executed again without being
+    /// parsed again. The variables the expression uses are the ones
+    /// that were found when it was parsed, so the new context should
+    /// be in the same block as the one it was parsed in.
+    ///
+    /// @param[in] exe_ctx
+    ///     The execution context to run the expression in next.
+    ///
+    /// @return
+    ///     True if the expression can be executed in  exe_ctx; false
+    ///     if it has to be parsed again, for instance because it was
+    ///     evaluated by the IR interpreter or compiled for another
+    ///     process.
+    //------------------------------------------------------------------
+    bool
+    ResetExecutionContext (ExecutionContext &exe_ctx);
              
     ThreadPlan *
     GetThreadPlanToExecuteJITExpression (Stream &error_stream,
@@ -343,6 +362,35 @@ public:
                        lldb::ValueObjectSP &result_valobj_sp,
                        Error &error,
                        uint32_t single_thread_timeout_usec = 500000);
+
+    //------------------------------------------------------------------
+    /// Evaluate an expression like EvaluateWithError(), but hold on to
+    /// the JIT compiled code so that evaluating it again in the same
+    /// block doesn't have to parse it again.
+    ///
+    /// @param[in/out] cached_expr_sp
+    ///     If this holds an expression from an earlier call that can
+    ///     be reset to  exe_ctx (see ResetExecutionContext()), it is
+    ///     run again and  expr_cstr is ignored. Otherwise
+    ///      expr_cstr is parsed. On return this holds the expression
+    ///     if it can be run again, and is empty if it can't, which
+    ///     includes expressions that the IR interpreter evaluated while
+    ///     parsing them and expressions that failed.
+    ///
+    /// The other parameters are the same as for EvaluateWithError().
+    //------------------------------------------------------------------
+    static ExecutionResults
+    EvaluateWithCache (ExecutionContext &exe_ctx,
+                       lldb_private::ExecutionPolicy execution_policy,
+                       lldb::LanguageType language,
+                       ResultType desired_type,
+                       bool discard_on_error,
+                       const char *expr_cstr,
+                       const char *expr_prefix,
+                       ClangUserExpressionSP &cached_expr_sp,
+                       lldb::ValueObjectSP &result_valobj_sp,
+                       Error &error,
+                       uint32_t single_thread_timeout_usec = 500000);
     
     static const Error::ValueType kNoResult = 0x1001; ///< ValueObject::GetError() returns this if there is no result from the expression.
 private:
@@ -10,6 +10,8 @@
 #ifndef liblldb_DWARFExpression_h_
 #define liblldb_DWARFExpression_h_
 
+#include <vector>
+
 #include "lldb/lldb-private.h"
 #include "lldb/Core/ClangForward.h"
 #include "lldb/Core/Address.h"
@@ -413,6 +415,90 @@ protected:
                  uint32_t &offset, 
                  uint32_t &len);
 
+    //------------------------------------------------------------------
+    /// Most variable locations are a single operation like DW_OP_fbreg
+    /// or DW_OP_regN, sometimes followed by a DW_OP_plus_uconst. These
+    /// are decoded once and then evaluated without the interpreter.
+    //------------------------------------------------------------------
+    enum SimpleExpressionKind
+    {
+        eSimpleExpressionUnknown = 0,       // Not decoded yet
+        eSimpleExpressionNone,              // Needs the interpreter
+        eSimpleExpressionAddress,           // DW_OP_addr
+        eSimpleExpressionRegister,          // DW_OP_regN or DW_OP_regx
+        eSimpleExpressionRegisterOffset,    // DW_OP_bregN or DW_OP_bregx
+        eSimpleExpressionFrameBaseOffset    // DW_OP_fbreg
+    };
+
+    struct SimpleExpression
+    {
+        SimpleExpressionKind kind;
+        uint32_t reg_num;           // The register for the register kinds
+        uint64_t address;           // The DW_OP_addr operand
+        int64_t offset;             // The DW_OP_bregN, DW_OP_bregx or DW_OP_fbreg offset
+        bool has_plus_uconst;       // True if followed by DW_OP_plus_uconst
+        uint32_t plus_uconst;
+    };
+
+    static bool
+    DecodeSimpleExpression (const DataExtractor& opcodes,
+                            uint32_t offset,
+                            uint32_t length,
+                            SimpleExpression &simple_expr);
+
+    static bool
+    EvaluateSimpleExpression (ExecutionContext *exe_ctx,
+                              clang::ASTContext *ast_context,
+                              RegisterContext *reg_ctx,
+                              const uint32_t reg_kind,
+                              const SimpleExpression &simple_expr,
+                              Value& result,
+                              Error *error_ptr);
+
+    //------------------------------------------------------------------
+    /// The entries of a location list that have opcodes, with their
+    /// opcodes decoded, sorted by address so the entry for a PC can be
+    /// found with a binary search. Built the first time the list is
+    /// used.
+    //------------------------------------------------------------------
+    struct LocationListEntry
+    {
+        lldb::addr_t lo_pc;             // As it is in the list, before sliding
+        lldb::addr_t hi_pc;
+        uint32_t offset;                // Offset of the opcodes in m_data
+        uint32_t length;
+        SimpleExpression simple_expr;
+    };
+    typedef std::vector<LocationListEntry> LocationListIndex;
+
+    enum LocationListIndexState
+    {
+        eLocationListIndexNotBuilt = 0,
+        eLocationListIndexSorted,       // Sorted by address, binary search it
+        eLocationListIndexOverlapping   // Entries overlap, in list order, search it in order
+    };
+
+    static bool
+    LocationListEntryLessThan (const LocationListEntry &lhs, const LocationListEntry &rhs);
+
+    static bool
+    PCLessThanLocationListEntry (lldb::addr_t pc, const LocationListEntry &entry);
+
+    void
+    BuildLocationListIndex () const;
+
+    const LocationListEntry *
+    FindLocationListEntry (lldb::addr_t loclist_base_addr, lldb::addr_t pc) const;
+
+    void
+    OpcodesChanged ()
+    {
+        m_simple_expr.kind = eSimpleExpressionUnknown;
+        m_loclist_index.clear();
+        m_loclist_index_state = eLocationListIndexNotBuilt;
+        m_loclist_last_idx = 0;
+    }
+
     //------------------------------------------------------------------
     /// Classes that inherit from DWARFExpression can see and modify these
     //------------------------------------------------------------------
@@ -422,6 +508,10 @@ protected:
     lldb::addr_t m_loclist_slide;               ///< A value used to slide the location list offsets so that 
                                                 ///< they are relative to the object that owns the location list
                                                 ///< (the function for frame base and variable location lists)
+    mutable SimpleExpression m_simple_expr;     ///< \a m_data decoded, when it isn't a location list
+    mutable LocationListIndex m_loclist_index;  ///< \a m_data decoded, when it is a location list
+    mutable LocationListIndexState m_loclist_index_state;
+    mutable uint32_t m_loclist_last_idx;        ///< The entry the last lookup found, which is checked first
 
 };
 
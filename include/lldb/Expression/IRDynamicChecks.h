@@ -107,9 +107,16 @@ public:
     /// @param[in] decl_map
     ///     The mapping used to look up entities in the target process. In
     ///     this case, used to find objc_msgSend
+    ///
+    /// @param[in] batch_checks
+    ///     If true, pointers that are computed in the entry block are
+    ///     checked once there instead of at every dereference.  Such a
+    ///     pointer is checked even if the expression never ends up
+    ///     dereferencing it.
     //------------------------------------------------------------------
     IRDynamicChecks (DynamicCheckerFunctions &checker_functions,
-                     const char* func_name = "$__lldb_expr");
+                     const char* func_name = "$__lldb_expr",
+                     bool batch_checks = false);
     
     //------------------------------------------------------------------
     /// Destructor
@@ -162,6 +169,7 @@ private:
     
     std::string                 m_func_name;            ///< The name of the function to add checks to
     DynamicCheckerFunctions    &m_checker_functions;    ///< The checker functions for the process
+    bool                        m_batch_checks;         ///< True if pointer checks should be moved to the entry block where possible
 };
     
 }
@@ -35,6 +35,11 @@ class ClangExpressionDeclMap;
 /// In some cases, the IR for an expression can be evaluated entirely
 /// in the debugger, manipulating variables but not executing any code
 /// in the target.  The IRInterpreter attempts to do this.
+///
+/// It handles integer and float/double arithmetic, comparisons and
+/// conversions, branches and loops, and calls to a few library functions
+/// that only read memory (strlen(), strcmp(), strncmp() and memcmp()),
+/// which it runs itself.
 //----------------------------------------------------------------------
 class IRInterpreter
 {
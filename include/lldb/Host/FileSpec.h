@@ -601,6 +601,38 @@ public:
     static size_t
     ResolvePartialUsername (const char *partial_name, StringList &matches);
 
+    //------------------------------------------------------------------
+    /// Resolved paths and the results of stat() are shared by the whole
+    /// process for a few seconds, since the same paths get checked over
+    /// and over while matching modules and locating symbol and source
+    /// files, and each check can be a slow round trip on a network file
+    /// system. Exists(), GetByteSize(), GetFileType(),
+    /// GetModificationTime() and Resolve() all use the cache.
+    ///
+    /// @param[in] timeout_sec
+    ///     How many seconds a result is used for, zero turns the cache
+    ///     off.
+    //------------------------------------------------------------------
+    static void
+    SetFileCacheTimeout (uint32_t timeout_sec);
+
+    static uint32_t
+    GetFileCacheTimeout ();
+
+    //------------------------------------------------------------------
+    /// Forget all of the cached path and stat() results, for when files
+    /// are expected to have changed, like before a process is launched.
+    //------------------------------------------------------------------
+    static void
+    ClearFileCache ();
+
+    //------------------------------------------------------------------
+    /// Forget the cached stat() results for this file, for when it was
+    /// just written.
+    //------------------------------------------------------------------
+    void
+    ClearCachedFileInfo () const;
+
     enum EnumerateDirectoryResult
     {
         eEnumerateDirectoryResultNext,  // Enumerate next entry in the current directory
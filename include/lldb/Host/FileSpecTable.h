@@ -0,0 +1,67 @@
+//===-- FileSpecTable.h -----------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_FileSpecTable_h_
+#define liblldb_FileSpecTable_h_
+#if defined(__cplusplus)
+
+#include "lldb/lldb-private.h"
+#include "lldb/Host/FileSpec.h"
+
+namespace lldb_private {
+
+//----------------------------------------------------------------------
+/// @class FileSpecTable FileSpecTable.h "lldb/Host/FileSpecTable.h"
+/// @brief A process wide table of uniqued file specifications.
+///
+/// Thousands of compile units list the same headers in their support
+/// files, and every type, function and variable declaration names one
+/// of them. Storing a small index into this table instead of a
+/// FileSpec in each of those places saves a lot of memory, and two
+/// indexes are equal exactly when the directory and filename of the
+/// two FileSpec objects are.
+///
+/// Like the ConstString pool, entries are never removed. Index zero is
+/// always the empty FileSpec, and references returned by
+/// GetFileSpecAtIndex() stay valid for the life of the process.
+//----------------------------------------------------------------------
+class FileSpecTable
+{
+public:
+    //------------------------------------------------------------------
+    /// Get the index of the entry matching \a file_spec, adding one if
+    /// there isn't one yet. Passing a reference that came from
+    /// GetFileSpecAtIndex() doesn't need to take any locks.
+    //------------------------------------------------------------------
+    static uint32_t
+    GetIndexForFileSpec (const FileSpec &file_spec);
+
+    //------------------------------------------------------------------
+    /// Get the index of the entry matching \a file_spec without adding
+    /// one.
+    ///
+    /// @return
+    ///     The index of the matching entry, or UINT32_MAX if
+    ///     \a file_spec isn't in the table, in which case nothing that
+    ///     stores indexes can refer to it either.
+    //------------------------------------------------------------------
+    static uint32_t
+    FindIndexForFileSpec (const FileSpec &file_spec);
+
+    //------------------------------------------------------------------
+    /// Get the entry at \a idx. This doesn't take any locks.
+    //------------------------------------------------------------------
+    static const FileSpec &
+    GetFileSpecAtIndex (uint32_t idx);
+};
+
+} // namespace lldb_private
+
+#endif  // #if defined(__cplusplus)
+#endif  // liblldb_FileSpecTable_h_
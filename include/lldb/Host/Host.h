@@ -88,6 +88,50 @@ public:
     static size_t
     GetPageSize();
 
+    //------------------------------------------------------------------
+    /// Get the number of CPUs that are online on the host system.
+    ///
+    /// @return
+    ///     The number of online CPUs, or 1 if the number can't be
+    ///     determined.
+    //------------------------------------------------------------------
+    static uint32_t
+    GetNumberCPUs ();
+
+    typedef void (*ShardCallback) (void *baton, 
+                                   uint32_t shard_idx, 
+                                   size_t begin_idx, 
+                                   size_t end_idx);
+
+    //------------------------------------------------------------------
+    /// Get how many shards Host::RunShards() should split \a num_items
+    /// items into so that each shard has at least \a min_shard_size
+    /// items, with no more shards than the shared thread pool has
+    /// threads.
+    ///
+    /// @return
+    ///     The number of shards, which is at least 1.
+    //------------------------------------------------------------------
+    static uint32_t
+    GetNumberOfShards (size_t num_items, size_t min_shard_size);
+
+    //------------------------------------------------------------------
+    /// Split the items [0, num_items) into \a num_shards contiguous
+    /// ranges and call \a callback once for each of them. The ranges
+    /// run on the shared ThreadPool, with the calling thread doing the
+    /// first one, and this returns once all of them are done.
+    ///
+    /// Callers usually keep one result per shard, indexed by the
+    /// shard index passed to \a callback, and merge the results in
+    /// shard order afterwards so they come out the same as if the
+    /// items were visited in order on one thread.
+    //------------------------------------------------------------------
+    static void
+    RunShards (size_t num_items, 
+               uint32_t num_shards, 
+               ShardCallback callback, 
+               void *baton);
+
     //------------------------------------------------------------------
     /// Returns the endianness of the host system.
     ///
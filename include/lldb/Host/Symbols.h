@@ -14,6 +14,8 @@
 #include <stdint.h>
 
 // C++ Includes
+#include <vector>
+
 // Other libraries and framework includes
 // Project includes
 #include "lldb/Host/FileSpec.h"
@@ -28,6 +30,39 @@ public:
 
     static FileSpec
     LocateExecutableSymbolFile (const ModuleSpec &module_spec);
+
+    //------------------------------------------------------------------
+    /// Locate the symbol files for many modules at once.
+    ///
+    /// The searches are spread over several threads. UUIDs that a
+    /// previous search found nothing for are not searched for again
+    /// until ClearMissingSymbolFileCache() is called.
+    ///
+    /// @param[in] module_specs
+    ///     The modules to find symbol files for. Any source remappings
+    ///     the searches find are added to each spec, just like
+    ///     LocateExecutableSymbolFile() does.
+    ///
+    /// @param[out] symbol_files
+    ///     Filled in with one entry for each module spec, which is
+    ///     invalid if no symbol file was found.
+    ///
+    /// @return
+    ///     The number of symbol files that were found.
+    //------------------------------------------------------------------
+    static size_t
+    LocateExecutableSymbolFiles (std::vector<ModuleSpec> &module_specs,
+                                 std::vector<FileSpec> &symbol_files);
+
+    //------------------------------------------------------------------
+    /// Returns true if a search for the symbol file for \a uuid already
+    /// came up empty.
+    //------------------------------------------------------------------
+    static bool
+    SymbolFileIsKnownMissing (const UUID &uuid);
+
+    static void
+    ClearMissingSymbolFileCache ();
 };
 
 } // namespace lldb_private
@@ -0,0 +1,210 @@
+//===-- ThreadPool.h --------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_ThreadPool_h_
+#define liblldb_ThreadPool_h_
+#if defined(__cplusplus)
+
+// C Includes
+// C++ Includes
+#include <deque>
+
+// Other libraries and framework includes
+// Project includes
+#include "lldb/lldb-defines.h"
+#include "lldb/lldb-types.h"
+#include "lldb/Host/Condition.h"
+#include "lldb/Host/Mutex.h"
+
+// The most worker threads a pool will ever run
+#define THREAD_POOL_MAX_NUM_THREADS 64
+
+namespace lldb_private {
+
+//----------------------------------------------------------------------
+/// @class ThreadPool ThreadPool.h "lldb/Host/ThreadPool.h"
+/// @brief A pool of worker threads that runs short tasks.
+///
+/// Work is handed to the pool through a ThreadPool::TaskGroup, which
+/// can wait for all of the tasks that were added to it and cancel the
+/// ones that haven't started yet.
+///
+/// Each worker thread has its own queue. Tasks added from a worker go
+/// on its own queue and are run newest first, which keeps the data a
+/// task just touched in its cache. A worker that runs out of tasks
+/// takes the oldest task from the other workers' queues. Tasks added
+/// from other threads go on a queue that all the workers share.
+///
+/// Waiting for a group runs the group's tasks that haven't started yet
+/// on the waiting thread. Tasks can start groups of their own and wait
+/// for them without tying up a worker or deadlocking the pool.
+///
+/// Worker threads are only created when tasks are added, so a pool
+/// that is never used costs nothing.
+//----------------------------------------------------------------------
+class ThreadPool
+{
+public:
+    typedef void (*TaskCallback) (void *baton);
+
+    //------------------------------------------------------------------
+    /// @class ThreadPool::TaskGroup
+    ///
+    /// A set of tasks that are waited for together. The destructor
+    /// waits for any tasks that are still running, so batons that live
+    /// on the stack can't go away while a task is using them.
+    //------------------------------------------------------------------
+    class TaskGroup
+    {
+    public:
+        TaskGroup (ThreadPool &pool);
+
+        ~TaskGroup ();
+
+        //--------------------------------------------------------------
+        /// Queue \a callback to be called with \a baton on one of the
+        /// pool's threads.
+        //--------------------------------------------------------------
+        void
+        AddTask (TaskCallback callback, void *baton);
+
+        //--------------------------------------------------------------
+        /// Wait for all of the tasks that were added to this group to
+        /// finish, running the ones that haven't started yet on the
+        /// calling thread.
+        //--------------------------------------------------------------
+        void
+        Wait ();
+
+        //--------------------------------------------------------------
+        /// Skip the tasks in this group that haven't started yet. Tasks
+        /// that are running can check IsCancelled(), or
+        /// ThreadPool::ShouldCancel() if they don't have the group, and
+        /// stop early.
+        //--------------------------------------------------------------
+        void
+        Cancel ();
+
+        bool
+        IsCancelled () const
+        {
+            return m_cancelled != 0;
+        }
+
+    private:
+        friend class ThreadPool;
+
+        void
+        TaskFinished ();
+
+        ThreadPool &m_pool;
+        Mutex m_mutex;
+        Condition m_condition;
+        uint32_t m_num_unfinished_tasks;    // Tasks that are queued or running
+        volatile uint32_t m_cancelled;
+
+        DISALLOW_COPY_AND_ASSIGN (TaskGroup);
+    };
+
+    //------------------------------------------------------------------
+    /// @param[in] max_num_threads
+    ///     The most worker threads to run, or zero for one per CPU.
+    //------------------------------------------------------------------
+    ThreadPool (uint32_t max_num_threads = 0);
+
+    ~ThreadPool ();
+
+    //------------------------------------------------------------------
+    /// The pool that all of LLDB's internal parallel work shares, so
+    /// the number of busy threads stays near the number of CPUs no
+    /// matter how many features are running at once. Its size comes
+    /// from the "thread-pool-size" debugger setting.
+    //------------------------------------------------------------------
+    static ThreadPool &
+    GetSharedThreadPool ();
+
+    uint32_t
+    GetMaximumNumberOfThreads () const
+    {
+        return m_max_num_threads;
+    }
+
+    //------------------------------------------------------------------
+    /// Change how many worker threads the pool can run, zero means one
+    /// per CPU. Extra workers exit once they are idle.
+    //------------------------------------------------------------------
+    void
+    SetMaximumNumberOfThreads (uint32_t max_num_threads);
+
+    //------------------------------------------------------------------
+    /// Returns true if the current thread is running a task whose
+    /// group was cancelled.
+    //------------------------------------------------------------------
+    static bool
+    ShouldCancel ();
+
+protected:
+    friend class TaskGroup;
+
+    struct Task
+    {
+        TaskCallback callback;
+        void *baton;
+        TaskGroup *group;
+    };
+
+    typedef std::deque<Task> TaskQueue;
+
+    struct Worker
+    {
+        ThreadPool *pool;
+        uint32_t index;
+        bool running;       // Protected by the pool's m_mutex
+        Mutex mutex;        // Protects tasks
+        TaskQueue tasks;
+    };
+
+    void
+    AddTask (const Task &task);
+
+    bool
+    GetTask (Worker *worker, Task &task);
+
+    bool
+    GetTaskForGroup (const TaskGroup *group, Task &task);
+
+    static bool
+    RemoveTaskForGroup (TaskQueue &tasks, const TaskGroup *group, Task &task);
+
+    static void
+    RunTask (const Task &task);
+
+    static void *
+    WorkerThread (void *arg);
+
+    Worker *m_workers[THREAD_POOL_MAX_NUM_THREADS];
+    Mutex m_tasks_mutex;                    // Protects m_tasks
+    TaskQueue m_tasks;                      // Tasks added from outside the pool
+    Mutex m_mutex;                          // Protects the members below
+    Condition m_condition;                  // Signaled when tasks are added or workers should exit
+    uint32_t m_max_num_threads;
+    uint32_t m_num_threads;                 // Worker threads that are running
+    uint32_t m_num_idle_threads;            // Worker threads waiting for tasks
+    volatile uint32_t m_num_worker_slots;   // One more than the highest worker index ever used
+    volatile uint32_t m_num_queued_tasks;
+    bool m_shutting_down;
+
+private:
+    DISALLOW_COPY_AND_ASSIGN (ThreadPool);
+};
+
+} // namespace lldb_private
+
+#endif  // #if defined(__cplusplus)
+#endif  // liblldb_ThreadPool_h_
@@ -0,0 +1,139 @@
+//===-- CommandBatch.h ------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_CommandBatch_h_
+#define liblldb_CommandBatch_h_
+
+// C Includes
+// C++ Includes
+#include <string>
+#include <vector>
+
+// Other libraries and framework includes
+// Project includes
+#include "lldb/lldb-private.h"
+#include "lldb/Interpreter/Args.h"
+
+namespace lldb_private {
+
+//----------------------------------------------------------------------
+/// @class CommandBatch CommandBatch.h "lldb/Interpreter/CommandBatch.h"
+/// @brief A list of command lines that is run as a unit, usually many
+/// times over.
+///
+/// The first time a batch is run by a command interpreter, each line
+/// is resolved to the command object that runs it, and the arguments
+/// of commands that parse them are split up into Args. Later runs call
+/// the command objects directly with copies of those Args, skipping
+/// the alias and command name lookups and the argument parsing. The
+/// lines are resolved again if the interpreter's commands or aliases
+/// change.
+///
+/// One CommandReturnObject is reused for all the commands. The status,
+/// output and error text of each command are kept separately, so they
+/// can be looked at without picking apart formatted text.
+//----------------------------------------------------------------------
+class CommandBatch
+{
+public:
+    CommandBatch ();
+
+    ~CommandBatch ();
+
+    void
+    AppendCommand (const char *command_line);
+
+    size_t
+    GetNumCommands () const
+    {
+        return m_commands.size();
+    }
+
+    const char *
+    GetCommandAtIndex (size_t idx) const;
+
+    void
+    Clear ();
+
+    //------------------------------------------------------------------
+    /// Run the commands in order.
+    ///
+    /// @param[in] interpreter
+    ///     The command interpreter to run the commands with.
+    ///
+    /// @param[in] stop_on_error
+    ///     If \b true, stop after the first command that fails.
+    ///
+    /// @return
+    ///     The number of commands that were run.
+    //------------------------------------------------------------------
+    size_t
+    Execute (CommandInterpreter &interpreter, bool stop_on_error);
+
+    //------------------------------------------------------------------
+    /// The number of commands that were run by the last Execute(). The
+    /// results below are only valid for these.
+    //------------------------------------------------------------------
+    size_t
+    GetNumCommandsRun () const
+    {
+        return m_num_commands_run;
+    }
+
+    lldb::ReturnStatus
+    GetStatusAtIndex (size_t idx) const;
+
+    const char *
+    GetOutputAtIndex (size_t idx) const;
+
+    const char *
+    GetErrorAtIndex (size_t idx) const;
+
+    void
+    Dump (Stream &strm) const;
+
+protected:
+    struct Command
+    {
+        Command (const char *line) :
+            command_line (line),
+            cmd_obj (NULL),
+            command_args (),
+            args (),
+            status (lldb::eReturnStatusInvalid),
+            output (),
+            error ()
+        {
+        }
+
+        std::string command_line;
+        CommandObject *cmd_obj;     // NULL if the line has to go through CommandInterpreter::HandleCommand()
+        std::string command_args;   // The arguments for cmd_obj
+        Args args;                  // command_args split up, if cmd_obj doesn't want raw input
+        lldb::ReturnStatus status;
+        std::string output;
+        std::string error;
+    };
+
+    void
+    Prepare (CommandInterpreter &interpreter);
+
+    std::vector<Command> m_commands;
+    CommandInterpreter *m_prepared_interpreter; // The interpreter the commands were resolved with
+    uint32_t m_prepared_generation;             // Its command set generation at the time
+    size_t m_num_prepared_commands;
+    size_t m_num_commands_run;
+
+private:
+    DISALLOW_COPY_AND_ASSIGN (CommandBatch);
+};
+
+} // namespace lldb_private
+
+#endif  // liblldb_CommandBatch_h_
@@ -122,6 +122,7 @@ public:
     RemoveAllUser ()
     {
         m_user_dict.clear();
+        ++m_command_set_generation;
     }
 
     OptionArgVectorSP
@@ -153,6 +154,40 @@ public:
                    ExecutionContext *override_context = NULL,
                    bool repeat_on_empty_command = true,
                    bool no_context_switching = false);
+
+    //------------------------------------------------------------------
+    /// Find the command object that would run \a command_line, taking
+    /// care of aliases and abbreviated command names, without running
+    /// it. Callers that run the same command lines over and over can
+    /// resolve them once and call the command object directly.
+    ///
+    /// Empty lines, comments, history references and lines with
+    /// backtick expressions have to be looked at each time they run,
+    /// for those NULL is returned without an error and the line should
+    /// go through HandleCommand().
+    ///
+    /// @param[out] command_args
+    ///     Filled in with the arguments to pass to the command object.
+    ///
+    /// @return
+    ///     The command object, or NULL if the line can't be resolved
+    ///     ahead of time.
+    //------------------------------------------------------------------
+    CommandObject *
+    ResolveCommandLine (const char *command_line,
+                        std::string &command_args,
+                        CommandReturnObject &result);
+
+    //------------------------------------------------------------------
+    /// Changes whenever commands, aliases or alias options are added or
+    /// removed, which can change what ResolveCommandLine() returns and
+    /// can delete the command objects it returned.
+    //------------------------------------------------------------------
+    uint32_t
+    GetCommandSetGeneration () const
+    {
+        return m_command_set_generation;
+    }
     
     //------------------------------------------------------------------
     /// Execute a list of commands in sequence.
@@ -367,6 +402,14 @@ public:
     ScriptInterpreter *
     GetScriptInterpreter ();
 
+    // Like GetScriptInterpreter(), but doesn't make one if nothing has
+    // needed it yet
+    ScriptInterpreter *
+    GetScriptInterpreterIfCreated ()
+    {
+        return m_script_interpreter_ap.get();
+    }
+
     void
     SkipLLDBInitFiles (bool skip_lldbinit_files)
     {
@@ -471,6 +514,12 @@ private:
     Error
     PreprocessCommand (std::string &command);
 
+    CommandObject *
+    ResolveCommand (std::string &command_string,
+                    std::string &resolved_command_line,
+                    std::string &command_args,
+                    CommandReturnObject &result);
+
     Debugger &m_debugger;                       // The debugger session that this interpreter is associated with
     ExecutionContextRef m_exe_ctx_ref;          // The current execution context to use when handling commands
     bool m_synchronous_execution;
@@ -488,6 +537,7 @@ private:
     bool m_batch_command_mode;
     ChildrenTruncatedWarningStatus m_truncation_warning;    // Whether we truncated children and whether the user has been told
     uint32_t m_command_source_depth;
+    uint32_t m_command_set_generation;          // Bumped when the commands, aliases or alias options change
     
 };
 
@@ -389,6 +389,15 @@ public:
     virtual bool
     Execute (const char *args_string, CommandReturnObject &result) = 0;
 
+    //------------------------------------------------------------------
+    /// Run the command with arguments that were already split up into
+    /// \a args, which the command may change. Commands that parse
+    /// their arguments use them as they are, others put the command
+    /// string back together and call Execute().
+    //------------------------------------------------------------------
+    virtual bool
+    ExecuteWithArgs (Args &args, CommandReturnObject &result);
+
 protected:
     CommandInterpreter &m_interpreter;
     std::string m_cmd_name;
@@ -424,6 +433,9 @@ public:
     
     virtual bool
     Execute (const char *args_string, CommandReturnObject &result);
+
+    virtual bool
+    ExecuteWithArgs (Args &cmd_args, CommandReturnObject &result);
     
 protected:
     virtual bool
@@ -53,6 +53,10 @@ public:
     Stream &
     GetOutputStream ()
     {
+        // When streaming, output only goes to the immediate stream
+        if (m_stream_output && m_out_stream.GetStreamAtIndex (eImmediateStreamIndex))
+            return m_out_stream;
+
         // Make sure we at least have our normal string stream output stream
         lldb::StreamSP stream_sp (m_out_stream.GetStreamAtIndex (eStreamStringIndex));
         if (!stream_sp)
@@ -113,6 +117,32 @@ public:
     {
         return m_err_stream.GetStreamAtIndex (eImmediateStreamIndex);
     }
+
+    //------------------------------------------------------------------
+    /// Make the immediate output stream one that hands the output to
+    /// \a callback as the command produces it, a block of whole lines
+    /// at a time. The last partial line is handed over when the stream
+    /// is flushed.
+    //------------------------------------------------------------------
+    void
+    SetImmediateOutputCallback (lldb::LogOutputCallback callback, void *baton);
+
+    //------------------------------------------------------------------
+    /// When \a stream_output is true and there is an immediate output
+    /// stream, output is only written to the immediate stream instead
+    /// of also being collected, so a command that prints hundreds of
+    /// megabytes doesn't hold all of it until it is done. Output that
+    /// was already collected is dropped, and GetOutputData() returns
+    /// nothing while streaming.
+    //------------------------------------------------------------------
+    void
+    SetStreamOutput (bool stream_output);
+
+    bool
+    GetStreamOutput () const
+    {
+        return m_stream_output;
+    }
     
     void
     Clear();
@@ -173,6 +203,7 @@ private:
     
     lldb::ReturnStatus m_status;
     bool m_did_change_process_state;
+    bool m_stream_output;
 };
 
 } // namespace lldb_private
@@ -30,7 +30,8 @@ public:
     //---------------------------------------------------------------------
     OptionValueProperties () :
         OptionValue(),
-        m_name ()
+        m_name (),
+        m_generation (1)
     {
     }
 
@@ -86,6 +87,17 @@ public:
     void
     Initialize (const PropertyDefinition *setting_definitions);
 
+    //---------------------------------------------------------------------
+    // Changes whenever properties are added, and with them the OptionValue
+    // objects that back each property index. PropertyHandle objects use
+    // this to know when to look their property up again.
+    //---------------------------------------------------------------------
+    uint32_t
+    GetGeneration () const
+    {
+        return m_generation;
+    }
+
 //    bool
 //    GetQualifiedName (Stream &strm);
 
@@ -251,6 +263,7 @@ protected:
     ConstString m_name;
     std::vector<Property> m_properties;
     NameToIndex m_name_to_index;
+    uint32_t m_generation;
 };
 
 } // namespace lldb_private
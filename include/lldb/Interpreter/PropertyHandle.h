@@ -0,0 +1,141 @@
+//===-- PropertyHandle.h ----------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_PropertyHandle_h_
+#define liblldb_PropertyHandle_h_
+
+// C Includes
+// C++ Includes
+// Other libraries and framework includes
+// Project includes
+#include "lldb/Interpreter/OptionValueBoolean.h"
+#include "lldb/Interpreter/OptionValueEnumeration.h"
+#include "lldb/Interpreter/OptionValueProperties.h"
+#include "lldb/Interpreter/OptionValueSInt64.h"
+#include "lldb/Interpreter/OptionValueString.h"
+#include "lldb/Interpreter/OptionValueUInt64.h"
+
+namespace lldb_private {
+
+//----------------------------------------------------------------------
+/// @class PropertyHandle PropertyHandle.h "lldb/Interpreter/PropertyHandle.h"
+/// @brief A cached reference to one setting of a known type.
+///
+/// Some settings are read for every value that is displayed or every
+/// memory read. A handle looks up the OptionValue for its property
+/// index the first time it is read, and again only when the collection
+/// it is read from is a different one or its generation has changed.
+/// Reading the setting after that doesn't go through any virtual calls
+/// or shared pointers.
+///
+/// The handle only caches where the value is, so changes made with
+/// "settings set" are seen right away. It should be read with the
+/// collection the property index came from and no execution context,
+/// reads that have to find a target specific value through an
+/// ExecutionContext still need OptionValueProperties.
+//----------------------------------------------------------------------
+class PropertyHandle
+{
+public:
+    PropertyHandle (uint32_t idx, OptionValue::Type type) :
+        m_idx (idx),
+        m_type (type),
+        m_properties (NULL),
+        m_generation (0),
+        m_value (NULL)
+    {
+    }
+
+    //------------------------------------------------------------------
+    /// Get the property's value, or NULL if there is no property at the
+    /// handle's index or its value isn't of the handle's type.
+    //------------------------------------------------------------------
+    OptionValue *
+    GetValue (const OptionValueProperties &properties) const
+    {
+        if (m_properties != &properties || m_generation != properties.GetGeneration())
+            Resolve (properties);
+        return m_value;
+    }
+
+    bool
+    GetBooleanValue (const OptionValueProperties &properties, bool fail_value) const
+    {
+        OptionValue *value = GetValue (properties);
+        if (value)
+            return static_cast<OptionValueBoolean *>(value)->GetCurrentValue();
+        return fail_value;
+    }
+
+    int64_t
+    GetEnumerationValue (const OptionValueProperties &properties, int64_t fail_value) const
+    {
+        OptionValue *value = GetValue (properties);
+        if (value)
+            return static_cast<OptionValueEnumeration *>(value)->GetCurrentValue();
+        return fail_value;
+    }
+
+    int64_t
+    GetSInt64Value (const OptionValueProperties &properties, int64_t fail_value) const
+    {
+        OptionValue *value = GetValue (properties);
+        if (value)
+            return static_cast<OptionValueSInt64 *>(value)->GetCurrentValue();
+        return fail_value;
+    }
+
+    uint64_t
+    GetUInt64Value (const OptionValueProperties &properties, uint64_t fail_value) const
+    {
+        OptionValue *value = GetValue (properties);
+        if (value)
+            return static_cast<OptionValueUInt64 *>(value)->GetCurrentValue();
+        return fail_value;
+    }
+
+    const char *
+    GetStringValue (const OptionValueProperties &properties, const char *fail_value) const
+    {
+        OptionValue *value = GetValue (properties);
+        if (value)
+            return static_cast<OptionValueString *>(value)->GetCurrentValue();
+        return fail_value;
+    }
+
+protected:
+    void
+    Resolve (const OptionValueProperties &properties) const
+    {
+        OptionValue *value = NULL;
+        const uint32_t generation = properties.GetGeneration();
+        const Property *property = properties.GetPropertyAtIndex (NULL, false, m_idx);
+        if (property && property->GetValue() && property->GetValue()->GetType() == m_type)
+            value = property->GetValue().get();
+        m_value = value;
+        // Another thread can see the new collection and generation as
+        // soon as they are stored, the value has to be there first
+        __sync_synchronize();
+        m_generation = generation;
+        m_properties = &properties;
+    }
+
+    const uint32_t m_idx;
+    const OptionValue::Type m_type;
+    mutable const OptionValueProperties * volatile m_properties;
+    mutable volatile uint32_t m_generation;
+    mutable OptionValue *m_value;
+
+private:
+    DISALLOW_COPY_AND_ASSIGN (PropertyHandle);
+};
+
+} // namespace lldb_private
+
+#endif  // liblldb_PropertyHandle_h_
@@ -87,7 +87,7 @@ public:
                                                const char *session_dictionary_name,
                                                const lldb::ProcessSP& process_sp);
     
-    typedef uint32_t       (*SWIGPythonCalculateNumChildren)        (void *implementor);
+    typedef uint32_t       (*SWIGPythonCalculateNumChildren)        (void *implementor, uint32_t max);
     typedef void*          (*SWIGPythonGetChildAtIndex)             (void *implementor, uint32_t idx);
     typedef int            (*SWIGPythonGetIndexOfChildWithName)     (void *implementor, const char* child_name);
     typedef void*          (*SWIGPythonCastPyObjectToSBValue)       (void* data);
@@ -218,6 +218,14 @@ public:
         return lldb::ScriptInterpreterObjectSP();
     }
     
+    virtual lldb::ScriptInterpreterObjectSP
+    OSPlugin_QueryForThreadsInfoChanges (lldb::ScriptInterpreterObjectSP object,
+                                         uint32_t since_stop_id,
+                                         uint32_t stop_id)
+    {
+        return lldb::ScriptInterpreterObjectSP();
+    }
+    
     virtual lldb::ScriptInterpreterObjectSP
     OSPlugin_QueryForRegisterContextData (lldb::ScriptInterpreterObjectSP object,
                                           lldb::tid_t thread_id)
@@ -264,8 +272,9 @@ public:
         return false;
     }
     
+    // A provider may stop counting once it has found "max" children
     virtual uint32_t
-    CalculateNumChildren (const lldb::ScriptInterpreterObjectSP& implementor)
+    CalculateNumChildren (const lldb::ScriptInterpreterObjectSP& implementor, uint32_t max)
     {
         return 0;
     }
@@ -340,6 +349,78 @@ public:
     virtual void
     ResetOutputFileHandle (FILE *new_fh) { } //By default, do nothing.
 
+    //------------------------------------------------------------------
+    /// Every callback into a script interpreter has to take its lock and
+    /// set up its session, which can cost more than the callback itself
+    /// when there are thousands of them. While a Batch is alive, the
+    /// callbacks made on the thread that made it share a single lock and
+    /// session, so a whole formatting pass or all the breakpoint callbacks
+    /// of a stop only pay for it once. Batches can be nested.
+    //------------------------------------------------------------------
+    class Batch
+    {
+    public:
+        //--------------------------------------------------------------
+        /// @param[in] interpreter
+        ///     The command interpreter whose script interpreter the
+        ///     callbacks will go to. No script interpreter is created
+        ///     just for the batch, if there isn't one yet or this is NULL
+        ///     nothing is batched.
+        //--------------------------------------------------------------
+        Batch (CommandInterpreter *interpreter);
+
+        ~Batch ();
+
+    private:
+        ScriptInterpreter *m_script_interpreter;
+        bool m_is_outermost;
+
+        DISALLOW_COPY_AND_ASSIGN (Batch);
+    };
+
+    //------------------------------------------------------------------
+    /// Give up the lock held by the batch this thread is in, if any,
+    /// while it waits on other threads that may need the script
+    /// interpreter, like when the process runs to evaluate an expression.
+    //------------------------------------------------------------------
+    class BatchSuspender
+    {
+    public:
+        BatchSuspender ();
+
+        ~BatchSuspender ();
+
+    private:
+        ScriptInterpreter *m_script_interpreter;
+
+        DISALLOW_COPY_AND_ASSIGN (BatchSuspender);
+    };
+
+    //------------------------------------------------------------------
+    /// The batch entry points. Interpreters that have nothing to save by
+    /// batching can leave these alone.
+    //------------------------------------------------------------------
+    virtual void
+    BeginBatch ()
+    {
+    }
+
+    virtual void
+    EndBatch ()
+    {
+    }
+
+    virtual bool
+    SuspendBatch ()
+    {
+        return false;
+    }
+
+    virtual void
+    ResumeBatch ()
+    {
+    }
+
 protected:
     CommandInterpreter &m_interpreter;
     lldb::ScriptLanguage m_script_lang;
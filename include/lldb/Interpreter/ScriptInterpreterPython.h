@@ -86,12 +86,17 @@ public:
     virtual lldb::ScriptInterpreterObjectSP
     OSPlugin_QueryForThreadsInfo (lldb::ScriptInterpreterObjectSP object);
     
+    virtual lldb::ScriptInterpreterObjectSP
+    OSPlugin_QueryForThreadsInfoChanges (lldb::ScriptInterpreterObjectSP object,
+                                         uint32_t since_stop_id,
+                                         uint32_t stop_id);
+    
     virtual lldb::ScriptInterpreterObjectSP
     OSPlugin_QueryForRegisterContextData (lldb::ScriptInterpreterObjectSP object,
                                           lldb::tid_t thread_id);
     
     virtual uint32_t
-    CalculateNumChildren (const lldb::ScriptInterpreterObjectSP& implementor);
+    CalculateNumChildren (const lldb::ScriptInterpreterObjectSP& implementor, uint32_t max);
     
     virtual lldb::ValueObjectSP
     GetChildAtIndex (const lldb::ScriptInterpreterObjectSP& implementor, uint32_t idx);
@@ -184,6 +189,18 @@ public:
     virtual void
     ResetOutputFileHandle (FILE *new_fh);
     
+    virtual void
+    BeginBatch ();
+    
+    virtual void
+    EndBatch ();
+    
+    virtual bool
+    SuspendBatch ();
+    
+    virtual void
+    ResumeBatch ();
+    
     static lldb::thread_result_t
     RunEmbeddedPythonInterpreter (lldb::thread_arg_t baton);
 
@@ -285,6 +302,7 @@ private:
         static void
         ReleasePythonLock ();
         
+        bool                     m_in_batch;    // the thread's batch already holds the lock and session
     	bool                     m_need_session;
     	ScriptInterpreterPython *m_python_interpreter;
     	FILE*                    m_tmp_fh;
@@ -343,6 +361,15 @@ private:
     bool m_session_is_active;
     bool m_pty_slave_is_open;
     bool m_valid_session;
+    
+    // The batch that holds the lock and the session, see ScriptInterpreter::Batch
+    lldb::tid_t m_batch_tid;
+    uint32_t m_batch_depth;
+    PyGILState_STATE m_batch_gil_state;
+    PyThreadState *m_batch_suspended_state;
+    
+    bool
+    IsBatchActiveOnCurrentThread () const;
 };
 } // namespace lldb_private
 
@@ -45,6 +45,7 @@ class Block :
 public:
     typedef RangeArray<uint32_t, uint32_t, 1> RangeList;
     typedef RangeList::Entry Range;
+    typedef RangeDataArray<uint32_t, uint32_t, Block *, 1> InnermostBlockRanges;
 
     //------------------------------------------------------------------
     /// Construct with a User ID \a uid, \a depth.
@@ -435,6 +436,21 @@ public:
     Block *
     FindBlockByID (lldb::user_id_t block_id);
 
+    //------------------------------------------------------------------
+    /// Flatten this block and all of its descendants.
+    ///
+    /// Appends the parts of this block's ranges that none of its
+    /// children cover to \a block_ranges, and does the same for each
+    /// child, so that once sorted every offset in \a block_ranges maps
+    /// to the innermost block containing it. This block and all of its
+    /// descendants are appended to \a blocks.
+    ///
+    /// @see Function::FindBlockContainingFileAddress()
+    //------------------------------------------------------------------
+    void
+    AppendInnermostRanges (InnermostBlockRanges &block_ranges,
+                           std::vector<Block *> &blocks);
+
     uint32_t
     GetNumRanges () const
     {
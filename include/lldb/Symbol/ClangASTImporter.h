@@ -273,6 +273,35 @@ private:
     
     DeclOrigin
     GetDeclOrigin (const clang::Decl *decl);
+    
+    //------------------------------------------------------------------
+    /// Copy a decl that was imported into \a src_ctx straight from the
+    /// AST it originally came from.
+    ///
+    /// The minion for \a dst_ctx and the original AST stays around for
+    /// as long as both ASTs do, so a decl that was copied before is
+    /// found in its map instead of being imported again, and the copy
+    /// keeps pointing at the original so its definition is only
+    /// imported when something needs it.
+    ///
+    /// @return
+    ///     The copy, or NULL if the decl isn't from another AST.
+    //------------------------------------------------------------------
+    clang::Decl *
+    CopyDeclFromOrigin (clang::ASTContext *dst_ctx,
+                        clang::Decl *decl);
+    
+    //------------------------------------------------------------------
+    /// Copy a type using CopyDeclFromOrigin() for the decl it names,
+    /// rebuilding the pointers and references around it.
+    ///
+    /// @return
+    ///     The copy, or a null type if the type doesn't name a decl that
+    ///     is from another AST.
+    //------------------------------------------------------------------
+    clang::QualType
+    CopyTypeFromOrigin (clang::ASTContext *dst_ctx,
+                        clang::QualType type);
         
     clang::FileManager      m_file_manager;
 };
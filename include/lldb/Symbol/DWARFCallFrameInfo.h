@@ -81,20 +81,21 @@ private:
 
     typedef STD_SHARED_PTR(CIE) CIESP;
 
+    // The FDE index is kept in a flat array sorted by address, and is
+    // saved to the index cache as is, so keep this small and free of
+    // pointers.
     struct FDEEntry
     {
-        AddressRange bounds;   // function bounds
-        dw_offset_t offset;    // offset to this FDE within the Section
+        lldb::addr_t file_addr; // function start file address
+        uint32_t byte_size;     // function size
+        dw_offset_t offset;     // offset to this FDE within the Section
 
-        FDEEntry () : bounds (), offset (0) { }
+        FDEEntry () : file_addr (LLDB_INVALID_ADDRESS), byte_size (0), offset (0) { }
 
         inline bool
         operator<(const DWARFCallFrameInfo::FDEEntry& b) const
         {
-            if (bounds.GetBaseAddress().GetOffset() < b.bounds.GetBaseAddress().GetOffset())
-                return true;
-            else
-                return false;
+            return file_addr < b.file_addr;
         }
     };
 
@@ -109,6 +110,12 @@ private:
     void
     GetFDEIndex ();
 
+    bool
+    LoadFDEIndexFromCache ();
+
+    void
+    SaveFDEIndexToCache ();
+
     bool
     FDEToUnwindPlan (uint32_t offset, Address startaddr, UnwindPlan& unwind_plan);
 
@@ -129,7 +136,7 @@ private:
 
     std::vector<FDEEntry>       m_fde_index;
     bool                        m_fde_index_initialized;  // only scan the section for FDEs once
-    Mutex                       m_fde_index_mutex;        // and isolate the thread that does it
+    Mutex                       m_fde_index_mutex;        // and isolate the thread that does it, also protects m_cie_map
 
     bool                        m_is_eh_frame;
 
@@ -12,6 +12,7 @@
 
 #include "lldb/lldb-private.h"
 #include "lldb/Host/FileSpec.h"
+#include "lldb/Host/FileSpecTable.h"
 
 namespace lldb_private {
 
@@ -32,7 +33,7 @@ public:
     /// Default constructor.
     //------------------------------------------------------------------
     Declaration () :
-        m_file (),
+        m_file_idx (0),
         m_line (0)
 #ifdef LLDB_ENABLE_DECLARATION_COLUMNS
         ,m_column (0)
@@ -57,7 +58,7 @@ public:
     ///     Set to zero if there is no column number information.
     //------------------------------------------------------------------
     Declaration (const FileSpec& file_spec, uint32_t line = 0, uint32_t column = 0) :
-        m_file (file_spec),
+        m_file_idx (FileSpecTable::GetIndexForFileSpec (file_spec)),
         m_line (line)
 #ifdef LLDB_ENABLE_DECLARATION_COLUMNS
         ,m_column (column)
@@ -69,7 +70,7 @@ public:
     /// Construct with a reference to another Declaration object.
     //------------------------------------------------------------------
     Declaration (const Declaration& rhs) :
-        m_file (rhs.m_file),
+        m_file_idx (rhs.m_file_idx),
         m_line (rhs.m_line)
 #ifdef LLDB_ENABLE_DECLARATION_COLUMNS
         ,m_column (rhs.m_column)
@@ -82,7 +83,7 @@ public:
     /// Construct with a pointer to another Declaration object.
     //------------------------------------------------------------------
     Declaration(const Declaration* decl_ptr) :
-        m_file(),
+        m_file_idx(0),
         m_line(0)
 #ifdef LLDB_ENABLE_DECLARATION_COLUMNS
         ,m_column(0)
@@ -101,7 +102,7 @@ public:
     void
     Clear ()
     {
-        m_file.Clear();
+        m_file_idx = 0;
         m_line= 0;
 #ifdef LLDB_ENABLE_DECLARATION_COLUMNS
         m_column = 0;
@@ -161,27 +162,26 @@ public:
     }
 
     //------------------------------------------------------------------
-    /// Get accessor for file specification.
+    /// Get const accessor for file specification.
     ///
     /// @return
-    ///     A reference to the file specification object.
+    ///     A const reference to the file specification object, which
+    ///     lives in the FileSpecTable. Use SetFile() to change it.
     //------------------------------------------------------------------
-    FileSpec&
-    GetFile ()
+    const FileSpec&
+    GetFile () const
     {
-        return m_file;
+        return FileSpecTable::GetFileSpecAtIndex (m_file_idx);
     }
 
     //------------------------------------------------------------------
-    /// Get const accessor for file specification.
-    ///
-    /// @return
-    ///     A const reference to the file specification object.
+    /// Get the FileSpecTable index of the file specification, two
+    /// declarations are in the same file if their indexes are equal.
     //------------------------------------------------------------------
-    const FileSpec&
-    GetFile () const
+    uint32_t
+    GetFileIndex () const
     {
-        return m_file;
+        return m_file_idx;
     }
 
     //------------------------------------------------------------------
@@ -201,7 +201,7 @@ public:
     bool
     IsValid() const
     {
-        return m_file && m_line != 0;
+        return m_file_idx != 0 && m_line != 0;
     }
 
     //------------------------------------------------------------------
@@ -241,7 +241,7 @@ public:
     void
     SetFile (const FileSpec& file_spec)
     {
-        m_file = file_spec;
+        m_file_idx = FileSpecTable::GetIndexForFileSpec (file_spec);
     }
 
     //------------------------------------------------------------------
@@ -260,8 +260,9 @@ protected:
     //------------------------------------------------------------------
     /// Member variables.
     //------------------------------------------------------------------
-    FileSpec m_file;    ///< The file specification that points to the
-                        ///< source file where the declaration occurred.
+    uint32_t m_file_idx;///< The FileSpecTable index of the file specification
+                        ///< that points to the source file where the
+                        ///< declaration occurred.
     uint32_t m_line;    ///< Non-zero values indicates a valid line number,
                         ///< zero indicates no line number information is available.
 #ifdef LLDB_ENABLE_DECLARATION_COLUMNS
@@ -34,7 +34,10 @@ public:
     // instructions are finished for migrating breakpoints past the 
     // stack frame setup instructions when we don't have line table information.
 
-    FuncUnwinders (lldb_private::UnwindTable& unwind_table, lldb_private::UnwindAssembly *assembly_profiler, AddressRange range);
+    // If use_saved_plans is true, UnwindPlans the assembly profiler made for
+    // this function in earlier debug sessions are used instead of profiling
+    // the function again.
+    FuncUnwinders (lldb_private::UnwindTable& unwind_table, lldb_private::UnwindAssembly *assembly_profiler, AddressRange range, bool use_saved_plans);
 
     ~FuncUnwinders ();
 
@@ -75,6 +78,7 @@ private:
     UnwindTable& m_unwind_table;
     UnwindAssembly *m_assembly_profiler;
     AddressRange m_range;
+    bool m_use_saved_plans;
 
     Mutex m_mutex;
     lldb::UnwindPlanSP m_unwind_plan_call_site_sp;
@@ -478,6 +478,34 @@ public:
     Block&
     GetBlock (bool can_create);
 
+    //------------------------------------------------------------------
+    /// Find the innermost block that contains a file address.
+    ///
+    /// The first call parses the function's blocks and flattens their
+    /// ranges into one sorted table in which each piece maps to the
+    /// innermost block covering it, so every lookup is a single binary
+    /// search instead of a walk down the block tree.
+    ///
+    /// @param[in] file_addr
+    ///     A file address within this function.
+    ///
+    /// @return
+    ///     The innermost block that contains \a file_addr, the
+    ///     function's top level block if no nested block does, or NULL
+    ///     if \a file_addr isn't in this function.
+    //------------------------------------------------------------------
+    Block *
+    FindBlockContainingFileAddress (lldb::addr_t file_addr);
+
+    //------------------------------------------------------------------
+    /// Find a block of this function by its user ID.
+    ///
+    /// Does the same as GetBlock(true).FindBlockByID(), but with a
+    /// binary search in a table built with the one above.
+    //------------------------------------------------------------------
+    Block *
+    FindBlockByID (lldb::user_id_t block_id);
+
     //------------------------------------------------------------------
     /// Get accessor for the compile unit that owns this function.
     ///
@@ -622,9 +650,13 @@ protected:
 
     enum
     {
-        flagsCalculatedPrologueSize = (1 << 0)  ///< Have we already tried to calculate the prologue size?
+        flagsCalculatedPrologueSize = (1 << 0), ///< Have we already tried to calculate the prologue size?
+        flagsBuiltBlockIndexes      = (1 << 1)  ///< Have we built m_block_ranges and m_blocks_by_id?
     };
 
+    bool
+    BuildBlockIndexes ();
+
 
 
     //------------------------------------------------------------------
@@ -639,6 +671,8 @@ protected:
     DWARFExpression m_frame_base;   ///< The frame base expression for variables that are relative to the frame pointer.
     Flags m_flags;
     uint32_t m_prologue_byte_size;  ///< Compute the prologue size once and cache it
+    Block::InnermostBlockRanges m_block_ranges; ///< The innermost block for each offset into the function, built on first use
+    std::vector<Block *> m_blocks_by_id;        ///< All blocks in the function sorted by user ID, built on first use
 private:
     DISALLOW_COPY_AND_ASSIGN(Function);
 };
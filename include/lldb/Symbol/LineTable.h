@@ -14,6 +14,7 @@
 
 #include "lldb/lldb-private.h"
 #include "lldb/Symbol/LineEntry.h"
+#include "lldb/Core/DataExtractor.h"
 #include "lldb/Core/ModuleChild.h"
 #include "lldb/Core/Section.h"
 
@@ -22,6 +23,14 @@ namespace lldb_private {
 //----------------------------------------------------------------------
 /// @class LineTable LineTable.h "lldb/Symbol/LineTable.h"
 /// @brief A line table class.
+///
+/// Line entries are added to a line table one at a time. Once all
+/// entries have been added, LineTable::Finalize() encodes them into a
+/// compact form where each entry is stored as a delta from the entry
+/// before it. The encoded entries are split into fixed size blocks,
+/// and only the address of the first entry of each block and where the
+/// block starts are kept in a sparse index. Lookups decode only the
+/// blocks they need.
 //----------------------------------------------------------------------
 class LineTable
 {
@@ -79,6 +88,17 @@ public:
                      bool is_epilogue_begin,
                      bool is_terminal_entry);
 
+    //------------------------------------------------------------------
+    /// Encode the line entries that have been added into their compact
+    /// form and free the memory used while building the line table.
+    ///
+    /// Symbol files should call this once they have added all the line
+    /// entries. Adding more entries afterwards works, but decodes the
+    /// whole line table again.
+    //------------------------------------------------------------------
+    void
+    Finalize ();
+
     //------------------------------------------------------------------
     /// Dump all line entries in this line table to the stream \a s.
     ///
@@ -328,21 +348,80 @@ protected:
         Entry *a_entry;
     };
 
+    // The number of entries in each block of encoded entries.
+    enum { kEntriesPerBlock = 64 };
+
+    //------------------------------------------------------------------
+    /// An entry in the sparse index of encoded entry blocks.
+    //------------------------------------------------------------------
+    struct Block
+    {
+        uint32_t    sect_idx;       ///< The section index of the first entry in this block.
+        uint32_t    sect_offset;    ///< The section offset of the first entry in this block.
+        uint32_t    data_offset;    ///< The offset of this block in the encoded entry data.
+
+        static bool BlockAddressLessThan (const Block& lhs, const Entry& rhs)
+        {
+            if (lhs.sect_idx == rhs.sect_idx)
+                return lhs.sect_offset < rhs.sect_offset;
+            return lhs.sect_idx < rhs.sect_idx;
+        }
+    };
+
+    //------------------------------------------------------------------
+    /// Gets entries by index, decoding whole blocks at a time so that
+    /// walking the entries in order decodes each block only once.
+    /// Decoders keep their own decoded block, so line tables can be
+    /// read from multiple threads.
+    ///
+    /// The returned references are only valid until the next call.
+    //------------------------------------------------------------------
+    class EntryDecoder
+    {
+    public:
+        EntryDecoder (const LineTable &line_table);
+
+        const Entry &
+        GetEntryAtIndex (uint32_t idx);
+
+    protected:
+        const LineTable &m_line_table;
+        uint32_t m_block_idx;
+        Entry m_block_entries[kEntriesPerBlock];
+    };
+
     //------------------------------------------------------------------
     // Types
     //------------------------------------------------------------------
     typedef std::vector<lldb_private::Section*> section_collection; ///< The collection type for the line entries.
     typedef std::vector<Entry> entry_collection;    ///< The collection type for the line entries.
+    typedef std::vector<Block> block_collection;    ///< The collection type for the encoded entry blocks.
     //------------------------------------------------------------------
     // Member variables.
     //------------------------------------------------------------------
     CompileUnit* m_comp_unit;       ///< The compile unit that this line table belongs to.
     SectionList m_section_list; ///< The list of sections that at least one of the line entries exists in.
-    entry_collection m_entries; ///< The collection of line entries in this line table.
+    entry_collection m_entries; ///< The line entries that have been added and not encoded yet.
+    block_collection m_blocks;  ///< The sparse index of the blocks in m_entry_data.
+    DataExtractor m_entry_data; ///< The encoded line entries.
+    uint32_t m_num_encoded_entries; ///< The number of line entries in m_entry_data.
+    bool m_finalized;           ///< True if the line entries are encoded.
 
     bool
     ConvertEntryAtIndexToLineEntry (uint32_t idx, LineEntry &line_entry);
 
+    bool
+    ConvertEntryAtIndexToLineEntry (EntryDecoder &decoder, uint32_t idx, LineEntry &line_entry);
+
+    uint32_t
+    FindFirstEntryIndexNotBeforeAddress (EntryDecoder &decoder, const Entry &search_entry) const;
+
+    uint32_t
+    DecodeBlock (uint32_t block_idx, Entry *entries) const;
+
+    void
+    DecodeAllEntries ();
+
     lldb_private::Section *
     GetSectionForEntryIndex (uint32_t idx);
 private:
@@ -347,6 +347,15 @@ public:
     virtual Symtab *
     GetSymtab () = 0;
 
+    //------------------------------------------------------------------
+    /// Frees the symbol table so it can be parsed again the next time
+    /// GetSymtab() is called.
+    //------------------------------------------------------------------
+    virtual void
+    ClearSymtab ()
+    {
+    }
+
     //------------------------------------------------------------------
     /// Gets the UUID for this object file.
     ///
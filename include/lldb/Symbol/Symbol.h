@@ -178,6 +178,16 @@ public:
         m_size_is_synthesized = b;
     }
 
+    //------------------------------------------------------------------
+    // Returns true if the symbol has a byte size, without trying to
+    // calculate one like GetByteSize() does.
+    //------------------------------------------------------------------
+    bool
+    GetByteSizeIsValid () const
+    {
+        return m_addr_range.GetByteSize() > 0;
+    }
+
     bool
     IsDebug () const
     {
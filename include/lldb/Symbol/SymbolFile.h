@@ -140,8 +140,20 @@ public:
     virtual uint32_t        FindTypes (const SymbolContext& sc, const ConstString &name, const ClangNamespaceDecl *namespace_decl, bool append, uint32_t max_matches, TypeList& types) = 0;
 //  virtual uint32_t        FindTypes (const SymbolContext& sc, const RegularExpression& regex, bool append, uint32_t max_matches, TypeList& types) = 0;
     virtual TypeList *      GetTypeList ();
+    virtual void            PreloadSymbols () {}
+    // Save anything the symbol file has cached for the index cache that
+    // wasn't saved yet. Called by the module when it is destroyed, when
+    // the object file can no longer get at it through GetModule().
+    virtual void            SaveToIndexCache (Module *module) {}
+    // Append every name that FindFunctions() and FindGlobalVariables()
+    // can find something for, other than the names in the symbol table.
+    // Returns false if the names can't be listed.
+    virtual bool            AppendLookupNames (std::vector<const char *> &names) { return false; }
     virtual ClangASTContext &
                             GetClangASTContext ();
+    // The module that owns the ClangASTContext above. Hold its mutex
+    // while modifying the AST.
+    virtual lldb::ModuleSP  GetClangASTModule ();
     virtual ClangNamespaceDecl
                             FindNamespace (const SymbolContext& sc, 
                                            const ConstString &name,
@@ -14,6 +14,8 @@
 #include <vector>
 
 #include "lldb/lldb-private.h"
+#include "lldb/Core/DataExtractor.h"
+#include "lldb/Core/RangeMap.h"
 #include "lldb/Core/UniqueCStringMap.h"
 #include "lldb/Host/Mutex.h"
 #include "lldb/Symbol/Symbol.h"
@@ -76,6 +78,7 @@ public:
             Symbol *    FindSymbolContainingFileAddress (lldb::addr_t file_addr, const uint32_t* indexes, uint32_t num_indexes);
             Symbol *    FindSymbolContainingFileAddress (lldb::addr_t file_addr);
             size_t      CalculateSymbolSize (Symbol *symbol);
+            void        PreloadSymbols ();
 
             void        SortSymbolIndexesByValue (std::vector<uint32_t>& indexes, bool remove_duplicates) const;
 
@@ -102,13 +105,66 @@ protected:
     typedef collection::iterator        iterator;
     typedef collection::const_iterator  const_iterator;
 
+    //------------------------------------------------------------------
+    // The name index is a sorted array of 64 bit name hashes with a
+    // parallel array of symbol indexes. It stores no strings, so it can
+    // be used straight out of a memory mapped index cache file.
+    //------------------------------------------------------------------
+    struct NameHashEntry
+    {
+        uint64_t hash;
+        uint32_t symbol_idx;
+
+        bool
+        operator < (const NameHashEntry &rhs) const
+        {
+            if (hash == rhs.hash)
+                return symbol_idx < rhs.symbol_idx;
+            return hash < rhs.hash;
+        }
+    };
+
+    typedef RangeDataArray<lldb::addr_t, lldb::addr_t, uint32_t, 1> FileRangeToIndexMap;
+
+    struct RegExMatchShards;
+
+    struct PCLookupEntry
+    {
+        PCLookupEntry () :
+            file_addr (LLDB_INVALID_ADDRESS),
+            symbol_idx (UINT32_MAX)
+        {
+        }
+
+        lldb::addr_t file_addr;
+        uint32_t symbol_idx;
+    };
+
             void        InitNameIndexes ();
             void        InitAddressIndexes ();
+            void        InitFileAddressRanges ();
+            size_t      GetNameIndexMatches (const ConstString &name, std::vector<uint32_t> &indexes) const;
+            void        ClearNameIndex ();
+            bool        LoadNameIndexFromCache ();
+            void        SaveNameIndexToCache ();
+            bool        LoadIndexFromCache (const char *index_name, std::vector<uint32_t> *indexes);
+            void        SaveIndexToCache (const char *index_name, const std::vector<uint32_t> *indexes);
+
+    static  uint64_t    HashName (const char *cstr);
+    static  void        MatchRegExInShard (void *baton, uint32_t shard_idx, size_t begin_idx, size_t end_idx);
+    static  bool        SymbolHasName (const Symbol &symbol, const ConstString &name);
 
     ObjectFile *        m_objfile;
     collection          m_symbols;
     std::vector<uint32_t> m_addr_indexes;
-    UniqueCStringMap<uint32_t> m_name_to_index;
+    FileRangeToIndexMap m_file_addr_to_index;   // Size resolved address ranges of the symbols in m_addr_indexes
+    std::vector<PCLookupEntry> m_pc_lookup_cache;   // Direct mapped cache of FindSymbolContainingFileAddress() results
+    const uint64_t *    m_name_hashes;          // Sorted name hashes, either in m_name_hash_storage or m_name_index_data
+    const uint32_t *    m_name_symbol_indexes;  // The symbol index for each entry in m_name_hashes
+    size_t              m_name_index_size;
+    std::vector<uint64_t> m_name_hash_storage;
+    std::vector<uint32_t> m_name_symbol_idx_storage;
+    DataExtractor       m_name_index_data;      // Keeps the memory mapped index cache file around
     mutable Mutex       m_mutex; // Provide thread safety for this symbol table
     bool                m_addr_indexes_computed:1,
                         m_name_indexes_computed:1;
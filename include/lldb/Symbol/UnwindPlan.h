@@ -332,6 +332,15 @@ public:
         void
         Dump (Stream& s, const UnwindPlan* unwind_plan, Thread* thread, lldb::addr_t base_addr) const;
 
+        // Register numbers are converted from from_kind to to_kind with reg_ctx
+        // when the two differ. Returns false if a register can't be converted
+        // or the row uses a DWARF expression, which points into the CFI data.
+        bool
+        Encode (Stream &strm, RegisterContext *reg_ctx, lldb::RegisterKind from_kind, lldb::RegisterKind to_kind) const;
+
+        bool
+        Decode (const DataExtractor &data, uint32_t *offset_ptr);
+
     protected:
         typedef std::map<uint32_t, RegisterLocation> collection;
         lldb::addr_t m_offset;      // Offset into the function for this row
@@ -447,6 +456,16 @@ public:
     const RegisterInfo *
     GetRegisterInfo (Thread* thread, uint32_t reg_num) const;
 
+    // Encode this plan so it can be saved across debug sessions. The plan's
+    // register numbers are written in reg_kind, converted with reg_ctx if they
+    // are in another kind, and its valid address range is written relative to
+    // base_addr. Returns false if the plan can't be encoded.
+    bool
+    Encode (Stream &strm, const Address &base_addr, RegisterContext *reg_ctx, lldb::RegisterKind reg_kind) const;
+
+    bool
+    Decode (const DataExtractor &data, uint32_t *offset_ptr, const Address &base_addr);
+
 private:
 
     
@@ -12,14 +12,22 @@
 #define liblldb_UnwindTable_h
 
 #include <map>
+#include <string>
 
 #include "lldb/lldb-private.h"
+#include "lldb/Host/Mutex.h"
 
 namespace lldb_private {
 
 // A class which holds all the FuncUnwinders objects for a given ObjectFile.
 // The UnwindTable is populated with FuncUnwinders objects lazily during
-// the debug session.
+// the debug session.  The FuncUnwinders, and the UnwindPlans they hold,
+// are shared by all threads and kept across stops, but only the most
+// recently used ones are kept once there are a lot of them.
+//
+// UnwindPlans made by profiling a function's assembly are also saved in
+// the index cache, keyed by the module's UUID and the function's address,
+// so later debug sessions don't need to profile the same functions again.
 
 class UnwindTable
 {
@@ -42,20 +50,72 @@ public:
     lldb::FuncUnwindersSP
     GetUncachedFuncUnwindersContainingAddress (const Address& addr, SymbolContext &sc);
 
+    enum ProfiledUnwindPlanKind
+    {
+        eProfiledUnwindPlanNonCallSite = 0,
+        eProfiledUnwindPlanFast,
+        kNumProfiledUnwindPlanKinds
+    };
+
+    // Fill in unwind_plan with a saved assembly profiled UnwindPlan for the
+    // function at func_range, if there is one.
+    bool
+    GetProfiledUnwindPlan (const AddressRange &func_range, ProfiledUnwindPlanKind kind, UnwindPlan &unwind_plan);
+
+    // Remember an UnwindPlan the assembly profiler made for the function at
+    // func_range so it can be saved. The thread's register context is used to
+    // save the register numbers in a numbering that doesn't depend on the
+    // process plugin.
+    void
+    AddProfiledUnwindPlan (const AddressRange &func_range, ProfiledUnwindPlanKind kind, const UnwindPlan &unwind_plan, Thread &thread);
+
+    // Write the profiled UnwindPlans to the index cache if there are any
+    // that haven't been saved yet. The module is passed in because this is
+    // called while the module is being destroyed.
+    void
+    SaveProfiledUnwindPlans (Module *module);
+
 private:
     void
     Dump (Stream &s);
     
     void Initialize ();
 
-    typedef std::map<lldb::addr_t, lldb::FuncUnwindersSP> collection;
+    void
+    TrimFuncUnwinders ();
+
+    void
+    LoadProfiledUnwindPlans ();
+
+    void
+    EncodeProfiledUnwindPlans (std::string &data);
+
+    struct FuncUnwindersEntry
+    {
+        lldb::FuncUnwindersSP func_unwinders_sp;
+        uint32_t last_use;
+    };
+
+    struct ProfiledUnwindPlanEntry
+    {
+        lldb::addr_t byte_size;     // The size of the function the plans were made for
+        std::string encoded_plans[kNumProfiledUnwindPlanKinds];    // Empty if there is no plan of that kind
+    };
+
+    typedef std::map<lldb::addr_t, FuncUnwindersEntry> collection;
+    typedef std::map<lldb::addr_t, ProfiledUnwindPlanEntry> ProfiledUnwindPlanMap;
     typedef collection::iterator iterator;
     typedef collection::const_iterator const_iterator;
 
     ObjectFile&         m_object_file;
     collection          m_unwinds;
+    uint32_t            m_use_count;    // Incremented every time a FuncUnwinders is handed out
+    Mutex               m_mutex;
 
     bool                m_initialized;  // delay some initialization until ObjectFile is set up
+    bool                m_profiled_plans_loaded;
+    uint32_t            m_num_unsaved_profiled_plans;
+    ProfiledUnwindPlanMap m_profiled_plans; // Encoded plans keyed by function file address
 
     UnwindAssembly* m_assembly_profiler;
 
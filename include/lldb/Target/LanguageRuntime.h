@@ -71,6 +71,13 @@ public:
         return false;
     }
     
+    // Called when modules are removed from the target, so runtimes can
+    // drop anything they cached about them
+    virtual void
+    ModulesDidUnload (ModuleList &module_list)
+    {
+    }
+    
     static lldb::BreakpointSP
     CreateExceptionBreakpoint (Target &target,
                                lldb::LanguageType language, 
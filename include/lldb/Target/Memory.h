@@ -12,6 +12,7 @@
 
 // C Includes
 // C++ Includes
+#include <list>
 #include <map>
 #include <vector>
 
@@ -23,9 +24,28 @@
 #include "lldb/Host/Mutex.h"
 
 namespace lldb_private {
+    //----------------------------------------------------------------------
+    // A range of memory to read with Process::ReadMemoryRanges(). "buf"
+    // must be able to hold "size" bytes and "bytes_read" is filled in
+    // with how many of them were read.
+    //----------------------------------------------------------------------
+    struct MemoryReadRange
+    {
+        lldb::addr_t addr;
+        size_t size;
+        void *buf;
+        size_t bytes_read;
+    };
+
     //----------------------------------------------------------------------
     // A class to track memory that was read from a live process between 
     // runs. 
+    //
+    // Memory is cached in fixed-size cache lines and the total size of the
+    // cache is kept under the "process.memory-cache-size" setting by
+    // evicting the least recently used lines. Runs of missing cache lines
+    // are read from the process with a single read, and when reads walk
+    // sequentially through memory the cache reads ahead of them.
     //----------------------------------------------------------------------
     class MemoryCache
     {
@@ -42,12 +62,38 @@ namespace lldb_private {
         
         void
         Flush (lldb::addr_t addr, size_t size);
+
+        //------------------------------------------------------------------
+        // Add memory contents that a process plug-in got for free, like
+        // stack memory that was expedited in a stop reply packet. Reads
+        // that are entirely contained in one of these blocks are served
+        // without having to read from the process.
+        //------------------------------------------------------------------
+        void
+        AddL1CacheData (lldb::addr_t addr, const void *src, size_t src_len);
         
         size_t
         Read (lldb::addr_t addr, 
               void *dst, 
               size_t dst_len,
               Error &error);
+
+        //------------------------------------------------------------------
+        // Read the cache lines that cover a range of memory that we expect
+        // to need soon, reading runs of missing lines with one read from
+        // the process each. Stops quietly at the first line that can't be
+        // read.
+        //------------------------------------------------------------------
+        void
+        Prefetch (lldb::addr_t addr, size_t size);
+
+        //------------------------------------------------------------------
+        // Read the missing cache lines of several ranges of memory with a
+        // single Process::ReadMemoryRangesFromInferior() call so that
+        // reading scattered objects doesn't cost a read for each one.
+        //------------------------------------------------------------------
+        void
+        PrefetchRanges (const MemoryReadRange *ranges, size_t num_ranges);
         
         uint32_t
         GetMemoryCacheLineSize() const
@@ -61,16 +107,69 @@ namespace lldb_private {
         bool
         RemoveInvalidRange (lldb::addr_t base_addr, lldb::addr_t byte_size);
 
+        //------------------------------------------------------------------
+        // Counters that describe how well the cache is doing. They are
+        // kept for the lifetime of the process, Clear() doesn't reset them.
+        //------------------------------------------------------------------
+        struct Statistics
+        {
+            uint64_t l1_hits;           // Reads served from the L1 cache
+            uint64_t line_hits;         // Cache lines found in the cache
+            uint64_t line_misses;       // Cache lines that had to be read from the process
+            uint64_t prefetched_lines;  // Lines read ahead of a sequential access pattern
+            uint64_t evicted_lines;     // Lines evicted to stay within the size budget
+            uint64_t process_reads;     // Calls to Process::ReadMemoryFromInferior()
+            uint64_t process_bytes;     // Bytes read from the process
+        };
+
+        Statistics
+        GetStatistics () const;
+
+        size_t
+        GetCachedByteSize () const;
+
+        void
+        DumpStatistics (Stream &strm) const;
+
     protected:
-        typedef std::map<lldb::addr_t, lldb::DataBufferSP> BlockMap;
+        typedef std::map<lldb::addr_t, lldb::DataBufferSP> L1CacheMap;
+        typedef std::list<lldb::addr_t> LRUList;
+        struct CacheLine
+        {
+            lldb::DataBufferSP data_sp;
+            LRUList::iterator lru_pos;
+        };
+        typedef std::map<lldb::addr_t, CacheLine> BlockMap;
         typedef RangeArray<lldb::addr_t, lldb::addr_t, 4> InvalidRanges;
+
+        size_t
+        ReadCacheLinesFromProcess (lldb::addr_t line_addr,
+                                   size_t num_lines,
+                                   size_t num_needed_lines,
+                                   Error &error);
+
+        void
+        AddCacheLine (lldb::addr_t line_addr, const lldb::DataBufferSP &data_sp);
+
+        void
+        RemoveCacheLine (BlockMap::iterator pos);
+
+        void
+        EvictCacheLinesIfNeeded (size_t num_protected_lines);
+
         //------------------------------------------------------------------
         // Classes that inherit from MemoryCache can see and modify these
         //------------------------------------------------------------------
         Process &m_process;
         uint32_t m_cache_line_byte_size;
-        Mutex m_mutex;
-        BlockMap m_cache;
+        mutable Mutex m_mutex;
+        L1CacheMap m_L1_cache;  // Variable sized blocks of memory added with AddL1CacheData()
+        BlockMap m_cache;       // Cache lines of m_cache_line_byte_size bytes
+        LRUList m_lru;          // Cache line addresses, least recently used first
+        size_t m_cache_byte_size;
+        lldb::addr_t m_next_sequential_addr;    // Where the previous read from the process ended
+        uint32_t m_prefetch_lines;              // How many lines we currently read ahead
+        Statistics m_stats;
         InvalidRanges m_invalid_ranges;
     private:
         DISALLOW_COPY_AND_ASSIGN (MemoryCache);
@@ -191,6 +290,74 @@ namespace lldb_private {
         DISALLOW_COPY_AND_ASSIGN (AllocatedMemoryCache);
     };
 
+    //----------------------------------------------------------------------
+    // A region of readable and writable memory in a process that is
+    // reserved once and handed out to expressions for data that only has
+    // to live for one evaluation, like the materialized argument struct.
+    //
+    // Allocations are bumped out of the region and are never freed one at
+    // a time. Everything is released at once when the outermost evaluation
+    // epoch ends. If an epoch ends while an expression may still be on a
+    // thread's stack, the region is abandoned instead and a new one is
+    // reserved the next time one is needed.
+    //----------------------------------------------------------------------
+    class AllocatedMemoryArena
+    {
+    public:
+        //------------------------------------------------------------------
+        // Constructors and Destructors
+        //------------------------------------------------------------------
+        AllocatedMemoryArena (Process &process);
+
+        ~AllocatedMemoryArena ();
+
+        void
+        Clear();
+
+        void
+        BeginEpoch ();
+
+        void
+        EndEpoch (bool expression_finished);
+
+        bool
+        InEpoch () const
+        {
+            return m_epoch_depth > 0;
+        }
+
+        //------------------------------------------------------------------
+        // Returns LLDB_INVALID_ADDRESS without setting an error if we are
+        // not in an epoch or the request isn't something the arena hands
+        // out, callers should then fall back to Process::AllocateMemory().
+        //------------------------------------------------------------------
+        lldb::addr_t
+        AllocateMemory (size_t byte_size,
+                        uint32_t permissions,
+                        Error &error);
+
+        bool
+        Contains (lldb::addr_t addr) const;
+
+    protected:
+        bool
+        RegionContains (lldb::addr_t region_addr, lldb::addr_t addr) const
+        {
+            return region_addr != LLDB_INVALID_ADDRESS && addr >= region_addr && addr < region_addr + m_byte_size;
+        }
+
+        Process &m_process;
+        mutable Mutex m_mutex;
+        const size_t m_byte_size;       // The size of each region we reserve
+        lldb::addr_t m_addr;            // The region we are handing out memory from
+        size_t m_offset;                // How much of m_addr has been handed out this epoch
+        uint32_t m_epoch_depth;
+        std::vector<lldb::addr_t> m_abandoned_regions;
+
+    private:
+        DISALLOW_COPY_AND_ASSIGN (AllocatedMemoryArena);
+    };
+
 } // namespace lldb_private
 
 #endif  // liblldb_Memory_h_
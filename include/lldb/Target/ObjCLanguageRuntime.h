@@ -194,6 +194,21 @@ public:
 
     void
     AddToMethodCache (lldb::addr_t class_addr, lldb::addr_t sel, lldb::addr_t impl_addr);
+
+    //------------------------------------------------------------------
+    /// Copy the implementations the runtime itself has cached for
+    /// \a class_addr into our method cache, so lookups for selectors
+    /// that have already been sent to that class don't need to run code
+    /// in the inferior.
+    ///
+    /// @return
+    ///     \b true if the runtime's cache for the class was read.
+    //------------------------------------------------------------------
+    virtual bool
+    ReadClassMethodCache (lldb::addr_t class_addr)
+    {
+        return false;
+    }
     
     TypeAndOrName
     LookupInClassNameCache (lldb::addr_t class_addr);
@@ -404,7 +419,30 @@ private:
     
     LazyBool m_has_new_literals_and_indexing;
 protected:
-    
+
+    //------------------------------------------------------------------
+    // Runtimes that can read the full list of classes out of the
+    // inferior in one go override this to fill in the ISA to descriptor
+    // map, so that later lookups don't have to read each class on its
+    // own. It is called before every lookup in the map and should be
+    // cheap when nothing has changed.
+    //------------------------------------------------------------------
+    virtual void
+    UpdateISAToDescriptorMap ()
+    {
+    }
+
+    bool
+    AddClass (ObjCISA isa, const ClassDescriptorSP &descriptor_sp)
+    {
+        if (isa != 0 && descriptor_sp)
+        {
+            m_isa_to_descriptor_cache[isa] = descriptor_sp;
+            return true;
+        }
+        return false;
+    }
+
     typedef std::map<ObjCISA, ClassDescriptorSP> ISAToDescriptorMap;
     typedef ISAToDescriptorMap::iterator ISAToDescriptorIterator;
     ISAToDescriptorMap                  m_isa_to_descriptor_cache;
@@ -238,6 +238,44 @@ namespace lldb_private {
                  const UUID *uuid_ptr,
                  FileSpec &local_file);
 
+        //------------------------------------------------------------------
+        /// Copy a file from the platform to this machine.
+        ///
+        /// @param[in] platform_file
+        ///     The path of the file on the platform.
+        ///
+        /// @param[in] local_file
+        ///     Where to put the copy. It only appears once the whole file
+        ///     has been copied.
+        ///
+        /// @return
+        ///     An error object.
+        //------------------------------------------------------------------
+        virtual Error
+        DownloadFile (const FileSpec &platform_file,
+                      const FileSpec &local_file);
+
+        //------------------------------------------------------------------
+        /// Copy a file from this machine to the platform.
+        ///
+        /// @param[in] local_file
+        ///     The file to copy.
+        ///
+        /// @param[in] platform_file
+        ///     The path to copy it to on the platform, which is replaced if
+        ///     it already exists.
+        ///
+        /// @param[in] mode
+        ///     The permissions the file gets if it is created.
+        ///
+        /// @return
+        ///     An error object.
+        //------------------------------------------------------------------
+        virtual Error
+        PutFile (const FileSpec &local_file,
+                 const FileSpec &platform_file,
+                 uint32_t mode = 0644);
+
         virtual Error
         GetSharedModule (const ModuleSpec &module_spec, 
                          lldb::ModuleSP &module_sp,
@@ -245,6 +283,36 @@ namespace lldb_private {
                          lldb::ModuleSP *old_module_sp_ptr,
                          bool *did_create_ptr);
 
+        //------------------------------------------------------------------
+        /// Get the path where a local copy of a remote platform's file is
+        /// kept in the module cache.
+        ///
+        /// The cache is in the directory named by the LLDB_MODULE_CACHE_DIR
+        /// environment variable, or in ~/.lldb/module_cache, and is keyed
+        /// by UUID. A file only needs to be copied once no matter which
+        /// path or session it is loaded from.
+        ///
+        /// @param[in] uuid
+        ///     The UUID of the file's contents.
+        ///
+        /// @param[in] platform_file
+        ///     The path to the file on the platform, only its name is used.
+        ///
+        /// @param[in] create_directory
+        ///     If true, create the directory the file goes in.
+        ///
+        /// @param[out] cache_file
+        ///     The path to the cached copy, which may not exist yet.
+        ///
+        /// @return
+        ///     \b true if \a cache_file was filled in.
+        //------------------------------------------------------------------
+        bool
+        GetModuleCacheFileSpec (const UUID &uuid,
+                                const FileSpec &platform_file,
+                                bool create_directory,
+                                FileSpec &cache_file);
+
         virtual Error
         ConnectRemote (Args& args);
 
@@ -44,6 +44,7 @@
 #include "lldb/Host/ReadWriteLock.h"
 #include "lldb/Interpreter/Args.h"
 #include "lldb/Interpreter/Options.h"
+#include "lldb/Interpreter/PropertyHandle.h"
 #include "lldb/Target/ExecutionContextScope.h"
 #include "lldb/Target/Memory.h"
 #include "lldb/Target/ThreadList.h"
@@ -52,6 +53,12 @@
 
 namespace lldb_private {
 
+typedef enum StdioOverflowPolicy
+{
+    eStdioOverflowDropOldest = 0,
+    eStdioOverflowBlock
+} StdioOverflowPolicy;
+
 //----------------------------------------------------------------------
 // ProcessProperties
 //----------------------------------------------------------------------
@@ -71,6 +78,41 @@ public:
 
     void
     SetExtraStartupCommands (const Args &args);
+
+    uint64_t
+    GetMemoryCacheSize () const;
+
+    bool
+    GetNonStopModeEnabled () const;
+
+    uint32_t
+    GetPacketCompressionMinSize () const;
+
+    bool
+    GetReadOnlyMemoryFromFiles () const;
+
+    bool
+    GetSharedMemoryTransportEnabled () const;
+
+    uint64_t
+    GetSimulatedLinkBandwidth () const;
+
+    uint32_t
+    GetSimulatedLinkLatency () const;
+
+    uint64_t
+    GetStackPrefetchSize () const;
+
+    uint64_t
+    GetSTDIOBufferSize () const;
+
+    StdioOverflowPolicy
+    GetSTDIOOverflowPolicy () const;
+
+protected:
+    // Read for every memory read
+    PropertyHandle m_disable_memory_cache;
+    PropertyHandle m_read_only_memory_from_files;
 };
 
 typedef STD_SHARED_PTR(ProcessProperties) ProcessPropertiesSP;
@@ -797,7 +839,8 @@ public:
         m_resume_count (0),
         m_wait_for_launch (false),
         m_ignore_existing (true),
-        m_continue_once_attached (false)
+        m_continue_once_attached (false),
+        m_defer_symbol_loading (false)
     {
     }
 
@@ -807,7 +850,8 @@ public:
         m_resume_count (0),
         m_wait_for_launch (false),
         m_ignore_existing (true),
-        m_continue_once_attached (false)
+        m_continue_once_attached (false),
+        m_defer_symbol_loading (false)
     {
         ProcessInfo::operator= (launch_info);
         SetProcessPluginName (launch_info.GetProcessPluginName());
@@ -850,6 +894,25 @@ public:
         m_continue_once_attached = b;
     }
 
+    //------------------------------------------------------------------
+    /// If \b true, the attach stops as soon as the threads and images
+    /// are known. Breakpoints in shared libraries are resolved when the
+    /// process first resumes, and their symbols are parsed in the
+    /// background, starting with the modules the threads are stopped
+    /// in.
+    //------------------------------------------------------------------
+    bool
+    GetDeferSymbolLoading () const
+    {
+        return m_defer_symbol_loading;
+    }
+
+    void
+    SetDeferSymbolLoading (bool b)
+    {
+        m_defer_symbol_loading = b;
+    }
+
     uint32_t
     GetResumeCount () const
     {
@@ -888,6 +951,7 @@ public:
         m_wait_for_launch = false;
         m_ignore_existing = true;
         m_continue_once_attached = false;
+        m_defer_symbol_loading = false;
     }
 
     bool
@@ -907,6 +971,7 @@ protected:
     bool m_wait_for_launch;
     bool m_ignore_existing;
     bool m_continue_once_attached; // Supports the use-case scenario of immediately continuing the process once attached.
+    bool m_defer_symbol_loading;
 };
 
 class ProcessLaunchCommandOptions : public Options
@@ -1114,13 +1179,16 @@ public:
         m_stop_id (0),
         m_resume_id (0), 
         m_memory_id (0),
+        m_natural_stop_id (0),
         m_last_user_expression_resume (0),
-        m_running_user_expression (false)
+        m_running_user_expression (false),
+        m_last_resume_for_user_expression (false)
     {}
     
     ProcessModID (const ProcessModID &rhs) :
         m_stop_id (rhs.m_stop_id),
-        m_memory_id (rhs.m_memory_id)
+        m_memory_id (rhs.m_memory_id),
+        m_natural_stop_id (rhs.m_natural_stop_id)
     {}
     
     const ProcessModID & operator= (const ProcessModID &rhs)
@@ -1129,6 +1197,7 @@ public:
         {
             m_stop_id = rhs.m_stop_id;
             m_memory_id = rhs.m_memory_id;
+            m_natural_stop_id = rhs.m_natural_stop_id;
         }
         return *this;
     }
@@ -1137,17 +1206,24 @@ public:
     
     void BumpStopID () { 
         m_stop_id++; 
+        if (!m_last_resume_for_user_expression)
+            m_natural_stop_id = m_stop_id;
     }
     
     void BumpMemoryID () { m_memory_id++; }
     
     void BumpResumeID () {
         m_resume_id++;
-        if (m_running_user_expression > 0)
+        m_last_resume_for_user_expression = m_running_user_expression > 0;
+        if (m_last_resume_for_user_expression)
             m_last_user_expression_resume = m_resume_id;
     }
     
     uint32_t GetStopID() const { return m_stop_id; }
+    // The stop ID of the last stop that wasn't the end of an expression
+    // the user (or a data formatter) ran. Values in the program can only
+    // have changed behind our back since then by running that code.
+    uint32_t GetNaturalStopID () const { return m_natural_stop_id; }
     uint32_t GetMemoryID () const { return m_memory_id; }
     uint32_t GetResumeID () const { return m_resume_id; }
     uint32_t GetLastUserExpressionResumeID () const { return m_last_user_expression_resume; }
@@ -1192,8 +1268,10 @@ private:
     uint32_t m_stop_id;
     uint32_t m_resume_id;
     uint32_t m_memory_id;
+    uint32_t m_natural_stop_id;
     uint32_t m_last_user_expression_resume;
     uint32_t m_running_user_expression;
+    bool m_last_resume_for_user_expression;
 };
 inline bool operator== (const ProcessModID &lhs, const ProcessModID &rhs)
 {
@@ -1327,7 +1405,8 @@ public:
         eBroadcastBitStateChanged   = (1 << 0),
         eBroadcastBitInterrupt      = (1 << 1),
         eBroadcastBitSTDOUT         = (1 << 2),
-        eBroadcastBitSTDERR         = (1 << 3)
+        eBroadcastBitSTDERR         = (1 << 3),
+        eBroadcastBitProfileData    = (1 << 4)
     };
 
     enum
@@ -1584,6 +1663,21 @@ public:
         return !m_finalize_called;
     }
 
+    //------------------------------------------------------------------
+    /// Return a command that "process plugin" runs with the rest of its
+    /// arguments, for commands that only make sense for this kind of
+    /// process.
+    ///
+    /// @return
+    ///     A command owned by the process plug-in, or NULL if the
+    ///     plug-in has no commands.
+    //------------------------------------------------------------------
+    virtual CommandObject *
+    GetPluginCommandObject ()
+    {
+        return NULL;
+    }
+
     //------------------------------------------------------------------
     /// Launch a new process.
     ///
@@ -2345,7 +2439,7 @@ public:
 protected:
     
     void
-    SetState (lldb::EventSP &event_sp);
+    SetState (lldb::EventIntrusiveSP &event_sp);
 
     lldb::StateType
     GetPrivateState ();
@@ -2486,6 +2580,30 @@ public:
                   size_t size,
                   Error &error) = 0;
 
+    //------------------------------------------------------------------
+    /// Actually do the reading of several ranges of memory from a
+    /// process.
+    ///
+    /// The default implementation calls DoReadMemory() once for each
+    /// range. Subclasses whose debug server can read many ranges in
+    /// one request should override this. A range may be read short,
+    /// the rest of it will be read with DoReadMemory().
+    ///
+    /// @param[in] ranges
+    ///     The ranges to read. The \a bytes_read member of each range
+    ///     is filled in with the number of bytes read into \a buf.
+    ///
+    /// @param[in] num_ranges
+    ///     The number of entries in \a ranges.
+    ///
+    /// @return
+    ///     The total number of bytes that were read.
+    //------------------------------------------------------------------
+    virtual size_t
+    DoReadMemoryRanges (MemoryReadRange *ranges,
+                        size_t num_ranges,
+                        Error &error);
+
     //------------------------------------------------------------------
     /// Read of memory from a process.
     ///
@@ -2493,6 +2611,14 @@ public:
     /// address space and remove any traps that may have been inserted
     /// into the memory.
     ///
+    /// Reads from read-only sections of modules that were loaded from
+    /// files are served from the files when the "read-only-memory-
+    /// from-files" setting is on, see ReadMemoryFromFiles(). It is off
+    /// by default, since the file doesn't have the changes made by
+    /// text relocations, the shared cache or the program itself. Use
+    /// Target::ReadMemory() with \a prefer_file_cache for the reads
+    /// that can always use the file.
+    ///
     /// This function is not meant to be overridden by Process
     /// subclasses, the subclasses should implement
     /// Process::DoReadMemory (lldb::addr_t, size_t, void *).
@@ -2521,14 +2647,35 @@ public:
                 size_t size,
                 Error &error);
 
+    //------------------------------------------------------------------
+    /// Read a range of memory into the memory cache ahead of time.
+    ///
+    /// Missing memory is read with as few reads from the process as
+    /// possible, and a range that runs into unreadable memory is cut
+    /// short without an error. Does nothing when the memory cache is
+    /// disabled, or for processes that don't read through the cache.
+    //------------------------------------------------------------------
+    virtual void
+    PrefetchMemory (lldb::addr_t vm_addr, size_t size);
+
+    //------------------------------------------------------------------
+    /// Read the "process.stack-prefetch-size" bytes of stack memory
+    /// above \a sp into the memory cache, so that unwinding and
+    /// reading local variables doesn't read the stack a few bytes at
+    /// a time.
+    //------------------------------------------------------------------
+    void
+    PrefetchStackMemory (lldb::addr_t sp);
+
     //------------------------------------------------------------------
     /// Read a NULL terminated C string from memory
     ///
-    /// This function will read a cache page at a time until the NULL
-    /// C stirng terminator is found. It will stop reading if the NULL
-    /// termination byte isn't found before reading \a cstr_max_len
-    /// bytes, and the results are always guaranteed to be NULL 
-    /// terminated (at most cstr_max_len - 1 bytes will be read).
+    /// This function will read the C string in growing chunks until the
+    /// NULL C stirng terminator is found, see the std::string version
+    /// below. It will stop reading if the NULL termination byte isn't
+    /// found before reading \a cstr_max_len bytes, and the results are
+    /// always guaranteed to be NULL terminated (at most
+    /// cstr_max_len - 1 bytes will be read).
     //------------------------------------------------------------------
     size_t
     ReadCStringFromMemory (lldb::addr_t vm_addr, 
@@ -2541,12 +2688,129 @@ public:
                            std::string &out_str,
                            Error &error);
 
+    //------------------------------------------------------------------
+    /// Read a NULL terminated C string of at most \a max_len characters
+    /// from memory into \a out_str.
+    ///
+    /// The first read goes to the end of the cache line the string
+    /// starts in, and each read after that is twice as big, so short
+    /// strings only touch one cache line and long ones take a few
+    /// reads. No read crosses a page boundary, a string that ends right
+    /// before memory that can't be read is still read in full.
+    ///
+    /// @return
+    ///     The length of the string that was read, which is \a max_len
+    ///     if the terminator wasn't found in the first \a max_len
+    ///     characters. \a error is only set if no memory at all could
+    ///     be read for a chunk of the string.
+    //------------------------------------------------------------------
+    size_t
+    ReadCStringFromMemory (lldb::addr_t vm_addr,
+                           std::string &out_str,
+                           size_t max_len,
+                           Error &error);
+
     size_t
     ReadMemoryFromInferior (lldb::addr_t vm_addr, 
                             void *buf, 
                             size_t size,
                             Error &error);
+
+    //------------------------------------------------------------------
+    /// Read memory from the file of the module it was loaded from,
+    /// without asking the process.
+    ///
+    /// This only works for ranges that are entirely inside one section
+    /// that the program can't write to, in a module with a UUID whose
+    /// object file was read from a file and not from memory. Nothing in
+    /// the range may have been written with WriteMemory(). The bytes are
+    /// then the same as the process's, with breakpoint traps removed.
+    /// This saves a round trip for each code and constant data read,
+    /// which is slow when debugging a remote device.
+    ///
+    /// @return
+    ///     \a size if the whole range was read, zero otherwise.
+    //------------------------------------------------------------------
+    size_t
+    ReadMemoryFromFiles (lldb::addr_t vm_addr,
+                         void *buf,
+                         size_t size);
+
+    //------------------------------------------------------------------
+    /// Read several small ranges of memory, like the nodes of a linked
+    /// list or the children of a value, with as few reads from the
+    /// process as possible.
+    ///
+    /// Ranges that aren't in the memory cache are read from the process
+    /// together. Software breakpoint opcodes are removed like they are
+    /// by ReadMemory().
+    ///
+    /// @param[in] ranges
+    ///     The ranges to read. The \a bytes_read member of each range
+    ///     is filled in with the number of bytes read into its \a buf,
+    ///     which is less than its \a size if not all of it could be read.
+    ///
+    /// @param[in] num_ranges
+    ///     The number of entries in \a ranges.
+    ///
+    /// @return
+    ///     The total number of bytes that were read.
+    //------------------------------------------------------------------
+    size_t
+    ReadMemoryRanges (MemoryReadRange *ranges,
+                      size_t num_ranges,
+                      Error &error);
+
+    size_t
+    ReadMemoryRangesFromInferior (MemoryReadRange *ranges,
+                                  size_t num_ranges,
+                                  Error &error);
+
+    //------------------------------------------------------------------
+    /// Find the first occurrence of a byte pattern in the memory of the
+    /// process between \a start_addr and \a end_addr. Memory that can't
+    /// be read is skipped.
+    ///
+    /// The default implementation reads the memory in large chunks.
+    /// Process plug-ins whose debug server can search memory without
+    /// sending it all back should override this.
+    ///
+    /// @param[in] start_addr
+    ///     The address at which to start searching.
+    ///
+    /// @param[in] end_addr
+    ///     The address one past the last byte that a match may cover.
+    ///
+    /// @param[in] pattern
+    ///     The bytes to search for.
+    ///
+    /// @param[in] pattern_size
+    ///     The number of bytes in \a pattern.
+    ///
+    /// @param[out] error
+    ///     An error value in case the search could not be done.
+    ///
+    /// @return
+    ///     The address of the first match, or LLDB_INVALID_ADDRESS if
+    ///     the pattern wasn't found or \a error was set.
+    //------------------------------------------------------------------
+    virtual lldb::addr_t
+    FindInMemory (lldb::addr_t start_addr,
+                  lldb::addr_t end_addr,
+                  const uint8_t *pattern,
+                  size_t pattern_size,
+                  Error &error);
     
+    //------------------------------------------------------------------
+    /// Get the cache that Process::ReadMemory() reads through when the
+    /// "disable-memory-cache" setting is off.
+    //------------------------------------------------------------------
+    MemoryCache &
+    GetMemoryCache ()
+    {
+        return m_memory_cache;
+    }
+
     //------------------------------------------------------------------
     /// Reads an unsigned integer of the specified byte size from 
     /// process memory.
@@ -2690,6 +2954,26 @@ public:
     size_t
     WriteMemory (lldb::addr_t vm_addr, const void *buf, size_t size, Error &error);
 
+    //------------------------------------------------------------------
+    /// Find out if WriteMemory() has written to any of the bytes in a
+    /// range that came from a section of an object file.
+    ///
+    /// Until it has, the bytes in the object file are the bytes in
+    /// memory (with any breakpoint traps taken out), so code can be
+    /// read from the object file instead of from the process.
+    ///
+    /// @param[in] vm_addr
+    ///     A virtual load address of the start of the range.
+    ///
+    /// @param[in] size
+    ///     The number of bytes in the range.
+    ///
+    /// @return
+    ///     \b true if any byte in the range was written to.
+    //------------------------------------------------------------------
+    bool
+    SectionMemoryWasWritten (lldb::addr_t vm_addr, size_t size) const;
+
 
     //------------------------------------------------------------------
     /// Actually allocate memory in the process.
@@ -2740,6 +3024,37 @@ public:
     lldb::addr_t
     AllocateMemory (size_t size, uint32_t permissions, Error &error);
 
+    //------------------------------------------------------------------
+    /// Allocate memory that an expression only needs while it is being
+    /// evaluated.
+    ///
+    /// Between BeginExpressionEpoch() and EndExpressionEpoch() small
+    /// readable and writable allocations come out of a region that is
+    /// reserved once per process, so they don't cost a round trip to the
+    /// process. Memory from the region is released all at once when the
+    /// outermost epoch ends; DeallocateMemory() on it does nothing.
+    /// Anything else is passed on to AllocateMemory().
+    //------------------------------------------------------------------
+    lldb::addr_t
+    AllocateExpressionMemory (size_t size, uint32_t permissions, Error &error);
+
+    void
+    BeginExpressionEpoch ()
+    {
+        m_expression_arena.BeginEpoch();
+    }
+
+    //------------------------------------------------------------------
+    /// @param[in] expression_finished
+    ///     true if nothing the expression was given can still be used,
+    ///     false if it was left on a thread's stack.
+    //------------------------------------------------------------------
+    void
+    EndExpressionEpoch (bool expression_finished)
+    {
+        m_expression_arena.EndEpoch(expression_finished);
+    }
+
     virtual Error
     GetMemoryRegionInfo (lldb::addr_t load_addr, 
                         MemoryRegionInfo &range_info)
@@ -2764,6 +3079,32 @@ public:
         error.SetErrorString ("Process::GetWatchpointSupportInfo() not supported");
         return error;
     }
+
+    //------------------------------------------------------------------
+    /// Get everything the dynamic loader needs to know about the images
+    /// in a dyld_image_info array with a single request, instead of
+    /// reading each image's info, path, mach header and load commands
+    /// with separate memory reads.
+    ///
+    /// @param[in] image_infos_addr
+    ///     The address of the dyld_image_info array in the process.
+    ///
+    /// @param[in] image_infos_count
+    ///     The number of entries in the array.
+    ///
+    /// @param[out] infos
+    ///     The image infos in the format of a "qShlibInfos" reply,
+    ///     which is described in docs/lldb-gdb-remote.txt.
+    //------------------------------------------------------------------
+    virtual Error
+    GetSharedLibraryInfos (lldb::addr_t image_infos_addr,
+                           uint32_t image_infos_count,
+                           std::string &infos)
+    {
+        Error error;
+        error.SetErrorString ("Process::GetSharedLibraryInfos() not supported");
+        return error;
+    }
     
     lldb::ModuleSP
     ReadModuleFromMemory (const FileSpec& file_spec, 
@@ -2926,6 +3267,26 @@ public:
     virtual size_t
     GetSTDERR (char *buf, size_t buf_size, Error &error);
 
+    //------------------------------------------------------------------
+    /// Write all the STDOUT that is currently available to \a strm.
+    ///
+    /// The bytes are written straight out of the process' buffer, so
+    /// this is the cheapest way to drain a lot of output.
+    ///
+    /// @return
+    ///     The number of bytes written to \a strm.
+    //------------------------------------------------------------------
+    size_t
+    GetSTDOUT (Stream &strm, Error &error);
+
+    //------------------------------------------------------------------
+    /// Write all the STDERR that is currently available to \a strm.
+    ///
+    /// @see Process::GetSTDOUT (Stream &, Error &)
+    //------------------------------------------------------------------
+    size_t
+    GetSTDERR (Stream &strm, Error &error);
+
     virtual size_t
     PutSTDIN (const char *buf, size_t buf_size, Error &error) 
     {
@@ -2933,6 +3294,59 @@ public:
         return 0;
     }
 
+    //------------------------------------------------------------------
+    /// Start sampling the process while it is running.
+    ///
+    /// Every \a interval_usec microseconds the process plug-in takes
+    /// one sample with the entries selected by \a scan_type (a mask of
+    /// lldb::ProfileDataScanType bits). Samples are delivered with
+    /// eBroadcastBitProfileData events and retrieved with
+    /// Process::GetAsyncProfileData(). Each sample is one line of text:
+    ///
+    /// time:<usec>;memory:<resident>,<virtual>;
+    /// thread:<tid>,<pc>,<pc>...;threadcpu:<tid>,<user usec>,<system usec>;...
+    ///
+    /// with all numbers in hex. The "thread" entries hold the PC and up
+    /// to \a max_frames - 1 return addresses.
+    //------------------------------------------------------------------
+    virtual Error
+    EnableAsyncProfiling (uint32_t interval_usec, uint32_t max_frames, uint32_t scan_type)
+    {
+        Error error;
+        error.SetErrorStringWithFormat("error: %s does not support async profiling", GetShortPluginName());
+        return error;
+    }
+
+    virtual Error
+    DisableAsyncProfiling ()
+    {
+        Error error;
+        error.SetErrorStringWithFormat("error: %s does not support async profiling", GetShortPluginName());
+        return error;
+    }
+
+    //------------------------------------------------------------------
+    /// Get any available profiling samples.
+    ///
+    /// @see Process::EnableAsyncProfiling (uint32_t, uint32_t, uint32_t)
+    ///
+    /// @return
+    ///     The number of bytes written into \a buf. If this value is
+    ///     equal to \a buf_size, another call to this function should
+    ///     be made to retrieve more data.
+    //------------------------------------------------------------------
+    size_t
+    GetAsyncProfileData (char *buf, size_t buf_size, Error &error);
+
+    //------------------------------------------------------------------
+    /// Called by process plug-ins when they receive profiling samples.
+    ///
+    /// When nobody is reading the samples, the oldest ones are dropped
+    /// once more than "target.process.stdio-buffer-size" bytes queue up.
+    //------------------------------------------------------------------
+    void
+    BroadcastAsyncProfileData (const char *s, size_t len);
+
     //----------------------------------------------------------------------
     // Process Breakpoints
     //----------------------------------------------------------------------
@@ -2971,6 +3385,42 @@ public:
     virtual Error
     DisableSoftwareBreakpoint (BreakpointSite *bp_site);
 
+    //------------------------------------------------------------------
+    /// Enable or disable all of the breakpoint sites in \a bp_sites at
+    /// once.
+    ///
+    /// Process plug-ins that can insert or remove many breakpoints with
+    /// fewer round trips than one at a time should override these. The
+    /// default implementations call EnableBreakpoint() or
+    /// DisableBreakpoint() for each site.
+    ///
+    /// @param[in] bp_sites
+    ///     The sites to enable or disable. Sites that already are get
+    ///     skipped.
+    ///
+    /// @param[out] error
+    ///     The error for the first site that failed, if any did.
+    ///
+    /// @return
+    ///     The number of sites that are enabled or disabled afterwards.
+    //------------------------------------------------------------------
+    virtual size_t
+    EnableBreakpointSites (const BreakpointSiteList &bp_sites, Error &error);
+
+    virtual size_t
+    DisableBreakpointSites (const BreakpointSiteList &bp_sites, Error &error);
+
+    // These do the same as EnableSoftwareBreakpoint() and
+    // DisableSoftwareBreakpoint() for several sites, but read, patch and
+    // write all of the sites that share a page of memory together, so a
+    // page with many sites costs one read, write and verify instead of
+    // one of each for every site.
+    size_t
+    EnableSoftwareBreakpoints (const BreakpointSiteList &bp_sites, Error &error);
+
+    size_t
+    DisableSoftwareBreakpoints (const BreakpointSiteList &bp_sites, Error &error);
+
     BreakpointSiteList &
     GetBreakpointSiteList();
 
@@ -2987,6 +3437,18 @@ public:
     CreateBreakpointSite (const lldb::BreakpointLocationSP &owner,
                           bool use_hardware);
 
+    //------------------------------------------------------------------
+    /// Give each location in \a owners a breakpoint site, enabling all
+    /// of the sites that need to be created with one
+    /// EnableBreakpointSites() call.
+    ///
+    /// @return
+    ///     The number of locations that have a breakpoint site afterwards.
+    //------------------------------------------------------------------
+    size_t
+    CreateBreakpointSites (const BreakpointLocationCollection &owners,
+                           bool use_hardware);
+
     Error
     DisableBreakpointSiteByID (lldb::user_id_t break_id);
 
@@ -3004,6 +3466,14 @@ public:
                                    lldb::user_id_t owner_loc_id,
                                    lldb::BreakpointSiteSP &bp_site_sp);
 
+    //------------------------------------------------------------------
+    /// Disable and remove the sites in \a bp_sites, which their owners
+    /// have already been removed from, with one DisableBreakpointSites()
+    /// call.
+    //------------------------------------------------------------------
+    void
+    RemoveUnownedBreakpointSites (const BreakpointSiteList &bp_sites);
+
     //----------------------------------------------------------------------
     // Process Watchpoints (optional)
     //----------------------------------------------------------------------
@@ -3019,6 +3489,24 @@ public:
     virtual bool
     UpdateThreadList (ThreadList &old_thread_list, ThreadList &new_thread_list) = 0;
 
+    //------------------------------------------------------------------
+    /// Get the IDs of the threads that have a stop reason for the
+    /// current stop, if the plug-in already knows them without asking
+    /// each thread.
+    ///
+    /// ThreadList::ShouldStop() and ThreadList::ShouldReportStop() only
+    /// look at these threads, the others would neither stop nor vote.
+    ///
+    /// @return
+    ///     \b true if \a tids holds all threads with a stop reason,
+    ///     \b false if every thread has to be asked.
+    //------------------------------------------------------------------
+    virtual bool
+    GetThreadsWithStopReason (std::vector<lldb::tid_t> &tids)
+    {
+        return false;
+    }
+
     void
     UpdateThreadListIfNeeded ();
 
@@ -3036,13 +3524,13 @@ public:
     // Event Handling
     //------------------------------------------------------------------
     lldb::StateType
-    GetNextEvent (lldb::EventSP &event_sp);
+    GetNextEvent (lldb::EventIntrusiveSP &event_sp);
 
     lldb::StateType
     WaitForProcessToStop (const TimeValue *timeout);
 
     lldb::StateType
-    WaitForStateChangedEvents (const TimeValue *timeout, lldb::EventSP &event_sp);
+    WaitForStateChangedEvents (const TimeValue *timeout, lldb::EventIntrusiveSP &event_sp);
     
     Event *
     PeekAtStateChangedEvents ();
@@ -3110,6 +3598,19 @@ protected:
     bool
     ShouldBroadcastEvent (Event *event_ptr);
 
+    //------------------------------------------------------------------
+    /// Check if the private state thread can restart the process after
+    /// a stop that nobody will see, without sending the running event
+    /// back through the private state thread.
+    ///
+    /// This is the case when the public state is still running (so the
+    /// running event would be suppressed anyway), no next event action
+    /// is pending and nobody is hijacking the public or the private
+    /// state changed events.
+    //------------------------------------------------------------------
+    bool
+    CanContinueInternally ();
+
 public:
     const lldb::ABISP &
     GetABI ();
@@ -3129,6 +3630,13 @@ public:
 
     virtual ObjCLanguageRuntime *
     GetObjCLanguageRuntime (bool retry_if_null = true);
+
+    //------------------------------------------------------------------
+    /// Let the language runtimes that have been created know that
+    /// modules have been removed from the target.
+    //------------------------------------------------------------------
+    void
+    ModulesDidUnload (ModuleList &module_list);
     
     bool
     IsPossibleDynamicValue (ValueObject& in_value);
@@ -3281,7 +3789,7 @@ protected:
         {
         }
         
-        virtual EventActionResult PerformAction (lldb::EventSP &event_sp) = 0;
+        virtual EventActionResult PerformAction (lldb::EventIntrusiveSP &event_sp) = 0;
         virtual void HandleBeingUnshipped () {}
         virtual EventActionResult HandleBeingInterrupted () = 0;
         virtual const char *GetExitString() = 0;
@@ -3312,7 +3820,7 @@ protected:
         {
         }
         
-        virtual EventActionResult PerformAction (lldb::EventSP &event_sp);
+        virtual EventActionResult PerformAction (lldb::EventIntrusiveSP &event_sp);
         virtual EventActionResult HandleBeingInterrupted ();
         virtual const char *GetExitString();
     private:
@@ -3337,6 +3845,50 @@ protected:
     //------------------------------------------------------------------
     typedef std::map<lldb::LanguageType, lldb::LanguageRuntimeSP> LanguageRuntimeCollection;
 
+    //------------------------------------------------------------------
+    // Output from the inferior that hasn't been read yet. Reads move an
+    // offset forward instead of erasing from the front of the string,
+    // and the bytes that were read are only dropped once they make up
+    // half the string, so reading a lot of output in small pieces stays
+    // linear. Only one STDOUT or STDERR event is outstanding at a time:
+    // notification_pending is set when one is broadcast and cleared when
+    // the output is read.
+    //------------------------------------------------------------------
+    class StdioBuffer
+    {
+    public:
+        StdioBuffer () :
+            notification_pending (false),
+            m_data (),
+            m_read_pos (0)
+        {
+        }
+
+        size_t
+        GetBytesAvailable () const
+        {
+            return m_data.size() - m_read_pos;
+        }
+
+        const char *
+        GetBytes () const
+        {
+            return m_data.data() + m_read_pos;
+        }
+
+        void
+        Append (const char *s, size_t len);
+
+        void
+        Consume (size_t len);
+
+        bool notification_pending;
+
+    private:
+        std::string m_data;
+        size_t m_read_pos;
+    };
+
     struct PreResumeCallbackAndBaton
     {
         bool (*callback) (void *);
@@ -3376,17 +3928,27 @@ protected:
     lldb::InputReaderSP         m_process_input_reader;
     Communication 				m_stdio_communication;
     Mutex        				m_stdio_communication_mutex;
-    std::string                 m_stdout_data;
-    std::string                 m_stderr_data;
+    StdioBuffer                 m_stdout_data;
+    StdioBuffer                 m_stderr_data;
+    StdioBuffer                 m_profile_data;
     MemoryCache                 m_memory_cache;
+    RangeArray<lldb::addr_t, lldb::addr_t, 4> m_written_section_ranges; ///< Load address ranges in object file sections that WriteMemory() has written to
+    mutable Mutex               m_written_section_ranges_mutex;
     AllocatedMemoryCache        m_allocated_memory_cache;
+    AllocatedMemoryArena        m_expression_arena;
     bool                        m_should_detach;   /// Should we detach if the process object goes away with an explicit call to Kill or Detach?
+    bool                        m_defer_attach_symbols;     ///< Set by Attach() for CompleteAttach(), see ProcessAttachInfo::GetDeferSymbolLoading()
     LanguageRuntimeCollection 	m_language_runtimes;
     std::auto_ptr<NextEventAction> m_next_event_action_ap;
     std::vector<PreResumeCallbackAndBaton> m_pre_resume_actions;
     ReadWriteLock               m_run_lock;
     Predicate<bool>             m_currently_handling_event;
+    bool                        m_internal_continue;    ///< The next private state change, if it is a running state, was caused by an internal continue and isn't broadcast. Protected by the m_private_state mutex.
     bool                        m_finalize_called;
+    lldb::thread_t              m_type_prewarm_thread;  // Thread that completes the variable types of the selected frame after a stop
+    Predicate<bool>             m_type_prewarm_cancel;
+    lldb::ModuleSP              m_type_prewarm_module_sp;
+    std::vector<lldb::VariableSP> m_type_prewarm_variables;
 
     enum {
         eCanJITDontKnow= 0,
@@ -3425,19 +3987,28 @@ protected:
     RunPrivateStateThread ();
 
     void
-    HandlePrivateEvent (lldb::EventSP &event_sp);
+    HandlePrivateEvent (lldb::EventIntrusiveSP &event_sp);
+
+    void
+    StartTypePrewarmThread ();
+
+    void
+    StopTypePrewarmThread ();
+
+    static lldb::thread_result_t
+    TypePrewarmThread (void *arg);
 
     lldb::StateType
-    WaitForProcessStopPrivate (const TimeValue *timeout, lldb::EventSP &event_sp);
+    WaitForProcessStopPrivate (const TimeValue *timeout, lldb::EventIntrusiveSP &event_sp);
 
     // This waits for both the state change broadcaster, and the control broadcaster.
     // If control_only, it only waits for the control broadcaster.
 
     bool
-    WaitForEventsPrivate (const TimeValue *timeout, lldb::EventSP &event_sp, bool control_only);
+    WaitForEventsPrivate (const TimeValue *timeout, lldb::EventIntrusiveSP &event_sp, bool control_only);
 
     lldb::StateType
-    WaitForStateChangedEventsPrivate (const TimeValue *timeout, lldb::EventSP &event_sp);
+    WaitForStateChangedEventsPrivate (const TimeValue *timeout, lldb::EventIntrusiveSP &event_sp);
 
     lldb::StateType
     WaitForState (const TimeValue *timeout,
@@ -3452,6 +4023,15 @@ protected:
     
     void
     AppendSTDERR (const char *s, size_t len);
+
+    void
+    AppendSTDIOData (StdioBuffer &buffer, const char *s, size_t len, uint32_t event_type);
+
+    size_t
+    ReadSTDIOData (StdioBuffer &buffer, char *buf, size_t buf_size);
+
+    size_t
+    ReadSTDIOData (StdioBuffer &buffer, Stream &strm);
     
     static void
     STDIOReadThreadBytesReceived (void *baton, const void *src, size_t src_len);
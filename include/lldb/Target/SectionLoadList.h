@@ -13,12 +13,13 @@
 // C Includes
 // C++ Includes
 #include <map>
+#include <vector>
 
 // Other libraries and framework includes
 #include "llvm/ADT/DenseMap.h"
 // Project includes
 #include "lldb/lldb-public.h"
-#include "lldb/Host/Mutex.h"
+#include "lldb/Host/ReadWriteLock.h"
 
 namespace lldb_private {
 
@@ -28,17 +29,9 @@ public:
     //------------------------------------------------------------------
     // Constructors and Destructors
     //------------------------------------------------------------------
-    SectionLoadList () :
-        m_addr_to_sect (),
-        m_sect_to_addr (),
-        m_mutex (Mutex::eMutexTypeRecursive)
+    SectionLoadList ();
 
-    {
-    }
-
-    ~SectionLoadList()
-    {
-    }
+    ~SectionLoadList();
 
     bool
     IsEmpty() const;
@@ -73,9 +66,50 @@ public:
 protected:
     typedef std::map<lldb::addr_t, lldb::SectionSP> addr_to_sect_collection;
     typedef llvm::DenseMap<const Section *, lldb::addr_t> sect_to_addr_collection;
+
+    //------------------------------------------------------------------
+    // An immutable copy of m_addr_to_sect sorted by load address, which
+    // is what ResolveLoadAddress() searches so that lookups never take
+    // m_lock. Changes to the load list mark it stale and the next
+    // lookup publishes a new one, so a run of loads only rebuilds it
+    // once. Old copies are kept until no lookup can still be using them.
+    //------------------------------------------------------------------
+    struct LoadedSection
+    {
+        lldb::addr_t load_addr;
+        lldb::SectionSP section_sp;
+    };
+    typedef std::vector<LoadedSection> loaded_section_collection;
+
+    struct Snapshot
+    {
+        loaded_section_collection sections;
+        mutable volatile uint32_t last_hit_idx; // Index of the section the last lookup found
+    };
+
+    static bool
+    LoadAddressLessThanSection (lldb::addr_t load_addr, const LoadedSection &loaded_section);
+
+    static bool
+    SectionContainsLoadAddress (const LoadedSection &loaded_section, lldb::addr_t load_addr);
+
+    // Must be called with m_lock locked for writing
+    void
+    UpdateSnapshot () const;
+
+    const Snapshot *
+    AcquireSnapshot () const;
+
+    void
+    ReleaseSnapshot () const;
+
     addr_to_sect_collection m_addr_to_sect;
     sect_to_addr_collection m_sect_to_addr;
-    mutable Mutex m_mutex;
+    mutable ReadWriteLock m_lock;
+    mutable Snapshot * volatile m_snapshot;
+    mutable std::vector<Snapshot *> m_retired_snapshots;  // Replaced snapshots that lookups might still be using
+    mutable volatile uint32_t m_snapshot_readers;         // How many lookups are using a snapshot
+    mutable volatile bool m_snapshot_is_stale;
 
 private:
     DISALLOW_COPY_AND_ASSIGN (SectionLoadList);
@@ -106,6 +106,14 @@ public:
     lldb::VariableListSP
     GetInScopeVariableList (bool get_file_globals);
 
+    //------------------------------------------------------------------
+    /// Get the variables of the blocks that contain the frame's PC, in
+    /// the order GetVariableList() has them. Unlike GetVariableList(),
+    /// this doesn't parse the variables of the function's other blocks.
+    //------------------------------------------------------------------
+    lldb::VariableListSP
+    GetScopeVariableList (bool get_file_globals);
+
     // See ExpressionPathOption enumeration for "options" values
     lldb::ValueObjectSP
     GetValueForVariableExpressionPath (const char *var_expr, 
@@ -179,6 +187,11 @@ protected:
     void
     UpdatePreviousFrameFromCurrentFrame (StackFrame &curr_frame);
 
+    // Reuse a frame from the previous stop that moved to a new position
+    // in the stack without being unwound again.
+    void
+    UpdateFrameIndexes (uint32_t frame_idx, uint32_t concrete_frame_idx);
+
     bool
     HasCachedData () const;
     
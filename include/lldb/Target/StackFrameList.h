@@ -124,6 +124,12 @@ protected:
 
     uint32_t
     GetCurrentInlinedDepth ();
+
+    lldb::StackFrameSP
+    MaterializeFrame (uint32_t idx);
+
+    void
+    SpliceFrames (StackFrameList &prev_frames, uint32_t prev_idx);
     
     //------------------------------------------------------------------
     // Classes that inherit from StackFrameList can see and modify these
@@ -132,10 +138,24 @@ protected:
     typedef collection::iterator iterator;
     typedef collection::const_iterator const_iterator;
 
+    // When showing inlined frames we have to look up the blocks of every
+    // concrete frame to know how many frames there are, but we only make
+    // StackFrame objects for the frames that get asked for. Until then a
+    // frame is described by one of these.
+    struct FrameRecord
+    {
+        lldb::addr_t cfa;
+        lldb::addr_t pc;            // The load address of the frame code address
+        uint32_t concrete_idx;      // The unwind frame index
+        uint32_t inlined_depth;     // How many inlined scopes out from the concrete frame we are
+    };
+    typedef std::vector<FrameRecord> FrameRecordCollection;
+
     Thread &m_thread;
     lldb::StackFrameListSP m_prev_frames_sp;
     mutable Mutex m_mutex;
     collection m_frames;
+    FrameRecordCollection m_frame_records;  // One per entry in m_frames when showing inlined frames
     uint32_t m_selected_frame_idx;
     uint32_t m_concrete_frames_fetched;
     uint32_t m_current_inlined_depth;
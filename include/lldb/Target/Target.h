@@ -12,6 +12,8 @@
 
 // C Includes
 // C++ Includes
+#include <set>
+#include <vector>
 
 // Other libraries and framework includes
 // Project includes
@@ -30,11 +32,13 @@
 #include "lldb/Interpreter/OptionValueBoolean.h"
 #include "lldb/Interpreter/OptionValueEnumeration.h"
 #include "lldb/Interpreter/OptionValueFileSpec.h"
+#include "lldb/Interpreter/PropertyHandle.h"
 #include "lldb/Symbol/SymbolContext.h"
 #include "lldb/Target/ABI.h"
 #include "lldb/Target/ExecutionContextScope.h"
 #include "lldb/Target/PathMappingList.h"
 #include "lldb/Target/SectionLoadList.h"
+#include "lldb/Target/TraceBuffer.h"
 
 namespace lldb_private {
 
@@ -133,6 +137,49 @@ public:
     
     const char *
     GetExpressionPrefixContentsAsCString ();
+
+    FileSpec
+    GetIndexCachePath () const;
+
+    uint64_t
+    GetModuleCacheSize () const;
+
+    bool
+    GetParallelModuleSearch () const;
+
+    bool
+    GetShareTypesAcrossModules () const;
+
+    bool
+    GetPrewarmFrameVariableTypes () const;
+
+    bool
+    GetPreloadSymbols () const;
+
+    bool
+    GetParallelBacktrace () const;
+
+    bool
+    GetUseFastStepping () const;
+
+    uint64_t
+    GetTracepointBufferSize () const;
+
+    uint64_t
+    GetScratchASTMemoryBudget () const;
+
+    bool
+    GetExprBatchPointerChecks () const;
+
+    bool
+    GetSymbolsOnDemand () const;
+
+protected:
+    // Settings that are read for every value that is displayed
+    PropertyHandle m_prefer_dynamic;
+    PropertyHandle m_enable_synthetic;
+    PropertyHandle m_max_children_count;
+    PropertyHandle m_max_summary_length;
 };
 
 typedef STD_SHARED_PTR(TargetProperties) TargetPropertiesSP;
@@ -194,7 +241,7 @@ public:
         Dump (Stream *s) const;
 
         static const lldb::TargetSP
-        GetTargetFromEvent (const lldb::EventSP &event_sp);
+        GetTargetFromEvent (const lldb::EventIntrusiveSP &event_sp);
         
         static const TargetEventData *
         GetEventDataFromEvent (const Event *event_sp);
@@ -217,6 +264,18 @@ public:
     static FileSpecList
     GetDefaultExecutableSearchPaths ();
 
+    static FileSpec
+    GetDefaultIndexCachePath ();
+
+    static uint64_t
+    GetDefaultModuleCacheSize ();
+
+    static bool
+    GetDefaultParallelModuleSearch ();
+
+    static bool
+    GetDefaultShareTypesAcrossModules ();
+
     static ArchSpec
     GetDefaultArchitecture ();
 
@@ -226,9 +285,20 @@ public:
 //    void
 //    UpdateInstanceName ();
 
+    //------------------------------------------------------------------
+    /// Find or create the module for \a module_spec and add it to the
+    /// target's image list.
+    ///
+    /// @param[in] notify
+    ///     If \b true, call ModulesDidLoad() for a newly added module.
+    ///     Callers that add many modules at once can pass \b false and
+    ///     call ModulesDidLoad() once for all of them after they have
+    ///     set their load addresses.
+    //------------------------------------------------------------------
     lldb::ModuleSP
     GetSharedModule (const ModuleSpec &module_spec,
-                     Error *error_ptr = NULL);
+                     Error *error_ptr = NULL,
+                     bool notify = true);
 
     //----------------------------------------------------------------------
     // Settings accessors
@@ -345,6 +415,23 @@ public:
     CreateBreakpoint (Address &addr,
                       bool internal = false);
 
+    //------------------------------------------------------------------
+    /// Get the internal breakpoint that functions called by the
+    /// expression parser return to. It stays inserted between calls so
+    /// each call doesn't have to resolve, insert and remove a
+    /// breakpoint of its own, and it only stops threads that are
+    /// running a function call.
+    ///
+    /// @param[in] load_addr
+    ///     The return address the call was set up with.
+    ///
+    /// @return
+    ///     The breakpoint, or an empty shared pointer if it couldn't
+    ///     be set.
+    //------------------------------------------------------------------
+    lldb::BreakpointSP
+    GetFunctionCallReturnBreakpoint (lldb::addr_t load_addr);
+
     // Use this to create a function breakpoint by regexp in containingModule/containingSourceFiles, or all modules if it is NULL
     // When "skip_prologue is set to eLazyBoolCalculate, we use the current target 
     // setting, else we use the values passed in
@@ -469,6 +556,44 @@ public:
     void
     ModulesDidUnload (ModuleList &module_list);
 
+    //------------------------------------------------------------------
+    /// Put off resolving breakpoints in modules other than the
+    /// executable that are loaded from now on, and have the symbol
+    /// preloader parse their symbols in the background instead.
+    /// Breakpoints can't be hit before the process runs, so attaching
+    /// uses this to get to the first stop without waiting on every
+    /// shared library's symbols.
+    //------------------------------------------------------------------
+    void
+    DeferModuleBreakpoints ();
+
+    //------------------------------------------------------------------
+    /// Resolve the breakpoints in the modules that were loaded since
+    /// DeferModuleBreakpoints() and stop deferring. The process calls
+    /// this before it resumes.
+    //------------------------------------------------------------------
+    void
+    ResolveDeferredModules ();
+
+    //------------------------------------------------------------------
+    /// Move \a module_list to the front of the background symbol
+    /// preloading queue, used for the modules the user is about to
+    /// look at.
+    //------------------------------------------------------------------
+    void
+    PrioritizeModules (ModuleList &module_list);
+
+    //------------------------------------------------------------------
+    /// Resolve breakpoints again in the modules that loaded their debug
+    /// information on demand since the last call, so file and line
+    /// breakpoints find their locations. The process calls this before
+    /// it resumes.
+    ///
+    /// @see TargetProperties::GetSymbolsOnDemand()
+    //------------------------------------------------------------------
+    void
+    ResolveModulesLoadedOnDemand ();
+
     
     //------------------------------------------------------------------
     /// Get \a load_addr as a callable code load address for this target
@@ -685,9 +810,11 @@ public:
     // want to read from const sections in object files, read from the target.
     // This version of ReadMemory will try and read memory from the process
     // if the process is alive. The order is:
-    // 1 - if (prefer_file_cache == true) then read from object file cache
+    // 1 - if (prefer_file_cache == true) then read from object file cache,
+    //     as long as the section is read only and the process hasn't
+    //     written to the bytes (see FileCacheMatchesMemory())
     // 2 - if there is a valid process, try and read from its memory
-    // 3 - if (prefer_file_cache == false) then read from object file cache
+    // 3 - if the object file cache wasn't read in step 1, read from it
     size_t
     ReadMemory (const Address& addr,
                 bool prefer_file_cache,
@@ -696,6 +823,19 @@ public:
                 Error &error,
                 lldb::addr_t *load_addr_ptr = NULL);
 
+    //------------------------------------------------------------------
+    /// Find out if the bytes in an object file can stand in for the
+    /// bytes in the process's memory.
+    ///
+    /// They can when \a addr is in a section that the program can't
+    /// write to, like code and C strings, and nothing has been written
+    /// to the range through Process::WriteMemory(). Process memory reads
+    /// take any breakpoint traps out, so in that case the two are the
+    /// same without needing to ask the process.
+    //------------------------------------------------------------------
+    bool
+    FileCacheMatchesMemory (const Address& addr, size_t dst_len);
+
     size_t
     ReadScalarIntegerFromMemory (const Address& addr, 
                                  bool prefer_file_cache,
@@ -717,6 +857,38 @@ public:
                            Error &error,
                            Address &pointer_addr);
 
+    //------------------------------------------------------------------
+    /// Resolve the symbol contexts for many load addresses at once.
+    ///
+    /// The addresses are resolved in address order so nearby addresses
+    /// share the work of finding their module and section. Addresses in
+    /// the same function and symbol share one lookup, unless
+    /// \a resolve_scope asks for blocks or line entries, which can
+    /// differ within a function.
+    ///
+    /// @param[in] load_addrs
+    ///     The load addresses to resolve.
+    ///
+    /// @param[in] num_addrs
+    ///     The number of addresses in \a load_addrs.
+    ///
+    /// @param[in] resolve_scope
+    ///     The lldb::SymbolContextItem bits to resolve.
+    ///
+    /// @param[out] sc_list
+    ///     One symbol context is appended for each address, in the same
+    ///     order as \a load_addrs. Addresses that aren't in any loaded
+    ///     section get an empty symbol context.
+    ///
+    /// @return
+    ///     The number of addresses that resolved to a module.
+    //------------------------------------------------------------------
+    size_t
+    ResolveSymbolContextsForLoadAddresses (const lldb::addr_t *load_addrs,
+                                           size_t num_addrs,
+                                           uint32_t resolve_scope,
+                                           SymbolContextList &sc_list);
+
     SectionLoadList&
     GetSectionLoadList()
     {
@@ -729,6 +901,14 @@ public:
         return m_section_load_list;
     }
 
+    //------------------------------------------------------------------
+    /// Get the buffer that the hits of this target's tracepoints are
+    /// recorded in, sized to the "target.tracepoint-buffer-size"
+    /// setting.
+    //------------------------------------------------------------------
+    TraceBuffer &
+    GetTraceBuffer ();
+
     static Target *
     GetTargetFromContexts (const ExecutionContext *exe_ctx_ptr, 
                            const SymbolContext *sc_ptr);
@@ -757,9 +937,41 @@ public:
     ClangASTContext *
     GetScratchClangASTContext(bool create_on_demand=true);
     
+    //------------------------------------------------------------------
+    /// Get a shared pointer that keeps \a clang_ast alive, if it is this
+    /// target's scratch AST context or one that was retired by
+    /// CompactScratchClangASTContext().
+    ///
+    /// Values made with types from the scratch AST context hold on to
+    /// it this way, so a retired context isn't freed while they could
+    /// still use it.
+    ///
+    /// @return
+    ///     An empty shared pointer if \a clang_ast isn't a scratch AST
+    ///     context of this target.
+    //------------------------------------------------------------------
+    lldb::ClangASTContextSP
+    GetScratchClangASTContextSP (clang::ASTContext *clang_ast);
+    
     ClangASTImporter *
     GetClangASTImporter();
     
+    //------------------------------------------------------------------
+    /// If the scratch AST context and the persistent variables use more
+    /// memory than the "scratch-ast-memory-budget" setting allows, move
+    /// the persistent variables and types to a new scratch AST context
+    /// and retire the current one.
+    ///
+    /// A retired context is kept until the next time this happens and
+    /// after that for as long as any value holds on to it, see
+    /// GetScratchClangASTContextSP(). Once over the budget, the scratch
+    /// AST context has to grow by half the budget again before it is
+    /// replaced again, so persistent variables that don't fit in the
+    /// budget by themselves don't make every expression compact it.
+    //------------------------------------------------------------------
+    void
+    CompactScratchClangASTContext ();
+    
     // Since expressions results can persist beyond the lifetime of a process,
     // and the const expression results are available after a process is gone,
     // we provide a way for expressions to be evaluated from the Target itself.
@@ -776,6 +988,35 @@ public:
                         lldb::ValueObjectSP &result_valobj_sp,
                         uint32_t single_thread_timeout_usec = 500000);
 
+    //------------------------------------------------------------------
+    /// Forget the compiled expressions that EvaluateExpression() keeps
+    /// around to run again at later stops.
+    //------------------------------------------------------------------
+    void
+    ClearExpressionCache ();
+
+    //------------------------------------------------------------------
+    /// Names that the expression parser looked for in the root namespace
+    /// of every module in the target without finding anything, so it can
+    /// skip searching for them again.  Forgotten whenever the module list
+    /// changes.
+    ///
+    /// A search can race with modules being loaded, so take the
+    /// generation before searching and pass it to AddMissingGlobalName(),
+    /// which ignores the name if the set was cleared in the meantime.
+    //------------------------------------------------------------------
+    bool
+    IsMissingGlobalName (const ConstString &name);
+
+    uint32_t
+    GetMissingGlobalNamesGeneration ();
+
+    void
+    AddMissingGlobalName (const ConstString &name, uint32_t generation);
+
+    void
+    ClearMissingGlobalNames ();
+
     ClangPersistentVariables &
     GetPersistentVariables()
     {
@@ -985,9 +1226,11 @@ protected:
     ArchSpec        m_arch;
     ModuleList      m_images;           ///< The list of images for this process (shared libraries and anything dynamically loaded).
     SectionLoadList m_section_load_list;
+    TraceBuffer     m_trace_buffer;     ///< The recorded hits of tracepoints, kept across process instances.
     BreakpointList  m_breakpoint_list;
     BreakpointList  m_internal_breakpoint_list;
     lldb::BreakpointSP m_last_created_breakpoint;
+    lldb::break_id_t m_function_call_return_break_id;
     WatchpointList  m_watchpoint_list;
     lldb::WatchpointSP m_last_created_watchpoint;
     // We want to tightly control the process destruction process so
@@ -997,11 +1240,39 @@ protected:
     bool m_valid;
     lldb::SearchFilterSP  m_search_filter_sp;
     PathMappingList m_image_search_paths;
-    std::auto_ptr<ClangASTContext> m_scratch_ast_context_ap;
-    std::auto_ptr<ClangASTSource> m_scratch_ast_source_ap;
+    lldb::ClangASTContextSP m_scratch_ast_context_sp;      ///< Also owns the ClangASTSource that completes its types
+    std::vector<lldb::ClangASTContextSP> m_retired_scratch_ast_contexts;   ///< Scratch AST contexts replaced by CompactScratchClangASTContext(), oldest first
+    uint64_t m_scratch_ast_compacted_size;                  ///< The memory used right after the last CompactScratchClangASTContext()
     std::auto_ptr<ClangASTImporter> m_ast_importer_ap;
     ClangPersistentVariables m_persistent_variables;      ///< These are the persistent variables associated with this process for the expression parser.
 
+    // Everything that went into compiling an expression that
+    // EvaluateExpression() can run again without parsing it.  The
+    // modules the code refers to are covered by emptying the cache
+    // whenever the module list changes.
+    struct ExpressionCacheKey
+    {
+        std::string expr_text;
+        std::string prefix_text;
+        lldb::LanguageType language;
+        bool coerce_to_id;
+        const void *decl_context;   ///< The block, function or symbol the expression was compiled in
+
+        bool
+        operator< (const ExpressionCacheKey &rhs) const;
+    };
+    typedef std::map<ExpressionCacheKey, STD_SHARED_PTR(ClangUserExpression)> ExpressionCache;
+    ExpressionCache m_expression_cache;
+    Mutex           m_expression_cache_mutex;
+    std::set<const char *> m_missing_global_names;    ///< Uniqued names of globals that no module has
+    uint32_t        m_missing_global_names_generation;    ///< Bumped each time m_missing_global_names is cleared
+    Mutex           m_missing_global_names_mutex;
+    Mutex           m_deferred_modules_mutex;     ///< Protects the two members below
+    ModuleList      m_deferred_modules;           ///< Modules whose breakpoints haven't been resolved, see DeferModuleBreakpoints()
+    bool            m_defer_module_breakpoints;
+    ModuleList      m_symbols_on_demand_modules;  ///< Modules this target made load their debug information on demand, until they do
+    uint32_t        m_symbols_on_demand_generation; ///< Module::GetSymbolsLoadedOnDemandGeneration() when they were last checked
+
     SourceManager m_source_manager;
 
     typedef std::map<lldb::user_id_t, StopHookSP> StopHookCollection;
@@ -11,6 +11,7 @@
 #define liblldb_Thread_h_
 
 #include "lldb/lldb-private.h"
+#include "lldb/Host/FileSpec.h"
 #include "lldb/Host/Mutex.h"
 #include "lldb/Core/UserID.h"
 #include "lldb/Core/UserSettingsController.h"
@@ -43,6 +44,9 @@ public:
     
     bool
     GetTraceEnabledState() const;
+
+    FileSpec
+    GetTraceFile() const;
 };
 
 typedef STD_SHARED_PTR(ThreadProperties) ThreadPropertiesSP;
@@ -262,6 +266,27 @@ public:
         return GetStackFrameList()->GetNumFrames();
     }
 
+    //------------------------------------------------------------------
+    /// Get the PCs of the frames in this thread as cheaply as possible.
+    ///
+    /// No StackFrame objects are created and no symbols are looked up,
+    /// so this is meant for clients that sample stacks often, like
+    /// profilers. Where the architecture allows it the frame pointer
+    /// chain is followed, in which case a frame whose function hasn't
+    /// set up its frame pointer yet may be missing.
+    ///
+    /// @param[out] pcs
+    ///     A buffer that receives the PCs, starting with frame zero.
+    ///
+    /// @param[in] max_pcs
+    ///     The number of PCs that fit in \a pcs.
+    ///
+    /// @return
+    ///     The number of PCs that were filled in.
+    //------------------------------------------------------------------
+    uint32_t
+    GetFramePCs (lldb::addr_t *pcs, uint32_t max_pcs);
+
     virtual lldb::StackFrameSP
     GetStackFrameAtIndex (uint32_t idx)
     {
@@ -280,7 +305,7 @@ public:
     uint32_t
     GetCurrentInlinedDepth()
     {
-        return GetStackFrameList()->DecrementCurrentInlinedDepth();
+        return GetStackFrameList()->GetCurrentInlinedDepth();
     }
     
     virtual lldb::StackFrameSP
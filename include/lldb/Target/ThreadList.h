@@ -45,6 +45,11 @@ public:
     void
     AddThread (const lldb::ThreadSP &thread_sp);
 
+    // Remove the thread with ID "tid" from the list and return it, if there
+    // is one.
+    lldb::ThreadSP
+    RemoveThreadByID (lldb::tid_t tid);
+
     // Return the selected thread if there is one.  Otherwise, return the thread
     // selected at index 0.
     lldb::ThreadSP
@@ -128,16 +133,45 @@ public:
     
     void
     Update (ThreadList &rhs);
+
+    //------------------------------------------------------------------
+    /// Unwind the first \a num_frames frames of each thread in
+    /// \a threads ahead of time.
+    ///
+    /// If the "target.parallel-backtrace" setting is enabled the threads
+    /// are unwound on worker threads, otherwise this does nothing and
+    /// the frames are unwound on demand as usual. Either way, callers
+    /// then get the frames and display them in order.
+    ///
+    /// @param[in] threads
+    ///     The threads to unwind.
+    ///
+    /// @param[in] num_frames
+    ///     The number of frames to unwind in each thread, or UINT32_MAX
+    ///     to unwind all of them.
+    //------------------------------------------------------------------
+    static void
+    ComputeStackFrames (const std::vector<lldb::ThreadSP> &threads, uint32_t num_frames);
     
 protected:
 
     typedef std::vector<lldb::ThreadSP> collection;
+    typedef std::pair<lldb::tid_t, uint32_t> TIDIndexPair;
+    typedef std::vector<TIDIndexPair> tid_index_collection;
+
+    //------------------------------------------------------------------
+    /// Make sure m_tid_index has an entry for every thread.
+    //------------------------------------------------------------------
+    void
+    UpdateTIDIndex ();
+
     //------------------------------------------------------------------
     // Classes that inherit from Process can see and modify these
     //------------------------------------------------------------------
     Process *m_process; ///< The process that manages this thread list.
     uint32_t m_stop_id; ///< The process stop ID that this thread list is valid for.
     collection m_threads; ///< The threads for this process.
+    tid_index_collection m_tid_index; ///< Thread IDs sorted with their indexes into m_threads, so processes with many threads can find them by ID quickly. Rebuilt when it doesn't have an entry for every thread.
     mutable Mutex m_threads_mutex;
     lldb::tid_t m_selected_tid;  ///< For targets that need the notion of a current thread.
 
@@ -36,6 +36,13 @@ public:
                             const std::vector<lldb::addr_t> &addresses,
                             bool stop_others);
 
+    // Use a breakpoint that is already set at \a address, the plan
+    // leaves it in place when it is done.
+    ThreadPlanRunToAddress (Thread &thread,
+                            Address &address,
+                            lldb::break_id_t break_id,
+                            bool stop_others);
+
 
     virtual
     ~ThreadPlanRunToAddress ();
@@ -75,6 +82,7 @@ private:
     std::vector<lldb::addr_t> m_addresses;   // This is the address we are going to run to.
                           // TODO: Would it be useful to have multiple addresses?
     std::vector<lldb::break_id_t> m_break_ids; // This is the breakpoint we are using to stop us at m_address.
+    bool m_owns_breakpoints;                   // True if we set the breakpoints and have to remove them.
 
     DISALLOW_COPY_AND_ASSIGN (ThreadPlanRunToAddress);
 
@@ -12,10 +12,15 @@
 
 // C Includes
 // C++ Includes
+#include <map>
+#include <vector>
+
 // Other libraries and framework includes
 // Project includes
 #include "lldb/lldb-private.h"
 #include "lldb/Core/RegisterValue.h"
+#include "lldb/Host/File.h"
+#include "lldb/Host/FileSpec.h"
 #include "lldb/Symbol/TaggedASTType.h"
 #include "lldb/Target/Thread.h"
 
@@ -95,7 +100,7 @@ protected:
     virtual void Log();
     
 private:
-    bool
+    virtual bool
     TracerExplainsStop ();
         
     bool m_single_step;
@@ -126,6 +131,67 @@ private:
     lldb::DataBufferSP      m_buffer_sp;
 };
 
+//----------------------------------------------------------------------
+// ThreadPlanBranchTracer: Traces a thread by running it from one branch
+// to the next, instead of single-stepping every instruction.
+//
+// The straight-line run of instructions that starts at an address is
+// decoded once and remembered, so the tracer knows where the next
+// branch is without disassembling again. The thread runs to a thread
+// specific breakpoint on that branch, and only the branch itself is
+// single-stepped to find out where it went.
+//
+// Every run is written to a binary trace file, which starts with the
+// 8 byte magic "LLDBBTR1" and the thread ID as a uint64_t, followed by
+// one record per run: the start address as a uint64_t and the number
+// of instructions up to and including the branch as a uint32_t, all in
+// the byte order of the host. The records are written in batches.
+//----------------------------------------------------------------------
+class ThreadPlanBranchTracer : public ThreadPlanTracer
+{
+public:
+    ThreadPlanBranchTracer (Thread &thread, const FileSpec &trace_file);
+    virtual ~ThreadPlanBranchTracer ();
+    virtual void TracingStarted ();
+    virtual void TracingEnded ();
+    virtual void Log();
+private:
+
+    struct Run
+    {
+        lldb::addr_t branch_addr;   // The address of the last instruction in the run
+        uint32_t num_instructions;  // Including the last instruction
+    };
+
+    typedef std::map<lldb::addr_t, Run> RunMap;
+
+    virtual bool
+    TracerExplainsStop ();
+
+    const Run &
+    GetRunAtAddress (lldb::addr_t addr);
+
+    void
+    ClearBranchBreakpoint ();
+
+    void
+    AppendRecord (lldb::addr_t start_addr, uint32_t num_instructions);
+
+    void
+    FlushRecords ();
+
+    FileSpec                m_trace_file;
+    File                    m_file;
+    std::vector<uint8_t>    m_records;      // Records that haven't been written to m_file yet
+    RunMap                  m_runs;         // Decoded runs, by start address
+    lldb::DisassemblerSP    m_disassembler_sp;
+    lldb::BreakpointSP      m_branch_bp_sp; // On the branch the thread is running to
+    lldb::addr_t            m_run_start;    // Where the current run started
+    uint32_t                m_run_instructions;
+    bool                    m_stepping;     // Single-stepping the last instruction of the run
+    bool                    m_explains_stop;
+};
+
 } // namespace lldb_private
 
 #endif  // liblldb_ThreadPlanTracer_h_
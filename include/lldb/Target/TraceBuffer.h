@@ -0,0 +1,122 @@
+//===-- TraceBuffer.h -------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_TraceBuffer_h_
+#define liblldb_TraceBuffer_h_
+
+// C Includes
+// C++ Includes
+#include <vector>
+
+// Other libraries and framework includes
+// Project includes
+#include "lldb/lldb-private.h"
+#include "lldb/Host/Mutex.h"
+
+namespace lldb_private {
+
+//----------------------------------------------------------------------
+/// @class TraceBuffer TraceBuffer.h "lldb/Target/TraceBuffer.h"
+/// @brief A ring buffer of the hits of tracepoints.
+///
+/// A tracepoint is a breakpoint that doesn't stop. When a thread hits
+/// one, the private state thread records the thread's registers and
+/// the top of its stack in the target's TraceBuffer and resumes the
+/// process, without making stack frames, asking thread plans or
+/// broadcasting a stop event. Once the buffer is full, each new hit
+/// replaces the oldest one.
+//----------------------------------------------------------------------
+class TraceBuffer
+{
+public:
+    enum
+    {
+        eNumArgumentRegisters = 6,  // LLDB_REGNUM_GENERIC_ARG1 - LLDB_REGNUM_GENERIC_ARG6
+        eStackSnapshotSize = 64     // Bytes of stack saved from the stack pointer up
+    };
+
+    struct Record
+    {
+        uint64_t index;             // The number of hits recorded before this one
+        uint64_t time_usec;         // Microseconds since Jan 1, 1970
+        lldb::tid_t tid;
+        lldb::break_id_t bp_id;     // The first tracepoint that owns the site
+        lldb::break_id_t loc_id;
+        lldb::addr_t pc;
+        lldb::addr_t sp;
+        lldb::addr_t fp;
+        lldb::addr_t ra;
+        uint64_t args[eNumArgumentRegisters];
+        uint32_t num_args;          // The number of valid entries in "args"
+        uint32_t stack_size;        // The number of valid bytes in "stack"
+        uint8_t stack[eStackSnapshotSize];
+    };
+
+    TraceBuffer (size_t capacity);
+
+    ~TraceBuffer ();
+
+    //------------------------------------------------------------------
+    /// Record a hit of the tracepoints at breakpoint site \a bp_site.
+    ///
+    /// The registers are read from the frame 0 register context of
+    /// \a thread, and the stack from its process. This is called on
+    /// the private state thread while the process is stopped.
+    //------------------------------------------------------------------
+    void
+    RecordHit (Thread &thread, BreakpointSite &bp_site);
+
+    //------------------------------------------------------------------
+    /// Copy out the most recent \a max_records records, oldest first.
+    /// Pass zero for \a max_records to get all of them.
+    ///
+    /// @return
+    ///     The number of records copied into \a records.
+    //------------------------------------------------------------------
+    size_t
+    GetRecords (std::vector<Record> &records, size_t max_records = 0) const;
+
+    //------------------------------------------------------------------
+    /// The number of hits recorded since the last Clear, including the
+    /// ones that have been overwritten since.
+    //------------------------------------------------------------------
+    uint64_t
+    GetNumHits () const;
+
+    size_t
+    GetCapacity () const;
+
+    //------------------------------------------------------------------
+    /// Change how many records are kept. The existing records are
+    /// discarded.
+    //------------------------------------------------------------------
+    void
+    SetCapacity (size_t capacity);
+
+    void
+    Clear ();
+
+    static void
+    DumpRecord (Stream &s, const Record &record);
+
+protected:
+    typedef std::vector<Record> collection;
+
+    mutable Mutex m_mutex;
+    collection m_records;   // Grows up to m_capacity, then is reused from the start
+    size_t m_capacity;
+    uint64_t m_num_hits;
+
+private:
+    DISALLOW_COPY_AND_ASSIGN (TraceBuffer);
+};
+
+} // namespace lldb_private
+
+#endif // liblldb_TraceBuffer_h_
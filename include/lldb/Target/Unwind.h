@@ -78,6 +78,15 @@ public:
         return DoGetFrameInfoAtIndex (frame_idx, cfa, pc);
     }
     
+    // Fill in the PCs of up to max_pcs frames, starting with frame zero,
+    // without creating any StackFrame objects. Returns the number of PCs.
+    uint32_t
+    GetFramePCs (lldb::addr_t *pcs, uint32_t max_pcs)
+    {
+        Mutex::Locker locker(m_unwind_mutex);
+        return DoGetFramePCs (pcs, max_pcs);
+    }
+
     lldb::RegisterContextSP
     CreateRegisterContextForFrame (StackFrame *frame)
     {
@@ -109,6 +118,21 @@ protected:
     virtual lldb::RegisterContextSP
     DoCreateRegisterContextForFrame (StackFrame *frame) = 0;
 
+    // Unwinders that have a cheaper way to find just the PCs can
+    // override this, by default we do a full unwind.
+    virtual uint32_t
+    DoGetFramePCs (lldb::addr_t *pcs, uint32_t max_pcs)
+    {
+        lldb::addr_t cfa;
+        uint32_t idx;
+        for (idx = 0; idx < max_pcs; idx++)
+        {
+            if (!DoGetFrameInfoAtIndex (idx, cfa, pcs[idx]))
+                break;
+        }
+        return idx;
+    }
+
     Thread &m_thread;
     Mutex  m_unwind_mutex;
 private:
@@ -15,39 +15,23 @@
 
 namespace lldb_private {
 
-namespace imp
-{
-    template <typename T>
-    class shared_ptr_refcount : public lldb_private::imp::shared_count
-    {
-    public:
-        template<class Y> shared_ptr_refcount (Y *in) : shared_count (0), manager(in) {}
-        
-        shared_ptr_refcount() : shared_count (0) {}
-        
-        virtual ~shared_ptr_refcount ()
-        {
-        }
-        
-        virtual void on_zero_shared ()
-        {
-            manager->DecrementRefCount();
-        }
-    private:
-        T *manager;
-    };
-
-} // namespace imp
-
+//----------------------------------------------------------------------
+// The manager is the reference count for every object in the cluster.
+// Handing out a shared pointer to one of them just bumps the manager's
+// count atomically, so it neither allocates nor takes a lock, and the
+// whole cluster is deleted when the last shared pointer goes away.
+//----------------------------------------------------------------------
 template <class T>
-class ClusterManager
+class ClusterManager : public imp::shared_count
 {
 public:
     ClusterManager () : 
+        imp::shared_count (-1),
         m_objects(),
-        m_external_ref(0),
-        m_mutex(Mutex::eMutexTypeNormal) {}
+        m_mutex(Mutex::eMutexTypeNormal),
+        m_cluster_mutex(Mutex::eMutexTypeRecursive) {}
     
+    virtual
     ~ClusterManager ()
     {
         size_t n_items = m_objects.size();
@@ -55,53 +39,43 @@ public:
         {
             delete m_objects[i];
         }
-        // Decrement refcount should have been called on this ClusterManager,
-        // and it should have locked the mutex, now we will unlock it before
-        // we destroy it...
-        m_mutex.Unlock();
     }
     
+    // Objects must only be added once, from their constructors. Looking
+    // for duplicates made adding N objects, like the children of a big
+    // array, take N^2 time.
     void ManageObject (T *new_object)
     {
         Mutex::Locker locker (m_mutex);
-        if (!ContainsObject(new_object))
-            m_objects.push_back (new_object);
+        m_objects.push_back (new_object);
     }
     
     typename lldb_private::SharingPtr<T> GetSharedPointer(T *desired_object)
     {
-        {
-            Mutex::Locker locker (m_mutex);
-            m_external_ref++;
-            assert (ContainsObject(desired_object));
-        }
-        return typename lldb_private::SharingPtr<T> (desired_object, new imp::shared_ptr_refcount<ClusterManager> (this));
+        add_shared();
+        return typename lldb_private::SharingPtr<T> (desired_object, this);
     }
     
-private:
-    
-    bool ContainsObject (const T *desired_object)
+    // A recursive mutex that the objects in the cluster share to protect
+    // their own state, so they don't each need a mutex of their own.
+    Mutex &
+    GetClusterMutex ()
     {
-        typename std::vector<T *>::iterator pos, end = m_objects.end();
-        pos = std::find(m_objects.begin(), end, desired_object);
-        return pos != end;
+        return m_cluster_mutex;
     }
     
-    void DecrementRefCount () 
+private:
+    
+    // The objects are deleted by the destructor, which
+    // imp::shared_count::release_shared() calls right after this
+    virtual void
+    on_zero_shared ()
     {
-        m_mutex.Lock();
-        m_external_ref--;
-        if (m_external_ref == 0)
-            delete this;
-        else
-            m_mutex.Unlock();
     }
     
-    friend class imp::shared_ptr_refcount<ClusterManager>;
-    
     std::vector<T *> m_objects;
-    int m_external_ref;
-    Mutex m_mutex;
+    Mutex m_mutex;  // Protects m_objects
+    Mutex m_cluster_mutex;
 };
 
 } // namespace lldb_private
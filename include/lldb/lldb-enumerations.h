@@ -494,7 +494,8 @@ namespace lldb {
         eSectionTypeDWARFAppleNamespaces,
         eSectionTypeDWARFAppleObjC,
         eSectionTypeEHFrame,
-        eSectionTypeOther
+        eSectionTypeOther,
+        eSectionTypeDWARFDebugNames
         
     } SectionType;
 
@@ -613,7 +614,8 @@ namespace lldb {
         eTypeOptionHideChildren    = (1u << 3),
         eTypeOptionHideValue       = (1u << 4),
         eTypeOptionShowOneLiner    = (1u << 5),
-        eTypeOptionHideNames       = (1u << 6)
+        eTypeOptionHideNames       = (1u << 6),
+        eTypeOptionNotCacheable    = (1u << 7)
     } TypeOptions;
 
    //----------------------------------------------------------------------
@@ -650,6 +652,20 @@ namespace lldb {
         eAddressClassRuntime
     } AddressClass;
 
+    //----------------------------------------------------------------------
+    // Profile Data Scan Type
+    //
+    // What each async profiling sample contains, see
+    // SBProcess::EnableAsyncProfiling().
+    //----------------------------------------------------------------------
+    typedef enum ProfileDataScanType
+    {
+        eProfileThreadStacks    = (1u << 0),    // The PC and return addresses of each thread
+        eProfileThreadsCPU      = (1u << 1),    // The user and system CPU time of each thread
+        eProfileMemory          = (1u << 2),    // The resident and virtual size of the process
+        eProfileAll             = 0xffffffffu
+    } ProfileDataScanType;
+
 } // namespace lldb
 
 
@@ -43,6 +43,7 @@ class   AddressResolver;
 class   ArchSpec;
 class   Args;
 class   ASTResultSynthesizer;
+class   AsyncOperation;
 class   Baton;
 class   Block;
 class   Breakpoint;
@@ -76,6 +77,7 @@ class   ClangFunction;
 class   ClangPersistentVariables;
 class   ClangUserExpression;
 class   ClangUtilityFunction;
+class   CommandBatch;
 class   CommandInterpreter;
 class   CommandObject;
 class   CommandReturnObject;
@@ -84,6 +86,7 @@ class   CompileUnit;
 class   Condition;
 class   Connection;
 class   ConnectionFileDescriptor;
+class   ConnectionSharedMemory;
 class   ConstString;
 class   DWARFCallFrameInfo;
 class   DWARFExpression;
@@ -160,6 +163,7 @@ class   ProcessInstanceInfo;
 class   ProcessInstanceInfoList;
 class   ProcessInstanceInfoMatch;
 class   ProcessLaunchInfo;
+class   PromptFormat;
 class   Property;
 struct  PropertyDefinition;
 class   PythonDataArray;
@@ -231,6 +235,7 @@ class   ThreadPlanStepThrough;
 class   ThreadPlanTracer;
 class   ThreadSpec;
 class   TimeValue;
+class   TraceBuffer;
 class   Type;
 class   TypeImpl;
 class   TypeAndOrName;
@@ -268,6 +273,7 @@ struct  LineEntry;
 namespace lldb {
     
     typedef STD_SHARED_PTR(lldb_private::ABI) ABISP;
+    typedef STD_SHARED_PTR(lldb_private::AsyncOperation) AsyncOperationSP;
     typedef STD_SHARED_PTR(lldb_private::Baton) BatonSP;
     typedef STD_SHARED_PTR(lldb_private::Block) BlockSP;
     typedef STD_SHARED_PTR(lldb_private::Breakpoint) BreakpointSP;
@@ -278,7 +284,9 @@ namespace lldb {
     typedef STD_WEAK_PTR(  lldb_private::BreakpointLocation) BreakpointLocationWP;
     typedef STD_SHARED_PTR(lldb_private::BreakpointResolver) BreakpointResolverSP;
     typedef STD_SHARED_PTR(lldb_private::Broadcaster) BroadcasterSP;
+    typedef STD_SHARED_PTR(lldb_private::ClangASTContext) ClangASTContextSP;
     typedef STD_SHARED_PTR(lldb_private::ClangExpressionVariable) ClangExpressionVariableSP;
+    typedef STD_SHARED_PTR(lldb_private::CommandBatch) CommandBatchSP;
     typedef STD_SHARED_PTR(lldb_private::CommandObject) CommandObjectSP;
     typedef STD_SHARED_PTR(lldb_private::Communication) CommunicationSP;
     typedef STD_SHARED_PTR(lldb_private::Connection) ConnectionSP;
@@ -290,6 +298,7 @@ namespace lldb {
     typedef STD_SHARED_PTR(lldb_private::Disassembler) DisassemblerSP;
     typedef STD_SHARED_PTR(lldb_private::DynamicLoader) DynamicLoaderSP;
     typedef STD_SHARED_PTR(lldb_private::Event) EventSP;
+    typedef lldb_private::IntrusiveSharingPtr<lldb_private::Event> EventIntrusiveSP;
     typedef STD_SHARED_PTR(lldb_private::ExecutionContextRef) ExecutionContextRefSP;
     typedef STD_SHARED_PTR(lldb_private::Function) FunctionSP;
     typedef STD_SHARED_PTR(lldb_private::FuncUnwinders) FuncUnwindersSP;
@@ -328,6 +337,7 @@ namespace lldb {
     typedef STD_SHARED_PTR(lldb_private::ProcessAttachInfo) ProcessAttachInfoSP;
     typedef STD_SHARED_PTR(lldb_private::ProcessLaunchInfo) ProcessLaunchInfoSP;
     typedef STD_WEAK_PTR(  lldb_private::Process) ProcessWP;
+    typedef STD_SHARED_PTR(lldb_private::PromptFormat) PromptFormatSP;
     typedef STD_SHARED_PTR(lldb_private::Property) PropertySP;
     typedef STD_SHARED_PTR(lldb_private::RegisterContext) RegisterContextSP;
     typedef STD_SHARED_PTR(lldb_private::RegularExpression) RegularExpressionSP;
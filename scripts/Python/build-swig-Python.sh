@@ -58,10 +58,12 @@ HEADER_FILES="${SRC_ROOT}/include/lldb/lldb.h"\
 " ${SRC_ROOT}/include/lldb/lldb-forward-rtti.h"\
 " ${SRC_ROOT}/include/lldb/lldb-types.h"\
 " ${SRC_ROOT}/include/lldb/API/SBAddress.h"\
+" ${SRC_ROOT}/include/lldb/API/SBAsyncOperation.h"\
 " ${SRC_ROOT}/include/lldb/API/SBBlock.h"\
 " ${SRC_ROOT}/include/lldb/API/SBBreakpoint.h"\
 " ${SRC_ROOT}/include/lldb/API/SBBreakpointLocation.h"\
 " ${SRC_ROOT}/include/lldb/API/SBBroadcaster.h"\
+" ${SRC_ROOT}/include/lldb/API/SBCommandBatch.h"\
 " ${SRC_ROOT}/include/lldb/API/SBCommandInterpreter.h"\
 " ${SRC_ROOT}/include/lldb/API/SBCommandReturnObject.h"\
 " ${SRC_ROOT}/include/lldb/API/SBCommunication.h"\
@@ -101,10 +103,12 @@ HEADER_FILES="${SRC_ROOT}/include/lldb/lldb.h"\
 " ${SRC_ROOT}/include/lldb/API/SBWatchpoint.h"\
 
 INTERFACE_FILES="${SRC_ROOT}/scripts/Python/interface/SBAddress.i"\
+" ${SRC_ROOT}/scripts/Python/interface/SBAsyncOperation.i"\
 " ${SRC_ROOT}/scripts/Python/interface/SBBlock.i"\
 " ${SRC_ROOT}/scripts/Python/interface/SBBreakpoint.i"\
 " ${SRC_ROOT}/scripts/Python/interface/SBBreakpointLocation.i"\
 " ${SRC_ROOT}/scripts/Python/interface/SBBroadcaster.i"\
+" ${SRC_ROOT}/scripts/Python/interface/SBCommandBatch.i"\
 " ${SRC_ROOT}/scripts/Python/interface/SBCommandInterpreter.i"\
 " ${SRC_ROOT}/scripts/Python/interface/SBCommandReturnObject.i"\
 " ${SRC_ROOT}/scripts/Python/interface/SBCommunication.i"\
@@ -0,0 +1,70 @@
+//===-- SWIG Interface for SBAsyncOperation ---------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+namespace lldb {
+
+%feature("docstring",
+"Represents work started on a background thread by one of the *Async()
+calls, so a UI can keep running while it finishes and can cancel it.
+
+For example,
+
+    op = frame.EvaluateExpressionAsync('my_struct', lldb.eNoDynamicValues, True)
+    while not op.Wait(10000):
+        if user_pressed_stop():
+            op.Cancel()
+    if op.GetError().Success():
+        print op.GetValue()
+") SBAsyncOperation;
+class SBAsyncOperation
+{
+public:
+    SBAsyncOperation ();
+
+    SBAsyncOperation (const lldb::SBAsyncOperation &rhs);
+
+    ~SBAsyncOperation ();
+
+    bool
+    IsValid () const;
+
+    bool
+    IsDone () const;
+
+    %feature("docstring", "
+    Wait up to timeout_usec microseconds for the operation to finish, or
+    until it is done if timeout_usec is zero. Returns True if it is done.
+    ") Wait;
+    bool
+    Wait (uint32_t timeout_usec = 0);
+
+    %feature("docstring", "
+    Ask the operation to stop early. It gives up the next time it gets
+    somewhere it is safe to, and then finishes with an error.
+    ") Cancel;
+    void
+    Cancel ();
+
+    bool
+    IsCancelled () const;
+
+    lldb::SBError
+    GetError () const;
+
+    lldb::SBValue
+    GetValue () const;
+
+    lldb::SBSymbolContextList
+    GetSymbolContextList () const;
+
+    uint32_t
+    GetCount () const;
+};
+
+} // namespace lldb
@@ -0,0 +1,83 @@
+//===-- SWIG Interface for SBCommandBatch -----------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+namespace lldb {
+
+%feature("docstring",
+"A list of command lines for SBCommandInterpreter.HandleCommandBatch().
+
+A batch that is run over and over only looks up its commands and splits up
+their arguments the first time, which makes it much cheaper than calling
+HandleCommand() for each line from a script that polls the same commands.
+
+For example,
+
+    batch = lldb.SBCommandBatch()
+    batch.AppendCommand('register read pc')
+    batch.AppendCommand('frame variable')
+    while process.GetState() == lldb.eStateStopped:
+        ci.HandleCommandBatch(batch)
+        for i in range(batch.GetNumCommandsRun()):
+            if batch.SucceededAtIndex(i):
+                print batch.GetOutputAtIndex(i)
+            else:
+                print batch.GetErrorAtIndex(i)
+        process.Continue()
+") SBCommandBatch;
+class SBCommandBatch
+{
+public:
+    SBCommandBatch ();
+
+    SBCommandBatch (const lldb::SBCommandBatch &rhs);
+
+    ~SBCommandBatch ();
+
+    bool
+    IsValid () const;
+
+    void
+    AppendCommand (const char *command_line);
+
+    void
+    AppendCommands (lldb::SBStringList &command_lines);
+
+    uint32_t
+    GetNumCommands () const;
+
+    const char *
+    GetCommandAtIndex (uint32_t idx) const;
+
+    void
+    Clear ();
+
+    %feature("docstring", "
+    Returns the number of commands that ran the last time the batch was run.
+    The results for each command are only valid for these.
+    ") GetNumCommandsRun;
+    uint32_t
+    GetNumCommandsRun () const;
+
+    lldb::ReturnStatus
+    GetStatusAtIndex (uint32_t idx) const;
+
+    bool
+    SucceededAtIndex (uint32_t idx) const;
+
+    const char *
+    GetOutputAtIndex (uint32_t idx) const;
+
+    const char *
+    GetErrorAtIndex (uint32_t idx) const;
+
+    bool
+    GetDescription (lldb::SBStream &description);
+};
+
+} // namespace lldb
@@ -111,6 +111,13 @@ public:
     lldb::ReturnStatus
     HandleCommand (const char *command_line, lldb::SBCommandReturnObject &result, bool add_to_history = false);
 
+    %feature("docstring", "
+    Run the commands in an SBCommandBatch in order, keeping the status and
+    output of each one in the batch. Returns the number of commands that ran.
+    ") HandleCommandBatch;
+    uint32_t
+    HandleCommandBatch (lldb::SBCommandBatch &batch, bool stop_on_error = true);
+
     int
     HandleCompletion (const char *current_line,
                       uint32_t cursor_pos,
@@ -74,6 +74,19 @@ public:
     void
     SetImmediateErrorFile (FILE *fh);
 
+    void
+    SetImmediateOutputCallback (lldb::LogOutputCallback log_callback, void *baton);
+
+    %feature("docstring", "
+    Only write output to the immediate output file or callback as the command
+    produces it, instead of also collecting it for GetOutput().
+    ") SetStreamOutput;
+    void
+    SetStreamOutput (bool stream_output);
+
+    bool
+    GetStreamOutput ();
+
 	void
 	PutCString(const char* string, int len = -1);
 
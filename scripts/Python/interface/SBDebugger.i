@@ -262,6 +262,13 @@ public:
     static const char *
     GetVersionString ();
 
+    %feature("docstring",
+    "Put the counters and histograms LLDB keeps about its own work into
+    'json' as a JSON object, the same one 'statistics dump --json' shows."
+    ) GetStatistics;
+    static bool
+    GetStatistics (lldb::SBStream &json);
+
     static const char *
     StateAsCString (lldb::StateType state);
 
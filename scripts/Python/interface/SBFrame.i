@@ -140,6 +140,13 @@ public:
     lldb::SBValue
     EvaluateExpression (const char *expr, lldb::DynamicValueType use_dynamic, bool unwind_on_error);
 
+    %feature("docstring", "
+    /// Evaluate the expression on a background thread. The result is
+    /// the value of the returned operation once it is done.
+    ") EvaluateExpressionAsync;
+    lldb::SBAsyncOperation
+    EvaluateExpressionAsync (const char *expr, lldb::DynamicValueType use_dynamic, bool unwind_on_error);
+
     %feature("docstring", "
     /// Gets the lexical block that defines the stack frame. Another way to think
     /// of this is it will return the block that contains all of the variables
@@ -43,7 +43,8 @@ public:
         eBroadcastBitStateChanged   = (1 << 0),
         eBroadcastBitInterrupt      = (1 << 1),
         eBroadcastBitSTDOUT         = (1 << 2),
-        eBroadcastBitSTDERR         = (1 << 3)
+        eBroadcastBitSTDERR         = (1 << 3),
+        eBroadcastBitProfileData    = (1 << 4)
     };
 
     SBProcess ();
@@ -90,6 +91,40 @@ public:
     size_t
     GetSTDERR (char *dst, size_t dst_len) const;
 
+    %feature("autodoc", "
+    Writes all the data currently available from the process's stdout stream
+    to the given file object at once. Returns the number of bytes written.
+    ") DrainSTDOUT;
+    size_t
+    DrainSTDOUT (FILE *out) const;
+
+    %feature("autodoc", "
+    Writes all the data currently available from the process's stderr stream
+    to the given file object at once. Returns the number of bytes written.
+    ") DrainSTDERR;
+    size_t
+    DrainSTDERR (FILE *out) const;
+
+    %feature("autodoc", "
+    Samples the process every interval_usec microseconds while it runs.
+    scan_type is a mask of eProfileThreadStacks (up to max_frames deep),
+    eProfileThreadsCPU and eProfileMemory. The samples are announced with
+    eBroadcastBitProfileData events.
+    ") EnableAsyncProfiling;
+    lldb::SBError
+    EnableAsyncProfiling (uint32_t interval_usec, uint32_t max_frames, uint32_t scan_type);
+
+    lldb::SBError
+    DisableAsyncProfiling ();
+
+    %feature("autodoc", "
+    Reads the profiling samples that are currently available. API client
+    specifies the size of the buffer to read data into. It returns the byte
+    buffer in a Python string.
+    ") GetAsyncProfileData;
+    size_t
+    GetAsyncProfileData (char *dst, size_t dst_len) const;
+
     void
     ReportEventState (const lldb::SBEvent &event, FILE *out) const;
 
@@ -285,6 +320,24 @@ public:
     lldb::addr_t
     ReadPointerFromMemory (addr_t addr, lldb::SBError &error);
     
+    %feature("autodoc", "
+    Finds the first occurrence of the bytes of a Python string in memory
+    from start_addr up to end_addr, skipping memory that can't be read.
+    Debug servers that support it search the memory themselves, so it
+    doesn't have to be sent to the debugger. Returns LLDB_INVALID_ADDRESS
+    if the bytes weren't found. Example:
+
+    # Scan a heap range for a 4 byte little endian magic value
+    error = lldb.SBError()
+    addr = process.FindInMemory(heap_start, heap_end, '\\xef\\xbe\\xad\\xde', error)
+    if error.Success() and addr != lldb.LLDB_INVALID_ADDRESS:
+        print 'found at 0x%x' % addr
+
+    ") FindInMemory;
+
+    lldb::addr_t
+    FindInMemory (addr_t start_addr, addr_t end_addr, const void *buf, size_t size, lldb::SBError &error);
+
 
     // Events
     static lldb::StateType
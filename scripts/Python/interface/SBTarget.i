@@ -131,6 +131,17 @@ public:
     void
     SetIgnoreExisting (bool b);
     
+    %feature("docstring", "
+    If true, the attach stops as soon as the threads and images are known.
+    Breakpoints in shared libraries are resolved when the process is first
+    resumed, and their symbols are loaded in the background.
+    ") SetDeferSymbolLoading;
+    bool
+    GetDeferSymbolLoading ();
+    
+    void
+    SetDeferSymbolLoading (bool b);
+    
     uint32_t
     GetResumeCount ();
     
@@ -476,6 +487,32 @@ public:
                    const char *plugin_name,
                    SBError& error);
     
+    %feature("docstring", "
+    //------------------------------------------------------------------
+    /// Load a core file as the process of this target.
+    ///
+    /// @param[in] listener
+    ///     An optional listener that will receive all process events.
+    ///     If \a listener is valid then \a listener will listen to all
+    ///     process events. If not valid, then this target's debugger
+    ///     (SBTarget::GetDebugger()) will listen to all process events.
+    ///
+    /// @param[in] core_file
+    ///     The path to the core file.
+    ///
+    /// @param[out]
+    ///     An error explaining what went wrong if the core file can't
+    ///     be loaded.
+    ///
+    /// @return
+    ///      A process object for the core file.
+    //------------------------------------------------------------------
+    ") LoadCore;
+    lldb::SBProcess
+    LoadCore (SBListener &listener,
+              const char *core_file,
+              SBError& error);
+    
     lldb::SBFileSpec
     GetExecutable ();
 
@@ -554,6 +591,17 @@ public:
     FindFunctions (const char *name, 
                    uint32_t name_type_mask = lldb::eFunctionNameTypeAny);
     
+    %feature("docstring", "
+    //------------------------------------------------------------------
+    /// Find functions by name on a background thread, the matches are
+    /// in the symbol context list of the returned operation once it is
+    /// done.
+    //------------------------------------------------------------------
+    ") FindFunctionsAsync;
+    lldb::SBAsyncOperation
+    FindFunctionsAsync (const char *name, 
+                        uint32_t name_type_mask = lldb::eFunctionNameTypeAny);
+    
     lldb::SBType
     FindFirstType (const char* type);
     
@@ -592,6 +640,21 @@ public:
     ResolveSymbolContextForAddress (const SBAddress& addr, 
                                     uint32_t resolve_scope);
 
+    %feature("docstring", "
+    //------------------------------------------------------------------
+    /// Resolve the symbol contexts for a list of load addresses at once.
+    /// One symbol context is appended to sc_list for each address, in
+    /// the same order as the addresses, and the number of addresses that
+    /// resolved to a module is returned.
+    //------------------------------------------------------------------
+    ") ResolveLoadAddresses;
+    uint32_t
+    ResolveLoadAddresses (uint64_t *array,
+                          size_t array_len,
+                          uint32_t resolve_scope,
+                          lldb::SBSymbolContextList &sc_list);
+
+
     lldb::SBBreakpoint
     BreakpointCreateByLocation (const char *file, uint32_t line);
 
@@ -165,6 +165,23 @@ public:
     uint32_t
     GetNumFrames ();
 
+    %feature("docstring", "
+    Unwind and symbolicate up to max_frames frames, or all of them if
+    max_frames is zero, on a background thread. The operation has a symbol
+    context for each frame once it is done.
+    ") GetFramesAsync;
+    lldb::SBAsyncOperation
+    GetFramesAsync (uint32_t max_frames);
+
+    %feature("docstring", "
+    Returns a list of the PCs of up to max_pcs frames, starting with frame
+    zero. This is much cheaper than getting the frames themselves, and is
+    meant for sampling. When the frame pointer chain is followed, a frame
+    whose function hasn't set up its frame pointer yet may be missing.
+    ") GetFramePCs;
+    uint32_t
+    GetFramePCs (lldb::addr_t *pcs, uint32_t max_pcs);
+
     lldb::SBFrame
     GetFrameAtIndex (uint32_t idx);
 
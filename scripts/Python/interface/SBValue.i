@@ -214,6 +214,21 @@ public:
                      lldb::DynamicValueType use_dynamic,
                      bool can_create_synthetic);
     
+    %feature("docstring", "
+    Get up to count children starting at index start_idx as an SBValueList.
+    This returns the same values as calling GetChildAtIndex() for each
+    index, but crosses into LLDB only once, which is much cheaper for
+    scripts and synthetic child providers that walk large arrays.
+    ") GetChildren;
+    lldb::SBValueList
+    GetChildren (uint32_t start_idx, uint32_t count);
+
+    lldb::SBValueList
+    GetChildren (uint32_t start_idx,
+                 uint32_t count,
+                 lldb::DynamicValueType use_dynamic,
+                 bool can_create_synthetic);
+    
     lldb::SBValue
     CreateChildAtOffset (const char *name, uint32_t offset, lldb::SBType type);
     
@@ -281,9 +296,27 @@ public:
     lldb::SBValue
     GetValueForExpressionPath(const char* expr_path);
 
+    %feature("docstring", "
+    Reads the value and works out its summary and number of children on a
+    background thread, so that GetValue(), GetSummary() and GetNumChildren()
+    don't block once the operation is done.
+    ") FetchAsync;
+    lldb::SBAsyncOperation
+    FetchAsync ();
+
     uint32_t
     GetNumChildren ();
 
+    %feature("docstring", "
+    //------------------------------------------------------------------
+    /// Get the number of children of this value, or max if it has at
+    /// least that many. Synthetic children providers can stop walking
+    /// big containers once they have found max children.
+    //------------------------------------------------------------------
+    ") GetNumChildren;
+    uint32_t
+    GetNumChildren (uint32_t max);
+
     void *
     GetOpaqueType();
 
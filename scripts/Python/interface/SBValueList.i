@@ -96,6 +96,15 @@ public:
 
     lldb::SBValue
     FindValueObjectByUID (lldb::user_id_t uid);
+
+    %feature("docstring", "
+    Write GetValueAsUnsigned() of each value, as native 64 bit integers,
+    into a writable buffer like a bytearray or an array.array('Q'), and
+    return how many were written. Only as many values as fit are written.
+    ") GetValuesAsUnsigned;
+    uint32_t
+    GetValuesAsUnsigned (uint64_t *values, uint32_t max_values, uint64_t fail_value = 0);
+
     %pythoncode %{
         def __len__(self):
             return int(self.GetSize())
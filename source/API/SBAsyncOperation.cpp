@@ -0,0 +1,127 @@
+//===-- SBAsyncOperation.cpp ------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "lldb/API/SBAsyncOperation.h"
+#include "lldb/Core/AsyncOperation.h"
+#include "lldb/Core/Log.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+SBAsyncOperation::SBAsyncOperation () :
+    m_opaque_sp ()
+{
+}
+
+SBAsyncOperation::SBAsyncOperation (const lldb::AsyncOperationSP &op_sp) :
+    m_opaque_sp (op_sp)
+{
+}
+
+SBAsyncOperation::SBAsyncOperation (const SBAsyncOperation &rhs) :
+    m_opaque_sp (rhs.m_opaque_sp)
+{
+}
+
+SBAsyncOperation::~SBAsyncOperation ()
+{
+}
+
+const SBAsyncOperation &
+SBAsyncOperation::operator = (const SBAsyncOperation &rhs)
+{
+    if (this != &rhs)
+        m_opaque_sp = rhs.m_opaque_sp;
+    return *this;
+}
+
+bool
+SBAsyncOperation::IsValid () const
+{
+    return m_opaque_sp.get() != NULL;
+}
+
+bool
+SBAsyncOperation::IsDone () const
+{
+    if (m_opaque_sp)
+        return m_opaque_sp->IsDone();
+    return false;
+}
+
+bool
+SBAsyncOperation::Wait (uint32_t timeout_usec)
+{
+    LogSP log(GetLogIfAllCategoriesSet (LIBLLDB_LOG_API));
+    bool done = false;
+    if (m_opaque_sp)
+        done = m_opaque_sp->Wait (timeout_usec);
+    if (log)
+        log->Printf ("SBAsyncOperation(%p)::Wait (timeout_usec=%u) => %i", m_opaque_sp.get(), timeout_usec, done);
+    return done;
+}
+
+void
+SBAsyncOperation::Cancel ()
+{
+    LogSP log(GetLogIfAllCategoriesSet (LIBLLDB_LOG_API));
+    if (log)
+        log->Printf ("SBAsyncOperation(%p)::Cancel ()", m_opaque_sp.get());
+    if (m_opaque_sp)
+        m_opaque_sp->Cancel();
+}
+
+bool
+SBAsyncOperation::IsCancelled () const
+{
+    if (m_opaque_sp)
+        return m_opaque_sp->IsCancelled();
+    return false;
+}
+
+SBError
+SBAsyncOperation::GetError () const
+{
+    SBError sb_error;
+    if (m_opaque_sp)
+    {
+        if (m_opaque_sp->IsDone())
+            sb_error.SetError (m_opaque_sp->GetError());
+        else
+            sb_error.SetErrorString ("operation is still running");
+    }
+    else
+        sb_error.SetErrorString ("invalid operation");
+    return sb_error;
+}
+
+SBValue
+SBAsyncOperation::GetValue () const
+{
+    if (m_opaque_sp && m_opaque_sp->IsDone())
+        return SBValue (m_opaque_sp->GetValueObject());
+    return SBValue();
+}
+
+SBSymbolContextList
+SBAsyncOperation::GetSymbolContextList () const
+{
+    SBSymbolContextList sb_sc_list;
+    if (m_opaque_sp && m_opaque_sp->IsDone())
+        *sb_sc_list = m_opaque_sp->GetSymbolContextList();
+    return sb_sc_list;
+}
+
+uint32_t
+SBAsyncOperation::GetCount () const
+{
+    if (m_opaque_sp && m_opaque_sp->IsDone())
+        return m_opaque_sp->GetCount();
+    return 0;
+}
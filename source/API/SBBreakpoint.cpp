@@ -567,7 +567,7 @@ BreakpointEventType
 SBBreakpoint::GetBreakpointEventTypeFromEvent (const SBEvent& event)
 {
     if (event.IsValid())
-        return Breakpoint::BreakpointEventData::GetBreakpointEventTypeFromEvent (event.GetSP());
+        return Breakpoint::BreakpointEventData::GetBreakpointEventTypeFromEvent (Event::MakeIntrusiveSP (event.GetSP()));
     return eBreakpointEventTypeInvalidType;
 }
 
@@ -576,7 +576,7 @@ SBBreakpoint::GetBreakpointFromEvent (const lldb::SBEvent& event)
 {
     SBBreakpoint sb_breakpoint;
     if (event.IsValid())
-        sb_breakpoint.m_opaque_sp = Breakpoint::BreakpointEventData::GetBreakpointFromEvent (event.GetSP());
+        sb_breakpoint.m_opaque_sp = Breakpoint::BreakpointEventData::GetBreakpointFromEvent (Event::MakeIntrusiveSP (event.GetSP()));
     return sb_breakpoint;
 }
 
@@ -585,7 +585,7 @@ SBBreakpoint::GetBreakpointLocationAtIndexFromEvent (const lldb::SBEvent& event,
 {
     SBBreakpointLocation sb_breakpoint_loc;
     if (event.IsValid())
-        sb_breakpoint_loc.SetLocation (Breakpoint::BreakpointEventData::GetBreakpointLocationAtIndexFromEvent (event.GetSP(), loc_idx));
+        sb_breakpoint_loc.SetLocation (Breakpoint::BreakpointEventData::GetBreakpointLocationAtIndexFromEvent (Event::MakeIntrusiveSP (event.GetSP()), loc_idx));
     return sb_breakpoint_loc;
 }
 
@@ -594,7 +594,7 @@ SBBreakpoint::GetNumBreakpointLocationsFromEvent (const lldb::SBEvent &event)
 {
     uint32_t num_locations = 0;
     if (event.IsValid())
-        num_locations = (Breakpoint::BreakpointEventData::GetNumBreakpointLocationsFromEvent (event.GetSP()));
+        num_locations = (Breakpoint::BreakpointEventData::GetNumBreakpointLocationsFromEvent (Event::MakeIntrusiveSP (event.GetSP())));
     return num_locations;
 }
 
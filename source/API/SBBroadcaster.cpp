@@ -8,6 +8,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "lldb/Core/Broadcaster.h"
+#include "lldb/Core/Event.h"
 #include "lldb/Core/Log.h"
 
 #include "lldb/API/SBBroadcaster.h"
@@ -97,7 +98,7 @@ SBBroadcaster::BroadcastEvent (const SBEvent &event, bool unique)
     if (m_opaque_ptr == NULL)
         return;
 
-    EventSP event_sp = event.GetSP ();
+    EventIntrusiveSP event_sp (Event::MakeIntrusiveSP (event.GetSP ()));
     if (unique)
         m_opaque_ptr->BroadcastEventIfUnique (event_sp);
     else
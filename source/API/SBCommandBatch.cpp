@@ -0,0 +1,142 @@
+//===-- SBCommandBatch.cpp --------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "lldb/API/SBCommandBatch.h"
+#include "lldb/API/SBStream.h"
+#include "lldb/API/SBStringList.h"
+#include "lldb/Interpreter/CommandBatch.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+SBCommandBatch::SBCommandBatch () :
+    m_opaque_sp (new CommandBatch())
+{
+}
+
+SBCommandBatch::SBCommandBatch (const SBCommandBatch &rhs) :
+    m_opaque_sp (rhs.m_opaque_sp)
+{
+}
+
+SBCommandBatch::~SBCommandBatch ()
+{
+}
+
+const SBCommandBatch &
+SBCommandBatch::operator = (const SBCommandBatch &rhs)
+{
+    if (this != &rhs)
+        m_opaque_sp = rhs.m_opaque_sp;
+    return *this;
+}
+
+bool
+SBCommandBatch::IsValid () const
+{
+    return m_opaque_sp.get() != NULL;
+}
+
+CommandBatch *
+SBCommandBatch::get () const
+{
+    return m_opaque_sp.get();
+}
+
+void
+SBCommandBatch::AppendCommand (const char *command_line)
+{
+    if (m_opaque_sp && command_line)
+        m_opaque_sp->AppendCommand (command_line);
+}
+
+void
+SBCommandBatch::AppendCommands (SBStringList &command_lines)
+{
+    if (m_opaque_sp)
+    {
+        const uint32_t num_lines = command_lines.GetSize();
+        for (uint32_t i=0; i<num_lines; ++i)
+            m_opaque_sp->AppendCommand (command_lines.GetStringAtIndex(i));
+    }
+}
+
+uint32_t
+SBCommandBatch::GetNumCommands () const
+{
+    if (m_opaque_sp)
+        return m_opaque_sp->GetNumCommands();
+    return 0;
+}
+
+const char *
+SBCommandBatch::GetCommandAtIndex (uint32_t idx) const
+{
+    if (m_opaque_sp)
+        return m_opaque_sp->GetCommandAtIndex (idx);
+    return NULL;
+}
+
+void
+SBCommandBatch::Clear ()
+{
+    if (m_opaque_sp)
+        m_opaque_sp->Clear();
+}
+
+uint32_t
+SBCommandBatch::GetNumCommandsRun () const
+{
+    if (m_opaque_sp)
+        return m_opaque_sp->GetNumCommandsRun();
+    return 0;
+}
+
+ReturnStatus
+SBCommandBatch::GetStatusAtIndex (uint32_t idx) const
+{
+    if (m_opaque_sp)
+        return m_opaque_sp->GetStatusAtIndex (idx);
+    return eReturnStatusInvalid;
+}
+
+bool
+SBCommandBatch::SucceededAtIndex (uint32_t idx) const
+{
+    // Matches CommandReturnObject::Succeeded()
+    const ReturnStatus status = GetStatusAtIndex (idx);
+    return status != eReturnStatusInvalid && status <= eReturnStatusSuccessContinuingResult;
+}
+
+const char *
+SBCommandBatch::GetOutputAtIndex (uint32_t idx) const
+{
+    if (m_opaque_sp)
+        return m_opaque_sp->GetOutputAtIndex (idx);
+    return NULL;
+}
+
+const char *
+SBCommandBatch::GetErrorAtIndex (uint32_t idx) const
+{
+    if (m_opaque_sp)
+        return m_opaque_sp->GetErrorAtIndex (idx);
+    return NULL;
+}
+
+bool
+SBCommandBatch::GetDescription (SBStream &description)
+{
+    Stream &strm = description.ref();
+    if (m_opaque_sp)
+        m_opaque_sp->Dump (strm);
+    else
+        strm.PutCString ("No value");
+    return true;
+}
@@ -9,6 +9,7 @@
 
 #include "lldb/lldb-types.h"
 #include "lldb/Interpreter/Args.h"
+#include "lldb/Interpreter/CommandBatch.h"
 #include "lldb/Core/SourceManager.h"
 #include "lldb/Core/Listener.h"
 #include "lldb/Interpreter/CommandInterpreter.h"
@@ -16,6 +17,7 @@
 #include "lldb/Target/Target.h"
 
 #include "lldb/API/SBBroadcaster.h"
+#include "lldb/API/SBCommandBatch.h"
 #include "lldb/API/SBDebugger.h"
 #include "lldb/API/SBCommandReturnObject.h"
 #include "lldb/API/SBCommandInterpreter.h"
@@ -95,6 +97,12 @@ SBCommandInterpreter::HandleCommand (const char *command_line, SBCommandReturnOb
         if (target_sp)
             api_locker.Lock(target_sp->GetAPIMutex());
         m_opaque_ptr->HandleCommand (command_line, add_to_history ? eLazyBoolYes : eLazyBoolNo, result.ref());
+
+        // Hand over whatever is left in streaming callbacks
+        if (result->GetImmediateOutputStream())
+            result->GetImmediateOutputStream()->Flush();
+        if (result->GetImmediateErrorStream())
+            result->GetImmediateErrorStream()->Flush();
     }
     else
     {
@@ -115,6 +123,31 @@ SBCommandInterpreter::HandleCommand (const char *command_line, SBCommandReturnOb
     return result.GetStatus();
 }
 
+uint32_t
+SBCommandInterpreter::HandleCommandBatch (SBCommandBatch &batch, bool stop_on_error)
+{
+    LogSP log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_API));
+
+    uint32_t num_commands_run = 0;
+    CommandBatch *command_batch = batch.get();
+    if (command_batch && m_opaque_ptr)
+    {
+        TargetSP target_sp(m_opaque_ptr->GetDebugger().GetSelectedTarget());
+        Mutex::Locker api_locker;
+        if (target_sp)
+            api_locker.Lock(target_sp->GetAPIMutex());
+        num_commands_run = command_batch->Execute (*m_opaque_ptr, stop_on_error);
+    }
+
+    // We need to get the value again, in case a command disabled the log!
+    log = lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_API);
+    if (log)
+        log->Printf ("SBCommandInterpreter(%p)::HandleCommandBatch (SBCommandBatch(%p), stop_on_error=%i) => %u", 
+                     m_opaque_ptr, command_batch, stop_on_error, num_commands_run);
+
+    return num_commands_run;
+}
+
 int
 SBCommandInterpreter::HandleCompletion (const char *current_line,
                                         const char *cursor,
@@ -269,6 +269,28 @@ SBCommandReturnObject::SetImmediateErrorFile (FILE *fh)
         m_opaque_ap->SetImmediateErrorFile (fh);
 }
 
+void
+SBCommandReturnObject::SetImmediateOutputCallback (lldb::LogOutputCallback log_callback, void *baton)
+{
+    if (m_opaque_ap.get())
+        m_opaque_ap->SetImmediateOutputCallback (log_callback, baton);
+}
+
+void
+SBCommandReturnObject::SetStreamOutput (bool stream_output)
+{
+    if (m_opaque_ap.get())
+        m_opaque_ap->SetStreamOutput (stream_output);
+}
+
+bool
+SBCommandReturnObject::GetStreamOutput ()
+{
+    if (m_opaque_ap.get())
+        return m_opaque_ap->GetStreamOutput ();
+    return false;
+}
+
 void
 SBCommandReturnObject::PutCString(const char* string, int len)
 {
@@ -484,6 +484,18 @@ SBData::ReadRawData (lldb::SBError& error,
     return ok ? size : 0;
 }
 
+const void *
+SBData::GetDataBytes ()
+{
+    const void *bytes = NULL;
+    if (m_opaque_sp.get())
+        bytes = m_opaque_sp->GetDataStart();
+    LogSP log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_API));
+    if (log)
+        log->Printf ("SBData::GetDataBytes () => %p", bytes);
+    return bytes;
+}
+
 void
 SBData::SetData (lldb::SBError& error,
                  const void *buf,
@@ -36,6 +36,7 @@
 #include "lldb/Core/DataVisualization.h"
 #include "lldb/Core/Debugger.h"
 #include "lldb/Core/State.h"
+#include "lldb/Core/Statistics.h"
 #include "lldb/Interpreter/Args.h"
 #include "lldb/Interpreter/CommandInterpreter.h"
 #include "lldb/Interpreter/OptionGroupPlatform.h"
@@ -333,11 +334,12 @@ SBDebugger::HandleCommand (const char *command)
             ProcessSP process_sp (process.GetSP());
             if (process_sp)
             {
-                EventSP event_sp;
+                EventIntrusiveSP event_sp;
                 Listener &lldb_listener = m_opaque_sp->GetListener();
                 while (lldb_listener.GetNextEventForBroadcaster (process_sp.get(), event_sp))
                 {
-                    SBEvent event(event_sp);
+                    EventSP public_event_sp (Event::MakePublicSP (event_sp));
+                    SBEvent event(public_event_sp);
                     HandleProcessEvent (process, event, GetOutputFileHandle(), GetErrorFileHandle());
                 }
             }
@@ -380,17 +382,25 @@ SBDebugger::HandleProcessEvent (const SBProcess &process, const SBEvent &event,
     if (event_type & (Process::eBroadcastBitSTDOUT | Process::eBroadcastBitStateChanged))
     {
         // Drain stdout when we stop just in case we have any bytes
-        while ((len = process.GetSTDOUT (stdio_buffer, sizeof (stdio_buffer))) > 0)
-            if (out != NULL)
-                ::fwrite (stdio_buffer, 1, len, out);
+        if (out != NULL)
+            process.DrainSTDOUT (out);
+        else
+        {
+            while ((len = process.GetSTDOUT (stdio_buffer, sizeof (stdio_buffer))) > 0)
+                ;
+        }
     }
     
     if (event_type & (Process::eBroadcastBitSTDERR | Process::eBroadcastBitStateChanged))
     {
         // Drain stderr when we stop just in case we have any bytes
-        while ((len = process.GetSTDERR (stdio_buffer, sizeof (stdio_buffer))) > 0)
-            if (err != NULL)
-                ::fwrite (stdio_buffer, 1, len, err);
+        if (err != NULL)
+            process.DrainSTDERR (err);
+        else
+        {
+            while ((len = process.GetSTDERR (stdio_buffer, sizeof (stdio_buffer))) > 0)
+                ;
+        }
     }
     
     if (event_type & Process::eBroadcastBitStateChanged)
@@ -467,6 +477,13 @@ SBDebugger::GetVersionString ()
     return lldb_private::GetVersion();
 }
 
+bool
+SBDebugger::GetStatistics (SBStream &json)
+{
+    Statistics::Dump (json.ref(), true);
+    return true;
+}
+
 const char *
 SBDebugger::StateAsCString (StateType state)
 {
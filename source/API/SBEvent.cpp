@@ -30,7 +30,7 @@ SBEvent::SBEvent () :
 }
 
 SBEvent::SBEvent (uint32_t event_type, const char *cstr, uint32_t cstr_len) :
-    m_event_sp (new Event (event_type, new EventDataBytes (cstr, cstr_len))),
+    m_event_sp (Event::MakePublicSP (EventIntrusiveSP (new Event (event_type, new EventDataBytes (cstr, cstr_len))))),
     m_opaque_ptr (m_event_sp.get())
 {
 }
@@ -15,10 +15,12 @@
 #include "lldb/lldb-types.h"
 
 #include "lldb/Core/Address.h"
+#include "lldb/Core/AsyncOperation.h"
 #include "lldb/Core/ConstString.h"
 #include "lldb/Core/Log.h"
 #include "lldb/Core/Stream.h"
 #include "lldb/Core/StreamFile.h"
+#include "lldb/Core/ValueObjectList.h"
 #include "lldb/Core/ValueObjectRegister.h"
 #include "lldb/Core/ValueObjectVariable.h"
 #include "lldb/Expression/ClangUserExpression.h"
@@ -40,6 +42,7 @@
 #include "lldb/API/SBDebugger.h"
 #include "lldb/API/SBValue.h"
 #include "lldb/API/SBAddress.h"
+#include "lldb/API/SBAsyncOperation.h"
 #include "lldb/API/SBStream.h"
 #include "lldb/API/SBSymbolContext.h"
 #include "lldb/API/SBThread.h"
@@ -902,13 +905,22 @@ SBFrame::GetVariables (bool arguments,
         {
 
             size_t i;
+            VariableListSP scope_variable_list_sp;
             VariableList *variable_list = NULL;
-            variable_list = frame->GetVariableList(true);
+            if (in_scope_only)
+            {
+                // Don't parse the variables of blocks that don't contain the PC
+                scope_variable_list_sp = frame->GetScopeVariableList(true);
+                variable_list = scope_variable_list_sp.get();
+            }
+            else
+                variable_list = frame->GetVariableList(true);
             if (variable_list)
             {
                 const size_t num_variables = variable_list->GetSize();
                 if (num_variables)
                 {
+                    ValueObjectList valobj_list;
                     for (i = 0; i < num_variables; ++i)
                     {
                         VariableSP variable_sp (variable_list->GetVariableAtIndex(i));
@@ -938,10 +950,19 @@ SBFrame::GetVariables (bool arguments,
                                 if (in_scope_only && !variable_sp->IsInScope(frame))
                                     continue;
 
-                                value_list.Append(frame->GetValueObjectForFrameVariable (variable_sp, use_dynamic));
+                                valobj_list.Append(frame->GetValueObjectForFrameVariable (variable_sp, use_dynamic));
                             }
                         }
                     }
+
+                    // Read the memory of all the variables at once rather
+                    // than one variable at a time as they get updated
+                    valobj_list.PrefetchMemory();
+                    // and the strings that their summaries will show
+                    valobj_list.PrefetchPointedStrings();
+                    const uint32_t num_values = valobj_list.GetSize();
+                    for (i = 0; i < num_values; ++i)
+                        value_list.Append(valobj_list.GetValueObjectAtIndex(i));
                 }
             }
         }
@@ -1122,6 +1143,55 @@ SBFrame::EvaluateExpression (const char *expr, lldb::DynamicValueType fetch_dyna
     return expr_result;
 }
 
+namespace {
+
+class EvaluateExpressionOperation : public AsyncOperation
+{
+public:
+    EvaluateExpressionOperation (const SBFrame &frame,
+                                 const char *expr,
+                                 lldb::DynamicValueType use_dynamic,
+                                 bool unwind_on_error) :
+        AsyncOperation (),
+        m_frame (frame),
+        m_expr (expr),
+        m_use_dynamic (use_dynamic),
+        m_unwind_on_error (unwind_on_error)
+    {
+    }
+
+protected:
+    virtual void
+    DoExecute ()
+    {
+        SBValue expr_result (m_frame.EvaluateExpression (m_expr.c_str(), m_use_dynamic, m_unwind_on_error));
+        m_valobj_sp = expr_result.get_sp();
+        if (m_valobj_sp)
+            m_error = m_valobj_sp->GetError();
+    }
+
+    SBFrame m_frame;
+    std::string m_expr;
+    lldb::DynamicValueType m_use_dynamic;
+    bool m_unwind_on_error;
+};
+
+} // anonymous namespace
+
+SBAsyncOperation
+SBFrame::EvaluateExpressionAsync (const char *expr, lldb::DynamicValueType fetch_dynamic_value, bool unwind_on_error)
+{
+    LogSP log(GetLogIfAllCategoriesSet (LIBLLDB_LOG_API));
+
+    AsyncOperationSP op_sp (new EvaluateExpressionOperation (*this, expr ? expr : "", fetch_dynamic_value, unwind_on_error));
+    op_sp->Start();
+
+    if (log)
+        log->Printf ("SBFrame(%p)::EvaluateExpressionAsync (expr=\"%s\", use_dynamic=%i) => SBAsyncOperation(%p)",
+                     GetFrameSP().get(), expr, fetch_dynamic_value, op_sp.get());
+    return SBAsyncOperation (op_sp);
+}
+
 bool
 SBFrame::IsInlined()
 {
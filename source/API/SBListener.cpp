@@ -80,7 +80,7 @@ SBListener::IsValid() const
 void
 SBListener::AddEvent (const SBEvent &event)
 {
-    EventSP &event_sp = event.GetSP ();
+    EventIntrusiveSP event_sp (Event::MakeIntrusiveSP (event.GetSP ()));
     if (event_sp)
         m_opaque_ptr->AddEvent (event_sp);
 }
@@ -213,10 +213,11 @@ SBListener::WaitForEvent (uint32_t timeout_secs, SBEvent &event)
             time_value = TimeValue::Now();
             time_value.OffsetWithSeconds (timeout_secs);
         }
-        EventSP event_sp;
+        EventIntrusiveSP event_sp;
         if (m_opaque_ptr->WaitForEvent (time_value.IsValid() ? &time_value : NULL, event_sp))
         {
-            event.reset (event_sp);
+            EventSP public_event_sp (Event::MakePublicSP (event_sp));
+            event.reset (public_event_sp);
             success = true;
         }
     }
@@ -255,12 +256,13 @@ SBListener::WaitForEventForBroadcaster
             time_value = TimeValue::Now();
             time_value.OffsetWithSeconds (num_seconds);
         }
-        EventSP event_sp;
+        EventIntrusiveSP event_sp;
         if (m_opaque_ptr->WaitForEventForBroadcaster (time_value.IsValid() ? &time_value : NULL,
                                                          broadcaster.get(),
                                                          event_sp))
         {
-            event.reset (event_sp);
+            EventSP public_event_sp (Event::MakePublicSP (event_sp));
+            event.reset (public_event_sp);
             return true;
         }
 
@@ -286,13 +288,14 @@ SBListener::WaitForEventForBroadcasterWithType
             time_value = TimeValue::Now();
             time_value.OffsetWithSeconds (num_seconds);
         }
-        EventSP event_sp;
+        EventIntrusiveSP event_sp;
         if (m_opaque_ptr->WaitForEventForBroadcasterWithType (time_value.IsValid() ? &time_value : NULL,
                                                               broadcaster.get(),
                                                               event_type_mask,
                                                               event_sp))
         {
-            event.reset (event_sp);
+            EventSP public_event_sp (Event::MakePublicSP (event_sp));
+            event.reset (public_event_sp);
             return true;
         }
     }
@@ -342,10 +345,11 @@ SBListener::GetNextEvent (SBEvent &event)
 {
     if (m_opaque_ptr)
     {
-        EventSP event_sp;
+        EventIntrusiveSP event_sp;
         if (m_opaque_ptr->GetNextEvent (event_sp))
         {
-            event.reset (event_sp);
+            EventSP public_event_sp (Event::MakePublicSP (event_sp));
+            event.reset (public_event_sp);
             return true;
         }
     }
@@ -358,10 +362,11 @@ SBListener::GetNextEventForBroadcaster (const SBBroadcaster &broadcaster, SBEven
 {
     if (m_opaque_ptr && broadcaster.IsValid())
     {
-        EventSP event_sp;
+        EventIntrusiveSP event_sp;
         if (m_opaque_ptr->GetNextEventForBroadcaster (broadcaster.get(), event_sp))
         {
-            event.reset (event_sp);
+            EventSP public_event_sp (Event::MakePublicSP (event_sp));
+            event.reset (public_event_sp);
             return true;
         }
     }
@@ -379,12 +384,13 @@ SBListener::GetNextEventForBroadcasterWithType
 {
     if (m_opaque_ptr && broadcaster.IsValid())
     {
-        EventSP event_sp;
+        EventIntrusiveSP event_sp;
         if (m_opaque_ptr->GetNextEventForBroadcasterWithType (broadcaster.get(),
                                                               event_type_mask,
                                                               event_sp))
         {
-            event.reset (event_sp);
+            EventSP public_event_sp (Event::MakePublicSP (event_sp));
+            event.reset (public_event_sp);
             return true;
         }
     }
@@ -396,7 +402,10 @@ bool
 SBListener::HandleBroadcastEvent (const SBEvent &event)
 {
     if (m_opaque_ptr)
-        return m_opaque_ptr->HandleBroadcastEvent (event.GetSP());
+    {
+        EventIntrusiveSP event_sp (Event::MakeIntrusiveSP (event.GetSP()));
+        return m_opaque_ptr->HandleBroadcastEvent (event_sp);
+    }
     return false;
 }
 
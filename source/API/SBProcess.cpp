@@ -335,6 +335,118 @@ SBProcess::GetSTDERR (char *dst, size_t dst_len) const
     return bytes_read;
 }
 
+size_t
+SBProcess::DrainSTDOUT (FILE *out) const
+{
+    size_t bytes_written = 0;
+    ProcessSP process_sp(GetSP());
+    if (process_sp && out != NULL)
+    {
+        Error error;
+        StreamFile stream (out, false);
+        bytes_written = process_sp->GetSTDOUT (stream, error);
+    }
+
+    LogSP log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_API));
+    if (log)
+        log->Printf ("SBProcess(%p)::DrainSTDOUT (out=%p) => %zu",
+                     process_sp.get(), out, bytes_written);
+
+    return bytes_written;
+}
+
+size_t
+SBProcess::DrainSTDERR (FILE *out) const
+{
+    size_t bytes_written = 0;
+    ProcessSP process_sp(GetSP());
+    if (process_sp && out != NULL)
+    {
+        Error error;
+        StreamFile stream (out, false);
+        bytes_written = process_sp->GetSTDERR (stream, error);
+    }
+
+    LogSP log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_API));
+    if (log)
+        log->Printf ("SBProcess(%p)::DrainSTDERR (out=%p) => %zu",
+                     process_sp.get(), out, bytes_written);
+
+    return bytes_written;
+}
+
+SBError
+SBProcess::EnableAsyncProfiling (uint32_t interval_usec, uint32_t max_frames, uint32_t scan_type)
+{
+    SBError sb_error;
+    ProcessSP process_sp(GetSP());
+    if (process_sp)
+    {
+        Mutex::Locker api_locker (process_sp->GetTarget().GetAPIMutex());
+        sb_error.SetError (process_sp->EnableAsyncProfiling (interval_usec, max_frames, scan_type));
+    }
+    else
+        sb_error.SetErrorString ("SBProcess is invalid");
+    LogSP log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_API));
+    if (log)
+    {
+        SBStream sstr;
+        sb_error.GetDescription (sstr);
+        log->Printf ("SBProcess(%p)::EnableAsyncProfiling (interval_usec=%u, max_frames=%u, scan_type=0x%x) => SBError (%p): %s", 
+                     process_sp.get(), 
+                     interval_usec,
+                     max_frames,
+                     scan_type,
+                     sb_error.get(),
+                     sstr.GetData());
+    }
+    return sb_error;
+}
+
+SBError
+SBProcess::DisableAsyncProfiling ()
+{
+    SBError sb_error;
+    ProcessSP process_sp(GetSP());
+    if (process_sp)
+    {
+        Mutex::Locker api_locker (process_sp->GetTarget().GetAPIMutex());
+        sb_error.SetError (process_sp->DisableAsyncProfiling ());
+    }
+    else
+        sb_error.SetErrorString ("SBProcess is invalid");
+    LogSP log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_API));
+    if (log)
+    {
+        SBStream sstr;
+        sb_error.GetDescription (sstr);
+        log->Printf ("SBProcess(%p)::DisableAsyncProfiling () => SBError (%p): %s", 
+                     process_sp.get(), 
+                     sb_error.get(),
+                     sstr.GetData());
+    }
+    return sb_error;
+}
+
+size_t
+SBProcess::GetAsyncProfileData (char *dst, size_t dst_len) const
+{
+    size_t bytes_read = 0;
+    ProcessSP process_sp(GetSP());
+    if (process_sp)
+    {
+        Error error;
+        bytes_read = process_sp->GetAsyncProfileData (dst, dst_len, error);
+    }
+
+    LogSP log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_API));
+    if (log)
+        log->Printf ("SBProcess(%p)::GetAsyncProfileData (dst=\"%.*s\", dst_len=%zu) => %zu",
+                     process_sp.get(), (int) bytes_read, dst, dst_len, bytes_read);
+
+    return bytes_read;
+}
+
 void
 SBProcess::ReportEventState (const SBEvent &event, FILE *out) const
 {
@@ -979,6 +1091,34 @@ SBProcess::ReadPointerFromMemory (addr_t addr, lldb::SBError &sb_error)
     return ptr;
 }
 
+lldb::addr_t
+SBProcess::FindInMemory (addr_t start_addr, addr_t end_addr, const void *buf, size_t size, lldb::SBError &sb_error)
+{
+    lldb::addr_t match_addr = LLDB_INVALID_ADDRESS;
+    ProcessSP process_sp(GetSP());
+    if (process_sp)
+    {
+        Process::StopLocker stop_locker;
+        if (stop_locker.TryLock(&process_sp->GetRunLock()))
+        {
+            Mutex::Locker api_locker (process_sp->GetTarget().GetAPIMutex());
+            match_addr = process_sp->FindInMemory (start_addr, end_addr, (const uint8_t *)buf, size, sb_error.ref());
+        }
+        else
+        {
+            LogSP log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_API));
+            if (log)
+                log->Printf ("SBProcess(%p)::FindInMemory() => error: process is running", process_sp.get());
+            sb_error.SetErrorString("process is running");
+        }
+    }
+    else
+    {
+        sb_error.SetErrorString ("SBProcess is invalid");
+    }
+    return match_addr;
+}
+
 size_t
 SBProcess::WriteMemory (addr_t addr, const void *src, size_t src_len, SBError &sb_error)
 {
@@ -11,6 +11,7 @@
 
 #include "lldb/lldb-public.h"
 
+#include "lldb/API/SBAsyncOperation.h"
 #include "lldb/API/SBDebugger.h"
 #include "lldb/API/SBBreakpoint.h"
 #include "lldb/API/SBFileSpec.h"
@@ -28,6 +29,7 @@
 #include "lldb/Core/AddressResolver.h"
 #include "lldb/Core/AddressResolverName.h"
 #include "lldb/Core/ArchSpec.h"
+#include "lldb/Core/AsyncOperation.h"
 #include "lldb/Core/Debugger.h"
 #include "lldb/Core/Disassembler.h"
 #include "lldb/Core/Log.h"
@@ -385,6 +387,18 @@ SBAttachInfo::SetIgnoreExisting (bool b)
     m_opaque_sp->SetIgnoreExisting (b);
 }
 
+bool
+SBAttachInfo::GetDeferSymbolLoading ()
+{
+    return m_opaque_sp->GetDeferSymbolLoading();
+}
+
+void
+SBAttachInfo::SetDeferSymbolLoading (bool b)
+{
+    m_opaque_sp->SetDeferSymbolLoading (b);
+}
+
 uint32_t
 SBAttachInfo::GetUserID()
 {
@@ -1089,6 +1103,55 @@ SBTarget::ConnectRemote
     return sb_process;
 }
 
+SBProcess
+SBTarget::LoadCore
+(
+    SBListener &listener,
+    const char *core_file,
+    SBError& error
+)
+{
+    SBProcess sb_process;
+    ProcessSP process_sp;
+    TargetSP target_sp(GetSP());
+    if (target_sp)
+    {
+        Mutex::Locker api_locker (target_sp->GetAPIMutex());
+        FileSpec core_file_spec (core_file, true);
+        if (core_file && core_file_spec.Exists())
+        {
+            if (listener.IsValid())
+                process_sp = target_sp->CreateProcess (listener.ref(), NULL, &core_file_spec);
+            else
+                process_sp = target_sp->CreateProcess (target_sp->GetDebugger().GetListener(), NULL, &core_file_spec);
+
+            if (process_sp)
+            {
+                sb_process.SetSP (process_sp);
+                error.SetError (process_sp->LoadCore());
+            }
+            else
+            {
+                error.SetErrorStringWithFormat ("unable to find a process plug-in for core file '%s'", core_file);
+            }
+        }
+        else
+        {
+            error.SetErrorStringWithFormat ("core file '%s' does not exist", core_file ? core_file : "");
+        }
+    }
+    else
+    {
+        error.SetErrorString ("SBTarget is invalid");
+    }
+
+    LogSP log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_API));
+    if (log)
+        log->Printf ("SBTarget(%p)::LoadCore (core_file=\"%s\") => SBProcess(%p)",
+                     target_sp.get(), core_file, process_sp.get());
+    return sb_process;
+}
+
 SBFileSpec
 SBTarget::GetExecutable ()
 {
@@ -1168,6 +1231,28 @@ SBTarget::ResolveSymbolContextForAddress (const SBAddress& addr, uint32_t resolv
     return sc;
 }
 
+uint32_t
+SBTarget::ResolveLoadAddresses (uint64_t *array,
+                                size_t array_len,
+                                uint32_t resolve_scope,
+                                SBSymbolContextList &sc_list)
+{
+    LogSP log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_API));
+
+    uint32_t num_resolved = 0;
+    TargetSP target_sp(GetSP());
+    if (target_sp && array && array_len > 0)
+    {
+        Mutex::Locker api_locker (target_sp->GetAPIMutex());
+        num_resolved = target_sp->ResolveSymbolContextsForLoadAddresses (array, array_len, resolve_scope, *sc_list);
+    }
+
+    if (log)
+        log->Printf ("SBTarget(%p)::ResolveLoadAddresses (array=%p, array_len=%zu, resolve_scope=0x%x) => %u",
+                     target_sp.get(), array, array_len, resolve_scope, num_resolved);
+    return num_resolved;
+}
+
 
 SBBreakpoint
 SBTarget::BreakpointCreateByLocation (const char *file, uint32_t line)
@@ -1982,6 +2067,61 @@ SBTarget::FindFunctions (const char *name, uint32_t name_type_mask)
     return sb_sc_list;
 }
 
+namespace {
+
+class FindFunctionsOperation : public AsyncOperation
+{
+public:
+    FindFunctionsOperation (const TargetSP &target_sp, const char *name, uint32_t name_type_mask) :
+        AsyncOperation (),
+        m_target_sp (target_sp),
+        m_name (name),
+        m_name_type_mask (name_type_mask)
+    {
+    }
+
+protected:
+    virtual void
+    DoExecute ()
+    {
+        const bool symbols_ok = true;
+        const bool inlines_ok = true;
+        const bool append = true;
+        m_target_sp->GetImages().FindFunctions (m_name,
+                                                m_name_type_mask,
+                                                symbols_ok,
+                                                inlines_ok,
+                                                append,
+                                                m_sc_list);
+        m_count = m_sc_list.GetSize();
+    }
+
+    TargetSP m_target_sp;
+    ConstString m_name;
+    uint32_t m_name_type_mask;
+};
+
+} // anonymous namespace
+
+lldb::SBAsyncOperation
+SBTarget::FindFunctionsAsync (const char *name, uint32_t name_type_mask)
+{
+    LogSP log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_API));
+
+    AsyncOperationSP op_sp;
+    TargetSP target_sp(GetSP());
+    if (name && name[0] && target_sp)
+    {
+        op_sp.reset (new FindFunctionsOperation (target_sp, name, name_type_mask));
+        op_sp->Start();
+    }
+
+    if (log)
+        log->Printf ("SBTarget(%p)::FindFunctionsAsync (name=\"%s\", name_type_mask=0x%x) => SBAsyncOperation(%p)",
+                     target_sp.get(), name, name_type_mask, op_sp.get());
+    return SBAsyncOperation (op_sp);
+}
+
 lldb::SBType
 SBTarget::FindFirstType (const char* type)
 {
@@ -9,16 +9,19 @@
 
 #include "lldb/API/SBThread.h"
 
+#include "lldb/API/SBAsyncOperation.h"
 #include "lldb/API/SBSymbolContext.h"
 #include "lldb/API/SBFileSpec.h"
 #include "lldb/API/SBStream.h"
 #include "lldb/Breakpoint/BreakpointLocation.h"
+#include "lldb/Core/AsyncOperation.h"
 #include "lldb/Core/Debugger.h"
 #include "lldb/Core/Stream.h"
 #include "lldb/Core/StreamFile.h"
 #include "lldb/Interpreter/CommandInterpreter.h"
 #include "lldb/Target/Thread.h"
 #include "lldb/Target/Process.h"
+#include "lldb/Target/StackFrame.h"
 #include "lldb/Symbol/SymbolContext.h"
 #include "lldb/Symbol/CompileUnit.h"
 #include "lldb/Target/StopInfo.h"
@@ -991,6 +994,105 @@ SBThread::GetNumFrames ()
     return num_frames;
 }
 
+namespace {
+
+class GetFramesOperation : public AsyncOperation
+{
+public:
+    GetFramesOperation (const ExecutionContextRef &exe_ctx_ref, uint32_t max_frames) :
+        AsyncOperation (),
+        m_exe_ctx_ref (exe_ctx_ref),
+        m_max_frames (max_frames)
+    {
+    }
+
+protected:
+    virtual void
+    DoExecute ()
+    {
+        Mutex::Locker api_locker;
+        ExecutionContext exe_ctx (m_exe_ctx_ref, api_locker);
+        if (!exe_ctx.HasThreadScope())
+        {
+            m_error.SetErrorString ("invalid thread");
+            return;
+        }
+
+        Process::StopLocker stop_locker;
+        if (!stop_locker.TryLock(&exe_ctx.GetProcessPtr()->GetRunLock()))
+        {
+            m_error.SetErrorString ("process is running");
+            return;
+        }
+
+        // Each frame is a safe place to stop, the frames unwound so far
+        // stay cached in the thread's frame list either way
+        Thread *thread = exe_ctx.GetThreadPtr();
+        for (uint32_t idx = 0; m_max_frames == 0 || idx < m_max_frames; ++idx)
+        {
+            if (AsyncOperation::ShouldCancel())
+                break;
+            StackFrameSP frame_sp (thread->GetStackFrameAtIndex (idx));
+            if (!frame_sp)
+                break;
+            m_sc_list.Append (frame_sp->GetSymbolContext (eSymbolContextEverything));
+            ++m_count;
+        }
+    }
+
+    ExecutionContextRef m_exe_ctx_ref;
+    uint32_t m_max_frames;
+};
+
+} // anonymous namespace
+
+SBAsyncOperation
+SBThread::GetFramesAsync (uint32_t max_frames)
+{
+    LogSP log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_API));
+
+    AsyncOperationSP op_sp;
+    if (m_opaque_sp)
+    {
+        op_sp.reset (new GetFramesOperation (*m_opaque_sp, max_frames));
+        op_sp->Start();
+    }
+
+    if (log)
+        log->Printf ("SBThread(%p)::GetFramesAsync (max_frames=%u) => SBAsyncOperation(%p)",
+                     m_opaque_sp.get(), max_frames, op_sp.get());
+    return SBAsyncOperation (op_sp);
+}
+
+uint32_t
+SBThread::GetFramePCs (lldb::addr_t *pcs, uint32_t max_pcs)
+{
+    LogSP log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_API));
+
+    uint32_t num_pcs = 0;
+    Mutex::Locker api_locker;
+    ExecutionContext exe_ctx (m_opaque_sp.get(), api_locker);
+
+    if (pcs != NULL && exe_ctx.HasThreadScope())
+    {
+        Process::StopLocker stop_locker;
+        if (stop_locker.TryLock(&exe_ctx.GetProcessPtr()->GetRunLock()))
+        {
+            num_pcs = exe_ctx.GetThreadPtr()->GetFramePCs (pcs, max_pcs);
+        }
+        else
+        {
+            if (log)
+                log->Printf ("SBThread(%p)::GetFramePCs() => error: process is running", exe_ctx.GetThreadPtr());
+        }
+    }
+
+    if (log)
+        log->Printf ("SBThread(%p)::GetFramePCs (pcs=%p, max_pcs=%u) => %u", exe_ctx.GetThreadPtr(), pcs, max_pcs, num_pcs);
+
+    return num_pcs;
+}
+
 SBFrame
 SBThread::GetFrameAtIndex (uint32_t idx)
 {
@@ -231,6 +231,10 @@ SBTypeCategory::GetSyntheticForType (SBTypeNameSpecifier spec)
     if (!children_sp)
         return lldb::SBTypeSynthetic();
     
+    // built-in synthetic children aren't Python classes
+    if (!children_sp->IsScripted())
+        return lldb::SBTypeSynthetic();
+    
     TypeSyntheticImplSP synth_sp = STD_STATIC_POINTER_CAST(TypeSyntheticImpl,children_sp);
     
     return lldb::SBTypeSynthetic(synth_sp);
@@ -283,6 +287,9 @@ SBTypeCategory::GetSyntheticAtIndex (uint32_t index)
     if (!children_sp.get())
         return lldb::SBTypeSynthetic();
     
+    if (!children_sp->IsScripted())
+        return lldb::SBTypeSynthetic();
+    
     TypeSyntheticImplSP synth_sp = STD_STATIC_POINTER_CAST(TypeSyntheticImpl,children_sp);
     
     return lldb::SBTypeSynthetic(synth_sp);
@@ -9,6 +9,8 @@
 
 #include "lldb/API/SBValue.h"
 
+#include <algorithm>
+
 #include "lldb/API/SBStream.h"
 #include "lldb/API/SBTypeFilter.h"
 #include "lldb/API/SBTypeFormat.h"
@@ -16,8 +18,10 @@
 #include "lldb/API/SBTypeSynthetic.h"
 
 #include "lldb/Breakpoint/Watchpoint.h"
+#include "lldb/Core/AsyncOperation.h"
 #include "lldb/Core/DataExtractor.h"
 #include "lldb/Core/DataVisualization.h"
+#include "lldb/Core/Debugger.h"
 #include "lldb/Core/Log.h"
 #include "lldb/Core/Module.h"
 #include "lldb/Core/Scalar.h"
@@ -27,6 +31,9 @@
 #include "lldb/Core/Value.h"
 #include "lldb/Core/ValueObject.h"
 #include "lldb/Core/ValueObjectConstResult.h"
+#include "lldb/Core/ValueObjectList.h"
+#include "lldb/Interpreter/CommandInterpreter.h"
+#include "lldb/Interpreter/ScriptInterpreter.h"
 #include "lldb/Symbol/Block.h"
 #include "lldb/Symbol/ObjectFile.h"
 #include "lldb/Symbol/Type.h"
@@ -38,11 +45,13 @@
 #include "lldb/Target/Target.h"
 #include "lldb/Target/Thread.h"
 
+#include "lldb/API/SBAsyncOperation.h"
 #include "lldb/API/SBProcess.h"
 #include "lldb/API/SBTarget.h"
 #include "lldb/API/SBThread.h"
 #include "lldb/API/SBFrame.h"
 #include "lldb/API/SBDebugger.h"
+#include "lldb/API/SBValueList.h"
 
 using namespace lldb;
 using namespace lldb_private;
@@ -842,6 +851,42 @@ SBValue::CreateValueFromData (const char* name, SBData data, SBType type)
     return sb_value;
 }
 
+//----------------------------------------------------------------------
+// Get a child of VALUE_SP, which the caller has locked the target and
+// process of.
+//----------------------------------------------------------------------
+static lldb::ValueObjectSP
+GetChildAtIndexLocked (const lldb::ValueObjectSP &value_sp,
+                       uint32_t idx,
+                       lldb::DynamicValueType use_dynamic,
+                       bool can_create_synthetic)
+{
+    const bool can_create = true;
+    lldb::ValueObjectSP child_sp (value_sp->GetChildAtIndex (idx, can_create));
+    if (can_create_synthetic && !child_sp)
+    {
+        if (value_sp->IsPointerType())
+        {
+            child_sp = value_sp->GetSyntheticArrayMemberFromPointer(idx, can_create);
+        }
+        else if (value_sp->IsArrayType())
+        {
+            child_sp = value_sp->GetSyntheticArrayMemberFromArray(idx, can_create);
+        }
+    }
+        
+    if (child_sp)
+    {
+        if (use_dynamic != lldb::eNoDynamicValues)
+        {
+            lldb::ValueObjectSP dynamic_sp(child_sp->GetDynamicValue (use_dynamic));
+            if (dynamic_sp)
+                child_sp = dynamic_sp;
+        }
+    }
+    return child_sp;
+}
+
 SBValue
 SBValue::GetChildAtIndex (uint32_t idx)
 {
@@ -879,29 +924,7 @@ SBValue::GetChildAtIndex (uint32_t idx, lldb::DynamicValueType use_dynamic, bool
             if (target_sp)
             {
                 Mutex::Locker api_locker (target_sp->GetAPIMutex());
-                const bool can_create = true;
-                child_sp = value_sp->GetChildAtIndex (idx, can_create);
-                if (can_create_synthetic && !child_sp)
-                {
-                    if (value_sp->IsPointerType())
-                    {
-                        child_sp = value_sp->GetSyntheticArrayMemberFromPointer(idx, can_create);
-                    }
-                    else if (value_sp->IsArrayType())
-                    {
-                        child_sp = value_sp->GetSyntheticArrayMemberFromArray(idx, can_create);
-                    }
-                }
-                    
-                if (child_sp)
-                {
-                    if (use_dynamic != lldb::eNoDynamicValues)
-                    {
-                        lldb::ValueObjectSP dynamic_sp(child_sp->GetDynamicValue (use_dynamic));
-                        if (dynamic_sp)
-                            child_sp = dynamic_sp;
-                    }
-                }
+                child_sp = GetChildAtIndexLocked (value_sp, idx, use_dynamic, can_create_synthetic);
             }
         }
     }
@@ -913,6 +936,73 @@ SBValue::GetChildAtIndex (uint32_t idx, lldb::DynamicValueType use_dynamic, bool
     return sb_value;
 }
 
+SBValueList
+SBValue::GetChildren (uint32_t start_idx, uint32_t count)
+{
+    const bool can_create_synthetic = false;
+    lldb::DynamicValueType use_dynamic = eNoDynamicValues;
+    lldb::ValueObjectSP value_sp(GetSP());
+    if (value_sp)
+    {
+        TargetSP target_sp(value_sp->GetTargetSP());
+        if (target_sp)
+            use_dynamic = target_sp->GetPreferDynamicValue();
+    }
+    return GetChildren (start_idx, count, use_dynamic, can_create_synthetic);
+}
+
+SBValueList
+SBValue::GetChildren (uint32_t start_idx, uint32_t count, lldb::DynamicValueType use_dynamic, bool can_create_synthetic)
+{
+    SBValueList sb_children;
+    LogSP log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_API));
+
+    lldb::ValueObjectSP value_sp(GetSP());
+    if (value_sp)
+    {
+        ProcessSP process_sp(value_sp->GetProcessSP());
+        Process::StopLocker stop_locker;
+        if (process_sp && !stop_locker.TryLock(&process_sp->GetRunLock()))
+        {
+            if (log)
+                log->Printf ("SBValue(%p)::GetChildren() => error: process is running", value_sp.get());
+        }
+        else
+        {
+            TargetSP target_sp(value_sp->GetTargetSP());
+            if (target_sp)
+            {
+                // Take the locks once for all of the children instead of
+                // once for each one like GetChildAtIndex() would, and let
+                // their synthetic children providers share one trip into
+                // the script interpreter
+                ScriptInterpreter::Batch script_batch (&target_sp->GetDebugger().GetCommandInterpreter());
+                Mutex::Locker api_locker (target_sp->GetAPIMutex());
+                uint32_t end_idx = UINT32_MAX;
+                if (count < end_idx - start_idx)
+                    end_idx = start_idx + count;
+                // Synthetic array members can go past the real children
+                if (!can_create_synthetic)
+                    end_idx = std::min<uint32_t> (end_idx, value_sp->GetNumChildren());
+
+                ValueObjectList &children = sb_children.ref();
+                for (uint32_t idx = start_idx; idx < end_idx; ++idx)
+                {
+                    lldb::ValueObjectSP child_sp (GetChildAtIndexLocked (value_sp, idx, use_dynamic, can_create_synthetic));
+                    if (!child_sp)
+                        break;
+                    children.Append (child_sp);
+                }
+            }
+        }
+    }
+
+    if (log)
+        log->Printf ("SBValue(%p)::GetChildren (start_idx=%u, count=%u) => %u children", value_sp.get(), start_idx, count, sb_children.GetSize());
+
+    return sb_children;
+}
+
 uint32_t
 SBValue::GetIndexOfChildWithName (const char *name)
 {
@@ -1088,6 +1178,66 @@ SBValue::IsDynamic()
     return false;
 }
 
+namespace {
+
+class FetchValueOperation : public AsyncOperation
+{
+public:
+    FetchValueOperation (const lldb::ValueObjectSP &value_sp) :
+        AsyncOperation ()
+    {
+        m_valobj_sp = value_sp;
+    }
+
+protected:
+    virtual void
+    DoExecute ()
+    {
+        ProcessSP process_sp(m_valobj_sp->GetProcessSP());
+        Process::StopLocker stop_locker;
+        if (process_sp && !stop_locker.TryLock(&process_sp->GetRunLock()))
+        {
+            m_error.SetErrorString ("process is running");
+            return;
+        }
+
+        TargetSP target_sp(m_valobj_sp->GetTargetSP());
+        if (!target_sp)
+        {
+            m_error.SetErrorString ("value has no target");
+            return;
+        }
+
+        // The value object caches all of these until the process runs
+        Mutex::Locker api_locker (target_sp->GetAPIMutex());
+        m_valobj_sp->GetValueAsCString();
+        m_valobj_sp->GetSummaryAsCString();
+        m_count = m_valobj_sp->GetNumChildren();
+        if (m_valobj_sp->GetError().Fail())
+            m_error = m_valobj_sp->GetError();
+    }
+};
+
+} // anonymous namespace
+
+lldb::SBAsyncOperation
+SBValue::FetchAsync ()
+{
+    LogSP log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_API));
+
+    AsyncOperationSP op_sp;
+    lldb::ValueObjectSP value_sp(GetSP());
+    if (value_sp)
+    {
+        op_sp.reset (new FetchValueOperation (value_sp));
+        op_sp->Start();
+    }
+
+    if (log)
+        log->Printf ("SBValue(%p)::FetchAsync () => SBAsyncOperation(%p)", value_sp.get(), op_sp.get());
+    return SBAsyncOperation (op_sp);
+}
+
 lldb::SBValue
 SBValue::GetValueForExpressionPath(const char* expr_path)
 {
@@ -1287,6 +1437,40 @@ SBValue::GetNumChildren ()
     return num_children;
 }
 
+uint32_t
+SBValue::GetNumChildren (uint32_t max)
+{
+    uint32_t num_children = 0;
+
+    LogSP log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_API));
+    lldb::ValueObjectSP value_sp(GetSP());
+    if (value_sp)
+    {
+        ProcessSP process_sp(value_sp->GetProcessSP());
+        Process::StopLocker stop_locker;
+        if (process_sp && !stop_locker.TryLock(&process_sp->GetRunLock()))
+        {
+            if (log)
+                log->Printf ("SBValue(%p)::GetNumChildren(max = %u) => error: process is running", value_sp.get(), max);
+        }
+        else
+        {
+            TargetSP target_sp(value_sp->GetTargetSP());
+            if (target_sp)
+            {
+                Mutex::Locker api_locker (target_sp->GetAPIMutex());
+
+                num_children = value_sp->GetNumChildren(max);
+            }
+        }
+    }
+
+    if (log)
+        log->Printf ("SBValue(%p)::GetNumChildren (max = %u) => %u", value_sp.get(), max, num_children);
+
+    return num_children;
+}
+
 
 SBValue
 SBValue::Dereference ()
@@ -9,10 +9,16 @@
 
 
 #include "lldb/API/SBValueList.h"
+
+#include <algorithm>
+
 #include "lldb/API/SBValue.h"
 #include "lldb/API/SBStream.h"
 #include "lldb/Core/Log.h"
+#include "lldb/Core/Scalar.h"
 #include "lldb/Core/ValueObjectList.h"
+#include "lldb/Target/Process.h"
+#include "lldb/Target/Target.h"
 
 using namespace lldb;
 using namespace lldb_private;
@@ -201,6 +207,60 @@ SBValueList::FindValueObjectByUID (lldb::user_id_t uid)
     return sb_value;
 }
 
+uint32_t
+SBValueList::GetValuesAsUnsigned (uint64_t *values, uint32_t max_values, uint64_t fail_value)
+{
+    LogSP log(GetLogIfAllCategoriesSet (LIBLLDB_LOG_API));
+
+    uint32_t num_values = 0;
+    if (values && m_opaque_ap.get())
+    {
+        num_values = std::min<uint32_t> (max_values, m_opaque_ap->GetSize());
+
+        // The values in a list almost always come from the same target,
+        // so the locks are only changed when the target or process does
+        Process::StopLocker stop_locker;
+        Mutex::Locker api_locker;
+        Process *locked_process = NULL;
+        Target *locked_target = NULL;
+        bool process_running = false;
+        for (uint32_t idx = 0; idx < num_values; ++idx)
+        {
+            values[idx] = fail_value;
+            ValueObjectSP value_sp (m_opaque_ap->GetValueObjectAtIndex (idx));
+            if (!value_sp)
+                continue;
+
+            ProcessSP process_sp(value_sp->GetProcessSP());
+            if (process_sp.get() != locked_process)
+            {
+                locked_process = process_sp.get();
+                process_running = locked_process && !stop_locker.TryLock(&process_sp->GetRunLock());
+            }
+            if (process_running)
+                continue;
+
+            TargetSP target_sp(value_sp->GetTargetSP());
+            if (!target_sp)
+                continue;
+            if (target_sp.get() != locked_target)
+            {
+                locked_target = target_sp.get();
+                api_locker.Lock (target_sp->GetAPIMutex());
+            }
+
+            Scalar scalar;
+            if (value_sp->ResolveValue (scalar))
+                values[idx] = scalar.GetRawBits64(fail_value);
+        }
+    }
+
+    if (log)
+        log->Printf ("SBValueList(%p)::GetValuesAsUnsigned (values=%p, max_values=%u) => %u",
+                     m_opaque_ap.get(), values, max_values, num_values);
+    return num_values;
+}
+
 ValueObjectList *
 SBValueList::get ()
 {
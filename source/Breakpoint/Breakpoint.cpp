@@ -47,6 +47,7 @@ Breakpoint::GetEventIdentifier ()
 //----------------------------------------------------------------------
 Breakpoint::Breakpoint(Target &target, SearchFilterSP &filter_sp, BreakpointResolverSP &resolver_sp) :
     m_being_created(true),
+    m_is_tracepoint (false),
     m_target (target),
     m_filter_sp (filter_sp),
     m_resolver_sp (resolver_sp),
@@ -69,6 +70,22 @@ Breakpoint::IsInternal () const
     return LLDB_BREAK_ID_IS_INTERNAL(m_bid);
 }
 
+bool
+Breakpoint::ResolvesBySymbolLookup () const
+{
+    if (!m_resolver_sp)
+        return false;
+    switch (m_resolver_sp->getResolverID())
+    {
+    case BreakpointResolver::FileLineResolver:
+    case BreakpointResolver::NameResolver:
+        return true;
+    default:
+        break;
+    }
+    return false;
+}
+
 
 
 Target&
@@ -143,6 +160,18 @@ Breakpoint::IsEnabled ()
     return m_options.IsEnabled();
 }
 
+void
+Breakpoint::SetTracepoint (bool tracepoint)
+{
+    m_is_tracepoint = tracepoint;
+}
+
+bool
+Breakpoint::IsTracepoint () const
+{
+    return m_is_tracepoint;
+}
+
 void
 Breakpoint::SetIgnoreCount (uint32_t n)
 {
@@ -358,6 +387,7 @@ Breakpoint::ModulesChanged (ModuleList &module_list, bool load, bool delete_loca
                                  // resolving breakpoints will add new locations potentially.
 
         const size_t num_locs = m_locations.GetSize();
+        BreakpointLocationCollection locations_to_resolve;
         size_t num_modules = module_list.GetSize();
         for (size_t i = 0; i < num_modules; i++)
         {
@@ -377,13 +407,7 @@ Breakpoint::ModulesChanged (ModuleList &module_list, bool load, bool delete_loca
                     if (!seen)
                         seen = true;
 
-                    if (!break_loc->ResolveBreakpointSite())
-                    {
-                        LogSP log (lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_BREAKPOINTS));
-                        if (log)
-                            log->Printf ("Warning: could not set breakpoint site for breakpoint location %d of breakpoint %d.\n",
-                                         break_loc->GetID(), GetID());
-                    }
+                    locations_to_resolve.Add (break_loc);
                 }
             }
 
@@ -391,6 +415,24 @@ Breakpoint::ModulesChanged (ModuleList &module_list, bool load, bool delete_loca
                 new_modules.AppendIfNeeded (module_sp);
 
         }
+
+        // Set the breakpoint sites for all of the locations together, so
+        // the process can insert them with as few round trips as it can.
+        if (locations_to_resolve.GetSize() > 0)
+        {
+            m_locations.ResolveBreakpointSites (locations_to_resolve);
+            LogSP log (lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_BREAKPOINTS));
+            if (log)
+            {
+                for (size_t loc_idx = 0; loc_idx < locations_to_resolve.GetSize(); loc_idx++)
+                {
+                    BreakpointLocationSP break_loc (locations_to_resolve.GetByIndex(loc_idx));
+                    if (!break_loc->IsResolved())
+                        log->Printf ("Warning: could not set breakpoint site for breakpoint location %d of breakpoint %d.\n",
+                                     break_loc->GetID(), GetID());
+                }
+            }
+        }
         
         if (new_modules.GetSize() > 0)
         {
@@ -537,6 +579,9 @@ Breakpoint::GetDescription (Stream *s, lldb::DescriptionLevel level, bool show_l
                 s->Printf(", locations = 0 (pending)");
         }
 
+        if (m_is_tracepoint)
+            s->PutCString(", tracepoint");
+
         GetOptions()->GetDescription(s, level);
         
         if (level == lldb::eDescriptionLevelFull)
@@ -691,7 +736,7 @@ Breakpoint::BreakpointEventData::GetEventDataFromEvent (const Event *event)
 }
 
 BreakpointEventType
-Breakpoint::BreakpointEventData::GetBreakpointEventTypeFromEvent (const EventSP &event_sp)
+Breakpoint::BreakpointEventData::GetBreakpointEventTypeFromEvent (const EventIntrusiveSP &event_sp)
 {
     const BreakpointEventData *data = GetEventDataFromEvent (event_sp.get());
 
@@ -702,7 +747,7 @@ Breakpoint::BreakpointEventData::GetBreakpointEventTypeFromEvent (const EventSP
 }
 
 BreakpointSP
-Breakpoint::BreakpointEventData::GetBreakpointFromEvent (const EventSP &event_sp)
+Breakpoint::BreakpointEventData::GetBreakpointFromEvent (const EventIntrusiveSP &event_sp)
 {
     BreakpointSP bp_sp;
 
@@ -714,7 +759,7 @@ Breakpoint::BreakpointEventData::GetBreakpointFromEvent (const EventSP &event_sp
 }
 
 uint32_t
-Breakpoint::BreakpointEventData::GetNumBreakpointLocationsFromEvent (const EventSP &event_sp)
+Breakpoint::BreakpointEventData::GetNumBreakpointLocationsFromEvent (const EventIntrusiveSP &event_sp)
 {
     const BreakpointEventData *data = GetEventDataFromEvent (event_sp.get());
     if (data)
@@ -724,7 +769,7 @@ Breakpoint::BreakpointEventData::GetNumBreakpointLocationsFromEvent (const Event
 }
 
 lldb::BreakpointLocationSP
-Breakpoint::BreakpointEventData::GetBreakpointLocationAtIndexFromEvent (const lldb::EventSP &event_sp, uint32_t bp_loc_idx)
+Breakpoint::BreakpointEventData::GetBreakpointLocationAtIndexFromEvent (const lldb::EventIntrusiveSP &event_sp, uint32_t bp_loc_idx)
 {
     lldb::BreakpointLocationSP bp_loc_sp;
 
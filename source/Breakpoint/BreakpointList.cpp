@@ -204,6 +204,26 @@ BreakpointList::UpdateBreakpoints (ModuleList& module_list, bool added)
     Mutex::Locker locker(m_mutex);
     bp_collection::iterator end = m_breakpoints.end();
     bp_collection::iterator pos;
+
+    if (added)
+    {
+        // Each breakpoint searches the new modules on its own, and the
+        // first lookup in a module builds that module's name indexes,
+        // which is by far the most expensive part of resolving. Build
+        // the indexes for all the new modules in parallel up front so
+        // the breakpoints below only do cheap lookups. Only user
+        // breakpoints count here, the internal ones are usually limited
+        // to one or two modules.
+        for (pos = m_breakpoints.begin(); pos != end; ++pos)
+        {
+            if (!(*pos)->IsInternal() && (*pos)->ResolvesBySymbolLookup())
+            {
+                module_list.PreloadSymbols ();
+                break;
+            }
+        }
+    }
+
     for (pos = m_breakpoints.begin(); pos != end; ++pos)
         (*pos)->ModulesChanged (module_list, added);
 
@@ -243,6 +243,17 @@ BreakpointLocation::GetConditionText () const
     return GetOptionsNoCreate()->GetConditionText();
 }
 
+bool
+BreakpointLocation::ConditionSaysStop (ExecutionContext &exe_ctx, Error &error)
+{
+    // Use the same options GetConditionText() gets the condition from,
+    // so locations without their own condition share the compiled copies
+    // of the breakpoint's.
+    if (m_options_ap.get() != NULL)
+        return m_options_ap->ConditionSaysStop (exe_ctx, error);
+    return m_owner.GetOptions()->ConditionSaysStop (exe_ctx, error);
+}
+
 uint32_t
 BreakpointLocation::GetIgnoreCount ()
 {
@@ -347,6 +358,32 @@ BreakpointLocation::ShouldStop (StoppointCallbackContext *context)
     return should_stop;
 }
 
+void
+BreakpointLocation::AddFilteredHits (uint32_t num_hits)
+{
+    // The stub only filters hits when there are no ignore counts, so
+    // these hits would have gone straight to the condition in ShouldStop
+    for (uint32_t i=0; i<num_hits; ++i)
+        IncrementHitCount();
+}
+
+bool
+BreakpointLocation::TracepointWasHit ()
+{
+    IncrementHitCount();
+
+    if (!IsEnabled())
+        return false;
+
+    if (!IgnoreCountShouldStop())
+        return false;
+
+    if (!m_owner.IgnoreCountShouldStop())
+        return false;
+
+    return true;
+}
+
 bool
 BreakpointLocation::IsResolved () const
 {
@@ -394,12 +431,26 @@ BreakpointLocation::SetBreakpointSite (BreakpointSiteSP& bp_site_sp)
 }
 
 bool
-BreakpointLocation::ClearBreakpointSite ()
+BreakpointLocation::ClearBreakpointSite (BreakpointSiteList *unowned_sites)
 {
+    // The compiled conditions are tied to the process, which may be about
+    // to go away.
+    if (m_options_ap.get() != NULL)
+        m_options_ap->ClearConditionCache();
+    m_owner.GetOptions()->ClearConditionCache();
+
     if (m_bp_site_sp.get())
     {
-        m_owner.GetTarget().GetProcessSP()->RemoveOwnerFromBreakpointSite (GetBreakpoint().GetID(), 
-                                                                           GetID(), m_bp_site_sp);
+        if (unowned_sites)
+        {
+            if (m_bp_site_sp->RemoveOwner (GetBreakpoint().GetID(), GetID()) == 0)
+                unowned_sites->Add (m_bp_site_sp);
+        }
+        else
+        {
+            m_owner.GetTarget().GetProcessSP()->RemoveOwnerFromBreakpointSite (GetBreakpoint().GetID(), 
+                                                                               GetID(), m_bp_site_sp);
+        }
         m_bp_site_sp.reset();
         return true;
     }
@@ -14,7 +14,11 @@
 // Project includes
 #include "lldb/Breakpoint/BreakpointLocationList.h"
 #include "lldb/Breakpoint/BreakpointLocation.h"
+#include "lldb/Breakpoint/BreakpointLocationCollection.h"
+#include "lldb/Breakpoint/Breakpoint.h"
 #include "lldb/Core/Section.h"
+#include "lldb/Target/Process.h"
+#include "lldb/Target/Target.h"
 
 using namespace lldb;
 using namespace lldb_private;
@@ -164,8 +168,21 @@ BreakpointLocationList::ClearAllBreakpointSites ()
 {
     Mutex::Locker locker (m_mutex);
     collection::iterator pos, end = m_locations.end();
+    ProcessSP process_sp (m_owner.GetTarget().GetProcessSP());
+    if (!process_sp)
+    {
+        for (pos = m_locations.begin(); pos != end; ++pos)
+            (*pos)->ClearBreakpointSite();
+        return;
+    }
+
+    // Take the sites that no other breakpoint uses out of the process
+    // together rather than one at a time.
+    BreakpointSiteList unowned_sites;
     for (pos = m_locations.begin(); pos != end; ++pos)
-        (*pos)->ClearBreakpointSite();
+        (*pos)->ClearBreakpointSite(&unowned_sites);
+    if (unowned_sites.GetSize() > 0)
+        process_sp->RemoveUnownedBreakpointSites (unowned_sites);
 }
 
 void
@@ -174,11 +191,36 @@ BreakpointLocationList::ResolveAllBreakpointSites ()
     Mutex::Locker locker (m_mutex);
     collection::iterator pos, end = m_locations.end();
 
+    BreakpointLocationCollection bp_locs;
     for (pos = m_locations.begin(); pos != end; ++pos)
     {
         if ((*pos)->IsEnabled())
-            (*pos)->ResolveBreakpointSite();
+            bp_locs.Add (*pos);
+    }
+    ResolveBreakpointSites (bp_locs);
+}
+
+size_t
+BreakpointLocationList::ResolveBreakpointSites (const BreakpointLocationCollection &bp_locs)
+{
+    Process *process = m_owner.GetTarget().GetProcessSP().get();
+    if (process == NULL || m_owner.GetTarget().GetSectionLoadList().IsEmpty())
+        return 0;
+
+    BreakpointLocationCollection unresolved_locs;
+    size_t num_resolved = 0;
+    const size_t num_locs = bp_locs.GetSize();
+    for (size_t i = 0; i < num_locs; ++i)
+    {
+        BreakpointLocationSP bp_loc_sp (bp_locs.GetByIndex(i));
+        if (bp_loc_sp->IsResolved())
+            ++num_resolved;
+        else
+            unresolved_locs.Add (bp_loc_sp);
     }
+    if (unresolved_locs.GetSize() > 0)
+        num_resolved += process->CreateBreakpointSites (unresolved_locs, false);
+    return num_resolved;
 }
 
 uint32_t
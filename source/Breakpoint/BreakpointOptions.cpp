@@ -13,11 +13,17 @@
 // C++ Includes
 // Other libraries and framework includes
 // Project includes
+#include "lldb/lldb-private-log.h"
+#include "lldb/Core/Log.h"
+#include "lldb/Core/Module.h"
 #include "lldb/Core/Stream.h"
 #include "lldb/Core/StringList.h"
 #include "lldb/Core/Value.h"
+#include "lldb/Core/ValueObject.h"
 #include "lldb/Breakpoint/StoppointCallbackContext.h"
+#include "lldb/Symbol/SymbolContext.h"
 #include "lldb/Target/Process.h"
+#include "lldb/Target/StackFrame.h"
 #include "lldb/Target/Target.h"
 #include "lldb/Target/ThreadSpec.h"
 #include "lldb/Expression/ClangUserExpression.h"
@@ -41,7 +47,8 @@ BreakpointOptions::BreakpointOptions() :
     m_enabled (true),
     m_ignore_count (0),
     m_thread_spec_ap (NULL),
-    m_condition_ap()
+    m_condition_ap(),
+    m_condition_cache ()
 {
 }
 
@@ -55,7 +62,8 @@ BreakpointOptions::BreakpointOptions(const BreakpointOptions& rhs) :
     m_enabled (rhs.m_enabled),
     m_ignore_count (rhs.m_ignore_count),
     m_thread_spec_ap (NULL),
-    m_condition_ap (NULL)
+    m_condition_ap (NULL),
+    m_condition_cache ()
 {
     if (rhs.m_thread_spec_ap.get() != NULL)
         m_thread_spec_ap.reset (new ThreadSpec(*rhs.m_thread_spec_ap.get()));
@@ -78,6 +86,7 @@ BreakpointOptions::operator=(const BreakpointOptions& rhs)
         m_thread_spec_ap.reset(new ThreadSpec(*rhs.m_thread_spec_ap.get()));
     if (rhs.m_condition_ap.get())
         m_condition_ap.reset (new ClangUserExpression (rhs.m_condition_ap->GetUserText(), NULL, lldb::eLanguageTypeUnknown, ClangUserExpression::eResultTypeAny));
+    m_condition_cache.clear();
     return *this;
 }
 
@@ -151,7 +160,7 @@ BreakpointOptions::InvokeCallback (StoppointCallbackContext *context,
 }
 
 bool
-BreakpointOptions::HasCallback ()
+BreakpointOptions::HasCallback () const
 {
     return m_callback != BreakpointOptions::NullCallback;
 }
@@ -159,6 +168,7 @@ BreakpointOptions::HasCallback ()
 void 
 BreakpointOptions::SetCondition (const char *condition)
 {
+    m_condition_cache.clear();
     if (condition == NULL || condition[0] == '\0')
     {
         if (m_condition_ap.get())
@@ -179,6 +189,84 @@ BreakpointOptions::GetConditionText () const
         return NULL;
 }
 
+bool
+BreakpointOptions::ConditionSaysStop (ExecutionContext &exe_ctx, Error &error)
+{
+    error.Clear();
+    if (m_condition_ap.get() == NULL)
+        return true;
+
+    LogSP log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_BREAKPOINTS));
+
+    // The compiled condition refers to the variables that were in scope
+    // where it was parsed, so only reuse it for hits in the same block.
+    ModuleSP module_sp;
+    const void *scope = NULL;
+    StackFrame *frame = exe_ctx.GetFramePtr();
+    if (frame)
+    {
+        const SymbolContext &sc (frame->GetSymbolContext (eSymbolContextModule | eSymbolContextFunction | eSymbolContextBlock | eSymbolContextSymbol));
+        module_sp = sc.module_sp;
+        if (sc.block)
+            scope = sc.block;
+        else if (sc.function)
+            scope = sc.function;
+        else
+            scope = sc.symbol;
+    }
+
+    CachedCondition &cached_condition = m_condition_cache[scope];
+    // If the module went away, a new block may have been allocated where
+    // the old one was.
+    if (cached_condition.module_wp.lock() != module_sp)
+        cached_condition.expr_sp.reset();
+    cached_condition.module_wp = module_sp;
+
+    ValueObjectSP result_value_sp;
+    const bool discard_on_error = true;
+    ExecutionResults result_code = ClangUserExpression::EvaluateWithCache (exe_ctx,
+                                                                           eExecutionPolicyOnlyWhenNeeded,
+                                                                           lldb::eLanguageTypeUnknown,
+                                                                           ClangUserExpression::eResultTypeAny,
+                                                                           discard_on_error,
+                                                                           m_condition_ap->GetUserText(),
+                                                                           NULL,
+                                                                           cached_condition.expr_sp,
+                                                                           result_value_sp,
+                                                                           error);
+    if (!cached_condition.expr_sp)
+        m_condition_cache.erase (scope);
+
+    if (result_code != eExecutionCompleted)
+    {
+        if (error.Success())
+            error.SetErrorString ("couldn't evaluate the condition");
+        return true;
+    }
+
+    // Completing without a result isn't an error we need to report, we
+    // just stop.
+    error.Clear();
+    Scalar scalar_value;
+    if (result_value_sp && result_value_sp->ResolveValue (scalar_value))
+    {
+        const bool condition_is_true = scalar_value.ULongLong(1) != 0;
+        if (log)
+            log->Printf("Condition successfully evaluated, result is %s.", condition_is_true ? "true" : "false");
+        return condition_is_true;
+    }
+
+    if (log)
+        log->Printf("Failed to get an integer result from the expression.");
+    return true;
+}
+
+void
+BreakpointOptions::ClearConditionCache ()
+{
+    m_condition_cache.clear();
+}
+
 //------------------------------------------------------------------
 // Enabled/Ignore Count
 //------------------------------------------------------------------
@@ -18,6 +18,7 @@
 #include "lldb/Core/Log.h"
 #include "lldb/Core/StreamString.h"
 #include "lldb/Symbol/CompileUnit.h"
+#include "lldb/Symbol/LineTable.h"
 #include "lldb/Target/Target.h"
 #include "lldb/lldb-private-log.h"
 
@@ -33,7 +34,8 @@ BreakpointResolverFileRegex::BreakpointResolverFileRegex
     RegularExpression &regex
 ) :
     BreakpointResolver (bkpt, BreakpointResolver::FileLineResolver),
-    m_regex (regex)
+    m_regex (regex),
+    m_file_matches ()
 {
 }
 
@@ -59,11 +61,42 @@ BreakpointResolverFileRegex::SearchCallback
 
     CompileUnit *cu = context.comp_unit;
     FileSpec cu_file_spec = *(static_cast<FileSpec *>(cu));
-    std::vector<uint32_t> line_matches;
-    context.target_sp->GetSourceManager().FindLinesMatchingRegex(cu_file_spec, m_regex, 1, UINT32_MAX, line_matches); 
+
+    // A matching line without code gets a location on the next line that
+    // has some, so lines after the last one with code can never give us
+    // a location and don't need to be searched
+    uint32_t last_code_line = 0;
+    LineTable *line_table = cu->GetLineTable();
+    if (line_table)
+    {
+        // The line table entries point to the copy of the compile unit's
+        // file further on in the support files, see CompileUnit::FindLineEntry()
+        FileSpecList &support_files = cu->GetSupportFiles();
+        uint32_t file_idx = support_files.FindFileIndex (1, support_files.GetFileSpecAtIndex(0), true);
+        if (file_idx == UINT32_MAX)
+            file_idx = 0;
+        const FileSpec &line_file_spec = support_files.GetFileSpecAtIndex(file_idx);
+        const uint32_t num_line_entries = line_table->GetSize();
+        LineEntry line_entry;
+        for (uint32_t i = 0; i < num_line_entries; ++i)
+        {
+            if (line_table->GetLineEntryAtIndex (i, line_entry) &&
+                line_entry.line > last_code_line &&
+                line_entry.file == line_file_spec)
+                last_code_line = line_entry.line;
+        }
+    }
+    if (last_code_line == 0)
+        return eCallbackReturnContinue;
+
+    const std::vector<uint32_t> &line_matches = GetMatchingLines (context.target_sp->GetSourceManager(),
+                                                                 cu_file_spec,
+                                                                 last_code_line + 1);
     uint32_t num_matches = line_matches.size();
     for (int i = 0; i < num_matches; i++)
     {
+        if (line_matches[i] > last_code_line)
+            break;
         uint32_t start_idx = 0;
         bool exact = false;
         while (1)
@@ -114,6 +147,33 @@ BreakpointResolverFileRegex::SearchCallback
     return Searcher::eCallbackReturnContinue;
 }
 
+const std::vector<uint32_t> &
+BreakpointResolverFileRegex::GetMatchingLines (SourceManager &source_manager,
+                                               FileSpec &file_spec,
+                                               uint32_t end_line)
+{
+    FileMatches &file_matches = m_file_matches[file_spec];
+    const TimeValue mod_time (source_manager.GetFileModificationTime (file_spec));
+    if (file_matches.mod_time != mod_time)
+    {
+        // The file changed since we searched it, start over
+        file_matches.mod_time = mod_time;
+        file_matches.end_line = 1;
+        file_matches.match_lines.clear();
+    }
+
+    // Only search the lines this compile unit needs that earlier ones
+    // didn't
+    if (end_line > file_matches.end_line)
+    {
+        std::vector<uint32_t> new_match_lines;
+        source_manager.FindLinesMatchingRegex (file_spec, m_regex, file_matches.end_line, end_line, new_match_lines);
+        file_matches.match_lines.insert (file_matches.match_lines.end(), new_match_lines.begin(), new_match_lines.end());
+        file_matches.end_line = end_line;
+    }
+    return file_matches.match_lines;
+}
+
 Searcher::Depth
 BreakpointResolverFileRegex::GetDepth()
 {
@@ -65,6 +65,46 @@ BreakpointSite::ShouldStop (StoppointCallbackContext *context)
     return m_owners.ShouldStop (context);
 }
 
+bool
+BreakpointSite::IsTracepointSite ()
+{
+    const size_t owner_count = m_owners.GetSize();
+    if (owner_count == 0)
+        return false;
+    for (size_t i = 0; i < owner_count; i++)
+    {
+        if (!m_owners.GetByIndex(i)->GetBreakpoint().IsTracepoint())
+            return false;
+    }
+    return true;
+}
+
+void
+BreakpointSite::AddFilteredHits (uint32_t num_hits)
+{
+    for (uint32_t i=0; i<num_hits; ++i)
+        IncrementHitCount();
+    const size_t owner_count = m_owners.GetSize();
+    for (size_t i = 0; i < owner_count; i++)
+        m_owners.GetByIndex(i)->AddFilteredHits (num_hits);
+}
+
+bool
+BreakpointSite::TracepointWasHit (lldb::BreakpointLocationSP &loc_sp)
+{
+    IncrementHitCount();
+    loc_sp.reset();
+    const size_t owner_count = m_owners.GetSize();
+    for (size_t i = 0; i < owner_count; i++)
+    {
+        lldb::BreakpointLocationSP owner_sp (m_owners.GetByIndex(i));
+        // Every location counts the hit, like they do in ShouldStop.
+        if (owner_sp->TracepointWasHit() && !loc_sp)
+            loc_sp = owner_sp;
+    }
+    return loc_sp.get() != NULL;
+}
+
 bool
 BreakpointSite::IsBreakpointAtThisSite (lldb::break_id_t bp_id)
 {
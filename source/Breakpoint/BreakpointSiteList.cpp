@@ -20,7 +20,9 @@ using namespace lldb;
 using namespace lldb_private;
 
 BreakpointSiteList::BreakpointSiteList() :
-    m_bp_site_list()
+    m_bp_site_list(),
+    m_addr_index(),
+    m_id_index()
 {
 }
 
@@ -40,6 +42,7 @@ BreakpointSiteList::Add(const BreakpointSiteSP &bp)
     if (iter == m_bp_site_list.end())
     {
         m_bp_site_list.insert (iter, collection::value_type (bp_site_load_addr, bp));
+        AddToIndexes (bp);
         return bp->GetID();
     }
     else
@@ -48,6 +51,32 @@ BreakpointSiteList::Add(const BreakpointSiteSP &bp)
     }
 }
 
+// The DenseMap reserves the two largest addresses as its empty and
+// tombstone keys, sites at those addresses are only in the map.
+static inline bool
+AddressCanBeIndexed (lldb::addr_t addr)
+{
+    return addr < LLDB_INVALID_ADDRESS - 1;
+}
+
+void
+BreakpointSiteList::AddToIndexes (const BreakpointSiteSP &bp_site_sp)
+{
+    const lldb::addr_t addr = bp_site_sp->GetLoadAddress();
+    if (AddressCanBeIndexed (addr))
+        m_addr_index[addr] = bp_site_sp;
+    m_id_index[bp_site_sp->GetID()] = bp_site_sp;
+}
+
+void
+BreakpointSiteList::RemoveFromIndexes (const BreakpointSiteSP &bp_site_sp)
+{
+    const lldb::addr_t addr = bp_site_sp->GetLoadAddress();
+    if (AddressCanBeIndexed (addr))
+        m_addr_index.erase (addr);
+    m_id_index.erase (bp_site_sp->GetID());
+}
+
 bool
 BreakpointSiteList::ShouldStop (StoppointCallbackContext *context, lldb::break_id_t site_id)
 {
@@ -79,12 +108,9 @@ BreakpointSiteList::FindIDByAddress (lldb::addr_t addr)
 bool
 BreakpointSiteList::Remove (lldb::break_id_t break_id)
 {
-    collection::iterator pos = GetIDIterator(break_id);    // Predicate
-    if (pos != m_bp_site_list.end())
-    {
-        m_bp_site_list.erase(pos);
-        return true;
-    }
+    BreakpointSiteSP bp_site_sp (FindByID (break_id));
+    if (bp_site_sp)
+        return RemoveByAddress (bp_site_sp->GetLoadAddress());
     return false;
 }
 
@@ -94,6 +120,7 @@ BreakpointSiteList::RemoveByAddress (lldb::addr_t address)
     collection::iterator pos =  m_bp_site_list.find(address);
     if (pos != m_bp_site_list.end())
     {
+        RemoveFromIndexes (pos->second);
         m_bp_site_list.erase(pos);
         return true;
     }
@@ -135,8 +162,8 @@ BreakpointSiteSP
 BreakpointSiteList::FindByID (lldb::break_id_t break_id)
 {
     BreakpointSiteSP stop_sp;
-    collection::iterator pos = GetIDIterator(break_id);
-    if (pos != m_bp_site_list.end())
+    id_index::const_iterator pos = m_id_index.find(break_id);
+    if (pos != m_id_index.end())
         stop_sp = pos->second;
 
     return stop_sp;
@@ -146,8 +173,8 @@ const BreakpointSiteSP
 BreakpointSiteList::FindByID (lldb::break_id_t break_id) const
 {
     BreakpointSiteSP stop_sp;
-    collection::const_iterator pos = GetIDConstIterator(break_id);
-    if (pos != m_bp_site_list.end())
+    id_index::const_iterator pos = m_id_index.find(break_id);
+    if (pos != m_id_index.end())
         stop_sp = pos->second;
 
     return stop_sp;
@@ -158,6 +185,14 @@ BreakpointSiteList::FindByAddress (lldb::addr_t addr)
 {
     BreakpointSiteSP found_sp;
 
+    if (AddressCanBeIndexed (addr))
+    {
+        addr_index::const_iterator pos = m_addr_index.find(addr);
+        if (pos != m_addr_index.end())
+            found_sp = pos->second;
+        return found_sp;
+    }
+
     collection::iterator iter =  m_bp_site_list.find(addr);
     if (iter != m_bp_site_list.end())
         found_sp = iter->second;
@@ -167,9 +202,9 @@ BreakpointSiteList::FindByAddress (lldb::addr_t addr)
 bool
 BreakpointSiteList::BreakpointSiteContainsBreakpoint (lldb::break_id_t bp_site_id, lldb::break_id_t bp_id)
 {
-    collection::const_iterator pos = GetIDConstIterator(bp_site_id);
-    if (pos != m_bp_site_list.end())
-        pos->second->IsBreakpointAtThisSite (bp_id);
+    BreakpointSiteSP bp_site_sp (FindByID (bp_site_id));
+    if (bp_site_sp)
+        bp_site_sp->IsBreakpointAtThisSite (bp_id);
 
     return false;
 }
@@ -219,6 +254,16 @@ BreakpointSiteList::GetByIndex (uint32_t i) const
     return stop_sp;
 }
 
+size_t
+BreakpointSiteList::GetSites (std::vector<BreakpointSiteSP> &bp_sites) const
+{
+    bp_sites.reserve (bp_sites.size() + m_bp_site_list.size());
+    collection::const_iterator pos, end = m_bp_site_list.end();
+    for (pos = m_bp_site_list.begin(); pos != end; ++pos)
+        bp_sites.push_back (pos->second);
+    return m_bp_site_list.size();
+}
+
 bool
 BreakpointSiteList::FindInRange (lldb::addr_t lower_bound, lldb::addr_t upper_bound, BreakpointSiteList &bp_site_list) const
 {
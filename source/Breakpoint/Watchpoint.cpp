@@ -29,6 +29,7 @@ Watchpoint::Watchpoint (lldb::addr_t addr, size_t size, bool hardware) :
     m_enabled(false),
     m_is_hardware(hardware),
     m_is_watch_variable(false),
+    m_watch_variable_encoding(eEncodingInvalid),
     m_is_ephemeral(false),
     m_disabled_count(0),
     m_watch_read(0),
@@ -189,6 +190,18 @@ Watchpoint::SetWatchVariable(bool val)
     m_is_watch_variable = val;
 }
 
+lldb::Encoding
+Watchpoint::GetWatchVariableEncoding() const
+{
+    return m_watch_variable_encoding;
+}
+
+void
+Watchpoint::SetWatchVariableEncoding (lldb::Encoding encoding)
+{
+    m_watch_variable_encoding = encoding;
+}
+
 void
 Watchpoint::IncrementFalseAlarmsAndReviseHitCount()
 {
@@ -27,6 +27,7 @@
 #include "lldb/Target/StackFrame.h"
 #include "lldb/Target/Thread.h"
 #include "lldb/Target/ThreadSpec.h"
+#include "lldb/Target/TraceBuffer.h"
 
 #include <vector>
 
@@ -708,7 +709,9 @@ public:
             m_enable_value (false),
             m_name_passed (false),
             m_queue_passed (false),
-            m_condition_passed (false)
+            m_condition_passed (false),
+            m_tracepoint_passed (false),
+            m_tracepoint_value (false)
         {
         }
 
@@ -745,6 +748,16 @@ public:
                        error.SetErrorStringWithFormat ("invalid ignore count '%s'", option_arg);
                 }
                 break;
+                case 'P':
+                {
+                    bool success;
+                    m_tracepoint_value = Args::StringToBoolean (option_arg, false, &success);
+                    if (success)
+                        m_tracepoint_passed = true;
+                    else
+                        error.SetErrorStringWithFormat ("invalid boolean value '%s' passed for -P option", option_arg);
+                }
+                break;
                 case 't' :
                 {
                     if (option_arg[0] == '\0')
@@ -815,6 +828,7 @@ public:
             m_queue_passed = false;
             m_name_passed = false;
             m_condition_passed = false;
+            m_tracepoint_passed = false;
         }
         
         const OptionDefinition*
@@ -843,6 +857,8 @@ public:
         bool m_name_passed;
         bool m_queue_passed;
         bool m_condition_passed;
+        bool m_tracepoint_passed;
+        bool m_tracepoint_value;
 
     };
 
@@ -875,6 +891,11 @@ protected:
                 if (cur_bp_id.GetBreakpointID() != LLDB_INVALID_BREAK_ID)
                 {
                     Breakpoint *bp = target->GetBreakpointByID (cur_bp_id.GetBreakpointID()).get();
+
+                    // Being a tracepoint applies to all the locations of a breakpoint.
+                    if (m_options.m_tracepoint_passed)
+                        bp->SetTracepoint (m_options.m_tracepoint_value);
+
                     if (cur_bp_id.GetLocationID() != LLDB_INVALID_BREAK_ID)
                     {
                         BreakpointLocation *location = bp->FindLocationByID (cur_bp_id.GetLocationID()).get();
@@ -948,6 +969,7 @@ CommandObjectBreakpointModify::CommandOptions::g_option_table[] =
 { LLDB_OPT_SET_ALL, false, "condition",    'c', required_argument, NULL, 0, eArgTypeExpression, "The breakpoint stops only if this condition expression evaluates to true."},
 { LLDB_OPT_SET_1,   false, "enable",       'e', no_argument,       NULL, 0, eArgTypeNone, "Enable the breakpoint."},
 { LLDB_OPT_SET_2,   false, "disable",      'd', no_argument,       NULL, 0, eArgTypeNone, "Disable the breakpoint."},
+{ LLDB_OPT_SET_ALL, false, "tracepoint",   'P', required_argument, NULL, 0, eArgTypeBoolean, "Make the breakpoint a tracePoint, whose hits are recorded without stopping.  See \"breakpoint trace\" for the recorded hits."},
 { 0,                false, NULL,            0 , 0,                 NULL, 0,    eArgTypeNone, NULL }
 };
 
@@ -1654,6 +1676,143 @@ protected:
     }
 };
 
+//-------------------------------------------------------------------------
+// CommandObjectBreakpointTrace
+//-------------------------------------------------------------------------
+#pragma mark Trace
+
+class CommandObjectBreakpointTrace : public CommandObjectParsed
+{
+public:
+    CommandObjectBreakpointTrace (CommandInterpreter &interpreter) :
+        CommandObjectParsed (interpreter,
+                             "breakpoint trace",
+                             "Show the hits of tracepoints recorded in the current target, oldest first.  "
+                             "Use \"breakpoint modify --tracepoint true\" to make a breakpoint a tracepoint.",
+                             "breakpoint trace [<cmd-options>]"),
+        m_options (interpreter)
+    {
+    }
+
+    virtual
+    ~CommandObjectBreakpointTrace () {}
+
+    virtual Options *
+    GetOptions ()
+    {
+        return &m_options;
+    }
+
+    class CommandOptions : public Options
+    {
+    public:
+
+        CommandOptions (CommandInterpreter &interpreter) :
+            Options (interpreter),
+            m_count (0),
+            m_clear (false)
+        {
+        }
+
+        virtual
+        ~CommandOptions () {}
+
+        virtual Error
+        SetOptionValue (uint32_t option_idx, const char *option_arg)
+        {
+            Error error;
+            char short_option = (char) m_getopt_table[option_idx].val;
+
+            switch (short_option)
+            {
+                case 'c':
+                    m_count = Args::StringToUInt32 (option_arg, UINT32_MAX, 0);
+                    if (m_count == UINT32_MAX)
+                        error.SetErrorStringWithFormat ("invalid count '%s'", option_arg);
+                    break;
+                case 'C':
+                    m_clear = true;
+                    break;
+                default:
+                    error.SetErrorStringWithFormat ("unrecognized option '%c'", short_option);
+                    break;
+            }
+
+            return error;
+        }
+
+        void
+        OptionParsingStarting ()
+        {
+            m_count = 0;
+            m_clear = false;
+        }
+
+        const OptionDefinition *
+        GetDefinitions ()
+        {
+            return g_option_table;
+        }
+
+        // Options table: Required for subclasses of Options.
+
+        static OptionDefinition g_option_table[];
+
+        // Instance variables to hold the values for command options.
+
+        uint32_t m_count;
+        bool m_clear;
+    };
+
+protected:
+    virtual bool
+    DoExecute (Args& command, CommandReturnObject &result)
+    {
+        Target *target = m_interpreter.GetDebugger().GetSelectedTarget().get();
+        if (target == NULL)
+        {
+            result.AppendError ("Invalid target. No current target or breakpoints.");
+            result.SetStatus (eReturnStatusFailed);
+            return false;
+        }
+
+        TraceBuffer &trace_buffer = target->GetTraceBuffer();
+        if (m_options.m_clear)
+        {
+            trace_buffer.Clear();
+            result.SetStatus (eReturnStatusSuccessFinishNoResult);
+            return true;
+        }
+
+        std::vector<TraceBuffer::Record> records;
+        const size_t num_records = trace_buffer.GetRecords (records, m_options.m_count);
+        const uint64_t num_hits = trace_buffer.GetNumHits();
+
+        Stream &output_stream = result.GetOutputStream();
+        output_stream.Printf ("%llu tracepoint hits recorded, showing the last %zu:\n", num_hits, num_records);
+        for (size_t i = 0; i < num_records; ++i)
+            TraceBuffer::DumpRecord (output_stream, records[i]);
+        result.SetStatus (eReturnStatusSuccessFinishResult);
+        return true;
+    }
+
+private:
+    CommandOptions m_options;
+};
+
+#pragma mark Trace::CommandOptions
+OptionDefinition
+CommandObjectBreakpointTrace::CommandOptions::g_option_table[] =
+{
+    { LLDB_OPT_SET_1, false, "count", 'c', required_argument, NULL, 0, eArgTypeCount,
+        "Show only this many of the most recent hits." },
+
+    { LLDB_OPT_SET_2, false, "clear", 'C', no_argument, NULL, 0, eArgTypeNone,
+        "Discard the recorded hits." },
+
+    { 0, false, NULL, 0, 0, NULL, 0, eArgTypeNone, NULL }
+};
+
 //-------------------------------------------------------------------------
 // CommandObjectMultiwordBreakpoint
 //-------------------------------------------------------------------------
@@ -1673,6 +1832,7 @@ CommandObjectMultiwordBreakpoint::CommandObjectMultiwordBreakpoint (CommandInter
     CommandObjectSP set_command_object (new CommandObjectBreakpointSet (interpreter));
     CommandObjectSP command_command_object (new CommandObjectBreakpointCommand (interpreter));
     CommandObjectSP modify_command_object (new CommandObjectBreakpointModify(interpreter));
+    CommandObjectSP trace_command_object (new CommandObjectBreakpointTrace (interpreter));
 
     list_command_object->SetCommandName ("breakpoint list");
     enable_command_object->SetCommandName("breakpoint enable");
@@ -1682,6 +1842,7 @@ CommandObjectMultiwordBreakpoint::CommandObjectMultiwordBreakpoint (CommandInter
     set_command_object->SetCommandName("breakpoint set");
     command_command_object->SetCommandName ("breakpoint command");
     modify_command_object->SetCommandName ("breakpoint modify");
+    trace_command_object->SetCommandName ("breakpoint trace");
 
     LoadSubCommand ("list",       list_command_object);
     LoadSubCommand ("enable",     enable_command_object);
@@ -1691,6 +1852,7 @@ CommandObjectMultiwordBreakpoint::CommandObjectMultiwordBreakpoint (CommandInter
     LoadSubCommand ("set",        set_command_object);
     LoadSubCommand ("command",    command_command_object);
     LoadSubCommand ("modify",     modify_command_object);
+    LoadSubCommand ("trace",      trace_command_object);
 }
 
 CommandObjectMultiwordBreakpoint::~CommandObjectMultiwordBreakpoint ()
@@ -380,12 +380,25 @@ protected:
 
         Stream &s = result.GetOutputStream();
 
+        // All the variables share one trip into the script interpreter for their formatters
+        ScriptInterpreter::Batch script_batch (&m_interpreter);
+
         bool get_file_globals = true;
         
         // Be careful about the stack frame, if any summary formatter runs code, it might clear the StackFrameList
         // for the thread.  So hold onto a shared pointer to the frame so it stays alive.
         
-        VariableList *variable_list = frame->GetVariableList (get_file_globals);
+        VariableListSP scope_variable_list_sp;
+        VariableList *variable_list = NULL;
+        if (command.GetArgumentCount() > 0)
+            variable_list = frame->GetVariableList (get_file_globals);
+        else
+        {
+            // Only the variables that are in scope get shown, so don't
+            // parse the blocks of the function that don't contain the PC
+            scope_variable_list_sp = frame->GetScopeVariableList (get_file_globals);
+            variable_list = scope_variable_list_sp.get();
+        }
 
         VariableSP var_sp;
         ValueObjectSP valobj_sp;
@@ -19,6 +19,7 @@
 #include "lldb/Core/Debugger.h"
 #include "lldb/Host/FileSpec.h"
 #include "lldb/Core/Log.h"
+#include "lldb/Core/LogBuffer.h"
 #include "lldb/Core/Module.h"
 #include "lldb/Interpreter/Options.h"
 #include "lldb/Core/RegularExpression.h"
@@ -144,6 +145,7 @@ public:
             case 'T':  log_options |= LLDB_LOG_OPTION_PREPEND_TIMESTAMP;      break;
             case 'p':  log_options |= LLDB_LOG_OPTION_PREPEND_PROC_AND_THREAD;break;
             case 'n':  log_options |= LLDB_LOG_OPTION_PREPEND_THREAD_NAME;    break;
+            case 'b':  log_options |= LLDB_LOG_OPTION_BINARY;                 break;
             default:
                 error.SetErrorStringWithFormat ("unrecognized option '%c'", short_option);
                 break;
@@ -215,6 +217,7 @@ CommandObjectLogEnable::CommandOptions::g_option_table[] =
 { LLDB_OPT_SET_1, false, "timestamp",  'T', no_argument,       NULL, 0, eArgTypeNone,       "Prepend all log lines with a timestamp." },
 { LLDB_OPT_SET_1, false, "pid-tid",    'p', no_argument,       NULL, 0, eArgTypeNone,       "Prepend all log lines with the process and thread ID that generates the log line." },
 { LLDB_OPT_SET_1, false, "thread-name",'n', no_argument,       NULL, 0, eArgTypeNone,       "Prepend all log lines with the thread name for the thread that generates the log line." },
+{ LLDB_OPT_SET_1, false, "binary",     'b', no_argument,       NULL, 0, eArgTypeNone,       "Record log lines into per-thread binary buffers without formatting them, use \"log dump\" to see them." },
 { 0, false, NULL,                       0,  0,                 NULL, 0, eArgTypeNone,       NULL }
 };
 
@@ -374,6 +377,136 @@ protected:
     }
 };
 
+class CommandObjectLogDump : public CommandObjectParsed
+{
+public:
+    //------------------------------------------------------------------
+    // Constructors and Destructors
+    //------------------------------------------------------------------
+    CommandObjectLogDump(CommandInterpreter &interpreter) :
+        CommandObjectParsed (interpreter,
+                             "log dump",
+                             "Format and show the log lines recorded by logs enabled with \"log enable --binary\".",
+                             NULL),
+        m_options (interpreter)
+    {
+    }
+
+    virtual
+    ~CommandObjectLogDump()
+    {
+    }
+
+    Options *
+    GetOptions ()
+    {
+        return &m_options;
+    }
+
+    class CommandOptions : public Options
+    {
+    public:
+
+        CommandOptions (CommandInterpreter &interpreter) :
+            Options (interpreter),
+            log_file (),
+            clear (false)
+        {
+        }
+
+        virtual
+        ~CommandOptions ()
+        {
+        }
+
+        virtual Error
+        SetOptionValue (uint32_t option_idx, const char *option_arg)
+        {
+            Error error;
+            char short_option = (char) m_getopt_table[option_idx].val;
+
+            switch (short_option)
+            {
+            case 'f':  log_file = option_arg;   break;
+            case 'c':  clear = true;            break;
+            default:
+                error.SetErrorStringWithFormat ("unrecognized option '%c'", short_option);
+                break;
+            }
+
+            return error;
+        }
+
+        void
+        OptionParsingStarting ()
+        {
+            log_file.clear();
+            clear = false;
+        }
+
+        const OptionDefinition*
+        GetDefinitions ()
+        {
+            return g_option_table;
+        }
+
+        // Options table: Required for subclasses of Options.
+
+        static OptionDefinition g_option_table[];
+
+        // Instance variables to hold the values for command options.
+
+        std::string log_file;
+        bool clear;
+    };
+
+protected:
+    virtual bool
+    DoExecute (Args& args,
+             CommandReturnObject &result)
+    {
+        if (args.GetArgumentCount() != 0)
+        {
+            result.AppendErrorWithFormat("%s takes no arguments.\n", m_cmd_name.c_str());
+            result.SetStatus (eReturnStatusFailed);
+            return false;
+        }
+
+        size_t num_records = 0;
+        if (m_options.log_file.empty())
+        {
+            num_records = LogBuffer::Dump (result.GetOutputStream());
+        }
+        else
+        {
+            StreamFile log_file (m_options.log_file.c_str());
+            if (!log_file.GetFile().IsValid())
+            {
+                result.AppendErrorWithFormat("unable to open '%s' for writing.\n", m_options.log_file.c_str());
+                result.SetStatus (eReturnStatusFailed);
+                return false;
+            }
+            num_records = LogBuffer::Dump (log_file);
+            result.AppendMessageWithFormat ("%zu log lines written to '%s'.\n", num_records, m_options.log_file.c_str());
+        }
+
+        if (m_options.clear)
+            LogBuffer::Clear();
+        result.SetStatus (eReturnStatusSuccessFinishResult);
+        return result.Succeeded();
+    }
+
+    CommandOptions m_options;
+};
+
+OptionDefinition
+CommandObjectLogDump::CommandOptions::g_option_table[] =
+{
+{ LLDB_OPT_SET_1, false, "file",       'f', required_argument, NULL, 0, eArgTypeFilename,   "Write the log lines to this file instead of showing them."},
+{ LLDB_OPT_SET_1, false, "clear",      'c', no_argument,       NULL, 0, eArgTypeNone,       "Throw away the recorded log lines after dumping them." },
+{ 0, false, NULL,                       0,  0,                 NULL, 0, eArgTypeNone,       NULL }
+};
+
 class CommandObjectLogTimer : public CommandObjectParsed
 {
 public:
@@ -383,8 +516,8 @@ public:
     CommandObjectLogTimer(CommandInterpreter &interpreter) :
         CommandObjectParsed (interpreter,
                            "log timers",
-                           "Enable, disable, dump, and reset LLDB internal performance timers.",
-                           "log timers < enable <depth> | disable | dump | increment <bool> | reset >")
+                           "Enable, disable, dump, reset and record LLDB internal performance timers. \"record\" writes when each timer starts and stops on every thread to a Chrome trace file once \"stop\" is given.",
+                           "log timers < enable <depth> | disable | dump | increment <bool> | reset | record <file> | stop >")
     {
     }
 
@@ -412,6 +545,8 @@ protected:
             }
             else if (strcasecmp(sub_command, "disable") == 0)
             {
+                if (Timer::IsRecording())
+                    StopRecording (result);
                 Timer::DumpCategoryTimes (&result.GetOutputStream());
                 Timer::SetDisplayDepth (0);
                 result.SetStatus(eReturnStatusSuccessFinishResult);
@@ -426,6 +561,11 @@ protected:
                 Timer::ResetCategoryTimes ();
                 result.SetStatus(eReturnStatusSuccessFinishResult);
             }
+            else if (strcasecmp(sub_command, "stop") == 0)
+            {
+                if (!StopRecording (result))
+                    return false;
+            }
 
         }
         else if (argc == 2)
@@ -444,7 +584,22 @@ protected:
                 else
                     result.AppendError("Could not convert enable depth to an unsigned integer.");
             }
-            if (strcasecmp(sub_command, "increment") == 0)
+            else if (strcasecmp(sub_command, "record") == 0)
+            {
+                const char *path = args.GetArgumentAtIndex(1);
+                Error error (Timer::StartRecording (path));
+                if (error.Success())
+                {
+                    result.AppendMessageWithFormat ("Recording timers, use \"log timers stop\" to write them to '%s'.\n", path);
+                    result.SetStatus(eReturnStatusSuccessFinishNoResult);
+                }
+                else
+                {
+                    result.AppendError (error.AsCString());
+                    return false;
+                }
+            }
+            else if (strcasecmp(sub_command, "increment") == 0)
             {
                 bool success;
                 bool increment = Args::StringToBoolean(args.GetArgumentAtIndex(1), false, &success);
@@ -465,6 +620,24 @@ protected:
         }
         return result.Succeeded();
     }
+
+    bool
+    StopRecording (CommandReturnObject &result)
+    {
+        size_t num_events = 0;
+        Error error (Timer::StopRecording (num_events));
+        if (error.Success())
+        {
+            result.AppendMessageWithFormat ("%zu timer events written.\n", num_events);
+            result.SetStatus(eReturnStatusSuccessFinishResult);
+        }
+        else
+        {
+            result.AppendError (error.AsCString());
+            result.SetStatus(eReturnStatusFailed);
+        }
+        return result.Succeeded();
+    }
 };
 
 //----------------------------------------------------------------------
@@ -479,6 +652,7 @@ CommandObjectLog::CommandObjectLog(CommandInterpreter &interpreter) :
     LoadSubCommand ("enable",  CommandObjectSP (new CommandObjectLogEnable (interpreter)));
     LoadSubCommand ("disable", CommandObjectSP (new CommandObjectLogDisable (interpreter)));
     LoadSubCommand ("list",    CommandObjectSP (new CommandObjectLogList (interpreter)));
+    LoadSubCommand ("dump",    CommandObjectSP (new CommandObjectLogDump (interpreter)));
     LoadSubCommand ("timers",  CommandObjectSP (new CommandObjectLogTimer (interpreter)));
 }
 
@@ -19,6 +19,7 @@
 #include "lldb/Core/Module.h"
 #include "lldb/Core/StreamString.h"
 #include "lldb/Core/ValueObjectMemory.h"
+#include "lldb/Host/ThreadPool.h"
 #include "lldb/Interpreter/Args.h"
 #include "lldb/Interpreter/CommandReturnObject.h"
 #include "lldb/Interpreter/CommandInterpreter.h"
@@ -280,7 +281,63 @@ public:
     bool m_force;
 };
 
+// Binary dumps to a file are read and written this many bytes at a time
+#define MEMORY_DUMP_CHUNK_SIZE (1024 * 1024)
+// Without memory region information, a failed read skips ahead to the
+// next boundary of this size
+#define MEMORY_DUMP_PAGE_SIZE 4096
 
+struct MemoryDumpWrite
+{
+    File *file;
+    const uint8_t *bytes;
+    size_t byte_size;
+    off_t skip;             // Bytes of unreadable memory to skip before writing
+    bool append;
+    Error error;
+};
+
+// Leave room for byte_size bytes of memory that couldn't be read. Seeking
+// past them leaves a hole that reads back as zeros once something is
+// written after it; writes to a file opened for appending always go to
+// its end, so zeros are written instead.
+static Error
+SkipMemoryDumpBytes (File &file, off_t byte_size, bool append)
+{
+    if (!append)
+        return file.SeekFromCurrent (byte_size);
+
+    static const uint8_t g_zeros[4096] = { 0 };
+    Error error;
+    while (byte_size > 0 && error.Success())
+    {
+        size_t num_bytes = std::min<off_t> (byte_size, sizeof(g_zeros));
+        error = file.Write (g_zeros, num_bytes);
+        if (num_bytes == 0)
+            break;
+        byte_size -= num_bytes;
+    }
+    return error;
+}
+
+static void
+WriteMemoryDumpChunk (void *baton)
+{
+    MemoryDumpWrite *chunk_write = (MemoryDumpWrite *)baton;
+    if (chunk_write->skip > 0)
+    {
+        chunk_write->error = SkipMemoryDumpBytes (*chunk_write->file, chunk_write->skip, chunk_write->append);
+        if (chunk_write->error.Fail())
+            return;
+    }
+    size_t bytes_written = chunk_write->byte_size;
+    if (bytes_written > 0)
+    {
+        chunk_write->error = chunk_write->file->Write (chunk_write->bytes, bytes_written);
+        if (chunk_write->error.Success() && bytes_written != chunk_write->byte_size)
+            chunk_write->error.SetErrorString ("short write");
+    }
+}
 
 //----------------------------------------------------------------------
 // Read memory from the inferior process
@@ -640,6 +697,13 @@ protected:
             return false;
         }
         
+        Process *process = exe_ctx.GetProcessPtr();
+        if (m_memory_options.m_output_as_binary &&
+            m_outfile_options.GetFile().GetCurrentValue() &&
+            !clang_ast_type.GetOpaqueQualType() &&
+            process && process->IsAlive())
+            return DumpBinaryMemoryToFile (process, addr, total_byte_size, result);
+
         DataBufferSP data_sp;
         size_t bytes_read = 0;
         if (!clang_ast_type.GetOpaqueQualType())
@@ -799,6 +863,178 @@ protected:
         return true;
     }
 
+    //------------------------------------------------------------------
+    // Write [addr, addr + total_byte_size) to the output file without
+    // holding all of it in memory. Each chunk is written on the shared
+    // thread pool while the next one is read from the process. Regions
+    // the process says are unreadable are skipped without reading them
+    // and come out as zeros, so every byte is at its offset from addr.
+    //------------------------------------------------------------------
+    bool
+    DumpBinaryMemoryToFile (Process *process,
+                            lldb::addr_t addr,
+                            size_t total_byte_size,
+                            CommandReturnObject &result)
+    {
+        char path[PATH_MAX];
+        m_outfile_options.GetFile().GetCurrentValue().GetPath (path, sizeof(path));
+
+        uint32_t open_options = File::eOpenOptionWrite | File::eOpenOptionCanCreate;
+        const bool append = m_outfile_options.GetAppend().GetCurrentValue();
+        if (append)
+            open_options |= File::eOpenOptionAppend;
+        else
+            open_options |= File::eOpenOptionTruncate;
+
+        File file;
+        if (file.Open (path, open_options).Fail())
+        {
+            result.AppendErrorWithFormat("Failed to open file '%s' for %s.\n", path, append ? "append" : "write");
+            result.SetStatus(eReturnStatusFailed);
+            return false;
+        }
+
+        const size_t chunk_size = std::min<size_t> (total_byte_size, MEMORY_DUMP_CHUNK_SIZE);
+        DataBufferHeap first_buffer (chunk_size, 0);
+        DataBufferHeap second_buffer (chunk_size, 0);
+        DataBufferHeap *buffers[2] = { &first_buffer, &second_buffer };
+        MemoryDumpWrite writes[2];
+        uint32_t buffer_idx = 0;
+        ThreadPool::TaskGroup write_group (ThreadPool::GetSharedThreadPool());
+        bool write_pending = false;
+
+        const lldb::addr_t end_addr = addr + total_byte_size;
+        lldb::addr_t curr_addr = addr;
+        uint64_t bytes_written = 0;
+        uint64_t bytes_skipped = 0;
+        off_t pending_skip = 0;
+        bool have_region_info = true;
+        MemoryRegionInfo region_info;
+        Error error;
+        while (curr_addr < end_addr)
+        {
+            // Stop reading at the end of the memory region so a chunk never
+            // straddles readable and unreadable memory
+            lldb::addr_t chunk_end = std::min<lldb::addr_t> (end_addr, curr_addr + chunk_size);
+            if (have_region_info)
+            {
+                region_info.Clear();
+                if (process->GetMemoryRegionInfo (curr_addr, region_info).Success())
+                {
+                    const lldb::addr_t region_end = region_info.GetRange().GetRangeEnd();
+                    if (region_end > curr_addr && region_end < chunk_end)
+                        chunk_end = region_end;
+                    if (region_info.GetReadable() == MemoryRegionInfo::eNo)
+                    {
+                        if (region_end <= curr_addr)
+                            chunk_end = std::min<lldb::addr_t> (end_addr, (curr_addr + MEMORY_DUMP_PAGE_SIZE) & ~((lldb::addr_t)MEMORY_DUMP_PAGE_SIZE - 1));
+                        bytes_skipped += chunk_end - curr_addr;
+                        pending_skip += chunk_end - curr_addr;
+                        curr_addr = chunk_end;
+                        continue;
+                    }
+                }
+                else
+                    have_region_info = false;
+            }
+
+            DataBufferHeap &buffer = *buffers[buffer_idx];
+            Error read_error;
+            const size_t bytes_read = process->ReadMemory (curr_addr, buffer.GetBytes(), chunk_end - curr_addr, read_error);
+
+            // The other buffer has to be written before its task can be
+            // reused
+            if (write_pending)
+            {
+                write_group.Wait();
+                write_pending = false;
+                const MemoryDumpWrite &prev_write = writes[buffer_idx ^ 1];
+                if (prev_write.error.Fail())
+                {
+                    error = prev_write.error;
+                    break;
+                }
+            }
+
+            if (bytes_read > 0)
+            {
+                MemoryDumpWrite &chunk_write = writes[buffer_idx];
+                chunk_write.file = &file;
+                chunk_write.bytes = buffer.GetBytes();
+                chunk_write.byte_size = bytes_read;
+                chunk_write.skip = pending_skip;
+                chunk_write.append = append;
+                chunk_write.error.Clear();
+                write_group.AddTask (WriteMemoryDumpChunk, &chunk_write);
+                write_pending = true;
+                pending_skip = 0;
+                bytes_written += bytes_read;
+                curr_addr += bytes_read;
+                buffer_idx ^= 1;
+            }
+
+            if (curr_addr < chunk_end)
+            {
+                // The rest of the chunk couldn't be read, without region
+                // information skip to the next page
+                lldb::addr_t skip_end = chunk_end;
+                if (!have_region_info)
+                    skip_end = std::min<lldb::addr_t> (chunk_end, (curr_addr + MEMORY_DUMP_PAGE_SIZE) & ~((lldb::addr_t)MEMORY_DUMP_PAGE_SIZE - 1));
+                bytes_skipped += skip_end - curr_addr;
+                pending_skip += skip_end - curr_addr;
+                curr_addr = skip_end;
+            }
+        }
+
+        write_group.Wait();
+        if (error.Success() && write_pending)
+            error = writes[buffer_idx ^ 1].error;
+
+        // Unreadable memory at the end has to be written out too, or the
+        // file comes out short
+        if (error.Success() && pending_skip > 0)
+        {
+            if (!append && pending_skip > 1)
+            {
+                off_t offset = pending_skip - 1;
+                error = file.SeekFromCurrent (offset);
+                pending_skip = 1;
+            }
+            if (error.Success())
+                error = SkipMemoryDumpBytes (file, pending_skip, true);
+        }
+        file.Close();
+
+        if (error.Fail())
+        {
+            result.AppendErrorWithFormat("Failed to write to '%s': %s.\n", path, error.AsCString());
+            result.SetStatus(eReturnStatusFailed);
+            return false;
+        }
+        if (bytes_written == 0)
+        {
+            result.AppendErrorWithFormat("failed to read memory from 0x%llx.\n", addr);
+            result.SetStatus(eReturnStatusFailed);
+            return false;
+        }
+
+        result.GetOutputStream().Printf ("%llu bytes %s to '%s'\n",
+                                         bytes_written,
+                                         append ? "appended" : "written",
+                                         path);
+        if (bytes_skipped > 0)
+            result.AppendWarningWithFormat("%llu unreadable bytes were written as zeros.\n", bytes_skipped);
+
+        m_next_addr = end_addr;
+        m_prev_byte_size = total_byte_size;
+        m_prev_format_options = m_format_options;
+        m_prev_memory_options = m_memory_options;
+        m_prev_outfile_options = m_outfile_options;
+        m_prev_varobj_options = m_varobj_options;
+        result.SetStatus(eReturnStatusSuccessFinishResult);
+        return true;
+    }
+
     OptionGroupOptions m_option_group;
     OptionGroupFormat m_format_options;
     OptionGroupReadMemory m_memory_options;
@@ -1263,6 +1499,200 @@ protected:
 };
 
 
+//----------------------------------------------------------------------
+// Find a byte pattern in the memory of the inferior process
+//----------------------------------------------------------------------
+class CommandObjectMemoryFind : public CommandObjectParsed
+{
+public:
+
+    class CommandOptions : public Options
+    {
+    public:
+        CommandOptions (CommandInterpreter &interpreter) :
+            Options(interpreter)
+        {
+            OptionParsingStarting();
+        }
+
+        ~CommandOptions ()
+        {
+        }
+
+        Error
+        SetOptionValue (uint32_t option_idx, const char *option_arg)
+        {
+            Error error;
+            const char short_option = g_option_table[option_idx].short_option;
+            switch (short_option)
+            {
+            case 's':
+                m_pattern = option_arg;
+                break;
+
+            case 'x':
+                {
+                    // The bytes are given in memory order, like "efbeadde"
+                    const size_t hex_len = strlen (option_arg);
+                    m_pattern.clear();
+                    for (size_t i = 0; i + 1 < hex_len; i += 2)
+                    {
+                        const char hex_byte[3] = { option_arg[i], option_arg[i+1], '\0' };
+                        bool success = false;
+                        const uint64_t byte = Args::StringToUInt64 (hex_byte, 0, 16, &success);
+                        if (!success)
+                            break;
+                        m_pattern.push_back ((char)byte);
+                    }
+                    if (hex_len == 0 || (hex_len & 1) || m_pattern.size() * 2 != hex_len)
+                        error.SetErrorStringWithFormat("invalid hex byte string: '%s'", option_arg);
+                }
+                break;
+
+            case 'c':
+                m_count = Args::StringToUInt32 (option_arg, 0, 0);
+                if (m_count == 0)
+                    error.SetErrorStringWithFormat("invalid count: '%s'", option_arg);
+                break;
+
+            default:
+                error.SetErrorStringWithFormat("unrecognized short option '%c'", short_option);
+                break;
+            }
+
+            return error;
+        }
+
+        void
+        OptionParsingStarting ()
+        {
+            m_pattern.clear();
+            m_count = 1;
+        }
+
+        const OptionDefinition*
+        GetDefinitions ()
+        {
+            return g_option_table;
+        }
+        static OptionDefinition g_option_table[];
+
+        // Instance variables to hold the values for command options.
+        std::string m_pattern;
+        uint32_t m_count;
+    };
+
+    CommandObjectMemoryFind (CommandInterpreter &interpreter) :
+        CommandObjectParsed (interpreter,
+                             "memory find",
+                             "Find a string or a sequence of bytes in the memory of the process being debugged.",
+                             NULL,
+                             eFlagProcessMustBeLaunched | eFlagProcessMustBePaused),
+        m_options (interpreter)
+    {
+        CommandArgumentEntry arg1;
+        CommandArgumentEntry arg2;
+        CommandArgumentData start_addr_arg;
+        CommandArgumentData end_addr_arg;
+
+        start_addr_arg.arg_type = eArgTypeStartAddress;
+        start_addr_arg.arg_repetition = eArgRepeatPlain;
+        arg1.push_back (start_addr_arg);
+
+        end_addr_arg.arg_type = eArgTypeEndAddress;
+        end_addr_arg.arg_repetition = eArgRepeatPlain;
+        arg2.push_back (end_addr_arg);
+
+        m_arguments.push_back (arg1);
+        m_arguments.push_back (arg2);
+    }
+
+    ~CommandObjectMemoryFind ()
+    {
+    }
+
+    Options *
+    GetOptions ()
+    {
+        return &m_options;
+    }
+
+protected:
+    bool
+    DoExecute (Args& command, CommandReturnObject &result)
+    {
+        Process *process = m_interpreter.GetExecutionContext().GetProcessPtr();
+        if (process == NULL)
+        {
+            result.AppendError("need a process to search memory");
+            result.SetStatus(eReturnStatusFailed);
+            return false;
+        }
+
+        if (command.GetArgumentCount() != 2)
+        {
+            result.AppendErrorWithFormat ("%s takes a start address and an end address.\n", m_cmd_name.c_str());
+            result.SetStatus(eReturnStatusFailed);
+            return false;
+        }
+
+        if (m_options.m_pattern.empty())
+        {
+            result.AppendError("specify a string with --string or bytes with --hex to search for");
+            result.SetStatus(eReturnStatusFailed);
+            return false;
+        }
+
+        lldb::addr_t start_addr = Args::StringToUInt64(command.GetArgumentAtIndex(0), LLDB_INVALID_ADDRESS, 0);
+        lldb::addr_t end_addr = Args::StringToUInt64(command.GetArgumentAtIndex(1), LLDB_INVALID_ADDRESS, 0);
+        if (start_addr == LLDB_INVALID_ADDRESS || end_addr == LLDB_INVALID_ADDRESS || start_addr >= end_addr)
+        {
+            result.AppendErrorWithFormat("invalid address range '%s' - '%s'.\n", command.GetArgumentAtIndex(0), command.GetArgumentAtIndex(1));
+            result.SetStatus(eReturnStatusFailed);
+            return false;
+        }
+
+        const uint8_t *pattern = (const uint8_t *)m_options.m_pattern.data();
+        const size_t pattern_size = m_options.m_pattern.size();
+        Stream &strm = result.GetOutputStream();
+        uint32_t num_matches = 0;
+        lldb::addr_t addr = start_addr;
+        while (num_matches < m_options.m_count && addr < end_addr)
+        {
+            Error error;
+            const lldb::addr_t match_addr = process->FindInMemory (addr, end_addr, pattern, pattern_size, error);
+            if (error.Fail())
+            {
+                result.AppendErrorWithFormat("memory search failed: %s\n", error.AsCString());
+                result.SetStatus(eReturnStatusFailed);
+                return false;
+            }
+            if (match_addr == LLDB_INVALID_ADDRESS)
+                break;
+            strm.Printf("0x%llx\n", match_addr);
+            ++num_matches;
+            addr = match_addr + 1;
+        }
+
+        if (num_matches == 0)
+            strm.PutCString("pattern not found\n");
+        result.SetStatus(eReturnStatusSuccessFinishResult);
+        return true;
+    }
+
+    CommandOptions m_options;
+};
+
+OptionDefinition
+CommandObjectMemoryFind::CommandOptions::g_option_table[] =
+{
+{ LLDB_OPT_SET_1, true,  "string", 's', required_argument, NULL, 0, eArgTypeValue, "The string to search for."},
+{ LLDB_OPT_SET_2, true,  "hex",    'x', required_argument, NULL, 0, eArgTypeValue, "The bytes to search for as a hex string in memory order, like \"efbeadde\"."},
+{ LLDB_OPT_SET_ALL, false, "count", 'c', required_argument, NULL, 0, eArgTypeCount, "The number of matches to show, the first one is shown by default."},
+{ 0, false, NULL, 0, 0, NULL, 0, eArgTypeNone, NULL }
+};
+
+
 //-------------------------------------------------------------------------
 // CommandObjectMemory
 //-------------------------------------------------------------------------
@@ -1273,6 +1703,7 @@ CommandObjectMemory::CommandObjectMemory (CommandInterpreter &interpreter) :
                             "A set of commands for operating on memory.",
                             "memory <subcommand> [<subcommand-options>]")
 {
+    LoadSubCommand ("find",  CommandObjectSP (new CommandObjectMemoryFind (interpreter)));
     LoadSubCommand ("read",  CommandObjectSP (new CommandObjectMemoryRead (interpreter)));
     LoadSubCommand ("write", CommandObjectSP (new CommandObjectMemoryWrite (interpreter)));
 }
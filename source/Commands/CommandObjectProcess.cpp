@@ -354,6 +354,10 @@ public:
                     attach_info.SetContinueOnceAttached(true);
                     break;
 
+                case 'd':
+                    attach_info.SetDeferSymbolLoading(true);
+                    break;
+
                 case 'p':   
                     {
                         lldb::pid_t pid = Args::StringToUInt32 (option_arg, LLDB_INVALID_PROCESS_ID, 0, &success);
@@ -653,6 +657,7 @@ OptionDefinition
 CommandObjectProcessAttach::CommandOptions::g_option_table[] =
 {
 { LLDB_OPT_SET_ALL, false, "continue",'c', no_argument,         NULL, 0, eArgTypeNone,         "Immediately continue the process once attached."},
+{ LLDB_OPT_SET_ALL, false, "defer-symbols",'d', no_argument,    NULL, 0, eArgTypeNone,         "Stop as soon as the threads and images are known, and load shared library symbols in the background. Breakpoints in shared libraries are resolved when the process is resumed."},
 { LLDB_OPT_SET_ALL, false, "plugin",  'P', required_argument,   NULL, 0, eArgTypePlugin,       "Name of the process plugin you want to use."},
 { LLDB_OPT_SET_1,   false, "pid",     'p', required_argument,   NULL, 0, eArgTypePid,          "The process ID of an existing process to attach to."},
 { LLDB_OPT_SET_2,   false, "name",    'n', required_argument,   NULL, 0, eArgTypeProcessName,  "The name of the process to attach to."},
@@ -1463,6 +1468,118 @@ public:
     }
 };
 
+//-------------------------------------------------------------------------
+// CommandObjectProcessCacheStats
+//-------------------------------------------------------------------------
+#pragma mark CommandObjectProcessCacheStats
+
+class CommandObjectProcessCacheStats : public CommandObjectParsed
+{
+public:
+    CommandObjectProcessCacheStats (CommandInterpreter &interpreter) :
+        CommandObjectParsed (interpreter,
+                             "process cache stats",
+                             "Show statistics for the memory cache of the current process.",
+                             "process cache stats",
+                             eFlagProcessMustBeLaunched)
+    {
+    }
+
+    ~CommandObjectProcessCacheStats ()
+    {
+    }
+
+protected:
+    bool
+    DoExecute (Args& command,
+               CommandReturnObject &result)
+    {
+        Process *process = m_interpreter.GetExecutionContext().GetProcessPtr();
+        if (process == NULL)
+        {
+            result.AppendError ("No process.");
+            result.SetStatus (eReturnStatusFailed);
+            return false;
+        }
+
+        if (command.GetArgumentCount() != 0)
+        {
+            result.AppendErrorWithFormat ("'%s' takes no arguments.\n", m_cmd_name.c_str());
+            result.SetStatus (eReturnStatusFailed);
+            return false;
+        }
+
+        process->GetMemoryCache().DumpStatistics (result.GetOutputStream());
+        result.SetStatus (eReturnStatusSuccessFinishResult);
+        return result.Succeeded();
+    }
+};
+
+//-------------------------------------------------------------------------
+// CommandObjectProcessCache
+//-------------------------------------------------------------------------
+#pragma mark CommandObjectProcessCache
+
+class CommandObjectProcessCache : public CommandObjectMultiword
+{
+public:
+    CommandObjectProcessCache (CommandInterpreter &interpreter) :
+        CommandObjectMultiword (interpreter,
+                                "process cache",
+                                "A set of commands for inspecting the memory cache of the current process.",
+                                "process cache <subcommand> [<subcommand-options>]")
+    {
+        LoadSubCommand ("stats", CommandObjectSP (new CommandObjectProcessCacheStats (interpreter)));
+    }
+
+    ~CommandObjectProcessCache ()
+    {
+    }
+};
+
+//-------------------------------------------------------------------------
+// CommandObjectProcessPlugin
+//-------------------------------------------------------------------------
+#pragma mark CommandObjectProcessPlugin
+
+class CommandObjectProcessPlugin : public CommandObjectRaw
+{
+public:
+    CommandObjectProcessPlugin (CommandInterpreter &interpreter) :
+        CommandObjectRaw (interpreter,
+                          "process plugin",
+                          "Send a custom command to the process plug-in of the current process.",
+                          "process plugin <args>",
+                          eFlagProcessMustBeLaunched)
+    {
+    }
+
+    ~CommandObjectProcessPlugin ()
+    {
+    }
+
+protected:
+    bool
+    DoExecute (const char *command, CommandReturnObject &result)
+    {
+        Process *process = m_interpreter.GetExecutionContext().GetProcessPtr();
+        if (process == NULL)
+        {
+            result.AppendError ("No process.");
+            result.SetStatus (eReturnStatusFailed);
+            return false;
+        }
+        CommandObject *plugin_command = process->GetPluginCommandObject();
+        if (plugin_command == NULL)
+        {
+            result.AppendErrorWithFormat ("The %s process plug-in has no commands.\n", process->GetPluginName());
+            result.SetStatus (eReturnStatusFailed);
+            return false;
+        }
+        return plugin_command->Execute (command, result);
+    }
+};
+
 //-------------------------------------------------------------------------
 // CommandObjectProcessHandle
 //-------------------------------------------------------------------------
@@ -1790,6 +1907,8 @@ CommandObjectMultiwordProcess::CommandObjectMultiwordProcess (CommandInterpreter
     LoadSubCommand ("status",      CommandObjectSP (new CommandObjectProcessStatus    (interpreter)));
     LoadSubCommand ("interrupt",   CommandObjectSP (new CommandObjectProcessInterrupt (interpreter)));
     LoadSubCommand ("kill",        CommandObjectSP (new CommandObjectProcessKill      (interpreter)));
+    LoadSubCommand ("cache",       CommandObjectSP (new CommandObjectProcessCache     (interpreter)));
+    LoadSubCommand ("plugin",      CommandObjectSP (new CommandObjectProcessPlugin    (interpreter)));
 }
 
 CommandObjectMultiwordProcess::~CommandObjectMultiwordProcess ()
@@ -0,0 +1,163 @@
+//===-- CommandObjectStatistics.cpp -----------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "CommandObjectStatistics.h"
+
+// C Includes
+// C++ Includes
+// Other libraries and framework includes
+// Project includes
+#include "lldb/Core/Statistics.h"
+#include "lldb/Interpreter/CommandInterpreter.h"
+#include "lldb/Interpreter/CommandReturnObject.h"
+#include "lldb/Interpreter/Options.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+class CommandObjectStatisticsDump : public CommandObjectParsed
+{
+public:
+    CommandObjectStatisticsDump (CommandInterpreter &interpreter) :
+        CommandObjectParsed (interpreter,
+                             "statistics dump",
+                             "Show the counters and histograms LLDB keeps about its own work, like packets sent, bytes read from memory, DWARF DIEs parsed and expressions JIT compiled.",
+                             NULL),
+        m_options (interpreter)
+    {
+    }
+
+    virtual
+    ~CommandObjectStatisticsDump ()
+    {
+    }
+
+    Options *
+    GetOptions ()
+    {
+        return &m_options;
+    }
+
+    class CommandOptions : public Options
+    {
+    public:
+
+        CommandOptions (CommandInterpreter &interpreter) :
+            Options (interpreter),
+            json (false)
+        {
+        }
+
+        virtual
+        ~CommandOptions ()
+        {
+        }
+
+        virtual Error
+        SetOptionValue (uint32_t option_idx, const char *option_arg)
+        {
+            Error error;
+            char short_option = (char) m_getopt_table[option_idx].val;
+
+            switch (short_option)
+            {
+            case 'j':  json = true;   break;
+            default:
+                error.SetErrorStringWithFormat ("unrecognized option '%c'", short_option);
+                break;
+            }
+
+            return error;
+        }
+
+        void
+        OptionParsingStarting ()
+        {
+            json = false;
+        }
+
+        const OptionDefinition*
+        GetDefinitions ()
+        {
+            return g_option_table;
+        }
+
+        // Options table: Required for subclasses of Options.
+
+        static OptionDefinition g_option_table[];
+
+        // Instance variables to hold the values for command options.
+
+        bool json;
+    };
+
+protected:
+    virtual bool
+    DoExecute (Args& command, CommandReturnObject &result)
+    {
+        Statistics::Dump (result.GetOutputStream(), m_options.json);
+        result.SetStatus (eReturnStatusSuccessFinishResult);
+        return true;
+    }
+
+    CommandOptions m_options;
+};
+
+OptionDefinition
+CommandObjectStatisticsDump::CommandOptions::g_option_table[] =
+{
+{ LLDB_OPT_SET_1, false, "json",       'j', no_argument,       NULL, 0, eArgTypeNone,       "Show the statistics as a JSON object."},
+{ 0, false, NULL,                       0,  0,                 NULL, 0, eArgTypeNone,       NULL }
+};
+
+class CommandObjectStatisticsReset : public CommandObjectParsed
+{
+public:
+    CommandObjectStatisticsReset (CommandInterpreter &interpreter) :
+        CommandObjectParsed (interpreter,
+                             "statistics reset",
+                             "Set all of LLDB's counters and histograms back to zero.",
+                             NULL)
+    {
+    }
+
+    virtual
+    ~CommandObjectStatisticsReset ()
+    {
+    }
+
+protected:
+    virtual bool
+    DoExecute (Args& command, CommandReturnObject &result)
+    {
+        Statistics::Reset ();
+        result.SetStatus (eReturnStatusSuccessFinishNoResult);
+        return true;
+    }
+};
+
+//----------------------------------------------------------------------
+// CommandObjectStatistics constructor
+//----------------------------------------------------------------------
+CommandObjectStatistics::CommandObjectStatistics (CommandInterpreter &interpreter) :
+    CommandObjectMultiword (interpreter,
+                            "statistics",
+                            "A set of commands for showing how much work LLDB has done.",
+                            "statistics <command> [<command-options>]")
+{
+    LoadSubCommand ("dump",  CommandObjectSP (new CommandObjectStatisticsDump (interpreter)));
+    LoadSubCommand ("reset", CommandObjectSP (new CommandObjectStatisticsReset (interpreter)));
+}
+
+//----------------------------------------------------------------------
+// Destructor
+//----------------------------------------------------------------------
+CommandObjectStatistics::~CommandObjectStatistics ()
+{
+}
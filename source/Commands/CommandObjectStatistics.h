@@ -0,0 +1,45 @@
+//===-- CommandObjectStatistics.h -------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_CommandObjectStatistics_h_
+#define liblldb_CommandObjectStatistics_h_
+
+// C Includes
+// C++ Includes
+// Other libraries and framework includes
+// Project includes
+#include "lldb/Interpreter/CommandObjectMultiword.h"
+
+namespace lldb_private {
+
+//-------------------------------------------------------------------------
+// CommandObjectStatistics
+//-------------------------------------------------------------------------
+
+class CommandObjectStatistics : public CommandObjectMultiword
+{
+public:
+    //------------------------------------------------------------------
+    // Constructors and Destructors
+    //------------------------------------------------------------------
+    CommandObjectStatistics(CommandInterpreter &interpreter);
+
+    virtual
+    ~CommandObjectStatistics();
+
+private:
+    //------------------------------------------------------------------
+    // For CommandObjectStatistics only
+    //------------------------------------------------------------------
+    DISALLOW_COPY_AND_ASSIGN (CommandObjectStatistics);
+};
+
+} // namespace lldb_private
+
+#endif  // liblldb_CommandObjectStatistics_h_
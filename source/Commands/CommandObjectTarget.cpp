@@ -22,8 +22,10 @@
 #include "lldb/Core/ModuleSpec.h"
 #include "lldb/Core/Section.h"
 #include "lldb/Core/State.h"
+#include "lldb/Core/StreamString.h"
 #include "lldb/Core/Timer.h"
 #include "lldb/Core/ValueObjectVariable.h"
+#include "lldb/Host/ThreadPool.h"
 #include "lldb/Interpreter/CommandInterpreter.h"
 #include "lldb/Interpreter/CommandReturnObject.h"
 #include "lldb/Interpreter/Options.h"
@@ -1372,6 +1374,64 @@ DumpModuleSections (CommandInterpreter &interpreter, Stream &strm, Module *modul
     }
 }
 
+//----------------------------------------------------------------------
+// Dumping modules one at a time is slow for targets with a lot of them,
+// so each module is dumped into its own stream on the shared thread pool
+// and the streams are appended in module order afterwards, which keeps
+// the output the same. Callers pass in a snapshot of shared pointers and
+// must not hold any module list lock, since the workers can take it.
+//----------------------------------------------------------------------
+typedef void (*ModuleDumpCallback) (void *baton, Stream &strm, Module *module, uint32_t module_idx);
+
+struct ModuleDumpTask
+{
+    ModuleDumpCallback callback;
+    void *baton;
+    Module *module;
+    uint32_t module_idx;
+    StreamString strm;
+};
+
+static void
+RunModuleDumpTask (void *baton)
+{
+    ModuleDumpTask *task = (ModuleDumpTask *)baton;
+    task->callback (task->baton, task->strm, task->module, task->module_idx);
+}
+
+static void
+DumpModulesInParallel (Stream &strm, const std::vector<ModuleSP> &modules, ModuleDumpCallback callback, void *baton)
+{
+    const uint32_t num_modules = modules.size();
+    if (num_modules <= 1)
+    {
+        for (uint32_t i=0; i<num_modules; ++i)
+            callback (baton, strm, modules[i].get(), i);
+        return;
+    }
+
+    ModuleDumpTask *tasks = new ModuleDumpTask[num_modules];
+    {
+        ThreadPool::TaskGroup task_group (ThreadPool::GetSharedThreadPool());
+        for (uint32_t i=0; i<num_modules; ++i)
+        {
+            ModuleDumpTask &task = tasks[i];
+            task.callback = callback;
+            task.baton = baton;
+            task.module = modules[i].get();
+            task.module_idx = i;
+            task.strm.GetFlags() = strm.GetFlags();
+            task.strm.SetAddressByteSize (strm.GetAddressByteSize());
+            task.strm.SetIndentLevel (strm.GetIndentLevel());
+            task_group.AddTask (RunModuleDumpTask, &task);
+        }
+        task_group.Wait();
+    }
+    for (uint32_t i=0; i<num_modules; ++i)
+        strm.Write (tasks[i].strm.GetData(), tasks[i].strm.GetSize());
+    delete [] tasks;
+}
+
 static bool
 DumpModuleSymbolVendor (Stream &strm, Module *module)
 {
@@ -1438,6 +1498,9 @@ LookupAddressInModule (CommandInterpreter &interpreter,
                 return false;
         }
         
+        // Looking up an address is asking for the debug information
+        module->LoadSymbolsOnDemand();
+
         ExecutionContextScope *exe_scope = interpreter.GetExecutionContext().GetBestExecutionContextScope();
         DumpAddress (exe_scope, so_addr, verbose, strm);
 //        strm.IndentMore();
@@ -2022,24 +2085,20 @@ protected:
             if (command.GetArgumentCount() == 0)
             {
                 // Dump all sections for all modules images
-                Mutex::Locker modules_locker(target->GetImages().GetMutex());
-                const uint32_t num_modules = target->GetImages().GetSize();
+                std::vector<ModuleSP> modules;
+                {
+                    Mutex::Locker modules_locker(target->GetImages().GetMutex());
+                    const uint32_t num_modules = target->GetImages().GetSize();
+                    for (uint32_t image_idx = 0;  image_idx<num_modules; ++image_idx)
+                        modules.push_back (target->GetImages().GetModuleAtIndexUnlocked(image_idx));
+                }
+                const uint32_t num_modules = modules.size();
                 if (num_modules > 0)
                 {
                     result.GetOutputStream().Printf("Dumping symbol table for %u modules.\n", num_modules);
-                    for (uint32_t image_idx = 0;  image_idx<num_modules; ++image_idx)
-                    {
-                        if (num_dumped > 0)
-                        {
-                            result.GetOutputStream().EOL();
-                            result.GetOutputStream().EOL();
-                        }
-                        num_dumped++;
-                        DumpModuleSymtab (m_interpreter,
-                                          result.GetOutputStream(),
-                                          target->GetImages().GetModulePointerAtIndexUnlocked(image_idx),
-                                          m_options.m_sort_order);
-                    }
+                    num_dumped = modules.size();
+                    DumpSymtabBaton baton = { &m_interpreter, m_options.m_sort_order };
+                    DumpModulesInParallel (result.GetOutputStream(), modules, DumpSymtabCallback, &baton);
                 }
                 else
                 {
@@ -2051,31 +2110,25 @@ protected:
             else
             {
                 // Dump specified images (by basename or fullpath)
+                ModuleList module_list;
                 const char *arg_cstr;
                 for (int arg_idx = 0; (arg_cstr = command.GetArgumentAtIndex(arg_idx)) != NULL; ++arg_idx)
                 {
-                    ModuleList module_list;
                     const size_t num_matches = FindModulesByName (target, arg_cstr, module_list, true);
-                    if (num_matches > 0)
-                    {
-                        for (size_t i=0; i<num_matches; ++i)
-                        {
-                            Module *module = module_list.GetModulePointerAtIndex(i);
-                            if (module)
-                            {
-                                if (num_dumped > 0)
-                                {
-                                    result.GetOutputStream().EOL();
-                                    result.GetOutputStream().EOL();
-                                }
-                                num_dumped++;
-                                DumpModuleSymtab (m_interpreter, result.GetOutputStream(), module, m_options.m_sort_order);
-                            }
-                        }
-                    }
-                    else
+                    if (num_matches == 0)
                         result.AppendWarningWithFormat("Unable to find an image that matches '%s'.\n", arg_cstr);
                 }
+                std::vector<ModuleSP> modules;
+                const size_t num_matches = module_list.GetSize();
+                for (size_t i=0; i<num_matches; ++i)
+                {
+                    ModuleSP module_sp (module_list.GetModuleAtIndex(i));
+                    if (module_sp)
+                        modules.push_back (module_sp);
+                }
+                num_dumped = modules.size();
+                DumpSymtabBaton baton = { &m_interpreter, m_options.m_sort_order };
+                DumpModulesInParallel (result.GetOutputStream(), modules, DumpSymtabCallback, &baton);
             }
             
             if (num_dumped > 0)
@@ -2089,6 +2142,23 @@ protected:
         return result.Succeeded();
     }
     
+    struct DumpSymtabBaton
+    {
+        CommandInterpreter *interpreter;
+        SortOrder sort_order;
+    };
+
+    static void
+    DumpSymtabCallback (void *baton, Stream &strm, Module *module, uint32_t module_idx)
+    {
+        DumpSymtabBaton *dump_baton = (DumpSymtabBaton *)baton;
+        if (module_idx > 0)
+        {
+            strm.EOL();
+            strm.EOL();
+        }
+        DumpModuleSymtab (*dump_baton->interpreter, strm, module, dump_baton->sort_order);
+    }
     
     CommandOptions m_options;
 };
@@ -2156,15 +2226,19 @@ protected:
             if (command.GetArgumentCount() == 0)
             {
                 // Dump all sections for all modules images
-                const uint32_t num_modules = target->GetImages().GetSize();
+                std::vector<ModuleSP> modules;
+                {
+                    Mutex::Locker modules_locker(target->GetImages().GetMutex());
+                    const uint32_t num_modules = target->GetImages().GetSize();
+                    for (uint32_t image_idx = 0;  image_idx<num_modules; ++image_idx)
+                        modules.push_back (target->GetImages().GetModuleAtIndexUnlocked(image_idx));
+                }
+                const uint32_t num_modules = modules.size();
                 if (num_modules > 0)
                 {
                     result.GetOutputStream().Printf("Dumping sections for %u modules.\n", num_modules);
-                    for (uint32_t image_idx = 0;  image_idx<num_modules; ++image_idx)
-                    {
-                        num_dumped++;
-                        DumpModuleSections (m_interpreter, result.GetOutputStream(), target->GetImages().GetModulePointerAtIndex(image_idx));
-                    }
+                    num_dumped = modules.size();
+                    DumpModulesInParallel (result.GetOutputStream(), modules, DumpSectionsCallback, &m_interpreter);
                 }
                 else
                 {
@@ -2213,6 +2287,12 @@ protected:
         }
         return result.Succeeded();
     }
+
+    static void
+    DumpSectionsCallback (void *baton, Stream &strm, Module *module, uint32_t module_idx)
+    {
+        DumpModuleSections (*(CommandInterpreter *)baton, strm, module);
+    }
 };
 
 
@@ -2982,27 +3062,25 @@ protected:
                 num_modules = module_list_ptr->GetSize();
             }
 
+            // Take a reference to each module while the locker is held so
+            // the modules stay alive after it is released below
+            std::vector<ModuleSP> modules;
+            for (uint32_t image_idx = 0; image_idx<num_modules; ++image_idx)
+            {
+                if (module_list_ptr)
+                    modules.push_back (module_list_ptr->GetModuleAtIndexUnlocked(image_idx));
+                else
+                    modules.push_back (Module::GetAllocatedModuleAtIndex(image_idx)->shared_from_this());
+            }
+            locker.Unlock();
+
             if (num_modules > 0)
             {                
-                for (uint32_t image_idx = 0; image_idx<num_modules; ++image_idx)
-                {
-                    ModuleSP module_sp;
-                    Module *module;
-                    if (module_list_ptr)
-                    {
-                        module_sp = module_list_ptr->GetModuleAtIndexUnlocked(image_idx);
-                        module = module_sp.get();
-                    }
-                    else
-                    {
-                        module = Module::GetAllocatedModuleAtIndex(image_idx);
-                        module_sp = module->shared_from_this();
-                    }
-                    
-                    int indent = strm.Printf("[%3u] ", image_idx);
-                    PrintModule (target, module, image_idx, indent, strm);
-
-                }
+                // Set up the default format before the rows are printed
+                // on other threads
+                InitializeFormatArray ();
+                PrintModuleBaton baton = { this, target };
+                DumpModulesInParallel (strm, modules, PrintModuleCallback, &baton);
                 result.SetStatus (eReturnStatusSuccessFinishResult);
             }
             else
@@ -3028,11 +3106,23 @@ protected:
         return result.Succeeded();
     }
 
-    void
-    PrintModule (Target *target, Module *module, uint32_t idx, int indent, Stream &strm)
+    struct PrintModuleBaton
     {
+        CommandObjectTargetModulesList *command;
+        Target *target;
+    };
 
-        bool dump_object_name = false;
+    static void
+    PrintModuleCallback (void *baton, Stream &strm, Module *module, uint32_t module_idx)
+    {
+        PrintModuleBaton *print_baton = (PrintModuleBaton *)baton;
+        int indent = strm.Printf("[%3u] ", module_idx);
+        print_baton->command->PrintModule (print_baton->target, module, module_idx, indent, strm);
+    }
+
+    void
+    InitializeFormatArray ()
+    {
         if (m_options.m_format_array.empty())
         {
             m_options.m_format_array.push_back(std::make_pair('u', 0));
@@ -3040,6 +3130,14 @@ protected:
             m_options.m_format_array.push_back(std::make_pair('f', 0));
             m_options.m_format_array.push_back(std::make_pair('S', 0));
         }
+    }
+
+    void
+    PrintModule (Target *target, Module *module, uint32_t idx, int indent, Stream &strm)
+    {
+
+        bool dump_object_name = false;
+        InitializeFormatArray ();
         const size_t num_entries = m_options.m_format_array.size();
         bool print_space = false;
         for (size_t i=0; i<num_entries; ++i)
@@ -3134,7 +3232,10 @@ protected:
                 case 's':
                 case 'S':
                     {
-                        SymbolVendor *symbol_vendor = module->GetSymbolVendor();
+                        // The default listing only shows a symbol file that
+                        // is already known about, it shouldn't make every
+                        // module go looking for its symbols
+                        SymbolVendor *symbol_vendor = module->GetSymbolVendor(format_char == 's');
                         if (symbol_vendor)
                         {
                             SymbolFile *symbol_file = symbol_vendor->GetSymbolFile();
@@ -186,9 +186,14 @@ protected:
         {
             Process *process = m_interpreter.GetExecutionContext().GetProcessPtr();
             uint32_t num_threads = process->GetThreadList().GetSize();
+            std::vector<ThreadSP> thread_sps;
+            for (uint32_t i = 0; i < num_threads; i++)
+                thread_sps.push_back (process->GetThreadList().GetThreadAtIndex(i));
+            ThreadList::ComputeStackFrames (thread_sps, GetNumFramesToUnwind());
+
             for (uint32_t i = 0; i < num_threads; i++)
             {
-                ThreadSP thread_sp = process->GetThreadList().GetThreadAtIndex(i);
+                ThreadSP thread_sp = thread_sps[i];
                 if (!thread_sp->GetStatus (strm,
                                            m_options.m_start,
                                            m_options.m_count,
@@ -232,6 +237,8 @@ protected:
                 }
                 
             }
+
+            ThreadList::ComputeStackFrames (thread_sps, GetNumFramesToUnwind());
             
             for (uint32_t i = 0; i < num_args; i++)
             {
@@ -252,6 +259,16 @@ protected:
         return result.Succeeded();
     }
 
+    // The number of frames we need to unwind in each thread to show the
+    // requested frames.
+    uint32_t
+    GetNumFramesToUnwind () const
+    {
+        if (m_options.m_count == UINT32_MAX || m_options.m_start > UINT32_MAX - m_options.m_count)
+            return UINT32_MAX;
+        return m_options.m_start + m_options.m_count;
+    }
+
     CommandOptions m_options;
 };
 
@@ -72,6 +72,7 @@ public:
     bool m_skip_references;
     bool m_cascade;
     bool m_regex;
+    bool m_no_cache;
     StringList m_user_source;
     StringList m_target_types;
     
@@ -81,11 +82,13 @@ public:
                     bool sref,
                     bool casc,
                     bool regx,
+                    bool nocache,
                     std::string catg) :
     m_skip_pointers(sptr),
     m_skip_references(sref),
     m_cascade(casc),
     m_regex(regx),
+    m_no_cache(nocache),
     m_user_source(),
     m_target_types(),
     m_category(catg)
@@ -226,6 +229,9 @@ private:
                     m_class_name = std::string(option_arg);
                     is_class_based = true;
                     break;
+                case 'N':
+                    m_no_cache = true;
+                    break;
                 case 'p':
                     m_skip_pointers = true;
                     break;
@@ -257,6 +263,7 @@ private:
             is_class_based = false;
             handwrite_python = false;
             m_regex = false;
+            m_no_cache = false;
         }
         
         const OptionDefinition*
@@ -284,6 +291,8 @@ private:
         
         bool m_regex;
         
+        bool m_no_cache;
+        
     };
     
     CommandOptions m_options;
@@ -966,6 +975,9 @@ CommandObjectTypeSummaryAdd::CommandOptions::SetOptionValue (uint32_t option_idx
         case 'O':
             m_flags.SetHideItemNames(true);
             break;
+        case 'N':
+            m_flags.SetNotCacheable(true);
+            break;
         default:
             error.SetErrorStringWithFormat ("unrecognized option '%c'", short_option);
             break;
@@ -1388,6 +1400,7 @@ CommandObjectTypeSummaryAdd::CommandOptions::g_option_table[] =
     { LLDB_OPT_SET_3, false, "python-script", 'o', required_argument, NULL, 0, eArgTypePythonScript, "Give a one-liner Python script as part of the command."},
     { LLDB_OPT_SET_3, false, "python-function", 'F', required_argument, NULL, 0, eArgTypePythonFunction, "Give the name of a Python function to use for this type."},
     { LLDB_OPT_SET_3, false, "input-python", 'P', no_argument, NULL, 0, eArgTypeNone, "Input Python code to use for this type manually."},
+    { LLDB_OPT_SET_3, false, "no-cache", 'N', no_argument, NULL, 0, eArgTypeNone, "Run the Python code every time the summary is shown, instead of reusing its last result while the value is unchanged."},
     { LLDB_OPT_SET_2 | LLDB_OPT_SET_3,   false, "expand", 'e', no_argument, NULL, 0, eArgTypeNone,    "Expand aggregate data types to show children on separate lines."},
     { LLDB_OPT_SET_2 | LLDB_OPT_SET_3,   false, "name", 'n', required_argument, NULL, 0, eArgTypeName,    "A name for this summary string."},
     { 0, false, NULL, 0, 0, NULL, 0, eArgTypeNone, NULL }
@@ -3385,7 +3398,8 @@ public:
         SyntheticChildrenSP synth_provider;
         synth_provider.reset(new TypeSyntheticImpl(SyntheticChildren::Flags().SetCascades(options->m_cascade).
                                                          SetSkipPointers(options->m_skip_pointers).
-                                                         SetSkipReferences(options->m_skip_references),
+                                                         SetSkipReferences(options->m_skip_references).
+                                                         SetNotCacheable(options->m_no_cache),
                                                          class_name_str.c_str()));
         
         
@@ -3460,6 +3474,7 @@ CommandObjectTypeSynthAdd::Execute_HandwritePython (Args& command, CommandReturn
                                                      m_options.m_skip_references,
                                                      m_options.m_cascade,
                                                      m_options.m_regex,
+                                                     m_options.m_no_cache,
                                                      m_options.m_category);
     
     const size_t argc = command.GetArgumentCount();
@@ -3505,7 +3520,8 @@ CommandObjectTypeSynthAdd::Execute_PythonClass (Args& command, CommandReturnObje
     TypeSyntheticImpl* impl = new TypeSyntheticImpl(SyntheticChildren::Flags().
                                                     SetCascades(m_options.m_cascade).
                                                     SetSkipPointers(m_options.m_skip_pointers).
-                                                    SetSkipReferences(m_options.m_skip_references),
+                                                    SetSkipReferences(m_options.m_skip_references).
+                                                    SetNotCacheable(m_options.m_no_cache),
                                                     m_options.m_class_name.c_str());
     
     entry.reset(impl);
@@ -3630,6 +3646,7 @@ CommandObjectTypeSynthAdd::CommandOptions::g_option_table[] =
     { LLDB_OPT_SET_ALL, false, "category", 'w', required_argument, NULL, 0, eArgTypeName,         "Add this to the given category instead of the default one."},
     { LLDB_OPT_SET_2, false, "python-class", 'l', required_argument, NULL, 0, eArgTypePythonClass,    "Use this Python class to produce synthetic children."},
     { LLDB_OPT_SET_3, false, "input-python", 'P', no_argument, NULL, 0, eArgTypeNone,    "Type Python code to generate a class that provides synthetic children."},
+    { LLDB_OPT_SET_2 | LLDB_OPT_SET_3, false, "no-cache", 'N', no_argument, NULL, 0, eArgTypeNone,    "Update the Python class every time the children are shown, instead of reusing them while the value is unchanged."},
     { LLDB_OPT_SET_ALL, false,  "regex", 'x', no_argument, NULL, 0, eArgTypeNone,    "Type names are actually regular expressions."},
     { 0, false, NULL, 0, 0, NULL, 0, eArgTypeNone, NULL }
 };
@@ -22,6 +22,7 @@
 #include "lldb/Interpreter/CommandInterpreter.h"
 #include "lldb/Interpreter/CommandReturnObject.h"
 #include "lldb/Interpreter/CommandCompletions.h"
+#include "lldb/Symbol/ClangASTContext.h"
 #include "lldb/Symbol/Variable.h"
 #include "lldb/Symbol/VariableList.h"
 #include "lldb/Target/Target.h"
@@ -1049,6 +1050,11 @@ protected:
         if (wp) {
             wp->SetWatchSpec(command.GetArgumentAtIndex(0));
             wp->SetWatchVariable(true);
+            // Conditions on integer variables can be handed to the
+            // remote stub, see ProcessGDBRemote::GetWatchpointConditions().
+            bool is_signed = false;
+            if (ClangASTContext::IsIntegerType (valobj_sp->GetClangType(), is_signed))
+                wp->SetWatchVariableEncoding (is_signed ? eEncodingSint : eEncodingUint);
             if (var_sp && var_sp->GetDeclaration().GetFile()) {
                 StreamString ss;
                 // True to show fullpath for declaration file.
@@ -0,0 +1,108 @@
+//===-- AsyncOperation.cpp --------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "lldb/Core/AsyncOperation.h"
+
+// C Includes
+#include <pthread.h>
+// C++ Includes
+// Other libraries and framework includes
+// Project includes
+#include "lldb/Host/Host.h"
+#include "lldb/Host/TimeValue.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+// The operation the current thread is running, if any
+static pthread_key_t g_current_operation_key;
+static pthread_once_t g_current_operation_key_once = PTHREAD_ONCE_INIT;
+
+static void
+InitializeCurrentOperationKey ()
+{
+    ::pthread_key_create (&g_current_operation_key, NULL);
+}
+
+AsyncOperation::AsyncOperation () :
+    m_error (),
+    m_valobj_sp (),
+    m_sc_list (),
+    m_count (0),
+    m_done (false),
+    m_cancelled (0)
+{
+}
+
+AsyncOperation::~AsyncOperation ()
+{
+}
+
+bool
+AsyncOperation::Start ()
+{
+    ::pthread_once (&g_current_operation_key_once, InitializeCurrentOperationKey);
+
+    AsyncOperationSP *op_sp_ptr = new AsyncOperationSP (shared_from_this());
+    lldb::thread_t thread = Host::ThreadCreate ("<lldb.async-operation>", AsyncOperation::ThreadFunction, op_sp_ptr, &m_error);
+    if (!IS_VALID_LLDB_HOST_THREAD(thread))
+    {
+        delete op_sp_ptr;
+        if (m_error.Success())
+            m_error.SetErrorString ("couldn't start a thread for the operation");
+        m_done.SetValue (true, eBroadcastAlways);
+        return false;
+    }
+    Host::ThreadDetach (thread, NULL);
+    return true;
+}
+
+void
+AsyncOperation::Cancel ()
+{
+    __sync_lock_test_and_set (&m_cancelled, 1);
+}
+
+bool
+AsyncOperation::Wait (uint32_t timeout_usec)
+{
+    if (timeout_usec == 0)
+        return m_done.WaitForValueEqualTo (true);
+
+    TimeValue timeout = TimeValue::Now();
+    timeout.OffsetWithMicroSeconds (timeout_usec);
+    return m_done.WaitForValueEqualTo (true, &timeout);
+}
+
+bool
+AsyncOperation::ShouldCancel ()
+{
+    ::pthread_once (&g_current_operation_key_once, InitializeCurrentOperationKey);
+    AsyncOperation *op = (AsyncOperation *)::pthread_getspecific (g_current_operation_key);
+    return op && op->IsCancelled();
+}
+
+void *
+AsyncOperation::ThreadFunction (void *arg)
+{
+    AsyncOperationSP op_sp (*(AsyncOperationSP *)arg);
+    delete (AsyncOperationSP *)arg;
+
+    ::pthread_setspecific (g_current_operation_key, op_sp.get());
+    if (!op_sp->IsCancelled())
+        op_sp->DoExecute ();
+    ::pthread_setspecific (g_current_operation_key, NULL);
+
+    // Whatever the work found before it stopped is incomplete, don't
+    // let it look like a success
+    if (op_sp->IsCancelled() && op_sp->m_error.Success())
+        op_sp->m_error.SetErrorString ("operation was cancelled");
+    op_sp->m_done.SetValue (true, eBroadcastAlways);
+    return NULL;
+}
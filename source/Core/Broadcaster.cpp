@@ -27,8 +27,15 @@ Broadcaster::Broadcaster (BroadcasterManager *manager, const char *name) :
     m_listeners_mutex (Mutex::eMutexTypeRecursive),
     m_hijacking_listeners(),
     m_hijacking_masks(),
+    m_listener_snapshot (new ListenerSnapshot()),
+    m_listener_snapshot_readers (0),
+    m_listener_snapshot_waiters (0),
+    m_listener_snapshot_mutex (Mutex::eMutexTypeNormal),
+    m_listener_snapshot_condition (),
     m_manager (manager)
 {
+    m_listener_snapshot->hijacking_listener = NULL;
+    m_listener_snapshot->hijacking_mask = 0;
     LogSP log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_OBJECT));
     if (log)
         log->Printf ("%p Broadcaster::Broadcaster(\"%s\")", this, m_broadcaster_name.AsCString());
@@ -42,6 +49,7 @@ Broadcaster::~Broadcaster()
         log->Printf ("%p Broadcaster::~Broadcaster(\"%s\")", this, m_broadcaster_name.AsCString());
 
     Clear();
+    delete m_listener_snapshot;
 }
 
 void
@@ -67,6 +75,62 @@ Broadcaster::Clear()
         pos->first->BroadcasterWillDestruct (this);
     
     m_listeners.clear();
+    UpdateListenerSnapshot ();
+}
+
+void
+Broadcaster::UpdateListenerSnapshot ()
+{
+    ListenerSnapshot *snapshot = new ListenerSnapshot();
+    snapshot->listeners = m_listeners;
+    if (m_hijacking_listeners.empty())
+    {
+        snapshot->hijacking_listener = NULL;
+        snapshot->hijacking_mask = 0;
+    }
+    else
+    {
+        snapshot->hijacking_listener = m_hijacking_listeners.back();
+        snapshot->hijacking_mask = m_hijacking_masks.back();
+    }
+
+    ListenerSnapshot *old_snapshot = m_listener_snapshot;
+    m_listener_snapshot = snapshot;
+    __sync_synchronize();
+
+    // Readers announce themselves before they load the snapshot pointer,
+    // so once there are none left nobody can still be using the old one.
+    // Readers only look at m_listener_snapshot_waiters, and take the
+    // mutex, when we are waiting for them.
+    if (m_listener_snapshot_readers != 0)
+    {
+        Mutex::Locker locker (m_listener_snapshot_mutex);
+        __sync_add_and_fetch (&m_listener_snapshot_waiters, 1);
+        while (m_listener_snapshot_readers != 0)
+            m_listener_snapshot_condition.Wait (m_listener_snapshot_mutex);
+        __sync_sub_and_fetch (&m_listener_snapshot_waiters, 1);
+    }
+
+    delete old_snapshot;
+}
+
+Broadcaster::ListenerSnapshot *
+Broadcaster::AcquireListenerSnapshot ()
+{
+    __sync_add_and_fetch (&m_listener_snapshot_readers, 1);
+    return m_listener_snapshot;
+}
+
+void
+Broadcaster::ReleaseListenerSnapshot ()
+{
+    // Both counters are updated with full barriers, so either the waiter
+    // sees that there are no readers left or we see the waiter
+    if (__sync_sub_and_fetch (&m_listener_snapshot_readers, 1) == 0 && m_listener_snapshot_waiters != 0)
+    {
+        Mutex::Locker locker (m_listener_snapshot_mutex);
+        m_listener_snapshot_condition.Broadcast();
+    }
 }
 const ConstString &
 Broadcaster::GetBroadcasterName ()
@@ -153,6 +217,8 @@ Broadcaster::AddListener (Listener* listener, uint32_t event_mask)
         // Individual broadcasters decide whether they have outstanding data when a
         // listener attaches, and insert it into the listener with this method.
 
+        UpdateListenerSnapshot ();
+
         AddInitialEventsToListener (listener, available_event_types);
     }
 
@@ -163,21 +229,26 @@ Broadcaster::AddListener (Listener* listener, uint32_t event_mask)
 bool
 Broadcaster::EventTypeHasListeners (uint32_t event_type)
 {
-    Mutex::Locker locker (m_listeners_mutex);
+    ListenerSnapshot *snapshot = AcquireListenerSnapshot ();
     
-    if (m_hijacking_listeners.size() > 0 && event_type & m_hijacking_masks.back())
-        return true;
-        
-    if (m_listeners.empty())
-        return false;
-
-    collection::iterator pos, end = m_listeners.end();
-    for (pos = m_listeners.begin(); pos != end; ++pos)
+    bool has_listeners = false;
+    if (snapshot->hijacking_listener && event_type & snapshot->hijacking_mask)
+        has_listeners = true;
+    else
     {
-        if (pos->second & event_type)
-            return true;
+        collection::const_iterator pos, end = snapshot->listeners.end();
+        for (pos = snapshot->listeners.begin(); pos != end; ++pos)
+        {
+            if (pos->second & event_type)
+            {
+                has_listeners = true;
+                break;
+            }
+        }
     }
-    return false;
+    
+    ReleaseListenerSnapshot ();
+    return has_listeners;
 }
 
 bool
@@ -195,6 +266,7 @@ Broadcaster::RemoveListener (Listener* listener, uint32_t event_mask)
             // If all bits have been relinquished then remove this listener
             if (pos->second == 0)
                 m_listeners.erase (pos);
+            UpdateListenerSnapshot ();
             return true;
         }
     }
@@ -202,19 +274,19 @@ Broadcaster::RemoveListener (Listener* listener, uint32_t event_mask)
 }
 
 void
-Broadcaster::BroadcastEvent (EventSP &event_sp)
+Broadcaster::BroadcastEvent (EventIntrusiveSP &event_sp)
 {
     return PrivateBroadcastEvent (event_sp, false);
 }
 
 void
-Broadcaster::BroadcastEventIfUnique (EventSP &event_sp)
+Broadcaster::BroadcastEventIfUnique (EventIntrusiveSP &event_sp)
 {
     return PrivateBroadcastEvent (event_sp, true);
 }
 
 void
-Broadcaster::PrivateBroadcastEvent (EventSP &event_sp, bool unique)
+Broadcaster::PrivateBroadcastEvent (EventIntrusiveSP &event_sp, bool unique)
 {
     // Can't add a NULL event...
     if (event_sp.get() == NULL)
@@ -225,16 +297,13 @@ Broadcaster::PrivateBroadcastEvent (EventSP &event_sp, bool unique)
 
     const uint32_t event_type = event_sp->GetType();
 
-    Mutex::Locker event_types_locker(m_listeners_mutex);
+    // Broadcasting only reads the current listener snapshot, so it
+    // doesn't contend with other broadcasts or wait on m_listeners_mutex
+    ListenerSnapshot *snapshot = AcquireListenerSnapshot ();
     
-    Listener *hijacking_listener = NULL;
-    if (!m_hijacking_listeners.empty())
-    {
-        assert (!m_hijacking_masks.empty());
-        hijacking_listener = m_hijacking_listeners.back();
-        if ((event_type & m_hijacking_masks.back()) == 0)
-            hijacking_listener = NULL;
-    }
+    Listener *hijacking_listener = snapshot->hijacking_listener;
+    if ((event_type & snapshot->hijacking_mask) == 0)
+        hijacking_listener = NULL;
 
     LogSP log(lldb_private::GetLogIfAnyCategoriesSet (LIBLLDB_LOG_EVENTS));
     if (log)
@@ -251,17 +320,16 @@ Broadcaster::PrivateBroadcastEvent (EventSP &event_sp, bool unique)
 
     if (hijacking_listener)
     {
-        if (unique && hijacking_listener->PeekAtNextEventForBroadcasterWithType (this, event_type))
-            return;
-        hijacking_listener->AddEvent (event_sp);
+        if (!unique || !hijacking_listener->PeekAtNextEventForBroadcasterWithType (this, event_type))
+            hijacking_listener->AddEvent (event_sp);
     }
     else
     {
-        collection::iterator pos, end = m_listeners.end();
+        collection::const_iterator pos, end = snapshot->listeners.end();
 
 
         // Iterate through all listener/mask pairs
-        for (pos = m_listeners.begin(); pos != end; ++pos)
+        for (pos = snapshot->listeners.begin(); pos != end; ++pos)
         {
             // If the listener's mask matches any bits that we just set, then
             // put the new event on its event queue.
@@ -273,19 +341,21 @@ Broadcaster::PrivateBroadcastEvent (EventSP &event_sp, bool unique)
             }
         }
     }
+
+    ReleaseListenerSnapshot ();
 }
 
 void
 Broadcaster::BroadcastEvent (uint32_t event_type, EventData *event_data)
 {
-    EventSP event_sp (new Event (event_type, event_data));
+    EventIntrusiveSP event_sp (new Event (event_type, event_data));
     PrivateBroadcastEvent (event_sp, false);
 }
 
 void
 Broadcaster::BroadcastEventIfUnique (uint32_t event_type, EventData *event_data)
 {
-    EventSP event_sp (new Event (event_type, event_data));
+    EventIntrusiveSP event_sp (new Event (event_type, event_data));
     PrivateBroadcastEvent (event_sp, true);
 }
 
@@ -305,6 +375,7 @@ Broadcaster::HijackBroadcaster (Listener *listener, uint32_t event_mask)
     }
     m_hijacking_listeners.push_back(listener);
     m_hijacking_masks.push_back(event_mask);
+    UpdateListenerSnapshot ();
     return true;
 }
 
@@ -325,6 +396,7 @@ Broadcaster::RestoreBroadcaster ()
     }
     m_hijacking_listeners.pop_back();
     m_hijacking_masks.pop_back();
+    UpdateListenerSnapshot ();
 }
 
 ConstString &
@@ -9,13 +9,22 @@
 
 #include "lldb/Core/CXXFormatterFunctions.h"
 
+#include <algorithm>
+
 // needed to get ConvertUTF16/32ToUTF8
 #define CLANG_NEEDS_THESE_ONE_DAY
 #include "clang/Basic/ConvertUTF.h"
 
+#include "lldb/Core/DataBufferHeap.h"
+#include "lldb/Core/Error.h"
 #include "lldb/Core/Stream.h"
+#include "lldb/Core/StreamString.h"
 #include "lldb/Core/ValueObject.h"
+#include "lldb/Core/ValueObjectConstResult.h"
+#include "lldb/Interpreter/Args.h"
+#include "lldb/Symbol/ClangASTContext.h"
 #include "lldb/Target/ObjCLanguageRuntime.h"
+#include "lldb/Target/Process.h"
 #include "lldb/Target/Target.h"
 
 using namespace lldb;
@@ -485,6 +494,22 @@ lldb_private::formatters::NSNumber_SummaryProvider (ValueObject& valobj, Stream&
     }
 }
 
+// Print the 8 bit characters of an NSString that start at "location",
+// stopping where summaries of C strings stop
+static bool
+DumpNSStringCharacters (Process &process, lldb::addr_t location, Stream &stream)
+{
+    Error error;
+    const size_t max_len = process.GetTarget().GetMaximumSizeOfStringSummary();
+    std::string str;
+    process.ReadCStringFromMemory (location, str, max_len, error);
+    if (error.Fail())
+        return false;
+    if (!str.empty())
+        stream.Printf ("@\"%s\"%s", str.c_str(), str.size() >= max_len ? "..." : "");
+    return true;
+}
+
 bool
 lldb_private::formatters::NSString_SummaryProvider (ValueObject& valobj, Stream& stream)
 {
@@ -549,7 +574,7 @@ lldb_private::formatters::NSString_SummaryProvider (ValueObject& valobj, Stream&
         if (has_explicit_length and is_unicode)
         {
             lldb::DataBufferSP buffer_sp(new DataBufferHeap(1024,0));
-            size_t data_read = process_sp->ReadMemoryFromInferior(location, (char*)buffer_sp->GetBytes(), 1024, error);
+            size_t data_read = process_sp->ReadMemory(location, (char*)buffer_sp->GetBytes(), 1024, error);
             if (error.Fail())
             {
                 stream.Printf("erorr reading pte");
@@ -600,25 +625,13 @@ lldb_private::formatters::NSString_SummaryProvider (ValueObject& valobj, Stream&
         else
         {
             location++;
-            lldb::DataBufferSP buffer_sp(new DataBufferHeap(1024,0));
-            size_t data_read = process_sp->ReadCStringFromMemory(location, (char*)buffer_sp->GetBytes(), 1024, error);
-            if (error.Fail())
-                return false;
-            if (data_read)
-                stream.Printf("@\"%s\"",(char*)buffer_sp->GetBytes());
-                return true;
+            return DumpNSStringCharacters (*process_sp, location, stream);
         }
     }
     else if (is_inline && has_explicit_length && !is_unicode && !is_special && !is_mutable)
     {
         uint64_t location = 3 * ptr_size + valobj_addr;
-        lldb::DataBufferSP buffer_sp(new DataBufferHeap(1024,0));
-        size_t data_read = process_sp->ReadCStringFromMemory(location, (char*)buffer_sp->GetBytes(), 1024, error);
-        if (error.Fail())
-            return false;
-        if (data_read)
-            stream.Printf("@\"%s\"",(char*)buffer_sp->GetBytes());
-            return true;
+        return DumpNSStringCharacters (*process_sp, location, stream);
     }
     else if (is_unicode)
     {
@@ -640,7 +653,7 @@ lldb_private::formatters::NSString_SummaryProvider (ValueObject& valobj, Stream&
                 return false;
         }
         lldb::DataBufferSP buffer_sp(new DataBufferHeap(1024,0));
-        size_t data_read = process_sp->ReadMemoryFromInferior(location, (char*)buffer_sp->GetBytes(), 1024, error);
+        size_t data_read = process_sp->ReadMemory(location, (char*)buffer_sp->GetBytes(), 1024, error);
         if (error.Fail())
         {
             stream.Printf("erorr reading pte");
@@ -692,7 +705,7 @@ lldb_private::formatters::NSString_SummaryProvider (ValueObject& valobj, Stream&
     {
         uint64_t location = valobj_addr + (ptr_size == 8 ? 12 : 8);
         lldb::DataBufferSP buffer_sp(new DataBufferHeap(1024,0));
-        size_t data_read = process_sp->ReadMemoryFromInferior(location, (char*)buffer_sp->GetBytes(), 1024, error);
+        size_t data_read = process_sp->ReadMemory(location, (char*)buffer_sp->GetBytes(), 1024, error);
         if (error.Fail())
         {
             stream.Printf("erorr reading pte");
@@ -745,13 +758,7 @@ lldb_private::formatters::NSString_SummaryProvider (ValueObject& valobj, Stream&
         uint64_t location = valobj_addr + ptr_size + 4 + (ptr_size == 8 ? 4 : 0);
         if (!has_explicit_length)
             location++;
-        lldb::DataBufferSP buffer_sp(new DataBufferHeap(1024,0));
-        size_t data_read = process_sp->ReadCStringFromMemory(location, (char*)buffer_sp->GetBytes(), 1024, error);
-        if (error.Fail())
-            return false;
-        if (data_read)
-            stream.Printf("@\"%s\"",(char*)buffer_sp->GetBytes());
-            return true;
+        return DumpNSStringCharacters (*process_sp, location, stream);
     }
     else
     {
@@ -759,13 +766,7 @@ lldb_private::formatters::NSString_SummaryProvider (ValueObject& valobj, Stream&
         location = process_sp->ReadPointerFromMemory(location, error);
         if (error.Fail())
             return false;
-        lldb::DataBufferSP buffer_sp(new DataBufferHeap(1024,0));
-        size_t data_read = process_sp->ReadCStringFromMemory(location, (char*)buffer_sp->GetBytes(), 1024, error);
-        if (error.Fail())
-            return false;
-        if (data_read)
-            stream.Printf("@\"%s\"",(char*)buffer_sp->GetBytes());
-            return true;
+        return DumpNSStringCharacters (*process_sp, location, stream);
     }
     
     stream.Printf("class name = %s",class_name);
@@ -783,3 +784,629 @@ lldb_private::formatters::NSData_SummaryProvider<true> (ValueObject&, Stream&) ;
 
 template bool
 lldb_private::formatters::NSData_SummaryProvider<false> (ValueObject&, Stream&) ;
+
+// The Python formatters cap lists and maps at this many children, because
+// walking a corrupted list or tree would never end otherwise
+#define STD_CONTAINER_CAPPING_SIZE 255
+
+// How much of a vector's storage we read ahead of the child being fetched,
+// children are usually asked for in order one page at a time
+#define STD_VECTOR_PREFETCH_BYTE_SIZE (16 * 1024)
+
+static uint32_t
+ExtractIndexFromChildName (const ConstString &name_cs)
+{
+    const char* name_cstr = name_cs.GetCString();
+    if (name_cstr == NULL || *name_cstr != '[')
+        return UINT32_MAX;
+    std::string name(name_cstr+1);
+    if (name.empty() || name[name.size()-1] != ']')
+        return UINT32_MAX;
+    name = name.erase(name.size()-1,1);
+    int index = Args::StringToSInt32 (name.c_str(), -1);
+    if (index < 0)
+        return UINT32_MAX;
+    return index;
+}
+
+// Make a child named "[idx]" out of the value at "addr", reading the value
+// with a single memory read
+static lldb::ValueObjectSP
+CreateChildFromMemory (ValueObject &backend,
+                       uint32_t idx,
+                       lldb::addr_t addr,
+                       const ClangASTType &type)
+{
+    ProcessSP process_sp (backend.GetProcessSP());
+    const uint32_t byte_size = type.GetTypeByteSize();
+    if (!process_sp || !type.IsValid() || byte_size == 0 || addr == LLDB_INVALID_ADDRESS || addr == 0)
+        return ValueObjectSP();
+    
+    DataBufferSP buffer_sp (new DataBufferHeap (byte_size, 0));
+    Error error;
+    if (process_sp->ReadMemory (addr, buffer_sp->GetBytes(), byte_size, error) != byte_size)
+        return ValueObjectSP();
+    DataExtractor data (buffer_sp, process_sp->GetByteOrder(), process_sp->GetAddressByteSize());
+    
+    StreamString name;
+    name.Printf("[%u]", idx);
+    ExecutionContext exe_ctx (backend.GetExecutionContextRef());
+    return ValueObjectConstResult::Create (exe_ctx.GetBestExecutionContextScope(),
+                                           type.GetASTContext(),
+                                           type.GetOpaqueQualType(),
+                                           ConstString(name.GetData()),
+                                           data,
+                                           addr);
+}
+
+// The type of template argument "idx" of the container "valobj" is an
+// instance of, looking through a reference to the container
+static ClangASTType
+GetContainerTemplateArgument (ValueObject &valobj, size_t idx)
+{
+    clang::ASTContext *ast = valobj.GetClangAST();
+    lldb::clang_type_t container_type = valobj.GetClangType();
+    lldb::clang_type_t referenced_type = NULL;
+    if (ClangASTContext::IsReferenceType (container_type, &referenced_type))
+        container_type = referenced_type;
+    lldb::TemplateArgumentKind kind;
+    lldb::clang_type_t arg_type = ClangASTContext::GetTemplateArgument (ast, container_type, idx, kind);
+    if (arg_type == NULL || kind != eTemplateArgumentKindType)
+        return ClangASTType();
+    return ClangASTType (ast, arg_type);
+}
+
+lldb_private::formatters::StdVectorSyntheticFrontEnd::StdVectorSyntheticFrontEnd (lldb::ValueObjectSP valobj_sp) :
+    SyntheticChildrenFrontEnd(*valobj_sp.get()),
+    m_start(LLDB_INVALID_ADDRESS),
+    m_finish(LLDB_INVALID_ADDRESS),
+    m_element_type(),
+    m_element_size(0),
+    m_prefetched_start(LLDB_INVALID_ADDRESS),
+    m_prefetched_end(LLDB_INVALID_ADDRESS)
+{
+}
+
+lldb_private::formatters::StdVectorSyntheticFrontEnd::~StdVectorSyntheticFrontEnd ()
+{
+}
+
+void
+lldb_private::formatters::StdVectorSyntheticFrontEnd::Clear ()
+{
+    m_start = LLDB_INVALID_ADDRESS;
+    m_finish = LLDB_INVALID_ADDRESS;
+    m_element_type = ClangASTType();
+    m_element_size = 0;
+    m_prefetched_start = LLDB_INVALID_ADDRESS;
+    m_prefetched_end = LLDB_INVALID_ADDRESS;
+}
+
+void
+lldb_private::formatters::StdVectorSyntheticFrontEnd::SetStorage (const lldb::ValueObjectSP &start_sp,
+                                                                  const lldb::ValueObjectSP &finish_sp)
+{
+    Clear();
+    if (!start_sp || !finish_sp)
+        return;
+    // vector<bool> and other specializations that don't store an array of
+    // elements are left alone
+    lldb::clang_type_t element_type = NULL;
+    if (!ClangASTContext::IsPointerType (start_sp->GetClangType(), &element_type) || element_type == NULL)
+        return;
+    ClangASTType clang_element_type (start_sp->GetClangAST(), element_type);
+    const uint32_t element_size = clang_element_type.GetTypeByteSize();
+    if (element_size == 0)
+        return;
+    m_start = start_sp->GetValueAsUnsigned(0);
+    m_finish = finish_sp->GetValueAsUnsigned(0);
+    m_element_type = clang_element_type;
+    m_element_size = element_size;
+}
+
+uint32_t
+lldb_private::formatters::StdVectorSyntheticFrontEnd::CalculateNumChildren ()
+{
+    // Before a vector has been constructed it contains garbage, make sure
+    // we don't come up with a huge number of children out of it
+    if (m_element_size == 0 || m_start == 0 || m_finish == 0 || m_start >= m_finish)
+        return 0;
+    const lldb::addr_t byte_size = m_finish - m_start;
+    if (byte_size % m_element_size)
+        return 0;
+    const lldb::addr_t num_children = byte_size / m_element_size;
+    return num_children < UINT32_MAX ? num_children : UINT32_MAX - 1;
+}
+
+lldb::ValueObjectSP
+lldb_private::formatters::StdVectorSyntheticFrontEnd::GetChildAtIndex (uint32_t idx, bool can_create)
+{
+    if (idx >= CalculateNumChildren())
+        return lldb::ValueObjectSP();
+    const lldb::addr_t child_addr = m_start + (lldb::addr_t)idx * m_element_size;
+    
+    if (m_prefetched_start == LLDB_INVALID_ADDRESS || child_addr < m_prefetched_start || child_addr + m_element_size > m_prefetched_end)
+    {
+        ProcessSP process_sp (m_backend.GetProcessSP());
+        if (process_sp)
+        {
+            const size_t prefetch_size = std::min<lldb::addr_t> (m_finish - child_addr, STD_VECTOR_PREFETCH_BYTE_SIZE);
+            process_sp->PrefetchMemory (child_addr, prefetch_size);
+            m_prefetched_start = child_addr;
+            m_prefetched_end = child_addr + prefetch_size;
+        }
+    }
+    return CreateChildFromMemory (m_backend, idx, child_addr, m_element_type);
+}
+
+uint32_t
+lldb_private::formatters::StdVectorSyntheticFrontEnd::GetIndexOfChildWithName (const ConstString &name)
+{
+    return ExtractIndexFromChildName (name);
+}
+
+lldb_private::formatters::LibstdcppVectorSyntheticFrontEnd::LibstdcppVectorSyntheticFrontEnd (lldb::ValueObjectSP valobj_sp) :
+    StdVectorSyntheticFrontEnd(valobj_sp)
+{
+    if (valobj_sp)
+        Update();
+}
+
+bool
+lldb_private::formatters::LibstdcppVectorSyntheticFrontEnd::Update ()
+{
+    Clear();
+    ValueObjectSP impl_sp (m_backend.GetChildMemberWithName(ConstString("_M_impl"), true));
+    if (!impl_sp)
+        return false;
+    ValueObjectSP start_sp (impl_sp->GetChildMemberWithName(ConstString("_M_start"), true));
+    ValueObjectSP finish_sp (impl_sp->GetChildMemberWithName(ConstString("_M_finish"), true));
+    ValueObjectSP end_sp (impl_sp->GetChildMemberWithName(ConstString("_M_end_of_storage"), true));
+    SetStorage (start_sp, finish_sp);
+    // A vector can't hold more elements than it has storage for
+    if (end_sp && m_finish > end_sp->GetValueAsUnsigned(0))
+        Clear();
+    return false;
+}
+
+lldb_private::formatters::LibcxxVectorSyntheticFrontEnd::LibcxxVectorSyntheticFrontEnd (lldb::ValueObjectSP valobj_sp) :
+    StdVectorSyntheticFrontEnd(valobj_sp)
+{
+    if (valobj_sp)
+        Update();
+}
+
+bool
+lldb_private::formatters::LibcxxVectorSyntheticFrontEnd::Update ()
+{
+    SetStorage (m_backend.GetChildMemberWithName(ConstString("__begin_"), true),
+                m_backend.GetChildMemberWithName(ConstString("__end_"), true));
+    return false;
+}
+
+lldb_private::formatters::StdListSyntheticFrontEnd::StdListSyntheticFrontEnd (lldb::ValueObjectSP valobj_sp) :
+    SyntheticChildrenFrontEnd(*valobj_sp.get()),
+    m_sentinel(LLDB_INVALID_ADDRESS),
+    m_first(LLDB_INVALID_ADDRESS),
+    m_next_offset(0),
+    m_value_offset(0),
+    m_element_type(),
+    m_nodes(),
+    m_found_end(true)
+{
+}
+
+lldb_private::formatters::StdListSyntheticFrontEnd::~StdListSyntheticFrontEnd ()
+{
+}
+
+void
+lldb_private::formatters::StdListSyntheticFrontEnd::Clear ()
+{
+    m_sentinel = LLDB_INVALID_ADDRESS;
+    m_first = LLDB_INVALID_ADDRESS;
+    m_next_offset = 0;
+    m_value_offset = 0;
+    m_element_type = ClangASTType();
+    m_nodes.clear();
+    m_found_end = true;
+}
+
+bool
+lldb_private::formatters::StdListSyntheticFrontEnd::FindNodes (uint32_t idx)
+{
+    if (idx >= STD_CONTAINER_CAPPING_SIZE)
+        return false;
+    if (idx < m_nodes.size())
+        return true;
+    if (m_found_end)
+        return false;
+    
+    ProcessSP process_sp (m_backend.GetProcessSP());
+    if (!process_sp)
+        return false;
+    
+    // Pick up where the last walk stopped, so fetching children in order
+    // only ever reads each node once
+    lldb::addr_t node = m_nodes.empty() ? m_first : m_nodes.back();
+    if (m_nodes.empty())
+    {
+        // An uninitialized list has NULL links, an empty one links to itself
+        if (node == 0 || node == LLDB_INVALID_ADDRESS || node == m_sentinel)
+        {
+            m_found_end = true;
+            return false;
+        }
+        m_nodes.push_back(node);
+    }
+    while (m_nodes.size() <= idx)
+    {
+        Error error;
+        node = process_sp->ReadPointerFromMemory (node + m_next_offset, error);
+        if (error.Fail() || node == 0 || node == m_sentinel)
+        {
+            m_found_end = true;
+            return false;
+        }
+        m_nodes.push_back(node);
+    }
+    return true;
+}
+
+uint32_t
+lldb_private::formatters::StdListSyntheticFrontEnd::CalculateNumChildren ()
+{
+    return CalculateNumChildrenUpTo (UINT32_MAX);
+}
+
+uint32_t
+lldb_private::formatters::StdListSyntheticFrontEnd::CalculateNumChildrenUpTo (uint32_t max)
+{
+    // The only way to count the nodes of a list is to walk it, so don't
+    // walk any further than our caller cares about
+    if (max == 0)
+        return 0;
+    FindNodes (std::min<uint32_t> (max, STD_CONTAINER_CAPPING_SIZE) - 1);
+    const uint32_t num_children = m_nodes.size();
+    return num_children < max ? num_children : max;
+}
+
+lldb::ValueObjectSP
+lldb_private::formatters::StdListSyntheticFrontEnd::GetChildAtIndex (uint32_t idx, bool can_create)
+{
+    if (!FindNodes (idx))
+        return lldb::ValueObjectSP();
+    return CreateChildFromMemory (m_backend, idx, m_nodes[idx] + m_value_offset, m_element_type);
+}
+
+uint32_t
+lldb_private::formatters::StdListSyntheticFrontEnd::GetIndexOfChildWithName (const ConstString &name)
+{
+    return ExtractIndexFromChildName (name);
+}
+
+lldb_private::formatters::LibstdcppListSyntheticFrontEnd::LibstdcppListSyntheticFrontEnd (lldb::ValueObjectSP valobj_sp) :
+    StdListSyntheticFrontEnd(valobj_sp)
+{
+    if (valobj_sp)
+        Update();
+}
+
+bool
+lldb_private::formatters::LibstdcppListSyntheticFrontEnd::Update ()
+{
+    Clear();
+    // struct _List_node_base { _List_node_base* _M_next; _List_node_base* _M_prev; };
+    // with the value of a _List_node<T> following the two links
+    ValueObjectSP impl_sp (m_backend.GetChildMemberWithName(ConstString("_M_impl"), true));
+    if (!impl_sp)
+        return false;
+    ValueObjectSP node_sp (impl_sp->GetChildMemberWithName(ConstString("_M_node"), true));
+    if (!node_sp)
+        return false;
+    ValueObjectSP next_sp (node_sp->GetChildMemberWithName(ConstString("_M_next"), true));
+    ValueObjectSP prev_sp (node_sp->GetChildMemberWithName(ConstString("_M_prev"), true));
+    if (!next_sp || !prev_sp || prev_sp->GetValueAsUnsigned(0) == 0)
+        return false;
+    m_element_type = GetContainerTemplateArgument (m_backend, 0);
+    if (!m_element_type.IsValid())
+        return false;
+    const uint32_t addr_size = m_backend.GetProcessSP() ? m_backend.GetProcessSP()->GetAddressByteSize() : 0;
+    if (addr_size == 0)
+        return false;
+    m_sentinel = node_sp->GetAddressOf();
+    m_first = next_sp->GetValueAsUnsigned(0);
+    m_next_offset = 0;
+    m_value_offset = 2 * addr_size;
+    m_found_end = false;
+    return false;
+}
+
+lldb_private::formatters::LibcxxListSyntheticFrontEnd::LibcxxListSyntheticFrontEnd (lldb::ValueObjectSP valobj_sp) :
+    StdListSyntheticFrontEnd(valobj_sp)
+{
+    if (valobj_sp)
+        Update();
+}
+
+bool
+lldb_private::formatters::LibcxxListSyntheticFrontEnd::Update ()
+{
+    Clear();
+    // struct __list_node_base { __node_pointer __prev_; __node_pointer __next_; };
+    // with the __value_ of a __list_node<T> following the two links
+    ValueObjectSP end_sp (m_backend.GetChildMemberWithName(ConstString("__end_"), true));
+    if (!end_sp)
+        return false;
+    ValueObjectSP next_sp (end_sp->GetChildMemberWithName(ConstString("__next_"), true));
+    ValueObjectSP prev_sp (end_sp->GetChildMemberWithName(ConstString("__prev_"), true));
+    if (!next_sp || !prev_sp || prev_sp->GetValueAsUnsigned(0) == 0)
+        return false;
+    m_element_type = GetContainerTemplateArgument (m_backend, 0);
+    if (!m_element_type.IsValid())
+        return false;
+    const uint32_t addr_size = m_backend.GetProcessSP() ? m_backend.GetProcessSP()->GetAddressByteSize() : 0;
+    if (addr_size == 0)
+        return false;
+    m_sentinel = end_sp->GetAddressOf();
+    m_first = next_sp->GetValueAsUnsigned(0);
+    m_next_offset = addr_size;
+    m_value_offset = 2 * addr_size;
+    m_found_end = false;
+    return false;
+}
+
+lldb_private::formatters::StdMapSyntheticFrontEnd::StdMapSyntheticFrontEnd (lldb::ValueObjectSP valobj_sp) :
+    SyntheticChildrenFrontEnd(*valobj_sp.get()),
+    m_begin(LLDB_INVALID_ADDRESS),
+    m_count(0),
+    m_left_offset(0),
+    m_right_offset(0),
+    m_parent_offset(0),
+    m_value_offset(0),
+    m_element_type(),
+    m_nodes()
+{
+}
+
+lldb_private::formatters::StdMapSyntheticFrontEnd::~StdMapSyntheticFrontEnd ()
+{
+}
+
+void
+lldb_private::formatters::StdMapSyntheticFrontEnd::Clear ()
+{
+    m_begin = LLDB_INVALID_ADDRESS;
+    m_count = 0;
+    m_left_offset = 0;
+    m_right_offset = 0;
+    m_parent_offset = 0;
+    m_value_offset = 0;
+    m_element_type = ClangASTType();
+    m_nodes.clear();
+}
+
+lldb::addr_t
+lldb_private::formatters::StdMapSyntheticFrontEnd::GetNextNode (lldb::addr_t node)
+{
+    ProcessSP process_sp (m_backend.GetProcessSP());
+    if (!process_sp)
+        return LLDB_INVALID_ADDRESS;
+    
+    // Getting to the next node never takes more steps than there are nodes
+    // in a sane tree, if it does we are looking at garbage
+    uint32_t steps = 0;
+    Error error;
+    lldb::addr_t right = process_sp->ReadPointerFromMemory (node + m_right_offset, error);
+    if (error.Fail())
+        return LLDB_INVALID_ADDRESS;
+    if (right != 0)
+    {
+        // The leftmost node of the right subtree
+        node = right;
+        while (true)
+        {
+            lldb::addr_t left = process_sp->ReadPointerFromMemory (node + m_left_offset, error);
+            if (error.Fail())
+                return LLDB_INVALID_ADDRESS;
+            if (left == 0)
+                return node;
+            node = left;
+            if (++steps > m_count)
+                return LLDB_INVALID_ADDRESS;
+        }
+    }
+    // The first ancestor whose left subtree we are in
+    while (true)
+    {
+        lldb::addr_t parent = process_sp->ReadPointerFromMemory (node + m_parent_offset, error);
+        if (error.Fail() || parent == 0)
+            return LLDB_INVALID_ADDRESS;
+        lldb::addr_t parent_left = process_sp->ReadPointerFromMemory (parent + m_left_offset, error);
+        if (error.Fail())
+            return LLDB_INVALID_ADDRESS;
+        if (parent_left == node)
+            return parent;
+        node = parent;
+        if (++steps > m_count)
+            return LLDB_INVALID_ADDRESS;
+    }
+}
+
+uint32_t
+lldb_private::formatters::StdMapSyntheticFrontEnd::CalculateNumChildren ()
+{
+    return m_count;
+}
+
+lldb::ValueObjectSP
+lldb_private::formatters::StdMapSyntheticFrontEnd::GetChildAtIndex (uint32_t idx, bool can_create)
+{
+    if (idx >= m_count)
+        return lldb::ValueObjectSP();
+    if (m_nodes.empty())
+    {
+        if (m_begin == 0 || m_begin == LLDB_INVALID_ADDRESS)
+            return lldb::ValueObjectSP();
+        m_nodes.push_back(m_begin);
+    }
+    // Continue the in-order walk from the last node we found
+    while (m_nodes.size() <= idx)
+    {
+        lldb::addr_t node = GetNextNode (m_nodes.back());
+        if (node == LLDB_INVALID_ADDRESS)
+        {
+            // This tree is garbage, don't hand out any more children
+            m_count = m_nodes.size();
+            return lldb::ValueObjectSP();
+        }
+        m_nodes.push_back(node);
+    }
+    return CreateChildFromMemory (m_backend, idx, m_nodes[idx] + m_value_offset, m_element_type);
+}
+
+uint32_t
+lldb_private::formatters::StdMapSyntheticFrontEnd::GetIndexOfChildWithName (const ConstString &name)
+{
+    return ExtractIndexFromChildName (name);
+}
+
+lldb_private::formatters::LibstdcppMapSyntheticFrontEnd::LibstdcppMapSyntheticFrontEnd (lldb::ValueObjectSP valobj_sp) :
+    StdMapSyntheticFrontEnd(valobj_sp)
+{
+    if (valobj_sp)
+        Update();
+}
+
+bool
+lldb_private::formatters::LibstdcppMapSyntheticFrontEnd::Update ()
+{
+    Clear();
+    // struct _Rb_tree_node_base { _Rb_tree_color _M_color; _Base_ptr _M_parent; _Base_ptr _M_left; _Base_ptr _M_right; };
+    // with the value of a _Rb_tree_node<T> following it. The header node
+    // has the root as its parent and the leftmost node as its left child.
+    ValueObjectSP tree_sp (m_backend.GetChildMemberWithName(ConstString("_M_t"), true));
+    if (!tree_sp)
+        return false;
+    ValueObjectSP impl_sp (tree_sp->GetChildMemberWithName(ConstString("_M_impl"), true));
+    if (!impl_sp)
+        return false;
+    ValueObjectSP header_sp (impl_sp->GetChildMemberWithName(ConstString("_M_header"), true));
+    ValueObjectSP count_sp (impl_sp->GetChildMemberWithName(ConstString("_M_node_count"), true));
+    if (!header_sp || !count_sp)
+        return false;
+    ValueObjectSP root_sp (header_sp->GetChildMemberWithName(ConstString("_M_parent"), true));
+    ValueObjectSP leftmost_sp (header_sp->GetChildMemberWithName(ConstString("_M_left"), true));
+    if (!root_sp || !leftmost_sp || root_sp->GetValueAsUnsigned(0) == 0)
+        return false;
+    // _Rb_tree<Key, Value, KeyOfValue, Compare, Alloc> stores pair<const Key, T> as Value
+    m_element_type = GetContainerTemplateArgument (*tree_sp, 1);
+    if (!m_element_type.IsValid())
+        return false;
+    const uint32_t addr_size = m_backend.GetProcessSP() ? m_backend.GetProcessSP()->GetAddressByteSize() : 0;
+    if (addr_size == 0)
+        return false;
+    m_begin = leftmost_sp->GetValueAsUnsigned(0);
+    m_parent_offset = addr_size;
+    m_left_offset = 2 * addr_size;
+    m_right_offset = 3 * addr_size;
+    m_value_offset = header_sp->GetByteSize();
+    m_count = std::min<uint64_t> (count_sp->GetValueAsUnsigned(0), STD_CONTAINER_CAPPING_SIZE);
+    return false;
+}
+
+lldb_private::formatters::LibcxxMapSyntheticFrontEnd::LibcxxMapSyntheticFrontEnd (lldb::ValueObjectSP valobj_sp) :
+    StdMapSyntheticFrontEnd(valobj_sp)
+{
+    if (valobj_sp)
+        Update();
+}
+
+bool
+lldb_private::formatters::LibcxxMapSyntheticFrontEnd::Update ()
+{
+    Clear();
+    // struct __tree_node_base { pointer __left_; pointer __right_; pointer __parent_; bool __is_black_; };
+    // with the __value_ of a __tree_node<T> following it
+    ValueObjectSP tree_sp (m_backend.GetChildMemberWithName(ConstString("__tree_"), true));
+    if (!tree_sp)
+        return false;
+    ValueObjectSP begin_sp (tree_sp->GetChildMemberWithName(ConstString("__begin_node_"), true));
+    ValueObjectSP pair3_sp (tree_sp->GetChildMemberWithName(ConstString("__pair3_"), true));
+    if (!begin_sp || !pair3_sp)
+        return false;
+    ValueObjectSP count_sp (pair3_sp->GetChildMemberWithName(ConstString("__first_"), true));
+    if (!count_sp)
+        return false;
+    const uint64_t count = count_sp->GetValueAsUnsigned(0);
+    if (count == 0)
+        return false;
+    // __begin_node_ is the only node whose type tells us about the value
+    // a node holds, every other link is a __tree_node_base
+    Error error;
+    ValueObjectSP begin_node_sp (begin_sp->Dereference(error));
+    if (!begin_node_sp || error.Fail())
+        return false;
+    ValueObjectSP value_sp (begin_node_sp->GetChildMemberWithName(ConstString("__value_"), true));
+    if (!value_sp)
+        return false;
+    const uint32_t addr_size = m_backend.GetProcessSP() ? m_backend.GetProcessSP()->GetAddressByteSize() : 0;
+    if (addr_size == 0)
+        return false;
+    m_element_type = ClangASTType (value_sp->GetClangAST(), value_sp->GetClangType());
+    m_begin = begin_sp->GetValueAsUnsigned(0);
+    m_left_offset = 0;
+    m_right_offset = addr_size;
+    m_parent_offset = 2 * addr_size;
+    m_value_offset = value_sp->GetByteOffset();
+    m_count = std::min<uint64_t> (count, STD_CONTAINER_CAPPING_SIZE);
+    return false;
+}
+
+SyntheticChildrenFrontEnd*
+lldb_private::formatters::LibstdcppVectorSyntheticFrontEndCreator (CXXSyntheticChildren*, lldb::ValueObjectSP valobj_sp)
+{
+    if (!valobj_sp)
+        return NULL;
+    return (new LibstdcppVectorSyntheticFrontEnd(valobj_sp));
+}
+
+SyntheticChildrenFrontEnd*
+lldb_private::formatters::LibstdcppListSyntheticFrontEndCreator (CXXSyntheticChildren*, lldb::ValueObjectSP valobj_sp)
+{
+    if (!valobj_sp)
+        return NULL;
+    return (new LibstdcppListSyntheticFrontEnd(valobj_sp));
+}
+
+SyntheticChildrenFrontEnd*
+lldb_private::formatters::LibstdcppMapSyntheticFrontEndCreator (CXXSyntheticChildren*, lldb::ValueObjectSP valobj_sp)
+{
+    if (!valobj_sp)
+        return NULL;
+    return (new LibstdcppMapSyntheticFrontEnd(valobj_sp));
+}
+
+SyntheticChildrenFrontEnd*
+lldb_private::formatters::LibcxxVectorSyntheticFrontEndCreator (CXXSyntheticChildren*, lldb::ValueObjectSP valobj_sp)
+{
+    if (!valobj_sp)
+        return NULL;
+    return (new LibcxxVectorSyntheticFrontEnd(valobj_sp));
+}
+
+SyntheticChildrenFrontEnd*
+lldb_private::formatters::LibcxxListSyntheticFrontEndCreator (CXXSyntheticChildren*, lldb::ValueObjectSP valobj_sp)
+{
+    if (!valobj_sp)
+        return NULL;
+    return (new LibcxxListSyntheticFrontEnd(valobj_sp));
+}
+
+SyntheticChildrenFrontEnd*
+lldb_private::formatters::LibcxxMapSyntheticFrontEndCreator (CXXSyntheticChildren*, lldb::ValueObjectSP valobj_sp)
+{
+    if (!valobj_sp)
+        return NULL;
+    return (new LibcxxMapSyntheticFrontEnd(valobj_sp));
+}
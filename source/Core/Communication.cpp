@@ -39,6 +39,7 @@ Communication::Communication(const char *name) :
     m_read_thread (LLDB_INVALID_HOST_THREAD),
     m_read_thread_enabled (false),
     m_bytes(),
+    m_bytes_pos (0),
     m_bytes_mutex (Mutex::eMutexTypeRecursive),
     m_write_mutex (Mutex::eMutexTypeNormal),
     m_callback (NULL),
@@ -170,7 +171,7 @@ Communication::Read (void *dst, size_t dst_len, uint32_t timeout_usec, Connectio
 
         Listener listener ("Communication::Read");
         listener.StartListeningForEvents (this, eBroadcastBitReadThreadGotBytes | eBroadcastBitReadThreadDidExit);
-        EventSP event_sp;
+        EventIntrusiveSP event_sp;
         while (listener.WaitForEvent (timeout_time.IsValid() ? &timeout_time : NULL, event_sp))
         {
             const uint32_t event_type = event_sp->GetType();
@@ -274,23 +275,46 @@ size_t
 Communication::GetCachedBytes (void *dst, size_t dst_len)
 {
     Mutex::Locker locker(m_bytes_mutex);
-    if (m_bytes.size() > 0)
+    const size_t num_cached_bytes = GetNumCachedBytes();
+    if (num_cached_bytes > 0)
     {
         // If DST is NULL and we have a thread, then return the number
         // of bytes that are available so the caller can call again
         if (dst == NULL)
-            return m_bytes.size();
+            return num_cached_bytes;
 
-        const size_t len = std::min<size_t>(dst_len, m_bytes.size());
+        const size_t len = std::min<size_t>(dst_len, num_cached_bytes);
 
-        ::memcpy (dst, m_bytes.c_str(), len);
-        m_bytes.erase(m_bytes.begin(), m_bytes.begin() + len);
+        ::memcpy (dst, GetCachedBytesStart(), len);
+        ConsumeCachedBytes (len);
 
         return len;
     }
     return 0;
 }
 
+void
+Communication::AppendCachedBytes (const void *src, size_t src_len)
+{
+    if (m_bytes_pos > 0 && m_bytes_pos >= m_bytes.size() / 2)
+    {
+        m_bytes.erase (0, m_bytes_pos);
+        m_bytes_pos = 0;
+    }
+    m_bytes.append ((const char *)src, src_len);
+}
+
+void
+Communication::ConsumeCachedBytes (size_t len)
+{
+    m_bytes_pos += std::min<size_t>(len, GetNumCachedBytes());
+    if (m_bytes_pos == m_bytes.size())
+    {
+        m_bytes.clear();
+        m_bytes_pos = 0;
+    }
+}
+
 void
 Communication::AppendBytesToCache (const uint8_t * bytes, size_t len, bool broadcast, ConnectionStatus status)
 {
@@ -308,7 +332,7 @@ Communication::AppendBytesToCache (const uint8_t * bytes, size_t len, bool broad
     else if (bytes != NULL && len > 0)
     {
         Mutex::Locker locker(m_bytes_mutex);
-        m_bytes.append ((const char *)bytes, len);
+        AppendCachedBytes (bytes, len);
         if (broadcast)
             BroadcastEventIfUnique (eBroadcastBitReadThreadGotBytes);
     }
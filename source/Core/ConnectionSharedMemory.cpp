@@ -10,130 +10,157 @@
 #include "lldb/Core/ConnectionSharedMemory.h"
 
 // C Includes
-#include <errno.h>
-#ifdef LLDB_PTHREAD
-#include <pthread.h>
-#endif
-#include <stdlib.h>
-#ifdef _POSIX_SOURCE
-#include <sys/file.h>
-#include <sys/mman.h>
-#include <sys/stat.h>
-#include <sys/types.h>
-#endif
+#include <unistd.h>
 
 // C++ Includes
 // Other libraries and framework includes
 // Project includes
 #include "lldb/lldb-private-log.h"
-#include "lldb/Core/Communication.h"
+#include "lldb/Core/Error.h"
 #include "lldb/Core/Log.h"
 
 using namespace lldb;
 using namespace lldb_private;
 
-ConnectionSharedMemory::ConnectionSharedMemory () :
+ConnectionSharedMemory::ConnectionSharedMemory (Connection *connection) :
     Connection(),
-    m_name(),
-    m_fd (-1),
-    m_mmap()
+    m_connection_ap (connection),
+    m_transport (),
+    m_write_mutex (Mutex::eMutexTypeNormal),
+    m_active (false)
 {
 }
 
 ConnectionSharedMemory::~ConnectionSharedMemory ()
 {
-    Disconnect (NULL);
+    m_transport.Close();
 }
 
 bool
 ConnectionSharedMemory::IsConnected () const
 {
-    return m_fd >= 0;
+    return m_connection_ap.get() && m_connection_ap->IsConnected();
 }
 
 ConnectionStatus
 ConnectionSharedMemory::Connect (const char *s, Error *error_ptr)
 {
-//    if (s && s[0])
-//    {
-//        if (strstr(s, "shm-create://"))
-//        {
-//        }
-//        else if (strstr(s, "shm-connect://"))
-//        {
-//        }
-//        if (error_ptr)
-//            error_ptr->SetErrorStringWithFormat ("unsupported connection URL: '%s'", s);
-//        return eConnectionStatusError;
-//    }
+    if (m_connection_ap.get())
+        return m_connection_ap->Connect (s, error_ptr);
     if (error_ptr)
-        error_ptr->SetErrorString("invalid connect arguments");
-    return eConnectionStatusError;
+        error_ptr->SetErrorString ("no connection to share memory over");
+    return eConnectionStatusNoConnection;
 }
 
 ConnectionStatus
 ConnectionSharedMemory::Disconnect (Error *error_ptr)
 {
-#ifdef _POSIX_SOURCE
-    m_mmap.Clear();
-    if (!m_name.empty())
-    {
-        shm_unlink (m_name.c_str());
-        m_name.clear();
-    }
-#endif
+    // Another thread can still be reading, so the region is only
+    // unmapped when this object goes away
+    m_active = false;
+    if (m_connection_ap.get())
+        return m_connection_ap->Disconnect (error_ptr);
     return eConnectionStatusSuccess;
 }
 
-size_t
-ConnectionSharedMemory::Read (void *dst, 
-                              size_t dst_len, 
-                              uint32_t timeout_usec,
-                              ConnectionStatus &status, 
-                              Error *error_ptr)
+bool
+ConnectionSharedMemory::Create (size_t ring_size, Error *error_ptr)
 {
-    status = eConnectionStatusSuccess;
-    return 0;
+    if (m_transport.Create (ring_size))
+        return true;
+    if (error_ptr)
+        error_ptr->SetErrorToErrno();
+    return false;
 }
 
-size_t
-ConnectionSharedMemory::Write (const void *src, size_t src_len, ConnectionStatus &status, Error *error_ptr)
+void
+ConnectionSharedMemory::Activate ()
 {
-    status = eConnectionStatusSuccess;
-    return 0;
+    // Both sides have it mapped, the name isn't needed any more
+    m_transport.Unlink();
+    m_active = m_transport.IsValid();
+    LogSP log (lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_CONNECTION));
+    if (log)
+        log->Printf ("%p ConnectionSharedMemory::Activate () => %s", this, m_active ? "active" : "no region");
 }
 
-ConnectionStatus
-ConnectionSharedMemory::BytesAvailable (uint32_t timeout_usec, Error *error_ptr)
+void
+ConnectionSharedMemory::Abandon ()
 {
-    return eConnectionStatusLostConnection;
+    m_active = false;
+    m_transport.Close();
 }
 
-ConnectionStatus
-ConnectionSharedMemory::Open (bool create, const char *name, size_t size, Error *error_ptr)
+size_t
+ConnectionSharedMemory::Read (void *dst,
+                              size_t dst_len,
+                              uint32_t timeout_usec,
+                              ConnectionStatus &status,
+                              Error *error_ptr)
 {
-#ifdef _POSIX_SOURCE
-    if (m_fd != -1)
+    if (m_connection_ap.get() == NULL)
+    {
+        status = eConnectionStatusNoConnection;
+        return 0;
+    }
+    if (!m_active)
+        return m_connection_ap->Read (dst, dst_len, timeout_usec, status, error_ptr);
+
+    while (true)
     {
-        if (error_ptr)
-            error_ptr->SetErrorString("already open");
-        return eConnectionStatusError;
+        const size_t bytes_read = m_transport.Read (dst, dst_len);
+        if (bytes_read > 0)
+        {
+            status = eConnectionStatusSuccess;
+            return bytes_read;
+        }
+        if (!m_transport.PrepareToWait())
+            continue;
+
+        // Sleep on the connection until the other side wakes us up, the
+        // bytes that do it don't mean anything
+        char wake_up_bytes[64];
+        m_connection_ap->Read (wake_up_bytes, sizeof(wake_up_bytes), timeout_usec, status, error_ptr);
+        if (status != eConnectionStatusSuccess)
+            return 0;
     }
-    
-    m_name.assign (name);
-    int oflag = O_RDWR;
-    if (create)
-        oflag |= O_CREAT;
-    m_fd = ::shm_open (m_name.c_str(), oflag, S_IRUSR|S_IWUSR);
-
-    if (create)
-        ::ftruncate (m_fd, size);
-
-    if (m_mmap.MemoryMapFromFileDescriptor(m_fd, 0, size, true, false) == size)
-        return eConnectionStatusSuccess;
-
-    Disconnect(NULL);
-#endif
-    return eConnectionStatusError;
 }
 
+size_t
+ConnectionSharedMemory::Write (const void *src, size_t src_len, ConnectionStatus &status, Error *error_ptr)
+{
+    if (m_connection_ap.get() == NULL)
+    {
+        status = eConnectionStatusNoConnection;
+        return 0;
+    }
+    if (!m_active)
+        return m_connection_ap->Write (src, src_len, status, error_ptr);
+
+    Mutex::Locker locker (m_write_mutex);
+    status = eConnectionStatusSuccess;
+    size_t total_bytes_written = 0;
+    while (total_bytes_written < src_len)
+    {
+        const size_t bytes_written = m_transport.Write ((const uint8_t *)src + total_bytes_written, src_len - total_bytes_written);
+        total_bytes_written += bytes_written;
+        if (bytes_written > 0 && m_transport.ShouldWakeReader())
+        {
+            const char wake_up_byte = '\0';
+            m_connection_ap->Write (&wake_up_byte, 1, status, error_ptr);
+            if (status != eConnectionStatusSuccess)
+                break;
+        }
+        if (total_bytes_written < src_len)
+        {
+            // The ring is full, give the other side a chance to empty it
+            if (!m_connection_ap->IsConnected())
+            {
+                status = eConnectionStatusLostConnection;
+                break;
+            }
+            ::usleep (50);
+        }
+    }
+    return total_bytes_written;
+}
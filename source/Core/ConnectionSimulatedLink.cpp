@@ -0,0 +1,110 @@
+//===-- ConnectionSimulatedLink.cpp -----------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "lldb/Core/ConnectionSimulatedLink.h"
+
+// C Includes
+#include <unistd.h>
+
+// C++ Includes
+// Other libraries and framework includes
+// Project includes
+#include "lldb/Core/Error.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+static void
+SleepMicroseconds (uint64_t usec)
+{
+    // usleep() doesn't have to take more than a second at a time
+    while (usec > 0)
+    {
+        const uint64_t chunk_usec = usec < 500000 ? usec : 500000;
+        ::usleep (chunk_usec);
+        usec -= chunk_usec;
+    }
+}
+
+ConnectionSimulatedLink::ConnectionSimulatedLink (Connection *connection,
+                                                  uint32_t latency_usec,
+                                                  uint64_t bytes_per_second) :
+    Connection(),
+    m_connection_ap (connection),
+    m_latency_usec (latency_usec),
+    m_bytes_per_second (bytes_per_second)
+{
+}
+
+ConnectionSimulatedLink::~ConnectionSimulatedLink ()
+{
+}
+
+bool
+ConnectionSimulatedLink::IsConnected () const
+{
+    return m_connection_ap.get() && m_connection_ap->IsConnected();
+}
+
+ConnectionStatus
+ConnectionSimulatedLink::Connect (const char *s, Error *error_ptr)
+{
+    if (m_connection_ap.get())
+        return m_connection_ap->Connect (s, error_ptr);
+    if (error_ptr)
+        error_ptr->SetErrorString ("no connection to simulate a link for");
+    return eConnectionStatusNoConnection;
+}
+
+ConnectionStatus
+ConnectionSimulatedLink::Disconnect (Error *error_ptr)
+{
+    if (m_connection_ap.get())
+        return m_connection_ap->Disconnect (error_ptr);
+    return eConnectionStatusSuccess;
+}
+
+size_t
+ConnectionSimulatedLink::Read (void *dst, 
+                               size_t dst_len, 
+                               uint32_t timeout_usec,
+                               ConnectionStatus &status, 
+                               Error *error_ptr)
+{
+    if (m_connection_ap.get() == NULL)
+    {
+        status = eConnectionStatusNoConnection;
+        return 0;
+    }
+    const size_t bytes_read = m_connection_ap->Read (dst, dst_len, timeout_usec, status, error_ptr);
+    SleepForBytes (bytes_read);
+    return bytes_read;
+}
+
+size_t
+ConnectionSimulatedLink::Write (const void *src, size_t src_len, ConnectionStatus &status, Error *error_ptr)
+{
+    if (m_connection_ap.get() == NULL)
+    {
+        status = eConnectionStatusNoConnection;
+        return 0;
+    }
+    SleepMicroseconds (m_latency_usec);
+    SleepForBytes (src_len);
+    return m_connection_ap->Write (src, src_len, status, error_ptr);
+}
+
+void
+ConnectionSimulatedLink::SleepForBytes (size_t num_bytes)
+{
+    if (m_bytes_per_second > 0 && num_bytes > 0)
+    {
+        SleepMicroseconds ((num_bytes * 1000000ull) / m_bytes_per_second);
+    }
+}
@@ -9,6 +9,7 @@
 #include "lldb/Core/ConstString.h"
 #include "lldb/Core/Stream.h"
 #include "lldb/Host/Mutex.h"
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/ADT/StringMap.h"
 
 using namespace lldb_private;
@@ -26,9 +27,7 @@ public:
     //
     // Initialize the member variables and create the empty string.
     //------------------------------------------------------------------
-    Pool () :
-        m_mutex (Mutex::eMutexTypeRecursive),
-        m_string_map ()
+    Pool ()
     {
     }
 
@@ -52,6 +51,8 @@ public:
     {
         if (ccstr)
         {
+            // The length of a string is never modified once the entry has
+            // been created, so no locking is needed here.
             const StringPoolEntryType&entry = GetStringMapEntryFromKeyData (ccstr);
             return entry.getKey().size();
         }
@@ -62,7 +63,11 @@ public:
     GetMangledCounterpart (const char *ccstr) const
     {
         if (ccstr)
-            return GetStringMapEntryFromKeyData (ccstr).getValue();
+        {
+            const StringPoolEntryType &entry = GetStringMapEntryFromKeyData (ccstr);
+            Mutex::Locker locker (m_string_pools[Hash (entry.getKey())].m_mutex);
+            return entry.getValue();
+        }
         return 0;
     }
 
@@ -71,8 +76,8 @@ public:
     {
         if (key_ccstr && value_ccstr)
         {
-            GetStringMapEntryFromKeyData (key_ccstr).setValue(value_ccstr);
-            GetStringMapEntryFromKeyData (value_ccstr).setValue(key_ccstr);
+            SetMangledCounterpart (key_ccstr, value_ccstr);
+            SetMangledCounterpart (value_ccstr, key_ccstr);
             return true;
         }
         return false;
@@ -90,12 +95,7 @@ public:
     GetConstCStringWithLength (const char *cstr, int cstr_len)
     {
         if (cstr)
-        {
-            Mutex::Locker locker (m_mutex);
-            llvm::StringRef string_ref (cstr, cstr_len);
-            StringPoolEntryType& entry = m_string_map.GetOrCreateValue (string_ref, (StringPoolValueType)NULL);
-            return entry.getKeyData();
-        }
+            return GetConstCStringWithStringRef (llvm::StringRef (cstr, cstr_len));
         return NULL;
     }
 
@@ -104,8 +104,9 @@ public:
     {
         if (string_ref.data())
         {
-            Mutex::Locker locker (m_mutex);
-            StringPoolEntryType& entry = m_string_map.GetOrCreateValue (string_ref, (StringPoolValueType)NULL);
+            PoolEntry &pool = m_string_pools[Hash (string_ref)];
+            Mutex::Locker locker (pool.m_mutex);
+            StringPoolEntryType& entry = pool.m_string_map.GetOrCreateValue (string_ref, (StringPoolValueType)NULL);
             return entry.getKeyData();
         }
         return NULL;
@@ -116,21 +117,36 @@ public:
     {
         if (demangled_cstr)
         {
-            Mutex::Locker locker (m_mutex);
-            // Make string pool entry with the mangled counterpart already set
-            StringPoolEntryType& entry = m_string_map.GetOrCreateValue (llvm::StringRef (demangled_cstr), mangled_ccstr);
-
-            // Extract the const version of the demangled_cstr
-            const char *demangled_ccstr = entry.getKeyData();
+            const char *demangled_ccstr = NULL;
+            {
+                llvm::StringRef string_ref (demangled_cstr);
+                PoolEntry &pool = m_string_pools[Hash (string_ref)];
+                Mutex::Locker locker (pool.m_mutex);
+                // Make string pool entry with the mangled counterpart already set
+                StringPoolEntryType& entry = pool.m_string_map.GetOrCreateValue (string_ref, mangled_ccstr);
+
+                // Extract the const version of the demangled_cstr
+                demangled_ccstr = entry.getKeyData();
+            }
             // Now assign the demangled const string as the counterpart of the
-            // mangled const string...
-            GetStringMapEntryFromKeyData (mangled_ccstr).setValue(demangled_ccstr);
+            // mangled const string. The mangled string lives in its own pool
+            // so we only ever hold one pool mutex at a time.
+            SetMangledCounterpart (mangled_ccstr, demangled_ccstr);
             // Return the constant demangled C string
             return demangled_ccstr;
         }
         return NULL;
     }
 
+    void
+    SetEmptyMangledCounterpart (const char *mangled_ccstr)
+    {
+        // Only the mangled string points to the empty string, the empty
+        // string keeps whatever counterpart it had.
+        if (mangled_ccstr)
+            SetMangledCounterpart (mangled_ccstr, GetConstCString (""));
+    }
+
     const char *
     GetConstTrimmedCStringWithLength (const char *cstr, int cstr_len)
     {
@@ -150,12 +166,15 @@ public:
     size_t
     MemorySize() const
     {
-        Mutex::Locker locker (m_mutex);
         size_t mem_size = sizeof(Pool);
-        const_iterator end = m_string_map.end();
-        for (const_iterator pos = m_string_map.begin(); pos != end; ++pos)
+        for (uint32_t i=0; i<kNumPools; ++i)
         {
-            mem_size += sizeof(StringPoolEntryType) + pos->getKey().size();
+            Mutex::Locker locker (m_string_pools[i].m_mutex);
+            const_iterator end = m_string_pools[i].m_string_map.end();
+            for (const_iterator pos = m_string_pools[i].m_string_map.begin(); pos != end; ++pos)
+            {
+                mem_size += sizeof(StringPoolEntryType) + pos->getKey().size();
+            }
         }
         return mem_size;
     }
@@ -167,11 +186,46 @@ protected:
     typedef StringPool::iterator iterator;
     typedef StringPool::const_iterator const_iterator;
 
+    //------------------------------------------------------------------
+    // The strings are spread across a number of independently locked
+    // string maps, selected by the hash of the string, so threads that
+    // create strings at the same time rarely contend for the same lock.
+    // A given string always hashes to the same map, so each string is
+    // still uniqued to a single pointer value.
+    //------------------------------------------------------------------
+    enum { kNumPoolsLog2 = 8, kNumPools = 1u << kNumPoolsLog2 };
+
+    struct PoolEntry
+    {
+        PoolEntry () :
+            m_mutex (Mutex::eMutexTypeNormal),
+            m_string_map ()
+        {
+        }
+
+        mutable Mutex m_mutex;
+        StringPool m_string_map;
+    };
+
+    static uint32_t
+    Hash (const llvm::StringRef &s)
+    {
+        const uint32_t h = llvm::HashString (s);
+        return ((h >> 24) ^ (h >> 16) ^ (h >> 8) ^ h) & (kNumPools - 1);
+    }
+
+    void
+    SetMangledCounterpart (const char *key_ccstr, const char *value_ccstr)
+    {
+        StringPoolEntryType &entry = GetStringMapEntryFromKeyData (key_ccstr);
+        Mutex::Locker locker (m_string_pools[Hash (entry.getKey())].m_mutex);
+        entry.setValue (value_ccstr);
+    }
+
     //------------------------------------------------------------------
     // Member variables
     //------------------------------------------------------------------
-    mutable Mutex m_mutex;
-    StringPool m_string_map;
+    PoolEntry m_string_pools[kNumPools];
 };
 
 //----------------------------------------------------------------------
@@ -312,6 +366,12 @@ ConstString::SetCStringWithMangledCounterpart (const char *demangled, const Cons
     m_string = StringPool().GetConstCStringAndSetMangledCounterPart (demangled, mangled.m_string);
 }
 
+void
+ConstString::SetEmptyMangledCounterpart () const
+{
+    StringPool().SetEmptyMangledCounterpart (m_string);
+}
+
 bool
 ConstString::GetMangledCounterpart (ConstString &counterpart) const
 {
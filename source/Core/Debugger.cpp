@@ -29,6 +29,7 @@
 #include "lldb/Core/ValueObject.h"
 #include "lldb/Core/ValueObjectVariable.h"
 #include "lldb/Host/Terminal.h"
+#include "lldb/Host/ThreadPool.h"
 #include "lldb/Interpreter/CommandInterpreter.h"
 #include "lldb/Interpreter/OptionValueSInt64.h"
 #include "lldb/Interpreter/OptionValueString.h"
@@ -110,6 +111,7 @@ static PropertyDefinition
 g_properties[] =
 {
 {   "auto-confirm",             OptionValue::eTypeBoolean, true, false, NULL, NULL, "If true all confirmation prompts will receive their default reply." },
+{   "file-cache-timeout",       OptionValue::eTypeUInt64 , true, 5    , NULL, NULL, "The number of seconds that resolved file paths and file status results are reused for before the file system is checked again. Zero turns the cache off." },
 {   "frame-format",             OptionValue::eTypeString , true, 0    , DEFAULT_FRAME_FORMAT, NULL, "The default frame format string to use when displaying stack frame information for threads." },
 {   "notify-void",              OptionValue::eTypeBoolean, true, false, NULL, NULL, "Notify the user explicitly if an expression returns void (default: false)." },
 {   "prompt",                   OptionValue::eTypeString , true, OptionValueString::eOptionEncodeCharacterEscapeSequences, "(lldb) ", NULL, "The debugger command line prompt displayed for the user." },
@@ -120,6 +122,7 @@ g_properties[] =
 {   "stop-line-count-before",   OptionValue::eTypeSInt64 , true, 3    , NULL, NULL, "The number of sources lines to display that come before the current source line when displaying a stopped context." },
 {   "term-width",               OptionValue::eTypeSInt64 , true, 80   , NULL, NULL, "The maximum number of columns to use for displaying text." },
 {   "thread-format",            OptionValue::eTypeString , true, 0    , DEFAULT_THREAD_FORMAT, NULL, "The default thread format string to use when displaying thread information." },
+{   "thread-pool-size",         OptionValue::eTypeUInt64 , true, 0    , NULL, NULL, "The most worker threads LLDB uses for work it does in parallel, like indexing debug information and searching modules. Zero means one per CPU." },
 {   "use-external-editor",      OptionValue::eTypeBoolean, true, false, NULL, NULL, "Whether to use an external editor or not." },
 {   NULL,                       OptionValue::eTypeInvalid, true, 0    , NULL, NULL, NULL }
 };
@@ -127,6 +130,7 @@ g_properties[] =
 enum
 {
     ePropertyAutoConfirm = 0,
+    ePropertyFileCacheTimeout,
     ePropertyFrameFormat,
     ePropertyNotiftVoid,
     ePropertyPrompt,
@@ -137,6 +141,7 @@ enum
     ePropertyStopLineCountBefore,
     ePropertyTerminalWidth,
     ePropertyThreadFormat,
+    ePropertyThreadPoolSize,
     ePropertyUseExternalEditor
 };
 
@@ -166,9 +171,17 @@ Debugger::SetPropertyValue (const ExecutionContext *exe_ctx,
         if (strcmp(property_path, g_properties[ePropertyPrompt].name) == 0)
         {
             const char *new_prompt = GetPrompt();
-            EventSP prompt_change_event_sp (new Event(CommandInterpreter::eBroadcastBitResetPrompt, new EventDataBytes (new_prompt)));
+            EventIntrusiveSP prompt_change_event_sp (new Event(CommandInterpreter::eBroadcastBitResetPrompt, new EventDataBytes (new_prompt)));
             GetCommandInterpreter().BroadcastEvent (prompt_change_event_sp);
         }
+        else if (strcmp(property_path, g_properties[ePropertyThreadPoolSize].name) == 0)
+        {
+            ThreadPool::GetSharedThreadPool().SetMaximumNumberOfThreads (GetThreadPoolSize());
+        }
+        else if (strcmp(property_path, g_properties[ePropertyFileCacheTimeout].name) == 0)
+        {
+            FileSpec::SetFileCacheTimeout (GetFileCacheTimeout());
+        }
     }
     return error;
 }
@@ -180,11 +193,18 @@ Debugger::GetAutoConfirm () const
     return m_collection_sp->GetPropertyAtIndexAsBoolean (NULL, idx, g_properties[idx].default_uint_value != 0);
 }
 
+uint32_t
+Debugger::GetFileCacheTimeout () const
+{
+    const uint32_t idx = ePropertyFileCacheTimeout;
+    return m_collection_sp->GetPropertyAtIndexAsUInt64 (NULL, idx, g_properties[idx].default_uint_value);
+}
+
 const char *
 Debugger::GetFrameFormat() const
 {
     const uint32_t idx = ePropertyFrameFormat;
-    return m_collection_sp->GetPropertyAtIndexAsString (NULL, idx, g_properties[idx].default_cstr_value);
+    return m_frame_format.GetStringValue (*m_collection_sp, g_properties[idx].default_cstr_value);
 }
 
 bool
@@ -207,7 +227,7 @@ Debugger::SetPrompt(const char *p)
     const uint32_t idx = ePropertyPrompt;
     m_collection_sp->SetPropertyAtIndexAsString (NULL, idx, p);
     const char *new_prompt = GetPrompt();
-    EventSP prompt_change_event_sp (new Event(CommandInterpreter::eBroadcastBitResetPrompt, new EventDataBytes (new_prompt)));;
+    EventIntrusiveSP prompt_change_event_sp (new Event(CommandInterpreter::eBroadcastBitResetPrompt, new EventDataBytes (new_prompt)));;
     GetCommandInterpreter().BroadcastEvent (prompt_change_event_sp);
 }
 
@@ -215,7 +235,33 @@ const char *
 Debugger::GetThreadFormat() const
 {
     const uint32_t idx = ePropertyThreadFormat;
-    return m_collection_sp->GetPropertyAtIndexAsString (NULL, idx, g_properties[idx].default_cstr_value);
+    return m_thread_format.GetStringValue (*m_collection_sp, g_properties[idx].default_cstr_value);
+}
+
+static PromptFormatSP
+GetCompiledFormat (const char *format, PromptFormatSP &compiled_format_sp)
+{
+    if (format == NULL)
+        return PromptFormatSP();
+    // Comparing is much cheaper than parsing, and catches every way the
+    // setting can be changed
+    if (!compiled_format_sp || ::strcmp (compiled_format_sp->GetFormat(), format) != 0)
+        compiled_format_sp.reset (new PromptFormat (format));
+    return compiled_format_sp;
+}
+
+PromptFormatSP
+Debugger::GetCompiledFrameFormat ()
+{
+    Mutex::Locker locker (m_compiled_formats_mutex);
+    return GetCompiledFormat (GetFrameFormat(), m_compiled_frame_format_sp);
+}
+
+PromptFormatSP
+Debugger::GetCompiledThreadFormat ()
+{
+    Mutex::Locker locker (m_compiled_formats_mutex);
+    return GetCompiledFormat (GetThreadFormat(), m_compiled_thread_format_sp);
 }
 
 lldb::ScriptLanguage
@@ -246,6 +292,13 @@ Debugger::SetTerminalWidth (uint32_t term_width)
     return m_collection_sp->SetPropertyAtIndexAsSInt64 (NULL, idx, term_width);
 }
 
+uint32_t
+Debugger::GetThreadPoolSize () const
+{
+    const uint32_t idx = ePropertyThreadPoolSize;
+    return m_collection_sp->GetPropertyAtIndexAsUInt64 (NULL, idx, g_properties[idx].default_uint_value);
+}
+
 bool
 Debugger::GetUseExternalEditor () const
 {
@@ -444,7 +497,12 @@ Debugger::Debugger (lldb::LogOutputCallback log_callback, void *baton) :
     m_command_interpreter_ap (new CommandInterpreter (*this, eScriptLanguageDefault, false)),
     m_input_reader_stack (),
     m_input_reader_data (),
-    m_instance_name()
+    m_instance_name(),
+    m_frame_format (ePropertyFrameFormat, OptionValue::eTypeString),
+    m_thread_format (ePropertyThreadFormat, OptionValue::eTypeString),
+    m_compiled_formats_mutex (Mutex::eMutexTypeNormal),
+    m_compiled_frame_format_sp (),
+    m_compiled_thread_format_sp ()
 {
     char instance_cstr[256];
     snprintf(instance_cstr, sizeof(instance_cstr), "debugger_%d", (int)GetID());
@@ -569,7 +627,11 @@ Debugger::SetOutputFileHandle (FILE *fh, bool tranfer_ownership)
     if (out_file.IsValid() == false)
         out_file.SetStream (stdout, false);
     
-    GetCommandInterpreter().GetScriptInterpreter()->ResetOutputFileHandle (fh);
+    // Don't start up the script interpreter just to tell it about the
+    // new handle, it picks up the output file when it is made
+    ScriptInterpreter *script_interpreter = GetCommandInterpreter().GetScriptInterpreterIfCreated();
+    if (script_interpreter)
+        script_interpreter->ResetOutputFileHandle (fh);
 }
 
 void
@@ -1140,1314 +1202,1250 @@ ExpandIndexedExpression (ValueObject* valobj,
     return item;
 }
 
-bool
-Debugger::FormatPrompt 
-(
-    const char *format,
-    const SymbolContext *sc,
-    const ExecutionContext *exe_ctx,
-    const Address *addr,
-    Stream &s,
-    const char **end,
-    ValueObject* valobj
-)
+// Print the "${...}" variable whose name starts at var_name_begin and
+// ends with the '}' at var_name_end. "${svar...}" switches valobj to its
+// synthetic value for the rest of the format.
+static bool
+FormatPromptVariable (const char *var_name_begin,
+                      const char *var_name_end,
+                      const SymbolContext *sc,
+                      const ExecutionContext *exe_ctx,
+                      const Address *addr,
+                      Stream &s,
+                      ValueObject *&valobj)
 {
-    ValueObject* realvalobj = NULL; // makes it super-easy to parse pointers
-    bool success = true;
-    const char *p;
     LogSP log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_TYPES));
-    for (p = format; *p != '\0'; ++p)
+
+    const char *cstr = NULL;
+    Address format_addr;
+    bool calculate_format_addr_function_offset = false;
+    // Set reg_kind and reg_num to invalid values
+    RegisterKind reg_kind = kNumRegisterKinds; 
+    uint32_t reg_num = LLDB_INVALID_REGNUM;
+    FileSpec format_file_spec;
+    const RegisterInfo *reg_info = NULL;
+    RegisterContext *reg_ctx = NULL;
+    bool do_deref_pointer = false;
+    ValueObject::ExpressionPathScanEndReason reason_to_stop = ValueObject::eExpressionPathScanEndReasonEndOfString;
+    ValueObject::ExpressionPathEndResultType final_value_type = ValueObject::eExpressionPathEndResultTypePlain;
+
+    // Each variable must set success to true below...
+    bool var_success = false;
+    switch (var_name_begin[0])
     {
-        if (realvalobj)
-        {
-            valobj = realvalobj;
-            realvalobj = NULL;
-        }
-        size_t non_special_chars = ::strcspn (p, "${}\\");
-        if (non_special_chars > 0)
+    case '*':
+    case 'v':
+    case 's':
         {
-            if (success)
-                s.Write (p, non_special_chars);
-            p += non_special_chars;            
-        }
+            if (!valobj)
+                break;
 
-        if (*p == '\0')
-        {
-            break;
-        }
-        else if (*p == '{')
-        {
-            // Start a new scope that must have everything it needs if it is to
-            // to make it into the final output stream "s". If you want to make
-            // a format that only prints out the function or symbol name if there
-            // is one in the symbol context you can use:
-            //      "{function =${function.name}}"
-            // The first '{' starts a new scope that end with the matching '}' at
-            // the end of the string. The contents "function =${function.name}"
-            // will then be evaluated and only be output if there is a function
-            // or symbol with a valid name. 
-            StreamString sub_strm;
-
-            ++p;  // Skip the '{'
-            
-            if (FormatPrompt (p, sc, exe_ctx, addr, sub_strm, &p, valobj))
+            if (log)
+                log->Printf("initial string: %s",var_name_begin);
+
+            // check for *var and *svar
+            if (*var_name_begin == '*')
+            {
+                do_deref_pointer = true;
+                var_name_begin++;
+            }
+
+            if (log)
+                log->Printf("initial string: %s",var_name_begin);
+
+            if (*var_name_begin == 's')
+            {
+                if (!valobj->IsSynthetic())
+                    valobj = valobj->GetSyntheticValue().get();
+                if (!valobj)
+                    break;
+                var_name_begin++;
+            }
+
+            if (log)
+                log->Printf("initial string: %s",var_name_begin);
+
+            // should be a 'v' by now
+            if (*var_name_begin != 'v')
+                break;
+
+            if (log)
+                log->Printf("initial string: %s",var_name_begin);
+
+            ValueObject::ExpressionPathAftermath what_next = (do_deref_pointer ?
+                                                              ValueObject::eExpressionPathAftermathDereference : ValueObject::eExpressionPathAftermathNothing);
+            ValueObject::GetValueForExpressionPathOptions options;
+            options.DontCheckDotVsArrowSyntax().DoAllowBitfieldSyntax().DoAllowFragileIVar().DoAllowSyntheticChildren();
+            ValueObject::ValueObjectRepresentationStyle val_obj_display = ValueObject::eValueObjectRepresentationStyleSummary;
+            ValueObject* target = NULL;
+            Format custom_format = eFormatInvalid;
+            const char* var_name_final = NULL;
+            const char* var_name_final_if_array_range = NULL;
+            const char* close_bracket_position = NULL;
+            int64_t index_lower = -1;
+            int64_t index_higher = -1;
+            bool is_array_range = false;
+            const char* first_unparsed;
+            bool was_plain_var = false;
+            bool was_var_format = false;
+            bool was_var_indexed = false;
+
+            if (!valobj) break;
+            // simplest case ${var}, just print valobj's value
+            if (::strncmp (var_name_begin, "var}", strlen("var}")) == 0)
+            {
+                was_plain_var = true;
+                target = valobj;
+                val_obj_display = ValueObject::eValueObjectRepresentationStyleValue;
+            }
+            else if (::strncmp(var_name_begin,"var%",strlen("var%")) == 0)
             {
-                // The stream had all it needed
-                s.Write(sub_strm.GetData(), sub_strm.GetSize());
+                was_var_format = true;
+                // this is a variable with some custom format applied to it
+                const char* percent_position;
+                target = valobj;
+                val_obj_display = ValueObject::eValueObjectRepresentationStyleValue;
+                ScanFormatDescriptor (var_name_begin,
+                                      var_name_end,
+                                      &var_name_final,
+                                      &percent_position,
+                                      &custom_format,
+                                      &val_obj_display);
             }
-            if (*p != '}')
+                // this is ${var.something} or multiple .something nested
+            else if (::strncmp (var_name_begin, "var", strlen("var")) == 0)
             {
-                success = false;
+                if (::strncmp(var_name_begin, "var[", strlen("var[")) == 0)
+                    was_var_indexed = true;
+                const char* percent_position;
+                ScanFormatDescriptor (var_name_begin,
+                                      var_name_end,
+                                      &var_name_final,
+                                      &percent_position,
+                                      &custom_format,
+                                      &val_obj_display);
+
+                const char* open_bracket_position;
+                const char* separator_position;
+                ScanBracketedRange (var_name_begin,
+                                    var_name_end,
+                                    var_name_final,
+                                    &open_bracket_position,
+                                    &separator_position,
+                                    &close_bracket_position,
+                                    &var_name_final_if_array_range,
+                                    &index_lower,
+                                    &index_higher);
+
+                Error error;
+
+                std::auto_ptr<char> expr_path(new char[var_name_final-var_name_begin-1]);
+                ::memset(expr_path.get(), 0, var_name_final-var_name_begin-1);
+                memcpy(expr_path.get(), var_name_begin+3,var_name_final-var_name_begin-3);
+
+                if (log)
+                    log->Printf("symbol to expand: %s",expr_path.get());
+
+                target = valobj->GetValueForExpressionPath(expr_path.get(),
+                                                         &first_unparsed,
+                                                         &reason_to_stop,
+                                                         &final_value_type,
+                                                         options,
+                                                         &what_next).get();
+
+                if (!target)
+                {
+                    if (log)
+                        log->Printf("ERROR: unparsed portion = %s, why stopping = %d,"
+                           " final_value_type %d",
+                           first_unparsed, reason_to_stop, final_value_type);
+                    break;
+                }
+                else
+                {
+                    if (log)
+                        log->Printf("ALL RIGHT: unparsed portion = %s, why stopping = %d,"
+                           " final_value_type %d",
+                           first_unparsed, reason_to_stop, final_value_type);
+                }
+            }
+            else
+                break;
+
+            is_array_range = (final_value_type == ValueObject::eExpressionPathEndResultTypeBoundedRange ||
+                              final_value_type == ValueObject::eExpressionPathEndResultTypeUnboundedRange);
+
+            do_deref_pointer = (what_next == ValueObject::eExpressionPathAftermathDereference);
+
+            if (do_deref_pointer && !is_array_range)
+            {
+                // I have not deref-ed yet, let's do it
+                // this happens when we are not going through GetValueForVariableExpressionPath
+                // to get to the target ValueObject
+                Error error;
+                target = target->Dereference(error).get();
+                if (error.Fail())
+                {
+                    if (log)
+                        log->Printf("ERROR: %s\n", error.AsCString("unknown")); \
+                    break;
+                }
+                do_deref_pointer = false;
+            }
+
+            // <rdar://problem/11338654>
+            // we do not want to use the summary for a bitfield of type T:n
+            // if we were originally dealing with just a T - that would get
+            // us into an endless recursion
+            if (target->IsBitfield() && was_var_indexed)
+            {
+                // TODO: check for a (T:n)-specific summary - we should still obey that
+                StreamString bitfield_name;
+                bitfield_name.Printf("%s:%d", target->GetTypeName().AsCString(), target->GetBitfieldBitSize());
+                lldb::TypeNameSpecifierImplSP type_sp(new TypeNameSpecifierImpl(bitfield_name.GetData(),false));
+                if (!DataVisualization::GetSummaryForType(type_sp))
+                    val_obj_display = ValueObject::eValueObjectRepresentationStyleValue;
+            }
+
+            // TODO use flags for these
+            bool is_array = ClangASTContext::IsArrayType(target->GetClangType());
+            bool is_pointer = ClangASTContext::IsPointerType(target->GetClangType());
+            bool is_aggregate = ClangASTContext::IsAggregateType(target->GetClangType());
+
+            if ((is_array || is_pointer) && (!is_array_range) && val_obj_display == ValueObject::eValueObjectRepresentationStyleValue) // this should be wrong, but there are some exceptions
+            {
+                StreamString str_temp;
+                if (log)
+                    log->Printf("I am into array || pointer && !range");
+
+                if (target->HasSpecialPrintableRepresentation(val_obj_display,
+                                                              custom_format))
+                {
+                    // try to use the special cases
+                    var_success = target->DumpPrintableRepresentation(str_temp,
+                                                                      val_obj_display,
+                                                                      custom_format);
+                    if (log)
+                        log->Printf("special cases did%s match", var_success ? "" : "n't");
+
+                    // should not happen
+                    if (!var_success)
+                        s << "<invalid usage of pointer value as object>";
+                    else
+                        s << str_temp.GetData();
+                    var_success = true;
+                    break;
+                }
+                else
+                {
+                    if (was_plain_var) // if ${var}
+                    {
+                        s << target->GetTypeName() << " @ " << target->GetLocationAsCString();
+                    }
+                    else if (is_pointer) // if pointer, value is the address stored
+                    {
+                        target->DumpPrintableRepresentation (s,
+                                                             val_obj_display,
+                                                             custom_format,
+                                                             ValueObject::ePrintableRepresentationSpecialCasesDisable);
+                    }
+                    else
+                    {
+                        s << "<invalid usage of pointer value as object>";
+                    }
+                    var_success = true;
+                    break;
+                }
+            }
+
+            // if directly trying to print ${var}, and this is an aggregate, display a nice
+            // type @ location message
+            if (is_aggregate && was_plain_var)
+            {
+                s << target->GetTypeName() << " @ " << target->GetLocationAsCString();
+                var_success = true;
                 break;
             }
+
+            // if directly trying to print ${var%V}, and this is an aggregate, do not let the user do it
+            if (is_aggregate && ((was_var_format && val_obj_display == ValueObject::eValueObjectRepresentationStyleValue)))
+            {
+                s << "<invalid use of aggregate type>";
+                var_success = true;
+                break;
+            }
+
+            if (!is_array_range)
+            {
+                if (log)
+                    log->Printf("dumping ordinary printable output");
+                var_success = target->DumpPrintableRepresentation(s,val_obj_display, custom_format);
+            }
+            else
+            {   
+                if (log)
+                    log->Printf("checking if I can handle as array");
+                if (!is_array && !is_pointer)
+                    break;
+                if (log)
+                    log->Printf("handle as array");
+                const char* special_directions = NULL;
+                StreamString special_directions_writer;
+                if (close_bracket_position && (var_name_end-close_bracket_position > 1))
+                {
+                    ConstString additional_data;
+                    additional_data.SetCStringWithLength(close_bracket_position+1, var_name_end-close_bracket_position-1);
+                    special_directions_writer.Printf("${%svar%s}",
+                                                     do_deref_pointer ? "*" : "",
+                                                     additional_data.GetCString());
+                    special_directions = special_directions_writer.GetData();
+                }
+
+                // let us display items index_lower thru index_higher of this array
+                s.PutChar('[');
+                var_success = true;
+
+                if (index_higher < 0)
+                    index_higher = valobj->GetNumChildren() - 1;
+
+                uint32_t max_num_children = target->GetTargetSP()->GetMaximumNumberOfChildrenToDisplay();
+
+                for (;index_lower<=index_higher;index_lower++)
+                {
+                    ValueObject* item = ExpandIndexedExpression (target,
+                                                                 index_lower,
+                                                                 exe_ctx->GetFramePtr(),
+                                                                 false).get();
+
+                    if (!item)
+                    {
+                        if (log)
+                            log->Printf("ERROR in getting child item at index %lld", index_lower);
+                    }
+                    else
+                    {
+                        if (log)
+                            log->Printf("special_directions for child item: %s",special_directions);
+                    }
+
+                    if (!special_directions)
+                        var_success &= item->DumpPrintableRepresentation(s,val_obj_display, custom_format);
+                    else
+                        var_success &= FormatPrompt(special_directions, sc, exe_ctx, addr, s, NULL, item);
+
+                    if (--max_num_children == 0)
+                    {
+                        s.PutCString(", ...");
+                        break;
+                    }
+
+                    if (index_lower < index_higher)
+                        s.PutChar(',');
+                }
+                s.PutChar(']');
+            }
         }
-        else if (*p == '}')
+        break;
+    case 'a':
+        if (::strncmp (var_name_begin, "addr}", strlen("addr}")) == 0)
         {
-            // End of a enclosing scope
-            break;
+            if (addr && addr->IsValid())
+            {
+                var_success = true;
+                format_addr = *addr;
+            }
         }
-        else if (*p == '$')
+        else if (::strncmp (var_name_begin, "ansi.", strlen("ansi.")) == 0)
         {
-            // We have a prompt variable to print
-            ++p;
-            if (*p == '{')
+            var_success = true;
+            var_name_begin += strlen("ansi."); // Skip the "ansi."
+            if (::strncmp (var_name_begin, "fg.", strlen("fg.")) == 0)
+            {
+                var_name_begin += strlen("fg."); // Skip the "fg."
+                if (::strncmp (var_name_begin, "black}", strlen("black}")) == 0)
+                {
+                    s.Printf ("%s%s%s", 
+                              lldb_utility::ansi::k_escape_start, 
+                              lldb_utility::ansi::k_fg_black,
+                              lldb_utility::ansi::k_escape_end);
+                }
+                else if (::strncmp (var_name_begin, "red}", strlen("red}")) == 0)
+                {
+                    s.Printf ("%s%s%s", 
+                              lldb_utility::ansi::k_escape_start, 
+                              lldb_utility::ansi::k_fg_red,
+                              lldb_utility::ansi::k_escape_end);
+                }
+                else if (::strncmp (var_name_begin, "green}", strlen("green}")) == 0)
+                {
+                    s.Printf ("%s%s%s", 
+                              lldb_utility::ansi::k_escape_start, 
+                              lldb_utility::ansi::k_fg_green,
+                              lldb_utility::ansi::k_escape_end);
+                }
+                else if (::strncmp (var_name_begin, "yellow}", strlen("yellow}")) == 0)
+                {
+                    s.Printf ("%s%s%s", 
+                              lldb_utility::ansi::k_escape_start, 
+                              lldb_utility::ansi::k_fg_yellow,
+                              lldb_utility::ansi::k_escape_end);
+                }
+                else if (::strncmp (var_name_begin, "blue}", strlen("blue}")) == 0)
+                {
+                    s.Printf ("%s%s%s", 
+                              lldb_utility::ansi::k_escape_start, 
+                              lldb_utility::ansi::k_fg_blue,
+                              lldb_utility::ansi::k_escape_end);
+                }
+                else if (::strncmp (var_name_begin, "purple}", strlen("purple}")) == 0)
+                {
+                    s.Printf ("%s%s%s", 
+                              lldb_utility::ansi::k_escape_start, 
+                              lldb_utility::ansi::k_fg_purple,
+                              lldb_utility::ansi::k_escape_end);
+                }
+                else if (::strncmp (var_name_begin, "cyan}", strlen("cyan}")) == 0)
+                {
+                    s.Printf ("%s%s%s", 
+                              lldb_utility::ansi::k_escape_start, 
+                              lldb_utility::ansi::k_fg_cyan,
+                              lldb_utility::ansi::k_escape_end);
+                }
+                else if (::strncmp (var_name_begin, "white}", strlen("white}")) == 0)
+                {
+                    s.Printf ("%s%s%s", 
+                              lldb_utility::ansi::k_escape_start, 
+                              lldb_utility::ansi::k_fg_white,
+                              lldb_utility::ansi::k_escape_end);
+                }
+                else
+                {
+                    var_success = false;
+                }
+            }
+            else if (::strncmp (var_name_begin, "bg.", strlen("bg.")) == 0)
+            {
+                var_name_begin += strlen("bg."); // Skip the "bg."
+                if (::strncmp (var_name_begin, "black}", strlen("black}")) == 0)
+                {
+                    s.Printf ("%s%s%s", 
+                              lldb_utility::ansi::k_escape_start, 
+                              lldb_utility::ansi::k_bg_black,
+                              lldb_utility::ansi::k_escape_end);
+                }
+                else if (::strncmp (var_name_begin, "red}", strlen("red}")) == 0)
+                {
+                    s.Printf ("%s%s%s", 
+                              lldb_utility::ansi::k_escape_start, 
+                              lldb_utility::ansi::k_bg_red,
+                              lldb_utility::ansi::k_escape_end);
+                }
+                else if (::strncmp (var_name_begin, "green}", strlen("green}")) == 0)
+                {
+                    s.Printf ("%s%s%s", 
+                              lldb_utility::ansi::k_escape_start, 
+                              lldb_utility::ansi::k_bg_green,
+                              lldb_utility::ansi::k_escape_end);
+                }
+                else if (::strncmp (var_name_begin, "yellow}", strlen("yellow}")) == 0)
+                {
+                    s.Printf ("%s%s%s", 
+                              lldb_utility::ansi::k_escape_start, 
+                              lldb_utility::ansi::k_bg_yellow,
+                              lldb_utility::ansi::k_escape_end);
+                }
+                else if (::strncmp (var_name_begin, "blue}", strlen("blue}")) == 0)
+                {
+                    s.Printf ("%s%s%s", 
+                              lldb_utility::ansi::k_escape_start, 
+                              lldb_utility::ansi::k_bg_blue,
+                              lldb_utility::ansi::k_escape_end);
+                }
+                else if (::strncmp (var_name_begin, "purple}", strlen("purple}")) == 0)
+                {
+                    s.Printf ("%s%s%s", 
+                              lldb_utility::ansi::k_escape_start, 
+                              lldb_utility::ansi::k_bg_purple,
+                              lldb_utility::ansi::k_escape_end);
+                }
+                else if (::strncmp (var_name_begin, "cyan}", strlen("cyan}")) == 0)
+                {
+                    s.Printf ("%s%s%s", 
+                              lldb_utility::ansi::k_escape_start, 
+                              lldb_utility::ansi::k_bg_cyan,
+                              lldb_utility::ansi::k_escape_end);
+                }
+                else if (::strncmp (var_name_begin, "white}", strlen("white}")) == 0)
+                {
+                    s.Printf ("%s%s%s", 
+                              lldb_utility::ansi::k_escape_start, 
+                              lldb_utility::ansi::k_bg_white,
+                              lldb_utility::ansi::k_escape_end);
+                }
+                else
+                {
+                    var_success = false;
+                }
+            }
+            else if (::strncmp (var_name_begin, "normal}", strlen ("normal}")) == 0)
+            {
+                s.Printf ("%s%s%s", 
+                          lldb_utility::ansi::k_escape_start, 
+                          lldb_utility::ansi::k_ctrl_normal,
+                          lldb_utility::ansi::k_escape_end);
+            }
+            else if (::strncmp (var_name_begin, "bold}", strlen("bold}")) == 0)
+            {
+                s.Printf ("%s%s%s", 
+                          lldb_utility::ansi::k_escape_start, 
+                          lldb_utility::ansi::k_ctrl_bold,
+                          lldb_utility::ansi::k_escape_end);
+            }
+            else if (::strncmp (var_name_begin, "faint}", strlen("faint}")) == 0)
+            {
+                s.Printf ("%s%s%s", 
+                          lldb_utility::ansi::k_escape_start, 
+                          lldb_utility::ansi::k_ctrl_faint,
+                          lldb_utility::ansi::k_escape_end);
+            }
+            else if (::strncmp (var_name_begin, "italic}", strlen("italic}")) == 0)
+            {
+                s.Printf ("%s%s%s", 
+                          lldb_utility::ansi::k_escape_start, 
+                          lldb_utility::ansi::k_ctrl_italic,
+                          lldb_utility::ansi::k_escape_end);
+            }
+            else if (::strncmp (var_name_begin, "underline}", strlen("underline}")) == 0)
+            {
+                s.Printf ("%s%s%s", 
+                          lldb_utility::ansi::k_escape_start, 
+                          lldb_utility::ansi::k_ctrl_underline,
+                          lldb_utility::ansi::k_escape_end);
+            }
+            else if (::strncmp (var_name_begin, "slow-blink}", strlen("slow-blink}")) == 0)
+            {
+                s.Printf ("%s%s%s", 
+                          lldb_utility::ansi::k_escape_start, 
+                          lldb_utility::ansi::k_ctrl_slow_blink,
+                          lldb_utility::ansi::k_escape_end);
+            }
+            else if (::strncmp (var_name_begin, "fast-blink}", strlen("fast-blink}")) == 0)
+            {
+                s.Printf ("%s%s%s", 
+                          lldb_utility::ansi::k_escape_start, 
+                          lldb_utility::ansi::k_ctrl_fast_blink,
+                          lldb_utility::ansi::k_escape_end);
+            }
+            else if (::strncmp (var_name_begin, "negative}", strlen("negative}")) == 0)
+            {
+                s.Printf ("%s%s%s", 
+                          lldb_utility::ansi::k_escape_start, 
+                          lldb_utility::ansi::k_ctrl_negative,
+                          lldb_utility::ansi::k_escape_end);
+            }
+            else if (::strncmp (var_name_begin, "conceal}", strlen("conceal}")) == 0)
+            {
+                s.Printf ("%s%s%s", 
+                          lldb_utility::ansi::k_escape_start, 
+                          lldb_utility::ansi::k_ctrl_conceal,
+                          lldb_utility::ansi::k_escape_end);
+
+            }
+            else if (::strncmp (var_name_begin, "crossed-out}", strlen("crossed-out}")) == 0)
             {
-                ++p;
-                const char *var_name_begin = p;
-                const char *var_name_end = ::strchr (p, '}');
+                s.Printf ("%s%s%s", 
+                          lldb_utility::ansi::k_escape_start, 
+                          lldb_utility::ansi::k_ctrl_crossed_out,
+                          lldb_utility::ansi::k_escape_end);
+            }
+            else
+            {
+                var_success = false;
+            }
+        }
+        break;
 
-                if (var_name_end && var_name_begin < var_name_end)
+    case 'p':
+        if (::strncmp (var_name_begin, "process.", strlen("process.")) == 0)
+        {
+            if (exe_ctx)
+            {
+                Process *process = exe_ctx->GetProcessPtr();
+                if (process)
                 {
-                    // if we have already failed to parse, skip this variable
-                    if (success)
+                    var_name_begin += ::strlen ("process.");
+                    if (::strncmp (var_name_begin, "id}", strlen("id}")) == 0)
+                    {
+                        s.Printf("%llu", process->GetID());
+                        var_success = true;
+                    }
+                    else if ((::strncmp (var_name_begin, "name}", strlen("name}")) == 0) ||
+                             (::strncmp (var_name_begin, "file.basename}", strlen("file.basename}")) == 0) ||
+                             (::strncmp (var_name_begin, "file.fullpath}", strlen("file.fullpath}")) == 0))
                     {
-                        const char *cstr = NULL;
-                        Address format_addr;
-                        bool calculate_format_addr_function_offset = false;
-                        // Set reg_kind and reg_num to invalid values
-                        RegisterKind reg_kind = kNumRegisterKinds; 
-                        uint32_t reg_num = LLDB_INVALID_REGNUM;
-                        FileSpec format_file_spec;
-                        const RegisterInfo *reg_info = NULL;
-                        RegisterContext *reg_ctx = NULL;
-                        bool do_deref_pointer = false;
-                        ValueObject::ExpressionPathScanEndReason reason_to_stop = ValueObject::eExpressionPathScanEndReasonEndOfString;
-                        ValueObject::ExpressionPathEndResultType final_value_type = ValueObject::eExpressionPathEndResultTypePlain;
-                        
-                        // Each variable must set success to true below...
-                        bool var_success = false;
-                        switch (var_name_begin[0])
+                        Module *exe_module = process->GetTarget().GetExecutableModulePointer();
+                        if (exe_module)
                         {
-                        case '*':
-                        case 'v':
-                        case 's':
+                            if (var_name_begin[0] == 'n' || var_name_begin[5] == 'f')
                             {
-                                if (!valobj)
-                                    break;
-                                
-                                if (log)
-                                    log->Printf("initial string: %s",var_name_begin);
-                                
-                                // check for *var and *svar
-                                if (*var_name_begin == '*')
-                                {
-                                    do_deref_pointer = true;
-                                    var_name_begin++;
-                                }
-                                
-                                if (log)
-                                    log->Printf("initial string: %s",var_name_begin);
-                                
-                                if (*var_name_begin == 's')
-                                {
-                                    if (!valobj->IsSynthetic())
-                                        valobj = valobj->GetSyntheticValue().get();
-                                    if (!valobj)
-                                        break;
-                                    var_name_begin++;
-                                }
-                                
-                                if (log)
-                                    log->Printf("initial string: %s",var_name_begin);
-                                
-                                // should be a 'v' by now
-                                if (*var_name_begin != 'v')
-                                    break;
-                                
-                                if (log)
-                                    log->Printf("initial string: %s",var_name_begin);
-                                                                
-                                ValueObject::ExpressionPathAftermath what_next = (do_deref_pointer ?
-                                                                                  ValueObject::eExpressionPathAftermathDereference : ValueObject::eExpressionPathAftermathNothing);
-                                ValueObject::GetValueForExpressionPathOptions options;
-                                options.DontCheckDotVsArrowSyntax().DoAllowBitfieldSyntax().DoAllowFragileIVar().DoAllowSyntheticChildren();
-                                ValueObject::ValueObjectRepresentationStyle val_obj_display = ValueObject::eValueObjectRepresentationStyleSummary;
-                                ValueObject* target = NULL;
-                                Format custom_format = eFormatInvalid;
-                                const char* var_name_final = NULL;
-                                const char* var_name_final_if_array_range = NULL;
-                                const char* close_bracket_position = NULL;
-                                int64_t index_lower = -1;
-                                int64_t index_higher = -1;
-                                bool is_array_range = false;
-                                const char* first_unparsed;
-                                bool was_plain_var = false;
-                                bool was_var_format = false;
-                                bool was_var_indexed = false;
-
-                                if (!valobj) break;
-                                // simplest case ${var}, just print valobj's value
-                                if (::strncmp (var_name_begin, "var}", strlen("var}")) == 0)
-                                {
-                                    was_plain_var = true;
-                                    target = valobj;
-                                    val_obj_display = ValueObject::eValueObjectRepresentationStyleValue;
-                                }
-                                else if (::strncmp(var_name_begin,"var%",strlen("var%")) == 0)
-                                {
-                                    was_var_format = true;
-                                    // this is a variable with some custom format applied to it
-                                    const char* percent_position;
-                                    target = valobj;
-                                    val_obj_display = ValueObject::eValueObjectRepresentationStyleValue;
-                                    ScanFormatDescriptor (var_name_begin,
-                                                          var_name_end,
-                                                          &var_name_final,
-                                                          &percent_position,
-                                                          &custom_format,
-                                                          &val_obj_display);
-                                }
-                                    // this is ${var.something} or multiple .something nested
-                                else if (::strncmp (var_name_begin, "var", strlen("var")) == 0)
-                                {
-                                    if (::strncmp(var_name_begin, "var[", strlen("var[")) == 0)
-                                        was_var_indexed = true;
-                                    const char* percent_position;
-                                    ScanFormatDescriptor (var_name_begin,
-                                                          var_name_end,
-                                                          &var_name_final,
-                                                          &percent_position,
-                                                          &custom_format,
-                                                          &val_obj_display);
-                                    
-                                    const char* open_bracket_position;
-                                    const char* separator_position;
-                                    ScanBracketedRange (var_name_begin,
-                                                        var_name_end,
-                                                        var_name_final,
-                                                        &open_bracket_position,
-                                                        &separator_position,
-                                                        &close_bracket_position,
-                                                        &var_name_final_if_array_range,
-                                                        &index_lower,
-                                                        &index_higher);
-                                                                    
-                                    Error error;
-                                                                        
-                                    std::auto_ptr<char> expr_path(new char[var_name_final-var_name_begin-1]);
-                                    ::memset(expr_path.get(), 0, var_name_final-var_name_begin-1);
-                                    memcpy(expr_path.get(), var_name_begin+3,var_name_final-var_name_begin-3);
-                                                                        
-                                    if (log)
-                                        log->Printf("symbol to expand: %s",expr_path.get());
-                                    
-                                    target = valobj->GetValueForExpressionPath(expr_path.get(),
-                                                                             &first_unparsed,
-                                                                             &reason_to_stop,
-                                                                             &final_value_type,
-                                                                             options,
-                                                                             &what_next).get();
-                                    
-                                    if (!target)
-                                    {
-                                        if (log)
-                                            log->Printf("ERROR: unparsed portion = %s, why stopping = %d,"
-                                               " final_value_type %d",
-                                               first_unparsed, reason_to_stop, final_value_type);
-                                        break;
-                                    }
-                                    else
-                                    {
-                                        if (log)
-                                            log->Printf("ALL RIGHT: unparsed portion = %s, why stopping = %d,"
-                                               " final_value_type %d",
-                                               first_unparsed, reason_to_stop, final_value_type);
-                                    }
-                                }
-                                else
-                                    break;
-                                
-                                is_array_range = (final_value_type == ValueObject::eExpressionPathEndResultTypeBoundedRange ||
-                                                  final_value_type == ValueObject::eExpressionPathEndResultTypeUnboundedRange);
-                                
-                                do_deref_pointer = (what_next == ValueObject::eExpressionPathAftermathDereference);
-
-                                if (do_deref_pointer && !is_array_range)
-                                {
-                                    // I have not deref-ed yet, let's do it
-                                    // this happens when we are not going through GetValueForVariableExpressionPath
-                                    // to get to the target ValueObject
-                                    Error error;
-                                    target = target->Dereference(error).get();
-                                    if (error.Fail())
-                                    {
-                                        if (log)
-                                            log->Printf("ERROR: %s\n", error.AsCString("unknown")); \
-                                        break;
-                                    }
-                                    do_deref_pointer = false;
-                                }
-                                
-                                // <rdar://problem/11338654>
-                                // we do not want to use the summary for a bitfield of type T:n
-                                // if we were originally dealing with just a T - that would get
-                                // us into an endless recursion
-                                if (target->IsBitfield() && was_var_indexed)
-                                {
-                                    // TODO: check for a (T:n)-specific summary - we should still obey that
-                                    StreamString bitfield_name;
-                                    bitfield_name.Printf("%s:%d", target->GetTypeName().AsCString(), target->GetBitfieldBitSize());
-                                    lldb::TypeNameSpecifierImplSP type_sp(new TypeNameSpecifierImpl(bitfield_name.GetData(),false));
-                                    if (!DataVisualization::GetSummaryForType(type_sp))
-                                        val_obj_display = ValueObject::eValueObjectRepresentationStyleValue;
-                                }
-                                
-                                // TODO use flags for these
-                                bool is_array = ClangASTContext::IsArrayType(target->GetClangType());
-                                bool is_pointer = ClangASTContext::IsPointerType(target->GetClangType());
-                                bool is_aggregate = ClangASTContext::IsAggregateType(target->GetClangType());
-                                
-                                if ((is_array || is_pointer) && (!is_array_range) && val_obj_display == ValueObject::eValueObjectRepresentationStyleValue) // this should be wrong, but there are some exceptions
-                                {
-                                    StreamString str_temp;
-                                    if (log)
-                                        log->Printf("I am into array || pointer && !range");
-                                    
-                                    if (target->HasSpecialPrintableRepresentation(val_obj_display,
-                                                                                  custom_format))
-                                    {
-                                        // try to use the special cases
-                                        var_success = target->DumpPrintableRepresentation(str_temp,
-                                                                                          val_obj_display,
-                                                                                          custom_format);
-                                        if (log)
-                                            log->Printf("special cases did%s match", var_success ? "" : "n't");
-                                        
-                                        // should not happen
-                                        if (!var_success)
-                                            s << "<invalid usage of pointer value as object>";
-                                        else
-                                            s << str_temp.GetData();
-                                        var_success = true;
-                                        break;
-                                    }
-                                    else
-                                    {
-                                        if (was_plain_var) // if ${var}
-                                        {
-                                            s << target->GetTypeName() << " @ " << target->GetLocationAsCString();
-                                        }
-                                        else if (is_pointer) // if pointer, value is the address stored
-                                        {
-                                            target->DumpPrintableRepresentation (s,
-                                                                                 val_obj_display,
-                                                                                 custom_format,
-                                                                                 ValueObject::ePrintableRepresentationSpecialCasesDisable);
-                                        }
-                                        else
-                                        {
-                                            s << "<invalid usage of pointer value as object>";
-                                        }
-                                        var_success = true;
-                                        break;
-                                    }
-                                }
-                                
-                                // if directly trying to print ${var}, and this is an aggregate, display a nice
-                                // type @ location message
-                                if (is_aggregate && was_plain_var)
-                                {
-                                    s << target->GetTypeName() << " @ " << target->GetLocationAsCString();
-                                    var_success = true;
-                                    break;
-                                }
-                                
-                                // if directly trying to print ${var%V}, and this is an aggregate, do not let the user do it
-                                if (is_aggregate && ((was_var_format && val_obj_display == ValueObject::eValueObjectRepresentationStyleValue)))
-                                {
-                                    s << "<invalid use of aggregate type>";
-                                    var_success = true;
-                                    break;
-                                }
-                                                                
-                                if (!is_array_range)
-                                {
-                                    if (log)
-                                        log->Printf("dumping ordinary printable output");
-                                    var_success = target->DumpPrintableRepresentation(s,val_obj_display, custom_format);
-                                }
-                                else
-                                {   
-                                    if (log)
-                                        log->Printf("checking if I can handle as array");
-                                    if (!is_array && !is_pointer)
-                                        break;
-                                    if (log)
-                                        log->Printf("handle as array");
-                                    const char* special_directions = NULL;
-                                    StreamString special_directions_writer;
-                                    if (close_bracket_position && (var_name_end-close_bracket_position > 1))
-                                    {
-                                        ConstString additional_data;
-                                        additional_data.SetCStringWithLength(close_bracket_position+1, var_name_end-close_bracket_position-1);
-                                        special_directions_writer.Printf("${%svar%s}",
-                                                                         do_deref_pointer ? "*" : "",
-                                                                         additional_data.GetCString());
-                                        special_directions = special_directions_writer.GetData();
-                                    }
-                                    
-                                    // let us display items index_lower thru index_higher of this array
-                                    s.PutChar('[');
-                                    var_success = true;
-
-                                    if (index_higher < 0)
-                                        index_higher = valobj->GetNumChildren() - 1;
-                                    
-                                    uint32_t max_num_children = target->GetTargetSP()->GetMaximumNumberOfChildrenToDisplay();
-                                    
-                                    for (;index_lower<=index_higher;index_lower++)
-                                    {
-                                        ValueObject* item = ExpandIndexedExpression (target,
-                                                                                     index_lower,
-                                                                                     exe_ctx->GetFramePtr(),
-                                                                                     false).get();
-                                        
-                                        if (!item)
-                                        {
-                                            if (log)
-                                                log->Printf("ERROR in getting child item at index %lld", index_lower);
-                                        }
-                                        else
-                                        {
-                                            if (log)
-                                                log->Printf("special_directions for child item: %s",special_directions);
-                                        }
-
-                                        if (!special_directions)
-                                            var_success &= item->DumpPrintableRepresentation(s,val_obj_display, custom_format);
-                                        else
-                                            var_success &= FormatPrompt(special_directions, sc, exe_ctx, addr, s, NULL, item);
-                                        
-                                        if (--max_num_children == 0)
-                                        {
-                                            s.PutCString(", ...");
-                                            break;
-                                        }
-                                        
-                                        if (index_lower < index_higher)
-                                            s.PutChar(',');
-                                    }
-                                    s.PutChar(']');
-                                }
+                                format_file_spec.GetFilename() = exe_module->GetFileSpec().GetFilename();
+                                var_success = format_file_spec;
                             }
-                            break;
-                        case 'a':
-                            if (::strncmp (var_name_begin, "addr}", strlen("addr}")) == 0)
+                            else
                             {
-                                if (addr && addr->IsValid())
-                                {
-                                    var_success = true;
-                                    format_addr = *addr;
-                                }
+                                format_file_spec = exe_module->GetFileSpec();
+                                var_success = format_file_spec;
                             }
-                            else if (::strncmp (var_name_begin, "ansi.", strlen("ansi.")) == 0)
-                            {
-                                var_success = true;
-                                var_name_begin += strlen("ansi."); // Skip the "ansi."
-                                if (::strncmp (var_name_begin, "fg.", strlen("fg.")) == 0)
-                                {
-                                    var_name_begin += strlen("fg."); // Skip the "fg."
-                                    if (::strncmp (var_name_begin, "black}", strlen("black}")) == 0)
-                                    {
-                                        s.Printf ("%s%s%s", 
-                                                  lldb_utility::ansi::k_escape_start, 
-                                                  lldb_utility::ansi::k_fg_black,
-                                                  lldb_utility::ansi::k_escape_end);
-                                    }
-                                    else if (::strncmp (var_name_begin, "red}", strlen("red}")) == 0)
-                                    {
-                                        s.Printf ("%s%s%s", 
-                                                  lldb_utility::ansi::k_escape_start, 
-                                                  lldb_utility::ansi::k_fg_red,
-                                                  lldb_utility::ansi::k_escape_end);
-                                    }
-                                    else if (::strncmp (var_name_begin, "green}", strlen("green}")) == 0)
-                                    {
-                                        s.Printf ("%s%s%s", 
-                                                  lldb_utility::ansi::k_escape_start, 
-                                                  lldb_utility::ansi::k_fg_green,
-                                                  lldb_utility::ansi::k_escape_end);
-                                    }
-                                    else if (::strncmp (var_name_begin, "yellow}", strlen("yellow}")) == 0)
-                                    {
-                                        s.Printf ("%s%s%s", 
-                                                  lldb_utility::ansi::k_escape_start, 
-                                                  lldb_utility::ansi::k_fg_yellow,
-                                                  lldb_utility::ansi::k_escape_end);
-                                    }
-                                    else if (::strncmp (var_name_begin, "blue}", strlen("blue}")) == 0)
-                                    {
-                                        s.Printf ("%s%s%s", 
-                                                  lldb_utility::ansi::k_escape_start, 
-                                                  lldb_utility::ansi::k_fg_blue,
-                                                  lldb_utility::ansi::k_escape_end);
-                                    }
-                                    else if (::strncmp (var_name_begin, "purple}", strlen("purple}")) == 0)
-                                    {
-                                        s.Printf ("%s%s%s", 
-                                                  lldb_utility::ansi::k_escape_start, 
-                                                  lldb_utility::ansi::k_fg_purple,
-                                                  lldb_utility::ansi::k_escape_end);
-                                    }
-                                    else if (::strncmp (var_name_begin, "cyan}", strlen("cyan}")) == 0)
-                                    {
-                                        s.Printf ("%s%s%s", 
-                                                  lldb_utility::ansi::k_escape_start, 
-                                                  lldb_utility::ansi::k_fg_cyan,
-                                                  lldb_utility::ansi::k_escape_end);
-                                    }
-                                    else if (::strncmp (var_name_begin, "white}", strlen("white}")) == 0)
-                                    {
-                                        s.Printf ("%s%s%s", 
-                                                  lldb_utility::ansi::k_escape_start, 
-                                                  lldb_utility::ansi::k_fg_white,
-                                                  lldb_utility::ansi::k_escape_end);
-                                    }
-                                    else
-                                    {
-                                        var_success = false;
-                                    }
-                                }
-                                else if (::strncmp (var_name_begin, "bg.", strlen("bg.")) == 0)
-                                {
-                                    var_name_begin += strlen("bg."); // Skip the "bg."
-                                    if (::strncmp (var_name_begin, "black}", strlen("black}")) == 0)
-                                    {
-                                        s.Printf ("%s%s%s", 
-                                                  lldb_utility::ansi::k_escape_start, 
-                                                  lldb_utility::ansi::k_bg_black,
-                                                  lldb_utility::ansi::k_escape_end);
-                                    }
-                                    else if (::strncmp (var_name_begin, "red}", strlen("red}")) == 0)
-                                    {
-                                        s.Printf ("%s%s%s", 
-                                                  lldb_utility::ansi::k_escape_start, 
-                                                  lldb_utility::ansi::k_bg_red,
-                                                  lldb_utility::ansi::k_escape_end);
-                                    }
-                                    else if (::strncmp (var_name_begin, "green}", strlen("green}")) == 0)
-                                    {
-                                        s.Printf ("%s%s%s", 
-                                                  lldb_utility::ansi::k_escape_start, 
-                                                  lldb_utility::ansi::k_bg_green,
-                                                  lldb_utility::ansi::k_escape_end);
-                                    }
-                                    else if (::strncmp (var_name_begin, "yellow}", strlen("yellow}")) == 0)
-                                    {
-                                        s.Printf ("%s%s%s", 
-                                                  lldb_utility::ansi::k_escape_start, 
-                                                  lldb_utility::ansi::k_bg_yellow,
-                                                  lldb_utility::ansi::k_escape_end);
-                                    }
-                                    else if (::strncmp (var_name_begin, "blue}", strlen("blue}")) == 0)
-                                    {
-                                        s.Printf ("%s%s%s", 
-                                                  lldb_utility::ansi::k_escape_start, 
-                                                  lldb_utility::ansi::k_bg_blue,
-                                                  lldb_utility::ansi::k_escape_end);
-                                    }
-                                    else if (::strncmp (var_name_begin, "purple}", strlen("purple}")) == 0)
-                                    {
-                                        s.Printf ("%s%s%s", 
-                                                  lldb_utility::ansi::k_escape_start, 
-                                                  lldb_utility::ansi::k_bg_purple,
-                                                  lldb_utility::ansi::k_escape_end);
-                                    }
-                                    else if (::strncmp (var_name_begin, "cyan}", strlen("cyan}")) == 0)
-                                    {
-                                        s.Printf ("%s%s%s", 
-                                                  lldb_utility::ansi::k_escape_start, 
-                                                  lldb_utility::ansi::k_bg_cyan,
-                                                  lldb_utility::ansi::k_escape_end);
-                                    }
-                                    else if (::strncmp (var_name_begin, "white}", strlen("white}")) == 0)
-                                    {
-                                        s.Printf ("%s%s%s", 
-                                                  lldb_utility::ansi::k_escape_start, 
-                                                  lldb_utility::ansi::k_bg_white,
-                                                  lldb_utility::ansi::k_escape_end);
-                                    }
-                                    else
-                                    {
-                                        var_success = false;
-                                    }
-                                }
-                                else if (::strncmp (var_name_begin, "normal}", strlen ("normal}")) == 0)
-                                {
-                                    s.Printf ("%s%s%s", 
-                                              lldb_utility::ansi::k_escape_start, 
-                                              lldb_utility::ansi::k_ctrl_normal,
-                                              lldb_utility::ansi::k_escape_end);
-                                }
-                                else if (::strncmp (var_name_begin, "bold}", strlen("bold}")) == 0)
-                                {
-                                    s.Printf ("%s%s%s", 
-                                              lldb_utility::ansi::k_escape_start, 
-                                              lldb_utility::ansi::k_ctrl_bold,
-                                              lldb_utility::ansi::k_escape_end);
-                                }
-                                else if (::strncmp (var_name_begin, "faint}", strlen("faint}")) == 0)
-                                {
-                                    s.Printf ("%s%s%s", 
-                                              lldb_utility::ansi::k_escape_start, 
-                                              lldb_utility::ansi::k_ctrl_faint,
-                                              lldb_utility::ansi::k_escape_end);
-                                }
-                                else if (::strncmp (var_name_begin, "italic}", strlen("italic}")) == 0)
-                                {
-                                    s.Printf ("%s%s%s", 
-                                              lldb_utility::ansi::k_escape_start, 
-                                              lldb_utility::ansi::k_ctrl_italic,
-                                              lldb_utility::ansi::k_escape_end);
-                                }
-                                else if (::strncmp (var_name_begin, "underline}", strlen("underline}")) == 0)
-                                {
-                                    s.Printf ("%s%s%s", 
-                                              lldb_utility::ansi::k_escape_start, 
-                                              lldb_utility::ansi::k_ctrl_underline,
-                                              lldb_utility::ansi::k_escape_end);
-                                }
-                                else if (::strncmp (var_name_begin, "slow-blink}", strlen("slow-blink}")) == 0)
-                                {
-                                    s.Printf ("%s%s%s", 
-                                              lldb_utility::ansi::k_escape_start, 
-                                              lldb_utility::ansi::k_ctrl_slow_blink,
-                                              lldb_utility::ansi::k_escape_end);
-                                }
-                                else if (::strncmp (var_name_begin, "fast-blink}", strlen("fast-blink}")) == 0)
-                                {
-                                    s.Printf ("%s%s%s", 
-                                              lldb_utility::ansi::k_escape_start, 
-                                              lldb_utility::ansi::k_ctrl_fast_blink,
-                                              lldb_utility::ansi::k_escape_end);
-                                }
-                                else if (::strncmp (var_name_begin, "negative}", strlen("negative}")) == 0)
-                                {
-                                    s.Printf ("%s%s%s", 
-                                              lldb_utility::ansi::k_escape_start, 
-                                              lldb_utility::ansi::k_ctrl_negative,
-                                              lldb_utility::ansi::k_escape_end);
-                                }
-                                else if (::strncmp (var_name_begin, "conceal}", strlen("conceal}")) == 0)
-                                {
-                                    s.Printf ("%s%s%s", 
-                                              lldb_utility::ansi::k_escape_start, 
-                                              lldb_utility::ansi::k_ctrl_conceal,
-                                              lldb_utility::ansi::k_escape_end);
-
-                                }
-                                else if (::strncmp (var_name_begin, "crossed-out}", strlen("crossed-out}")) == 0)
-                                {
-                                    s.Printf ("%s%s%s", 
-                                              lldb_utility::ansi::k_escape_start, 
-                                              lldb_utility::ansi::k_ctrl_crossed_out,
-                                              lldb_utility::ansi::k_escape_end);
-                                }
-                                else
-                                {
-                                    var_success = false;
-                                }
-                            }
-                            break;
+                        }
+                    }
+                }
+            }
+        }
+        break;
 
-                        case 'p':
-                            if (::strncmp (var_name_begin, "process.", strlen("process.")) == 0)
+    case 't':
+        if (::strncmp (var_name_begin, "thread.", strlen("thread.")) == 0)
+        {
+            if (exe_ctx)
+            {
+                Thread *thread = exe_ctx->GetThreadPtr();
+                if (thread)
+                {
+                    var_name_begin += ::strlen ("thread.");
+                    if (::strncmp (var_name_begin, "id}", strlen("id}")) == 0)
+                    {
+                        s.Printf("0x%4.4llx", thread->GetID());
+                        var_success = true;
+                    }
+                    else if (::strncmp (var_name_begin, "index}", strlen("index}")) == 0)
+                    {
+                        s.Printf("%u", thread->GetIndexID());
+                        var_success = true;
+                    }
+                    else if (::strncmp (var_name_begin, "name}", strlen("name}")) == 0)
+                    {
+                        cstr = thread->GetName();
+                        var_success = cstr && cstr[0];
+                        if (var_success)
+                            s.PutCString(cstr);
+                    }
+                    else if (::strncmp (var_name_begin, "queue}", strlen("queue}")) == 0)
+                    {
+                        cstr = thread->GetQueueName();
+                        var_success = cstr && cstr[0];
+                        if (var_success)
+                            s.PutCString(cstr);
+                    }
+                    else if (::strncmp (var_name_begin, "stop-reason}", strlen("stop-reason}")) == 0)
+                    {
+                        StopInfoSP stop_info_sp = thread->GetStopInfo ();
+                        if (stop_info_sp)
+                        {
+                            cstr = stop_info_sp->GetDescription();
+                            if (cstr && cstr[0])
                             {
-                                if (exe_ctx)
-                                {
-                                    Process *process = exe_ctx->GetProcessPtr();
-                                    if (process)
-                                    {
-                                        var_name_begin += ::strlen ("process.");
-                                        if (::strncmp (var_name_begin, "id}", strlen("id}")) == 0)
-                                        {
-                                            s.Printf("%llu", process->GetID());
-                                            var_success = true;
-                                        }
-                                        else if ((::strncmp (var_name_begin, "name}", strlen("name}")) == 0) ||
-                                                 (::strncmp (var_name_begin, "file.basename}", strlen("file.basename}")) == 0) ||
-                                                 (::strncmp (var_name_begin, "file.fullpath}", strlen("file.fullpath}")) == 0))
-                                        {
-                                            Module *exe_module = process->GetTarget().GetExecutableModulePointer();
-                                            if (exe_module)
-                                            {
-                                                if (var_name_begin[0] == 'n' || var_name_begin[5] == 'f')
-                                                {
-                                                    format_file_spec.GetFilename() = exe_module->GetFileSpec().GetFilename();
-                                                    var_success = format_file_spec;
-                                                }
-                                                else
-                                                {
-                                                    format_file_spec = exe_module->GetFileSpec();
-                                                    var_success = format_file_spec;
-                                                }
-                                            }
-                                        }
-                                    }
-                                }
+                                s.PutCString(cstr);
+                                var_success = true;
                             }
-                            break;
-                        
-                        case 't':
-                            if (::strncmp (var_name_begin, "thread.", strlen("thread.")) == 0)
+                        }
+                    }
+                    else if (::strncmp (var_name_begin, "return-value}", strlen("return-value}")) == 0)
+                    {
+                        StopInfoSP stop_info_sp = thread->GetStopInfo ();
+                        if (stop_info_sp)
+                        {
+                            ValueObjectSP return_valobj_sp = StopInfo::GetReturnValueObject (stop_info_sp);
+                            if (return_valobj_sp)
                             {
-                                if (exe_ctx)
-                                {
-                                    Thread *thread = exe_ctx->GetThreadPtr();
-                                    if (thread)
-                                    {
-                                        var_name_begin += ::strlen ("thread.");
-                                        if (::strncmp (var_name_begin, "id}", strlen("id}")) == 0)
-                                        {
-                                            s.Printf("0x%4.4llx", thread->GetID());
-                                            var_success = true;
-                                        }
-                                        else if (::strncmp (var_name_begin, "index}", strlen("index}")) == 0)
-                                        {
-                                            s.Printf("%u", thread->GetIndexID());
-                                            var_success = true;
-                                        }
-                                        else if (::strncmp (var_name_begin, "name}", strlen("name}")) == 0)
-                                        {
-                                            cstr = thread->GetName();
-                                            var_success = cstr && cstr[0];
-                                            if (var_success)
-                                                s.PutCString(cstr);
-                                        }
-                                        else if (::strncmp (var_name_begin, "queue}", strlen("queue}")) == 0)
-                                        {
-                                            cstr = thread->GetQueueName();
-                                            var_success = cstr && cstr[0];
-                                            if (var_success)
-                                                s.PutCString(cstr);
-                                        }
-                                        else if (::strncmp (var_name_begin, "stop-reason}", strlen("stop-reason}")) == 0)
-                                        {
-                                            StopInfoSP stop_info_sp = thread->GetStopInfo ();
-                                            if (stop_info_sp)
-                                            {
-                                                cstr = stop_info_sp->GetDescription();
-                                                if (cstr && cstr[0])
-                                                {
-                                                    s.PutCString(cstr);
-                                                    var_success = true;
-                                                }
-                                            }
-                                        }
-                                        else if (::strncmp (var_name_begin, "return-value}", strlen("return-value}")) == 0)
-                                        {
-                                            StopInfoSP stop_info_sp = thread->GetStopInfo ();
-                                            if (stop_info_sp)
-                                            {
-                                                ValueObjectSP return_valobj_sp = StopInfo::GetReturnValueObject (stop_info_sp);
-                                                if (return_valobj_sp)
-                                                {
-                                                    ValueObject::DumpValueObjectOptions dump_options;
-                                                    ValueObject::DumpValueObject (s, return_valobj_sp.get(), dump_options);
-                                                    var_success = true;
-                                                }
-                                            }
-                                        }
-                                    }
-                                }
+                                ValueObject::DumpValueObjectOptions dump_options;
+                                ValueObject::DumpValueObject (s, return_valobj_sp.get(), dump_options);
+                                var_success = true;
                             }
-                            else if (::strncmp (var_name_begin, "target.", strlen("target.")) == 0)
-                            {
-                                // TODO: hookup properties
-//                                if (!target_properties_sp)
-//                                {
-//                                    Target *target = Target::GetTargetFromContexts (exe_ctx, sc);
-//                                    if (target)
-//                                        target_properties_sp = target->GetProperties();
-//                                }
+                        }
+                    }
+                }
+            }
+        }
+        else if (::strncmp (var_name_begin, "target.", strlen("target.")) == 0)
+        {
+            // TODO: hookup properties
+//            if (!target_properties_sp)
+//            {
+//                Target *target = Target::GetTargetFromContexts (exe_ctx, sc);
+//                if (target)
+//                    target_properties_sp = target->GetProperties();
+//            }
 //
-//                                if (target_properties_sp)
-//                                {
-//                                    var_name_begin += ::strlen ("target.");
-//                                    const char *end_property = strchr(var_name_begin, '}');
-//                                    if (end_property)
-//                                    {
-//                                        ConstString property_name(var_name_begin, end_property - var_name_begin);
-//                                        std::string property_value (target_properties_sp->GetPropertyValue(property_name));
-//                                        if (!property_value.empty())
-//                                        {
-//                                            s.PutCString (property_value.c_str());
-//                                            var_success = true;
-//                                        }
-//                                    }
-//                                }                                        
-                                Target *target = Target::GetTargetFromContexts (exe_ctx, sc);
-                                if (target)
-                                {
-                                    var_name_begin += ::strlen ("target.");
-                                    if (::strncmp (var_name_begin, "arch}", strlen("arch}")) == 0)
-                                    {
-                                        ArchSpec arch (target->GetArchitecture ());
-                                        if (arch.IsValid())
-                                        {
-                                            s.PutCString (arch.GetArchitectureName());
-                                            var_success = true;
-                                        }
-                                    }
-                                }
-                            }
-                            break;
-                            
-                            
-                        case 'm':
-                            if (::strncmp (var_name_begin, "module.", strlen("module.")) == 0)
+//            if (target_properties_sp)
+//            {
+//                var_name_begin += ::strlen ("target.");
+//                const char *end_property = strchr(var_name_begin, '}');
+//                if (end_property)
+//                {
+//                    ConstString property_name(var_name_begin, end_property - var_name_begin);
+//                    std::string property_value (target_properties_sp->GetPropertyValue(property_name));
+//                    if (!property_value.empty())
+//                    {
+//                        s.PutCString (property_value.c_str());
+//                        var_success = true;
+//                    }
+//                }
+//            }                                        
+            Target *target = Target::GetTargetFromContexts (exe_ctx, sc);
+            if (target)
+            {
+                var_name_begin += ::strlen ("target.");
+                if (::strncmp (var_name_begin, "arch}", strlen("arch}")) == 0)
+                {
+                    ArchSpec arch (target->GetArchitecture ());
+                    if (arch.IsValid())
+                    {
+                        s.PutCString (arch.GetArchitectureName());
+                        var_success = true;
+                    }
+                }
+            }
+        }
+        break;
+
+
+    case 'm':
+        if (::strncmp (var_name_begin, "module.", strlen("module.")) == 0)
+        {
+            if (sc && sc->module_sp.get())
+            {
+                Module *module = sc->module_sp.get();
+                var_name_begin += ::strlen ("module.");
+
+                if (::strncmp (var_name_begin, "file.", strlen("file.")) == 0)
+                {
+                    if (module->GetFileSpec())
+                    {
+                        var_name_begin += ::strlen ("file.");
+
+                        if (::strncmp (var_name_begin, "basename}", strlen("basename}")) == 0)
+                        {
+                            format_file_spec.GetFilename() = module->GetFileSpec().GetFilename();
+                            var_success = format_file_spec;
+                        }
+                        else if (::strncmp (var_name_begin, "fullpath}", strlen("fullpath}")) == 0)
+                        {
+                            format_file_spec = module->GetFileSpec();
+                            var_success = format_file_spec;
+                        }
+                    }
+                }
+            }
+        }
+        break;
+
+
+    case 'f':
+        if (::strncmp (var_name_begin, "file.", strlen("file.")) == 0)
+        {
+            if (sc && sc->comp_unit != NULL)
+            {
+                var_name_begin += ::strlen ("file.");
+
+                if (::strncmp (var_name_begin, "basename}", strlen("basename}")) == 0)
+                {
+                    format_file_spec.GetFilename() = sc->comp_unit->GetFilename();
+                    var_success = format_file_spec;
+                }
+                else if (::strncmp (var_name_begin, "fullpath}", strlen("fullpath}")) == 0)
+                {
+                    format_file_spec = *sc->comp_unit;
+                    var_success = format_file_spec;
+                }
+            }
+        }
+        else if (::strncmp (var_name_begin, "frame.", strlen("frame.")) == 0)
+        {
+            if (exe_ctx)
+            {
+                StackFrame *frame = exe_ctx->GetFramePtr();
+                if (frame)
+                {
+                    var_name_begin += ::strlen ("frame.");
+                    if (::strncmp (var_name_begin, "index}", strlen("index}")) == 0)
+                    {
+                        s.Printf("%u", frame->GetFrameIndex());
+                        var_success = true;
+                    }
+                    else if (::strncmp (var_name_begin, "pc}", strlen("pc}")) == 0)
+                    {
+                        reg_kind = eRegisterKindGeneric;
+                        reg_num = LLDB_REGNUM_GENERIC_PC;
+                        var_success = true;
+                    }
+                    else if (::strncmp (var_name_begin, "sp}", strlen("sp}")) == 0)
+                    {
+                        reg_kind = eRegisterKindGeneric;
+                        reg_num = LLDB_REGNUM_GENERIC_SP;
+                        var_success = true;
+                    }
+                    else if (::strncmp (var_name_begin, "fp}", strlen("fp}")) == 0)
+                    {
+                        reg_kind = eRegisterKindGeneric;
+                        reg_num = LLDB_REGNUM_GENERIC_FP;
+                        var_success = true;
+                    }
+                    else if (::strncmp (var_name_begin, "flags}", strlen("flags}")) == 0)
+                    {
+                        reg_kind = eRegisterKindGeneric;
+                        reg_num = LLDB_REGNUM_GENERIC_FLAGS;
+                        var_success = true;
+                    }
+                    else if (::strncmp (var_name_begin, "reg.", strlen ("reg.")) == 0)
+                    {
+                        reg_ctx = frame->GetRegisterContext().get();
+                        if (reg_ctx)
+                        {
+                            var_name_begin += ::strlen ("reg.");
+                            if (var_name_begin < var_name_end)
                             {
-                                if (sc && sc->module_sp.get())
-                                {
-                                    Module *module = sc->module_sp.get();
-                                    var_name_begin += ::strlen ("module.");
-                                    
-                                    if (::strncmp (var_name_begin, "file.", strlen("file.")) == 0)
-                                    {
-                                        if (module->GetFileSpec())
-                                        {
-                                            var_name_begin += ::strlen ("file.");
-                                            
-                                            if (::strncmp (var_name_begin, "basename}", strlen("basename}")) == 0)
-                                            {
-                                                format_file_spec.GetFilename() = module->GetFileSpec().GetFilename();
-                                                var_success = format_file_spec;
-                                            }
-                                            else if (::strncmp (var_name_begin, "fullpath}", strlen("fullpath}")) == 0)
-                                            {
-                                                format_file_spec = module->GetFileSpec();
-                                                var_success = format_file_spec;
-                                            }
-                                        }
-                                    }
-                                }
+                                std::string reg_name (var_name_begin, var_name_end);
+                                reg_info = reg_ctx->GetRegisterInfoByName (reg_name.c_str());
+                                if (reg_info)
+                                    var_success = true;
                             }
-                            break;
-                            
-                        
-                        case 'f':
-                            if (::strncmp (var_name_begin, "file.", strlen("file.")) == 0)
+                        }
+                    }
+                }
+            }
+        }
+        else if (::strncmp (var_name_begin, "function.", strlen("function.")) == 0)
+        {
+            if (sc && (sc->function != NULL || sc->symbol != NULL))
+            {
+                var_name_begin += ::strlen ("function.");
+                if (::strncmp (var_name_begin, "id}", strlen("id}")) == 0)
+                {
+                    if (sc->function)
+                        s.Printf("function{0x%8.8llx}", sc->function->GetID());
+                    else
+                        s.Printf("symbol[%u]", sc->symbol->GetID());
+
+                    var_success = true;
+                }
+                else if (::strncmp (var_name_begin, "name}", strlen("name}")) == 0)
+                {
+                    if (sc->function)
+                        cstr = sc->function->GetName().AsCString (NULL);
+                    else if (sc->symbol)
+                        cstr = sc->symbol->GetName().AsCString (NULL);
+                    if (cstr)
+                    {
+                        s.PutCString(cstr);
+
+                        if (sc->block)
+                        {
+                            Block *inline_block = sc->block->GetContainingInlinedBlock ();
+                            if (inline_block)
                             {
-                                if (sc && sc->comp_unit != NULL)
+                                const InlineFunctionInfo *inline_info = sc->block->GetInlinedFunctionInfo();
+                                if (inline_info)
                                 {
-                                    var_name_begin += ::strlen ("file.");
-                                    
-                                    if (::strncmp (var_name_begin, "basename}", strlen("basename}")) == 0)
-                                    {
-                                        format_file_spec.GetFilename() = sc->comp_unit->GetFilename();
-                                        var_success = format_file_spec;
-                                    }
-                                    else if (::strncmp (var_name_begin, "fullpath}", strlen("fullpath}")) == 0)
-                                    {
-                                        format_file_spec = *sc->comp_unit;
-                                        var_success = format_file_spec;
-                                    }
+                                    s.PutCString(" [inlined] ");
+                                    inline_info->GetName().Dump(&s);
                                 }
                             }
-                            else if (::strncmp (var_name_begin, "frame.", strlen("frame.")) == 0)
+                        }
+                        var_success = true;
+                    }
+                }
+                else if (::strncmp (var_name_begin, "name-with-args}", strlen("name-with-args}")) == 0)
+                {
+                    // Print the function name with arguments in it
+
+                    if (sc->function)
+                    {
+                        var_success = true;
+                        ExecutionContextScope *exe_scope = exe_ctx ? exe_ctx->GetBestExecutionContextScope() : NULL;
+                        cstr = sc->function->GetName().AsCString (NULL);
+                        if (cstr)
+                        {
+                            const InlineFunctionInfo *inline_info = NULL;
+                            VariableListSP variable_list_sp;
+                            bool get_function_vars = true;
+                            if (sc->block)
                             {
-                                if (exe_ctx)
+                                Block *inline_block = sc->block->GetContainingInlinedBlock ();
+
+                                if (inline_block)
                                 {
-                                    StackFrame *frame = exe_ctx->GetFramePtr();
-                                    if (frame)
-                                    {
-                                        var_name_begin += ::strlen ("frame.");
-                                        if (::strncmp (var_name_begin, "index}", strlen("index}")) == 0)
-                                        {
-                                            s.Printf("%u", frame->GetFrameIndex());
-                                            var_success = true;
-                                        }
-                                        else if (::strncmp (var_name_begin, "pc}", strlen("pc}")) == 0)
-                                        {
-                                            reg_kind = eRegisterKindGeneric;
-                                            reg_num = LLDB_REGNUM_GENERIC_PC;
-                                            var_success = true;
-                                        }
-                                        else if (::strncmp (var_name_begin, "sp}", strlen("sp}")) == 0)
-                                        {
-                                            reg_kind = eRegisterKindGeneric;
-                                            reg_num = LLDB_REGNUM_GENERIC_SP;
-                                            var_success = true;
-                                        }
-                                        else if (::strncmp (var_name_begin, "fp}", strlen("fp}")) == 0)
-                                        {
-                                            reg_kind = eRegisterKindGeneric;
-                                            reg_num = LLDB_REGNUM_GENERIC_FP;
-                                            var_success = true;
-                                        }
-                                        else if (::strncmp (var_name_begin, "flags}", strlen("flags}")) == 0)
-                                        {
-                                            reg_kind = eRegisterKindGeneric;
-                                            reg_num = LLDB_REGNUM_GENERIC_FLAGS;
-                                            var_success = true;
-                                        }
-                                        else if (::strncmp (var_name_begin, "reg.", strlen ("reg.")) == 0)
-                                        {
-                                            reg_ctx = frame->GetRegisterContext().get();
-                                            if (reg_ctx)
-                                            {
-                                                var_name_begin += ::strlen ("reg.");
-                                                if (var_name_begin < var_name_end)
-                                                {
-                                                    std::string reg_name (var_name_begin, var_name_end);
-                                                    reg_info = reg_ctx->GetRegisterInfoByName (reg_name.c_str());
-                                                    if (reg_info)
-                                                        var_success = true;
-                                                }
-                                            }
-                                        }
-                                    }
+                                    get_function_vars = false;
+                                    inline_info = sc->block->GetInlinedFunctionInfo();
+                                    if (inline_info)
+                                        variable_list_sp = inline_block->GetBlockVariableList (true);
                                 }
                             }
-                            else if (::strncmp (var_name_begin, "function.", strlen("function.")) == 0)
-                            {
-                                if (sc && (sc->function != NULL || sc->symbol != NULL))
-                                {
-                                    var_name_begin += ::strlen ("function.");
-                                    if (::strncmp (var_name_begin, "id}", strlen("id}")) == 0)
-                                    {
-                                        if (sc->function)
-                                            s.Printf("function{0x%8.8llx}", sc->function->GetID());
-                                        else
-                                            s.Printf("symbol[%u]", sc->symbol->GetID());
 
-                                        var_success = true;
-                                    }
-                                    else if (::strncmp (var_name_begin, "name}", strlen("name}")) == 0)
-                                    {
-                                        if (sc->function)
-                                            cstr = sc->function->GetName().AsCString (NULL);
-                                        else if (sc->symbol)
-                                            cstr = sc->symbol->GetName().AsCString (NULL);
-                                        if (cstr)
-                                        {
-                                            s.PutCString(cstr);
-                                            
-                                            if (sc->block)
-                                            {
-                                                Block *inline_block = sc->block->GetContainingInlinedBlock ();
-                                                if (inline_block)
-                                                {
-                                                    const InlineFunctionInfo *inline_info = sc->block->GetInlinedFunctionInfo();
-                                                    if (inline_info)
-                                                    {
-                                                        s.PutCString(" [inlined] ");
-                                                        inline_info->GetName().Dump(&s);
-                                                    }
-                                                }
-                                            }
-                                            var_success = true;
-                                        }
-                                    }
-                                    else if (::strncmp (var_name_begin, "name-with-args}", strlen("name-with-args}")) == 0)
-                                    {
-                                        // Print the function name with arguments in it
-
-                                        if (sc->function)
-                                        {
-                                            var_success = true;
-                                            ExecutionContextScope *exe_scope = exe_ctx ? exe_ctx->GetBestExecutionContextScope() : NULL;
-                                            cstr = sc->function->GetName().AsCString (NULL);
-                                            if (cstr)
-                                            {
-                                                const InlineFunctionInfo *inline_info = NULL;
-                                                VariableListSP variable_list_sp;
-                                                bool get_function_vars = true;
-                                                if (sc->block)
-                                                {
-                                                    Block *inline_block = sc->block->GetContainingInlinedBlock ();
-
-                                                    if (inline_block)
-                                                    {
-                                                        get_function_vars = false;
-                                                        inline_info = sc->block->GetInlinedFunctionInfo();
-                                                        if (inline_info)
-                                                            variable_list_sp = inline_block->GetBlockVariableList (true);
-                                                    }
-                                                }
-                                                
-                                                if (get_function_vars)
-                                                {
-                                                    variable_list_sp = sc->function->GetBlock(true).GetBlockVariableList (true);
-                                                }
-                                                
-                                                if (inline_info)
-                                                {
-                                                    s.PutCString (cstr);
-                                                    s.PutCString (" [inlined] ");
-                                                    cstr = inline_info->GetName().GetCString();
-                                                }
-                                                
-                                                VariableList args;
-                                                if (variable_list_sp)
-                                                {
-                                                    const size_t num_variables = variable_list_sp->GetSize();
-                                                    for (size_t var_idx = 0; var_idx < num_variables; ++var_idx)
-                                                    {
-                                                        VariableSP var_sp (variable_list_sp->GetVariableAtIndex(var_idx));
-                                                        if (var_sp->GetScope() == eValueTypeVariableArgument)
-                                                            args.AddVariable (var_sp);
-                                                    }
-
-                                                }
-                                                if (args.GetSize() > 0)
-                                                {
-                                                    const char *open_paren = strchr (cstr, '(');
-                                                    const char *close_paren = NULL;
-                                                    if (open_paren)
-                                                        close_paren = strchr (open_paren, ')');
-                                                    
-                                                    if (open_paren)
-                                                        s.Write(cstr, open_paren - cstr + 1);
-                                                    else
-                                                    {
-                                                        s.PutCString (cstr);
-                                                        s.PutChar ('(');
-                                                    }
-                                                    const size_t num_args = args.GetSize();
-                                                    for (size_t arg_idx = 0; arg_idx < num_args; ++arg_idx)
-                                                    {
-                                                        VariableSP var_sp (args.GetVariableAtIndex (arg_idx));
-                                                        ValueObjectSP var_value_sp (ValueObjectVariable::Create (exe_scope, var_sp));
-                                                        const char *var_name = var_value_sp->GetName().GetCString();
-                                                        const char *var_value = var_value_sp->GetValueAsCString();
-                                                        if (var_value_sp->GetError().Success())
-                                                        {
-                                                            if (arg_idx > 0)
-                                                                s.PutCString (", ");
-                                                            s.Printf ("%s=%s", var_name, var_value);
-                                                        }
-                                                    }
-                                                    
-                                                    if (close_paren)
-                                                        s.PutCString (close_paren);
-                                                    else
-                                                        s.PutChar(')');
-
-                                                }
-                                                else
-                                                {
-                                                    s.PutCString(cstr);
-                                                }
-                                            }
-                                        }
-                                        else if (sc->symbol)
-                                        {
-                                            cstr = sc->symbol->GetName().AsCString (NULL);
-                                            if (cstr)
-                                            {
-                                                s.PutCString(cstr);
-                                                var_success = true;
-                                            }
-                                        }
-                                    }
-                                    else if (::strncmp (var_name_begin, "addr-offset}", strlen("addr-offset}")) == 0)
-                                    {
-                                        var_success = addr != NULL;
-                                        if (var_success)
-                                        {
-                                            format_addr = *addr;
-                                            calculate_format_addr_function_offset = true;
-                                        }
-                                    }
-                                    else if (::strncmp (var_name_begin, "line-offset}", strlen("line-offset}")) == 0)
-                                    {
-                                        var_success = sc->line_entry.range.GetBaseAddress().IsValid();
-                                        if (var_success)
-                                        {
-                                            format_addr = sc->line_entry.range.GetBaseAddress();
-                                            calculate_format_addr_function_offset = true;
-                                        }
-                                    }
-                                    else if (::strncmp (var_name_begin, "pc-offset}", strlen("pc-offset}")) == 0)
-                                    {
-                                        StackFrame *frame = exe_ctx->GetFramePtr();
-                                        var_success = frame != NULL;
-                                        if (var_success)
-                                        {
-                                            format_addr = frame->GetFrameCodeAddress();
-                                            calculate_format_addr_function_offset = true;
-                                        }
-                                    }
-                                }
+                            if (get_function_vars)
+                            {
+                                variable_list_sp = sc->function->GetBlock(true).GetBlockVariableList (true);
                             }
-                            break;
 
-                        case 'l':
-                            if (::strncmp (var_name_begin, "line.", strlen("line.")) == 0)
+                            if (inline_info)
                             {
-                                if (sc && sc->line_entry.IsValid())
-                                {
-                                    var_name_begin += ::strlen ("line.");
-                                    if (::strncmp (var_name_begin, "file.", strlen("file.")) == 0)
-                                    {
-                                        var_name_begin += ::strlen ("file.");
-                                        
-                                        if (::strncmp (var_name_begin, "basename}", strlen("basename}")) == 0)
-                                        {
-                                            format_file_spec.GetFilename() = sc->line_entry.file.GetFilename();
-                                            var_success = format_file_spec;
-                                        }
-                                        else if (::strncmp (var_name_begin, "fullpath}", strlen("fullpath}")) == 0)
-                                        {
-                                            format_file_spec = sc->line_entry.file;
-                                            var_success = format_file_spec;
-                                        }
-                                    }
-                                    else if (::strncmp (var_name_begin, "number}", strlen("number}")) == 0)
-                                    {
-                                        var_success = true;
-                                        s.Printf("%u", sc->line_entry.line);
-                                    }
-                                    else if ((::strncmp (var_name_begin, "start-addr}", strlen("start-addr}")) == 0) ||
-                                             (::strncmp (var_name_begin, "end-addr}", strlen("end-addr}")) == 0))
-                                    {
-                                        var_success = sc && sc->line_entry.range.GetBaseAddress().IsValid();
-                                        if (var_success)
-                                        {
-                                            format_addr = sc->line_entry.range.GetBaseAddress();
-                                            if (var_name_begin[0] == 'e')
-                                                format_addr.Slide (sc->line_entry.range.GetByteSize());
-                                        }
-                                    }
-                                }
+                                s.PutCString (cstr);
+                                s.PutCString (" [inlined] ");
+                                cstr = inline_info->GetName().GetCString();
                             }
-                            break;
-                        }
-                        
-                        if (var_success)
-                        {
-                            // If format addr is valid, then we need to print an address
-                            if (reg_num != LLDB_INVALID_REGNUM)
-                            {
-                                StackFrame *frame = exe_ctx->GetFramePtr();
-                                // We have a register value to display...
-                                if (reg_num == LLDB_REGNUM_GENERIC_PC && reg_kind == eRegisterKindGeneric)
-                                {
-                                    format_addr = frame->GetFrameCodeAddress();
-                                }
-                                else
-                                {
-                                    if (reg_ctx == NULL)
-                                        reg_ctx = frame->GetRegisterContext().get();
 
-                                    if (reg_ctx)
-                                    {
-                                        if (reg_kind != kNumRegisterKinds)
-                                            reg_num = reg_ctx->ConvertRegisterKindToRegisterNumber(reg_kind, reg_num);
-                                        reg_info = reg_ctx->GetRegisterInfoAtIndex (reg_num);
-                                        var_success = reg_info != NULL;
-                                    }
-                                }
-                            }
-                            
-                            if (reg_info != NULL)
+                            VariableList args;
+                            if (variable_list_sp)
                             {
-                                RegisterValue reg_value;
-                                var_success = reg_ctx->ReadRegister (reg_info, reg_value);
-                                if (var_success)
+                                const size_t num_variables = variable_list_sp->GetSize();
+                                for (size_t var_idx = 0; var_idx < num_variables; ++var_idx)
                                 {
-                                    reg_value.Dump(&s, reg_info, false, false, eFormatDefault);
+                                    VariableSP var_sp (variable_list_sp->GetVariableAtIndex(var_idx));
+                                    if (var_sp->GetScope() == eValueTypeVariableArgument)
+                                        args.AddVariable (var_sp);
                                 }
-                            }                            
-                            
-                            if (format_file_spec)
-                            {
-                                s << format_file_spec;
-                            }
 
-                            // If format addr is valid, then we need to print an address
-                            if (format_addr.IsValid())
+                            }
+                            if (args.GetSize() > 0)
                             {
-                                var_success = false;
+                                const char *open_paren = strchr (cstr, '(');
+                                const char *close_paren = NULL;
+                                if (open_paren)
+                                    close_paren = strchr (open_paren, ')');
 
-                                if (calculate_format_addr_function_offset)
+                                if (open_paren)
+                                    s.Write(cstr, open_paren - cstr + 1);
+                                else
                                 {
-                                    Address func_addr;
-                                    
-                                    if (sc)
-                                    {
-                                        if (sc->function)
-                                        {
-                                            func_addr = sc->function->GetAddressRange().GetBaseAddress();
-                                            if (sc->block)
-                                            {
-                                                // Check to make sure we aren't in an inline
-                                                // function. If we are, use the inline block
-                                                // range that contains "format_addr" since
-                                                // blocks can be discontiguous.
-                                                Block *inline_block = sc->block->GetContainingInlinedBlock ();
-                                                AddressRange inline_range;
-                                                if (inline_block && inline_block->GetRangeContainingAddress (format_addr, inline_range))
-                                                    func_addr = inline_range.GetBaseAddress();
-                                            }
-                                        }
-                                        else if (sc->symbol && sc->symbol->ValueIsAddress())
-                                            func_addr = sc->symbol->GetAddress();
-                                    }
-                                    
-                                    if (func_addr.IsValid())
-                                    {
-                                        if (func_addr.GetSection() == format_addr.GetSection())
-                                        {
-                                            addr_t func_file_addr = func_addr.GetFileAddress();
-                                            addr_t addr_file_addr = format_addr.GetFileAddress();
-                                            if (addr_file_addr > func_file_addr)
-                                                s.Printf(" + %llu", addr_file_addr - func_file_addr);
-                                            else if (addr_file_addr < func_file_addr)
-                                                s.Printf(" - %llu", func_file_addr - addr_file_addr);
-                                            var_success = true;
-                                        }
-                                        else
-                                        {
-                                            Target *target = Target::GetTargetFromContexts (exe_ctx, sc);
-                                            if (target)
-                                            {
-                                                addr_t func_load_addr = func_addr.GetLoadAddress (target);
-                                                addr_t addr_load_addr = format_addr.GetLoadAddress (target);
-                                                if (addr_load_addr > func_load_addr)
-                                                    s.Printf(" + %llu", addr_load_addr - func_load_addr);
-                                                else if (addr_load_addr < func_load_addr)
-                                                    s.Printf(" - %llu", func_load_addr - addr_load_addr);
-                                                var_success = true;
-                                            }
-                                        }
-                                    }
+                                    s.PutCString (cstr);
+                                    s.PutChar ('(');
                                 }
-                                else
+                                const size_t num_args = args.GetSize();
+                                for (size_t arg_idx = 0; arg_idx < num_args; ++arg_idx)
                                 {
-                                    Target *target = Target::GetTargetFromContexts (exe_ctx, sc);
-                                    addr_t vaddr = LLDB_INVALID_ADDRESS;
-                                    if (exe_ctx && !target->GetSectionLoadList().IsEmpty())
-                                        vaddr = format_addr.GetLoadAddress (target);
-                                    if (vaddr == LLDB_INVALID_ADDRESS)
-                                        vaddr = format_addr.GetFileAddress ();
-
-                                    if (vaddr != LLDB_INVALID_ADDRESS)
+                                    VariableSP var_sp (args.GetVariableAtIndex (arg_idx));
+                                    ValueObjectSP var_value_sp (ValueObjectVariable::Create (exe_scope, var_sp));
+                                    const char *var_name = var_value_sp->GetName().GetCString();
+                                    const char *var_value = var_value_sp->GetValueAsCString();
+                                    if (var_value_sp->GetError().Success())
                                     {
-                                        int addr_width = target->GetArchitecture().GetAddressByteSize() * 2;
-                                        if (addr_width == 0)
-                                            addr_width = 16;
-                                        s.Printf("0x%*.*llx", addr_width, addr_width, vaddr);
-                                        var_success = true;
+                                        if (arg_idx > 0)
+                                            s.PutCString (", ");
+                                        s.Printf ("%s=%s", var_name, var_value);
                                     }
                                 }
+
+                                if (close_paren)
+                                    s.PutCString (close_paren);
+                                else
+                                    s.PutChar(')');
+
                             }
+                            else
+                            {
+                                s.PutCString(cstr);
+                            }
+                        }
+                    }
+                    else if (sc->symbol)
+                    {
+                        cstr = sc->symbol->GetName().AsCString (NULL);
+                        if (cstr)
+                        {
+                            s.PutCString(cstr);
+                            var_success = true;
                         }
+                    }
+                }
+                else if (::strncmp (var_name_begin, "addr-offset}", strlen("addr-offset}")) == 0)
+                {
+                    var_success = addr != NULL;
+                    if (var_success)
+                    {
+                        format_addr = *addr;
+                        calculate_format_addr_function_offset = true;
+                    }
+                }
+                else if (::strncmp (var_name_begin, "line-offset}", strlen("line-offset}")) == 0)
+                {
+                    var_success = sc->line_entry.range.GetBaseAddress().IsValid();
+                    if (var_success)
+                    {
+                        format_addr = sc->line_entry.range.GetBaseAddress();
+                        calculate_format_addr_function_offset = true;
+                    }
+                }
+                else if (::strncmp (var_name_begin, "pc-offset}", strlen("pc-offset}")) == 0)
+                {
+                    StackFrame *frame = exe_ctx->GetFramePtr();
+                    var_success = frame != NULL;
+                    if (var_success)
+                    {
+                        format_addr = frame->GetFrameCodeAddress();
+                        calculate_format_addr_function_offset = true;
+                    }
+                }
+            }
+        }
+        break;
 
-                        if (var_success == false)
-                            success = false;
+    case 'l':
+        if (::strncmp (var_name_begin, "line.", strlen("line.")) == 0)
+        {
+            if (sc && sc->line_entry.IsValid())
+            {
+                var_name_begin += ::strlen ("line.");
+                if (::strncmp (var_name_begin, "file.", strlen("file.")) == 0)
+                {
+                    var_name_begin += ::strlen ("file.");
+
+                    if (::strncmp (var_name_begin, "basename}", strlen("basename}")) == 0)
+                    {
+                        format_file_spec.GetFilename() = sc->line_entry.file.GetFilename();
+                        var_success = format_file_spec;
+                    }
+                    else if (::strncmp (var_name_begin, "fullpath}", strlen("fullpath}")) == 0)
+                    {
+                        format_file_spec = sc->line_entry.file;
+                        var_success = format_file_spec;
                     }
-                    p = var_name_end;
                 }
-                else
-                    break;
+                else if (::strncmp (var_name_begin, "number}", strlen("number}")) == 0)
+                {
+                    var_success = true;
+                    s.Printf("%u", sc->line_entry.line);
+                }
+                else if ((::strncmp (var_name_begin, "start-addr}", strlen("start-addr}")) == 0) ||
+                         (::strncmp (var_name_begin, "end-addr}", strlen("end-addr}")) == 0))
+                {
+                    var_success = sc && sc->line_entry.range.GetBaseAddress().IsValid();
+                    if (var_success)
+                    {
+                        format_addr = sc->line_entry.range.GetBaseAddress();
+                        if (var_name_begin[0] == 'e')
+                            format_addr.Slide (sc->line_entry.range.GetByteSize());
+                    }
+                }
+            }
+        }
+        break;
+    }
+
+    if (var_success)
+    {
+        // If format addr is valid, then we need to print an address
+        if (reg_num != LLDB_INVALID_REGNUM)
+        {
+            StackFrame *frame = exe_ctx->GetFramePtr();
+            // We have a register value to display...
+            if (reg_num == LLDB_REGNUM_GENERIC_PC && reg_kind == eRegisterKindGeneric)
+            {
+                format_addr = frame->GetFrameCodeAddress();
             }
             else
             {
-                // We got a dollar sign with no '{' after it, it must just be a dollar sign
-                s.PutChar(*p);
+                if (reg_ctx == NULL)
+                    reg_ctx = frame->GetRegisterContext().get();
+
+                if (reg_ctx)
+                {
+                    if (reg_kind != kNumRegisterKinds)
+                        reg_num = reg_ctx->ConvertRegisterKindToRegisterNumber(reg_kind, reg_num);
+                    reg_info = reg_ctx->GetRegisterInfoAtIndex (reg_num);
+                    var_success = reg_info != NULL;
+                }
+            }
+        }
+
+        if (reg_info != NULL)
+        {
+            RegisterValue reg_value;
+            var_success = reg_ctx->ReadRegister (reg_info, reg_value);
+            if (var_success)
+            {
+                reg_value.Dump(&s, reg_info, false, false, eFormatDefault);
             }
+        }                            
+
+        if (format_file_spec)
+        {
+            s << format_file_spec;
         }
-        else if (*p == '\\')
+
+        // If format addr is valid, then we need to print an address
+        if (format_addr.IsValid())
         {
-            ++p; // skip the slash
-            switch (*p)
+            var_success = false;
+
+            if (calculate_format_addr_function_offset)
             {
-            case 'a': s.PutChar ('\a'); break;
-            case 'b': s.PutChar ('\b'); break;
-            case 'f': s.PutChar ('\f'); break;
-            case 'n': s.PutChar ('\n'); break;
-            case 'r': s.PutChar ('\r'); break;
-            case 't': s.PutChar ('\t'); break;
-            case 'v': s.PutChar ('\v'); break;
-            case '\'': s.PutChar ('\''); break; 
-            case '\\': s.PutChar ('\\'); break; 
-            case '0':
-                // 1 to 3 octal chars
+                Address func_addr;
+
+                if (sc)
                 {
-                    // Make a string that can hold onto the initial zero char,
-                    // up to 3 octal digits, and a terminating NULL.
-                    char oct_str[5] = { 0, 0, 0, 0, 0 };
-
-                    int i;
-                    for (i=0; (p[i] >= '0' && p[i] <= '7') && i<4; ++i)
-                        oct_str[i] = p[i];
-
-                    // We don't want to consume the last octal character since
-                    // the main for loop will do this for us, so we advance p by
-                    // one less than i (even if i is zero)
-                    p += i - 1;
-                    unsigned long octal_value = ::strtoul (oct_str, NULL, 8);
-                    if (octal_value <= UINT8_MAX)
+                    if (sc->function)
                     {
-                        char octal_char = octal_value;
-                        s.Write (&octal_char, 1);
+                        func_addr = sc->function->GetAddressRange().GetBaseAddress();
+                        if (sc->block)
+                        {
+                            // Check to make sure we aren't in an inline
+                            // function. If we are, use the inline block
+                            // range that contains "format_addr" since
+                            // blocks can be discontiguous.
+                            Block *inline_block = sc->block->GetContainingInlinedBlock ();
+                            AddressRange inline_range;
+                            if (inline_block && inline_block->GetRangeContainingAddress (format_addr, inline_range))
+                                func_addr = inline_range.GetBaseAddress();
+                        }
                     }
+                    else if (sc->symbol && sc->symbol->ValueIsAddress())
+                        func_addr = sc->symbol->GetAddress();
                 }
-                break;
 
-            case 'x':
-                // hex number in the format 
-                if (isxdigit(p[1]))
+                if (func_addr.IsValid())
                 {
-                    ++p;    // Skip the 'x'
-
-                    // Make a string that can hold onto two hex chars plus a
-                    // NULL terminator
-                    char hex_str[3] = { 0,0,0 };
-                    hex_str[0] = *p;
-                    if (isxdigit(p[1]))
+                    if (func_addr.GetSection() == format_addr.GetSection())
                     {
-                        ++p; // Skip the first of the two hex chars
-                        hex_str[1] = *p;
+                        addr_t func_file_addr = func_addr.GetFileAddress();
+                        addr_t addr_file_addr = format_addr.GetFileAddress();
+                        if (addr_file_addr > func_file_addr)
+                            s.Printf(" + %llu", addr_file_addr - func_file_addr);
+                        else if (addr_file_addr < func_file_addr)
+                            s.Printf(" - %llu", func_file_addr - addr_file_addr);
+                        var_success = true;
+                    }
+                    else
+                    {
+                        Target *target = Target::GetTargetFromContexts (exe_ctx, sc);
+                        if (target)
+                        {
+                            addr_t func_load_addr = func_addr.GetLoadAddress (target);
+                            addr_t addr_load_addr = format_addr.GetLoadAddress (target);
+                            if (addr_load_addr > func_load_addr)
+                                s.Printf(" + %llu", addr_load_addr - func_load_addr);
+                            else if (addr_load_addr < func_load_addr)
+                                s.Printf(" - %llu", func_load_addr - addr_load_addr);
+                            var_success = true;
+                        }
                     }
-
-                    unsigned long hex_value = strtoul (hex_str, NULL, 16);                    
-                    if (hex_value <= UINT8_MAX)
-                        s.PutChar (hex_value);
                 }
-                else
+            }
+            else
+            {
+                Target *target = Target::GetTargetFromContexts (exe_ctx, sc);
+                addr_t vaddr = LLDB_INVALID_ADDRESS;
+                if (exe_ctx && !target->GetSectionLoadList().IsEmpty())
+                    vaddr = format_addr.GetLoadAddress (target);
+                if (vaddr == LLDB_INVALID_ADDRESS)
+                    vaddr = format_addr.GetFileAddress ();
+
+                if (vaddr != LLDB_INVALID_ADDRESS)
                 {
-                    s.PutChar('x');
+                    int addr_width = target->GetArchitecture().GetAddressByteSize() * 2;
+                    if (addr_width == 0)
+                        addr_width = 16;
+                    s.Printf("0x%*.*llx", addr_width, addr_width, vaddr);
+                    var_success = true;
                 }
-                break;
-                
-            default:
-                // Just desensitize any other character by just printing what
-                // came after the '\'
-                s << *p;
-                break;
-            
             }
+        }
+    }
+
+    return var_success;
+}
+
+static bool
+FormatPromptTokens (const PromptFormat::Token *tokens,
+                    size_t num_tokens,
+                    const SymbolContext *sc,
+                    const ExecutionContext *exe_ctx,
+                    const Address *addr,
+                    Stream &s,
+                    ValueObject *valobj)
+{
+    bool success = true;
+    for (size_t i=0; i<num_tokens; ++i)
+    {
+        const PromptFormat::Token &token = tokens[i];
+        switch (token.kind)
+        {
+        case PromptFormat::eTokenText:
+            if (success)
+                s.Write (token.text.data(), token.text.size());
+            break;
+
+        case PromptFormat::eTokenEscape:
+            s.Write (token.text.data(), token.text.size());
+            break;
+
+        case PromptFormat::eTokenVariable:
+            // if we have already failed, skip this variable
+            if (success)
+            {
+                const char *var_name_begin = token.text.c_str();
+                const char *var_name_end = var_name_begin + token.text.size() - 1;
+                if (!FormatPromptVariable (var_name_begin, var_name_end, sc, exe_ctx, addr, s, valobj))
+                    success = false;
+            }
+            break;
+
+        case PromptFormat::eTokenScope:
+            {
+                // Start a new scope that must have everything it needs if it is to
+                // to make it into the final output stream "s". If you want to make
+                // a format that only prints out the function or symbol name if there
+                // is one in the symbol context you can use:
+                //      "{function =${function.name}}"
+                // The first '{' starts a new scope that end with the matching '}' at
+                // the end of the string. The contents "function =${function.name}"
+                // will then be evaluated and only be output if there is a function
+                // or symbol with a valid name. 
+                StreamString sub_strm;
+                if (FormatPromptTokens (tokens + i + 1, token.num_scope_tokens, sc, exe_ctx, addr, sub_strm, valobj))
+                {
+                    // The stream had all it needed
+                    s.Write(sub_strm.GetData(), sub_strm.GetSize());
+                }
+                i += token.num_scope_tokens;
+            }
+            break;
 
+        case PromptFormat::eTokenError:
+            success = false;
+            break;
         }
     }
-    if (end) 
-        *end = p;
     return success;
 }
 
+bool
+Debugger::FormatPrompt 
+(
+    const char *format,
+    const SymbolContext *sc,
+    const ExecutionContext *exe_ctx,
+    const Address *addr,
+    Stream &s,
+    const char **end,
+    ValueObject* valobj
+)
+{
+    PromptFormat prompt_format (format);
+    if (end)
+        *end = format + prompt_format.GetEndOffset();
+    return FormatPrompt (prompt_format, sc, exe_ctx, addr, s, valobj);
+}
+
+bool
+Debugger::FormatPrompt (const PromptFormat &format,
+                        const SymbolContext *sc,
+                        const ExecutionContext *exe_ctx,
+                        const Address *addr,
+                        Stream &s,
+                        ValueObject* valobj)
+{
+    return FormatPromptTokens (format.GetTokens(), format.GetNumTokens(), sc, exe_ctx, addr, s, valobj);
+}
+
 void
 Debugger::SetLoggingCallback (lldb::LogOutputCallback log_callback, void *baton)
 {
@@ -22,6 +22,7 @@
 #include "lldb/Core/Module.h"
 #include "lldb/Core/PluginManager.h"
 #include "lldb/Core/RegularExpression.h"
+#include "lldb/Core/Section.h"
 #include "lldb/Core/Timer.h"
 #include "lldb/Interpreter/OptionValue.h"
 #include "lldb/Interpreter/OptionValueArray.h"
@@ -1025,6 +1026,40 @@ Disassembler::ParseInstructions
         if (target == NULL || byte_size == 0 || !range.GetBaseAddress().IsValid())
             return 0;
 
+        // Code that comes entirely from a module's object file decodes the
+        // same way every time, so the module keeps the instructions.
+        // Breakpoint traps never show up here because ReadMemory below
+        // prefers the file cache, and code the process has written to is
+        // read from the process and never cached.
+        ModuleSP module_sp;
+        const Address &base_addr = range.GetBaseAddress();
+        SectionSP section_sp (base_addr.GetSection());
+        if (section_sp &&
+            section_sp->GetType() == eSectionTypeCode &&
+            !section_sp->IsEncrypted() &&
+            base_addr.GetOffset() + byte_size <= section_sp->GetFileSize() &&
+            target->FileCacheMatchesMemory (base_addr, byte_size))
+        {
+            module_sp = section_sp->GetModule();
+            if (module_sp && module_sp->GetObjectFile() == NULL)
+                module_sp.reset();
+        }
+
+        const ConstString plugin_name (GetPluginName());
+        const addr_t file_addr = base_addr.GetFileAddress();
+        if (module_sp)
+        {
+            size_t decoded_byte_size = 0;
+            m_instruction_list.Clear();
+            if (module_sp->GetCachedInstructions (plugin_name,
+                                                  m_arch,
+                                                  file_addr,
+                                                  byte_size,
+                                                  m_instruction_list,
+                                                  decoded_byte_size))
+                return decoded_byte_size;
+        }
+
         DataBufferHeap *heap_buffer = new DataBufferHeap (byte_size, '\0');
         DataBufferSP data_sp(heap_buffer);
 
@@ -1043,7 +1078,15 @@ Disassembler::ParseInstructions
             DataExtractor data (data_sp, 
                                 m_arch.GetByteOrder(),
                                 m_arch.GetAddressByteSize());
-            return DecodeInstructions (range.GetBaseAddress(), data, 0, UINT32_MAX, false);
+            const size_t decoded_byte_size = DecodeInstructions (range.GetBaseAddress(), data, 0, UINT32_MAX, false);
+            if (module_sp && bytes_read == byte_size)
+                module_sp->CacheInstructions (plugin_name,
+                                              m_arch,
+                                              file_addr,
+                                              byte_size,
+                                              m_instruction_list,
+                                              decoded_byte_size);
+            return decoded_byte_size;
         }
         else if (error_strm_ptr)
         {
@@ -49,6 +49,37 @@ Event::~Event ()
 {
 }
 
+namespace {
+
+    // The deleter of a public shared pointer, which keeps a reference on
+    // the event's intrusive count and drops it when the last copy of the
+    // shared pointer goes away
+    struct EventReferenceReleaser
+    {
+        EventReferenceReleaser (const EventIntrusiveSP &event_sp) :
+            m_event_sp (event_sp)
+        {
+        }
+
+        void
+        operator() (Event *event)
+        {
+            m_event_sp.reset();
+        }
+
+        EventIntrusiveSP m_event_sp;
+    };
+
+}
+
+EventSP
+Event::MakePublicSP (const EventIntrusiveSP &event_sp)
+{
+    if (!event_sp)
+        return EventSP();
+    return EventSP (event_sp.get(), EventReferenceReleaser (event_sp));
+}
+
 void
 Event::Dump (Stream *s) const
 {
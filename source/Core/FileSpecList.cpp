@@ -53,7 +53,7 @@ FileSpecList::operator= (const FileSpecList& rhs)
 void
 FileSpecList::Append(const FileSpec &file_spec)
 {
-    m_files.push_back(file_spec);
+    m_files.push_back(FileSpecTable::GetIndexForFileSpec (file_spec));
 }
 
 //------------------------------------------------------------------
@@ -66,13 +66,15 @@ FileSpecList::Append(const FileSpec &file_spec)
 bool
 FileSpecList::AppendIfUnique(const FileSpec &file_spec)
 {
-    collection::iterator pos, end = m_files.end();
-    if (find(m_files.begin(), end, file_spec) == end)
+    const uint32_t file_idx = FileSpecTable::GetIndexForFileSpec (file_spec);
+    collection::const_iterator pos, end = m_files.end();
+    for (pos = m_files.begin(); pos != end; ++pos)
     {
-        m_files.push_back(file_spec);
-        return true;
+        if (*pos == file_idx || FileSpecTable::GetFileSpecAtIndex (*pos) == file_spec)
+            return false;
     }
-    return false;
+    m_files.push_back(file_idx);
+    return true;
 }
 
 //------------------------------------------------------------------
@@ -93,7 +95,7 @@ FileSpecList::Dump(Stream *s, const char *separator_cstr) const
     collection::const_iterator pos, end = m_files.end();
     for (pos = m_files.begin(); pos != end; ++pos)
     {
-        pos->Dump(s);
+        FileSpecTable::GetFileSpecAtIndex (*pos).Dump(s);
         if (separator_cstr && ((pos + 1) != end))
             s->PutCString(separator_cstr);
     }
@@ -116,16 +118,23 @@ FileSpecList::FindFileIndex (uint32_t start_idx, const FileSpec &file_spec, bool
     // FILE_SPEC argument is empty
     bool compare_filename_only = file_spec.GetDirectory().IsEmpty();
 
+    // Exact matches only need the indexes compared
+    const uint32_t file_spec_idx = FileSpecTable::FindIndexForFileSpec (file_spec);
+
     for (idx = start_idx; idx < num_files; ++idx)
     {
+        if (m_files[idx] == file_spec_idx)
+            return idx;
+
+        const FileSpec &file = FileSpecTable::GetFileSpecAtIndex (m_files[idx]);
         if (compare_filename_only)
         {
-            if (m_files[idx].GetFilename() == file_spec.GetFilename())
+            if (file.GetFilename() == file_spec.GetFilename())
                 return idx;
         }
         else
         {
-            if (FileSpec::Equal (m_files[idx], file_spec, full))
+            if (FileSpec::Equal (file, file_spec, full))
                 return idx;
         }
     }
@@ -143,7 +152,7 @@ FileSpecList::GetFileSpecAtIndex(uint32_t idx) const
 {
 
     if (idx < m_files.size())
-        return m_files[idx];
+        return FileSpecTable::GetFileSpecAtIndex (m_files[idx]);
     static FileSpec g_empty_file_spec;
     return g_empty_file_spec;
 }
@@ -152,28 +161,20 @@ const FileSpec *
 FileSpecList::GetFileSpecPointerAtIndex(uint32_t idx) const
 {
     if (idx < m_files.size())
-        return &m_files[idx];
+        return &FileSpecTable::GetFileSpecAtIndex (m_files[idx]);
     return NULL;
 }
 
 //------------------------------------------------------------------
 // Return the size in bytes that this object takes in memory. This
 // returns the size in bytes of this object's member variables and
-// any FileSpec objects its member variables contain, the result
-// doesn't not include the string values for the directories any
-// filenames as those are in shared string pools.
+// the file indexes they contain, the result doesn't include the
+// FileSpec objects as those are in the shared FileSpecTable.
 //------------------------------------------------------------------
 size_t
 FileSpecList::MemorySize () const
 {
-    size_t mem_size = sizeof(FileSpecList);
-    collection::const_iterator pos, end = m_files.end();
-    for (pos = m_files.begin(); pos != end; ++pos)
-    {
-        mem_size += pos->MemorySize();
-    }
-
-    return mem_size;
+    return sizeof(FileSpecList) + m_files.size() * sizeof(collection::value_type);
 }
 
 //------------------------------------------------------------------
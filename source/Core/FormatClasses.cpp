@@ -57,10 +57,12 @@ TypeSummaryImpl::TypeSummaryImpl(const TypeSummaryImpl::Flags& flags) :
 StringSummaryFormat::StringSummaryFormat(const TypeSummaryImpl::Flags& flags,
                                          const char *format_cstr) :
     TypeSummaryImpl(flags),
-    m_format()
+    m_format(),
+    m_compiled_format()
 {
   if (format_cstr)
     m_format.assign(format_cstr);
+  m_compiled_format.Compile(m_format.c_str());
 }
 
 bool
@@ -128,7 +130,7 @@ StringSummaryFormat::FormatObject(ValueObject *valobj,
     }
     else
     {
-        if (Debugger::FormatPrompt(m_format.c_str(), &sc, &exe_ctx, &sc.line_entry.range.GetBaseAddress(), s, NULL, valobj))
+        if (Debugger::FormatPrompt(m_compiled_format, &sc, &exe_ctx, &sc.line_entry.range.GetBaseAddress(), s, valobj))
         {
             retval.assign(s.GetString());
             return true;
@@ -243,13 +245,14 @@ std::string
 ScriptSummaryFormat::GetDescription()
 {
     StreamString sstr;
-    sstr.Printf ("%s%s%s%s%s%s%s\n%s",       Cascades() ? "" : " (not cascading)",
+    sstr.Printf ("%s%s%s%s%s%s%s%s\n%s",       Cascades() ? "" : " (not cascading)",
                  !DoesPrintChildren() ? "" : " (show children)",
                  !DoesPrintValue() ? " (hide value)" : "",
                  IsOneliner() ? " (one-line printout)" : "",
                  SkipsPointers() ? " (skip pointers)" : "",
                  SkipsReferences() ? " (skip references)" : "",
                  HideNames() ? " (hide member names)" : "",
+                 IsCacheable() ? "" : " (not cacheable)",
                  m_python_script.c_str());
     return sstr.GetString();
     
@@ -276,6 +279,20 @@ TypeFilterImpl::GetDescription()
     return sstr.GetString();
 }
 
+std::string
+CXXSyntheticChildren::GetDescription()
+{
+    StreamString sstr;
+    sstr.Printf("%s%s%s Generator at %p - %s\n",
+                Cascades() ? "" : " (not cascading)",
+                SkipsPointers() ? " (skip pointers)" : "",
+                SkipsReferences() ? " (skip references)" : "",
+                m_create_callback,
+                m_description.c_str());
+    
+    return sstr.GetString();
+}
+
 std::string
 SyntheticArrayView::GetDescription()
 {
@@ -341,10 +358,11 @@ std::string
 TypeSyntheticImpl::GetDescription()
 {
     StreamString sstr;
-    sstr.Printf("%s%s%s Python class %s",
+    sstr.Printf("%s%s%s%s Python class %s",
                 Cascades() ? "" : " (not cascading)",
                 SkipsPointers() ? " (skip pointers)" : "",
                 SkipsReferences() ? " (skip references)" : "",
+                IsCacheable() ? "" : " (not cacheable)",
                 m_python_class.c_str());
     
     return sstr.GetString();
@@ -413,7 +413,7 @@ CategoryMap::AnyMatches (ConstString type_name,
                          const char** matching_category,
                          TypeCategoryImpl::FormatCategoryItems* matching_type)
 {
-    Mutex::Locker(m_map_mutex);
+    ReadWriteLock::ReadLocker locker(m_map_lock);
     
     MapIterator pos, end = m_map.end();
     for (pos = m_map.begin(); pos != end; pos++)
@@ -432,7 +432,7 @@ lldb::TypeSummaryImplSP
 CategoryMap::GetSummaryFormat (ValueObject& valobj,
                                lldb::DynamicValueType use_dynamic)
 {
-    Mutex::Locker(m_map_mutex);
+    ReadWriteLock::ReadLocker locker(m_map_lock);
     
     uint32_t reason_why;        
     ActiveCategoriesIterator begin, end = m_active_categories.end();
@@ -517,7 +517,11 @@ FormatManager::GetSyntheticForType (lldb::TypeNameSpecifierImplSP type_sp)
         category_sp = GetCategoryAtIndex(category_id);
         if (category_sp->IsEnabled() == false)
             continue;
-        lldb::TypeSyntheticImplSP synth_current_sp((TypeSyntheticImpl*)category_sp->GetSyntheticForType(type_sp).get());
+        lldb::SyntheticChildrenSP children_sp(category_sp->GetSyntheticForType(type_sp));
+        // only Python synthetic children are TypeSyntheticImpl, skip the built-in ones
+        if (!children_sp || !children_sp->IsScripted())
+            continue;
+        lldb::TypeSyntheticImplSP synth_current_sp(STD_STATIC_POINTER_CAST(TypeSyntheticImpl,children_sp));
         if (synth_current_sp && (synth_chosen_sp.get() == NULL || (prio_category > category_sp->GetEnabledPosition())))
         {
             prio_category = category_sp->GetEnabledPosition();
@@ -548,7 +552,7 @@ lldb::SyntheticChildrenSP
 CategoryMap::GetSyntheticChildren (ValueObject& valobj,
                                    lldb::DynamicValueType use_dynamic)
 {
-    Mutex::Locker(m_map_mutex);
+    ReadWriteLock::ReadLocker locker(m_map_lock);
     
     uint32_t reason_why;
     
@@ -571,7 +575,7 @@ CategoryMap::LoopThrough(CallbackType callback, void* param)
 {
     if (callback)
     {
-        Mutex::Locker(m_map_mutex);
+        ReadWriteLock::ReadLocker locker(m_map_lock);
         
         // loop through enabled categories in respective order
         {
@@ -603,7 +607,7 @@ CategoryMap::LoopThrough(CallbackType callback, void* param)
 TypeCategoryImplSP
 CategoryMap::GetAtIndex (uint32_t index)
 {
-    Mutex::Locker(m_map_mutex);
+    ReadWriteLock::ReadLocker locker(m_map_lock);
     
     if (index < m_map.size())
     {
@@ -672,11 +676,153 @@ FormatManager::GetValidTypeName (const ConstString& type)
     return ::GetValidTypeName_Impl(type);
 }
 
+// Bound the cache for programs with a huge number of types, it is
+// simply started over when it gets this big
+#define FORMAT_CACHE_MAX_SIZE 8192
+
+bool
+FormatManager::IsFormatCacheable (ValueObject& valobj,
+                                  lldb::DynamicValueType use_dynamic)
+{
+    // Bitfields are looked up by their type name and bit size
+    if (valobj.GetBitfieldBitSize() > 0)
+        return false;
+    clang::QualType type = clang::QualType::getFromOpaquePtr(valobj.GetClangType());
+    if (type.isNull())
+        return false;
+    if (use_dynamic == lldb::eNoDynamicValues)
+        return true;
+    // With dynamic values on, the formatters for an ObjC object pointer
+    // depend on the class of the object it points to, not just on its type
+    while (!type.isNull())
+    {
+        type = type.getNonReferenceType();
+        if (type->isObjCObjectPointerType())
+            return false;
+        if (!type->isPointerType())
+            break;
+        type = type->getPointeeType();
+    }
+    return true;
+}
+
+FormatManager::FormatCacheEntry *
+FormatManager::GetFormatCacheEntry (const FormatCacheKey &key,
+                                    uint32_t revision)
+{
+    const uint32_t current_revision = GetCurrentRevision();
+    if (m_format_cache_revision != current_revision || m_format_cache.size() >= FORMAT_CACHE_MAX_SIZE)
+    {
+        m_format_cache.clear();
+        m_format_cache_revision = current_revision;
+    }
+    // Whatever was looked up before the formatters changed is stale
+    if (revision != current_revision)
+        return NULL;
+    return &m_format_cache[key];
+}
+
+lldb::TypeFormatImplSP
+FormatManager::GetFormat (ValueObject& valobj,
+                          lldb::DynamicValueType use_dynamic)
+{
+    const bool cacheable = IsFormatCacheable(valobj, use_dynamic);
+    const FormatCacheKey key(valobj.GetClangType(), use_dynamic);
+    const uint32_t revision = GetCurrentRevision();
+    if (cacheable)
+    {
+        Mutex::Locker locker(m_format_cache_mutex);
+        FormatCacheEntry *entry = GetFormatCacheEntry(key, revision);
+        if (entry && entry->has_format)
+            return entry->format_sp;
+    }
+    
+    lldb::TypeFormatImplSP format_sp;
+    m_value_nav.Get(valobj, format_sp, use_dynamic);
+    
+    if (cacheable)
+    {
+        Mutex::Locker locker(m_format_cache_mutex);
+        FormatCacheEntry *entry = GetFormatCacheEntry(key, revision);
+        if (entry)
+        {
+            entry->has_format = true;
+            entry->format_sp = format_sp;
+        }
+    }
+    return format_sp;
+}
+
+lldb::TypeSummaryImplSP
+FormatManager::GetSummaryFormat (ValueObject& valobj,
+                                 lldb::DynamicValueType use_dynamic)
+{
+    const bool cacheable = IsFormatCacheable(valobj, use_dynamic);
+    const FormatCacheKey key(valobj.GetClangType(), use_dynamic);
+    const uint32_t revision = GetCurrentRevision();
+    if (cacheable)
+    {
+        Mutex::Locker locker(m_format_cache_mutex);
+        FormatCacheEntry *entry = GetFormatCacheEntry(key, revision);
+        if (entry && entry->has_summary)
+            return entry->summary_sp;
+    }
+    
+    lldb::TypeSummaryImplSP summary_sp(m_categories_map.GetSummaryFormat(valobj, use_dynamic));
+    
+    if (cacheable)
+    {
+        Mutex::Locker locker(m_format_cache_mutex);
+        FormatCacheEntry *entry = GetFormatCacheEntry(key, revision);
+        if (entry)
+        {
+            entry->has_summary = true;
+            entry->summary_sp = summary_sp;
+        }
+    }
+    return summary_sp;
+}
+
+#ifndef LLDB_DISABLE_PYTHON
+lldb::SyntheticChildrenSP
+FormatManager::GetSyntheticChildren (ValueObject& valobj,
+                                     lldb::DynamicValueType use_dynamic)
+{
+    const bool cacheable = IsFormatCacheable(valobj, use_dynamic);
+    const FormatCacheKey key(valobj.GetClangType(), use_dynamic);
+    const uint32_t revision = GetCurrentRevision();
+    if (cacheable)
+    {
+        Mutex::Locker locker(m_format_cache_mutex);
+        FormatCacheEntry *entry = GetFormatCacheEntry(key, revision);
+        if (entry && entry->has_synthetic)
+            return entry->synthetic_sp;
+    }
+    
+    lldb::SyntheticChildrenSP synthetic_sp(m_categories_map.GetSyntheticChildren(valobj, use_dynamic));
+    
+    if (cacheable)
+    {
+        Mutex::Locker locker(m_format_cache_mutex);
+        FormatCacheEntry *entry = GetFormatCacheEntry(key, revision);
+        if (entry)
+        {
+            entry->has_synthetic = true;
+            entry->synthetic_sp = synthetic_sp;
+        }
+    }
+    return synthetic_sp;
+}
+#endif
+
 FormatManager::FormatManager() : 
     m_value_nav("format",this),
     m_named_summaries_map(this),
     m_last_revision(0),
     m_categories_map(this),
+    m_format_cache_mutex(Mutex::eMutexTypeNormal),
+    m_format_cache(),
+    m_format_cache_revision(0),
     m_default_category_name(ConstString("default")),
     m_system_category_name(ConstString("system")), 
     m_gnu_cpp_category_name(ConstString("gnu-libstdc++")),
@@ -738,14 +884,17 @@ FormatManager::LoadSTLFormatters()
     stl_synth_flags.SetCascades(true).SetSkipPointers(false).SetSkipReferences(false);
     
     gnu_category_sp->GetRegexSyntheticNavigator()->Add(RegularExpressionSP(new RegularExpression("^std::vector<.+>(( )?&)?$")),
-                                                       SyntheticChildrenSP(new TypeSyntheticImpl(stl_synth_flags,
-                                                                                                 "lldb.formatters.cpp.gnu_libstdcpp.StdVectorSynthProvider")));
+                                                       SyntheticChildrenSP(new CXXSyntheticChildren(stl_synth_flags,
+                                                                                                    "std::vector synthetic children",
+                                                                                                    lldb_private::formatters::LibstdcppVectorSyntheticFrontEndCreator)));
     gnu_category_sp->GetRegexSyntheticNavigator()->Add(RegularExpressionSP(new RegularExpression("^std::map<.+> >(( )?&)?$")),
-                                                       SyntheticChildrenSP(new TypeSyntheticImpl(stl_synth_flags,
-                                                                                                 "lldb.formatters.cpp.gnu_libstdcpp.StdMapSynthProvider")));
+                                                       SyntheticChildrenSP(new CXXSyntheticChildren(stl_synth_flags,
+                                                                                                    "std::map synthetic children",
+                                                                                                    lldb_private::formatters::LibstdcppMapSyntheticFrontEndCreator)));
     gnu_category_sp->GetRegexSyntheticNavigator()->Add(RegularExpressionSP(new RegularExpression("^std::list<.+>(( )?&)?$")),
-                                                       SyntheticChildrenSP(new TypeSyntheticImpl(stl_synth_flags,
-                                                                                                 "lldb.formatters.cpp.gnu_libstdcpp.StdListSynthProvider")));
+                                                       SyntheticChildrenSP(new CXXSyntheticChildren(stl_synth_flags,
+                                                                                                    "std::list synthetic children",
+                                                                                                    lldb_private::formatters::LibstdcppListSyntheticFrontEndCreator)));
     
     stl_summary_flags.SetDontShowChildren(false);
     gnu_category_sp->GetRegexSummaryNavigator()->Add(RegularExpressionSP(new RegularExpression("^std::vector<.+>(( )?&)?$")),
@@ -787,14 +936,17 @@ FormatManager::LoadLibcxxFormatters()
     stl_synth_flags.SetCascades(true).SetSkipPointers(false).SetSkipReferences(false);
     
     libcxx_category_sp->GetRegexSyntheticNavigator()->Add(RegularExpressionSP(new RegularExpression("^std::__1::vector<.+>(( )?&)?$")),
-                                                       SyntheticChildrenSP(new TypeSyntheticImpl(stl_synth_flags,
-                                                                                                 "lldb.formatters.cpp.libcxx.stdvector_SynthProvider")));
+                                                       SyntheticChildrenSP(new CXXSyntheticChildren(stl_synth_flags,
+                                                                                                    "libc++ std::vector synthetic children",
+                                                                                                    lldb_private::formatters::LibcxxVectorSyntheticFrontEndCreator)));
     libcxx_category_sp->GetRegexSyntheticNavigator()->Add(RegularExpressionSP(new RegularExpression("^std::__1::list<.+>(( )?&)?$")),
-                                                       SyntheticChildrenSP(new TypeSyntheticImpl(stl_synth_flags,
-                                                                                                 "lldb.formatters.cpp.libcxx.stdlist_SynthProvider")));
+                                                       SyntheticChildrenSP(new CXXSyntheticChildren(stl_synth_flags,
+                                                                                                    "libc++ std::list synthetic children",
+                                                                                                    lldb_private::formatters::LibcxxListSyntheticFrontEndCreator)));
     libcxx_category_sp->GetRegexSyntheticNavigator()->Add(RegularExpressionSP(new RegularExpression("^std::__1::map<.+> >(( )?&)?$")),
-                                                       SyntheticChildrenSP(new TypeSyntheticImpl(stl_synth_flags,
-                                                                                                 "lldb.formatters.cpp.libcxx.stdmap_SynthProvider")));
+                                                       SyntheticChildrenSP(new CXXSyntheticChildren(stl_synth_flags,
+                                                                                                    "libc++ std::map synthetic children",
+                                                                                                    lldb_private::formatters::LibcxxMapSyntheticFrontEndCreator)));
     libcxx_category_sp->GetRegexSyntheticNavigator()->Add(RegularExpressionSP(new RegularExpression("^(std::__1::)deque<.+>(( )?&)?$")),
                                                           SyntheticChildrenSP(new TypeSyntheticImpl(stl_synth_flags,
                                                                                                     "lldb.formatters.cpp.libcxx.stddeque_SynthProvider")));
@@ -0,0 +1,210 @@
+//===-- IndexCache.cpp ------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "lldb/Core/IndexCache.h"
+
+// C Includes
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+// C++ Includes
+// Other libraries and framework includes
+// Project includes
+#include "lldb/Core/ConstString.h"
+#include "lldb/Core/DataBuffer.h"
+#include "lldb/Core/Log.h"
+#include "lldb/Core/Module.h"
+#include "lldb/Core/StreamString.h"
+#include "lldb/Core/UUID.h"
+#include "lldb/Host/Endian.h"
+#include "lldb/Host/File.h"
+#include "lldb/Host/FileSpec.h"
+#include "lldb/Host/Host.h"
+#include "lldb/Target/Target.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+// 'LLIX' in the host byte order. Cache files are only ever read on the
+// host that wrote them, so we don't need to worry about byte swapping
+// and any file with a mismatched magic number is simply ignored.
+#define INDEX_CACHE_MAGIC   0x4c4c4958u
+
+bool
+IndexCache::IsEnabledForModule (Module *module)
+{
+    if (module == NULL || !module->GetUUID().IsValid())
+        return false;
+    FileSpec cache_dir (Target::GetDefaultIndexCachePath());
+    return (bool)cache_dir;
+}
+
+bool
+IndexCache::GetCacheFileForModule (Module *module,
+                                   const char *index_name,
+                                   FileSpec &cache_file)
+{
+    if (!IsEnabledForModule (module) || index_name == NULL || index_name[0] == '\0')
+        return false;
+
+    char cache_dir_path[PATH_MAX];
+    FileSpec cache_dir (Target::GetDefaultIndexCachePath());
+    if (cache_dir.GetPath (cache_dir_path, sizeof(cache_dir_path)) == 0)
+        return false;
+
+    char uuid_cstr[64];
+    if (module->GetUUID().GetAsCString (uuid_cstr, sizeof(uuid_cstr)) == NULL)
+        return false;
+
+    char cache_path[PATH_MAX];
+    const int cache_path_len = ::snprintf (cache_path,
+                                           sizeof(cache_path),
+                                           "%s/%s-%llx.%s",
+                                           cache_dir_path,
+                                           uuid_cstr,
+                                           (unsigned long long)module->GetModificationTime().GetAsSecondsSinceJan1_1970(),
+                                           index_name);
+    if (cache_path_len <= 0 || cache_path_len >= (int)sizeof(cache_path))
+        return false;
+    cache_file.SetFile (cache_path, false);
+    return true;
+}
+
+bool
+IndexCache::Load (Module *module,
+                  const char *index_name,
+                  uint32_t version,
+                  DataExtractor &data,
+                  uint32_t *offset_ptr)
+{
+    FileSpec cache_file;
+    if (!GetCacheFileForModule (module, index_name, cache_file) || !cache_file.Exists())
+        return false;
+
+    DataBufferSP data_sp (cache_file.MemoryMapFileContents ());
+    if (!data_sp || data_sp->GetByteSize() == 0)
+        return false;
+
+    data.SetData (data_sp);
+    data.SetByteOrder (lldb::endian::InlHostByteOrder());
+    data.SetAddressByteSize (sizeof(void *));
+
+    const uint32_t uuid_size = UUID::GetByteSize();
+    uint32_t offset = 0;
+    if (!data.ValidOffsetForDataOfSize (offset, 8 + uuid_size + 8))
+        return false;
+
+    if (data.GetU32 (&offset) != INDEX_CACHE_MAGIC)
+        return false;
+
+    if (data.GetU32 (&offset) != version)
+        return false;
+
+    if (::memcmp (data.GetData (&offset, uuid_size), module->GetUUID().GetBytes(), uuid_size) != 0)
+        return false;
+
+    if (data.GetU64 (&offset) != module->GetModificationTime().GetAsSecondsSinceJan1_1970())
+        return false;
+
+    LogSP log (lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_SYMBOLS));
+    if (log)
+        module->LogMessage (log.get(), "IndexCache::Load (index_name = \"%s\") loaded %llu bytes",
+                            index_name,
+                            (uint64_t)data.GetByteSize());
+    *offset_ptr = offset;
+    return true;
+}
+
+bool
+IndexCache::Save (Module *module,
+                  const char *index_name,
+                  uint32_t version,
+                  const std::string &data)
+{
+    FileSpec cache_file;
+    if (!GetCacheFileForModule (module, index_name, cache_file))
+        return false;
+
+    char cache_path[PATH_MAX];
+    if (cache_file.GetPath (cache_path, sizeof(cache_path)) == 0)
+        return false;
+
+    // Write to a temporary file and rename it into place so readers in
+    // other processes never see a partially written cache file.
+    char tmp_path[PATH_MAX];
+    const int tmp_path_len = ::snprintf (tmp_path, sizeof(tmp_path), "%s.%llu.tmp", cache_path, (uint64_t)Host::GetCurrentProcessID());
+    if (tmp_path_len <= 0 || tmp_path_len >= (int)sizeof(tmp_path))
+        return false;
+
+    StreamString header (Stream::eBinary, sizeof(void *), lldb::endian::InlHostByteOrder());
+    header.PutHex32 (INDEX_CACHE_MAGIC);
+    header.PutHex32 (version);
+    header.Write (module->GetUUID().GetBytes(), UUID::GetByteSize());
+    header.PutHex64 (module->GetModificationTime().GetAsSecondsSinceJan1_1970());
+
+    bool success = false;
+    {
+        File file (tmp_path,
+                   File::eOpenOptionWrite | File::eOpenOptionCanCreate | File::eOpenOptionTruncate,
+                   File::ePermissionsDefault);
+        if (!file.IsValid())
+            return false;
+
+        size_t header_len = header.GetSize();
+        size_t data_len = data.size();
+        success = file.Write (header.GetData(), header_len).Success() && header_len == header.GetSize() &&
+                  file.Write (data.data(), data_len).Success() && data_len == data.size();
+    }
+
+    if (success)
+        success = ::rename (tmp_path, cache_path) == 0;
+
+    if (!success)
+        ::unlink (tmp_path);
+    return success;
+}
+
+void
+IndexCache::EncodeNameMap (Stream &strm, const NameMap &map)
+{
+    const uint32_t size = map.GetSize();
+    strm.PutHex32 (size);
+    for (uint32_t i=0; i<size; ++i)
+    {
+        const char *cstr = map.GetCStringAtIndex(i);
+        strm.Write (cstr, ::strlen (cstr) + 1);
+        strm.PutHex32 (map.GetValueAtIndexUnchecked(i));
+    }
+}
+
+bool
+IndexCache::DecodeNameMap (const DataExtractor &data, uint32_t *offset_ptr, NameMap &map)
+{
+    map.Clear();
+    const uint32_t size = data.GetU32 (offset_ptr);
+    // Each entry is at least a NULL terminator and a 32 bit value.
+    if ((uint64_t)size * 5 > data.GetByteSize())
+        return false;
+    map.Reserve (size);
+    for (uint32_t i=0; i<size; ++i)
+    {
+        const char *cstr = data.GetCStr (offset_ptr);
+        if (cstr == NULL || !data.ValidOffsetForDataOfSize (*offset_ptr, 4))
+        {
+            map.Clear();
+            return false;
+        }
+        const uint32_t value = data.GetU32 (offset_ptr);
+        map.Append (ConstString (cstr).GetCString(), value);
+    }
+    // The maps are sorted by unique string pointer value, which will
+    // differ from the process that wrote the map.
+    map.Sort ();
+    return true;
+}
@@ -30,6 +30,7 @@ Listener::Listener(const char *name) :
     m_broadcasters_mutex (Mutex::eMutexTypeRecursive),
     m_events (),
     m_events_mutex (Mutex::eMutexTypeRecursive),
+    m_pending_events (NULL),
     m_cond_wait()
 {
     LogSP log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_OBJECT));
@@ -63,6 +64,7 @@ Listener::Clear()
     m_cond_wait.SetValue (false, eBroadcastNever);
     m_broadcasters.clear();
     Mutex::Locker event_locker(m_events_mutex);
+    MovePendingEvents ();
     m_events.clear();
 }
 
@@ -154,6 +156,7 @@ Listener::BroadcasterWillDestruct (Broadcaster *broadcaster)
     // Scope for "event_locker"
     {
         Mutex::Locker event_locker(m_events_mutex);
+        MovePendingEvents ();
         // Remove all events for this broadcaster object.
         event_collection::iterator pos = m_events.begin();
         while (pos != m_events.end())
@@ -164,7 +167,7 @@ Listener::BroadcasterWillDestruct (Broadcaster *broadcaster)
                 ++pos;
         }
 
-        if (m_events.empty())
+        if (m_events.empty() && m_pending_events == NULL)
             m_cond_wait.SetValue (false, eBroadcastNever);
 
     }
@@ -181,20 +184,45 @@ Listener::BroadcasterManagerWillDestruct (BroadcasterManager *manager)
 }
 
 void
-Listener::AddEvent (EventSP &event_sp)
+Listener::AddEvent (EventIntrusiveSP &event_sp)
 {
     LogSP log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_EVENTS));
     if (log)
         log->Printf ("%p Listener('%s')::AddEvent (event_sp = {%p})", this, m_name.c_str(), event_sp.get());
 
-    // Scope for "locker"
+    // Push the event onto the pending stack, this never blocks no matter
+    // what the thread that is reading our events is doing
+    PendingEvent *pending = new PendingEvent;
+    pending->event_sp = event_sp;
+    PendingEvent *head;
+    do
     {
-        Mutex::Locker locker(m_events_mutex);
-        m_events.push_back (event_sp);
-    }
+        head = m_pending_events;
+        pending->next = head;
+    } while (!__sync_bool_compare_and_swap (&m_pending_events, head, pending));
+
     m_cond_wait.SetValue (true, eBroadcastAlways);
 }
 
+void
+Listener::MovePendingEvents ()
+{
+    // Take the whole stack at once, so there is no ABA problem even
+    // though many threads push onto it
+    PendingEvent *pending = __sync_lock_test_and_set (&m_pending_events, (PendingEvent *)NULL);
+
+    // The stack is newest first, so insert each event in front of the one
+    // we inserted before it
+    event_collection::iterator insert_pos = m_events.end();
+    while (pending)
+    {
+        insert_pos = m_events.insert (insert_pos, pending->event_sp);
+        PendingEvent *next = pending->next;
+        delete pending;
+        pending = next;
+    }
+}
+
 class EventBroadcasterMatches
 {
 public:
@@ -202,7 +230,7 @@ public:
         m_broadcaster (broadcaster)    {
     }
 
-    bool operator() (const EventSP &event_sp) const
+    bool operator() (const EventIntrusiveSP &event_sp) const
     {
         if (event_sp->BroadcasterIs(m_broadcaster))
             return true;
@@ -226,7 +254,7 @@ public:
     {
     }
 
-    bool operator() (const EventSP &event_sp) const
+    bool operator() (const EventIntrusiveSP &event_sp) const
     {
         if (m_broadcaster && !event_sp->BroadcasterIs(m_broadcaster))
             return false;
@@ -267,13 +295,15 @@ Listener::FindNextEventInternal
     const ConstString *broadcaster_names, // NULL for any event
     uint32_t num_broadcaster_names,
     uint32_t event_type_mask,
-    EventSP &event_sp,
+    EventIntrusiveSP &event_sp,
     bool remove)
 {
     //LogSP log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_EVENTS));
 
     Mutex::Locker lock(m_events_mutex);
 
+    MovePendingEvents ();
+
     if (m_events.empty())
         return false;
 
@@ -296,7 +326,7 @@ Listener::FindNextEventInternal
         {
             m_events.erase(pos);
 
-            if (m_events.empty())
+            if (m_events.empty() && m_pending_events == NULL)
                 m_cond_wait.SetValue (false, eBroadcastNever);
         }
         
@@ -319,7 +349,7 @@ Listener::FindNextEventInternal
 Event *
 Listener::PeekAtNextEvent ()
 {
-    EventSP event_sp;
+    EventIntrusiveSP event_sp;
     if (FindNextEventInternal (NULL, NULL, 0, 0, event_sp, false))
         return event_sp.get();
     return NULL;
@@ -328,7 +358,7 @@ Listener::PeekAtNextEvent ()
 Event *
 Listener::PeekAtNextEventForBroadcaster (Broadcaster *broadcaster)
 {
-    EventSP event_sp;
+    EventIntrusiveSP event_sp;
     if (FindNextEventInternal (broadcaster, NULL, 0, 0, event_sp, false))
         return event_sp.get();
     return NULL;
@@ -337,7 +367,7 @@ Listener::PeekAtNextEventForBroadcaster (Broadcaster *broadcaster)
 Event *
 Listener::PeekAtNextEventForBroadcasterWithType (Broadcaster *broadcaster, uint32_t event_type_mask)
 {
-    EventSP event_sp;
+    EventIntrusiveSP event_sp;
     if (FindNextEventInternal (broadcaster, NULL, 0, event_type_mask, event_sp, false))
         return event_sp.get();
     return NULL;
@@ -351,27 +381,27 @@ Listener::GetNextEventInternal
     const ConstString *broadcaster_names, // NULL for any event
     uint32_t num_broadcaster_names,
     uint32_t event_type_mask,
-    EventSP &event_sp
+    EventIntrusiveSP &event_sp
 )
 {
     return FindNextEventInternal (broadcaster, broadcaster_names, num_broadcaster_names, event_type_mask, event_sp, true);
 }
 
 bool
-Listener::GetNextEvent (EventSP &event_sp)
+Listener::GetNextEvent (EventIntrusiveSP &event_sp)
 {
     return GetNextEventInternal (NULL, NULL, 0, 0, event_sp);
 }
 
 
 bool
-Listener::GetNextEventForBroadcaster (Broadcaster *broadcaster, EventSP &event_sp)
+Listener::GetNextEventForBroadcaster (Broadcaster *broadcaster, EventIntrusiveSP &event_sp)
 {
     return GetNextEventInternal (broadcaster, NULL, 0, 0, event_sp);
 }
 
 bool
-Listener::GetNextEventForBroadcasterWithType (Broadcaster *broadcaster, uint32_t event_type_mask, EventSP &event_sp)
+Listener::GetNextEventForBroadcasterWithType (Broadcaster *broadcaster, uint32_t event_type_mask, EventIntrusiveSP &event_sp)
 {
     return GetNextEventInternal (broadcaster, NULL, 0, event_type_mask, event_sp);
 }
@@ -385,7 +415,7 @@ Listener::WaitForEventsInternal
     const ConstString *broadcaster_names, // NULL for any event
     uint32_t num_broadcaster_names,
     uint32_t event_type_mask,
-    EventSP &event_sp
+    EventIntrusiveSP &event_sp
 )
 {
     LogSP log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_EVENTS));
@@ -406,6 +436,11 @@ Listener::WaitForEventsInternal
         // added that might meet our current filter
         m_cond_wait.SetValue (false, eBroadcastNever);
 
+        // An event may have been added after we looked, and its signal
+        // would have been lost when we reset the condition above
+        if (m_pending_events != NULL)
+            continue;
+
         if (m_cond_wait.WaitForValueEqualTo (true, timeout, &timed_out))
             continue;
 
@@ -434,7 +469,7 @@ Listener::WaitForEventForBroadcasterWithType
     const TimeValue *timeout,
     Broadcaster *broadcaster,
     uint32_t event_type_mask,
-    EventSP &event_sp
+    EventIntrusiveSP &event_sp
 )
 {
     return WaitForEventsInternal (timeout, broadcaster, NULL, 0, event_type_mask, event_sp);
@@ -445,14 +480,14 @@ Listener::WaitForEventForBroadcaster
 (
     const TimeValue *timeout,
     Broadcaster *broadcaster,
-    EventSP &event_sp
+    EventIntrusiveSP &event_sp
 )
 {
     return WaitForEventsInternal (timeout, broadcaster, NULL, 0, 0, event_sp);
 }
 
 bool
-Listener::WaitForEvent (const TimeValue *timeout, EventSP &event_sp)
+Listener::WaitForEvent (const TimeValue *timeout, EventIntrusiveSP &event_sp)
 {
     return WaitForEventsInternal (timeout, NULL, NULL, 0, 0, event_sp);
 }
@@ -481,7 +516,7 @@ Listener::WaitForEvent (const TimeValue *timeout, EventSP &event_sp)
 //}
 
 size_t
-Listener::HandleBroadcastEvent (EventSP &event_sp)
+Listener::HandleBroadcastEvent (EventIntrusiveSP &event_sp)
 {
     size_t num_handled = 0;
     Mutex::Locker locker(m_broadcasters_mutex);
@@ -30,6 +30,7 @@
 // Project includes
 #include "lldb/Core/Debugger.h"
 #include "lldb/Core/Log.h"
+#include "lldb/Core/LogBuffer.h"
 #include "lldb/Core/PluginManager.h"
 #include "lldb/Core/StreamFile.h"
 #include "lldb/Core/StreamString.h"
@@ -91,6 +92,13 @@ Log::GetMask() const
 void
 Log::PrintfWithFlagsVarArg (uint32_t flags, const char *format, va_list args)
 {
+    // Binary logs leave the formatting for whenever the records are dumped
+    if (m_options.Test (LLDB_LOG_OPTION_BINARY))
+    {
+        LogBuffer::Record (format, args);
+        return;
+    }
+
     if (m_stream_sp)
     {
         static uint32_t g_sequence_id = 0;
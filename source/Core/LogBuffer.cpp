@@ -0,0 +1,496 @@
+//===-- LogBuffer.cpp -------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "lldb/Core/LogBuffer.h"
+
+// C Includes
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// C++ Includes
+#include <algorithm>
+#include <vector>
+
+// Other libraries and framework includes
+// Project includes
+#include "lldb/Core/Stream.h"
+#include "lldb/Host/Host.h"
+#include "lldb/Host/Mutex.h"
+#include "lldb/Host/TimeValue.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+namespace {
+
+    enum ArgumentKind
+    {
+        eArgumentPercent,       // "%%", takes no argument
+        eArgumentInt,
+        eArgumentLong,
+        eArgumentLongLong,
+        eArgumentIntMax,
+        eArgumentSizeT,
+        eArgumentPtrDiff,
+        eArgumentDouble,
+        eArgumentLongDouble,    // Kept as a double
+        eArgumentPointer,
+        eArgumentString,
+        eArgumentCount,         // "%n", the pointer is skipped
+        eArgumentInvalid        // Something we don't know how to keep
+    };
+
+    struct ConversionSpec
+    {
+        const char *start;      // The '%'
+        const char *end;        // One past the conversion character
+        ArgumentKind kind;
+        uint32_t num_stars;     // The number of '*' width and precision arguments
+        bool precision_is_star;
+        int precision;          // -1 if there is no precision
+    };
+
+    struct LogRecord
+    {
+        uint64_t sequence;      // Zero while the record is being written
+        uint64_t time_usec;
+        lldb::tid_t tid;
+        const char *format;
+        uint32_t num_specs;     // The number of conversions in "format" whose arguments were kept
+        uint32_t truncated;     // Non-zero if not all of the arguments were kept
+        uint64_t args[LogBuffer::eMaxArguments];
+        char strings[LogBuffer::eMaxStringBytes];
+    };
+
+    struct ThreadLogBuffer
+    {
+        uint64_t next_index;
+        bool thread_exited;     // Another thread can take this buffer over
+        LogRecord records[LogBuffer::eNumRecordsPerThread];
+    };
+
+    bool
+    LogRecordLessThan (const LogRecord &lhs, const LogRecord &rhs)
+    {
+        return lhs.sequence < rhs.sequence;
+    }
+}
+
+typedef std::vector<ThreadLogBuffer *> ThreadLogBufferList;
+
+static uint64_t g_sequence = 0;         // The sequence number of the last record
+static uint64_t g_cleared_sequence = 0; // Records up to this one were cleared
+static pthread_key_t g_thread_log_buffer_key;
+static pthread_once_t g_thread_log_buffer_key_once = PTHREAD_ONCE_INIT;
+
+static Mutex &
+GetThreadLogBufferListMutex ()
+{
+    static Mutex g_mutex (Mutex::eMutexTypeNormal);
+    return g_mutex;
+}
+
+static ThreadLogBufferList &
+GetThreadLogBufferList ()
+{
+    static ThreadLogBufferList g_buffers;
+    return g_buffers;
+}
+
+static void
+ThreadLogBufferCleanup (void *p)
+{
+    // The records outlive the thread so they can still be dumped, the
+    // buffer is handed to the next thread that starts logging.
+    Mutex::Locker locker (GetThreadLogBufferListMutex());
+    ((ThreadLogBuffer *)p)->thread_exited = true;
+}
+
+static void
+InitializeThreadLogBufferKey ()
+{
+    ::pthread_key_create (&g_thread_log_buffer_key, ThreadLogBufferCleanup);
+}
+
+static ThreadLogBuffer *
+GetThreadLogBuffer ()
+{
+    ::pthread_once (&g_thread_log_buffer_key_once, InitializeThreadLogBufferKey);
+    ThreadLogBuffer *buffer = (ThreadLogBuffer *)::pthread_getspecific (g_thread_log_buffer_key);
+    if (buffer == NULL)
+    {
+        // Only the first record a thread logs takes the lock
+        Mutex::Locker locker (GetThreadLogBufferListMutex());
+        ThreadLogBufferList &buffers = GetThreadLogBufferList();
+        for (ThreadLogBufferList::iterator pos = buffers.begin(); pos != buffers.end(); ++pos)
+        {
+            if ((*pos)->thread_exited)
+            {
+                buffer = *pos;
+                break;
+            }
+        }
+        if (buffer == NULL)
+        {
+            buffer = new ThreadLogBuffer;
+            ::memset (buffer, 0, sizeof(ThreadLogBuffer));
+            buffers.push_back (buffer);
+        }
+        buffer->thread_exited = false;
+        ::pthread_setspecific (g_thread_log_buffer_key, buffer);
+    }
+    return buffer;
+}
+
+//----------------------------------------------------------------------
+// Find the next conversion in "format" and fill in "spec". Returns
+// false when there are no more conversions.
+//----------------------------------------------------------------------
+static bool
+GetNextConversionSpec (const char *format, ConversionSpec &spec)
+{
+    const char *p = ::strchr (format, '%');
+    if (p == NULL)
+        return false;
+
+    spec.start = p++;
+    spec.kind = eArgumentInvalid;
+    spec.num_stars = 0;
+    spec.precision_is_star = false;
+    spec.precision = -1;
+
+    if (*p == '%')
+    {
+        spec.kind = eArgumentPercent;
+        spec.end = p + 1;
+        return true;
+    }
+
+    // Flags
+    while (*p && ::strchr ("-+ #0'", *p))
+        ++p;
+
+    // Width
+    if (*p == '*')
+    {
+        ++spec.num_stars;
+        ++p;
+    }
+    else
+    {
+        while (*p >= '0' && *p <= '9')
+            ++p;
+    }
+
+    // Precision
+    if (*p == '.')
+    {
+        ++p;
+        if (*p == '*')
+        {
+            ++spec.num_stars;
+            spec.precision_is_star = true;
+            ++p;
+        }
+        else
+        {
+            spec.precision = 0;
+            while (*p >= '0' && *p <= '9')
+                spec.precision = spec.precision * 10 + (*p++ - '0');
+        }
+    }
+
+    // Length
+    char length = '\0';
+    switch (*p)
+    {
+    case 'h':
+        length = *p++;
+        if (*p == 'h')
+            ++p;
+        break;
+    case 'l':
+        length = *p++;
+        if (*p == 'l')
+        {
+            length = 'q';
+            ++p;
+        }
+        break;
+    case 'q':
+    case 'L':
+    case 'j':
+    case 'z':
+    case 't':
+        length = *p++;
+        break;
+    default:
+        break;
+    }
+
+    switch (*p)
+    {
+    case 'd': case 'i': case 'o': case 'u': case 'x': case 'X': case 'c':
+        switch (length)
+        {
+        case 'l': spec.kind = *p == 'c' ? eArgumentInvalid : eArgumentLong; break;
+        case 'q': spec.kind = eArgumentLongLong; break;
+        case 'j': spec.kind = eArgumentIntMax; break;
+        case 'z': spec.kind = eArgumentSizeT; break;
+        case 't': spec.kind = eArgumentPtrDiff; break;
+        case 'L': spec.kind = eArgumentInvalid; break;
+        default:  spec.kind = eArgumentInt; break;
+        }
+        break;
+
+    case 'e': case 'E': case 'f': case 'F': case 'g': case 'G': case 'a': case 'A':
+        spec.kind = length == 'L' ? eArgumentLongDouble : eArgumentDouble;
+        break;
+
+    case 's':
+        spec.kind = length == '\0' ? eArgumentString : eArgumentInvalid;
+        break;
+
+    case 'p':
+        spec.kind = eArgumentPointer;
+        break;
+
+    case 'n':
+        spec.kind = eArgumentCount;
+        break;
+
+    default:
+        break;
+    }
+
+    if (*p)
+        ++p;
+    spec.end = p;
+    return true;
+}
+
+void
+LogBuffer::Record (const char *format, va_list args)
+{
+    ThreadLogBuffer *buffer = GetThreadLogBuffer ();
+    LogRecord &record = buffer->records[buffer->next_index++ % eNumRecordsPerThread];
+
+    // Anyone dumping the records skips this one until it is complete
+    record.sequence = 0;
+    __sync_synchronize();
+
+    record.time_usec = TimeValue::Now().GetAsMicroSecondsSinceJan1_1970();
+    record.tid = Host::GetCurrentThreadID();
+    record.format = format;
+    record.num_specs = 0;
+    record.truncated = 0;
+
+    uint32_t num_args = 0;
+    uint32_t string_bytes = 0;
+    ConversionSpec spec;
+    const char *p = format;
+    while (!record.truncated && GetNextConversionSpec (p, spec))
+    {
+        p = spec.end;
+        if (spec.kind == eArgumentInvalid ||
+            num_args + spec.num_stars + 1 > eMaxArguments)
+        {
+            record.truncated = 1;
+            break;
+        }
+
+        int precision = spec.precision;
+        for (uint32_t i = 0; i < spec.num_stars; ++i)
+        {
+            const int star = va_arg (args, int);
+            record.args[num_args++] = (int64_t)star;
+            if (spec.precision_is_star && i + 1 == spec.num_stars)
+                precision = star;
+        }
+
+        switch (spec.kind)
+        {
+        case eArgumentPercent:
+        case eArgumentInvalid:
+            break;
+        case eArgumentInt:          record.args[num_args++] = (int64_t)va_arg (args, int); break;
+        case eArgumentLong:         record.args[num_args++] = (int64_t)va_arg (args, long); break;
+        case eArgumentLongLong:     record.args[num_args++] = (int64_t)va_arg (args, long long); break;
+        case eArgumentIntMax:       record.args[num_args++] = (int64_t)va_arg (args, intmax_t); break;
+        case eArgumentSizeT:        record.args[num_args++] = (uint64_t)va_arg (args, size_t); break;
+        case eArgumentPtrDiff:      record.args[num_args++] = (int64_t)va_arg (args, ptrdiff_t); break;
+        case eArgumentPointer:      record.args[num_args++] = (uintptr_t)va_arg (args, void *); break;
+        case eArgumentCount:        va_arg (args, void *); break;
+
+        case eArgumentDouble:
+        case eArgumentLongDouble:
+            {
+                const double value = spec.kind == eArgumentDouble ? va_arg (args, double) : (double)va_arg (args, long double);
+                ::memcpy (&record.args[num_args++], &value, sizeof(value));
+            }
+            break;
+
+        case eArgumentString:
+            {
+                const char *cstr = va_arg (args, const char *);
+                if (cstr == NULL)
+                    cstr = "(null)";
+                // A precision limits how much of the string is read, it
+                // doesn't have to be NULL terminated
+                size_t len = 0;
+                if (precision >= 0)
+                    len = ::strnlen (cstr, precision);
+                else
+                    len = ::strlen (cstr);
+                const size_t available = eMaxStringBytes - string_bytes;
+                if (available == 0)
+                {
+                    record.truncated = 1;
+                    continue;
+                }
+                if (len + 1 > available)
+                {
+                    // Keep what fits, this is the last conversion
+                    len = available - 1;
+                    record.truncated = 1;
+                }
+                ::memcpy (record.strings + string_bytes, cstr, len);
+                record.strings[string_bytes + len] = '\0';
+                record.args[num_args++] = string_bytes;
+                string_bytes += len + 1;
+            }
+            break;
+        }
+        ++record.num_specs;
+    }
+
+    __sync_synchronize();
+    record.sequence = __sync_add_and_fetch (&g_sequence, 1);
+}
+
+template <typename T>
+static void
+PrintConversion (Stream &s, const char *spec, uint32_t num_stars, const int *stars, T value)
+{
+    switch (num_stars)
+    {
+    case 0:  s.Printf (spec, value); break;
+    case 1:  s.Printf (spec, stars[0], value); break;
+    default: s.Printf (spec, stars[0], stars[1], value); break;
+    }
+}
+
+static void
+DumpRecord (Stream &s, const LogRecord &record)
+{
+    s.Printf ("%llu %llu.%6.6llu [%4.4llx]: ",
+              record.sequence,
+              record.time_usec / 1000000,
+              record.time_usec % 1000000,
+              record.tid);
+
+    uint32_t arg_idx = 0;
+    ConversionSpec spec;
+    const char *p = record.format;
+    for (uint32_t i = 0; i < record.num_specs && GetNextConversionSpec (p, spec); ++i)
+    {
+        s.Write (p, spec.start - p);
+        p = spec.end;
+
+        // Copy the conversion so it can be handed to printf on its own,
+        // without the 'L' since long doubles were kept as doubles
+        char spec_cstr[64];
+        size_t spec_len = 0;
+        for (const char *c = spec.start; c < spec.end && spec_len + 1 < sizeof(spec_cstr); ++c)
+        {
+            if (*c != 'L')
+                spec_cstr[spec_len++] = *c;
+        }
+        spec_cstr[spec_len] = '\0';
+
+        int stars[2] = { 0, 0 };
+        for (uint32_t star_idx = 0; star_idx < spec.num_stars; ++star_idx)
+            stars[star_idx] = (int)record.args[arg_idx++];
+
+        const uint64_t arg = spec.kind == eArgumentPercent || spec.kind == eArgumentCount ? 0 : record.args[arg_idx++];
+        switch (spec.kind)
+        {
+        case eArgumentPercent:      s.PutChar ('%'); break;
+        case eArgumentCount:        break;
+        case eArgumentInvalid:      break;
+        case eArgumentInt:          PrintConversion (s, spec_cstr, spec.num_stars, stars, (int)arg); break;
+        case eArgumentLong:         PrintConversion (s, spec_cstr, spec.num_stars, stars, (long)arg); break;
+        case eArgumentLongLong:     PrintConversion (s, spec_cstr, spec.num_stars, stars, (long long)arg); break;
+        case eArgumentIntMax:       PrintConversion (s, spec_cstr, spec.num_stars, stars, (intmax_t)arg); break;
+        case eArgumentSizeT:        PrintConversion (s, spec_cstr, spec.num_stars, stars, (size_t)arg); break;
+        case eArgumentPtrDiff:      PrintConversion (s, spec_cstr, spec.num_stars, stars, (ptrdiff_t)arg); break;
+        case eArgumentPointer:      PrintConversion (s, spec_cstr, spec.num_stars, stars, (void *)(uintptr_t)arg); break;
+        case eArgumentString:       PrintConversion (s, spec_cstr, spec.num_stars, stars, record.strings + arg); break;
+        case eArgumentDouble:
+        case eArgumentLongDouble:
+            {
+                double value;
+                ::memcpy (&value, &arg, sizeof(value));
+                PrintConversion (s, spec_cstr, spec.num_stars, stars, value);
+            }
+            break;
+        }
+    }
+
+    if (record.truncated)
+        s.PutCString (" <truncated>");
+    else
+        s.PutCString (p);
+    s.EOL();
+}
+
+size_t
+LogBuffer::Dump (Stream &s)
+{
+    std::vector<LogRecord> records;
+    {
+        Mutex::Locker locker (GetThreadLogBufferListMutex());
+        const uint64_t cleared_sequence = g_cleared_sequence;
+        ThreadLogBufferList &buffers = GetThreadLogBufferList();
+        for (ThreadLogBufferList::iterator pos = buffers.begin(); pos != buffers.end(); ++pos)
+        {
+            const ThreadLogBuffer *buffer = *pos;
+            for (uint32_t i = 0; i < eNumRecordsPerThread; ++i)
+            {
+                // The thread that owns the buffer may be writing the record
+                // right now, only keep copies that didn't change under us
+                const LogRecord &record = buffer->records[i];
+                const uint64_t sequence = record.sequence;
+                if (sequence <= cleared_sequence)
+                    continue;
+                __sync_synchronize();
+                LogRecord copy;
+                ::memcpy (&copy, &record, sizeof(copy));
+                __sync_synchronize();
+                if (record.sequence == sequence && copy.sequence == sequence)
+                    records.push_back (copy);
+            }
+        }
+    }
+
+    std::sort (records.begin(), records.end(), LogRecordLessThan);
+    const size_t num_records = records.size();
+    for (size_t i = 0; i < num_records; ++i)
+        DumpRecord (s, records[i]);
+    return num_records;
+}
+
+void
+LogBuffer::Clear ()
+{
+    Mutex::Locker locker (GetThreadLogBufferListMutex());
+    g_cleared_sequence = __sync_add_and_fetch (&g_sequence, 0);
+}
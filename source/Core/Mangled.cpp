@@ -29,6 +29,8 @@
 #include "lldb/Core/Stream.h"
 #include "lldb/Core/Timer.h"
 #include <ctype.h>
+#include <pthread.h>
+#include <stdlib.h>
 #include <string.h>
 
 using namespace lldb_private;
@@ -41,6 +43,68 @@ cstring_is_mangled (const char *s)
     return false;
 }
 
+//----------------------------------------------------------------------
+// __cxa_demangle() mallocs the buffer it returns the demangled name in
+// unless it is handed a buffer that is big enough. Each thread keeps a
+// buffer that it reuses for every name it demangles, and that only
+// grows when a demangled name doesn't fit.
+//----------------------------------------------------------------------
+struct DemangleBuffer
+{
+    char *buf;
+    size_t size;
+};
+
+static pthread_key_t g_demangle_buffer_key;
+static pthread_once_t g_demangle_buffer_key_once = PTHREAD_ONCE_INIT;
+
+static void
+DemangleBufferCleanup (void *p)
+{
+    DemangleBuffer *buffer = (DemangleBuffer *)p;
+    free (buffer->buf);
+    delete buffer;
+}
+
+static void
+InitializeDemangleBufferKey ()
+{
+    ::pthread_key_create (&g_demangle_buffer_key, DemangleBufferCleanup);
+}
+
+//----------------------------------------------------------------------
+// Returns the demangled name in the buffer of the current thread, the
+// result is only valid until the next call on the same thread.
+//----------------------------------------------------------------------
+static const char *
+DemangleIntoThreadBuffer (const char *mangled_cstr)
+{
+#if defined(USE_BUILTIN_LIBCXXABI_DEMANGLER) || defined(LLDB_LIBCXXABI)
+    ::pthread_once (&g_demangle_buffer_key_once, InitializeDemangleBufferKey);
+    DemangleBuffer *buffer = (DemangleBuffer *)::pthread_getspecific (g_demangle_buffer_key);
+    if (buffer == NULL)
+    {
+        buffer = new DemangleBuffer;
+        buffer->buf = NULL;
+        buffer->size = 0;
+        ::pthread_setspecific (g_demangle_buffer_key, buffer);
+    }
+
+    int status = 0;
+#if defined(USE_BUILTIN_LIBCXXABI_DEMANGLER)
+    char *demangled_name = lldb_cxxabiv1::__cxa_demangle (mangled_cstr, buffer->buf, &buffer->size, &status);
+#else
+    char *demangled_name = abi::__cxa_demangle (mangled_cstr, buffer->buf, &buffer->size, &status);
+#endif
+    // The buffer might have been reallocated to fit the name
+    if (demangled_name)
+        buffer->buf = demangled_name;
+    return demangled_name;
+#else
+    return NULL;
+#endif
+}
+
 #pragma mark Mangled
 //----------------------------------------------------------------------
 // Default constructor
@@ -202,25 +266,18 @@ Mangled::GetDemangledName () const
         const char *mangled_cstr = m_mangled.GetCString();
         if (cstring_is_mangled(mangled_cstr))
         {
-            if (!m_mangled.GetMangledCounterpart(m_demangled))
+            // The string pool remembers the demangled name of every mangled
+            // name we have demangled, including the ones that failed to
+            // demangle, so each unique name only goes through the demangler
+            // once no matter how many modules it appears in.
+            m_mangled.GetMangledCounterpart(m_demangled);
+            if (m_demangled.GetCString() == NULL)
             {
-                // We didn't already mangle this name, demangle it and if all goes well
-                // add it to our map.
-#if defined(USE_BUILTIN_LIBCXXABI_DEMANGLER)
-                char *demangled_name = lldb_cxxabiv1::__cxa_demangle (mangled_cstr, NULL, NULL, NULL);
-#else
-#ifdef LLDB_LIBCXXABI
-                char *demangled_name = abi::__cxa_demangle (mangled_cstr, NULL, NULL, NULL);
-#else
-                char *demangled_name = 0;
-#endif
-#endif
-
+                const char *demangled_name = DemangleIntoThreadBuffer (mangled_cstr);
                 if (demangled_name)
-                {
-                    m_demangled.SetCStringWithMangledCounterpart(demangled_name, m_mangled);                    
-                    free (demangled_name);
-                }
+                    m_demangled.SetCStringWithMangledCounterpart(demangled_name, m_mangled);
+                else
+                    m_mangled.SetEmptyMangledCounterpart();
             }
         }
         if (!m_demangled)
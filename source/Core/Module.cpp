@@ -8,9 +8,14 @@
 //===----------------------------------------------------------------------===//
 
 #include "lldb/Core/Module.h"
+
+
 #include "lldb/Core/DataBuffer.h"
 #include "lldb/Core/DataBufferHeap.h"
+#include "lldb/Core/DataExtractor.h"
+#include "lldb/Core/Disassembler.h"
 #include "lldb/Core/Log.h"
+#include "lldb/Core/IndexCache.h"
 #include "lldb/Core/ModuleList.h"
 #include "lldb/Core/ModuleSpec.h"
 #include "lldb/Core/RegularExpression.h"
@@ -22,6 +27,7 @@
 #include "lldb/Symbol/CompileUnit.h"
 #include "lldb/Symbol/ObjectFile.h"
 #include "lldb/Symbol/SymbolContext.h"
+#include "lldb/Symbol/SymbolFile.h"
 #include "lldb/Symbol/SymbolVendor.h"
 #include "lldb/Target/Process.h"
 #include "lldb/Target/Target.h"
@@ -132,11 +138,19 @@ Module::Module (const ModuleSpec &module_spec) :
     m_symfile_ap (),
     m_ast (),
     m_source_mappings (),
+    m_shared_module_stamp (0),
+    m_disassembly_cache (),
+    m_disassembly_cache_byte_size (0),
+    m_inlined_call_sites (),
+    m_name_filter (),
     m_did_load_objfile (false),
     m_did_load_symbol_vendor (false),
     m_did_parse_uuid (false),
     m_did_init_ast (false),
     m_is_dynamic_loader_module (false),
+    m_symbols_on_demand (false),
+    m_did_init_name_filter (false),
+    m_name_filter_is_complete (false),
     m_file_has_changed (false),
     m_first_file_changed_log (false)
 {
@@ -175,11 +189,19 @@ Module::Module(const FileSpec& file_spec,
     m_symfile_ap (),
     m_ast (),
     m_source_mappings (),
+    m_shared_module_stamp (0),
+    m_disassembly_cache (),
+    m_disassembly_cache_byte_size (0),
+    m_inlined_call_sites (),
+    m_name_filter (),
     m_did_load_objfile (false),
     m_did_load_symbol_vendor (false),
     m_did_parse_uuid (false),
     m_did_init_ast (false),
     m_is_dynamic_loader_module (false),
+    m_symbols_on_demand (false),
+    m_did_init_name_filter (false),
+    m_name_filter_is_complete (false),
     m_file_has_changed (false),
     m_first_file_changed_log (false)
 {
@@ -224,6 +246,12 @@ Module::~Module()
                      m_object_name.IsEmpty() ? "" : "(",
                      m_object_name.IsEmpty() ? "" : m_object_name.AsCString(""),
                      m_object_name.IsEmpty() ? "" : ")");
+    // Save the UnwindPlans profiled for this module. The object file can't
+    // get at us through GetModule() anymore, so pass ourselves in.
+    if (m_objfile_sp)
+        m_objfile_sp->GetUnwindTable().SaveProfiledUnwindPlans (this);
+    if (m_symfile_ap.get() && m_symfile_ap->GetSymbolFile())
+        m_symfile_ap->GetSymbolFile()->SaveToIndexCache (this);
     // Release any auto pointers before we start tearing down our member 
     // variables since the object file and symbol files might need to make
     // function calls back into this module object. The ordering is important
@@ -499,6 +527,11 @@ Module::ResolveSymbolContextsForFileSpec (const FileSpec &file_spec, uint32_t li
 
     const uint32_t initial_count = sc_list.GetSize();
 
+    // The symbol table can't say which files a module was built from,
+    // so check the compile units before holding back the debug info
+    if (GetSymbolsOnDemand() && MayContainFile (file_spec))
+        LoadSymbolsOnDemand ();
+
     SymbolVendor *symbols = GetSymbolVendor  ();
     if (symbols)
         symbols->ResolveSymbolContext (file_spec, line, check_inlines, resolve_scope, sc_list);
@@ -510,6 +543,15 @@ Module::ResolveSymbolContextsForFileSpec (const FileSpec &file_spec, uint32_t li
 uint32_t
 Module::FindGlobalVariables(const ConstString &name, const ClangNamespaceDecl *namespace_decl, bool append, uint32_t max_matches, VariableList& variables)
 {
+    if (!MayContainName (name))
+    {
+        if (!append)
+            variables.Clear();
+        return 0;
+    }
+    if (GetSymbolsOnDemand())
+        LoadSymbolsOnDemand ();
+
     SymbolVendor *symbols = GetSymbolVendor ();
     if (symbols)
         return symbols->FindGlobalVariables(name, namespace_decl, append, max_matches, variables);
@@ -563,6 +605,14 @@ Module::FindFunctions (const ConstString &name,
 
     const uint32_t start_size = sc_list.GetSize();
 
+    // Most modules don't have the function, skip them without looking
+    // in their symbol table or symbol file indexes. A module that loads
+    // its symbols on demand needs them once it might have it.
+    if (!MayContainName (name))
+        return 0;
+    if (GetSymbolsOnDemand())
+        LoadSymbolsOnDemand ();
+
     // Find all the functions (not symbols, but debug information functions...
     SymbolVendor *symbols = GetSymbolVendor ();
     if (symbols)
@@ -722,6 +772,15 @@ Module::FindTypes (const SymbolContext& sc,
 
 SymbolVendor*
 Module::GetSymbolVendor (bool can_create)
+{
+    Mutex::Locker locker (m_mutex);
+    if (m_symbols_on_demand)
+        return NULL;
+    return LoadSymbolVendor (can_create);
+}
+
+SymbolVendor*
+Module::LoadSymbolVendor (bool can_create)
 {
     Mutex::Locker locker (m_mutex);
     if (m_did_load_symbol_vendor == false && can_create)
@@ -737,6 +796,436 @@ Module::GetSymbolVendor (bool can_create)
     return m_symfile_ap.get();
 }
 
+void
+Module::PreloadSymbols ()
+{
+    Mutex::Locker locker (m_mutex);
+    ObjectFile *objfile = GetObjectFile();
+    if (objfile)
+    {
+        Symtab *symtab = objfile->GetSymtab();
+        if (symtab)
+            symtab->PreloadSymbols();
+    }
+
+    SymbolVendor *symbols = GetSymbolVendor ();
+    if (symbols)
+    {
+        SymbolFile *symbol_file = symbols->GetSymbolFile();
+        if (symbol_file)
+            symbol_file->PreloadSymbols();
+    }
+}
+
+// Bumped whenever a module loads its debug information on demand
+static uint32_t g_symbols_loaded_on_demand_generation = 0;
+
+void
+Module::SetSymbolsOnDemand ()
+{
+    Mutex::Locker locker (m_mutex);
+    if (!m_did_load_symbol_vendor)
+        m_symbols_on_demand = true;
+}
+
+bool
+Module::GetSymbolsOnDemand () const
+{
+    Mutex::Locker locker (m_mutex);
+    return m_symbols_on_demand;
+}
+
+bool
+Module::LoadSymbolsOnDemand ()
+{
+    Mutex::Locker locker (m_mutex);
+    if (!m_symbols_on_demand)
+        return false;
+    m_symbols_on_demand = false;
+    // Build the name filter again with the symbol file's names
+    m_did_init_name_filter = false;
+    ClearInlinedCallSites();
+    __sync_add_and_fetch (&g_symbols_loaded_on_demand_generation, 1);
+
+    LogSP log (lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_SYMBOLS));
+    if (log)
+        LogMessage (log.get(), "Module::LoadSymbolsOnDemand ()");
+    return true;
+}
+
+bool
+Module::MayContainFile (const FileSpec &file_spec)
+{
+    Mutex::Locker locker (m_mutex);
+    SymbolVendor *symbols = LoadSymbolVendor (true);
+    if (symbols == NULL)
+        return false;
+
+    const bool full = file_spec.GetDirectory();
+    const uint32_t num_compile_units = symbols->GetNumCompileUnits();
+    for (uint32_t i=0; i<num_compile_units; ++i)
+    {
+        CompUnitSP cu_sp (symbols->GetCompileUnitAtIndex(i));
+        if (!cu_sp)
+            continue;
+        if (FileSpec::Equal (*cu_sp, file_spec, full))
+            return true;
+        if (cu_sp->GetSupportFiles().FindFileIndex (0, file_spec, full) != UINT32_MAX)
+            return true;
+    }
+    return false;
+}
+
+uint32_t
+Module::GetSymbolsLoadedOnDemandGeneration ()
+{
+    return g_symbols_loaded_on_demand_generation;
+}
+
+// Get the part of a symbol name that a lookup by base name would use:
+// "bar" for "foo::bar(int)" and for "-[Foo bar]". Returns false if the
+// name is its own base name.
+static bool
+GetNameFilterBaseName (const char *name, std::string &base_name)
+{
+    if ((name[0] == '-' || name[0] == '+') && name[1] == '[')
+    {
+        const char *selector = ::strchr (name, ' ');
+        const char *end = ::strchr (name, ']');
+        if (selector == NULL || end == NULL || end < selector)
+            return false;
+        base_name.assign (selector + 1, end);
+        return true;
+    }
+
+    const char *end = ::strchr (name, '(');
+    if (end == NULL)
+        end = name + ::strlen (name);
+    const char *start = name;
+    for (const char *pos = name; pos + 1 < end; ++pos)
+    {
+        if (pos[0] == ':' && pos[1] == ':')
+            start = pos + 2;
+    }
+    if (start == name && *end == '\0')
+        return false;
+    base_name.assign (start, end);
+    return true;
+}
+
+static void
+AddNameToFilter (const char *name, NameBloomFilter &name_filter)
+{
+    if (name == NULL || name[0] == '\0')
+        return;
+    name_filter.Insert (name);
+    std::string base_name;
+    if (GetNameFilterBaseName (name, base_name) && !base_name.empty())
+        name_filter.Insert (base_name.c_str());
+}
+
+// Bump this whenever the names in the filter or its encoding change
+#define NAME_FILTER_CACHE_VERSION   2
+
+// Describe the symbol file whose names went into a module's name filter,
+// so a cached filter isn't used with a different symbol file, like a
+// dSYM that was added later with SetSymbolFileFileSpec().
+static void
+GetNameFilterSymbolFileKey (SymbolFile *symbol_file, std::string &key)
+{
+    key.clear();
+    if (symbol_file == NULL)
+        return;
+    key = symbol_file->GetPluginName();
+    ObjectFile *objfile = symbol_file->GetObjectFile();
+    if (objfile)
+    {
+        char path[PATH_MAX];
+        if (objfile->GetFileSpec().GetPath (path, sizeof(path)))
+        {
+            StreamString strm;
+            strm.Printf (":%s:%llu", path, objfile->GetFileSpec().GetModificationTime().GetAsSecondsSinceJan1_1970());
+            key.append (strm.GetData(), strm.GetSize());
+        }
+        UUID uuid;
+        char uuid_cstr[64];
+        if (objfile->GetUUID (&uuid) && uuid.GetAsCString (uuid_cstr, sizeof(uuid_cstr)))
+        {
+            key.append (1, ':');
+            key.append (uuid_cstr);
+        }
+    }
+}
+
+void
+Module::InitializeNameFilter ()
+{
+    // Protected function, the caller holds m_mutex
+    m_did_init_name_filter = true;
+    m_name_filter_is_complete = true;
+    m_name_filter.Clear();
+    Timer scoped_timer(__PRETTY_FUNCTION__, __PRETTY_FUNCTION__);
+
+    // A module that loads its symbols on demand has no symbol vendor
+    // yet, and can only find what is in its symbol table until it does
+    SymbolVendor *symbols = GetSymbolVendor ();
+    SymbolFile *symbol_file = symbols ? symbols->GetSymbolFile() : NULL;
+    std::string symbol_file_key;
+    GetNameFilterSymbolFileKey (symbol_file, symbol_file_key);
+
+    // Only complete filters are saved, so a cached one can be used
+    // without indexing the symbol file at all
+    if (IndexCache::IsEnabledForModule (this))
+    {
+        DataExtractor data;
+        uint32_t offset = 0;
+        if (IndexCache::Load (this, "name-filter", NAME_FILTER_CACHE_VERSION, data, &offset))
+        {
+            const char *cached_symbol_file_key = data.GetCStr (&offset);
+            if (cached_symbol_file_key &&
+                symbol_file_key == cached_symbol_file_key &&
+                m_name_filter.Decode (data, &offset))
+                return;
+        }
+        m_name_filter.Clear();
+    }
+
+    std::vector<const char *> symbol_file_names;
+    if (symbol_file && !symbol_file->AppendLookupNames (symbol_file_names))
+    {
+        m_name_filter_is_complete = false;
+        return;
+    }
+
+    ObjectFile *objfile = GetObjectFile();
+    Symtab *symtab = objfile ? objfile->GetSymtab() : NULL;
+    const size_t num_symbols = symtab ? symtab->GetNumSymbols() : 0;
+    // Count a mangled, a demangled and a base name for each symbol, and
+    // a name and a base name for each of the symbol file's names
+    m_name_filter.Reset (num_symbols * 3 + symbol_file_names.size() * 2);
+    for (size_t i=0; i<num_symbols; ++i)
+    {
+        const Mangled &mangled = symtab->SymbolAtIndex(i)->GetMangled();
+        AddNameToFilter (mangled.GetMangledName().GetCString(), m_name_filter);
+        AddNameToFilter (mangled.GetDemangledName().GetCString(), m_name_filter);
+    }
+    const size_t num_symbol_file_names = symbol_file_names.size();
+    for (size_t i=0; i<num_symbol_file_names; ++i)
+        AddNameToFilter (symbol_file_names[i], m_name_filter);
+
+    if (IndexCache::IsEnabledForModule (this))
+    {
+        StreamString strm (Stream::eBinary, sizeof(void *), lldb::endian::InlHostByteOrder());
+        strm.PutCString (symbol_file_key.c_str());
+        m_name_filter.Encode (strm);
+        IndexCache::Save (this, "name-filter", NAME_FILTER_CACHE_VERSION, strm.GetString());
+    }
+}
+
+bool
+Module::MayContainName (const ConstString &name, bool can_build)
+{
+    if (!name)
+        return false;
+
+    Mutex::Locker locker (m_mutex);
+    if (!m_did_init_name_filter)
+    {
+        if (!can_build)
+            return true;
+        InitializeNameFilter ();
+    }
+    if (!m_name_filter_is_complete)
+        return true;
+
+    const char *cstr = name.GetCString();
+    if (m_name_filter.MayContain (cstr))
+        return true;
+    std::string base_name;
+    if (GetNameFilterBaseName (cstr, base_name) && !base_name.empty())
+        return m_name_filter.MayContain (base_name.c_str());
+    return false;
+}
+
+void
+Module::ClearParsedData ()
+{
+    Mutex::Locker locker (m_mutex);
+    // The symbol file refers to the symbol table and the types, so it
+    // must go first. Anything it cached for the index cache is only
+    // saved when it goes away.
+    if (m_symfile_ap.get() && m_symfile_ap->GetSymbolFile())
+        m_symfile_ap->GetSymbolFile()->SaveToIndexCache (this);
+    m_symfile_ap.reset();
+    m_did_load_symbol_vendor = false;
+    if (m_objfile_sp)
+        m_objfile_sp->ClearSymtab();
+    m_ast.Clear();
+    m_did_init_ast = false;
+    ClearDisassemblyCache();
+    ClearInlinedCallSites();
+}
+
+bool
+Module::HasParsedData () const
+{
+    Mutex::Locker locker (m_mutex);
+    return m_did_load_symbol_vendor || m_did_init_ast;
+}
+
+uint64_t
+Module::GetParsedDataByteSizeEstimate ()
+{
+    Mutex::Locker locker (m_mutex);
+    uint64_t byte_size = 0;
+    if (m_objfile_sp)
+        byte_size += m_objfile_sp->GetByteSize();
+    if (m_symfile_ap.get())
+    {
+        SymbolFile *symbol_file = m_symfile_ap->GetSymbolFile();
+        ObjectFile *symbol_objfile = symbol_file ? symbol_file->GetObjectFile() : NULL;
+        if (symbol_objfile && symbol_objfile != m_objfile_sp.get())
+            byte_size += symbol_objfile->GetByteSize();
+    }
+    return byte_size;
+}
+
+// The most bytes of code a module keeps decoded instructions for. The
+// instructions take many times more memory than the code they decode.
+#define MAX_DISASSEMBLY_CACHE_BYTE_SIZE (256 * 1024)
+
+bool
+Module::DisassemblyCacheKey::operator < (const DisassemblyCacheKey &rhs) const
+{
+    if (file_addr != rhs.file_addr)
+        return file_addr < rhs.file_addr;
+    if (byte_size != rhs.byte_size)
+        return byte_size < rhs.byte_size;
+    if (plugin_name != rhs.plugin_name)
+        return plugin_name.GetCString() < rhs.plugin_name.GetCString();
+    return triple.GetCString() < rhs.triple.GetCString();
+}
+
+bool
+Module::GetCachedInstructions (const ConstString &plugin_name,
+                               const ArchSpec &arch,
+                               lldb::addr_t file_addr,
+                               lldb::addr_t byte_size,
+                               InstructionList &instructions,
+                               size_t &decoded_byte_size)
+{
+    DisassemblyCacheKey key;
+    key.plugin_name = plugin_name;
+    key.triple.SetCString (arch.GetTriple().getTriple().c_str());
+    key.file_addr = file_addr;
+    key.byte_size = byte_size;
+
+    Mutex::Locker locker (m_mutex);
+    DisassemblyCache::const_iterator pos = m_disassembly_cache.find (key);
+    if (pos == m_disassembly_cache.end())
+        return false;
+    const size_t num_instructions = pos->second.instructions.size();
+    for (size_t i = 0; i < num_instructions; ++i)
+    {
+        InstructionSP inst_sp (pos->second.instructions[i]);
+        instructions.Append (inst_sp);
+    }
+    decoded_byte_size = pos->second.decoded_byte_size;
+    return true;
+}
+
+void
+Module::CacheInstructions (const ConstString &plugin_name,
+                           const ArchSpec &arch,
+                           lldb::addr_t file_addr,
+                           lldb::addr_t byte_size,
+                           const InstructionList &instructions,
+                           size_t decoded_byte_size)
+{
+    if (byte_size > MAX_DISASSEMBLY_CACHE_BYTE_SIZE)
+        return;
+
+    DisassemblyCacheKey key;
+    key.plugin_name = plugin_name;
+    key.triple.SetCString (arch.GetTriple().getTriple().c_str());
+    key.file_addr = file_addr;
+    key.byte_size = byte_size;
+
+    Mutex::Locker locker (m_mutex);
+    // Start over rather than keep track of which ranges were used last.
+    if (m_disassembly_cache_byte_size + byte_size > MAX_DISASSEMBLY_CACHE_BYTE_SIZE)
+        ClearDisassemblyCache();
+
+    DisassemblyCacheEntry &entry = m_disassembly_cache[key];
+    if (!entry.instructions.empty())
+        return;
+    const size_t num_instructions = instructions.GetSize();
+    entry.instructions.reserve (num_instructions);
+    for (size_t i = 0; i < num_instructions; ++i)
+        entry.instructions.push_back (instructions.GetInstructionAtIndex (i));
+    entry.decoded_byte_size = decoded_byte_size;
+    m_disassembly_cache_byte_size += byte_size;
+}
+
+void
+Module::ClearDisassemblyCache ()
+{
+    Mutex::Locker locker (m_mutex);
+    m_disassembly_cache.clear();
+    m_disassembly_cache_byte_size = 0;
+}
+
+#define MAX_INLINED_CALL_SITE_ADDRESSES (16 * 1024)
+
+bool
+Module::GetInlinedCallSites (const Address &so_addr, std::vector<Address> &call_sites)
+{
+    call_sites.clear();
+    if (so_addr.GetModule().get() != this)
+        return false;
+    const lldb::addr_t file_addr = so_addr.GetFileAddress();
+    if (file_addr == LLDB_INVALID_ADDRESS)
+        return false;
+
+    Mutex::Locker locker (m_mutex);
+    InlinedCallSiteMap::const_iterator pos = m_inlined_call_sites.find (file_addr);
+    if (pos != m_inlined_call_sites.end())
+    {
+        call_sites = pos->second;
+        return !call_sites.empty();
+    }
+
+    SymbolContext sc;
+    ResolveSymbolContextForAddress (so_addr, eSymbolContextBlock | eSymbolContextFunction, sc);
+    if (sc.block)
+    {
+        Address curr_address (so_addr);
+        SymbolContext next_sc;
+        Address next_address;
+        while (sc.GetParentOfInlinedScope (curr_address, next_sc, next_address))
+        {
+            call_sites.push_back (next_address);
+            sc = next_sc;
+            curr_address = next_address;
+        }
+    }
+
+    // Start over rather than keep track of which addresses were used last.
+    if (m_inlined_call_sites.size() >= MAX_INLINED_CALL_SITE_ADDRESSES)
+        m_inlined_call_sites.clear();
+    // Remember the addresses that aren't inlined too, they are the
+    // common case.
+    m_inlined_call_sites[file_addr] = call_sites;
+    return !call_sites.empty();
+}
+
+void
+Module::ClearInlinedCallSites ()
+{
+    Mutex::Locker locker (m_mutex);
+    m_inlined_call_sites.clear();
+}
+
 void
 Module::SetFileSpecAndObjectName (const FileSpec &file, const ConstString &object_name)
 {
@@ -987,6 +1476,8 @@ Module::FindFirstSymbolWithNameAndType (const ConstString &name, SymbolType symb
                        "Module::FindFirstSymbolWithNameAndType (name = %s, type = %i)",
                        name.AsCString(),
                        symbol_type);
+    if (!MayContainName (name, false))
+        return NULL;
     ObjectFile *objfile = GetObjectFile();
     if (objfile)
     {
@@ -1028,6 +1519,8 @@ Module::FindSymbolsWithNameAndType (const ConstString &name, SymbolType symbol_t
                        name.AsCString(),
                        symbol_type);
     const size_t initial_size = sc_list.GetSize();
+    if (!MayContainName (name, false))
+        return 0;
     ObjectFile *objfile = GetObjectFile ();
     if (objfile)
     {
@@ -11,16 +11,22 @@
 
 // C Includes
 // C++ Includes
+#include <algorithm>
+
 // Other libraries and framework includes
 // Project includes
 #include "lldb/Core/Log.h"
 #include "lldb/Core/Module.h"
 #include "lldb/Core/ModuleSpec.h"
+#include "lldb/Core/RegularExpression.h"
 #include "lldb/Host/Host.h"
 #include "lldb/Host/Symbols.h"
+#include "lldb/Host/ThreadPool.h"
 #include "lldb/Symbol/ClangNamespaceDecl.h"
 #include "lldb/Symbol/ObjectFile.h"
+#include "lldb/Symbol/TypeList.h"
 #include "lldb/Symbol/VariableList.h"
+#include "lldb/Target/Target.h"
 
 using namespace lldb;
 using namespace lldb_private;
@@ -260,6 +266,124 @@ ModuleList::GetModuleAtIndexUnlocked(uint32_t idx)
     return module_sp;
 }
 
+void
+ModuleList::GetModulesSnapshot (collection &modules) const
+{
+    Mutex::Locker locker(m_modules_mutex);
+    modules = m_modules;
+}
+
+//----------------------------------------------------------------------
+// Searching a module for the first time can mean parsing and indexing
+// its symbol table and debug information, which is slow for large
+// modules. The searches below that have to visit every module farm the
+// modules out to worker threads. Each module is searched into its own
+// result list, and the lists are merged in module order afterwards so
+// the results are the same as for a serial search.
+//----------------------------------------------------------------------
+
+// Don't bother spinning up threads for fewer modules than this.
+#define MODULE_LIST_MIN_MODULES_FOR_PARALLEL_SEARCH 4
+
+class ModuleListSearch
+{
+public:
+    virtual
+    ~ModuleListSearch ()
+    {
+    }
+
+    virtual void
+    SearchModule (size_t module_idx, Module *module) = 0;
+};
+
+struct ModuleListSearchTask
+{
+    ModuleListSearch *search;
+    size_t module_idx;
+    Module *module;
+};
+
+static void
+RunModuleListSearchTask (void *baton)
+{
+    ModuleListSearchTask *task = (ModuleListSearchTask *)baton;
+    task->search->SearchModule (task->module_idx, task->module);
+}
+
+static void
+SearchModules (const std::vector<ModuleSP> &modules, ModuleListSearch &search)
+{
+    const size_t num_modules = modules.size();
+    if (num_modules < MODULE_LIST_MIN_MODULES_FOR_PARALLEL_SEARCH || !Target::GetDefaultParallelModuleSearch())
+    {
+        for (size_t i=0; i<num_modules; ++i)
+            search.SearchModule (i, modules[i].get());
+        return;
+    }
+
+    // Modules take very different amounts of time to search, so each one
+    // is its own task and idle workers pick up the next one
+    std::vector<ModuleListSearchTask> tasks (num_modules);
+    ThreadPool::TaskGroup task_group (ThreadPool::GetSharedThreadPool());
+    for (size_t i=0; i<num_modules; ++i)
+    {
+        tasks[i].search = &search;
+        tasks[i].module_idx = i;
+        tasks[i].module = modules[i].get();
+        task_group.AddTask (RunModuleListSearchTask, &tasks[i]);
+    }
+    task_group.Wait();
+}
+
+class FindFunctionsSearch : public ModuleListSearch
+{
+public:
+    FindFunctionsSearch (size_t num_modules,
+                         const ConstString &name,
+                         uint32_t name_type_mask,
+                         bool include_symbols,
+                         bool include_inlines) :
+        m_results (num_modules),
+        m_name (name),
+        m_name_type_mask (name_type_mask),
+        m_include_symbols (include_symbols),
+        m_include_inlines (include_inlines)
+    {
+    }
+
+    virtual void
+    SearchModule (size_t module_idx, Module *module)
+    {
+        module->FindFunctions (m_name, NULL, m_name_type_mask, m_include_symbols, m_include_inlines, true, m_results[module_idx]);
+    }
+
+    std::vector<SymbolContextList> m_results;
+    const ConstString &m_name;
+    const uint32_t m_name_type_mask;
+    const bool m_include_symbols;
+    const bool m_include_inlines;
+};
+
+class PreloadSymbolsSearch : public ModuleListSearch
+{
+public:
+    virtual void
+    SearchModule (size_t module_idx, Module *module)
+    {
+        module->PreloadSymbols ();
+    }
+};
+
+void
+ModuleList::PreloadSymbols ()
+{
+    collection modules;
+    GetModulesSnapshot (modules);
+    PreloadSymbolsSearch search;
+    SearchModules (modules, search);
+}
+
 uint32_t
 ModuleList::FindFunctions (const ConstString &name, 
                            uint32_t name_type_mask, 
@@ -271,12 +395,12 @@ ModuleList::FindFunctions (const ConstString &name,
     if (!append)
         sc_list.Clear();
     
-    Mutex::Locker locker(m_modules_mutex);
-    collection::const_iterator pos, end = m_modules.end();
-    for (pos = m_modules.begin(); pos != end; ++pos)
-    {
-        (*pos)->FindFunctions (name, NULL, name_type_mask, include_symbols, include_inlines, true, sc_list);
-    }
+    collection modules;
+    GetModulesSnapshot (modules);
+    FindFunctionsSearch search (modules.size(), name, name_type_mask, include_symbols, include_inlines);
+    SearchModules (modules, search);
+    for (size_t i=0; i<search.m_results.size(); ++i)
+        sc_list.Append (search.m_results[i]);
     
     return sc_list.GetSize();
 }
@@ -289,9 +413,10 @@ ModuleList::FindCompileUnits (const FileSpec &path,
     if (!append)
         sc_list.Clear();
     
-    Mutex::Locker locker(m_modules_mutex);
-    collection::const_iterator pos, end = m_modules.end();
-    for (pos = m_modules.begin(); pos != end; ++pos)
+    collection modules;
+    GetModulesSnapshot (modules);
+    collection::const_iterator pos, end = modules.end();
+    for (pos = modules.begin(); pos != end; ++pos)
     {
         (*pos)->FindCompileUnits (path, true, sc_list);
     }
@@ -299,6 +424,44 @@ ModuleList::FindCompileUnits (const FileSpec &path,
     return sc_list.GetSize();
 }
 
+class FindGlobalVariablesSearch : public ModuleListSearch
+{
+public:
+    FindGlobalVariablesSearch (size_t num_modules,
+                               const ConstString *name,
+                               const RegularExpression *regex,
+                               bool append,
+                               uint32_t max_matches) :
+        m_results (new VariableList[num_modules]),
+        m_name (name),
+        m_regex (regex),
+        m_append (append),
+        m_max_matches (max_matches)
+    {
+    }
+
+    virtual
+    ~FindGlobalVariablesSearch ()
+    {
+        delete [] m_results;
+    }
+
+    virtual void
+    SearchModule (size_t module_idx, Module *module)
+    {
+        if (m_name)
+            module->FindGlobalVariables (*m_name, NULL, m_append, m_max_matches, m_results[module_idx]);
+        else
+            module->FindGlobalVariables (*m_regex, m_append, m_max_matches, m_results[module_idx]);
+    }
+
+    VariableList *m_results;
+    const ConstString *m_name;
+    const RegularExpression *m_regex;
+    const bool m_append;
+    const uint32_t m_max_matches;
+};
+
 uint32_t
 ModuleList::FindGlobalVariables (const ConstString &name, 
                                  bool append, 
@@ -306,12 +469,12 @@ ModuleList::FindGlobalVariables (const ConstString &name,
                                  VariableList& variable_list)
 {
     size_t initial_size = variable_list.GetSize();
-    Mutex::Locker locker(m_modules_mutex);
-    collection::iterator pos, end = m_modules.end();
-    for (pos = m_modules.begin(); pos != end; ++pos)
-    {
-        (*pos)->FindGlobalVariables (name, NULL, append, max_matches, variable_list);
-    }
+    collection modules;
+    GetModulesSnapshot (modules);
+    FindGlobalVariablesSearch search (modules.size(), &name, NULL, append, max_matches);
+    SearchModules (modules, search);
+    for (size_t i=0; i<modules.size(); ++i)
+        variable_list.AddVariables (&search.m_results[i]);
     return variable_list.GetSize() - initial_size;
 }
 
@@ -323,12 +486,12 @@ ModuleList::FindGlobalVariables (const RegularExpression& regex,
                                  VariableList& variable_list)
 {
     size_t initial_size = variable_list.GetSize();
-    Mutex::Locker locker(m_modules_mutex);
-    collection::iterator pos, end = m_modules.end();
-    for (pos = m_modules.begin(); pos != end; ++pos)
-    {
-        (*pos)->FindGlobalVariables (regex, append, max_matches, variable_list);
-    }
+    collection modules;
+    GetModulesSnapshot (modules);
+    FindGlobalVariablesSearch search (modules.size(), NULL, &regex, append, max_matches);
+    SearchModules (modules, search);
+    for (size_t i=0; i<modules.size(); ++i)
+        variable_list.AddVariables (&search.m_results[i]);
     return variable_list.GetSize() - initial_size;
 }
 
@@ -339,13 +502,14 @@ ModuleList::FindSymbolsWithNameAndType (const ConstString &name,
                                         SymbolContextList &sc_list,
                                         bool append)
 {
-    Mutex::Locker locker(m_modules_mutex);
+    collection modules;
+    GetModulesSnapshot (modules);
     if (!append)
         sc_list.Clear();
     size_t initial_size = sc_list.GetSize();
     
-    collection::iterator pos, end = m_modules.end();
-    for (pos = m_modules.begin(); pos != end; ++pos)
+    collection::iterator pos, end = modules.end();
+    for (pos = modules.begin(); pos != end; ++pos)
         (*pos)->FindSymbolsWithNameAndType (name, symbol_type, sc_list);
     return sc_list.GetSize() - initial_size;
 }
@@ -356,13 +520,14 @@ ModuleList::FindSymbolsMatchingRegExAndType (const RegularExpression &regex,
                                              SymbolContextList &sc_list,
                                              bool append)
 {
-    Mutex::Locker locker(m_modules_mutex);
+    collection modules;
+    GetModulesSnapshot (modules);
     if (!append)
         sc_list.Clear();
     size_t initial_size = sc_list.GetSize();
     
-    collection::iterator pos, end = m_modules.end();
-    for (pos = m_modules.begin(); pos != end; ++pos)
+    collection::iterator pos, end = modules.end();
+    for (pos = modules.begin(); pos != end; ++pos)
         (*pos)->FindSymbolsMatchingRegExAndType (regex, symbol_type, sc_list);
     return sc_list.GetSize() - initial_size;
 }
@@ -429,18 +594,58 @@ ModuleList::FindModule (const UUID &uuid)
 }
 
 
+class FindTypesSearch : public ModuleListSearch
+{
+public:
+    FindTypesSearch (size_t num_modules,
+                     const SymbolContext &sc,
+                     const ConstString &name,
+                     bool name_is_fully_qualified,
+                     uint32_t max_matches) :
+        m_results (new TypeList[num_modules]),
+        m_num_matches (num_modules, 0),
+        m_sc (sc),
+        m_name (name),
+        m_name_is_fully_qualified (name_is_fully_qualified),
+        m_max_matches (max_matches)
+    {
+    }
+
+    virtual
+    ~FindTypesSearch ()
+    {
+        delete [] m_results;
+    }
+
+    virtual void
+    SearchModule (size_t module_idx, Module *module)
+    {
+        // The module in the symbol context has already been searched
+        if (module != m_sc.module_sp.get())
+            m_num_matches[module_idx] = module->FindTypes (m_sc, m_name, m_name_is_fully_qualified, m_max_matches, m_results[module_idx]);
+    }
+
+    TypeList *m_results;
+    std::vector<uint32_t> m_num_matches;
+    const SymbolContext &m_sc;
+    const ConstString &m_name;
+    const bool m_name_is_fully_qualified;
+    const uint32_t m_max_matches;
+};
+
 uint32_t
 ModuleList::FindTypes (const SymbolContext& sc, const ConstString &name, bool name_is_fully_qualified, uint32_t max_matches, TypeList& types)
 {
-    Mutex::Locker locker(m_modules_mutex);
+    collection modules;
+    GetModulesSnapshot (modules);
 
     uint32_t total_matches = 0;
-    collection::const_iterator pos, end = m_modules.end();
+    collection::const_iterator pos, end = modules.end();
     if (sc.module_sp)
     {
         // The symbol context "sc" contains a module so we want to search that
         // one first if it is in our list...
-        for (pos = m_modules.begin(); pos != end; ++pos)
+        for (pos = modules.begin(); pos != end; ++pos)
         {
             if (sc.module_sp.get() == (*pos).get())
             {
@@ -452,9 +657,11 @@ ModuleList::FindTypes (const SymbolContext& sc, const ConstString &name, bool na
         }
     }
     
-    if (total_matches < max_matches)
+    if (total_matches < max_matches && max_matches != UINT32_MAX)
     {
-        for (pos = m_modules.begin(); pos != end; ++pos)
+        // A search that is limited to a few matches will usually stop after
+        // a few modules, so search the modules one at a time.
+        for (pos = modules.begin(); pos != end; ++pos)
         {
             // Search the module if the module is not equal to the one in the symbol
             // context "sc". If "sc" contains a empty module shared pointer, then
@@ -466,6 +673,21 @@ ModuleList::FindTypes (const SymbolContext& sc, const ConstString &name, bool na
                 break;
         }
     }
+    else if (total_matches < max_matches)
+    {
+        // Every module has to be searched, so search them all at once and
+        // add their types in module order.
+        FindTypesSearch search (modules.size(), sc, name, name_is_fully_qualified, max_matches);
+        SearchModules (modules, search);
+        for (size_t i=0; i<modules.size(); ++i)
+        {
+            TypeList &module_types = search.m_results[i];
+            const uint32_t num_module_types = module_types.GetSize();
+            for (uint32_t type_idx = 0; type_idx < num_module_types; ++type_idx)
+                types.Insert (module_types.GetTypeAtIndex (type_idx));
+            total_matches += search.m_num_matches[i];
+        }
+    }
     
     return total_matches;
 }
@@ -473,9 +695,10 @@ ModuleList::FindTypes (const SymbolContext& sc, const ConstString &name, bool na
 bool
 ModuleList::FindSourceFile (const FileSpec &orig_spec, FileSpec &new_spec) const
 {
-    Mutex::Locker locker(m_modules_mutex);
-    collection::const_iterator pos, end = m_modules.end();
-    for (pos = m_modules.begin(); pos != end; ++pos)
+    collection modules;
+    GetModulesSnapshot (modules);
+    collection::const_iterator pos, end = modules.end();
+    for (pos = modules.begin(); pos != end; ++pos)
     {
         if ((*pos)->FindSourceFile (orig_spec, new_spec))
             return true;
@@ -555,9 +778,10 @@ ModuleList::LogUUIDAndPaths (LogSP &log_sp, const char *prefix_cstr)
 bool
 ModuleList::ResolveFileAddress (lldb::addr_t vm_addr, Address& so_addr)
 {
-    Mutex::Locker locker(m_modules_mutex);
-    collection::const_iterator pos, end = m_modules.end();
-    for (pos = m_modules.begin(); pos != end; ++pos)
+    collection modules;
+    GetModulesSnapshot (modules);
+    collection::const_iterator pos, end = modules.end();
+    for (pos = modules.begin(); pos != end; ++pos)
     {
         if ((*pos)->ResolveFileAddress (vm_addr, so_addr))
             return true;
@@ -580,9 +804,10 @@ ModuleList::ResolveSymbolContextForAddress (const Address& so_addr, uint32_t res
     }
     else
     {
-        Mutex::Locker locker(m_modules_mutex);
-        collection::const_iterator pos, end = m_modules.end();
-        for (pos = m_modules.begin(); pos != end; ++pos)
+        collection modules;
+        GetModulesSnapshot (modules);
+        collection::const_iterator pos, end = modules.end();
+        for (pos = modules.begin(); pos != end; ++pos)
         {
             resolved_flags = (*pos)->ResolveSymbolContextForAddress (so_addr,
                                                                      resolve_scope,
@@ -612,9 +837,10 @@ ModuleList::ResolveSymbolContextForFilePath
 uint32_t
 ModuleList::ResolveSymbolContextsForFileSpec (const FileSpec &file_spec, uint32_t line, bool check_inlines, uint32_t resolve_scope, SymbolContextList& sc_list)
 {
-    Mutex::Locker locker(m_modules_mutex);
-    collection::const_iterator pos, end = m_modules.end();
-    for (pos = m_modules.begin(); pos != end; ++pos)
+    collection modules;
+    GetModulesSnapshot (modules);
+    collection::const_iterator pos, end = modules.end();
+    for (pos = modules.begin(); pos != end; ++pos)
     {
         (*pos)->ResolveSymbolContextsForFileSpec (file_spec, line, check_inlines, resolve_scope, sc_list);
     }
@@ -647,6 +873,50 @@ GetSharedModuleList ()
     return g_shared_module_list;
 }
 
+//----------------------------------------------------------------------
+// Remember when a module was last handed out of the shared module list
+// so TrimSharedModuleCache() can free the least recently used ones.
+//----------------------------------------------------------------------
+static void
+StampSharedModule (const ModuleSP &module_sp)
+{
+    static uint32_t g_shared_module_stamp = 0;
+    Mutex::Locker locker (GetSharedModuleList ().GetMutex());
+    module_sp->SetSharedModuleStamp (++g_shared_module_stamp);
+}
+
+//----------------------------------------------------------------------
+// GetSharedModule() used to hold the shared module list mutex while it
+// located, mapped and parsed the object file for a module it had to
+// create, which serialized every target that was loading modules.
+// Creating a module now only locks one of these mutexes, picked by the
+// file name being looked up, so two targets loading different files
+// proceed in parallel while two that want the same file still wait for
+// each other and end up sharing one module. The shared module list
+// mutex itself is only held for the list operations.
+//----------------------------------------------------------------------
+enum { kNumSharedModuleCreationMutexes = 64 };
+
+struct SharedModuleCreationMutex
+{
+    SharedModuleCreationMutex () :
+        m_mutex (Mutex::eMutexTypeRecursive)
+    {
+    }
+
+    Mutex m_mutex;
+};
+
+static Mutex &
+GetSharedModuleCreationMutex (const ModuleSpec &module_spec)
+{
+    static SharedModuleCreationMutex g_creation_mutexes[kNumSharedModuleCreationMutexes];
+    // ConstString pointers are unique per string, so hash the pointer.
+    uintptr_t h = (uintptr_t)module_spec.GetFileSpec().GetFilename().GetCString();
+    h ^= (h >> 4) ^ (h >> 12);
+    return g_creation_mutexes[h % kNumSharedModuleCreationMutexes].m_mutex;
+}
+
 bool
 ModuleList::ModuleIsInCache (const Module *module_ptr)
 {
@@ -682,7 +952,7 @@ ModuleList::GetSharedModule
 )
 {
     ModuleList &shared_module_list = GetSharedModuleList ();
-    Mutex::Locker locker(shared_module_list.m_modules_mutex);
+    Mutex::Locker creation_locker(GetSharedModuleCreationMutex (module_spec));
     char path[PATH_MAX];
     char uuid_cstr[64];
 
@@ -699,9 +969,8 @@ ModuleList::GetSharedModule
     const FileSpec &module_file_spec = module_spec.GetFileSpec();
     const ArchSpec &arch = module_spec.GetArchitecture();
 
-    // Make sure no one else can try and get or create a module while this
-    // function is actively working on it by doing an extra lock on the
-    // global mutex list.
+    // The creation mutex we hold keeps anyone else looking up this file
+    // name from creating a module while this function is working on it.
     if (always_create == false)
     {
         ModuleList matching_module_list;
@@ -724,6 +993,7 @@ ModuleList::GetSharedModule
                 {
                     // The module matches and the module was not modified from
                     // when it was last loaded.
+                    StampSharedModule (module_sp);
                     return error;
                 }
             }
@@ -752,6 +1022,7 @@ ModuleList::GetSharedModule
                         *did_create_ptr = true;
                     
                     shared_module_list.ReplaceEquivalent(module_sp);
+                    StampSharedModule (module_sp);
                     return error;
                 }
             }
@@ -803,9 +1074,8 @@ ModuleList::GetSharedModule
         }
 
 
-        // Make sure no one else can try and get or create a module while this
-        // function is actively working on it by doing an extra lock on the
-        // global mutex list.
+        // The creation mutex we hold keeps anyone else looking up this file
+        // name from creating a module while this function is working on it.
         ModuleSpec platform_module_spec(module_spec);
         platform_module_spec.GetFileSpec() = file_spec;
         platform_module_spec.GetPlatformFileSpec() = file_spec;
@@ -872,9 +1142,100 @@ ModuleList::GetSharedModule
         }
     }
 
+    if (module_sp)
+        StampSharedModule (module_sp);
     return error;
 }
 
+void
+ModuleList::AddSharedModule (const lldb::ModuleSP &module_sp)
+{
+    if (module_sp)
+    {
+        ModuleList &shared_module_list = GetSharedModuleList ();
+        Mutex::Locker locker(shared_module_list.m_modules_mutex);
+        shared_module_list.ReplaceEquivalent (module_sp);
+        StampSharedModule (module_sp);
+    }
+}
+
+struct OrphanedModule
+{
+    uint32_t stamp;
+    uint64_t byte_size;
+    const ModuleSP *module_sp;  // Points into the shared module list
+
+    bool
+    operator < (const OrphanedModule &rhs) const
+    {
+        return stamp < rhs.stamp;
+    }
+};
+
+size_t
+ModuleList::TrimSharedModuleCache (uint64_t max_byte_size)
+{
+    if (max_byte_size == 0)
+        return 0;
+
+    ModuleList &shared_module_list = GetSharedModuleList ();
+    Mutex::Locker locker;
+    // Trimming the cache is never urgent, so don't wait on a thread that
+    // is getting or creating a shared module.
+    if (!locker.TryLock (shared_module_list.m_modules_mutex))
+        return 0;
+
+    // Only the shared module list refers to an orphaned module, and since
+    // we hold its mutex nobody else can start using one while we free
+    // its parsed data.
+    std::vector<OrphanedModule> orphans;
+    uint64_t total_byte_size = 0;
+    collection::const_iterator pos, end = shared_module_list.m_modules.end();
+    for (pos = shared_module_list.m_modules.begin(); pos != end; ++pos)
+    {
+        if (pos->unique() && (*pos)->HasParsedData())
+        {
+            OrphanedModule orphan;
+            orphan.stamp = (*pos)->GetSharedModuleStamp();
+            orphan.byte_size = (*pos)->GetParsedDataByteSizeEstimate();
+            orphan.module_sp = &(*pos);
+            orphans.push_back (orphan);
+            total_byte_size += orphan.byte_size;
+        }
+    }
+
+    if (total_byte_size <= max_byte_size)
+        return 0;
+
+    // Free the least recently used modules first.
+    std::sort (orphans.begin(), orphans.end());
+
+    LogSP log(lldb_private::GetLogIfAnyCategoriesSet (LIBLLDB_LOG_OBJECT));
+    size_t num_cleared = 0;
+    for (size_t i=0; i<orphans.size() && total_byte_size > max_byte_size; ++i)
+    {
+        const ModuleSP &module_sp = *orphans[i].module_sp;
+        // Modules that are being loaded concurrently by other targets can
+        // get a new reference without going through the shared module
+        // list, by locking a weak pointer to the module. So check again
+        // that only the list refers to the module, while holding the
+        // module's mutex so whoever gets a new reference after this waits
+        // for us before touching the parsed data.
+        Mutex::Locker module_locker (module_sp->GetMutex());
+        if (!module_sp.unique())
+            continue;
+        if (log)
+            log->Printf ("ModuleList::TrimSharedModuleCache() clearing parsed data for '%s/%s' (%llu bytes)",
+                         module_sp->GetFileSpec().GetDirectory().AsCString(""),
+                         module_sp->GetFileSpec().GetFilename().AsCString(""),
+                         orphans[i].byte_size);
+        module_sp->ClearParsedData();
+        total_byte_size -= orphans[i].byte_size;
+        ++num_cleared;
+    }
+    return num_cleared;
+}
+
 bool
 ModuleList::RemoveSharedModule (lldb::ModuleSP &module_sp)
 {
@@ -0,0 +1,116 @@
+//===-- NameBloomFilter.cpp -------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "lldb/Core/NameBloomFilter.h"
+
+// C Includes
+// C++ Includes
+// Other libraries and framework includes
+// Project includes
+#include "lldb/Core/DataExtractor.h"
+#include "lldb/Core/MappedHash.h"
+#include "lldb/Core/Stream.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+// Ten bits per name and seven probes give about a one percent false
+// positive rate. Filters are saved in the index cache, so changing these
+// needs a new cache version in the clients.
+#define NAME_BLOOM_FILTER_BITS_PER_NAME 10
+#define NAME_BLOOM_FILTER_NUM_PROBES    7
+
+// A second hash that is independent of the DJB one, the probes are
+// spaced by it
+static uint32_t
+HashNameFNV (const char *name)
+{
+    uint32_t hash = 2166136261u;
+    for (const uint8_t *p = (const uint8_t *)name; *p; ++p)
+    {
+        hash ^= *p;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+NameBloomFilter::NameBloomFilter () :
+    m_words (),
+    m_num_bits (0)
+{
+}
+
+void
+NameBloomFilter::Reset (uint32_t num_names)
+{
+    const uint32_t num_words = (std::max<uint32_t> (num_names, 1) * NAME_BLOOM_FILTER_BITS_PER_NAME + 31) / 32;
+    m_words.assign (num_words, 0);
+    m_num_bits = num_words * 32;
+}
+
+void
+NameBloomFilter::Clear ()
+{
+    m_words.clear();
+    m_num_bits = 0;
+}
+
+void
+NameBloomFilter::Insert (const char *name)
+{
+    if (m_num_bits == 0 || name == NULL)
+        return;
+    uint32_t hash = MappedHash::HashStringUsingDJB (name);
+    const uint32_t step = HashNameFNV (name) | 1;
+    for (uint32_t i=0; i<NAME_BLOOM_FILTER_NUM_PROBES; ++i, hash += step)
+    {
+        const uint32_t bit = hash % m_num_bits;
+        m_words[bit / 32] |= 1u << (bit % 32);
+    }
+}
+
+bool
+NameBloomFilter::MayContain (const char *name) const
+{
+    if (m_num_bits == 0 || name == NULL)
+        return false;
+    uint32_t hash = MappedHash::HashStringUsingDJB (name);
+    const uint32_t step = HashNameFNV (name) | 1;
+    for (uint32_t i=0; i<NAME_BLOOM_FILTER_NUM_PROBES; ++i, hash += step)
+    {
+        const uint32_t bit = hash % m_num_bits;
+        if ((m_words[bit / 32] & (1u << (bit % 32))) == 0)
+            return false;
+    }
+    return true;
+}
+
+void
+NameBloomFilter::Encode (Stream &strm) const
+{
+    strm.PutHex32 (m_words.size());
+    if (!m_words.empty())
+        strm.Write (&m_words[0], m_words.size() * sizeof(uint32_t));
+}
+
+bool
+NameBloomFilter::Decode (const DataExtractor &data, uint32_t *offset_ptr)
+{
+    Clear();
+    if (!data.ValidOffsetForDataOfSize (*offset_ptr, 4))
+        return false;
+    const uint32_t num_words = data.GetU32 (offset_ptr);
+    if (!data.ValidOffsetForDataOfSize (*offset_ptr, num_words * sizeof(uint32_t)))
+        return false;
+    m_words.resize (num_words);
+    for (uint32_t i=0; i<num_words; ++i)
+        m_words[i] = data.GetU32 (offset_ptr);
+    m_num_bits = num_words * 32;
+    return true;
+}
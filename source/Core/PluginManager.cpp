@@ -18,6 +18,7 @@
 #include "lldb/Host/FileSpec.h"
 #include "lldb/Host/Host.h"
 #include "lldb/Host/Mutex.h"
+#include "lldb/Host/ReadWriteLock.h"
 
 #include "llvm/ADT/StringRef.h"
 
@@ -232,11 +233,11 @@ struct ABIInstance
 
 typedef std::vector<ABIInstance> ABIInstances;
 
-static Mutex &
-GetABIInstancesMutex ()
+static ReadWriteLock &
+GetABIInstancesLock ()
 {
-    static Mutex g_instances_mutex (Mutex::eMutexTypeRecursive);
-    return g_instances_mutex;
+    static ReadWriteLock g_instances_lock;
+    return g_instances_lock;
 }
 
 static ABIInstances &
@@ -262,7 +263,7 @@ PluginManager::RegisterPlugin
         if (description && description[0])
             instance.description = description;
         instance.create_callback = create_callback;
-        Mutex::Locker locker (GetABIInstancesMutex ());
+        ReadWriteLock::WriteLocker locker (GetABIInstancesLock ());
         GetABIInstances ().push_back (instance);
         return true;
     }
@@ -274,7 +275,7 @@ PluginManager::UnregisterPlugin (ABICreateInstance create_callback)
 {
     if (create_callback)
     {
-        Mutex::Locker locker (GetABIInstancesMutex ());
+        ReadWriteLock::WriteLocker locker (GetABIInstancesLock ());
         ABIInstances &instances = GetABIInstances ();
 
         ABIInstances::iterator pos, end = instances.end();
@@ -293,7 +294,7 @@ PluginManager::UnregisterPlugin (ABICreateInstance create_callback)
 ABICreateInstance
 PluginManager::GetABICreateCallbackAtIndex (uint32_t idx)
 {
-    Mutex::Locker locker (GetABIInstancesMutex ());
+    ReadWriteLock::ReadLocker locker (GetABIInstancesLock ());
     ABIInstances &instances = GetABIInstances ();
     if (idx < instances.size())
         return instances[idx].create_callback;
@@ -305,7 +306,7 @@ PluginManager::GetABICreateCallbackForPluginName (const char *name)
 {
     if (name && name[0])
     {
-        Mutex::Locker locker (GetABIInstancesMutex ());
+        ReadWriteLock::ReadLocker locker (GetABIInstancesLock ());
         llvm::StringRef name_sref(name);
         ABIInstances &instances = GetABIInstances ();
 
@@ -339,11 +340,11 @@ struct DisassemblerInstance
 
 typedef std::vector<DisassemblerInstance> DisassemblerInstances;
 
-static Mutex &
-GetDisassemblerMutex ()
+static ReadWriteLock &
+GetDisassemblerLock ()
 {
-    static Mutex g_instances_mutex (Mutex::eMutexTypeRecursive);
-    return g_instances_mutex;
+    static ReadWriteLock g_instances_lock;
+    return g_instances_lock;
 }
 
 static DisassemblerInstances &
@@ -369,7 +370,7 @@ PluginManager::RegisterPlugin
         if (description && description[0])
             instance.description = description;
         instance.create_callback = create_callback;
-        Mutex::Locker locker (GetDisassemblerMutex ());
+        ReadWriteLock::WriteLocker locker (GetDisassemblerLock ());
         GetDisassemblerInstances ().push_back (instance);
         return true;
     }
@@ -381,7 +382,7 @@ PluginManager::UnregisterPlugin (DisassemblerCreateInstance create_callback)
 {
     if (create_callback)
     {
-        Mutex::Locker locker (GetDisassemblerMutex ());
+        ReadWriteLock::WriteLocker locker (GetDisassemblerLock ());
         DisassemblerInstances &instances = GetDisassemblerInstances ();
         
         DisassemblerInstances::iterator pos, end = instances.end();
@@ -400,7 +401,7 @@ PluginManager::UnregisterPlugin (DisassemblerCreateInstance create_callback)
 DisassemblerCreateInstance
 PluginManager::GetDisassemblerCreateCallbackAtIndex (uint32_t idx)
 {
-    Mutex::Locker locker (GetDisassemblerMutex ());
+    ReadWriteLock::ReadLocker locker (GetDisassemblerLock ());
     DisassemblerInstances &instances = GetDisassemblerInstances ();
     if (idx < instances.size())
         return instances[idx].create_callback;
@@ -413,7 +414,7 @@ PluginManager::GetDisassemblerCreateCallbackForPluginName (const char *name)
     if (name && name[0])
     {
         llvm::StringRef name_sref(name);
-        Mutex::Locker locker (GetDisassemblerMutex ());
+        ReadWriteLock::ReadLocker locker (GetDisassemblerLock ());
         DisassemblerInstances &instances = GetDisassemblerInstances ();
         
         DisassemblerInstances::iterator pos, end = instances.end();
@@ -448,11 +449,11 @@ struct DynamicLoaderInstance
 typedef std::vector<DynamicLoaderInstance> DynamicLoaderInstances;
 
 
-static Mutex &
-GetDynamicLoaderMutex ()
+static ReadWriteLock &
+GetDynamicLoaderLock ()
 {
-    static Mutex g_instances_mutex (Mutex::eMutexTypeRecursive);
-    return g_instances_mutex;
+    static ReadWriteLock g_instances_lock;
+    return g_instances_lock;
 }
 
 static DynamicLoaderInstances &
@@ -479,7 +480,7 @@ PluginManager::RegisterPlugin
         if (description && description[0])
             instance.description = description;
         instance.create_callback = create_callback;
-        Mutex::Locker locker (GetDynamicLoaderMutex ());
+        ReadWriteLock::WriteLocker locker (GetDynamicLoaderLock ());
         GetDynamicLoaderInstances ().push_back (instance);
     }
     return false;
@@ -490,7 +491,7 @@ PluginManager::UnregisterPlugin (DynamicLoaderCreateInstance create_callback)
 {
     if (create_callback)
     {
-        Mutex::Locker locker (GetDynamicLoaderMutex ());
+        ReadWriteLock::WriteLocker locker (GetDynamicLoaderLock ());
         DynamicLoaderInstances &instances = GetDynamicLoaderInstances ();
         
         DynamicLoaderInstances::iterator pos, end = instances.end();
@@ -509,7 +510,7 @@ PluginManager::UnregisterPlugin (DynamicLoaderCreateInstance create_callback)
 DynamicLoaderCreateInstance
 PluginManager::GetDynamicLoaderCreateCallbackAtIndex (uint32_t idx)
 {
-    Mutex::Locker locker (GetDynamicLoaderMutex ());
+    ReadWriteLock::ReadLocker locker (GetDynamicLoaderLock ());
     DynamicLoaderInstances &instances = GetDynamicLoaderInstances ();
     if (idx < instances.size())
         return instances[idx].create_callback;
@@ -522,7 +523,7 @@ PluginManager::GetDynamicLoaderCreateCallbackForPluginName (const char *name)
     if (name && name[0])
     {
         llvm::StringRef name_sref(name);
-        Mutex::Locker locker (GetDynamicLoaderMutex ());
+        ReadWriteLock::ReadLocker locker (GetDynamicLoaderLock ());
         DynamicLoaderInstances &instances = GetDynamicLoaderInstances ();
         
         DynamicLoaderInstances::iterator pos, end = instances.end();
@@ -554,11 +555,11 @@ struct EmulateInstructionInstance
 
 typedef std::vector<EmulateInstructionInstance> EmulateInstructionInstances;
 
-static Mutex &
-GetEmulateInstructionMutex ()
+static ReadWriteLock &
+GetEmulateInstructionLock ()
 {
-    static Mutex g_instances_mutex (Mutex::eMutexTypeRecursive);
-    return g_instances_mutex;
+    static ReadWriteLock g_instances_lock;
+    return g_instances_lock;
 }
 
 static EmulateInstructionInstances &
@@ -585,7 +586,7 @@ PluginManager::RegisterPlugin
         if (description && description[0])
             instance.description = description;
         instance.create_callback = create_callback;
-        Mutex::Locker locker (GetEmulateInstructionMutex ());
+        ReadWriteLock::WriteLocker locker (GetEmulateInstructionLock ());
         GetEmulateInstructionInstances ().push_back (instance);
     }
     return false;
@@ -596,7 +597,7 @@ PluginManager::UnregisterPlugin (EmulateInstructionCreateInstance create_callbac
 {
     if (create_callback)
     {
-        Mutex::Locker locker (GetEmulateInstructionMutex ());
+        ReadWriteLock::WriteLocker locker (GetEmulateInstructionLock ());
         EmulateInstructionInstances &instances = GetEmulateInstructionInstances ();
         
         EmulateInstructionInstances::iterator pos, end = instances.end();
@@ -615,7 +616,7 @@ PluginManager::UnregisterPlugin (EmulateInstructionCreateInstance create_callbac
 EmulateInstructionCreateInstance
 PluginManager::GetEmulateInstructionCreateCallbackAtIndex (uint32_t idx)
 {
-    Mutex::Locker locker (GetEmulateInstructionMutex ());
+    ReadWriteLock::ReadLocker locker (GetEmulateInstructionLock ());
     EmulateInstructionInstances &instances = GetEmulateInstructionInstances ();
     if (idx < instances.size())
         return instances[idx].create_callback;
@@ -628,7 +629,7 @@ PluginManager::GetEmulateInstructionCreateCallbackForPluginName (const char *nam
     if (name && name[0])
     {
         llvm::StringRef name_sref(name);
-        Mutex::Locker locker (GetEmulateInstructionMutex ());
+        ReadWriteLock::ReadLocker locker (GetEmulateInstructionLock ());
         EmulateInstructionInstances &instances = GetEmulateInstructionInstances ();
         
         EmulateInstructionInstances::iterator pos, end = instances.end();
@@ -659,11 +660,11 @@ struct OperatingSystemInstance
 
 typedef std::vector<OperatingSystemInstance> OperatingSystemInstances;
 
-static Mutex &
-GetOperatingSystemMutex ()
+static ReadWriteLock &
+GetOperatingSystemLock ()
 {
-    static Mutex g_instances_mutex (Mutex::eMutexTypeRecursive);
-    return g_instances_mutex;
+    static ReadWriteLock g_instances_lock;
+    return g_instances_lock;
 }
 
 static OperatingSystemInstances &
@@ -689,7 +690,7 @@ PluginManager::RegisterPlugin
         if (description && description[0])
             instance.description = description;
         instance.create_callback = create_callback;
-        Mutex::Locker locker (GetOperatingSystemMutex ());
+        ReadWriteLock::WriteLocker locker (GetOperatingSystemLock ());
         GetOperatingSystemInstances ().push_back (instance);
     }
     return false;
@@ -700,7 +701,7 @@ PluginManager::UnregisterPlugin (OperatingSystemCreateInstance create_callback)
 {
     if (create_callback)
     {
-        Mutex::Locker locker (GetOperatingSystemMutex ());
+        ReadWriteLock::WriteLocker locker (GetOperatingSystemLock ());
         OperatingSystemInstances &instances = GetOperatingSystemInstances ();
         
         OperatingSystemInstances::iterator pos, end = instances.end();
@@ -719,7 +720,7 @@ PluginManager::UnregisterPlugin (OperatingSystemCreateInstance create_callback)
 OperatingSystemCreateInstance
 PluginManager::GetOperatingSystemCreateCallbackAtIndex (uint32_t idx)
 {
-    Mutex::Locker locker (GetOperatingSystemMutex ());
+    ReadWriteLock::ReadLocker locker (GetOperatingSystemLock ());
     OperatingSystemInstances &instances = GetOperatingSystemInstances ();
     if (idx < instances.size())
         return instances[idx].create_callback;
@@ -732,7 +733,7 @@ PluginManager::GetOperatingSystemCreateCallbackForPluginName (const char *name)
     if (name && name[0])
     {
         llvm::StringRef name_sref(name);
-        Mutex::Locker locker (GetOperatingSystemMutex ());
+        ReadWriteLock::ReadLocker locker (GetOperatingSystemLock ());
         OperatingSystemInstances &instances = GetOperatingSystemInstances ();
         
         OperatingSystemInstances::iterator pos, end = instances.end();
@@ -765,11 +766,11 @@ struct LanguageRuntimeInstance
 
 typedef std::vector<LanguageRuntimeInstance> LanguageRuntimeInstances;
 
-static Mutex &
-GetLanguageRuntimeMutex ()
+static ReadWriteLock &
+GetLanguageRuntimeLock ()
 {
-    static Mutex g_instances_mutex (Mutex::eMutexTypeRecursive);
-    return g_instances_mutex;
+    static ReadWriteLock g_instances_lock;
+    return g_instances_lock;
 }
 
 static LanguageRuntimeInstances &
@@ -795,7 +796,7 @@ PluginManager::RegisterPlugin
         if (description && description[0])
             instance.description = description;
         instance.create_callback = create_callback;
-        Mutex::Locker locker (GetLanguageRuntimeMutex ());
+        ReadWriteLock::WriteLocker locker (GetLanguageRuntimeLock ());
         GetLanguageRuntimeInstances ().push_back (instance);
     }
     return false;
@@ -806,7 +807,7 @@ PluginManager::UnregisterPlugin (LanguageRuntimeCreateInstance create_callback)
 {
     if (create_callback)
     {
-        Mutex::Locker locker (GetLanguageRuntimeMutex ());
+        ReadWriteLock::WriteLocker locker (GetLanguageRuntimeLock ());
         LanguageRuntimeInstances &instances = GetLanguageRuntimeInstances ();
         
         LanguageRuntimeInstances::iterator pos, end = instances.end();
@@ -825,7 +826,7 @@ PluginManager::UnregisterPlugin (LanguageRuntimeCreateInstance create_callback)
 LanguageRuntimeCreateInstance
 PluginManager::GetLanguageRuntimeCreateCallbackAtIndex (uint32_t idx)
 {
-    Mutex::Locker locker (GetLanguageRuntimeMutex ());
+    ReadWriteLock::ReadLocker locker (GetLanguageRuntimeLock ());
     LanguageRuntimeInstances &instances = GetLanguageRuntimeInstances ();
     if (idx < instances.size())
         return instances[idx].create_callback;
@@ -838,7 +839,7 @@ PluginManager::GetLanguageRuntimeCreateCallbackForPluginName (const char *name)
     if (name && name[0])
     {
         llvm::StringRef name_sref(name);
-        Mutex::Locker locker (GetLanguageRuntimeMutex ());
+        ReadWriteLock::ReadLocker locker (GetLanguageRuntimeLock ());
         LanguageRuntimeInstances &instances = GetLanguageRuntimeInstances ();
         
         LanguageRuntimeInstances::iterator pos, end = instances.end();
@@ -871,11 +872,11 @@ struct ObjectFileInstance
 
 typedef std::vector<ObjectFileInstance> ObjectFileInstances;
 
-static Mutex &
-GetObjectFileMutex ()
+static ReadWriteLock &
+GetObjectFileLock ()
 {
-    static Mutex g_instances_mutex (Mutex::eMutexTypeRecursive);
-    return g_instances_mutex;
+    static ReadWriteLock g_instances_lock;
+    return g_instances_lock;
 }
 
 static ObjectFileInstances &
@@ -904,7 +905,7 @@ PluginManager::RegisterPlugin
             instance.description = description;
         instance.create_callback = create_callback;
         instance.create_memory_callback = create_memory_callback;
-        Mutex::Locker locker (GetObjectFileMutex ());
+        ReadWriteLock::WriteLocker locker (GetObjectFileLock ());
         GetObjectFileInstances ().push_back (instance);
     }
     return false;
@@ -915,7 +916,7 @@ PluginManager::UnregisterPlugin (ObjectFileCreateInstance create_callback)
 {
     if (create_callback)
     {
-        Mutex::Locker locker (GetObjectFileMutex ());
+        ReadWriteLock::WriteLocker locker (GetObjectFileLock ());
         ObjectFileInstances &instances = GetObjectFileInstances ();
         
         ObjectFileInstances::iterator pos, end = instances.end();
@@ -934,7 +935,7 @@ PluginManager::UnregisterPlugin (ObjectFileCreateInstance create_callback)
 ObjectFileCreateInstance
 PluginManager::GetObjectFileCreateCallbackAtIndex (uint32_t idx)
 {
-    Mutex::Locker locker (GetObjectFileMutex ());
+    ReadWriteLock::ReadLocker locker (GetObjectFileLock ());
     ObjectFileInstances &instances = GetObjectFileInstances ();
     if (idx < instances.size())
         return instances[idx].create_callback;
@@ -945,7 +946,7 @@ PluginManager::GetObjectFileCreateCallbackAtIndex (uint32_t idx)
 ObjectFileCreateMemoryInstance
 PluginManager::GetObjectFileCreateMemoryCallbackAtIndex (uint32_t idx)
 {
-    Mutex::Locker locker (GetObjectFileMutex ());
+    ReadWriteLock::ReadLocker locker (GetObjectFileLock ());
     ObjectFileInstances &instances = GetObjectFileInstances ();
     if (idx < instances.size())
         return instances[idx].create_memory_callback;
@@ -958,7 +959,7 @@ PluginManager::GetObjectFileCreateCallbackForPluginName (const char *name)
     if (name && name[0])
     {
         llvm::StringRef name_sref(name);
-        Mutex::Locker locker (GetObjectFileMutex ());
+        ReadWriteLock::ReadLocker locker (GetObjectFileLock ());
         ObjectFileInstances &instances = GetObjectFileInstances ();
         
         ObjectFileInstances::iterator pos, end = instances.end();
@@ -978,7 +979,7 @@ PluginManager::GetObjectFileCreateMemoryCallbackForPluginName (const char *name)
     if (name && name[0])
     {
         llvm::StringRef name_sref(name);
-        Mutex::Locker locker (GetObjectFileMutex ());
+        ReadWriteLock::ReadLocker locker (GetObjectFileLock ());
         ObjectFileInstances &instances = GetObjectFileInstances ();
         
         ObjectFileInstances::iterator pos, end = instances.end();
@@ -1011,11 +1012,11 @@ struct ObjectContainerInstance
 
 typedef std::vector<ObjectContainerInstance> ObjectContainerInstances;
 
-static Mutex &
-GetObjectContainerMutex ()
+static ReadWriteLock &
+GetObjectContainerLock ()
 {
-    static Mutex g_instances_mutex (Mutex::eMutexTypeRecursive);
-    return g_instances_mutex;
+    static ReadWriteLock g_instances_lock;
+    return g_instances_lock;
 }
 
 static ObjectContainerInstances &
@@ -1041,7 +1042,7 @@ PluginManager::RegisterPlugin
         if (description && description[0])
             instance.description = description;
         instance.create_callback = create_callback;
-        Mutex::Locker locker (GetObjectContainerMutex ());
+        ReadWriteLock::WriteLocker locker (GetObjectContainerLock ());
         GetObjectContainerInstances ().push_back (instance);
     }
     return false;
@@ -1052,7 +1053,7 @@ PluginManager::UnregisterPlugin (ObjectContainerCreateInstance create_callback)
 {
     if (create_callback)
     {
-        Mutex::Locker locker (GetObjectContainerMutex ());
+        ReadWriteLock::WriteLocker locker (GetObjectContainerLock ());
         ObjectContainerInstances &instances = GetObjectContainerInstances ();
         
         ObjectContainerInstances::iterator pos, end = instances.end();
@@ -1071,7 +1072,7 @@ PluginManager::UnregisterPlugin (ObjectContainerCreateInstance create_callback)
 ObjectContainerCreateInstance
 PluginManager::GetObjectContainerCreateCallbackAtIndex (uint32_t idx)
 {
-    Mutex::Locker locker (GetObjectContainerMutex ());
+    ReadWriteLock::ReadLocker locker (GetObjectContainerLock ());
     ObjectContainerInstances &instances = GetObjectContainerInstances ();
     if (idx < instances.size())
         return instances[idx].create_callback;
@@ -1084,7 +1085,7 @@ PluginManager::GetObjectContainerCreateCallbackForPluginName (const char *name)
     if (name && name[0])
     {
         llvm::StringRef name_sref(name);
-        Mutex::Locker locker (GetObjectContainerMutex ());
+        ReadWriteLock::ReadLocker locker (GetObjectContainerLock ());
         ObjectContainerInstances &instances = GetObjectContainerInstances ();
         
         ObjectContainerInstances::iterator pos, end = instances.end();
@@ -1115,11 +1116,11 @@ struct LogInstance
 
 typedef std::vector<LogInstance> LogInstances;
 
-static Mutex &
-GetLogMutex ()
+static ReadWriteLock &
+GetLogLock ()
 {
-    static Mutex g_instances_mutex (Mutex::eMutexTypeRecursive);
-    return g_instances_mutex;
+    static ReadWriteLock g_instances_lock;
+    return g_instances_lock;
 }
 
 static LogInstances &
@@ -1147,7 +1148,7 @@ PluginManager::RegisterPlugin
         if (description && description[0])
             instance.description = description;
         instance.create_callback = create_callback;
-        Mutex::Locker locker (GetLogMutex ());
+        ReadWriteLock::WriteLocker locker (GetLogLock ());
         GetLogInstances ().push_back (instance);
     }
     return false;
@@ -1158,7 +1159,7 @@ PluginManager::UnregisterPlugin (LogChannelCreateInstance create_callback)
 {
     if (create_callback)
     {
-        Mutex::Locker locker (GetLogMutex ());
+        ReadWriteLock::WriteLocker locker (GetLogLock ());
         LogInstances &instances = GetLogInstances ();
         
         LogInstances::iterator pos, end = instances.end();
@@ -1177,7 +1178,7 @@ PluginManager::UnregisterPlugin (LogChannelCreateInstance create_callback)
 const char *
 PluginManager::GetLogChannelCreateNameAtIndex (uint32_t idx)
 {
-    Mutex::Locker locker (GetLogMutex ());
+    ReadWriteLock::ReadLocker locker (GetLogLock ());
     LogInstances &instances = GetLogInstances ();
     if (idx < instances.size())
         return instances[idx].name.c_str();
@@ -1188,7 +1189,7 @@ PluginManager::GetLogChannelCreateNameAtIndex (uint32_t idx)
 LogChannelCreateInstance
 PluginManager::GetLogChannelCreateCallbackAtIndex (uint32_t idx)
 {
-    Mutex::Locker locker (GetLogMutex ());
+    ReadWriteLock::ReadLocker locker (GetLogLock ());
     LogInstances &instances = GetLogInstances ();
     if (idx < instances.size())
         return instances[idx].create_callback;
@@ -1201,7 +1202,7 @@ PluginManager::GetLogChannelCreateCallbackForPluginName (const char *name)
     if (name && name[0])
     {
         llvm::StringRef name_sref(name);
-        Mutex::Locker locker (GetLogMutex ());
+        ReadWriteLock::ReadLocker locker (GetLogLock ());
         LogInstances &instances = GetLogInstances ();
         
         LogInstances::iterator pos, end = instances.end();
@@ -1232,11 +1233,11 @@ struct PlatformInstance
 
 typedef std::vector<PlatformInstance> PlatformInstances;
 
-static Mutex &
-GetPlatformInstancesMutex ()
+static ReadWriteLock &
+GetPlatformInstancesLock ()
 {
-    static Mutex g_platform_instances_mutex (Mutex::eMutexTypeRecursive);
-    return g_platform_instances_mutex;
+    static ReadWriteLock g_platform_instances_lock;
+    return g_platform_instances_lock;
 }
 
 static PlatformInstances &
@@ -1254,7 +1255,7 @@ PluginManager::RegisterPlugin (const char *name,
 {
     if (create_callback)
     {
-        Mutex::Locker locker (GetPlatformInstancesMutex ());
+        ReadWriteLock::WriteLocker locker (GetPlatformInstancesLock ());
         
         PlatformInstance instance;
         assert (name && name[0]);
@@ -1271,7 +1272,7 @@ PluginManager::RegisterPlugin (const char *name,
 const char *
 PluginManager::GetPlatformPluginNameAtIndex (uint32_t idx)
 {
-    Mutex::Locker locker (GetPlatformInstancesMutex ());
+    ReadWriteLock::ReadLocker locker (GetPlatformInstancesLock ());
     PlatformInstances &instances = GetPlatformInstances ();
     if (idx < instances.size())
         return instances[idx].name.c_str();
@@ -1281,7 +1282,7 @@ PluginManager::GetPlatformPluginNameAtIndex (uint32_t idx)
 const char *
 PluginManager::GetPlatformPluginDescriptionAtIndex (uint32_t idx)
 {
-    Mutex::Locker locker (GetPlatformInstancesMutex ());
+    ReadWriteLock::ReadLocker locker (GetPlatformInstancesLock ());
     PlatformInstances &instances = GetPlatformInstances ();
     if (idx < instances.size())
         return instances[idx].description.c_str();
@@ -1293,7 +1294,7 @@ PluginManager::UnregisterPlugin (PlatformCreateInstance create_callback)
 {
     if (create_callback)
     {
-        Mutex::Locker locker (GetPlatformInstancesMutex ());
+        ReadWriteLock::WriteLocker locker (GetPlatformInstancesLock ());
         PlatformInstances &instances = GetPlatformInstances ();
 
         PlatformInstances::iterator pos, end = instances.end();
@@ -1312,7 +1313,7 @@ PluginManager::UnregisterPlugin (PlatformCreateInstance create_callback)
 PlatformCreateInstance
 PluginManager::GetPlatformCreateCallbackAtIndex (uint32_t idx)
 {
-    Mutex::Locker locker (GetPlatformInstancesMutex ());
+    ReadWriteLock::ReadLocker locker (GetPlatformInstancesLock ());
     PlatformInstances &instances = GetPlatformInstances ();
     if (idx < instances.size())
         return instances[idx].create_callback;
@@ -1324,7 +1325,7 @@ PluginManager::GetPlatformCreateCallbackForPluginName (const char *name)
 {
     if (name && name[0])
     {
-        Mutex::Locker locker (GetPlatformInstancesMutex ());
+        ReadWriteLock::ReadLocker locker (GetPlatformInstancesLock ());
         PlatformInstances &instances = GetPlatformInstances ();
         llvm::StringRef name_sref(name);
 
@@ -1343,7 +1344,7 @@ PluginManager::AutoCompletePlatformName (const char *name, StringList &matches)
 {
     if (name && name[0])
     {
-        Mutex::Locker locker (GetPlatformInstancesMutex ());
+        ReadWriteLock::ReadLocker locker (GetPlatformInstancesLock ());
         PlatformInstances &instances = GetPlatformInstances ();
         llvm::StringRef name_sref(name);
 
@@ -1376,11 +1377,11 @@ struct ProcessInstance
 
 typedef std::vector<ProcessInstance> ProcessInstances;
 
-static Mutex &
-GetProcessMutex ()
+static ReadWriteLock &
+GetProcessLock ()
 {
-    static Mutex g_instances_mutex (Mutex::eMutexTypeRecursive);
-    return g_instances_mutex;
+    static ReadWriteLock g_instances_lock;
+    return g_instances_lock;
 }
 
 static ProcessInstances &
@@ -1407,7 +1408,7 @@ PluginManager::RegisterPlugin
         if (description && description[0])
             instance.description = description;
         instance.create_callback = create_callback;
-        Mutex::Locker locker (GetProcessMutex ());
+        ReadWriteLock::WriteLocker locker (GetProcessLock ());
         GetProcessInstances ().push_back (instance);
     }
     return false;
@@ -1416,7 +1417,7 @@ PluginManager::RegisterPlugin
 const char *
 PluginManager::GetProcessPluginNameAtIndex (uint32_t idx)
 {
-    Mutex::Locker locker (GetProcessMutex ());
+    ReadWriteLock::ReadLocker locker (GetProcessLock ());
     ProcessInstances &instances = GetProcessInstances ();
     if (idx < instances.size())
         return instances[idx].name.c_str();
@@ -1426,7 +1427,7 @@ PluginManager::GetProcessPluginNameAtIndex (uint32_t idx)
 const char *
 PluginManager::GetProcessPluginDescriptionAtIndex (uint32_t idx)
 {
-    Mutex::Locker locker (GetProcessMutex ());
+    ReadWriteLock::ReadLocker locker (GetProcessLock ());
     ProcessInstances &instances = GetProcessInstances ();
     if (idx < instances.size())
         return instances[idx].description.c_str();
@@ -1438,7 +1439,7 @@ PluginManager::UnregisterPlugin (ProcessCreateInstance create_callback)
 {
     if (create_callback)
     {
-        Mutex::Locker locker (GetProcessMutex ());
+        ReadWriteLock::WriteLocker locker (GetProcessLock ());
         ProcessInstances &instances = GetProcessInstances ();
         
         ProcessInstances::iterator pos, end = instances.end();
@@ -1457,7 +1458,7 @@ PluginManager::UnregisterPlugin (ProcessCreateInstance create_callback)
 ProcessCreateInstance
 PluginManager::GetProcessCreateCallbackAtIndex (uint32_t idx)
 {
-    Mutex::Locker locker (GetProcessMutex ());
+    ReadWriteLock::ReadLocker locker (GetProcessLock ());
     ProcessInstances &instances = GetProcessInstances ();
     if (idx < instances.size())
         return instances[idx].create_callback;
@@ -1471,7 +1472,7 @@ PluginManager::GetProcessCreateCallbackForPluginName (const char *name)
     if (name && name[0])
     {
         llvm::StringRef name_sref(name);
-        Mutex::Locker locker (GetProcessMutex ());
+        ReadWriteLock::ReadLocker locker (GetProcessLock ());
         ProcessInstances &instances = GetProcessInstances ();
         
         ProcessInstances::iterator pos, end = instances.end();
@@ -1502,11 +1503,11 @@ struct SymbolFileInstance
 
 typedef std::vector<SymbolFileInstance> SymbolFileInstances;
 
-static Mutex &
-GetSymbolFileMutex ()
+static ReadWriteLock &
+GetSymbolFileLock ()
 {
-    static Mutex g_instances_mutex (Mutex::eMutexTypeRecursive);
-    return g_instances_mutex;
+    static ReadWriteLock g_instances_lock;
+    return g_instances_lock;
 }
 
 static SymbolFileInstances &
@@ -1533,7 +1534,7 @@ PluginManager::RegisterPlugin
         if (description && description[0])
             instance.description = description;
         instance.create_callback = create_callback;
-        Mutex::Locker locker (GetSymbolFileMutex ());
+        ReadWriteLock::WriteLocker locker (GetSymbolFileLock ());
         GetSymbolFileInstances ().push_back (instance);
     }
     return false;
@@ -1544,7 +1545,7 @@ PluginManager::UnregisterPlugin (SymbolFileCreateInstance create_callback)
 {
     if (create_callback)
     {
-        Mutex::Locker locker (GetSymbolFileMutex ());
+        ReadWriteLock::WriteLocker locker (GetSymbolFileLock ());
         SymbolFileInstances &instances = GetSymbolFileInstances ();
         
         SymbolFileInstances::iterator pos, end = instances.end();
@@ -1563,7 +1564,7 @@ PluginManager::UnregisterPlugin (SymbolFileCreateInstance create_callback)
 SymbolFileCreateInstance
 PluginManager::GetSymbolFileCreateCallbackAtIndex (uint32_t idx)
 {
-    Mutex::Locker locker (GetSymbolFileMutex ());
+    ReadWriteLock::ReadLocker locker (GetSymbolFileLock ());
     SymbolFileInstances &instances = GetSymbolFileInstances ();
     if (idx < instances.size())
         return instances[idx].create_callback;
@@ -1576,7 +1577,7 @@ PluginManager::GetSymbolFileCreateCallbackForPluginName (const char *name)
     if (name && name[0])
     {
         llvm::StringRef name_sref(name);
-        Mutex::Locker locker (GetSymbolFileMutex ());
+        ReadWriteLock::ReadLocker locker (GetSymbolFileLock ());
         SymbolFileInstances &instances = GetSymbolFileInstances ();
         
         SymbolFileInstances::iterator pos, end = instances.end();
@@ -1609,11 +1610,11 @@ struct SymbolVendorInstance
 
 typedef std::vector<SymbolVendorInstance> SymbolVendorInstances;
 
-static Mutex &
-GetSymbolVendorMutex ()
+static ReadWriteLock &
+GetSymbolVendorLock ()
 {
-    static Mutex g_instances_mutex (Mutex::eMutexTypeRecursive);
-    return g_instances_mutex;
+    static ReadWriteLock g_instances_lock;
+    return g_instances_lock;
 }
 
 static SymbolVendorInstances &
@@ -1639,7 +1640,7 @@ PluginManager::RegisterPlugin
         if (description && description[0])
             instance.description = description;
         instance.create_callback = create_callback;
-        Mutex::Locker locker (GetSymbolVendorMutex ());
+        ReadWriteLock::WriteLocker locker (GetSymbolVendorLock ());
         GetSymbolVendorInstances ().push_back (instance);
     }
     return false;
@@ -1650,7 +1651,7 @@ PluginManager::UnregisterPlugin (SymbolVendorCreateInstance create_callback)
 {
     if (create_callback)
     {
-        Mutex::Locker locker (GetSymbolVendorMutex ());
+        ReadWriteLock::WriteLocker locker (GetSymbolVendorLock ());
         SymbolVendorInstances &instances = GetSymbolVendorInstances ();
         
         SymbolVendorInstances::iterator pos, end = instances.end();
@@ -1669,7 +1670,7 @@ PluginManager::UnregisterPlugin (SymbolVendorCreateInstance create_callback)
 SymbolVendorCreateInstance
 PluginManager::GetSymbolVendorCreateCallbackAtIndex (uint32_t idx)
 {
-    Mutex::Locker locker (GetSymbolVendorMutex ());
+    ReadWriteLock::ReadLocker locker (GetSymbolVendorLock ());
     SymbolVendorInstances &instances = GetSymbolVendorInstances ();
     if (idx < instances.size())
         return instances[idx].create_callback;
@@ -1683,7 +1684,7 @@ PluginManager::GetSymbolVendorCreateCallbackForPluginName (const char *name)
     if (name && name[0])
     {
         llvm::StringRef name_sref(name);
-        Mutex::Locker locker (GetSymbolVendorMutex ());
+        ReadWriteLock::ReadLocker locker (GetSymbolVendorLock ());
         SymbolVendorInstances &instances = GetSymbolVendorInstances ();
         
         SymbolVendorInstances::iterator pos, end = instances.end();
@@ -1715,11 +1716,11 @@ struct UnwindAssemblyInstance
 
 typedef std::vector<UnwindAssemblyInstance> UnwindAssemblyInstances;
 
-static Mutex &
-GetUnwindAssemblyMutex ()
+static ReadWriteLock &
+GetUnwindAssemblyLock ()
 {
-    static Mutex g_instances_mutex (Mutex::eMutexTypeRecursive);
-    return g_instances_mutex;
+    static ReadWriteLock g_instances_lock;
+    return g_instances_lock;
 }
 
 static UnwindAssemblyInstances &
@@ -1745,7 +1746,7 @@ PluginManager::RegisterPlugin
         if (description && description[0])
             instance.description = description;
         instance.create_callback = create_callback;
-        Mutex::Locker locker (GetUnwindAssemblyMutex ());
+        ReadWriteLock::WriteLocker locker (GetUnwindAssemblyLock ());
         GetUnwindAssemblyInstances ().push_back (instance);
     }
     return false;
@@ -1756,7 +1757,7 @@ PluginManager::UnregisterPlugin (UnwindAssemblyCreateInstance create_callback)
 {
     if (create_callback)
     {
-        Mutex::Locker locker (GetUnwindAssemblyMutex ());
+        ReadWriteLock::WriteLocker locker (GetUnwindAssemblyLock ());
         UnwindAssemblyInstances &instances = GetUnwindAssemblyInstances ();
         
         UnwindAssemblyInstances::iterator pos, end = instances.end();
@@ -1775,7 +1776,7 @@ PluginManager::UnregisterPlugin (UnwindAssemblyCreateInstance create_callback)
 UnwindAssemblyCreateInstance
 PluginManager::GetUnwindAssemblyCreateCallbackAtIndex (uint32_t idx)
 {
-    Mutex::Locker locker (GetUnwindAssemblyMutex ());
+    ReadWriteLock::ReadLocker locker (GetUnwindAssemblyLock ());
     UnwindAssemblyInstances &instances = GetUnwindAssemblyInstances ();
     if (idx < instances.size())
         return instances[idx].create_callback;
@@ -1789,7 +1790,7 @@ PluginManager::GetUnwindAssemblyCreateCallbackForPluginName (const char *name)
     if (name && name[0])
     {
         llvm::StringRef name_sref(name);
-        Mutex::Locker locker (GetUnwindAssemblyMutex ());
+        ReadWriteLock::ReadLocker locker (GetUnwindAssemblyLock ());
         UnwindAssemblyInstances &instances = GetUnwindAssemblyInstances ();
         
         UnwindAssemblyInstances::iterator pos, end = instances.end();
@@ -0,0 +1,204 @@
+//===-- PromptFormat.cpp ----------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "lldb/Core/PromptFormat.h"
+
+// C Includes
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+// C++ Includes
+// Other libraries and framework includes
+// Project includes
+
+using namespace lldb;
+using namespace lldb_private;
+
+PromptFormat::PromptFormat () :
+    m_format (),
+    m_tokens (),
+    m_first_mergeable_token (0),
+    m_end_offset (0)
+{
+}
+
+PromptFormat::PromptFormat (const char *format) :
+    m_format (),
+    m_tokens (),
+    m_first_mergeable_token (0),
+    m_end_offset (0)
+{
+    Compile (format);
+}
+
+PromptFormat::~PromptFormat ()
+{
+}
+
+void
+PromptFormat::Compile (const char *format)
+{
+    m_tokens.clear();
+    m_first_mergeable_token = 0;
+    if (format)
+        m_format.assign (format);
+    else
+        m_format.clear();
+    const char *p = m_format.c_str();
+    CompileScope (p);
+    m_end_offset = p - m_format.c_str();
+}
+
+void
+PromptFormat::AppendToken (TokenKind kind, const char *text, size_t text_len)
+{
+    // Runs of text and runs of escapes are printed the same way no matter
+    // how they are split up
+    if ((kind == eTokenText || kind == eTokenEscape) &&
+        m_tokens.size() > m_first_mergeable_token &&
+        m_tokens.back().kind == kind)
+    {
+        m_tokens.back().text.append (text, text_len);
+        return;
+    }
+    Token token;
+    token.kind = kind;
+    if (text)
+        token.text.assign (text, text_len);
+    token.num_scope_tokens = 0;
+    m_tokens.push_back (token);
+}
+
+// This follows the parsing Debugger::FormatPrompt() always did, "p" is
+// left where it would have stopped
+void
+PromptFormat::CompileScope (const char *&p)
+{
+    for (; *p != '\0'; ++p)
+    {
+        size_t non_special_chars = ::strcspn (p, "${}\\");
+        if (non_special_chars > 0)
+        {
+            AppendToken (eTokenText, p, non_special_chars);
+            p += non_special_chars;
+        }
+
+        if (*p == '\0')
+        {
+            break;
+        }
+        else if (*p == '{')
+        {
+            ++p;  // Skip the '{'
+            const size_t scope_idx = m_tokens.size();
+            AppendToken (eTokenScope, NULL, 0);
+            CompileScope (p);
+            m_tokens[scope_idx].num_scope_tokens = m_tokens.size() - scope_idx - 1;
+            m_first_mergeable_token = m_tokens.size();
+            if (*p != '}')
+            {
+                AppendToken (eTokenError, NULL, 0);
+                break;
+            }
+        }
+        else if (*p == '}')
+        {
+            // End of a enclosing scope
+            break;
+        }
+        else if (*p == '$')
+        {
+            ++p;
+            if (*p == '{')
+            {
+                ++p;
+                const char *var_name_end = ::strchr (p, '}');
+                if (var_name_end && p < var_name_end)
+                {
+                    AppendToken (eTokenVariable, p, var_name_end - p + 1);
+                    p = var_name_end;
+                }
+                else
+                    break;
+            }
+            else if (*p == '\0')
+            {
+                break;
+            }
+            else
+            {
+                // We got a dollar sign with no '{' after it, it must just be a dollar sign
+                AppendToken (eTokenEscape, p, 1);
+            }
+        }
+        else if (*p == '\\')
+        {
+            ++p; // skip the slash
+            char escaped_char = *p;
+            switch (*p)
+            {
+            case '\0': return;
+            case 'a': escaped_char = '\a'; break;
+            case 'b': escaped_char = '\b'; break;
+            case 'f': escaped_char = '\f'; break;
+            case 'n': escaped_char = '\n'; break;
+            case 'r': escaped_char = '\r'; break;
+            case 't': escaped_char = '\t'; break;
+            case 'v': escaped_char = '\v'; break;
+            case '0':
+                // 1 to 3 octal chars
+                {
+                    // Make a string that can hold onto the initial zero char,
+                    // up to 3 octal digits, and a terminating NULL.
+                    char oct_str[5] = { 0, 0, 0, 0, 0 };
+
+                    int i;
+                    for (i=0; (p[i] >= '0' && p[i] <= '7') && i<4; ++i)
+                        oct_str[i] = p[i];
+
+                    // We don't want to consume the last octal character since
+                    // the main for loop will do this for us, so we advance p by
+                    // one less than i (even if i is zero)
+                    p += i - 1;
+                    unsigned long octal_value = ::strtoul (oct_str, NULL, 8);
+                    if (octal_value > UINT8_MAX)
+                        continue;
+                    escaped_char = octal_value;
+                }
+                break;
+
+            case 'x':
+                // hex number in the format 
+                if (isxdigit(p[1]))
+                {
+                    ++p;    // Skip the 'x'
+
+                    // Make a string that can hold onto two hex chars plus a
+                    // NULL terminator
+                    char hex_str[3] = { 0,0,0 };
+                    hex_str[0] = *p;
+                    if (isxdigit(p[1]))
+                    {
+                        ++p; // Skip the first of the two hex chars
+                        hex_str[1] = *p;
+                    }
+
+                    escaped_char = ::strtoul (hex_str, NULL, 16);
+                }
+                break;
+
+            default:
+                // Just desensitize any other character by just printing what
+                // came after the '\'
+                break;
+            }
+            AppendToken (eTokenEscape, &escaped_char, 1);
+        }
+    }
+}
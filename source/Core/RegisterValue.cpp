@@ -17,7 +17,6 @@
 #include "lldb/Core/Error.h"
 #include "lldb/Core/Scalar.h"
 #include "lldb/Core/Stream.h"
-#include "lldb/Core/StreamString.h"
 #include "lldb/Interpreter/Args.h"
 
 using namespace lldb;
@@ -41,22 +40,20 @@ RegisterValue::Dump (Stream *s,
         // 
         //     prefix_with_name^prefix_with_alt_name is true
         //
-        StreamString format_string;
+        // A field width of zero prints the name unpadded.
+        int name_width = 0;
         if (reg_name_right_align_at && (prefix_with_name^prefix_with_alt_name))
-            format_string.Printf("%%%us", reg_name_right_align_at);
-        else
-            format_string.Printf("%%s");
-        const char *fmt = format_string.GetData();
+            name_width = reg_name_right_align_at;
         if (prefix_with_name)
         {
             if (reg_info->name)
             {
-                s->Printf (fmt, reg_info->name);
+                s->Printf ("%*s", name_width, reg_info->name);
                 name_printed = true;
             }
             else if (reg_info->alt_name)
             {
-                s->Printf (fmt, reg_info->alt_name);
+                s->Printf ("%*s", name_width, reg_info->alt_name);
                 prefix_with_alt_name = false;
                 name_printed = true;
             }
@@ -67,13 +64,13 @@ RegisterValue::Dump (Stream *s,
                 s->PutChar ('/');
             if (reg_info->alt_name)
             {
-                s->Printf (fmt, reg_info->alt_name);
+                s->Printf ("%*s", name_width, reg_info->alt_name);
                 name_printed = true;
             }
             else if (!name_printed)
             {
                 // No alternate name but we were asked to display a name, so show the main name
-                s->Printf (fmt, reg_info->name);
+                s->Printf ("%*s", name_width, reg_info->name);
                 name_printed = true;
             }
         }
@@ -330,9 +327,6 @@ RegisterValue::SetValueFromData (const RegisterInfo *reg_info, DataExtractor &sr
     if (src_len > reg_info->byte_size)
         src_len = reg_info->byte_size;
 
-    // Zero out the value in case we get partial data...
-    memset (m_data.buffer.bytes, 0, sizeof (m_data.buffer.bytes));
-    
     switch (SetType (reg_info))
     {
         case eTypeInvalid:
@@ -359,6 +353,9 @@ RegisterValue::SetValueFromData (const RegisterInfo *reg_info, DataExtractor &sr
         case eTypeLongDouble:   SetFloat (src.GetLongDouble (&src_offset)); break;
         case eTypeBytes:
         {
+            // Zero out the value in case we get partial data. The integer and
+            // floating point cases above always write the whole value.
+            memset (m_data.buffer.bytes, 0, sizeof (m_data.buffer.bytes));
             m_data.buffer.length = reg_info->byte_size;
             m_data.buffer.byte_order = src.GetByteOrder();
             assert (m_data.buffer.length <= kMaxRegisterByteSize);
@@ -380,7 +377,6 @@ RegisterValue::SetValueFromData (const RegisterInfo *reg_info, DataExtractor &sr
 }
 
 #include "llvm/ADT/StringRef.h"
-#include <vector>
 static inline void StripSpaces(llvm::StringRef &Str)
 {
     while (!Str.empty() && isspace(Str[0]))
@@ -414,21 +410,26 @@ ParseVectorEncoding(const RegisterInfo *reg_info, const char *vector_str, const
     // The first split should give us:
     // ('0x2c', '0x4b 0x2a 0x3e 0xd0 0x4f 0x2a 0x3e 0xac 0x4a 0x2a 0x3e 0x84 0x4f 0x2a 0x3e').
     std::pair<llvm::StringRef, llvm::StringRef> Pair = Str.split(Sep);
-    std::vector<uint8_t> bytes;
+    // No register is bigger than a RegisterValue can hold, so parse into a
+    // fixed buffer rather than a heap allocated one.
+    if (byte_size > RegisterValue::kMaxRegisterByteSize)
+        return false;
+    uint8_t bytes[RegisterValue::kMaxRegisterByteSize];
+    uint32_t num_bytes = 0;
     unsigned byte = 0;
 
     // Using radix auto-sensing by passing 0 as the radix.
     // Keep on processing the vector elements as long as the parsing succeeds and the vector size is < byte_size.
-    while (!Pair.first.getAsInteger(0, byte) && bytes.size() < byte_size) {
-        bytes.push_back(byte);
+    while (!Pair.first.getAsInteger(0, byte) && num_bytes < byte_size) {
+        bytes[num_bytes++] = byte;
         Pair = Pair.second.split(Sep);
     }
 
     // Check for vector of exact byte_size elements.
-    if (bytes.size() != byte_size)
+    if (num_bytes != byte_size)
         return false;
 
-    reg_value->SetBytes(&(bytes.front()), byte_size, eByteOrderLittle);
+    reg_value->SetBytes(bytes, byte_size, eByteOrderLittle);
     return true;
 }
 Error
@@ -709,6 +710,14 @@ RegisterValue::GetAsUInt32 (uint32_t fail_value, bool *success_ptr) const
 uint64_t
 RegisterValue::GetAsUInt64 (uint64_t fail_value, bool *success_ptr) const
 {
+    // Most registers are 64 bit general purpose registers, check for those
+    // before the switch.
+    if (m_type == eTypeUInt64)
+    {
+        if (success_ptr)
+            *success_ptr = true;
+        return m_data.uint64;
+    }
     if (success_ptr)
         *success_ptr = true;
     switch (m_type)
@@ -8,6 +8,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "lldb/Core/RegularExpression.h"
+#include <ctype.h>
 #include <string.h>
 
 using namespace lldb_private;
@@ -17,6 +18,7 @@ using namespace lldb_private;
 //----------------------------------------------------------------------
 RegularExpression::RegularExpression() :
 	m_re(),
+	m_required_literal(),
 	m_regex(llvm::StringRef())
 {
 }
@@ -27,6 +29,7 @@ RegularExpression::RegularExpression() :
 //----------------------------------------------------------------------
 RegularExpression::RegularExpression(const char* re, int flags) :
 	m_re(),
+    m_required_literal(),
     m_regex(llvm::StringRef())
 {
     Compile(re);
@@ -38,12 +41,15 @@ RegularExpression::RegularExpression(const char* re, int flags) :
 //----------------------------------------------------------------------
 RegularExpression::RegularExpression(const char* re) :
     m_re(),
+    m_required_literal(),
     m_regex(llvm::StringRef())
 {
     Compile(re);
 }
 
 RegularExpression::RegularExpression(const RegularExpression &rhs) :
+    m_re(),
+    m_required_literal(),
     m_regex(llvm::StringRef())
  {
      Compile(rhs.GetText(), rhs.GetCompileFlags());
@@ -82,6 +88,182 @@ RegularExpression::~RegularExpression()
 //  True of the refular expression compiles successfully, false
 //  otherwise.
 //----------------------------------------------------------------------
+//----------------------------------------------------------------------
+// Skip a bracket expression like "[a-z]" or "[^]:[:space:]]" that
+// starts at "p", returning a pointer just past its closing bracket or
+// NULL if it isn't closed.
+//----------------------------------------------------------------------
+static const char *
+SkipBracketExpression (const char *p)
+{
+    ++p;
+    if (*p == '^')
+        ++p;
+    // A ']' right at the start is part of the set
+    if (*p == ']')
+        ++p;
+    while (*p && *p != ']')
+    {
+        if (p[0] == '[' && (p[1] == ':' || p[1] == '.' || p[1] == '='))
+        {
+            // "[:alpha:]", "[.-.]" and "[=a=]" end with the same
+            // character followed by ']'
+            const char delimiter = p[1];
+            p += 2;
+            while (*p && !(p[0] == delimiter && p[1] == ']'))
+                ++p;
+            if (*p == '\0')
+                return NULL;
+            p += 2;
+        }
+        else
+            ++p;
+    }
+    if (*p == '\0')
+        return NULL;
+    return p + 1;
+}
+
+//----------------------------------------------------------------------
+// Skip a parenthesized group that starts at "p", returning a pointer
+// just past its closing parenthesis or NULL if it isn't closed.
+//----------------------------------------------------------------------
+static const char *
+SkipGroup (const char *p)
+{
+    uint32_t depth = 0;
+    while (*p)
+    {
+        switch (*p)
+        {
+        case '\\':
+            if (p[1] == '\0')
+                return NULL;
+            p += 2;
+            continue;
+        case '[':
+            p = SkipBracketExpression (p);
+            if (p == NULL)
+                return NULL;
+            continue;
+        case '(':
+            ++depth;
+            break;
+        case ')':
+            if (--depth == 0)
+                return p + 1;
+            break;
+        }
+        ++p;
+    }
+    return NULL;
+}
+
+//----------------------------------------------------------------------
+// Find the longest run of literal characters that every string the
+// extended regular expression "re" matches must contain, so Execute()
+// can reject most strings with a strstr() instead of running the
+// regular expression engine.
+//
+// Anything that isn't understood gives up and returns an empty string,
+// which just turns the check off. Alternation anywhere means there is
+// nothing that is always required, and the contents of groups are
+// skipped since the group may be optional.
+//----------------------------------------------------------------------
+static std::string
+CalculateRequiredLiteral (const char *re)
+{
+    std::string best;
+    if (re == NULL || ::strchr (re, '|'))
+        return best;
+
+    std::string run;
+    const char *p = re;
+    while (*p)
+    {
+        bool is_literal = false;
+        char literal = '\0';
+        switch (*p)
+        {
+        case '\\':
+            if (p[1] == '\0')
+                return std::string();
+            // Escaped letters and digits can be classes or back
+            // references, only escaped punctuation is literal
+            if (!isalnum ((unsigned char)p[1]))
+            {
+                is_literal = true;
+                literal = p[1];
+            }
+            p += 2;
+            break;
+
+        case '[':
+            p = SkipBracketExpression (p);
+            if (p == NULL)
+                return std::string();
+            break;
+
+        case '(':
+            p = SkipGroup (p);
+            if (p == NULL)
+                return std::string();
+            break;
+
+        case '.':
+        case '^':
+        case '$':
+            ++p;
+            break;
+
+        case '*':
+        case '+':
+        case '?':
+        case '{':
+        case ')':
+            // A repetition with nothing to repeat or an unbalanced
+            // parenthesis, leave it to the regular expression engine
+            return std::string();
+
+        default:
+            is_literal = true;
+            literal = *p;
+            ++p;
+            break;
+        }
+
+        if (*p == '*' || *p == '?' || *p == '{')
+        {
+            // The atom we just read can be left out
+            if (*p == '{')
+            {
+                p = ::strchr (p, '}');
+                if (p == NULL)
+                    return std::string();
+            }
+            ++p;
+            is_literal = false;
+        }
+
+        if (is_literal)
+            run += literal;
+
+        if (!is_literal || *p == '+')
+        {
+            // An atom that can repeat still has to be there once, but
+            // nothing after it is next to it for sure
+            if (*p == '+')
+                ++p;
+            if (run.size() > best.size())
+                best.swap (run);
+            run.clear();
+        }
+    }
+    if (run.size() > best.size())
+        best.swap (run);
+    return best;
+}
+
 bool
 RegularExpression::Compile(const char* re)
 {
@@ -96,7 +278,10 @@ RegularExpression::Compile(const char* re, int flags)
     m_re = re;
     m_regex = llvm::Regex(llvm::StringRef(re));
  
-    return IsValid();
+    if (!IsValid())
+        return false;
+    m_required_literal = CalculateRequiredLiteral (re);
+    return true;
 }
 
 //----------------------------------------------------------------------
@@ -110,6 +295,20 @@ RegularExpression::Compile(const char* re, int flags)
 bool
 RegularExpression::Execute(const char* s, size_t num_matches, int execute_flags) const
 {
+    // Most strings we are asked to match, like every symbol name in a
+    // program, don't have the text every match needs, and strstr() is
+    // much cheaper than the regular expression engine
+    if (s && !m_required_literal.empty() && ::strstr (s, m_required_literal.c_str()) == NULL)
+    {
+        if (num_matches > 0)
+            m_matches.clear();
+        return false;
+    }
+    // Only keep the matches when asked for them, so that a compiled
+    // expression can be shared by threads that just want to know if
+    // strings match
+    if (num_matches == 0)
+        return m_regex.match(llvm::StringRef(s));
     return m_regex.match(llvm::StringRef(s), &m_matches);
 }
 
@@ -155,6 +354,7 @@ void
 RegularExpression::Free()
 {
     m_re.clear();
+    m_required_literal.clear();
     m_regex = llvm::Regex(llvm::StringRef());
     m_matches.clear();
 }
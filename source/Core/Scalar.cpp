@@ -36,7 +36,6 @@ PromoteToMaxType
     const Scalar* &promoted_rhs_ptr // Pointer to the resulting possibly promoted value of rhs (at most one of lhs/rhs will get promoted)
 )
 {
-    Scalar result;
     // Initialize the promoted values for both the right and left hand side values
     // to be the objects themselves. If no promotion is needed (both right and left
     // have the same type), then the temp_value will not get used.
@@ -46,6 +45,11 @@ PromoteToMaxType
     Scalar::Type lhs_type = lhs.GetType();
     Scalar::Type rhs_type = rhs.GetType();
 
+    // DWARF expressions and the IR interpreter almost always combine values
+    // of the same type, which need no promotion at all.
+    if (lhs_type == rhs_type)
+        return lhs_type;
+
     if (lhs_type > rhs_type)
     {
         // Right hand side need to be promoted
@@ -71,20 +75,24 @@ PromoteToMaxType
 
 
 //----------------------------------------------------------------------
-// Scalar constructor
+// Returns true if values of type "type" are 64 bit integers, which is what
+// addresses and most values computed by DWARF expressions are. Those can be
+// read straight out of m_data.ulonglong without a switch on the type.
 //----------------------------------------------------------------------
-Scalar::Scalar() :
-    m_type(e_void),
-    m_data()
+static inline bool
+Is64BitIntegerType (Scalar::Type type)
 {
+    if (sizeof(long) == sizeof(long long))
+        return (unsigned)(type - Scalar::e_slong) <= (unsigned)(Scalar::e_ulonglong - Scalar::e_slong);
+    return (unsigned)(type - Scalar::e_slonglong) <= (unsigned)(Scalar::e_ulonglong - Scalar::e_slonglong);
 }
 
 //----------------------------------------------------------------------
-// Scalar copy constructor
+// Scalar constructor
 //----------------------------------------------------------------------
-Scalar::Scalar(const Scalar& rhs) :
-    m_type(rhs.m_type),
-    m_data(rhs.m_data)  // TODO: verify that for C++ this will correctly copy the union??
+Scalar::Scalar() :
+    m_type(e_void),
+    m_data()
 {
 }
 
@@ -251,20 +259,6 @@ Scalar::GetTypeAsCString() const
 
 
 
-//----------------------------------------------------------------------
-// Scalar copy constructor
-//----------------------------------------------------------------------
-Scalar&
-Scalar::operator=(const Scalar& rhs)
-{
-    if (this != &rhs)
-    {
-        m_type = rhs.m_type;
-        ::memcpy (&m_data, &rhs.m_data, sizeof(m_data));
-    }
-    return *this;
-}
-
 Scalar&
 Scalar::operator= (const int v)
 {
@@ -338,13 +332,6 @@ Scalar::operator= (long double v)
     return *this;
 }
 
-//----------------------------------------------------------------------
-// Destructor
-//----------------------------------------------------------------------
-Scalar::~Scalar()
-{
-}
-
 bool
 Scalar::Promote(Scalar::Type type)
 {
@@ -824,6 +811,9 @@ Scalar::ULong(unsigned long fail_value) const
 uint64_t
 Scalar::GetRawBits64(uint64_t fail_value) const
 {
+    if (Is64BitIntegerType (m_type))
+        return m_data.ulonglong;
+
     switch (m_type)
     {
     default:
@@ -877,6 +867,9 @@ Scalar::GetRawBits64(uint64_t fail_value) const
 long long
 Scalar::SLongLong(long long fail_value) const
 {
+    if (Is64BitIntegerType (m_type))
+        return m_data.slonglong;
+
     switch (m_type)
     {
     default:
@@ -898,6 +891,9 @@ Scalar::SLongLong(long long fail_value) const
 unsigned long long
 Scalar::ULongLong(unsigned long long fail_value) const
 {
+    if (Is64BitIntegerType (m_type))
+        return m_data.ulonglong;
+
     switch (m_type)
     {
     default:
@@ -17,6 +17,7 @@
 #include "lldb/Core/Debugger.h"
 #include "lldb/Core/Module.h"
 #include "lldb/Core/Stream.h"
+#include "lldb/Host/Mutex.h"
 #include "lldb/Symbol/ClangNamespaceDecl.h"
 #include "lldb/Symbol/CompileUnit.h"
 #include "lldb/Symbol/Function.h"
@@ -287,6 +288,15 @@ SourceManager::FindLinesMatchingRegex (FileSpec &file_spec,
     return file_sp->FindLinesMatchingRegex (regex, start_line, end_line, match_lines);
 }
 
+TimeValue
+SourceManager::GetFileModificationTime (const FileSpec &file_spec)
+{
+    FileSP file_sp = GetFile (file_spec);
+    if (file_sp)
+        return file_sp->GetFileSpec().GetModificationTime();
+    return TimeValue();
+}
+
 SourceManager::File::File(const FileSpec &file_spec, Target *target) :
     m_file_spec_orig (file_spec),
     m_file_spec(file_spec),
@@ -360,13 +370,79 @@ SourceManager::File::File(const FileSpec &file_spec, Target *target) :
     }
     
     if (m_mod_time.IsValid())
-        m_data_sp = m_file_spec.ReadFileContents ();
+        m_data_sp = GetFileContents (m_file_spec, m_mod_time);
 }
 
 SourceManager::File::~File()
 {
 }
 
+//----------------------------------------------------------------------
+// The contents of source files are shared by every debugger in the
+// process, so IDE sessions with many targets that show the same big
+// generated sources only have one copy of each. The cache doesn't keep
+// the contents alive, they go away with the last File that uses them.
+//----------------------------------------------------------------------
+struct SharedSourceFileContents
+{
+    TimeValue mod_time;
+    STD_WEAK_PTR(DataBuffer) data_wp;
+};
+
+typedef std::map<FileSpec, SharedSourceFileContents> SharedSourceFileContentsMap;
+
+static Mutex &
+GetSharedSourceFileContentsMutex ()
+{
+    static Mutex g_mutex (Mutex::eMutexTypeNormal);
+    return g_mutex;
+}
+
+static SharedSourceFileContentsMap &
+GetSharedSourceFileContents ()
+{
+    static SharedSourceFileContentsMap g_contents;
+    return g_contents;
+}
+
+// Files at least this big are memory mapped instead of read, so only
+// the pages that get displayed or indexed are ever read from disk.
+#define SOURCE_FILE_MIN_MMAP_SIZE (64 * 1024)
+
+DataBufferSP
+SourceManager::File::GetFileContents (const FileSpec &file_spec, const TimeValue &mod_time)
+{
+    Mutex::Locker locker (GetSharedSourceFileContentsMutex());
+    SharedSourceFileContentsMap &contents_map = GetSharedSourceFileContents();
+    SharedSourceFileContents &contents = contents_map[file_spec];
+    DataBufferSP data_sp;
+    if (contents.mod_time == mod_time)
+        data_sp = contents.data_wp.lock();
+    if (!data_sp)
+    {
+        // A mapped file is only used while its modification time is the
+        // one it was mapped with, every File checks that before it looks
+        // at the contents.
+        if (file_spec.GetByteSize() >= SOURCE_FILE_MIN_MMAP_SIZE)
+            data_sp = file_spec.MemoryMapFileContents ();
+        if (!data_sp || data_sp->GetBytes() == NULL)
+            data_sp = file_spec.ReadFileContents ();
+        contents.mod_time = mod_time;
+        contents.data_wp = data_sp;
+    }
+
+    // Drop the entries for files nobody is looking at any more
+    SharedSourceFileContentsMap::iterator pos = contents_map.begin();
+    while (pos != contents_map.end())
+    {
+        if (pos->second.data_wp.expired())
+            contents_map.erase (pos++);
+        else
+            ++pos;
+    }
+    return data_sp;
+}
+
 uint32_t
 SourceManager::File::GetLineOffset (uint32_t line)
 {
@@ -406,7 +482,7 @@ SourceManager::File::DisplaySourceLines (uint32_t line, uint32_t context_before,
     if (curr_mod_time.IsValid() && m_mod_time != curr_mod_time)
     {
         m_mod_time = curr_mod_time;
-        m_data_sp = m_file_spec.ReadFileContents ();
+        m_data_sp = GetFileContents (m_file_spec, m_mod_time);
         m_offsets.clear();
     }
 
@@ -445,20 +521,21 @@ SourceManager::File::FindLinesMatchingRegex (RegularExpression& regex, uint32_t
     if (m_mod_time != curr_mod_time)
     {
         m_mod_time = curr_mod_time;
-        m_data_sp = m_file_spec.ReadFileContents ();
+        m_data_sp = GetFileContents (m_file_spec, m_mod_time);
         m_offsets.clear();
     }
     
     match_lines.clear();
     
-    if (!LineIsValid(start_line) || (end_line != UINT32_MAX && !LineIsValid(end_line)))
+    // An end line past the end of the file just means search to the end
+    if (!LineIsValid(start_line))
         return;
     if (start_line > end_line)
         return;
         
+    std::string buffer;
     for (uint32_t line_no = start_line; line_no < end_line; line_no++)
     {
-        std::string buffer;
         if (!GetLine (line_no, buffer))
             break;
         if (regex.Execute(buffer.c_str()))
@@ -498,63 +575,55 @@ lldb_private::operator== (const SourceManager::File &lhs, const SourceManager::F
 bool
 SourceManager::File::CalculateLineOffsets (uint32_t line)
 {
-    line = UINT32_MAX;  // TODO: take this line out when we support partial indexing
-    if (line == UINT32_MAX)
-    {
-        // Already done?
-        if (!m_offsets.empty() && m_offsets[0] == UINT32_MAX)
-            return true;
+    // Already done?
+    if (!m_offsets.empty() && m_offsets[0] == UINT32_MAX)
+        return true;
 
-        if (m_offsets.empty())
-        {
-            if (m_data_sp.get() == NULL)
-                return false;
+    if (m_data_sp.get() == NULL)
+        return false;
 
-            const char *start = (char *)m_data_sp->GetBytes();
-            if (start)
-            {
-                const char *end = start + m_data_sp->GetByteSize();
+    const char *start = (char *)m_data_sp->GetBytes();
+    if (start == NULL)
+        return false;
+    const char *end = start + m_data_sp->GetByteSize();
 
-                // Calculate all line offsets from scratch
+    // Lines are indexed as they are asked for, so showing the top of a
+    // huge file doesn't have to read all of it. m_offsets[0] is zero
+    // until the whole file is indexed, and then it is UINT32_MAX.
+    if (m_offsets.empty())
+        m_offsets.push_back(0);
 
-                // Push a 1 at index zero to indicate the file has been completely indexed.
-                m_offsets.push_back(UINT32_MAX);
-                register const char *s;
-                for (s = start; s < end; ++s)
-                {
-                    register char curr_ch = *s;
-                    if (is_newline_char (curr_ch))
-                    {
-                        register char next_ch = s[1];
-                        if (is_newline_char (next_ch))
-                        {
-                            if (curr_ch != next_ch)
-                                ++s;
-                        }
-                        m_offsets.push_back(s + 1 - start);
-                    }
-                }
-                if (!m_offsets.empty())
+    // Pick up where we left off, which is the start of the last line
+    // that was found
+    register const char *s = start + (m_offsets.size() > 1 ? m_offsets.back() : 0);
+
+    // Finding where "line" ends needs the start of the line after it
+    while (line == UINT32_MAX || m_offsets.size() <= line)
+    {
+        if (s >= end)
+        {
+            if (m_offsets.back() < end - start)
+                m_offsets.push_back(end - start);
+            m_offsets[0] = UINT32_MAX;
+            return true;
+        }
+        register char curr_ch = *s;
+        if (is_newline_char (curr_ch))
+        {
+            if (s + 1 < end)
+            {
+                register char next_ch = s[1];
+                if (is_newline_char (next_ch))
                 {
-                    if (m_offsets.back() < end - start)
-                        m_offsets.push_back(end - start);
+                    if (curr_ch != next_ch)
+                        ++s;
                 }
-                return true;
             }
+            m_offsets.push_back(s + 1 - start);
         }
-        else
-        {
-            // Some lines have been populated, start where we last left off
-            assert(!"Not implemented yet");
-        }
-
-    }
-    else
-    {
-        // Calculate all line offsets up to "line"
-        assert(!"Not implemented yet");
+        ++s;
     }
-    return false;
+    return true;
 }
 
 bool
@@ -577,7 +646,7 @@ SourceManager::File::GetLine (uint32_t line_no, std::string &buffer)
 void 
 SourceManager::SourceFileCache::AddSourceFile (const FileSP &file_sp)
 {
-    FileSpec file_spec;
+    FileSpec file_spec (file_sp->GetFileSpec());
     FileCache::iterator pos = m_file_cache.find(file_spec);
     if (pos == m_file_cache.end())
         m_file_cache[file_spec] = file_sp;
@@ -0,0 +1,299 @@
+//===-- Statistics.cpp ------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "lldb/Core/Statistics.h"
+
+// C Includes
+#include <string.h>
+
+// C++ Includes
+#include <map>
+#include <string>
+#include <vector>
+
+// Other libraries and framework includes
+// Project includes
+#include "lldb/Core/Stream.h"
+#include "lldb/Host/Mutex.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+StatisticsHistogram::StatisticsHistogram () :
+    m_count (0),
+    m_sum (0),
+    m_maximum (0)
+{
+    ::memset (m_buckets, 0, sizeof(m_buckets));
+}
+
+void
+StatisticsHistogram::Add (uint64_t value)
+{
+    const uint32_t bucket_idx = value == 0 ? 0 : 64 - __builtin_clzll (value);
+    __sync_add_and_fetch (&m_buckets[bucket_idx], 1);
+    __sync_add_and_fetch (&m_count, 1);
+    __sync_add_and_fetch (&m_sum, value);
+    uint64_t maximum = m_maximum;
+    while (value > maximum)
+    {
+        const uint64_t prev_maximum = __sync_val_compare_and_swap (&m_maximum, maximum, value);
+        if (prev_maximum == maximum)
+            break;
+        maximum = prev_maximum;
+    }
+}
+
+uint64_t
+StatisticsHistogram::GetCount () const
+{
+    return __sync_add_and_fetch (const_cast<uint64_t *>(&m_count), 0);
+}
+
+uint64_t
+StatisticsHistogram::GetSum () const
+{
+    return __sync_add_and_fetch (const_cast<uint64_t *>(&m_sum), 0);
+}
+
+uint64_t
+StatisticsHistogram::GetMaximum () const
+{
+    return __sync_add_and_fetch (const_cast<uint64_t *>(&m_maximum), 0);
+}
+
+uint64_t
+StatisticsHistogram::GetBucketCount (uint32_t bucket_idx) const
+{
+    if (bucket_idx < eNumBuckets)
+        return __sync_add_and_fetch (const_cast<uint64_t *>(&m_buckets[bucket_idx]), 0);
+    return 0;
+}
+
+void
+StatisticsHistogram::Reset ()
+{
+    for (uint32_t i = 0; i < eNumBuckets; ++i)
+        __sync_lock_test_and_set (&m_buckets[i], 0);
+    __sync_lock_test_and_set (&m_count, 0);
+    __sync_lock_test_and_set (&m_sum, 0);
+    __sync_lock_test_and_set (&m_maximum, 0);
+}
+
+namespace {
+    struct StatisticsEntry
+    {
+        StatisticsCounter *counter;
+        StatisticsHistogram *histogram;
+    };
+}
+
+// Sorted by name so that all the names in a group are next to each other
+typedef std::map<std::string, StatisticsEntry> StatisticsMap;
+
+// The entries are never freed, places that count keep references to them
+static Mutex &
+GetStatisticsMutex ()
+{
+    static Mutex g_mutex (Mutex::eMutexTypeNormal);
+    return g_mutex;
+}
+
+static StatisticsMap &
+GetStatisticsMap ()
+{
+    static StatisticsMap g_map;
+    return g_map;
+}
+
+StatisticsCounter &
+Statistics::GetCounter (const char *name)
+{
+    Mutex::Locker locker (GetStatisticsMutex());
+    StatisticsEntry &entry = GetStatisticsMap()[name];
+    if (entry.counter == NULL)
+        entry.counter = new StatisticsCounter;
+    return *entry.counter;
+}
+
+StatisticsHistogram &
+Statistics::GetHistogram (const char *name)
+{
+    Mutex::Locker locker (GetStatisticsMutex());
+    StatisticsEntry &entry = GetStatisticsMap()[name];
+    if (entry.histogram == NULL)
+        entry.histogram = new StatisticsHistogram;
+    return *entry.histogram;
+}
+
+static void
+SplitStatisticName (const std::string &name, std::vector<std::string> &components)
+{
+    components.clear();
+    size_t start = 0;
+    while (true)
+    {
+        const size_t dot = name.find ('.', start);
+        components.push_back (name.substr (start, dot == std::string::npos ? std::string::npos : dot - start));
+        if (dot == std::string::npos)
+            break;
+        start = dot + 1;
+    }
+}
+
+static void
+DumpHistogram (Stream &s, const StatisticsHistogram &histogram, bool json)
+{
+    const uint64_t count = histogram.GetCount();
+    if (json)
+    {
+        s.Printf ("{ \"count\": %llu, \"sum\": %llu, \"max\": %llu, \"buckets\": [",
+                  count,
+                  histogram.GetSum(),
+                  histogram.GetMaximum());
+        bool first = true;
+        for (uint32_t i = 0; i < StatisticsHistogram::eNumBuckets; ++i)
+        {
+            const uint64_t bucket_count = histogram.GetBucketCount (i);
+            if (bucket_count == 0)
+                continue;
+            const uint64_t min_value = i == 0 ? 0 : 1ull << (i - 1);
+            s.Printf ("%s { \"min\": %llu, \"count\": %llu }", first ? "" : ",", min_value, bucket_count);
+            first = false;
+        }
+        s.PutCString (" ] }");
+    }
+    else
+    {
+        s.Printf ("count = %llu, sum = %llu, max = %llu", count, histogram.GetSum(), histogram.GetMaximum());
+        for (uint32_t i = 0; i < StatisticsHistogram::eNumBuckets; ++i)
+        {
+            const uint64_t bucket_count = histogram.GetBucketCount (i);
+            if (bucket_count == 0)
+                continue;
+            const uint64_t min_value = i == 0 ? 0 : 1ull << (i - 1);
+            s.EOL();
+            s.Indent();
+            s.Printf ("  [%llu+]: %llu", min_value, bucket_count);
+        }
+    }
+}
+
+void
+Statistics::Dump (Stream &s, bool json)
+{
+    Mutex::Locker locker (GetStatisticsMutex());
+    StatisticsMap &map = GetStatisticsMap();
+
+    // The groups that are open right now, and whether anything has been
+    // put in each of them yet (for JSON commas)
+    std::vector<std::string> open_groups;
+    std::vector<bool> group_has_items (1, false);
+    std::vector<std::string> components;
+
+    if (json)
+        s.PutChar ('{');
+
+    for (StatisticsMap::const_iterator pos = map.begin(), end = map.end(); pos != end; ++pos)
+    {
+        SplitStatisticName (pos->first, components);
+        const size_t num_groups = components.size() - 1;
+
+        // Close the groups this name isn't in
+        size_t num_common = 0;
+        while (num_common < open_groups.size() &&
+               num_common < num_groups &&
+               open_groups[num_common] == components[num_common])
+            ++num_common;
+        while (open_groups.size() > num_common)
+        {
+            open_groups.pop_back();
+            group_has_items.pop_back();
+            s.IndentLess();
+            if (json)
+            {
+                s.EOL();
+                s.Indent ("}");
+            }
+        }
+
+        // Open the ones it is in
+        while (open_groups.size() < num_groups)
+        {
+            const std::string &group = components[open_groups.size()];
+            if (json)
+            {
+                s.PutCString (group_has_items.back() ? ",\n" : "\n");
+                s.Indent();
+                s.Printf ("\"%s\": {", group.c_str());
+            }
+            else
+            {
+                s.Indent();
+                s.Printf ("%s:\n", group.c_str());
+            }
+            group_has_items.back() = true;
+            open_groups.push_back (group);
+            group_has_items.push_back (false);
+            s.IndentMore();
+        }
+
+        const std::string &leaf = components.back();
+        const StatisticsEntry &entry = pos->second;
+        if (json)
+        {
+            s.PutCString (group_has_items.back() ? ",\n" : "\n");
+            s.Indent();
+            s.Printf ("\"%s\": ", leaf.c_str());
+            if (entry.histogram)
+                DumpHistogram (s, *entry.histogram, json);
+            else
+                s.Printf ("%llu", entry.counter->GetValue());
+        }
+        else
+        {
+            s.Indent();
+            s.Printf ("%s: ", leaf.c_str());
+            if (entry.histogram)
+                DumpHistogram (s, *entry.histogram, json);
+            else
+                s.Printf ("%llu", entry.counter->GetValue());
+            s.EOL();
+        }
+        group_has_items.back() = true;
+    }
+
+    while (!open_groups.empty())
+    {
+        open_groups.pop_back();
+        s.IndentLess();
+        if (json)
+        {
+            s.EOL();
+            s.Indent ("}");
+        }
+    }
+
+    if (json)
+        s.PutCString ("\n}\n");
+}
+
+void
+Statistics::Reset ()
+{
+    Mutex::Locker locker (GetStatisticsMutex());
+    StatisticsMap &map = GetStatisticsMap();
+    for (StatisticsMap::iterator pos = map.begin(), end = map.end(); pos != end; ++pos)
+    {
+        if (pos->second.counter)
+            pos->second.counter->Reset();
+        if (pos->second.histogram)
+            pos->second.histogram->Reset();
+    }
+}
@@ -9,11 +9,14 @@
 
 #include "lldb/Core/Stream.h"
 #include "lldb/Host/Endian.h"
+#include "Utility/StringExtractor.h"
 #include <stddef.h>
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
 
+#include <algorithm>
+
 using namespace lldb;
 using namespace lldb_private;
 
@@ -705,8 +708,16 @@ Stream::PutBytesAsRawHex8 (const void *s, size_t src_len, ByteOrder src_byte_ord
     m_flags.Clear(eBinary);
     if (src_byte_order == dst_byte_order)
     {
-        for (size_t i = 0; i < src_len; ++i)
-            bytes_written += _PutHex8 (src[i], false);
+        // Memory and register data going out in packets can be big, so
+        // encode it in chunks instead of a byte at a time
+        char hex_buf[1024];
+        const size_t chunk_len = sizeof(hex_buf) / 2;
+        for (size_t offset = 0; offset < src_len; offset += chunk_len)
+        {
+            const size_t len = std::min<size_t> (chunk_len, src_len - offset);
+            StringExtractor::EncodeHexBytes (src + offset, len, hex_buf);
+            bytes_written += Write (hex_buf, len * 2);
+        }
     }
     else
     {
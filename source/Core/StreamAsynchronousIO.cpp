@@ -38,7 +38,7 @@ StreamAsynchronousIO::Flush ()
         std::auto_ptr<EventDataBytes> data_bytes_ap (new EventDataBytes);
         // Let's swap the bytes to avoid LARGE string copies.
         data_bytes_ap->SwapBytes (m_accumulated_data.GetString());
-        EventSP new_event_sp (new Event (m_broadcast_event_type, data_bytes_ap.release()));
+        EventIntrusiveSP new_event_sp (new Event (m_broadcast_event_type, data_bytes_ap.release()));
         m_broadcaster.BroadcastEvent (new_event_sp);
         m_accumulated_data.Clear();
     }
@@ -0,0 +1,247 @@
+//===-- SymbolPreloader.cpp -------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "lldb/Core/SymbolPreloader.h"
+
+// C Includes
+// C++ Includes
+#include <algorithm>
+#include <deque>
+// Other libraries and framework includes
+// Project includes
+#include "lldb/Core/Log.h"
+#include "lldb/Core/Module.h"
+#include "lldb/Core/ModuleList.h"
+#include "lldb/Host/Condition.h"
+#include "lldb/Host/Host.h"
+#include "lldb/Host/Mutex.h"
+#include "lldb/Host/ThreadPool.h"
+#include "lldb/Host/TimeValue.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+// Never run more than this many preload tasks at once, no matter how
+// many CPUs we have. Preloading is meant to soak up idle time, not
+// compete with the foreground for the whole thread pool.
+#define SYMBOL_PRELOADER_MAX_WORKERS    4
+
+// How long a worker waits before it tries again when the only modules
+// left in the queue are ones that are busy in the foreground.
+#define SYMBOL_PRELOADER_RETRY_USEC     (10 * 1000)
+
+namespace {
+
+struct PreloadRequest
+{
+    ModuleWP module_wp;
+    const void *owner;
+};
+
+struct PreloaderState
+{
+    PreloaderState () :
+        mutex (Mutex::eMutexTypeNormal),
+        condition (),
+        queue (),
+        task_group (NULL),
+        num_tasks (0),
+        terminate (false)
+    {
+    }
+
+    Mutex mutex;
+    Condition condition;
+    std::deque<PreloadRequest> queue;
+    ThreadPool::TaskGroup *task_group;  // Created on the first Enqueue()
+    uint32_t num_tasks;                 // Preload tasks that are queued or running
+    bool terminate;
+};
+
+} // anonymous namespace
+
+static PreloaderState &
+GetPreloaderState ()
+{
+    // Leaked on purpose, preload tasks may still be running when static
+    // destructors run.
+    static PreloaderState *g_state = new PreloaderState();
+    return *g_state;
+}
+
+void
+SymbolPreloader::Enqueue (ModuleList &module_list, const void *owner, bool prioritize)
+{
+    const size_t num_modules = module_list.GetSize();
+    if (num_modules == 0)
+        return;
+
+    PreloaderState &state = GetPreloaderState();
+    Mutex::Locker locker (state.mutex);
+    if (state.terminate)
+        return;
+
+    for (size_t i=0; i<num_modules; ++i)
+    {
+        // Prioritized modules are pushed on the front in reverse so they
+        // keep their order
+        ModuleSP module_sp (module_list.GetModuleAtIndex(prioritize ? num_modules - i - 1 : i));
+        if (!module_sp)
+            continue;
+
+        // Modules are shared between targets, so don't queue the same
+        // module twice.
+        bool already_queued = false;
+        std::deque<PreloadRequest>::iterator pos, end = state.queue.end();
+        for (pos = state.queue.begin(); pos != end; ++pos)
+        {
+            if (pos->module_wp.lock() == module_sp)
+            {
+                already_queued = true;
+                break;
+            }
+        }
+        if (already_queued)
+        {
+            if (!prioritize)
+                continue;
+            state.queue.erase (pos);
+        }
+
+        PreloadRequest request;
+        request.module_wp = module_sp;
+        request.owner = owner;
+        if (prioritize)
+            state.queue.push_front (request);
+        else
+            state.queue.push_back (request);
+    }
+
+    const uint32_t max_workers = std::max<uint32_t> (1, std::min<uint32_t> (Host::GetNumberCPUs() / 2, SYMBOL_PRELOADER_MAX_WORKERS));
+    const uint32_t num_tasks = std::min<uint32_t> (state.queue.size(), max_workers);
+    if (state.task_group == NULL && state.num_tasks < num_tasks)
+        state.task_group = new ThreadPool::TaskGroup (ThreadPool::GetSharedThreadPool());
+    // Each task keeps preloading until the queue is empty, so only add
+    // tasks up to the limit
+    while (state.num_tasks < num_tasks)
+    {
+        state.task_group->AddTask (SymbolPreloader::PreloadTask, &state);
+        ++state.num_tasks;
+    }
+    state.condition.Broadcast();
+}
+
+void
+SymbolPreloader::Cancel (const void *owner)
+{
+    PreloaderState &state = GetPreloaderState();
+    Mutex::Locker locker (state.mutex);
+    std::deque<PreloadRequest>::iterator pos = state.queue.begin();
+    while (pos != state.queue.end())
+    {
+        if (pos->owner == owner)
+            pos = state.queue.erase (pos);
+        else
+            ++pos;
+    }
+}
+
+void
+SymbolPreloader::Terminate ()
+{
+    PreloaderState &state = GetPreloaderState();
+    ThreadPool::TaskGroup *task_group;
+    {
+        Mutex::Locker locker (state.mutex);
+        state.terminate = true;
+        state.queue.clear();
+        task_group = state.task_group;
+        state.task_group = NULL;
+        state.condition.Broadcast();
+    }
+
+    if (task_group)
+    {
+        // Tasks that haven't started are skipped, running ones see
+        // "terminate" and return after the module they are on
+        task_group->Cancel();
+        task_group->Wait();
+        delete task_group;
+    }
+
+    Mutex::Locker locker (state.mutex);
+    state.num_tasks = 0;
+    state.terminate = false;
+}
+
+void
+SymbolPreloader::PreloadTask (void *baton)
+{
+    PreloaderState &state = *(PreloaderState *)baton;
+
+    LogSP log (lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_SYMBOLS));
+    Mutex::Locker locker (state.mutex);
+    while (!state.terminate && !state.queue.empty())
+    {
+        // Find the first module that nobody else is using right now.
+        ModuleSP module_sp;
+        Mutex::Locker module_locker;
+        bool found_busy_module = false;
+        while (!state.queue.empty())
+        {
+            module_sp = state.queue.front().module_wp.lock();
+            if (!module_sp)
+            {
+                // The module went away before we got to it.
+                state.queue.pop_front();
+                continue;
+            }
+            if (module_locker.TryLock (module_sp->GetMutex()))
+            {
+                state.queue.pop_front();
+                break;
+            }
+            if (found_busy_module)
+            {
+                // The modules at the front of the queue are busy in
+                // the foreground, back off and retry later.
+                module_sp.reset();
+                break;
+            }
+            found_busy_module = true;
+            state.queue.push_back (state.queue.front());
+            state.queue.pop_front();
+            module_sp.reset();
+        }
+
+        if (!module_sp)
+        {
+            if (!state.queue.empty())
+            {
+                TimeValue timeout (TimeValue::Now());
+                timeout.OffsetWithMicroSeconds (SYMBOL_PRELOADER_RETRY_USEC);
+                state.condition.Wait (state.mutex, &timeout);
+            }
+            continue;
+        }
+
+        locker.Unlock();
+
+        if (log)
+            module_sp->LogMessage (log.get(), "SymbolPreloader preloading symbols");
+        module_sp->PreloadSymbols ();
+        module_locker.Unlock();
+        module_sp.reset();
+
+        locker.Lock (state.mutex);
+    }
+    // Terminate() resets the count itself
+    if (!state.terminate)
+        --state.num_tasks;
+}
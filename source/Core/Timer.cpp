@@ -9,24 +9,75 @@
 #include "lldb/Core/Timer.h"
 
 #include <map>
+#include <string>
 #include <vector>
 #include <algorithm>
 
+#include "lldb/Core/Error.h"
+#include "lldb/Core/Statistics.h"
 #include "lldb/Core/Stream.h"
+#include "lldb/Core/StreamFile.h"
+#include "lldb/Host/Host.h"
 #include "lldb/Host/Mutex.h"
 
+#include <assert.h>
+#include <stdarg.h>
 #include <stdio.h>
 
 using namespace lldb_private;
 
 #define TIMER_INDENT_AMOUNT 2
 static bool g_quiet = true;
-uint32_t Timer::g_depth = 0;
 uint32_t Timer::g_display_depth = 0;
 FILE * Timer::g_file = NULL;
 typedef std::vector<Timer *> TimerStack;
 typedef std::map<const char *, uint64_t> CategoryMap;
 
+//----------------------------------------------------------------------
+// A timer starting ('B') or stopping ('E') while timers are being
+// recorded with "log timers record".
+//----------------------------------------------------------------------
+struct TimerTraceEvent
+{
+    lldb::tid_t tid;
+    uint64_t nsec;
+    const char *category;
+    std::string name;
+    char phase;
+};
+
+typedef std::vector<TimerTraceEvent> TimerTraceEvents;
+
+// Don't let a runaway recording use up all of memory
+static const size_t g_max_trace_events_per_thread = 1024 * 1024;
+static bool g_recording = false;
+
+//----------------------------------------------------------------------
+// Each thread keeps its own stack of running timers and its own
+// category times, so timers on different threads never wait for each
+// other. The mutex is only ever contended while the times are being
+// dumped or reset.
+//----------------------------------------------------------------------
+struct TimerThreadData
+{
+    TimerThreadData () :
+        tid (Host::GetCurrentThreadID()),
+        stack (),
+        mutex (Mutex::eMutexTypeNormal),
+        category_map (),
+        trace_events ()
+    {
+    }
+
+    lldb::tid_t tid;
+    TimerStack stack;
+    Mutex mutex;
+    CategoryMap category_map;
+    TimerTraceEvents trace_events;
+};
+
+typedef std::vector<TimerThreadData *> TimerThreadDataList;
+
 #ifdef _POSIX_SOURCE
 static pthread_key_t g_key;
 #else
@@ -40,6 +91,7 @@ GetCategoryMutex()
     return g_category_mutex;
 }
 
+// The times of threads that have exited, protected by GetCategoryMutex()
 static CategoryMap &
 GetCategoryMap()
 {
@@ -47,33 +99,62 @@ GetCategoryMap()
     return g_category_map;
 }
 
+// The trace events of threads that have exited, protected by GetCategoryMutex()
+static TimerTraceEvents &
+GetTraceEvents()
+{
+    static TimerTraceEvents g_trace_events;
+    return g_trace_events;
+}
 
-static TimerStack *
-GetTimerStackForCurrentThread ()
+// The threads that have timed something, protected by GetCategoryMutex()
+static TimerThreadDataList &
+GetTimerThreadDataList()
+{
+    static TimerThreadDataList g_thread_data_list;
+    return g_thread_data_list;
+}
+
+static TimerThreadData *
+GetTimerThreadDataForCurrentThread ()
 {
 #ifdef _POSIX_SOURCE
-    void *timer_stack = ::pthread_getspecific (g_key);
-    if (timer_stack == NULL)
-    {
-        ::pthread_setspecific (g_key, new TimerStack);
-        timer_stack = ::pthread_getspecific (g_key);
-    }
-    return (TimerStack *)timer_stack;
+    TimerThreadData *thread_data = (TimerThreadData *)::pthread_getspecific (g_key);
 #else
-    void *timer_stack = ::TlsGetValue  (g_key);
-    if (timer_stack == NULL)
+    TimerThreadData *thread_data = (TimerThreadData *)::TlsGetValue (g_key);
+#endif
+    if (thread_data == NULL)
     {
-        ::TlsSetValue  (g_key, new TimerStack);
-        timer_stack = ::TlsGetValue (g_key);
-    }
-    return (TimerStack *)timer_stack;
+        thread_data = new TimerThreadData;
+#ifdef _POSIX_SOURCE
+        ::pthread_setspecific (g_key, thread_data);
+#else
+        ::TlsSetValue (g_key, thread_data);
 #endif
+        Mutex::Locker locker (GetCategoryMutex());
+        GetTimerThreadDataList().push_back (thread_data);
+    }
+    return thread_data;
 }
 
 void
 ThreadSpecificCleanup (void *p)
 {
-    delete (TimerStack *)p;
+    // Keep the times of the thread that is going away
+    TimerThreadData *thread_data = (TimerThreadData *)p;
+    Mutex::Locker locker (GetCategoryMutex());
+    CategoryMap &category_map = GetCategoryMap();
+    CategoryMap::const_iterator pos, end = thread_data->category_map.end();
+    for (pos = thread_data->category_map.begin(); pos != end; ++pos)
+        category_map[pos->first] += pos->second;
+    if (!thread_data->trace_events.empty())
+    {
+        TimerTraceEvents &trace_events = GetTraceEvents();
+        trace_events.insert (trace_events.end(), thread_data->trace_events.begin(), thread_data->trace_events.end());
+    }
+    TimerThreadDataList &thread_data_list = GetTimerThreadDataList();
+    thread_data_list.erase (std::remove (thread_data_list.begin(), thread_data_list.end(), thread_data), thread_data_list.end());
+    delete thread_data;
 }
 
 void
@@ -98,84 +179,114 @@ Timer::Timer (const char *category, const char *format, ...) :
     m_total_start (),
     m_timer_start (),
     m_total_ticks (0),
-    m_timer_ticks (0)
+    m_timer_ticks (0),
+    m_started (false),
+    m_traced (false)
 {
-    if (g_depth++ < g_display_depth)
+    // This is all a timer costs while timers are disabled
+    const uint32_t display_depth = g_display_depth;
+    if (display_depth == 0)
+        return;
+
+    TimerThreadData *thread_data = GetTimerThreadDataForCurrentThread ();
+    TimerStack &stack = thread_data->stack;
+    const uint32_t depth = stack.size() + 1;
+    if (depth > display_depth)
+        return;
+
+    if (g_quiet == false)
     {
-        if (g_quiet == false)
-        {
-            // Indent
-            ::fprintf (g_file, "%*s", g_depth * TIMER_INDENT_AMOUNT, "");
-            // Print formatted string
-            va_list args;
-            va_start (args, format);
-            ::vfprintf (g_file, format, args);
-            va_end (args);
-
-            // Newline
-            ::fprintf (g_file, "\n");
-        }
-        TimeValue start_time(TimeValue::Now());
-        m_total_start = start_time;
-        m_timer_start = start_time;
-        TimerStack *stack = GetTimerStackForCurrentThread ();
-        if (stack)
-        {
-            if (stack->empty() == false)
-                stack->back()->ChildStarted (start_time);
-            stack->push_back(this);
-        }
+        // Indent
+        ::fprintf (g_file, "%*s", depth * TIMER_INDENT_AMOUNT, "");
+        // Print formatted string
+        va_list args;
+        va_start (args, format);
+        ::vfprintf (g_file, format, args);
+        va_end (args);
+
+        // Newline
+        ::fprintf (g_file, "\n");
+    }
+    if (g_recording && thread_data->trace_events.size() < g_max_trace_events_per_thread)
+    {
+        TimerTraceEvent event;
+        event.tid = thread_data->tid;
+        event.category = m_category;
+        event.phase = 'B';
+        char name[256];
+        va_list args;
+        va_start (args, format);
+        ::vsnprintf (name, sizeof(name), format, args);
+        va_end (args);
+        event.name = name;
+        event.nsec = TimeValue::Now().GetAsNanoSecondsSinceJan1_1970();
+        Mutex::Locker locker (thread_data->mutex);
+        thread_data->trace_events.push_back (event);
+        m_traced = true;
     }
+    TimeValue start_time(TimeValue::Now());
+    m_total_start = start_time;
+    m_timer_start = start_time;
+    if (stack.empty() == false)
+        stack.back()->ChildStarted (start_time);
+    stack.push_back(this);
+    m_started = true;
 }
 
-
-Timer::~Timer()
+void
+Timer::Stop ()
 {
+    m_started = false;
+    TimeValue stop_time = TimeValue::Now();
     if (m_total_start.IsValid())
     {
-        TimeValue stop_time = TimeValue::Now();
-        if (m_total_start.IsValid())
-        {
-            m_total_ticks += (stop_time - m_total_start);
-            m_total_start.Clear();
-        }
-        if (m_timer_start.IsValid())
-        {
-            m_timer_ticks += (stop_time - m_timer_start);
-            m_timer_start.Clear();
-        }
+        m_total_ticks += (stop_time - m_total_start);
+        m_total_start.Clear();
+    }
+    if (m_timer_start.IsValid())
+    {
+        m_timer_ticks += (stop_time - m_timer_start);
+        m_timer_start.Clear();
+    }
 
-        TimerStack *stack = GetTimerStackForCurrentThread ();
-        if (stack)
-        {
-            assert (stack->back() == this);
-            stack->pop_back();
-            if (stack->empty() == false)
-                stack->back()->ChildStopped(stop_time);
-        }
+    TimerThreadData *thread_data = GetTimerThreadDataForCurrentThread ();
+    TimerStack &stack = thread_data->stack;
+    assert (!stack.empty() && stack.back() == this);
+    stack.pop_back();
+    if (stack.empty() == false)
+        stack.back()->ChildStopped(stop_time);
 
-        const uint64_t total_nsec_uint = GetTotalElapsedNanoSeconds();
-        const uint64_t timer_nsec_uint = GetTimerElapsedNanoSeconds();
-        const double total_nsec = total_nsec_uint;
-        const double timer_nsec = timer_nsec_uint;
+    const uint64_t total_nsec_uint = GetTotalElapsedNanoSeconds();
+    const uint64_t timer_nsec_uint = GetTimerElapsedNanoSeconds();
+    const double total_nsec = total_nsec_uint;
+    const double timer_nsec = timer_nsec_uint;
 
-        if (g_quiet == false)
-        {
+    if (g_quiet == false)
+    {
 
-            ::fprintf (g_file,
-                       "%*s%.9f sec (%.9f sec)\n",
-                       (g_depth - 1) *TIMER_INDENT_AMOUNT, "",
-                       total_nsec / 1000000000.0,
-                       timer_nsec / 1000000000.0);
-        }
+        ::fprintf (g_file,
+                   "%*s%.9f sec (%.9f sec)\n",
+                   (int)(stack.size() * TIMER_INDENT_AMOUNT), "",
+                   total_nsec / 1000000000.0,
+                   timer_nsec / 1000000000.0);
+    }
 
-        // Keep total results for each category so we can dump results.
-        Mutex::Locker locker (GetCategoryMutex());
-        CategoryMap &category_map = GetCategoryMap();
-        category_map[m_category] += timer_nsec_uint;
+    // Keep total results for each category so we can dump results.
+    Mutex::Locker locker (thread_data->mutex);
+    thread_data->category_map[m_category] += timer_nsec_uint;
+    if (m_traced)
+    {
+        m_traced = false;
+        if (g_recording)
+        {
+            TimerTraceEvent event;
+            event.tid = thread_data->tid;
+            event.nsec = stop_time.GetAsNanoSecondsSinceJan1_1970();
+            event.category = m_category;
+            event.phase = 'E';
+            thread_data->trace_events.push_back (event);
+        }
     }
-    if (g_depth > 0)
-        --g_depth;
 }
 
 uint64_t
@@ -242,15 +353,33 @@ void
 Timer::ResetCategoryTimes ()
 {
     Mutex::Locker locker (GetCategoryMutex());
-    CategoryMap &category_map = GetCategoryMap();
-    category_map.clear();
+    GetCategoryMap().clear();
+    TimerThreadDataList &thread_data_list = GetTimerThreadDataList();
+    for (TimerThreadDataList::iterator pos = thread_data_list.begin(); pos != thread_data_list.end(); ++pos)
+    {
+        Mutex::Locker thread_locker ((*pos)->mutex);
+        (*pos)->category_map.clear();
+    }
 }
 
 void
 Timer::DumpCategoryTimes (Stream *s)
 {
-    Mutex::Locker locker (GetCategoryMutex());
-    CategoryMap &category_map = GetCategoryMap();
+    // Add up the times of the threads that exited and of each running thread
+    CategoryMap category_map;
+    {
+        Mutex::Locker locker (GetCategoryMutex());
+        category_map = GetCategoryMap();
+        TimerThreadDataList &thread_data_list = GetTimerThreadDataList();
+        for (TimerThreadDataList::iterator thread_pos = thread_data_list.begin(); thread_pos != thread_data_list.end(); ++thread_pos)
+        {
+            Mutex::Locker thread_locker ((*thread_pos)->mutex);
+            CategoryMap::const_iterator pos, end = (*thread_pos)->category_map.end();
+            for (pos = (*thread_pos)->category_map.begin(); pos != end; ++pos)
+                category_map[pos->first] += pos->second;
+        }
+    }
+
     std::vector<CategoryMap::const_iterator> sorted_iterators;
     CategoryMap::const_iterator pos, end = category_map.end();
     for (pos = category_map.begin(); pos != end; ++pos)
@@ -266,3 +395,148 @@ Timer::DumpCategoryTimes (Stream *s)
         s->Printf("%.9f sec for %s\n", timer_nsec / 1000000000.0, sorted_iterators[i]->first);
     }
 }
+
+//----------------------------------------------------------------------
+// Timer recording
+//----------------------------------------------------------------------
+static std::string g_recording_path;
+static uint32_t g_recording_saved_display_depth = 0;
+static uint64_t g_recording_start_nsec = 0;
+
+static void
+PutJSONString (Stream &s, const char *cstr)
+{
+    s.PutChar ('"');
+    if (cstr)
+    {
+        for (const char *p = cstr; *p; ++p)
+        {
+            const unsigned char ch = *p;
+            if (ch == '"' || ch == '\\')
+                s.Printf ("\\%c", ch);
+            else if (ch < 0x20)
+                s.Printf ("\\u%4.4x", ch);
+            else
+                s.PutChar (ch);
+        }
+    }
+    s.PutChar ('"');
+}
+
+Error
+Timer::StartRecording (const char *path)
+{
+    Error error;
+    if (path == NULL || path[0] == '\0')
+    {
+        error.SetErrorString ("a trace file path is required");
+        return error;
+    }
+
+    // Make sure the file can be written before timing anything
+    {
+        StreamFile trace_file (path);
+        if (!trace_file.GetFile().IsValid())
+        {
+            error.SetErrorStringWithFormat ("unable to open '%s' for writing", path);
+            return error;
+        }
+    }
+
+    Mutex::Locker locker (GetCategoryMutex());
+    if (g_recording)
+    {
+        error.SetErrorStringWithFormat ("timers are already being recorded to '%s'", g_recording_path.c_str());
+        return error;
+    }
+    GetTraceEvents().clear();
+    TimerThreadDataList &thread_data_list = GetTimerThreadDataList();
+    for (TimerThreadDataList::iterator pos = thread_data_list.begin(); pos != thread_data_list.end(); ++pos)
+    {
+        Mutex::Locker thread_locker ((*pos)->mutex);
+        (*pos)->trace_events.clear();
+    }
+    g_recording_path = path;
+    g_recording_start_nsec = TimeValue::Now().GetAsNanoSecondsSinceJan1_1970();
+    // Timers have to be running to be recorded
+    g_recording_saved_display_depth = g_display_depth;
+    g_display_depth = UINT32_MAX;
+    g_recording = true;
+    return error;
+}
+
+bool
+Timer::IsRecording ()
+{
+    return g_recording;
+}
+
+Error
+Timer::StopRecording (size_t &num_events)
+{
+    Error error;
+    num_events = 0;
+
+    // Gather the events of all threads
+    TimerTraceEvents trace_events;
+    std::string path;
+    {
+        Mutex::Locker locker (GetCategoryMutex());
+        if (!g_recording)
+        {
+            error.SetErrorString ("timers aren't being recorded");
+            return error;
+        }
+        g_recording = false;
+        g_display_depth = g_recording_saved_display_depth;
+        path.swap (g_recording_path);
+        trace_events.swap (GetTraceEvents());
+        TimerThreadDataList &thread_data_list = GetTimerThreadDataList();
+        for (TimerThreadDataList::iterator pos = thread_data_list.begin(); pos != thread_data_list.end(); ++pos)
+        {
+            Mutex::Locker thread_locker ((*pos)->mutex);
+            trace_events.insert (trace_events.end(), (*pos)->trace_events.begin(), (*pos)->trace_events.end());
+            TimerTraceEvents().swap ((*pos)->trace_events);
+        }
+    }
+
+    StreamFile trace_file (path.c_str());
+    if (!trace_file.GetFile().IsValid())
+    {
+        error.SetErrorStringWithFormat ("unable to open '%s' for writing", path.c_str());
+        return error;
+    }
+
+    // Write the events in the Chrome trace event format, which
+    // chrome://tracing and flame graph tools can load. The events of each
+    // thread are already in order, the viewers sort the threads out.
+    const lldb::pid_t pid = Host::GetCurrentProcessID();
+    trace_file.PutCString ("{\n\"traceEvents\": [");
+    const size_t count = trace_events.size();
+    for (size_t i = 0; i < count; ++i)
+    {
+        const TimerTraceEvent &event = trace_events[i];
+        const uint64_t nsec = event.nsec > g_recording_start_nsec ? event.nsec - g_recording_start_nsec : 0;
+        trace_file.Printf ("%s\n{ \"ph\": \"%c\", \"pid\": %llu, \"tid\": %llu, \"ts\": %llu.%3.3llu",
+                           i == 0 ? "" : ",",
+                           event.phase,
+                           (uint64_t)pid,
+                           (uint64_t)event.tid,
+                           nsec / 1000,
+                           nsec % 1000);
+        if (event.phase == 'B')
+        {
+            trace_file.PutCString (", \"name\": ");
+            PutJSONString (trace_file, event.name.c_str());
+            trace_file.PutCString (", \"cat\": ");
+            PutJSONString (trace_file, event.category);
+        }
+        trace_file.PutCString (" }");
+    }
+    trace_file.PutCString ("\n],\n\"displayTimeUnit\": \"ms\",\n\"statistics\": ");
+    // The counters, so the trace shows how much work went with the time
+    Statistics::Dump (trace_file, true);
+    trace_file.PutCString ("}\n");
+    num_events = count;
+    return error;
+}
@@ -18,6 +18,7 @@
 #include "clang/AST/Type.h"
 
 // Project includes
+#include "lldb/Core/AsyncOperation.h"
 #include "lldb/Core/DataBufferHeap.h"
 #include "lldb/Core/DataVisualization.h"
 #include "lldb/Core/Debugger.h"
@@ -56,6 +57,19 @@ using namespace lldb_utility;
 
 static user_id_t g_value_obj_uid = 0;
 
+// 64 bit FNV-1a of the bytes of a value
+static uint64_t
+HashBytes (const uint8_t *bytes, size_t length)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i=0; i<length; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
 //----------------------------------------------------------------------
 // ValueObject constructor
 //----------------------------------------------------------------------
@@ -73,7 +87,7 @@ ValueObject::ValueObject (ValueObject &parent) :
     m_summary_str (),
     m_object_desc_str (),
     m_manager(parent.GetManager()),
-    m_children (),
+    m_children (m_manager->GetClusterMutex()),
     m_synthetic_children (),
     m_dynamic_value (NULL),
     m_synthetic_value(NULL),
@@ -86,10 +100,18 @@ ValueObject::ValueObject (ValueObject &parent) :
     m_synthetic_children_sp(),
     m_user_id_of_forced_summary(),
     m_address_type_of_ptr_or_ref_children(eAddressTypeInvalid),
+    m_cached_summary_format(NULL),
+    m_cached_summary_format_mgr_revision(0),
+    m_cached_summary_stop_id(0),
+    m_cached_summary_memory_id(0),
+    m_cached_summary_data(),
+    m_cached_summary_str(),
+    m_data_hash(0),
     m_value_is_valid (false),
     m_value_did_change (false),
     m_children_count_valid (false),
     m_old_value_valid (false),
+    m_data_hash_valid (false),
     m_is_deref_of_parent (false),
     m_is_array_item_for_pointer(false),
     m_is_bitfield_for_scalar(false),
@@ -118,8 +140,8 @@ ValueObject::ValueObject (ExecutionContextScope *exe_scope,
     m_location_str (),
     m_summary_str (),
     m_object_desc_str (),
-    m_manager(),
-    m_children (),
+    m_manager(new ValueObjectManager()),
+    m_children (m_manager->GetClusterMutex()),
     m_synthetic_children (),
     m_dynamic_value (NULL),
     m_synthetic_value(NULL),
@@ -132,10 +154,18 @@ ValueObject::ValueObject (ExecutionContextScope *exe_scope,
     m_synthetic_children_sp(),
     m_user_id_of_forced_summary(),
     m_address_type_of_ptr_or_ref_children(child_ptr_or_ref_addr_type),
+    m_cached_summary_format(NULL),
+    m_cached_summary_format_mgr_revision(0),
+    m_cached_summary_stop_id(0),
+    m_cached_summary_memory_id(0),
+    m_cached_summary_data(),
+    m_cached_summary_str(),
+    m_data_hash(0),
     m_value_is_valid (false),
     m_value_did_change (false),
     m_children_count_valid (false),
     m_old_value_valid (false),
+    m_data_hash_valid (false),
     m_is_deref_of_parent (false),
     m_is_array_item_for_pointer(false),
     m_is_bitfield_for_scalar(false),
@@ -144,7 +174,6 @@ ValueObject::ValueObject (ExecutionContextScope *exe_scope,
     m_is_getting_summary(false),
     m_did_calculate_complete_objc_class_type(false)
 {
-    m_manager = new ValueObjectManager();
     m_manager->ManageObject (this);
 }
 
@@ -188,6 +217,14 @@ ValueObject::UpdateValueIfNeeded (DynamicValueType use_dynamic, bool update_form
     
     if (m_update_point.NeedsUpdating())
     {
+        // Leave the value stale rather than half updated, so whoever
+        // asks next will do the update
+        if (AsyncOperation::ShouldCancel())
+        {
+            m_error.SetErrorString ("operation was cancelled");
+            return false;
+        }
+
         m_update_point.SetUpdated();
         
         // Save the old value using swap to avoid a string copy which
@@ -203,6 +240,16 @@ ValueObject::UpdateValueIfNeeded (DynamicValueType use_dynamic, bool update_form
             ClearUserVisibleData(eClearUserVisibleDataItemsValue);
         }
 
+        // Hold on to the strings that were made from the old bytes until
+        // we know whether the bytes changed
+        std::string old_summary_str;
+        std::string old_object_desc_str;
+        old_summary_str.swap (m_summary_str);
+        old_object_desc_str.swap (m_object_desc_str);
+        const bool had_data_hash = m_data_hash_valid;
+        const uint64_t old_data_hash = m_data_hash;
+        m_data_hash_valid = false;
+
         ClearUserVisibleData();
         
         if (IsInScope())
@@ -217,6 +264,16 @@ ValueObject::UpdateValueIfNeeded (DynamicValueType use_dynamic, bool update_form
             
             SetValueIsValid (success);
             
+            if (success)
+            {
+                const size_t byte_size = m_data.GetByteSize();
+                if (byte_size > 0)
+                {
+                    m_data_hash = HashBytes (m_data.GetDataStart(), byte_size);
+                    m_data_hash_valid = true;
+                }
+            }
+            
             if (first_update)
                 SetValueDidChange (false);
             else if (!m_value_did_change && success == false)
@@ -225,6 +282,19 @@ ValueObject::UpdateValueIfNeeded (DynamicValueType use_dynamic, bool update_form
                 // as changed if the value used to be valid and now isn't
                 SetValueDidChange (value_was_valid);
             }
+            else if (success &&
+                     had_data_hash &&
+                     m_data_hash_valid &&
+                     m_data_hash == old_data_hash &&
+                     DisplayDependsOnlyOnData())
+            {
+                // Same bytes as last time, so the strings we made from
+                // them don't need to be formatted again
+                if (m_old_value_valid)
+                    m_value_str = m_old_value_str;
+                m_summary_str.swap (old_summary_str);
+                m_object_desc_str.swap (old_object_desc_str);
+            }
         }
         else
         {
@@ -234,6 +304,39 @@ ValueObject::UpdateValueIfNeeded (DynamicValueType use_dynamic, bool update_form
     return m_error.Success();
 }
 
+bool
+ValueObject::DisplayDependsOnlyOnData ()
+{
+    // Pointers and references show what they point to, and summaries
+    // of aggregates can follow the pointers inside them or run code
+    // that looks anywhere, so only values that can't have children
+    // are safe to keep
+    clang_type_t clang_type = GetClangType();
+    if (clang_type == NULL)
+        return false;
+    const Flags type_flags (ClangASTContext::GetTypeInfo (clang_type, GetClangAST(), NULL));
+    if (type_flags.AnySet (ClangASTContext::eTypeIsPointer |
+                           ClangASTContext::eTypeIsReference |
+                           ClangASTContext::eTypeIsObjC |
+                           ClangASTContext::eTypeIsBlock))
+        return false;
+    if (type_flags.Test (ClangASTContext::eTypeHasChildren))
+        return !m_type_summary_sp && !m_synthetic_children_sp;
+    return true;
+}
+
+bool
+ValueObject::GetLastLoadAddressRange (addr_t &load_addr, size_t &byte_size) const
+{
+    // m_value still holds where the value was found the last time it
+    // was updated
+    if (m_value.GetValueType() != Value::eValueTypeLoadAddress)
+        return false;
+    load_addr = m_value.GetScalar().ULongLong(LLDB_INVALID_ADDRESS);
+    byte_size = m_data.GetByteSize();
+    return load_addr != LLDB_INVALID_ADDRESS && byte_size > 0;
+}
+
 bool
 ValueObject::UpdateFormatsIfNeeded(DynamicValueType use_dynamic)
 {
@@ -508,6 +611,9 @@ ValueObject::GetChildAtIndex (uint32_t idx, bool can_create)
         // Check if we have already made the child value object?
         if (can_create && !m_children.HasChildAtIndex(idx))
         {
+            if (AsyncOperation::ShouldCancel())
+                return child_sp;
+
             // No we haven't created the child at this index, so lets have our
             // subclass do it and cache the result for quick future access.
             m_children.SetChildAtIndex(idx,CreateChildAtIndex (idx, false, 0));
@@ -585,6 +691,23 @@ ValueObject::GetNumChildren ()
     }
     return m_children.GetChildrenCount();
 }
+
+uint32_t
+ValueObject::GetNumChildren (uint32_t max)
+{
+    UpdateValueIfNeeded();
+    if (!m_children_count_valid)
+    {
+        const uint32_t num_children = CalculateNumChildrenUpTo (max);
+        // Only a count below the limit is known to be the real one
+        if (num_children < max)
+            SetNumChildren (num_children);
+        return num_children;
+    }
+    const uint32_t num_children = m_children.GetChildrenCount();
+    return num_children < max ? num_children : max;
+}
+
 void
 ValueObject::SetNumChildren (uint32_t num_children)
 {
@@ -686,9 +809,39 @@ ValueObject::GetSummaryAsCString (TypeSummaryImpl* summary_ptr,
     {
         if (summary_ptr)
         {
-            if (HasSyntheticValue())
-                m_synthetic_value->UpdateValueIfNeeded(); // the summary might depend on the synthetic children being up-to-date (e.g. ${svar%#})
-            summary_ptr->FormatObject(this, destination);
+            // Summary strings are cheap enough to format every time, the
+            // others can run Python or expressions so reuse their last
+            // result if nothing they could look at has changed
+            uint32_t natural_stop_id = 0;
+            uint32_t memory_id = 0;
+            std::string data;
+            const bool cacheable = summary_ptr->GetType() != TypeSummaryImpl::eTypeString &&
+                                   summary_ptr->IsCacheable() &&
+                                   GetFormatterCacheKey (natural_stop_id, memory_id, data);
+            if (cacheable &&
+                m_cached_summary_format == summary_ptr &&
+                m_cached_summary_format_mgr_revision == DataVisualization::GetCurrentRevision() &&
+                m_cached_summary_stop_id == natural_stop_id &&
+                m_cached_summary_memory_id == memory_id &&
+                m_cached_summary_data == data)
+            {
+                destination = m_cached_summary_str;
+            }
+            else
+            {
+                if (HasSyntheticValue())
+                    m_synthetic_value->UpdateValueIfNeeded(); // the summary might depend on the synthetic children being up-to-date (e.g. ${svar%#})
+                summary_ptr->FormatObject(this, destination);
+                if (cacheable)
+                {
+                    m_cached_summary_format = summary_ptr;
+                    m_cached_summary_format_mgr_revision = DataVisualization::GetCurrentRevision();
+                    m_cached_summary_stop_id = natural_stop_id;
+                    m_cached_summary_memory_id = memory_id;
+                    m_cached_summary_data.swap (data);
+                    m_cached_summary_str = destination;
+                }
+            }
         }
         else
         {
@@ -752,6 +905,23 @@ ValueObject::GetSummaryAsCString (TypeSummaryImpl* summary_ptr,
     return !destination.empty();
 }
 
+bool
+ValueObject::GetFormatterCacheKey (uint32_t &natural_stop_id,
+                                   uint32_t &memory_id,
+                                   std::string &data)
+{
+    const size_t byte_size = m_data.GetByteSize();
+    if (byte_size == 0)
+        return false;
+    ProcessSP process_sp (GetProcessSP());
+    if (!process_sp)
+        return false;
+    natural_stop_id = process_sp->GetModIDRef().GetNaturalStopID();
+    memory_id = process_sp->GetModIDRef().GetMemoryID();
+    data.assign ((const char *)m_data.GetDataStart(), byte_size);
+    return true;
+}
+
 const char *
 ValueObject::GetSummaryAsCString ()
 {
@@ -1007,6 +1177,34 @@ ValueObject::ReadPointedString (Stream& s,
                         s << '"';
                     }
                 }
+                else if (cstr_address_type == eAddressTypeLoad && exe_ctx.GetProcessPtr())
+                {
+                    // The string is in the process, read it with as few
+                    // reads as we can instead of a small chunk at a time
+                    Error read_error;
+                    std::string cstr;
+                    exe_ctx.GetProcessPtr()->ReadCStringFromMemory (cstr_address, cstr, max_length, read_error);
+                    if (!cstr.empty() || read_error.Success())
+                    {
+                        s << '"';
+                        if (!cstr.empty())
+                        {
+                            data.SetData (cstr.data(), cstr.size(), target->GetArchitecture().GetByteOrder());
+                            data.Dump (&s,
+                                       0,                 // Start offset in "data"
+                                       item_format,
+                                       1,                 // Size of item (1 byte for a char!)
+                                       cstr.size(),       // How many bytes to print?
+                                       UINT32_MAX,        // num per line
+                                       LLDB_INVALID_ADDRESS,// base address
+                                       0,                 // bitfield bit size
+                                       0);                // bitfield bit offset
+                        }
+                        s << '"';
+                        if (cstr.size() >= max_length)
+                            s << "...";
+                    }
+                }
                 else
                 {
                     cstr_len = max_length;
@@ -3360,7 +3558,16 @@ DumpValueObject_Impl (Stream &s,
                     ValueObjectSP synth_valobj_sp = valobj->GetSyntheticValue (options.m_use_synthetic);
                     synth_valobj = (synth_valobj_sp ? synth_valobj_sp.get() : valobj);
                     
-                    uint32_t num_children = synth_valobj->GetNumChildren();
+                    TargetSP target_sp (valobj->GetTargetSP());
+                    uint32_t max_num_children = target_sp ? target_sp->GetMaximumNumberOfChildrenToDisplay() : UINT32_MAX;
+                    
+                    // We only need to know whether there are more children
+                    // than we are going to show, not how many more.
+                    uint32_t num_children;
+                    if (options.m_ignore_cap || max_num_children == UINT32_MAX)
+                        num_children = synth_valobj->GetNumChildren();
+                    else
+                        num_children = synth_valobj->GetNumChildren(max_num_children + 1);
                     bool print_dotdotdot = false;
                     if (num_children)
                     {
@@ -3376,8 +3583,6 @@ DumpValueObject_Impl (Stream &s,
                             s.IndentMore();
                         }
                         
-                        uint32_t max_num_children = valobj->GetTargetSP()->GetMaximumNumberOfChildrenToDisplay();
-                        
                         if (num_children > max_num_children && !options.m_ignore_cap)
                         {
                             num_children = max_num_children;
@@ -3466,6 +3671,18 @@ ValueObject::LogValueObject (Log *log,
     }
 }
 
+static CommandInterpreter *
+GetCommandInterpreterForValueObject (ValueObject *valobj)
+{
+    if (valobj)
+    {
+        TargetSP target_sp (valobj->GetTargetSP());
+        if (target_sp)
+            return &target_sp->GetDebugger().GetCommandInterpreter();
+    }
+    return NULL;
+}
+
 void
 ValueObject::DumpValueObject (Stream &s,
                               ValueObject *valobj)
@@ -3474,6 +3691,7 @@ ValueObject::DumpValueObject (Stream &s,
     if (!valobj)
         return;
     
+    ScriptInterpreter::Batch script_batch (GetCommandInterpreterForValueObject (valobj));
     DumpValueObject_Impl(s,
                          valobj,
                          DumpValueObjectOptions::DefaultOptions(),
@@ -3486,6 +3704,9 @@ ValueObject::DumpValueObject (Stream &s,
                               ValueObject *valobj,
                               const DumpValueObjectOptions& options)
 {
+    // The summaries and synthetic children of the whole tree share one
+    // trip into the script interpreter
+    ScriptInterpreter::Batch script_batch (GetCommandInterpreterForValueObject (valobj));
     DumpValueObject_Impl(s,
                          valobj,
                          options,
@@ -9,9 +9,12 @@
 
 #include "lldb/Core/ValueObjectChild.h"
 
+#include <algorithm>
+
 #include "lldb/Core/Module.h"
 #include "lldb/Core/ValueObjectList.h"
 
+#include "lldb/Symbol/ClangASTContext.h"
 #include "lldb/Symbol/ClangASTType.h"
 #include "lldb/Symbol/ObjectFile.h"
 #include "lldb/Symbol/SymbolContext.h"
@@ -24,6 +27,10 @@
 
 using namespace lldb_private;
 
+// The most bytes of a pointer's pointee we read ahead when the first of
+// its children is updated
+#define MAX_POINTEE_PREFETCH_SIZE   (16 * 1024)
+
 ValueObjectChild::ValueObjectChild
 (
     ValueObject &parent,
@@ -146,6 +153,11 @@ ValueObjectChild::UpdateValue ()
                     m_value.GetScalar() += m_byte_offset;
                     AddressType addr_type = parent->GetAddressTypeOfChildren();
                     
+                    // The rest of the pointee's children are usually asked
+                    // for right after the first one, read all of them now.
+                    if (m_byte_offset == 0 && addr_type == eAddressTypeLoad)
+                        PrefetchPointee (*parent, addr);
+                    
                     switch (addr_type)
                     {
                         case eAddressTypeFile:
@@ -207,7 +219,7 @@ ValueObjectChild::UpdateValue ()
                 }
             }
 
-            if (m_error.Success())
+            if (m_error.Success() && !GetDataFromParent (*parent))
             {
                 ExecutionContext exe_ctx (GetExecutionContextRef().Lock());
                 m_error = m_value.GetValueAsData (&exe_ctx, GetClangAST (), m_data, 0, GetModule().get());
@@ -232,3 +244,65 @@ ValueObjectChild::IsInScope ()
 {
     return m_parent->IsInScope ();
 }
+
+//----------------------------------------------------------------------
+// A parent that lives in memory has already read all of its bytes into
+// its data, so share our slice of them instead of reading them again.
+//----------------------------------------------------------------------
+bool
+ValueObjectChild::GetDataFromParent (ValueObject &parent)
+{
+    if (ClangASTContext::IsPointerOrReferenceType (parent.GetClangType()))
+        return false;
+
+    switch (parent.GetValue().GetValueType())
+    {
+    case Value::eValueTypeLoadAddress:
+    case Value::eValueTypeFileAddress:
+    case Value::eValueTypeHostAddress:
+        break;
+    default:
+        return false;
+    }
+
+    if (m_byte_offset < 0)
+        return false;
+
+    Error error;
+    const uint32_t byte_size = m_value.GetValueByteSize (GetClangAST(), &error);
+    if (error.Fail() || byte_size == 0)
+        return false;
+
+    DataExtractor &parent_data = parent.GetDataExtractor();
+    if (!parent_data.GetSharedDataBuffer() ||
+        !parent_data.ValidOffsetForDataOfSize (m_byte_offset, byte_size))
+        return false;
+
+    m_data.SetByteOrder (parent_data.GetByteOrder());
+    m_data.SetData (parent_data, m_byte_offset, byte_size);
+    return m_data.GetByteSize() == byte_size;
+}
+
+void
+ValueObjectChild::PrefetchPointee (ValueObject &parent, lldb::addr_t addr)
+{
+    lldb::ProcessSP process_sp (GetProcessSP());
+    if (!process_sp)
+        return;
+
+    clang::ASTContext *ast = parent.GetClangAST();
+    lldb::clang_type_t pointee_type = ClangASTType::GetPointeeType (parent.GetClangType());
+    if (!ast || !pointee_type)
+        return;
+
+    // Objective-C objects aren't laid out the way their clang type says
+    const uint32_t type_info = ClangASTContext::GetTypeInfo (pointee_type, ast, NULL);
+    if ((type_info & ClangASTContext::eTypeIsObjC) ||
+        !(type_info & (ClangASTContext::eTypeIsStructUnion | ClangASTContext::eTypeIsClass)) ||
+        !ClangASTContext::IsCompleteType (ast, pointee_type))
+        return;
+
+    const uint32_t pointee_byte_size = ClangASTType::GetTypeByteSize (ast, pointee_type);
+    if (pointee_byte_size > 0)
+        process_sp->PrefetchMemory (addr, std::min<uint32_t> (pointee_byte_size, MAX_POINTEE_PREFETCH_SIZE));
+}
@@ -55,7 +55,8 @@ ValueObjectConstResult::ValueObjectConstResult
     m_clang_ast (NULL),
     m_type_name (),
     m_byte_size (0),
-    m_impl(this, address)
+    m_impl(this, address),
+    m_scratch_ast_context_sp ()
 {
     SetIsConstant ();
     SetValueIsValid(true);
@@ -96,8 +97,10 @@ ValueObjectConstResult::ValueObjectConstResult
     m_clang_ast (clang_ast),
     m_type_name (),
     m_byte_size (0),
-    m_impl(this, address)
+    m_impl(this, address),
+    m_scratch_ast_context_sp ()
 {
+    RetainScratchClangASTContext ();
     m_data = data;
     
     if (!m_data.GetSharedDataBuffer())
@@ -162,8 +165,10 @@ ValueObjectConstResult::ValueObjectConstResult
     m_clang_ast (clang_ast),
     m_type_name (),
     m_byte_size (0),
-    m_impl(this, address)
+    m_impl(this, address),
+    m_scratch_ast_context_sp ()
 {
+    RetainScratchClangASTContext ();
     m_data.SetByteOrder(data_byte_order);
     m_data.SetAddressByteSize(data_addr_size);
     m_data.SetData(data_sp);
@@ -211,8 +216,10 @@ ValueObjectConstResult::ValueObjectConstResult
     m_clang_ast (clang_ast),
     m_type_name (),
     m_byte_size (0),
-    m_impl(this, address)
+    m_impl(this, address),
+    m_scratch_ast_context_sp ()
 {
+    RetainScratchClangASTContext ();
     m_value.GetScalar() = address;
     m_data.SetAddressByteSize(addr_byte_size);
     m_value.GetScalar().GetData (m_data, addr_byte_size);
@@ -250,7 +257,8 @@ ValueObjectConstResult::ValueObjectConstResult (
     m_clang_ast (NULL),
     m_type_name (),
     m_byte_size (0),
-    m_impl(this)
+    m_impl(this),
+    m_scratch_ast_context_sp ()
 {
     m_error = error;
     SetIsConstant ();
@@ -265,8 +273,10 @@ ValueObjectConstResult::ValueObjectConstResult (
     m_clang_ast (clang_ast),
     m_type_name (),
     m_byte_size (0),
-    m_impl(this)
+    m_impl(this),
+    m_scratch_ast_context_sp ()
 {
+    RetainScratchClangASTContext ();
     m_value = value;
     m_value.GetData(m_data);
 }
@@ -275,6 +285,17 @@ ValueObjectConstResult::~ValueObjectConstResult()
 {
 }
 
+void
+ValueObjectConstResult::RetainScratchClangASTContext ()
+{
+    // The scratch AST context can be replaced by a new one when it gets
+    // too big, hold on to it so it isn't freed while this value is around
+    m_scratch_ast_context_sp.reset();
+    TargetSP target_sp (GetTargetSP());
+    if (target_sp)
+        m_scratch_ast_context_sp = target_sp->GetScratchClangASTContextSP (m_clang_ast);
+}
+
 lldb::clang_type_t
 ValueObjectConstResult::GetClangTypeImpl()
 {
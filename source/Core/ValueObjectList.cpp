@@ -13,10 +13,13 @@
 // C++ Includes
 // Other libraries and framework includes
 // Project includes
+#include "lldb/Core/Flags.h"
 #include "lldb/Core/ValueObjectChild.h"
 #include "lldb/Core/ValueObjectRegister.h"
 #include "lldb/Core/ValueObjectVariable.h"
+#include "lldb/Symbol/ClangASTContext.h"
 #include "lldb/Target/ExecutionContext.h"
+#include "lldb/Target/Memory.h"
 #include "lldb/Target/Process.h"
 
 using namespace lldb;
@@ -164,3 +167,87 @@ ValueObjectList::Swap (ValueObjectList &value_object_list)
 {
     m_value_objects.swap (value_object_list.m_value_objects);
 }
+
+void
+ValueObjectList::PrefetchMemory ()
+{
+    ProcessSP process_sp;
+    std::vector<MemoryReadRange> ranges;
+    size_t total_byte_size = 0;
+    collection::iterator pos, end = m_value_objects.end();
+    for (pos = m_value_objects.begin(); pos != end; ++pos)
+    {
+        ValueObject *valobj = (*pos).get();
+        if (valobj == NULL)
+            continue;
+        MemoryReadRange range;
+        if (!valobj->GetLastLoadAddressRange (range.addr, range.size))
+            continue;
+        if (!process_sp)
+            process_sp = valobj->GetProcessSP();
+        range.buf = NULL;
+        range.bytes_read = 0;
+        ranges.push_back (range);
+        total_byte_size += range.size;
+    }
+    
+    if (!process_sp || ranges.empty())
+        return;
+    
+    // The bytes are thrown away, what we want is the process' memory
+    // cache filled in so the updates don't each go to the process
+    std::vector<uint8_t> bytes (total_byte_size);
+    size_t offset = 0;
+    for (size_t i=0; i<ranges.size(); ++i)
+    {
+        ranges[i].buf = &bytes[offset];
+        offset += ranges[i].size;
+    }
+    Error error;
+    process_sp->ReadMemoryRanges (&ranges[0], ranges.size(), error);
+}
+
+// How much of each string PrefetchPointedStrings() reads, the memory
+// cache reads the whole cache line anyway
+#define POINTED_STRING_PREFETCH_SIZE 64
+
+void
+ValueObjectList::PrefetchPointedStrings ()
+{
+    ProcessSP process_sp;
+    std::vector<MemoryReadRange> ranges;
+    collection::iterator pos, end = m_value_objects.end();
+    for (pos = m_value_objects.begin(); pos != end; ++pos)
+    {
+        ValueObject *valobj = (*pos).get();
+        if (valobj == NULL)
+            continue;
+        clang_type_t pointee_clang_type = NULL;
+        const Flags type_flags (ClangASTContext::GetTypeInfo (valobj->GetClangType(),
+                                                              valobj->GetClangAST(),
+                                                              &pointee_clang_type));
+        if (!type_flags.Test (ClangASTContext::eTypeIsPointer) || !ClangASTContext::IsCharType (pointee_clang_type))
+            continue;
+        AddressType address_type = eAddressTypeInvalid;
+        const addr_t cstr_address = valobj->GetPointerValue (&address_type);
+        if (address_type != eAddressTypeLoad || cstr_address == 0 || cstr_address == LLDB_INVALID_ADDRESS)
+            continue;
+        if (!process_sp)
+            process_sp = valobj->GetProcessSP();
+        MemoryReadRange range;
+        range.addr = cstr_address;
+        range.size = POINTED_STRING_PREFETCH_SIZE;
+        range.buf = NULL;
+        range.bytes_read = 0;
+        ranges.push_back (range);
+    }
+
+    if (!process_sp || ranges.empty())
+        return;
+
+    std::vector<uint8_t> bytes (ranges.size() * POINTED_STRING_PREFETCH_SIZE);
+    for (size_t i=0; i<ranges.size(); ++i)
+        ranges[i].buf = &bytes[i * POINTED_STRING_PREFETCH_SIZE];
+    Error error;
+    process_sp->ReadMemoryRanges (&ranges[0], ranges.size(), error);
+}
@@ -25,7 +25,11 @@ ValueObjectSynthetic::ValueObjectSynthetic (ValueObject &parent, lldb::Synthetic
     m_synth_filter_ap(filter->GetFrontEnd(parent)),
     m_children_byindex(),
     m_name_toindex(),
-    m_synthetic_children_count(UINT32_MAX)
+    m_synthetic_children_count(UINT32_MAX),
+    m_update_key_valid(false),
+    m_update_stop_id(0),
+    m_update_memory_id(0),
+    m_update_parent_data()
 {
 #ifdef LLDB_CONFIGURATION_DEBUG
     std::string new_name(parent.GetName().AsCString());
@@ -61,6 +65,18 @@ ValueObjectSynthetic::CalculateNumChildren()
     return (m_synthetic_children_count = m_synth_filter_ap->CalculateNumChildren());
 }
 
+uint32_t
+ValueObjectSynthetic::CalculateNumChildrenUpTo (uint32_t max)
+{
+    UpdateValueIfNeeded();
+    if (m_synthetic_children_count < UINT32_MAX)
+        return m_synthetic_children_count < max ? m_synthetic_children_count : max;
+    const uint32_t num_children = m_synth_filter_ap->CalculateNumChildrenUpTo(max);
+    if (num_children < max)
+        m_synthetic_children_count = num_children;
+    return num_children;
+}
+
 clang::ASTContext *
 ValueObjectSynthetic::GetClangASTImpl ()
 {
@@ -93,6 +109,28 @@ ValueObjectSynthetic::UpdateValue ()
         return false;
     }
 
+    // a cacheable backend gives the same children as long as our parent
+    // and the memory it may point to didn't change, so don't run it again
+    // just because an expression was run
+    uint32_t natural_stop_id = 0;
+    uint32_t memory_id = 0;
+    std::string parent_data;
+    const bool cacheable = m_synth_sp->IsCacheable() &&
+                           m_parent->GetFormatterCacheKey (natural_stop_id, memory_id, parent_data);
+    if (cacheable &&
+        m_update_key_valid &&
+        m_update_stop_id == natural_stop_id &&
+        m_update_memory_id == memory_id &&
+        m_update_parent_data == parent_data)
+    {
+        SetValueIsValid(true);
+        return true;
+    }
+    m_update_key_valid = cacheable;
+    m_update_stop_id = natural_stop_id;
+    m_update_memory_id = memory_id;
+    m_update_parent_data.swap (parent_data);
+
     // let our backend do its update
     if (m_synth_filter_ap->Update() == false)
     {
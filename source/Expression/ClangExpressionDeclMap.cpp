@@ -138,6 +138,58 @@ ClangExpressionDeclMap::DidParse()
     }
 }
 
+bool
+ClangExpressionDeclMap::ResetExecutionContext (ExecutionContext &exe_ctx)
+{
+    if (!m_parser_vars.get())
+        return false;
+    
+    // Get rid of anything left over from the last time we ran.
+    DidDematerialize();
+    
+    m_parser_vars->m_exe_ctx = exe_ctx;
+    if (exe_ctx.GetFramePtr())
+        m_parser_vars->m_sym_ctx = exe_ctx.GetFramePtr()->GetSymbolContext(lldb::eSymbolContextEverything);
+    
+    if (!m_struct_vars.get() || !m_struct_vars->m_result_name)
+        return true;
+    
+    // The last run's result belongs to the user now.  Put a new persistent
+    // variable with the same type into its slot in the struct, the way a new
+    // parse would have.
+    
+    ClangExpressionVariableSP old_result_sp (m_struct_members.GetVariable(m_struct_vars->m_result_name));
+    
+    if (!old_result_sp)
+        return true;
+    
+    if (!old_result_sp->m_jit_vars.get() || !m_parser_vars->m_target_info.IsValid())
+        return false;
+    
+    ConstString result_name (m_parser_vars->m_persistent_vars->GetNextPersistentVariableName());
+    
+    ClangExpressionVariableSP result_sp (m_parser_vars->m_persistent_vars->CreatePersistentVariable (exe_ctx.GetBestExecutionContextScope (),
+                                                                                                     result_name,
+                                                                                                     old_result_sp->GetTypeFromUser(),
+                                                                                                     m_parser_vars->m_target_info.byte_order,
+                                                                                                     m_parser_vars->m_target_info.address_byte_size));
+    
+    if (!result_sp)
+        return false;
+    
+    result_sp->m_flags = m_struct_vars->m_result_flags;
+    result_sp->EnableJITVars();
+    result_sp->m_jit_vars->m_alignment = old_result_sp->m_jit_vars->m_alignment;
+    result_sp->m_jit_vars->m_size = old_result_sp->m_jit_vars->m_size;
+    result_sp->m_jit_vars->m_offset = old_result_sp->m_jit_vars->m_offset;
+    
+    m_struct_members.RemoveVariable(old_result_sp);
+    m_struct_members.AddVariable(result_sp);
+    m_struct_vars->m_result_name = result_name;
+    
+    return true;
+}
+
 // Interface for IRForTarget
 
 ClangExpressionDeclMap::TargetInfo 
@@ -496,6 +548,9 @@ ClangExpressionDeclMap::AddPersistentVariable
         var_sp->m_flags |= ClangExpressionVariable::EVNeedsAllocation;
     }
     
+    if (is_result)
+        m_struct_vars->m_result_flags = var_sp->m_flags;
+    
     if (log)
         log->Printf("Created persistent variable with flags 0x%hx", var_sp->m_flags);
     
@@ -1475,9 +1530,9 @@ ClangExpressionDeclMap::DoMaterialize
         if (log)
             log->PutCString("Allocating memory for materialized argument struct");
         
-        lldb::addr_t mem = process->AllocateMemory(m_struct_vars->m_struct_alignment + m_struct_vars->m_struct_size, 
-                                                   lldb::ePermissionsReadable | lldb::ePermissionsWritable,
-                                                   err);
+        lldb::addr_t mem = process->AllocateExpressionMemory(m_struct_vars->m_struct_alignment + m_struct_vars->m_struct_size, 
+                                                             lldb::ePermissionsReadable | lldb::ePermissionsWritable,
+                                                             err);
         
         if (mem == LLDB_INVALID_ADDRESS)
         {
@@ -1621,6 +1676,12 @@ ClangExpressionDeclMap::DoMaterializeOnePersistentVariable
         if ((var_sp->m_flags & ClangExpressionVariable::EVIsLLDBAllocated) ||
             (var_sp->m_flags & ClangExpressionVariable::EVIsProgramReference))
         {
+            // Remember whether we allocated the area ourselves when we materialized
+            // the variable, since the checks below can set EVNeedsAllocation for
+            // areas that live on the expression's stack.
+            
+            const bool allocated_area = var_sp->m_flags & ClangExpressionVariable::EVNeedsAllocation;
+            
             // Get the location of the target out of the struct.
             
             Error read_error;
@@ -1696,20 +1757,22 @@ ClangExpressionDeclMap::DoMaterializeOnePersistentVariable
             if (var_sp->m_flags & ClangExpressionVariable::EVNeedsAllocation &&
                 !(var_sp->m_flags & ClangExpressionVariable::EVKeepInTarget))
             {
-                if (m_keep_result_in_memory)
-                {
-                    var_sp->m_flags |= ClangExpressionVariable::EVKeepInTarget;
-                }
-                else
+                // The contents are frozen in lldb now, so the variable doesn't need
+                // any memory in the target until an expression uses it again.  That
+                // expression will allocate a new area when it is materialized.
+                
+                if (allocated_area)
                 {
                     Error deallocate_error = process->DeallocateMemory(mem);
                     
-                    if (!err.Success())
+                    if (!deallocate_error.Success())
                     {
                         err.SetErrorStringWithFormat ("Couldn't deallocate memory for %s: %s", var_sp->GetName().GetCString(), deallocate_error.AsCString());
                         return false;
                     }
                 }
+                
+                var_sp->m_live_sp.reset();
             }
         }
         else
@@ -1726,12 +1789,30 @@ ClangExpressionDeclMap::DoMaterializeOnePersistentVariable
         if (var_sp->m_flags & ClangExpressionVariable::EVNeedsAllocation)
         {
             // Allocate a spare memory area to store the persistent variable's contents.
+            // A result that this expression computes is freeze dried and dropped as
+            // soon as the expression finishes, so it only needs expression memory.
+            // A variable that is being passed back into the target is kept there
+            // afterward if the caller asked for results to stay in memory, so that
+            // anything the expression writes to it is still read back.
             
             Error allocate_error;
             
-            mem = process->AllocateMemory(pvar_byte_size, 
-                                          lldb::ePermissionsReadable | lldb::ePermissionsWritable, 
-                                          allocate_error);
+            if ((var_sp->m_flags & ClangExpressionVariable::EVNeedsFreezeDry) &&
+                !(var_sp->m_flags & ClangExpressionVariable::EVKeepInTarget))
+            {
+                mem = process->AllocateExpressionMemory(pvar_byte_size, 
+                                                        lldb::ePermissionsReadable | lldb::ePermissionsWritable, 
+                                                        allocate_error);
+            }
+            else
+            {
+                if (m_keep_result_in_memory)
+                    var_sp->m_flags |= ClangExpressionVariable::EVKeepInTarget;
+                
+                mem = process->AllocateMemory(pvar_byte_size, 
+                                              lldb::ePermissionsReadable | lldb::ePermissionsWritable, 
+                                              allocate_error);
+            }
             
             if (mem == LLDB_INVALID_ADDRESS)
             {
@@ -2401,8 +2482,27 @@ ClangExpressionDeclMap::FindExternalVisibleDecls (NameSearchContext &context)
                                  current_id);
     }
     
+    // Names that aren't variables in the frame but that no module has
+    // either are looked for again by every expression that mentions them,
+    // so remember that searching the modules for them is pointless.
+    Target *target = m_parser_vars->m_exe_ctx.GetTargetPtr();
+    const bool is_global_name = target && isa<TranslationUnitDecl>(context.m_decl_context) && name && name.GetCString()[0] != '$';
+    const bool is_missing_global_name = is_global_name && !context.m_found.variable && target->IsMissingGlobalName(name);
+    
+    if (is_missing_global_name)
+    {
+        if (log)
+            log->Printf("  CEDM::FEVD[%u] No module has '%s', not searching the modules for it", current_id, name.GetCString());
+        return;
+    }
+    
+    const uint32_t missing_names_generation = is_global_name ? target->GetMissingGlobalNamesGeneration() : 0;
+    
     if (!context.m_found.variable)
         ClangASTSource::FindExternalVisibleDecls(context);
+    
+    if (is_global_name && context.m_decls.empty())
+        target->AddMissingGlobalName(name, missing_names_generation);
 }
 
 void 
@@ -2672,6 +2772,10 @@ ClangExpressionDeclMap::FindExternalVisibleDecls (NameSearchContext &context,
             }
         }
         
+        // We already know that no module has this name
+        if (target && !namespace_decl && target->IsMissingGlobalName(name))
+            return;
+        
         if (target)
         {
             var = FindGlobalVariable (*target,
@@ -20,6 +20,7 @@
 #include "lldb/Expression/ClangExpressionDeclMap.h"
 #include "lldb/Expression/IRDynamicChecks.h"
 #include "lldb/Expression/RecordingMemoryManager.h"
+#include "lldb/Host/Mutex.h"
 #include "lldb/Target/ExecutionContext.h"
 #include "lldb/Target/ObjCLanguageRuntime.h"
 #include "lldb/Target/Process.h"
@@ -29,6 +30,7 @@
 #include "clang/AST/ExternalASTSource.h"
 #include "clang/Basic/FileManager.h"
 #include "clang/Basic/TargetInfo.h"
+#include "clang/Basic/TargetOptions.h"
 #include "clang/Basic/Version.h"
 #include "clang/CodeGen/CodeGenAction.h"
 #include "clang/CodeGen/ModuleBuilder.h"
@@ -52,6 +54,7 @@
 #include "clang/Sema/SemaConsumer.h"
 #include "clang/StaticAnalyzer/Frontend/FrontendActions.h"
 
+#include "llvm/ADT/IntrusiveRefCntPtr.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/ExecutionEngine/ExecutionEngine.h"
 #include "llvm/Support/TargetSelect.h"
@@ -73,6 +76,8 @@
 #include "llvm/Support/Host.h"
 #include "llvm/Support/Signals.h"
 
+#include <map>
+
 using namespace clang;
 using namespace llvm;
 using namespace lldb_private;
@@ -182,6 +187,95 @@ static FrontendAction *CreateFrontendAction(CompilerInstance &CI) {
     return Act;
 }
 
+//===----------------------------------------------------------------------===//
+// Compiler setup shared between expressions
+//===----------------------------------------------------------------------===//
+
+namespace {
+
+// The parts of a compiler's setup that only depend on the target triple and
+// the language options. Working these out means creating and configuring a
+// TargetInfo, which is the same for every expression parsed for a target in
+// a language, so parsers with the same key share one.
+struct ParserTargetSetup
+{
+    clang::TargetOptions target_opts;   // The target options after the target canonicalized them
+    llvm::IntrusiveRefCntPtr<clang::TargetInfo> target_info;
+};
+
+typedef std::map<std::string, ParserTargetSetup> ParserTargetSetupMap;
+
+}
+
+static Mutex &
+GetParserTargetSetupMutex ()
+{
+    static Mutex g_mutex (Mutex::eMutexTypeRecursive);
+    return g_mutex;
+}
+
+static ParserTargetSetupMap &
+GetParserTargetSetupMap ()
+{
+    static ParserTargetSetupMap g_map;
+    return g_map;
+}
+
+static std::string
+GetParserTargetSetupKey (const clang::TargetOptions &target_opts,
+                         const clang::LangOptions &lang_opts)
+{
+    std::string key (target_opts.Triple);
+    key.push_back ('|');
+    key.append (target_opts.ABI);
+    key.push_back ('|');
+    key.push_back (lang_opts.ObjC1 ? '1' : '0');
+    key.push_back (lang_opts.ObjC2 ? '1' : '0');
+    key.push_back (lang_opts.CPlusPlus ? '1' : '0');
+    key.push_back (lang_opts.CPlusPlus0x ? '1' : '0');
+    key.push_back (lang_opts.DebuggerCastResultToId ? '1' : '0');
+    key.push_back (lang_opts.DebuggerObjCLiteral ? '1' : '0');
+    return key;
+}
+
+//----------------------------------------------------------------------
+// Give the compiler a TargetInfo for its target and language options,
+// reusing the one an earlier parser created if there is one.
+//----------------------------------------------------------------------
+static void
+SetUpCompilerTarget (CompilerInstance &compiler)
+{
+    Mutex::Locker locker (GetParserTargetSetupMutex());
+
+    ParserTargetSetupMap &setup_map = GetParserTargetSetupMap();
+    const std::string key (GetParserTargetSetupKey (compiler.getTargetOpts(), compiler.getLangOpts()));
+    
+    ParserTargetSetupMap::iterator pos = setup_map.find (key);
+    if (pos == setup_map.end())
+    {
+        compiler.setTarget(TargetInfo::CreateTargetInfo(compiler.getDiagnostics(),
+                                                        compiler.getTargetOpts()));
+        if (!compiler.hasTarget())
+            return;
+        
+        // Inform the target of the language options
+        //
+        // FIXME: We shouldn't need to do this, the target should be immutable once
+        // created. This complexity should be lifted elsewhere.
+        compiler.getTarget().setForcedLangOptions(compiler.getLangOpts());
+
+        ParserTargetSetup &setup = setup_map[key];
+        setup.target_opts = compiler.getTargetOpts();
+        setup.target_info = &compiler.getTarget();
+    }
+    else
+    {
+        const ParserTargetSetup &setup = pos->second;
+        compiler.getTargetOpts() = setup.target_opts;
+        compiler.setTarget(setup.target_info.getPtr());
+    }
+}
+
 //===----------------------------------------------------------------------===//
 // Implementation of ClangExpressionParser
 //===----------------------------------------------------------------------===//
@@ -314,18 +408,12 @@ ClangExpressionParser::ClangExpressionParser (ExecutionContextScope *exe_scope,
     // 3. Set up various important bits of infrastructure.
     m_compiler->createDiagnostics(0, 0);
     
-    // Create the target instance.
-    m_compiler->setTarget(TargetInfo::CreateTargetInfo(m_compiler->getDiagnostics(),
-                                                       m_compiler->getTargetOpts()));
+    // Create the target instance, or reuse the one we made for an earlier
+    // expression with the same target and language options.
+    SetUpCompilerTarget(*m_compiler);
     
     assert (m_compiler->hasTarget());
     
-    // Inform the target of the language options
-    //
-    // FIXME: We shouldn't need to do this, the target should be immutable once
-    // created. This complexity should be lifted elsewhere.
-    m_compiler->getTarget().setForcedLangOptions(m_compiler->getLangOpts());
-    
     // 4. Set up the diagnostic buffer for reporting errors
     
     m_compiler->getDiagnostics().setClient(new clang::TextDiagnosticBuffer);
@@ -566,7 +654,9 @@ ClangExpressionParser::PrepareForExecution (lldb::addr_t &func_allocation_addr,
                     log->Printf("== [ClangUserExpression::Evaluate] Finished installing dynamic checkers ==");
             }
             
-            IRDynamicChecks ir_dynamic_checks(*process->GetDynamicCheckers(), function_name.c_str());
+            IRDynamicChecks ir_dynamic_checks(*process->GetDynamicCheckers(),
+                                              function_name.c_str(),
+                                              target && target->GetExprBatchPointerChecks());
         
             if (!ir_dynamic_checks.runOnModule(*module))
             {
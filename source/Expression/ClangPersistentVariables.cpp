@@ -8,11 +8,15 @@
 //===----------------------------------------------------------------------===//
 
 #include "lldb/Expression/ClangPersistentVariables.h"
+#include "lldb/Core/DataBufferHeap.h"
 #include "lldb/Core/DataExtractor.h"
 #include "lldb/Core/Log.h"
 #include "lldb/Core/StreamString.h"
 #include "lldb/Core/Value.h"
+#include "lldb/Core/ValueObjectConstResult.h"
+#include "lldb/Symbol/ClangASTImporter.h"
 
+#include "clang/AST/Decl.h"
 #include "llvm/ADT/StringMap.h"
 
 using namespace lldb;
@@ -87,3 +91,85 @@ ClangPersistentVariables::GetPersistentType (const ConstString &name)
     else
         return i->second;
 }
+
+size_t
+ClangPersistentVariables::GetValueByteSize ()
+{
+    size_t byte_size = 0;
+    const size_t num_variables = GetSize();
+    for (size_t i = 0; i < num_variables; ++i)
+        byte_size += GetVariableAtIndex(i)->GetByteSize();
+    return byte_size;
+}
+
+bool
+ClangPersistentVariables::MigrateToASTContext (ClangASTImporter &importer,
+                                               ExecutionContextScope *exe_scope,
+                                               clang::ASTContext *dst_ast,
+                                               clang::ASTContext *src_ast)
+{
+    // Copy all the types first so a failure doesn't leave some of the
+    // variables in each AST
+    const size_t num_variables = GetSize();
+    std::vector<lldb::clang_type_t> new_types (num_variables, (lldb::clang_type_t)NULL);
+    for (size_t i = 0; i < num_variables; ++i)
+    {
+        ClangExpressionVariableSP var_sp (GetVariableAtIndex(i));
+        if (var_sp->GetClangAST() != src_ast)
+            continue;
+        new_types[i] = importer.DeportType (dst_ast, src_ast, var_sp->GetClangType());
+        if (new_types[i] == NULL)
+            return false;
+    }
+
+    PersistentTypeMap new_persistent_types;
+    for (PersistentTypeMap::iterator pos = m_persistent_types.begin(), end = m_persistent_types.end(); pos != end; ++pos)
+    {
+        clang::TypeDecl *type_decl = pos->second;
+        if (&type_decl->getASTContext() == src_ast)
+        {
+            type_decl = llvm::dyn_cast_or_null<clang::TypeDecl>(importer.DeportDecl (dst_ast, src_ast, type_decl));
+            if (type_decl == NULL)
+                return false;
+        }
+        new_persistent_types.insert(std::pair<const char*, clang::TypeDecl*>(pos->first, type_decl));
+    }
+
+    for (size_t i = 0; i < num_variables; ++i)
+    {
+        if (new_types[i] == NULL)
+            continue;
+
+        ClangExpressionVariableSP var_sp (GetVariableAtIndex(i));
+        const ConstString name (var_sp->GetName());
+        lldb::ValueObjectSP old_frozen_sp (var_sp->m_frozen_sp);
+        DataExtractor &old_data = old_frozen_sp->GetDataExtractor();
+        DataBufferSP buffer_sp (new DataBufferHeap (old_data.GetDataStart(), old_data.GetByteSize()));
+        var_sp->m_frozen_sp = ValueObjectConstResult::Create (exe_scope,
+                                                              dst_ast,
+                                                              new_types[i],
+                                                              name,
+                                                              buffer_sp,
+                                                              old_data.GetByteOrder(),
+                                                              old_data.GetAddressByteSize(),
+                                                              old_frozen_sp->GetLiveAddress());
+
+        if (var_sp->m_live_sp && var_sp->m_live_sp->GetClangAST() == src_ast)
+        {
+            const Value &live_value = var_sp->m_live_sp->GetValue();
+            if (live_value.GetValueType() == Value::eValueTypeLoadAddress)
+                var_sp->m_live_sp = ValueObjectConstResult::Create (exe_scope,
+                                                                    dst_ast,
+                                                                    new_types[i],
+                                                                    name,
+                                                                    live_value.GetScalar().ULongLong(LLDB_INVALID_ADDRESS),
+                                                                    eAddressTypeLoad,
+                                                                    old_data.GetAddressByteSize());
+            else
+                var_sp->m_live_sp.reset();
+        }
+    }
+
+    m_persistent_types.swap (new_persistent_types);
+    return true;
+}
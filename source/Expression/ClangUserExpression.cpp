@@ -18,8 +18,10 @@
 #include <string>
 #include <map>
 
+#include "lldb/Core/AsyncOperation.h"
 #include "lldb/Core/ConstString.h"
 #include "lldb/Core/Log.h"
+#include "lldb/Core/Statistics.h"
 #include "lldb/Core/StreamFile.h"
 #include "lldb/Core/StreamString.h"
 #include "lldb/Core/ValueObjectConstResult.h"
@@ -30,6 +32,7 @@
 #include "lldb/Expression/ClangUserExpression.h"
 #include "lldb/Expression/ExpressionSourceCode.h"
 #include "lldb/Host/Host.h"
+#include "lldb/Host/TimeValue.h"
 #include "lldb/Symbol/Block.h"
 #include "lldb/Symbol/VariableList.h"
 #include "lldb/Target/ExecutionContext.h"
@@ -313,6 +316,7 @@ ClangUserExpression::Parse (Stream &error_stream,
     
     ClangExpressionParser parser(exe_scope, *this);
     
+    const TimeValue parse_start_time (TimeValue::Now());
     unsigned num_errors = parser.Parse (error_stream);
     
     if (num_errors)
@@ -348,8 +352,18 @@ ClangUserExpression::Parse (Stream &error_stream,
         log->Printf("Data buffer contents:\n%s", dump_string.GetString().c_str());
     }
         
+    static StatisticsHistogram &g_parse_time = Statistics::GetHistogram ("expression.parse-usec");
+    g_parse_time.Add (TimeValue::Now().GetAsMicroSecondsSinceJan1_1970() - parse_start_time.GetAsMicroSecondsSinceJan1_1970());
+
     if (jit_error.Success())
     {
+        static StatisticsCounter &g_evaluated_statically = Statistics::GetCounter ("expression.evaluated-statically");
+        static StatisticsCounter &g_jit_compiled = Statistics::GetCounter ("expression.jit-compiled");
+        if (m_evaluated_statically)
+            g_evaluated_statically.Add ();
+        else if (m_jit_start_addr != LLDB_INVALID_ADDRESS)
+            g_jit_compiled.Add ();
+
         if (process && m_jit_alloc != LLDB_INVALID_ADDRESS)
             m_jit_process_sp = process->shared_from_this();        
         return true;
@@ -470,6 +484,23 @@ ClangUserExpression::PrepareToExecuteJITExpression (Stream &error_stream,
     return true;
 }
 
+bool
+ClangUserExpression::ResetExecutionContext (ExecutionContext &exe_ctx)
+{
+    if (m_evaluated_statically || m_jit_start_addr == LLDB_INVALID_ADDRESS || !m_expr_decl_map.get())
+        return false;
+    
+    // The JIT compiled code lives in the process it was compiled for.
+    if (!m_jit_process_sp || m_jit_process_sp.get() != exe_ctx.GetProcessPtr())
+        return false;
+    
+    if (!m_expr_decl_map->ResetExecutionContext (exe_ctx))
+        return false;
+    
+    InstallContext (exe_ctx);
+    return true;
+}
+
 ThreadPlan *
 ClangUserExpression::GetThreadPlanToExecuteJITExpression (Stream &error_stream,
                                                           ExecutionContext &exe_ctx)
@@ -538,6 +569,39 @@ ClangUserExpression::FinalizeJITExecution (Stream &error_stream,
     return true;
 }        
 
+//----------------------------------------------------------------------
+// Keeps the process's expression arena in an epoch for as long as one
+// expression is being executed, so the memory it materializes into can be
+// handed out again once it is done.
+//----------------------------------------------------------------------
+class ExpressionArenaEpoch
+{
+public:
+    ExpressionArenaEpoch (Process *process) :
+        m_process (process),
+        m_expression_finished (true)
+    {
+        if (m_process)
+            m_process->BeginExpressionEpoch();
+    }
+
+    ~ExpressionArenaEpoch ()
+    {
+        if (m_process)
+            m_process->EndExpressionEpoch(m_expression_finished);
+    }
+
+    void
+    SetExpressionLeftOnStack ()
+    {
+        m_expression_finished = false;
+    }
+
+private:
+    Process *m_process;
+    bool m_expression_finished;
+};
+
 ExecutionResults
 ClangUserExpression::Execute (Stream &error_stream,
                               ExecutionContext &exe_ctx,
@@ -552,6 +616,7 @@ ClangUserExpression::Execute (Stream &error_stream,
 
     if (m_jit_start_addr != LLDB_INVALID_ADDRESS)
     {
+        ExpressionArenaEpoch arena_epoch (exe_ctx.GetProcessPtr());
         lldb::addr_t struct_address;
                 
         lldb::addr_t object_ptr = 0;
@@ -562,6 +627,9 @@ ClangUserExpression::Execute (Stream &error_stream,
             error_stream.Printf("Errored out in %s, couldn't PrepareToExecuteJITExpression", __FUNCTION__);
             return eExecutionSetupError;
         }
+
+        static StatisticsCounter &g_executed = Statistics::GetCounter ("expression.executed");
+        g_executed.Add ();
         
         const bool stop_others = true;
         const bool try_all_threads = true;
@@ -603,6 +671,9 @@ ClangUserExpression::Execute (Stream &error_stream,
         if (log)
             log->Printf("-- [ClangUserExpression::Execute] Execution of expression completed --");
 
+        if (execution_result != eExecutionCompleted && !discard_on_error)
+            arena_epoch.SetExpressionLeftOnStack();
+
         if (execution_result == eExecutionInterrupted)
         {
             const char *error_desc = NULL;
@@ -672,6 +743,23 @@ ClangUserExpression::EvaluateWithError (ExecutionContext &exe_ctx,
                                         lldb::ValueObjectSP &result_valobj_sp,
                                         Error &error,
                                         uint32_t single_thread_timeout_usec)
+{
+    ClangUserExpressionSP user_expression_sp;
+    return EvaluateWithCache (exe_ctx, execution_policy, language, desired_type, discard_on_error, expr_cstr, expr_prefix, user_expression_sp, result_valobj_sp, error, single_thread_timeout_usec);
+}
+
+ExecutionResults
+ClangUserExpression::EvaluateWithCache (ExecutionContext &exe_ctx,
+                                        lldb_private::ExecutionPolicy execution_policy,
+                                        lldb::LanguageType language,
+                                        ResultType desired_type,
+                                        bool discard_on_error,
+                                        const char *expr_cstr,
+                                        const char *expr_prefix,
+                                        ClangUserExpressionSP &user_expression_sp,
+                                        lldb::ValueObjectSP &result_valobj_sp,
+                                        Error &error,
+                                        uint32_t single_thread_timeout_usec)
 {
     lldb::LogSP log(lldb_private::GetLogIfAnyCategoriesSet (LIBLLDB_LOG_EXPRESSIONS | LIBLLDB_LOG_STEP));
 
@@ -695,23 +783,42 @@ ClangUserExpression::EvaluateWithError (ExecutionContext &exe_ctx,
     if (process == NULL || !process->CanJIT())
         execution_policy = eExecutionPolicyNever;
     
-    ClangUserExpressionSP user_expression_sp (new ClangUserExpression (expr_cstr, expr_prefix, language, desired_type));
-
     StreamString error_stream;
-        
-    if (log)
-        log->Printf("== [ClangUserExpression::Evaluate] Parsing expression %s ==", expr_cstr);
     
-    const bool keep_expression_in_memory = true;
+    bool parsed = false;
     
-    if (!user_expression_sp->Parse (error_stream, exe_ctx, execution_policy, keep_expression_in_memory))
+    if (AsyncOperation::ShouldCancel())
     {
-        if (error_stream.GetString().empty())
-            error.SetErrorString ("expression failed to parse, unknown error");
-        else
-            error.SetErrorString (error_stream.GetString().c_str());
+        error.SetErrorString ("expression evaluation was cancelled");
+    }
+    else if (user_expression_sp && user_expression_sp->ResetExecutionContext (exe_ctx))
+    {
+        if (log)
+            log->Printf("== [ClangUserExpression::Evaluate] Reusing the parsed expression %s ==", user_expression_sp->GetUserText());
+        
+        parsed = true;
     }
     else
+    {
+        user_expression_sp.reset (new ClangUserExpression (expr_cstr, expr_prefix, language, desired_type));
+        
+        if (log)
+            log->Printf("== [ClangUserExpression::Evaluate] Parsing expression %s ==", expr_cstr);
+        
+        const bool keep_expression_in_memory = true;
+        
+        parsed = user_expression_sp->Parse (error_stream, exe_ctx, execution_policy, keep_expression_in_memory);
+        
+        if (!parsed)
+        {
+            if (error_stream.GetString().empty())
+                error.SetErrorString ("expression failed to parse, unknown error");
+            else
+                error.SetErrorString (error_stream.GetString().c_str());
+        }
+    }
+    
+    if (parsed)
     {
         lldb::ClangExpressionVariableSP expr_result;
 
@@ -735,6 +842,12 @@ ClangUserExpression::EvaluateWithError (ExecutionContext &exe_ctx,
             if (error_stream.GetString().empty())
                 error.SetErrorString ("expression needed to run but couldn't");
         }
+        else if (AsyncOperation::ShouldCancel())
+        {
+            // Parsing can take a while, don't start the process running
+            // for an operation that was cancelled in the meantime
+            error.SetErrorString ("expression evaluation was cancelled");
+        }
         else
         {    
             error_stream.GetString().clear();
@@ -779,6 +892,11 @@ ClangUserExpression::EvaluateWithError (ExecutionContext &exe_ctx,
         }
     }
     
+    // Only JIT compiled code that ran to completion can be run again, the
+    // IR interpreter computes its result while the expression is parsed.
+    if (execution_results != eExecutionCompleted || user_expression_sp->EvaluatedStatically())
+        user_expression_sp.reset();
+    
     if (result_valobj_sp.get() == NULL)
         result_valobj_sp = ValueObjectConstResult::Create (NULL, error);
 
@@ -9,6 +9,7 @@
 
 #include "lldb/Expression/DWARFExpression.h"
 
+#include <algorithm>
 #include <vector>
 
 #include "lldb/Core/DataEncoder.h"
@@ -221,14 +222,22 @@ DW_OP_value_to_name (uint32_t val)
 DWARFExpression::DWARFExpression() :
     m_data(),
     m_reg_kind (eRegisterKindDWARF),
-    m_loclist_slide (LLDB_INVALID_ADDRESS)
+    m_loclist_slide (LLDB_INVALID_ADDRESS),
+    m_simple_expr (),
+    m_loclist_index (),
+    m_loclist_index_state (eLocationListIndexNotBuilt),
+    m_loclist_last_idx (0)
 {
 }
 
 DWARFExpression::DWARFExpression(const DWARFExpression& rhs) :
     m_data(rhs.m_data),
     m_reg_kind (rhs.m_reg_kind),
-    m_loclist_slide(rhs.m_loclist_slide)
+    m_loclist_slide(rhs.m_loclist_slide),
+    m_simple_expr (rhs.m_simple_expr),
+    m_loclist_index (rhs.m_loclist_index),
+    m_loclist_index_state (rhs.m_loclist_index_state),
+    m_loclist_last_idx (rhs.m_loclist_last_idx)
 {
 }
 
@@ -236,7 +245,11 @@ DWARFExpression::DWARFExpression(const DWARFExpression& rhs) :
 DWARFExpression::DWARFExpression(const DataExtractor& data, uint32_t data_offset, uint32_t data_length) :
     m_data(data, data_offset, data_length),
     m_reg_kind (eRegisterKindDWARF),
-    m_loclist_slide(LLDB_INVALID_ADDRESS)
+    m_loclist_slide(LLDB_INVALID_ADDRESS),
+    m_simple_expr (),
+    m_loclist_index (),
+    m_loclist_index_state (eLocationListIndexNotBuilt),
+    m_loclist_last_idx (0)
 {
 }
 
@@ -258,6 +271,7 @@ void
 DWARFExpression::SetOpcodeData (const DataExtractor& data)
 {
     m_data = data;
+    OpcodesChanged ();
 }
 
 void
@@ -269,6 +283,7 @@ DWARFExpression::CopyOpcodeData (const DataExtractor& data, uint32_t data_offset
         m_data.SetData(DataBufferSP(new DataBufferHeap(bytes, data_length)));
         m_data.SetByteOrder(data.GetByteOrder());
         m_data.SetAddressByteSize(data.GetAddressByteSize());
+        OpcodesChanged ();
     }
 }
 
@@ -276,6 +291,7 @@ void
 DWARFExpression::SetOpcodeData (const DataExtractor& data, uint32_t data_offset, uint32_t data_length)
 {
     m_data.SetData(data, data_offset, data_length);
+    OpcodesChanged ();
 }
 
 void
@@ -1079,6 +1095,7 @@ DWARFExpression::Update_DW_OP_addr (lldb::addr_t file_addr)
             // pointer to the heap data so "m_data" will now correctly 
             // manage the heap data.
             m_data.SetData (DataBufferSP (head_data_ap.release()));
+            OpcodesChanged ();
             return true;
         }
         else
@@ -1127,6 +1144,106 @@ DWARFExpression::LocationListContainsAddress (lldb::addr_t loclist_base_addr, ll
     return false;
 }
 
+// Orders location list entries by address for std::stable_sort()
+bool
+DWARFExpression::LocationListEntryLessThan (const LocationListEntry &lhs, const LocationListEntry &rhs)
+{
+    return lhs.lo_pc < rhs.lo_pc;
+}
+
+void
+DWARFExpression::BuildLocationListIndex () const
+{
+    LocationListIndex index;
+    uint32_t offset = 0;
+    while (m_data.ValidOffset(offset))
+    {
+        LocationListEntry entry;
+        entry.lo_pc = m_data.GetAddress(&offset);
+        entry.hi_pc = m_data.GetAddress(&offset);
+        if (entry.lo_pc == 0 && entry.hi_pc == 0)
+            break;
+        entry.length = m_data.GetU16(&offset);
+        entry.offset = offset;
+        if (entry.length > 0 && entry.lo_pc < entry.hi_pc)
+        {
+            DecodeSimpleExpression (m_data, entry.offset, entry.length, entry.simple_expr);
+            index.push_back (entry);
+        }
+        offset += entry.length;
+    }
+
+    // The first entry in the list that contains a PC wins, so if any
+    // entries overlap we have to keep them in list order.
+    LocationListIndex sorted_index (index);
+    std::stable_sort (sorted_index.begin(), sorted_index.end(), LocationListEntryLessThan);
+    bool overlapping = false;
+    for (size_t i = 1; i < sorted_index.size() && !overlapping; ++i)
+        overlapping = sorted_index[i].lo_pc < sorted_index[i - 1].hi_pc;
+
+    if (overlapping)
+    {
+        m_loclist_index.swap (index);
+        m_loclist_index_state = eLocationListIndexOverlapping;
+    }
+    else
+    {
+        m_loclist_index.swap (sorted_index);
+        m_loclist_index_state = eLocationListIndexSorted;
+    }
+}
+
+// Compares a PC to the start of a location list entry for std::upper_bound()
+bool
+DWARFExpression::PCLessThanLocationListEntry (addr_t pc, const LocationListEntry &entry)
+{
+    return pc < entry.lo_pc;
+}
+
+const DWARFExpression::LocationListEntry *
+DWARFExpression::FindLocationListEntry (addr_t loclist_base_addr, addr_t pc) const
+{
+    if (m_loclist_index_state == eLocationListIndexNotBuilt)
+        BuildLocationListIndex ();
+
+    // The entries are relative to the base address, move the PC instead of
+    // every entry we look at
+    const addr_t list_pc = pc - (loclist_base_addr - m_loclist_slide);
+    const size_t num_entries = m_loclist_index.size();
+    if (m_loclist_index_state == eLocationListIndexSorted)
+    {
+        // All the locals of a frame get evaluated at the same PC, and
+        // stepping usually stays in the same range, so check the entry
+        // the last lookup found first
+        uint32_t idx = m_loclist_last_idx;
+        if (idx < num_entries && m_loclist_index[idx].lo_pc <= list_pc && list_pc < m_loclist_index[idx].hi_pc)
+            return &m_loclist_index[idx];
+
+        LocationListIndex::const_iterator pos = std::upper_bound (m_loclist_index.begin(),
+                                                                  m_loclist_index.end(),
+                                                                  list_pc,
+                                                                  PCLessThanLocationListEntry);
+        if (pos != m_loclist_index.begin())
+        {
+            --pos;
+            if (list_pc < pos->hi_pc)
+            {
+                m_loclist_last_idx = pos - m_loclist_index.begin();
+                return &(*pos);
+            }
+        }
+    }
+    else
+    {
+        for (size_t i = 0; i < num_entries; ++i)
+        {
+            if (m_loclist_index[i].lo_pc <= list_pc && list_pc < m_loclist_index[i].hi_pc)
+                return &m_loclist_index[i];
+        }
+    }
+    return NULL;
+}
+
 bool
 DWARFExpression::GetLocation (addr_t base_addr, addr_t pc, uint32_t &offset, uint32_t &length)
 {
@@ -1139,29 +1256,12 @@ DWARFExpression::GetLocation (addr_t base_addr, addr_t pc, uint32_t &offset, uin
 
     if (base_addr != LLDB_INVALID_ADDRESS && pc != LLDB_INVALID_ADDRESS)
     {
-        addr_t curr_base_addr = base_addr;
-
-        while (m_data.ValidOffset(offset))
+        const LocationListEntry *entry = FindLocationListEntry (base_addr, pc);
+        if (entry)
         {
-            // We need to figure out what the value is for the location.
-            addr_t lo_pc = m_data.GetAddress(&offset);
-            addr_t hi_pc = m_data.GetAddress(&offset);
-            if (lo_pc == 0 && hi_pc == 0)
-            {
-                break;
-            }
-            else
-            {
-                lo_pc += curr_base_addr - m_loclist_slide;
-                hi_pc += curr_base_addr - m_loclist_slide;
-                
-                length = m_data.GetU16(&offset);
-                
-                if (length > 0 && lo_pc <= pc && pc < hi_pc)
-                    return true;
-
-                offset += length;
-            }
+            offset = entry->offset;
+            length = entry->length;
+            return true;
         }
     }
     offset = UINT32_MAX;
@@ -1190,6 +1290,158 @@ DWARFExpression::DumpLocationForAddress (Stream *s,
     return false;
 }
 
+bool
+DWARFExpression::DecodeSimpleExpression (const DataExtractor& opcodes,
+                                         uint32_t offset,
+                                         uint32_t length,
+                                         SimpleExpression &simple_expr)
+{
+    simple_expr.kind = eSimpleExpressionNone;
+    simple_expr.reg_num = 0;
+    simple_expr.address = 0;
+    simple_expr.offset = 0;
+    simple_expr.has_plus_uconst = false;
+    simple_expr.plus_uconst = 0;
+
+    if (length == 0 || !opcodes.ValidOffsetForDataOfSize(offset, length))
+        return false;
+
+    const uint32_t end_offset = offset + length;
+    SimpleExpressionKind kind = eSimpleExpressionNone;
+    const uint8_t op = opcodes.GetU8(&offset);
+    if (op == DW_OP_addr)
+    {
+        kind = eSimpleExpressionAddress;
+        simple_expr.address = opcodes.GetAddress(&offset);
+    }
+    else if (op >= DW_OP_reg0 && op <= DW_OP_reg31)
+    {
+        kind = eSimpleExpressionRegister;
+        simple_expr.reg_num = op - DW_OP_reg0;
+    }
+    else if (op == DW_OP_regx)
+    {
+        kind = eSimpleExpressionRegister;
+        simple_expr.reg_num = opcodes.GetULEB128(&offset);
+    }
+    else if (op >= DW_OP_breg0 && op <= DW_OP_breg31)
+    {
+        kind = eSimpleExpressionRegisterOffset;
+        simple_expr.reg_num = op - DW_OP_breg0;
+        simple_expr.offset = opcodes.GetSLEB128(&offset);
+    }
+    else if (op == DW_OP_bregx)
+    {
+        kind = eSimpleExpressionRegisterOffset;
+        simple_expr.reg_num = opcodes.GetULEB128(&offset);
+        simple_expr.offset = opcodes.GetSLEB128(&offset);
+    }
+    else if (op == DW_OP_fbreg)
+    {
+        kind = eSimpleExpressionFrameBaseOffset;
+        simple_expr.offset = opcodes.GetSLEB128(&offset);
+    }
+    else
+        return false;
+
+    // A member of something on the stack is often an offset from its address
+    if (offset < end_offset && 
+        (kind == eSimpleExpressionRegisterOffset || kind == eSimpleExpressionFrameBaseOffset) &&
+        opcodes.GetU8_unchecked (&offset) == DW_OP_plus_uconst)
+    {
+        simple_expr.has_plus_uconst = true;
+        simple_expr.plus_uconst = opcodes.GetULEB128(&offset);
+    }
+
+    if (offset != end_offset)
+        return false;
+    simple_expr.kind = kind;
+    return true;
+}
+
+//----------------------------------------------------------------------
+// Evaluate an expression decoded by DecodeSimpleExpression(). The
+// results and errors match what the interpreter produces for the same
+// operations.
+//----------------------------------------------------------------------
+bool
+DWARFExpression::EvaluateSimpleExpression (ExecutionContext *exe_ctx,
+                                           clang::ASTContext *ast_context,
+                                           RegisterContext *reg_ctx,
+                                           const uint32_t reg_kind,
+                                           const SimpleExpression &simple_expr,
+                                           Value& result,
+                                           Error *error_ptr)
+{
+    StackFrame *frame = NULL;
+    if (exe_ctx)
+        frame = exe_ctx->GetFramePtr();
+    if (reg_ctx == NULL && frame)
+        reg_ctx = frame->GetRegisterContext().get();
+
+    Value value;
+    switch (simple_expr.kind)
+    {
+    case eSimpleExpressionAddress:
+        value = Value (Scalar (simple_expr.address));
+        value.SetValueType (Value::eValueTypeFileAddress);
+        break;
+
+    case eSimpleExpressionRegister:
+        if (!ReadRegisterValueAsScalar (reg_ctx, reg_kind, simple_expr.reg_num, error_ptr, value))
+            return false;
+        break;
+
+    case eSimpleExpressionRegisterOffset:
+        if (!ReadRegisterValueAsScalar (reg_ctx, reg_kind, simple_expr.reg_num, error_ptr, value))
+            return false;
+        value.ResolveValue(exe_ctx, ast_context) += (uint64_t)simple_expr.offset;
+        value.ClearContext();
+        value.SetValueType (Value::eValueTypeLoadAddress);
+        break;
+
+    case eSimpleExpressionFrameBaseOffset:
+        {
+            if (exe_ctx == NULL)
+            {
+                if (error_ptr)
+                    error_ptr->SetErrorStringWithFormat ("NULL execution context for DW_OP_fbreg.\n");
+                return false;
+            }
+            if (frame == NULL)
+            {
+                if (error_ptr)
+                    error_ptr->SetErrorString ("Invalid stack frame in context for DW_OP_fbreg opcode.");
+                return false;
+            }
+            Scalar frame_base;
+            if (!frame->GetFrameBaseValue(frame_base, error_ptr))
+                return false;
+            frame_base += simple_expr.offset;
+            value = Value (frame_base);
+            value.SetValueType (Value::eValueTypeLoadAddress);
+        }
+        break;
+
+    default:
+        return false;
+    }
+
+    if (simple_expr.has_plus_uconst)
+    {
+        value.ResolveValue(exe_ctx, ast_context) += simple_expr.plus_uconst;
+        if (!value.ResolveValue(exe_ctx, ast_context).IsValid())
+        {
+            if (error_ptr)
+                error_ptr->SetErrorString("DW_OP_plus_uconst failed.");
+            return false;
+        }
+    }
+
+    result = value;
+    return true;
+}
+
 bool
 DWARFExpression::Evaluate
 (
@@ -1223,7 +1475,6 @@ DWARFExpression::Evaluate
 {
     if (IsLocationList())
     {
-        uint32_t offset = 0;
         addr_t pc;
         StackFrame *frame = NULL;
         if (reg_ctx)
@@ -1248,30 +1499,12 @@ DWARFExpression::Evaluate
                 return false;
             }
 
-            addr_t curr_loclist_base_load_addr = loclist_base_load_addr;
-
-            while (m_data.ValidOffset(offset))
+            const LocationListEntry *entry = FindLocationListEntry (loclist_base_load_addr, pc);
+            if (entry)
             {
-                // We need to figure out what the value is for the location.
-                addr_t lo_pc = m_data.GetAddress(&offset);
-                addr_t hi_pc = m_data.GetAddress(&offset);
-                if (lo_pc == 0 && hi_pc == 0)
-                {
-                    break;
-                }
-                else
-                {
-                    lo_pc += curr_loclist_base_load_addr - m_loclist_slide;
-                    hi_pc += curr_loclist_base_load_addr - m_loclist_slide;
-
-                    uint16_t length = m_data.GetU16(&offset);
-
-                    if (length > 0 && lo_pc <= pc && pc < hi_pc)
-                    {
-                        return DWARFExpression::Evaluate (exe_ctx, ast_context, expr_locals, decl_map, reg_ctx, m_data, offset, length, m_reg_kind, initial_value_ptr, result, error_ptr);
-                    }
-                    offset += length;
-                }
+                if (entry->simple_expr.kind != eSimpleExpressionNone)
+                    return EvaluateSimpleExpression (exe_ctx, ast_context, reg_ctx, m_reg_kind, entry->simple_expr, result, error_ptr);
+                return DWARFExpression::Evaluate (exe_ctx, ast_context, expr_locals, decl_map, reg_ctx, m_data, entry->offset, entry->length, m_reg_kind, initial_value_ptr, result, error_ptr);
             }
         }
         if (error_ptr)
@@ -1279,7 +1512,17 @@ DWARFExpression::Evaluate
         return false;
     }
 
-    // Not a location list, just a single expression.
+    // Not a location list, just a single expression. Variables are
+    // re-evaluated constantly, so remember whether it is one of the
+    // simple forms we don't need the interpreter for.
+    if (m_simple_expr.kind == eSimpleExpressionUnknown)
+    {
+        SimpleExpression simple_expr;
+        DecodeSimpleExpression (m_data, 0, m_data.GetByteSize(), simple_expr);
+        m_simple_expr = simple_expr;
+    }
+    if (m_simple_expr.kind != eSimpleExpressionNone)
+        return EvaluateSimpleExpression (exe_ctx, ast_context, reg_ctx, m_reg_kind, m_simple_expr, result, error_ptr);
     return DWARFExpression::Evaluate (exe_ctx, ast_context, expr_locals, decl_map, reg_ctx, m_data, 0, m_data.GetByteSize(), m_reg_kind, initial_value_ptr, result, error_ptr);
 }
 
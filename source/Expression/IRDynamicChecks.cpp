@@ -22,8 +22,11 @@
 #include "llvm/Function.h"
 #include "llvm/Instructions.h"
 #include "llvm/Module.h"
+#include "llvm/Operator.h"
 #include "llvm/Value.h"
 
+#include <set>
+
 using namespace llvm;
 using namespace lldb_private;
 
@@ -344,16 +347,59 @@ class ValidPointerChecker : public Instrumenter
 {
 public:
     ValidPointerChecker (llvm::Module &module,
-                         DynamicCheckerFunctions &checker_functions) :
+                         DynamicCheckerFunctions &checker_functions,
+                         bool batch_checks) :
         Instrumenter(module, checker_functions),
-        m_valid_pointer_check_func(NULL)
+        m_valid_pointer_check_func(NULL),
+        m_batch_checks(batch_checks),
+        m_function(NULL)
     {
     }
     
     virtual ~ValidPointerChecker ()
     {
     }
+
+    //------------------------------------------------------------------
+    /// Add the checks that were moved to the entry block because
+    /// batching was requested.  Call this after Instrument().
+    ///
+    /// @return
+    ///     True on success; false otherwise.
+    //------------------------------------------------------------------
+    bool InstrumentBatchedChecks ()
+    {
+        for (ValueVector::iterator vi = m_batched_pointers.begin(), last_vi = m_batched_pointers.end();
+             vi != last_vi;
+             ++vi)
+        {
+            llvm::Instruction *insert_before = NULL;
+            
+            // Right after the pointer is computed, or first thing if it
+            // isn't computed by an instruction at all
+            if (llvm::Instruction *def_inst = dyn_cast<llvm::Instruction> (*vi))
+            {
+                llvm::BasicBlock::iterator next_ii = def_inst;
+                ++next_ii;
+                insert_before = &*next_ii;
+            }
+            else
+            {
+                insert_before = m_function->getEntryBlock().getFirstNonPHI();
+            }
+            
+            if (!insert_before)
+                return false;
+            
+            InsertCheck(*vi, insert_before);
+        }
+        
+        return true;
+    }
 private:
+    typedef std::vector <llvm::Value *> ValueVector;
+    typedef std::set <llvm::Value *>    ValueSet;
+
     bool InstrumentInstruction(llvm::Instruction *inst)
     {
         lldb::LogSP log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_EXPRESSIONS));
@@ -362,24 +408,27 @@ private:
             log->Printf("Instrumenting load/store instruction: %s\n", 
                         PrintValue(inst).c_str());
         
-        if (!m_valid_pointer_check_func)
-            m_valid_pointer_check_func = BuildPointerValidatorFunc(m_checker_functions.m_valid_pointer_check->StartAddress());
+        llvm::Value *dereferenced_ptr = GetDereferencedPointer(inst);
         
-        llvm::Value *dereferenced_ptr = NULL;
-        
-        if (llvm::LoadInst *li = dyn_cast<llvm::LoadInst> (inst))
-            dereferenced_ptr = li->getPointerOperand();
-        else if (llvm::StoreInst *si = dyn_cast<llvm::StoreInst> (inst))
-            dereferenced_ptr = si->getPointerOperand();
-        else
+        if (!dereferenced_ptr)
             return false;
         
+        InsertCheck(dereferenced_ptr, inst);
+            
+        return true;
+    }
+    
+    void InsertCheck(llvm::Value *ptr, llvm::Instruction *insert_before)
+    {
+        if (!m_valid_pointer_check_func)
+            m_valid_pointer_check_func = BuildPointerValidatorFunc(m_checker_functions.m_valid_pointer_check->StartAddress());
+        
         // Insert an instruction to cast the loaded value to int8_t*
         
-        BitCastInst *bit_cast = new BitCastInst(dereferenced_ptr,
+        BitCastInst *bit_cast = new BitCastInst(ptr,
                                                 GetI8PtrTy(),
                                                 "",
-                                                inst);
+                                                insert_before);
         
         // Insert an instruction to call the helper with the result
         
@@ -392,21 +441,132 @@ private:
         CallInst::Create(m_valid_pointer_check_func, 
                          args,
                          "",
-                         inst);
+                         insert_before);
+    }
+    
+    static llvm::Value *GetDereferencedPointer(llvm::Instruction *inst)
+    {
+        if (llvm::LoadInst *li = dyn_cast<llvm::LoadInst> (inst))
+            return li->getPointerOperand();
+        else if (llvm::StoreInst *si = dyn_cast<llvm::StoreInst> (inst))
+            return si->getPointerOperand();
+        return NULL;
+    }
+    
+    //------------------------------------------------------------------
+    /// Strip casts and constant offsets from a pointer, leaving the
+    /// pointer it was derived from
+    //------------------------------------------------------------------
+    static llvm::Value *GetBasePointer(llvm::Value *ptr)
+    {
+        while (1)
+        {
+            ptr = ptr->stripPointerCasts();
             
-        return true;
+            llvm::GEPOperator *gep = dyn_cast<llvm::GEPOperator> (ptr);
+            
+            if (!gep || !gep->hasAllConstantIndices())
+                return ptr;
+            
+            ptr = gep->getPointerOperand();
+        }
+    }
+    
+    static bool IsArgumentStruct(llvm::Value *base)
+    {
+        llvm::Argument *argument = dyn_cast<llvm::Argument> (base);
+        
+        return argument && argument->getName().equals("$__lldb_arg");
+    }
+    
+    //------------------------------------------------------------------
+    /// Determine whether a pointer can't be invalid, so dereferencing it
+    /// needs no check.  That is the case for the expression's own locals
+    /// and globals, the argument struct, the addresses of the variables
+    /// that were materialized into it, and pointers derived from a base
+    /// that was already checked.
+    //------------------------------------------------------------------
+    bool IsKnownValid(llvm::Value *ptr)
+    {
+        llvm::Value *base = GetBasePointer(ptr);
+        
+        if (isa<llvm::AllocaInst> (base) ||
+            isa<llvm::GlobalVariable> (base) ||
+            IsArgumentStruct(base))
+            return true;
+        
+        if (llvm::LoadInst *li = dyn_cast<llvm::LoadInst> (base))
+        {
+            if (IsArgumentStruct(GetBasePointer(li->getPointerOperand())))
+                return true;
+        }
+        
+        return m_checked_pointers.count(base) || m_batched_pointer_set.count(base);
+    }
+    
+    //------------------------------------------------------------------
+    /// With batching, a pointer that is computed in the entry block (or
+    /// isn't computed at all) is checked once where it is computed,
+    /// instead of everywhere it is dereferenced.  That covers the
+    /// pointers expressions loop over.
+    //------------------------------------------------------------------
+    bool CanBatch(llvm::Value *base)
+    {
+        if (isa<llvm::Constant> (base) || isa<llvm::Argument> (base))
+            return true;
+        
+        llvm::Instruction *def_inst = dyn_cast<llvm::Instruction> (base);
+        
+        return def_inst &&
+               !isa<llvm::TerminatorInst> (def_inst) &&
+               !isa<llvm::PHINode> (def_inst) &&
+               def_inst->getParent() == &m_function->getEntryBlock();
+    }
+    
+    bool InspectFunction(llvm::Function &f)
+    {
+        m_function = &f;
+        
+        return Instrumenter::InspectFunction(f);
+    }
+    
+    bool InspectBasicBlock(llvm::BasicBlock &bb)
+    {
+        // Checks only cover the dereferences that come after them in the
+        // same block; other blocks may be reached without passing them
+        m_checked_pointers.clear();
+        
+        return Instrumenter::InspectBasicBlock(bb);
     }
     
     bool InspectInstruction(llvm::Instruction &i)
     {
-        if (dyn_cast<llvm::LoadInst> (&i) ||
-            dyn_cast<llvm::StoreInst> (&i))
-            RegisterInstruction(i);
+        llvm::Value *dereferenced_ptr = GetDereferencedPointer(&i);
+        
+        if (!dereferenced_ptr || IsKnownValid(dereferenced_ptr))
+            return true;
+        
+        llvm::Value *base = GetBasePointer(dereferenced_ptr);
+        
+        if (m_batch_checks && CanBatch(base))
+        {
+            m_batched_pointers.push_back(base);
+            m_batched_pointer_set.insert(base);
+            return true;
+        }
+        
+        RegisterInstruction(i);
+        m_checked_pointers.insert(base);
         
         return true;
     }
     
     llvm::Value         *m_valid_pointer_check_func;
+    bool                 m_batch_checks;            ///< True if checks should be hoisted into the entry block where possible
+    llvm::Function      *m_function;                ///< The function being inspected
+    ValueSet             m_checked_pointers;        ///< Base pointers checked earlier in the current block
+    ValueVector          m_batched_pointers;        ///< Base pointers to check once, in the order they were found
+    ValueSet             m_batched_pointer_set;     ///< The same pointers, for lookups
 };
 
 class ObjcObjectChecker : public Instrumenter
@@ -590,10 +750,12 @@ private:
 };
 
 IRDynamicChecks::IRDynamicChecks(DynamicCheckerFunctions &checker_functions,
-                                 const char *func_name) :
+                                 const char *func_name,
+                                 bool batch_checks) :
     ModulePass(ID),
     m_func_name(func_name),
-    m_checker_functions(checker_functions)
+    m_checker_functions(checker_functions),
+    m_batch_checks(batch_checks)
 {
 }
 
@@ -618,13 +780,16 @@ IRDynamicChecks::runOnModule(llvm::Module &M)
 
     if (m_checker_functions.m_valid_pointer_check.get())
     {
-        ValidPointerChecker vpc(M, m_checker_functions);
+        ValidPointerChecker vpc(M, m_checker_functions, m_batch_checks);
         
         if (!vpc.Inspect(*function))
             return false;
         
         if (!vpc.Instrument())
             return false;
+        
+        if (!vpc.InstrumentBatchedChecks())
+            return false;
     }
     
     if (m_checker_functions.m_objc_object_check.get())
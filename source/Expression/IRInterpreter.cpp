@@ -15,6 +15,8 @@
 #include "lldb/Expression/IRForTarget.h"
 #include "lldb/Expression/IRInterpreter.h"
 
+#include "clang/AST/Decl.h"
+
 #include "llvm/Constants.h"
 #include "llvm/Function.h"
 #include "llvm/Instructions.h"
@@ -23,6 +25,8 @@
 #include "llvm/Target/TargetData.h"
 
 #include <map>
+#include <math.h>
+#include <string.h>
 
 using namespace llvm;
 
@@ -70,6 +74,138 @@ PrintType(const Type *type, bool truncate = false)
     return s;
 }
 
+// Integers are interpreted at most 64 bits at a time, and the only
+// floating point types that are handled are float and double.
+static bool
+CanInterpretType (Type *type)
+{
+    if (type->isIntegerTy())
+        return cast<IntegerType>(type)->getBitWidth() <= 64;
+    
+    return type->isPointerTy() || type->isFloatTy() || type->isDoubleTy();
+}
+
+static unsigned
+BitWidthOfType (Type *type, TargetData &target_data)
+{
+    if (type->isPointerTy())
+        return target_data.getPointerSizeInBits();
+    
+    return type->getPrimitiveSizeInBits();
+}
+
+static uint64_t
+TruncateBits (uint64_t value, unsigned bit_width)
+{
+    if (bit_width >= 64)
+        return value;
+    
+    return value & ((1ull << bit_width) - 1);
+}
+
+static int64_t
+SignExtendBits (uint64_t value, unsigned bit_width)
+{
+    if (bit_width >= 64 || bit_width == 0)
+        return (int64_t)value;
+    
+    const uint64_t sign_bit = 1ull << (bit_width - 1);
+    value = TruncateBits(value, bit_width);
+    return (int64_t)((value ^ sign_bit) - sign_bit);
+}
+
+// Floating point values are carried around as their bit patterns, like
+// the values in the interpreter's memory.  float arithmetic is done in
+// double and rounded back, which gives the same result for the basic
+// operations because double has more than twice float's precision.
+static bool
+BitsToDouble (double &value, uint64_t bits, Type *type)
+{
+    if (type->isFloatTy())
+    {
+        uint32_t float_bits = (uint32_t)bits;
+        float float_value;
+        memcpy (&float_value, &float_bits, sizeof(float_value));
+        value = float_value;
+        return true;
+    }
+    else if (type->isDoubleTy())
+    {
+        memcpy (&value, &bits, sizeof(value));
+        return true;
+    }
+    
+    return false;
+}
+
+static bool
+DoubleToBits (uint64_t &bits, double value, Type *type)
+{
+    if (type->isFloatTy())
+    {
+        float float_value = (float)value;
+        uint32_t float_bits;
+        memcpy (&float_bits, &float_value, sizeof(float_bits));
+        bits = float_bits;
+        return true;
+    }
+    else if (type->isDoubleTy())
+    {
+        memcpy (&bits, &value, sizeof(bits));
+        return true;
+    }
+    
+    return false;
+}
+
+// The library functions that the interpreter runs itself instead of
+// calling into the target.  They have no side effects and only read
+// memory, so running them in the debugger gives the same answer.
+enum PureFunction
+{
+    ePureFunctionNone,
+    ePureFunctionStrlen,
+    ePureFunctionStrcmp,
+    ePureFunctionStrncmp,
+    ePureFunctionMemcmp
+};
+
+static PureFunction
+PureFunctionForCall (const CallInst *call_inst, Module &module)
+{
+    const Function *callee = call_inst->getCalledFunction();
+    
+    if (!callee || !callee->isDeclaration())
+        return ePureFunctionNone;
+    
+    // The IR name may be mangled if the function's declaration came from
+    // the symbol table, so go by the name of the Decl when there is one.
+    std::string name = callee->getName().str();
+    
+    if (clang::NamedDecl *decl = IRForTarget::DeclForGlobal(callee, &module))
+    {
+        clang::FunctionDecl *function_decl = dyn_cast<clang::FunctionDecl>(decl);
+        
+        if (!function_decl || !function_decl->getDeclContext()->isTranslationUnit())
+            return ePureFunctionNone;
+        
+        name = function_decl->getNameAsString();
+    }
+    
+    unsigned num_args = call_inst->getNumArgOperands();
+    
+    if (name == "strlen" && num_args == 1)
+        return ePureFunctionStrlen;
+    if (name == "strcmp" && num_args == 2)
+        return ePureFunctionStrcmp;
+    if (name == "strncmp" && num_args == 3)
+        return ePureFunctionStrncmp;
+    if (name == "memcmp" && num_args == 3)
+        return ePureFunctionMemcmp;
+    
+    return ePureFunctionNone;
+}
+
 typedef STD_SHARED_PTR(lldb_private::DataEncoder) DataEncoderSP;
 typedef STD_SHARED_PTR(lldb_private::DataExtractor) DataExtractorSP;
 
@@ -361,6 +497,22 @@ public:
         return m_decl_map.ReadTarget(data, source, length);
     }
     
+    // Read from either one of our allocations or the target, whichever
+    // the address belongs to.  Reads can't run past the end of an
+    // allocation.
+    bool ReadFromAnyPtr (uint8_t *data, lldb::addr_t addr, size_t length)
+    {
+        MemoryMap::iterator i = LookupInternal(addr);
+        
+        if (i == m_memory.end())
+            return ReadFromRawPtr(data, addr, length);
+        
+        if (addr + length > (*i)->m_virtual_address + (*i)->m_extent)
+            return false;
+        
+        return Read(data, addr, length);
+    }
+    
     std::string PrintData (lldb::addr_t addr, size_t length)
     {
         lldb_private::Value target = GetAccessTarget(addr);
@@ -411,6 +563,7 @@ public:
     TargetData                             &m_target_data;
     lldb_private::ClangExpressionDeclMap   &m_decl_map;
     const BasicBlock                       *m_bb;
+    const BasicBlock                       *m_prev_bb;
     BasicBlock::const_iterator              m_ii;
     BasicBlock::const_iterator              m_ie;
     
@@ -422,7 +575,9 @@ public:
                            lldb_private::ClangExpressionDeclMap &decl_map) :
         m_memory (memory),
         m_target_data (target_data),
-        m_decl_map (decl_map)
+        m_decl_map (decl_map),
+        m_bb (NULL),
+        m_prev_bb (NULL)
     {
         m_byte_order = (target_data.isLittleEndian() ? lldb::eByteOrderLittle : lldb::eByteOrderBig);
         m_addr_byte_size = (target_data.getPointerSize());
@@ -430,6 +585,7 @@ public:
     
     void Jump (const BasicBlock *bb)
     {
+        m_prev_bb = m_bb;
         m_bb = bb;
         m_ii = m_bb->begin();
         m_ie = m_bb->end();
@@ -492,10 +648,10 @@ public:
         
         if (constant)
         {
-            if (const ConstantInt *constant_int = dyn_cast<ConstantInt>(constant))
-            {                
-                return AssignToMatchType(scalar, constant_int->getLimitedValue(), value->getType());
-            }
+            APInt constant_value;
+            
+            if (ResolveConstantValue(constant_value, constant, module))
+                return AssignToMatchType(scalar, constant_value.getLimitedValue(), value->getType());
         }
         else
         {
@@ -539,7 +695,22 @@ public:
         return true;
     }
     
-    bool ResolveConstantValue (APInt &value, const Constant *constant)
+    // String literals and other constant data the expression carries
+    // with it, which the interpreter keeps in its own memory.
+    static bool IsConstantData (const Value *value)
+    {
+        const GlobalVariable *global_variable = dyn_cast<GlobalVariable>(value);
+        
+        if (!global_variable || !global_variable->isConstant() || !global_variable->hasInitializer())
+            return false;
+        
+        const ConstantDataSequential *data = dyn_cast<ConstantDataSequential>(global_variable->getInitializer());
+        
+        // The initializer is in host byte order, so stick to byte arrays.
+        return data && data->getElementByteSize() == 1;
+    }
+    
+    bool ResolveConstantValue (APInt &value, const Constant *constant, Module &module)
     {
         if (const ConstantInt *constant_int = dyn_cast<ConstantInt>(constant))
         {
@@ -551,6 +722,27 @@ public:
             value = constant_fp->getValueAPF().bitcastToAPInt();
             return true;
         }
+        else if (isa<ConstantPointerNull>(constant))
+        {
+            value = APInt(m_target_data.getPointerSizeInBits(), 0);
+            return true;
+        }
+        else if (IsConstantData(constant))
+        {
+            Memory::Region region = ResolveValue(constant, module);
+            
+            if (region.IsInvalid())
+                return false;
+            
+            DataExtractorSP region_extractor = m_memory.GetExtractor(region);
+            
+            if (!region_extractor)
+                return false;
+            
+            uint32_t offset = 0;
+            value = APInt(m_target_data.getPointerSizeInBits(), region_extractor->GetAddress(&offset));
+            return true;
+        }
         else if (const ConstantExpr *constant_expr = dyn_cast<ConstantExpr>(constant))
         {
             switch (constant_expr->getOpcode())
@@ -558,8 +750,9 @@ public:
                 default:
                     return false;
                 case Instruction::IntToPtr:
+                case Instruction::PtrToInt:
                 case Instruction::BitCast:
-                    return ResolveConstantValue(value, constant_expr->getOperand(0));
+                    return ResolveConstantValue(value, constant_expr->getOperand(0), module);
                 case Instruction::GetElementPtr:
                 {
                     ConstantExpr::const_op_iterator op_cursor = constant_expr->op_begin();
@@ -570,7 +763,7 @@ public:
                     if (!base)
                         return false;
                     
-                    if (!ResolveConstantValue(value, base))
+                    if (!ResolveConstantValue(value, base, module))
                         return false;
                     
                     op_cursor++;
@@ -593,11 +786,11 @@ public:
         return false;
     }
     
-    bool ResolveConstant (Memory::Region &region, const Constant *constant)
+    bool ResolveConstant (Memory::Region &region, const Constant *constant, Module &module)
     {
         APInt resolved_value;
         
-        if (!ResolveConstantValue(resolved_value, constant))
+        if (!ResolveConstantValue(resolved_value, constant, module))
             return false;
         
         const uint64_t *raw_data = resolved_value.getRawData();
@@ -773,6 +966,36 @@ public:
         }
         while(0);
         
+        if (IsConstantData(value))
+        {
+            // Copy the data into an allocation of its own.  The value of the
+            // global is the address of that allocation.
+            
+            const ConstantDataSequential *data = cast<ConstantDataSequential>(cast<GlobalVariable>(value)->getInitializer());
+            StringRef raw_data = data->getRawDataValues();
+            
+            Memory::Region data_region = m_memory.Malloc(raw_data.size(), m_target_data.getPrefTypeAlignment(data->getType()));
+            
+            if (data_region.IsInvalid())
+                return Memory::Region();
+            
+            Memory::Region pointer_region = m_memory.Malloc(value->getType());
+            
+            if (pointer_region.IsInvalid())
+                return Memory::Region();
+            
+            if (!m_memory.Write(data_region.m_base, (const uint8_t*)raw_data.data(), raw_data.size()))
+                return Memory::Region();
+            
+            DataEncoderSP pointer_encoder = m_memory.GetEncoder(pointer_region);
+            
+            if (pointer_encoder->PutAddress(0, data_region.m_base) == UINT32_MAX)
+                return Memory::Region();
+            
+            m_values[value] = pointer_region;
+            return pointer_region;
+        }
+        
         // Fall back and allocate space [allocation type Alloca]
         
         Type *type = value->getType();
@@ -791,7 +1014,7 @@ public:
             if (!constant)
                 break;
             
-            if (!ResolveConstant (data_region, constant))
+            if (!ResolveConstant (data_region, constant, module))
                 return Memory::Region();
         }
         while(0);
@@ -800,6 +1023,93 @@ public:
         return data_region;
     }
     
+    // Read up to a page boundary at a time, so a string that ends just
+    // before unreadable memory can still be read.
+    static size_t ChunkSize (lldb::addr_t addr, uint64_t remaining)
+    {
+        const uint64_t chunk_alignment = 256;
+        uint64_t chunk_size = chunk_alignment - (addr % chunk_alignment);
+        
+        return (size_t)(chunk_size < remaining ? chunk_size : remaining);
+    }
+    
+    bool ReadChunk (uint8_t *data, lldb::addr_t addr, size_t &length)
+    {
+        if (m_memory.ReadFromAnyPtr(data, addr, length))
+            return true;
+        
+        // Allocations of our own don't end on chunk boundaries.
+        length = 1;
+        return m_memory.ReadFromAnyPtr(data, addr, length);
+    }
+    
+    bool StringLength (uint64_t &length, lldb::addr_t addr, uint64_t max_length)
+    {
+        uint8_t buffer[256];
+        
+        length = 0;
+        
+        while (length < max_length)
+        {
+            size_t chunk_size = ChunkSize(addr + length, max_length - length);
+            
+            if (!ReadChunk(buffer, addr + length, chunk_size))
+                return false;
+            
+            const uint8_t *nul = (const uint8_t *)memchr(buffer, 0, chunk_size);
+            
+            if (nul)
+            {
+                length += (nul - buffer);
+                return true;
+            }
+            
+            length += chunk_size;
+        }
+        
+        return false;
+    }
+    
+    // Compares like memcmp(), or like strncmp() if stop_at_nul is true.
+    bool CompareMemory (int &result, lldb::addr_t lhs, lldb::addr_t rhs, uint64_t length, bool stop_at_nul)
+    {
+        uint8_t lhs_buffer[256];
+        uint8_t rhs_buffer[256];
+        
+        result = 0;
+        
+        uint64_t offset = 0;
+        
+        while (offset < length)
+        {
+            size_t lhs_size = ChunkSize(lhs + offset, length - offset);
+            size_t rhs_size = ChunkSize(rhs + offset, length - offset);
+            size_t chunk_size = (lhs_size < rhs_size ? lhs_size : rhs_size);
+            
+            if (!ReadChunk(lhs_buffer, lhs + offset, chunk_size))
+                return false;
+            
+            if (!ReadChunk(rhs_buffer, rhs + offset, chunk_size))
+                return false;
+            
+            for (size_t i = 0; i < chunk_size; ++i)
+            {
+                if (lhs_buffer[i] != rhs_buffer[i])
+                {
+                    result = (lhs_buffer[i] < rhs_buffer[i] ? -1 : 1);
+                    return true;
+                }
+                
+                if (stop_at_nul && lhs_buffer[i] == 0)
+                    return true;
+            }
+            
+            offset += chunk_size;
+        }
+        
+        return true;
+    }
+    
     bool ConstructResult (lldb::ClangExpressionVariableSP &result,
                           const GlobalValue *result_value,
                           const lldb_private::ConstString &result_name,
@@ -920,6 +1230,14 @@ static const char *memory_read_error                = "Interpreter couldn't read
 static const char *infinite_loop_error              = "Interpreter ran for too many cycles";
 static const char *bad_result_error                 = "Result of expression is in bad memory";
 
+// The most bytes the interpreter's strlen() and friends look at before
+// they give up and leave the call to the target.
+static const uint64_t max_pure_function_bytes       = 64 * 1024;
+
+// The most instructions the interpreter runs before it decides the
+// expression is in an infinite loop.
+static const uint32_t max_interpreted_instructions  = 64 * 1024;
+
 bool
 IRInterpreter::supportsFunction (Function &llvm_function, 
                                  lldb_private::Error &err)
@@ -944,12 +1262,79 @@ IRInterpreter::supportsFunction (Function &llvm_function,
                     err.SetErrorString(unsupported_opcode_error);
                     return false;
                 }
-            case Instruction::Add:
             case Instruction::Alloca:
             case Instruction::BitCast:
             case Instruction::Br:
             case Instruction::GetElementPtr:
                 break;
+            case Instruction::Add:
+            case Instruction::Sub:
+            case Instruction::Mul:
+            case Instruction::SDiv:
+            case Instruction::UDiv:
+            case Instruction::SRem:
+            case Instruction::URem:
+            case Instruction::Shl:
+            case Instruction::LShr:
+            case Instruction::AShr:
+            case Instruction::And:
+            case Instruction::Or:
+            case Instruction::Xor:
+            case Instruction::FAdd:
+            case Instruction::FSub:
+            case Instruction::FMul:
+            case Instruction::FDiv:
+            case Instruction::Trunc:
+            case Instruction::ZExt:
+            case Instruction::SExt:
+            case Instruction::FPTrunc:
+            case Instruction::FPExt:
+            case Instruction::FPToUI:
+            case Instruction::FPToSI:
+            case Instruction::UIToFP:
+            case Instruction::SIToFP:
+            case Instruction::PtrToInt:
+            case Instruction::IntToPtr:
+            case Instruction::FCmp:
+            case Instruction::Select:
+            case Instruction::PHI:
+                {
+                    // Check the type of the result and of the first operand,
+                    // which covers the source type of casts and the type that
+                    // comparisons compare.
+                    
+                    if (!CanInterpretType(ii->getType()) ||
+                        !CanInterpretType(ii->getOperand(ii->getOpcode() == Instruction::Select ? 1 : 0)->getType()))
+                    {
+                        if (log)
+                            log->Printf("Unsupported type: %s", PrintValue(ii).c_str());
+                        err.SetErrorToGenericError();
+                        err.SetErrorString(unsupported_opcode_error);
+                        return false;
+                    }
+                }
+                break;
+            case Instruction::Call:
+                {
+                    CallInst *call_inst = dyn_cast<CallInst>(ii);
+                    
+                    if (!call_inst)
+                    {
+                        err.SetErrorToGenericError();
+                        err.SetErrorString(interpreter_internal_error);
+                        return false;
+                    }
+                    
+                    if (PureFunctionForCall(call_inst, *llvm_function.getParent()) == ePureFunctionNone)
+                    {
+                        if (log)
+                            log->Printf("Unsupported function call: %s", PrintValue(ii).c_str());
+                        err.SetErrorToGenericError();
+                        err.SetErrorString(unsupported_opcode_error);
+                        return false;
+                    }
+                }
+                break;
             case Instruction::ICmp:
                 {
                     ICmpInst *icmp_inst = dyn_cast<ICmpInst>(ii);
@@ -986,15 +1371,9 @@ IRInterpreter::supportsFunction (Function &llvm_function,
                     }
                 }
                 break;
-            case Instruction::IntToPtr:
             case Instruction::Load:
-            case Instruction::Mul:
             case Instruction::Ret:
-            case Instruction::SDiv:
             case Instruction::Store:
-            case Instruction::Sub:
-            case Instruction::UDiv:
-            case Instruction::ZExt:
                 break;
             }
         }
@@ -1068,7 +1447,7 @@ IRInterpreter::runOnFunction (lldb::ClangExpressionVariableSP &result,
     
     frame.Jump(llvm_function.begin());
     
-    while (frame.m_ii != frame.m_ie && (++num_insts < 4096))
+    while (frame.m_ii != frame.m_ie && (++num_insts < max_interpreted_instructions))
     {
         const Instruction *inst = frame.m_ii;
         
@@ -1084,6 +1463,18 @@ IRInterpreter::runOnFunction (lldb::ClangExpressionVariableSP &result,
         case Instruction::Mul:
         case Instruction::SDiv:
         case Instruction::UDiv:
+        case Instruction::SRem:
+        case Instruction::URem:
+        case Instruction::Shl:
+        case Instruction::LShr:
+        case Instruction::AShr:
+        case Instruction::And:
+        case Instruction::Or:
+        case Instruction::Xor:
+        case Instruction::FAdd:
+        case Instruction::FSub:
+        case Instruction::FMul:
+        case Instruction::FDiv:
             {
                 const BinaryOperator *bin_op = dyn_cast<BinaryOperator>(inst);
                 
@@ -1120,28 +1511,122 @@ IRInterpreter::runOnFunction (lldb::ClangExpressionVariableSP &result,
                     return false;
                 }
                 
-                lldb_private::Scalar result;
+                // Work on the values' bits, the way the instructions are
+                // defined, rather than relying on the Scalars' types.
+                
+                Type *type = inst->getType();
+                const unsigned bit_width = BitWidthOfType(type, target_data);
+                const uint64_t l = L.GetRawBits64(0);
+                const uint64_t r = R.GetRawBits64(0);
+                const int64_t sl = SignExtendBits(l, bit_width);
+                const int64_t sr = SignExtendBits(r, bit_width);
+                
+                bool valid = true;
+                uint64_t result_bits = 0;
                 
                 switch (inst->getOpcode())
                 {
                 default:
+                    valid = false;
                     break;
                 case Instruction::Add:
-                    result = L + R;
-                    break;
-                case Instruction::Mul:
-                    result = L * R;
+                    result_bits = l + r;
                     break;
                 case Instruction::Sub:
-                    result = L - R;
+                    result_bits = l - r;
+                    break;
+                case Instruction::Mul:
+                    result_bits = l * r;
                     break;
                 case Instruction::SDiv:
-                    result = L / R;
+                case Instruction::SRem:
+                    // Division by zero and INT_MIN / -1 are undefined; leave
+                    // them to the target.
+                    if (sr == 0 || (sr == -1 && sl == SignExtendBits(1ull << (bit_width - 1), bit_width)))
+                        valid = false;
+                    else if (inst->getOpcode() == Instruction::SDiv)
+                        result_bits = (uint64_t)(sl / sr);
+                    else
+                        result_bits = (uint64_t)(sl % sr);
                     break;
                 case Instruction::UDiv:
-                    result = L.GetRawBits64(0) / R.GetRawBits64(1);
+                case Instruction::URem:
+                    if (TruncateBits(r, bit_width) == 0)
+                        valid = false;
+                    else if (inst->getOpcode() == Instruction::UDiv)
+                        result_bits = TruncateBits(l, bit_width) / TruncateBits(r, bit_width);
+                    else
+                        result_bits = TruncateBits(l, bit_width) % TruncateBits(r, bit_width);
+                    break;
+                case Instruction::Shl:
+                case Instruction::LShr:
+                case Instruction::AShr:
+                    if (TruncateBits(r, bit_width) >= bit_width)
+                        valid = false;
+                    else if (inst->getOpcode() == Instruction::Shl)
+                        result_bits = l << r;
+                    else if (inst->getOpcode() == Instruction::LShr)
+                        result_bits = TruncateBits(l, bit_width) >> r;
+                    else
+                        result_bits = (uint64_t)(sl >> r);
+                    break;
+                case Instruction::And:
+                    result_bits = l & r;
+                    break;
+                case Instruction::Or:
+                    result_bits = l | r;
+                    break;
+                case Instruction::Xor:
+                    result_bits = l ^ r;
+                    break;
+                case Instruction::FAdd:
+                case Instruction::FSub:
+                case Instruction::FMul:
+                case Instruction::FDiv:
+                    {
+                        double dl;
+                        double dr;
+                        double dresult = 0.0;
+                        
+                        if (!BitsToDouble(dl, l, type) || !BitsToDouble(dr, r, type))
+                        {
+                            valid = false;
+                            break;
+                        }
+                        
+                        switch (inst->getOpcode())
+                        {
+                        default:
+                            break;
+                        case Instruction::FAdd:
+                            dresult = dl + dr;
+                            break;
+                        case Instruction::FSub:
+                            dresult = dl - dr;
+                            break;
+                        case Instruction::FMul:
+                            dresult = dl * dr;
+                            break;
+                        case Instruction::FDiv:
+                            dresult = dl / dr;
+                            break;
+                        }
+                        
+                        valid = DoubleToBits(result_bits, dresult, type);
+                    }
                     break;
                 }
+                
+                if (!valid)
+                {
+                    if (log)
+                        log->Printf("Couldn't interpret %s", PrintValue(inst).c_str());
+                    err.SetErrorToGenericError();
+                    err.SetErrorString(unsupported_opcode_error);
+                    return false;
+                }
+                
+                lldb_private::Scalar result = (unsigned long long)TruncateBits(result_bits, bit_width);
                                 
                 frame.AssignValue(inst, result, llvm_module);
                 
@@ -1228,14 +1713,24 @@ IRInterpreter::runOnFunction (lldb::ClangExpressionVariableSP &result,
             }
             break;
         case Instruction::BitCast:
+        case Instruction::Trunc:
         case Instruction::ZExt:
+        case Instruction::SExt:
+        case Instruction::FPTrunc:
+        case Instruction::FPExt:
+        case Instruction::FPToUI:
+        case Instruction::FPToSI:
+        case Instruction::UIToFP:
+        case Instruction::SIToFP:
+        case Instruction::PtrToInt:
+        case Instruction::IntToPtr:
             {
                 const CastInst *cast_inst = dyn_cast<CastInst>(inst);
                 
                 if (!cast_inst)
                 {
                     if (log)
-                        log->Printf("getOpcode() returns %s, but instruction is not a BitCastInst", cast_inst->getOpcodeName());
+                        log->Printf("getOpcode() returns %s, but instruction is not a CastInst", inst->getOpcodeName());
                     err.SetErrorToGenericError();
                     err.SetErrorString(interpreter_internal_error);
                     return false;
@@ -1254,7 +1749,86 @@ IRInterpreter::runOnFunction (lldb::ClangExpressionVariableSP &result,
                     return false;
                 }
                 
-                frame.AssignValue(inst, S, llvm_module);
+                Type *source_type = source->getType();
+                Type *dest_type = cast_inst->getType();
+                const unsigned source_width = BitWidthOfType(source_type, target_data);
+                const unsigned dest_width = BitWidthOfType(dest_type, target_data);
+                const uint64_t bits = TruncateBits(S.GetRawBits64(0), source_width);
+                
+                bool valid = true;
+                uint64_t result_bits = bits;
+                
+                switch (inst->getOpcode())
+                {
+                default:
+                    // BitCast, Trunc, ZExt, PtrToInt and IntToPtr just keep
+                    // as many of the bits as fit.
+                    break;
+                case Instruction::SExt:
+                    result_bits = (uint64_t)SignExtendBits(bits, source_width);
+                    break;
+                case Instruction::FPTrunc:
+                case Instruction::FPExt:
+                    {
+                        double value;
+                        valid = BitsToDouble(value, bits, source_type) && DoubleToBits(result_bits, value, dest_type);
+                    }
+                    break;
+                case Instruction::FPToUI:
+                case Instruction::FPToSI:
+                    {
+                        double value;
+                        
+                        // Values that don't fit in the destination are undefined.
+                        const double limit = ldexp(1.0, dest_width - (inst->getOpcode() == Instruction::FPToSI ? 1 : 0));
+                        
+                        if (!BitsToDouble(value, bits, source_type) ||
+                            value != value ||
+                            value >= limit ||
+                            (inst->getOpcode() == Instruction::FPToSI ? value < -limit : value <= -1.0))
+                            valid = false;
+                        else if (inst->getOpcode() == Instruction::FPToSI)
+                            result_bits = (uint64_t)(int64_t)value;
+                        else
+                            result_bits = (uint64_t)value;
+                    }
+                    break;
+                case Instruction::UIToFP:
+                case Instruction::SIToFP:
+                    // Convert straight to the destination type, so the value
+                    // is only rounded once.
+                    if (dest_type->isFloatTy())
+                    {
+                        float value = (inst->getOpcode() == Instruction::SIToFP ? (float)SignExtendBits(bits, source_width) : (float)bits);
+                        valid = DoubleToBits(result_bits, value, dest_type);
+                    }
+                    else
+                    {
+                        double value = (inst->getOpcode() == Instruction::SIToFP ? (double)SignExtendBits(bits, source_width) : (double)bits);
+                        valid = DoubleToBits(result_bits, value, dest_type);
+                    }
+                    break;
+                }
+                
+                if (!valid)
+                {
+                    if (log)
+                        log->Printf("Couldn't interpret %s", PrintValue(inst).c_str());
+                    err.SetErrorToGenericError();
+                    err.SetErrorString(unsupported_opcode_error);
+                    return false;
+                }
+                
+                lldb_private::Scalar result = (unsigned long long)TruncateBits(result_bits, dest_width);
+                
+                frame.AssignValue(inst, result, llvm_module);
+                
+                if (log)
+                {
+                    log->Printf("Interpreted a %s", inst->getOpcodeName());
+                    log->Printf("  Src : %s", frame.SummarizeValue(source).c_str());
+                    log->Printf("  =   : %s", frame.SummarizeValue(inst).c_str());
+                }
             }
             break;
         case Instruction::Br:
@@ -1423,6 +1997,12 @@ IRInterpreter::runOnFunction (lldb::ClangExpressionVariableSP &result,
                     return false;
                 }
                 
+                const unsigned bit_width = BitWidthOfType(lhs->getType(), target_data);
+                const uint64_t l = TruncateBits(L.GetRawBits64(0), bit_width);
+                const uint64_t r = TruncateBits(R.GetRawBits64(0), bit_width);
+                const int64_t sl = SignExtendBits(l, bit_width);
+                const int64_t sr = SignExtendBits(r, bit_width);
+                
                 lldb_private::Scalar result;
 
                 switch (predicate)
@@ -1430,34 +2010,34 @@ IRInterpreter::runOnFunction (lldb::ClangExpressionVariableSP &result,
                 default:
                     return false;
                 case CmpInst::ICMP_EQ:
-                    result = (L == R);
+                    result = (l == r);
                     break;
                 case CmpInst::ICMP_NE:
-                    result = (L != R);
+                    result = (l != r);
                     break;    
                 case CmpInst::ICMP_UGT:
-                    result = (L.GetRawBits64(0) > R.GetRawBits64(0));
+                    result = (l > r);
                     break;
                 case CmpInst::ICMP_UGE:
-                    result = (L.GetRawBits64(0) >= R.GetRawBits64(0));
+                    result = (l >= r);
                     break;
                 case CmpInst::ICMP_ULT:
-                    result = (L.GetRawBits64(0) < R.GetRawBits64(0));
+                    result = (l < r);
                     break;
                 case CmpInst::ICMP_ULE:
-                    result = (L.GetRawBits64(0) <= R.GetRawBits64(0));
+                    result = (l <= r);
                     break;
                 case CmpInst::ICMP_SGT:
-                    result = (L > R);
+                    result = (sl > sr);
                     break;
                 case CmpInst::ICMP_SGE:
-                    result = (L >= R);
+                    result = (sl >= sr);
                     break;
                 case CmpInst::ICMP_SLT:
-                    result = (L < R);
+                    result = (sl < sr);
                     break;
                 case CmpInst::ICMP_SLE:
-                    result = (L <= R);
+                    result = (sl <= sr);
                     break;
                 }
                 
@@ -1472,39 +2052,321 @@ IRInterpreter::runOnFunction (lldb::ClangExpressionVariableSP &result,
                 }
             }
             break;
-        case Instruction::IntToPtr:
+        case Instruction::FCmp:
             {
-                const IntToPtrInst *int_to_ptr_inst = dyn_cast<IntToPtrInst>(inst);
+                const FCmpInst *fcmp_inst = dyn_cast<FCmpInst>(inst);
                 
-                if (!int_to_ptr_inst)
+                if (!fcmp_inst)
                 {
                     if (log)
-                        log->Printf("getOpcode() returns IntToPtr, but instruction is not an IntToPtrInst");
+                        log->Printf("getOpcode() returns FCmp, but instruction is not an FCmpInst");
                     err.SetErrorToGenericError();
                     err.SetErrorString(interpreter_internal_error);
                     return false;
                 }
                 
-                Value *src_operand = int_to_ptr_inst->getOperand(0);
+                Value *lhs = inst->getOperand(0);
+                Value *rhs = inst->getOperand(1);
                 
-                lldb_private::Scalar I;
+                lldb_private::Scalar L;
+                lldb_private::Scalar R;
+                
+                if (!frame.EvaluateValue(L, lhs, llvm_module))
+                {
+                    if (log)
+                        log->Printf("Couldn't evaluate %s", PrintValue(lhs).c_str());
+                    err.SetErrorToGenericError();
+                    err.SetErrorString(bad_value_error);
+                    return false;
+                }
                 
-                if (!frame.EvaluateValue(I, src_operand, llvm_module))
+                if (!frame.EvaluateValue(R, rhs, llvm_module))
                 {
                     if (log)
-                        log->Printf("Couldn't evaluate %s", PrintValue(src_operand).c_str());
+                        log->Printf("Couldn't evaluate %s", PrintValue(rhs).c_str());
                     err.SetErrorToGenericError();
                     err.SetErrorString(bad_value_error);
                     return false;
                 }
                 
-                frame.AssignValue(inst, I, llvm_module);
+                double l;
+                double r;
+                
+                if (!BitsToDouble(l, L.GetRawBits64(0), lhs->getType()) ||
+                    !BitsToDouble(r, R.GetRawBits64(0), rhs->getType()))
+                {
+                    if (log)
+                        log->Printf("Couldn't interpret %s", PrintValue(inst).c_str());
+                    err.SetErrorToGenericError();
+                    err.SetErrorString(unsupported_opcode_error);
+                    return false;
+                }
+                
+                // The "O" predicates are false if either side is a NaN, the
+                // "U" predicates are true.
+                const bool unordered = (l != l || r != r);
+                bool compare = false;
+                
+                switch (fcmp_inst->getPredicate())
+                {
+                default:
+                    return false;
+                case CmpInst::FCMP_FALSE:
+                    compare = false;
+                    break;
+                case CmpInst::FCMP_TRUE:
+                    compare = true;
+                    break;
+                case CmpInst::FCMP_ORD:
+                    compare = !unordered;
+                    break;
+                case CmpInst::FCMP_UNO:
+                    compare = unordered;
+                    break;
+                case CmpInst::FCMP_OEQ:
+                    compare = !unordered && l == r;
+                    break;
+                case CmpInst::FCMP_ONE:
+                    compare = !unordered && l != r;
+                    break;
+                case CmpInst::FCMP_OGT:
+                    compare = !unordered && l > r;
+                    break;
+                case CmpInst::FCMP_OGE:
+                    compare = !unordered && l >= r;
+                    break;
+                case CmpInst::FCMP_OLT:
+                    compare = !unordered && l < r;
+                    break;
+                case CmpInst::FCMP_OLE:
+                    compare = !unordered && l <= r;
+                    break;
+                case CmpInst::FCMP_UEQ:
+                    compare = unordered || l == r;
+                    break;
+                case CmpInst::FCMP_UNE:
+                    compare = unordered || l != r;
+                    break;
+                case CmpInst::FCMP_UGT:
+                    compare = unordered || l > r;
+                    break;
+                case CmpInst::FCMP_UGE:
+                    compare = unordered || l >= r;
+                    break;
+                case CmpInst::FCMP_ULT:
+                    compare = unordered || l < r;
+                    break;
+                case CmpInst::FCMP_ULE:
+                    compare = unordered || l <= r;
+                    break;
+                }
+                
+                lldb_private::Scalar result = (compare ? 1 : 0);
+                
+                frame.AssignValue(inst, result, llvm_module);
                 
                 if (log)
                 {
-                    log->Printf("Interpreted an IntToPtr");
-                    log->Printf("  Src : %s", frame.SummarizeValue(src_operand).c_str());
-                    log->Printf("  =   : %s", frame.SummarizeValue(inst).c_str()); 
+                    log->Printf("Interpreted an FCmpInst");
+                    log->Printf("  L : %s", frame.SummarizeValue(lhs).c_str());
+                    log->Printf("  R : %s", frame.SummarizeValue(rhs).c_str());
+                    log->Printf("  = : %s", frame.SummarizeValue(inst).c_str());
+                }
+            }
+            break;
+        case Instruction::Select:
+            {
+                const SelectInst *select_inst = dyn_cast<SelectInst>(inst);
+                
+                if (!select_inst)
+                {
+                    if (log)
+                        log->Printf("getOpcode() returns Select, but instruction is not a SelectInst");
+                    err.SetErrorToGenericError();
+                    err.SetErrorString(interpreter_internal_error);
+                    return false;
+                }
+                
+                const Value *condition = select_inst->getCondition();
+                
+                lldb_private::Scalar C;
+                
+                if (!frame.EvaluateValue(C, condition, llvm_module))
+                {
+                    if (log)
+                        log->Printf("Couldn't evaluate %s", PrintValue(condition).c_str());
+                    err.SetErrorToGenericError();
+                    err.SetErrorString(bad_value_error);
+                    return false;
+                }
+                
+                const Value *selected = (C.GetRawBits64(0) & 1) ? select_inst->getTrueValue() : select_inst->getFalseValue();
+                
+                lldb_private::Scalar S;
+                
+                if (!frame.EvaluateValue(S, selected, llvm_module))
+                {
+                    if (log)
+                        log->Printf("Couldn't evaluate %s", PrintValue(selected).c_str());
+                    err.SetErrorToGenericError();
+                    err.SetErrorString(bad_value_error);
+                    return false;
+                }
+                
+                frame.AssignValue(inst, S, llvm_module);
+                
+                if (log)
+                {
+                    log->Printf("Interpreted a SelectInst");
+                    log->Printf("  cond : %s", frame.SummarizeValue(condition).c_str());
+                    log->Printf("  =    : %s", frame.SummarizeValue(inst).c_str());
+                }
+            }
+            break;
+        case Instruction::PHI:
+            {
+                // All of a block's PHI nodes take their values at once, on the
+                // edge from the block we came from, so evaluate all of them
+                // before assigning any.
+                
+                typedef std::vector <std::pair <const Instruction *, lldb_private::Scalar> > PHIValues;
+                PHIValues phi_values;
+                
+                BasicBlock::const_iterator pi;
+                
+                for (pi = frame.m_ii; pi != frame.m_ie && isa<PHINode>(&*pi); ++pi)
+                {
+                    const PHINode *phi_node = cast<PHINode>(&*pi);
+                    
+                    int incoming_index = (frame.m_prev_bb ? phi_node->getBasicBlockIndex(frame.m_prev_bb) : -1);
+                    
+                    if (incoming_index < 0)
+                    {
+                        if (log)
+                            log->Printf("PHI node %s has no value for the previous block", PrintValue(phi_node).c_str());
+                        err.SetErrorToGenericError();
+                        err.SetErrorString(interpreter_internal_error);
+                        return false;
+                    }
+                    
+                    const Value *incoming_value = phi_node->getIncomingValue(incoming_index);
+                    
+                    lldb_private::Scalar V;
+                    
+                    if (!frame.EvaluateValue(V, incoming_value, llvm_module))
+                    {
+                        if (log)
+                            log->Printf("Couldn't evaluate %s", PrintValue(incoming_value).c_str());
+                        err.SetErrorToGenericError();
+                        err.SetErrorString(bad_value_error);
+                        return false;
+                    }
+                    
+                    phi_values.push_back(std::make_pair((const Instruction *)phi_node, V));
+                }
+                
+                for (PHIValues::iterator vi = phi_values.begin(), ve = phi_values.end();
+                     vi != ve;
+                     ++vi)
+                {
+                    frame.AssignValue(vi->first, vi->second, llvm_module);
+                    
+                    if (log)
+                        log->Printf("Interpreted a PHINode: %s", frame.SummarizeValue(vi->first).c_str());
+                }
+                
+                frame.m_ii = pi;
+            }
+            continue;
+        case Instruction::Call:
+            {
+                const CallInst *call_inst = dyn_cast<CallInst>(inst);
+                
+                if (!call_inst)
+                {
+                    if (log)
+                        log->Printf("getOpcode() returns Call, but instruction is not a CallInst");
+                    err.SetErrorToGenericError();
+                    err.SetErrorString(interpreter_internal_error);
+                    return false;
+                }
+                
+                PureFunction pure_function = PureFunctionForCall(call_inst, llvm_module);
+                
+                lldb_private::Scalar args[3];
+                
+                for (unsigned arg_index = 0; arg_index < call_inst->getNumArgOperands() && arg_index < 3; ++arg_index)
+                {
+                    const Value *arg = call_inst->getArgOperand(arg_index);
+                    
+                    if (!frame.EvaluateValue(args[arg_index], arg, llvm_module))
+                    {
+                        if (log)
+                            log->Printf("Couldn't evaluate %s", PrintValue(arg).c_str());
+                        err.SetErrorToGenericError();
+                        err.SetErrorString(bad_value_error);
+                        return false;
+                    }
+                }
+                
+                bool valid = false;
+                uint64_t result_bits = 0;
+                
+                switch (pure_function)
+                {
+                case ePureFunctionNone:
+                    break;
+                case ePureFunctionStrlen:
+                    valid = frame.StringLength(result_bits, args[0].GetRawBits64(0), max_pure_function_bytes);
+                    break;
+                case ePureFunctionStrcmp:
+                case ePureFunctionStrncmp:
+                case ePureFunctionMemcmp:
+                    {
+                        uint64_t length = max_pure_function_bytes;
+                        
+                        if (pure_function != ePureFunctionStrcmp)
+                            length = args[2].GetRawBits64(0);
+
+                        int compare = 0;
+                        
+                        // Leave comparisons longer than we're willing to read
+                        // to the target.
+                        if (length <= max_pure_function_bytes)
+                            valid = frame.CompareMemory(compare,
+                                                        args[0].GetRawBits64(0),
+                                                        args[1].GetRawBits64(0),
+                                                        length,
+                                                        pure_function != ePureFunctionMemcmp);
+                        result_bits = (uint64_t)(int64_t)compare;
+                        
+                        if (valid && pure_function == ePureFunctionStrcmp && compare == 0)
+                        {
+                            // Make sure the strings really ended.
+                            uint64_t string_length;
+                            valid = frame.StringLength(string_length, args[0].GetRawBits64(0), max_pure_function_bytes);
+                        }
+                    }
+                    break;
+                }
+                
+                if (!valid)
+                {
+                    if (log)
+                        log->Printf("Couldn't interpret %s", PrintValue(inst).c_str());
+                    err.SetErrorToGenericError();
+                    err.SetErrorString(unsupported_opcode_error);
+                    return false;
+                }
+                
+                lldb_private::Scalar result = (unsigned long long)TruncateBits(result_bits, BitWidthOfType(inst->getType(), target_data));
+                
+                frame.AssignValue(inst, result, llvm_module);
+                
+                if (log)
+                {
+                    log->Printf("Interpreted a call to %s", call_inst->getCalledFunction()->getName().str().c_str());
+                    log->Printf("  = : %s", frame.SummarizeValue(inst).c_str());
                 }
             }
             break;
@@ -1721,7 +2583,7 @@ IRInterpreter::runOnFunction (lldb::ClangExpressionVariableSP &result,
         ++frame.m_ii;
     }
     
-    if (num_insts >= 4096)
+    if (num_insts >= max_interpreted_instructions)
     {
         err.SetErrorToGenericError();
         err.SetErrorString(infinite_loop_error);
@@ -255,7 +255,13 @@ File::Open (const char *path, uint32_t options, uint32_t permissions)
     if (!DescriptorIsValid())
         error.SetErrorToErrno();
     else
+    {
         m_owned = true;
+        // Don't let a cached stat() of the old file, or of no file at
+        // all, hide what we are about to write
+        if (write)
+            FileSpec (path, false).ClearCachedFileInfo();
+    }
     
     return error;
 }
@@ -18,6 +18,7 @@
 
 #include <string.h>
 #include <fstream>
+#include <map>
 
 #include "lldb/Host/Config.h" // Have to include this before we test the define...
 #ifdef LLDB_CONFIG_TILDE_RESOLVES_TO_USER
@@ -35,21 +36,155 @@
 #include "lldb/Core/RegularExpression.h"
 #include "lldb/Core/Stream.h"
 #include "lldb/Host/Host.h"
+#include "lldb/Host/Mutex.h"
 #include "lldb/Utility/CleanUp.h"
 
 using namespace lldb;
 using namespace lldb_private;
 using namespace std;
 
+// Once a cache gets this big it is emptied instead of growing further
+#define FILE_CACHE_MAX_ENTRIES 8192
+
+//----------------------------------------------------------------------
+// The process wide cache of resolved paths and stat() results, see
+// FileSpec::SetFileCacheTimeout().
+//----------------------------------------------------------------------
+struct CachedFileStats
+{
+    TimeValue expiration;
+    bool valid;                 // True if stat() succeeded
+    struct stat stats;
+};
+
+struct CachedResolvedPath
+{
+    TimeValue expiration;
+    std::string path;
+};
+
+typedef std::map<std::string, CachedFileStats> FileStatsCache;
+typedef std::map<std::string, CachedResolvedPath> ResolvedPathCache;
+
+struct FileCache
+{
+    FileCache () :
+        mutex (Mutex::eMutexTypeNormal),
+        stats (),
+        resolved_paths (),
+        generation (0)
+    {
+    }
+
+    Mutex mutex;                // Protects the members below
+    FileStatsCache stats;
+    ResolvedPathCache resolved_paths;
+    uint32_t generation;        // Bumped every time entries are removed
+};
+
+static uint32_t g_file_cache_timeout_sec = 5;
+
+static FileCache &
+GetFileCache ()
+{
+    // Never destroyed, files can still be looked at while the program
+    // exits
+    static FileCache *g_file_cache = new FileCache();
+    return *g_file_cache;
+}
+
+// Results that were looked up while entries were being removed might be
+// stale, so they are only added if the generation is still the same
+static uint32_t
+GetFileCacheGeneration ()
+{
+    FileCache &cache = GetFileCache();
+    Mutex::Locker locker (cache.mutex);
+    return cache.generation;
+}
+
 static bool
 GetFileStats (const FileSpec *file_spec, struct stat *stats_ptr)
 {
     char resolved_path[PATH_MAX];
-    if (file_spec->GetPath (resolved_path, sizeof(resolved_path)))
+    if (!file_spec->GetPath (resolved_path, sizeof(resolved_path)))
+        return false;
+
+    const uint32_t timeout_sec = g_file_cache_timeout_sec;
+    if (timeout_sec == 0)
         return ::stat (resolved_path, stats_ptr) == 0;
+
+    FileCache &cache = GetFileCache();
+    const TimeValue now (TimeValue::Now());
+    uint32_t generation;
+    {
+        Mutex::Locker locker (cache.mutex);
+        FileStatsCache::const_iterator pos = cache.stats.find (resolved_path);
+        if (pos != cache.stats.end() && now < pos->second.expiration)
+        {
+            *stats_ptr = pos->second.stats;
+            return pos->second.valid;
+        }
+        generation = cache.generation;
+    }
+
+    // Don't hold the lock while calling stat(), it can take a while
+    CachedFileStats entry;
+    entry.valid = ::stat (resolved_path, &entry.stats) == 0;
+    entry.expiration = now;
+    entry.expiration.OffsetWithSeconds (timeout_sec);
+    *stats_ptr = entry.stats;
+
+    Mutex::Locker locker (cache.mutex);
+    if (generation == cache.generation)
+    {
+        if (cache.stats.size() >= FILE_CACHE_MAX_ENTRIES)
+            cache.stats.clear();
+        cache.stats[resolved_path] = entry;
+    }
+    return entry.valid;
+}
+
+static bool
+GetCachedResolvedPath (const char *src_path, std::string &resolved_path)
+{
+    if (g_file_cache_timeout_sec == 0)
+        return false;
+
+    FileCache &cache = GetFileCache();
+    const TimeValue now (TimeValue::Now());
+    Mutex::Locker locker (cache.mutex);
+    ResolvedPathCache::const_iterator pos = cache.resolved_paths.find (src_path);
+    if (pos != cache.resolved_paths.end() && now < pos->second.expiration)
+    {
+        resolved_path = pos->second.path;
+        return true;
+    }
     return false;
 }
 
+static void
+AddCachedResolvedPath (const std::string &src_path, const char *resolved_path, uint32_t generation)
+{
+    const uint32_t timeout_sec = g_file_cache_timeout_sec;
+    if (timeout_sec == 0)
+        return;
+
+    CachedResolvedPath entry;
+    entry.expiration = TimeValue::Now();
+    entry.expiration.OffsetWithSeconds (timeout_sec);
+    entry.path = resolved_path;
+
+    FileCache &cache = GetFileCache();
+    Mutex::Locker locker (cache.mutex);
+    if (generation == cache.generation)
+    {
+        if (cache.resolved_paths.size() >= FILE_CACHE_MAX_ENTRIES)
+            cache.resolved_paths.clear();
+        cache.resolved_paths[src_path] = entry;
+    }
+}
+
 #ifdef _WIN32
 char* realpath( const char * name, char * resolved );
 char* basename(char *path);
@@ -198,6 +333,14 @@ FileSpec::Resolve (const char *src_path, char *dst_path, size_t dst_len)
     if (src_path == NULL || src_path[0] == '\0')
         return 0;
 
+    std::string cached_path;
+    if (GetCachedResolvedPath (src_path, cached_path))
+        return ::snprintf(dst_path, dst_len, "%s", cached_path.c_str());
+
+    // Copy the key now, src_path can be the same buffer as dst_path
+    const std::string src_path_key (src_path);
+    const uint32_t generation = GetFileCacheGeneration();
+
     // Glob if needed for ~/, otherwise copy in case src_path is same as dst_path...
     char unglobbed_path[PATH_MAX];
 #ifdef LLDB_CONFIG_TILDE_RESOLVES_TO_USER
@@ -221,15 +364,54 @@ FileSpec::Resolve (const char *src_path, char *dst_path, size_t dst_len)
     if (::realpath (unglobbed_path, resolved_path))
     {
         // Success, copy the resolved path
+        AddCachedResolvedPath (src_path_key, resolved_path, generation);
         return ::snprintf(dst_path, dst_len, "%s", resolved_path);
     }
     else
     {
         // Failed, just copy the unglobbed path
+        AddCachedResolvedPath (src_path_key, unglobbed_path, generation);
         return ::snprintf(dst_path, dst_len, "%s", unglobbed_path);
     }
 }
 
+void
+FileSpec::SetFileCacheTimeout (uint32_t timeout_sec)
+{
+    g_file_cache_timeout_sec = timeout_sec;
+    // Entries that were added with a longer timeout shouldn't outlive
+    // the new one
+    ClearFileCache ();
+}
+
+uint32_t
+FileSpec::GetFileCacheTimeout ()
+{
+    return g_file_cache_timeout_sec;
+}
+
+void
+FileSpec::ClearFileCache ()
+{
+    FileCache &cache = GetFileCache();
+    Mutex::Locker locker (cache.mutex);
+    cache.stats.clear();
+    cache.resolved_paths.clear();
+    ++cache.generation;
+}
+
+void
+FileSpec::ClearCachedFileInfo () const
+{
+    char path[PATH_MAX];
+    if (!GetPath (path, sizeof(path)))
+        return;
+    FileCache &cache = GetFileCache();
+    Mutex::Locker locker (cache.mutex);
+    cache.stats.erase (path);
+    ++cache.generation;
+}
+
 FileSpec::FileSpec() :
     m_directory(),
     m_filename()
@@ -0,0 +1,158 @@
+//===-- FileSpecTable.cpp ---------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "lldb/Host/FileSpecTable.h"
+
+// C Includes
+#include <assert.h>
+#include <string.h>
+// C++ Includes
+#include <map>
+// Other libraries and framework includes
+// Project includes
+#include "lldb/Host/Mutex.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+// Entries live in fixed size chunks that never move, so they can be
+// read without taking the lock while other threads add entries
+#define FILE_SPEC_TABLE_CHUNK_SIZE 16384
+#define FILE_SPEC_TABLE_MAX_CHUNKS 4096
+
+// The uniqued directory and filename strings
+typedef std::pair<const char *, const char *> FileSpecKey;
+typedef std::map<FileSpecKey, uint32_t> FileSpecIndexMap;
+
+struct FileSpecTableStorage
+{
+    FileSpecTableStorage () :
+        mutex (Mutex::eMutexTypeNormal),
+        index_map (),
+        num_entries (1),
+        num_chunks (1)
+    {
+        ::memset (chunks, 0, sizeof(chunks));
+        // Index zero is the empty FileSpec
+        chunks[0] = new FileSpec[FILE_SPEC_TABLE_CHUNK_SIZE];
+    }
+
+    Mutex mutex;                    // Protects the members below when adding entries
+    FileSpecIndexMap index_map;
+    uint32_t num_entries;
+    volatile uint32_t num_chunks;
+    FileSpec *chunks[FILE_SPEC_TABLE_MAX_CHUNKS];
+};
+
+static FileSpecTableStorage &
+GetStorage ()
+{
+    // Never destroyed, declarations can still be around while static
+    // objects are being torn down
+    static FileSpecTableStorage *g_storage = new FileSpecTableStorage();
+    return *g_storage;
+}
+
+// If file_spec is one of the table's own entries, get its index from
+// where it is
+static bool
+GetIndexForEntry (const FileSpecTableStorage &storage, const FileSpec &file_spec, uint32_t &idx)
+{
+    const uint32_t num_chunks = storage.num_chunks;
+    for (uint32_t i=0; i<num_chunks; ++i)
+    {
+        const FileSpec *chunk = storage.chunks[i];
+        if (&file_spec >= chunk && &file_spec < chunk + FILE_SPEC_TABLE_CHUNK_SIZE)
+        {
+            idx = i * FILE_SPEC_TABLE_CHUNK_SIZE + (&file_spec - chunk);
+            return true;
+        }
+    }
+    return false;
+}
+
+uint32_t
+FileSpecTable::GetIndexForFileSpec (const FileSpec &file_spec)
+{
+    FileSpecTableStorage &storage = GetStorage();
+
+    uint32_t idx;
+    if (GetIndexForEntry (storage, file_spec, idx))
+        return idx;
+
+    const ConstString &directory = file_spec.GetDirectory();
+    const ConstString &filename = file_spec.GetFilename();
+    if (!directory && !filename)
+        return 0;
+
+    const FileSpecKey key (directory.GetCString(), filename.GetCString());
+    Mutex::Locker locker (storage.mutex);
+    FileSpecIndexMap::const_iterator pos = storage.index_map.find (key);
+    if (pos != storage.index_map.end())
+    {
+        // Remember that the path was found to be resolved so comparisons
+        // with the entry don't have to resolve it again
+        if (file_spec.IsResolved())
+            storage.chunks[pos->second / FILE_SPEC_TABLE_CHUNK_SIZE][pos->second % FILE_SPEC_TABLE_CHUNK_SIZE].SetIsResolved (true);
+        return pos->second;
+    }
+
+    idx = storage.num_entries;
+    const uint32_t chunk_idx = idx / FILE_SPEC_TABLE_CHUNK_SIZE;
+    if (chunk_idx >= FILE_SPEC_TABLE_MAX_CHUNKS)
+    {
+        // This would take tens of millions of different files
+        assert (!"FileSpecTable is full");
+        return 0;
+    }
+    if (chunk_idx == storage.num_chunks)
+    {
+        storage.chunks[chunk_idx] = new FileSpec[FILE_SPEC_TABLE_CHUNK_SIZE];
+        // The chunk must be visible before the count that lets readers
+        // look at it
+        __sync_synchronize();
+        ++storage.num_chunks;
+    }
+    storage.chunks[chunk_idx][idx % FILE_SPEC_TABLE_CHUNK_SIZE] = file_spec;
+    ++storage.num_entries;
+    storage.index_map[key] = idx;
+    return idx;
+}
+
+uint32_t
+FileSpecTable::FindIndexForFileSpec (const FileSpec &file_spec)
+{
+    FileSpecTableStorage &storage = GetStorage();
+
+    uint32_t idx;
+    if (GetIndexForEntry (storage, file_spec, idx))
+        return idx;
+
+    const ConstString &directory = file_spec.GetDirectory();
+    const ConstString &filename = file_spec.GetFilename();
+    if (!directory && !filename)
+        return 0;
+
+    const FileSpecKey key (directory.GetCString(), filename.GetCString());
+    Mutex::Locker locker (storage.mutex);
+    FileSpecIndexMap::const_iterator pos = storage.index_map.find (key);
+    if (pos != storage.index_map.end())
+        return pos->second;
+    return UINT32_MAX;
+}
+
+const FileSpec &
+FileSpecTable::GetFileSpecAtIndex (uint32_t idx)
+{
+    FileSpecTableStorage &storage = GetStorage();
+    const uint32_t chunk_idx = idx / FILE_SPEC_TABLE_CHUNK_SIZE;
+    if (chunk_idx < storage.num_chunks)
+        return storage.chunks[chunk_idx][idx % FILE_SPEC_TABLE_CHUNK_SIZE];
+    return storage.chunks[0][0];
+}
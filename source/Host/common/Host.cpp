@@ -19,6 +19,7 @@
 #include "lldb/Host/Endian.h"
 #include "lldb/Host/FileSpec.h"
 #include "lldb/Host/Mutex.h"
+#include "lldb/Host/ThreadPool.h"
 #include "lldb/Target/Process.h"
 #include "lldb/Target/TargetList.h"
 
@@ -28,6 +29,9 @@
 #include <errno.h>
 #include <limits.h>
 
+#include <algorithm>
+#include <vector>
+
 #ifdef __unix__
 #include <dlfcn.h>
 #include <grp.h>
@@ -36,6 +40,9 @@
 #endif
 
 #include <sys/types.h>
+#ifndef _WIN32
+#include <unistd.h>
+#endif
 
 #if defined (__APPLE__)
 
@@ -277,6 +284,87 @@ Host::GetPageSize()
 #endif
 }
 
+uint32_t
+Host::GetNumberCPUs ()
+{
+    static uint32_t g_num_cores = 0;
+    if (g_num_cores == 0)
+    {
+#if defined (_WIN32)
+        SYSTEM_INFO systemInfo;
+        GetNativeSystemInfo(&systemInfo);
+        g_num_cores = systemInfo.dwNumberOfProcessors;
+#elif defined (__APPLE__) || defined (__FreeBSD__)
+        int num_cores = 0;
+        size_t num_cores_len = sizeof(num_cores);
+        int mib[] = { CTL_HW, HW_NCPU };
+        if (::sysctl (mib, sizeof(mib)/sizeof(int), &num_cores, &num_cores_len, NULL, 0) == 0 && num_cores > 0)
+            g_num_cores = num_cores;
+#else
+        long num_cores = ::sysconf (_SC_NPROCESSORS_ONLN);
+        if (num_cores > 0)
+            g_num_cores = num_cores;
+#endif
+        if (g_num_cores == 0)
+            g_num_cores = 1;
+    }
+    return g_num_cores;
+}
+
+uint32_t
+Host::GetNumberOfShards (size_t num_items, size_t min_shard_size)
+{
+    if (min_shard_size == 0)
+        min_shard_size = 1;
+    const size_t max_shards = num_items / min_shard_size;
+    if (max_shards <= 1)
+        return 1;
+    return std::min<size_t> (ThreadPool::GetSharedThreadPool().GetMaximumNumberOfThreads(), max_shards);
+}
+
+struct HostShard
+{
+    Host::ShardCallback callback;
+    void *baton;
+    uint32_t shard_idx;
+    size_t begin_idx;
+    size_t end_idx;
+};
+
+static void
+HostShardTask (void *arg)
+{
+    HostShard *shard = (HostShard *)arg;
+    shard->callback (shard->baton, shard->shard_idx, shard->begin_idx, shard->end_idx);
+}
+
+void
+Host::RunShards (size_t num_items, uint32_t num_shards, ShardCallback callback, void *baton)
+{
+    if (num_shards == 0)
+        num_shards = 1;
+
+    std::vector<HostShard> shards (num_shards);
+    for (uint32_t i=0; i<num_shards; ++i)
+    {
+        shards[i].callback = callback;
+        shards[i].baton = baton;
+        shards[i].shard_idx = i;
+        shards[i].begin_idx = (num_items * i) / num_shards;
+        shards[i].end_idx = (num_items * (i + 1)) / num_shards;
+    }
+
+    // The calling thread does the first shard, and any others the pool
+    // hasn't started when it is done
+    ThreadPool::TaskGroup task_group (ThreadPool::GetSharedThreadPool());
+    for (uint32_t i=1; i<num_shards; ++i)
+        task_group.AddTask (HostShardTask, &shards[i]);
+
+    HostShardTask (&shards[0]);
+
+    task_group.Wait();
+}
+
 const ArchSpec &
 Host::GetArchitecture (SystemDefaultArchitecture arch_kind)
 {
@@ -9,6 +9,18 @@
 
 #include "lldb/Host/Symbols.h"
 
+// C Includes
+// C++ Includes
+#include <algorithm>
+#include <set>
+
+// Other libraries and framework includes
+// Project includes
+#include "lldb/Core/ModuleSpec.h"
+#include "lldb/Core/UUID.h"
+#include "lldb/Host/Host.h"
+#include "lldb/Host/Mutex.h"
+
 using namespace lldb;
 using namespace lldb_private;
 
@@ -29,3 +41,122 @@ Symbols::LocateExecutableSymbolFile (const ModuleSpec &module_spec)
 }
 
 #endif
+
+typedef std::set<UUID> UUIDSet;
+
+static Mutex &
+GetMissingSymbolFileMutex ()
+{
+    static Mutex g_mutex (Mutex::eMutexTypeNormal);
+    return g_mutex;
+}
+
+// UUIDs that we already searched for symbol files and didn't find any
+static UUIDSet &
+GetMissingSymbolFileUUIDs ()
+{
+    static UUIDSet g_uuids;
+    return g_uuids;
+}
+
+bool
+Symbols::SymbolFileIsKnownMissing (const UUID &uuid)
+{
+    if (!uuid.IsValid())
+        return false;
+    Mutex::Locker locker (GetMissingSymbolFileMutex());
+    return GetMissingSymbolFileUUIDs().count (uuid) > 0;
+}
+
+void
+Symbols::ClearMissingSymbolFileCache ()
+{
+    Mutex::Locker locker (GetMissingSymbolFileMutex());
+    GetMissingSymbolFileUUIDs().clear();
+}
+
+// Searching for a symbol file can mean asking Spotlight, so it is worth
+// a thread for even a few modules.
+#define SYMBOLS_MIN_LOCATES_PER_WORKER 2
+
+struct SymbolFileLocateWorkerState
+{
+    Mutex *mutex;
+    size_t *next_idx;
+    std::vector<ModuleSpec> *module_specs;
+    std::vector<FileSpec> *symbol_files;
+};
+
+static void *
+SymbolFileLocateWorkerThread (void *arg)
+{
+    SymbolFileLocateWorkerState *state = (SymbolFileLocateWorkerState *)arg;
+    const size_t num_specs = state->module_specs->size();
+    while (1)
+    {
+        size_t idx;
+        {
+            Mutex::Locker locker (*state->mutex);
+            idx = (*state->next_idx)++;
+        }
+        if (idx >= num_specs)
+            break;
+
+        // Each worker only touches its own spec and result
+        ModuleSpec &module_spec = (*state->module_specs)[idx];
+        const UUID &uuid = module_spec.GetUUID();
+        if (Symbols::SymbolFileIsKnownMissing (uuid))
+            continue;
+
+        FileSpec symbol_file (Symbols::LocateExecutableSymbolFile (module_spec));
+        if (symbol_file)
+        {
+            (*state->symbol_files)[idx] = symbol_file;
+        }
+        else if (uuid.IsValid())
+        {
+            Mutex::Locker locker (GetMissingSymbolFileMutex());
+            GetMissingSymbolFileUUIDs().insert (uuid);
+        }
+    }
+    return NULL;
+}
+
+size_t
+Symbols::LocateExecutableSymbolFiles (std::vector<ModuleSpec> &module_specs,
+                                      std::vector<FileSpec> &symbol_files)
+{
+    const size_t num_specs = module_specs.size();
+    symbol_files.clear();
+    symbol_files.resize (num_specs);
+    if (num_specs == 0)
+        return 0;
+
+    Mutex mutex;
+    size_t next_idx = 0;
+    SymbolFileLocateWorkerState state = { &mutex, &next_idx, &module_specs, &symbol_files };
+
+    // The calling thread does work too, so only spawn threads for the
+    // rest of the workers.
+    const uint32_t num_workers = std::min<uint32_t> (Host::GetNumberCPUs(), num_specs / SYMBOLS_MIN_LOCATES_PER_WORKER);
+    std::vector<lldb::thread_t> threads;
+    for (uint32_t i=1; i<num_workers; ++i)
+    {
+        lldb::thread_t thread = Host::ThreadCreate ("<lldb.symbols.locate>", SymbolFileLocateWorkerThread, &state, NULL);
+        if (IS_VALID_LLDB_HOST_THREAD(thread))
+            threads.push_back (thread);
+    }
+
+    SymbolFileLocateWorkerThread (&state);
+
+    for (size_t i=0; i<threads.size(); ++i)
+        Host::ThreadJoin (threads[i], NULL, NULL);
+
+    size_t num_found = 0;
+    for (size_t i=0; i<num_specs; ++i)
+    {
+        if (symbol_files[i])
+            ++num_found;
+    }
+    return num_found;
+}
@@ -0,0 +1,347 @@
+//===-- ThreadPool.cpp ------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "lldb/Host/ThreadPool.h"
+
+// C Includes
+#include <pthread.h>
+// C++ Includes
+#include <algorithm>
+// Other libraries and framework includes
+// Project includes
+#include "lldb/Host/Host.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+// The worker the current thread is, and the group of the task it is
+// running, if any
+static pthread_key_t g_current_worker_key;
+static pthread_key_t g_current_group_key;
+static pthread_once_t g_thread_keys_once = PTHREAD_ONCE_INIT;
+
+static void
+InitializeThreadKeys ()
+{
+    ::pthread_key_create (&g_current_worker_key, NULL);
+    ::pthread_key_create (&g_current_group_key, NULL);
+}
+
+static uint32_t
+ResolveMaximumNumberOfThreads (uint32_t max_num_threads)
+{
+    if (max_num_threads == 0)
+        max_num_threads = Host::GetNumberCPUs();
+    return std::max<uint32_t> (1, std::min<uint32_t> (max_num_threads, THREAD_POOL_MAX_NUM_THREADS));
+}
+
+ThreadPool::TaskGroup::TaskGroup (ThreadPool &pool) :
+    m_pool (pool),
+    m_mutex (Mutex::eMutexTypeNormal),
+    m_condition (),
+    m_num_unfinished_tasks (0),
+    m_cancelled (0)
+{
+}
+
+ThreadPool::TaskGroup::~TaskGroup ()
+{
+    Wait ();
+}
+
+void
+ThreadPool::TaskGroup::AddTask (TaskCallback callback, void *baton)
+{
+    {
+        Mutex::Locker locker (m_mutex);
+        ++m_num_unfinished_tasks;
+    }
+    Task task = { callback, baton, this };
+    m_pool.AddTask (task);
+}
+
+void
+ThreadPool::TaskGroup::Wait ()
+{
+    // Run what the workers haven't gotten to yet here, this thread would
+    // only be sitting around otherwise
+    Task task;
+    while (m_pool.GetTaskForGroup (this, task))
+        ThreadPool::RunTask (task);
+
+    Mutex::Locker locker (m_mutex);
+    while (m_num_unfinished_tasks > 0)
+        m_condition.Wait (m_mutex);
+}
+
+void
+ThreadPool::TaskGroup::Cancel ()
+{
+    __sync_lock_test_and_set (&m_cancelled, 1);
+}
+
+void
+ThreadPool::TaskGroup::TaskFinished ()
+{
+    Mutex::Locker locker (m_mutex);
+    if (--m_num_unfinished_tasks == 0)
+        m_condition.Broadcast();
+}
+
+ThreadPool::ThreadPool (uint32_t max_num_threads) :
+    m_tasks_mutex (Mutex::eMutexTypeNormal),
+    m_tasks (),
+    m_mutex (Mutex::eMutexTypeNormal),
+    m_condition (),
+    m_max_num_threads (ResolveMaximumNumberOfThreads (max_num_threads)),
+    m_num_threads (0),
+    m_num_idle_threads (0),
+    m_num_worker_slots (0),
+    m_num_queued_tasks (0),
+    m_shutting_down (false)
+{
+    ::pthread_once (&g_thread_keys_once, InitializeThreadKeys);
+
+    // The workers are made up front so that other workers can look
+    // through their queues without locking the array
+    for (uint32_t i=0; i<THREAD_POOL_MAX_NUM_THREADS; ++i)
+    {
+        m_workers[i] = new Worker();
+        m_workers[i]->pool = this;
+        m_workers[i]->index = i;
+        m_workers[i]->running = false;
+    }
+}
+
+ThreadPool::~ThreadPool ()
+{
+    {
+        Mutex::Locker locker (m_mutex);
+        m_shutting_down = true;
+        m_condition.Broadcast();
+        while (m_num_threads > 0)
+            m_condition.Wait (m_mutex);
+    }
+    for (uint32_t i=0; i<THREAD_POOL_MAX_NUM_THREADS; ++i)
+        delete m_workers[i];
+}
+
+ThreadPool &
+ThreadPool::GetSharedThreadPool ()
+{
+    // This is never destroyed, tasks can still be running when the
+    // program exits
+    static ThreadPool *g_shared_thread_pool = new ThreadPool();
+    return *g_shared_thread_pool;
+}
+
+void
+ThreadPool::SetMaximumNumberOfThreads (uint32_t max_num_threads)
+{
+    Mutex::Locker locker (m_mutex);
+    m_max_num_threads = ResolveMaximumNumberOfThreads (max_num_threads);
+    // Wake up the idle workers so the extra ones can exit
+    m_condition.Broadcast();
+}
+
+bool
+ThreadPool::ShouldCancel ()
+{
+    ::pthread_once (&g_thread_keys_once, InitializeThreadKeys);
+    TaskGroup *group = (TaskGroup *)::pthread_getspecific (g_current_group_key);
+    return group && group->IsCancelled();
+}
+
+void
+ThreadPool::AddTask (const Task &task)
+{
+    // Tasks added by one of our workers go on its own queue
+    Worker *worker = (Worker *)::pthread_getspecific (g_current_worker_key);
+    if (worker && worker->pool == this)
+    {
+        Mutex::Locker locker (worker->mutex);
+        worker->tasks.push_back (task);
+    }
+    else
+    {
+        Mutex::Locker locker (m_tasks_mutex);
+        m_tasks.push_back (task);
+    }
+
+    // Counted while holding m_mutex so that a worker that is about to
+    // wait can't miss it
+    Mutex::Locker locker (m_mutex);
+    __sync_add_and_fetch (&m_num_queued_tasks, 1);
+    if (m_num_idle_threads > 0)
+    {
+        m_condition.Signal();
+    }
+    else if (m_num_threads < m_max_num_threads && !m_shutting_down)
+    {
+        for (uint32_t i=0; i<m_max_num_threads; ++i)
+        {
+            Worker *new_worker = m_workers[i];
+            if (new_worker->running)
+                continue;
+            lldb::thread_t thread = Host::ThreadCreate ("<lldb.thread-pool.worker>", ThreadPool::WorkerThread, new_worker, NULL);
+            // If no thread could be made the task still gets run by
+            // whoever waits for its group
+            if (IS_VALID_LLDB_HOST_THREAD(thread))
+            {
+                Host::ThreadDetach (thread, NULL);
+                new_worker->running = true;
+                ++m_num_threads;
+                if (m_num_worker_slots < i + 1)
+                    m_num_worker_slots = i + 1;
+            }
+            break;
+        }
+    }
+}
+
+bool
+ThreadPool::GetTask (Worker *worker, Task &task)
+{
+    if (m_num_queued_tasks == 0)
+        return false;
+
+    // Our own newest task first
+    {
+        Mutex::Locker locker (worker->mutex);
+        if (!worker->tasks.empty())
+        {
+            task = worker->tasks.back();
+            worker->tasks.pop_back();
+            __sync_sub_and_fetch (&m_num_queued_tasks, 1);
+            return true;
+        }
+    }
+
+    // Then tasks from outside the pool
+    {
+        Mutex::Locker locker (m_tasks_mutex);
+        if (!m_tasks.empty())
+        {
+            task = m_tasks.front();
+            m_tasks.pop_front();
+            __sync_sub_and_fetch (&m_num_queued_tasks, 1);
+            return true;
+        }
+    }
+
+    // Then steal the oldest task from another worker, starting with the
+    // next one so workers don't all go after the same queue
+    const uint32_t num_worker_slots = m_num_worker_slots;
+    for (uint32_t i=1; i<num_worker_slots; ++i)
+    {
+        Worker *victim = m_workers[(worker->index + i) % num_worker_slots];
+        Mutex::Locker locker (victim->mutex);
+        if (!victim->tasks.empty())
+        {
+            task = victim->tasks.front();
+            victim->tasks.pop_front();
+            __sync_sub_and_fetch (&m_num_queued_tasks, 1);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool
+ThreadPool::RemoveTaskForGroup (TaskQueue &tasks, const TaskGroup *group, Task &task)
+{
+    TaskQueue::iterator pos, end = tasks.end();
+    for (pos = tasks.begin(); pos != end; ++pos)
+    {
+        if (pos->group == group)
+        {
+            task = *pos;
+            tasks.erase (pos);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool
+ThreadPool::GetTaskForGroup (const TaskGroup *group, Task &task)
+{
+    if (m_num_queued_tasks == 0)
+        return false;
+
+    {
+        Mutex::Locker locker (m_tasks_mutex);
+        if (RemoveTaskForGroup (m_tasks, group, task))
+        {
+            __sync_sub_and_fetch (&m_num_queued_tasks, 1);
+            return true;
+        }
+    }
+
+    const uint32_t num_worker_slots = m_num_worker_slots;
+    for (uint32_t i=0; i<num_worker_slots; ++i)
+    {
+        Worker *worker = m_workers[i];
+        Mutex::Locker locker (worker->mutex);
+        if (RemoveTaskForGroup (worker->tasks, group, task))
+        {
+            __sync_sub_and_fetch (&m_num_queued_tasks, 1);
+            return true;
+        }
+    }
+    return false;
+}
+
+void
+ThreadPool::RunTask (const Task &task)
+{
+    // A thread that is waiting for a group can run a task in the middle
+    // of another one, so put the outer task's group back afterwards
+    void *outer_group = ::pthread_getspecific (g_current_group_key);
+    ::pthread_setspecific (g_current_group_key, task.group);
+    if (!task.group->IsCancelled())
+        task.callback (task.baton);
+    ::pthread_setspecific (g_current_group_key, outer_group);
+    task.group->TaskFinished ();
+}
+
+void *
+ThreadPool::WorkerThread (void *arg)
+{
+    Worker *worker = (Worker *)arg;
+    ThreadPool *pool = worker->pool;
+    ::pthread_setspecific (g_current_worker_key, worker);
+
+    while (1)
+    {
+        Task task;
+        if (pool->GetTask (worker, task))
+        {
+            ThreadPool::RunTask (task);
+            continue;
+        }
+
+        Mutex::Locker locker (pool->m_mutex);
+        if (pool->m_shutting_down || worker->index >= pool->m_max_num_threads)
+        {
+            // Nothing can be on our own queue, only we add to it
+            worker->running = false;
+            --pool->m_num_threads;
+            pool->m_condition.Broadcast();
+            break;
+        }
+        if (pool->m_num_queued_tasks == 0)
+        {
+            ++pool->m_num_idle_threads;
+            pool->m_condition.Wait (pool->m_mutex);
+            --pool->m_num_idle_threads;
+        }
+    }
+    return NULL;
+}
@@ -0,0 +1,176 @@
+//===-- CommandBatch.cpp ----------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "lldb/Interpreter/CommandBatch.h"
+
+// C Includes
+// C++ Includes
+// Other libraries and framework includes
+// Project includes
+#include "lldb/Core/Stream.h"
+#include "lldb/Interpreter/CommandInterpreter.h"
+#include "lldb/Interpreter/CommandObject.h"
+#include "lldb/Interpreter/CommandReturnObject.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+CommandBatch::CommandBatch () :
+    m_commands (),
+    m_prepared_interpreter (NULL),
+    m_prepared_generation (0),
+    m_num_prepared_commands (0),
+    m_num_commands_run (0)
+{
+}
+
+CommandBatch::~CommandBatch ()
+{
+}
+
+void
+CommandBatch::AppendCommand (const char *command_line)
+{
+    m_commands.push_back (Command (command_line ? command_line : ""));
+}
+
+const char *
+CommandBatch::GetCommandAtIndex (size_t idx) const
+{
+    if (idx < m_commands.size())
+        return m_commands[idx].command_line.c_str();
+    return NULL;
+}
+
+void
+CommandBatch::Clear ()
+{
+    m_commands.clear();
+    m_prepared_interpreter = NULL;
+    m_num_prepared_commands = 0;
+    m_num_commands_run = 0;
+}
+
+void
+CommandBatch::Prepare (CommandInterpreter &interpreter)
+{
+    if (m_prepared_interpreter == &interpreter &&
+        m_prepared_generation == interpreter.GetCommandSetGeneration() &&
+        m_num_prepared_commands == m_commands.size())
+        return;
+
+    // Commands that were added since the last time can be resolved on
+    // their own, otherwise the old command objects can't be trusted
+    size_t start_idx = 0;
+    if (m_prepared_interpreter == &interpreter && m_prepared_generation == interpreter.GetCommandSetGeneration())
+        start_idx = m_num_prepared_commands;
+
+    CommandReturnObject result;
+    const size_t num_commands = m_commands.size();
+    for (size_t i=start_idx; i<num_commands; ++i)
+    {
+        Command &command = m_commands[i];
+        result.Clear();
+        command.args.Clear();
+        command.cmd_obj = interpreter.ResolveCommandLine (command.command_line.c_str(), command.command_args, result);
+        // Lines that can't be resolved, including the ones with errors,
+        // go through HandleCommand() so they fail the same way
+        if (command.cmd_obj && !command.cmd_obj->WantsRawCommandString())
+            command.args.SetCommandString (command.command_args.c_str());
+    }
+    m_prepared_interpreter = &interpreter;
+    m_prepared_generation = interpreter.GetCommandSetGeneration();
+    m_num_prepared_commands = num_commands;
+}
+
+size_t
+CommandBatch::Execute (CommandInterpreter &interpreter, bool stop_on_error)
+{
+    CommandReturnObject result;
+    m_num_commands_run = 0;
+    const size_t num_commands = m_commands.size();
+    for (size_t i=0; i<num_commands; ++i)
+    {
+        // A command can add or remove commands and aliases, so check
+        // before each one
+        Prepare (interpreter);
+
+        // Pick up the selected thread and frame before each command, like
+        // HandleCommand() does, so "thread select" or "frame select" in
+        // the batch applies to the commands after it
+        interpreter.UpdateExecutionContext (NULL);
+
+        Command &command = m_commands[i];
+        result.Clear();
+        if (command.cmd_obj == NULL)
+        {
+            interpreter.HandleCommand (command.command_line.c_str(),
+                                       eLazyBoolNo,
+                                       result,
+                                       NULL,    // override_context
+                                       false,   // repeat_on_empty_command
+                                       true);   // no_context_switching
+        }
+        else if (command.cmd_obj->WantsRawCommandString())
+        {
+            command.cmd_obj->Execute (command.command_args.c_str(), result);
+        }
+        else
+        {
+            // Parsing the options takes them out of the Args
+            Args args (command.args);
+            command.cmd_obj->ExecuteWithArgs (args, result);
+        }
+
+        command.status = result.GetStatus();
+        command.output = result.GetOutputData();
+        command.error = result.GetErrorData();
+        ++m_num_commands_run;
+
+        if (stop_on_error && !result.Succeeded())
+            break;
+    }
+    return m_num_commands_run;
+}
+
+ReturnStatus
+CommandBatch::GetStatusAtIndex (size_t idx) const
+{
+    if (idx < m_num_commands_run)
+        return m_commands[idx].status;
+    return eReturnStatusInvalid;
+}
+
+const char *
+CommandBatch::GetOutputAtIndex (size_t idx) const
+{
+    if (idx < m_num_commands_run)
+        return m_commands[idx].output.c_str();
+    return NULL;
+}
+
+const char *
+CommandBatch::GetErrorAtIndex (size_t idx) const
+{
+    if (idx < m_num_commands_run)
+        return m_commands[idx].error.c_str();
+    return NULL;
+}
+
+void
+CommandBatch::Dump (Stream &strm) const
+{
+    for (size_t i=0; i<m_num_commands_run; ++i)
+    {
+        const Command &command = m_commands[i];
+        strm.Printf ("%s\n", command.command_line.c_str());
+        strm.PutCString (command.output.c_str());
+        strm.PutCString (command.error.c_str());
+    }
+}
@@ -33,6 +33,7 @@
 #include "../Commands/CommandObjectRegister.h"
 #include "../Commands/CommandObjectSettings.h"
 #include "../Commands/CommandObjectSource.h"
+#include "../Commands/CommandObjectStatistics.h"
 #include "../Commands/CommandObjectCommands.h"
 #include "../Commands/CommandObjectSyntax.h"
 #include "../Commands/CommandObjectTarget.h"
@@ -98,7 +99,8 @@ CommandInterpreter::CommandInterpreter
     m_repeat_char ('!'),
     m_batch_command_mode (false),
     m_truncation_warning(eNoTruncation),
-    m_command_source_depth (0)
+    m_command_source_depth (0),
+    m_command_set_generation (0)
 {
     debugger.SetScriptLanguage (script_language);
     SetEventName (eBroadcastBitThreadShouldExit, "thread-should-exit");
@@ -361,6 +363,7 @@ CommandInterpreter::LoadCommandDictionary ()
     m_command_dict["script"]    = CommandObjectSP (new CommandObjectScript (*this, script_language));
     m_command_dict["settings"]  = CommandObjectSP (new CommandObjectMultiwordSettings (*this));
     m_command_dict["source"]    = CommandObjectSP (new CommandObjectMultiwordSource (*this));
+    m_command_dict["statistics"]= CommandObjectSP (new CommandObjectStatistics (*this));
     m_command_dict["target"]    = CommandObjectSP (new CommandObjectMultiwordTarget (*this));
     m_command_dict["thread"]    = CommandObjectSP (new CommandObjectMultiwordThread (*this));
     m_command_dict["type"]      = CommandObjectSP (new CommandObjectType (*this));
@@ -597,6 +600,7 @@ CommandInterpreter::AddCommand (const char *name, const lldb::CommandObjectSP &c
                 return false;
         }
         m_command_dict[name_sstr] = cmd_sp;
+        ++m_command_set_generation;
         return true;
     }
     return false;
@@ -620,6 +624,7 @@ CommandInterpreter::AddUserCommand (std::string name,
             return false;
 
         m_user_dict[name] = cmd_sp;
+        ++m_command_set_generation;
         return true;
     }
     return false;
@@ -773,6 +778,7 @@ CommandInterpreter::AddAlias (const char *alias_name, CommandObjectSP& command_o
 {
     command_obj_sp->SetIsAlias (true);
     m_alias_dict[alias_name] = command_obj_sp;
+    ++m_command_set_generation;
 }
 
 bool
@@ -782,6 +788,7 @@ CommandInterpreter::RemoveAlias (const char *alias_name)
     if (pos != m_alias_dict.end())
     {
         m_alias_dict.erase(pos);
+        ++m_command_set_generation;
         return true;
     }
     return false;
@@ -793,6 +800,7 @@ CommandInterpreter::RemoveUser (const char *alias_name)
     if (pos != m_user_dict.end())
     {
         m_user_dict.erase(pos);
+        ++m_command_set_generation;
         return true;
     }
     return false;
@@ -1280,9 +1288,6 @@ CommandInterpreter::HandleCommand (const char *command_line,
 
 {
 
-    bool done = false;
-    CommandObject *cmd_obj = NULL;
-    bool wants_raw_input = false;
     std::string command_string (command_line);
     std::string original_command_string (command_line);
     
@@ -1384,7 +1389,82 @@ CommandInterpreter::HandleCommand (const char *command_line,
         return false;
     }
     // Phase 1.
+    // Figure out what the real/final command object for the specified command is, taking care of aliases and
+    // abbreviated command names.  See ResolveCommand().
+
+    std::string revised_command_line;
+    std::string remainder;
+    CommandObject *cmd_obj = ResolveCommand (command_string, revised_command_line, remainder, result);
+    if (cmd_obj == NULL)
+        return false;
+
+    // End of Phase 1.
+    // At this point cmd_obj contains the CommandObject whose Execute method will be called; revised_command_line
+    // contains the complete command line (including command name(s)), fully translated with all substitutions &
+    // translations taken care of (still in raw text format); and remainder contains the arguments for cmd_obj.
+
+    if (log)
+    {
+        log->Printf ("HandleCommand, cmd_obj : '%s'", cmd_obj->GetCommandName());
+        log->Printf ("HandleCommand, revised_command_line: '%s'", revised_command_line.c_str());
+        log->Printf ("HandleCommand, wants_raw_input:'%s'", cmd_obj->WantsRawCommandString() ? "True" : "False");
+    }
+
+    // Phase 2.
+    // Take care of things like setting up the history command & calling the appropriate Execute method on the
+    // CommandObject, with the appropriate arguments.
+    
+    if (add_to_history)
+    {
+        Args command_args (revised_command_line.c_str());
+        const char *repeat_command = cmd_obj->GetRepeatCommand(command_args, 0);
+        if (repeat_command != NULL)
+            m_repeat_command.assign(repeat_command);
+        else
+            m_repeat_command.assign(original_command_string.c_str());
+        
+        // Don't keep pushing the same command onto the history...
+        if (m_command_history.empty() || m_command_history.back() != original_command_string) 
+            m_command_history.push_back (original_command_string);
+    }
+
+    if (log)
+        log->Printf ("HandleCommand, command line after removing command name(s): '%s'", remainder.c_str());
+
+    cmd_obj->Execute (remainder.c_str(), result);
     
+    if (log)
+      log->Printf ("HandleCommand, command %s", (result.Succeeded() ? "succeeded" : "did not succeed"));
+
+    return result.Succeeded();
+}
+
+CommandObject *
+CommandInterpreter::ResolveCommandLine (const char *command_line,
+                                        std::string &command_args,
+                                        CommandReturnObject &result)
+{
+    if (command_line == NULL)
+        return NULL;
+
+    std::string command_string (command_line);
+    const size_t non_space = command_string.find_first_not_of ("\t\n\v\f\r ");
+    if (non_space == std::string::npos ||
+        command_string[non_space] == m_comment_char ||
+        command_string[non_space] == m_repeat_char ||
+        command_string.find ('`') != std::string::npos)
+        return NULL;
+
+    std::string resolved_command_line;
+    return ResolveCommand (command_string, resolved_command_line, command_args, result);
+}
+
+CommandObject *
+CommandInterpreter::ResolveCommand (std::string &command_string,
+                                    std::string &resolved_command_line,
+                                    std::string &command_args,
+                                    CommandReturnObject &result)
+{
     // Before we do ANY kind of argument processing, etc. we need to figure out what the real/final command object
     // is for the specified command, and whether or not it wants raw input.  This gets complicated by the fact that
     // the user could have specified an alias, and in translating the alias there may also be command options and/or
@@ -1393,6 +1473,9 @@ CommandInterpreter::HandleCommand (const char *command_line,
     // object whose Execute method will actually be called; 2). a revised command string, with all substitutions &
     // replacements taken care of; 3). whether or not the Execute function wants raw input or not.
 
+    bool done = false;
+    CommandObject *cmd_obj = NULL;
+    bool wants_raw_input = false;
     StreamString revised_command_line;
     size_t actual_cmd_name_len = 0;
     std::string next_word;
@@ -1484,7 +1567,7 @@ CommandInterpreter::HandleCommand (const char *command_line,
                 result.AppendErrorWithFormat ("'%s' is not a valid command.\n", next_word.c_str());
             }
             result.SetStatus (eReturnStatusFailed);
-            return false;
+            return NULL;
         }
 
         if (cmd_obj->IsMultiwordObject ())
@@ -1496,7 +1579,7 @@ CommandInterpreter::HandleCommand (const char *command_line,
                                               next_word.c_str(),
                                               suffix.c_str());
                 result.SetStatus (eReturnStatusFailed);
-                return false;
+                return NULL;
             }
         }
         else
@@ -1538,7 +1621,7 @@ CommandInterpreter::HandleCommand (const char *command_line,
                             result.AppendErrorWithFormat ("the '%s' command doesn't support the --gdb-format option\n", 
                                                           cmd_obj->GetCommandName());
                             result.SetStatus (eReturnStatusFailed);
-                            return false;
+                            return NULL;
                         }
                     }
                     break;
@@ -1547,7 +1630,7 @@ CommandInterpreter::HandleCommand (const char *command_line,
                     result.AppendErrorWithFormat ("unknown command shorthand suffix: '%s'\n", 
                                                   suffix.c_str());
                     result.SetStatus (eReturnStatusFailed);
-                    return false;
+                    return NULL;
         
                 }
             }
@@ -1560,103 +1643,21 @@ CommandInterpreter::HandleCommand (const char *command_line,
     if (!command_string.empty())
         revised_command_line.Printf (" %s", command_string.c_str());
 
-    // End of Phase 1.
-    // At this point cmd_obj should contain the CommandObject whose Execute method will be called, if the command
-    // specified was valid; revised_command_line contains the complete command line (including command name(s)),
-    // fully translated with all substitutions & translations taken care of (still in raw text format); and
-    // wants_raw_input specifies whether the Execute method expects raw input or not.
-
- 
-    if (log)
-    {
-        log->Printf ("HandleCommand, cmd_obj : '%s'", cmd_obj ? cmd_obj->GetCommandName() : "<not found>");
-        log->Printf ("HandleCommand, revised_command_line: '%s'", revised_command_line.GetData());
-        log->Printf ("HandleCommand, wants_raw_input:'%s'", wants_raw_input ? "True" : "False");
-    }
-
-    // Phase 2.
-    // Take care of things like setting up the history command & calling the appropriate Execute method on the
-    // CommandObject, with the appropriate arguments.
-    
-    if (cmd_obj != NULL)
-    {
-        if (add_to_history)
-        {
-            Args command_args (revised_command_line.GetData());
-            const char *repeat_command = cmd_obj->GetRepeatCommand(command_args, 0);
-            if (repeat_command != NULL)
-                m_repeat_command.assign(repeat_command);
-            else
-                m_repeat_command.assign(original_command_string.c_str());
-            
-            // Don't keep pushing the same command onto the history...
-            if (m_command_history.empty() || m_command_history.back() != original_command_string) 
-                m_command_history.push_back (original_command_string);
-        }
-        
-        command_string = revised_command_line.GetData();
-        std::string command_name (cmd_obj->GetCommandName());
-        std::string remainder;
-        if (actual_cmd_name_len < command_string.length()) 
-            remainder = command_string.substr (actual_cmd_name_len);  // Note: 'actual_cmd_name_len' may be considerably shorter
-                                                           // than cmd_obj->GetCommandName(), because name completion
-                                                           // allows users to enter short versions of the names,
-                                                           // e.g. 'br s' for 'breakpoint set'.
-        
-        // Remove any initial spaces
-        std::string white_space (" \t\v");
-        size_t pos = remainder.find_first_not_of (white_space);
-        if (pos != 0 && pos != std::string::npos)
-            remainder.erase(0, pos);
-
-        if (log)
-            log->Printf ("HandleCommand, command line after removing command name(s): '%s'", remainder.c_str());
+    resolved_command_line = revised_command_line.GetData();
+    command_args.clear();
+    if (actual_cmd_name_len < resolved_command_line.length()) 
+        command_args = resolved_command_line.substr (actual_cmd_name_len);  // Note: 'actual_cmd_name_len' may be considerably shorter
+                                                                            // than cmd_obj->GetCommandName(), because name completion
+                                                                            // allows users to enter short versions of the names,
+                                                                            // e.g. 'br s' for 'breakpoint set'.
     
-        cmd_obj->Execute (remainder.c_str(), result);
-    }
-    else
-    {
-        // We didn't find the first command object, so complete the first argument.
-        Args command_args (revised_command_line.GetData());
-        StringList matches;
-        int num_matches;
-        int cursor_index = 0;
-        int cursor_char_position = strlen (command_args.GetArgumentAtIndex(0));
-        bool word_complete;
-        num_matches = HandleCompletionMatches (command_args, 
-                                               cursor_index,
-                                               cursor_char_position,
-                                               0, 
-                                               -1, 
-                                               word_complete,
-                                               matches);
-        
-        if (num_matches > 0)
-        {
-            std::string error_msg;
-            error_msg.assign ("ambiguous command '");
-            error_msg.append(command_args.GetArgumentAtIndex(0));
-            error_msg.append ("'.");
-            
-            error_msg.append (" Possible completions:");
-            for (int i = 0; i < num_matches; i++)
-            {
-                error_msg.append ("\n\t");
-                error_msg.append (matches.GetStringAtIndex (i));
-            }
-            error_msg.append ("\n");
-            result.AppendRawError (error_msg.c_str(), error_msg.size());
-        }
-        else
-            result.AppendErrorWithFormat ("Unrecognized command '%s'.\n", command_args.GetArgumentAtIndex (0));
-        
-        result.SetStatus (eReturnStatusFailed);
-    }
-    
-    if (log)
-      log->Printf ("HandleCommand, command %s", (result.Succeeded() ? "succeeded" : "did not succeed"));
+    // Remove any initial spaces
+    std::string white_space (" \t\v");
+    size_t pos = command_args.find_first_not_of (white_space);
+    if (pos != 0 && pos != std::string::npos)
+        command_args.erase(0, pos);
 
-    return result.Succeeded();
+    return cmd_obj;
 }
 
 int
@@ -2011,6 +2012,7 @@ CommandInterpreter::RemoveAliasOptions (const char *alias_name)
     if (pos != m_alias_options.end())
     {
         m_alias_options.erase (pos);
+        ++m_command_set_generation;
     }
 }
 
@@ -2018,6 +2020,7 @@ void
 CommandInterpreter::AddOrReplaceAliasOptions (const char *alias_name, OptionArgVectorSP &option_arg_vector_sp)
 {
     m_alias_options[alias_name] = option_arg_vector_sp;
+    ++m_command_set_generation;
 }
 
 bool
@@ -844,12 +844,26 @@ CommandObject::GetArgumentDescriptionAsCString (const lldb::CommandArgumentType
     return NULL;
 }
 
+bool
+CommandObject::ExecuteWithArgs (Args &args, CommandReturnObject &result)
+{
+    std::string args_string;
+    args.GetQuotedCommandString (args_string);
+    return Execute (args_string.c_str(), result);
+}
+
 bool
 CommandObjectParsed::Execute (const char *args_string, CommandReturnObject &result)
+{
+    Args cmd_args (args_string);
+    return ExecuteWithArgs (cmd_args, result);
+}
+
+bool
+CommandObjectParsed::ExecuteWithArgs (Args &cmd_args, CommandReturnObject &result)
 {
     CommandOverrideCallback command_callback = GetOverrideCallback();
     bool handled = false;
-    Args cmd_args (args_string);
     if (command_callback)
     {
         Args full_args (GetCommandName ());
@@ -19,6 +19,69 @@
 using namespace lldb;
 using namespace lldb_private;
 
+// How much output to let build up before handing the whole lines in it
+// to a streaming output callback
+#define STREAM_LINE_CALLBACK_CHUNK_SIZE 4096
+
+// The immediate output stream for SetImmediateOutputCallback(). Handing
+// over a block of lines at a time keeps the number of callbacks down
+// for commands that print a line at a time.
+class StreamLineCallback : public Stream
+{
+public:
+    StreamLineCallback (lldb::LogOutputCallback callback, void *baton) :
+        Stream (0, 4, eByteOrderBig),
+        m_callback (callback),
+        m_baton (baton),
+        m_pending ()
+    {
+    }
+
+    virtual
+    ~StreamLineCallback ()
+    {
+        Flush ();
+    }
+
+    virtual void
+    Flush ()
+    {
+        if (!m_pending.empty())
+        {
+            m_callback (m_pending.c_str(), m_baton);
+            m_pending.clear();
+        }
+    }
+
+    virtual int
+    Write (const void *s, size_t length)
+    {
+        m_pending.append ((const char *)s, length);
+        if (m_pending.size() >= STREAM_LINE_CALLBACK_CHUNK_SIZE)
+        {
+            const size_t last_newline = m_pending.rfind ('\n');
+            if (last_newline == std::string::npos)
+            {
+                // One huge line, don't hold on to it any longer
+                Flush ();
+            }
+            else
+            {
+                std::string partial_line (m_pending, last_newline + 1);
+                m_pending.erase (last_newline + 1);
+                m_callback (m_pending.c_str(), m_baton);
+                m_pending.swap (partial_line);
+            }
+        }
+        return length;
+    }
+
+private:
+    lldb::LogOutputCallback m_callback;
+    void *m_baton;
+    std::string m_pending;
+};
+
 static void
 DumpStringToStreamWithNewline (Stream &strm, const std::string &s, bool add_newline_if_empty)
 {
@@ -46,7 +109,8 @@ CommandReturnObject::CommandReturnObject () :
     m_out_stream (),
     m_err_stream (),
     m_status (eReturnStatusStarted),
-    m_did_change_process_state (false)
+    m_did_change_process_state (false),
+    m_stream_output (false)
 {
 }
 
@@ -54,6 +118,23 @@ CommandReturnObject::~CommandReturnObject ()
 {
 }
 
+void
+CommandReturnObject::SetImmediateOutputCallback (lldb::LogOutputCallback callback, void *baton)
+{
+    lldb::StreamSP stream_sp;
+    if (callback)
+        stream_sp.reset (new StreamLineCallback (callback, baton));
+    m_out_stream.SetStreamAtIndex (eImmediateStreamIndex, stream_sp);
+}
+
+void
+CommandReturnObject::SetStreamOutput (bool stream_output)
+{
+    m_stream_output = stream_output;
+    if (m_stream_output)
+        m_out_stream.SetStreamAtIndex (eStreamStringIndex, lldb::StreamSP());
+}
+
 void
 CommandReturnObject::AppendErrorWithFormat (const char *format, ...)
 {
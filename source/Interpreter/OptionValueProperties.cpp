@@ -26,14 +26,16 @@ using namespace lldb_private;
 
 
 OptionValueProperties::OptionValueProperties (const ConstString &name) :
-    m_name (name)
+    m_name (name),
+    m_generation (1)
 {
 }
 
 OptionValueProperties::OptionValueProperties (const OptionValueProperties &global_properties) :
     m_name (global_properties.m_name),
     m_properties (global_properties.m_properties),
-    m_name_to_index (global_properties.m_name_to_index)
+    m_name_to_index (global_properties.m_name_to_index),
+    m_generation (1)
 {
     // We now have an exact copy of "global_properties". We need to now
     // find all non-global settings and copy the property values so that
@@ -73,6 +75,7 @@ OptionValueProperties::Initialize (const PropertyDefinition *defs)
         m_properties.push_back(property);
     }
     m_name_to_index.Sort();
+    ++m_generation;
 }
 
 void
@@ -86,6 +89,7 @@ OptionValueProperties::AppendProperty(const ConstString &name,
     m_properties.push_back(property);
     value_sp->SetParent (shared_from_this());
     m_name_to_index.Sort();
+    ++m_generation;
 }
 
 
@@ -10,12 +10,14 @@
 #include "lldb/Interpreter/ScriptInterpreter.h"
 
 #include <string>
+#include <pthread.h>
 #include <stdlib.h>
 #include <stdio.h>
 
 #include "lldb/Core/Error.h"
 #include "lldb/Core/Stream.h"
 #include "lldb/Core/StringList.h"
+#include "lldb/Interpreter/CommandInterpreter.h"
 #include "lldb/Interpreter/CommandReturnObject.h"
 #include "lldb/Interpreter/ScriptInterpreterPython.h"
 #include "lldb/Utility/PseudoTerminal.h"
@@ -23,6 +25,23 @@
 using namespace lldb;
 using namespace lldb_private;
 
+// The script interpreter the outermost batch on the current thread is for
+static pthread_key_t g_batch_interpreter_key;
+static pthread_once_t g_batch_interpreter_key_once = PTHREAD_ONCE_INIT;
+
+static void
+InitializeBatchInterpreterKey ()
+{
+    ::pthread_key_create (&g_batch_interpreter_key, NULL);
+}
+
+static ScriptInterpreter *
+GetBatchInterpreterForCurrentThread ()
+{
+    ::pthread_once (&g_batch_interpreter_key_once, InitializeBatchInterpreterKey);
+    return (ScriptInterpreter *)::pthread_getspecific (g_batch_interpreter_key);
+}
+
 ScriptInterpreter::ScriptInterpreter (CommandInterpreter &interpreter, lldb::ScriptLanguage script_lang) :
     m_interpreter (interpreter),
     m_script_lang (script_lang)
@@ -95,3 +114,49 @@ ScriptInterpreter::TerminateInterpreter ()
 #endif // #ifndef LLDB_DISABLE_PYTHON
 }
 
+ScriptInterpreter::Batch::Batch (CommandInterpreter *interpreter) :
+    m_script_interpreter (NULL),
+    m_is_outermost (false)
+{
+    if (interpreter == NULL)
+        return;
+    ScriptInterpreter *script_interpreter = interpreter->GetScriptInterpreterIfCreated();
+    if (script_interpreter == NULL)
+        return;
+
+    // Only one script interpreter can be batched on a thread at a time,
+    // callbacks to any other one just go through as they always did
+    ScriptInterpreter *batch_interpreter = GetBatchInterpreterForCurrentThread();
+    if (batch_interpreter == NULL)
+    {
+        ::pthread_setspecific (g_batch_interpreter_key, script_interpreter);
+        m_is_outermost = true;
+    }
+    else if (batch_interpreter != script_interpreter)
+        return;
+
+    m_script_interpreter = script_interpreter;
+    m_script_interpreter->BeginBatch();
+}
+
+ScriptInterpreter::Batch::~Batch ()
+{
+    if (m_script_interpreter == NULL)
+        return;
+    m_script_interpreter->EndBatch();
+    if (m_is_outermost)
+        ::pthread_setspecific (g_batch_interpreter_key, NULL);
+}
+
+ScriptInterpreter::BatchSuspender::BatchSuspender () :
+    m_script_interpreter (GetBatchInterpreterForCurrentThread())
+{
+    if (m_script_interpreter && !m_script_interpreter->SuspendBatch())
+        m_script_interpreter = NULL;
+}
+
+ScriptInterpreter::BatchSuspender::~BatchSuspender ()
+{
+    if (m_script_interpreter)
+        m_script_interpreter->ResumeBatch();
+}
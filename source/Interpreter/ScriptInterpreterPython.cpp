@@ -99,7 +99,7 @@ LLDBSwigPythonCreateSyntheticProvider
  );
 
 
-extern "C" uint32_t       LLDBSwigPython_CalculateNumChildren        (void *implementor);
+extern "C" uint32_t       LLDBSwigPython_CalculateNumChildren        (void *implementor, uint32_t max);
 extern "C" void*          LLDBSwigPython_GetChildAtIndex             (void *implementor, uint32_t idx);
 extern "C" int            LLDBSwigPython_GetIndexOfChildWithName     (void *implementor, const char* child_name);
 extern "C" void*          LLDBSWIGPython_CastPyObjectToSBValue       (void* data);
@@ -140,6 +140,7 @@ ScriptInterpreterPython::Locker::Locker (ScriptInterpreterPython *py_interpreter
                                          uint16_t on_entry,
                                          uint16_t on_leave,
                                          FILE* wait_msg_handle) :
+    m_in_batch( py_interpreter && py_interpreter->IsBatchActiveOnCurrentThread() ),
     m_need_session( (on_leave & TearDownSession) == TearDownSession ),
     m_python_interpreter(py_interpreter),
     m_tmp_fh(wait_msg_handle)
@@ -147,6 +148,10 @@ ScriptInterpreterPython::Locker::Locker (ScriptInterpreterPython *py_interpreter
     if (m_python_interpreter && !m_tmp_fh)
         m_tmp_fh = (m_python_interpreter->m_dbg_stdout ? m_python_interpreter->m_dbg_stdout : stdout);
 
+    // The batch holds on to the lock and the session until it is done
+    if (m_in_batch)
+        return;
+
     DoAcquireLock();
     if ( (on_entry & InitSession) == InitSession )
         DoInitSession();
@@ -192,6 +197,8 @@ ScriptInterpreterPython::Locker::DoTearDownSession()
 
 ScriptInterpreterPython::Locker::~Locker()
 {
+    if (m_in_batch)
+        return;
     if (m_need_session)
         DoTearDownSession();
     DoFreeLock();
@@ -462,7 +469,11 @@ ScriptInterpreterPython::ScriptInterpreterPython (CommandInterpreter &interprete
     m_dictionary_name (interpreter.GetDebugger().GetInstanceName().AsCString()),
     m_terminal_state (),
     m_session_is_active (false),
-    m_valid_session (true)
+    m_valid_session (true),
+    m_batch_tid (LLDB_INVALID_THREAD_ID),
+    m_batch_depth (0),
+    m_batch_gil_state (PyGILState_UNLOCKED),
+    m_batch_suspended_state (NULL)
 {
 
     static int g_initialized = false;
@@ -566,6 +577,70 @@ ScriptInterpreterPython::ResetOutputFileHandle (FILE *fh)
     m_new_sysout = PyFile_FromFile (m_dbg_stdout, (char *) "", (char *) "w", _check_and_flush);
 }
 
+bool
+ScriptInterpreterPython::IsBatchActiveOnCurrentThread () const
+{
+    // Only the thread that owns the batch can ever see its own ID here
+    return m_batch_depth > 0 &&
+           m_batch_suspended_state == NULL &&
+           m_batch_tid == Host::GetCurrentThreadID();
+}
+
+void
+ScriptInterpreterPython::BeginBatch ()
+{
+    if (m_batch_depth > 0 && m_batch_tid == Host::GetCurrentThreadID())
+    {
+        ++m_batch_depth;
+        return;
+    }
+
+    // Another thread's batch keeps us waiting here until it is done
+    PyGILState_STATE gil_state = PyGILState_Ensure();
+    m_batch_gil_state = gil_state;
+    m_batch_tid = Host::GetCurrentThreadID();
+    m_batch_depth = 1;
+    EnterSession ();
+
+    LogSP log (lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_SCRIPT | LIBLLDB_LOG_VERBOSE));
+    if (log)
+        log->Printf("ScriptInterpreterPython::BeginBatch () on thread 0x%4.4llx", m_batch_tid);
+}
+
+void
+ScriptInterpreterPython::EndBatch ()
+{
+    if (m_batch_depth == 0 || m_batch_tid != Host::GetCurrentThreadID())
+        return;
+    if (--m_batch_depth > 0)
+        return;
+
+    LeaveSession ();
+    m_batch_tid = LLDB_INVALID_THREAD_ID;
+    PyGILState_Release (m_batch_gil_state);
+}
+
+bool
+ScriptInterpreterPython::SuspendBatch ()
+{
+    if (!IsBatchActiveOnCurrentThread())
+        return false;
+    m_batch_suspended_state = PyEval_SaveThread();
+    return true;
+}
+
+void
+ScriptInterpreterPython::ResumeBatch ()
+{
+    if (m_batch_suspended_state == NULL || m_batch_tid != Host::GetCurrentThreadID())
+        return;
+    PyThreadState *thread_state = m_batch_suspended_state;
+    PyEval_RestoreThread (thread_state);
+    m_batch_suspended_state = NULL;
+    // Whoever used the interpreter in the meantime may have left the session
+    EnterSession ();
+}
+
 void
 ScriptInterpreterPython::SaveTerminalState (int fd)
 {
@@ -1844,6 +1919,69 @@ ScriptInterpreterPython::OSPlugin_QueryForThreadsInfo (lldb::ScriptInterpreterOb
     return MakeScriptObject(py_return);
 }
 
+lldb::ScriptInterpreterObjectSP
+ScriptInterpreterPython::OSPlugin_QueryForThreadsInfoChanges (lldb::ScriptInterpreterObjectSP object,
+                                                              uint32_t since_stop_id,
+                                                              uint32_t stop_id)
+{
+    Locker py_lock(this,Locker::AcquireLock,Locker::FreeLock);
+
+    static char callee_name[] = "get_thread_info_changes";
+    static char param_format[] = "II";
+    
+    if (!object)
+        return lldb::ScriptInterpreterObjectSP();
+    
+    PyObject* implementor = (PyObject*)object->GetObject();
+    
+    if (implementor == NULL || implementor == Py_None)
+        return lldb::ScriptInterpreterObjectSP();
+    
+    // this one is optional, plug-ins that don't have it always give us the whole list
+    PyObject* pmeth  = PyObject_GetAttrString(implementor, callee_name);
+    
+    if (PyErr_Occurred())
+    {
+        PyErr_Clear();
+    }
+    
+    if (pmeth == NULL || pmeth == Py_None)
+    {
+        Py_XDECREF(pmeth);
+        return lldb::ScriptInterpreterObjectSP();
+    }
+    
+    if (PyCallable_Check(pmeth) == 0)
+    {
+        if (PyErr_Occurred())
+        {
+            PyErr_Clear();
+        }
+        
+        Py_XDECREF(pmeth);
+        return lldb::ScriptInterpreterObjectSP();
+    }
+    
+    if (PyErr_Occurred())
+    {
+        PyErr_Clear();
+    }
+    
+    Py_XDECREF(pmeth);
+    
+    // right now we know this function exists and is callable..
+    PyObject* py_return = PyObject_CallMethod(implementor, callee_name, param_format, since_stop_id, stop_id);
+    
+    // if it fails, print the error but otherwise go on
+    if (PyErr_Occurred())
+    {
+        PyErr_Print();
+        PyErr_Clear();
+    }
+    
+    return MakeScriptObject(py_return);
+}
+
 lldb::ScriptInterpreterObjectSP
 ScriptInterpreterPython::OSPlugin_QueryForRegisterContextData (lldb::ScriptInterpreterObjectSP object,
                                                                lldb::tid_t thread_id)
@@ -2257,7 +2395,7 @@ ScriptInterpreterPython::PythonInputReaderManager::RunPythonInputReader (lldb::t
 }
 
 uint32_t
-ScriptInterpreterPython::CalculateNumChildren (const lldb::ScriptInterpreterObjectSP& implementor_sp)
+ScriptInterpreterPython::CalculateNumChildren (const lldb::ScriptInterpreterObjectSP& implementor_sp, uint32_t max)
 {
     if (!implementor_sp)
         return 0;
@@ -2275,7 +2413,7 @@ ScriptInterpreterPython::CalculateNumChildren (const lldb::ScriptInterpreterObje
     {
         Locker py_lock(this);
         ForceDisableSyntheticChildren no_synthetics(GetCommandInterpreter().GetDebugger().GetSelectedTarget().get());
-        ret_val = g_swig_calc_children       (implementor);
+        ret_val = g_swig_calc_children       (implementor, max);
     }
     
     return ret_val;
@@ -62,8 +62,42 @@ public:
     virtual bool
     DoesBranch () const
     {
+        if (m_does_branch == eLazyBoolCalculate)
+            CalculateDoesBranch ();
         return m_does_branch == eLazyBoolYes;
     }
+
+    // Figure out if this is a branch without calculating the strings,
+    // since they need the execution context to look up symbols. Without
+    // an execution context the symbol lookup callback adds no comment.
+    void
+    CalculateDoesBranch () const
+    {
+        InstructionLLVMC *inst = const_cast<InstructionLLVMC *>(this);
+        m_does_branch = eLazyBoolNo;
+
+        DataExtractor data;
+        if (!m_opcode.GetData(data))
+            return;
+
+        ::LLVMDisasmContextRef disasm_context = m_disasm.m_disasm_context;
+        if (m_disasm.m_alternate_disasm_context && inst->GetAddressClass () == eAddressClassCodeAlternateISA)
+            disasm_context = m_disasm.m_alternate_disasm_context;
+
+        char out_string[512];
+        m_disasm.Lock(inst, NULL);
+        uint8_t *opcode_data = const_cast<uint8_t *>(data.PeekData (0, 1));
+        const size_t inst_size = ::LLVMDisasmInstruction (disasm_context,
+                                                          opcode_data,
+                                                          data.GetByteSize(),
+                                                          m_address.GetFileAddress(),
+                                                          out_string,
+                                                          sizeof(out_string));
+        m_disasm.Unlock();
+
+        if (inst_size > 0 && inst->StringRepresentsBranch (out_string, strlen(out_string)))
+            m_does_branch = eLazyBoolYes;
+    }
     
     virtual size_t
     Decode (const lldb_private::Disassembler &disassembler,
@@ -421,7 +455,7 @@ protected:
     bool                    m_is_valid;
     DisassemblerLLVMC      &m_disasm;
     DisassemblerSP          m_disasm_sp; // for ownership
-    LazyBool                m_does_branch;
+    mutable LazyBool        m_does_branch;
     
     static bool             s_regex_compiled;
     static lldb::RegularExpressionSP s_regex;
@@ -433,6 +467,17 @@ lldb::RegularExpressionSP InstructionLLVMC::s_regex;
 Disassembler *
 DisassemblerLLVMC::CreateInstance (const ArchSpec &arch)
 {
+    // Setting up all of the LLVM targets is a noticeable part of the
+    // time it takes lldb to start, so wait for the first disassembler
+    static struct InitializeLLVM {
+        InitializeLLVM() {
+            llvm::InitializeAllTargetInfos();
+            llvm::InitializeAllTargetMCs();
+            llvm::InitializeAllAsmParsers();
+            llvm::InitializeAllDisassemblers();
+        }
+    } InitializeLLVM;
+
     std::auto_ptr<DisassemblerLLVMC> disasm_ap (new DisassemblerLLVMC(arch));
     
     if (disasm_ap.get() && disasm_ap->IsValid())
@@ -535,11 +580,6 @@ DisassemblerLLVMC::Initialize()
     PluginManager::RegisterPlugin (GetPluginNameStatic(),
                                    GetPluginDescriptionStatic(),
                                    CreateInstance);
-    
-    llvm::InitializeAllTargetInfos();
-    llvm::InitializeAllTargetMCs();
-    llvm::InitializeAllAsmParsers();
-    llvm::InitializeAllDisassemblers();
 }
 
 void
@@ -17,6 +17,8 @@
 #include "lldb/Core/PluginManager.h"
 #include "lldb/Core/Section.h"
 #include "lldb/Core/State.h"
+#include "lldb/Host/Host.h"
+#include "lldb/Host/Symbols.h"
 #include "lldb/Symbol/ObjectFile.h"
 #include "lldb/Target/ObjCLanguageRuntime.h"
 #include "lldb/Target/RegisterContext.h"
@@ -190,6 +192,52 @@ DynamicLoaderDarwinKernel::OSKextLoadedKextSummary::LoadImageUsingMemoryModule (
     bool uuid_is_valid = uuid.IsValid();
 
     Target &target = process->GetTarget();
+
+    // If LocateKextFiles() found the kext on disk we can load it at a
+    // slide from its header address without reading the kext out of
+    // memory at all. Only kexts we have no file for need the memory image.
+    if (!module_sp && uuid_is_valid && located_file && address != LLDB_INVALID_ADDRESS)
+    {
+        module_sp = target.GetImages().FindModule(uuid);
+        if (!module_sp)
+        {
+            ModuleSpec module_spec (located_file, target.GetArchitecture());
+            module_spec.GetUUID() = uuid;
+            module_sp = target.GetSharedModule (module_spec);
+            if (module_sp && located_dsym)
+                module_sp->SetSymbolFileFileSpec (located_dsym);
+        }
+
+        if (module_sp && module_sp->GetUUID() == uuid)
+        {
+            ObjectFile *ondisk_object_file = module_sp->GetObjectFile();
+            SectionList *ondisk_section_list = ondisk_object_file ? ondisk_object_file->GetSectionList () : NULL;
+            if (ondisk_section_list)
+            {
+                static ConstString g_text_segment_name ("__TEXT");
+                SectionSP text_section_sp (ondisk_section_list->FindSectionByName (g_text_segment_name));
+                if (text_section_sp)
+                {
+                    // kxld links each kext at a single base address, so all
+                    // segments move by the same amount as the mach header.
+                    const addr_t slide = address - text_section_sp->GetFileAddress();
+                    bool changed = false;
+                    if (module_sp->SetLoadAddress (target, slide, changed))
+                        load_process_stop_id = process->GetStopID();
+                }
+            }
+        }
+
+        if (IsLoaded())
+        {
+            if (so_address.IsValid())
+                so_address.SetLoadAddress (address, &target);
+            return true;
+        }
+        // Fall back to comparing against the memory image below
+        module_sp.reset();
+    }
+
     ModuleSP memory_module_sp;
     // Use the memory module as the module if we have one...
     if (address != LLDB_INVALID_ADDRESS)
@@ -483,6 +531,8 @@ DynamicLoaderDarwinKernel::ParseKextSummaries (const Address &kext_summary_addr,
     if (!ReadKextSummaries (kext_summary_addr, count, kext_summaries))
         return false;
 
+    LocateKextFiles (kext_summaries);
+
     Stream *s = &m_process->GetTarget().GetDebugger().GetOutputStream();
     for (uint32_t i = 0; i < count; i++)
     {
@@ -528,6 +578,93 @@ DynamicLoaderDarwinKernel::ParseKextSummaries (const Address &kext_summary_addr,
     return return_value;
 }
 
+// Don't bother spinning up threads unless each one has at least this
+// many kexts to look for.
+#define KEXT_MIN_LOCATES_PER_WORKER 8
+
+void *
+DynamicLoaderDarwinKernel::KextLocateWorkerThread (void *arg)
+{
+    KextLocateWorkerState *state = (KextLocateWorkerState *)arg;
+    const size_t num_indexes = state->summary_indexes->size();
+    while (1)
+    {
+        size_t idx;
+        {
+            Mutex::Locker locker (*state->mutex);
+            idx = (*state->next_idx)++;
+        }
+        if (idx >= num_indexes)
+            break;
+
+        // Each worker only writes to its own summary, so no locking is
+        // needed for the results.
+        OSKextLoadedKextSummary &summary = (*state->summaries)[(*state->summary_indexes)[idx]];
+        ModuleSpec module_spec;
+        module_spec.GetUUID() = summary.uuid;
+        module_spec.GetArchitecture() = *state->arch;
+        summary.located_file = Symbols::LocateExecutableObjectFile (module_spec);
+        if (summary.located_file)
+            module_spec.GetFileSpec() = summary.located_file;
+        summary.located_dsym = Symbols::LocateExecutableSymbolFile (module_spec);
+    }
+    return NULL;
+}
+
+//----------------------------------------------------------------------
+// Searching for the binary and dSYM of each kext by UUID dominates the
+// time it takes to attach to a kernel with hundreds of kexts loaded, so
+// do the searches on multiple threads before loading anything. Getting
+// the modules and setting their load addresses still happens serially
+// in LoadImageUsingMemoryModule() since the shared module list is
+// locked while modules are created anyway.
+//----------------------------------------------------------------------
+void
+DynamicLoaderDarwinKernel::LocateKextFiles (OSKextLoadedKextSummary::collection &image_infos)
+{
+    ModuleList &target_images = m_process->GetTarget().GetImages();
+    std::vector<size_t> summary_indexes;
+    const size_t num_image_infos = image_infos.size();
+    for (size_t idx = 0; idx < num_image_infos; ++idx)
+    {
+        const OSKextLoadedKextSummary &image_info = image_infos[idx];
+        if (image_info.module_sp || !image_info.uuid.IsValid())
+            continue;
+        if (target_images.FindModule (image_info.uuid))
+            continue;
+        summary_indexes.push_back (idx);
+    }
+
+    const size_t num_indexes = summary_indexes.size();
+    if (num_indexes == 0)
+        return;
+
+    Mutex mutex;
+    size_t next_idx = 0;
+    const ArchSpec arch (m_process->GetTarget().GetArchitecture());
+    KextLocateWorkerState state = { &mutex, &next_idx, &arch, &summary_indexes, &image_infos };
+
+    const uint32_t num_workers = std::min<uint32_t> (Host::GetNumberCPUs(), num_indexes / KEXT_MIN_LOCATES_PER_WORKER);
+    LogSP log(GetLogIfAnyCategoriesSet (LIBLLDB_LOG_DYNAMIC_LOADER));
+    if (log)
+        log->Printf ("Locating %llu kexts on %u threads.", (uint64_t)num_indexes, num_workers > 1 ? num_workers : 1);
+
+    // The calling thread does work too, so only spawn threads for the
+    // rest of the workers.
+    std::vector<lldb::thread_t> threads;
+    for (uint32_t i=1; i<num_workers; ++i)
+    {
+        lldb::thread_t thread = Host::ThreadCreate ("<lldb.kext.locate>", KextLocateWorkerThread, &state, NULL);
+        if (IS_VALID_LLDB_HOST_THREAD(thread))
+            threads.push_back (thread);
+    }
+
+    KextLocateWorkerThread (&state);
+
+    for (size_t i=0; i<threads.size(); ++i)
+        Host::ThreadJoin (threads[i], NULL, NULL);
+}
+
 // Adds the modules in image_infos to m_kext_summaries.  
 // NB don't call this passing in m_kext_summaries.
 
@@ -144,6 +144,8 @@ protected:
         uint32_t                 load_tag;
         uint32_t                 flags;
         uint64_t                 reference_list;
+        lldb_private::FileSpec   located_file;      // The kext binary on disk that matches uuid, found by LocateKextFiles()
+        lldb_private::FileSpec   located_dsym;      // The dSYM for the kext, found by LocateKextFiles()
 
         OSKextLoadedKextSummary() :
             module_sp (),
@@ -155,7 +157,9 @@ protected:
             version (0),
             load_tag (0),
             flags (0),
-            reference_list (0)
+            reference_list (0),
+            located_file (),
+            located_dsym ()
         {
             name[0] = '\0';
         }
@@ -181,6 +185,8 @@ protected:
                 name[0] = '\0';
             }
             module_sp.reset();
+            located_file.Clear();
+            located_dsym.Clear();
             load_process_stop_id = UINT32_MAX;
         }
 
@@ -292,6 +298,21 @@ protected:
     
     bool
     AddModulesUsingImageInfos (OSKextLoadedKextSummary::collection &image_infos);
+
+    void
+    LocateKextFiles (OSKextLoadedKextSummary::collection &image_infos);
+
+    struct KextLocateWorkerState
+    {
+        lldb_private::Mutex *mutex;
+        size_t *next_idx;
+        const lldb_private::ArchSpec *arch;
+        const std::vector<size_t> *summary_indexes;
+        OSKextLoadedKextSummary::collection *summaries;
+    };
+
+    static void *
+    KextLocateWorkerThread (void *arg);
     
     void
     UpdateImageInfosHeaderAndLoadCommands(OSKextLoadedKextSummary::collection &image_infos, 
@@ -8,6 +8,8 @@
 //===----------------------------------------------------------------------===//
 
 
+#include <algorithm>
+
 #include "llvm/Support/MachO.h"
 
 #include "lldb/Breakpoint/StoppointCallbackContext.h"
@@ -19,6 +21,9 @@
 #include "lldb/Core/PluginManager.h"
 #include "lldb/Core/Section.h"
 #include "lldb/Core/State.h"
+#include "lldb/Host/Host.h"
+#include "lldb/Host/Symbols.h"
+#include "lldb/Interpreter/Args.h"
 #include "lldb/Symbol/Function.h"
 #include "lldb/Symbol/ObjectFile.h"
 #include "lldb/Target/ObjCLanguageRuntime.h"
@@ -28,6 +33,8 @@
 #include "lldb/Target/ThreadPlanRunToAddress.h"
 #include "lldb/Target/StackFrame.h"
 
+#include "Utility/StringExtractor.h"
+
 #include "DynamicLoaderMacOSXDYLD.h"
 
 //#define ENABLE_DEBUG_PRINTF // COMMENT THIS LINE OUT PRIOR TO CHECKIN
@@ -779,6 +786,142 @@ DynamicLoaderMacOSXDYLD::AddModulesUsingImageInfosAddress (lldb::addr_t image_in
     return return_value;
 }
 
+// Don't bother spinning up threads unless each one has at least this
+// many modules to create.
+#define DYLD_MIN_MODULES_PER_WORKER 8
+
+struct DYLDModuleWorkerState
+{
+    Mutex *mutex;
+    size_t *next_idx;
+    const std::vector<ModuleSpec> *module_specs;
+    std::vector<ModuleSP> *modules;
+};
+
+static void *
+DYLDModuleWorkerThread (void *arg)
+{
+    DYLDModuleWorkerState *state = (DYLDModuleWorkerState *)arg;
+    const size_t num_specs = state->module_specs->size();
+    while (1)
+    {
+        // Modules vary a lot in size, so hand them out one at a time
+        // instead of splitting the list into fixed ranges.
+        size_t idx;
+        {
+            Mutex::Locker locker (*state->mutex);
+            idx = (*state->next_idx)++;
+        }
+        if (idx >= num_specs)
+            break;
+
+        const ModuleSpec &module_spec = (*state->module_specs)[idx];
+        ModuleSP module_sp (new Module (module_spec));
+        ObjectFile *objfile = module_sp->GetObjectFile();
+        if (objfile && module_sp->GetUUID() == module_spec.GetUUID())
+        {
+            // Parsing the load commands into sections is the other
+            // expensive part of loading a module, get it done here too.
+            objfile->GetSectionList();
+            (*state->modules)[idx] = module_sp;
+        }
+    }
+    return NULL;
+}
+
+//----------------------------------------------------------------------
+// Opening the object file for each image, parsing its load commands
+// and building its section list are the expensive parts of adding
+// images, so create the modules for any images that we will need to
+// load from disk on multiple threads and put them in the shared module
+// list. AddModulesUsingImageInfos() then finds them there when it adds
+// them to the target and updates the section load list, which still
+// happens serially and in order.
+//----------------------------------------------------------------------
+void
+DynamicLoaderMacOSXDYLD::CreateModulesForImageInfos (const DYLDImageInfo::collection &image_infos)
+{
+    ModuleList &target_images = m_process->GetTarget().GetImages();
+    std::vector<ModuleSpec> module_specs;
+    const size_t num_image_infos = image_infos.size();
+    for (size_t idx = 0; idx < num_image_infos; ++idx)
+    {
+        // Without a UUID we can't tell whether a file on disk is the one
+        // that was loaded, so leave those to the platform.
+        ModuleSpec module_spec (image_infos[idx].file_spec, image_infos[idx].GetArchitecture ());
+        module_spec.GetUUID() = image_infos[idx].uuid;
+        if (!module_spec.GetUUID().IsValid() || !module_spec.GetFileSpec().Exists())
+            continue;
+        if (target_images.FindFirstModule (module_spec))
+            continue;
+        ModuleList matching_module_list;
+        if (ModuleList::FindSharedModules (module_spec, matching_module_list) > 0)
+            continue;
+        module_specs.push_back (module_spec);
+    }
+
+    const size_t num_specs = module_specs.size();
+    const uint32_t num_workers = std::min<uint32_t> (Host::GetNumberCPUs(), num_specs / DYLD_MIN_MODULES_PER_WORKER);
+    if (num_workers <= 1)
+        return;
+
+    LogSP log(lldb_private::GetLogIfAnyCategoriesSet (LIBLLDB_LOG_DYNAMIC_LOADER));
+    if (log)
+        log->Printf ("Creating %llu modules on %u threads.", (uint64_t)num_specs, num_workers);
+
+    Mutex mutex;
+    size_t next_idx = 0;
+    std::vector<ModuleSP> modules (num_specs);
+    DYLDModuleWorkerState state = { &mutex, &next_idx, &module_specs, &modules };
+
+    // The calling thread does work too, so only spawn threads for the
+    // rest of the workers.
+    std::vector<lldb::thread_t> threads;
+    for (uint32_t i=1; i<num_workers; ++i)
+    {
+        lldb::thread_t thread = Host::ThreadCreate ("<lldb.dyld.create-modules>", DYLDModuleWorkerThread, &state, NULL);
+        if (IS_VALID_LLDB_HOST_THREAD(thread))
+            threads.push_back (thread);
+    }
+
+    DYLDModuleWorkerThread (&state);
+
+    for (size_t i=0; i<threads.size(); ++i)
+        Host::ThreadJoin (threads[i], NULL, NULL);
+
+    // Finding the dSYMs is the other slow part of getting a module
+    // ready, do all of those at once too so the symbol vendors don't
+    // each search on their own later.
+    std::vector<ModuleSpec> dsym_module_specs;
+    std::vector<size_t> dsym_module_indexes;
+    for (size_t i=0; i<num_specs; ++i)
+    {
+        if (modules[i] && !modules[i]->GetSymbolFileFileSpec())
+        {
+            ModuleSpec dsym_module_spec (modules[i]->GetFileSpec(), modules[i]->GetArchitecture());
+            dsym_module_spec.GetUUID() = modules[i]->GetUUID();
+            dsym_module_specs.push_back (dsym_module_spec);
+            dsym_module_indexes.push_back (i);
+        }
+    }
+    std::vector<FileSpec> dsym_files;
+    if (Symbols::LocateExecutableSymbolFiles (dsym_module_specs, dsym_files) > 0)
+    {
+        for (size_t i=0; i<dsym_files.size(); ++i)
+        {
+            if (!dsym_files[i])
+                continue;
+            ModuleSP &module_sp = modules[dsym_module_indexes[i]];
+            module_sp->SetSymbolFileFileSpec (dsym_files[i]);
+            if (dsym_module_specs[i].GetSourceMappingList().GetSize())
+                module_sp->GetSourceMappingList().Append (dsym_module_specs[i].GetSourceMappingList (), true);
+        }
+    }
+
+    for (size_t i=0; i<num_specs; ++i)
+        ModuleList::AddSharedModule (modules[i]);
+}
+
 // Adds the modules in image_infos to m_dyld_image_infos.  
 // NB don't call this passing in m_dyld_image_infos.
 
@@ -788,6 +931,8 @@ DynamicLoaderMacOSXDYLD::AddModulesUsingImageInfos (DYLDImageInfo::collection &i
     // Now add these images to the main list.
     ModuleList loaded_module_list;
     LogSP log(lldb_private::GetLogIfAnyCategoriesSet (LIBLLDB_LOG_DYNAMIC_LOADER));
+
+    CreateModulesForImageInfos (image_infos);
     
     for (uint32_t idx = 0; idx < image_infos.size(); ++idx)
     {
@@ -809,34 +954,33 @@ DynamicLoaderMacOSXDYLD::AddModulesUsingImageInfos (DYLDImageInfo::collection &i
             ObjectFile *objfile = image_module_sp->GetObjectFile ();
             if (objfile)
             {
-                SectionList *sections = objfile->GetSectionList();
-                if (sections)
+                // We already have the segments from the load commands in
+                // memory, use them instead of building the section list
+                // of every image just to look for the commpage
+                ConstString commpage_dbstr("__commpage");
+                const Segment *commpage_segment = image_infos[idx].FindSegment(commpage_dbstr);
+                if (commpage_segment)
                 {
-                    ConstString commpage_dbstr("__commpage");
-                    Section *commpage_section = sections->FindSectionByName(commpage_dbstr).get();
-                    if (commpage_section)
+                    ModuleList& target_images = m_process->GetTarget().GetImages();
+                    ModuleSpec module_spec (objfile->GetFileSpec(), image_infos[idx].GetArchitecture ());
+                    module_spec.GetObjectName() = commpage_dbstr;
+                    ModuleSP commpage_image_module_sp(target_images.FindFirstModule (module_spec));
+                    if (!commpage_image_module_sp)
                     {
-                        ModuleList& target_images = m_process->GetTarget().GetImages();
-                        ModuleSpec module_spec (objfile->GetFileSpec(), image_infos[idx].GetArchitecture ());
-                        module_spec.GetObjectName() = commpage_dbstr;
-                        ModuleSP commpage_image_module_sp(target_images.FindFirstModule (module_spec));
-                        if (!commpage_image_module_sp)
+                        module_spec.SetObjectOffset (objfile->GetOffset() + commpage_segment->fileoff);
+                        commpage_image_module_sp  = m_process->GetTarget().GetSharedModule (module_spec);
+                        if (!commpage_image_module_sp || commpage_image_module_sp->GetObjectFile() == NULL)
                         {
-                            module_spec.SetObjectOffset (objfile->GetOffset() + commpage_section->GetFileOffset());
-                            commpage_image_module_sp  = m_process->GetTarget().GetSharedModule (module_spec);
-                            if (!commpage_image_module_sp || commpage_image_module_sp->GetObjectFile() == NULL)
-                            {
-                                const bool add_image_to_target = true;
-                                const bool load_image_sections_in_target = false;
-                                commpage_image_module_sp = m_process->ReadModuleFromMemory (image_infos[idx].file_spec,
-                                                                                            image_infos[idx].address,
-                                                                                            add_image_to_target,
-                                                                                            load_image_sections_in_target);
-                            }
+                            const bool add_image_to_target = true;
+                            const bool load_image_sections_in_target = false;
+                            commpage_image_module_sp = m_process->ReadModuleFromMemory (image_infos[idx].file_spec,
+                                                                                        image_infos[idx].address,
+                                                                                        add_image_to_target,
+                                                                                        load_image_sections_in_target);
                         }
-                        if (commpage_image_module_sp)
-                            UpdateCommPageLoadAddress (commpage_image_module_sp.get());
                     }
+                    if (commpage_image_module_sp)
+                        UpdateCommPageLoadAddress (commpage_image_module_sp.get());
                 }
             }
 
@@ -977,6 +1121,12 @@ DynamicLoaderMacOSXDYLD::ReadImageInfos (lldb::addr_t image_infos_addr,
                                          uint32_t image_infos_count, 
                                          DYLDImageInfo::collection &image_infos)
 {
+    // Debug servers that can walk the image list themselves save us
+    // from reading each image info and path separately, and they also
+    // give us the mach headers and load commands
+    if (GetImageInfosFromProcess (image_infos_addr, image_infos_count, image_infos))
+        return true;
+
     const ByteOrder endian = m_dyld.GetByteOrder();
     const uint32_t addr_size = m_dyld.GetAddressByteSize();
 
@@ -1015,6 +1165,106 @@ DynamicLoaderMacOSXDYLD::ReadImageInfos (lldb::addr_t image_infos_addr,
     }
 }
 
+//----------------------------------------------------------------------
+// Get the image infos along with each image's mach header, UUID and
+// segments from the process plug-in with a single request. Returns
+// false if the process plug-in can't do this, in which case the image
+// infos need to be read from memory.
+//----------------------------------------------------------------------
+bool
+DynamicLoaderMacOSXDYLD::GetImageInfosFromProcess (lldb::addr_t image_infos_addr, 
+                                                   uint32_t image_infos_count, 
+                                                   DYLDImageInfo::collection &image_infos)
+{
+    std::string infos;
+    if (m_process->GetSharedLibraryInfos (image_infos_addr, image_infos_count, infos).Fail())
+        return false;
+
+    DYLDImageInfo::collection new_image_infos;
+    new_image_infos.reserve (image_infos_count);
+    StringExtractor extractor (infos.c_str());
+    std::string name;
+    std::string value;
+    while (extractor.GetNameColonValue (name, value))
+    {
+        // Each image starts with its address
+        if (name.compare ("address") == 0)
+        {
+            new_image_infos.push_back (DYLDImageInfo());
+            new_image_infos.back().address = Args::StringToUInt64 (value.c_str(), LLDB_INVALID_ADDRESS, 16);
+            continue;
+        }
+
+        if (new_image_infos.empty())
+            return false;
+        DYLDImageInfo &image_info = new_image_infos.back();
+        StringExtractor value_extractor (value.c_str());
+        if (name.compare ("mod_date") == 0)
+        {
+            image_info.mod_date = Args::StringToUInt64 (value.c_str(), 0, 16);
+        }
+        else if (name.compare ("path") == 0)
+        {
+            std::string path;
+            value_extractor.GetHexByteString (path);
+            // don't resolve the path
+            const bool resolve_path = false;
+            image_info.file_spec.SetFile (path.c_str(), resolve_path);
+        }
+        else if (name.compare ("header") == 0)
+        {
+            // magic,cputype,cpusubtype,filetype,ncmds,sizeofcmds,flags
+            uint32_t *header_fields = &image_info.header.magic;
+            for (uint32_t i = 0; i < 7; ++i)
+            {
+                if (i > 0 && value_extractor.GetChar() != ',')
+                    return false;
+                header_fields[i] = value_extractor.GetHexMaxU32 (false, 0);
+            }
+        }
+        else if (name.compare ("uuid") == 0)
+        {
+            uint8_t uuid_bytes[16];
+            if (value_extractor.GetHexBytes (uuid_bytes, sizeof(uuid_bytes), 0) == sizeof(uuid_bytes))
+                image_info.uuid.SetBytes (uuid_bytes);
+        }
+        else if (name.compare ("segment") == 0)
+        {
+            // vmaddr,vmsize,fileoff,filesize,maxprot,initprot,nsects,flags,name
+            Segment segment;
+            segment.vmaddr = value_extractor.GetHexMaxU64 (false, 0);
+            value_extractor.GetChar();
+            segment.vmsize = value_extractor.GetHexMaxU64 (false, 0);
+            value_extractor.GetChar();
+            segment.fileoff = value_extractor.GetHexMaxU64 (false, 0);
+            value_extractor.GetChar();
+            segment.filesize = value_extractor.GetHexMaxU64 (false, 0);
+            value_extractor.GetChar();
+            segment.maxprot = value_extractor.GetHexMaxU32 (false, 0);
+            value_extractor.GetChar();
+            segment.initprot = value_extractor.GetHexMaxU32 (false, 0);
+            value_extractor.GetChar();
+            segment.nsects = value_extractor.GetHexMaxU32 (false, 0);
+            value_extractor.GetChar();
+            segment.flags = value_extractor.GetHexMaxU32 (false, 0);
+            if (value_extractor.GetChar() != ',')
+                return false;
+            std::string segment_name;
+            value_extractor.GetHexByteString (segment_name);
+            segment.name.SetCString (segment_name.c_str());
+            image_info.segments.push_back (segment);
+        }
+    }
+
+    if (new_image_infos.size() != image_infos_count)
+        return false;
+
+    for (uint32_t i = 0; i < image_infos_count; ++i)
+        new_image_infos[i].CalculateSlide ();
+    image_infos.swap (new_image_infos);
+    return true;
+}
+
 //----------------------------------------------------------------------
 // If we have found where the "_dyld_all_image_infos" lives in memory,
 // read the current info from it, and then update all image load
@@ -1235,27 +1485,7 @@ DynamicLoaderMacOSXDYLD::ParseLoadCommands (const DataExtractor& data, DYLDImage
         }
     }
     
-    // All sections listed in the dyld image info structure will all
-    // either be fixed up already, or they will all be off by a single
-    // slide amount that is determined by finding the first segment
-    // that is at file offset zero which also has bytes (a file size
-    // that is greater than zero) in the object file.
-    
-    // Determine the slide amount (if any)
-    const size_t num_sections = dylib_info.segments.size();
-    for (size_t i = 0; i < num_sections; ++i)
-    {
-        // Iterate through the object file sections to find the
-        // first section that starts of file offset zero and that
-        // has bytes in the file...
-        if (dylib_info.segments[i].fileoff == 0 && dylib_info.segments[i].filesize > 0)
-        {
-            dylib_info.slide = dylib_info.address - dylib_info.segments[i].vmaddr;
-            // We have found the slide amount, so we can exit
-            // this for loop.
-            break;
-        }
-    }
+    dylib_info.CalculateSlide ();
     return cmd_idx;
 }
 
@@ -1274,6 +1504,8 @@ DynamicLoaderMacOSXDYLD::UpdateImageInfosHeaderAndLoadCommands(DYLDImageInfo::co
     // Read any UUID values that we can get
     for (uint32_t i = 0; i < infos_count; i++)
     {
+        // Images we got from GetImageInfosFromProcess() already have
+        // their UUIDs and segments
         if (!image_infos[i].UUIDValid())
         {
             DataExtractor data; // Load command data
@@ -1281,11 +1513,10 @@ DynamicLoaderMacOSXDYLD::UpdateImageInfosHeaderAndLoadCommands(DYLDImageInfo::co
                 continue;
 
             ParseLoadCommands (data, image_infos[i], NULL);
-
-            if (image_infos[i].header.filetype == llvm::MachO::HeaderFileTypeExecutable)
-                exe_idx = i;
-            
         }
+
+        if (image_infos[i].header.filetype == llvm::MachO::HeaderFileTypeExecutable)
+            exe_idx = i;
     }
 
     if (exe_idx < image_infos.size())
@@ -1399,6 +1630,32 @@ DynamicLoaderMacOSXDYLD::DYLDImageInfo::FindSegment (const ConstString &name) co
     return NULL;
 }
 
+void
+DynamicLoaderMacOSXDYLD::DYLDImageInfo::CalculateSlide ()
+{
+    // All sections listed in the dyld image info structure will all
+    // either be fixed up already, or they will all be off by a single
+    // slide amount that is determined by finding the first segment
+    // that is at file offset zero which also has bytes (a file size
+    // that is greater than zero) in the object file.
+    
+    // Determine the slide amount (if any)
+    const size_t num_sections = segments.size();
+    for (size_t i = 0; i < num_sections; ++i)
+    {
+        // Iterate through the object file sections to find the
+        // first section that starts of file offset zero and that
+        // has bytes in the file...
+        if (segments[i].fileoff == 0 && segments[i].filesize > 0)
+        {
+            slide = address - segments[i].vmaddr;
+            // We have found the slide amount, so we can exit
+            // this for loop.
+            break;
+        }
+    }
+}
+
 
 //----------------------------------------------------------------------
 // Dump an image info structure to the file handle provided.
@@ -245,6 +245,9 @@ protected:
         const Segment *
         FindSegment (const lldb_private::ConstString &name) const;
 
+        void
+        CalculateSlide ();
+
         void
         PutToLog (lldb_private::Log *log) const;
 
@@ -345,6 +348,9 @@ protected:
     
     bool
     AddModulesUsingImageInfos (DYLDImageInfo::collection &image_infos);
+
+    void
+    CreateModulesForImageInfos (const DYLDImageInfo::collection &image_infos);
     
     bool
     RemoveModulesUsingImageInfosAddress (lldb::addr_t image_infos_addr, uint32_t image_infos_count);
@@ -362,6 +368,11 @@ protected:
                     uint32_t image_infos_count, 
                     DYLDImageInfo::collection &image_infos);
 
+    bool
+    GetImageInfosFromProcess (lldb::addr_t image_infos_addr, 
+                              uint32_t image_infos_count, 
+                              DYLDImageInfo::collection &image_infos);
+
 
     DYLDImageInfo m_dyld;               // Info about the current dyld being used
     lldb::addr_t m_dyld_all_image_infos_addr;
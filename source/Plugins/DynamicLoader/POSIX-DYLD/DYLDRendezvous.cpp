@@ -11,6 +11,7 @@
 // C++ Includes
 // Other libraries and framework includes
 #include "lldb/Core/ArchSpec.h"
+#include "lldb/Core/DataExtractor.h"
 #include "lldb/Core/Error.h"
 #include "lldb/Core/Log.h"
 #include "lldb/Core/Module.h"
@@ -56,7 +57,8 @@ DYLDRendezvous::DYLDRendezvous(Process *process)
       m_previous(),
       m_soentries(),
       m_added_soentries(),
-      m_removed_soentries()
+      m_removed_soentries(),
+      m_tail_entry()
 {
     // Cache a copy of the executable path
     m_process->GetTarget().GetExecutableModule().get()->GetFileSpec().GetPath(m_exe_path, PATH_MAX);
@@ -115,8 +117,6 @@ DYLDRendezvous::IsValid()
 bool
 DYLDRendezvous::UpdateSOEntries()
 {
-    SOEntry entry;
-
     if (m_current.map_addr == 0)
         return false;
 
@@ -124,17 +124,22 @@ DYLDRendezvous::UpdateSOEntries()
     // time we have been asked to update.  Just take a snapshot of the currently
     // loaded modules.
     if (m_previous.state == eConsistent && m_current.state == eConsistent) 
+    {
+        m_soentries.clear();
         return TakeSnapshot(m_soentries);
+    }
 
-    // If we are about to add or remove a shared object clear out the current
-    // state and take a snapshot of the currently loaded images.
+    // If we are about to add or remove a shared object the link map still
+    // matches the snapshot we took when it was last consistent, so all we
+    // need to do is forget the previous changes.
     if (m_current.state == eAdd || m_current.state == eDelete)
     {
         assert(m_previous.state == eConsistent);
-        m_soentries.clear();
         m_added_soentries.clear();
         m_removed_soentries.clear();
-        return TakeSnapshot(m_soentries);
+        if (m_soentries.empty())
+            return TakeSnapshot(m_soentries);
+        return true;
     }
     assert(m_current.state == eConsistent);
 
@@ -151,51 +156,87 @@ DYLDRendezvous::UpdateSOEntries()
 bool
 DYLDRendezvous::UpdateSOEntriesForAddition()
 {
-    SOEntry entry;
-    iterator pos;
-
     assert(m_previous.state == eAdd);
 
     if (m_current.map_addr == 0)
         return false;
 
-    for (addr_t cursor = m_current.map_addr; cursor != 0; cursor = entry.next)
+    // New entries are appended to the end of the link map.  If the list still
+    // starts where it did and the entry that used to be last is unchanged,
+    // only the entries after it need to be read.
+    if (m_current.map_addr == m_previous.map_addr && m_tail_entry.link_addr != 0)
     {
-        if (!ReadSOEntryFromMemory(cursor, entry))
-            return false;
-
-        // Only add shared libraries and not the executable.
-        // On Linux this is indicated by an empty path in the entry.
-        // On FreeBSD it is the name of the executable.
-        if (entry.path.empty() || ::strcmp(entry.path.c_str(), m_exe_path) == 0)
-            continue;
+        SOEntryMap tail_entries;
+        tail_entries[m_tail_entry.link_addr] = &m_tail_entry;
 
-        pos = std::find(m_soentries.begin(), m_soentries.end(), entry);
-        if (pos == m_soentries.end())
+        SOEntry tail;
+        if (ReadSOEntryFromMemory(m_tail_entry.link_addr, tail, &tail_entries) &&
+            tail.base_addr == m_tail_entry.base_addr &&
+            tail.path_addr == m_tail_entry.path_addr)
         {
-            m_soentries.push_back(entry);
-            m_added_soentries.push_back(entry);
+            m_tail_entry = tail;
+            if (tail.next == 0)
+                return true;
+
+            SOEntryList entry_list;
+            if (!ReadLinkMap(tail.next, entry_list, NULL))
+                return false;
+
+            for (iterator I = entry_list.begin(); I != entry_list.end(); ++I)
+            {
+                if (std::find(m_soentries.begin(), m_soentries.end(), *I) == m_soentries.end())
+                {
+                    m_soentries.push_back(*I);
+                    m_added_soentries.push_back(*I);
+                }
+            }
+            return true;
         }
     }
 
+    // The list was modified somewhere other than its end, read all of it and
+    // compare it against what we had.
+    SOEntryMap known_entries;
+    BuildSOEntryMap(m_soentries, known_entries);
+
+    SOEntryList entry_list;
+    if (!ReadLinkMap(m_current.map_addr, entry_list, &known_entries))
+        return false;
+
+    for (iterator I = entry_list.begin(); I != entry_list.end(); ++I)
+    {
+        if (std::find(m_soentries.begin(), m_soentries.end(), *I) == m_soentries.end())
+            m_added_soentries.push_back(*I);
+    }
+
+    m_soentries = entry_list;
     return true;
 }
 
 bool
 DYLDRendezvous::UpdateSOEntriesForDeletion()
 {
-    SOEntryList entry_list;
-    iterator pos;
-
     assert(m_previous.state == eDelete);
 
-    if (!TakeSnapshot(entry_list))
+    if (m_current.map_addr == 0)
+        return false;
+
+    // An entry can be removed from anywhere in the list so we have to walk all
+    // of it, but the entries that remain don't need their paths read again.
+    SOEntryMap known_entries;
+    BuildSOEntryMap(m_soentries, known_entries);
+
+    SOEntryList entry_list;
+    if (!ReadLinkMap(m_current.map_addr, entry_list, &known_entries))
         return false;
 
+    SOEntryMap current_entries;
+    BuildSOEntryMap(entry_list, current_entries);
+
     for (iterator I = begin(); I != end(); ++I)
     {
-        pos = std::find(entry_list.begin(), entry_list.end(), *I);
-        if (pos == entry_list.end())
+        SOEntryMap::const_iterator pos = current_entries.find(I->link_addr);
+        if (pos == current_entries.end() || !(*pos->second == *I))
             m_removed_soentries.push_back(*I);
     }
 
@@ -206,23 +247,43 @@ DYLDRendezvous::UpdateSOEntriesForDeletion()
 bool
 DYLDRendezvous::TakeSnapshot(SOEntryList &entry_list)
 {
-    SOEntry entry;
-
     if (m_current.map_addr == 0)
         return false;
 
-    for (addr_t cursor = m_current.map_addr; cursor != 0; cursor = entry.next)
+    return ReadLinkMap(m_current.map_addr, entry_list, NULL);
+}
+
+void
+DYLDRendezvous::BuildSOEntryMap(const SOEntryList &entry_list, SOEntryMap &entry_map)
+{
+    for (iterator I = entry_list.begin(); I != entry_list.end(); ++I)
+        entry_map[I->link_addr] = &*I;
+}
+
+bool
+DYLDRendezvous::IsSharedLibraryEntry(const SOEntry &entry) const
+{
+    // Only add shared libraries and not the executable.
+    // On Linux this is indicated by an empty path in the entry.
+    // On FreeBSD it is the name of the executable.
+    return !entry.path.empty() && ::strcmp(entry.path.c_str(), m_exe_path) != 0;
+}
+
+bool
+DYLDRendezvous::ReadLinkMap(addr_t cursor, SOEntryList &entry_list,
+                            const SOEntryMap *known_entries)
+{
+    SOEntry entry;
+
+    for (; cursor != 0; cursor = entry.next)
     {
-        if (!ReadSOEntryFromMemory(cursor, entry))
+        if (!ReadSOEntryFromMemory(cursor, entry, known_entries))
             return false;
 
-        // Only add shared libraries and not the executable.
-        // On Linux this is indicated by an empty path in the entry.
-        // On FreeBSD it is the name of the executable.
-        if (entry.path.empty() || ::strcmp(entry.path.c_str(), m_exe_path) == 0)
-            continue;
+        m_tail_entry = entry;
 
-        entry_list.push_back(entry);
+        if (IsSharedLibraryEntry(entry))
+            entry_list.push_back(entry);
     }
 
     return true;
@@ -246,49 +307,55 @@ DYLDRendezvous::ReadStringFromMemory(addr_t addr)
 {
     std::string str;
     Error error;
-    size_t size;
-    char c;
 
     if (addr == LLDB_INVALID_ADDRESS)
         return std::string();
 
-    for (;;) {
-        size = m_process->DoReadMemory(addr, &c, 1, error);
-        if (size != 1 || error.Fail())
-            return std::string();
-        if (c == 0)
-            break;
-        else {
-            str.push_back(c);
-            addr++;
-        }
-    }
+    // Read the string a cache line at a time rather than a byte at a time.
+    m_process->ReadCStringFromMemory(addr, str, error);
+    if (error.Fail())
+        return std::string();
 
     return str;
 }
 
 bool
-DYLDRendezvous::ReadSOEntryFromMemory(lldb::addr_t addr, SOEntry &entry)
+DYLDRendezvous::ReadSOEntryFromMemory(lldb::addr_t addr, SOEntry &entry,
+                                      const SOEntryMap *known_entries)
 {
-    size_t address_size = m_process->GetAddressByteSize();
+    const size_t address_size = m_process->GetAddressByteSize();
+    uint8_t buffer[5 * sizeof(uint64_t)];
+    const size_t entry_size = 5 * address_size;
 
     entry.clear();
-    
-    if (!(addr = ReadMemory(addr, &entry.base_addr, address_size)))
-        return false;
-    
-    if (!(addr = ReadMemory(addr, &entry.path_addr, address_size)))
-        return false;
-    
-    if (!(addr = ReadMemory(addr, &entry.dyn_addr, address_size)))
-        return false;
-    
-    if (!(addr = ReadMemory(addr, &entry.next, address_size)))
+
+    if (entry_size > sizeof(buffer))
         return false;
-    
-    if (!(addr = ReadMemory(addr, &entry.prev, address_size)))
+
+    // Read the l_addr, l_name, l_ld, l_next and l_prev fields of the link_map
+    // with a single memory read.
+    if (!ReadMemory(addr, buffer, entry_size))
         return false;
-    
+
+    DataExtractor data(buffer, entry_size, m_process->GetByteOrder(), address_size);
+    uint32_t offset = 0;
+    entry.link_addr = addr;
+    entry.base_addr = data.GetPointer(&offset);
+    entry.path_addr = data.GetPointer(&offset);
+    entry.dyn_addr  = data.GetPointer(&offset);
+    entry.next      = data.GetPointer(&offset);
+    entry.prev      = data.GetPointer(&offset);
+
+    if (known_entries)
+    {
+        SOEntryMap::const_iterator pos = known_entries->find(addr);
+        if (pos != known_entries->end() && pos->second->path_addr == entry.path_addr)
+        {
+            entry.path = pos->second->path;
+            return true;
+        }
+    }
+
     entry.path = ReadStringFromMemory(entry.path_addr);
     
     return true;
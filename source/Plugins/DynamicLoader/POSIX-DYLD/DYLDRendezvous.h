@@ -13,6 +13,7 @@
 // C Includes
 // C++ Includes
 #include <list>
+#include <map>
 #include <string>
 
 // Other libraries and framework includes
@@ -128,6 +129,7 @@ public:
     /// This object is a rough analogue to the struct link_map object which
     /// actually lives in the inferiors memory.
     struct SOEntry {
+        lldb::addr_t link_addr; ///< Address of this entry's link_map.
         lldb::addr_t base_addr; ///< Base address of the loaded object.
         lldb::addr_t path_addr; ///< String naming the shared object.
         lldb::addr_t dyn_addr;  ///< Dynamic section of shared object.
@@ -137,11 +139,12 @@ public:
 
         SOEntry() { clear(); }
 
-        bool operator ==(const SOEntry &entry) {
+        bool operator ==(const SOEntry &entry) const {
             return this->path == entry.path;
         }
 
         void clear() {
+            link_addr = 0;
             base_addr = 0;
             path_addr = 0;
             dyn_addr  = 0;
@@ -154,6 +157,9 @@ public:
 protected:
     typedef std::list<SOEntry> SOEntryList;
 
+    /// Maps link_map addresses to the entries read from them.
+    typedef std::map<lldb::addr_t, const SOEntry *> SOEntryMap;
+
 public:
     typedef SOEntryList::const_iterator iterator;
 
@@ -194,6 +200,12 @@ protected:
     /// Resolve().
     SOEntryList m_removed_soentries;
 
+    /// The last entry in the link map when it was last read, including
+    /// entries that are not in m_soentries.  The runtime linker appends
+    /// newly loaded objects to the end of the list so we only need to read
+    /// the entries after this one when modules are added.
+    SOEntry m_tail_entry;
+
     /// Reads @p size bytes from the inferiors address space starting at @p
     /// addr.
     ///
@@ -206,9 +218,23 @@ protected:
     std::string
     ReadStringFromMemory(lldb::addr_t addr);
 
-    /// Reads an SOEntry starting at @p addr.
+    /// Reads an SOEntry starting at @p addr.  If @p known_entries contains an
+    /// entry for the same link_map naming the same string its path is reused
+    /// instead of being read from the inferior again.
+    bool
+    ReadSOEntryFromMemory(lldb::addr_t addr, SOEntry &entry,
+                          const SOEntryMap *known_entries = NULL);
+
+    /// @returns true if @p entry names a shared library and not the
+    /// executable.
     bool
-    ReadSOEntryFromMemory(lldb::addr_t addr, SOEntry &entry);
+    IsSharedLibraryEntry(const SOEntry &entry) const;
+
+    /// Reads the entries of the link map starting at @p cursor and appends
+    /// the shared libraries to @p entry_list.
+    bool
+    ReadLinkMap(lldb::addr_t cursor, SOEntryList &entry_list,
+                const SOEntryMap *known_entries);
 
     /// Updates the current set of SOEntries, the set of added entries, and the
     /// set of removed entries.
@@ -225,6 +251,10 @@ protected:
     /// supplied by the runtime linker.
     bool
     TakeSnapshot(SOEntryList &entry_list);
+
+    /// Fills in @p entry_map with the entries in @p entry_list.
+    static void
+    BuildSOEntryMap(const SOEntryList &entry_list, SOEntryMap &entry_map);
 };
 
 #endif
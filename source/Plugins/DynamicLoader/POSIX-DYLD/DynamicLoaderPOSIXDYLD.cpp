@@ -273,7 +273,8 @@ DynamicLoaderPOSIXDYLD::RefreshModules()
             if (module_sp.get())
                 new_modules.Append(module_sp);
         }
-        m_process->GetTarget().ModulesDidLoad(new_modules);
+        if (new_modules.GetSize() > 0)
+            m_process->GetTarget().ModulesDidLoad(new_modules);
     }
     
     if (m_rendezvous.ModulesDidUnload())
@@ -375,15 +376,19 @@ DynamicLoaderPOSIXDYLD::LoadModuleAtAddress(const FileSpec &file, addr_t base_ad
     ModuleList &modules = target.GetImages();
     ModuleSP module_sp;
 
+    // Our callers report all of the modules they load with a single call
+    // to ModulesDidLoad() once their sections are loaded, so don't have the
+    // target notify for each one.
+    const bool notify = false;
     ModuleSpec module_spec (file, target.GetArchitecture());
     if ((module_sp = modules.FindFirstModule (module_spec))) 
     {
         UpdateLoadedSections(module_sp, base_addr);
     }
-    else if ((module_sp = target.GetSharedModule(module_spec))) 
+    else if ((module_sp = target.GetSharedModule(module_spec, NULL, notify))) 
     {
         UpdateLoadedSections(module_sp, base_addr);
-        modules.Append(module_sp);
+        modules.AppendIfNeeded(module_sp);
     }
 
     return module_sp;
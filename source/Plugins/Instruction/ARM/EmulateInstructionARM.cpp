@@ -9,6 +9,8 @@
 
 #include <stdlib.h>
 
+#include <vector>
+
 #include "EmulateInstructionARM.h"
 #include "EmulationStateARM.h"
 #include "lldb/Core/ArchSpec.h"
@@ -12249,6 +12251,76 @@ EmulateInstructionARM::EmulateSUBSPcLrEtc (const uint32_t opcode, const ARMEncod
     return true;
 }
     
+//----------------------------------------------------------------------
+// Finds the first entry of an opcode table that matches an opcode
+// without comparing the opcode against every entry.
+//
+// The entries are put in buckets keyed by two fields of opcode bits.
+// An entry whose mask doesn't cover all of those bits goes in every
+// bucket it could match. Each bucket keeps its entries in table order,
+// so the first match in the bucket is the first match a scan of the
+// whole table would find.
+//----------------------------------------------------------------------
+class EmulateInstructionARM::OpcodeDecodeTable
+{
+public:
+    OpcodeDecodeTable (ARMOpcode *opcodes,
+                       size_t num_opcodes,
+                       uint32_t hi_shift,
+                       uint32_t hi_num_bits,
+                       uint32_t lo_shift,
+                       uint32_t lo_num_bits) :
+        m_opcodes (opcodes),
+        m_hi_shift (hi_shift),
+        m_hi_mask ((1u << hi_num_bits) - 1),
+        m_lo_shift (lo_shift),
+        m_lo_num_bits (lo_num_bits),
+        m_lo_mask ((1u << lo_num_bits) - 1),
+        m_bucket_offsets (),
+        m_bucket_entries ()
+    {
+        const uint32_t num_buckets = 1u << (hi_num_bits + lo_num_bits);
+        const uint32_t key_bits = (m_hi_mask << m_hi_shift) | (m_lo_mask << m_lo_shift);
+        m_bucket_offsets.reserve (num_buckets + 1);
+        for (uint32_t key = 0; key < num_buckets; ++key)
+        {
+            m_bucket_offsets.push_back (m_bucket_entries.size());
+            const uint32_t key_value = ((key >> m_lo_num_bits) << m_hi_shift) | ((key & m_lo_mask) << m_lo_shift);
+            for (size_t i=0; i<num_opcodes; ++i)
+            {
+                if (((opcodes[i].value ^ key_value) & opcodes[i].mask & key_bits) == 0)
+                    m_bucket_entries.push_back (i);
+            }
+        }
+        m_bucket_offsets.push_back (m_bucket_entries.size());
+    }
+
+    ARMOpcode *
+    FindOpcode (uint32_t opcode, uint32_t arm_isa) const
+    {
+        const uint32_t key = (((opcode >> m_hi_shift) & m_hi_mask) << m_lo_num_bits) | ((opcode >> m_lo_shift) & m_lo_mask);
+        const uint32_t end = m_bucket_offsets[key + 1];
+        for (uint32_t i = m_bucket_offsets[key]; i < end; ++i)
+        {
+            ARMOpcode *entry = &m_opcodes[m_bucket_entries[i]];
+            if ((entry->mask & opcode) == entry->value &&
+                (entry->variants & arm_isa) != 0)
+                return entry;
+        }
+        return NULL;
+    }
+
+private:
+    ARMOpcode *m_opcodes;
+    uint32_t m_hi_shift;
+    uint32_t m_hi_mask;
+    uint32_t m_lo_shift;
+    uint32_t m_lo_num_bits;
+    uint32_t m_lo_mask;
+    std::vector<uint32_t> m_bucket_offsets;     // Where each bucket starts in m_bucket_entries
+    std::vector<uint16_t> m_bucket_entries;     // Indexes into m_opcodes
+};
+
 EmulateInstructionARM::ARMOpcode*
 EmulateInstructionARM::GetARMOpcodeForInstruction (const uint32_t opcode, uint32_t arm_isa)
 {
@@ -12472,14 +12544,11 @@ EmulateInstructionARM::GetARMOpcodeForInstruction (const uint32_t opcode, uint32
                   
     };
     static const size_t k_num_arm_opcodes = sizeof(g_arm_opcodes)/sizeof(ARMOpcode);
-                  
-    for (size_t i=0; i<k_num_arm_opcodes; ++i)
-    {
-        if ((g_arm_opcodes[i].mask & opcode) == g_arm_opcodes[i].value &&
-            (g_arm_opcodes[i].variants & arm_isa) != 0)
-            return &g_arm_opcodes[i];
-    }
-    return NULL;
+
+    // Bucket by bits 27-20 and 7-4, the bits that select the instruction
+    // class and the multiply and extra load/store encodings
+    static OpcodeDecodeTable g_arm_decode_table (g_arm_opcodes, k_num_arm_opcodes, 20, 8, 4, 4);
+    return g_arm_decode_table.FindOpcode (opcode, arm_isa);
 }
 
     
@@ -12798,13 +12867,12 @@ EmulateInstructionARM::GetThumbOpcodeForInstruction (const uint32_t opcode, uint
     };
 
     const size_t k_num_thumb_opcodes = sizeof(g_thumb_opcodes)/sizeof(ARMOpcode);
-    for (size_t i=0; i<k_num_thumb_opcodes; ++i)
-    {
-        if ((g_thumb_opcodes[i].mask & opcode) == g_thumb_opcodes[i].value &&
-            (g_thumb_opcodes[i].variants & arm_isa) != 0)
-            return &g_thumb_opcodes[i];
-    }
-    return NULL;
+
+    // 16 bit instructions are in the low halfword, so bits 15-11 select
+    // their class and bits 28-20 are zero. For 32 bit instructions bits
+    // 28-20 are op1 and op2 of the first halfword.
+    static OpcodeDecodeTable g_thumb_decode_table (g_thumb_opcodes, k_num_thumb_opcodes, 20, 9, 11, 5);
+    return g_thumb_decode_table.FindOpcode (opcode, arm_isa);
 }
 
 bool
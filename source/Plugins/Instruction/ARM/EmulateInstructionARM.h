@@ -383,6 +383,8 @@ protected:
     static ARMOpcode*
     GetThumbOpcodeForInstruction (const uint32_t opcode, uint32_t isa_mask);
 
+    class OpcodeDecodeTable;
+
     // A8.6.123 PUSH
     bool
     EmulatePUSH (const uint32_t opcode, const ARMEncoding encoding);
@@ -94,184 +94,225 @@ ItaniumABILanguageRuntime::GetDynamicTypeAndAddress (ValueObject &in_value,
         if (offset_ptr == 0)
             return false;
         
-        // Now find the symbol that contains this address:
+        if (target == NULL || target->GetSectionLoadList().IsEmpty())
+            return false;
         
-        SymbolContext sc;
-        Address address_point_address;
-        if (target && !target->GetSectionLoadList().IsEmpty())
+        // Every object with the same vtable address point has the same
+        // dynamic type, so only the first one pays for the symbol and type
+        // lookups
+        DynamicTypeCache::const_iterator pos = m_dynamic_type_cache.find (vtable_address_point);
+        if (pos == m_dynamic_type_cache.end())
         {
-            if (target->GetSectionLoadList().ResolveLoadAddress (vtable_address_point, address_point_address))
-            {
-                target->GetImages().ResolveSymbolContextForAddress (address_point_address, eSymbolContextSymbol, sc);
-                Symbol *symbol = sc.symbol;
-                if (symbol != NULL)
-                {
-                    const char *name = symbol->GetMangled().GetDemangledName().AsCString();
-                    if (strstr(name, vtable_demangled_prefix) == name)
-                    {
-                        LogSP log (lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_OBJECT));
-                        if (log)
-                            log->Printf ("0x%16.16llx: static-type = '%s' has vtable symbol '%s'\n",
-                                         original_ptr,
-                                         in_value.GetTypeName().GetCString(),
-                                         name);
-                        // We are a C++ class, that's good.  Get the class name and look it up:
-                        const char *class_name = name + strlen(vtable_demangled_prefix);
-                        class_type_or_name.SetName (class_name);
-                        const bool exact_match = true;
-                        TypeList class_types;
-                        
-                        uint32_t num_matches = 0;
-                        // First look in the module that the vtable symbol came from
-                        // and look for a single exact match.
-                        if (sc.module_sp)
-                        {
-                            num_matches = sc.module_sp->FindTypes (sc,
-                                                                   ConstString(class_name),
-                                                                   exact_match,
-                                                                   1,
-                                                                   class_types);
-                        }
-                        
-                        // If we didn't find a symbol, then move on to the entire
-                        // module list in the target and get as many unique matches
-                        // as possible
-                        if (num_matches == 0)
-                        {
-                            num_matches = target->GetImages().FindTypes (sc,
-                                                                         ConstString(class_name),
-                                                                         exact_match,
-                                                                         UINT32_MAX,
-                                                                         class_types);
-                        }
-                        
-                        lldb::TypeSP type_sp;
-                        if (num_matches == 0)
-                        {
-                            if (log)
-                                log->Printf("0x%16.16llx: is not dynamic\n", original_ptr);
-                            return false;
-                        }
-                        if (num_matches == 1)
-                        {
-                            type_sp = class_types.GetTypeAtIndex(0);
-                            if (log)
-                                log->Printf ("0x%16.16llx: static-type = '%s' has dynamic type: uid={0x%llx}, type-name='%s'\n",
-                                             original_ptr,
-                                             in_value.GetTypeName().AsCString(),
-                                             type_sp->GetID(),
-                                             type_sp->GetName().GetCString());
+            DynamicTypeInfo info;
+            GetDynamicTypeInfoForVTable (in_value, original_ptr, vtable_address_point, *target, *process, info);
+            pos = m_dynamic_type_cache.insert (std::make_pair (vtable_address_point, info)).first;
+        }
+        
+        const DynamicTypeInfo &info = pos->second;
+        if (!info.type_sp)
+            return false;
+        
+        ConstString class_name (info.class_name);
+        class_type_or_name.SetName (class_name);
+        class_type_or_name.SetTypeSP (info.type_sp);
 
-                            class_type_or_name.SetTypeSP(class_types.GetTypeAtIndex(0));
-                        }
-                        else if (num_matches > 1)
-                        {
-                            size_t i;
-                            if (log)
-                            {
-                                for (i = 0; i < num_matches; i++)
-                                {
-                                    type_sp = class_types.GetTypeAtIndex(i);
-                                    if (type_sp)
-                                    {
-                                        if (log)
-                                            log->Printf ("0x%16.16llx: static-type = '%s' has multiple matching dynamic types: uid={0x%llx}, type-name='%s'\n",
-                                                         original_ptr,
-                                                         in_value.GetTypeName().AsCString(),
-                                                         type_sp->GetID(),
-                                                         type_sp->GetName().GetCString());
-                                    }
-                                }
-                            }
+        // We don't consider something to have a dynamic type if
+        // it is the same as the static type.  So compare against
+        // the value we were handed.
+        clang::ASTContext *in_ast_ctx = in_value.GetClangAST ();
+        clang::ASTContext *this_ast_ctx = info.type_sp->GetClangAST ();
+        if (in_ast_ctx == this_ast_ctx)
+        {
+            if (ClangASTContext::AreTypesSame (in_ast_ctx,
+                                               in_value.GetClangType(),
+                                               info.type_sp->GetClangFullType()))
+            {
+                // The dynamic type we found was the same type,
+                // so we don't have a dynamic type here...
+                return false;
+            }
+        }
 
-                            for (i = 0; i < num_matches; i++)
-                            {
-                                type_sp = class_types.GetTypeAtIndex(i);
-                                if (type_sp)
-                                {
-                                    if (ClangASTContext::IsCXXClassType(type_sp->GetClangFullType()))
-                                    {
-                                        if (log)
-                                            log->Printf ("0x%16.16llx: static-type = '%s' has multiple matching dynamic types, picking this one: uid={0x%llx}, type-name='%s'\n",
-                                                         original_ptr,
-                                                         in_value.GetTypeName().AsCString(),
-                                                         type_sp->GetID(),
-                                                         type_sp->GetName().GetCString());
-                                        class_type_or_name.SetTypeSP(type_sp);
-                                        break;
-                                    }
-                                }
-                            }
-                            
-                            if (i == num_matches)
-                            {
-                                if (log)
-                                    log->Printf ("0x%16.16llx: static-type = '%s' has multiple matching dynamic types, didn't find a C++ match\n",
-                                                 original_ptr,
-                                                 in_value.GetTypeName().AsCString());
-                                return false;
-                            }
-                        }
+        // So the dynamic type is a value that starts at offset_to_top
+        // above the original address.
+        lldb::addr_t dynamic_addr = original_ptr + info.offset_to_top;
+        if (!target->GetSectionLoadList().ResolveLoadAddress (dynamic_addr, dynamic_address))
+        {
+            dynamic_address.SetRawAddress(dynamic_addr);
+        }
+        return true;
+    }
+    
+    return false;
+}
 
-                        // There can only be one type with a given name,
-                        // so we've just found duplicate definitions, and this
-                        // one will do as well as any other.
-                        // We don't consider something to have a dynamic type if
-                        // it is the same as the static type.  So compare against
-                        // the value we were handed.
-                        if (type_sp)
-                        {
-                            clang::ASTContext *in_ast_ctx = in_value.GetClangAST ();
-                            clang::ASTContext *this_ast_ctx = type_sp->GetClangAST ();
-                            if (in_ast_ctx == this_ast_ctx)
-                            {
-                                if (ClangASTContext::AreTypesSame (in_ast_ctx,
-                                                                   in_value.GetClangType(),
-                                                                   type_sp->GetClangFullType()))
-                                {
-                                    // The dynamic type we found was the same type,
-                                    // so we don't have a dynamic type here...
-                                    return false;
-                                }
-                            }
+void
+ItaniumABILanguageRuntime::GetDynamicTypeInfoForVTable (ValueObject &in_value,
+                                                        lldb::addr_t original_ptr,
+                                                        lldb::addr_t vtable_address_point,
+                                                        Target &target,
+                                                        Process &process,
+                                                        DynamicTypeInfo &info)
+{
+    info.class_name.Clear();
+    info.type_sp.reset();
+    info.offset_to_top = 0;
+    
+    // Now find the symbol that contains this address:
+    
+    SymbolContext sc;
+    Address address_point_address;
+    if (!target.GetSectionLoadList().ResolveLoadAddress (vtable_address_point, address_point_address))
+        return;
+    
+    target.GetImages().ResolveSymbolContextForAddress (address_point_address, eSymbolContextSymbol, sc);
+    Symbol *symbol = sc.symbol;
+    if (symbol == NULL)
+        return;
+    
+    const char *name = symbol->GetMangled().GetDemangledName().AsCString();
+    if (name == NULL || strstr(name, vtable_demangled_prefix) != name)
+        return;
+    
+    LogSP log (lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_OBJECT));
+    if (log)
+        log->Printf ("0x%16.16llx: static-type = '%s' has vtable symbol '%s'\n",
+                     original_ptr,
+                     in_value.GetTypeName().GetCString(),
+                     name);
+    // We are a C++ class, that's good.  Get the class name and look it up:
+    const char *class_name = name + strlen(vtable_demangled_prefix);
+    const bool exact_match = true;
+    TypeList class_types;
+    
+    uint32_t num_matches = 0;
+    // First look in the module that the vtable symbol came from
+    // and look for a single exact match.
+    if (sc.module_sp)
+    {
+        num_matches = sc.module_sp->FindTypes (sc,
+                                               ConstString(class_name),
+                                               exact_match,
+                                               1,
+                                               class_types);
+    }
+    
+    // If we didn't find a symbol, then move on to the entire
+    // module list in the target and get as many unique matches
+    // as possible
+    if (num_matches == 0)
+    {
+        num_matches = target.GetImages().FindTypes (sc,
+                                                    ConstString(class_name),
+                                                    exact_match,
+                                                    UINT32_MAX,
+                                                    class_types);
+    }
+    
+    lldb::TypeSP type_sp;
+    if (num_matches == 0)
+    {
+        if (log)
+            log->Printf("0x%16.16llx: is not dynamic\n", original_ptr);
+        return;
+    }
+    if (num_matches == 1)
+    {
+        type_sp = class_types.GetTypeAtIndex(0);
+        if (log)
+            log->Printf ("0x%16.16llx: static-type = '%s' has dynamic type: uid={0x%llx}, type-name='%s'\n",
+                         original_ptr,
+                         in_value.GetTypeName().AsCString(),
+                         type_sp->GetID(),
+                         type_sp->GetName().GetCString());
+    }
+    else if (num_matches > 1)
+    {
+        size_t i;
+        if (log)
+        {
+            for (i = 0; i < num_matches; i++)
+            {
+                type_sp = class_types.GetTypeAtIndex(i);
+                if (type_sp)
+                {
+                    if (log)
+                        log->Printf ("0x%16.16llx: static-type = '%s' has multiple matching dynamic types: uid={0x%llx}, type-name='%s'\n",
+                                     original_ptr,
+                                     in_value.GetTypeName().AsCString(),
+                                     type_sp->GetID(),
+                                     type_sp->GetName().GetCString());
+                }
+            }
+        }
 
-                            // The offset_to_top is two pointers above the address.
-                            Address offset_to_top_address = address_point_address;
-                            int64_t slide = -2 * ((int64_t) target->GetArchitecture().GetAddressByteSize());
-                            offset_to_top_address.Slide (slide);
-                            
-                            Error error;
-                            lldb::addr_t offset_to_top_location = offset_to_top_address.GetLoadAddress(target);
-                            
-                            size_t bytes_read = process->ReadMemory (offset_to_top_location, 
-                                                                     memory_buffer, 
-                                                                     address_byte_size, 
-                                                                     error);
-                                                                     
-                            if (!error.Success() || (bytes_read != address_byte_size))
-                            {
-                                return false;
-                            }
-                            
-                            offset_ptr = 0;
-                            int64_t offset_to_top = data.GetMaxS64(&offset_ptr, process->GetAddressByteSize());
-                            
-                            // So the dynamic type is a value that starts at offset_to_top
-                            // above the original address.
-                            lldb::addr_t dynamic_addr = original_ptr + offset_to_top;
-                            if (!target->GetSectionLoadList().ResolveLoadAddress (dynamic_addr, dynamic_address))
-                            {
-                                dynamic_address.SetRawAddress(dynamic_addr);
-                            }
-                            return true;
-                        }
-                    }
+        for (i = 0; i < num_matches; i++)
+        {
+            type_sp = class_types.GetTypeAtIndex(i);
+            if (type_sp)
+            {
+                if (ClangASTContext::IsCXXClassType(type_sp->GetClangFullType()))
+                {
+                    if (log)
+                        log->Printf ("0x%16.16llx: static-type = '%s' has multiple matching dynamic types, picking this one: uid={0x%llx}, type-name='%s'\n",
+                                     original_ptr,
+                                     in_value.GetTypeName().AsCString(),
+                                     type_sp->GetID(),
+                                     type_sp->GetName().GetCString());
+                    break;
                 }
             }
         }
+        
+        if (i == num_matches)
+        {
+            if (log)
+                log->Printf ("0x%16.16llx: static-type = '%s' has multiple matching dynamic types, didn't find a C++ match\n",
+                             original_ptr,
+                             in_value.GetTypeName().AsCString());
+            return;
+        }
     }
+
+    // There can only be one type with a given name,
+    // so we've just found duplicate definitions, and this
+    // one will do as well as any other.
+    if (!type_sp)
+        return;
+
+    // The offset_to_top is two pointers above the address.
+    Address offset_to_top_address = address_point_address;
+    const size_t address_byte_size = process.GetAddressByteSize();
+    int64_t slide = -2 * ((int64_t) target.GetArchitecture().GetAddressByteSize());
+    offset_to_top_address.Slide (slide);
     
-    return false;
+    Error error;
+    lldb::addr_t offset_to_top_location = offset_to_top_address.GetLoadAddress(&target);
+    
+    char memory_buffer[16];
+    DataExtractor data(memory_buffer, sizeof(memory_buffer), 
+                       process.GetByteOrder(), 
+                       address_byte_size);
+    size_t bytes_read = process.ReadMemory (offset_to_top_location, 
+                                            memory_buffer, 
+                                            address_byte_size, 
+                                            error);
+                                                         
+    if (!error.Success() || (bytes_read != address_byte_size))
+        return;
+    
+    uint32_t offset_ptr = 0;
+    info.offset_to_top = data.GetMaxS64(&offset_ptr, address_byte_size);
+    info.class_name.SetCString (class_name);
+    info.type_sp = type_sp;
+}
+
+void
+ItaniumABILanguageRuntime::ModulesDidUnload (ModuleList &module_list)
+{
+    // The types we found may have come from these modules, and new ones
+    // may get loaded where their vtables used to be
+    m_dynamic_type_cache.clear();
 }
 
 bool
@@ -12,10 +12,13 @@
 
 // C Includes
 // C++ Includes
+#include <map>
+
 // Other libraries and framework includes
 // Project includes
 #include "lldb/lldb-private.h"
 #include "lldb/Breakpoint/BreakpointResolver.h"
+#include "lldb/Core/ConstString.h"
 #include "lldb/Target/LanguageRuntime.h"
 #include "lldb/Target/CPPLanguageRuntime.h"
 #include "lldb/Core/Value.h"
@@ -73,6 +76,9 @@ namespace lldb_private {
         virtual bool
         ExceptionBreakpointsExplainStop (lldb::StopInfoSP stop_reason);
         
+        virtual void
+        ModulesDidUnload (ModuleList &module_list);
+        
     protected:
         virtual lldb::BreakpointResolverSP
         CreateExceptionResolver (Breakpoint *bkpt, bool catch_bp, bool throw_bp);
@@ -81,9 +87,32 @@ namespace lldb_private {
         CreateExceptionResolver (Breakpoint *bkpt, bool catch_bp, bool throw_bp, bool for_expressions);
 
     private:
+        //------------------------------------------------------------------
+        // What we found out about the dynamic type of objects whose vtable
+        // pointer points at a given address point. A NULL type_sp means
+        // those objects have no dynamic type we can find.
+        //------------------------------------------------------------------
+        struct DynamicTypeInfo
+        {
+            ConstString class_name;
+            lldb::TypeSP type_sp;
+            int64_t offset_to_top;
+        };
+        
+        typedef std::map<lldb::addr_t, DynamicTypeInfo> DynamicTypeCache;
+        
         ItaniumABILanguageRuntime(Process *process) : lldb_private::CPPLanguageRuntime(process) { } // Call CreateInstance instead.
         
+        void
+        GetDynamicTypeInfoForVTable (ValueObject &in_value,
+                                     lldb::addr_t original_ptr,
+                                     lldb::addr_t vtable_address_point,
+                                     Target &target,
+                                     Process &process,
+                                     DynamicTypeInfo &info);
+        
         lldb::BreakpointSP                              m_cxx_exception_bp_sp;
+        DynamicTypeCache                                m_dynamic_type_cache;   // vtable address point -> dynamic type
     };
     
 } // namespace lldb_private
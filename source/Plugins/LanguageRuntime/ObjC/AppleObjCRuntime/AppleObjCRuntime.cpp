@@ -88,21 +88,20 @@ AppleObjCRuntime::GetObjectDescription (Stream &strm, Value &value, ExecutionCon
             return false;
         }
     }
-    else 
-    {
-        // If it is not a pointer, see if we can make it into a pointer.
-        ClangASTContext *ast_context = target->GetScratchClangASTContext();
-        void *opaque_type_ptr = ast_context->GetBuiltInType_objc_id();
-        if (opaque_type_ptr == NULL)
-            opaque_type_ptr = ast_context->GetVoidPtrType(false);
-        value.SetContext(Value::eContextTypeClangType, opaque_type_ptr);    
-    }
+
+    // Pass every object as an "id" (or a plain pointer if we can't get
+    // that type) so the call always has the same signature and the
+    // wrapper function can be reused.
+    ClangASTContext *ast_context = target->GetScratchClangASTContext();
+    void *opaque_type_ptr = ast_context->GetBuiltInType_objc_id();
+    if (opaque_type_ptr == NULL)
+        opaque_type_ptr = ast_context->GetVoidPtrType(false);
+    value.SetContext(Value::eContextTypeClangType, opaque_type_ptr);    
 
     ValueList arg_value_list;
     arg_value_list.PushValue(value);
     
     // This is the return value:
-    ClangASTContext *ast_context = target->GetScratchClangASTContext();
     
     void *return_qualtype = ast_context->GetCStringType(true);
     Value ret;
@@ -122,30 +121,46 @@ AppleObjCRuntime::GetObjectDescription (Stream &strm, Value &value, ExecutionCon
         }
     }
     
-    // Now we're ready to call the function:
-    ClangFunction func (*exe_ctx.GetBestExecutionContextScope(),
-                        ast_context, 
-                        return_qualtype, 
-                        *function_address, 
-                        arg_value_list);
+    // Only one thread at a time can use the argument struct
+    Mutex::Locker locker (m_print_object_args_mutex);
 
     StreamString error_stream;
-    
-    lldb::addr_t wrapper_struct_addr = LLDB_INVALID_ADDRESS;
-    func.InsertFunction(exe_ctx, wrapper_struct_addr, error_stream);
+
+    if (!m_print_object_function.get())
+    {
+        m_print_object_function.reset (new ClangFunction (*m_process,
+                                                          ast_context, 
+                                                          return_qualtype, 
+                                                          *function_address, 
+                                                          arg_value_list));
+        if (m_print_object_function->CompileFunction (error_stream) != 0 ||
+            !m_print_object_function->WriteFunctionWrapper (exe_ctx, error_stream))
+        {
+            m_print_object_function.reset();
+            strm.Printf ("Error preparing Print Object function: %s\n", error_stream.GetData());
+            return false;
+        }
+    }
+
+    // Now we're ready to call the function:
+    if (!m_print_object_function->WriteFunctionArguments (exe_ctx, m_print_object_args, *function_address, arg_value_list, error_stream))
+    {
+        strm.Printf ("Error writing Print Object function arguments: %s\n", error_stream.GetData());
+        return false;
+    }
 
     bool unwind_on_error = true;
     bool try_all_threads = true;
     bool stop_others = true;
     
-    ExecutionResults results = func.ExecuteFunction (exe_ctx, 
-                                                     &wrapper_struct_addr, 
-                                                     error_stream, 
-                                                     stop_others, 
-                                                     0 /* no timeout */,
-                                                     try_all_threads, 
-                                                     unwind_on_error, 
-                                                     ret);
+    ExecutionResults results = m_print_object_function->ExecuteFunction (exe_ctx, 
+                                                                         &m_print_object_args, 
+                                                                         error_stream, 
+                                                                         stop_others, 
+                                                                         0 /* no timeout */,
+                                                                         try_all_threads, 
+                                                                         unwind_on_error, 
+                                                                         ret);
     if (results != eExecutionCompleted)
     {
         strm.Printf("Error evaluating Print Object function: %d.\n", results);
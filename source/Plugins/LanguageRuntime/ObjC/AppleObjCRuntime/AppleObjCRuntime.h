@@ -18,6 +18,8 @@
 #include "lldb/Target/LanguageRuntime.h"
 #include "lldb/Target/ObjCLanguageRuntime.h"
 #include "lldb/Core/ValueObject.h"
+#include "lldb/Expression/ClangFunction.h"
+#include "lldb/Host/Mutex.h"
 #include "AppleObjCTrampolineHandler.h"
 #include "AppleThreadPlanStepThroughObjCTrampoline.h"
 
@@ -111,11 +113,20 @@ protected:
     bool m_read_objc_library;
     std::auto_ptr<lldb_private::AppleObjCTrampolineHandler> m_objc_trampoline_handler_ap;
     lldb::BreakpointSP m_objc_exception_bp_sp;
+    // The print object function is always called the same way, so its
+    // wrapper is only compiled and written once and the argument struct
+    // is reused
+    std::auto_ptr<ClangFunction> m_print_object_function;
+    lldb::addr_t m_print_object_args;
+    Mutex m_print_object_args_mutex;
 
     AppleObjCRuntime(Process *process) : 
         lldb_private::ObjCLanguageRuntime(process),
         m_read_objc_library (false),
-        m_objc_trampoline_handler_ap(NULL)
+        m_objc_trampoline_handler_ap(NULL),
+        m_print_object_function(),
+        m_print_object_args(LLDB_INVALID_ADDRESS),
+        m_print_object_args_mutex(Mutex::eMutexTypeNormal)
      { } // Call CreateInstance instead.
 };
     
@@ -20,6 +20,8 @@
 #include "lldb/Breakpoint/BreakpointLocation.h"
 #include "lldb/Core/ClangForward.h"
 #include "lldb/Core/ConstString.h"
+#include "lldb/Core/DataBufferHeap.h"
+#include "lldb/Core/DataExtractor.h"
 #include "lldb/Core/Error.h"
 #include "lldb/Core/Log.h"
 #include "lldb/Core/Module.h"
@@ -104,7 +106,13 @@ AppleObjCRuntimeV2::AppleObjCRuntimeV2 (Process *process,
                                         const ModuleSP &objc_module_sp) : 
     AppleObjCRuntime (process),
     m_get_class_name_args(LLDB_INVALID_ADDRESS),
-    m_get_class_name_args_mutex(Mutex::eMutexTypeNormal)
+    m_get_class_name_args_mutex(Mutex::eMutexTypeNormal),
+    m_realized_classes_addr(LLDB_INVALID_ADDRESS),
+    m_realized_classes_stop_id(UINT32_MAX),
+    m_realized_classes_buckets(LLDB_INVALID_ADDRESS),
+    m_realized_classes_count(0),
+    m_method_cache_stop_ids(),
+    m_msg_forward_addr(LLDB_INVALID_ADDRESS)
 {
     static const ConstString g_gdb_object_getClass("gdb_object_getClass");
     m_has_object_getClass = (objc_module_sp->FindFirstSymbolWithNameAndType(g_gdb_object_getClass, eSymbolTypeCode) != NULL);
@@ -588,6 +596,8 @@ AppleObjCRuntimeV2::IsTaggedPointer(addr_t ptr)
 ObjCLanguageRuntime::ClassDescriptorSP
 AppleObjCRuntimeV2::GetClassDescriptor (ObjCISA isa)
 {
+    UpdateISAToDescriptorMap();
+    
     ObjCLanguageRuntime::ISAToDescriptorIterator found = m_isa_to_descriptor_cache.find(isa);
     ObjCLanguageRuntime::ISAToDescriptorIterator end = m_isa_to_descriptor_cache.end();
     
@@ -609,6 +619,8 @@ AppleObjCRuntimeV2::GetClassDescriptor (ValueObject& in_value)
     
     ObjCISA isa = GetISA(in_value);
     
+    UpdateISAToDescriptorMap();
+    
     ObjCLanguageRuntime::ISAToDescriptorIterator found = m_isa_to_descriptor_cache.find(isa);
     ObjCLanguageRuntime::ISAToDescriptorIterator end = m_isa_to_descriptor_cache.end();
     
@@ -679,6 +691,8 @@ AppleObjCRuntimeV2::GetActualTypeName(ObjCLanguageRuntime::ObjCISA isa)
         return g_objc_tagged_isa_name;
     }
     
+    UpdateISAToDescriptorMap();
+    
     ISAToDescriptorIterator found = m_isa_to_descriptor_cache.find(isa);
     ISAToDescriptorIterator end = m_isa_to_descriptor_cache.end();
     
@@ -700,6 +714,235 @@ AppleObjCRuntimeV2::GetActualTypeName(ObjCLanguageRuntime::ObjCISA isa)
     return descriptor->GetClassName();
 }
 
+// gdb_objc_realized_classes points to the NXMapTable the runtime keeps of
+// every realized class, keyed by class name:
+//
+// struct NXMapTable {
+//     const void *prototype;
+//     unsigned count;
+//     unsigned nbBucketsMinusOne;
+//     void *buckets;      // an array of { const char *name; Class cls; }
+// };
+lldb::addr_t
+AppleObjCRuntimeV2::GetRealizedClassesTableAddress ()
+{
+    if (m_realized_classes_addr == LLDB_INVALID_ADDRESS)
+    {
+        static const ConstString g_gdb_objc_realized_classes("gdb_objc_realized_classes");
+        
+        SymbolContextList sc_list;
+        Target &target = m_process->GetTarget();
+        target.GetImages().FindSymbolsWithNameAndType(g_gdb_objc_realized_classes, eSymbolTypeData, sc_list);
+        
+        SymbolContext sc;
+        if (sc_list.GetSize() == 1 && sc_list.GetContextAtIndex(0, sc) && sc.symbol)
+            m_realized_classes_addr = sc.symbol->GetAddress().GetLoadAddress(&target);
+    }
+    return m_realized_classes_addr;
+}
+
+void
+AppleObjCRuntimeV2::UpdateISAToDescriptorMap ()
+{
+    // The class table only changes while the process runs, so read it at
+    // most once per stop
+    const uint32_t stop_id = m_process->GetStopID();
+    if (m_realized_classes_stop_id == stop_id)
+        return;
+    m_realized_classes_stop_id = stop_id;
+    
+    const addr_t table_ptr_addr = GetRealizedClassesTableAddress();
+    if (table_ptr_addr == LLDB_INVALID_ADDRESS)
+        return;
+    
+    ProcessSP process_sp (m_process->CalculateProcess());
+    const uint32_t ptr_size = m_process->GetAddressByteSize();
+    const ByteOrder byte_order = m_process->GetByteOrder();
+    Error error;
+    
+    const addr_t table_addr = m_process->ReadPointerFromMemory(table_ptr_addr, error);
+    if (error.Fail() || table_addr == 0 || table_addr == LLDB_INVALID_ADDRESS)
+        return;
+    
+    uint8_t header_bytes[32];
+    const size_t header_size = 2 * ptr_size + 2 * sizeof(uint32_t);
+    if (m_process->ReadMemory(table_addr, header_bytes, header_size, error) != header_size)
+        return;
+    
+    DataExtractor header (header_bytes, header_size, byte_order, ptr_size);
+    uint32_t offset = ptr_size; // skip the prototype
+    const uint32_t count = header.GetU32(&offset);
+    const uint32_t num_buckets = header.GetU32(&offset) + 1;
+    const addr_t buckets_addr = header.GetPointer(&offset);
+    
+    // Classes are only ever added to the table, so if it has the same
+    // buckets and number of classes we already have all of them
+    if (buckets_addr == m_realized_classes_buckets && count == m_realized_classes_count)
+        return;
+    
+    // Sanity check the table before we go reading the buckets, it is
+    // not worth reading megabytes for a table that doesn't look right
+    if (buckets_addr == 0 || count > num_buckets || num_buckets > (1u << 20))
+        return;
+    
+    LogSP log(GetLogIfAllCategoriesSet (LIBLLDB_LOG_TYPES));
+    
+    // Read all the buckets with a single read
+    const size_t buckets_size = num_buckets * 2 * ptr_size;
+    DataBufferHeap buckets_buffer (buckets_size, 0);
+    if (m_process->ReadMemory(buckets_addr, buckets_buffer.GetBytes(), buckets_size, error) != buckets_size)
+        return;
+    
+    // Empty buckets have a key of NX_MAPNOTAKEY, which is (void *)-1
+    const addr_t empty_key = (ptr_size == 8 ? UINT64_MAX : UINT32_MAX);
+    DataExtractor buckets (buckets_buffer.GetBytes(), buckets_size, byte_order, ptr_size);
+    offset = 0;
+    uint32_t num_added = 0;
+    char name_buffer[1024];
+    for (uint32_t i = 0; i < num_buckets; ++i)
+    {
+        const addr_t name_addr = buckets.GetPointer(&offset);
+        const ObjCISA isa = buckets.GetPointer(&offset);
+        
+        if (name_addr == empty_key || name_addr == 0 || isa == 0)
+            continue;
+        
+        if (m_isa_to_descriptor_cache.find(isa) != m_isa_to_descriptor_cache.end())
+            continue;
+        
+        if (m_process->ReadCStringFromMemory(name_addr, name_buffer, sizeof(name_buffer), error) == 0)
+            continue;
+        ConstString name (name_buffer);
+        
+        ClassDescriptorSP descriptor_sp (new ClassDescriptorV2(isa, name, process_sp));
+        if (descriptor_sp->IsValid() && AddClass(isa, descriptor_sp))
+            ++num_added;
+    }
+    
+    m_realized_classes_buckets = buckets_addr;
+    m_realized_classes_count = count;
+    
+    if (log)
+        log->Printf("AppleObjCRuntimeV2::UpdateISAToDescriptorMap() added %u of %u classes from gdb_objc_realized_classes at 0x%llx",
+                    num_added,
+                    count,
+                    (uint64_t)table_addr);
+}
+
+lldb::addr_t
+AppleObjCRuntimeV2::GetMsgForwardAddress ()
+{
+    if (m_msg_forward_addr == LLDB_INVALID_ADDRESS)
+    {
+        static const ConstString g_objc_msgForward_internal("_objc_msgForward_internal");
+        
+        SymbolContextList sc_list;
+        Target &target = m_process->GetTarget();
+        target.GetImages().FindSymbolsWithNameAndType(g_objc_msgForward_internal, eSymbolTypeCode, sc_list);
+        
+        SymbolContext sc;
+        if (sc_list.GetSize() == 1 && sc_list.GetContextAtIndex(0, sc) && sc.symbol)
+            m_msg_forward_addr = sc.symbol->GetAddress().GetLoadAddress(&target);
+        else
+            m_msg_forward_addr = 0;
+    }
+    return m_msg_forward_addr;
+}
+
+// The cache pointer of a class_t points to:
+//
+// struct objc_cache {
+//     uintptr_t mask;             // total = mask + 1
+//     uintptr_t occupied;
+//     cache_entry *buckets[1];
+// };
+//
+// where each non-NULL bucket points to a { SEL name; void *types; IMP imp; }
+bool
+AppleObjCRuntimeV2::ReadClassMethodCache (lldb::addr_t class_addr)
+{
+    if (class_addr == 0 || class_addr == LLDB_INVALID_ADDRESS)
+        return false;
+    
+    // The runtime fills its caches as the program runs, so there is no
+    // point in reading the same one more than once per stop
+    const uint32_t stop_id = m_process->GetStopID();
+    ClassToStopIDMap::iterator pos = m_method_cache_stop_ids.find(class_addr);
+    if (pos != m_method_cache_stop_ids.end() && pos->second == stop_id)
+        return false;
+    m_method_cache_stop_ids[class_addr] = stop_id;
+    
+    const uint32_t ptr_size = m_process->GetAddressByteSize();
+    const ByteOrder byte_order = m_process->GetByteOrder();
+    Error error;
+    
+    const addr_t cache_addr = m_process->ReadPointerFromMemory(class_addr + 2 * ptr_size, error);
+    if (error.Fail() || cache_addr == 0)
+        return false;
+    
+    uint8_t header_bytes[16];
+    const size_t header_size = 2 * ptr_size;
+    if (m_process->ReadMemory(cache_addr, header_bytes, header_size, error) != header_size)
+        return false;
+    
+    DataExtractor header (header_bytes, header_size, byte_order, ptr_size);
+    uint32_t offset = 0;
+    const uint64_t mask = header.GetPointer(&offset);
+    const uint64_t occupied = header.GetPointer(&offset);
+    
+    // The empty cache shared by all classes that haven't been messaged
+    // has no buckets in use, and anything this large is not a cache
+    const uint64_t num_buckets = mask + 1;
+    if (occupied == 0 || occupied > num_buckets || num_buckets > (1u << 16))
+        return false;
+    
+    // Read all the bucket pointers with a single read
+    const size_t buckets_size = num_buckets * ptr_size;
+    DataBufferHeap buckets_buffer (buckets_size, 0);
+    if (m_process->ReadMemory(cache_addr + header_size, buckets_buffer.GetBytes(), buckets_size, error) != buckets_size)
+        return false;
+    
+    const addr_t msg_forward_addr = GetMsgForwardAddress();
+    DataExtractor buckets (buckets_buffer.GetBytes(), buckets_size, byte_order, ptr_size);
+    offset = 0;
+    uint8_t entry_bytes[24];
+    const size_t entry_size = 3 * ptr_size;
+    uint32_t num_added = 0;
+    for (uint64_t i = 0; i < num_buckets; ++i)
+    {
+        const addr_t entry_addr = buckets.GetPointer(&offset);
+        if (entry_addr == 0)
+            continue;
+        
+        if (m_process->ReadMemory(entry_addr, entry_bytes, entry_size, error) != entry_size)
+            continue;
+        
+        DataExtractor entry (entry_bytes, entry_size, byte_order, ptr_size);
+        uint32_t entry_offset = 0;
+        const addr_t sel_addr = entry.GetPointer(&entry_offset);
+        entry.GetPointer(&entry_offset); // skip the types
+        const addr_t impl_addr = entry.GetPointer(&entry_offset);
+        
+        // Selectors the class doesn't respond to are cached with the
+        // forwarding implementation, stepping there is not what we want
+        if (sel_addr == 0 || impl_addr == 0 || impl_addr == msg_forward_addr)
+            continue;
+        
+        if (LookupInMethodCache (class_addr, sel_addr) == LLDB_INVALID_ADDRESS)
+        {
+            AddToMethodCache (class_addr, sel_addr, impl_addr);
+            ++num_added;
+        }
+    }
+    
+    LogSP log(GetLogIfAllCategoriesSet (LIBLLDB_LOG_STEP));
+    if (log)
+        log->Printf("AppleObjCRuntimeV2::ReadClassMethodCache() added %u methods from the cache of class 0x%llx",
+                    num_added,
+                    (uint64_t)class_addr);
+    return true;
+}
+
 SymbolVendor *
 AppleObjCRuntimeV2::GetSymbolVendor()
 {
@@ -723,6 +966,11 @@ AppleObjCRuntimeV2::ClassDescriptorV2::ClassDescriptorV2 (ObjCISA isa, lldb::Pro
     Initialize (isa, process_sp);
 }
 
+AppleObjCRuntimeV2::ClassDescriptorV2::ClassDescriptorV2 (ObjCISA isa, const ConstString &name, lldb::ProcessSP process_sp)
+{
+    InitializeFromClass (isa, name, process_sp);
+}
+
 void
 AppleObjCRuntimeV2::ClassDescriptorV2::Initialize (ObjCISA isa, lldb::ProcessSP process_sp)
 {
@@ -844,6 +1092,53 @@ AppleObjCRuntimeV2::ClassDescriptorV2::Initialize (ObjCISA isa, lldb::ProcessSP
     m_process_wp = lldb::ProcessWP(process_sp);
 }
 
+// Unlike Initialize(), "isa" here is the address of the class_t itself,
+// and the name came along with it, so we only need a few reads of the
+// class and its class_ro_t
+void
+AppleObjCRuntimeV2::ClassDescriptorV2::InitializeFromClass (ObjCISA isa, const ConstString &name, lldb::ProcessSP process_sp)
+{
+    m_valid = false;
+    if (!isa || !process_sp)
+        return;
+    
+    Error error;
+    const uint32_t ptr_size = process_sp->GetAddressByteSize();
+    const ByteOrder byte_order = process_sp->GetByteOrder();
+    
+    // struct class_t { isa, superclass, cache, vtable, data }
+    uint8_t class_bytes[5 * 8];
+    const size_t class_size = 5 * ptr_size;
+    if (process_sp->ReadMemory(isa, class_bytes, class_size, error) != class_size)
+        return;
+    
+    DataExtractor class_data (class_bytes, class_size, byte_order, ptr_size);
+    uint32_t offset = ptr_size; // skip the metaclass
+    m_parent_isa = class_data.GetPointer(&offset);
+    const addr_t cache_ptr = class_data.GetPointer(&offset);
+    const addr_t vtable_ptr = class_data.GetPointer(&offset);
+    const addr_t data_ptr = class_data.GetPointer(&offset);
+    
+    if (!IsPointerValid(cache_ptr,ptr_size,true,false,true) ||
+        !IsPointerValid(vtable_ptr,ptr_size,true,false,true) ||
+        !IsPointerValid(data_ptr,ptr_size,false,false,true))
+        return;
+    
+    // data points to a class_rw_t, whose ro pointer is at offset 8
+    const addr_t rot_pointer = process_sp->ReadPointerFromMemory(data_ptr + 8, error);
+    if (error.Fail() || !IsPointerValid(rot_pointer,ptr_size))
+        return;
+    
+    m_instance_size = process_sp->ReadUnsignedIntegerFromMemory(rot_pointer + 8, ptr_size, 0, error);
+    if (error.Fail())
+        return;
+    
+    m_isa = isa;
+    m_name = name;
+    m_process_wp = lldb::ProcessWP(process_sp);
+    m_valid = true;
+}
+
 AppleObjCRuntime::ClassDescriptorSP
 AppleObjCRuntimeV2::ClassDescriptorV2::GetSuperclass ()
 {
@@ -34,6 +34,10 @@ public:
         ClassDescriptorV2 (ValueObject &isa_pointer);
         ClassDescriptorV2 (ObjCISA isa, lldb::ProcessSP process);
         
+        // Describe a class whose class_t lives at "isa" and whose name
+        // is already known, as when scraping the runtime's class table
+        ClassDescriptorV2 (ObjCISA isa, const ConstString &name, lldb::ProcessSP process);
+        
         virtual ConstString
         GetClassName ()
         {
@@ -84,6 +88,9 @@ public:
         void
         Initialize (ObjCISA isa, lldb::ProcessSP process_sp);
         
+        void
+        InitializeFromClass (ObjCISA isa, const ConstString &name, lldb::ProcessSP process_sp);
+        
     private:
         ConstString m_name;
         ObjCISA m_isa;
@@ -258,10 +265,16 @@ public:
     virtual SymbolVendor *
     GetSymbolVendor();
     
+    virtual bool
+    ReadClassMethodCache (lldb::addr_t class_addr);
+    
 protected:
     virtual lldb::BreakpointResolverSP
     CreateExceptionResolver (Breakpoint *bkpt, bool catch_bp, bool throw_bp);
 
+    virtual void
+    UpdateISAToDescriptorMap ();
+
 private:
     
     AppleObjCRuntimeV2 (Process *process,
@@ -272,6 +285,12 @@ private:
     
     bool RunFunctionToFindClassName (lldb::addr_t class_addr, Thread *thread, char *name_dst, size_t max_name_len);
     
+    lldb::addr_t
+    GetRealizedClassesTableAddress ();
+    
+    lldb::addr_t
+    GetMsgForwardAddress ();
+    
     bool                                m_has_object_getClass;
     std::auto_ptr<ClangFunction>        m_get_class_name_function;
     std::auto_ptr<ClangUtilityFunction> m_get_class_name_code;
@@ -280,6 +299,15 @@ private:
     
     std::auto_ptr<SymbolVendor>         m_symbol_vendor_ap;
     
+    lldb::addr_t                        m_realized_classes_addr;        // Address of gdb_objc_realized_classes
+    uint32_t                            m_realized_classes_stop_id;     // Stop ID we last read the class table at
+    lldb::addr_t                        m_realized_classes_buckets;     // Buckets of the class table we last scraped
+    uint32_t                            m_realized_classes_count;       // Number of classes in the table we last scraped
+    
+    typedef std::map<lldb::addr_t, uint32_t> ClassToStopIDMap;
+    ClassToStopIDMap                    m_method_cache_stop_ids;        // Stop ID we last read each class' method cache at
+    lldb::addr_t                        m_msg_forward_addr;             // Forwarding implementation the runtime caches for unknown selectors
+    
     static const char *g_find_class_name_function_name;
     static const char *g_find_class_name_function_body;
 };
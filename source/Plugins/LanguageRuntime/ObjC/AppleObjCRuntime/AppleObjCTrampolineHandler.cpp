@@ -889,6 +889,12 @@ AppleObjCTrampolineHandler::GetStepThroughDispatchPlan (Thread &thread, bool sto
             assert(objc_runtime != NULL);
             
             impl_addr = objc_runtime->LookupInMethodCache (isa_addr, sel_addr);
+            
+            // If we haven't seen this pair ourselves, the runtime may well
+            // have, and reading its cache is much cheaper than calling the
+            // lookup function below
+            if (impl_addr == LLDB_INVALID_ADDRESS && objc_runtime->ReadClassMethodCache (isa_addr))
+                impl_addr = objc_runtime->LookupInMethodCache (isa_addr, sel_addr);
         }                                      
                                                                                                                           
         if (impl_addr != LLDB_INVALID_ADDRESS)
@@ -108,7 +108,9 @@ ObjectContainerBSDArchive::Archive::Archive
 ) :
     m_arch (arch),
     m_time (time),
-    m_objects()
+    m_objects(),
+    m_object_name_to_index_map(),
+    m_data()
 {
 }
 
@@ -124,6 +126,10 @@ ObjectContainerBSDArchive::Archive::ParseObjects (DataExtractor &data)
     str.assign((const char *)data.GetData(&offset, SARMAG), SARMAG);
     if (str == ARMAG)
     {
+        // Keep the memory map of the archive so that object files that
+        // are made from it later share it instead of mapping it again
+        m_data = data;
+
         Object obj;
         do
         {
@@ -132,14 +138,12 @@ ObjectContainerBSDArchive::Archive::ParseObjects (DataExtractor &data)
                 break;
             uint32_t obj_idx = m_objects.size();
             m_objects.push_back(obj);
-            // Insert all of the C strings out of order for now...
-            m_object_name_to_index_map.Append (obj.ar_name.GetCString(), obj_idx);
+            // The first object with a given name wins, like it would with
+            // a search from the start of the archive
+            m_object_name_to_index_map.insert (std::make_pair (obj.ar_name.GetCString(), obj_idx));
             offset += obj.ar_file_size;
             obj.Clear();
         } while (data.ValidOffset(offset));
-
-        // Now sort all of the object name pointers
-        m_object_name_to_index_map.Sort ();
     }
     return m_objects.size();
 }
@@ -147,9 +151,9 @@ ObjectContainerBSDArchive::Archive::ParseObjects (DataExtractor &data)
 ObjectContainerBSDArchive::Object *
 ObjectContainerBSDArchive::Archive::FindObject (const ConstString &object_name)
 {
-    const UniqueCStringMap<uint32_t>::Entry *match = m_object_name_to_index_map.FindFirstValueForName (object_name.GetCString());
-    if (match)
-        return &m_objects[match->value];
+    llvm::DenseMap<const char *, uint32_t>::const_iterator pos = m_object_name_to_index_map.find (object_name.GetCString());
+    if (pos != m_object_name_to_index_map.end())
+        return &m_objects[pos->second];
     return NULL;
 }
 
@@ -393,11 +397,18 @@ ObjectContainerBSDArchive::GetObjectFile (const FileSpec *file)
         {
             Object *object = m_archive_sp->FindObject (module_sp->GetObjectName());
             if (object)
+            {
+                // Use the memory map of the cached archive, all of the
+                // object files from this archive then share one map of it
+                DataBufferSP archive_data_sp (m_archive_sp->GetData().GetSharedDataBuffer());
+                if (!archive_data_sp)
+                    archive_data_sp = m_data.GetSharedDataBuffer();
                 return ObjectFile::FindPlugin (module_sp, 
                                                file, 
                                                object->ar_file_offset, 
                                                object->ar_file_size, 
-                                               m_data.GetSharedDataBuffer());
+                                               archive_data_sp);
+            }
         }
     }
     return ObjectFileSP();
@@ -12,10 +12,12 @@
 
 #include "lldb/Symbol/ObjectContainer.h"
 
+#include "llvm/ADT/DenseMap.h"
+
 #include "lldb/Core/ArchSpec.h"
 #include "lldb/Core/ConstString.h"
+#include "lldb/Core/DataExtractor.h"
 #include "lldb/Host/FileSpec.h"
-#include "lldb/Core/UniqueCStringMap.h"
 #include "lldb/Host/TimeValue.h"
 
 class ObjectContainerBSDArchive :
@@ -155,6 +157,16 @@ protected:
         Object *
         FindObject (const lldb_private::ConstString &object_name);
 
+        //------------------------------------------------------------------
+        /// The contents of the archive file. Every object file that comes
+        /// out of this archive shares this one memory map of it.
+        //------------------------------------------------------------------
+        lldb_private::DataExtractor &
+        GetData ()
+        {
+            return m_data;
+        }
+
         const lldb_private::TimeValue &
         GetModificationTime()
         {
@@ -178,7 +190,8 @@ protected:
         lldb_private::ArchSpec m_arch;
         lldb_private::TimeValue m_time;
         Object::collection  m_objects;
-        lldb_private::UniqueCStringMap<uint32_t> m_object_name_to_index_map;
+        llvm::DenseMap<const char *, uint32_t> m_object_name_to_index_map;  // Keyed by ConstString pointers
+        lldb_private::DataExtractor m_data;
     };
 
     void
@@ -28,6 +28,7 @@
 namespace lldb_private
 {
 class DataExtractor;
+template <bool swap> class DataBlockCursor;
 } // End namespace lldb_private.
 
 namespace elf 
@@ -260,6 +261,37 @@ struct ELFSymbol
     ///    True if the ELFSymbol was successfully read and false otherwise.
     bool
     Parse(const lldb_private::DataExtractor &data, uint32_t *offset);
+
+    /// Parse an ELFSymbol entry from a record whose bounds were already
+    /// checked, see lldb_private::DataExtractor::ExtractRecords().
+    ///
+    /// @param[in] cursor
+    ///    A cursor at the start of the record.
+    ///
+    /// @param[in] parsing_32
+    ///    True if a 32 bit object should be read.
+    template <bool swap>
+    void
+    Parse(lldb_private::DataBlockCursor<swap> &cursor, bool parsing_32)
+    {
+        st_name = cursor.GetU32();
+        if (parsing_32)
+        {
+            st_value = cursor.GetU32();
+            st_size = cursor.GetU32();
+            st_info = cursor.GetU8();
+            st_other = cursor.GetU8();
+            st_shndx = cursor.GetU16();
+        }
+        else
+        {
+            st_info = cursor.GetU8();
+            st_other = cursor.GetU8();
+            st_shndx = cursor.GetU16();
+            st_value = cursor.GetU64();
+            st_size = cursor.GetU64();
+        }
+    }
 };
 
 //------------------------------------------------------------------------------
@@ -10,6 +10,7 @@
 #include "ObjectFileELF.h"
 
 #include <cassert>
+#include <cstring>
 #include <algorithm>
 
 #include "lldb/Core/ArchSpec.h"
@@ -243,7 +244,8 @@ ObjectFileELF::ObjectFileELF (const lldb::ModuleSP &module_sp,
     m_sections_ap(),
     m_symtab_ap(),
     m_filespec_ap(),
-    m_shstr_data()
+    m_shstr_data(),
+    m_uuid()
 {
     if (file)
         m_file = *file;
@@ -298,7 +300,69 @@ ObjectFileELF::ParseHeader()
 bool
 ObjectFileELF::GetUUID(lldb_private::UUID* uuid)
 {
-    // FIXME: Return MD5 sum here.  See comment in ObjectFile.h.
+    // The GNU build ID note is the closest thing ELF has to a UUID, it is
+    // a hash of the file contents that the linker stores in a PT_NOTE.
+    if (!m_uuid.IsValid())
+    {
+        const size_t num_program_headers = ParseProgramHeaders();
+        for (size_t i = 0; i < num_program_headers; ++i)
+        {
+            const ELFProgramHeader &header = m_program_headers[i];
+            if (header.p_type != PT_NOTE || header.p_filesz == 0)
+                continue;
+
+            DataExtractor note_data;
+            if (GetData(header.p_offset, header.p_filesz, note_data) != header.p_filesz)
+                continue;
+
+            if (ParseBuildID(note_data, m_uuid))
+                break;
+        }
+    }
+
+    if (m_uuid.IsValid())
+    {
+        *uuid = m_uuid;
+        return true;
+    }
+    return false;
+}
+
+bool
+ObjectFileELF::ParseBuildID(const DataExtractor &note_data, UUID &uuid)
+{
+    // Each note is a 12 byte header followed by the name and the
+    // description, both padded to 4 byte boundaries.
+    static const uint32_t g_nt_gnu_build_id = 3;
+    uint32_t offset = 0;
+    while (note_data.ValidOffsetForDataOfSize(offset, 12))
+    {
+        const uint32_t name_size = note_data.GetU32(&offset);
+        const uint32_t desc_size = note_data.GetU32(&offset);
+        const uint32_t note_type = note_data.GetU32(&offset);
+        const uint32_t name_offset = offset;
+        const uint32_t desc_offset = name_offset + ((name_size + 3) & ~3u);
+        if (!note_data.ValidOffsetForDataOfSize(desc_offset, desc_size))
+            return false;
+
+        if (note_type == g_nt_gnu_build_id && name_size == 4 && desc_size > 0)
+        {
+            const char *name = (const char *)note_data.PeekData(name_offset, name_size);
+            if (name && ::strncmp(name, "GNU", name_size) == 0)
+            {
+                // Short build IDs are padded with zeros, long ones are
+                // truncated, to fit the fixed size UUID
+                uint8_t uuid_bytes[16];
+                ::memset(uuid_bytes, 0, sizeof(uuid_bytes));
+                ::memcpy(uuid_bytes,
+                         note_data.PeekData(desc_offset, desc_size),
+                         std::min<uint32_t>(desc_size, sizeof(uuid_bytes)));
+                uuid.SetBytes(uuid_bytes);
+                return uuid.IsValid();
+            }
+        }
+        offset = desc_offset + ((desc_size + 3) & ~3u);
+    }
     return false;
 }
 
@@ -428,21 +492,18 @@ ObjectFileELF::ParseDependentModules()
     if (!(dynsym_id && dynstr_id))
         return 0;
 
-    SectionList *section_list = GetSectionList();
-    if (!section_list)
-        return 0;
-
-    // Resolve and load the dynamic table entries and corresponding string
-    // table.
-    Section *dynsym = section_list->FindSectionByID(dynsym_id).get();
-    Section *dynstr = section_list->FindSectionByID(dynstr_id).get();
+    // Read the dynamic table entries and corresponding string table
+    // straight from the section headers, modules that are only asked
+    // for their dependencies shouldn't have to build their section list.
+    const ELFSectionHeader *dynsym = GetSectionHeaderByIndex(dynsym_id);
+    const ELFSectionHeader *dynstr = GetSectionHeaderByIndex(dynstr_id);
     if (!(dynsym && dynstr))
         return 0;
 
     DataExtractor dynsym_data;
     DataExtractor dynstr_data;
-    if (ReadSectionData(dynsym, dynsym_data) &&
-        ReadSectionData(dynstr, dynstr_data))
+    if (GetData(dynsym->sh_offset, dynsym->sh_size, dynsym_data) == dynsym->sh_size &&
+        GetData(dynstr->sh_offset, dynstr->sh_size, dynstr_data) == dynstr->sh_size)
     {
         ELFDynamic symbol;
         const unsigned section_size = dynsym_data.GetByteSize();
@@ -634,6 +695,7 @@ ObjectFileELF::GetSectionList()
             static ConstString g_sect_name_dwarf_debug_pubtypes (".debug_pubtypes");
             static ConstString g_sect_name_dwarf_debug_ranges (".debug_ranges");
             static ConstString g_sect_name_dwarf_debug_str (".debug_str");
+            static ConstString g_sect_name_dwarf_debug_names (".debug_names");
             static ConstString g_sect_name_eh_frame (".eh_frame");
 
             SectionType sect_type = eSectionTypeOther;
@@ -664,6 +726,7 @@ ObjectFileELF::GetSectionList()
             else if (name == g_sect_name_dwarf_debug_pubtypes)  sect_type = eSectionTypeDWARFDebugPubTypes;
             else if (name == g_sect_name_dwarf_debug_ranges)    sect_type = eSectionTypeDWARFDebugRanges;
             else if (name == g_sect_name_dwarf_debug_str)       sect_type = eSectionTypeDWARFDebugStr;
+            else if (name == g_sect_name_dwarf_debug_names)     sect_type = eSectionTypeDWARFDebugNames;
             else if (name == g_sect_name_eh_frame)              sect_type = eSectionTypeEHFrame;
             
             
@@ -689,19 +752,12 @@ ObjectFileELF::GetSectionList()
     return m_sections_ap.get();
 }
 
-static unsigned
-ParseSymbols(Symtab *symtab, 
-             user_id_t start_id,
-             SectionList *section_list,
-             const ELFSectionHeader *symtab_shdr,
-             const DataExtractor &symtab_data,
-             const DataExtractor &strtab_data)
-{
-    ELFSymbol symbol;
-    uint32_t offset = 0;
-    const unsigned num_symbols = 
-        symtab_data.GetByteSize() / symtab_shdr->sh_entsize;
+// Don't bother creating threads to parse fewer symbols than this
+#define ELF_MIN_SYMBOLS_PER_WORKER  4096
 
+static SymbolType
+GetSymbolTypeForSection (const SectionSP &symbol_section_sp)
+{
     static ConstString text_section_name(".text");
     static ConstString init_section_name(".init");
     static ConstString fini_section_name(".fini");
@@ -714,11 +770,99 @@ ParseSymbols(Symtab *symtab,
     static ConstString data2_section_name(".data1");
     static ConstString bss_section_name(".bss");
 
+    if (symbol_section_sp)
+    {
+        const ConstString &sect_name = symbol_section_sp->GetName();
+        if (sect_name == text_section_name ||
+            sect_name == init_section_name ||
+            sect_name == fini_section_name ||
+            sect_name == ctors_section_name ||
+            sect_name == dtors_section_name)
+        {
+            return eSymbolTypeCode;
+        }
+        else if (sect_name == data_section_name ||
+                 sect_name == data2_section_name ||
+                 sect_name == rodata_section_name ||
+                 sect_name == rodata1_section_name ||
+                 sect_name == bss_section_name)
+        {
+            return eSymbolTypeData;
+        }
+    }
+    return eSymbolTypeInvalid;
+}
+
+struct ELFSymbolWorkerState
+{
+    Symbol *symbols;
+    user_id_t start_id;
+    SectionList *section_list;
+    const ELFSectionHeader *symtab_shdr;
+    const DataExtractor *symtab_data;
+    const DataExtractor *strtab_data;
+    unsigned start_idx;
+    unsigned end_idx;
+    unsigned num_parsed;
+};
+
+// Decodes symbol table entries with DataExtractor::ExtractRecords()
+class ELFSymbolRecordParser
+{
+public:
+    ELFSymbolRecordParser (ELFSymbol *symbols, bool parsing_32) :
+        m_symbols (symbols),
+        m_parsing_32 (parsing_32)
+    {
+    }
+
+    template <bool swap>
+    bool
+    ParseRecord (DataBlockCursor<swap> &cursor, uint32_t idx)
+    {
+        m_symbols[idx].Parse (cursor, m_parsing_32);
+        return true;
+    }
+
+private:
+    ELFSymbol *m_symbols;
+    bool m_parsing_32;
+};
+
+static lldb::thread_result_t
+ELFSymbolWorkerThread (void *arg)
+{
+    ELFSymbolWorkerState *state = (ELFSymbolWorkerState *)arg;
+    const uint32_t entsize = state->symtab_shdr->sh_entsize;
+
+    // Decode all of this worker's symbols up front so their bounds and
+    // byte order are only checked once. Entries that are too small for
+    // a symbol are left to ELFSymbol::Parse() to reject.
+    const bool parsing_32 = state->symtab_data->GetAddressByteSize() == 4;
+    const uint32_t min_entsize = parsing_32 ? 16 : 24;    // sizeof(Elf32_Sym) and sizeof(Elf64_Sym)
+    std::vector<ELFSymbol> elf_symbols;
+    if (entsize >= min_entsize && state->end_idx > state->start_idx)
+    {
+        elf_symbols.resize (state->end_idx - state->start_idx);
+        ELFSymbolRecordParser parser (&elf_symbols[0], parsing_32);
+        uint32_t offset = state->start_idx * entsize;
+        elf_symbols.resize (state->symtab_data->ExtractRecords (&offset, entsize, elf_symbols.size(), parser));
+    }
+
+    ELFSymbol symbol;
     unsigned i;
-    for (i = 0; i < num_symbols; ++i)
+    for (i = state->start_idx; i < state->end_idx; ++i)
     {
-        if (symbol.Parse(symtab_data, &offset) == false)
-            break;
+        if (i - state->start_idx < elf_symbols.size())
+        {
+            symbol = elf_symbols[i - state->start_idx];
+        }
+        else
+        {
+            uint32_t offset = i * entsize;
+            if (symbol.Parse(*state->symtab_data, &offset) == false)
+                break;
+        }
 
         SectionSP symbol_section_sp;
         SymbolType symbol_type = eSymbolTypeInvalid;
@@ -733,7 +877,7 @@ ParseSymbols(Symtab *symtab,
             symbol_type = eSymbolTypeUndefined;
             break;
         default:
-            symbol_section_sp = section_list->GetSectionAtIndex(symbol_idx);
+            symbol_section_sp = state->section_list->GetSectionAtIndex(symbol_idx);
             break;
         }
 
@@ -771,53 +915,103 @@ ParseSymbols(Symtab *symtab,
         }
 
         if (symbol_type == eSymbolTypeInvalid)
-        {
-            if (symbol_section_sp)
-            {
-                const ConstString &sect_name = symbol_section_sp->GetName();
-                if (sect_name == text_section_name ||
-                    sect_name == init_section_name ||
-                    sect_name == fini_section_name ||
-                    sect_name == ctors_section_name ||
-                    sect_name == dtors_section_name)
-                {
-                    symbol_type = eSymbolTypeCode;
-                }
-                else if (sect_name == data_section_name ||
-                         sect_name == data2_section_name ||
-                         sect_name == rodata_section_name ||
-                         sect_name == rodata1_section_name ||
-                         sect_name == bss_section_name)
-                {
-                    symbol_type = eSymbolTypeData;
-                }
-            }
-        }
+            symbol_type = GetSymbolTypeForSection (symbol_section_sp);
 
         uint64_t symbol_value = symbol.st_value;
         if (symbol_section_sp)
             symbol_value -= symbol_section_sp->GetFileAddress();
-        const char *symbol_name = strtab_data.PeekCStr(symbol.st_name);
+        const char *symbol_name = state->strtab_data->PeekCStr(symbol.st_name);
         bool is_global = symbol.getBinding() == STB_GLOBAL;
         uint32_t flags = symbol.st_other << 8 | symbol.st_info;
         bool is_mangled = symbol_name ? (symbol_name[0] == '_' && symbol_name[1] == 'Z') : false;
-        Symbol dc_symbol(
-            i + start_id,       // ID is the original symbol table index.
-            symbol_name,        // Symbol name.
-            is_mangled,         // Is the symbol name mangled?
-            symbol_type,        // Type of this symbol
-            is_global,          // Is this globally visible?
-            false,              // Is this symbol debug info?
-            false,              // Is this symbol a trampoline?
-            false,              // Is this symbol artificial?
-            symbol_section_sp,  // Section in which this symbol is defined or null.
-            symbol_value,       // Offset in section or symbol value.
-            symbol.st_size,     // Size in bytes of this symbol.
-            flags);             // Symbol flags.
-        symtab->AddSymbol(dc_symbol);
+        state->symbols[i] = Symbol(
+            i + state->start_id,    // ID is the original symbol table index.
+            symbol_name,            // Symbol name.
+            is_mangled,             // Is the symbol name mangled?
+            symbol_type,            // Type of this symbol
+            is_global,              // Is this globally visible?
+            false,                  // Is this symbol debug info?
+            false,                  // Is this symbol a trampoline?
+            false,                  // Is this symbol artificial?
+            symbol_section_sp,      // Section in which this symbol is defined or null.
+            symbol_value,           // Offset in section or symbol value.
+            symbol.st_size,         // Size in bytes of this symbol.
+            flags);                 // Symbol flags.
     }
+    state->num_parsed = i - state->start_idx;
+    return NULL;
+}
 
-    return i;
+static unsigned
+ParseSymbols(Symtab *symtab, 
+             user_id_t start_id,
+             SectionList *section_list,
+             const ELFSectionHeader *symtab_shdr,
+             const DataExtractor &symtab_data,
+             const DataExtractor &strtab_data)
+{
+    if (symtab_shdr->sh_entsize == 0)
+        return 0;
+
+    const unsigned num_symbols = 
+        symtab_data.GetByteSize() / symtab_shdr->sh_entsize;
+    if (num_symbols == 0)
+        return 0;
+
+    // Every symbol is decoded independently of the others, so the symbols
+    // are parsed straight into their slots in the symbol table, split
+    // into ranges that are decoded on separate threads when there are
+    // enough of them.
+    const uint32_t first_symbol_idx = symtab->GetNumSymbols();
+    Symbol *symbols = symtab->Resize (first_symbol_idx + num_symbols) + first_symbol_idx;
+
+    const unsigned num_workers = std::max<unsigned> (1, std::min<unsigned> (Host::GetNumberCPUs(), num_symbols / ELF_MIN_SYMBOLS_PER_WORKER));
+    const unsigned symbols_per_worker = (num_symbols + num_workers - 1) / num_workers;
+    std::vector<ELFSymbolWorkerState> workers (num_workers);
+    for (unsigned i = 0; i < num_workers; ++i)
+    {
+        ELFSymbolWorkerState &worker = workers[i];
+        worker.symbols = symbols;
+        worker.start_id = start_id;
+        worker.section_list = section_list;
+        worker.symtab_shdr = symtab_shdr;
+        worker.symtab_data = &symtab_data;
+        worker.strtab_data = &strtab_data;
+        worker.start_idx = std::min<unsigned> (i * symbols_per_worker, num_symbols);
+        worker.end_idx = std::min<unsigned> (worker.start_idx + symbols_per_worker, num_symbols);
+        worker.num_parsed = 0;
+    }
+
+    // The calling thread does the work for the first worker, so only
+    // spawn threads for the rest.
+    std::vector<lldb::thread_t> threads;
+    for (unsigned i = 1; i < num_workers; ++i)
+    {
+        lldb::thread_t thread = Host::ThreadCreate ("<lldb.elf.symbols>", ELFSymbolWorkerThread, &workers[i], NULL);
+        if (IS_VALID_LLDB_HOST_THREAD(thread))
+            threads.push_back (thread);
+        else
+            ELFSymbolWorkerThread (&workers[i]);
+    }
+
+    ELFSymbolWorkerThread (&workers[0]);
+
+    for (size_t i = 0; i < threads.size(); ++i)
+        Host::ThreadJoin (threads[i], NULL, NULL);
+
+    // Stop at the first symbol that failed to parse, like a serial parse
+    // would have.
+    unsigned num_parsed = 0;
+    for (unsigned i = 0; i < num_workers; ++i)
+    {
+        num_parsed += workers[i].num_parsed;
+        if (workers[i].start_idx + workers[i].num_parsed < workers[i].end_idx)
+            break;
+    }
+    if (num_parsed < num_symbols)
+        symtab->Resize (first_symbol_idx + num_parsed);
+
+    return num_parsed;
 }
 
 unsigned
@@ -1091,6 +1285,12 @@ ObjectFileELF::ParseTrampolineSymbols(Symtab *symbol_table,
                                 strtab_data);
 }
 
+void
+ObjectFileELF::ClearSymtab()
+{
+    m_symtab_ap.reset();
+}
+
 Symtab *
 ObjectFileELF::GetSymtab()
 {
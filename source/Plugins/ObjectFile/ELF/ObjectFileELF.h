@@ -14,6 +14,7 @@
 #include <vector>
 
 #include "lldb/lldb-private.h"
+#include "lldb/Core/UUID.h"
 #include "lldb/Host/FileSpec.h"
 #include "lldb/Symbol/ObjectFile.h"
 
@@ -90,6 +91,9 @@ public:
     virtual lldb_private::Symtab *
     GetSymtab();
 
+    virtual void
+    ClearSymtab();
+
     virtual lldb_private::SectionList *
     GetSectionList();
 
@@ -164,6 +168,9 @@ private:
     /// Data extractor holding the string table used to resolve section names.
     lldb_private::DataExtractor m_shstr_data;
 
+    /// UUID made from the GNU build ID note, if there is one.
+    lldb_private::UUID m_uuid;
+
     /// Cached value of the entry point for this module.
     lldb_private::Address  m_entry_point_address;
 
@@ -181,6 +188,13 @@ private:
     size_t
     ParseProgramHeaders();
 
+    /// Looks for a GNU build ID note in the PT_NOTE segment data in
+    /// @p note_data and, if found, fills in @p uuid with its first 16 bytes
+    /// (build IDs are usually 20 byte SHA-1 hashes).
+    static bool
+    ParseBuildID(const lldb_private::DataExtractor &note_data,
+                 lldb_private::UUID &uuid);
+
     /// Parses all section headers present in this object file and populates
     /// m_section_headers.  This method will compute the header list only once.
     /// Returns the number of headers parsed.
@@ -94,6 +94,9 @@ public:
     virtual lldb_private::Symtab *
     GetSymtab();
 
+    virtual void
+    ClearSymtab();
+
     virtual lldb_private::SectionList *
     GetSectionList();
 
@@ -163,6 +166,9 @@ protected:
     size_t
     ParseSections ();
 
+    bool
+    HasSegmentNamed (const lldb_private::ConstString &segment_name);
+
     size_t
     ParseSymtab (bool minimize);
 
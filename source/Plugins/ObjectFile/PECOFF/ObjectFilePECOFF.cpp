@@ -76,6 +76,13 @@ static uint32_t COFFMachineToMachCPU(uint16_t machine);
 #define OPT_HEADER_MAGIC_PE32           0x010b
 #define OPT_HEADER_MAGIC_PE32_PLUS      0x020b
 
+// Data directory indexes in the optional header
+#define IMAGE_DIRECTORY_ENTRY_EXPORT    0
+
+// The size of a COFF symbol table entry, which isn't sizeof(coff_symbol_t)
+// because the entries are packed.
+#define COFF_SYMBOL_SIZE                18
+
 // Section Flags
 // The section flags in the Characteristics field of the section header indicate
 // characteristics of the section.
@@ -223,8 +230,6 @@ ObjectFilePECOFF::ParseHeader ()
                     ParseCOFFOptionalHeader(&offset);
                 ParseSectionHeaders (offset);
             }
-            StreamFile s(stdout, false);// REMOVE THIS LINE!!!
-            Dump(&s);// REMOVE THIS LINE!!!
             return true;
         }
     }
@@ -429,10 +434,11 @@ ObjectFilePECOFF::ParseSectionHeaders (uint32_t section_header_data_offset)
     
     if (nsects > 0)
     {
-        const uint32_t addr_byte_size = GetAddressByteSize ();
         const size_t section_header_byte_size = nsects * sizeof(section_header_t);
-        DataBufferSP section_header_data_sp(m_file.ReadFileContents (section_header_data_offset, section_header_byte_size));
-        DataExtractor section_header_data (section_header_data_sp, GetByteOrder(), addr_byte_size);
+        // The whole file is memory mapped into m_data, so use a slice of it
+        // instead of reading the section headers into a new buffer.
+        DataExtractor section_header_data;
+        GetData (section_header_data_offset, section_header_byte_size, section_header_data);
 
         uint32_t offset = 0;
         if (section_header_data.ValidOffsetForDataOfSize (offset, section_header_byte_size))
@@ -482,6 +488,17 @@ ObjectFilePECOFF::GetSectionName(std::string& sect_name, const section_header_t&
     return true;
 }       
 
+void
+ObjectFilePECOFF::ClearSymtab()
+{
+    ModuleSP module_sp(GetModule());
+    if (module_sp)
+    {
+        lldb_private::Mutex::Locker locker(module_sp->GetMutex());
+        m_symtab_ap.reset();
+    }
+}
+
 //----------------------------------------------------------------------
 // GetNListSymtab
 //----------------------------------------------------------------------
@@ -497,68 +514,219 @@ ObjectFilePECOFF::GetSymtab()
             SectionList *sect_list = GetSectionList();
             m_symtab_ap.reset(new Symtab(this));
             Mutex::Locker symtab_locker (m_symtab_ap->GetMutex());
-            
-            const uint32_t num_syms = m_coff_header.nsyms;
 
-            if (num_syms > 0 && m_coff_header.symoff > 0)
-            {
-                const uint32_t symbol_size = sizeof(section_header_t);
-                const uint32_t addr_byte_size = GetAddressByteSize ();
-                const size_t symbol_data_size = num_syms * symbol_size; 
-                // Include the 4 bytes string table size at the end of the symbols
-                DataBufferSP symtab_data_sp(m_file.ReadFileContents (m_coff_header.symoff, symbol_data_size + 4));
-                DataExtractor symtab_data (symtab_data_sp, GetByteOrder(), addr_byte_size);
-                uint32_t offset = symbol_data_size;
-                const uint32_t strtab_size = symtab_data.GetU32 (&offset);
-                DataBufferSP strtab_data_sp(m_file.ReadFileContents (m_coff_header.symoff + symbol_data_size + 4, strtab_size));
-                DataExtractor strtab_data (strtab_data_sp, GetByteOrder(), addr_byte_size);
-
-                offset = 0;
-                std::string symbol_name;
-                Symbol *symbols = m_symtab_ap->Resize (num_syms);
-                for (uint32_t i=0; i<num_syms; ++i)
-                {
-                    coff_symbol_t symbol;
-                    const uint32_t symbol_offset = offset;
-                    const char *symbol_name_cstr = NULL;
-                    // If the first 4 bytes of the symbol string are zero, then we
-                    // it is followed by a 4 byte string table offset. Else these
-                    // 8 bytes contain the symbol name
-                    if (symtab_data.GetU32 (&offset) == 0)
-                    {
-                        // Long string that doesn't fit into the symbol table name,
-                        // so now we must read the 4 byte string table offset
-                        uint32_t strtab_offset = symtab_data.GetU32 (&offset);
-                        symbol_name_cstr = strtab_data.PeekCStr (strtab_offset);
-                        symbol_name.assign (symbol_name_cstr);
-                    }
-                    else
-                    {
-                        // Short string that fits into the symbol table name which is 8 bytes
-                        offset += sizeof(symbol.name) - 4; // Skip remaining 
-                        symbol_name_cstr = symtab_data.PeekCStr (symbol_offset);
-                        if (symbol_name_cstr == NULL)
-                            break;
-                        symbol_name.assign (symbol_name_cstr, sizeof(symbol.name));
-                    }
-                    symbol.value    = symtab_data.GetU32 (&offset);
-                    symbol.sect     = symtab_data.GetU16 (&offset);
-                    symbol.type     = symtab_data.GetU16 (&offset);
-                    symbol.storage  = symtab_data.GetU8  (&offset);
-                    symbol.naux     = symtab_data.GetU8  (&offset);		
-                    Address symbol_addr(sect_list->GetSectionAtIndex(symbol.sect-1), symbol.value);
-                    symbols[i].GetMangled ().SetValue (ConstString(symbol_name.c_str()));
-                    symbols[i].GetAddress() = symbol_addr;
-
-                    if (symbol.naux > 0)
-                        i += symbol.naux;
-                }
-                
-            }
+            // Linked images rarely have any COFF symbols left, for those
+            // the exports are the only symbols there are.
+            ParseCOFFSymbols (sect_list);
+            ParseExportSymbols (sect_list);
+            m_symtab_ap->Finalize ();
         }
     }
     return m_symtab_ap.get();
+}
+
+//----------------------------------------------------------------------
+// ParseCOFFSymbols
+//
+// Add the symbols from the COFF symbol table, reading them straight out
+// of the memory mapped file.
+//----------------------------------------------------------------------
+void
+ObjectFilePECOFF::ParseCOFFSymbols (SectionList *sect_list)
+{
+    const uint32_t num_syms = m_coff_header.nsyms;
+    if (num_syms == 0 || m_coff_header.symoff == 0)
+        return;
+
+    const size_t symbol_data_size = num_syms * COFF_SYMBOL_SIZE;
+    // Include the 4 bytes string table size at the end of the symbols.
+    // Both tables are slices of the memory mapped file data.
+    DataExtractor symtab_data;
+    if (GetData (m_coff_header.symoff, symbol_data_size + 4, symtab_data) != symbol_data_size + 4)
+        return;
+    uint32_t offset = symbol_data_size;
+    const uint32_t strtab_size = symtab_data.GetU32 (&offset);
+    DataExtractor strtab_data;
+    GetData (m_coff_header.symoff + symbol_data_size, strtab_size, strtab_data);
+
+    m_symtab_ap->Reserve (m_symtab_ap->GetNumSymbols() + num_syms);
+    for (uint32_t i=0; i<num_syms; ++i)
+    {
+        offset = i * COFF_SYMBOL_SIZE;
+        ConstString symbol_name;
+        // If the first 4 bytes of the symbol name are zero, they are
+        // followed by a 4 byte string table offset (the offset counts
+        // the 4 size bytes). Else these 8 bytes contain the symbol name,
+        // which is only NULL terminated if it is shorter than 8 bytes.
+        if (symtab_data.GetU32 (&offset) == 0)
+        {
+            const uint32_t strtab_offset = symtab_data.GetU32 (&offset);
+            symbol_name.SetCString (strtab_data.PeekCStr (strtab_offset));
+        }
+        else
+        {
+            const char *name_data = (const char *)symtab_data.PeekData (i * COFF_SYMBOL_SIZE, 8);
+            symbol_name = ConstString (name_data, 8);
+            offset += 4;
+        }
+        const uint32_t value = symtab_data.GetU32 (&offset);
+        const uint16_t sect = symtab_data.GetU16 (&offset);
+        symtab_data.GetU16 (&offset);   // type
+        symtab_data.GetU8 (&offset);    // storage class
+        const uint8_t naux = symtab_data.GetU8 (&offset);
+
+        // Section numbers are 1 based, zero means undefined and the
+        // values above the number of sections are absolute or debug
+        // symbols.
+        SectionSP section_sp;
+        if (sect > 0 && sect_list)
+            section_sp = sect_list->GetSectionAtIndex (sect - 1);
+        if (symbol_name)
+        {
+            Symbol symbol;
+            symbol.GetMangled().SetValue (symbol_name);
+            symbol.GetAddress() = Address (section_sp, value);
+            m_symtab_ap->AddSymbol (symbol);
+        }
+
+        // Skip the auxiliary entries, they aren't symbols
+        i += naux;
+    }
+}
+
+//----------------------------------------------------------------------
+// ParseExportSymbols
+//
+// Add a code or data symbol for each named export in the export
+// directory.
+//----------------------------------------------------------------------
+void
+ObjectFilePECOFF::ParseExportSymbols (SectionList *sect_list)
+{
+    if (sect_list == NULL || m_coff_header_opt.data_dirs.size() <= IMAGE_DIRECTORY_ENTRY_EXPORT)
+        return;
+    const data_directory &export_dir = m_coff_header_opt.data_dirs[IMAGE_DIRECTORY_ENTRY_EXPORT];
+    if (export_dir.vmaddr == 0 || export_dir.vmsize < 40)
+        return;
+
+    DataExtractor export_data;
+    if (!GetDataForRVA (export_dir.vmaddr, 40, export_data))
+        return;
+    uint32_t offset = 24;   // Skip the flags, time stamp, version, name and ordinal base
+    const uint32_t num_functions = export_data.GetU32 (&offset);
+    const uint32_t num_names = export_data.GetU32 (&offset);
+    const uint32_t functions_rva = export_data.GetU32 (&offset);
+    const uint32_t names_rva = export_data.GetU32 (&offset);
+    const uint32_t ordinals_rva = export_data.GetU32 (&offset);
+
+    DataExtractor functions_data;
+    DataExtractor names_data;
+    DataExtractor ordinals_data;
+    if (num_names == 0 ||
+        !GetDataForRVA (functions_rva, num_functions * 4, functions_data) ||
+        !GetDataForRVA (names_rva, num_names * 4, names_data) ||
+        !GetDataForRVA (ordinals_rva, num_names * 2, ordinals_data))
+        return;
+
+    m_symtab_ap->Reserve (m_symtab_ap->GetNumSymbols() + num_names);
+    uint32_t names_offset = 0;
+    uint32_t ordinals_offset = 0;
+    for (uint32_t i=0; i<num_names; ++i)
+    {
+        const uint32_t name_rva = names_data.GetU32 (&names_offset);
+        const uint32_t function_idx = ordinals_data.GetU16 (&ordinals_offset);
+        if (function_idx >= num_functions)
+            continue;
+        uint32_t function_offset = function_idx * 4;
+        const uint32_t function_rva = functions_data.GetU32 (&function_offset);
+        // Exports whose address is inside the export directory are
+        // forwarded to another DLL, they have no code here.
+        if (function_rva - export_dir.vmaddr < export_dir.vmsize)
+            continue;
+
+        const uint32_t sect_idx = FindSectionHeaderIndexForRVA (function_rva);
+        if (sect_idx == UINT32_MAX)
+            continue;
+        const char *name_cstr = GetCStringForRVA (name_rva);
+        if (name_cstr == NULL || name_cstr[0] == '\0')
+            continue;
+
+        const section_header_t &sect_header = m_sect_headers[sect_idx];
+        const bool is_code = (sect_header.flags & (IMAGE_SCN_CNT_CODE | IMAGE_SCN_MEM_EXECUTE)) != 0;
+        Symbol symbol (m_symtab_ap->GetNumSymbols(),                 // Symbol ID
+                       name_cstr,                                    // Symbol name
+                       false,                                        // The name is not mangled
+                       is_code ? eSymbolTypeCode : eSymbolTypeData,  // Type of this symbol
+                       true,                                         // Exports are external
+                       false,                                        // Not a debug symbol
+                       false,                                        // Not a trampoline
+                       false,                                        // Not artificial
+                       sect_list->GetSectionAtIndex (sect_idx),      // Section this symbol is in
+                       function_rva - sect_header.vmaddr,            // Offset in the section
+                       0,                                            // Size is unknown
+                       0);                                           // Flags
+        m_symtab_ap->AddSymbol (symbol);
+    }
+}
+
+//----------------------------------------------------------------------
+// FindSectionHeaderIndexForRVA
+//
+// Return the index of the section header that contains the relative
+// virtual address RVA, or UINT32_MAX if none does.
+//----------------------------------------------------------------------
+uint32_t
+ObjectFilePECOFF::FindSectionHeaderIndexForRVA (uint32_t rva) const
+{
+    const uint32_t nsects = m_sect_headers.size();
+    for (uint32_t idx = 0; idx<nsects; ++idx)
+    {
+        const section_header_t &sect = m_sect_headers[idx];
+        const uint32_t sect_size = std::max<uint32_t> (sect.vmsize, sect.size);
+        if (rva - sect.vmaddr < sect_size)
+            return idx;
+    }
+    return UINT32_MAX;
+}
 
+//----------------------------------------------------------------------
+// GetDataForRVA
+//
+// Point DATA at the LENGTH bytes in the file for the relative virtual
+// address RVA. The bytes must all be in the file part of one section.
+//----------------------------------------------------------------------
+bool
+ObjectFilePECOFF::GetDataForRVA (uint32_t rva, uint32_t length, DataExtractor &data)
+{
+    const uint32_t sect_idx = FindSectionHeaderIndexForRVA (rva);
+    if (sect_idx == UINT32_MAX)
+        return false;
+    const section_header_t &sect = m_sect_headers[sect_idx];
+    const uint32_t sect_offset = rva - sect.vmaddr;
+    if (sect_offset > sect.size || length > sect.size - sect_offset)
+        return false;
+    return GetData (sect.offset + sect_offset, length, data) == length;
+}
+
+//----------------------------------------------------------------------
+// GetCStringForRVA
+//
+// Return the C string at the relative virtual address RVA in the memory
+// mapped file, or NULL if RVA isn't in the file part of a section.
+//----------------------------------------------------------------------
+const char *
+ObjectFilePECOFF::GetCStringForRVA (uint32_t rva)
+{
+    const uint32_t sect_idx = FindSectionHeaderIndexForRVA (rva);
+    if (sect_idx == UINT32_MAX)
+        return NULL;
+    const section_header_t &sect = m_sect_headers[sect_idx];
+    const uint32_t sect_offset = rva - sect.vmaddr;
+    if (sect_offset >= sect.size)
+        return NULL;
+    DataExtractor data;
+    GetData (sect.offset + sect_offset, sect.size - sect_offset, data);
+    return data.PeekCStr (0);
 }
 
 SectionList *
@@ -76,6 +76,9 @@ public:
 //    
     virtual lldb_private::Symtab *
     GetSymtab();
+
+    virtual void
+    ClearSymtab();
     
     virtual lldb_private::SectionList *
     GetSectionList();
@@ -215,6 +218,11 @@ protected:
 	bool ParseCOFFHeader (uint32_t* offset_ptr);
 	bool ParseCOFFOptionalHeader (uint32_t* offset_ptr);
 	bool ParseSectionHeaders (uint32_t offset);
+    void ParseCOFFSymbols (lldb_private::SectionList *sect_list);
+    void ParseExportSymbols (lldb_private::SectionList *sect_list);
+    uint32_t FindSectionHeaderIndexForRVA (uint32_t rva) const;
+    bool GetDataForRVA (uint32_t rva, uint32_t length, lldb_private::DataExtractor &data);
+    const char *GetCStringForRVA (uint32_t rva);
 	
 	static	void DumpDOSHeader(lldb_private::Stream *s, const dos_header_t& header);
 	static	void DumpCOFFHeader(lldb_private::Stream *s, const coff_header_t& header);
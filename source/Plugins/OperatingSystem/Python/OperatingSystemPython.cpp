@@ -79,7 +79,9 @@ OperatingSystemPython::OperatingSystemPython (lldb_private::Process *process) :
     m_thread_list_valobj_sp (),
     m_register_info_ap (),
     m_interpreter(NULL),
-    m_python_object(NULL)
+    m_python_object(NULL),
+    m_threads(),
+    m_threads_stop_id(UINT32_MAX)
 {
     if (!process)
         return;
@@ -150,58 +152,163 @@ OperatingSystemPython::GetPluginVersion()
 bool
 OperatingSystemPython::UpdateThreadList (ThreadList &old_thread_list, ThreadList &new_thread_list)
 {
-    
     if (!m_interpreter || !m_python_object)
-        return NULL;
-    auto object_sp = m_interpreter->OSPlugin_QueryForThreadsInfo(m_interpreter->MakeScriptObject(m_python_object));
+        return false;
+
+    // With thousands of threads, most of which didn't do anything since
+    // the last stop, it is a lot cheaper to only hear about the changes
+    const uint32_t stop_id = m_process->GetStopID();
+    bool updated = m_threads_stop_id != UINT32_MAX && UpdateThreadsIncrementally (stop_id);
+    if (!updated)
+        updated = UpdateAllThreads ();
+
+    if (updated)
+    {
+        m_threads_stop_id = stop_id;
+        for (ThreadMap::iterator pos = m_threads.begin(), end = m_threads.end(); pos != end; ++pos)
+        {
+            ThreadSP thread_sp (pos->second.lock());
+            if (thread_sp)
+                new_thread_list.AddThread (thread_sp);
+        }
+    }
+    else
+    {
+        m_threads_stop_id = UINT32_MAX;
+        new_thread_list = old_thread_list;
+    }
+    return new_thread_list.GetSize(false) > 0;
+}
+
+bool
+OperatingSystemPython::UpdateThreadsIncrementally (uint32_t stop_id)
+{
+    // The threads we are about to update must all still be around, the
+    // process may have thrown its thread list away since
+    for (ThreadMap::iterator pos = m_threads.begin(), end = m_threads.end(); pos != end; ++pos)
+    {
+        if (pos->second.expired())
+            return false;
+    }
+
+    auto object_sp = m_interpreter->OSPlugin_QueryForThreadsInfoChanges (m_interpreter->MakeScriptObject(m_python_object),
+                                                                         m_threads_stop_id,
+                                                                         stop_id);
     if (!object_sp)
-        return NULL;
+        return false;
     PythonDataObject pyobj((PyObject*)object_sp->GetObject());
-    PythonDataArray threads_array (pyobj.GetArrayObject());
-    if (threads_array)
+    PythonDataDictionary changes_dict (pyobj.GetDictionaryObject());
+    if (!changes_dict)
+        return false;
+
+    PythonDataArray removed_array (changes_dict.GetItemForKey("removed").GetArrayObject());
+    if (removed_array)
     {
-//        const uint32_t num_old_threads = old_thread_list.GetSize(false);
-//        for (uint32_t i=0; i<num_old_threads; ++i)
-//        {
-//            ThreadSP old_thread_sp(old_thread_list.GetThreadAtIndex(i, false));
-//            if (old_thread_sp->GetID() < 0x10000)
-//                new_thread_list.AddThread (old_thread_sp);
-//        }
-
-        PythonDataString tid_pystr("tid");
-        PythonDataString name_pystr("name");
-        PythonDataString queue_pystr("queue");
-        PythonDataString state_pystr("state");
-        PythonDataString stop_reason_pystr("stop_reason");
-        
-        const uint32_t num_threads = threads_array.GetSize();
-        for (uint32_t i=0; i<num_threads; ++i)
+        const uint32_t num_removed = removed_array.GetSize();
+        for (uint32_t i=0; i<num_removed; ++i)
         {
-            PythonDataDictionary thread_dict(threads_array.GetItemAtIndex(i).GetDictionaryObject());
+            PythonDataInteger tid_pyint (removed_array.GetItemAtIndex(i).GetIntegerObject());
+            if (tid_pyint)
+                m_threads.erase (tid_pyint.GetInteger());
+        }
+    }
+
+    // Threads that changed get their registers again the next time they
+    // are asked for, the others keep what they have
+    PythonDataArray changed_array (changes_dict.GetItemForKey("changed").GetArrayObject());
+    if (changed_array)
+    {
+        const uint32_t num_changed = changed_array.GetSize();
+        for (uint32_t i=0; i<num_changed; ++i)
+        {
+            PythonDataDictionary thread_dict (changed_array.GetItemAtIndex(i).GetDictionaryObject());
             if (thread_dict)
-            {
-                const tid_t tid = thread_dict.GetItemForKeyAsInteger(tid_pystr, LLDB_INVALID_THREAD_ID);
-                const char *name = thread_dict.GetItemForKeyAsString (name_pystr);
-                const char *queue = thread_dict.GetItemForKeyAsString (queue_pystr);
-                //const char *state = thread_dict.GetItemForKeyAsString (state_pystr);
-                //const char *stop_reason = thread_dict.GetItemForKeyAsString (stop_reason_pystr);
-                
-                ThreadSP thread_sp (old_thread_list.FindThreadByID (tid, false));
-                if (!thread_sp)
-                    thread_sp.reset (new ThreadMemory (m_process->shared_from_this(),
-                                                       tid,
-                                                       name,
-                                                       queue));
-                new_thread_list.AddThread(thread_sp);
+                UpdateThreadFromDictionary (thread_dict);
+        }
+    }
 
-            }
+    PythonDataArray added_array (changes_dict.GetItemForKey("added").GetArrayObject());
+    if (added_array)
+    {
+        const uint32_t num_added = added_array.GetSize();
+        for (uint32_t i=0; i<num_added; ++i)
+        {
+            PythonDataDictionary thread_dict (added_array.GetItemAtIndex(i).GetDictionaryObject());
+            if (thread_dict)
+                UpdateThreadFromDictionary (thread_dict);
+        }
+    }
+    return true;
+}
+
+bool
+OperatingSystemPython::UpdateAllThreads ()
+{
+    auto object_sp = m_interpreter->OSPlugin_QueryForThreadsInfo(m_interpreter->MakeScriptObject(m_python_object));
+    if (!object_sp)
+        return false;
+    PythonDataObject pyobj((PyObject*)object_sp->GetObject());
+    PythonDataArray threads_array (pyobj.GetArrayObject());
+    if (!threads_array)
+        return false;
+
+    // Any thread that isn't in the new list is gone, the rest are looked
+    // up again in UpdateThreadFromDictionary()
+    ThreadMap old_threads;
+    old_threads.swap (m_threads);
+
+    PythonDataString tid_pystr("tid");
+    const uint32_t num_threads = threads_array.GetSize();
+    for (uint32_t i=0; i<num_threads; ++i)
+    {
+        PythonDataDictionary thread_dict(threads_array.GetItemAtIndex(i).GetDictionaryObject());
+        if (thread_dict)
+        {
+            const tid_t tid = thread_dict.GetItemForKeyAsInteger(tid_pystr, LLDB_INVALID_THREAD_ID);
+            ThreadMap::iterator pos = old_threads.find (tid);
+            if (pos != old_threads.end())
+                m_threads.insert (*pos);
+            UpdateThreadFromDictionary (thread_dict);
         }
     }
+    return true;
+}
+
+void
+OperatingSystemPython::UpdateThreadFromDictionary (PythonDataDictionary &thread_dict)
+{
+    PythonDataString tid_pystr("tid");
+    PythonDataString name_pystr("name");
+    PythonDataString queue_pystr("queue");
+    //PythonDataString state_pystr("state");
+    //PythonDataString stop_reason_pystr("stop_reason");
+
+    const tid_t tid = thread_dict.GetItemForKeyAsInteger(tid_pystr, LLDB_INVALID_THREAD_ID);
+    if (tid == LLDB_INVALID_THREAD_ID)
+        return;
+    const char *name = thread_dict.GetItemForKeyAsString (name_pystr);
+    const char *queue = thread_dict.GetItemForKeyAsString (queue_pystr);
+    //const char *state = thread_dict.GetItemForKeyAsString (state_pystr);
+    //const char *stop_reason = thread_dict.GetItemForKeyAsString (stop_reason_pystr);
+
+    ThreadSP thread_sp (m_threads[tid].lock());
+    if (thread_sp)
+    {
+        // All the threads in m_threads are ours. We don't know what about
+        // the thread changed, so its registers are fetched again lazily.
+        ThreadMemory *thread_memory = static_cast<ThreadMemory *>(thread_sp.get());
+        thread_memory->SetName (name);
+        thread_memory->SetQueueName (queue);
+        thread_memory->ClearRegisterContext ();
+    }
     else
     {
-        new_thread_list = old_thread_list;
+        thread_sp.reset (new ThreadMemory (m_process->shared_from_this(),
+                                           tid,
+                                           name,
+                                           queue));
+        m_threads[tid] = thread_sp;
     }
-    return new_thread_list.GetSize(false) > 0;
 }
 
 void
@@ -13,7 +13,9 @@
 
 // C Includes
 // C++ Includes
+#include <map>
 // Other libraries and framework includes
+#include "lldb/Interpreter/PythonDataObjects.h"
 #include "lldb/Interpreter/ScriptInterpreter.h"
 #include "lldb/Target/OperatingSystem.h"
 
@@ -81,10 +83,33 @@ protected:
     DynamicRegisterInfo *
     GetDynamicRegisterInfo ();
 
+    //------------------------------------------------------------------
+    /// Ask the plug-in for the threads that were added, removed or
+    /// changed since the last update, and apply them to m_threads.
+    ///
+    /// @return
+    ///     False if the plug-in can't tell, in which case the whole list
+    ///     has to be asked for.
+    //------------------------------------------------------------------
+    bool
+    UpdateThreadsIncrementally (uint32_t stop_id);
+
+    bool
+    UpdateAllThreads ();
+
+    void
+    UpdateThreadFromDictionary (lldb_private::PythonDataDictionary &thread_dict);
+
+    // The threads we made, by thread ID. The process' thread list owns
+    // them, so these are only weak references.
+    typedef std::map<lldb::tid_t, lldb::ThreadWP> ThreadMap;
+
     lldb::ValueObjectSP m_thread_list_valobj_sp;
     std::auto_ptr<DynamicRegisterInfo> m_register_info_ap;
     lldb_private::ScriptInterpreter *m_interpreter;
     void* m_python_object;
+    ThreadMap m_threads;
+    uint32_t m_threads_stop_id;     // The stop ID m_threads was last updated at, or UINT32_MAX
     
 };
 
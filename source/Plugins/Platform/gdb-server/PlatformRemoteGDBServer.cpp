@@ -10,6 +10,9 @@
 #include "PlatformRemoteGDBServer.h"
 
 // C Includes
+#include <limits.h>
+#include <stdio.h>
+#include <unistd.h>
 #ifdef _POSIX_SOURCE
 #include <sys/sysctl.h>
 #endif
@@ -24,7 +27,9 @@
 #include "lldb/Core/Module.h"
 #include "lldb/Core/ModuleList.h"
 #include "lldb/Core/PluginManager.h"
+#include "lldb/Core/StreamFile.h"
 #include "lldb/Core/StreamString.h"
+#include "lldb/Core/UUID.h"
 #include "lldb/Host/FileSpec.h"
 #include "lldb/Host/Host.h"
 #include "lldb/Target/Process.h"
@@ -117,9 +122,76 @@ PlatformRemoteGDBServer::GetFile (const FileSpec &platform_file,
 {
     // Default to the local case
     local_file = platform_file;
+    if (!IsConnected())
+        return Error();
+
+    // Cached copies are found by UUID, without one we can't tell if a
+    // copy is of the same file so keep using the local path.
+    UUID uuid;
+    if (uuid_ptr)
+        uuid = *uuid_ptr;
+    if (!uuid.IsValid() && !m_gdb_client.GetModuleUUID (platform_file, uuid))
+        return Error();
+
+    FileSpec cache_file;
+    if (!GetModuleCacheFileSpec (uuid, platform_file, true, cache_file))
+        return Error();
+
+    if (!cache_file.Exists())
+    {
+        Error error (DownloadFile (platform_file, cache_file));
+        if (error.Fail())
+            return error;
+    }
+    local_file = cache_file;
     return Error();
 }
 
+Error
+PlatformRemoteGDBServer::DownloadFile (const FileSpec &platform_file, const FileSpec &local_file)
+{
+    Error error;
+    char local_path[PATH_MAX];
+    if (!local_file.GetPath (local_path, sizeof(local_path)))
+    {
+        error.SetErrorString ("invalid local path");
+        return error;
+    }
+
+    if (!IsConnected())
+    {
+        error.SetErrorString ("not connected to a remote platform");
+        return error;
+    }
+
+    // Write to a temporary file and move it into place at the end so
+    // other sessions never see a partial file in the cache
+    std::string tmp_path (local_path);
+    StreamString tmp_suffix;
+    tmp_suffix.Printf (".partial.%i", (int)::getpid());
+    tmp_path += tmp_suffix.GetData();
+
+    error = m_gdb_client.DownloadFile (platform_file, FileSpec (tmp_path.c_str(), false), true);
+    if (error.Success() && ::rename (tmp_path.c_str(), local_path) != 0)
+        error.SetErrorToErrno();
+    if (error.Fail())
+        ::unlink (tmp_path.c_str());
+    return error;
+}
+
+Error
+PlatformRemoteGDBServer::PutFile (const FileSpec &local_file,
+                                  const FileSpec &platform_file,
+                                  uint32_t mode)
+{
+    Error error;
+    if (IsConnected())
+        error = m_gdb_client.UploadFile (local_file, platform_file, mode);
+    else
+        error.SetErrorString ("not connected to a remote platform");
+    return error;
+}
+
 //------------------------------------------------------------------
 /// Default Constructor
 //------------------------------------------------------------------
@@ -215,7 +287,8 @@ PlatformRemoteGDBServer::ConnectRemote (Args& args)
                     m_gdb_client.QueryNoAckModeSupported();
                     m_gdb_client.GetHostInfo();
 #if 0
-                    m_gdb_client.TestPacketSpeed(10000);
+                    StreamFile strm (stdout, false);
+                    m_gdb_client.TestPacketSpeed(10000, strm);
 #endif
                 }
                 else
@@ -83,6 +83,15 @@ public:
              const lldb_private::UUID *uuid_ptr,
              lldb_private::FileSpec &local_file);
 
+    virtual lldb_private::Error
+    DownloadFile (const lldb_private::FileSpec &platform_file,
+                  const lldb_private::FileSpec &local_file);
+
+    virtual lldb_private::Error
+    PutFile (const lldb_private::FileSpec &local_file,
+             const lldb_private::FileSpec &platform_file,
+             uint32_t mode);
+
     virtual bool
     GetProcessInfo (lldb::pid_t pid, 
                     lldb_private::ProcessInstanceInfo &proc_info);
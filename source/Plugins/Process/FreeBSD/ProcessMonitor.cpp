@@ -1407,7 +1407,8 @@ ProcessMonitor::WriteMemory(lldb::addr_t vm_addr, const void *buf, size_t size,
 }
 
 bool
-ProcessMonitor::ReadRegisterValue(unsigned offset, unsigned size, RegisterValue &value)
+ProcessMonitor::ReadRegisterValue(lldb::tid_t tid, unsigned offset,
+                                  unsigned size, RegisterValue &value)
 {
     bool result;
     ReadRegOperation op(offset, size, value, result);
@@ -1416,7 +1417,8 @@ ProcessMonitor::ReadRegisterValue(unsigned offset, unsigned size, RegisterValue
 }
 
 bool
-ProcessMonitor::WriteRegisterValue(unsigned offset, const RegisterValue &value)
+ProcessMonitor::WriteRegisterValue(lldb::tid_t tid, unsigned offset,
+                                   const RegisterValue &value)
 {
     bool result;
     WriteRegOperation op(offset, value, result);
@@ -1425,7 +1427,7 @@ ProcessMonitor::WriteRegisterValue(unsigned offset, const RegisterValue &value)
 }
 
 bool
-ProcessMonitor::ReadGPR(void *buf)
+ProcessMonitor::ReadGPR(lldb::tid_t tid, void *buf)
 {
     bool result;
     ReadGPROperation op(buf, result);
@@ -1434,7 +1436,7 @@ ProcessMonitor::ReadGPR(void *buf)
 }
 
 bool
-ProcessMonitor::ReadFPR(void *buf)
+ProcessMonitor::ReadFPR(lldb::tid_t tid, void *buf)
 {
     bool result;
     ReadFPROperation op(buf, result);
@@ -1443,7 +1445,7 @@ ProcessMonitor::ReadFPR(void *buf)
 }
 
 bool
-ProcessMonitor::WriteGPR(void *buf)
+ProcessMonitor::WriteGPR(lldb::tid_t tid, void *buf)
 {
     bool result;
     WriteGPROperation op(buf, result);
@@ -1452,7 +1454,7 @@ ProcessMonitor::WriteGPR(void *buf)
 }
 
 bool
-ProcessMonitor::WriteFPR(void *buf)
+ProcessMonitor::WriteFPR(lldb::tid_t tid, void *buf)
 {
     bool result;
     WriteFPROperation op(buf, result);
@@ -1460,6 +1462,26 @@ ProcessMonitor::WriteFPR(void *buf)
     return result;
 }
 
+bool
+ProcessMonitor::ReadRegisterSets(lldb::tid_t tid, void *gpr_buf, void *fpr_buf)
+{
+    if (gpr_buf && !ReadGPR(tid, gpr_buf))
+        return false;
+    if (fpr_buf && !ReadFPR(tid, fpr_buf))
+        return false;
+    return true;
+}
+
+bool
+ProcessMonitor::WriteRegisterSets(lldb::tid_t tid, void *gpr_buf, void *fpr_buf)
+{
+    if (gpr_buf && !WriteGPR(tid, gpr_buf))
+        return false;
+    if (fpr_buf && !WriteFPR(tid, fpr_buf))
+        return false;
+    return true;
+}
+
 bool
 ProcessMonitor::Resume(lldb::tid_t tid, uint32_t signo)
 {
@@ -101,18 +101,22 @@ ProcessLinux::UpdateThreadList(ThreadList &old_thread_list, ThreadList &new_thre
     if (log && log->GetMask().Test(POSIX_LOG_VERBOSE))
         log->Printf ("ProcessLinux::%s() (pid = %i)", __FUNCTION__, GetID());
 
-    // Update the process thread list with this new thread.
-    // FIXME: We should be using tid, not pid.
+    // The monitor adds threads as the inferior starts them and removes them as
+    // they exit, so the threads in the old list are the current ones.
     assert(m_monitor);
-    ThreadSP thread_sp (old_thread_list.FindThreadByID (GetID(), false));
-    if (!thread_sp) {
+    const uint32_t num_threads = old_thread_list.GetSize(false);
+    for (uint32_t i = 0; i < num_threads; ++i)
+        new_thread_list.AddThread(old_thread_list.GetThreadAtIndex(i, false));
+
+    if (new_thread_list.GetSize(false) == 0)
+    {
         ProcessSP me = this->shared_from_this();
-        thread_sp.reset(new POSIXThread(me, GetID()));
+        ThreadSP thread_sp (new POSIXThread(me, GetID()));
+        new_thread_list.AddThread(thread_sp);
     }
 
     if (log && log->GetMask().Test(POSIX_LOG_VERBOSE))
         log->Printf ("ProcessLinux::%s() updated pid = %i", __FUNCTION__, GetID());
-    new_thread_list.AddThread(thread_sp);
 
     return new_thread_list.GetSize(false) > 0;
 }
@@ -8,13 +8,21 @@
 //===----------------------------------------------------------------------===//
 
 // C Includes
+#include <dirent.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
 #include <poll.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 #include <sys/ptrace.h>
 #include <sys/socket.h>
+#include <sys/syscall.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <sys/user.h>
 #include <sys/wait.h>
 
@@ -157,6 +165,79 @@ PtraceWrapper(__ptrace_request req, pid_t pid, void *addr, void *data,
 #define PTRACE ptrace
 #endif
 
+//------------------------------------------------------------------------------
+// Bulk memory access.  Reading or writing memory a word at a time with
+// PTRACE_PEEKDATA and PTRACE_POKEDATA costs a system call per word, so we
+// first try to transfer the whole range with a single process_vm_readv or
+// process_vm_writev call, or with pread/pwrite on /proc/<pid>/mem.  Neither
+// of these need to be called from the monitor thread.  They can come up
+// short, for example process_vm_writev can't write to read only pages that
+// contain code, in which case the callers fall back to ptrace for the rest.
+
+#if defined(__NR_process_vm_readv) && defined(__NR_process_vm_writev)
+static bool g_process_vm_rw_unsupported = false;
+#endif
+
+static int
+OpenProcessMemFile(lldb::pid_t pid, int flags)
+{
+    char mem_path[64];
+    ::snprintf(mem_path, sizeof(mem_path), "/proc/%llu/mem", (unsigned long long)pid);
+    return ::open(mem_path, flags);
+}
+
+static size_t
+DoReadMemoryBulk(lldb::pid_t pid, lldb::addr_t vm_addr, void *buf, size_t size)
+{
+#if defined(__NR_process_vm_readv) && defined(__NR_process_vm_writev)
+    if (!g_process_vm_rw_unsupported)
+    {
+        struct iovec local_iov = { buf, size };
+        struct iovec remote_iov = { (void*)vm_addr, size };
+        ssize_t bytes_read = ::syscall(__NR_process_vm_readv, pid, &local_iov, 1UL, &remote_iov, 1UL, 0UL);
+        if (bytes_read > 0)
+            return bytes_read;
+        if (bytes_read < 0 && errno == ENOSYS)
+            g_process_vm_rw_unsupported = true;
+        else
+            return 0;
+    }
+#endif
+
+    int fd = OpenProcessMemFile(pid, O_RDONLY);
+    if (fd < 0)
+        return 0;
+    ssize_t bytes_read = ::pread(fd, buf, size, (off_t)vm_addr);
+    ::close(fd);
+    return bytes_read > 0 ? bytes_read : 0;
+}
+
+static size_t
+DoWriteMemoryBulk(lldb::pid_t pid, lldb::addr_t vm_addr, const void *buf, size_t size)
+{
+#if defined(__NR_process_vm_readv) && defined(__NR_process_vm_writev)
+    if (!g_process_vm_rw_unsupported)
+    {
+        struct iovec local_iov = { const_cast<void *>(buf), size };
+        struct iovec remote_iov = { (void*)vm_addr, size };
+        ssize_t bytes_written = ::syscall(__NR_process_vm_writev, pid, &local_iov, 1UL, &remote_iov, 1UL, 0UL);
+        if (bytes_written > 0)
+            return bytes_written;
+        if (bytes_written < 0 && errno == ENOSYS)
+            g_process_vm_rw_unsupported = true;
+        // Writes to read only pages fail with EFAULT, "/proc/<pid>/mem"
+        // can write those on kernels that allow writing it at all.
+    }
+#endif
+
+    int fd = OpenProcessMemFile(pid, O_WRONLY);
+    if (fd < 0)
+        return 0;
+    ssize_t bytes_written = ::pwrite(fd, buf, size, (off_t)vm_addr);
+    ::close(fd);
+    return bytes_written > 0 ? bytes_written : 0;
+}
+
 //------------------------------------------------------------------------------
 // Static implementations of ProcessMonitor::ReadMemory and
 // ProcessMonitor::WriteMemory.  This enables mutual recursion between these
@@ -336,6 +417,34 @@ public:
     virtual void Execute(ProcessMonitor *monitor) = 0;
 };
 
+//------------------------------------------------------------------------------
+/// @class BatchOperation
+/// @brief Runs several operations for a single trip to the monitor thread.
+///
+/// Each hand off to the monitor thread costs two context switches, which is
+/// far more than most ptrace calls take, so work that needs several
+/// operations should submit them together.
+class BatchOperation : public Operation
+{
+public:
+    BatchOperation(Operation **ops, size_t num_ops)
+        : m_ops(ops), m_num_ops(num_ops)
+        { }
+
+    void Execute(ProcessMonitor *monitor);
+
+private:
+    Operation **m_ops;
+    size_t m_num_ops;
+};
+
+void
+BatchOperation::Execute(ProcessMonitor *monitor)
+{
+    for (size_t i = 0; i < m_num_ops; ++i)
+        m_ops[i]->Execute(monitor);
+}
+
 //------------------------------------------------------------------------------
 /// @class ReadOperation
 /// @brief Implements ProcessMonitor::ReadMemory.
@@ -405,13 +514,15 @@ WriteOperation::Execute(ProcessMonitor *monitor)
 class ReadRegOperation : public Operation
 {
 public:
-    ReadRegOperation(unsigned offset, RegisterValue &value, bool &result)
-        : m_offset(offset), m_value(value), m_result(result)
+    ReadRegOperation(lldb::tid_t tid, unsigned offset, RegisterValue &value,
+                     bool &result)
+        : m_tid(tid), m_offset(offset), m_value(value), m_result(result)
         { }
 
     void Execute(ProcessMonitor *monitor);
 
 private:
+    lldb::tid_t m_tid;
     unsigned m_offset;
     RegisterValue &m_value;
     bool &m_result;
@@ -420,12 +531,11 @@ private:
 void
 ReadRegOperation::Execute(ProcessMonitor *monitor)
 {
-    lldb::pid_t pid = monitor->GetPID();
     LogSP log (ProcessPOSIXLog::GetLogIfAllCategoriesSet (POSIX_LOG_REGISTERS));
 
     // Set errno to zero so that we can detect a failed peek.
     errno = 0;
-    lldb::addr_t data = PTRACE(PTRACE_PEEKUSER, pid, (void*)m_offset, NULL);
+    lldb::addr_t data = PTRACE(PTRACE_PEEKUSER, m_tid, (void*)m_offset, NULL);
     if (data == -1UL && errno)
         m_result = false;
     else
@@ -444,13 +554,15 @@ ReadRegOperation::Execute(ProcessMonitor *monitor)
 class WriteRegOperation : public Operation
 {
 public:
-    WriteRegOperation(unsigned offset, const RegisterValue &value, bool &result)
-        : m_offset(offset), m_value(value), m_result(result)
+    WriteRegOperation(lldb::tid_t tid, unsigned offset,
+                      const RegisterValue &value, bool &result)
+        : m_tid(tid), m_offset(offset), m_value(value), m_result(result)
         { }
 
     void Execute(ProcessMonitor *monitor);
 
 private:
+    lldb::tid_t m_tid;
     unsigned m_offset;
     const RegisterValue &m_value;
     bool &m_result;
@@ -460,7 +572,6 @@ void
 WriteRegOperation::Execute(ProcessMonitor *monitor)
 {
     void* buf;
-    lldb::pid_t pid = monitor->GetPID();
     LogSP log (ProcessPOSIXLog::GetLogIfAllCategoriesSet (POSIX_LOG_REGISTERS));
 
     if (sizeof(void*) == sizeof(uint64_t))
@@ -474,7 +585,7 @@ WriteRegOperation::Execute(ProcessMonitor *monitor)
     if (log)
         log->Printf ("ProcessMonitor::%s() reg %s: %p", __FUNCTION__,
                      POSIXThread::GetRegisterNameFromOffset(m_offset), buf);
-    if (PTRACE(PTRACE_POKEUSER, pid, (void*)m_offset, buf))
+    if (PTRACE(PTRACE_POKEUSER, m_tid, (void*)m_offset, buf))
         m_result = false;
     else
         m_result = true;
@@ -486,13 +597,14 @@ WriteRegOperation::Execute(ProcessMonitor *monitor)
 class ReadGPROperation : public Operation
 {
 public:
-    ReadGPROperation(void *buf, bool &result)
-        : m_buf(buf), m_result(result)
+    ReadGPROperation(lldb::tid_t tid, void *buf, bool &result)
+        : m_tid(tid), m_buf(buf), m_result(result)
         { }
 
     void Execute(ProcessMonitor *monitor);
 
 private:
+    lldb::tid_t m_tid;
     void *m_buf;
     bool &m_result;
 };
@@ -500,7 +612,7 @@ private:
 void
 ReadGPROperation::Execute(ProcessMonitor *monitor)
 {
-    if (PTRACE(PTRACE_GETREGS, monitor->GetPID(), NULL, m_buf) < 0)
+    if (PTRACE(PTRACE_GETREGS, m_tid, NULL, m_buf) < 0)
         m_result = false;
     else
         m_result = true;
@@ -512,13 +624,14 @@ ReadGPROperation::Execute(ProcessMonitor *monitor)
 class ReadFPROperation : public Operation
 {
 public:
-    ReadFPROperation(void *buf, bool &result)
-        : m_buf(buf), m_result(result)
+    ReadFPROperation(lldb::tid_t tid, void *buf, bool &result)
+        : m_tid(tid), m_buf(buf), m_result(result)
         { }
 
     void Execute(ProcessMonitor *monitor);
 
 private:
+    lldb::tid_t m_tid;
     void *m_buf;
     bool &m_result;
 };
@@ -526,7 +639,7 @@ private:
 void
 ReadFPROperation::Execute(ProcessMonitor *monitor)
 {
-    if (PTRACE(PTRACE_GETFPREGS, monitor->GetPID(), NULL, m_buf) < 0)
+    if (PTRACE(PTRACE_GETFPREGS, m_tid, NULL, m_buf) < 0)
         m_result = false;
     else
         m_result = true;
@@ -538,13 +651,14 @@ ReadFPROperation::Execute(ProcessMonitor *monitor)
 class WriteGPROperation : public Operation
 {
 public:
-    WriteGPROperation(void *buf, bool &result)
-        : m_buf(buf), m_result(result)
+    WriteGPROperation(lldb::tid_t tid, void *buf, bool &result)
+        : m_tid(tid), m_buf(buf), m_result(result)
         { }
 
     void Execute(ProcessMonitor *monitor);
 
 private:
+    lldb::tid_t m_tid;
     void *m_buf;
     bool &m_result;
 };
@@ -552,7 +666,7 @@ private:
 void
 WriteGPROperation::Execute(ProcessMonitor *monitor)
 {
-    if (PTRACE(PTRACE_SETREGS, monitor->GetPID(), NULL, m_buf) < 0)
+    if (PTRACE(PTRACE_SETREGS, m_tid, NULL, m_buf) < 0)
         m_result = false;
     else
         m_result = true;
@@ -564,13 +678,14 @@ WriteGPROperation::Execute(ProcessMonitor *monitor)
 class WriteFPROperation : public Operation
 {
 public:
-    WriteFPROperation(void *buf, bool &result)
-        : m_buf(buf), m_result(result)
+    WriteFPROperation(lldb::tid_t tid, void *buf, bool &result)
+        : m_tid(tid), m_buf(buf), m_result(result)
         { }
 
     void Execute(ProcessMonitor *monitor);
 
 private:
+    lldb::tid_t m_tid;
     void *m_buf;
     bool &m_result;
 };
@@ -578,7 +693,7 @@ private:
 void
 WriteFPROperation::Execute(ProcessMonitor *monitor)
 {
-    if (PTRACE(PTRACE_SETFPREGS, monitor->GetPID(), NULL, m_buf) < 0)
+    if (PTRACE(PTRACE_SETFPREGS, m_tid, NULL, m_buf) < 0)
         m_result = false;
     else
         m_result = true;
@@ -729,11 +844,13 @@ KillOperation::Execute(ProcessMonitor *monitor)
 class DetachOperation : public Operation
 {
 public:
-    DetachOperation(Error &result) : m_error(result) { }
+    DetachOperation(const std::vector<lldb::tid_t> &tids, Error &result)
+        : m_tids(tids), m_error(result) { }
 
     void Execute(ProcessMonitor *monitor);
 
 private:
+    const std::vector<lldb::tid_t> &m_tids;
     Error &m_error;
 };
 
@@ -742,6 +859,14 @@ DetachOperation::Execute(ProcessMonitor *monitor)
 {
     lldb::pid_t pid = monitor->GetPID();
 
+    // Each thread is traced on its own.  Only failing to detach from the main
+    // thread is an error, the others may have exited by now.
+    for (size_t i = 0; i < m_tids.size(); ++i)
+    {
+        if (m_tids[i] != pid)
+            ptrace(PT_DETACH, m_tids[i], NULL, 0);
+    }
+
     if (ptrace(PT_DETACH, pid, NULL, 0) < 0)
         m_error.SetErrorToErrno();
   
@@ -786,10 +911,11 @@ ProcessMonitor::AttachArgs::~AttachArgs()
 //------------------------------------------------------------------------------
 /// The basic design of the ProcessMonitor is built around two threads.
 ///
-/// One thread (@see SignalThread) simply blocks on a call to waitpid() looking
-/// for changes in the debugee state.  When a change is detected a
-/// ProcessMessage is sent to the associated ProcessLinux instance.  This thread
-/// "drives" state changes in the debugger.
+/// One thread (@see MonitorThread) simply blocks on a call to waitpid() looking
+/// for changes in the state of any of the debugee's threads.  When a thread
+/// stops, the others are stopped too, and a ProcessMessage for every thread
+/// with something to report is sent to the associated ProcessLinux instance in
+/// one go.  This thread "drives" state changes in the debugger.
 ///
 /// The second thread (@see OperationThread) is responsible for two things 1)
 /// launching or attaching to the inferior process, and then 2) servicing
@@ -849,8 +975,8 @@ WAIT_AGAIN:
     }
 
     // Finally, start monitoring the child process for change in state.
-    m_monitor_thread = Host::StartMonitoringChildProcess(
-        ProcessMonitor::MonitorCallback, this, GetPID(), true);
+    m_monitor_thread = Host::ThreadCreate(
+        "lldb.process.linux.monitor", MonitorThread, this, NULL);
     if (!IS_VALID_LLDB_HOST_THREAD(m_monitor_thread))
     {
         error.SetErrorToGenericError();
@@ -907,8 +1033,8 @@ WAIT_AGAIN:
     }
 
     // Finally, start monitoring the child process for change in state.
-    m_monitor_thread = Host::StartMonitoringChildProcess(
-        ProcessMonitor::MonitorCallback, this, GetPID(), true);
+    m_monitor_thread = Host::ThreadCreate(
+        "lldb.process.linux.monitor", MonitorThread, this, NULL);
     if (!IS_VALID_LLDB_HOST_THREAD(m_monitor_thread))
     {
         error.SetErrorToGenericError();
@@ -967,7 +1093,6 @@ ProcessMonitor::Launch(LaunchArgs *args)
 {
     ProcessMonitor *monitor = args->m_monitor;
     ProcessLinux &process = monitor->GetProcess();
-    lldb::ProcessSP processSP = process.shared_from_this();
     const char **argv = args->m_argv;
     const char **envp = args->m_envp;
     const char *stdin_path = args->m_stdin_path;
@@ -979,9 +1104,6 @@ ProcessMonitor::Launch(LaunchArgs *args)
     char err_str[err_len];
     lldb::pid_t pid;
 
-    lldb::ThreadSP inferior;
-    LogSP log (ProcessPOSIXLog::GetLogIfAllCategoriesSet (POSIX_LOG_PROCESS));
-
     // Propagate the environment if one is not supplied.
     if (envp == NULL || envp[0] == NULL)
         envp = const_cast<const char **>(environ);
@@ -1085,8 +1207,10 @@ ProcessMonitor::Launch(LaunchArgs *args)
            "Could not sync with inferior process.");
 
     // Have the child raise an event on exit.  This is used to keep the child in
-    // limbo until it is destroyed.
-    if (PTRACE(PTRACE_SETOPTIONS, pid, NULL, (void*)PTRACE_O_TRACEEXIT) < 0)
+    // limbo until it is destroyed.  Also trace the threads it starts, the
+    // options are inherited by each of them.
+    if (PTRACE(PTRACE_SETOPTIONS, pid, NULL,
+               (void*)(PTRACE_O_TRACEEXIT | PTRACE_O_TRACECLONE)) < 0)
     {
         args->m_error.SetErrorToErrno();
         goto FINISH;
@@ -1103,13 +1227,9 @@ ProcessMonitor::Launch(LaunchArgs *args)
     if (!EnsureFDFlags(monitor->m_terminal_fd, O_NONBLOCK, args->m_error))
         goto FINISH;
 
-    // Update the process thread list with this new thread.
-    // FIXME: should we be letting UpdateThreadList handle this?
-    // FIXME: by using pids instead of tids, we can only support one thread.
-    inferior.reset(new POSIXThread(processSP, pid));
-    if (log)
-        log->Printf ("ProcessMonitor::%s() adding pid = %i", __FUNCTION__, pid);
-    process.GetThreadList().AddThread(inferior);
+    // Update the process thread list with the main thread.  The threads it
+    // starts are added as their clone events come in.
+    monitor->AddThread(pid);
 
     // Let our process instance know the thread has stopped.
     process.SendMessage(ProcessMessage::Trace(pid));
@@ -1168,9 +1288,6 @@ ProcessMonitor::Attach(AttachArgs *args)
 
     ProcessMonitor *monitor = args->m_monitor;
     ProcessLinux &process = monitor->GetProcess();
-    lldb::ProcessSP processSP = process.shared_from_this();
-    lldb::ThreadSP inferior;
-    LogSP log (ProcessPOSIXLog::GetLogIfAllCategoriesSet (POSIX_LOG_PROCESS));
 
     if (pid <= 1)
     {
@@ -1187,17 +1304,26 @@ ProcessMonitor::Attach(AttachArgs *args)
     }
 
     int status;
-    if ((status = waitpid(pid, NULL, 0)) < 0)
+    if ((status = waitpid(pid, NULL, __WALL)) < 0)
     {
         args->m_error.SetErrorToErrno();
         goto FINISH;
     }
 
-    // Update the process thread list with the attached thread.
-    inferior.reset(new POSIXThread(processSP, pid));
-    if (log)
-        log->Printf ("ProcessMonitor::%s() adding tid = %i", __FUNCTION__, pid);
-    process.GetThreadList().AddThread(inferior);
+    if (PTRACE(PTRACE_SETOPTIONS, pid, NULL,
+               (void*)(PTRACE_O_TRACEEXIT | PTRACE_O_TRACECLONE)) < 0)
+    {
+        args->m_error.SetErrorToErrno();
+        goto FINISH;
+    }
+
+    monitor->m_pid = pid;
+
+    // Update the process thread list with the attached thread and the other
+    // threads the process already has.
+    monitor->AddThread(pid);
+    if (!AttachThreads(monitor, pid, args->m_error))
+        goto FINISH;
 
     // Let our process instance know the thread has stopped.
     process.SendMessage(ProcessMessage::Trace(pid));
@@ -1206,6 +1332,152 @@ ProcessMonitor::Attach(AttachArgs *args)
     return args->m_error.Success();
 }
 
+bool
+ProcessMonitor::AttachThreads(ProcessMonitor *monitor, lldb::pid_t pid,
+                              Error &error)
+{
+    char task_path[PATH_MAX];
+    ::snprintf(task_path, sizeof(task_path), "/proc/%i/task", pid);
+
+    // Threads can be started while we attach to the others, so keep going
+    // until a pass over the task directory finds nothing new.  The ones
+    // started after their parent was attached are traced automatically.
+    bool found_new_thread = true;
+    while (found_new_thread)
+    {
+        found_new_thread = false;
+
+        DIR *task_dir = ::opendir(task_path);
+        if (task_dir == NULL)
+        {
+            error.SetErrorToErrno();
+            return false;
+        }
+
+        struct dirent *entry;
+        while ((entry = ::readdir(task_dir)) != NULL)
+        {
+            const lldb::tid_t tid = ::strtoul(entry->d_name, NULL, 10);
+            if (tid == 0 || monitor->IsTracedThread(tid))
+                continue;
+
+            // The thread may have exited in the meantime.
+            if (PTRACE(PTRACE_ATTACH, tid, NULL, NULL) < 0)
+                continue;
+
+            int status;
+            if (waitpid(tid, &status, __WALL) < 0)
+                continue;
+
+            PTRACE(PTRACE_SETOPTIONS, tid, NULL,
+                   (void*)(PTRACE_O_TRACEEXIT | PTRACE_O_TRACECLONE));
+            monitor->AddThread(tid);
+            found_new_thread = true;
+        }
+        ::closedir(task_dir);
+    }
+    return true;
+}
+
+void
+ProcessMonitor::AddThread(lldb::tid_t tid)
+{
+    LogSP log (ProcessPOSIXLog::GetLogIfAllCategoriesSet (POSIX_LOG_THREAD));
+    if (log)
+        log->Printf ("ProcessMonitor::%s() adding tid = %i", __FUNCTION__, tid);
+
+    {
+        Mutex::Locker locker(m_threads_mutex);
+        m_tids.insert(tid);
+    }
+
+    lldb::ProcessSP processSP = m_process->shared_from_this();
+    lldb::ThreadSP thread_sp(new POSIXThread(processSP, tid));
+    m_process->GetThreadList().AddThread(thread_sp);
+}
+
+void
+ProcessMonitor::RemoveThread(lldb::tid_t tid)
+{
+    LogSP log (ProcessPOSIXLog::GetLogIfAllCategoriesSet (POSIX_LOG_THREAD));
+    if (log)
+        log->Printf ("ProcessMonitor::%s() removing tid = %i", __FUNCTION__, tid);
+
+    {
+        Mutex::Locker locker(m_threads_mutex);
+        m_tids.erase(tid);
+        m_running_tids.erase(tid);
+        m_stepping_tids.erase(tid);
+    }
+
+    m_process->GetThreadList().RemoveThreadByID(tid);
+}
+
+bool
+ProcessMonitor::IsTracedThread(lldb::tid_t tid)
+{
+    Mutex::Locker locker(m_threads_mutex);
+    return m_tids.find(tid) != m_tids.end();
+}
+
+void *
+ProcessMonitor::MonitorThread(void *arg)
+{
+    ProcessMonitor *monitor = static_cast<ProcessMonitor*>(arg);
+    LogSP log (ProcessPOSIXLog::GetLogIfAllCategoriesSet (POSIX_LOG_PROCESS));
+
+    // Wait on the inferior's process group rather than on its pid so the
+    // events of all of its threads come here.  The threads are "clone"
+    // children as far as waitpid is concerned, hence __WALL.  A launched
+    // inferior is the leader of its own group.
+    const lldb::pid_t pgid = ::getpgid(monitor->GetPID());
+
+    for (;;)
+    {
+        int status;
+        const lldb::pid_t wait_pid = ::waitpid(-pgid, &status, __WALL);
+        if (wait_pid < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+
+        bool exited = false;
+        int signal = 0;
+        int exit_status = 0;
+        if (WIFSTOPPED(status))
+            signal = WSTOPSIG(status);
+        else if (WIFEXITED(status))
+        {
+            exit_status = WEXITSTATUS(status);
+            exited = true;
+        }
+        else if (WIFSIGNALED(status))
+        {
+            signal = WTERMSIG(status);
+            exit_status = -1;
+            exited = true;
+        }
+
+        if (log)
+            log->Printf ("ProcessMonitor::%s() waitpid => tid = %i, status = 0x%8.8x",
+                         __FUNCTION__, wait_pid, status);
+
+        // Don't let the thread be cancelled while it is half way through
+        // stopping the other threads.
+        int old_cancel_state;
+        ::pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, &old_cancel_state);
+        const bool stop_monitoring =
+            MonitorCallback(monitor, wait_pid, exited, signal, exit_status);
+        ::pthread_setcancelstate(old_cancel_state, NULL);
+
+        if (stop_monitoring)
+            break;
+    }
+    return NULL;
+}
+
 bool
 ProcessMonitor::MonitorCallback(void *callback_baton,
                                 lldb::pid_t pid,
@@ -1213,32 +1485,184 @@ ProcessMonitor::MonitorCallback(void *callback_baton,
                                 int signal,
                                 int status)
 {
-    ProcessMessage message;
     ProcessMonitor *monitor = static_cast<ProcessMonitor*>(callback_baton);
     ProcessLinux *process = monitor->m_process;
     assert(process);
-    bool stop_monitoring;
     siginfo_t info;
 
+    {
+        Mutex::Locker locker(monitor->m_threads_mutex);
+        monitor->m_running_tids.erase(pid);
+    }
+
+    // Threads other than the main one come and go while the process runs.
+    if (exited && pid != monitor->GetPID())
+    {
+        monitor->RemoveThread(pid);
+        return false;
+    }
+
     if (!monitor->GetSignalInfo(pid, &info))
-        stop_monitoring = true; // pid is gone.  Bail.
-    else {
-        switch (info.si_signo)
+        return pid == monitor->GetPID(); // pid is gone.  Bail.
+
+    lldb::tid_t new_tid;
+    ProcessMessage message = monitor->GetStopMessage(pid, &info, new_tid);
+    if (message.GetKind() == ProcessMessage::eInvalidMessage)
+    {
+        // Nothing to report, so keep the thread going along with any thread
+        // it just started.
+        if (monitor->IsTracedThread(pid))
         {
-        case SIGTRAP:
-            message = MonitorSIGTRAP(monitor, &info, pid);
-            break;
-            
-        default:
-            message = MonitorSignal(monitor, &info, pid);
-            break;
+            bool stepping;
+            {
+                Mutex::Locker locker(monitor->m_threads_mutex);
+                stepping = monitor->m_stepping_tids.count(pid) > 0;
+            }
+            if (stepping)
+                monitor->SingleStep(pid, LLDB_INVALID_SIGNAL_NUMBER);
+            else
+                monitor->Resume(pid, LLDB_INVALID_SIGNAL_NUMBER);
         }
+        if (new_tid != LLDB_INVALID_THREAD_ID)
+            monitor->Resume(new_tid, LLDB_INVALID_SIGNAL_NUMBER);
+        return false;
+    }
+
+    // Halt the rest of the threads and report whatever happened to them
+    // along with this stop, so the process only stops once.
+    std::vector<ProcessMessage> messages;
+    messages.push_back(message);
+    monitor->StopAllThreads(pid, messages);
+    process->SendMessages(&messages[0], messages.size());
+
+    return message.GetKind() == ProcessMessage::eExitMessage;
+}
+
+ProcessMessage
+ProcessMonitor::GetStopMessage(lldb::tid_t tid, const siginfo_t *info,
+                               lldb::tid_t &new_tid)
+{
+    new_tid = LLDB_INVALID_THREAD_ID;
 
-        process->SendMessage(message);
-        stop_monitoring = message.GetKind() == ProcessMessage::eExitMessage;
+    {
+        Mutex::Locker locker(m_threads_mutex);
+
+        // A new thread can report its first stop before the clone event of
+        // the thread that started it.  MonitorClone picks it up from here.
+        if (m_tids.find(tid) == m_tids.end())
+        {
+            m_new_tids.insert(tid);
+            return ProcessMessage();
+        }
     }
 
-    return stop_monitoring;
+    // The SIGSTOPs sent by StopAllThreads.  One can still be on its way
+    // after the thread stopped for another reason and was resumed.
+    if (info->si_signo == SIGSTOP && info->si_code == SI_TKILL &&
+        info->si_pid == getpid())
+        return ProcessMessage();
+
+    if (info->si_signo != SIGTRAP)
+        return MonitorSignal(this, info, tid);
+
+    switch (info->si_code)
+    {
+    case (SIGTRAP | (PTRACE_EVENT_CLONE << 8)):
+        new_tid = MonitorClone(tid);
+        return ProcessMessage();
+
+    case (SIGTRAP | (PTRACE_EVENT_EXIT << 8)):
+        // Only the exit of the main thread keeps the process in limbo.
+        if (tid != GetPID())
+            return ProcessMessage();
+        break;
+    }
+    return MonitorSIGTRAP(this, info, tid);
+}
+
+void
+ProcessMonitor::StopAllThreads(lldb::tid_t tid,
+                               std::vector<ProcessMessage> &messages)
+{
+    std::vector<lldb::tid_t> tids;
+    {
+        Mutex::Locker locker(m_threads_mutex);
+        std::set<lldb::tid_t>::const_iterator pos, end = m_running_tids.end();
+        for (pos = m_running_tids.begin(); pos != end; ++pos)
+        {
+            if (*pos != tid)
+                tids.push_back(*pos);
+        }
+    }
+
+    const size_t num_tids = tids.size();
+    for (size_t i = 0; i < num_tids; ++i)
+        ::syscall(__NR_tgkill, m_pid, tids[i], SIGSTOP);
+
+    for (size_t i = 0; i < num_tids; ++i)
+    {
+        int status;
+        lldb::pid_t wait_pid;
+        do
+            wait_pid = ::waitpid(tids[i], &status, __WALL);
+        while (wait_pid < 0 && errno == EINTR);
+
+        {
+            Mutex::Locker locker(m_threads_mutex);
+            m_running_tids.erase(tids[i]);
+        }
+
+        if (wait_pid < 0)
+            continue;
+
+        if (WIFEXITED(status) || WIFSIGNALED(status))
+        {
+            if (tids[i] != m_pid)
+                RemoveThread(tids[i]);
+            continue;
+        }
+
+        siginfo_t info;
+        if (!GetSignalInfo(tids[i], &info))
+            continue;
+
+        // If the thread stopped for a reason of its own before our SIGSTOP
+        // got to it, the SIGSTOP is ignored once it is resumed.
+        lldb::tid_t new_tid;
+        ProcessMessage message = GetStopMessage(tids[i], &info, new_tid);
+        if (message.GetKind() != ProcessMessage::eInvalidMessage)
+            messages.push_back(message);
+    }
+}
+
+lldb::tid_t
+ProcessMonitor::MonitorClone(lldb::tid_t tid)
+{
+    unsigned long data = 0;
+    if (!GetEventMessage(tid, &data))
+        return LLDB_INVALID_THREAD_ID;
+
+    const lldb::tid_t new_tid = data;
+    bool already_stopped;
+    {
+        Mutex::Locker locker(m_threads_mutex);
+        already_stopped = m_new_tids.erase(new_tid) > 0;
+    }
+
+    // The new thread starts out with a SIGSTOP.  Wait for it so the thread is
+    // known to be stopped when it is added.
+    if (!already_stopped)
+    {
+        int status;
+        while (::waitpid(new_tid, &status, __WALL) < 0)
+        {
+            if (errno != EINTR)
+                return LLDB_INVALID_THREAD_ID;
+        }
+    }
+
+    AddThread(new_tid);
+    return new_tid;
 }
 
 ProcessMessage
@@ -1546,95 +1970,185 @@ READ_AGAIN:
     assert(ack == op && "Invalid monitor thread response!");
 }
 
+void
+ProcessMonitor::DoOperations(Operation **ops, size_t num_ops)
+{
+    if (num_ops == 0)
+        return;
+    if (num_ops == 1)
+    {
+        DoOperation(ops[0]);
+        return;
+    }
+    BatchOperation op(ops, num_ops);
+    DoOperation(&op);
+}
+
 size_t
 ProcessMonitor::ReadMemory(lldb::addr_t vm_addr, void *buf, size_t size,
                            Error &error)
 {
+    // Try to read everything at once without going through the monitor
+    // thread, and only use ptrace for whatever couldn't be read.
+    const size_t bulk_bytes_read = DoReadMemoryBulk(m_pid, vm_addr, buf, size);
+    if (bulk_bytes_read >= size)
+        return size;
+
     size_t result;
-    ReadOperation op(vm_addr, buf, size, error, result);
+    ReadOperation op(vm_addr + bulk_bytes_read,
+                     static_cast<uint8_t *>(buf) + bulk_bytes_read,
+                     size - bulk_bytes_read, error, result);
     DoOperation(&op);
-    return result;
+    return bulk_bytes_read + result;
 }
 
 size_t
 ProcessMonitor::WriteMemory(lldb::addr_t vm_addr, const void *buf, size_t size,
                             lldb_private::Error &error)
 {
+    const size_t bulk_bytes_written = DoWriteMemoryBulk(m_pid, vm_addr, buf, size);
+    if (bulk_bytes_written >= size)
+        return size;
+
     size_t result;
-    WriteOperation op(vm_addr, buf, size, error, result);
+    WriteOperation op(vm_addr + bulk_bytes_written,
+                      static_cast<const uint8_t *>(buf) + bulk_bytes_written,
+                      size - bulk_bytes_written, error, result);
     DoOperation(&op);
-    return result;
+    return bulk_bytes_written + result;
 }
 
 bool
-ProcessMonitor::ReadRegisterValue(unsigned offset, unsigned size, RegisterValue &value)
+ProcessMonitor::ReadRegisterValue(lldb::tid_t tid, unsigned offset,
+                                  unsigned size, RegisterValue &value)
 {
     bool result;
-    ReadRegOperation op(offset, value, result);
+    ReadRegOperation op(tid, offset, value, result);
     DoOperation(&op);
     return result;
 }
 
 bool
-ProcessMonitor::WriteRegisterValue(unsigned offset, const RegisterValue &value)
+ProcessMonitor::WriteRegisterValue(lldb::tid_t tid, unsigned offset,
+                                   const RegisterValue &value)
 {
     bool result;
-    WriteRegOperation op(offset, value, result);
+    WriteRegOperation op(tid, offset, value, result);
     DoOperation(&op);
     return result;
 }
 
 bool
-ProcessMonitor::ReadGPR(void *buf)
+ProcessMonitor::ReadGPR(lldb::tid_t tid, void *buf)
 {
     bool result;
-    ReadGPROperation op(buf, result);
+    ReadGPROperation op(tid, buf, result);
     DoOperation(&op);
     return result;
 }
 
 bool
-ProcessMonitor::ReadFPR(void *buf)
+ProcessMonitor::ReadFPR(lldb::tid_t tid, void *buf)
 {
     bool result;
-    ReadFPROperation op(buf, result);
+    ReadFPROperation op(tid, buf, result);
     DoOperation(&op);
     return result;
 }
 
 bool
-ProcessMonitor::WriteGPR(void *buf)
+ProcessMonitor::WriteGPR(lldb::tid_t tid, void *buf)
 {
     bool result;
-    WriteGPROperation op(buf, result);
+    WriteGPROperation op(tid, buf, result);
     DoOperation(&op);
     return result;
 }
 
 bool
-ProcessMonitor::WriteFPR(void *buf)
+ProcessMonitor::WriteFPR(lldb::tid_t tid, void *buf)
 {
     bool result;
-    WriteFPROperation op(buf, result);
+    WriteFPROperation op(tid, buf, result);
     DoOperation(&op);
     return result;
 }
 
+bool
+ProcessMonitor::ReadRegisterSets(lldb::tid_t tid, void *gpr_buf, void *fpr_buf)
+{
+    bool gpr_result = true;
+    bool fpr_result = true;
+    ReadGPROperation gpr_op(tid, gpr_buf, gpr_result);
+    ReadFPROperation fpr_op(tid, fpr_buf, fpr_result);
+    Operation *ops[2];
+    size_t num_ops = 0;
+    if (gpr_buf)
+        ops[num_ops++] = &gpr_op;
+    if (fpr_buf)
+        ops[num_ops++] = &fpr_op;
+    DoOperations(ops, num_ops);
+    return gpr_result && fpr_result;
+}
+
+bool
+ProcessMonitor::WriteRegisterSets(lldb::tid_t tid, void *gpr_buf, void *fpr_buf)
+{
+    bool gpr_result = true;
+    bool fpr_result = true;
+    WriteGPROperation gpr_op(tid, gpr_buf, gpr_result);
+    WriteFPROperation fpr_op(tid, fpr_buf, fpr_result);
+    Operation *ops[2];
+    size_t num_ops = 0;
+    if (gpr_buf)
+        ops[num_ops++] = &gpr_op;
+    if (fpr_buf)
+        ops[num_ops++] = &fpr_op;
+    DoOperations(ops, num_ops);
+    return gpr_result && fpr_result;
+}
+
 bool
 ProcessMonitor::Resume(lldb::tid_t tid, uint32_t signo)
 {
+    // Mark the thread as running before it runs, the monitor thread can see
+    // it stop again before DoOperation returns.
+    {
+        Mutex::Locker locker(m_threads_mutex);
+        m_running_tids.insert(tid);
+        m_stepping_tids.erase(tid);
+    }
+
     bool result;
     ResumeOperation op(tid, signo, result);
     DoOperation(&op);
+
+    if (!result)
+    {
+        Mutex::Locker locker(m_threads_mutex);
+        m_running_tids.erase(tid);
+    }
     return result;
 }
 
 bool
 ProcessMonitor::SingleStep(lldb::tid_t tid, uint32_t signo)
 {
+    {
+        Mutex::Locker locker(m_threads_mutex);
+        m_running_tids.insert(tid);
+        m_stepping_tids.insert(tid);
+    }
+
     bool result;
     SingleStepOperation op(tid, signo, result);
     DoOperation(&op);
+
+    if (!result)
+    {
+        Mutex::Locker locker(m_threads_mutex);
+        m_running_tids.erase(tid);
+    }
     return result;
 }
 
@@ -1670,7 +2184,12 @@ ProcessMonitor::Detach()
 {
     bool result;
     lldb_private::Error error;
-    DetachOperation op(error);
+    std::vector<lldb::tid_t> tids;
+    {
+        Mutex::Locker locker(m_threads_mutex);
+        tids.assign(m_tids.begin(), m_tids.end());
+    }
+    DetachOperation op(tids, error);
     result = error.Success();
     DoOperation(&op);
     StopMonitor();
@@ -15,6 +15,9 @@
 #include <signal.h>
 
 // C++ Includes
+#include <set>
+#include <vector>
+
 // Other libraries and framework includes
 #include "lldb/lldb-types.h"
 #include "lldb/Host/Mutex.h"
@@ -101,35 +104,51 @@ public:
     WriteMemory(lldb::addr_t vm_addr, const void *buf, size_t size,
                 lldb_private::Error &error);
 
-    /// Reads the contents from the register identified by the given (architecture
-    /// dependent) offset.
+    /// Reads the contents from the register of thread @p tid identified by the
+    /// given (architecture dependent) offset.
     ///
     /// This method is provided for use by RegisterContextLinux derivatives.
     bool
-    ReadRegisterValue(unsigned offset, unsigned size, lldb_private::RegisterValue &value);
+    ReadRegisterValue(lldb::tid_t tid, unsigned offset, unsigned size,
+                      lldb_private::RegisterValue &value);
 
-    /// Writes the given value to the register identified by the given
-    /// (architecture dependent) offset.
+    /// Writes the given value to the register of thread @p tid identified by
+    /// the given (architecture dependent) offset.
     ///
     /// This method is provided for use by RegisterContextLinux derivatives.
     bool
-    WriteRegisterValue(unsigned offset, const lldb_private::RegisterValue &value);
+    WriteRegisterValue(lldb::tid_t tid, unsigned offset,
+                       const lldb_private::RegisterValue &value);
 
-    /// Reads all general purpose registers into the specified buffer.
+    /// Reads all general purpose registers of thread @p tid into the specified
+    /// buffer.
     bool
-    ReadGPR(void *buf);
+    ReadGPR(lldb::tid_t tid, void *buf);
 
-    /// Reads all floating point registers into the specified buffer.
+    /// Reads all floating point registers of thread @p tid into the specified
+    /// buffer.
     bool
-    ReadFPR(void *buf);
+    ReadFPR(lldb::tid_t tid, void *buf);
 
     /// Writes all general purpose registers into the specified buffer.
     bool
-    WriteGPR(void *buf);
+    WriteGPR(lldb::tid_t tid, void *buf);
 
     /// Writes all floating point registers into the specified buffer.
     bool
-    WriteFPR(void *buf);
+    WriteFPR(lldb::tid_t tid, void *buf);
+
+    /// Reads the general purpose and floating point registers into the
+    /// specified buffers with a single trip to the monitor thread.  Either
+    /// buffer may be NULL to skip that set.
+    bool
+    ReadRegisterSets(lldb::tid_t tid, void *gpr_buf, void *fpr_buf);
+
+    /// Writes the general purpose and floating point registers from the
+    /// specified buffers with a single trip to the monitor thread.  Either
+    /// buffer may be NULL to skip that set.
+    bool
+    WriteRegisterSets(lldb::tid_t tid, void *gpr_buf, void *fpr_buf);
 
     /// Writes a siginfo_t structure corresponding to the given thread ID to the
     /// memory region pointed to by @p siginfo.
@@ -171,6 +190,12 @@ private:
 
     lldb::thread_t m_monitor_thread;
 
+    lldb_private::Mutex m_threads_mutex;    // Protects the thread ID sets below.
+    std::set<lldb::tid_t> m_tids;           // Threads of the inferior being traced.
+    std::set<lldb::tid_t> m_running_tids;   // Traced threads that were resumed and have not stopped since.
+    std::set<lldb::tid_t> m_stepping_tids;  // Traced threads whose last resume was a single step.
+    std::set<lldb::tid_t> m_new_tids;       // Threads whose first stop came before the clone event that made them.
+
     lldb_private::Mutex m_server_mutex;
     int m_client_fd;
     int m_server_fd;
@@ -253,10 +278,52 @@ private:
     static bool
     DupDescriptor(const char *path, int fd, int flags);
 
+    /// Waits for events from every thread of the inferior and hands them to
+    /// MonitorCallback.
+    static void *
+    MonitorThread(void *arg);
+
     static bool
     MonitorCallback(void *callback_baton,
                     lldb::pid_t pid, bool exited, int signal, int status);
 
+    /// Works out what the stop of thread @p tid described by @p info means to
+    /// the process.  Stops that only matter to the monitor (new threads, the
+    /// exit of threads other than the main one, and the SIGSTOPs sent by
+    /// StopAllThreads) are handled here and yield an invalid message.  If the
+    /// stop was a clone event, @p new_tid is set to the new thread, which is
+    /// left stopped.
+    ProcessMessage
+    GetStopMessage(lldb::tid_t tid, const siginfo_t *info, lldb::tid_t &new_tid);
+
+    /// Stops every traced thread that is still running after @p tid stopped,
+    /// and appends a message for each one that had an event of its own to
+    /// @p messages.  All the threads are signalled before any of their stops
+    /// are collected so they halt in parallel.
+    void
+    StopAllThreads(lldb::tid_t tid, std::vector<ProcessMessage> &messages);
+
+    /// Handles a PTRACE_EVENT_CLONE stop of thread @p tid.  Returns the ID of
+    /// the new thread, which is traced and stopped, or LLDB_INVALID_THREAD_ID.
+    lldb::tid_t
+    MonitorClone(lldb::tid_t tid);
+
+    /// Attaches to all the threads of process @p pid that are not traced yet.
+    static bool
+    AttachThreads(ProcessMonitor *monitor, lldb::pid_t pid,
+                  lldb_private::Error &error);
+
+    /// Records thread @p tid as traced and adds it to the process thread list.
+    void
+    AddThread(lldb::tid_t tid);
+
+    /// Forgets thread @p tid, which has exited.
+    void
+    RemoveThread(lldb::tid_t tid);
+
+    bool
+    IsTracedThread(lldb::tid_t tid);
+
     static ProcessMessage
     MonitorSIGTRAP(ProcessMonitor *monitor,
                    const siginfo_t *info, lldb::pid_t pid);
@@ -280,6 +347,11 @@ private:
     void
     DoOperation(Operation *op);
 
+    /// Runs all of @p ops on the monitor thread for the price of one
+    /// DoOperation call.
+    void
+    DoOperations(Operation **ops, size_t num_ops);
+
     /// Stops the child monitor thread.
     void
     StopMonitoringChildProcess();
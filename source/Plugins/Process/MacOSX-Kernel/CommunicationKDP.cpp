@@ -15,6 +15,9 @@
 #include <string.h>
 
 // C++ Includes
+#include <algorithm>
+#include <map>
+#include <vector>
 #include "llvm/Support/MachO.h"
 
 // Other libraries and framework includes
@@ -48,6 +51,7 @@ CommunicationKDP::CommunicationKDP (const char *comm_name) :
     m_exception_sequence_id (0u),
     m_kdp_version_version (0u),
     m_kdp_version_feature (0u),
+    m_kdp_max_bytes (0u),
     m_kdp_hostinfo_cpu_mask (0u),
     m_kdp_hostinfo_cpu_type (0u),
     m_kdp_hostinfo_cpu_subtype (0u)
@@ -103,16 +107,18 @@ CommunicationKDP::SendRequestAndGetReply (const CommandType command,
     Mutex::Locker locker(m_sequence_mutex);    
     if (SendRequestPacketNoLock(request_packet))
     {
-        if (WaitForPacketWithTimeoutMicroSecondsNoLock (reply_packet, GetPacketTimeoutInMicroSeconds ()))
+        // A request we sent again after it timed out can still get its
+        // first reply late, so skip any replies to other requests.
+        while (WaitForPacketWithTimeoutMicroSecondsNoLock (reply_packet, GetPacketTimeoutInMicroSeconds ()))
         {
             uint32_t offset = 0;
             const uint8_t reply_command = reply_packet.GetU8 (&offset);
             const uint8_t reply_sequence_id = reply_packet.GetU8 (&offset);
+            if (request_sequence_id != reply_sequence_id)
+                continue;
             if ((reply_command & eCommandTypeMask) == command)
-            {
-                if (request_sequence_id == reply_sequence_id)
-                    return true;
-            }
+                return true;
+            break;
         }
     }
     reply_packet.Clear();
@@ -173,7 +179,7 @@ CommunicationKDP::WaitForPacketWithTimeoutMicroSeconds (DataExtractor &packet, u
 size_t
 CommunicationKDP::WaitForPacketWithTimeoutMicroSecondsNoLock (DataExtractor &packet, uint32_t timeout_usec)
 {
-    uint8_t buffer[8192];
+    uint8_t buffer[kMaxReplyPacketSize];
     Error error;
 
     LogSP log (ProcessKDPLog::GetLogIfAllCategoriesSet (KDP_LOG_PACKETS | KDP_LOG_VERBOSE));
@@ -349,6 +355,7 @@ CommunicationKDP::ClearKDPSettings ()
     m_request_sequence_id = 0;
     m_kdp_version_version = 0;
     m_kdp_version_feature = 0;
+    m_kdp_max_bytes = 0;
     m_kdp_hostinfo_cpu_mask = 0;
     m_kdp_hostinfo_cpu_type = 0;
     m_kdp_hostinfo_cpu_subtype = 0;
@@ -414,6 +421,41 @@ CommunicationKDP::SendRequestVersion ()
     return false;
 }
 
+uint32_t
+CommunicationKDP::GetMaxBytes ()
+{
+    if (m_kdp_max_bytes == 0)
+    {
+        // Older servers may not answer, use the data size every server
+        // supports so we don't keep asking.
+        if (!SendRequestMaxBytes() || m_kdp_max_bytes == 0)
+            m_kdp_max_bytes = kMaxDataSize;
+        // The reply, including its 12 byte header, has to fit in our
+        // read buffer
+        if (m_kdp_max_bytes > kMaxReplyPacketSize - 12)
+            m_kdp_max_bytes = kMaxReplyPacketSize - 12;
+    }
+    return m_kdp_max_bytes;
+}
+
+bool
+CommunicationKDP::SendRequestMaxBytes ()
+{
+    PacketStreamType request_packet (Stream::eBinary, m_addr_byte_size, m_byte_order);
+    const CommandType command = KDP_MAXBYTES;
+    const uint32_t command_length = 8;
+    const uint32_t request_sequence_id = m_request_sequence_id;
+    MakeRequestPacketHeader (command, request_packet, command_length);
+    DataExtractor reply_packet;
+    if (SendRequestAndGetReply (command, request_sequence_id, request_packet, reply_packet))
+    {
+        uint32_t offset = 8;
+        m_kdp_max_bytes = reply_packet.GetU32 (&offset);
+        return true;
+    }
+    return false;
+}
+
 #if 0 // Disable KDP_IMAGEPATH for now, it seems to hang the KDP connection...
 const char *
 CommunicationKDP::GetImagePath ()
@@ -539,45 +581,200 @@ CommunicationKDP::SendRequestDisconnect ()
     return true;
 }
 
-uint32_t
-CommunicationKDP::SendRequestReadMemory (lldb::addr_t addr, 
-                                         void *dst, 
-                                         uint32_t dst_len,
-                                         Error &error)
+CommunicationKDP::CommandType
+CommunicationKDP::MakeReadMemoryRequestPacket (lldb::addr_t addr,
+                                               uint32_t size,
+                                               uint8_t request_sequence_id,
+                                               PacketStreamType &request_packet)
 {
-    PacketStreamType request_packet (Stream::eBinary, m_addr_byte_size, m_byte_order);
     bool use_64 = (GetVersion() >= 11);
     uint32_t command_addr_byte_size = use_64 ? 8 : 4;
     const CommandType command = use_64 ? KDP_READMEM64 : KDP_READMEM;
     // Size is header + address size + uint32_t length
     const uint32_t command_length = 8 + command_addr_byte_size + 4;
-    const uint32_t request_sequence_id = m_request_sequence_id;
-    MakeRequestPacketHeader (command, request_packet, command_length);
+    // Requests that are sent again after a timeout must keep their
+    // sequence ID, so don't use MakeRequestPacketHeader() here
+    request_packet.Clear();
+    request_packet.PutHex8 (command | ePacketTypeRequest);
+    request_packet.PutHex8 (request_sequence_id);
+    request_packet.PutHex16 (command_length);
+    request_packet.PutHex32 (m_session_key);
     request_packet.PutMaxHex64 (addr, command_addr_byte_size);
-    request_packet.PutHex32 (dst_len);
+    request_packet.PutHex32 (size);
+    return command;
+}
+
+uint32_t
+CommunicationKDP::ReadMemoryReply (const DataExtractor &reply_packet,
+                                   void *dst,
+                                   uint32_t dst_len,
+                                   Error &error)
+{
+    uint32_t offset = 8;
+    uint32_t kdp_error = reply_packet.GetU32 (&offset);
+    uint32_t src_len = reply_packet.GetByteSize() > 12 ? reply_packet.GetByteSize() - 12 : 0;
+    if (src_len > dst_len)
+        src_len = dst_len;
+    
+    if (src_len > 0)
+    {
+        const void *src = reply_packet.GetData(&offset, src_len);
+        if (src)
+        {
+            ::memcpy (dst, src, src_len);
+            error.Clear();
+            return src_len;
+        }
+    }
+    if (kdp_error)
+        error.SetErrorStringWithFormat ("kdp read memory failed (error %u)", kdp_error);
+    else
+        error.SetErrorString ("kdp read memory failed");
+    return 0;
+}
+
+uint32_t
+CommunicationKDP::SendRequestReadMemory (lldb::addr_t addr, 
+                                         void *dst, 
+                                         uint32_t dst_len,
+                                         Error &error)
+{
+    const uint32_t max_bytes = GetMaxBytes();
+    if (dst_len > max_bytes)
+        return SendRequestReadMemoryPipelined (addr, dst, dst_len, max_bytes, error);
+
+    PacketStreamType request_packet (Stream::eBinary, m_addr_byte_size, m_byte_order);
+    const uint8_t request_sequence_id = m_request_sequence_id++;
+    const CommandType command = MakeReadMemoryRequestPacket (addr, dst_len, request_sequence_id, request_packet);
     DataExtractor reply_packet;
     if (SendRequestAndGetReply (command, request_sequence_id, request_packet, reply_packet))
+        return ReadMemoryReply (reply_packet, dst, dst_len, error);
+    error.SetErrorString ("kdp read memory failed");
+    return 0;
+}
+
+namespace {
+    struct ReadMemoryChunk
     {
-        uint32_t offset = 8;
-        uint32_t kdp_error = reply_packet.GetU32 (&offset);
-        uint32_t src_len = reply_packet.GetByteSize() - 12;
-        
-        if (src_len > 0)
+        uint32_t offset;
+        uint32_t size;
+        uint32_t bytes_read;
+        uint8_t sequence_id;
+        bool done;
+    };
+}
+
+//----------------------------------------------------------------------
+// Reads that are larger than the server will return in one reply are
+// split into chunks, and up to kReadMemoryWindowSize requests are sent
+// before waiting for any replies so the round trips overlap. Replies
+// are matched to their requests by sequence ID. When no reply comes in
+// time, only the requests that are still waiting are sent again.
+//----------------------------------------------------------------------
+uint32_t
+CommunicationKDP::SendRequestReadMemoryPipelined (lldb::addr_t addr,
+                                                  void *dst,
+                                                  uint32_t dst_len,
+                                                  uint32_t chunk_size,
+                                                  Error &error)
+{
+    LogSP log (ProcessKDPLog::GetLogIfAllCategoriesSet (KDP_LOG_MEMORY));
+
+    const uint32_t num_chunks = (dst_len + chunk_size - 1) / chunk_size;
+    std::vector<ReadMemoryChunk> chunks (num_chunks);
+    for (uint32_t i=0; i<num_chunks; ++i)
+    {
+        chunks[i].offset = i * chunk_size;
+        chunks[i].size = std::min<uint32_t> (chunk_size, dst_len - chunks[i].offset);
+        chunks[i].bytes_read = 0;
+        chunks[i].sequence_id = 0;
+        chunks[i].done = false;
+    }
+
+    Mutex::Locker locker(m_sequence_mutex);
+    PacketStreamType request_packet (Stream::eBinary, m_addr_byte_size, m_byte_order);
+    std::map<uint8_t, uint32_t> outstanding; // Sequence ID to chunk index
+    uint32_t next_chunk = 0;
+    uint32_t num_retries = 0;
+    bool failed = false;
+    Error chunk_error;
+
+    while (true)
+    {
+        // Keep the window full unless a chunk already came up short,
+        // in which case nothing after it can be used
+        while (!failed && next_chunk < num_chunks && outstanding.size() < kReadMemoryWindowSize)
         {
-            const void *src = reply_packet.GetData(&offset, src_len);
-            if (src)
+            ReadMemoryChunk &chunk = chunks[next_chunk];
+            chunk.sequence_id = m_request_sequence_id++;
+            MakeReadMemoryRequestPacket (addr + chunk.offset, chunk.size, chunk.sequence_id, request_packet);
+            if (!SendRequestPacketNoLock (request_packet))
             {
-                ::memcpy (dst, src, src_len);
-                error.Clear();
-                return src_len;
+                failed = true;
+                break;
             }
+            outstanding[chunk.sequence_id] = next_chunk;
+            ++next_chunk;
+        }
+
+        if (outstanding.empty())
+            break;
+
+        DataExtractor reply_packet;
+        if (WaitForPacketWithTimeoutMicroSecondsNoLock (reply_packet, GetPacketTimeoutInMicroSeconds ()))
+        {
+            uint32_t offset = 0;
+            const uint8_t reply_command = reply_packet.GetU8 (&offset);
+            const uint8_t reply_sequence_id = reply_packet.GetU8 (&offset);
+            const CommandType command = ExtractCommand (reply_command);
+            std::map<uint8_t, uint32_t>::iterator pos = outstanding.find (reply_sequence_id);
+            // Duplicate replies to requests we sent twice end up here
+            if (pos == outstanding.end() || (command != KDP_READMEM && command != KDP_READMEM64))
+                continue;
+
+            ReadMemoryChunk &chunk = chunks[pos->second];
+            outstanding.erase (pos);
+            chunk.bytes_read = ReadMemoryReply (reply_packet, (uint8_t *)dst + chunk.offset, chunk.size, chunk_error);
+            chunk.done = true;
+            if (chunk.bytes_read < chunk.size)
+                failed = true;
         }
-        if (kdp_error)
-            error.SetErrorStringWithFormat ("kdp read memory failed (error %u)", kdp_error);
         else
-            error.SetErrorString ("kdp read memory failed");
+        {
+            if (!IsConnected() || ++num_retries > kReadMemoryMaxRetries)
+                break;
+
+            if (log)
+                log->Printf ("CommunicationKDP::%s resending %u read memory requests that got no reply",
+                             __FUNCTION__,
+                             (uint32_t)outstanding.size());
+
+            std::map<uint8_t, uint32_t>::const_iterator pos, end = outstanding.end();
+            for (pos = outstanding.begin(); pos != end; ++pos)
+            {
+                const ReadMemoryChunk &chunk = chunks[pos->second];
+                MakeReadMemoryRequestPacket (addr + chunk.offset, chunk.size, chunk.sequence_id, request_packet);
+                SendRequestPacketNoLock (request_packet);
+            }
+        }
     }
-    return 0;
+
+    // The bytes we return have to be contiguous from the start address
+    uint32_t total_bytes_read = 0;
+    for (uint32_t i=0; i<num_chunks; ++i)
+    {
+        total_bytes_read += chunks[i].bytes_read;
+        if (!chunks[i].done || chunks[i].bytes_read < chunks[i].size)
+            break;
+    }
+
+    if (total_bytes_read > 0)
+        error.Clear();
+    else if (chunk_error.Fail())
+        error = chunk_error;
+    else
+        error.SetErrorString ("kdp read memory failed");
+    return total_bytes_read;
 }
 
 
@@ -35,6 +35,13 @@ public:
     
     const static uint32_t kMaxPacketSize = 1200;
     const static uint32_t kMaxDataSize = 1024;
+    const static uint32_t kMaxReplyPacketSize = 8192;
+    // Number of read memory requests that can be waiting for a reply
+    // at once when a large read is split up
+    const static uint32_t kReadMemoryWindowSize = 8;
+    // Number of times requests that got no reply are sent again before
+    // a read memory gives up
+    const static uint32_t kReadMemoryMaxRetries = 3;
     typedef lldb_private::StreamBuffer<1024> PacketStreamType;
     typedef enum 
     {
@@ -191,6 +198,13 @@ public:
     uint32_t
     GetFeatureFlags ();
 
+    //------------------------------------------------------------------
+    // The most bytes the KDP server will return for one read memory
+    // request.
+    //------------------------------------------------------------------
+    uint32_t
+    GetMaxBytes ();
+
     bool
     LocalBreakpointsAreSupported ()
     {
@@ -233,6 +247,25 @@ protected:
                              PacketStreamType &request_packet,
                              uint16_t request_length);
 
+    CommandType
+    MakeReadMemoryRequestPacket (lldb::addr_t addr,
+                                 uint32_t size,
+                                 uint8_t request_sequence_id,
+                                 PacketStreamType &request_packet);
+
+    uint32_t
+    ReadMemoryReply (const lldb_private::DataExtractor &reply_packet,
+                     void *dst,
+                     uint32_t dst_len,
+                     lldb_private::Error &error);
+
+    uint32_t
+    SendRequestReadMemoryPipelined (lldb::addr_t addr,
+                                    void *dst,
+                                    uint32_t dst_len,
+                                    uint32_t chunk_size,
+                                    lldb_private::Error &error);
+
     //------------------------------------------------------------------
     // Protected Request Packets (use public accessors which will cache
     // results.
@@ -243,6 +276,9 @@ protected:
     bool
     SendRequestHostInfo ();
 
+    bool
+    SendRequestMaxBytes ();
+
     bool
     SendRequestKernelVersion ();
     
@@ -310,6 +346,7 @@ protected:
     uint8_t m_exception_sequence_id;
     uint32_t m_kdp_version_version;
     uint32_t m_kdp_version_feature;
+    uint32_t m_kdp_max_bytes;
     uint32_t m_kdp_hostinfo_cpu_mask;
     uint32_t m_kdp_hostinfo_cpu_type;
     uint32_t m_kdp_hostinfo_cpu_subtype;
@@ -379,7 +379,7 @@ ProcessKDP::DoHalt (bool &caused_stop)
 Error
 ProcessKDP::InterruptIfRunning (bool discard_thread_plans,
                                 bool catch_stop_event,
-                                EventSP &stop_event_sp)
+                                EventIntrusiveSP &stop_event_sp)
 {
     Error error;
     
@@ -460,7 +460,7 @@ ProcessKDP::WillDetach ()
     
     bool discard_thread_plans = true; 
     bool catch_stop_event = true;
-    EventSP event_sp;
+    EventIntrusiveSP event_sp;
     return InterruptIfRunning (discard_thread_plans, catch_stop_event, event_sp);
 }
 
@@ -722,7 +722,7 @@ ProcessKDP::AsyncThread (void *arg)
         log->Printf ("ProcessKDP::%s (arg = %p, pid = %llu) thread starting...", __FUNCTION__, arg, process->GetID());
     
     Listener listener ("ProcessKDP::AsyncThread");
-    EventSP event_sp;
+    EventIntrusiveSP event_sp;
     const uint32_t desired_event_mask = eBroadcastBitAsyncContinue |
                                         eBroadcastBitAsyncThreadShouldExit;
     
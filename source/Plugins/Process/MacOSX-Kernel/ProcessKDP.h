@@ -244,7 +244,7 @@ protected:
     lldb_private::Error
     InterruptIfRunning (bool discard_thread_plans,
                         bool catch_stop_event,
-                        lldb::EventSP &stop_event_sp);
+                        lldb::EventIntrusiveSP &stop_event_sp);
 
     //------------------------------------------------------------------
     /// Broadcaster event bits definitions.
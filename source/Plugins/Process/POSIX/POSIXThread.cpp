@@ -164,6 +164,11 @@ POSIXThread::Resume()
     if (log && log->GetMask().Test(POSIX_LOG_VERBOSE))
         log->Printf ("POSIXThread::%s ()", __FUNCTION__);
 
+    // Write back registers that were changed while we were stopped, the
+    // cached values are stale once the thread runs.
+    if (m_reg_context_sp)
+        GetRegisterContextPOSIX()->FlushRegisters();
+
     switch (resume_state)
     {
     default:
@@ -180,8 +185,17 @@ POSIXThread::Resume()
         SetState(resume_state);
         status = monitor.SingleStep(GetID(), GetResumeSignal());
         break;
+
+    case lldb::eStateSuspended:
+        // Stays stopped while the other threads run.
+        return false;
     }
 
+    // The reason this thread stopped is stale once it runs.  It doesn't
+    // necessarily get a new one at the next stop, that may be another
+    // thread's.
+    m_stop_info.reset();
+
     return status;
 }
 
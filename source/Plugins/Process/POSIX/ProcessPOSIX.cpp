@@ -309,51 +309,72 @@ ProcessPOSIX::DoDestroy()
 
 void
 ProcessPOSIX::SendMessage(const ProcessMessage &message)
+{
+    SendMessages(&message, 1);
+}
+
+void
+ProcessPOSIX::SendMessages(const ProcessMessage *messages, size_t num_messages)
 {
     Mutex::Locker lock(m_message_mutex);
 
-    switch (message.GetKind())
-    {
-    default:
-        assert(false && "Unexpected process message!");
-        break;
+    // The messages all describe the same stop, so only change the state once
+    // however many threads had something to report.  RefreshStateAfterStop
+    // can't look at the queue until all of them are in it.
+    StateType stop_state = eStateInvalid;
 
-    case ProcessMessage::eInvalidMessage:
-        return;
+    for (size_t i = 0; i < num_messages; ++i)
+    {
+        const ProcessMessage &message = messages[i];
 
-    case ProcessMessage::eLimboMessage:
-        m_in_limbo = true;
-        m_exit_status = message.GetExitStatus();
-        if (m_exit_now)
+        switch (message.GetKind())
         {
-            SetPrivateState(eStateExited);
-            m_monitor->Detach();
+        default:
+            assert(false && "Unexpected process message!");
+            break;
+
+        case ProcessMessage::eInvalidMessage:
+            continue;
+
+        case ProcessMessage::eLimboMessage:
+            m_in_limbo = true;
+            m_exit_status = message.GetExitStatus();
+            if (m_exit_now)
+            {
+                SetPrivateState(eStateExited);
+                m_monitor->Detach();
+            }
+            else if (stop_state == eStateInvalid)
+                stop_state = eStateStopped;
+            break;
+
+        case ProcessMessage::eExitMessage:
+            m_exit_status = message.GetExitStatus();
+            SetExitStatus(m_exit_status, NULL);
+            break;
+
+        case ProcessMessage::eTraceMessage:
+        case ProcessMessage::eBreakpointMessage:
+            if (stop_state == eStateInvalid)
+                stop_state = eStateStopped;
+            break;
+
+        case ProcessMessage::eSignalMessage:
+        case ProcessMessage::eSignalDeliveredMessage:
+            if (stop_state == eStateInvalid)
+                stop_state = eStateStopped;
+            break;
+
+        case ProcessMessage::eCrashMessage:
+            stop_state = eStateCrashed;
+            break;
         }
-        else
-            SetPrivateState(eStateStopped);
-        break;
-
-    case ProcessMessage::eExitMessage:
-        m_exit_status = message.GetExitStatus();
-        SetExitStatus(m_exit_status, NULL);
-        break;
-
-    case ProcessMessage::eTraceMessage:
-    case ProcessMessage::eBreakpointMessage:
-        SetPrivateState(eStateStopped);
-        break;
 
-    case ProcessMessage::eSignalMessage:
-    case ProcessMessage::eSignalDeliveredMessage:
-        SetPrivateState(eStateStopped);
-        break;
-
-    case ProcessMessage::eCrashMessage:
-        SetPrivateState(eStateCrashed);
-        break;
+        m_message_queue.push(message);
     }
 
-    m_message_queue.push(message);
+    if (stop_state != eStateInvalid)
+        SetPrivateState(stop_state);
 }
 
 void
@@ -364,24 +385,25 @@ ProcessPOSIX::RefreshStateAfterStop()
         log->Printf ("ProcessPOSIX::%s()", __FUNCTION__);
 
     Mutex::Locker lock(m_message_mutex);
-    if (m_message_queue.empty())
-        return;
 
-    ProcessMessage &message = m_message_queue.front();
+    // Every thread that had something to report for this stop has a message
+    // in the queue.
+    while (!m_message_queue.empty())
+    {
+        ProcessMessage &message = m_message_queue.front();
 
-    // Resolve the thread this message corresponds to and pass it along.
-    // FIXME: we're really dealing with the pid here.  This should get
-    // fixed when this code is fixed to handle multiple threads.
-    lldb::tid_t tid = message.GetTID();
-    if (log)
-        log->Printf ("ProcessPOSIX::%s() pid = %i", __FUNCTION__, tid);
-    POSIXThread *thread = static_cast<POSIXThread*>(
-        GetThreadList().FindThreadByID(tid, false).get());
+        // Resolve the thread this message corresponds to and pass it along.
+        lldb::tid_t tid = message.GetTID();
+        if (log)
+            log->Printf ("ProcessPOSIX::%s() tid = %i", __FUNCTION__, tid);
+        POSIXThread *thread = static_cast<POSIXThread*>(
+            GetThreadList().FindThreadByID(tid, false).get());
 
-    assert(thread);
-    thread->Notify(message);
+        assert(thread);
+        thread->Notify(message);
 
-    m_message_queue.pop();
+        m_message_queue.pop();
+    }
 }
 
 bool
@@ -485,6 +507,18 @@ ProcessPOSIX::DisableBreakpoint(BreakpointSite *bp_site)
     return DisableSoftwareBreakpoint(bp_site);
 }
 
+size_t
+ProcessPOSIX::EnableBreakpointSites(const BreakpointSiteList &bp_sites, Error &error)
+{
+    return EnableSoftwareBreakpoints(bp_sites, error);
+}
+
+size_t
+ProcessPOSIX::DisableBreakpointSites(const BreakpointSiteList &bp_sites, Error &error)
+{
+    return DisableSoftwareBreakpoints(bp_sites, error);
+}
+
 uint32_t
 ProcessPOSIX::UpdateThreadListIfNeeded()
 {
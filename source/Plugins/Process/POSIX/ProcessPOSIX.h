@@ -102,6 +102,14 @@ public:
     virtual lldb_private::Error
     DisableBreakpoint(lldb_private::BreakpointSite *bp_site);
 
+    virtual size_t
+    EnableBreakpointSites(const lldb_private::BreakpointSiteList &bp_sites,
+                          lldb_private::Error &error);
+
+    virtual size_t
+    DisableBreakpointSites(const lldb_private::BreakpointSiteList &bp_sites,
+                           lldb_private::Error &error);
+
     virtual uint32_t
     UpdateThreadListIfNeeded();
 
@@ -130,6 +138,10 @@ public:
     /// Registers the given message with this process.
     void SendMessage(const ProcessMessage &message);
 
+    /// Registers messages for several threads that stopped together.  The
+    /// process changes state once for all of them.
+    void SendMessages(const ProcessMessage *messages, size_t num_messages);
+
     ProcessMonitor &
     GetMonitor() { assert(m_monitor); return *m_monitor; }
 
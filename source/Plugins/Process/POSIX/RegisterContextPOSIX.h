@@ -35,6 +35,16 @@ public:
     /// @return
     ///    True if the operation succeeded and false otherwise.
     virtual bool UpdateAfterBreakpoint() { return true; }
+
+    /// Writes back any register values that were changed but only cached,
+    /// and drops the cache.  Called before the associated thread is
+    /// resumed, since cached values are stale once it runs.  Default
+    /// implementation simply returns true for register contexts which do
+    /// not cache.
+    ///
+    /// @return
+    ///    True if the operation succeeded and false otherwise.
+    virtual bool FlushRegisters() { return true; }
 };
 
 #endif // #ifndef liblldb_RegisterContextPOSIX_H_
@@ -13,6 +13,7 @@
 
 #include "lldb/Core/DataBufferHeap.h"
 #include "lldb/Core/DataExtractor.h"
+#include "lldb/Core/RegisterValue.h"
 #include "lldb/Core/Scalar.h"
 #include "lldb/Target/Thread.h"
 #include "lldb/Host/Endian.h"
@@ -423,7 +424,11 @@ static bool IsFPR(unsigned reg)
 
 RegisterContext_x86_64::RegisterContext_x86_64(Thread &thread,
                                                          uint32_t concrete_frame_idx)
-    : RegisterContextPOSIX(thread, concrete_frame_idx)
+    : RegisterContextPOSIX(thread, concrete_frame_idx),
+      m_gpr_valid(false),
+      m_fpr_valid(false),
+      m_gpr_dirty(false),
+      m_fpr_dirty(false)
 {
 }
 
@@ -442,11 +447,15 @@ RegisterContext_x86_64::GetMonitor()
 void
 RegisterContext_x86_64::Invalidate()
 {
+    FlushRegisters();
 }
 
 void
 RegisterContext_x86_64::InvalidateAllRegisters()
 {
+    // Callers expect changed registers to be in the thread afterwards,
+    // e.g. after WriteAllRegisterValues.
+    FlushRegisters();
 }
 
 size_t
@@ -504,15 +513,34 @@ RegisterContext_x86_64::ReadRegister(const RegisterInfo *reg_info,
                                           RegisterValue &value)
 {
     const uint32_t reg = reg_info->kinds[eRegisterKindLLDB];
-    ProcessMonitor &monitor = GetMonitor();
-    return monitor.ReadRegisterValue(GetRegOffset(reg), GetRegSize(reg), value);
+
+    if (IsGPR(reg))
+    {
+        if (!ReadGPR())
+            return false;
+    }
+    else if (IsFPR(reg))
+    {
+        if (!ReadFPR())
+            return false;
+    }
+    else
+    {
+        ProcessMonitor &monitor = GetMonitor();
+        return monitor.ReadRegisterValue(m_thread.GetID(), GetRegOffset(reg), GetRegSize(reg), value);
+    }
+
+    const uint8_t *src = (const uint8_t *)&user + GetRegOffset(reg);
+    Error error;
+    return value.SetFromMemoryData(reg_info, src, GetRegSize(reg),
+                                   lldb::endian::InlHostByteOrder(), error) == GetRegSize(reg);
 }
 
 bool
 RegisterContext_x86_64::ReadAllRegisterValues(DataBufferSP &data_sp)
 {
     data_sp.reset (new DataBufferHeap (REG_CONTEXT_SIZE, 0));
-    if (data_sp && ReadGPR () && ReadFPR ())
+    if (data_sp && ReadRegisterSets ())
     {
         uint8_t *dst = data_sp->GetBytes();
         ::memcpy (dst, &user.regs, sizeof(user.regs));
@@ -529,8 +557,35 @@ RegisterContext_x86_64::WriteRegister(const lldb_private::RegisterInfo *reg_info
                                            const lldb_private::RegisterValue &value)
 {
     const uint32_t reg = reg_info->kinds[eRegisterKindLLDB];
-    ProcessMonitor &monitor = GetMonitor();
-    return monitor.WriteRegisterValue(GetRegOffset(reg), value);
+
+    // Only the cache is changed here, whole sets are written back when
+    // the registers are flushed.
+    bool *dirty;
+    if (IsGPR(reg))
+    {
+        if (!ReadGPR())
+            return false;
+        dirty = &m_gpr_dirty;
+    }
+    else if (IsFPR(reg))
+    {
+        if (!ReadFPR())
+            return false;
+        dirty = &m_fpr_dirty;
+    }
+    else
+    {
+        ProcessMonitor &monitor = GetMonitor();
+        return monitor.WriteRegisterValue(m_thread.GetID(), GetRegOffset(reg), value);
+    }
+
+    uint8_t *dst = (uint8_t *)&user + GetRegOffset(reg);
+    Error error;
+    if (value.GetAsMemoryData(reg_info, dst, GetRegSize(reg),
+                              lldb::endian::InlHostByteOrder(), error) != GetRegSize(reg))
+        return false;
+    *dirty = true;
+    return true;
 }
 
 bool
@@ -543,7 +598,9 @@ RegisterContext_x86_64::WriteAllRegisterValues(const DataBufferSP &data_sp)
         src += sizeof(user.regs);
 
         ::memcpy (&user.i387, src, sizeof(user.i387));
-        return WriteGPR() & WriteFPR();
+        m_gpr_valid = m_fpr_valid = true;
+        m_gpr_dirty = m_fpr_dirty = true;
+        return true;
     }
     return false;
 }
@@ -730,29 +787,51 @@ RegisterContext_x86_64::HardwareSingleStep(bool enable)
 }
 
 bool
-RegisterContext_x86_64::ReadGPR()
+RegisterContext_x86_64::FlushRegisters()
 {
-     ProcessMonitor &monitor = GetMonitor();
-     return monitor.ReadGPR(&user.regs);
+    bool success = true;
+    if (m_gpr_dirty || m_fpr_dirty)
+    {
+        ProcessMonitor &monitor = GetMonitor();
+        success = monitor.WriteRegisterSets(m_thread.GetID(),
+                                            m_gpr_dirty ? &user.regs : NULL,
+                                            m_fpr_dirty ? &user.i387 : NULL);
+    }
+    m_gpr_valid = m_fpr_valid = false;
+    m_gpr_dirty = m_fpr_dirty = false;
+    return success;
 }
 
 bool
-RegisterContext_x86_64::ReadFPR()
+RegisterContext_x86_64::ReadRegisterSets()
 {
+    if (m_gpr_valid && m_fpr_valid)
+        return true;
     ProcessMonitor &monitor = GetMonitor();
-    return monitor.ReadFPR(&user.i387);
+    if (!monitor.ReadRegisterSets(m_thread.GetID(),
+                                  m_gpr_valid ? NULL : &user.regs,
+                                  m_fpr_valid ? NULL : &user.i387))
+        return false;
+    m_gpr_valid = m_fpr_valid = true;
+    return true;
 }
 
 bool
-RegisterContext_x86_64::WriteGPR()
+RegisterContext_x86_64::ReadGPR()
 {
+     if (m_gpr_valid)
+         return true;
      ProcessMonitor &monitor = GetMonitor();
-     return monitor.WriteGPR(&user.regs);
+     m_gpr_valid = monitor.ReadGPR(m_thread.GetID(), &user.regs);
+     return m_gpr_valid;
 }
 
 bool
-RegisterContext_x86_64::WriteFPR()
+RegisterContext_x86_64::ReadFPR()
 {
+    if (m_fpr_valid)
+        return true;
     ProcessMonitor &monitor = GetMonitor();
-    return monitor.WriteFPR(&user.i387);
+    m_fpr_valid = monitor.ReadFPR(m_thread.GetID(), &user.i387);
+    return m_fpr_valid;
 }
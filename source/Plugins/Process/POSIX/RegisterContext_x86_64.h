@@ -79,6 +79,9 @@ public:
     bool
     UpdateAfterBreakpoint();
 
+    bool
+    FlushRegisters();
+
     struct MMSReg
     {
         uint8_t bytes[10];
@@ -129,15 +132,20 @@ public:
     };
 
 private:
+    // The register sets are read with one ptrace call each the first time
+    // any register in them is needed after a stop, and changes are only
+    // written back by FlushRegisters().
     UserArea user;
+    bool m_gpr_valid;   // True if user.regs holds the thread's GPRs.
+    bool m_fpr_valid;   // True if user.i387 holds the thread's FPRs.
+    bool m_gpr_dirty;   // True if user.regs has changes to write back.
+    bool m_fpr_dirty;   // True if user.i387 has changes to write back.
 
     ProcessMonitor &GetMonitor();
 
     bool ReadGPR();
     bool ReadFPR();
-
-    bool WriteGPR();
-    bool WriteFPR();
+    bool ReadRegisterSets();
 };
 
 #endif // #ifndef liblldb_RegisterContext_x86_64_H_
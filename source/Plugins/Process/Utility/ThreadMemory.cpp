@@ -130,10 +130,12 @@ ThreadMemory::GetPrivateStopReason ()
 void
 ThreadMemory::RefreshStateAfterStop()
 {
-    RegisterContextSP reg_ctx_sp(GetRegisterContext());
-    if (reg_ctx_sp)
+    // Don't make the register context just to invalidate it, getting one
+    // can mean a call into the operating system plug-in and there can be
+    // thousands of these threads
+    if (m_reg_context_sp)
     {
         const bool force = true;
-        reg_ctx_sp->InvalidateIfNeeded (force);
+        m_reg_context_sp->InvalidateIfNeeded (force);
     }
 }
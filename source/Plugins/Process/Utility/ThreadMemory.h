@@ -56,6 +56,35 @@ public:
         return m_queue.c_str();
     }
 
+    void
+    SetName (const char *name)
+    {
+        if (name)
+            m_name = name;
+        else
+            m_name.clear();
+    }
+
+    void
+    SetQueueName (const char *queue)
+    {
+        if (queue)
+            m_queue = queue;
+        else
+            m_queue.clear();
+    }
+
+    //------------------------------------------------------------------
+    // The thread's registers changed, the next GetRegisterContext()
+    // asks the operating system plug-in for them again
+    //------------------------------------------------------------------
+    void
+    ClearRegisterContext ()
+    {
+        ClearStackFrames();
+        m_reg_context_sp.reset();
+    }
+
     virtual bool
     WillResume (lldb::StateType resume_state);
 
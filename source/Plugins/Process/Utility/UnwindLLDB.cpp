@@ -9,6 +9,8 @@
 
 #include "lldb/Core/Module.h"
 #include "lldb/Core/Log.h"
+#include "lldb/Core/DataExtractor.h"
+#include "lldb/Core/Error.h"
 #include "lldb/Symbol/FuncUnwinders.h"
 #include "lldb/Symbol/Function.h"
 #include "lldb/Symbol/UnwindPlan.h"
@@ -71,6 +73,16 @@ UnwindLLDB::AddFirstFrame ()
 {
     if (m_frames.size() > 0)
         return true;
+
+    {
+        // This is the first unwind since the thread stopped. Get the top
+        // of the stack into the memory cache with one read, instead of
+        // the many small reads the register contexts are about to do.
+        ProcessSP process_sp (m_thread.GetProcess());
+        RegisterContextSP live_reg_ctx_sp (m_thread.GetRegisterContext());
+        if (process_sp && live_reg_ctx_sp)
+            process_sp->PrefetchStackMemory (live_reg_ctx_sp->GetSP());
+    }
         
     // First, set up the 0th (initial) frame
     CursorSP first_cursor_sp(new Cursor ());
@@ -217,6 +229,94 @@ UnwindLLDB::DoGetFrameInfoAtIndex (uint32_t idx, addr_t& cfa, addr_t& pc)
     return false;
 }
 
+// How much stack memory the frame pointer walk reads at a time.
+#define UNWIND_FP_WALK_READ_SIZE 4096
+
+uint32_t
+UnwindLLDB::DoGetFramePCs (addr_t *pcs, uint32_t max_pcs)
+{
+    if (max_pcs == 0)
+        return 0;
+
+    // If the full unwind already got far enough there is nothing to gain
+    // from walking the frame pointers.
+    if (m_unwind_complete || m_frames.size() >= max_pcs)
+        return Unwind::DoGetFramePCs (pcs, max_pcs);
+
+    LogSP log(GetLogIfAllCategoriesSet (LIBLLDB_LOG_UNWIND));
+    ProcessSP process_sp (m_thread.GetProcess());
+    RegisterContextSP reg_ctx_sp (m_thread.GetRegisterContext());
+    if (!process_sp || !reg_ctx_sp)
+        return Unwind::DoGetFramePCs (pcs, max_pcs);
+
+    const uint32_t addr_size = process_sp->GetAddressByteSize();
+    if (addr_size != 4 && addr_size != 8)
+        return Unwind::DoGetFramePCs (pcs, max_pcs);
+
+    ABI *abi = process_sp->GetABI().get();
+    addr_t pc = reg_ctx_sp->GetPC();
+    addr_t fp = reg_ctx_sp->GetFP(0);
+    if (pc == LLDB_INVALID_ADDRESS)
+        return Unwind::DoGetFramePCs (pcs, max_pcs);
+
+    process_sp->PrefetchStackMemory (reg_ctx_sp->GetSP());
+
+    uint32_t num_pcs = 0;
+    pcs[num_pcs++] = pc;
+
+    // Frames are usually close together, so read the stack in blocks
+    // instead of making two tiny memory reads per frame.
+    uint8_t buffer[UNWIND_FP_WALK_READ_SIZE];
+    addr_t buffer_addr = LLDB_INVALID_ADDRESS;
+    size_t buffer_size = 0;
+    DataExtractor data;
+    Error error;
+
+    while (num_pcs < max_pcs && fp != 0)
+    {
+        if (fp % addr_size != 0)
+            goto chain_broken;
+
+        if (buffer_addr == LLDB_INVALID_ADDRESS || fp < buffer_addr || fp + 2 * addr_size > buffer_addr + buffer_size)
+        {
+            buffer_addr = fp;
+            buffer_size = process_sp->ReadMemory (fp, buffer, sizeof(buffer), error);
+            if (buffer_size < 2 * addr_size)
+            {
+                // The block may run off the end of the stack mapping, try
+                // again with just the two words we need.
+                buffer_size = process_sp->ReadMemory (fp, buffer, 2 * addr_size, error);
+                if (buffer_size < 2 * addr_size)
+                    goto chain_broken;
+            }
+            data.SetData (buffer, buffer_size, process_sp->GetByteOrder());
+            data.SetAddressByteSize (addr_size);
+        }
+
+        uint32_t offset = fp - buffer_addr;
+        const addr_t saved_fp = data.GetAddress (&offset);
+        const addr_t return_pc = data.GetAddress (&offset);
+
+        // A zero return address marks the outermost frame.
+        if (return_pc == 0)
+            break;
+        if (abi && !abi->CodeAddressIsValid (return_pc))
+            goto chain_broken;
+        pcs[num_pcs++] = return_pc;
+
+        // The stack grows down, so the caller's frame must be above ours.
+        if (saved_fp != 0 && saved_fp <= fp)
+            goto chain_broken;
+        fp = saved_fp;
+    }
+    return num_pcs;
+
+chain_broken:
+    if (log)
+        log->Printf ("UnwindLLDB::DoGetFramePCs frame pointer chain broken at frame %u (fp = 0x%llx), doing a full unwind", num_pcs, (uint64_t)fp);
+    return Unwind::DoGetFramePCs (pcs, max_pcs);
+}
+
 lldb::RegisterContextSP
 UnwindLLDB::DoCreateRegisterContextForFrame (StackFrame *frame)
 {
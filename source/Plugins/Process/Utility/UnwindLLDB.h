@@ -70,6 +70,11 @@ protected:
     lldb::RegisterContextSP
     DoCreateRegisterContextForFrame (lldb_private::StackFrame *frame);
 
+    // Walks the frame pointer chain, and falls back to a full unwind if
+    // the chain looks broken.
+    virtual uint32_t
+    DoGetFramePCs (lldb::addr_t *pcs, uint32_t max_pcs);
+
     typedef STD_SHARED_PTR(RegisterContextLLDB) RegisterContextLLDBSP;
 
     // Needed to retrieve the "next" frame (e.g. frame 2 needs to retrieve frame 1's RegisterContextLLDB)
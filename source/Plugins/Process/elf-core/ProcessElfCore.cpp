@@ -0,0 +1,449 @@
+//===-- ProcessElfCore.cpp --------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+// C Includes
+#include <stdlib.h>
+#include <string.h>
+
+// C++ Includes
+#include <algorithm>
+#include "llvm/Support/ELF.h"
+#include "llvm/Support/MathExtras.h"
+
+// Other libraries and framework includes
+#include "lldb/Core/DataBuffer.h"
+#include "lldb/Core/DataExtractor.h"
+#include "lldb/Core/PluginManager.h"
+#include "lldb/Core/State.h"
+#include "lldb/Target/DynamicLoader.h"
+#include "lldb/Target/Target.h"
+
+// Project includes
+#include "ProcessElfCore.h"
+#include "ThreadElfCore.h"
+
+#include "Plugins/DynamicLoader/Static/DynamicLoaderStatic.h"
+#include "Plugins/ObjectFile/ELF/ELFHeader.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+// Note types of the "CORE" notes in the PT_NOTE segment of a core file
+enum
+{
+    eNoteTypePRStatus = 1     // NT_PRSTATUS, a struct elf_prstatus for one thread
+};
+
+// Where things are in the struct elf_prstatus of each architecture
+enum
+{
+    ePRStatusCurSigOffset_x86_64   = 12,     // short pr_cursig
+    ePRStatusPIDOffset_x86_64      = 32,     // pid_t pr_pid
+    ePRStatusRegsOffset_x86_64     = 112,    // elf_gregset_t pr_reg
+    ePRStatusRegsSize_x86_64       = 27 * 8,
+
+    ePRStatusCurSigOffset_i386     = 12,
+    ePRStatusPIDOffset_i386        = 24,
+    ePRStatusRegsOffset_i386       = 72,
+    ePRStatusRegsSize_i386         = 17 * 4
+};
+
+const char *
+ProcessElfCore::GetPluginNameStatic()
+{
+    return "elf-core";
+}
+
+const char *
+ProcessElfCore::GetPluginDescriptionStatic()
+{
+    return "ELF core file debugging plug-in.";
+}
+
+void
+ProcessElfCore::Terminate()
+{
+    PluginManager::UnregisterPlugin (ProcessElfCore::CreateInstance);
+}
+
+
+lldb::ProcessSP
+ProcessElfCore::CreateInstance (Target &target, Listener &listener, const FileSpec *crash_file)
+{
+    lldb::ProcessSP process_sp;
+    if (crash_file)
+        process_sp.reset(new ProcessElfCore (target, listener, *crash_file));
+    return process_sp;
+}
+
+bool
+ProcessElfCore::CanDebug(Target &target, bool plugin_specified_by_name)
+{
+    if (!m_core_file.Exists())
+        return false;
+
+    // Only look at the ELF header here, the rest of the core file is
+    // mapped when it is loaded
+    DataBufferSP header_data_sp (m_core_file.ReadFileContents (0, sizeof(llvm::ELF::Elf64_Ehdr)));
+    if (!header_data_sp || header_data_sp->GetByteSize() < llvm::ELF::EI_NIDENT ||
+        !elf::ELFHeader::MagicBytesMatch (header_data_sp->GetBytes()))
+        return false;
+
+    DataExtractor header_data (header_data_sp, lldb::endian::InlHostByteOrder(), 4);
+    elf::ELFHeader header;
+    uint32_t offset = 0;
+    if (!header.Parse (header_data, &offset))
+        return false;
+
+    // We can only make register contexts for x86_64 and i386 threads
+    return header.e_type == llvm::ELF::ET_CORE &&
+           (header.e_machine == llvm::ELF::EM_X86_64 || header.e_machine == llvm::ELF::EM_386);
+}
+
+//----------------------------------------------------------------------
+// ProcessElfCore constructor
+//----------------------------------------------------------------------
+ProcessElfCore::ProcessElfCore(Target& target, Listener &listener, const FileSpec &core_file) :
+    Process (target, listener),
+    m_core_file (core_file),
+    m_core_data_sp (),
+    m_core_arch (),
+    m_core_aranges (),
+    m_thread_data ()
+{
+}
+
+//----------------------------------------------------------------------
+// Destructor
+//----------------------------------------------------------------------
+ProcessElfCore::~ProcessElfCore()
+{
+    Clear();
+    // We need to call finalize on the process before destroying ourselves
+    // to make sure all of the broadcaster cleanup goes as planned. If we
+    // destruct this class, then Process::~Process() might have problems
+    // trying to fully destroy the broadcaster.
+    Finalize();
+}
+
+//----------------------------------------------------------------------
+// PluginInterface
+//----------------------------------------------------------------------
+const char *
+ProcessElfCore::GetPluginName()
+{
+    return "Process debugging plug-in that loads ELF core files.";
+}
+
+const char *
+ProcessElfCore::GetShortPluginName()
+{
+    return GetPluginNameStatic();
+}
+
+uint32_t
+ProcessElfCore::GetPluginVersion()
+{
+    return 1;
+}
+
+//----------------------------------------------------------------------
+// Process Control
+//----------------------------------------------------------------------
+Error
+ProcessElfCore::DoLoadCore ()
+{
+    Error error;
+
+    // Map the whole core file. Pages are only read in from the file when
+    // they are touched, so large cores don't cost anything up front and
+    // memory reads copy straight out of the mapping.
+    m_core_data_sp = m_core_file.MemoryMapFileContents ();
+    if (!m_core_data_sp || m_core_data_sp->GetByteSize() == 0)
+    {
+        error.SetErrorString ("unable to map the core file");
+        return error;
+    }
+    const uint8_t *core_bytes = m_core_data_sp->GetBytes();
+    const addr_t core_size = m_core_data_sp->GetByteSize();
+
+    DataExtractor header_data (core_bytes,
+                               std::min<addr_t> (core_size, sizeof(llvm::ELF::Elf64_Ehdr)),
+                               lldb::endian::InlHostByteOrder(),
+                               4);
+    elf::ELFHeader header;
+    uint32_t offset = 0;
+    if (!header.Parse (header_data, &offset) || header.e_type != llvm::ELF::ET_CORE)
+    {
+        error.SetErrorString ("invalid ELF core file");
+        return error;
+    }
+
+    const addr_t phdrs_size = (addr_t)header.e_phnum * header.e_phentsize;
+    if (header.e_phnum == 0 || header.e_phoff + phdrs_size > core_size)
+    {
+        error.SetErrorString ("core file has no program headers");
+        return error;
+    }
+
+    // The program header table is small, but can be anywhere in the file
+    DataExtractor phdr_data (core_bytes + header.e_phoff,
+                             phdrs_size,
+                             header_data.GetByteOrder(),
+                             header_data.GetAddressByteSize());
+    bool ranges_are_sorted = true;
+    addr_t vm_addr = 0;
+    for (uint32_t i=0; i<header.e_phnum; ++i)
+    {
+        elf::ELFProgramHeader phdr;
+        offset = i * header.e_phentsize;
+        if (!phdr.Parse (phdr_data, &offset))
+            break;
+
+        if (phdr.p_type == llvm::ELF::PT_NOTE)
+        {
+            ParseNoteSegment (phdr.p_offset, phdr.p_filesz, header.e_machine, header_data.GetByteOrder());
+        }
+        else if (phdr.p_type == llvm::ELF::PT_LOAD && phdr.p_memsz > 0)
+        {
+            VMRangeToFileOffset::Entry range_entry (phdr.p_vaddr,
+                                                    phdr.p_memsz,
+                                                    FileRange (phdr.p_offset, phdr.p_filesz));
+            if (vm_addr > phdr.p_vaddr)
+                ranges_are_sorted = false;
+            vm_addr = phdr.p_vaddr;
+            m_core_aranges.Append (range_entry);
+        }
+    }
+    if (!ranges_are_sorted)
+        m_core_aranges.Sort();
+
+    if (m_thread_data.empty())
+    {
+        error.SetErrorString ("core file has no threads");
+        return error;
+    }
+
+    // The process ID is the thread ID of the first thread
+    SetID (m_thread_data.front().tid);
+
+    // Even if the architecture is set in the target, we need to override
+    // it to match the core file.
+    m_core_arch.SetArchitecture (eArchTypeELF, header.e_machine, LLDB_INVALID_CPUTYPE);
+    if (m_core_arch.IsValid())
+        m_target.SetArchitecture (m_core_arch);
+
+    return error;
+}
+
+bool
+ProcessElfCore::ParseNoteSegment (addr_t file_offset, addr_t file_size, uint32_t machine, ByteOrder byte_order)
+{
+    const addr_t core_size = m_core_data_sp->GetByteSize();
+    if (file_offset >= core_size || file_size > core_size - file_offset)
+        return false;
+
+    uint32_t cursig_offset, pid_offset, regs_offset, regs_size;
+    switch (machine)
+    {
+    case llvm::ELF::EM_X86_64:
+        cursig_offset = ePRStatusCurSigOffset_x86_64;
+        pid_offset = ePRStatusPIDOffset_x86_64;
+        regs_offset = ePRStatusRegsOffset_x86_64;
+        regs_size = ePRStatusRegsSize_x86_64;
+        break;
+    case llvm::ELF::EM_386:
+        cursig_offset = ePRStatusCurSigOffset_i386;
+        pid_offset = ePRStatusPIDOffset_i386;
+        regs_offset = ePRStatusRegsOffset_i386;
+        regs_size = ePRStatusRegsSize_i386;
+        break;
+    default:
+        return false;
+    }
+
+    // Each note is a 12 byte header with the name and description sizes
+    // and the note type, followed by the name and the description, each
+    // padded to 4 bytes.
+    DataExtractor note_data (m_core_data_sp->GetBytes() + file_offset,
+                             file_size,
+                             byte_order,
+                             8);
+    uint32_t offset = 0;
+    while (note_data.ValidOffsetForDataOfSize (offset, 12))
+    {
+        const uint32_t name_size = note_data.GetU32 (&offset);
+        const uint32_t desc_size = note_data.GetU32 (&offset);
+        const uint32_t note_type = note_data.GetU32 (&offset);
+        const char *name = (const char *)note_data.PeekData (offset, name_size);
+        if (name_size > file_size || desc_size > file_size)
+            break;
+        offset += llvm::RoundUpToAlignment (name_size, 4);
+        const uint32_t desc_offset = offset;
+        if (!note_data.ValidOffsetForDataOfSize (desc_offset, desc_size))
+            break;
+        offset += llvm::RoundUpToAlignment (desc_size, 4);
+
+        if (name == NULL || name_size < 5 || ::strncmp (name, "CORE", 5) != 0)
+            continue;
+
+        if (note_type == eNoteTypePRStatus && desc_size >= regs_offset + regs_size)
+        {
+            uint32_t field_offset = desc_offset + cursig_offset;
+            ThreadData thread_data;
+            thread_data.signo = (int16_t)note_data.GetU16 (&field_offset);
+            field_offset = desc_offset + pid_offset;
+            thread_data.tid = note_data.GetU32 (&field_offset);
+            thread_data.gpr_offset = file_offset + desc_offset + regs_offset;
+            thread_data.gpr_size = regs_size;
+            m_thread_data.push_back (thread_data);
+        }
+    }
+    return true;
+}
+
+lldb_private::DynamicLoader *
+ProcessElfCore::GetDynamicLoader ()
+{
+    // The shared library list would have to come from the auxiliary
+    // vector in the core file, so only the executable is loaded for now
+    if (m_dyld_ap.get() == NULL)
+        m_dyld_ap.reset (DynamicLoader::FindPlugin(this, DynamicLoaderStatic::GetPluginNameStatic()));
+    return m_dyld_ap.get();
+}
+
+bool
+ProcessElfCore::UpdateThreadList (ThreadList &old_thread_list, ThreadList &new_thread_list)
+{
+    if (old_thread_list.GetSize(false) == 0)
+    {
+        // Make the threads the first time this is called. Their register
+        // contexts aren't made until something asks for them.
+        const size_t num_threads = m_thread_data.size();
+        for (size_t i=0; i<num_threads; ++i)
+        {
+            ThreadSP thread_sp (new ThreadElfCore (shared_from_this(), m_thread_data[i]));
+            new_thread_list.AddThread (thread_sp);
+        }
+    }
+    else
+    {
+        const uint32_t num_threads = old_thread_list.GetSize(false);
+        for (uint32_t i=0; i<num_threads; ++i)
+            new_thread_list.AddThread (old_thread_list.GetThreadAtIndex (i));
+    }
+    return new_thread_list.GetSize(false) > 0;
+}
+
+void
+ProcessElfCore::RefreshStateAfterStop ()
+{
+    // Let all threads recover from stopping and do any clean up based
+    // on the previous thread state (if any).
+    m_thread_list.RefreshStateAfterStop();
+}
+
+Error
+ProcessElfCore::DoDestroy ()
+{
+    return Error();
+}
+
+//------------------------------------------------------------------
+// Process Queries
+//------------------------------------------------------------------
+
+bool
+ProcessElfCore::IsAlive ()
+{
+    return true;
+}
+
+//------------------------------------------------------------------
+// Process Memory
+//------------------------------------------------------------------
+size_t
+ProcessElfCore::ReadMemory (addr_t addr, void *buf, size_t size, Error &error)
+{
+    // Don't allow the caching that lldb_private::Process::ReadMemory does
+    // since the core file is already mapped into our address space.
+    return DoReadMemory (addr, buf, size, error);
+}
+
+void
+ProcessElfCore::PrefetchMemory (addr_t addr, size_t size)
+{
+    // Our reads don't go through the memory cache, and the memory is
+    // already in the core file, so there is nothing to prefetch.
+}
+
+size_t
+ProcessElfCore::DoReadMemory (addr_t addr, void *buf, size_t size, Error &error)
+{
+    if (!m_core_data_sp)
+        return 0;
+
+    const uint8_t *core_bytes = m_core_data_sp->GetBytes();
+    const addr_t core_size = m_core_data_sp->GetByteSize();
+    uint8_t *dst = (uint8_t *)buf;
+    size_t bytes_read = 0;
+    // A read can span segments that are next to each other in memory
+    while (bytes_read < size)
+    {
+        const addr_t curr_addr = addr + bytes_read;
+        const VMRangeToFileOffset::Entry *core_memory_entry = m_core_aranges.FindEntryThatContains (curr_addr);
+        if (core_memory_entry == NULL)
+        {
+            if (bytes_read == 0)
+                error.SetErrorStringWithFormat ("core file does not contain 0x%llx", curr_addr);
+            break;
+        }
+
+        // Segments that weren't dumped have no bytes in the file
+        const addr_t offset = curr_addr - core_memory_entry->GetRangeBase();
+        const addr_t file_offset = core_memory_entry->data.GetRangeBase() + offset;
+        if (offset >= core_memory_entry->data.GetByteSize() || file_offset >= core_size)
+        {
+            if (bytes_read == 0)
+                error.SetErrorStringWithFormat ("core file does not contain the contents of 0x%llx", curr_addr);
+            break;
+        }
+        const addr_t bytes_left = std::min<addr_t> (core_memory_entry->data.GetByteSize() - offset, core_size - file_offset);
+        const size_t curr_size = std::min<addr_t> (size - bytes_read, bytes_left);
+        ::memcpy (dst + bytes_read, core_bytes + file_offset, curr_size);
+        bytes_read += curr_size;
+    }
+    return bytes_read;
+}
+
+void
+ProcessElfCore::Clear()
+{
+    m_thread_list.Clear();
+}
+
+void
+ProcessElfCore::Initialize()
+{
+    static bool g_initialized = false;
+
+    if (g_initialized == false)
+    {
+        g_initialized = true;
+        PluginManager::RegisterPlugin (GetPluginNameStatic(),
+                                       GetPluginDescriptionStatic(),
+                                       CreateInstance);
+    }
+}
+
+addr_t
+ProcessElfCore::GetImageInfoAddress()
+{
+    return LLDB_INVALID_ADDRESS;
+}
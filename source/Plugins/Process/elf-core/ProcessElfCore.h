@@ -0,0 +1,168 @@
+//===-- ProcessElfCore.h ----------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_ProcessElfCore_h_
+#define liblldb_ProcessElfCore_h_
+
+// C Includes
+
+// C++ Includes
+#include <vector>
+
+// Other libraries and framework includes
+#include "lldb/Core/ArchSpec.h"
+#include "lldb/Core/Error.h"
+#include "lldb/Core/RangeMap.h"
+#include "lldb/Target/Process.h"
+
+class ThreadElfCore;
+
+class ProcessElfCore : public lldb_private::Process
+{
+public:
+    //------------------------------------------------------------------
+    // Constructors and Destructors
+    //------------------------------------------------------------------
+    static lldb::ProcessSP
+    CreateInstance (lldb_private::Target& target,
+                    lldb_private::Listener &listener,
+                    const lldb_private::FileSpec *crash_file_path);
+
+    static void
+    Initialize();
+
+    static void
+    Terminate();
+
+    static const char *
+    GetPluginNameStatic();
+
+    static const char *
+    GetPluginDescriptionStatic();
+
+    //------------------------------------------------------------------
+    // Constructors and Destructors
+    //------------------------------------------------------------------
+    ProcessElfCore(lldb_private::Target& target,
+                   lldb_private::Listener &listener,
+                   const lldb_private::FileSpec &core_file);
+
+    virtual
+    ~ProcessElfCore();
+
+    //------------------------------------------------------------------
+    // Check if a given Process
+    //------------------------------------------------------------------
+    virtual bool
+    CanDebug (lldb_private::Target &target,
+              bool plugin_specified_by_name);
+
+    //------------------------------------------------------------------
+    // Creating a new process, or attaching to an existing one
+    //------------------------------------------------------------------
+    virtual lldb_private::Error
+    DoLoadCore ();
+
+    virtual lldb_private::DynamicLoader *
+    GetDynamicLoader ();
+
+    //------------------------------------------------------------------
+    // PluginInterface protocol
+    //------------------------------------------------------------------
+    virtual const char *
+    GetPluginName();
+
+    virtual const char *
+    GetShortPluginName();
+
+    virtual uint32_t
+    GetPluginVersion();
+
+    //------------------------------------------------------------------
+    // Process Control
+    //------------------------------------------------------------------
+    virtual lldb_private::Error
+    DoDestroy ();
+
+    virtual void
+    RefreshStateAfterStop();
+
+    //------------------------------------------------------------------
+    // Process Queries
+    //------------------------------------------------------------------
+    virtual bool
+    IsAlive ();
+
+    //------------------------------------------------------------------
+    // Process Memory
+    //------------------------------------------------------------------
+    virtual size_t
+    ReadMemory (lldb::addr_t addr, void *buf, size_t size, lldb_private::Error &error);
+
+    virtual size_t
+    DoReadMemory (lldb::addr_t addr, void *buf, size_t size, lldb_private::Error &error);
+
+    virtual void
+    PrefetchMemory (lldb::addr_t addr, size_t size);
+
+    virtual lldb::addr_t
+    GetImageInfoAddress ();
+
+protected:
+    friend class ThreadElfCore;
+
+    //------------------------------------------------------------------
+    // What we know about a thread from its NT_PRSTATUS note. Only the
+    // location of the registers in the core file is kept, the register
+    // context of a thread is made from them when it is first needed.
+    //------------------------------------------------------------------
+    struct ThreadData
+    {
+        lldb::tid_t tid;
+        int signo;                  // The signal that stopped the thread
+        lldb::addr_t gpr_offset;    // File offset of the general purpose registers
+        size_t gpr_size;
+    };
+
+    void
+    Clear ( );
+
+    virtual bool
+    UpdateThreadList (lldb_private::ThreadList &old_thread_list,
+                      lldb_private::ThreadList &new_thread_list);
+
+    const lldb::DataBufferSP &
+    GetCoreData () const
+    {
+        return m_core_data_sp;
+    }
+
+private:
+    bool
+    ParseNoteSegment (lldb::addr_t file_offset,
+                      lldb::addr_t file_size,
+                      uint32_t machine,
+                      lldb::ByteOrder byte_order);
+
+    //------------------------------------------------------------------
+    // For ProcessElfCore only
+    //------------------------------------------------------------------
+    typedef lldb_private::Range<lldb::addr_t, lldb::addr_t> FileRange;
+    typedef lldb_private::RangeDataArray<lldb::addr_t, lldb::addr_t, FileRange, 1> VMRangeToFileOffset;
+
+    lldb_private::FileSpec m_core_file;
+    lldb::DataBufferSP m_core_data_sp;      // The memory mapped core file
+    lldb_private::ArchSpec m_core_arch;
+    VMRangeToFileOffset m_core_aranges;     // PT_LOAD segments sorted by address
+    std::vector<ThreadData> m_thread_data;  // One entry for each NT_PRSTATUS note
+    DISALLOW_COPY_AND_ASSIGN (ProcessElfCore);
+
+};
+
+#endif  // liblldb_ProcessElfCore_h_
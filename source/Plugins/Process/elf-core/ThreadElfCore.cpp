@@ -0,0 +1,273 @@
+//===-- ThreadElfCore.cpp ---------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include <signal.h>
+
+#include "ThreadElfCore.h"
+
+#include "lldb/Core/DataBuffer.h"
+#include "lldb/Core/DataExtractor.h"
+#include "lldb/Target/Process.h"
+#include "lldb/Target/RegisterContext.h"
+#include "lldb/Target/StopInfo.h"
+#include "lldb/Target/Target.h"
+#include "lldb/Target/Unwind.h"
+
+#include "Plugins/Process/Utility/RegisterContextDarwin_i386.h"
+#include "Plugins/Process/Utility/RegisterContextDarwin_x86_64.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+//----------------------------------------------------------------------
+// The general purpose registers of an x86_64 thread in a Linux core
+// file. The x86_64 register context from the Utility plug-in has the
+// same registers, only the elf_gregset_t of the NT_PRSTATUS note has
+// them in a different order.
+//----------------------------------------------------------------------
+class RegisterContextElfCore_x86_64 : public RegisterContextDarwin_x86_64
+{
+public:
+    RegisterContextElfCore_x86_64 (lldb_private::Thread &thread, const DataExtractor &data) :
+        RegisterContextDarwin_x86_64 (thread, 0)
+    {
+        SetRegisterDataFromGRegSet (data);
+    }
+
+    virtual void
+    InvalidateAllRegisters ()
+    {
+        // Do nothing... registers are always valid...
+    }
+
+    void
+    SetRegisterDataFromGRegSet (const DataExtractor &data)
+    {
+        // The order of the registers in the Linux elf_gregset_t
+        uint64_t *gregset_regs[] =
+        {
+            &gpr.r15, &gpr.r14, &gpr.r13, &gpr.r12, &gpr.rbp, &gpr.rbx,
+            &gpr.r11, &gpr.r10, &gpr.r9, &gpr.r8, &gpr.rax, &gpr.rcx,
+            &gpr.rdx, &gpr.rsi, &gpr.rdi, NULL /* orig_rax */, &gpr.rip,
+            &gpr.cs, &gpr.rflags, &gpr.rsp, NULL /* ss */, NULL /* fs_base */,
+            NULL /* gs_base */, NULL /* ds */, NULL /* es */, &gpr.fs, &gpr.gs
+        };
+        const uint32_t num_regs = sizeof(gregset_regs)/sizeof(gregset_regs[0]);
+
+        SetError (GPRRegSet, Read, -1);
+        SetError (FPURegSet, Read, -1);
+        SetError (EXCRegSet, Read, -1);
+        if (!data.ValidOffsetForDataOfSize (0, num_regs * 8))
+            return;
+
+        uint32_t offset = 0;
+        for (uint32_t i=0; i<num_regs; ++i)
+        {
+            const uint64_t value = data.GetU64 (&offset);
+            if (gregset_regs[i])
+                *gregset_regs[i] = value;
+        }
+        SetError (GPRRegSet, Read, 0);
+    }
+protected:
+    virtual int
+    DoReadGPR (lldb::tid_t tid, int flavor, GPR &gpr)
+    {
+        return 0;
+    }
+
+    virtual int
+    DoReadFPU (lldb::tid_t tid, int flavor, FPU &fpu)
+    {
+        return -1;
+    }
+
+    virtual int
+    DoReadEXC (lldb::tid_t tid, int flavor, EXC &exc)
+    {
+        return -1;
+    }
+
+    virtual int
+    DoWriteGPR (lldb::tid_t tid, int flavor, const GPR &gpr)
+    {
+        return 0;
+    }
+
+    virtual int
+    DoWriteFPU (lldb::tid_t tid, int flavor, const FPU &fpu)
+    {
+        return 0;
+    }
+
+    virtual int
+    DoWriteEXC (lldb::tid_t tid, int flavor, const EXC &exc)
+    {
+        return 0;
+    }
+};
+
+//----------------------------------------------------------------------
+// The general purpose registers of an i386 thread in a Linux core file,
+// which are also in a different order than the Utility plug-in has them.
+//----------------------------------------------------------------------
+class RegisterContextElfCore_i386 : public RegisterContextDarwin_i386
+{
+public:
+    RegisterContextElfCore_i386 (lldb_private::Thread &thread, const DataExtractor &data) :
+        RegisterContextDarwin_i386 (thread, 0)
+    {
+        SetRegisterDataFromGRegSet (data);
+    }
+
+    virtual void
+    InvalidateAllRegisters ()
+    {
+        // Do nothing... registers are always valid...
+    }
+
+    void
+    SetRegisterDataFromGRegSet (const DataExtractor &data)
+    {
+        // The order of the registers in the Linux elf_gregset_t
+        uint32_t *gregset_regs[] =
+        {
+            &gpr.ebx, &gpr.ecx, &gpr.edx, &gpr.esi, &gpr.edi, &gpr.ebp,
+            &gpr.eax, &gpr.ds, &gpr.es, &gpr.fs, &gpr.gs, NULL /* orig_eax */,
+            &gpr.eip, &gpr.cs, &gpr.eflags, &gpr.esp, &gpr.ss
+        };
+        const uint32_t num_regs = sizeof(gregset_regs)/sizeof(gregset_regs[0]);
+
+        SetError (GPRRegSet, Read, -1);
+        SetError (FPURegSet, Read, -1);
+        SetError (EXCRegSet, Read, -1);
+        if (!data.ValidOffsetForDataOfSize (0, num_regs * 4))
+            return;
+
+        uint32_t offset = 0;
+        for (uint32_t i=0; i<num_regs; ++i)
+        {
+            const uint32_t value = data.GetU32 (&offset);
+            if (gregset_regs[i])
+                *gregset_regs[i] = value;
+        }
+        SetError (GPRRegSet, Read, 0);
+    }
+protected:
+    virtual int
+    DoReadGPR (lldb::tid_t tid, int flavor, GPR &gpr)
+    {
+        return 0;
+    }
+};
+
+//----------------------------------------------------------------------
+// Thread Registers
+//----------------------------------------------------------------------
+
+ThreadElfCore::ThreadElfCore (const lldb::ProcessSP &process_sp, const ProcessElfCore::ThreadData &thread_data) :
+    Thread(process_sp, thread_data.tid),
+    m_core_data_sp (static_cast<ProcessElfCore *>(process_sp.get())->GetCoreData()),
+    m_thread_data (thread_data),
+    m_thread_reg_ctx_sp ()
+{
+}
+
+ThreadElfCore::~ThreadElfCore ()
+{
+    DestroyThread();
+}
+
+void
+ThreadElfCore::RefreshStateAfterStop()
+{
+    // The registers of a core file never change, but let the register
+    // context decide if anything needs to be invalidated.
+    const bool force = false;
+    GetRegisterContext()->InvalidateIfNeeded (force);
+}
+
+void
+ThreadElfCore::ClearStackFrames ()
+{
+    Unwind *unwinder = GetUnwinder ();
+    if (unwinder)
+        unwinder->Clear();
+    Thread::ClearStackFrames();
+}
+
+lldb::RegisterContextSP
+ThreadElfCore::GetRegisterContext ()
+{
+    if (m_reg_context_sp.get() == NULL)
+        m_reg_context_sp = CreateRegisterContextForFrame (NULL);
+    return m_reg_context_sp;
+}
+
+lldb::RegisterContextSP
+ThreadElfCore::CreateRegisterContextForFrame (StackFrame *frame)
+{
+    lldb::RegisterContextSP reg_ctx_sp;
+    uint32_t concrete_frame_idx = 0;
+
+    if (frame)
+        concrete_frame_idx = frame->GetConcreteFrameIndex ();
+
+    if (concrete_frame_idx == 0)
+    {
+        ProcessSP process_sp (GetProcess());
+        if (!m_thread_reg_ctx_sp && process_sp && m_core_data_sp &&
+            m_thread_data.gpr_offset + m_thread_data.gpr_size <= m_core_data_sp->GetByteSize())
+        {
+            // Read the registers straight out of the mapped core file
+            const ArchSpec &arch = process_sp->GetTarget().GetArchitecture();
+            DataExtractor gpr_data (m_core_data_sp->GetBytes() + m_thread_data.gpr_offset,
+                                    m_thread_data.gpr_size,
+                                    eByteOrderLittle,
+                                    arch.GetAddressByteSize());
+            switch (arch.GetMachine())
+            {
+            case llvm::Triple::x86_64:
+                m_thread_reg_ctx_sp.reset (new RegisterContextElfCore_x86_64 (*this, gpr_data));
+                break;
+            case llvm::Triple::x86:
+                m_thread_reg_ctx_sp.reset (new RegisterContextElfCore_i386 (*this, gpr_data));
+                break;
+            default:
+                break;
+            }
+        }
+        reg_ctx_sp = m_thread_reg_ctx_sp;
+    }
+    else if (m_unwinder_ap.get())
+    {
+        reg_ctx_sp = m_unwinder_ap->CreateRegisterContextForFrame (frame);
+    }
+    return reg_ctx_sp;
+}
+
+lldb::StopInfoSP
+ThreadElfCore::GetPrivateStopReason ()
+{
+    ProcessSP process_sp (GetProcess());
+
+    if (process_sp)
+    {
+        const uint32_t process_stop_id = process_sp->GetStopID();
+        if (m_thread_stop_reason_stop_id != process_stop_id ||
+            (m_actual_stop_info_sp && !m_actual_stop_info_sp->IsValid()))
+        {
+            // Threads that weren't the one that crashed have no signal,
+            // pretend they were stopped by a SIGSTOP.
+            const int signo = m_thread_data.signo > 0 ? m_thread_data.signo : SIGSTOP;
+            SetStopInfo (StopInfo::CreateStopReasonWithSignal (*this, signo));
+        }
+    }
+    return m_actual_stop_info_sp;
+}
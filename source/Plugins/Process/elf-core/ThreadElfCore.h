@@ -0,0 +1,53 @@
+//===-- ThreadElfCore.h -----------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_ThreadElfCore_h_
+#define liblldb_ThreadElfCore_h_
+
+#include "lldb/Target/Thread.h"
+
+#include "ProcessElfCore.h"
+
+class ThreadElfCore : public lldb_private::Thread
+{
+public:
+    ThreadElfCore (const lldb::ProcessSP &process_sp,
+                   const ProcessElfCore::ThreadData &thread_data);
+
+    virtual
+    ~ThreadElfCore ();
+
+    virtual void
+    RefreshStateAfterStop();
+
+    virtual lldb::RegisterContextSP
+    GetRegisterContext ();
+
+    virtual lldb::RegisterContextSP
+    CreateRegisterContextForFrame (lldb_private::StackFrame *frame);
+
+    virtual void
+    ClearStackFrames ();
+
+protected:
+
+    friend class ProcessElfCore;
+
+    //------------------------------------------------------------------
+    // Member variables.
+    //------------------------------------------------------------------
+    lldb::DataBufferSP m_core_data_sp;      // Keeps the mapped core file alive
+    ProcessElfCore::ThreadData m_thread_data;
+    lldb::RegisterContextSP m_thread_reg_ctx_sp;
+
+    virtual lldb::StopInfoSP
+    GetPrivateStopReason ();
+};
+
+#endif  // liblldb_ThreadElfCore_h_
@@ -0,0 +1,802 @@
+//===-- GDBRemoteAgentExpression.cpp ----------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "GDBRemoteAgentExpression.h"
+
+// C Includes
+#include <ctype.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+// C++ Includes
+// Other libraries and framework includes
+// Project includes
+#include "GDBRemoteRegisterContext.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+// The agent expression opcodes we emit, from the GDB remote protocol
+// documentation.
+enum
+{
+    eAgentOpAdd             = 0x02,
+    eAgentOpSub             = 0x03,
+    eAgentOpMul             = 0x04,
+    eAgentOpDivSigned       = 0x05,
+    eAgentOpDivUnsigned     = 0x06,
+    eAgentOpRemSigned       = 0x07,
+    eAgentOpRemUnsigned     = 0x08,
+    eAgentOpLsh             = 0x09,
+    eAgentOpRshSigned       = 0x0a,
+    eAgentOpRshUnsigned     = 0x0b,
+    eAgentOpLogNot          = 0x0e,
+    eAgentOpBitAnd          = 0x0f,
+    eAgentOpBitOr           = 0x10,
+    eAgentOpBitXor          = 0x11,
+    eAgentOpBitNot          = 0x12,
+    eAgentOpEqual           = 0x13,
+    eAgentOpLessSigned      = 0x14,
+    eAgentOpLessUnsigned    = 0x15,
+    eAgentOpExt             = 0x16,
+    eAgentOpRef8            = 0x17,
+    eAgentOpRef16           = 0x18,
+    eAgentOpRef32           = 0x19,
+    eAgentOpRef64           = 0x1a,
+    eAgentOpIfGoto          = 0x20,
+    eAgentOpGoto            = 0x21,
+    eAgentOpConst8          = 0x22,
+    eAgentOpConst16         = 0x23,
+    eAgentOpConst32         = 0x24,
+    eAgentOpConst64         = 0x25,
+    eAgentOpReg             = 0x26,
+    eAgentOpEnd             = 0x27,
+    eAgentOpZeroExt         = 0x2a,
+    eAgentOpSwap            = 0x2b
+};
+
+// Don't ship anything bigger than this to the stub.
+#define AGENT_EXPRESSION_MAX_SIZE   512
+
+namespace {
+
+// The C type of a value on the agent expression stack. Values are
+// always kept sign or zero extended to 64 bits from their type.
+struct ValueType
+{
+    ValueType (uint32_t size = 4, bool is_signed = true) :
+        byte_size (size),
+        is_signed (is_signed)
+    {
+    }
+
+    uint32_t byte_size;
+    bool is_signed;
+};
+
+enum BinaryOp
+{
+    eBinaryOpLogicalOr,
+    eBinaryOpLogicalAnd,
+    eBinaryOpBitOr,
+    eBinaryOpBitXor,
+    eBinaryOpBitAnd,
+    eBinaryOpEqual,
+    eBinaryOpNotEqual,
+    eBinaryOpLess,
+    eBinaryOpLessEqual,
+    eBinaryOpGreater,
+    eBinaryOpGreaterEqual,
+    eBinaryOpShiftLeft,
+    eBinaryOpShiftRight,
+    eBinaryOpAdd,
+    eBinaryOpSub,
+    eBinaryOpMul,
+    eBinaryOpDiv,
+    eBinaryOpRem
+};
+
+struct BinaryOpInfo
+{
+    const char *text;
+    BinaryOp op;
+    int precedence;
+};
+
+// Two character operators come first so they are matched before their
+// one character prefixes.
+static const BinaryOpInfo g_binary_ops[] =
+{
+    { "||", eBinaryOpLogicalOr,     1 },
+    { "&&", eBinaryOpLogicalAnd,    2 },
+    { "==", eBinaryOpEqual,         6 },
+    { "!=", eBinaryOpNotEqual,      6 },
+    { "<=", eBinaryOpLessEqual,     7 },
+    { ">=", eBinaryOpGreaterEqual,  7 },
+    { "<<", eBinaryOpShiftLeft,     8 },
+    { ">>", eBinaryOpShiftRight,    8 },
+    { "|",  eBinaryOpBitOr,         3 },
+    { "^",  eBinaryOpBitXor,        4 },
+    { "&",  eBinaryOpBitAnd,        5 },
+    { "<",  eBinaryOpLess,          7 },
+    { ">",  eBinaryOpGreater,       7 },
+    { "+",  eBinaryOpAdd,           9 },
+    { "-",  eBinaryOpSub,           9 },
+    { "*",  eBinaryOpMul,           10 },
+    { "/",  eBinaryOpDiv,           10 },
+    { "%",  eBinaryOpRem,           10 }
+};
+
+class ConditionCompiler
+{
+public:
+    ConditionCompiler (const char *condition,
+                       const GDBRemoteDynamicRegisterInfo &reg_info,
+                       uint32_t long_byte_size,
+                       std::string &bytecode) :
+        m_pos (condition),
+        m_reg_info (reg_info),
+        m_long_byte_size (long_byte_size),
+        m_bytecode (bytecode),
+        m_value_name (),
+        m_value_addr (LLDB_INVALID_ADDRESS),
+        m_value_type ()
+    {
+    }
+
+    // Let the condition refer to the integer variable VALUE_NAME at
+    // VALUE_ADDR.
+    void
+    SetWatchedValue (const char *value_name, lldb::addr_t value_addr, const ValueType &value_type)
+    {
+        m_value_name.assign (value_name);
+        m_value_addr = value_addr;
+        m_value_type = value_type;
+    }
+
+    bool
+    Compile ()
+    {
+        m_bytecode.clear();
+        ValueType type;
+        if (!ParseExpression (0, type))
+            return false;
+        SkipSpaces ();
+        if (*m_pos != '\0')
+            return false;
+        EmitOp (eAgentOpEnd);
+        return m_bytecode.size() <= AGENT_EXPRESSION_MAX_SIZE;
+    }
+
+private:
+    void
+    SkipSpaces ()
+    {
+        while (isspace(*m_pos))
+            ++m_pos;
+    }
+
+    bool
+    ConsumeChar (char c)
+    {
+        SkipSpaces ();
+        if (*m_pos != c)
+            return false;
+        ++m_pos;
+        return true;
+    }
+
+    void
+    EmitOp (uint8_t op)
+    {
+        m_bytecode.push_back ((char)op);
+    }
+
+    void
+    EmitBigEndian (uint64_t value, uint32_t byte_size)
+    {
+        for (uint32_t i=byte_size; i>0; --i)
+            m_bytecode.push_back ((char)((value >> ((i - 1) * 8)) & 0xff));
+    }
+
+    void
+    EmitConstant (uint64_t value)
+    {
+        // The const opcodes don't sign extend, so pick the smallest
+        // one that holds all the bits.
+        if (value <= UINT8_MAX)
+        {
+            EmitOp (eAgentOpConst8);
+            EmitBigEndian (value, 1);
+        }
+        else if (value <= UINT16_MAX)
+        {
+            EmitOp (eAgentOpConst16);
+            EmitBigEndian (value, 2);
+        }
+        else if (value <= UINT32_MAX)
+        {
+            EmitOp (eAgentOpConst32);
+            EmitBigEndian (value, 4);
+        }
+        else
+        {
+            EmitOp (eAgentOpConst64);
+            EmitBigEndian (value, 8);
+        }
+    }
+
+    // Emit a jump with a placeholder target and return the offset of
+    // the target so it can be patched.
+    size_t
+    EmitJump (uint8_t op)
+    {
+        EmitOp (op);
+        const size_t target_offset = m_bytecode.size();
+        EmitBigEndian (0, 2);
+        return target_offset;
+    }
+
+    bool
+    PatchJump (size_t target_offset)
+    {
+        const size_t target = m_bytecode.size();
+        if (target > UINT16_MAX)
+            return false;
+        m_bytecode[target_offset] = (char)(target >> 8);
+        m_bytecode[target_offset + 1] = (char)(target & 0xff);
+        return true;
+    }
+
+    void
+    EmitExtend (uint32_t byte_size, bool is_signed)
+    {
+        EmitOp (is_signed ? eAgentOpExt : eAgentOpZeroExt);
+        EmitBigEndian (byte_size * 8, 1);
+    }
+
+    // Re-extend the top of the stack after an operation that may have
+    // carried into the bits above its type.
+    void
+    Normalize (const ValueType &type)
+    {
+        if (type.byte_size < 8)
+            EmitExtend (type.byte_size, type.is_signed);
+    }
+
+    // Convert the top of the stack from one promoted type to another.
+    void
+    Convert (const ValueType &from, const ValueType &to)
+    {
+        // Widening keeps the value as it is already extended, only a
+        // change of signedness within 32 bits changes the upper bits.
+        if (to.byte_size < 8 && from.is_signed != to.is_signed)
+            EmitExtend (to.byte_size, to.is_signed);
+    }
+
+    static ValueType
+    Promote (const ValueType &type)
+    {
+        if (type.byte_size < 4)
+            return ValueType (4, true);
+        return type;
+    }
+
+    static ValueType
+    CommonType (const ValueType &lhs, const ValueType &rhs)
+    {
+        if (lhs.byte_size == rhs.byte_size)
+            return ValueType (lhs.byte_size, lhs.is_signed && rhs.is_signed);
+        // The bigger type can represent all values of the smaller one
+        return lhs.byte_size > rhs.byte_size ? lhs : rhs;
+    }
+
+    const BinaryOpInfo *
+    PeekBinaryOp ()
+    {
+        SkipSpaces ();
+        const size_t num_ops = sizeof(g_binary_ops)/sizeof(g_binary_ops[0]);
+        for (size_t i=0; i<num_ops; ++i)
+        {
+            const size_t len = strlen (g_binary_ops[i].text);
+            if (strncmp (m_pos, g_binary_ops[i].text, len) == 0)
+            {
+                // Don't mistake "a = b", "a += b" and such for an operator
+                if (m_pos[len] == '=' && g_binary_ops[i].precedence != 6 && g_binary_ops[i].precedence != 7)
+                    return NULL;
+                return &g_binary_ops[i];
+            }
+        }
+        return NULL;
+    }
+
+    bool
+    ParseExpression (int min_precedence, ValueType &type)
+    {
+        if (!ParseUnary (type))
+            return false;
+
+        while (true)
+        {
+            const BinaryOpInfo *op_info = PeekBinaryOp ();
+            if (op_info == NULL || op_info->precedence < min_precedence)
+                return true;
+            m_pos += strlen (op_info->text);
+
+            if (op_info->op == eBinaryOpLogicalAnd || op_info->op == eBinaryOpLogicalOr)
+            {
+                if (!ParseLogical (op_info, type))
+                    return false;
+                continue;
+            }
+
+            ValueType rhs_type;
+            if (!ParseExpression (op_info->precedence + 1, rhs_type))
+                return false;
+            EmitBinaryOp (op_info->op, type, rhs_type, type);
+        }
+    }
+
+    // "a && b" and "a || b" are compiled with jumps so that "b" is only
+    // evaluated when needed, like "$rdi != 0 && *(int *)$rdi == 1".
+    bool
+    ParseLogical (const BinaryOpInfo *op_info, ValueType &type)
+    {
+        const size_t lhs_true_jump = EmitJump (eAgentOpIfGoto);
+        size_t end_jump;
+        ValueType rhs_type;
+        if (op_info->op == eBinaryOpLogicalAnd)
+        {
+            EmitConstant (0);
+            end_jump = EmitJump (eAgentOpGoto);
+            if (!PatchJump (lhs_true_jump))
+                return false;
+            if (!ParseExpression (op_info->precedence + 1, rhs_type))
+                return false;
+            EmitOp (eAgentOpLogNot);
+            EmitOp (eAgentOpLogNot);
+        }
+        else
+        {
+            if (!ParseExpression (op_info->precedence + 1, rhs_type))
+                return false;
+            EmitOp (eAgentOpLogNot);
+            EmitOp (eAgentOpLogNot);
+            end_jump = EmitJump (eAgentOpGoto);
+            if (!PatchJump (lhs_true_jump))
+                return false;
+            EmitConstant (1);
+        }
+        if (!PatchJump (end_jump))
+            return false;
+        type = ValueType (4, true);
+        return true;
+    }
+
+    void
+    EmitBinaryOp (BinaryOp op, const ValueType &lhs, const ValueType &rhs, ValueType &result)
+    {
+        if (op == eBinaryOpShiftLeft || op == eBinaryOpShiftRight)
+        {
+            // The result has the type of the left operand
+            if (op == eBinaryOpShiftLeft)
+                EmitOp (eAgentOpLsh);
+            else
+                EmitOp (lhs.is_signed ? eAgentOpRshSigned : eAgentOpRshUnsigned);
+            result = lhs;
+            Normalize (result);
+            return;
+        }
+
+        const ValueType common = CommonType (lhs, rhs);
+        Convert (rhs, common);
+        if (lhs.is_signed != common.is_signed && common.byte_size < 8)
+        {
+            EmitOp (eAgentOpSwap);
+            Convert (lhs, common);
+            EmitOp (eAgentOpSwap);
+        }
+
+        const uint8_t less_op = common.is_signed ? eAgentOpLessSigned : eAgentOpLessUnsigned;
+        switch (op)
+        {
+        case eBinaryOpEqual:        EmitOp (eAgentOpEqual); break;
+        case eBinaryOpNotEqual:     EmitOp (eAgentOpEqual); EmitOp (eAgentOpLogNot); break;
+        case eBinaryOpLess:         EmitOp (less_op); break;
+        case eBinaryOpGreaterEqual: EmitOp (less_op); EmitOp (eAgentOpLogNot); break;
+        case eBinaryOpGreater:      EmitOp (eAgentOpSwap); EmitOp (less_op); break;
+        case eBinaryOpLessEqual:    EmitOp (eAgentOpSwap); EmitOp (less_op); EmitOp (eAgentOpLogNot); break;
+        default:
+            switch (op)
+            {
+            case eBinaryOpBitOr:    EmitOp (eAgentOpBitOr); break;
+            case eBinaryOpBitXor:   EmitOp (eAgentOpBitXor); break;
+            case eBinaryOpBitAnd:   EmitOp (eAgentOpBitAnd); break;
+            case eBinaryOpAdd:      EmitOp (eAgentOpAdd); break;
+            case eBinaryOpSub:      EmitOp (eAgentOpSub); break;
+            case eBinaryOpMul:      EmitOp (eAgentOpMul); break;
+            case eBinaryOpDiv:      EmitOp (common.is_signed ? eAgentOpDivSigned : eAgentOpDivUnsigned); break;
+            case eBinaryOpRem:      EmitOp (common.is_signed ? eAgentOpRemSigned : eAgentOpRemUnsigned); break;
+            default:                break;
+            }
+            result = common;
+            Normalize (result);
+            return;
+        }
+        // Comparisons are of type int
+        result = ValueType (4, true);
+    }
+
+    bool
+    ParseUnary (ValueType &type)
+    {
+        SkipSpaces ();
+        const char c = *m_pos;
+        if (c == '!' && m_pos[1] != '=')
+        {
+            ++m_pos;
+            if (!ParseUnary (type))
+                return false;
+            EmitOp (eAgentOpLogNot);
+            type = ValueType (4, true);
+            return true;
+        }
+        if (c == '~')
+        {
+            ++m_pos;
+            if (!ParseUnary (type))
+                return false;
+            EmitOp (eAgentOpBitNot);
+            Normalize (type);
+            return true;
+        }
+        if (c == '-' && m_pos[1] != '-')
+        {
+            ++m_pos;
+            if (!ParseUnary (type))
+                return false;
+            EmitConstant (0);
+            EmitOp (eAgentOpSwap);
+            EmitOp (eAgentOpSub);
+            Normalize (type);
+            return true;
+        }
+        if (c == '+' && m_pos[1] != '+')
+        {
+            ++m_pos;
+            return ParseUnary (type);
+        }
+        if (c == '*')
+        {
+            ++m_pos;
+            return ParseDereference (type);
+        }
+        if (c == '(')
+        {
+            ++m_pos;
+            if (!ParseExpression (0, type))
+                return false;
+            return ConsumeChar (')');
+        }
+        if (c == '$')
+        {
+            ++m_pos;
+            return ParseRegister (type);
+        }
+        if (isdigit(c))
+            return ParseLiteral (type);
+        if ((isalpha(c) || c == '_') && !m_value_name.empty())
+            return ParseWatchedValue (type);
+        return false;
+    }
+
+    bool
+    ParseWatchedValue (ValueType &type)
+    {
+        std::string name;
+        if (!ParseIdentifier (name) || name != m_value_name)
+            return false;
+
+        EmitConstant (m_value_addr);
+        switch (m_value_type.byte_size)
+        {
+        case 1: EmitOp (eAgentOpRef8); break;
+        case 2: EmitOp (eAgentOpRef16); break;
+        case 4: EmitOp (eAgentOpRef32); break;
+        case 8: EmitOp (eAgentOpRef64); break;
+        default: return false;
+        }
+        // The ref opcodes zero extend
+        if (m_value_type.is_signed && m_value_type.byte_size < 8)
+            EmitExtend (m_value_type.byte_size, true);
+        type = Promote (m_value_type);
+        return true;
+    }
+
+    // Parse "(type *) operand" after a '*'.
+    bool
+    ParseDereference (ValueType &type)
+    {
+        ValueType pointee_type;
+        if (!ConsumeChar ('(') || !ParseTypeName (pointee_type) || !ConsumeChar ('*') || !ConsumeChar (')'))
+            return false;
+
+        ValueType address_type;
+        if (!ParseUnary (address_type))
+            return false;
+
+        switch (pointee_type.byte_size)
+        {
+        case 1: EmitOp (eAgentOpRef8); break;
+        case 2: EmitOp (eAgentOpRef16); break;
+        case 4: EmitOp (eAgentOpRef32); break;
+        case 8: EmitOp (eAgentOpRef64); break;
+        default: return false;
+        }
+        // The ref opcodes zero extend
+        if (pointee_type.is_signed && pointee_type.byte_size < 8)
+            EmitExtend (pointee_type.byte_size, true);
+        type = Promote (pointee_type);
+        return true;
+    }
+
+    bool
+    ParseIdentifier (std::string &identifier)
+    {
+        SkipSpaces ();
+        if (!isalpha(*m_pos) && *m_pos != '_')
+            return false;
+        const char *start = m_pos;
+        while (isalnum(*m_pos) || *m_pos == '_')
+            ++m_pos;
+        identifier.assign (start, m_pos - start);
+        return true;
+    }
+
+    bool
+    ParseTypeName (ValueType &type)
+    {
+        bool is_unsigned = false;
+        bool is_signed = false;
+        uint32_t num_char = 0;
+        uint32_t num_short = 0;
+        uint32_t num_int = 0;
+        uint32_t num_long = 0;
+        uint32_t num_words = 0;
+
+        std::string word;
+        while (true)
+        {
+            const char *word_start = m_pos;
+            if (!ParseIdentifier (word))
+            {
+                m_pos = word_start;
+                break;
+            }
+            ++num_words;
+            if (word == "unsigned")     is_unsigned = true;
+            else if (word == "signed")  is_signed = true;
+            else if (word == "char")    ++num_char;
+            else if (word == "short")   ++num_short;
+            else if (word == "int")     ++num_int;
+            else if (word == "long")    ++num_long;
+            else if (num_words == 1)
+            {
+                // The fixed size types from <stdint.h>
+                static const struct { const char *name; uint32_t byte_size; bool is_signed; } g_stdint_types[] =
+                {
+                    { "int8_t",   1, true  }, { "uint8_t",  1, false },
+                    { "int16_t",  2, true  }, { "uint16_t", 2, false },
+                    { "int32_t",  4, true  }, { "uint32_t", 4, false },
+                    { "int64_t",  8, true  }, { "uint64_t", 8, false }
+                };
+                for (size_t i=0; i<sizeof(g_stdint_types)/sizeof(g_stdint_types[0]); ++i)
+                {
+                    if (word == g_stdint_types[i].name)
+                    {
+                        type = ValueType (g_stdint_types[i].byte_size, g_stdint_types[i].is_signed);
+                        return true;
+                    }
+                }
+                return false;
+            }
+            else
+                return false;
+        }
+
+        if (num_words == 0 || (is_signed && is_unsigned) || num_char > 1 || num_short > 1 || num_int > 1 || num_long > 2)
+            return false;
+        if (num_char + num_short + (num_long ? 1 : 0) > 1)
+            return false;
+        if (num_char && num_int)
+            return false;
+
+        if (num_char)
+            type.byte_size = 1;
+        else if (num_short)
+            type.byte_size = 2;
+        else if (num_long == 1)
+            type.byte_size = m_long_byte_size;
+        else if (num_long == 2)
+            type.byte_size = 8;
+        else
+            type.byte_size = 4;
+        // Plain char is signed on the targets we support
+        type.is_signed = !is_unsigned;
+        return true;
+    }
+
+    bool
+    ParseRegister (ValueType &type)
+    {
+        std::string name;
+        if (!ParseIdentifier (name))
+            return false;
+
+        static const struct { const char *name; uint32_t regnum; } g_generic_regs[] =
+        {
+            { "pc",    LLDB_REGNUM_GENERIC_PC },
+            { "sp",    LLDB_REGNUM_GENERIC_SP },
+            { "fp",    LLDB_REGNUM_GENERIC_FP },
+            { "ra",    LLDB_REGNUM_GENERIC_RA },
+            { "flags", LLDB_REGNUM_GENERIC_FLAGS }
+        };
+        uint32_t generic_regnum = LLDB_INVALID_REGNUM;
+        for (size_t i=0; i<sizeof(g_generic_regs)/sizeof(g_generic_regs[0]); ++i)
+        {
+            if (name == g_generic_regs[i].name)
+                generic_regnum = g_generic_regs[i].regnum;
+        }
+
+        const RegisterInfo *reg_info = NULL;
+        const size_t num_regs = m_reg_info.GetNumRegisters();
+        for (size_t i=0; i<num_regs && reg_info == NULL; ++i)
+        {
+            const RegisterInfo *info = m_reg_info.GetRegisterInfoAtIndex(i);
+            if (info == NULL)
+                continue;
+            if ((info->name && name == info->name) || (info->alt_name && name == info->alt_name))
+                reg_info = info;
+        }
+        if (reg_info == NULL && generic_regnum != LLDB_INVALID_REGNUM)
+        {
+            for (size_t i=0; i<num_regs && reg_info == NULL; ++i)
+            {
+                const RegisterInfo *info = m_reg_info.GetRegisterInfoAtIndex(i);
+                if (info && info->kinds[eRegisterKindGeneric] == generic_regnum)
+                    reg_info = info;
+            }
+        }
+        if (reg_info == NULL)
+            return false;
+
+        if (reg_info->encoding != eEncodingUint && reg_info->encoding != eEncodingSint)
+            return false;
+        switch (reg_info->byte_size)
+        {
+        case 1: case 2: case 4: case 8: break;
+        default: return false;
+        }
+        const uint32_t regnum = reg_info->kinds[eRegisterKindLLDB];
+        if (regnum > UINT16_MAX)
+            return false;
+
+        EmitOp (eAgentOpReg);
+        EmitBigEndian (regnum, 2);
+        const ValueType reg_type (reg_info->byte_size, reg_info->encoding == eEncodingSint);
+        if (reg_type.is_signed && reg_type.byte_size < 8)
+            EmitExtend (reg_type.byte_size, true);
+        type = Promote (reg_type);
+        return true;
+    }
+
+    static bool
+    ValueFits (uint64_t value, const ValueType &type)
+    {
+        uint32_t bits = type.byte_size * 8;
+        if (type.is_signed)
+            --bits;
+        return bits >= 64 || value < (1ull << bits);
+    }
+
+    bool
+    ParseLiteral (ValueType &type)
+    {
+        const bool is_decimal = !(m_pos[0] == '0' && isalnum(m_pos[1]));
+        char *end = NULL;
+        errno = 0;
+        const uint64_t value = ::strtoull (m_pos, &end, 0);
+        if (errno != 0 || end == m_pos)
+            return false;
+        m_pos = end;
+
+        bool is_unsigned = false;
+        uint32_t num_long = 0;
+        while (true)
+        {
+            if ((*m_pos == 'u' || *m_pos == 'U') && !is_unsigned)
+                is_unsigned = true;
+            else if ((*m_pos == 'l' || *m_pos == 'L') && num_long < 2)
+                ++num_long;
+            else
+                break;
+            ++m_pos;
+        }
+        if (isalnum(*m_pos) || *m_pos == '_' || *m_pos == '.')
+            return false;
+
+        // Pick the first type that can represent the value, in the
+        // order the C standard lists them.
+        const ValueType candidates[] =
+        {
+            ValueType (4, true),
+            ValueType (4, false),
+            ValueType (m_long_byte_size, true),
+            ValueType (m_long_byte_size, false),
+            ValueType (8, true),
+            ValueType (8, false)
+        };
+        const size_t first = num_long == 0 ? 0 : (num_long == 1 ? 2 : 4);
+        for (size_t i=first; i<sizeof(candidates)/sizeof(candidates[0]); ++i)
+        {
+            if (is_unsigned && candidates[i].is_signed)
+                continue;
+            // Decimal literals without a 'u' suffix are always signed
+            if (is_decimal && !is_unsigned && !candidates[i].is_signed)
+                continue;
+            if (ValueFits (value, candidates[i]))
+            {
+                type = candidates[i];
+                EmitConstant (value);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    const char *m_pos;
+    const GDBRemoteDynamicRegisterInfo &m_reg_info;
+    const uint32_t m_long_byte_size;
+    std::string &m_bytecode;
+    std::string m_value_name;
+    lldb::addr_t m_value_addr;
+    ValueType m_value_type;
+};
+
+} // anonymous namespace
+
+bool
+GDBRemoteAgentExpression::CompileCondition (const char *condition,
+                                            const GDBRemoteDynamicRegisterInfo &reg_info,
+                                            uint32_t long_byte_size,
+                                            std::string &bytecode)
+{
+    if (condition == NULL || condition[0] == '\0')
+        return false;
+    ConditionCompiler compiler (condition, reg_info, long_byte_size, bytecode);
+    return compiler.Compile();
+}
+
+bool
+GDBRemoteAgentExpression::CompileWatchpointCondition (const char *condition,
+                                                      const char *value_name,
+                                                      lldb::addr_t value_addr,
+                                                      uint32_t value_byte_size,
+                                                      bool value_is_signed,
+                                                      const GDBRemoteDynamicRegisterInfo &reg_info,
+                                                      uint32_t long_byte_size,
+                                                      std::string &bytecode)
+{
+    if (condition == NULL || condition[0] == '\0')
+        return false;
+    ConditionCompiler compiler (condition, reg_info, long_byte_size, bytecode);
+    if (value_name && value_name[0] && value_addr != LLDB_INVALID_ADDRESS)
+        compiler.SetWatchedValue (value_name, value_addr, ValueType (value_byte_size, value_is_signed));
+    return compiler.Compile();
+}
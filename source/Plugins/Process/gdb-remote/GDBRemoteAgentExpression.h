@@ -0,0 +1,102 @@
+//===-- GDBRemoteAgentExpression.h ------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_GDBRemoteAgentExpression_h_
+#define liblldb_GDBRemoteAgentExpression_h_
+
+// C Includes
+// C++ Includes
+#include <string>
+
+// Other libraries and framework includes
+// Project includes
+#include "lldb/lldb-private.h"
+
+class GDBRemoteDynamicRegisterInfo;
+
+//----------------------------------------------------------------------
+// Compiles simple breakpoint conditions into GDB agent expression
+// bytecode, so a remote stub that supports conditions in its "Z"
+// packets can evaluate them and only stop for the hits where the
+// condition is true.
+//
+// Only a small subset of C is handled: integer literals, registers
+// ("$rdi"), memory reads through a cast pointer ("*(int *)($sp + 8)"),
+// and the C unary, arithmetic, bitwise, comparison and logical
+// operators with the usual C integer conversions. Anything else, like
+// variables or function calls, makes compilation fail and the
+// condition is left to lldb to evaluate. Watchpoint conditions can
+// also name the integer variable being watched.
+//----------------------------------------------------------------------
+class GDBRemoteAgentExpression
+{
+public:
+    //------------------------------------------------------------------
+    /// Compile \a condition into agent expression bytecode.
+    ///
+    /// @param[in] condition
+    ///     The breakpoint condition text.
+    ///
+    /// @param[in] reg_info
+    ///     The remote register definitions, used to look up register
+    ///     names. Registers are referred to by the numbers the "p"
+    ///     packet uses.
+    ///
+    /// @param[in] long_byte_size
+    ///     The size of "long" on the target.
+    ///
+    /// @param[out] bytecode
+    ///     The compiled bytecode.
+    ///
+    /// @return
+    ///     True if the whole condition could be compiled.
+    //------------------------------------------------------------------
+    static bool
+    CompileCondition (const char *condition,
+                      const GDBRemoteDynamicRegisterInfo &reg_info,
+                      uint32_t long_byte_size,
+                      std::string &bytecode);
+
+    //------------------------------------------------------------------
+    /// Compile the condition of a watchpoint on an integer variable.
+    ///
+    /// Uses of \a value_name in \a condition read the variable from
+    /// memory, so a stub that evaluates the condition after the access
+    /// sees the new value.
+    ///
+    /// @param[in] value_name
+    ///     The name of the watched variable, or NULL if the watchpoint
+    ///     isn't on a variable.
+    ///
+    /// @param[in] value_addr
+    ///     The load address of the watched variable.
+    ///
+    /// @param[in] value_byte_size
+    ///     The size of the watched variable, 1, 2, 4 or 8.
+    ///
+    /// @param[in] value_is_signed
+    ///     True if the watched variable has a signed integer type.
+    ///
+    /// @return
+    ///     True if the whole condition could be compiled.
+    ///
+    /// @see GDBRemoteAgentExpression::CompileCondition()
+    //------------------------------------------------------------------
+    static bool
+    CompileWatchpointCondition (const char *condition,
+                                const char *value_name,
+                                lldb::addr_t value_addr,
+                                uint32_t value_byte_size,
+                                bool value_is_signed,
+                                const GDBRemoteDynamicRegisterInfo &reg_info,
+                                uint32_t long_byte_size,
+                                std::string &bytecode);
+};
+
+#endif  // liblldb_GDBRemoteAgentExpression_h_
@@ -17,6 +17,7 @@
 // C++ Includes
 // Other libraries and framework includes
 #include "lldb/Core/Log.h"
+#include "lldb/Core/Statistics.h"
 #include "lldb/Core/StreamFile.h"
 #include "lldb/Core/StreamString.h"
 #include "lldb/Host/FileSpec.h"
@@ -138,8 +139,12 @@ GDBRemoteCommunication::GDBRemoteCommunication(const char *comm_name,
     m_public_is_running (false),
     m_private_is_running (false),
     m_history (512),
+    m_packet_scan_pos (0),
     m_send_acks (true),
-    m_is_platform (is_platform)
+    m_compression_enabled (false),
+    m_send_compression_min_size (0),
+    m_is_platform (is_platform),
+    m_notifications ()
 {
 }
 
@@ -157,15 +162,10 @@ GDBRemoteCommunication::~GDBRemoteCommunication()
 char
 GDBRemoteCommunication::CalculcateChecksum (const char *payload, size_t payload_length)
 {
-    int checksum = 0;
-
     // We only need to compute the checksum if we are sending acks
     if (GetSendAcks ())
-    {
-        for (size_t i = 0; i < payload_length; ++i)
-            checksum += payload[i];
-    }
-    return checksum & 255;
+        return StringExtractor::CalculateChecksum (payload, payload_length);
+    return 0;
 }
 
 size_t
@@ -206,6 +206,18 @@ GDBRemoteCommunication::SendPacketNoLock (const char *payload, size_t payload_le
 {
     if (IsConnected())
     {
+        // Packets that contain a '*' of their own can't be compressed
+        // since the other side couldn't tell the two apart
+        std::string encoded_payload;
+        if (m_send_compression_min_size > 0 &&
+            payload_length >= m_send_compression_min_size &&
+            ::memchr (payload, '*', payload_length) == NULL)
+        {
+            EncodeRunLengthEncoding (payload, payload_length, encoded_payload);
+            payload = encoded_payload.data();
+            payload_length = encoded_payload.size();
+        }
+
         StreamString packet(0, 4, eByteOrderBig);
 
         packet.PutChar('$');
@@ -216,6 +228,10 @@ GDBRemoteCommunication::SendPacketNoLock (const char *payload, size_t payload_le
         LogSP log (ProcessGDBRemoteLog::GetLogIfAllCategoriesSet (GDBR_LOG_PACKETS));
         ConnectionStatus status = eConnectionStatusSuccess;
         size_t bytes_written = Write (packet.GetData(), packet.GetSize(), status, NULL);
+        static StatisticsCounter &g_packets_sent = Statistics::GetCounter ("gdb-remote.packets.sent");
+        static StatisticsCounter &g_bytes_sent = Statistics::GetCounter ("gdb-remote.bytes.sent");
+        g_packets_sent.Add ();
+        g_bytes_sent.Add (bytes_written);
         if (log)
         {
             // If logging was just enabled and we have history, then dump out what
@@ -281,6 +297,40 @@ GDBRemoteCommunication::WaitForNotRunningPrivate (const TimeValue *timeout_ptr)
 
 size_t
 GDBRemoteCommunication::WaitForPacketWithTimeoutMicroSecondsNoLock (StringExtractorGDBRemote &packet, uint32_t timeout_usec)
+{
+    // A notification can show up at any time, like a "%Stop" for a thread
+    // that stopped in non-stop mode while we think the process is stopped.
+    // Taking it for the reply would pair every later packet with the
+    // wrong reply, so keep it for whoever waits for the process to stop.
+    while (ReadPacketWithTimeoutMicroSecondsNoLock (packet, timeout_usec))
+    {
+        if (packet.GetStringRef()[0] != '%')
+            return packet.GetStringRef().size();
+
+        LogSP log (ProcessGDBRemoteLog::GetLogIfAllCategoriesSet (GDBR_LOG_PACKETS));
+        if (log)
+            log->Printf ("GDBRemoteCommunication::%s queuing notification: %s", __FUNCTION__, packet.GetStringRef().c_str());
+        m_notifications.push_back (packet.GetStringRef());
+    }
+    packet.Clear ();
+    return 0;
+}
+
+size_t
+GDBRemoteCommunication::WaitForPacketOrNotificationWithTimeoutMicroSecondsNoLock (StringExtractorGDBRemote &packet, uint32_t timeout_usec)
+{
+    if (!m_notifications.empty())
+    {
+        packet.GetStringRef().swap (m_notifications.front());
+        packet.SetFilePos (0);
+        m_notifications.pop_front();
+        return packet.GetStringRef().size();
+    }
+    return ReadPacketWithTimeoutMicroSecondsNoLock (packet, timeout_usec);
+}
+
+size_t
+GDBRemoteCommunication::ReadPacketWithTimeoutMicroSecondsNoLock (StringExtractorGDBRemote &packet, uint32_t timeout_usec)
 {
     uint8_t buffer[8192];
     Error error;
@@ -353,12 +403,19 @@ GDBRemoteCommunication::CheckForPacket (const uint8_t *src, size_t src_len, Stri
                          (uint32_t)src_len, 
                          src);
         }
-        m_bytes.append ((const char *)src, src_len);
+        AppendCachedBytes (src, src_len);
     }
 
-    // Parse up the packets into gdb remote packets
-    if (!m_bytes.empty())
+    // Parse up the packets into gdb remote packets. Packets are framed
+    // in place in the cached bytes, which are only consumed once a whole
+    // packet has been copied out.
+    const size_t bytes_len = GetNumCachedBytes();
+    if (bytes_len > 0)
     {
+        const char *bytes = GetCachedBytesStart();
+        if (m_packet_scan_pos > bytes_len)
+            m_packet_scan_pos = 0;
+
         // end_idx must be one past the last valid packet byte. Start
         // it off with an invalid value that is the same as the current
         // index.
@@ -367,7 +424,7 @@ GDBRemoteCommunication::CheckForPacket (const uint8_t *src, size_t src_len, Stri
         size_t total_length = 0;
         size_t checksum_idx = std::string::npos;
 
-        switch (m_bytes[0])
+        switch (bytes[0])
         {
             case '+':       // Look for ack
             case '-':       // Look for cancel
@@ -376,18 +433,25 @@ GDBRemoteCommunication::CheckForPacket (const uint8_t *src, size_t src_len, Stri
                 break;
 
             case '$':
-                // Look for a standard gdb packet?
+            case '%':
+                // Look for a standard gdb packet, or a notification which
+                // is framed the same way but never acked
                 {
-                    size_t hash_pos = m_bytes.find('#');
-                    if (hash_pos != std::string::npos)
+                    // Large packets arrive in many pieces, so continue
+                    // looking for the '#' where we left off last time
+                    const char *hash = (const char *)::memchr (bytes + m_packet_scan_pos, '#', bytes_len - m_packet_scan_pos);
+                    if (hash != NULL)
                     {
-                        if (hash_pos + 2 < m_bytes.size())
+                        const size_t hash_pos = hash - bytes;
+                        m_packet_scan_pos = hash_pos;
+                        if (hash_pos + 2 < bytes_len)
                         {
                             checksum_idx = hash_pos + 1;
-                            // Skip the dollar sign
-                            content_start = 1; 
+                            // Skip the dollar sign, but keep the percent sign
+                            // so notifications can be told apart from replies
+                            content_start = bytes[0] == '$' ? 1 : 0;
                             // Don't include the # in the content or the $ in the content length
-                            content_length = hash_pos - 1;  
+                            content_length = hash_pos - content_start;
                             
                             total_length = hash_pos + 3; // Skip the # and the two hex checksum bytes
                         }
@@ -397,6 +461,10 @@ GDBRemoteCommunication::CheckForPacket (const uint8_t *src, size_t src_len, Stri
                             content_length = std::string::npos;
                         }
                     }
+                    else
+                    {
+                        m_packet_scan_pos = bytes_len;
+                    }
                 }
                 break;
 
@@ -405,19 +473,19 @@ GDBRemoteCommunication::CheckForPacket (const uint8_t *src, size_t src_len, Stri
                     // We have an unexpected byte and we need to flush all bad 
                     // data that is in m_bytes, so we need to find the first
                     // byte that is a '+' (ACK), '-' (NACK), \x03 (CTRL+C interrupt),
-                    // or '$' character (start of packet header) or of course,
-                    // the end of the data in m_bytes...
-                    const size_t bytes_len = m_bytes.size();
+                    // '$' or '%' character (start of packet or notification header)
+                    // or of course, the end of the data in m_bytes...
                     bool done = false;
                     uint32_t idx;
                     for (idx = 1; !done && idx < bytes_len; ++idx)
                     {
-                        switch (m_bytes[idx])
+                        switch (bytes[idx])
                         {
                         case '+':
                         case '-':
                         case '\x03':
                         case '$':
+                        case '%':
                             done = true;
                             break;
                                 
@@ -427,8 +495,9 @@ GDBRemoteCommunication::CheckForPacket (const uint8_t *src, size_t src_len, Stri
                     }
                     if (log)
                         log->Printf ("GDBRemoteCommunication::%s tossing %u junk bytes: '%.*s'",
-                                     __FUNCTION__, idx, idx, m_bytes.c_str());
-                    m_bytes.erase(0, idx);
+                                     __FUNCTION__, idx, idx, bytes);
+                    ConsumeCachedBytes (idx);
+                    m_packet_scan_pos = 0;
                 }
                 break;
         }
@@ -442,8 +511,8 @@ GDBRemoteCommunication::CheckForPacket (const uint8_t *src, size_t src_len, Stri
         {
 
             // We have a valid packet...
-            assert (content_length <= m_bytes.size());
-            assert (total_length <= m_bytes.size());
+            assert (content_length <= bytes_len);
+            assert (total_length <= bytes_len);
             assert (content_length <= total_length);
             
             bool success = true;
@@ -459,22 +528,28 @@ GDBRemoteCommunication::CheckForPacket (const uint8_t *src, size_t src_len, Stri
                 if (!m_history.DidDumpToLog ())
                     m_history.Dump (log.get());
                 
-                log->Printf ("<%4zu> read packet: %.*s", total_length, (int)(total_length), m_bytes.c_str());
+                log->Printf ("<%4zu> read packet: %.*s", total_length, (int)(total_length), bytes);
             }
 
-            m_history.AddPacket (m_bytes.c_str(), total_length, History::ePacketTypeRecv, total_length);
+            m_history.AddPacket (bytes, total_length, History::ePacketTypeRecv, total_length);
+            static StatisticsCounter &g_packets_received = Statistics::GetCounter ("gdb-remote.packets.received");
+            static StatisticsCounter &g_bytes_received = Statistics::GetCounter ("gdb-remote.bytes.received");
+            g_packets_received.Add ();
+            g_bytes_received.Add (total_length);
 
-            packet_str.assign (m_bytes, content_start, content_length);
+            // This is the only copy the packet contents get, straight from
+            // where they were received into the packet
+            packet_str.assign (bytes + content_start, content_length);
             
-            if (m_bytes[0] == '$')
+            if (bytes[0] == '$')
             {
-                assert (checksum_idx < m_bytes.size());
-                if (::isxdigit (m_bytes[checksum_idx+0]) || 
-                    ::isxdigit (m_bytes[checksum_idx+1]))
+                assert (checksum_idx < bytes_len);
+                if (::isxdigit (bytes[checksum_idx+0]) || 
+                    ::isxdigit (bytes[checksum_idx+1]))
                 {
                     if (GetSendAcks ())
                     {
-                        const char *packet_checksum_cstr = &m_bytes[checksum_idx];
+                        const char packet_checksum_cstr[3] = { bytes[checksum_idx], bytes[checksum_idx+1], '\0' };
                         char packet_checksum = strtol (packet_checksum_cstr, NULL, 16);
                         char actual_checksum = CalculcateChecksum (packet_str.c_str(), packet_str.size());
                         success = packet_checksum == actual_checksum;
@@ -483,7 +558,7 @@ GDBRemoteCommunication::CheckForPacket (const uint8_t *src, size_t src_len, Stri
                             if (log)
                                 log->Printf ("error: checksum mismatch: %.*s expected 0x%2.2x, got 0x%2.2x", 
                                              (int)(total_length), 
-                                             m_bytes.c_str(),
+                                             bytes,
                                              (uint8_t)packet_checksum,
                                              (uint8_t)actual_checksum);
                         }
@@ -498,11 +573,21 @@ GDBRemoteCommunication::CheckForPacket (const uint8_t *src, size_t src_len, Stri
                 {
                     success = false;
                     if (log)
-                        log->Printf ("error: invalid checksum in packet: '%s'\n", m_bytes.c_str());
+                        log->Printf ("error: invalid checksum in packet: '%.*s'\n", (int)(total_length), bytes);
+                }
+
+                // The checksum covers the encoded bytes, so only expand
+                // run-length encoded packets once it has been checked
+                if (success && m_compression_enabled && packet_str.find ('*') != std::string::npos)
+                {
+                    success = DecodeRunLengthEncoding (packet_str);
+                    if (!success && log)
+                        log->Printf ("error: invalid run-length encoding in packet: '%.*s'\n", (int)(total_length), bytes);
                 }
             }
             
-            m_bytes.erase(0, total_length);
+            ConsumeCachedBytes (total_length);
+            m_packet_scan_pos = 0;
             packet.SetFilePos(0);
             return success;
         }
@@ -511,6 +596,73 @@ GDBRemoteCommunication::CheckForPacket (const uint8_t *src, size_t src_len, Stri
     return false;
 }
 
+void
+GDBRemoteCommunication::EncodeRunLengthEncoding (const char *payload,
+                                                 size_t payload_length,
+                                                 std::string &encoded)
+{
+    encoded.clear();
+    encoded.reserve (payload_length);
+    size_t i = 0;
+    while (i < payload_length)
+    {
+        const char ch = payload[i];
+        // The count character can be at most '~', 97 extra copies
+        size_t run_length = 1;
+        while (i + run_length < payload_length && payload[i + run_length] == ch && run_length < 98)
+            ++run_length;
+
+        // Counts below 3 would be control characters and aren't worth
+        // it anyway. Counts of 6 and 7 would be '#' and '$', so shorten
+        // those runs and let the rest go out on its own.
+        size_t extra_copies = run_length - 1;
+        if (extra_copies == 6 || extra_copies == 7)
+            extra_copies = 5;
+        if (extra_copies >= 3)
+        {
+            encoded += ch;
+            encoded += '*';
+            encoded += (char)(extra_copies + 29);
+            i += extra_copies + 1;
+        }
+        else
+        {
+            encoded.append (run_length, ch);
+            i += run_length;
+        }
+    }
+}
+
+bool
+GDBRemoteCommunication::DecodeRunLengthEncoding (std::string &packet_str)
+{
+    // A run of characters is sent as the character followed by a '*' and
+    // a count character that is the number of additional copies plus 29.
+    std::string decoded;
+    decoded.reserve (packet_str.size() * 2);
+    const size_t size = packet_str.size();
+    for (size_t i = 0; i < size; ++i)
+    {
+        const char ch = packet_str[i];
+        if (ch == '*')
+        {
+            if (decoded.empty() || i + 1 >= size)
+                return false;
+            const int repeat_count = (uint8_t)packet_str[++i] - 29;
+            if (repeat_count < 0 || repeat_count > 126 - 29)
+                return false;
+            const char repeat_char = decoded[decoded.size() - 1];
+            decoded.append (repeat_count, repeat_char);
+        }
+        else
+        {
+            decoded.push_back (ch);
+        }
+    }
+    packet_str.swap (decoded);
+    return true;
+}
+
 Error
 GDBRemoteCommunication::StartDebugserverProcess (const char *debugserver_url,
                                                  const char *unix_socket_name,  // For handshaking
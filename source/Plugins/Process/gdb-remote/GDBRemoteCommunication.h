@@ -12,6 +12,7 @@
 
 // C Includes
 // C++ Includes
+#include <deque>
 #include <list>
 #include <string>
 
@@ -77,6 +78,16 @@ public:
         return m_send_acks;
     }
 
+    //------------------------------------------------------------------
+    // Returns true if the remote side has agreed to run-length encode
+    // large packets it sends us (see QEnableCompression).
+    //------------------------------------------------------------------
+    bool
+    GetCompressionEnabled () const
+    {
+        return m_compression_enabled;
+    }
+
     //------------------------------------------------------------------
     // Client and server must implement these pure virtual functions
     //------------------------------------------------------------------
@@ -231,13 +242,38 @@ protected:
     SendPacketNoLock (const char *payload, 
                       size_t payload_length);
 
+    //------------------------------------------------------------------
+    // Wait for the reply to a packet. Notifications ("%..." packets)
+    // that arrive first are not replies, they are queued for
+    // WaitForPacketOrNotificationWithTimeoutMicroSecondsNoLock.
+    //------------------------------------------------------------------
     size_t
     WaitForPacketWithTimeoutMicroSecondsNoLock (StringExtractorGDBRemote &response, 
                                                 uint32_t timeout_usec);
 
+    //------------------------------------------------------------------
+    // Wait for a reply or a notification, whichever comes first.
+    // Queued notifications are returned before anything is read.
+    //------------------------------------------------------------------
+    size_t
+    WaitForPacketOrNotificationWithTimeoutMicroSecondsNoLock (StringExtractorGDBRemote &response,
+                                                              uint32_t timeout_usec);
+
     bool
     WaitForNotRunningPrivate (const lldb_private::TimeValue *timeout_ptr);
 
+    //------------------------------------------------------------------
+    // Expand the gdb remote protocol run-length encoding ("X*<count>")
+    // in a received packet. Returns false if the encoding is invalid.
+    //------------------------------------------------------------------
+    static bool
+    DecodeRunLengthEncoding (std::string &packet_str);
+
+    static void
+    EncodeRunLengthEncoding (const char *payload,
+                             size_t payload_length,
+                             std::string &encoded);
+
     //------------------------------------------------------------------
     // Classes that inherit from GDBRemoteCommunication can see and modify these
     //------------------------------------------------------------------
@@ -250,11 +286,14 @@ protected:
     lldb_private::Predicate<bool> m_public_is_running;
     lldb_private::Predicate<bool> m_private_is_running;
     History m_history;
+    size_t m_packet_scan_pos; // How far into the cached bytes we have already looked for the end of the current packet
     bool m_send_acks;
+    bool m_compression_enabled; // Set to true if packets we receive may be run-length encoded
+    uint32_t m_send_compression_min_size; // Run-length encode packets we send that are at least this long, zero for never
     bool m_is_platform; // Set to true if this class represents a platform,
                         // false if this class represents a debug session for
                         // a single process
-    
+    std::deque<std::string> m_notifications; // Notifications that arrived while waiting for replies, protected by m_sequence_mutex
 
 
 
@@ -262,6 +301,10 @@ private:
     //------------------------------------------------------------------
     // For GDBRemoteCommunication only
     //------------------------------------------------------------------
+    size_t
+    ReadPacketWithTimeoutMicroSecondsNoLock (StringExtractorGDBRemote &packet,
+                                             uint32_t timeout_usec);
+
     DISALLOW_COPY_AND_ASSIGN (GDBRemoteCommunication);
 };
 
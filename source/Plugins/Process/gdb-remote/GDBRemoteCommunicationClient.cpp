@@ -11,14 +11,23 @@
 #include "GDBRemoteCommunicationClient.h"
 
 // C Includes
+#include <errno.h>
+#include <limits.h>
+
 // C++ Includes
+#include <deque>
+#include <vector>
+
 // Other libraries and framework includes
 #include "llvm/ADT/Triple.h"
 #include "lldb/Interpreter/Args.h"
 #include "lldb/Core/ConnectionFileDescriptor.h"
+#include "lldb/Core/ConnectionSharedMemory.h"
 #include "lldb/Core/Log.h"
 #include "lldb/Core/State.h"
+#include "lldb/Core/Statistics.h"
 #include "lldb/Core/StreamString.h"
+#include "lldb/Core/UUID.h"
 #include "lldb/Host/Endian.h"
 #include "lldb/Host/Host.h"
 #include "lldb/Host/TimeValue.h"
@@ -56,11 +65,22 @@ GDBRemoteCommunicationClient::GDBRemoteCommunicationClient(bool is_platform) :
     m_watchpoints_trigger_after_instruction(eLazyBoolCalculate),
     m_attach_or_wait_reply(eLazyBoolCalculate),
     m_prepare_for_reg_writing_reply (eLazyBoolCalculate),
+    m_supports_x (eLazyBoolCalculate),
+    m_supports_breakpoint_conditions (eLazyBoolCalculate),
+    m_qSupported_is_valid (eLazyBoolCalculate),
+    m_supports_QNonStop (eLazyBoolCalculate),
     m_supports_qProcessInfoPID (true),
     m_supports_qfProcessInfo (true),
     m_supports_qUserName (true),
     m_supports_qGroupName (true),
+    m_supports_qModuleUUID (true),
+    m_supports_vFile (true),
     m_supports_qThreadStopInfo (true),
+    m_supports_qThreadsStopInfo (true),
+    m_supports_qShlibInfos (true),
+    m_supports_qSearchMemory (true),
+    m_supports_qMultiMemRead (true),
+    m_supports_qMemoryRegionInfos (true),
     m_supports_z0 (true),
     m_supports_z1 (true),
     m_supports_z2 (true),
@@ -69,6 +89,10 @@ GDBRemoteCommunicationClient::GDBRemoteCommunicationClient(bool is_platform) :
     m_curr_tid (LLDB_INVALID_THREAD_ID),
     m_curr_tid_run (LLDB_INVALID_THREAD_ID),
     m_num_supported_hardware_watchpoints (0),
+    m_max_packet_size (0),
+    m_non_stop_mode (false),
+    m_all_threads_stopped (true),
+    m_non_stop_stop_replies (),
     m_async_mutex (Mutex::eMutexTypeRecursive),
     m_async_packet_predicate (false),
     m_async_packet (),
@@ -123,6 +147,52 @@ GDBRemoteCommunicationClient::QueryNoAckModeSupported ()
     }
 }
 
+bool
+GDBRemoteCommunicationClient::EnableCompression (uint32_t min_size)
+{
+    m_compression_enabled = false;
+    if (min_size > 0)
+    {
+        char packet[64];
+        const int packet_len = ::snprintf (packet, sizeof(packet), "QEnableCompression:type:rle;minsize:%x;", min_size);
+        assert (packet_len < (int)sizeof(packet));
+        StringExtractorGDBRemote response;
+        if (SendPacketAndWaitForResponse(packet, packet_len, response, false))
+        {
+            if (response.IsOKResponse())
+                m_compression_enabled = true;
+        }
+    }
+    return m_compression_enabled;
+}
+
+bool
+GDBRemoteCommunicationClient::StartSharedMemoryTransport (ConnectionSharedMemory &connection, size_t ring_size)
+{
+    // Acks would have to switch over to shared memory in the middle of
+    // the packet exchange that starts it, and aren't needed once it has
+    if (GetSendAcks ())
+        return false;
+    if (!connection.Create (ring_size, NULL))
+        return false;
+
+    StreamString packet;
+    packet.Printf ("QStartSharedMemory:%s;", connection.GetName());
+    StringExtractorGDBRemote response;
+    if (SendPacketAndWaitForResponse(packet.GetData(), packet.GetSize(), response, false))
+    {
+        // The stub sent the OK the old way and everything after it
+        // goes through shared memory
+        if (response.IsOKResponse())
+        {
+            connection.Activate ();
+            return true;
+        }
+    }
+    connection.Abandon ();
+    return false;
+}
+
 void
 GDBRemoteCommunicationClient::GetListThreadsInStopReplySupported ()
 {
@@ -179,6 +249,107 @@ GDBRemoteCommunicationClient::GetSyncThreadStateSupported ()
         return false;
 }
 
+bool
+GDBRemoteCommunicationClient::GetxPacketSupported ()
+{
+    if (m_supports_x == eLazyBoolCalculate)
+    {
+        m_supports_x = eLazyBoolNo;
+
+        // A zero length binary memory read is answered with "OK" by stubs
+        // that support the packet, and with an empty response by those
+        // that don't.
+        StringExtractorGDBRemote response;
+        if (SendPacketAndWaitForResponse("x0,0", response, false))
+        {
+            if (response.IsOKResponse())
+                m_supports_x = eLazyBoolYes;
+        }
+    }
+    return m_supports_x == eLazyBoolYes;
+}
+
+bool
+GDBRemoteCommunicationClient::GetBreakpointConditionsSupported ()
+{
+    if (m_supports_breakpoint_conditions == eLazyBoolCalculate)
+    {
+        m_supports_breakpoint_conditions = eLazyBoolNo;
+
+        StringExtractorGDBRemote response;
+        if (SendPacketAndWaitForResponse("qBreakpointConditionsSupported", response, false))
+        {
+            if (response.IsOKResponse())
+                m_supports_breakpoint_conditions = eLazyBoolYes;
+        }
+    }
+    return m_supports_breakpoint_conditions == eLazyBoolYes;
+}
+
+uint64_t
+GDBRemoteCommunicationClient::GetRemoteMaxPacketSize ()
+{
+    if (m_qSupported_is_valid == eLazyBoolCalculate)
+    {
+        m_qSupported_is_valid = eLazyBoolNo;
+        m_max_packet_size = 0;
+
+        // The reply is a list of "name=value", "name+" and "name-" items
+        // separated by semicolons.
+        StringExtractorGDBRemote response;
+        if (SendPacketAndWaitForResponse("qSupported", response, false) &&
+            response.IsNormalResponse())
+        {
+            m_qSupported_is_valid = eLazyBoolYes;
+            const std::string &reply = response.GetStringRef();
+            size_t item_start = 0;
+            while (item_start < reply.size())
+            {
+                size_t item_end = reply.find (';', item_start);
+                if (item_end == std::string::npos)
+                    item_end = reply.size();
+                const std::string item (reply, item_start, item_end - item_start);
+                if (item.compare (0, strlen("PacketSize="), "PacketSize=") == 0)
+                    m_max_packet_size = Args::StringToUInt64 (item.c_str() + strlen("PacketSize="), 0, 16);
+                item_start = item_end + 1;
+            }
+        }
+    }
+    return m_max_packet_size;
+}
+
+bool
+GDBRemoteCommunicationClient::SetNonStopMode (bool enable)
+{
+    if (m_supports_QNonStop == eLazyBoolNo)
+        return false;
+
+    StringExtractorGDBRemote response;
+    if (SendPacketAndWaitForResponse(enable ? "QNonStop:1" : "QNonStop:0", response, false))
+    {
+        if (response.IsOKResponse())
+        {
+            m_supports_QNonStop = eLazyBoolYes;
+            m_non_stop_mode = enable;
+            return true;
+        }
+        if (response.IsUnsupportedResponse())
+            m_supports_QNonStop = eLazyBoolNo;
+    }
+    return false;
+}
+
+bool
+GDBRemoteCommunicationClient::SetEnableAsyncProfiling (bool enable, uint32_t interval_usec, uint32_t max_frames, uint32_t scan_type)
+{
+    StreamString packet;
+    packet.Printf ("QSetEnableAsyncProfiling;enable:%d;interval_usec:%u;frames:%u;scan_type:0x%x;", enable ? 1 : 0, interval_usec, max_frames, scan_type);
+    StringExtractorGDBRemote response;
+    // Profiling is usually turned on and off while the process runs
+    if (SendPacketAndWaitForResponse(packet.GetData(), packet.GetSize(), response, true))
+        return response.IsOKResponse();
+    return false;
+}
 
 void
 GDBRemoteCommunicationClient::ResetDiscoverableSettings()
@@ -195,12 +366,27 @@ GDBRemoteCommunicationClient::ResetDiscoverableSettings()
     m_supports_memory_region_info = eLazyBoolCalculate;
     m_prepare_for_reg_writing_reply = eLazyBoolCalculate;
     m_attach_or_wait_reply = eLazyBoolCalculate;
+    m_supports_x = eLazyBoolCalculate;
+    m_supports_breakpoint_conditions = eLazyBoolCalculate;
+    m_qSupported_is_valid = eLazyBoolCalculate;
+    m_supports_QNonStop = eLazyBoolCalculate;
+    m_max_packet_size = 0;
+    m_non_stop_mode = false;
+    m_all_threads_stopped = true;
+    m_non_stop_stop_replies.clear();
 
     m_supports_qProcessInfoPID = true;
     m_supports_qfProcessInfo = true;
     m_supports_qUserName = true;
     m_supports_qGroupName = true;
+    m_supports_qModuleUUID = true;
+    m_supports_vFile = true;
     m_supports_qThreadStopInfo = true;
+    m_supports_qThreadsStopInfo = true;
+    m_supports_qShlibInfos = true;
+    m_supports_qSearchMemory = true;
+    m_supports_qMultiMemRead = true;
+    m_supports_qMemoryRegionInfos = true;
     m_supports_z0 = true;
     m_supports_z1 = true;
     m_supports_z2 = true;
@@ -312,8 +498,13 @@ GDBRemoteCommunicationClient::SendPacketAndWaitForResponse
     size_t response_len = 0;
     if (GetSequenceMutex (locker))
     {
+        const TimeValue start_time (TimeValue::Now());
         if (SendPacketNoLock (payload, payload_length))
-           response_len = WaitForPacketWithTimeoutMicroSecondsNoLock (response, GetPacketTimeoutInMicroSeconds ());
+        {
+            response_len = WaitForPacketWithTimeoutMicroSecondsNoLock (response, GetPacketTimeoutInMicroSeconds ());
+            static StatisticsHistogram &g_round_trip = Statistics::GetHistogram ("gdb-remote.round-trip-usec");
+            g_round_trip.Add (TimeValue::Now().GetAsMicroSecondsSinceJan1_1970() - start_time.GetAsMicroSecondsSinceJan1_1970());
+        }
         else 
         {
             if (log)
@@ -421,6 +612,97 @@ GDBRemoteCommunicationClient::SendPacketAndWaitForResponse
     return response_len;
 }
 
+size_t
+GDBRemoteCommunicationClient::SendPacketsAndWaitForResponses
+(
+    const std::vector<std::string> &payloads,
+    std::vector<StringExtractorGDBRemote> &responses
+)
+{
+    responses.clear();
+    if (payloads.empty())
+        return 0;
+
+    LogSP log (ProcessGDBRemoteLog::GetLogIfAllCategoriesSet (GDBR_LOG_PROCESS));
+    Mutex::Locker locker;
+    if (!GetSequenceMutex (locker))
+    {
+        if (log)
+            log->Printf("error: failed to get packet sequence mutex, not sending %zu pipelined packets", payloads.size());
+        return 0;
+    }
+
+    const size_t num_payloads = payloads.size();
+    responses.resize (num_payloads);
+    const uint32_t timeout_usec = GetPacketTimeoutInMicroSeconds ();
+    size_t num_responses = 0;
+    if (GetPipelinedPacketsSupported ())
+    {
+        size_t num_sent = 0;
+        while (num_sent < num_payloads)
+        {
+            if (SendPacketNoLock (payloads[num_sent].data(), payloads[num_sent].size()) == 0)
+            {
+                if (log)
+                    log->Printf("error: failed to send '%s'", payloads[num_sent].c_str());
+                break;
+            }
+            ++num_sent;
+        }
+
+        // Every packet that made it out will get a response, so we must
+        // read them all to keep the packets and responses in sync.
+        while (num_responses < num_sent)
+        {
+            if (WaitForPacketWithTimeoutMicroSecondsNoLock (responses[num_responses], timeout_usec) == 0)
+                break;
+            ++num_responses;
+        }
+
+        if (num_responses < num_sent)
+        {
+            // A response timed out, but the stub may still be working on
+            // it. Read and drop the responses that are still outstanding
+            // so the next packet isn't paired with one of them. If they
+            // don't show up either, there is no telling which response
+            // belongs to which packet anymore, so give up on the
+            // connection.
+            size_t num_drained = num_responses;
+            StringExtractorGDBRemote late_response;
+            while (num_drained < num_sent)
+            {
+                if (WaitForPacketWithTimeoutMicroSecondsNoLock (late_response, timeout_usec) == 0)
+                    break;
+                ++num_drained;
+            }
+            if (num_drained < num_sent)
+            {
+                if (log)
+                    log->Printf("error: %zu pipelined responses never arrived, disconnecting", num_sent - num_drained);
+                Disconnect();
+            }
+        }
+    }
+    else
+    {
+        while (num_responses < num_payloads)
+        {
+            if (SendPacketNoLock (payloads[num_responses].data(), payloads[num_responses].size()) == 0 ||
+                WaitForPacketWithTimeoutMicroSecondsNoLock (responses[num_responses], timeout_usec) == 0)
+                break;
+            ++num_responses;
+        }
+    }
+
+    if (num_responses < num_payloads)
+    {
+        if (log)
+            log->Printf("error: only got %zu of %zu responses for pipelined packets", num_responses, num_payloads);
+        responses.resize (num_responses);
+    }
+    return num_responses;
+}
+
 StateType
 GDBRemoteCommunicationClient::SendContinuePacketAndWaitForResponse
 (
@@ -445,6 +727,9 @@ GDBRemoteCommunicationClient::SendContinuePacketAndWaitForResponse
     std::string continue_packet(payload, packet_length);
     
     bool got_stdout = false;
+    bool resume_acknowledged = false;
+    m_all_threads_stopped = true;
+    m_non_stop_stop_replies.clear();
     
     while (state == eStateRunning)
     {
@@ -454,6 +739,7 @@ GDBRemoteCommunicationClient::SendContinuePacketAndWaitForResponse
                 log->Printf ("GDBRemoteCommunicationClient::%s () sending continue packet: %s", __FUNCTION__, continue_packet.c_str());
             if (SendPacketNoLock(continue_packet.c_str(), continue_packet.size()) == 0)
                 state = eStateInvalid;
+            resume_acknowledged = false;
         
             m_private_is_running.SetValue (true, eBroadcastAlways);
         }
@@ -463,12 +749,43 @@ GDBRemoteCommunicationClient::SendContinuePacketAndWaitForResponse
         if (log)
             log->Printf ("GDBRemoteCommunicationClient::%s () WaitForPacket(%s)", __FUNCTION__, continue_packet.c_str());
 
-        if (WaitForPacketWithTimeoutMicroSecondsNoLock(response, UINT32_MAX))
+        // Once the stub has acknowledged the resume in non-stop mode, a
+        // "%Stop" notification that came in while the process was stopped
+        // is handled here, as if it had come in just now. Before that the
+        // "OK" must be read first, or the "vStopped" packets sent for the
+        // notification would get it as their reply.
+        size_t response_len;
+        if (resume_acknowledged)
+            response_len = WaitForPacketOrNotificationWithTimeoutMicroSecondsNoLock(response, UINT32_MAX);
+        else
+            response_len = WaitForPacketWithTimeoutMicroSecondsNoLock(response, UINT32_MAX);
+        if (response_len)
         {
             if (response.Empty())
                 state = eStateInvalid;
+            else if (m_non_stop_mode && response.IsOKResponse())
+            {
+                // In non-stop mode the resume packet is acknowledged right
+                // away, keep waiting for a stop without resending it
+                got_stdout = true;
+                resume_acknowledged = true;
+            }
             else
             {
+                if (m_non_stop_mode && response.GetStringRef().compare (0, strlen("%Stop:"), "%Stop:") == 0)
+                {
+                    // Some threads stopped while the others keep running.
+                    // The notification has the stop reply for one of them,
+                    // get the others with "vStopped" until we get "OK".
+                    response.GetStringRef().erase (0, strlen("%Stop:"));
+                    response.SetFilePos (0);
+                    m_all_threads_stopped = false;
+                    StringExtractorGDBRemote stopped_response;
+                    while (SendPacketAndWaitForResponse ("vStopped", stopped_response, false) &&
+                           stopped_response.IsNormalResponse())
+                        m_non_stop_stop_replies.push_back (stopped_response.GetStringRef());
+                }
+
                 const char stop_type = response.GetChar();
                 if (log)
                     log->Printf ("GDBRemoteCommunicationClient::%s () got packet: %s", __FUNCTION__, response.GetStringRef().c_str());
@@ -651,6 +968,18 @@ GDBRemoteCommunicationClient::SendContinuePacketAndWaitForResponse
                     }
                     break;
 
+                case 'A':
+                    // Async profile data
+                    {
+                        std::string profile_data;
+                        profile_data.reserve(response.GetBytesLeft () / 2);
+                        char ch;
+                        while ((ch = response.GetHexU8()) != '\0')
+                            profile_data.append(1, ch);
+                        process->BroadcastAsyncProfileData (profile_data.c_str(), profile_data.size());
+                    }
+                    break;
+
                 case 'E':
                     // ERROR
                     state = eStateInvalid;
@@ -1365,6 +1694,249 @@ GDBRemoteCommunicationClient::GetMemoryRegionInfo (lldb::addr_t addr,
 
 }
 
+bool
+GDBRemoteCommunicationClient::GetMemoryRegionInfos (std::vector<MemoryRegionInfo> &regions, Error &error)
+{
+    regions.clear();
+    if (!m_supports_qMemoryRegionInfos)
+        return false;
+
+    addr_t addr = 0;
+    while (true)
+    {
+        char packet[64];
+        const int packet_len = ::snprintf(packet, sizeof(packet), "qMemoryRegionInfos:%llx", (uint64_t)addr);
+        assert (packet_len < sizeof(packet));
+        StringExtractorGDBRemote response;
+        if (!SendPacketAndWaitForResponse (packet, packet_len, response, false))
+        {
+            error.SetErrorString ("failed to send qMemoryRegionInfos packet");
+            return true;
+        }
+
+        if (response.IsUnsupportedResponse())
+        {
+            m_supports_qMemoryRegionInfos = false;
+            return false;
+        }
+
+        if (response.IsErrorResponse())
+        {
+            error.SetErrorStringWithFormat ("gdb remote returned an error: %s", response.GetStringRef().c_str());
+            return true;
+        }
+
+        // "OK" means there are no more mapped regions
+        if (response.IsOKResponse())
+            break;
+
+        // Each region is a "start", "size" and "permissions" key, and the
+        // response ends with a "next" key if the stub has more to send
+        std::string name;
+        std::string value;
+        addr_t next_addr = LLDB_INVALID_ADDRESS;
+        MemoryRegionInfo region_info;
+        while (response.GetNameColonValue(name, value))
+        {
+            if (name.compare ("start") == 0)
+            {
+                if (region_info.GetRange().IsValid())
+                    regions.push_back (region_info);
+                region_info.Clear();
+                region_info.GetRange().SetRangeBase (Args::StringToUInt64(value.c_str(), LLDB_INVALID_ADDRESS, 16));
+            }
+            else if (name.compare ("size") == 0)
+            {
+                region_info.GetRange().SetByteSize (Args::StringToUInt64(value.c_str(), 0, 16));
+            }
+            else if (name.compare ("permissions") == 0)
+            {
+                region_info.SetReadable (value.find('r') != std::string::npos ? MemoryRegionInfo::eYes : MemoryRegionInfo::eNo);
+                region_info.SetWritable (value.find('w') != std::string::npos ? MemoryRegionInfo::eYes : MemoryRegionInfo::eNo);
+                region_info.SetExecutable (value.find('x') != std::string::npos ? MemoryRegionInfo::eYes : MemoryRegionInfo::eNo);
+            }
+            else if (name.compare ("next") == 0)
+            {
+                next_addr = Args::StringToUInt64(value.c_str(), LLDB_INVALID_ADDRESS, 16);
+            }
+        }
+        if (region_info.GetRange().IsValid())
+            regions.push_back (region_info);
+
+        if (next_addr == LLDB_INVALID_ADDRESS || next_addr <= addr)
+            break;
+        addr = next_addr;
+    }
+    error.Clear();
+    return true;
+}
+
+Error
+GDBRemoteCommunicationClient::GetSharedLibraryInfos (lldb::addr_t image_infos_addr,
+                                                     uint32_t image_infos_count,
+                                                     std::string &infos)
+{
+    Error error;
+    if (m_supports_qShlibInfos)
+    {
+        char packet[64];
+        const int packet_len = ::snprintf(packet, sizeof(packet), "qShlibInfos:%llx,%x", (uint64_t)image_infos_addr, image_infos_count);
+        assert (packet_len < (int)sizeof(packet));
+        StringExtractorGDBRemote response;
+        if (SendPacketAndWaitForResponse (packet, packet_len, response, false))
+        {
+            if (response.IsUnsupportedResponse())
+                m_supports_qShlibInfos = false;
+            else if (response.IsNormalResponse())
+                infos.swap (response.GetStringRef());
+            else
+                error.SetErrorString ("qShlibInfos failed");
+        }
+        else
+        {
+            m_supports_qShlibInfos = false;
+        }
+    }
+
+    if (!m_supports_qShlibInfos)
+        error.SetErrorString ("qShlibInfos is not supported");
+    return error;
+}
+
+bool
+GDBRemoteCommunicationClient::SearchMemory (lldb::addr_t addr,
+                                            lldb::addr_t length,
+                                            const uint8_t *pattern,
+                                            size_t pattern_size,
+                                            lldb::addr_t &match_addr,
+                                            Error &error)
+{
+    match_addr = LLDB_INVALID_ADDRESS;
+    if (!m_supports_qSearchMemory)
+        return false;
+
+    StreamString packet;
+    packet.Printf ("qSearchMemory:%llx,%llx:", (uint64_t)addr, (uint64_t)length);
+    packet.PutBytesAsRawHex8 (pattern, pattern_size);
+
+    LogSP log (ProcessGDBRemoteLog::GetLogIfAllCategoriesSet (GDBR_LOG_PROCESS));
+    Mutex::Locker locker;
+    if (!GetSequenceMutex (locker))
+    {
+        error.SetErrorString ("failed to get packet sequence mutex, not sending qSearchMemory packet");
+        return true;
+    }
+
+    StringExtractorGDBRemote response;
+    size_t response_len = 0;
+    if (SendPacketNoLock (packet.GetData(), packet.GetSize()))
+    {
+        const uint32_t timeout_usec = GetPacketTimeoutInMicroSeconds ();
+        response_len = WaitForPacketWithTimeoutMicroSecondsNoLock (response, timeout_usec);
+        if (response_len == 0)
+        {
+            // The stub may still be searching. Its answer must not be taken
+            // for the response to the next packet, so give it another
+            // timeout period, and give up on the connection if it still
+            // doesn't answer.
+            response_len = WaitForPacketWithTimeoutMicroSecondsNoLock (response, timeout_usec);
+            if (response_len == 0)
+            {
+                if (log)
+                    log->Printf("error: qSearchMemory response never arrived, disconnecting");
+                Disconnect();
+            }
+        }
+    }
+
+    if (response_len > 0)
+    {
+        if (response.IsUnsupportedResponse())
+        {
+            m_supports_qSearchMemory = false;
+            return false;
+        }
+
+        switch (response.GetChar())
+        {
+            case '0':
+                break;
+
+            case '1':
+                if (response.GetChar() == ',')
+                    match_addr = response.GetHexMaxU64 (false, LLDB_INVALID_ADDRESS);
+                else
+                    error.SetErrorString ("invalid qSearchMemory response");
+                break;
+
+            default:
+                error.SetErrorStringWithFormat ("qSearchMemory failed: %s", response.GetStringRef().c_str());
+                break;
+        }
+        return true;
+    }
+
+    error.SetErrorString ("failed to send qSearchMemory packet");
+    return true;
+}
+
+bool
+GDBRemoteCommunicationClient::ReadMemoryRanges (MemoryReadRange *ranges, size_t num_ranges, Error &error)
+{
+    if (!m_supports_qMultiMemRead)
+        return false;
+
+    StreamString packet;
+    packet.PutCString ("qMultiMemRead:");
+    for (size_t i=0; i<num_ranges; ++i)
+    {
+        ranges[i].bytes_read = 0;
+        packet.Printf ("%llx,%zx;", (uint64_t)ranges[i].addr, ranges[i].size);
+    }
+
+    StringExtractorGDBRemote response;
+    if (!SendPacketAndWaitForResponse (packet.GetData(), packet.GetSize(), response, false))
+    {
+        error.SetErrorString ("failed to send qMultiMemRead packet");
+        return true;
+    }
+
+    if (response.IsUnsupportedResponse())
+    {
+        m_supports_qMultiMemRead = false;
+        return false;
+    }
+
+    if (response.IsErrorResponse())
+    {
+        error.SetErrorStringWithFormat ("gdb remote returned an error: %s", response.GetStringRef().c_str());
+        return true;
+    }
+
+    // The response is the number of bytes read from each range followed
+    // by all of the bytes: "<count>,<count>,...;<hex bytes>"
+    std::vector<size_t> counts (num_ranges, 0);
+    for (size_t i=0; i<num_ranges; ++i)
+    {
+        const uint64_t count = response.GetHexMaxU64 (false, UINT64_MAX);
+        const char separator = response.GetChar();
+        if (count > ranges[i].size || separator != (i + 1 < num_ranges ? ',' : ';'))
+        {
+            error.SetErrorString ("invalid qMultiMemRead response");
+            return true;
+        }
+        counts[i] = count;
+    }
+
+    for (size_t i=0; i<num_ranges; ++i)
+    {
+        if (counts[i] > 0)
+            ranges[i].bytes_read = response.GetHexBytes (ranges[i].buf, counts[i], '\xdd');
+    }
+    error.Clear();
+    return true;
+}
+
 Error
 GDBRemoteCommunicationClient::GetWatchpointSupportInfo (uint32_t &num)
 {
@@ -1785,8 +2357,392 @@ GDBRemoteCommunicationClient::GetGroupName (uint32_t gid, std::string &name)
     return false;
 }
 
+bool
+GDBRemoteCommunicationClient::GetModuleUUID (const FileSpec &file_spec, UUID &uuid)
+{
+    if (m_supports_qModuleUUID)
+    {
+        char path[PATH_MAX];
+        if (!file_spec.GetPath (path, sizeof(path)))
+            return false;
+        StreamString packet;
+        packet.PutCString ("qModuleUUID:");
+        packet.PutCStringAsRawHex8 (path);
+        StringExtractorGDBRemote response;
+        if (SendPacketAndWaitForResponse (packet.GetData(), packet.GetSize(), response, false))
+        {
+            if (response.IsUnsupportedResponse())
+                m_supports_qModuleUUID = false;
+            else if (response.IsNormalResponse())
+                return uuid.SetfromCString (response.GetStringRef().c_str()) > 0;
+        }
+    }
+    return false;
+}
+
+// Parse the "F<result>[,<errno>]" part of a vFile reply. Returns the
+// result, and fills in error if it was negative.
+static int64_t
+ParseFileIOResponse (StringExtractorGDBRemote &response, Error &error)
+{
+    if (response.GetChar() != 'F')
+    {
+        error.SetErrorString ("invalid file I/O response");
+        return -1;
+    }
+    int64_t result;
+    if (response.Peek() && *response.Peek() == '-')
+    {
+        response.GetChar();
+        result = -(int64_t)response.GetHexMaxU64 (false, 1);
+        if (response.GetChar() == ',')
+            error.SetError (response.GetHexMaxU32 (false, EIO), eErrorTypePOSIX);
+        else
+            error.SetErrorString ("file I/O failed");
+    }
+    else
+    {
+        result = response.GetHexMaxU64 (false, 0);
+        error.Clear();
+    }
+    return result;
+}
+
+lldb::user_id_t
+GDBRemoteCommunicationClient::OpenFile (const FileSpec &file_spec, uint32_t flags, uint32_t mode, Error &error)
+{
+    char path[PATH_MAX];
+    if (!m_supports_vFile || !file_spec.GetPath (path, sizeof(path)))
+    {
+        error.SetErrorString ("remote file I/O isn't supported");
+        return UINT64_MAX;
+    }
+    StreamString packet;
+    packet.PutCString ("vFile:open:");
+    packet.PutCStringAsRawHex8 (path);
+    packet.Printf (",%x,%x", flags, mode);
+    StringExtractorGDBRemote response;
+    if (!SendPacketAndWaitForResponse (packet.GetData(), packet.GetSize(), response, false))
+    {
+        error.SetErrorString ("no response to vFile:open");
+        return UINT64_MAX;
+    }
+    if (response.IsUnsupportedResponse())
+    {
+        m_supports_vFile = false;
+        error.SetErrorString ("remote file I/O isn't supported");
+        return UINT64_MAX;
+    }
+    const int64_t fd = ParseFileIOResponse (response, error);
+    return fd < 0 ? UINT64_MAX : fd;
+}
+
+bool
+GDBRemoteCommunicationClient::CloseFile (lldb::user_id_t fd, Error &error)
+{
+    char packet[64];
+    const int packet_len = ::snprintf (packet, sizeof (packet), "vFile:close:%llx", fd);
+    assert (packet_len < sizeof(packet));
+    StringExtractorGDBRemote response;
+    if (!SendPacketAndWaitForResponse (packet, packet_len, response, false))
+    {
+        error.SetErrorString ("no response to vFile:close");
+        return false;
+    }
+    return ParseFileIOResponse (response, error) == 0;
+}
+
+// Copy the data out of a "vFile:pread" reply
+static uint64_t
+ParseReadFileResponse (StringExtractorGDBRemote &response, void *dst, uint64_t dst_len, Error &error)
+{
+    const int64_t count = ParseFileIOResponse (response, error);
+    if (count <= 0)
+        return 0;
+    if (response.GetChar() != ';')
+    {
+        error.SetErrorString ("invalid vFile:pread response");
+        return 0;
+    }
+
+    // The data is binary, with '}' escaping the bytes that can't appear
+    // in a packet
+    const std::string &data = response.GetStringRef();
+    uint8_t *dst_bytes = (uint8_t *)dst;
+    uint64_t bytes_copied = 0;
+    for (size_t i = response.GetFilePos(); i < data.size() && bytes_copied < dst_len; ++i)
+    {
+        uint8_t ch = data[i];
+        if (ch == '}' && i + 1 < data.size())
+            ch = data[++i] ^ 0x20;
+        dst_bytes[bytes_copied++] = ch;
+    }
+    if (bytes_copied != (uint64_t)count)
+    {
+        error.SetErrorStringWithFormat ("vFile:pread returned %llu bytes, expected %llu", bytes_copied, (uint64_t)count);
+        return 0;
+    }
+    return bytes_copied;
+}
+
+uint64_t
+GDBRemoteCommunicationClient::ReadFile (lldb::user_id_t fd,
+                                        uint64_t offset,
+                                        void *dst,
+                                        uint64_t dst_len,
+                                        Error &error)
+{
+    char packet[128];
+    const int packet_len = ::snprintf (packet, sizeof (packet), "vFile:pread:%llx,%llx,%llx", fd, dst_len, offset);
+    assert (packet_len < sizeof(packet));
+    StringExtractorGDBRemote response;
+    if (!SendPacketAndWaitForResponse (packet, packet_len, response, false))
+    {
+        error.SetErrorString ("no response to vFile:pread");
+        return 0;
+    }
+    return ParseReadFileResponse (response, dst, dst_len, error);
+}
+
+// Append binary data to a packet, escaping the bytes that can't appear
+// in one as '}' followed by the byte xor'ed with 0x20
+static void
+PutEscapedBinary (StreamString &packet, const uint8_t *src, size_t src_len)
+{
+    for (size_t i = 0; i < src_len; ++i)
+    {
+        const char ch = src[i];
+        if (ch == '#' || ch == '$' || ch == '}' || ch == '*')
+        {
+            packet.PutChar ('}');
+            packet.PutChar (ch ^ 0x20);
+        }
+        else
+            packet.PutChar (ch);
+    }
+}
+
+uint64_t
+GDBRemoteCommunicationClient::WriteFile (lldb::user_id_t fd,
+                                         uint64_t offset,
+                                         const void *src,
+                                         uint64_t src_len,
+                                         Error &error)
+{
+    StreamString packet;
+    packet.Printf ("vFile:pwrite:%llx,%llx,", fd, offset);
+    PutEscapedBinary (packet, (const uint8_t *)src, src_len);
+    StringExtractorGDBRemote response;
+    if (!SendPacketAndWaitForResponse (packet.GetData(), packet.GetSize(), response, false))
+    {
+        error.SetErrorString ("no response to vFile:pwrite");
+        return 0;
+    }
+    const int64_t bytes_written = ParseFileIOResponse (response, error);
+    return bytes_written < 0 ? 0 : bytes_written;
+}
+
+// Each file transfer packet carries this much of the file
+#define FILE_TRANSFER_CHUNK_SIZE (128 * 1024)
+// Number of file transfer requests to keep in flight when acks are off
+#define FILE_TRANSFER_WINDOW_SIZE 8
+// Replies at least this large are compressed when a download asks for it
+#define FILE_TRANSFER_COMPRESSION_MIN_SIZE 0x400
+
+Error
+GDBRemoteCommunicationClient::DownloadFile (const FileSpec &remote_file,
+                                            const FileSpec &local_file,
+                                            bool compress)
+{
+    Error error;
+    char local_path[PATH_MAX];
+    if (!local_file.GetPath (local_path, sizeof(local_path)))
+    {
+        error.SetErrorString ("invalid local path");
+        return error;
+    }
+
+    if (compress && !m_compression_enabled)
+        EnableCompression (FILE_TRANSFER_COMPRESSION_MIN_SIZE);
+
+    const lldb::user_id_t fd = OpenFile (remote_file, eFileOpenReadOnly, 0, error);
+    if (fd == UINT64_MAX)
+        return error;
+
+    FILE *file = ::fopen (local_path, "wb");
+    if (file == NULL)
+    {
+        error.SetErrorToErrno();
+        Error close_error;
+        CloseFile (fd, close_error);
+        return error;
+    }
+
+    Mutex::Locker locker;
+    if (GetSequenceMutex (locker))
+    {
+        // With acks on, the ack for one request can't be told apart from
+        // the reply to another, so only pipeline requests without them.
+        // The remote side answers requests in the order they were sent.
+        const uint32_t window_size = GetSendAcks() ? 1 : FILE_TRANSFER_WINDOW_SIZE;
+        std::vector<uint8_t> buffer (FILE_TRANSFER_CHUNK_SIZE);
+        uint64_t request_offset = 0;
+        uint32_t num_outstanding = 0;
+        bool eof = false;
+        while (error.Success())
+        {
+            while (!eof && num_outstanding < window_size)
+            {
+                char packet[128];
+                const int packet_len = ::snprintf (packet, sizeof (packet), "vFile:pread:%llx,%x,%llx", fd, FILE_TRANSFER_CHUNK_SIZE, request_offset);
+                if (SendPacketNoLock (packet, packet_len) == 0)
+                {
+                    error.SetErrorString ("failed to send vFile:pread");
+                    break;
+                }
+                request_offset += FILE_TRANSFER_CHUNK_SIZE;
+                ++num_outstanding;
+            }
+            if (num_outstanding == 0 || error.Fail())
+                break;
+
+            StringExtractorGDBRemote response;
+            if (WaitForPacketWithTimeoutMicroSecondsNoLock (response, GetPacketTimeoutInMicroSeconds ()) == 0)
+            {
+                error.SetErrorString ("no response to vFile:pread");
+                break;
+            }
+            --num_outstanding;
+
+            // Requests we sent past the end of the file just return nothing
+            if (eof)
+                continue;
+
+            const uint64_t bytes_read = ParseReadFileResponse (response, &buffer[0], buffer.size(), error);
+            if (bytes_read > 0 && ::fwrite (&buffer[0], 1, bytes_read, file) != bytes_read)
+                error.SetErrorToErrno();
+            if (bytes_read < FILE_TRANSFER_CHUNK_SIZE)
+                eof = true;
+        }
+
+        // Don't leave replies behind for whoever sends the next packet
+        while (num_outstanding > 0)
+        {
+            StringExtractorGDBRemote response;
+            if (WaitForPacketWithTimeoutMicroSecondsNoLock (response, GetPacketTimeoutInMicroSeconds ()) == 0)
+                break;
+            --num_outstanding;
+        }
+    }
+    else
+    {
+        error.SetErrorString ("the connection is busy");
+    }
+
+    ::fclose (file);
+    Error close_error;
+    CloseFile (fd, close_error);
+    return error;
+}
+
+Error
+GDBRemoteCommunicationClient::UploadFile (const FileSpec &local_file,
+                                          const FileSpec &remote_file,
+                                          uint32_t mode)
+{
+    Error error;
+    char local_path[PATH_MAX];
+    if (!local_file.GetPath (local_path, sizeof(local_path)))
+    {
+        error.SetErrorString ("invalid local path");
+        return error;
+    }
+
+    FILE *file = ::fopen (local_path, "rb");
+    if (file == NULL)
+    {
+        error.SetErrorToErrno();
+        return error;
+    }
+
+    const lldb::user_id_t fd = OpenFile (remote_file, eFileOpenWriteOnly | eFileOpenCreate | eFileOpenTruncate, mode, error);
+    if (fd == UINT64_MAX)
+    {
+        ::fclose (file);
+        return error;
+    }
+
+    Mutex::Locker locker;
+    if (GetSequenceMutex (locker))
+    {
+        // See DownloadFile() for why this only pipelines without acks
+        const uint32_t window_size = GetSendAcks() ? 1 : FILE_TRANSFER_WINDOW_SIZE;
+        std::vector<uint8_t> buffer (FILE_TRANSFER_CHUNK_SIZE);
+        std::deque<uint64_t> outstanding_sizes;
+        uint64_t offset = 0;
+        bool eof = false;
+        while (error.Success())
+        {
+            while (!eof && outstanding_sizes.size() < window_size)
+            {
+                const size_t bytes_read = ::fread (&buffer[0], 1, buffer.size(), file);
+                if (bytes_read == 0)
+                {
+                    if (::ferror (file))
+                        error.SetErrorToErrno();
+                    eof = true;
+                    break;
+                }
+                StreamString packet;
+                packet.Printf ("vFile:pwrite:%llx,%llx,", fd, offset);
+                PutEscapedBinary (packet, &buffer[0], bytes_read);
+                if (SendPacketNoLock (packet.GetData(), packet.GetSize()) == 0)
+                {
+                    error.SetErrorString ("failed to send vFile:pwrite");
+                    break;
+                }
+                offset += bytes_read;
+                outstanding_sizes.push_back (bytes_read);
+            }
+            if (outstanding_sizes.empty() || error.Fail())
+                break;
+
+            StringExtractorGDBRemote response;
+            if (WaitForPacketWithTimeoutMicroSecondsNoLock (response, GetPacketTimeoutInMicroSeconds ()) == 0)
+            {
+                error.SetErrorString ("no response to vFile:pwrite");
+                break;
+            }
+            const int64_t bytes_written = ParseFileIOResponse (response, error);
+            if (error.Success() && (uint64_t)bytes_written != outstanding_sizes.front())
+                error.SetErrorString ("short write to remote file");
+            outstanding_sizes.pop_front();
+        }
+
+        while (!outstanding_sizes.empty())
+        {
+            StringExtractorGDBRemote response;
+            if (WaitForPacketWithTimeoutMicroSecondsNoLock (response, GetPacketTimeoutInMicroSeconds ()) == 0)
+                break;
+            outstanding_sizes.pop_front();
+        }
+    }
+    else
+    {
+        error.SetErrorString ("the connection is busy");
+    }
+
+    ::fclose (file);
+    Error close_error;
+    CloseFile (fd, close_error);
+    if (error.Success())
+        error = close_error;
+    return error;
+}
+
+
 void
-GDBRemoteCommunicationClient::TestPacketSpeed (const uint32_t num_packets)
+GDBRemoteCommunicationClient::TestPacketSpeed (const uint32_t num_packets, Stream &strm)
 {
     uint32_t i;
     TimeValue start_time, end_time;
@@ -1806,13 +2762,13 @@ GDBRemoteCommunicationClient::TestPacketSpeed (const uint32_t num_packets)
                 end_time = TimeValue::Now();
                 total_time_nsec = end_time.GetAsNanoSecondsSinceJan1_1970() - start_time.GetAsNanoSecondsSinceJan1_1970();
                 packets_per_second = (((float)num_packets)/(float)total_time_nsec) * (float)TimeValue::NanoSecPerSec;
-                printf ("%u qSpeedTest(send=%-5u, recv=%-5u) in %llu.%9.9llu sec for %f packets/sec.\n", 
-                        num_packets, 
-                        send_size,
-                        recv_size,
-                        total_time_nsec / TimeValue::NanoSecPerSec,
-                        total_time_nsec % TimeValue::NanoSecPerSec, 
-                        packets_per_second);
+                strm.Printf ("%u qSpeedTest(send=%-5u, recv=%-5u) in %llu.%9.9llu sec for %f packets/sec.\n", 
+                             num_packets, 
+                             send_size,
+                             recv_size,
+                             total_time_nsec / TimeValue::NanoSecPerSec,
+                             total_time_nsec % TimeValue::NanoSecPerSec, 
+                             packets_per_second);
                 if (recv_size == 0)
                     recv_size = 32;
             }
@@ -1830,11 +2786,11 @@ GDBRemoteCommunicationClient::TestPacketSpeed (const uint32_t num_packets)
         end_time = TimeValue::Now();
         total_time_nsec = end_time.GetAsNanoSecondsSinceJan1_1970() - start_time.GetAsNanoSecondsSinceJan1_1970();
         packets_per_second = (((float)num_packets)/(float)total_time_nsec) * (float)TimeValue::NanoSecPerSec;
-        printf ("%u 'qC' packets packets in 0x%llu%9.9llu sec for %f packets/sec.\n", 
-                num_packets, 
-                total_time_nsec / TimeValue::NanoSecPerSec, 
-                total_time_nsec % TimeValue::NanoSecPerSec, 
-                packets_per_second);
+        strm.Printf ("%u 'qC' packets in %llu.%9.9llu sec for %f packets/sec.\n", 
+                     num_packets, 
+                     total_time_nsec / TimeValue::NanoSecPerSec, 
+                     total_time_nsec % TimeValue::NanoSecPerSec, 
+                     packets_per_second);
     }
 }
 
@@ -1969,9 +2925,29 @@ GDBRemoteCommunicationClient::GetThreadStopInfo (uint32_t tid, StringExtractorGD
     return false;
 }
 
+bool
+GDBRemoteCommunicationClient::GetThreadsStopInfo (StringExtractorGDBRemote &response)
+{
+    if (m_supports_qThreadsStopInfo)
+    {
+        if (SendPacketAndWaitForResponse("qThreadsStopInfo", response, false))
+        {
+            if (response.IsUnsupportedResponse())
+                m_supports_qThreadsStopInfo = false;
+            else if (response.IsNormalResponse())
+                return true;
+        }
+        else
+        {
+            m_supports_qThreadsStopInfo = false;
+        }
+    }
+    return false;
+}
+
 
 uint8_t
-GDBRemoteCommunicationClient::SendGDBStoppointTypePacket (GDBStoppointType type, bool insert,  addr_t addr, uint32_t length)
+GDBRemoteCommunicationClient::SendGDBStoppointTypePacket (GDBStoppointType type, bool insert,  addr_t addr, uint32_t length, const char *conditions)
 {
     switch (type)
     {
@@ -1983,18 +2959,13 @@ GDBRemoteCommunicationClient::SendGDBStoppointTypePacket (GDBStoppointType type,
     default:                    return UINT8_MAX;
     }
 
-    char packet[64];
-    const int packet_len = ::snprintf (packet, 
-                                       sizeof(packet), 
-                                       "%c%i,%llx,%x", 
-                                       insert ? 'Z' : 'z', 
-                                       type, 
-                                       addr, 
-                                       length);
+    StreamString packet;
+    packet.Printf ("%c%i,%llx,%x", insert ? 'Z' : 'z', type, addr, length);
+    if (insert && conditions && conditions[0])
+        packet.PutCString (conditions);
 
-    assert (packet_len + 1 < sizeof(packet));
     StringExtractorGDBRemote response;
-    if (SendPacketAndWaitForResponse(packet, packet_len, response, true))
+    if (SendPacketAndWaitForResponse(packet.GetData(), packet.GetSize(), response, true))
     {
         if (response.IsOKResponse())
             return 0;
@@ -59,6 +59,27 @@ public:
                                   StringExtractorGDBRemote &response,
                                   bool send_async);
 
+    //------------------------------------------------------------------
+    // Send all of the packets in "payloads" and get their responses in
+    // the same order while holding the sequence mutex. When acks are
+    // disabled the packets are sent back to back before any response is
+    // read, so we pay for a single round trip instead of one per packet.
+    //
+    // Returns the number of responses that were received. This can't be
+    // used while the process is running, in which case zero is returned.
+    //------------------------------------------------------------------
+    size_t
+    SendPacketsAndWaitForResponses (const std::vector<std::string> &payloads,
+                                    std::vector<StringExtractorGDBRemote> &responses);
+
+    bool
+    GetPipelinedPacketsSupported ()
+    {
+        // With acks enabled, every packet must be acked before the next
+        // one can be sent.
+        return !GetSendAcks ();
+    }
+
     lldb::StateType
     SendContinuePacketAndWaitForResponse (ProcessGDBRemote *process,
                                           const char *packet_payload,
@@ -71,6 +92,23 @@ public:
     void
     QueryNoAckModeSupported ();
 
+    //------------------------------------------------------------------
+    // Ask the remote stub to run-length encode packets it sends that
+    // are at least "min_size" bytes long. A "min_size" of zero leaves
+    // compression off. Returns true if compression is now enabled.
+    //------------------------------------------------------------------
+    bool
+    EnableCompression (uint32_t min_size);
+
+    //------------------------------------------------------------------
+    // Ask a remote stub on this host to move the rest of the packets
+    // through the shared memory rings of CONNECTION, which must be the
+    // connection this object uses. Only done in no-ack mode. Returns
+    // true if the packets now go through shared memory.
+    //------------------------------------------------------------------
+    bool
+    StartSharedMemoryTransport (lldb_private::ConnectionSharedMemory &connection, size_t ring_size);
+
     void
     GetListThreadsInStopReplySupported ();
 
@@ -206,11 +244,63 @@ public:
     GetMemoryRegionInfo (lldb::addr_t addr, 
                         lldb_private::MemoryRegionInfo &range_info); 
 
+    //------------------------------------------------------------------
+    /// Get the start, size and permissions of all mapped memory regions
+    /// with "qMemoryRegionInfos" packets. Usually one packet is enough,
+    /// the stub tells us where to continue if it isn't.
+    ///
+    /// @return
+    ///     False if the remote stub doesn't support the packet. Otherwise
+    ///     \a regions is filled in, sorted by address, or \a error is set.
+    //------------------------------------------------------------------
+    bool
+    GetMemoryRegionInfos (std::vector<lldb_private::MemoryRegionInfo> &regions,
+                          lldb_private::Error &error);
+
     lldb_private::Error
     GetWatchpointSupportInfo (uint32_t &num); 
 
     lldb_private::Error
     GetWatchpointSupportInfo (uint32_t &num, bool& after);
+
+    //------------------------------------------------------------------
+    /// Get the paths, mach headers, UUIDs and segments of all images in
+    /// a dyld_image_info array with one "qShlibInfos" packet.
+    //------------------------------------------------------------------
+    lldb_private::Error
+    GetSharedLibraryInfos (lldb::addr_t image_infos_addr,
+                           uint32_t image_infos_count,
+                           std::string &infos);
+
+    //------------------------------------------------------------------
+    /// Have the remote stub search \a length bytes of memory starting
+    /// at \a addr for a byte pattern with a "qSearchMemory" packet.
+    ///
+    /// @return
+    ///     False if the remote stub doesn't support searching memory.
+    ///     Otherwise \a match_addr is the address of the first match,
+    ///     or LLDB_INVALID_ADDRESS if there was none or \a error was set.
+    //------------------------------------------------------------------
+    bool
+    SearchMemory (lldb::addr_t addr,
+                  lldb::addr_t length,
+                  const uint8_t *pattern,
+                  size_t pattern_size,
+                  lldb::addr_t &match_addr,
+                  lldb_private::Error &error);
+
+    //------------------------------------------------------------------
+    /// Read several ranges of memory with one "qMultiMemRead" packet.
+    ///
+    /// @return
+    ///     False if the remote stub doesn't support the packet. Otherwise
+    ///     the \a bytes_read member of each range is filled in, \a error
+    ///     is set if the packet failed.
+    //------------------------------------------------------------------
+    bool
+    ReadMemoryRanges (lldb_private::MemoryReadRange *ranges,
+                      size_t num_ranges,
+                      lldb_private::Error &error);
     
     lldb_private::Error
     GetWatchpointsTriggerAfterInstruction (bool &after);
@@ -226,6 +316,57 @@ public:
     
     bool
     GetSyncThreadStateSupported();
+
+    // Returns true if the remote stub supports the "x" packet which reads
+    // memory as escaped binary data instead of hex encoded bytes.
+    bool
+    GetxPacketSupported ();
+
+    // Returns the "PacketSize" the remote stub gave in its "qSupported"
+    // reply, the largest packet it can handle, or zero if it didn't say.
+    uint64_t
+    GetRemoteMaxPacketSize ();
+
+    // Non-stop mode: only the threads that hit breakpoints or get
+    // exceptions stop, the remote stub replies "OK" to resume packets
+    // right away and sends "%Stop" notifications for stopped threads.
+    // Returns true if the remote stub took the new mode.
+    bool
+    SetNonStopMode (bool enable);
+
+    // Have the remote stub sample the process while it runs and send
+    // the samples in "A" packets.
+    bool
+    SetEnableAsyncProfiling (bool enable, uint32_t interval_usec, uint32_t max_frames, uint32_t scan_type);
+
+    bool
+    GetNonStopMode () const
+    {
+        return m_non_stop_mode;
+    }
+
+    // Returns false if the last stop was a "%Stop" notification in
+    // non-stop mode, where the other threads may still be running.
+    bool
+    GetLastStopStoppedAllThreads () const
+    {
+        return m_all_threads_stopped;
+    }
+
+    // Get the stop replies of the other threads that stopped along with
+    // the one whose stop reply ended the last continue in non-stop mode.
+    void
+    GetNonStopStopReplies (std::vector<std::string> &stop_replies)
+    {
+        stop_replies.clear();
+        stop_replies.swap (m_non_stop_stop_replies);
+    }
+
+    // Returns true if the remote stub evaluates the agent expression
+    // conditions that can follow the length in software breakpoint "Z"
+    // packets, and only stops when one of them is true.
+    bool
+    GetBreakpointConditionsSupported ();
     
     void
     ResetDiscoverableSettings();
@@ -270,6 +411,68 @@ public:
     bool
     GetGroupName (uint32_t gid, std::string &name);
 
+    //------------------------------------------------------------------
+    // Ask the remote side for the UUID of a file so we can tell whether
+    // we already have a copy of it without transferring it.
+    //------------------------------------------------------------------
+    bool
+    GetModuleUUID (const lldb_private::FileSpec &file_spec,
+                   lldb_private::UUID &uuid);
+
+    //------------------------------------------------------------------
+    // Read and write files on the remote side with the vFile host I/O
+    // packets. The open flags are the ones from the GDB File-I/O
+    // protocol.
+    //------------------------------------------------------------------
+    enum
+    {
+        eFileOpenReadOnly   = 0x0,
+        eFileOpenWriteOnly  = 0x1,
+        eFileOpenCreate     = 0x200,
+        eFileOpenTruncate   = 0x400
+    };
+
+    lldb::user_id_t
+    OpenFile (const lldb_private::FileSpec &file_spec,
+              uint32_t flags,
+              uint32_t mode,
+              lldb_private::Error &error);
+
+    bool
+    CloseFile (lldb::user_id_t fd,
+               lldb_private::Error &error);
+
+    uint64_t
+    ReadFile (lldb::user_id_t fd,
+              uint64_t offset,
+              void *dst,
+              uint64_t dst_len,
+              lldb_private::Error &error);
+
+    uint64_t
+    WriteFile (lldb::user_id_t fd,
+               uint64_t offset,
+               const void *src,
+               uint64_t src_len,
+               lldb_private::Error &error);
+
+    //------------------------------------------------------------------
+    // Copy a whole file from or to the remote side. Large chunks are
+    // sent and, when acks are off, several requests are kept in flight
+    // at once so the transfer isn't limited by the round trip time.
+    // Downloads can also ask the remote side to run-length encode the
+    // data.
+    //------------------------------------------------------------------
+    lldb_private::Error
+    DownloadFile (const lldb_private::FileSpec &remote_file,
+                  const lldb_private::FileSpec &local_file,
+                  bool compress);
+
+    lldb_private::Error
+    UploadFile (const lldb_private::FileSpec &local_file,
+                const lldb_private::FileSpec &remote_file,
+                uint32_t mode);
+
     bool
     HasFullVContSupport ()
     {
@@ -297,6 +500,19 @@ public:
     GetThreadStopInfo (uint32_t tid, 
                        StringExtractorGDBRemote &response);
 
+    //------------------------------------------------------------------
+    /// Get the stop info of all threads with a "qThreadsStopInfo"
+    /// packet. The reply contains one qThreadStopInfo style reply per
+    /// thread, separated by '|'.
+    ///
+    /// @return
+    ///     False if the packet failed or the remote stub doesn't support
+    ///     it, in which case the caller should ask for each thread with
+    ///     GetThreadStopInfo().
+    //------------------------------------------------------------------
+    bool
+    GetThreadsStopInfo (StringExtractorGDBRemote &response);
+
     bool
     SupportsGDBStoppointPacket (GDBStoppointType type)
     {
@@ -315,10 +531,17 @@ public:
     SendGDBStoppointTypePacket (GDBStoppointType type,   // Type of breakpoint or watchpoint
                                 bool insert,              // Insert or remove?
                                 lldb::addr_t addr,        // Address of breakpoint or watchpoint
-                                uint32_t length);         // Byte Size of breakpoint or watchpoint
+                                uint32_t length,          // Byte Size of breakpoint or watchpoint
+                                const char *conditions = NULL); // Agent expression conditions to append to an insert (";X<len>,<hex>"...)
 
+    //------------------------------------------------------------------
+    /// Send \a num_packets speed test packets for each combination of
+    /// send and receive sizes from 0 to 1024 bytes (or "qC" packets if
+    /// the remote stub doesn't support "qSpeedTest"), and write how many
+    /// packets a second were exchanged to \a strm.
+    //------------------------------------------------------------------
     void
-    TestPacketSpeed (const uint32_t num_packets);
+    TestPacketSpeed (const uint32_t num_packets, lldb_private::Stream &strm);
 
     // This packet is for testing the speed of the interface only. Both
     // the client and server need to support it, but this allows us to
@@ -373,13 +596,24 @@ protected:
     lldb_private::LazyBool m_watchpoints_trigger_after_instruction;
     lldb_private::LazyBool m_attach_or_wait_reply;
     lldb_private::LazyBool m_prepare_for_reg_writing_reply;
+    lldb_private::LazyBool m_supports_x;
+    lldb_private::LazyBool m_supports_breakpoint_conditions;
+    lldb_private::LazyBool m_qSupported_is_valid;
+    lldb_private::LazyBool m_supports_QNonStop;
     
     bool
         m_supports_qProcessInfoPID:1,
         m_supports_qfProcessInfo:1,
         m_supports_qUserName:1,
         m_supports_qGroupName:1,
+        m_supports_qModuleUUID:1,
+        m_supports_vFile:1,
         m_supports_qThreadStopInfo:1,
+        m_supports_qThreadsStopInfo:1,
+        m_supports_qShlibInfos:1,
+        m_supports_qSearchMemory:1,
+        m_supports_qMultiMemRead:1,
+        m_supports_qMemoryRegionInfos:1,
         m_supports_z0:1,
         m_supports_z1:1,
         m_supports_z2:1,
@@ -392,6 +626,10 @@ protected:
 
 
     uint32_t m_num_supported_hardware_watchpoints;
+    uint64_t m_max_packet_size;     // The "PacketSize" from "qSupported", zero if unknown
+    bool m_non_stop_mode;           // The remote stub is in non-stop mode
+    bool m_all_threads_stopped;     // The last stop stopped every thread
+    std::vector<std::string> m_non_stop_stop_replies; // The extra stop replies from "vStopped"
 
     // If we need to send a packet while the target is running, the m_async_XXX
     // member variables take care of making this happen.
@@ -11,12 +11,18 @@
 #include "GDBRemoteCommunicationServer.h"
 
 // C Includes
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
 // C++ Includes
 // Other libraries and framework includes
 #include "llvm/ADT/Triple.h"
 #include "lldb/Interpreter/Args.h"
 #include "lldb/Core/ConnectionFileDescriptor.h"
 #include "lldb/Core/Log.h"
+#include "lldb/Core/Module.h"
+#include "lldb/Core/ModuleSpec.h"
 #include "lldb/Core/State.h"
 #include "lldb/Core/StreamString.h"
 #include "lldb/Host/Endian.h"
@@ -160,6 +166,24 @@ GDBRemoteCommunicationServer::GetPacketAndSendResponse (uint32_t timeout_usec,
 
             case StringExtractorGDBRemote::eServerPacketType_QStartNoAckMode:
                 return Handle_QStartNoAckMode (packet);
+
+            case StringExtractorGDBRemote::eServerPacketType_qModuleUUID:
+                return Handle_qModuleUUID (packet);
+
+            case StringExtractorGDBRemote::eServerPacketType_vFile_open:
+                return Handle_vFile_open (packet);
+
+            case StringExtractorGDBRemote::eServerPacketType_vFile_pread:
+                return Handle_vFile_pread (packet);
+
+            case StringExtractorGDBRemote::eServerPacketType_vFile_pwrite:
+                return Handle_vFile_pwrite (packet);
+
+            case StringExtractorGDBRemote::eServerPacketType_QEnableCompression:
+                return Handle_QEnableCompression (packet);
+
+            case StringExtractorGDBRemote::eServerPacketType_vFile_close:
+                return Handle_vFile_close (packet);
         }
         return true;
     }
@@ -842,3 +866,188 @@ GDBRemoteCommunicationServer::Handle_QStartNoAckMode (StringExtractorGDBRemote &
     m_send_acks = false;
     return true;
 }
+
+bool
+GDBRemoteCommunicationServer::Handle_qModuleUUID (StringExtractorGDBRemote &packet)
+{
+    // Packet format: "qModuleUUID:%s" where %s is the hex encoded path.
+    // Lets clients find out which build of a file is here without
+    // having to copy it first.
+    packet.SetFilePos(::strlen ("qModuleUUID:"));
+    std::string path;
+    packet.GetHexByteString(path);
+    if (!path.empty())
+    {
+        ModuleSpec module_spec (FileSpec (path.c_str(), false));
+        if (module_spec.GetFileSpec().Exists())
+        {
+            ModuleSP module_sp (new Module (module_spec));
+            const UUID &uuid = module_sp->GetUUID();
+            if (uuid.IsValid())
+            {
+                char uuid_cstr[64];
+                if (uuid.GetAsCString (uuid_cstr, sizeof(uuid_cstr)))
+                    return SendPacketNoLock (uuid_cstr, ::strlen (uuid_cstr));
+            }
+        }
+    }
+    return SendErrorResponse (13);
+}
+
+// The vFile packets follow the GDB host I/O protocol, results are sent
+// back as "F<result>" or "F-1,<errno>" with the numbers in hex.
+size_t
+GDBRemoteCommunicationServer::SendFileIOResponse (int64_t result, int err)
+{
+    StreamString response;
+    if (result < 0)
+        response.Printf ("F-1,%x", err);
+    else
+        response.Printf ("F%llx", (uint64_t)result);
+    return SendPacketNoLock (response.GetData(), response.GetSize());
+}
+
+// Open flags in the vFile:open packet use the values from the GDB File-I/O
+// protocol, not the host's
+static int
+ConvertFileIOOpenFlags (uint32_t gdb_flags)
+{
+    int flags = 0;
+    switch (gdb_flags & 3)
+    {
+        case 0: flags = O_RDONLY; break;
+        case 1: flags = O_WRONLY; break;
+        default: flags = O_RDWR; break;
+    }
+    if (gdb_flags & 0x8)
+        flags |= O_APPEND;
+    if (gdb_flags & 0x200)
+        flags |= O_CREAT;
+    if (gdb_flags & 0x400)
+        flags |= O_TRUNC;
+    if (gdb_flags & 0x800)
+        flags |= O_EXCL;
+    return flags;
+}
+
+bool
+GDBRemoteCommunicationServer::Handle_vFile_open (StringExtractorGDBRemote &packet)
+{
+    // Packet format: "vFile:open:%s,%x,%x" where the path is hex encoded
+    // followed by the flags and mode.
+    packet.SetFilePos(::strlen ("vFile:open:"));
+    std::string path;
+    packet.GetHexByteString(path);
+    if (path.empty() || packet.GetChar() != ',')
+        return SendFileIOResponse (-1, EINVAL) > 0;
+    const uint32_t flags = packet.GetHexMaxU32 (false, 0);
+    uint32_t mode = 0600;
+    if (packet.GetChar() == ',')
+        mode = packet.GetHexMaxU32 (false, mode);
+    const int fd = ::open (path.c_str(), ConvertFileIOOpenFlags (flags), (mode_t)mode);
+    return SendFileIOResponse (fd, errno) > 0;
+}
+
+bool
+GDBRemoteCommunicationServer::Handle_vFile_pread (StringExtractorGDBRemote &packet)
+{
+    // Packet format: "vFile:pread:%x,%x,%x" for the fd, count and offset.
+    // The reply is "F%x;" with the count read followed by the bytes,
+    // with '#', '$', '}' and '*' escaped as '}' followed by the byte
+    // xor'ed with 0x20.
+    packet.SetFilePos(::strlen ("vFile:pread:"));
+    const int fd = packet.GetHexMaxU32 (false, UINT32_MAX);
+    if (packet.GetChar() != ',')
+        return SendFileIOResponse (-1, EINVAL) > 0;
+    const uint64_t count = packet.GetHexMaxU64 (false, 0);
+    if (packet.GetChar() != ',')
+        return SendFileIOResponse (-1, EINVAL) > 0;
+    const uint64_t offset = packet.GetHexMaxU64 (false, UINT64_MAX);
+    if (fd < 0 || offset == UINT64_MAX)
+        return SendFileIOResponse (-1, EINVAL) > 0;
+
+    std::string buffer (count, '\0');
+    const ssize_t bytes_read = count > 0 ? ::pread (fd, &buffer[0], count, offset) : 0;
+    if (bytes_read < 0)
+        return SendFileIOResponse (-1, errno) > 0;
+
+    StreamString response;
+    response.Printf ("F%llx;", (uint64_t)bytes_read);
+    for (ssize_t i = 0; i < bytes_read; ++i)
+    {
+        const char ch = buffer[i];
+        if (ch == '#' || ch == '$' || ch == '}' || ch == '*')
+        {
+            response.PutChar ('}');
+            response.PutChar (ch ^ 0x20);
+        }
+        else
+            response.PutChar (ch);
+    }
+    return SendPacketNoLock (response.GetData(), response.GetSize()) > 0;
+}
+
+bool
+GDBRemoteCommunicationServer::Handle_vFile_pwrite (StringExtractorGDBRemote &packet)
+{
+    // Packet format: "vFile:pwrite:%x,%x," for the fd and offset, followed
+    // by the bytes to write escaped like the vFile:pread reply.
+    packet.SetFilePos(::strlen ("vFile:pwrite:"));
+    const int fd = packet.GetHexMaxU32 (false, UINT32_MAX);
+    if (packet.GetChar() != ',')
+        return SendFileIOResponse (-1, EINVAL) > 0;
+    const uint64_t offset = packet.GetHexMaxU64 (false, UINT64_MAX);
+    if (fd < 0 || offset == UINT64_MAX || packet.GetChar() != ',')
+        return SendFileIOResponse (-1, EINVAL) > 0;
+
+    const std::string &data = packet.GetStringRef();
+    std::string buffer;
+    buffer.reserve (data.size() - packet.GetFilePos());
+    for (size_t i = packet.GetFilePos(); i < data.size(); ++i)
+    {
+        char ch = data[i];
+        if (ch == '}' && i + 1 < data.size())
+            ch = data[++i] ^ 0x20;
+        buffer += ch;
+    }
+
+    const ssize_t bytes_written = buffer.empty() ? 0 : ::pwrite (fd, buffer.data(), buffer.size(), offset);
+    return SendFileIOResponse (bytes_written, errno) > 0;
+}
+
+bool
+GDBRemoteCommunicationServer::Handle_QEnableCompression (StringExtractorGDBRemote &packet)
+{
+    // Packet format: "QEnableCompression:type:rle;minsize:%x;"
+    packet.SetFilePos(::strlen ("QEnableCompression:"));
+    std::string name;
+    std::string value;
+    bool type_is_rle = false;
+    uint32_t min_size = UINT32_MAX;
+    while (packet.GetNameColonValue (name, value))
+    {
+        if (name.compare ("type") == 0)
+            type_is_rle = value.compare ("rle") == 0;
+        else if (name.compare ("minsize") == 0)
+            min_size = Args::StringToUInt32 (value.c_str(), UINT32_MAX, 16);
+    }
+    if (!type_is_rle || min_size == UINT32_MAX)
+        return SendErrorResponse (14);
+
+    // Reply before we start compressing so the OK goes out as is
+    const bool success = SendOKResponse () > 0;
+    m_send_compression_min_size = min_size;
+    return success;
+}
+
+bool
+GDBRemoteCommunicationServer::Handle_vFile_close (StringExtractorGDBRemote &packet)
+{
+    // Packet format: "vFile:close:%x" where %x is the fd
+    packet.SetFilePos(::strlen ("vFile:close:"));
+    const int fd = packet.GetHexMaxU32 (false, UINT32_MAX);
+    if (fd < 0)
+        return SendFileIOResponse (-1, EINVAL) > 0;
+    const int result = ::close (fd);
+    return SendFileIOResponse (result, errno) > 0;
+}
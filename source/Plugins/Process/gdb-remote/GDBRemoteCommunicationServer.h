@@ -83,6 +83,9 @@ protected:
     size_t
     SendOKResponse ();
 
+    size_t
+    SendFileIOResponse (int64_t result, int err);
+
     bool
     Handle_A (StringExtractorGDBRemote &packet);
 
@@ -136,6 +139,24 @@ protected:
 
     bool
     Handle_QSetSTDERR (StringExtractorGDBRemote &packet);
+
+    bool
+    Handle_qModuleUUID (StringExtractorGDBRemote &packet);
+
+    bool
+    Handle_vFile_open (StringExtractorGDBRemote &packet);
+
+    bool
+    Handle_vFile_pread (StringExtractorGDBRemote &packet);
+
+    bool
+    Handle_vFile_pwrite (StringExtractorGDBRemote &packet);
+
+    bool
+    Handle_QEnableCompression (StringExtractorGDBRemote &packet);
+
+    bool
+    Handle_vFile_close (StringExtractorGDBRemote &packet);
     
 private:
     //------------------------------------------------------------------
@@ -43,6 +43,10 @@ GDBRemoteRegisterContext::GDBRemoteRegisterContext
     RegisterContext (thread, concrete_frame_idx),
     m_reg_info (reg_info),
     m_reg_valid (),
+    m_reg_dirty (),
+    m_reg_set_idx (),
+    m_num_dirty_regs (0),
+    m_thread_generation (thread.GetRegisterGeneration()),
     m_reg_data (),
     m_read_all_at_once (read_all_at_once)
 {
@@ -50,6 +54,22 @@ GDBRemoteRegisterContext::GDBRemoteRegisterContext
     // We will use these boolean values to know when a register value
     // is valid in m_reg_data.
     m_reg_valid.resize (reg_info.GetNumRegisters());
+    m_reg_dirty.resize (reg_info.GetNumRegisters());
+
+    // Remember which set each register is in so a read of one register
+    // can fetch the rest of its set along with it.
+    m_reg_set_idx.resize (reg_info.GetNumRegisters(), LLDB_INVALID_INDEX32);
+    const size_t num_sets = reg_info.GetNumRegisterSets();
+    for (uint32_t set_idx = 0; set_idx < num_sets; ++set_idx)
+    {
+        const RegisterSet *reg_set = reg_info.GetRegisterSet (set_idx);
+        for (size_t i = 0; i < reg_set->num_registers; ++i)
+        {
+            const uint32_t reg = reg_set->registers[i];
+            if (reg < m_reg_set_idx.size() && m_reg_set_idx[reg] == LLDB_INVALID_INDEX32)
+                m_reg_set_idx[reg] = set_idx;
+        }
+    }
 
     // Make a heap based buffer that is big enough to store all registers
     DataBufferSP reg_data_sp(new DataBufferHeap (reg_info.GetRegisterDataByteSize(), 0));
@@ -68,6 +88,62 @@ void
 GDBRemoteRegisterContext::InvalidateAllRegisters ()
 {
     SetAllRegisterValid (false);
+
+    // Any writes that haven't been sent are lost along with the values
+    if (m_num_dirty_regs > 0)
+    {
+        LogSP log (ProcessGDBRemoteLog::GetLogIfAnyCategoryIsSet (GDBR_LOG_THREAD));
+        if (log)
+            log->Printf ("GDBRemoteRegisterContext::InvalidateAllRegisters () discarding %u unwritten registers for thread 0x%4.4llx", m_num_dirty_regs, m_thread.GetID());
+        m_reg_dirty.assign (m_reg_dirty.size(), false);
+        m_num_dirty_regs = 0;
+    }
+}
+
+void
+GDBRemoteRegisterContext::InvalidateIfThreadResumed ()
+{
+    // In all-stop mode a thread that stays suspended while the others
+    // run keeps its register values, so they are only thrown away when
+    // this thread itself has been resumed, not whenever the process
+    // stop ID changes.
+    const uint32_t thread_generation = static_cast<ThreadGDBRemote &>(m_thread).GetRegisterGeneration();
+    if (thread_generation != m_thread_generation)
+    {
+        InvalidateAllRegisters ();
+        m_thread_generation = thread_generation;
+    }
+
+    ProcessSP process_sp (m_thread.GetProcess());
+    if (process_sp)
+        SetStopID (process_sp->GetStopID());
+}
+
+void
+GDBRemoteRegisterContext::SetRegisterDirty (const RegisterInfo *reg_info)
+{
+    const uint32_t reg = reg_info->kinds[eRegisterKindLLDB];
+    m_reg_valid[reg] = true;
+
+    if (reg_info->value_regs)
+    {
+        // A composite register is written through the primordial
+        // registers that hold its bytes.
+        uint32_t prim_reg_idx;
+        for (uint32_t idx = 0;
+             (prim_reg_idx = reg_info->value_regs[idx]) != LLDB_INVALID_REGNUM;
+             ++idx)
+        {
+            const RegisterInfo *prim_reg_info = GetRegisterInfoAtIndex(prim_reg_idx);
+            if (prim_reg_info)
+                SetRegisterDirty (prim_reg_info);
+        }
+    }
+    else if (!m_reg_dirty[reg])
+    {
+        m_reg_dirty[reg] = true;
+        ++m_num_dirty_regs;
+    }
 }
 
 void
@@ -127,7 +203,7 @@ GDBRemoteRegisterContext::PrivateSetRegisterValue (uint32_t reg, StringExtractor
         return false;
 
     // Invalidate if needed
-    InvalidateIfNeeded(false);
+    InvalidateIfThreadResumed();
 
     const uint32_t reg_byte_size = reg_info->byte_size;
     const size_t bytes_copied = response.GetHexBytes (const_cast<uint8_t*>(m_reg_data.PeekData(reg_info->byte_offset, reg_byte_size)), reg_byte_size, '\xcc');
@@ -164,6 +240,50 @@ GDBRemoteRegisterContext::GetPrimordialRegister(const lldb_private::RegisterInfo
 
     return false;
 }
+
+// Helper function for GDBRemoteRegisterContext::ReadRegisterBytes().
+bool
+GDBRemoteRegisterContext::ReadRegisterSet (uint32_t set_idx,
+                                           GDBRemoteCommunicationClient &gdb_comm)
+{
+    const RegisterSet *reg_set = GetRegisterSet (set_idx);
+    if (reg_set == NULL)
+        return false;
+
+    // Ask for every primordial register in the set we don't have yet
+    // with pipelined "p" packets, which costs one round trip instead
+    // of one per register.
+    const bool thread_suffix_supported = gdb_comm.GetThreadSuffixSupported();
+    std::vector<uint32_t> regs;
+    std::vector<std::string> packets;
+    for (size_t i = 0; i < reg_set->num_registers; ++i)
+    {
+        const uint32_t reg = reg_set->registers[i];
+        const RegisterInfo *reg_info = GetRegisterInfoAtIndex (reg);
+        if (reg_info == NULL || reg_info->value_regs || m_reg_valid[reg])
+            continue;
+
+        char packet[64];
+        int packet_len = 0;
+        if (thread_suffix_supported)
+            packet_len = ::snprintf (packet, sizeof(packet), "p%x;thread:%4.4llx;", reg, m_thread.GetID());
+        else
+            packet_len = ::snprintf (packet, sizeof(packet), "p%x", reg);
+        assert (packet_len < (sizeof(packet) - 1));
+        regs.push_back (reg);
+        packets.push_back (std::string (packet, packet_len));
+    }
+
+    std::vector<StringExtractorGDBRemote> responses;
+    const size_t num_responses = gdb_comm.SendPacketsAndWaitForResponses (packets, responses);
+    for (size_t i = 0; i < num_responses; ++i)
+    {
+        if (responses[i].IsNormalResponse())
+            PrivateSetRegisterValue (regs[i], responses[i]);
+    }
+    return num_responses == packets.size();
+}
+
 bool
 GDBRemoteRegisterContext::ReadRegisterBytes (const RegisterInfo *reg_info, DataExtractor &data)
 {
@@ -176,7 +296,7 @@ GDBRemoteRegisterContext::ReadRegisterBytes (const RegisterInfo *reg_info, DataE
 
     GDBRemoteCommunicationClient &gdb_comm (((ProcessGDBRemote *)process)->GetGDBRemote());
 
-    InvalidateIfNeeded(false);
+    InvalidateIfThreadResumed();
 
     const uint32_t reg = reg_info->kinds[eRegisterKindLLDB];
 
@@ -194,6 +314,10 @@ GDBRemoteRegisterContext::ReadRegisterBytes (const RegisterInfo *reg_info, DataE
                 int packet_len = 0;
                 if (m_read_all_at_once)
                 {
+                    // The "g" reply replaces every cached value, so send
+                    // the ones that were written first.
+                    WriteDirtyRegisters ();
+
                     // Get all registers in one packet
                     if (thread_suffix_supported)
                         packet_len = ::snprintf (packet, sizeof(packet), "g;thread:%4.4llx;", m_thread.GetID());
@@ -209,8 +333,14 @@ GDBRemoteRegisterContext::ReadRegisterBytes (const RegisterInfo *reg_info, DataE
                 }
                 else if (!reg_info->value_regs)
                 {
-                    // Get each register individually
-                    GetPrimordialRegister(reg_info, gdb_comm);
+                    // Get each register individually, along with the rest
+                    // of its register set when the packets can be
+                    // pipelined since the other registers in the set are
+                    // usually wanted next.
+                    if (gdb_comm.GetPipelinedPacketsSupported())
+                        ReadRegisterSet (m_reg_set_idx[reg], gdb_comm);
+                    if (!m_reg_valid[reg])
+                        GetPrimordialRegister(reg_info, gdb_comm);
                 }
                 else
                 {
@@ -225,7 +355,10 @@ GDBRemoteRegisterContext::ReadRegisterBytes (const RegisterInfo *reg_info, DataE
                          ++idx)
                     {
                         // We have a valid primordial regsiter as our constituent.
-                        // Grab the corresponding register info.
+                        // Grab the corresponding register info, unless we
+                        // already have its value (which may have been written).
+                        if (m_reg_valid[prim_reg_idx])
+                            continue;
                         const RegisterInfo *prim_reg_info = GetRegisterInfoAtIndex(prim_reg_idx);
                         if (!GetPrimordialRegister(prim_reg_info, gdb_comm))
                         {
@@ -371,6 +504,32 @@ GDBRemoteRegisterContext::WriteRegisterBytes (const lldb_private::RegisterInfo *
     if (dst == NULL)
         return false;
 
+    // Writes to registers that don't change other registers just go into
+    // the cached values, WriteDirtyRegisters() sends them all together
+    // before the thread resumes.
+    if (reg_info->invalidate_regs == NULL)
+    {
+        InvalidateIfThreadResumed();
+
+        // A composite register may only cover part of its primordial
+        // registers, so we need their current values first.
+        if (reg_info->value_regs && !ReadRegisterBytes (reg_info, m_reg_data))
+            return false;
+
+        if (!data.CopyByteOrderedData (data_offset,                  // src offset
+                                       reg_info->byte_size,          // src length
+                                       dst,                          // dst
+                                       reg_info->byte_size,          // dst length
+                                       m_reg_data.GetByteOrder()))   // dst byte order
+            return false;
+
+        SetRegisterDirty (reg_info);
+        return true;
+    }
+
+    // Anything we held back has to go first so the remote stub sees the
+    // writes in order.
+    WriteDirtyRegisters ();
 
     if (data.CopyByteOrderedData (data_offset,                  // src offset
                                   reg_info->byte_size,          // src length
@@ -501,6 +660,10 @@ GDBRemoteRegisterContext::ReadAllRegisterValues (lldb::DataBufferSP &data_sp)
     Mutex::Locker locker;
     if (gdb_comm.GetSequenceMutex (locker, "Didn't get sequence mutex for read all registers."))
     {
+        // The "g" reply has to include the registers that were written,
+        // and syncing the thread state throws away the cached values.
+        WriteDirtyRegisters ();
+
         SyncThreadState(process);
         
         char packet[32];
@@ -575,6 +738,12 @@ GDBRemoteRegisterContext::WriteAllRegisterValues (const lldb::DataBufferSP &data
     Mutex::Locker locker;
     if (gdb_comm.GetSequenceMutex (locker, "Didn't get sequence mutex for write all registers."))
     {
+        // Every register is about to be replaced, and the restore code
+        // below compares against the cached values which must be the
+        // ones the remote stub has, so forget the unwritten ones.
+        if (m_num_dirty_regs > 0)
+            InvalidateAllRegisters ();
+
         const bool thread_suffix_supported = gdb_comm.GetThreadSuffixSupported();
         ProcessSP process_sp (m_thread.GetProcess());
         if (thread_suffix_supported || static_cast<ProcessGDBRemote *>(process_sp.get())->GetGDBRemote().SetCurrentThread(m_thread.GetID()))
@@ -687,6 +856,111 @@ GDBRemoteRegisterContext::WriteAllRegisterValues (const lldb::DataBufferSP &data
     return false;
 }
 
+bool
+GDBRemoteRegisterContext::WriteDirtyRegisters ()
+{
+    if (m_num_dirty_regs == 0)
+        return true;
+
+    ExecutionContext exe_ctx (CalculateThread());
+
+    Process *process = exe_ctx.GetProcessPtr();
+    Thread *thread = exe_ctx.GetThreadPtr();
+    if (process == NULL || thread == NULL)
+        return false;
+
+    GDBRemoteCommunicationClient &gdb_comm (((ProcessGDBRemote *)process)->GetGDBRemote());
+    LogSP log (ProcessGDBRemoteLog::GetLogIfAnyCategoryIsSet (GDBR_LOG_THREAD | GDBR_LOG_PACKETS));
+
+    Mutex::Locker locker;
+    if (!gdb_comm.GetSequenceMutex (locker, "Didn't get sequence mutex for write dirty registers."))
+    {
+        if (log)
+            log->Printf("error: failed to get packet sequence mutex, not sending %u dirty registers", m_num_dirty_regs);
+        return false;
+    }
+
+    const bool thread_suffix_supported = gdb_comm.GetThreadSuffixSupported();
+    ProcessSP process_sp (m_thread.GetProcess());
+    if (!thread_suffix_supported && !static_cast<ProcessGDBRemote *>(process_sp.get())->GetGDBRemote().SetCurrentThread(m_thread.GetID()))
+        return false;
+
+    // A "G" packet writes every register, so it can only be used when we
+    // know the values of all of them.
+    bool all_regs_valid = true;
+    const RegisterInfo *reg_info;
+    for (uint32_t reg = 0; all_regs_valid && (reg_info = GetRegisterInfoAtIndex (reg)) != NULL; ++reg)
+    {
+        if (!reg_info->value_regs && !m_reg_valid[reg])
+            all_regs_valid = false;
+    }
+
+    StringExtractorGDBRemote response;
+    bool success = false;
+    if (m_num_dirty_regs > 1 && all_regs_valid)
+    {
+        StreamString packet;
+        packet.PutChar ('G');
+        packet.PutBytesAsRawHex8 (m_reg_data.GetDataStart(),
+                                  m_reg_data.GetByteSize(),
+                                  lldb::endian::InlHostByteOrder(),
+                                  lldb::endian::InlHostByteOrder());
+
+        if (thread_suffix_supported)
+            packet.Printf (";thread:%4.4llx;", m_thread.GetID());
+
+        if (gdb_comm.SendPacketAndWaitForResponse(packet.GetString().c_str(),
+                                                  packet.GetString().size(),
+                                                  response,
+                                                  false))
+            success = response.IsOKResponse();
+    }
+
+    if (!success)
+    {
+        // Write each dirty register with its own "P" packet, pipelined
+        std::vector<uint32_t> regs;
+        std::vector<std::string> packets;
+        for (uint32_t reg = 0; (reg_info = GetRegisterInfoAtIndex (reg)) != NULL; ++reg)
+        {
+            if (!m_reg_dirty[reg])
+                continue;
+
+            StreamString packet;
+            packet.Printf ("P%x=", reg);
+            packet.PutBytesAsRawHex8 (m_reg_data.PeekData(reg_info->byte_offset, reg_info->byte_size),
+                                      reg_info->byte_size,
+                                      lldb::endian::InlHostByteOrder(),
+                                      lldb::endian::InlHostByteOrder());
+
+            if (thread_suffix_supported)
+                packet.Printf (";thread:%4.4llx;", m_thread.GetID());
+
+            regs.push_back (reg);
+            packets.push_back (packet.GetString());
+        }
+
+        std::vector<StringExtractorGDBRemote> responses;
+        const size_t num_responses = gdb_comm.SendPacketsAndWaitForResponses (packets, responses);
+        success = num_responses == packets.size();
+        for (size_t i = 0; i < num_responses; ++i)
+        {
+            if (!responses[i].IsOKResponse())
+            {
+                success = false;
+                if (log)
+                    log->Printf ("error: failed to write register \"%s\" for thread 0x%4.4llx", GetRegisterInfoAtIndex (regs[i])->name, m_thread.GetID());
+            }
+        }
+    }
+
+    // The remote stub may not have taken the values exactly as they were
+    // written, so read them back the next time they are needed.
+    m_reg_dirty.assign (m_reg_dirty.size(), false);
+    m_num_dirty_regs = 0;
+    SetAllRegisterValid (false);
+    return success;
+}
 
 uint32_t
 GDBRemoteRegisterContext::ConvertRegisterKindToRegisterNumber (uint32_t kind, uint32_t num)
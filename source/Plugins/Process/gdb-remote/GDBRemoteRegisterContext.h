@@ -225,6 +225,22 @@ public:
     virtual uint32_t
     ConvertRegisterKindToRegisterNumber (uint32_t kind, uint32_t num);
 
+    //------------------------------------------------------------------
+    /// Send the registers that have been written since the last call
+    /// to the remote stub.
+    ///
+    /// Register writes only go into the cached register values, this
+    /// sends all of them at once with a "G" packet when every register
+    /// value is known, or with pipelined "P" packets otherwise. The
+    /// thread calls this before it resumes.
+    ///
+    /// @return
+    ///     \b true if every dirty register was written, \b false
+    ///     otherwise.
+    //------------------------------------------------------------------
+    bool
+    WriteDirtyRegisters ();
+
 protected:
     friend class ThreadGDBRemote;
 
@@ -243,11 +259,27 @@ protected:
     void
     SetAllRegisterValid (bool b);
 
+    void
+    SetRegisterDirty (const lldb_private::RegisterInfo *reg_info);
+
+    // Throw away the cached register values if the thread has been
+    // resumed since they were read.
+    void
+    InvalidateIfThreadResumed ();
+
+    bool
+    ReadRegisterSet (uint32_t set_idx,
+                     GDBRemoteCommunicationClient &gdb_comm);
+
     void
     SyncThreadState(lldb_private::Process *process);  // Assumes the sequence mutex has already been acquired.
     
     GDBRemoteDynamicRegisterInfo &m_reg_info;
     std::vector<bool> m_reg_valid;
+    std::vector<bool> m_reg_dirty;          // Registers that have been written but not sent to the remote stub yet
+    std::vector<uint32_t> m_reg_set_idx;    // The register set each register is in
+    uint32_t m_num_dirty_regs;
+    uint32_t m_thread_generation;           // The ThreadGDBRemote::GetRegisterGeneration() the cached values are from
     lldb_private::DataExtractor m_reg_data;
     bool m_read_all_at_once;
 
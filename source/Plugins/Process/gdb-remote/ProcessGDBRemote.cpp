@@ -31,11 +31,16 @@
 
 // Other libraries and framework includes
 
+#include "lldb/Breakpoint/Breakpoint.h"
+#include "lldb/Breakpoint/BreakpointLocation.h"
+#include "lldb/Breakpoint/BreakpointSite.h"
 #include "lldb/Breakpoint/Watchpoint.h"
 #include "lldb/Interpreter/Args.h"
 #include "lldb/Core/ArchSpec.h"
 #include "lldb/Core/Debugger.h"
 #include "lldb/Core/ConnectionFileDescriptor.h"
+#include "lldb/Core/ConnectionSharedMemory.h"
+#include "lldb/Core/ConnectionSimulatedLink.h"
 #include "lldb/Host/FileSpec.h"
 #include "lldb/Core/InputReader.h"
 #include "lldb/Core/Module.h"
@@ -46,9 +51,16 @@
 #include "lldb/Core/StreamString.h"
 #include "lldb/Core/Timer.h"
 #include "lldb/Core/Value.h"
+#include "lldb/Core/RegisterValue.h"
 #include "lldb/Host/TimeValue.h"
+#include "lldb/Interpreter/CommandInterpreter.h"
+#include "lldb/Interpreter/CommandObjectMultiword.h"
+#include "lldb/Interpreter/CommandReturnObject.h"
+#include "lldb/Interpreter/Options.h"
 #include "lldb/Symbol/ObjectFile.h"
 #include "lldb/Target/DynamicLoader.h"
+#include "lldb/Target/RegisterContext.h"
+#include "lldb/Target/StackFrame.h"
 #include "lldb/Target/Target.h"
 #include "lldb/Target/TargetList.h"
 #include "lldb/Target/ThreadPlanCallFunction.h"
@@ -60,6 +72,7 @@
 #include "Plugins/Process/Utility/StopInfoMachException.h"
 #include "Plugins/Platform/MacOSX/PlatformRemoteiOS.h"
 #include "Utility/StringExtractorGDBRemote.h"
+#include "GDBRemoteAgentExpression.h"
 #include "GDBRemoteRegisterContext.h"
 #include "ProcessGDBRemote.h"
 #include "ProcessGDBRemoteLog.h"
@@ -190,6 +203,9 @@ ProcessGDBRemote::ProcessGDBRemote(Target& target, Listener &listener) :
     m_async_broadcaster (NULL, "lldb.process.gdb-remote.async-broadcaster"),
     m_async_thread (LLDB_INVALID_HOST_THREAD),
     m_thread_ids (),
+    m_threads_stop_info_stop_id (UINT32_MAX),
+    m_stop_reason_tids_stop_id (UINT32_MAX),
+    m_stop_reason_tids (),
     m_continue_c_tids (),
     m_continue_C_tids (),
     m_continue_s_tids (),
@@ -197,9 +213,15 @@ ProcessGDBRemote::ProcessGDBRemote(Target& target, Listener &listener) :
     m_dispatch_queue_offsets_addr (LLDB_INVALID_ADDRESS),
     m_max_memory_size (512),
     m_addr_to_mmap_size (),
+    m_breakpoint_site_conditions (),
+    m_watchpoint_conditions (),
+    m_memory_region_map (),
+    m_memory_region_map_stop_id (UINT32_MAX),
+    m_memory_region_map_is_valid (false),
     m_thread_create_bp_sp (),
     m_waiting_for_attach (false),
-    m_destroy_tried_resuming (false)
+    m_destroy_tried_resuming (false),
+    m_command_sp ()
 {
     m_async_broadcaster.SetEventName (eBroadcastBitAsyncThreadShouldExit,   "async thread should exit");
     m_async_broadcaster.SetEventName (eBroadcastBitAsyncContinue,           "async thread continue");
@@ -672,10 +694,22 @@ ProcessGDBRemote::DoLaunch (Module *exe_module, const ProcessLaunchInfo &launch_
 }
 
 
+// The most memory we will read or write with one packet, however big a
+// packet the remote stub says it can take
+#define MAX_MEMORY_PACKET_BYTES     (128 * 1024)
+// Room for the packet framing, the command, the address and the size
+#define MEMORY_PACKET_OVERHEAD      64
+// The size of each direction's ring when packets go through shared
+// memory, which holds the largest memory packet a few times over
+#define SHARED_MEMORY_RING_SIZE     (1024 * 1024)
+
 Error
 ProcessGDBRemote::ConnectToDebugserver (const char *connect_url)
 {
     Error error;
+    // A debugserver that we started is on this host, so packets can go
+    // through shared memory instead of the socket once it says it can
+    ConnectionSharedMemory *shared_memory_conn = NULL;
     // Sleep and wait a bit for debugserver to start to listen...
     std::auto_ptr<ConnectionFileDescriptor> conn_ap(new ConnectionFileDescriptor());
     if (conn_ap.get())
@@ -686,7 +720,19 @@ ProcessGDBRemote::ConnectToDebugserver (const char *connect_url)
         {
             if (conn_ap->Connect(connect_url, &error) == eConnectionStatusSuccess)
             {
-                m_gdb_comm.SetConnection (conn_ap.release());
+                // Slow the connection down to what a far away device would
+                // see if we were asked to
+                const uint32_t latency_usec = GetSimulatedLinkLatency();
+                const uint64_t bytes_per_second = GetSimulatedLinkBandwidth();
+                if (latency_usec > 0 || bytes_per_second > 0)
+                    m_gdb_comm.SetConnection (new ConnectionSimulatedLink (conn_ap.release(), latency_usec, bytes_per_second));
+                else if (m_debugserver_pid != LLDB_INVALID_PROCESS_ID && GetSharedMemoryTransportEnabled())
+                {
+                    shared_memory_conn = new ConnectionSharedMemory (conn_ap.release());
+                    m_gdb_comm.SetConnection (shared_memory_conn);
+                }
+                else
+                    m_gdb_comm.SetConnection (conn_ap.release());
                 break;
             }
             retry_count++;
@@ -723,11 +769,25 @@ ProcessGDBRemote::ConnectToDebugserver (const char *connect_url)
     }
     m_gdb_comm.ResetDiscoverableSettings();
     m_gdb_comm.QueryNoAckModeSupported ();
+    if (shared_memory_conn && !m_gdb_comm.StartSharedMemoryTransport (*shared_memory_conn, SHARED_MEMORY_RING_SIZE))
+    {
+        LogSP log (ProcessGDBRemoteLog::GetLogIfAllCategoriesSet (GDBR_LOG_PROCESS));
+        if (log)
+            log->Printf ("ProcessGDBRemote::ConnectToDebugserver() packets will go over the socket, " DEBUGSERVER_BASENAME " can't use shared memory");
+    }
+    m_gdb_comm.EnableCompression (GetPacketCompressionMinSize());
     m_gdb_comm.GetThreadSuffixSupported ();
     m_gdb_comm.GetListThreadsInStopReplySupported ();
     m_gdb_comm.GetHostInfo ();
     m_gdb_comm.GetVContSupported ('c');
     m_gdb_comm.GetVAttachOrWaitSupported();
+
+    // Move memory in packets as big as the remote stub can handle. Memory
+    // is hex encoded in "m" replies and "M" packets, so each byte takes two
+    // characters of the packet.
+    const uint64_t max_packet_size = m_gdb_comm.GetRemoteMaxPacketSize();
+    if (max_packet_size > MEMORY_PACKET_OVERHEAD * 2)
+        m_max_memory_size = std::min<uint64_t> ((max_packet_size - MEMORY_PACKET_OVERHEAD) / 2, MAX_MEMORY_PACKET_BYTES);
     
     size_t num_cmds = GetExtraStartupCommands().GetArgumentCount();
     for (size_t idx = 0; idx < num_cmds; idx++)
@@ -751,6 +811,12 @@ ProcessGDBRemote::DidLaunchOrAttach ()
 
         BuildDynamicRegisterInfo (false);
 
+        if (GetNonStopModeEnabled() && !m_gdb_comm.SetNonStopMode (true))
+        {
+            if (log)
+                log->Printf ("ProcessGDBRemote::DidLaunch() remote stub doesn't support non-stop mode");
+        }
+
         // See if the GDB server supports the qHostInfo information
 
         const ArchSpec &gdb_remote_arch = m_gdb_comm.GetHostArchitecture();
@@ -954,6 +1020,8 @@ ProcessGDBRemote::WillResume ()
     m_continue_C_tids.clear();
     m_continue_s_tids.clear();
     m_continue_S_tids.clear();
+    UpdateBreakpointSiteConditions ();
+    UpdateWatchpointConditions ();
     return Error();
 }
 
@@ -1161,7 +1229,7 @@ ProcessGDBRemote::DoResume ()
         }
         else
         {
-            EventSP event_sp;
+            EventIntrusiveSP event_sp;
             TimeValue timeout;
             timeout = TimeValue::Now();
             timeout.OffsetWithSeconds (5);
@@ -1247,9 +1315,95 @@ ProcessGDBRemote::UpdateThreadList (ThreadList &old_thread_list, ThreadList &new
     return true;
 }
 
+// Get the stop info of all threads with one packet instead of one
+// qThreadStopInfo packet per thread. This is done at most once per stop,
+// returns true if it was done by this call.
+bool
+ProcessGDBRemote::UpdateThreadsStopInfo ()
+{
+    const uint32_t stop_id = GetStopID();
+    if (m_threads_stop_info_stop_id == stop_id)
+        return false;
+    m_threads_stop_info_stop_id = stop_id;
+
+    StringExtractorGDBRemote response;
+    if (!m_gdb_comm.GetThreadsStopInfo (response))
+        return false;
+
+    // Remember which threads stopped for a reason along the way, this
+    // has every thread the remote stub knows about
+    m_stop_reason_tids.clear();
+    const std::string &records = response.GetStringRef();
+    size_t record_start = 0;
+    while (record_start < records.size())
+    {
+        size_t record_end = records.find ('|', record_start);
+        if (record_end == std::string::npos)
+            record_end = records.size();
+        StringExtractor stop_packet (records.substr (record_start, record_end - record_start).c_str());
+        ThreadSP thread_sp;
+        SetThreadStopInfo (stop_packet, &thread_sp);
+        if (thread_sp && thread_sp->GetPrivateStopReason())
+            m_stop_reason_tids.push_back (thread_sp->GetID());
+        record_start = record_end + 1;
+    }
+    m_stop_reason_tids_stop_id = stop_id;
+    return true;
+}
+
+bool
+ProcessGDBRemote::GetThreadsWithStopReason (std::vector<lldb::tid_t> &tids)
+{
+    // In non-stop mode the threads that are still running aren't in the
+    // list, leave it to them to say they didn't stop
+    if (!m_gdb_comm.GetLastStopStoppedAllThreads())
+        return false;
+
+    UpdateThreadsStopInfo ();
+    if (m_stop_reason_tids_stop_id != GetStopID())
+        return false;
+    tids = m_stop_reason_tids;
+    return true;
+}
+
+void
+ProcessGDBRemote::SetExpeditedThreadRegisters (std::string &value)
+{
+    size_t comma_pos = value.find(',');
+    if (comma_pos == std::string::npos)
+        return;
+    value[comma_pos] = '\0';
+    const lldb::tid_t tid = Args::StringToUInt64 (value.c_str(), LLDB_INVALID_THREAD_ID, 16);
+    if (tid == LLDB_INVALID_THREAD_ID)
+        return;
+
+    Mutex::Locker locker (m_thread_list.GetMutex ());
+    ThreadSP thread_sp (m_thread_list.FindThreadByID(tid, false));
+    if (!thread_sp)
+    {
+        thread_sp.reset (new ThreadGDBRemote (shared_from_this(), tid));
+        m_thread_list.AddThread(thread_sp);
+    }
+
+    ThreadGDBRemote *gdb_thread = static_cast<ThreadGDBRemote *> (thread_sp.get());
+    while (comma_pos != std::string::npos)
+    {
+        const size_t reg_start = comma_pos + 1;
+        comma_pos = value.find(',', reg_start);
+        const size_t reg_end = comma_pos == std::string::npos ? value.size() : comma_pos;
+        const size_t equal_pos = value.find('=', reg_start);
+        if (equal_pos == std::string::npos || equal_pos > reg_end)
+            break;
+        uint32_t reg = Args::StringToUInt32 (value.substr (reg_start, equal_pos - reg_start).c_str(), UINT32_MAX, 16);
+        if (reg == UINT32_MAX)
+            break;
+        StringExtractor reg_value_extractor (value.substr (equal_pos + 1, reg_end - (equal_pos + 1)).c_str());
+        gdb_thread->PrivateSetRegisterValue (reg, reg_value_extractor);
+    }
+}
 
 StateType
-ProcessGDBRemote::SetThreadStopInfo (StringExtractor& stop_packet)
+ProcessGDBRemote::SetThreadStopInfo (StringExtractor& stop_packet, ThreadSP *thread_sp_ptr)
 {
     stop_packet.SetFilePos (0);
     const char stop_type = stop_packet.GetChar();
@@ -1362,6 +1516,40 @@ ProcessGDBRemote::SetThreadStopInfo (StringExtractor& stop_packet)
                     // Now convert the HEX bytes into a string value
                     desc_extractor.GetHexByteString (thread_name);
                 }
+                else if (name.compare("memory") == 0)
+                {
+                    // Expedited memory in the form "<addr>=<hex bytes>", put
+                    // it in the memory cache so the unwinder won't have to
+                    // read it from the remote stub.
+                    const size_t equal_pos = value.find('=');
+                    if (equal_pos != std::string::npos)
+                    {
+                        bool success = false;
+                        value[equal_pos] = '\0';
+                        const addr_t mem_addr = Args::StringToUInt64 (value.c_str(), LLDB_INVALID_ADDRESS, 16, &success);
+                        if (success)
+                        {
+                            StringExtractor bytes_extractor (value.c_str() + equal_pos + 1);
+                            std::string bytes;
+                            bytes_extractor.GetHexByteString (bytes);
+                            m_memory_cache.AddL1CacheData (mem_addr, bytes.data(), bytes.size());
+                        }
+                    }
+                }
+                else if (name.compare("thread-regs") == 0)
+                {
+                    // Expedited registers for a thread other than the one
+                    // this stop reply is for in the form
+                    // "<tid>,<regnum>=<value>,<regnum>=<value>..."
+                    SetExpeditedThreadRegisters (value);
+                }
+                else if (name.compare("bpfiltered") == 0)
+                {
+                    // Hits of a breakpoint whose conditions the stub
+                    // evaluated to false since the last stop, in the form
+                    // "<addr>,<count>"
+                    AddFilteredBreakpointHits (value);
+                }
                 else if (name.size() == 2 && ::isxdigit(name[0]) && ::isxdigit(name[1]))
                 {
                     // We have a register number that contains an expedited
@@ -1394,6 +1582,8 @@ ProcessGDBRemote::SetThreadStopInfo (StringExtractor& stop_packet)
             {
                 ThreadGDBRemote *gdb_thread = static_cast<ThreadGDBRemote *> (thread_sp.get());
 
+                // Any thread with a stop reply is stopped, even in non-stop mode
+                gdb_thread->SetRunningInNonStopMode (false);
                 gdb_thread->SetThreadDispatchQAddr (thread_dispatch_qaddr);
                 gdb_thread->SetName (thread_name.empty() ? NULL : thread_name.c_str());
                 if (exc_type != 0)
@@ -1512,6 +1702,8 @@ ProcessGDBRemote::SetThreadStopInfo (StringExtractor& stop_packet)
                     }
                 }
             }
+            if (thread_sp_ptr)
+                *thread_sp_ptr = thread_sp;
             return eStateStopped;
         }
         break;
@@ -1531,10 +1723,29 @@ ProcessGDBRemote::RefreshStateAfterStop ()
 {
     Mutex::Locker locker(m_thread_list.GetMutex());
     m_thread_ids.clear();
+
+    // In non-stop mode only the threads that have stop replies stopped,
+    // the others keep running until they stop on their own.
+    const bool all_threads_stopped = m_gdb_comm.GetLastStopStoppedAllThreads();
+    const uint32_t num_threads = m_thread_list.GetSize(false);
+    for (uint32_t i = 0; i < num_threads; ++i)
+    {
+        ThreadGDBRemote *gdb_thread = static_cast<ThreadGDBRemote *> (m_thread_list.GetThreadAtIndex (i, false).get());
+        gdb_thread->SetRunningInNonStopMode (!all_threads_stopped);
+    }
+
     // Set the thread stop info. It might have a "threads" key whose value is
     // a list of all thread IDs in the current process, so m_thread_ids might
     // get set.
     SetThreadStopInfo (m_last_stop_packet);
+
+    std::vector<std::string> stop_replies;
+    m_gdb_comm.GetNonStopStopReplies (stop_replies);
+    for (size_t i = 0; i < stop_replies.size(); ++i)
+    {
+        StringExtractor stop_packet (stop_replies[i].c_str());
+        SetThreadStopInfo (stop_packet);
+    }
     // Check to see if SetThreadStopInfo() filled in m_thread_ids?
     if (m_thread_ids.empty())
     {
@@ -1582,7 +1793,7 @@ ProcessGDBRemote::InterruptIfRunning
 (
     bool discard_thread_plans, 
     bool catch_stop_event, 
-    EventSP &stop_event_sp
+    EventIntrusiveSP &stop_event_sp
 )
 {
     Error error;
@@ -1662,7 +1873,7 @@ ProcessGDBRemote::WillDetach ()
 
     bool discard_thread_plans = true; 
     bool catch_stop_event = true;
-    EventSP event_sp;
+    EventIntrusiveSP event_sp;
     
     // FIXME: InterruptIfRunning should be done in the Process base class, or better still make Halt do what is
     // needed.  This shouldn't be a feature of a particular plugin.
@@ -1678,6 +1889,16 @@ ProcessGDBRemote::DoDetach()
     if (log)
         log->Printf ("ProcessGDBRemote::DoDetach()");
 
+    // Register writes are only sent when threads resume, so send any
+    // that are still waiting before the process is let go.
+    const uint32_t num_threads = m_thread_list.GetSize (false);
+    for (uint32_t i = 0; i < num_threads; ++i)
+    {
+        ThreadGDBRemote *gdb_thread = static_cast<ThreadGDBRemote *>(m_thread_list.GetThreadAtIndex (i, false).get());
+        if (gdb_thread)
+            gdb_thread->WriteDirtyRegisters ();
+    }
+
     DisableAllBreakpointSites ();
 
     m_thread_list.DiscardThreadPlans();
@@ -1897,39 +2118,151 @@ ProcessGDBRemote::GetImageInfoAddress()
 //------------------------------------------------------------------
 // Process Memory
 //------------------------------------------------------------------
+// The maximum number of memory read packets we will have in flight at once
+#define MAX_PIPELINED_MEMORY_READS  32
+// The maximum number of ranges we will read with one "qMultiMemRead" packet
+#define MAX_MULTI_MEMORY_READ_RANGES    128
+
 size_t
 ProcessGDBRemote::DoReadMemory (addr_t addr, void *buf, size_t size, Error &error)
 {
     if (size > m_max_memory_size)
     {
+        // Large reads are split into multiple packets which can be sent back
+        // to back so we only pay for one round trip to the remote stub.
+        if (m_gdb_comm.GetPipelinedPacketsSupported())
+        {
+            const size_t bytes_read = ReadMemoryPipelined (addr, buf, size, error);
+            if (bytes_read > 0)
+                return bytes_read;
+        }
+
         // Keep memory read sizes down to a sane limit. This function will be
         // called multiple times in order to complete the task by 
         // lldb_private::Process so it is ok to do this.
         size = m_max_memory_size;
     }
 
+    // Binary "x" reads send half as many bytes over the wire as hex
+    // encoded "m" reads, so use them whenever the remote stub can.
+    const bool binary_memory_read = m_gdb_comm.GetxPacketSupported();
+
     char packet[64];
-    const int packet_len = ::snprintf (packet, sizeof(packet), "m%llx,%zx", (uint64_t)addr, size);
+    const int packet_len = ::snprintf (packet, sizeof(packet), "%c%llx,%zx", binary_memory_read ? 'x' : 'm', (uint64_t)addr, size);
     assert (packet_len + 1 < sizeof(packet));
     StringExtractorGDBRemote response;
     if (m_gdb_comm.SendPacketAndWaitForResponse(packet, packet_len, response, true))
+        return GetMemoryReadResponseBytes (response, packet, binary_memory_read, buf, size, error);
+
+    error.SetErrorStringWithFormat("failed to sent packet: '%s'", packet);
+    return 0;
+}
+
+size_t
+ProcessGDBRemote::DoReadMemoryRanges (MemoryReadRange *ranges, size_t num_ranges, Error &error)
+{
+    // Read as many ranges as will fit in one reply with each packet.
+    // Ranges that are too large on their own are read one at a time.
+    size_t total_bytes_read = 0;
+    size_t i = 0;
+    while (i < num_ranges)
     {
-        if (response.IsNormalResponse())
+        if (ranges[i].size > m_max_memory_size)
         {
-            error.Clear();
-            return response.GetHexBytes(buf, size, '\xdd');
+            total_bytes_read += Process::DoReadMemoryRanges (&ranges[i], 1, error);
+            ++i;
+            continue;
         }
-        else if (response.IsErrorResponse())
-            error.SetErrorStringWithFormat("gdb remote returned an error: %s", response.GetStringRef().c_str());
-        else if (response.IsUnsupportedResponse())
-            error.SetErrorStringWithFormat("'%s' packet unsupported", packet);
-        else
-            error.SetErrorStringWithFormat("unexpected response to '%s': '%s'", packet, response.GetStringRef().c_str());
+
+        size_t batch_size = 0;
+        size_t num_batch_ranges = 0;
+        while (i + num_batch_ranges < num_ranges &&
+               num_batch_ranges < MAX_MULTI_MEMORY_READ_RANGES &&
+               batch_size + ranges[i + num_batch_ranges].size <= m_max_memory_size)
+        {
+            batch_size += ranges[i + num_batch_ranges].size;
+            ++num_batch_ranges;
+        }
+
+        if (!m_gdb_comm.ReadMemoryRanges (&ranges[i], num_batch_ranges, error))
+            return total_bytes_read + Process::DoReadMemoryRanges (&ranges[i], num_ranges - i, error);
+
+        for (size_t j=0; j<num_batch_ranges; ++j)
+            total_bytes_read += ranges[i + j].bytes_read;
+        i += num_batch_ranges;
     }
-    else
+    return total_bytes_read;
+}
+
+size_t
+ProcessGDBRemote::ReadMemoryPipelined (addr_t addr, void *buf, size_t size, Error &error)
+{
+    const bool binary_memory_read = m_gdb_comm.GetxPacketSupported();
+    const size_t num_packets = std::min<size_t> ((size + m_max_memory_size - 1) / m_max_memory_size, MAX_PIPELINED_MEMORY_READS);
+
+    std::vector<std::string> packets (num_packets);
+    for (size_t i=0; i<num_packets; ++i)
+    {
+        const size_t offset = i * m_max_memory_size;
+        char packet[64];
+        const int packet_len = ::snprintf (packet, sizeof(packet), "%c%llx,%zx",
+                                           binary_memory_read ? 'x' : 'm',
+                                           (uint64_t)(addr + offset),
+                                           std::min<size_t> (m_max_memory_size, size - offset));
+        assert (packet_len + 1 < sizeof(packet));
+        packets[i].assign (packet, packet_len);
+    }
+
+    std::vector<StringExtractorGDBRemote> responses;
+    const size_t num_responses = m_gdb_comm.SendPacketsAndWaitForResponses (packets, responses);
+
+    uint8_t *dst = (uint8_t *)buf;
+    size_t total_bytes_read = 0;
+    for (size_t i=0; i<num_responses; ++i)
     {
-        error.SetErrorStringWithFormat("failed to sent packet: '%s'", packet);
+        const size_t chunk_size = std::min<size_t> (m_max_memory_size, size - total_bytes_read);
+        const size_t bytes_read = GetMemoryReadResponseBytes (responses[i],
+                                                              packets[i].c_str(),
+                                                              binary_memory_read,
+                                                              dst + total_bytes_read,
+                                                              chunk_size,
+                                                              error);
+        total_bytes_read += bytes_read;
+        // Stop at the first short read, the data after it can't be used
+        if (bytes_read < chunk_size)
+            break;
     }
+    if (total_bytes_read > 0)
+        error.Clear();
+    return total_bytes_read;
+}
+
+size_t
+ProcessGDBRemote::GetMemoryReadResponseBytes (StringExtractorGDBRemote &response,
+                                              const char *packet,
+                                              bool binary_memory_read,
+                                              void *buf,
+                                              size_t size,
+                                              Error &error)
+{
+    if (response.IsNormalResponse())
+    {
+        error.Clear();
+        if (binary_memory_read)
+        {
+            std::string data;
+            const size_t data_size = std::min<size_t> (response.GetEscapedBinaryData (data), size);
+            ::memcpy (buf, data.data(), data_size);
+            return data_size;
+        }
+        return response.GetHexBytes(buf, size, '\xdd');
+    }
+    else if (response.IsErrorResponse())
+        error.SetErrorStringWithFormat("gdb remote returned an error: %s", response.GetStringRef().c_str());
+    else if (response.IsUnsupportedResponse())
+        error.SetErrorStringWithFormat("'%s' packet unsupported", packet);
+    else
+        error.SetErrorStringWithFormat("unexpected response to '%s': '%s'", packet, response.GetStringRef().c_str());
     return 0;
 }
 
@@ -1973,6 +2306,9 @@ lldb::addr_t
 ProcessGDBRemote::DoAllocateMemory (size_t size, uint32_t permissions, Error &error)
 {
     addr_t allocated_addr = LLDB_INVALID_ADDRESS;
+
+    // Allocating changes the memory map without a stop
+    m_memory_region_map_stop_id = UINT32_MAX;
     
     LazyBool supported = m_gdb_comm.SupportsAllocDeallocMemory();
     switch (supported)
@@ -2008,13 +2344,87 @@ ProcessGDBRemote::DoAllocateMemory (size_t size, uint32_t permissions, Error &er
     return allocated_addr;
 }
 
+// Fetch all the memory regions with one packet, at most once per stop.
+// Returns false if the stub can't list them and each query has to be
+// sent with its own "qMemoryRegionInfo" packet.
+bool
+ProcessGDBRemote::UpdateMemoryRegionMap ()
+{
+    const uint32_t stop_id = GetStopID();
+    if (m_memory_region_map_stop_id == stop_id)
+        return m_memory_region_map_is_valid;
+    m_memory_region_map_stop_id = stop_id;
+    m_memory_region_map.Clear();
+    m_memory_region_map_is_valid = false;
+
+    std::vector<MemoryRegionInfo> regions;
+    Error error;
+    if (!m_gdb_comm.GetMemoryRegionInfos (regions, error) || error.Fail())
+        return false;
+
+    std::vector<MemoryRegionInfo>::const_iterator pos, end = regions.end();
+    for (pos = regions.begin(); pos != end; ++pos)
+    {
+        uint32_t permissions = 0;
+        if (pos->GetReadable() == MemoryRegionInfo::eYes)
+            permissions |= lldb::ePermissionsReadable;
+        if (pos->GetWritable() == MemoryRegionInfo::eYes)
+            permissions |= lldb::ePermissionsWritable;
+        if (pos->GetExecutable() == MemoryRegionInfo::eYes)
+            permissions |= lldb::ePermissionsExecutable;
+        m_memory_region_map.Append (MemoryRegionMap::Entry (pos->GetRange().GetRangeBase(),
+                                                            pos->GetRange().GetByteSize(),
+                                                            permissions));
+    }
+    m_memory_region_map.Sort();
+    m_memory_region_map_is_valid = true;
+    return true;
+}
+
 Error
 ProcessGDBRemote::GetMemoryRegionInfo (addr_t load_addr, 
                                        MemoryRegionInfo &region_info)
 {
-    
-    Error error (m_gdb_comm.GetMemoryRegionInfo (load_addr, region_info));
-    return error;
+    if (!UpdateMemoryRegionMap ())
+    {
+        Error error (m_gdb_comm.GetMemoryRegionInfo (load_addr, region_info));
+        return error;
+    }
+
+    region_info.Clear();
+    const MemoryRegionMap::Entry *entry = m_memory_region_map.FindEntryThatContains (load_addr);
+    if (entry)
+    {
+        region_info.GetRange().SetRangeBase (entry->GetRangeBase());
+        region_info.GetRange().SetByteSize (entry->GetByteSize());
+        region_info.SetReadable ((entry->data & lldb::ePermissionsReadable) ? MemoryRegionInfo::eYes : MemoryRegionInfo::eNo);
+        region_info.SetWritable ((entry->data & lldb::ePermissionsWritable) ? MemoryRegionInfo::eYes : MemoryRegionInfo::eNo);
+        region_info.SetExecutable ((entry->data & lldb::ePermissionsExecutable) ? MemoryRegionInfo::eYes : MemoryRegionInfo::eNo);
+    }
+    else
+    {
+        // The address isn't mapped, like with "qMemoryRegionInfo" the
+        // unmapped region runs up to the next mapped region
+        size_t lo = 0;
+        size_t hi = m_memory_region_map.GetSize();
+        while (lo < hi)
+        {
+            const size_t mid = (lo + hi) / 2;
+            if (m_memory_region_map.GetEntryRef(mid).GetRangeBase() <= load_addr)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        addr_t end_addr = LLDB_INVALID_ADDRESS;
+        if (lo < m_memory_region_map.GetSize())
+            end_addr = m_memory_region_map.GetEntryRef(lo).GetRangeBase();
+        region_info.GetRange().SetRangeBase (load_addr);
+        region_info.GetRange().SetByteSize (end_addr - load_addr);
+        region_info.SetReadable (MemoryRegionInfo::eNo);
+        region_info.SetWritable (MemoryRegionInfo::eNo);
+        region_info.SetExecutable (MemoryRegionInfo::eNo);
+    }
+    return Error();
 }
 
 Error
@@ -2032,6 +2442,50 @@ ProcessGDBRemote::GetWatchpointSupportInfo (uint32_t &num, bool& after)
     return error;
 }
 
+addr_t
+ProcessGDBRemote::FindInMemory (addr_t start_addr, addr_t end_addr, const uint8_t *pattern, size_t pattern_size, Error &error)
+{
+    // Have the remote stub search the memory so it doesn't all have to
+    // be sent to us. Search in pieces, which overlap by one byte less
+    // than the pattern, so no single packet takes too long.
+    const addr_t search_size = 32 * 1024 * 1024;
+    if (pattern == NULL || pattern_size == 0 || pattern_size > search_size || start_addr >= end_addr)
+        return Process::FindInMemory (start_addr, end_addr, pattern, pattern_size, error);
+
+    error.Clear();
+    addr_t addr = start_addr;
+    while (addr < end_addr && end_addr - addr >= pattern_size)
+    {
+        const addr_t length = std::min<addr_t> (search_size, end_addr - addr);
+        addr_t match_addr = LLDB_INVALID_ADDRESS;
+        // Give the stub a second for every 4MB it has to search on top of
+        // the normal packet timeout.
+        const uint32_t search_timeout = m_gdb_comm.GetPacketTimeoutInMicroSeconds() / TimeValue::MicroSecPerSec + 2 + (uint32_t)(length / (4 * 1024 * 1024));
+        const uint32_t old_packet_timeout = m_gdb_comm.SetPacketTimeout (search_timeout);
+        const bool supported = m_gdb_comm.SearchMemory (addr, length, pattern, pattern_size, match_addr, error);
+        m_gdb_comm.SetPacketTimeout (old_packet_timeout);
+
+        // Fall back to reading the memory if the remote stub can't search it
+        if (!supported)
+            return Process::FindInMemory (addr, end_addr, pattern, pattern_size, error);
+
+        if (error.Fail() || match_addr != LLDB_INVALID_ADDRESS)
+            return match_addr;
+
+        if (length == end_addr - addr)
+            break;
+        addr += length - (pattern_size - 1);
+    }
+    return LLDB_INVALID_ADDRESS;
+}
+
+Error
+ProcessGDBRemote::GetSharedLibraryInfos (addr_t image_infos_addr, uint32_t image_infos_count, std::string &infos)
+{
+    Error error (m_gdb_comm.GetSharedLibraryInfos (image_infos_addr, image_infos_count, infos));
+    return error;
+}
+
 Error
 ProcessGDBRemote::DoDeallocateMemory (lldb::addr_t addr)
 {
@@ -2064,6 +2518,8 @@ ProcessGDBRemote::DoDeallocateMemory (lldb::addr_t addr)
             break;
     }
 
+    // Deallocating changes the memory map without a stop
+    m_memory_region_map_stop_id = UINT32_MAX;
     return error;
 }
 
@@ -2104,16 +2560,24 @@ ProcessGDBRemote::EnableBreakpoint (BreakpointSite *bp_site)
     {
         const size_t bp_op_size = GetSoftwareBreakpointTrapOpcode (bp_site);
 
+        // If the stub can evaluate the conditions of all the locations at
+        // this site, send them along so we only hear about the hits that
+        // matter.
+        std::string conditions;
+        GetBreakpointSiteConditions (bp_site, conditions);
+
         if (bp_site->HardwarePreferred())
         {
             // Try and set hardware breakpoint, and if that fails, fall through
             // and set a software breakpoint?
             if (m_gdb_comm.SupportsGDBStoppointPacket (eBreakpointHardware))
             {
-                if (m_gdb_comm.SendGDBStoppointTypePacket(eBreakpointHardware, true, addr, bp_op_size) == 0)
+                if (m_gdb_comm.SendGDBStoppointTypePacket(eBreakpointHardware, true, addr, bp_op_size, conditions.c_str()) == 0)
                 {
                     bp_site->SetEnabled(true);
                     bp_site->SetType (BreakpointSite::eHardware);
+                    if (!conditions.empty())
+                        m_breakpoint_site_conditions[site_id] = conditions;
                     return error;
                 }
             }
@@ -2121,10 +2585,12 @@ ProcessGDBRemote::EnableBreakpoint (BreakpointSite *bp_site)
 
         if (m_gdb_comm.SupportsGDBStoppointPacket (eBreakpointSoftware))
         {
-            if (m_gdb_comm.SendGDBStoppointTypePacket(eBreakpointSoftware, true, addr, bp_op_size) == 0)
+            if (m_gdb_comm.SendGDBStoppointTypePacket(eBreakpointSoftware, true, addr, bp_op_size, conditions.c_str()) == 0)
             {
                 bp_site->SetEnabled(true);
                 bp_site->SetType (BreakpointSite::eExternal);
+                if (!conditions.empty())
+                    m_breakpoint_site_conditions[site_id] = conditions;
                 return error;
             }
         }
@@ -2178,7 +2644,10 @@ ProcessGDBRemote::DisableBreakpoint (BreakpointSite *bp_site)
             break;
         }
         if (error.Success())
+        {
             bp_site->SetEnabled(false);
+            m_breakpoint_site_conditions.erase (site_id);
+        }
     }
     else
     {
@@ -2192,6 +2661,363 @@ ProcessGDBRemote::DisableBreakpoint (BreakpointSite *bp_site)
     return error;
 }
 
+// The maximum number of breakpoint packets we will have in flight at once
+#define MAX_PIPELINED_BREAKPOINT_PACKETS    64
+
+size_t
+ProcessGDBRemote::EnableBreakpointSites (const BreakpointSiteList &bp_sites, Error &error)
+{
+    std::vector<BreakpointSiteSP> sites;
+    bp_sites.GetSites (sites);
+
+    // Sites the stub can insert get pipelined "Z0" packets, and when the
+    // stub can't insert breakpoints the traps are written a page at a time.
+    // Sites that would rather be hardware breakpoints go one at a time.
+    const bool pipelined = m_gdb_comm.GetPipelinedPacketsSupported();
+    size_t num_enabled = 0;
+    std::vector<BreakpointSite *> packet_sites;
+    std::vector<std::string> packet_conditions;
+    std::vector<std::string> packets;
+    BreakpointSiteList software_sites;
+    for (size_t i=0; i<sites.size(); ++i)
+    {
+        BreakpointSite *bp_site = sites[i].get();
+        if (bp_site->IsEnabled())
+        {
+            ++num_enabled;
+        }
+        else if (!bp_site->HardwarePreferred() && m_gdb_comm.SupportsGDBStoppointPacket (eBreakpointSoftware) && pipelined)
+        {
+            std::string conditions;
+            GetBreakpointSiteConditions (bp_site, conditions);
+            StreamString packet;
+            packet.Printf ("Z%i,%llx,%zx%s",
+                           eBreakpointSoftware,
+                           (uint64_t)bp_site->GetLoadAddress(),
+                           GetSoftwareBreakpointTrapOpcode (bp_site),
+                           conditions.c_str());
+            packets.push_back (std::string (packet.GetData(), packet.GetSize()));
+            packet_conditions.push_back (conditions);
+            packet_sites.push_back (bp_site);
+        }
+        else if (!bp_site->HardwarePreferred() && !m_gdb_comm.SupportsGDBStoppointPacket (eBreakpointSoftware))
+        {
+            software_sites.Add (sites[i]);
+        }
+        else
+        {
+            Error site_error (EnableBreakpoint (bp_site));
+            if (site_error.Success())
+                ++num_enabled;
+            else if (error.Success())
+                error = site_error;
+        }
+    }
+
+    std::vector<bool> succeeded;
+    SendBreakpointPacketsPipelined (packets, succeeded);
+    for (size_t i=0; i<packet_sites.size(); ++i)
+    {
+        if (succeeded[i])
+        {
+            packet_sites[i]->SetEnabled(true);
+            packet_sites[i]->SetType (BreakpointSite::eExternal);
+            if (!packet_conditions[i].empty())
+                m_breakpoint_site_conditions[packet_sites[i]->GetID()] = packet_conditions[i];
+            ++num_enabled;
+        }
+        else
+        {
+            // Let the single site version sort out why, it falls back on
+            // writing the trap ourselves if the stub can't insert it.
+            Error site_error (EnableBreakpoint (packet_sites[i]));
+            if (site_error.Success())
+                ++num_enabled;
+            else if (error.Success())
+                error = site_error;
+        }
+    }
+
+    if (software_sites.GetSize() > 0)
+        num_enabled += EnableSoftwareBreakpoints (software_sites, error);
+    return num_enabled;
+}
+
+size_t
+ProcessGDBRemote::DisableBreakpointSites (const BreakpointSiteList &bp_sites, Error &error)
+{
+    std::vector<BreakpointSiteSP> sites;
+    bp_sites.GetSites (sites);
+
+    const bool pipelined = m_gdb_comm.GetPipelinedPacketsSupported();
+    size_t num_disabled = 0;
+    std::vector<BreakpointSite *> packet_sites;
+    std::vector<std::string> packets;
+    BreakpointSiteList software_sites;
+    for (size_t i=0; i<sites.size(); ++i)
+    {
+        BreakpointSite *bp_site = sites[i].get();
+        if (!bp_site->IsEnabled())
+        {
+            ++num_disabled;
+        }
+        else if (bp_site->GetType() == BreakpointSite::eSoftware)
+        {
+            software_sites.Add (sites[i]);
+        }
+        else if (bp_site->GetType() == BreakpointSite::eExternal && pipelined)
+        {
+            StreamString packet;
+            packet.Printf ("z%i,%llx,%zx",
+                           eBreakpointSoftware,
+                           (uint64_t)bp_site->GetLoadAddress(),
+                           GetSoftwareBreakpointTrapOpcode (bp_site));
+            packets.push_back (std::string (packet.GetData(), packet.GetSize()));
+            packet_sites.push_back (bp_site);
+        }
+        else
+        {
+            Error site_error (DisableBreakpoint (bp_site));
+            if (site_error.Success())
+                ++num_disabled;
+            else if (error.Success())
+                error = site_error;
+        }
+    }
+
+    std::vector<bool> succeeded;
+    SendBreakpointPacketsPipelined (packets, succeeded);
+    for (size_t i=0; i<packet_sites.size(); ++i)
+    {
+        if (succeeded[i])
+        {
+            packet_sites[i]->SetEnabled(false);
+            m_breakpoint_site_conditions.erase (packet_sites[i]->GetID());
+            ++num_disabled;
+        }
+        else
+        {
+            Error site_error (DisableBreakpoint (packet_sites[i]));
+            if (site_error.Success())
+                ++num_disabled;
+            else if (error.Success())
+                error = site_error;
+        }
+    }
+
+    if (software_sites.GetSize() > 0)
+        num_disabled += DisableSoftwareBreakpoints (software_sites, error);
+    return num_disabled;
+}
+
+//----------------------------------------------------------------------
+// Send "Z" or "z" packets without waiting for the reply to each one
+// before sending the next. SUCCEEDED gets one entry for each packet
+// that is true if the stub replied "OK".
+//----------------------------------------------------------------------
+void
+ProcessGDBRemote::SendBreakpointPacketsPipelined (const std::vector<std::string> &packets,
+                                                  std::vector<bool> &succeeded)
+{
+    succeeded.assign (packets.size(), false);
+    for (size_t i=0; i<packets.size(); i += MAX_PIPELINED_BREAKPOINT_PACKETS)
+    {
+        const size_t num_packets = std::min<size_t> (packets.size() - i, MAX_PIPELINED_BREAKPOINT_PACKETS);
+        std::vector<std::string> batch (packets.begin() + i, packets.begin() + i + num_packets);
+        std::vector<StringExtractorGDBRemote> responses;
+        const size_t num_responses = m_gdb_comm.SendPacketsAndWaitForResponses (batch, responses);
+        for (size_t j=0; j<num_responses; ++j)
+            succeeded[i + j] = responses[j].IsOKResponse();
+    }
+}
+
+bool
+ProcessGDBRemote::GetBreakpointSiteConditions (BreakpointSite *bp_site, std::string &conditions)
+{
+    conditions.clear();
+    if (!m_gdb_comm.GetBreakpointConditionsSupported())
+        return false;
+
+    // The stub can only filter the hits if every location at this site has
+    // a condition we can compile, and nothing else needs to see the hits where
+    // the condition is false: ignore counts count those hits, and synchronous
+    // callbacks run before the condition is checked.
+    const uint32_t long_byte_size = GetTarget().GetArchitecture().GetAddressByteSize();
+    const size_t num_owners = bp_site->GetNumberOfOwners();
+    if (num_owners == 0)
+        return false;
+    StreamString strm;
+    for (size_t i=0; i<num_owners; ++i)
+    {
+        BreakpointLocationSP bp_loc_sp (bp_site->GetOwnerAtIndex(i));
+        if (!bp_loc_sp)
+            return false;
+        if (bp_loc_sp->GetIgnoreCount() != 0 || bp_loc_sp->GetBreakpoint().GetIgnoreCount() != 0)
+            return false;
+        const BreakpointOptions *loc_options = bp_loc_sp->GetOptionsNoCreate();
+        if (loc_options && loc_options->HasCallback() && loc_options->IsCallbackSynchronous())
+            return false;
+        const BreakpointOptions *bp_options = bp_loc_sp->GetBreakpoint().GetOptions();
+        if (bp_options && bp_options->HasCallback() && bp_options->IsCallbackSynchronous())
+            return false;
+
+        std::string bytecode;
+        if (!GDBRemoteAgentExpression::CompileCondition (bp_loc_sp->GetConditionText(), m_register_info, long_byte_size, bytecode))
+            return false;
+        strm.Printf (";X%x,", (uint32_t)bytecode.size());
+        for (size_t j=0; j<bytecode.size(); ++j)
+            strm.PutHex8 ((uint8_t)bytecode[j]);
+    }
+    conditions.assign (strm.GetData(), strm.GetSize());
+    return true;
+}
+
+void
+ProcessGDBRemote::UpdateBreakpointSiteConditions ()
+{
+    // Conditions, ignore counts and the owners of a site can all change while
+    // we are stopped, so make sure the stub has the current conditions for each
+    // site before we let the process go.
+    BreakpointSiteList &bp_site_list = GetBreakpointSiteList();
+    const size_t num_sites = bp_site_list.GetSize();
+    for (size_t i=0; i<num_sites; ++i)
+    {
+        BreakpointSiteSP bp_site_sp (bp_site_list.GetByIndex(i));
+        if (!bp_site_sp || !bp_site_sp->IsEnabled() || bp_site_sp->GetType() == BreakpointSite::eSoftware)
+            continue;
+
+        std::string conditions;
+        GetBreakpointSiteConditions (bp_site_sp.get(), conditions);
+
+        std::string old_conditions;
+        BreakpointConditionsMap::const_iterator pos = m_breakpoint_site_conditions.find (bp_site_sp->GetID());
+        if (pos != m_breakpoint_site_conditions.end())
+            old_conditions = pos->second;
+        if (conditions == old_conditions)
+            continue;
+
+        LogSP log (ProcessGDBRemoteLog::GetLogIfAllCategoriesSet(GDBR_LOG_BREAKPOINTS));
+        if (log)
+            log->Printf ("ProcessGDBRemote::UpdateBreakpointSiteConditions (site_id = %llu) address = 0x%llx -- conditions changed, re-inserting",
+                         bp_site_sp->GetID(),
+                         (uint64_t)bp_site_sp->GetLoadAddress());
+        DisableBreakpoint (bp_site_sp.get());
+        if (!bp_site_sp->IsEnabled())
+            EnableBreakpoint (bp_site_sp.get());
+    }
+}
+
+void
+ProcessGDBRemote::AddFilteredBreakpointHits (const std::string &value)
+{
+    // The stub didn't stop for these hits, but they still count, just
+    // like the hits where lldb evaluated the condition to false itself.
+    StringExtractor extractor (value.c_str());
+    const addr_t addr = extractor.GetHexMaxU64 (false, LLDB_INVALID_ADDRESS);
+    if (extractor.GetChar() != ',')
+        return;
+    const uint32_t num_hits = extractor.GetHexMaxU32 (false, 0);
+    if (addr == LLDB_INVALID_ADDRESS || num_hits == 0)
+        return;
+
+    BreakpointSiteSP bp_site_sp (GetBreakpointSiteList().FindByAddress (addr));
+    if (bp_site_sp)
+        bp_site_sp->AddFilteredHits (num_hits);
+}
+
+bool
+ProcessGDBRemote::GetWatchpointConditions (Watchpoint *wp, std::string &conditions)
+{
+    conditions.clear();
+    const char *condition = wp->GetConditionText();
+    if (condition == NULL || condition[0] == '\0')
+        return false;
+    if (!m_gdb_comm.GetBreakpointConditionsSupported())
+        return false;
+
+    // The condition has to see the value after the access, which it can't
+    // on targets that report watchpoints before the instruction runs.
+    uint32_t num_supported = 0;
+    bool after = true;
+    if (m_gdb_comm.GetWatchpointSupportInfo (num_supported, after).Fail() || !after)
+        return false;
+
+    // Ignore counts count the hits where the condition is false, and
+    // synchronous callbacks run before the condition is checked.
+    if (wp->GetIgnoreCount() != 0)
+        return false;
+    WatchpointOptions *options = wp->GetOptions();
+    if (options && options->HasCallback() && options->IsCallbackSynchronous())
+        return false;
+
+    // Let the condition name the variable being watched, like
+    // "counter == 1000".
+    const char *value_name = NULL;
+    std::string watch_spec;
+    const Encoding encoding = wp->GetWatchVariableEncoding();
+    if (wp->IsWatchVariable() && (encoding == eEncodingSint || encoding == eEncodingUint))
+    {
+        watch_spec = wp->GetWatchSpec();
+        value_name = watch_spec.c_str();
+    }
+
+    const uint32_t long_byte_size = GetTarget().GetArchitecture().GetAddressByteSize();
+    std::string bytecode;
+    if (!GDBRemoteAgentExpression::CompileWatchpointCondition (condition,
+                                                               value_name,
+                                                               wp->GetLoadAddress(),
+                                                               wp->GetByteSize(),
+                                                               encoding == eEncodingSint,
+                                                               m_register_info,
+                                                               long_byte_size,
+                                                               bytecode))
+        return false;
+
+    StreamString strm;
+    strm.Printf (";X%x,", (uint32_t)bytecode.size());
+    for (size_t i=0; i<bytecode.size(); ++i)
+        strm.PutHex8 ((uint8_t)bytecode[i]);
+    conditions.assign (strm.GetData(), strm.GetSize());
+    return true;
+}
+
+void
+ProcessGDBRemote::UpdateWatchpointConditions ()
+{
+    // "watchpoint modify" can change the condition or the ignore count
+    // while we are stopped, re-insert the watchpoints whose conditions
+    // the stub has out of date.
+    WatchpointList &wp_list = GetTarget().GetWatchpointList();
+    Mutex::Locker locker;
+    wp_list.GetListMutex (locker);
+    const size_t num_watchpoints = wp_list.GetSize();
+    for (size_t i=0; i<num_watchpoints; ++i)
+    {
+        WatchpointSP wp_sp (wp_list.GetByIndex(i));
+        if (!wp_sp || !wp_sp->IsEnabled() || !wp_sp->IsHardware())
+            continue;
+
+        std::string conditions;
+        GetWatchpointConditions (wp_sp.get(), conditions);
+
+        std::string old_conditions;
+        BreakpointConditionsMap::const_iterator pos = m_watchpoint_conditions.find (wp_sp->GetID());
+        if (pos != m_watchpoint_conditions.end())
+            old_conditions = pos->second;
+        if (conditions == old_conditions)
+            continue;
+
+        LogSP log (ProcessGDBRemoteLog::GetLogIfAllCategoriesSet(GDBR_LOG_WATCHPOINTS));
+        if (log)
+            log->Printf ("ProcessGDBRemote::UpdateWatchpointConditions (watchID = %llu) addr = 0x%8.8llx -- conditions changed, re-inserting",
+                         wp_sp->GetID(),
+                         (uint64_t)wp_sp->GetLoadAddress());
+        DisableWatchpoint (wp_sp.get());
+        if (!wp_sp->IsEnabled())
+            EnableWatchpoint (wp_sp.get());
+    }
+}
+
 // Pre-requisite: wp != NULL.
 static GDBStoppointType
 GetGDBStoppointType (Watchpoint *wp)
@@ -2228,13 +3054,20 @@ ProcessGDBRemote::EnableWatchpoint (Watchpoint *wp)
             return error;
         }
 
+        // If the stub can evaluate the condition, send it along so hits
+        // where it is false don't stop the process at all.
+        std::string conditions;
+        GetWatchpointConditions (wp, conditions);
+
         GDBStoppointType type = GetGDBStoppointType(wp);
         // Pass down an appropriate z/Z packet...
         if (m_gdb_comm.SupportsGDBStoppointPacket (type))
         {
-            if (m_gdb_comm.SendGDBStoppointTypePacket(type, true, addr, wp->GetByteSize()) == 0)
+            if (m_gdb_comm.SendGDBStoppointTypePacket(type, true, addr, wp->GetByteSize(), conditions.c_str()) == 0)
             {
                 wp->SetEnabled(true);
+                if (!conditions.empty())
+                    m_watchpoint_conditions[watchID] = conditions;
                 return error;
             }
             else
@@ -2284,6 +3117,7 @@ ProcessGDBRemote::DisableWatchpoint (Watchpoint *wp)
             if (m_gdb_comm.SendGDBStoppointTypePacket(type, false, addr, wp->GetByteSize()) == 0)
             {
                 wp->SetEnabled(false);
+                m_watchpoint_conditions.erase (watchID);
                 return error;
             }
             else
@@ -2320,6 +3154,28 @@ ProcessGDBRemote::DoSignal (int signo)
     return error;
 }
 
+Error
+ProcessGDBRemote::EnableAsyncProfiling (uint32_t interval_usec, uint32_t max_frames, uint32_t scan_type)
+{
+    Error error;
+    if (interval_usec == 0 || scan_type == 0)
+        error.SetErrorString("the profiling interval and scan type must be non-zero");
+    else if ((scan_type & eProfileThreadStacks) && max_frames == 0)
+        error.SetErrorString("sampling thread stacks needs a non-zero frame count");
+    else if (!m_gdb_comm.SetEnableAsyncProfiling (true, interval_usec, max_frames, scan_type))
+        error.SetErrorString("remote stub doesn't support async profiling");
+    return error;
+}
+
+Error
+ProcessGDBRemote::DisableAsyncProfiling ()
+{
+    Error error;
+    if (!m_gdb_comm.SetEnableAsyncProfiling (false, 0, 0, 0))
+        error.SetErrorString("remote stub doesn't support async profiling");
+    return error;
+}
+
 Error
 ProcessGDBRemote::StartDebugserverProcess (const char *debugserver_url)
 {
@@ -2649,7 +3505,7 @@ ProcessGDBRemote::AsyncThread (void *arg)
         log->Printf ("ProcessGDBRemote::%s (arg = %p, pid = %llu) thread starting...", __FUNCTION__, arg, process->GetID());
 
     Listener listener ("ProcessGDBRemote::AsyncThread");
-    EventSP event_sp;
+    EventIntrusiveSP event_sp;
     const uint32_t desired_event_mask = eBroadcastBitAsyncContinue |
                                         eBroadcastBitAsyncThreadShouldExit;
 
@@ -2913,3 +3769,442 @@ ProcessGDBRemote::StopNoticingNewThreads()
 }
     
 
+
+//----------------------------------------------------------------------
+// Commands for "process plugin"
+//----------------------------------------------------------------------
+static uint64_t
+GetElapsedNanoSeconds (const TimeValue &start_time)
+{
+    return TimeValue::Now().GetAsNanoSecondsSinceJan1_1970() - start_time.GetAsNanoSecondsSinceJan1_1970();
+}
+
+class CommandObjectProcessGDBRemoteBenchmarkPackets : public CommandObjectParsed
+{
+public:
+    CommandObjectProcessGDBRemoteBenchmarkPackets (CommandInterpreter &interpreter) :
+        CommandObjectParsed (interpreter,
+                             "process plugin benchmark packets",
+                             "Measure how many packets a second are exchanged with the remote stub for packet sizes up to 1024 bytes.",
+                             NULL,
+                             eFlagProcessMustBeLaunched | eFlagProcessMustBePaused),
+        m_options (interpreter)
+    {
+    }
+
+    ~CommandObjectProcessGDBRemoteBenchmarkPackets ()
+    {
+    }
+
+    Options *
+    GetOptions ()
+    {
+        return &m_options;
+    }
+
+    class CommandOptions : public Options
+    {
+    public:
+        CommandOptions (CommandInterpreter &interpreter) :
+            Options (interpreter),
+            count (1000)
+        {
+        }
+
+        virtual
+        ~CommandOptions ()
+        {
+        }
+
+        virtual Error
+        SetOptionValue (uint32_t option_idx, const char *option_arg)
+        {
+            Error error;
+            char short_option = (char) m_getopt_table[option_idx].val;
+            bool success = false;
+
+            switch (short_option)
+            {
+            case 'c':
+                count = Args::StringToUInt32 (option_arg, 0, 0, &success);
+                if (!success || count == 0)
+                    error.SetErrorStringWithFormat ("invalid count '%s'", option_arg);
+                break;
+            default:
+                error.SetErrorStringWithFormat ("unrecognized option '%c'", short_option);
+                break;
+            }
+            return error;
+        }
+
+        void
+        OptionParsingStarting ()
+        {
+            count = 1000;
+        }
+
+        const OptionDefinition*
+        GetDefinitions ()
+        {
+            return g_option_table;
+        }
+
+        static OptionDefinition g_option_table[];
+
+        uint32_t count;
+    };
+
+protected:
+    bool
+    DoExecute (Args& command, CommandReturnObject &result)
+    {
+        ProcessGDBRemote *process = (ProcessGDBRemote *)m_interpreter.GetExecutionContext().GetProcessPtr();
+        process->GetGDBRemote().TestPacketSpeed (m_options.count, result.GetOutputStream());
+        result.SetStatus (eReturnStatusSuccessFinishResult);
+        return true;
+    }
+
+    CommandOptions m_options;
+};
+
+OptionDefinition
+CommandObjectProcessGDBRemoteBenchmarkPackets::CommandOptions::g_option_table[] =
+{
+{ LLDB_OPT_SET_1, false, "count", 'c', required_argument, NULL, 0, eArgTypeCount, "The number of packets to send for each combination of sizes (default 1000)."},
+{ 0, false, NULL, 0, 0, NULL, 0, eArgTypeNone, NULL }
+};
+
+class CommandObjectProcessGDBRemoteBenchmarkMemoryRead : public CommandObjectParsed
+{
+public:
+    CommandObjectProcessGDBRemoteBenchmarkMemoryRead (CommandInterpreter &interpreter) :
+        CommandObjectParsed (interpreter,
+                             "process plugin benchmark memory-read",
+                             "Measure memory read throughput for read sizes from 64 bytes up to a maximum, doubling each time. Reads bigger than one packet show the effect of pipelining.",
+                             NULL,
+                             eFlagProcessMustBeLaunched | eFlagProcessMustBePaused),
+        m_options (interpreter)
+    {
+    }
+
+    ~CommandObjectProcessGDBRemoteBenchmarkMemoryRead ()
+    {
+    }
+
+    Options *
+    GetOptions ()
+    {
+        return &m_options;
+    }
+
+    class CommandOptions : public Options
+    {
+    public:
+        CommandOptions (CommandInterpreter &interpreter) :
+            Options (interpreter),
+            count (100),
+            address (LLDB_INVALID_ADDRESS),
+            max_size (64 * 1024)
+        {
+        }
+
+        virtual
+        ~CommandOptions ()
+        {
+        }
+
+        virtual Error
+        SetOptionValue (uint32_t option_idx, const char *option_arg)
+        {
+            Error error;
+            char short_option = (char) m_getopt_table[option_idx].val;
+            bool success = false;
+
+            switch (short_option)
+            {
+            case 'a':
+                address = Args::StringToAddress (option_arg, LLDB_INVALID_ADDRESS, &success);
+                if (!success)
+                    error.SetErrorStringWithFormat ("invalid address '%s'", option_arg);
+                break;
+            case 'c':
+                count = Args::StringToUInt32 (option_arg, 0, 0, &success);
+                if (!success || count == 0)
+                    error.SetErrorStringWithFormat ("invalid count '%s'", option_arg);
+                break;
+            case 's':
+                max_size = Args::StringToUInt32 (option_arg, 0, 0, &success);
+                if (!success || max_size == 0)
+                    error.SetErrorStringWithFormat ("invalid size '%s'", option_arg);
+                break;
+            default:
+                error.SetErrorStringWithFormat ("unrecognized option '%c'", short_option);
+                break;
+            }
+            return error;
+        }
+
+        void
+        OptionParsingStarting ()
+        {
+            count = 100;
+            address = LLDB_INVALID_ADDRESS;
+            max_size = 64 * 1024;
+        }
+
+        const OptionDefinition*
+        GetDefinitions ()
+        {
+            return g_option_table;
+        }
+
+        static OptionDefinition g_option_table[];
+
+        uint32_t count;
+        lldb::addr_t address;
+        uint32_t max_size;
+    };
+
+protected:
+    bool
+    DoExecute (Args& command, CommandReturnObject &result)
+    {
+        ExecutionContext exe_ctx (m_interpreter.GetExecutionContext());
+        ProcessGDBRemote *process = (ProcessGDBRemote *)exe_ctx.GetProcessPtr();
+        lldb::addr_t addr = m_options.address;
+        if (addr == LLDB_INVALID_ADDRESS)
+        {
+            StackFrame *frame = exe_ctx.GetFramePtr();
+            if (frame == NULL)
+            {
+                result.AppendError ("no frame to get a default address from, specify one with --address");
+                result.SetStatus (eReturnStatusFailed);
+                return false;
+            }
+            addr = frame->GetFrameCodeAddress().GetLoadAddress (exe_ctx.GetTargetPtr());
+        }
+
+        Stream &strm = result.GetOutputStream();
+        std::vector<uint8_t> buffer (m_options.max_size);
+        for (uint32_t size = 64; size <= m_options.max_size; size *= 2)
+        {
+            // Read the process directly so the memory cache isn't measured
+            Error error;
+            uint64_t total_bytes_read = 0;
+            TimeValue start_time (TimeValue::Now());
+            for (uint32_t i = 0; i < m_options.count; ++i)
+            {
+                size_t bytes_read = 0;
+                while (bytes_read < size)
+                {
+                    const size_t curr_bytes_read = process->DoReadMemory (addr + bytes_read, &buffer[bytes_read], size - bytes_read, error);
+                    if (curr_bytes_read == 0)
+                        break;
+                    bytes_read += curr_bytes_read;
+                }
+                total_bytes_read += bytes_read;
+                if (bytes_read < size)
+                    break;
+            }
+            const uint64_t total_time_nsec = GetElapsedNanoSeconds (start_time);
+            if (total_bytes_read < (uint64_t)size * m_options.count)
+            {
+                strm.Printf ("reading %u bytes at 0x%llx failed: %s\n", size, addr, error.AsCString("short read"));
+                break;
+            }
+            const double seconds = (double)total_time_nsec / TimeValue::NanoSecPerSec;
+            strm.Printf ("%u reads of %6u bytes in %f sec: %10.1f usec/read, %10.3f MB/sec\n",
+                         m_options.count,
+                         size,
+                         seconds,
+                         seconds * 1000000.0 / m_options.count,
+                         seconds > 0 ? total_bytes_read / seconds / (1024.0 * 1024.0) : 0.0);
+        }
+        result.SetStatus (eReturnStatusSuccessFinishResult);
+        return true;
+    }
+
+    CommandOptions m_options;
+};
+
+OptionDefinition
+CommandObjectProcessGDBRemoteBenchmarkMemoryRead::CommandOptions::g_option_table[] =
+{
+{ LLDB_OPT_SET_1, false, "address",  'a', required_argument, NULL, 0, eArgTypeAddress,  "The address to read from (default: the pc of the selected frame)."},
+{ LLDB_OPT_SET_1, false, "count",    'c', required_argument, NULL, 0, eArgTypeCount,    "The number of reads of each size (default 100)."},
+{ LLDB_OPT_SET_1, false, "max-size", 's', required_argument, NULL, 0, eArgTypeByteSize, "The largest read size to measure (default 65536)."},
+{ 0, false, NULL, 0, 0, NULL, 0, eArgTypeNone, NULL }
+};
+
+class CommandObjectProcessGDBRemoteBenchmarkRegisterRead : public CommandObjectParsed
+{
+public:
+    CommandObjectProcessGDBRemoteBenchmarkRegisterRead (CommandInterpreter &interpreter) :
+        CommandObjectParsed (interpreter,
+                             "process plugin benchmark register-read",
+                             "Measure how long fetching all the registers of the selected thread takes, which every stop pays for each thread that is looked at.",
+                             NULL,
+                             eFlagProcessMustBeLaunched | eFlagProcessMustBePaused),
+        m_options (interpreter)
+    {
+    }
+
+    ~CommandObjectProcessGDBRemoteBenchmarkRegisterRead ()
+    {
+    }
+
+    Options *
+    GetOptions ()
+    {
+        return &m_options;
+    }
+
+    class CommandOptions : public Options
+    {
+    public:
+        CommandOptions (CommandInterpreter &interpreter) :
+            Options (interpreter),
+            count (100)
+        {
+        }
+
+        virtual
+        ~CommandOptions ()
+        {
+        }
+
+        virtual Error
+        SetOptionValue (uint32_t option_idx, const char *option_arg)
+        {
+            Error error;
+            char short_option = (char) m_getopt_table[option_idx].val;
+            bool success = false;
+
+            switch (short_option)
+            {
+            case 'c':
+                count = Args::StringToUInt32 (option_arg, 0, 0, &success);
+                if (!success || count == 0)
+                    error.SetErrorStringWithFormat ("invalid count '%s'", option_arg);
+                break;
+            default:
+                error.SetErrorStringWithFormat ("unrecognized option '%c'", short_option);
+                break;
+            }
+            return error;
+        }
+
+        void
+        OptionParsingStarting ()
+        {
+            count = 100;
+        }
+
+        const OptionDefinition*
+        GetDefinitions ()
+        {
+            return g_option_table;
+        }
+
+        static OptionDefinition g_option_table[];
+
+        uint32_t count;
+    };
+
+protected:
+    bool
+    DoExecute (Args& command, CommandReturnObject &result)
+    {
+        ExecutionContext exe_ctx (m_interpreter.GetExecutionContext());
+        Thread *thread = exe_ctx.GetThreadPtr();
+        RegisterContext *reg_ctx = thread ? thread->GetRegisterContext().get() : NULL;
+        if (reg_ctx == NULL)
+        {
+            result.AppendError ("no selected thread");
+            result.SetStatus (eReturnStatusFailed);
+            return false;
+        }
+
+        const uint32_t num_registers = reg_ctx->GetRegisterCount();
+        uint32_t num_failed = 0;
+        TimeValue start_time (TimeValue::Now());
+        for (uint32_t i = 0; i < m_options.count; ++i)
+        {
+            // Forget the registers so each pass asks the remote stub again
+            reg_ctx->InvalidateAllRegisters();
+            for (uint32_t reg = 0; reg < num_registers; ++reg)
+            {
+                RegisterValue reg_value;
+                if (!reg_ctx->ReadRegister (reg_ctx->GetRegisterInfoAtIndex (reg), reg_value))
+                    ++num_failed;
+            }
+        }
+        const uint64_t total_time_nsec = GetElapsedNanoSeconds (start_time);
+        reg_ctx->InvalidateAllRegisters();
+
+        const double seconds = (double)total_time_nsec / TimeValue::NanoSecPerSec;
+        result.GetOutputStream().Printf ("%u fetches of %u registers in %f sec: %.1f usec/fetch",
+                                         m_options.count,
+                                         num_registers,
+                                         seconds,
+                                         seconds * 1000000.0 / m_options.count);
+        if (num_failed)
+            result.GetOutputStream().Printf (" (%u register reads failed)", num_failed);
+        result.GetOutputStream().EOL();
+        result.SetStatus (eReturnStatusSuccessFinishResult);
+        return true;
+    }
+
+    CommandOptions m_options;
+};
+
+OptionDefinition
+CommandObjectProcessGDBRemoteBenchmarkRegisterRead::CommandOptions::g_option_table[] =
+{
+{ LLDB_OPT_SET_1, false, "count", 'c', required_argument, NULL, 0, eArgTypeCount, "The number of times to fetch all the registers (default 100)."},
+{ 0, false, NULL, 0, 0, NULL, 0, eArgTypeNone, NULL }
+};
+
+class CommandObjectProcessGDBRemoteBenchmark : public CommandObjectMultiword
+{
+public:
+    CommandObjectProcessGDBRemoteBenchmark (CommandInterpreter &interpreter) :
+        CommandObjectMultiword (interpreter,
+                                "process plugin benchmark",
+                                "Commands that measure the speed of the connection to the remote stub. Set process.simulated-link-latency and process.simulated-link-bandwidth before connecting to see how a far away device would do.",
+                                "process plugin benchmark <subcommand> [<subcommand-options>]")
+    {
+        LoadSubCommand ("packets",       CommandObjectSP (new CommandObjectProcessGDBRemoteBenchmarkPackets (interpreter)));
+        LoadSubCommand ("memory-read",   CommandObjectSP (new CommandObjectProcessGDBRemoteBenchmarkMemoryRead (interpreter)));
+        LoadSubCommand ("register-read", CommandObjectSP (new CommandObjectProcessGDBRemoteBenchmarkRegisterRead (interpreter)));
+    }
+
+    ~CommandObjectProcessGDBRemoteBenchmark ()
+    {
+    }
+};
+
+class CommandObjectMultiwordProcessGDBRemote : public CommandObjectMultiword
+{
+public:
+    CommandObjectMultiwordProcessGDBRemote (CommandInterpreter &interpreter) :
+        CommandObjectMultiword (interpreter,
+                                "process plugin",
+                                "A set of commands for operating on a gdb-remote process.",
+                                "process plugin <subcommand> [<subcommand-options>]")
+    {
+        LoadSubCommand ("benchmark", CommandObjectSP (new CommandObjectProcessGDBRemoteBenchmark (interpreter)));
+    }
+
+    ~CommandObjectMultiwordProcessGDBRemote ()
+    {
+    }
+};
+
+CommandObject *
+ProcessGDBRemote::GetPluginCommandObject()
+{
+    if (!m_command_sp)
+        m_command_sp.reset (new CommandObjectMultiwordProcessGDBRemote (GetTarget().GetDebugger().GetCommandInterpreter()));
+    return m_command_sp.get();
+}
@@ -146,6 +146,12 @@ public:
     virtual lldb_private::Error
     DoSignal (int signal);
 
+    virtual lldb_private::Error
+    EnableAsyncProfiling (uint32_t interval_usec, uint32_t max_frames, uint32_t scan_type);
+
+    virtual lldb_private::Error
+    DisableAsyncProfiling ();
+
     virtual lldb_private::Error
     DoDestroy ();
 
@@ -167,6 +173,9 @@ public:
     virtual size_t
     DoReadMemory (lldb::addr_t addr, void *buf, size_t size, lldb_private::Error &error);
 
+    virtual size_t
+    DoReadMemoryRanges (lldb_private::MemoryReadRange *ranges, size_t num_ranges, lldb_private::Error &error);
+
     virtual size_t
     DoWriteMemory (lldb::addr_t addr, const void *buf, size_t size, lldb_private::Error &error);
 
@@ -195,6 +204,12 @@ public:
     virtual lldb_private::Error
     DisableBreakpoint (lldb_private::BreakpointSite *bp_site);
 
+    virtual size_t
+    EnableBreakpointSites (const lldb_private::BreakpointSiteList &bp_sites, lldb_private::Error &error);
+
+    virtual size_t
+    DisableBreakpointSites (const lldb_private::BreakpointSiteList &bp_sites, lldb_private::Error &error);
+
     //----------------------------------------------------------------------
     // Process Watchpoints
     //----------------------------------------------------------------------
@@ -210,6 +225,18 @@ public:
     virtual lldb_private::Error
     GetWatchpointSupportInfo (uint32_t &num, bool& after);
     
+    virtual lldb_private::Error
+    GetSharedLibraryInfos (lldb::addr_t image_infos_addr,
+                           uint32_t image_infos_count,
+                           std::string &infos);
+
+    virtual lldb::addr_t
+    FindInMemory (lldb::addr_t start_addr,
+                  lldb::addr_t end_addr,
+                  const uint8_t *pattern,
+                  size_t pattern_size,
+                  lldb_private::Error &error);
+
     virtual bool
     StartNoticingNewThreads();    
 
@@ -222,6 +249,9 @@ public:
         return m_gdb_comm;
     }
 
+    virtual lldb_private::CommandObject *
+    GetPluginCommandObject();
+
 protected:
     friend class ThreadGDBRemote;
     friend class GDBRemoteCommunicationClient;
@@ -275,6 +305,9 @@ protected:
     UpdateThreadList (lldb_private::ThreadList &old_thread_list, 
                       lldb_private::ThreadList &new_thread_list);
 
+    virtual bool
+    GetThreadsWithStopReason (std::vector<lldb::tid_t> &tids);
+
     lldb_private::Error
     StartDebugserverProcess (const char *debugserver_url);
     
@@ -287,6 +320,39 @@ protected:
     void
     BuildDynamicRegisterInfo (bool force);
 
+    void
+    SetExpeditedThreadRegisters (std::string &value);
+
+    bool
+    GetBreakpointSiteConditions (lldb_private::BreakpointSite *bp_site, std::string &conditions);
+
+    void
+    UpdateBreakpointSiteConditions ();
+
+    void
+    AddFilteredBreakpointHits (const std::string &value);
+
+    bool
+    GetWatchpointConditions (lldb_private::Watchpoint *wp, std::string &conditions);
+
+    void
+    UpdateWatchpointConditions ();
+
+    void
+    SendBreakpointPacketsPipelined (const std::vector<std::string> &packets,
+                                    std::vector<bool> &succeeded);
+
+    size_t
+    ReadMemoryPipelined (lldb::addr_t addr, void *buf, size_t size, lldb_private::Error &error);
+
+    size_t
+    GetMemoryReadResponseBytes (StringExtractorGDBRemote &response,
+                                const char *packet,
+                                bool binary_memory_read,
+                                void *buf,
+                                size_t size,
+                                lldb_private::Error &error);
+
     void
     SetLastStopPacket (const StringExtractorGDBRemote &response)
     {
@@ -314,7 +380,12 @@ protected:
     typedef std::vector<lldb::tid_t> tid_collection;
     typedef std::vector< std::pair<lldb::tid_t,int> > tid_sig_collection;
     typedef std::map<lldb::addr_t, lldb::addr_t> MMapMap;
+    typedef std::map<lldb::user_id_t, std::string> BreakpointConditionsMap;
+    typedef lldb_private::RangeDataArray<lldb::addr_t, lldb::addr_t, uint32_t, 1> MemoryRegionMap; // The data is the region's lldb::Permissions
     tid_collection m_thread_ids; // Thread IDs for all threads. This list gets updated after stopping
+    uint32_t m_threads_stop_info_stop_id; // The stop ID we last got the stop info of all threads for
+    uint32_t m_stop_reason_tids_stop_id; // The stop ID m_stop_reason_tids is valid for
+    tid_collection m_stop_reason_tids; // The threads with a stop reason according to the last "qThreadsStopInfo"
     tid_collection m_continue_c_tids;                  // 'c' for continue
     tid_sig_collection m_continue_C_tids; // 'C' for continue with signal
     tid_collection m_continue_s_tids;                  // 's' for step
@@ -322,9 +393,15 @@ protected:
     lldb::addr_t m_dispatch_queue_offsets_addr;
     size_t m_max_memory_size;       // The maximum number of bytes to read/write when reading and writing memory
     MMapMap m_addr_to_mmap_size;
+    BreakpointConditionsMap m_breakpoint_site_conditions; // The conditions each breakpoint site was inserted with, for sites the stub evaluates conditions for
+    BreakpointConditionsMap m_watchpoint_conditions; // The conditions each watchpoint was inserted with, for watchpoints the stub evaluates conditions for
+    MemoryRegionMap m_memory_region_map; // All mapped memory regions, sorted by address
+    uint32_t m_memory_region_map_stop_id; // The stop ID m_memory_region_map was fetched for
+    bool m_memory_region_map_is_valid; // False if the stub couldn't give us all the regions at once
     lldb::BreakpointSP m_thread_create_bp_sp;
     bool m_waiting_for_attach;
     bool m_destroy_tried_resuming;
+    lldb::CommandObjectSP m_command_sp;   // The commands for "process plugin", made when first asked for
     
     bool
     StartAsyncThread ();
@@ -343,7 +420,13 @@ protected:
                                int exit_status);
 
     lldb::StateType
-    SetThreadStopInfo (StringExtractor& stop_packet);
+    SetThreadStopInfo (StringExtractor& stop_packet, lldb::ThreadSP *thread_sp_ptr = NULL);
+
+    bool
+    UpdateThreadsStopInfo ();
+
+    bool
+    UpdateMemoryRegionMap ();
 
     void
     ClearThreadIDList ();
@@ -371,7 +454,7 @@ protected:
     lldb_private::Error
     InterruptIfRunning (bool discard_thread_plans, 
                         bool catch_stop_event, 
-                        lldb::EventSP &stop_event_sp);
+                        lldb::EventIntrusiveSP &stop_event_sp);
 
 private:
     //------------------------------------------------------------------
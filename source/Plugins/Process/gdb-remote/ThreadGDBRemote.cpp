@@ -36,7 +36,9 @@ ThreadGDBRemote::ThreadGDBRemote (const ProcessSP &process_sp, lldb::tid_t tid)
     Thread(process_sp, tid),
     m_thread_name (),
     m_dispatch_queue_name (),
-    m_thread_dispatch_qaddr (LLDB_INVALID_ADDRESS)
+    m_thread_dispatch_qaddr (LLDB_INVALID_ADDRESS),
+    m_register_generation (0),
+    m_non_stop_running (process_sp && !static_cast<ProcessGDBRemote *>(process_sp.get())->GetGDBRemote().GetLastStopStoppedAllThreads())
 {
     ProcessGDBRemoteLog::LogIf(GDBR_LOG_THREAD, "%p: ThreadGDBRemote::ThreadGDBRemote (pid = %i, tid = 0x%4.4x)", 
                                this, 
@@ -99,6 +101,19 @@ ThreadGDBRemote::WillResume (StateType resume_state)
     if (log)
         log->Printf ("Resuming thread: %4.4llx with state: %s.", GetID(), StateAsCString(resume_state));
 
+    // A thread that kept running in non-stop mode is still running, there
+    // is nothing to tell the remote stub about it.
+    if (m_non_stop_running)
+    {
+        ++m_register_generation;
+        return true;
+    }
+
+    // Register writes are held back in the register context, they have
+    // to reach the remote stub before anything runs.
+    if (!WriteDirtyRegisters() && log)
+        log->Printf ("error: failed to write registers for thread: %4.4llx before resuming.", GetID());
+
     ProcessSP process_sp (GetProcess());
     if (process_sp)
     {
@@ -111,6 +126,7 @@ ThreadGDBRemote::WillResume (StateType resume_state)
             break;
 
         case eStateRunning:
+            ++m_register_generation;
             if (gdb_process->GetUnixSignals().SignalIsValid (signo))
                 gdb_process->m_continue_C_tids.push_back(std::make_pair(GetID(), signo));
             else
@@ -118,6 +134,7 @@ ThreadGDBRemote::WillResume (StateType resume_state)
             break;
 
         case eStateStepping:
+            ++m_register_generation;
             if (gdb_process->GetUnixSignals().SignalIsValid (signo))
                 gdb_process->m_continue_S_tids.push_back(std::make_pair(GetID(), signo));
             else
@@ -135,16 +152,21 @@ ThreadGDBRemote::WillResume (StateType resume_state)
 void
 ThreadGDBRemote::RefreshStateAfterStop()
 {
-    // Invalidate all registers in our register context. We don't set "force" to
-    // true because the stop reply packet might have had some register values
-    // that were expedited and these will already be copied into the register
-    // context by the time this function gets called. The GDBRemoteRegisterContext
-    // class has been made smart enough to detect when it needs to invalidate
-    // which registers are valid by putting hooks in the register read and 
-    // register supply functions where they check the process stop ID and do
-    // the right thing.
-    const bool force = false;
-    GetRegisterContext()->InvalidateIfNeeded (force);
+    // Invalidate all registers in our register context if this thread ran.
+    // We don't invalidate unconditionally because the stop reply packet might
+    // have had some register values that were expedited and these will
+    // already be copied into the register context by the time this function
+    // gets called. The GDBRemoteRegisterContext class has been made smart
+    // enough to detect when it needs to invalidate which registers are valid
+    // by putting hooks in the register read and register supply functions
+    // where they check the thread's register generation and do the right
+    // thing. Threads that stayed suspended keep their register values, and
+    // threads still running in non-stop mode never have valid ones.
+    if (m_non_stop_running)
+        ++m_register_generation;
+    GDBRemoteRegisterContext *gdb_reg_ctx = static_cast<GDBRemoteRegisterContext *>(GetRegisterContext ().get());
+    if (gdb_reg_ctx)
+        gdb_reg_ctx->InvalidateIfThreadResumed ();
 }
 
 void
@@ -215,9 +237,23 @@ ThreadGDBRemote::PrivateSetRegisterValue (uint32_t reg, StringExtractor &respons
     return gdb_reg_ctx->PrivateSetRegisterValue (reg, response);
 }
 
+bool
+ThreadGDBRemote::WriteDirtyRegisters ()
+{
+    // Only the frame zero register context holds written registers, and
+    // if it hasn't been made yet nothing was written.
+    if (m_reg_context_sp)
+        return static_cast<GDBRemoteRegisterContext *>(m_reg_context_sp.get())->WriteDirtyRegisters ();
+    return true;
+}
+
 lldb::StopInfoSP
 ThreadGDBRemote::GetPrivateStopReason ()
 {
+    // Threads that are still running in non-stop mode didn't stop
+    if (m_non_stop_running)
+        return StopInfoSP();
+
     ProcessSP process_sp (GetProcess());
     if (process_sp)
     {
@@ -233,11 +269,20 @@ ThreadGDBRemote::GetPrivateStopReason ()
             // down to the remote GDB server, so we need to keep our own notion
             // of the stop ID that m_actual_stop_info_sp is valid for (even if it
             // contains nothing). We use m_thread_stop_reason_stop_id for this below.
-            m_thread_stop_reason_stop_id = process_stop_id;
             m_actual_stop_info_sp.reset();
 
-            StringExtractorGDBRemote stop_packet;
+            // The first thread that needs its stop info after a stop gets
+            // it for all threads with a single packet if the remote stub
+            // supports it, which sets our stop info and stop ID. That would
+            // also give stop info to threads still running in non-stop mode.
             ProcessGDBRemote *gdb_process = static_cast<ProcessGDBRemote *>(process_sp.get());
+            if (gdb_process->GetGDBRemote().GetLastStopStoppedAllThreads() &&
+                gdb_process->UpdateThreadsStopInfo() &&
+                m_thread_stop_reason_stop_id == process_stop_id)
+                return m_actual_stop_info_sp;
+
+            m_thread_stop_reason_stop_id = process_stop_id;
+            StringExtractorGDBRemote stop_packet;
             if (gdb_process->GetGDBRemote().GetThreadStopInfo(GetID(), stop_packet))
                 gdb_process->SetThreadStopInfo (stop_packet);
         }
@@ -80,6 +80,38 @@ public:
         m_thread_dispatch_qaddr = thread_dispatch_qaddr;
     }
 
+    //------------------------------------------------------------------
+    /// Get a number that changes every time this thread is resumed.
+    ///
+    /// The register context compares it to the one its cached values
+    /// were read at, so threads that stayed suspended while others ran
+    /// keep their register values.
+    //------------------------------------------------------------------
+    uint32_t
+    GetRegisterGeneration () const
+    {
+        return m_register_generation;
+    }
+
+    bool
+    WriteDirtyRegisters ();
+
+    //------------------------------------------------------------------
+    /// In non-stop mode a stop only stops some of the threads, the
+    /// others keep running and have no stop reason.
+    //------------------------------------------------------------------
+    bool
+    GetRunningInNonStopMode () const
+    {
+        return m_non_stop_running;
+    }
+
+    void
+    SetRunningInNonStopMode (bool running)
+    {
+        m_non_stop_running = running;
+    }
+
 protected:
     
     friend class ProcessGDBRemote;
@@ -94,6 +126,8 @@ protected:
     std::string m_thread_name;
     std::string m_dispatch_queue_name;
     lldb::addr_t m_thread_dispatch_qaddr;
+    uint32_t m_register_generation;
+    bool m_non_stop_running;
     //------------------------------------------------------------------
     // Member variables.
     //------------------------------------------------------------------
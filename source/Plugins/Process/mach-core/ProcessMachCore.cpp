@@ -12,10 +12,12 @@
 #include <stdlib.h>
 
 // C++ Includes
+#include <algorithm>
 #include "llvm/Support/MachO.h"
 #include "llvm/Support/MathExtras.h"
 
 // Other libraries and framework includes
+#include "lldb/Core/DataBuffer.h"
 #include "lldb/Core/Debugger.h"
 #include "lldb/Core/PluginManager.h"
 #include "lldb/Core/Module.h"
@@ -38,6 +40,12 @@
 using namespace lldb;
 using namespace lldb_private;
 
+// The core file is mapped in windows of this many bytes, which must be a
+// multiple of the host page size, and at most this many windows are kept
+// mapped at once.
+#define CORE_FILE_WINDOW_SIZE   (16 * 1024 * 1024)
+#define MAX_CORE_FILE_WINDOWS   64
+
 const char *
 ProcessMachCore::GetPluginNameStatic()
 {
@@ -102,6 +110,9 @@ ProcessMachCore::CanDebug(Target &target, bool plugin_specified_by_name)
 ProcessMachCore::ProcessMachCore(Target& target, Listener &listener, const FileSpec &core_file) :
     Process (target, listener),
     m_core_aranges (),
+    m_core_file_mutex (Mutex::eMutexTypeNormal),
+    m_core_file_windows (),
+    m_core_file_window_use (0),
     m_core_module_sp (),
     m_core_file (core_file),
     m_dyld_addr (LLDB_INVALID_ADDRESS),
@@ -404,35 +415,107 @@ ProcessMachCore::ReadMemory (addr_t addr, void *buf, size_t size, Error &error)
     return DoReadMemory (addr, buf, size, error);
 }
 
+void
+ProcessMachCore::PrefetchMemory (addr_t addr, size_t size)
+{
+    // Our reads don't go through the memory cache, and the memory is
+    // already in the core file, so there is nothing to prefetch.
+}
+
 size_t
 ProcessMachCore::DoReadMemory (addr_t addr, void *buf, size_t size, Error &error)
 {
-    ObjectFile *core_objfile = m_core_module_sp->GetObjectFile();
-
-    if (core_objfile)
+    uint8_t *dst = (uint8_t *)buf;
+    size_t bytes_read = 0;
+    // A read can span segments that are next to each other in memory
+    while (bytes_read < size)
     {
-        const VMRangeToFileOffset::Entry *core_memory_entry = m_core_aranges.FindEntryThatContains (addr);
-        if (core_memory_entry)
+        const addr_t curr_addr = addr + bytes_read;
+        const VMRangeToFileOffset::Entry *core_memory_entry = m_core_aranges.FindEntryThatContains (curr_addr);
+        if (core_memory_entry == NULL)
         {
-            const addr_t offset = addr - core_memory_entry->GetRangeBase();
-            const addr_t bytes_left = core_memory_entry->GetRangeEnd() - addr;
-            size_t bytes_to_read = size;
-            if (bytes_to_read > bytes_left)
-                bytes_to_read = bytes_left;
-            return core_objfile->CopyData (core_memory_entry->data.GetRangeBase() + offset, bytes_to_read, buf);
+            if (bytes_read == 0)
+                error.SetErrorStringWithFormat ("core file does not contain 0x%llx", curr_addr);
+            break;
         }
-        else
+
+        const addr_t offset = curr_addr - core_memory_entry->GetRangeBase();
+        const addr_t file_size = core_memory_entry->data.GetByteSize();
+        if (offset >= file_size)
+            break;
+        const size_t curr_size = std::min<addr_t> (std::min<addr_t> (size - bytes_read, core_memory_entry->GetRangeEnd() - curr_addr),
+                                                   file_size - offset);
+        const size_t curr_bytes_read = ReadCoreFileBytes (core_memory_entry->data.GetRangeBase() + offset,
+                                                          dst + bytes_read,
+                                                          curr_size);
+        bytes_read += curr_bytes_read;
+        if (curr_bytes_read < curr_size)
+            break;
+    }
+    return bytes_read;
+}
+
+size_t
+ProcessMachCore::ReadCoreFileBytes (addr_t file_offset, void *dst, size_t size)
+{
+    Mutex::Locker locker (m_core_file_mutex);
+    uint8_t *dst_bytes = (uint8_t *)dst;
+    size_t bytes_read = 0;
+    while (bytes_read < size)
+    {
+        const addr_t curr_offset = file_offset + bytes_read;
+        const addr_t window_offset = curr_offset - (curr_offset % CORE_FILE_WINDOW_SIZE);
+        DataBufferSP window_sp (GetCoreFileWindow (window_offset));
+        if (!window_sp || curr_offset - window_offset >= window_sp->GetByteSize())
+            break;
+        const size_t window_data_offset = curr_offset - window_offset;
+        const size_t curr_size = std::min<size_t> (size - bytes_read, window_sp->GetByteSize() - window_data_offset);
+        ::memcpy (dst_bytes + bytes_read, window_sp->GetBytes() + window_data_offset, curr_size);
+        bytes_read += curr_size;
+    }
+    return bytes_read;
+}
+
+DataBufferSP
+ProcessMachCore::GetCoreFileWindow (addr_t window_offset)
+{
+    // The caller must hold m_core_file_mutex
+    CoreFileWindows::iterator pos = m_core_file_windows.find (window_offset);
+    if (pos != m_core_file_windows.end())
+    {
+        pos->second.last_use = ++m_core_file_window_use;
+        return pos->second.data_sp;
+    }
+
+    if (m_core_file_windows.size() >= MAX_CORE_FILE_WINDOWS)
+    {
+        // Unmap the least recently used window
+        CoreFileWindows::iterator lru_pos = m_core_file_windows.begin();
+        for (pos = m_core_file_windows.begin(); pos != m_core_file_windows.end(); ++pos)
         {
-            error.SetErrorStringWithFormat ("core file does not contain 0x%llx", addr);
+            if (pos->second.last_use < lru_pos->second.last_use)
+                lru_pos = pos;
         }
+        m_core_file_windows.erase (lru_pos);
+    }
+
+    DataBufferSP data_sp (m_core_file.MemoryMapFileContents (window_offset, CORE_FILE_WINDOW_SIZE));
+    if (data_sp && data_sp->GetByteSize() > 0)
+    {
+        CoreFileWindow &window = m_core_file_windows[window_offset];
+        window.data_sp = data_sp;
+        window.last_use = ++m_core_file_window_use;
+        return data_sp;
     }
-    return 0;
+    return DataBufferSP();
 }
 
 void
 ProcessMachCore::Clear()
 {
     m_thread_list.Clear();
+    Mutex::Locker locker (m_core_file_mutex);
+    m_core_file_windows.clear();
 }
 
 void
@@ -14,10 +14,12 @@
 
 // C++ Includes
 #include <list>
+#include <map>
 #include <vector>
 
 // Other libraries and framework includes
 #include "lldb/Core/Error.h"
+#include "lldb/Host/Mutex.h"
 #include "lldb/Target/Process.h"
 
 class ThreadKDP;
@@ -106,6 +108,9 @@ public:
     
     virtual size_t
     DoReadMemory (lldb::addr_t addr, void *buf, size_t size, lldb_private::Error &error);
+
+    virtual void
+    PrefetchMemory (lldb::addr_t addr, size_t size);
     
     virtual lldb::addr_t
     GetImageInfoAddress ();
@@ -126,13 +131,34 @@ private:
     bool 
     GetDynamicLoaderAddress (lldb::addr_t addr);
 
+    //------------------------------------------------------------------
+    // Copy bytes out of the core file. The core file is memory mapped a
+    // window at a time as reads need it so that huge core files don't
+    // have to be mapped, or paged in, all at once.
+    //------------------------------------------------------------------
+    size_t
+    ReadCoreFileBytes (lldb::addr_t file_offset, void *dst, size_t size);
+
+    lldb::DataBufferSP
+    GetCoreFileWindow (lldb::addr_t window_offset);
+
     //------------------------------------------------------------------
     // For ProcessMachCore only
     //------------------------------------------------------------------
-    typedef lldb_private::Range<uint32_t, uint32_t> FileRange;
+    typedef lldb_private::Range<lldb::addr_t, lldb::addr_t> FileRange;
     typedef lldb_private::RangeDataArray<lldb::addr_t, lldb::addr_t, FileRange, 1> VMRangeToFileOffset;
 
+    struct CoreFileWindow
+    {
+        lldb::DataBufferSP data_sp;
+        uint32_t last_use;
+    };
+    typedef std::map<lldb::addr_t, CoreFileWindow> CoreFileWindows;
+
     VMRangeToFileOffset m_core_aranges;
+    lldb_private::Mutex m_core_file_mutex;
+    CoreFileWindows m_core_file_windows;    // Mapped windows of the core file by file offset
+    uint32_t m_core_file_window_use;        // Incremented each time a window is used
     lldb::ModuleSP m_core_module_sp;
     lldb_private::FileSpec m_core_file;
     lldb::addr_t m_dyld_addr;
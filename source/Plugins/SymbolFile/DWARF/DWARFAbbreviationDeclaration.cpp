@@ -19,6 +19,9 @@ DWARFAbbreviationDeclaration::DWARFAbbreviationDeclaration() :
     m_code  (InvalidCode),
     m_tag   (0),
     m_has_children (0),
+    m_has_fixed_attr_byte_size (true),
+    m_fixed_attr_byte_size (0),
+    m_num_addr_sized_attrs (0),
     m_attributes()
 {
 }
@@ -27,6 +30,9 @@ DWARFAbbreviationDeclaration::DWARFAbbreviationDeclaration(dw_tag_t tag, uint8_t
     m_code  (InvalidCode),
     m_tag   (tag),
     m_has_children (has_children),
+    m_has_fixed_attr_byte_size (true),
+    m_fixed_attr_byte_size (0),
+    m_num_addr_sized_attrs (0),
     m_attributes()
 {
 }
@@ -58,6 +64,7 @@ DWARFAbbreviationDeclaration::Extract(const DataExtractor& data, uint32_t* offse
                 break;
         }
 
+        UpdateFixedAttributeByteSize();
         return m_tag != 0;
     }
     else
@@ -66,9 +73,64 @@ DWARFAbbreviationDeclaration::Extract(const DataExtractor& data, uint32_t* offse
         m_has_children = 0;
     }
 
+    UpdateFixedAttributeByteSize();
     return false;
 }
 
+void
+DWARFAbbreviationDeclaration::UpdateFixedAttributeByteSize()
+{
+    m_has_fixed_attr_byte_size = true;
+    m_fixed_attr_byte_size = 0;
+    m_num_addr_sized_attrs = 0;
+
+    const uint32_t num_attributes = m_attributes.size();
+    for (uint32_t i = 0; i < num_attributes; ++i)
+    {
+        switch (m_attributes[i].get_form())
+        {
+        case DW_FORM_flag_present:
+            break;
+
+        case DW_FORM_data1:
+        case DW_FORM_flag:
+        case DW_FORM_ref1:
+            m_fixed_attr_byte_size += 1;
+            break;
+
+        case DW_FORM_data2:
+        case DW_FORM_ref2:
+            m_fixed_attr_byte_size += 2;
+            break;
+
+        case DW_FORM_strp:
+        case DW_FORM_data4:
+        case DW_FORM_ref4:
+        case DW_FORM_sec_offset:
+            m_fixed_attr_byte_size += 4;
+            break;
+
+        case DW_FORM_data8:
+        case DW_FORM_ref8:
+        case DW_FORM_ref_sig8:
+            m_fixed_attr_byte_size += 8;
+            break;
+
+        case DW_FORM_addr:
+        case DW_FORM_ref_addr:
+            ++m_num_addr_sized_attrs;
+            break;
+
+        default:
+            // Blocks, strings, LEB128 values and indirect forms
+            m_has_fixed_attr_byte_size = false;
+            m_fixed_attr_byte_size = 0;
+            m_num_addr_sized_attrs = 0;
+            return;
+        }
+    }
+}
+
 
 void
 DWARFAbbreviationDeclaration::Dump(Stream *s)  const
@@ -134,6 +196,7 @@ DWARFAbbreviationDeclaration::CopyExcludingAddressAttributes(const DWARFAbbrevia
             break;
         }
     }
+    UpdateFixedAttributeByteSize();
 }
 
 void
@@ -168,6 +231,7 @@ DWARFAbbreviationDeclaration::CopyChangingStringToStrp(
         else
             m_attributes.push_back(DWARFAttribute(attr, form));
     }
+    UpdateFixedAttributeByteSize();
 }
 
 
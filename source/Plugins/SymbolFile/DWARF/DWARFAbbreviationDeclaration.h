@@ -26,6 +26,7 @@ public:
     void            AddAttribute(const DWARFAttribute& attr)
                     {
                         m_attributes.push_back(attr);
+                        UpdateFixedAttributeByteSize();
                     }
 
     dw_uleb128_t    Code() const { return m_code; }
@@ -33,6 +34,15 @@ public:
     dw_tag_t        Tag() const { return m_tag; }
     bool            HasChildren() const { return m_has_children; }
     uint32_t        NumAttributes() const { return m_attributes.size(); }
+
+                    // Most abbreviations only use forms whose size doesn't
+                    // depend on the data, DIEs that use them can be skipped
+                    // without looking at the attribute forms at all.
+    bool            HasFixedAttributeByteSize() const { return m_has_fixed_attr_byte_size; }
+    uint32_t        GetFixedAttributeByteSize(uint8_t addr_size) const
+                    {
+                        return m_fixed_attr_byte_size + m_num_addr_sized_attrs * addr_size;
+                    }
     dw_attr_t       GetAttrByIndex(uint32_t idx) const { return m_attributes.size() > idx ? m_attributes[idx].get_attr() : 0; }
     dw_form_t       GetFormByIndex(uint32_t idx) const { return m_attributes.size() > idx ? m_attributes[idx].get_form() : 0; }
     bool            GetAttrAndFormByIndex(uint32_t idx, dw_attr_t& attr, dw_form_t& form) const
@@ -72,9 +82,14 @@ public:
 //  DWARFAttribute::collection& Attributes() { return m_attributes; }
     const DWARFAttribute::collection& Attributes() const { return m_attributes; }
 protected:
+    void            UpdateFixedAttributeByteSize();
+
     dw_uleb128_t        m_code;
     dw_tag_t            m_tag;
     uint8_t             m_has_children;
+    bool                m_has_fixed_attr_byte_size;
+    uint32_t            m_fixed_attr_byte_size;     // The size of all attributes that aren't address sized
+    uint32_t            m_num_addr_sized_attrs;
     DWARFAttribute::collection m_attributes;
 };
 
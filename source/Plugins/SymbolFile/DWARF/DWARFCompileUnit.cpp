@@ -11,6 +11,7 @@
 
 #include "lldb/Core/Mangled.h"
 #include "lldb/Core/Module.h"
+#include "lldb/Core/Statistics.h"
 #include "lldb/Core/Stream.h"
 #include "lldb/Core/Timer.h"
 #include "lldb/Symbol/ObjectFile.h"
@@ -37,7 +38,9 @@ DWARFCompileUnit::DWARFCompileUnit(SymbolFileDWARF* dwarf2Data) :
     m_abbrevs       (NULL),
     m_user_data     (NULL),
     m_die_array     (),
+    m_die_array_mutex (Mutex::eMutexTypeRecursive),
     m_func_aranges_ap (),
+    m_block_aranges_ap (),
     m_base_addr     (0),
     m_offset        (DW_INVALID_OFFSET),
     m_length        (0),
@@ -58,6 +61,7 @@ DWARFCompileUnit::Clear()
     m_base_addr     = 0;
     m_die_array.clear();
     m_func_aranges_ap.reset();
+    m_block_aranges_ap.reset();
     m_user_data     = NULL;
     m_producer      = eProducerInvalid;
 }
@@ -124,6 +128,7 @@ DWARFCompileUnit::Extract(dw_offset_t offset, const DataExtractor& debug_info_da
 void
 DWARFCompileUnit::ClearDIEs(bool keep_compile_unit_die)
 {
+    Mutex::Locker locker (m_die_array_mutex);
     if (m_die_array.size() > 1)
     {
         // std::vectors never get any smaller when resized to a smaller size,
@@ -151,6 +156,7 @@ DWARFCompileUnit::ClearDIEs(bool keep_compile_unit_die)
 size_t
 DWARFCompileUnit::ExtractDIEsIfNeeded (bool cu_die_only)
 {
+    Mutex::Locker locker (m_die_array_mutex);
     const size_t initial_die_array_size = m_die_array.size();
     if ((cu_die_only && initial_die_array_size > 0) || initial_die_array_size > 1)
         return 0; // Already parsed
@@ -273,6 +279,11 @@ DWARFCompileUnit::ExtractDIEsIfNeeded (bool cu_die_only)
                                                                    offset);
     }
 
+    static StatisticsCounter &g_compile_units_parsed = Statistics::GetCounter ("dwarf.compile-units-parsed");
+    static StatisticsCounter &g_dies_parsed = Statistics::GetCounter ("dwarf.dies-parsed");
+    g_compile_units_parsed.Add ();
+    g_dies_parsed.Add (m_die_array.size() - initial_die_array_size);
+
     // Since std::vector objects will double their size, we really need to
     // make a new array with the perfect size so we don't end up wasting
     // space. So here we copy and swap to make sure we don't have any extra
@@ -417,6 +428,89 @@ DWARFCompileUnit::GetFunctionAranges ()
     return *m_func_aranges_ap.get();
 }
 
+namespace {
+
+    // A block range starting or ending, for sweeping through a compile
+    // unit's block ranges in address order
+    struct BlockRangeEdge
+    {
+        dw_addr_t addr;
+        bool is_start;
+        uint32_t range_idx;
+
+        // Ends sort before starts at the same address so that a block
+        // that ends where its sibling starts doesn't look like it
+        // contains it
+        bool
+        operator < (const BlockRangeEdge &rhs) const
+        {
+            if (addr != rhs.addr)
+                return addr < rhs.addr;
+            return !is_start && rhs.is_start;
+        }
+    };
+
+}
+
+const DWARFDebugAranges &
+DWARFCompileUnit::GetBlockAranges ()
+{
+    if (m_block_aranges_ap.get() == NULL)
+    {
+        m_block_aranges_ap.reset (new DWARFDebugAranges());
+        LogSP log (LogChannelDWARF::GetLogIfAll(DWARF_LOG_DEBUG_ARANGES));
+
+        if (log)
+        {
+            m_dwarf2Data->GetObjectFile()->GetModule()->LogMessage (log.get(), 
+                                                                    "DWARFCompileUnit::GetBlockAranges() for compile unit at .debug_info[0x%8.8x]",
+                                                                    GetOffset());
+        }
+
+        DWARFDebugInfoEntry::block_range_collection block_ranges;
+        if (DIE())
+            DIE()->BuildBlockAddressRangeTable (m_dwarf2Data, this, 0, block_ranges);
+
+        // Blocks nest, so flatten their ranges into pieces that each
+        // belong to the deepest block that is open over them.
+        std::vector<BlockRangeEdge> edges;
+        edges.reserve (block_ranges.size() * 2);
+        for (uint32_t i = 0; i < block_ranges.size(); ++i)
+        {
+            BlockRangeEdge edge;
+            edge.range_idx = i;
+            edge.addr = block_ranges[i].lo_pc;
+            edge.is_start = true;
+            edges.push_back (edge);
+            edge.addr = block_ranges[i].hi_pc;
+            edge.is_start = false;
+            edges.push_back (edge);
+        }
+        std::stable_sort (edges.begin(), edges.end());
+
+        typedef std::set<std::pair<uint32_t, dw_offset_t> > open_block_collection;
+        open_block_collection open_blocks;
+        for (size_t i = 0; i < edges.size(); ++i)
+        {
+            const DWARFDebugInfoEntry::BlockRange &block_range = block_ranges[edges[i].range_idx];
+            const std::pair<uint32_t, dw_offset_t> open_block (block_range.depth, block_range.die_offset);
+            if (edges[i].is_start)
+                open_blocks.insert (open_block);
+            else
+                open_blocks.erase (open_block);
+
+            if (!open_blocks.empty() && i + 1 < edges.size())
+                m_block_aranges_ap->AppendRange (open_blocks.rbegin()->second, edges[i].addr, edges[i + 1].addr);
+        }
+
+        // Sorting combines the pieces of the same block that are next to
+        // each other again
+        const bool minimize = false;
+        m_block_aranges_ap->Sort(minimize);
+    }
+    return *m_block_aranges_ap.get();
+}
+
 bool
 DWARFCompileUnit::LookupAddress
 (
@@ -441,12 +535,14 @@ DWARFCompileUnit::LookupAddress
                 success = true;
                 if (block_die_handle != NULL)
                 {
-                    DWARFDebugInfoEntry* child = (*function_die_handle)->GetFirstChild();
-                    while (child)
+                    // Use the block table rather than walking the
+                    // function's DIEs every time
+                    const DWARFDebugAranges &block_aranges = GetBlockAranges ();
+                    if (!block_aranges.IsEmpty())
                     {
-                        if (child->LookupAddress(address, m_dwarf2Data, this, NULL, block_die_handle))
-                            break;
-                        child = child->GetSibling();
+                        DWARFDebugInfoEntry* block_die = GetDIEPtr(block_aranges.FindAddress(address));
+                        if (block_die != NULL)
+                            *block_die_handle = block_die;
                     }
                 }
             }
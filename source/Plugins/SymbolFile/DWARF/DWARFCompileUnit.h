@@ -10,6 +10,7 @@
 #ifndef SymbolFileDWARF_DWARFCompileUnit_h_
 #define SymbolFileDWARF_DWARFCompileUnit_h_
 
+#include "lldb/Host/Mutex.h"
 #include "DWARFDebugInfoEntry.h"
 #include "SymbolFileDWARF.h"
 
@@ -164,6 +165,15 @@ public:
     const DWARFDebugAranges &
     GetFunctionAranges ();
 
+    //------------------------------------------------------------------
+    // A table of non-overlapping address ranges that each point to the
+    // innermost DW_TAG_lexical_block or DW_TAG_inlined_subroutine DIE
+    // containing them. Addresses in a function but outside all of its
+    // blocks aren't in the table.
+    //------------------------------------------------------------------
+    const DWARFDebugAranges &
+    GetBlockAranges ();
+
     SymbolFileDWARF*
     GetSymbolFileDWARF () const
     {
@@ -179,7 +189,9 @@ protected:
     const DWARFAbbreviationDeclarationSet *m_abbrevs;
     void *              m_user_data;
     DWARFDebugInfoEntry::collection m_die_array;    // The compile unit debug information entry item
+    lldb_private::Mutex m_die_array_mutex;          // Guards extracting and clearing m_die_array so compile units can be indexed on multiple threads
     std::auto_ptr<DWARFDebugAranges> m_func_aranges_ap;   // A table similar to the .debug_aranges table, but this one points to the exact DW_TAG_subprogram DIEs
+    std::auto_ptr<DWARFDebugAranges> m_block_aranges_ap;  // Like m_func_aranges_ap, but points to the innermost block DIEs
     dw_addr_t           m_base_addr;
     dw_offset_t         m_offset;
     uint32_t            m_length;
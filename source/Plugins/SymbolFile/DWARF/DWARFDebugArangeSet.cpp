@@ -15,6 +15,39 @@
 
 using namespace lldb_private;
 
+// Decodes the tuples of a set with DataExtractor::ExtractRecords()
+class DescriptorRecordParser
+{
+public:
+    DescriptorRecordParser (std::vector<DWARFDebugArangeSet::Descriptor> &descriptors, uint32_t addr_size) :
+        m_descriptors (descriptors),
+        m_addr_size (addr_size)
+    {
+    }
+
+    template <bool swap>
+    bool
+    ParseRecord (DataBlockCursor<swap> &cursor, uint32_t idx)
+    {
+        DWARFDebugArangeSet::Descriptor arangeDescriptor;
+        arangeDescriptor.address    = cursor.GetMaxU64(m_addr_size);
+        arangeDescriptor.length     = cursor.GetMaxU64(m_addr_size);
+
+        // Each set of tuples is terminated by a 0 for the address and 0
+        // for the length.
+        if (arangeDescriptor.address || arangeDescriptor.length)
+        {
+            m_descriptors.push_back(arangeDescriptor);
+            return true;
+        }
+        return false;   // We are done if we get a zero address and length
+    }
+
+private:
+    std::vector<DWARFDebugArangeSet::Descriptor> &m_descriptors;
+    uint32_t m_addr_size;
+};
+
 DWARFDebugArangeSet::DWARFDebugArangeSet() :
     m_offset(DW_INVALID_OFFSET),
     m_header(),
@@ -202,23 +235,10 @@ DWARFDebugArangeSet::Extract(const DataExtractor &data, uint32_t* offset_ptr)
 
         *offset_ptr = m_offset + first_tuple_offset;
 
-        Descriptor arangeDescriptor;
-
-        assert(sizeof(arangeDescriptor.address) == sizeof(arangeDescriptor.length));
-        assert(sizeof(arangeDescriptor.address) >= m_header.addr_size);
+        assert(sizeof(dw_addr_t) >= m_header.addr_size);
 
-        while (data.ValidOffset(*offset_ptr))
-        {
-            arangeDescriptor.address    = data.GetMaxU64(offset_ptr, m_header.addr_size);
-            arangeDescriptor.length     = data.GetMaxU64(offset_ptr, m_header.addr_size);
-
-            // Each set of tuples is terminated by a 0 for the address and 0
-            // for the length.
-            if (arangeDescriptor.address || arangeDescriptor.length)
-                m_arange_descriptors.push_back(arangeDescriptor);
-            else
-                break;  // We are done if we get a zero address and length
-        }
+        DescriptorRecordParser parser (m_arange_descriptors, m_header.addr_size);
+        data.ExtractRecords (offset_ptr, tuple_size, UINT32_MAX, parser);
 
         return !m_arange_descriptors.empty();
     }
@@ -131,6 +131,47 @@ DWARFDebugAranges::AppendRange (dw_offset_t offset, dw_addr_t low_pc, dw_addr_t
         m_aranges.Append(RangeToDIE::Entry (low_pc, high_pc - low_pc, offset));
 }
 
+void
+DWARFDebugAranges::AppendRanges (const DWARFDebugAranges &aranges)
+{
+    const size_t num_entries = aranges.m_aranges.GetSize();
+    for (size_t i=0; i<num_entries; ++i)
+        m_aranges.Append (*aranges.m_aranges.GetEntryAtIndex(i));
+}
+
+void
+DWARFDebugAranges::Encode (Stream &strm) const
+{
+    const uint32_t num_entries = m_aranges.GetSize();
+    strm.PutHex32 (num_entries);
+    for (uint32_t i=0; i<num_entries; ++i)
+    {
+        const RangeToDIE::Entry *entry = m_aranges.GetEntryAtIndex(i);
+        strm.PutHex64 (entry->GetRangeBase());
+        strm.PutHex32 (entry->GetByteSize());
+        strm.PutHex32 (entry->data);
+    }
+}
+
+bool
+DWARFDebugAranges::Decode (const DataExtractor &data, uint32_t *offset_ptr)
+{
+    Clear();
+    const uint32_t num_entries = data.GetU32 (offset_ptr);
+    // Each entry is a 64 bit address and two 32 bit values
+    if (num_entries > data.GetByteSize() / 16 || !data.ValidOffsetForDataOfSize (*offset_ptr, num_entries * 16))
+        return false;
+    for (uint32_t i=0; i<num_entries; ++i)
+    {
+        const dw_addr_t base = data.GetU64 (offset_ptr);
+        const uint32_t size = data.GetU32 (offset_ptr);
+        const dw_offset_t cu_offset = data.GetU32 (offset_ptr);
+        m_aranges.Append (RangeToDIE::Entry (base, size, cu_offset));
+    }
+    // The ranges were sorted and minimized before they were encoded
+    return true;
+}
+
 void
 DWARFDebugAranges::Sort (bool minimize)
 {    
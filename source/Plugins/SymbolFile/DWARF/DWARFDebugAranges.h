@@ -46,9 +46,21 @@ public:
                  dw_addr_t low_pc, 
                  dw_addr_t high_pc);
 
+    void
+    AppendRanges (const DWARFDebugAranges &aranges);
+
     void 
     Sort (bool minimize);
 
+    //------------------------------------------------------------------
+    // Encode and decode sorted ranges for the index cache.
+    //------------------------------------------------------------------
+    void
+    Encode (lldb_private::Stream &strm) const;
+
+    bool
+    Decode (const lldb_private::DataExtractor &data, uint32_t *offset_ptr);
+
     const Range* 
     RangeAtIndex(uint32_t idx) const
     {
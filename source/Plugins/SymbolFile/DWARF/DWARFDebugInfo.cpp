@@ -12,8 +12,14 @@
 #include <algorithm>
 #include <set>
 
+#include "lldb/Core/IndexCache.h"
+#include "lldb/Core/Module.h"
 #include "lldb/Core/RegularExpression.h"
 #include "lldb/Core/Stream.h"
+#include "lldb/Core/StreamString.h"
+#include "lldb/Host/Endian.h"
+#include "lldb/Host/Host.h"
+#include "lldb/Host/Mutex.h"
 #include "lldb/Symbol/ObjectFile.h"
 
 #include "DWARFDebugAranges.h"
@@ -49,6 +55,119 @@ DWARFDebugInfo::SetDwarfData(SymbolFileDWARF* dwarf2Data)
 }
 
 
+//----------------------------------------------------------------------
+// Building the compile unit address ranges from the DIEs means parsing
+// all DIEs in each compile unit, so it is spread over a few worker
+// threads. Each worker collects the ranges for the compile units it
+// claims in its own DWARFDebugAranges, and the results are combined
+// and sorted at the end.
+//----------------------------------------------------------------------
+struct DWARFArangesWorkerState
+{
+    SymbolFileDWARF *dwarf2Data;
+    DWARFDebugInfo *debug_info;
+    const std::vector<uint32_t> *cu_idxs;
+    Mutex *mutex;
+    size_t *next_idx;
+    DWARFDebugAranges aranges;
+};
+
+static lldb::thread_result_t
+DWARFArangesWorkerThread (void *arg)
+{
+    DWARFArangesWorkerState *state = (DWARFArangesWorkerState *)arg;
+    const size_t num_cus = state->cu_idxs->size();
+    const bool clear_dies_if_already_not_parsed = true;
+    while (1)
+    {
+        size_t idx;
+        {
+            Mutex::Locker locker (*state->mutex);
+            idx = (*state->next_idx)++;
+        }
+        if (idx >= num_cus)
+            break;
+
+        DWARFCompileUnit* cu = state->debug_info->GetCompileUnitAtIndex((*state->cu_idxs)[idx]);
+        if (cu)
+            cu->BuildAddressRangeTable (state->dwarf2Data, &state->aranges, clear_dies_if_already_not_parsed);
+    }
+    return NULL;
+}
+
+void
+DWARFDebugInfo::BuildCompileUnitAranges (const std::vector<uint32_t> &cu_idxs)
+{
+    const uint32_t num_workers = std::min<uint32_t> (Host::GetNumberCPUs(), cu_idxs.size());
+    if (num_workers == 0)
+        return;
+
+    Mutex mutex;
+    size_t next_idx = 0;
+    std::vector<DWARFArangesWorkerState> workers (num_workers);
+    for (uint32_t i=0; i<num_workers; ++i)
+    {
+        workers[i].dwarf2Data = m_dwarf2Data;
+        workers[i].debug_info = this;
+        workers[i].cu_idxs = &cu_idxs;
+        workers[i].mutex = &mutex;
+        workers[i].next_idx = &next_idx;
+    }
+
+    // The calling thread does the work for the first worker, so only
+    // spawn threads for the rest.
+    std::vector<lldb::thread_t> threads;
+    for (uint32_t i=1; i<num_workers; ++i)
+    {
+        lldb::thread_t thread = Host::ThreadCreate ("<lldb.dwarf.aranges>", DWARFArangesWorkerThread, &workers[i], NULL);
+        if (IS_VALID_LLDB_HOST_THREAD(thread))
+            threads.push_back (thread);
+    }
+
+    DWARFArangesWorkerThread (&workers[0]);
+
+    for (size_t i=0; i<threads.size(); ++i)
+        Host::ThreadJoin (threads[i], NULL, NULL);
+
+    for (uint32_t i=0; i<num_workers; ++i)
+        m_cu_aranges_ap->AppendRanges (workers[i].aranges);
+}
+
+// Bump this whenever the contents or the encoding of the ranges change
+#define DWARF_ARANGES_CACHE_VERSION     1
+
+bool
+DWARFDebugInfo::LoadCompileUnitArangesFromCache ()
+{
+    Module *module = m_dwarf2Data->GetObjectFile()->GetModule().get();
+    if (!IndexCache::IsEnabledForModule (module))
+        return false;
+
+    DataExtractor data;
+    uint32_t offset = 0;
+    if (!IndexCache::Load (module, "dwarf-aranges", DWARF_ARANGES_CACHE_VERSION, data, &offset))
+        return false;
+
+    if (m_cu_aranges_ap->Decode (data, &offset))
+        return true;
+
+    // The cache file was truncated or corrupt, start from scratch
+    m_cu_aranges_ap->Clear();
+    return false;
+}
+
+void
+DWARFDebugInfo::SaveCompileUnitArangesToCache ()
+{
+    Module *module = m_dwarf2Data->GetObjectFile()->GetModule().get();
+    if (!IndexCache::IsEnabledForModule (module))
+        return;
+
+    StreamString strm (Stream::eBinary, sizeof(void *), lldb::endian::InlHostByteOrder());
+    m_cu_aranges_ap->Encode (strm);
+    IndexCache::Save (module, "dwarf-aranges", DWARF_ARANGES_CACHE_VERSION, strm.GetString());
+}
+
 DWARFDebugAranges &
 DWARFDebugInfo::GetCompileUnitAranges ()
 {
@@ -57,6 +176,12 @@ DWARFDebugInfo::GetCompileUnitAranges ()
         LogSP log (LogChannelDWARF::GetLogIfAll(DWARF_LOG_DEBUG_ARANGES));
 
         m_cu_aranges_ap.reset (new DWARFDebugAranges());
+
+        // A cache file is only ever written when some of the ranges had
+        // to be built from the DIEs, so it holds the complete table.
+        if (LoadCompileUnitArangesFromCache ())
+            return *m_cu_aranges_ap.get();
+
         const DataExtractor &debug_aranges_data = m_dwarf2Data->get_debug_aranges_data();
         if (debug_aranges_data.GetByteSize() > 0)
         {
@@ -67,25 +192,39 @@ DWARFDebugInfo::GetCompileUnitAranges ()
             m_cu_aranges_ap->Extract (debug_aranges_data);
             
         }
-        else
+
+        // Compilers don't always emit .debug_aranges, or only emit it for
+        // some compile units, so build the ranges from the DIEs for every
+        // compile unit that .debug_aranges didn't cover.
+        std::set<dw_offset_t> cu_offsets_with_aranges;
+        const uint32_t num_aranges = m_cu_aranges_ap->GetNumRanges();
+        for (uint32_t i = 0; i < num_aranges; ++i)
+            cu_offsets_with_aranges.insert (m_cu_aranges_ap->OffsetAtIndex(i));
+
+        std::vector<uint32_t> cu_idxs;
+        const uint32_t num_compile_units = GetNumCompileUnits();
+        for (uint32_t idx = 0; idx < num_compile_units; ++idx)
+        {
+            DWARFCompileUnit* cu = GetCompileUnitAtIndex(idx);
+            if (cu && cu_offsets_with_aranges.find (cu->GetOffset()) == cu_offsets_with_aranges.end())
+                cu_idxs.push_back (idx);
+        }
+
+        if (!cu_idxs.empty())
         {
             if (log)
-                log->Printf ("DWARFDebugInfo::GetCompileUnitAranges() for \"%s/%s\" by parsing", 
+                log->Printf ("DWARFDebugInfo::GetCompileUnitAranges() for \"%s/%s\" by parsing %zu compile units", 
                              m_dwarf2Data->GetObjectFile()->GetFileSpec().GetDirectory().GetCString(),
-                             m_dwarf2Data->GetObjectFile()->GetFileSpec().GetFilename().GetCString());
-            const uint32_t num_compile_units = GetNumCompileUnits();
-            uint32_t idx;
-            const bool clear_dies_if_already_not_parsed = true;
-            for (idx = 0; idx < num_compile_units; ++idx)
-            {
-                DWARFCompileUnit* cu = GetCompileUnitAtIndex(idx);
-                if (cu)
-                    cu->BuildAddressRangeTable (m_dwarf2Data, m_cu_aranges_ap.get(), clear_dies_if_already_not_parsed);
-            }
+                             m_dwarf2Data->GetObjectFile()->GetFileSpec().GetFilename().GetCString(),
+                             cu_idxs.size());
+            BuildCompileUnitAranges (cu_idxs);
         }
 
         const bool minimize = true;
         m_cu_aranges_ap->Sort (minimize);
+
+        if (!cu_idxs.empty())
+            SaveCompileUnitArangesToCache ();
     }
     return *m_cu_aranges_ap.get();
 }
@@ -79,6 +79,10 @@ protected:
     CompileUnitColl m_compile_units;
     std::auto_ptr<DWARFDebugAranges> m_cu_aranges_ap; // A quick address to compile unit table
 
+    void BuildCompileUnitAranges (const std::vector<uint32_t> &cu_idxs);
+    bool LoadCompileUnitArangesFromCache ();
+    void SaveCompileUnitArangesToCache ();
+
 private:
     // All parsing needs to be done partially any managed by this class as accessors are called.
     void ParseCompileUnitHeadersIfNeeded();
@@ -149,6 +149,13 @@ DWARFDebugInfoEntry::FastExtract
         }
         m_tag = abbrevDecl->Tag();
         m_has_children = abbrevDecl->HasChildren();
+        if (abbrevDecl->HasFixedAttributeByteSize())
+        {
+            // None of the attributes have a variable length encoding so
+            // we can skip them all in one go.
+            *offset_ptr = offset + abbrevDecl->GetFixedAttributeByteSize(cu->GetAddressByteSize());
+            return true;
+        }
         // Skip all data in the .debug_info for the attributes
         const uint32_t numAttributes = abbrevDecl->NumAttributes();
         register uint32_t i;
@@ -175,6 +182,7 @@ DWARFDebugInfoEntry::FastExtract
                     case DW_FORM_block1     : form_size = debug_info_data.GetU8_unchecked (&offset); break;
                     case DW_FORM_block2     : form_size = debug_info_data.GetU16_unchecked (&offset);break;
                     case DW_FORM_block4     : form_size = debug_info_data.GetU32_unchecked (&offset);break;
+                    case DW_FORM_exprloc    : form_size = debug_info_data.GetULEB128 (&offset);      break;
 
                     // Inlined NULL terminated C-strings
                     case DW_FORM_string     :
@@ -187,6 +195,10 @@ DWARFDebugInfoEntry::FastExtract
                         form_size = cu->GetAddressByteSize();
                         break;
 
+                    // 0 byte values, the attribute is implied by its presence
+                    case DW_FORM_flag_present:
+                        break;
+
                     // 1 byte values
                     case DW_FORM_data1      :
                     case DW_FORM_flag       :
@@ -204,12 +216,14 @@ DWARFDebugInfoEntry::FastExtract
                     case DW_FORM_strp       :
                     case DW_FORM_data4      :
                     case DW_FORM_ref4       :
+                    case DW_FORM_sec_offset :
                         form_size = 4;
                         break;
 
                     // 8 byte values
                     case DW_FORM_data8      :
                     case DW_FORM_ref8       :
+                    case DW_FORM_ref_sig8   :
                         form_size = 8;
                         break;
 
@@ -288,6 +302,11 @@ DWARFDebugInfoEntry::Extract
                 bool isCompileUnitTag = m_tag == DW_TAG_compile_unit;
                 if (cu && isCompileUnitTag)
                     ((DWARFCompileUnit*)cu)->SetBaseAddress(0);
+                else if (abbrevDecl->HasFixedAttributeByteSize())
+                {
+                    *offset_ptr = offset + abbrevDecl->GetFixedAttributeByteSize(cu_addr_size);
+                    return true;
+                }
 
                 // Skip all data in the .debug_info for the attributes
                 const uint32_t numAttributes = abbrevDecl->NumAttributes();
@@ -322,6 +341,7 @@ DWARFDebugInfoEntry::Extract
                             case DW_FORM_block1     : form_size = debug_info_data.GetU8(&offset);       break;
                             case DW_FORM_block2     : form_size = debug_info_data.GetU16(&offset);      break;
                             case DW_FORM_block4     : form_size = debug_info_data.GetU32(&offset);      break;
+                            case DW_FORM_exprloc    : form_size = debug_info_data.GetULEB128(&offset);  break;
 
                             // Inlined NULL terminated C-strings
                             case DW_FORM_string     : debug_info_data.GetCStr(&offset);                 break;
@@ -332,6 +352,10 @@ DWARFDebugInfoEntry::Extract
                                 form_size = cu_addr_size;
                                 break;
 
+                            // 0 byte values, the attribute is implied by its presence
+                            case DW_FORM_flag_present:
+                                break;
+
                             // 1 byte values
                             case DW_FORM_data1      :
                             case DW_FORM_flag       :
@@ -352,12 +376,14 @@ DWARFDebugInfoEntry::Extract
 
                             case DW_FORM_data4      :
                             case DW_FORM_ref4       :
+                            case DW_FORM_sec_offset :
                                 form_size = 4;
                                 break;
 
                             // 8 byte values
                             case DW_FORM_data8      :
                             case DW_FORM_ref8       :
+                            case DW_FORM_ref_sig8   :
                                 form_size = 8;
                                 break;
 
@@ -719,6 +745,7 @@ DWARFDebugInfoEntry::GetDIENamesAndRanges
 
     dw_addr_t lo_pc = DW_INVALID_ADDRESS;
     dw_addr_t hi_pc = DW_INVALID_ADDRESS;
+    bool hi_pc_is_offset = false;
     std::vector<dw_offset_t> die_offsets;
     bool set_frame_base_loclist_addr = false;
     
@@ -751,6 +778,7 @@ DWARFDebugInfoEntry::GetDIENamesAndRanges
 
                 case DW_AT_high_pc:
                     hi_pc = form_value.Unsigned();
+                    hi_pc_is_offset = form_value.Form() != DW_FORM_addr;
                     break;
 
                 case DW_AT_ranges:
@@ -855,6 +883,9 @@ DWARFDebugInfoEntry::GetDIENamesAndRanges
     {
         if (lo_pc != DW_INVALID_ADDRESS)
         {
+            // As of DWARF 4 the high pc can be an offset from the low pc
+            if (hi_pc != DW_INVALID_ADDRESS && hi_pc_is_offset)
+                hi_pc += lo_pc;
             if (hi_pc != DW_INVALID_ADDRESS && hi_pc > lo_pc)
                 ranges.Append(DWARFDebugRanges::Range (lo_pc, hi_pc - lo_pc));
             else
@@ -1267,9 +1298,17 @@ DWARFDebugInfoEntry::GetAttributeValue
         {
             const DataExtractor& debug_info_data = dwarf2Data->get_debug_info_data();
 
+            const uint8_t *fixed_form_sizes = DWARFFormValue::GetFixedFormSizesForAddressSize (cu->GetAddressByteSize());
             uint32_t idx=0;
             while (idx<attr_idx)
-                DWARFFormValue::SkipValue(abbrevDecl->GetFormByIndex(idx++), debug_info_data, &offset, cu);
+            {
+                const dw_form_t form = abbrevDecl->GetFormByIndex(idx++);
+                const uint8_t fixed_skip_size = (fixed_form_sizes && form <= DW_FORM_ref_sig8) ? fixed_form_sizes[form] : 0;
+                if (fixed_skip_size)
+                    offset += fixed_skip_size;
+                else
+                    DWARFFormValue::SkipValue(form, debug_info_data, &offset, cu);
+            }
 
             const dw_offset_t attr_offset = offset;
             form_value.SetForm(abbrevDecl->GetFormByIndex(idx));
@@ -1327,6 +1366,32 @@ DWARFDebugInfoEntry::GetAttributeValueAsUnsigned
     return fail_value;
 }
 
+//----------------------------------------------------------------------
+// GetAttributeHighPC
+//
+// Get the DW_AT_high_pc of a DIE whose DW_AT_low_pc is LO_PC. As of
+// DWARF 4 a DW_AT_high_pc that isn't a DW_FORM_addr is an offset from
+// the low pc.
+//----------------------------------------------------------------------
+dw_addr_t
+DWARFDebugInfoEntry::GetAttributeHighPC
+(
+    SymbolFileDWARF* dwarf2Data,
+    const DWARFCompileUnit* cu,
+    dw_addr_t lo_pc,
+    uint64_t fail_value
+) const
+{
+    DWARFFormValue form_value;
+    if (GetAttributeValue(dwarf2Data, cu, DW_AT_high_pc, form_value))
+    {
+        if (form_value.Form() == DW_FORM_addr)
+            return form_value.Unsigned();
+        return lo_pc + form_value.Unsigned();
+    }
+    return fail_value;
+}
+
 //----------------------------------------------------------------------
 // GetAttributeValueAsSigned
 //
@@ -1669,7 +1734,7 @@ DWARFDebugInfoEntry::BuildAddressRangeTable
             dw_addr_t hi_pc = DW_INVALID_ADDRESS;
             dw_addr_t lo_pc = GetAttributeValueAsUnsigned(dwarf2Data, cu, DW_AT_low_pc, DW_INVALID_ADDRESS);
             if (lo_pc != DW_INVALID_ADDRESS)
-                hi_pc = GetAttributeValueAsUnsigned(dwarf2Data, cu, DW_AT_high_pc, DW_INVALID_ADDRESS);
+                hi_pc = GetAttributeHighPC(dwarf2Data, cu, lo_pc, DW_INVALID_ADDRESS);
             if (hi_pc != DW_INVALID_ADDRESS)
             {
             /// printf("BuildAddressRangeTable() 0x%8.8x: %30s: [0x%8.8x - 0x%8.8x)\n", m_offset, DW_TAG_value_to_name(tag), lo_pc, hi_pc);
@@ -1710,7 +1775,7 @@ DWARFDebugInfoEntry::BuildFunctionAddressRangeTable
             dw_addr_t hi_pc = DW_INVALID_ADDRESS;
             dw_addr_t lo_pc = GetAttributeValueAsUnsigned(dwarf2Data, cu, DW_AT_low_pc, DW_INVALID_ADDRESS);
             if (lo_pc != DW_INVALID_ADDRESS)
-                hi_pc = GetAttributeValueAsUnsigned(dwarf2Data, cu, DW_AT_high_pc, DW_INVALID_ADDRESS);
+                hi_pc = GetAttributeHighPC(dwarf2Data, cu, lo_pc, DW_INVALID_ADDRESS);
             if (hi_pc != DW_INVALID_ADDRESS)
             {
             //  printf("BuildAddressRangeTable() 0x%8.8x: [0x%16.16llx - 0x%16.16llx)\n", m_offset, lo_pc, hi_pc); // DEBUG ONLY
@@ -1727,6 +1792,103 @@ DWARFDebugInfoEntry::BuildFunctionAddressRangeTable
     }
 }
 
+//----------------------------------------------------------------------
+// BuildBlockAddressRangeTable
+//
+// Append the address ranges of every lexical block and inlined
+// subroutine in the functions at or below this DIE, along with how
+// deeply each is nested, so the innermost block for an address can be
+// found without walking the DIEs again.
+//----------------------------------------------------------------------
+void
+DWARFDebugInfoEntry::BuildBlockAddressRangeTable
+(
+    SymbolFileDWARF* dwarf2Data,
+    const DWARFCompileUnit* cu,
+    uint32_t depth,
+    block_range_collection& block_ranges
+) const
+{
+    if (m_tag == 0)
+        return;
+
+    uint32_t child_depth = depth;
+    switch (m_tag)
+    {
+    case DW_TAG_compile_unit:
+    case DW_TAG_namespace:
+    case DW_TAG_class_type:
+    case DW_TAG_structure_type:
+    case DW_TAG_union_type:
+        // Only functions can be in these, not blocks
+        if (depth != 0)
+            return;
+        break;
+
+    case DW_TAG_subprogram:
+        child_depth = 1;
+        break;
+
+    case DW_TAG_lexical_block:
+    case DW_TAG_inlined_subroutine:
+        {
+            // Blocks only mean something inside a function
+            if (depth == 0)
+                return;
+            BlockRange block_range;
+            block_range.depth = depth;
+            block_range.die_offset = GetOffset();
+            dw_addr_t lo_pc = GetAttributeValueAsUnsigned(dwarf2Data, cu, DW_AT_low_pc, DW_INVALID_ADDRESS);
+            if (lo_pc != DW_INVALID_ADDRESS)
+            {
+                dw_addr_t hi_pc = GetAttributeHighPC(dwarf2Data, cu, lo_pc, DW_INVALID_ADDRESS);
+                if (hi_pc != DW_INVALID_ADDRESS && hi_pc > lo_pc)
+                {
+                    block_range.lo_pc = lo_pc;
+                    block_range.hi_pc = hi_pc;
+                    block_ranges.push_back (block_range);
+                }
+            }
+            else
+            {
+                dw_offset_t debug_ranges_offset = GetAttributeValueAsUnsigned(dwarf2Data, cu, DW_AT_ranges, DW_INVALID_OFFSET);
+                if (debug_ranges_offset != DW_INVALID_OFFSET)
+                {
+                    DWARFDebugRanges::RangeList ranges;
+                    DWARFDebugRanges* debug_ranges = dwarf2Data->DebugRanges();
+                    debug_ranges->FindRanges(debug_ranges_offset, ranges);
+                    // All DW_AT_ranges are relative to the base address of the
+                    // compile unit.
+                    ranges.Slide (cu->GetBaseAddress());
+                    const size_t num_ranges = ranges.GetSize();
+                    for (size_t i = 0; i < num_ranges; ++i)
+                    {
+                        const DWARFDebugRanges::Range *range = ranges.GetEntryAtIndex(i);
+                        if (range->GetByteSize() > 0)
+                        {
+                            block_range.lo_pc = range->GetRangeBase();
+                            block_range.hi_pc = range->GetRangeEnd();
+                            block_ranges.push_back (block_range);
+                        }
+                    }
+                }
+            }
+            child_depth = depth + 1;
+        }
+        break;
+
+    default:
+        return;
+    }
+
+    const DWARFDebugInfoEntry* child = GetFirstChild();
+    while (child)
+    {
+        child->BuildBlockAddressRangeTable(dwarf2Data, cu, child_depth, block_ranges);
+        child = child->GetSibling();
+    }
+}
+
 void
 DWARFDebugInfoEntry::GetDeclContextDIEs (SymbolFileDWARF* dwarf2Data, 
                                          DWARFCompileUnit* cu,
@@ -2001,7 +2163,7 @@ DWARFDebugInfoEntry::LookupAddress
             dw_addr_t lo_pc = GetAttributeValueAsUnsigned(dwarf2Data, cu, DW_AT_low_pc, DW_INVALID_ADDRESS);
             if (lo_pc != DW_INVALID_ADDRESS)
             {
-                dw_addr_t hi_pc = GetAttributeValueAsUnsigned(dwarf2Data, cu, DW_AT_high_pc, DW_INVALID_ADDRESS);
+                dw_addr_t hi_pc = GetAttributeHighPC(dwarf2Data, cu, lo_pc, DW_INVALID_ADDRESS);
                 if (hi_pc != DW_INVALID_ADDRESS)
                 {
                     //  printf("\n0x%8.8x: %30s: address = 0x%8.8x  [0x%8.8x - 0x%8.8x) ", m_offset, DW_TAG_value_to_name(tag), address, lo_pc, hi_pc);
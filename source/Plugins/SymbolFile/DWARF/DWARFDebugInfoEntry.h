@@ -57,6 +57,20 @@ public:
     typedef offset_collection::iterator         offset_collection_iterator;
     typedef offset_collection::const_iterator   offset_collection_const_iterator;
 
+    //------------------------------------------------------------------
+    // An address range of a DW_TAG_lexical_block or
+    // DW_TAG_inlined_subroutine, and how deeply the block is nested in
+    // its function (top level blocks are depth 1).
+    //------------------------------------------------------------------
+    struct BlockRange
+    {
+        dw_addr_t lo_pc;
+        dw_addr_t hi_pc;
+        uint32_t depth;
+        dw_offset_t die_offset;
+    };
+    typedef std::vector<BlockRange>             block_range_collection;
+
     class Attributes
     {
     public:
@@ -141,6 +155,12 @@ public:
                     const DWARFCompileUnit* cu,
                     DWARFDebugAranges* debug_aranges) const;
 
+    void        BuildBlockAddressRangeTable(
+                    SymbolFileDWARF* dwarf2Data,
+                    const DWARFCompileUnit* cu,
+                    uint32_t depth,
+                    block_range_collection& block_ranges) const;
+
     bool        FastExtract(
                     const lldb_private::DataExtractor& debug_info_data,
                     const DWARFCompileUnit* cu,
@@ -185,6 +205,12 @@ public:
                     const dw_attr_t attr,
                     uint64_t fail_value) const;
 
+    dw_addr_t   GetAttributeHighPC(
+                    SymbolFileDWARF* dwarf2Data,
+                    const DWARFCompileUnit* cu,
+                    dw_addr_t lo_pc,
+                    uint64_t fail_value) const;
+
     uint64_t    GetAttributeValueAsReference(
                     SymbolFileDWARF* dwarf2Data,
                     const DWARFCompileUnit* cu,
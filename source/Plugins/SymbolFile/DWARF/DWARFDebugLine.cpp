@@ -412,12 +412,16 @@ DWARFDebugLine::ParsePrologue(const DataExtractor& debug_line_data, dw_offset_t*
     const char * s;
     prologue->total_length      = debug_line_data.GetU32(offset_ptr);
     prologue->version           = debug_line_data.GetU16(offset_ptr);
-    if (prologue->version != 2)
+    if (prologue->version < 2 || prologue->version > 4)
       return false;
 
     prologue->prologue_length   = debug_line_data.GetU32(offset_ptr);
     const dw_offset_t end_prologue_offset = prologue->prologue_length + *offset_ptr;
     prologue->min_inst_length   = debug_line_data.GetU8(offset_ptr);
+    // Version 4 added the maximum operations per instruction, which is
+    // only used for VLIW architectures
+    if (prologue->version >= 4)
+        debug_line_data.GetU8(offset_ptr);
     prologue->default_is_stmt   = debug_line_data.GetU8(offset_ptr);
     prologue->line_base         = debug_line_data.GetU8(offset_ptr);
     prologue->line_range        = debug_line_data.GetU8(offset_ptr);
@@ -477,13 +481,14 @@ DWARFDebugLine::ParseSupportFiles (const lldb::ModuleSP &module_sp,
     uint32_t offset = stmt_list + 4;    // Skip the total length
     const char * s;
     uint32_t version = debug_line_data.GetU16(&offset);
-    if (version != 2)
+    if (version < 2 || version > 4)
       return false;
 
     const dw_offset_t end_prologue_offset = debug_line_data.GetU32(&offset) + offset;
-    // Skip instruction length, default is stmt, line base, line range and
-    // opcode base, and all opcode lengths
-    offset += 4;
+    // Skip instruction length, maximum operations per instruction (version
+    // 4 only), default is stmt, line base, line range and opcode base, and
+    // all opcode lengths
+    offset += version >= 4 ? 5 : 4;
     const uint8_t opcode_base = debug_line_data.GetU8(&offset);
     offset += opcode_base - 1;
     std::vector<std::string> include_directories;
@@ -0,0 +1,333 @@
+//===-- DWARFDebugNames.cpp -------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "DWARFDebugNames.h"
+
+#include "lldb/Core/ConstString.h"
+#include "lldb/Core/Mangled.h"
+#include "lldb/Core/Timer.h"
+#include "lldb/Target/ObjCLanguageRuntime.h"
+
+#include "NameToDIE.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+// Index attribute encodings from the DWARF 5 specification
+#define DW_IDX_compile_unit     0x01
+#define DW_IDX_type_unit        0x02
+#define DW_IDX_die_offset       0x03
+#define DW_IDX_parent           0x04
+#define DW_IDX_type_hash        0x05
+
+DWARFDebugNames::DWARFDebugNames (const DataExtractor &debug_names_data,
+                                  const DataExtractor &debug_str_data) :
+    m_data (debug_names_data),
+    m_debug_str (debug_str_data)
+{
+}
+
+bool
+DWARFDebugNames::Index (NameToDIE& func_basenames,
+                        NameToDIE& func_fullnames,
+                        NameToDIE& func_methods,
+                        NameToDIE& func_selectors,
+                        NameToDIE& objc_class_selectors,
+                        NameToDIE& globals,
+                        NameToDIE& types,
+                        NameToDIE& namespaces) const
+{
+    Timer scoped_timer (__PRETTY_FUNCTION__, "%s", __PRETTY_FUNCTION__);
+
+    if (m_data.GetByteSize() == 0)
+        return false;
+
+    // The section can contain one name table per module or one per
+    // compile unit, they are simply concatenated.
+    uint32_t offset = 0;
+    while (m_data.ValidOffset (offset))
+    {
+        NameTable table;
+        if (!ExtractNameTable (&offset, table))
+            return false;
+        if (!IndexNameTable (table,
+                             func_basenames,
+                             func_fullnames,
+                             func_methods,
+                             func_selectors,
+                             objc_class_selectors,
+                             globals,
+                             types,
+                             namespaces))
+            return false;
+        offset = table.end_offset;
+    }
+    return true;
+}
+
+bool
+DWARFDebugNames::ExtractNameTable (uint32_t *offset_ptr, NameTable &table) const
+{
+    uint32_t offset = *offset_ptr;
+    if (!m_data.ValidOffsetForDataOfSize (offset, 36))
+        return false;
+
+    const uint32_t unit_length = m_data.GetU32 (&offset);
+    // 64 bit DWARF isn't supported
+    if (unit_length >= 0xfffffff0u)
+        return false;
+    table.end_offset = offset + unit_length;
+    if (!m_data.ValidOffsetForDataOfSize (offset, unit_length))
+        return false;
+
+    const uint16_t version = m_data.GetU16 (&offset);
+    if (version != 5)
+        return false;
+    m_data.GetU16 (&offset); // Padding
+
+    const uint32_t comp_unit_count = m_data.GetU32 (&offset);
+    const uint32_t local_type_unit_count = m_data.GetU32 (&offset);
+    const uint32_t foreign_type_unit_count = m_data.GetU32 (&offset);
+    const uint32_t bucket_count = m_data.GetU32 (&offset);
+    table.name_count = m_data.GetU32 (&offset);
+    const uint32_t abbrev_table_size = m_data.GetU32 (&offset);
+    const uint32_t augmentation_string_size = m_data.GetU32 (&offset);
+    offset += augmentation_string_size;
+
+    if (comp_unit_count == 0)
+        return false;
+
+    if (!m_data.ValidOffsetForDataOfSize (offset, comp_unit_count * 4))
+        return false;
+    table.cu_offsets.resize (comp_unit_count);
+    for (uint32_t i=0; i<comp_unit_count; ++i)
+        table.cu_offsets[i] = m_data.GetU32 (&offset);
+
+    // Skip the type unit lists, the bucket array and the hash array. We
+    // visit every name so we never need to do hashed lookups.
+    offset += local_type_unit_count * 4;
+    offset += foreign_type_unit_count * 8;
+    offset += bucket_count * 4;
+    if (bucket_count > 0)
+        offset += table.name_count * 4;
+
+    table.string_offsets_offset = offset;
+    offset += table.name_count * 4;
+    table.entry_offsets_offset = offset;
+    offset += table.name_count * 4;
+
+    const uint32_t abbrev_table_end = offset + abbrev_table_size;
+    table.entry_pool_offset = abbrev_table_end;
+    if (table.entry_pool_offset > table.end_offset)
+        return false;
+
+    while (offset < abbrev_table_end)
+    {
+        const uint32_t code = m_data.GetULEB128 (&offset);
+        if (code == 0)
+            break;
+        Abbreviation &abbrev = table.abbreviations[code];
+        abbrev.tag = m_data.GetULEB128 (&offset);
+        while (offset < abbrev_table_end)
+        {
+            AttributeSpec spec;
+            spec.index = m_data.GetULEB128 (&offset);
+            spec.form = m_data.GetULEB128 (&offset);
+            if (spec.index == 0 && spec.form == 0)
+                break;
+            abbrev.attributes.push_back (spec);
+        }
+    }
+
+    *offset_ptr = offset;
+    return true;
+}
+
+bool
+DWARFDebugNames::ExtractFormValue (dw_form_t form, uint32_t *offset_ptr, uint64_t &value) const
+{
+    switch (form)
+    {
+    case DW_FORM_flag_present:  value = 1; return true;
+    case DW_FORM_flag:
+    case DW_FORM_data1:
+    case DW_FORM_ref1:          value = m_data.GetU8 (offset_ptr); return true;
+    case DW_FORM_data2:
+    case DW_FORM_ref2:          value = m_data.GetU16 (offset_ptr); return true;
+    case DW_FORM_data4:
+    case DW_FORM_ref4:          value = m_data.GetU32 (offset_ptr); return true;
+    case DW_FORM_data8:
+    case DW_FORM_ref8:
+    case DW_FORM_ref_sig8:      value = m_data.GetU64 (offset_ptr); return true;
+    case DW_FORM_udata:
+    case DW_FORM_ref_udata:     value = m_data.GetULEB128 (offset_ptr); return true;
+    default:
+        break;
+    }
+    return false;
+}
+
+dw_tag_t
+DWARFDebugNames::GetTagForEntry (const NameTable &table, uint32_t entry_offset) const
+{
+    uint32_t offset = table.entry_pool_offset + entry_offset;
+    if (offset >= table.end_offset)
+        return 0;
+    AbbreviationMap::const_iterator pos = table.abbreviations.find (m_data.GetULEB128 (&offset));
+    if (pos != table.abbreviations.end())
+        return pos->second.tag;
+    return 0;
+}
+
+bool
+DWARFDebugNames::IndexNameTable (const NameTable &table,
+                                 NameToDIE& func_basenames,
+                                 NameToDIE& func_fullnames,
+                                 NameToDIE& func_methods,
+                                 NameToDIE& func_selectors,
+                                 NameToDIE& objc_class_selectors,
+                                 NameToDIE& globals,
+                                 NameToDIE& types,
+                                 NameToDIE& namespaces) const
+{
+    uint32_t string_offset_offset = table.string_offsets_offset;
+    uint32_t entry_offset_offset = table.entry_offsets_offset;
+    const uint32_t num_cus = table.cu_offsets.size();
+
+    for (uint32_t name_idx = 0; name_idx < table.name_count; ++name_idx)
+    {
+        const char *name = m_debug_str.PeekCStr (m_data.GetU32 (&string_offset_offset));
+        uint32_t offset = table.entry_pool_offset + m_data.GetU32 (&entry_offset_offset);
+        if (name == NULL || name[0] == '\0')
+            continue;
+
+        ConstString name_const_str (name);
+
+        while (offset < table.end_offset)
+        {
+            const uint32_t code = m_data.GetULEB128 (&offset);
+            if (code == 0)
+                break;  // End of the entries for this name
+
+            AbbreviationMap::const_iterator abbrev_pos = table.abbreviations.find (code);
+            if (abbrev_pos == table.abbreviations.end())
+                return false;
+
+            const Abbreviation &abbrev = abbrev_pos->second;
+            uint32_t cu_idx = num_cus == 1 ? 0 : UINT32_MAX;
+            dw_offset_t die_offset = DW_INVALID_OFFSET;
+            bool is_type_unit_entry = false;
+            dw_tag_t parent_tag = 0;
+
+            const size_t num_attributes = abbrev.attributes.size();
+            for (size_t i=0; i<num_attributes; ++i)
+            {
+                uint64_t value = 0;
+                const AttributeSpec &spec = abbrev.attributes[i];
+                if (!ExtractFormValue (spec.form, &offset, value))
+                    return false;
+                switch (spec.index)
+                {
+                case DW_IDX_compile_unit:   cu_idx = value; break;
+                case DW_IDX_type_unit:      is_type_unit_entry = true; break;
+                case DW_IDX_die_offset:     die_offset = value; break;
+                case DW_IDX_parent:
+                    // DW_FORM_flag_present means the parent isn't indexed
+                    if (spec.form != DW_FORM_flag_present)
+                        parent_tag = GetTagForEntry (table, value);
+                    break;
+                default:
+                    break;
+                }
+            }
+
+            // We don't support type units, and entries without a DIE
+            // offset or a valid compile unit are of no use to us.
+            if (is_type_unit_entry || die_offset == DW_INVALID_OFFSET || cu_idx >= num_cus)
+                continue;
+
+            // DIE offsets are relative to the start of the compile unit
+            const dw_offset_t abs_die_offset = table.cu_offsets[cu_idx] + die_offset;
+
+            switch (abbrev.tag)
+            {
+            case DW_TAG_subprogram:
+            case DW_TAG_inlined_subroutine:
+                if (name[0] == '_' && name[1] == 'Z')
+                {
+                    // Linkage names get indexed with their full names
+                    Mangled mangled (name_const_str, true);
+                    func_fullnames.Insert (mangled.GetMangledName(), abs_die_offset);
+                    if (mangled.GetDemangledName())
+                        func_fullnames.Insert (mangled.GetDemangledName(), abs_die_offset);
+                    break;
+                }
+                if (abbrev.tag == DW_TAG_subprogram && ObjCLanguageRuntime::IsPossibleObjCMethodName(name))
+                {
+                    ConstString objc_class_name;
+                    ConstString objc_selector_name;
+                    ConstString objc_fullname_no_category_name;
+                    ConstString objc_class_name_no_category;
+                    if (ObjCLanguageRuntime::ParseMethodName (name,
+                                                              &objc_class_name,
+                                                              &objc_selector_name,
+                                                              &objc_fullname_no_category_name,
+                                                              &objc_class_name_no_category))
+                    {
+                        func_fullnames.Insert (name_const_str, abs_die_offset);
+                        if (objc_class_name)
+                            objc_class_selectors.Insert(objc_class_name, abs_die_offset);
+                        if (objc_class_name_no_category)
+                            objc_class_selectors.Insert(objc_class_name_no_category, abs_die_offset);
+                        if (objc_selector_name)
+                            func_selectors.Insert (objc_selector_name, abs_die_offset);
+                        if (objc_fullname_no_category_name)
+                            func_fullnames.Insert (objc_fullname_no_category_name, abs_die_offset);
+                    }
+                }
+                if (parent_tag == DW_TAG_class_type || parent_tag == DW_TAG_structure_type)
+                    func_methods.Insert (name_const_str, abs_die_offset);
+                else
+                    func_basenames.Insert (name_const_str, abs_die_offset);
+                break;
+
+            case DW_TAG_base_type:
+            case DW_TAG_class_type:
+            case DW_TAG_constant:
+            case DW_TAG_enumeration_type:
+            case DW_TAG_string_type:
+            case DW_TAG_subroutine_type:
+            case DW_TAG_structure_type:
+            case DW_TAG_union_type:
+            case DW_TAG_typedef:
+            case DW_TAG_unspecified_type:
+                types.Insert (name_const_str, abs_die_offset);
+                break;
+
+            case DW_TAG_namespace:
+                namespaces.Insert (name_const_str, abs_die_offset);
+                break;
+
+            case DW_TAG_variable:
+                globals.Insert (name_const_str, abs_die_offset);
+                if (name[0] == '_' && name[1] == 'Z')
+                {
+                    Mangled mangled (name_const_str, true);
+                    if (mangled.GetDemangledName())
+                        globals.Insert (mangled.GetDemangledName(), abs_die_offset);
+                }
+                break;
+
+            default:
+                break;
+            }
+        }
+    }
+    return true;
+}
@@ -0,0 +1,105 @@
+//===-- DWARFDebugNames.h ---------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef SymbolFileDWARF_DWARFDebugNames_h_
+#define SymbolFileDWARF_DWARFDebugNames_h_
+
+#include <map>
+#include <vector>
+
+#include "lldb/lldb-private.h"
+#include "lldb/Core/DataExtractor.h"
+#include "DWARFDefines.h"
+
+class NameToDIE;
+
+//----------------------------------------------------------------------
+// DWARFDebugNames
+//
+// Parses the standardized DWARF accelerator tables found in the
+// ".debug_names" section and uses them to fill in the same name
+// indexes that SymbolFileDWARF::Index() would otherwise build by
+// parsing every DIE in every compile unit.
+//----------------------------------------------------------------------
+class DWARFDebugNames
+{
+public:
+    DWARFDebugNames (const lldb_private::DataExtractor &debug_names_data,
+                     const lldb_private::DataExtractor &debug_str_data);
+
+    //------------------------------------------------------------------
+    // Fill in the name indexes with the contents of all name tables in
+    // the section. Returns false if any name table uses a feature that
+    // we don't support, in which case the indexes must be built from
+    // the DIEs instead.
+    //------------------------------------------------------------------
+    bool
+    Index (NameToDIE& func_basenames,
+           NameToDIE& func_fullnames,
+           NameToDIE& func_methods,
+           NameToDIE& func_selectors,
+           NameToDIE& objc_class_selectors,
+           NameToDIE& globals,
+           NameToDIE& types,
+           NameToDIE& namespaces) const;
+
+protected:
+    struct AttributeSpec
+    {
+        dw_attr_t index;
+        dw_form_t form;
+    };
+
+    struct Abbreviation
+    {
+        dw_tag_t tag;
+        std::vector<AttributeSpec> attributes;
+    };
+
+    typedef std::map<uint32_t, Abbreviation> AbbreviationMap;
+
+    struct NameTable
+    {
+        std::vector<dw_offset_t> cu_offsets;
+        AbbreviationMap abbreviations;
+        uint32_t name_count;
+        uint32_t string_offsets_offset;
+        uint32_t entry_offsets_offset;
+        uint32_t entry_pool_offset;
+        uint32_t end_offset;
+    };
+
+    bool
+    ExtractNameTable (uint32_t *offset_ptr, NameTable &table) const;
+
+    bool
+    IndexNameTable (const NameTable &table,
+                    NameToDIE& func_basenames,
+                    NameToDIE& func_fullnames,
+                    NameToDIE& func_methods,
+                    NameToDIE& func_selectors,
+                    NameToDIE& objc_class_selectors,
+                    NameToDIE& globals,
+                    NameToDIE& types,
+                    NameToDIE& namespaces) const;
+
+    bool
+    ExtractFormValue (dw_form_t form, uint32_t *offset_ptr, uint64_t &value) const;
+
+    dw_tag_t
+    GetTagForEntry (const NameTable &table, uint32_t entry_offset) const;
+
+    lldb_private::DataExtractor m_data;
+    lldb_private::DataExtractor m_debug_str;
+
+private:
+    DISALLOW_COPY_AND_ASSIGN (DWARFDebugNames);
+};
+
+#endif  // SymbolFileDWARF_DWARFDebugNames_h_
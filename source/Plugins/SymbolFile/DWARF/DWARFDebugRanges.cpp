@@ -81,27 +81,30 @@ DWARFDebugRanges::Extract(SymbolFileDWARF* dwarf2Data)
 //    return NULL;
 //}
 
-bool
-DWARFDebugRanges::Extract(SymbolFileDWARF* dwarf2Data, uint32_t* offset_ptr, RangeList &range_list)
+// Decodes the entries of a range list with DataExtractor::ExtractRecords()
+class RangeListRecordParser
 {
-    range_list.Clear();
-
-    uint32_t range_offset = *offset_ptr;
-    const DataExtractor& debug_ranges_data = dwarf2Data->get_debug_ranges_data();
-    uint32_t addr_size = debug_ranges_data.GetAddressByteSize();
+public:
+    RangeListRecordParser (DWARFDebugRanges::RangeList &range_list, uint32_t addr_size) :
+        m_range_list (range_list),
+        m_addr_size (addr_size)
+    {
+    }
 
-    while (debug_ranges_data.ValidOffsetForDataOfSize(*offset_ptr, 2 * addr_size))
+    template <bool swap>
+    bool
+    ParseRecord (DataBlockCursor<swap> &cursor, uint32_t idx)
     {
-        dw_addr_t begin = debug_ranges_data.GetMaxU64(offset_ptr, addr_size);
-        dw_addr_t end   = debug_ranges_data.GetMaxU64(offset_ptr, addr_size);
+        dw_addr_t begin = cursor.GetMaxU64(m_addr_size);
+        dw_addr_t end   = cursor.GetMaxU64(m_addr_size);
         if (!begin && !end)
         {
             // End of range list
-            break;
+            return false;
         }
         // Extend 4 byte addresses that consists of 32 bits of 1's to be 64 bits
         // of ones
-        switch (addr_size)
+        switch (m_addr_size)
         {
         case 2:
             if (begin == 0xFFFFull)
@@ -123,9 +126,27 @@ DWARFDebugRanges::Extract(SymbolFileDWARF* dwarf2Data, uint32_t* offset_ptr, Ran
 
         // Filter out empty ranges
         if (begin < end)
-            range_list.Append(Range(begin, end - begin));
+            m_range_list.Append(DWARFDebugRanges::Range(begin, end - begin));
+        return true;
     }
 
+private:
+    DWARFDebugRanges::RangeList &m_range_list;
+    uint32_t m_addr_size;
+};
+
+bool
+DWARFDebugRanges::Extract(SymbolFileDWARF* dwarf2Data, uint32_t* offset_ptr, RangeList &range_list)
+{
+    range_list.Clear();
+
+    uint32_t range_offset = *offset_ptr;
+    const DataExtractor& debug_ranges_data = dwarf2Data->get_debug_ranges_data();
+    uint32_t addr_size = debug_ranges_data.GetAddressByteSize();
+
+    RangeListRecordParser parser (range_list, addr_size);
+    debug_ranges_data.ExtractRecords (offset_ptr, 2 * addr_size, UINT32_MAX, parser);
+
     // Make sure we consumed at least something
     return range_offset != *offset_ptr;
 }
@@ -10,9 +10,11 @@
 #include "NameToDIE.h"
 #include "lldb/Core/ConstString.h"
 #include "lldb/Core/DataExtractor.h"
+#include "lldb/Core/IndexCache.h"
 #include "lldb/Core/Stream.h"
 #include "lldb/Core/StreamString.h"
 #include "lldb/Core/RegularExpression.h"
+#include "lldb/Host/Host.h"
 #include "lldb/Symbol/ObjectFile.h"
 
 #include "DWARFCompileUnit.h"
@@ -25,26 +27,114 @@ using namespace lldb_private;
 void
 NameToDIE::Finalize()
 {
-    m_map.Sort ();
+    // Large modules have millions of names, sort them on all the cores
+    m_map.Sort (Host::GetNumberCPUs());
     m_map.SizeToFit ();
 }
 
+void
+NameToDIE::AppendNames (std::vector<const char *> &names) const
+{
+    // The map is sorted, so each distinct name is only added once
+    const uint32_t size = m_map.GetSize();
+    const char *prev_cstr = NULL;
+    for (uint32_t i=0; i<size; ++i)
+    {
+        const char *cstr = m_map.GetCStringAtIndex(i);
+        if (cstr != prev_cstr)
+            names.push_back (cstr);
+        prev_cstr = cstr;
+    }
+}
+
 void
 NameToDIE::Insert (const ConstString& name, uint32_t die_offset)
 {
     m_map.Append(name.GetCString(), die_offset);
 }
 
+void
+NameToDIE::Append (const NameToDIE& other)
+{
+    m_map.Append (other.m_map);
+}
+
+void
+NameToDIE::Encode (Stream &strm) const
+{
+    IndexCache::EncodeNameMap (strm, m_map);
+}
+
+bool
+NameToDIE::Decode (const DataExtractor &data, uint32_t *offset_ptr)
+{
+    if (!IndexCache::DecodeNameMap (data, offset_ptr, m_map))
+        return false;
+    m_map.SizeToFit ();
+    return true;
+}
+
 size_t
 NameToDIE::Find (const ConstString &name, DIEArray &info_array) const
 {
     return m_map.GetValues (name.GetCString(), info_array);
 }
 
+// Name indexes of big programs can have millions of names, so matching a
+// regular expression against all of them is split into shards that run
+// on their own threads. Don't split indexes with fewer names per shard
+// than this.
+#define NAME_TO_DIE_MIN_REGEX_SHARD_SIZE 16384
+
+struct NameToDIERegexShards
+{
+    const UniqueCStringMap<uint32_t> *map;
+    const RegularExpression *regex;
+    std::vector<DIEArray> die_offsets;
+};
+
+static void
+MatchRegexInShard (void *baton, uint32_t shard_idx, size_t begin_idx, size_t end_idx)
+{
+    NameToDIERegexShards *shards = (NameToDIERegexShards *)baton;
+    // Execute() saves the sub-expression matches in the regular
+    // expression, so each shard needs a copy of its own
+    RegularExpression regex (*shards->regex);
+    DIEArray &die_offsets = shards->die_offsets[shard_idx];
+    const char *last_cstr = NULL;
+    bool last_matched = false;
+    for (size_t i = begin_idx; i < end_idx; ++i)
+    {
+        // DIEs with the same name are next to each other in the sorted map
+        const char *cstr = shards->map->GetCStringAtIndex(i);
+        if (cstr != last_cstr)
+        {
+            last_cstr = cstr;
+            last_matched = regex.Execute (cstr);
+        }
+        if (last_matched)
+            die_offsets.push_back (shards->map->GetValueAtIndexUnchecked(i));
+    }
+}
+
 size_t
 NameToDIE::Find (const RegularExpression& regex, DIEArray &info_array) const
 {
-    return m_map.GetValues (regex, info_array);
+    const size_t num_entries = m_map.GetSize();
+    const uint32_t num_shards = Host::GetNumberOfShards (num_entries, NAME_TO_DIE_MIN_REGEX_SHARD_SIZE);
+    if (num_shards <= 1)
+        return m_map.GetValues (regex, info_array);
+
+    NameToDIERegexShards shards;
+    shards.map = &m_map;
+    shards.regex = &regex;
+    shards.die_offsets.resize (num_shards);
+    Host::RunShards (num_entries, num_shards, MatchRegexInShard, &shards);
+
+    const size_t initial_size = info_array.size();
+    for (uint32_t i = 0; i < num_shards; ++i)
+        info_array.insert (info_array.end(), shards.die_offsets[i].begin(), shards.die_offsets[i].end());
+    return info_array.size() - initial_size;
 }
 
 size_t
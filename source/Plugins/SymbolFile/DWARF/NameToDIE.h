@@ -35,9 +35,33 @@ public:
     void
     Insert (const lldb_private::ConstString& name, uint32_t die_offset);
 
+    void
+    Append (const NameToDIE& other);
+
+    void
+    Reserve (size_t n)
+    {
+        m_map.Reserve (n);
+    }
+
+    size_t
+    GetSize () const
+    {
+        return m_map.GetSize();
+    }
+
     void
     Finalize();
 
+    void
+    AppendNames (std::vector<const char *> &names) const;
+
+    void
+    Encode (lldb_private::Stream &strm) const;
+
+    bool
+    Decode (const lldb_private::DataExtractor &data, uint32_t *offset_ptr);
+
     size_t
     Find (const lldb_private::ConstString &name, 
           DIEArray &info_array) const;
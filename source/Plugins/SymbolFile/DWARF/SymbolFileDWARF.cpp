@@ -26,17 +26,22 @@
 
 #include "llvm/Support/Casting.h"
 
+#include "lldb/Core/AsyncOperation.h"
+#include "lldb/Core/IndexCache.h"
 #include "lldb/Core/Module.h"
 #include "lldb/Core/PluginManager.h"
 #include "lldb/Core/RegularExpression.h"
 #include "lldb/Core/Scalar.h"
 #include "lldb/Core/Section.h"
+#include "lldb/Core/Statistics.h"
 #include "lldb/Core/StreamFile.h"
 #include "lldb/Core/StreamString.h"
 #include "lldb/Core/Timer.h"
 #include "lldb/Core/Value.h"
 
+#include "lldb/Host/Endian.h"
 #include "lldb/Host/Host.h"
+#include "lldb/Host/Mutex.h"
 
 #include "lldb/Symbol/Block.h"
 #include "lldb/Symbol/ClangExternalASTSourceCallbacks.h"
@@ -48,6 +53,7 @@
 
 #include "lldb/Target/ObjCLanguageRuntime.h"
 #include "lldb/Target/CPPLanguageRuntime.h"
+#include "lldb/Target/Target.h"
 
 #include "DWARFCompileUnit.h"
 #include "DWARFDebugAbbrev.h"
@@ -55,6 +61,7 @@
 #include "DWARFDebugInfo.h"
 #include "DWARFDebugInfoEntry.h"
 #include "DWARFDebugLine.h"
+#include "DWARFDebugNames.h"
 #include "DWARFDebugPubnames.h"
 #include "DWARFDebugRanges.h"
 #include "DWARFDeclContext.h"
@@ -64,6 +71,7 @@
 #include "LogChannelDWARF.h"
 #include "SymbolFileDWARFDebugMap.h"
 
+#include <algorithm>
 #include <map>
 
 //#define ENABLE_DEBUG_PRINTF // COMMENT OUT THIS LINE PRIOR TO CHECKIN
@@ -235,6 +243,34 @@ SymbolFileDWARF::GetTypeList ()
 
 }
 
+void
+SymbolFileDWARF::PreloadSymbols ()
+{
+    // Lookups with the accelerator tables only need the compile units,
+    // everything else goes through the manual name indexes.
+    if (m_using_apple_tables)
+        DebugInfo ();
+    else if (!m_indexed)
+        Index ();
+}
+
+bool
+SymbolFileDWARF::AppendLookupNames (std::vector<const char *> &names)
+{
+    // The accelerator tables can only be searched, not listed
+    if (m_using_apple_tables)
+        return false;
+    if (!m_indexed)
+        Index ();
+    m_function_basename_index.AppendNames (names);
+    m_function_fullname_index.AppendNames (names);
+    m_function_method_index.AppendNames (names);
+    m_function_selector_index.AppendNames (names);
+    m_objc_class_selectors_index.AppendNames (names);
+    m_global_index.AppendNames (names);
+    return true;
+}
+
 //----------------------------------------------------------------------
 // Gets the first parent that is a lexical block, function or inlined
 // subroutine, or compile unit.
@@ -278,6 +314,7 @@ SymbolFileDWARF::SymbolFileDWARF(ObjectFile* objfile) :
     m_data_apple_names (),
     m_data_apple_types (),
     m_data_apple_namespaces (),
+    m_data_debug_names (),
     m_abbr(),
     m_info(),
     m_line(),
@@ -293,17 +330,29 @@ SymbolFileDWARF::SymbolFileDWARF(ObjectFile* objfile) :
     m_global_index(),
     m_type_index(),
     m_namespace_index(),
+    m_file_line_index(),
+    m_line_index_mutex (Mutex::eMutexTypeRecursive),
+    m_line_indexed (false),
     m_indexed (false),
     m_is_external_ast_source (false),
     m_using_apple_tables (false),
+    m_record_layouts_loaded (false),
+    m_record_layouts_changed (false),
     m_supports_DW_AT_APPLE_objc_complete_type (eLazyBoolCalculate),
     m_ranges(),
-    m_unique_ast_type_map ()
+    m_unique_ast_type_map (),
+    m_cached_record_layouts (),
+    m_decl_ctx_nodes (),
+    m_decl_ctx_node_to_id (),
+    m_die_offset_to_decl_ctx_id (),
+    m_shared_type_ast (NULL)
 {
 }
 
 SymbolFileDWARF::~SymbolFileDWARF()
 {
+    if (m_shared_type_ast)
+        UniqueDWARFASTTypeFingerprintMap::GetSharedMap().RemoveSymbolFile (this, m_shared_type_ast);
     if (m_is_external_ast_source)
     {
         ModuleSP module_sp (m_obj_file->GetModule());
@@ -327,6 +376,260 @@ SymbolFileDWARF::GetUniqueDWARFASTTypeMap ()
     return m_unique_ast_type_map;
 }
 
+// 64 bit FNV-1a, used for type fingerprints
+#define TYPE_FINGERPRINT_OFFSET_BASIS   0xcbf29ce484222325ull
+#define TYPE_FINGERPRINT_PRIME          0x00000100000001b3ull
+// Nested types and chains of unnamed types that are deeper than this are
+// left out of a fingerprint
+#define TYPE_FINGERPRINT_MAX_DEPTH      16
+
+static inline void
+AddBytesToTypeFingerprint (const void *bytes, size_t length, uint64_t &fingerprint)
+{
+    const uint8_t *p = (const uint8_t *)bytes;
+    for (size_t i=0; i<length; ++i)
+    {
+        fingerprint ^= p[i];
+        fingerprint *= TYPE_FINGERPRINT_PRIME;
+    }
+}
+
+static inline void
+AddValueToTypeFingerprint (uint64_t value, uint64_t &fingerprint)
+{
+    AddBytesToTypeFingerprint (&value, sizeof(value), fingerprint);
+}
+
+static inline void
+AddCStringToTypeFingerprint (const char *cstr, uint64_t &fingerprint)
+{
+    if (cstr)
+        AddBytesToTypeFingerprint (cstr, strlen(cstr) + 1, fingerprint);
+    else
+        AddValueToTypeFingerprint (0, fingerprint);
+}
+
+uint64_t
+SymbolFileDWARF::ComputeTypeFingerprint (DWARFCompileUnit *dwarf_cu,
+                                         const DWARFDebugInfoEntry *die)
+{
+    uint64_t fingerprint = TYPE_FINGERPRINT_OFFSET_BASIS;
+    AddValueToTypeFingerprint (dwarf_cu->GetAddressByteSize(), fingerprint);
+
+    DWARFDeclContext die_decl_ctx;
+    GetDWARFDeclContext (dwarf_cu, die, die_decl_ctx);
+    AddCStringToTypeFingerprint (die_decl_ctx.GetQualifiedName(), fingerprint);
+
+    AddDIEToTypeFingerprint (dwarf_cu, die, 0, fingerprint);
+    return fingerprint;
+}
+
+void
+SymbolFileDWARF::AddDIEToTypeFingerprint (DWARFCompileUnit *dwarf_cu,
+                                          const DWARFDebugInfoEntry *die,
+                                          uint32_t depth,
+                                          uint64_t &fingerprint)
+{
+    AddValueToTypeFingerprint (die->Tag(), fingerprint);
+
+    DWARFDebugInfoEntry::Attributes attributes;
+    const size_t num_attributes = die->GetAttributes (this, dwarf_cu, NULL, attributes);
+    for (size_t i=0; i<num_attributes; ++i)
+    {
+        const dw_attr_t attr = attributes.AttributeAtIndex(i);
+        switch (attr)
+        {
+        // Where the type was declared or where its code lives doesn't
+        // change what the type looks like
+        case DW_AT_decl_file:
+        case DW_AT_decl_line:
+        case DW_AT_decl_column:
+        case DW_AT_sibling:
+        case DW_AT_low_pc:
+        case DW_AT_high_pc:
+        case DW_AT_ranges:
+        case DW_AT_frame_base:
+            continue;
+        default:
+            break;
+        }
+
+        DWARFFormValue form_value;
+        if (!attributes.ExtractFormValueAtIndex (this, i, form_value))
+            continue;
+
+        AddValueToTypeFingerprint (attr, fingerprint);
+        switch (attributes.FormAtIndex(i))
+        {
+        case DW_FORM_string:
+        case DW_FORM_strp:
+            AddCStringToTypeFingerprint (form_value.AsCString(&get_debug_str_data()), fingerprint);
+            break;
+
+        case DW_FORM_ref_addr:
+        case DW_FORM_ref1:
+        case DW_FORM_ref2:
+        case DW_FORM_ref4:
+        case DW_FORM_ref8:
+        case DW_FORM_ref_udata:
+            AddTypeReferenceToTypeFingerprint (form_value.Reference(attributes.CompileUnitAtIndex(i)), depth, fingerprint);
+            break;
+
+        case DW_FORM_block:
+        case DW_FORM_block1:
+        case DW_FORM_block2:
+        case DW_FORM_block4:
+        case DW_FORM_exprloc:
+            AddValueToTypeFingerprint (form_value.Unsigned(), fingerprint);
+            if (form_value.BlockData())
+                AddBytesToTypeFingerprint (form_value.BlockData(), form_value.Unsigned(), fingerprint);
+            break;
+
+        default:
+            AddValueToTypeFingerprint (form_value.Unsigned(), fingerprint);
+            break;
+        }
+    }
+
+    if (depth < TYPE_FINGERPRINT_MAX_DEPTH)
+    {
+        for (const DWARFDebugInfoEntry *child_die = die->GetFirstChild();
+             child_die != NULL;
+             child_die = child_die->GetSibling())
+        {
+            AddDIEToTypeFingerprint (dwarf_cu, child_die, depth + 1, fingerprint);
+        }
+    }
+    // Mark the end of the children so siblings and children of the
+    // same DIEs don't hash the same
+    AddValueToTypeFingerprint (0, fingerprint);
+}
+
+void
+SymbolFileDWARF::AddTypeReferenceToTypeFingerprint (dw_offset_t die_offset,
+                                                    uint32_t depth,
+                                                    uint64_t &fingerprint)
+{
+    DWARFCompileUnitSP ref_cu_sp;
+    const DWARFDebugInfoEntry *ref_die = DebugInfo()->GetDIEPtr (die_offset, &ref_cu_sp);
+    if (ref_die == NULL)
+    {
+        AddValueToTypeFingerprint (0, fingerprint);
+        return;
+    }
+
+    AddValueToTypeFingerprint (ref_die->Tag(), fingerprint);
+    if (ref_die->GetName (this, ref_cu_sp.get()))
+    {
+        // Named types are identified by their qualified name, their own
+        // definitions get fingerprinted if they need to be shared.
+        DWARFDeclContext ref_decl_ctx;
+        GetDWARFDeclContext (ref_cu_sp.get(), ref_die, ref_decl_ctx);
+        AddCStringToTypeFingerprint (ref_decl_ctx.GetQualifiedName(), fingerprint);
+    }
+    else if (depth < TYPE_FINGERPRINT_MAX_DEPTH)
+    {
+        // Pointers, const and other modifiers and anonymous types are
+        // part of the structure of the type that refers to them
+        AddDIEToTypeFingerprint (ref_cu_sp.get(), ref_die, depth + 1, fingerprint);
+    }
+}
+
+bool
+SymbolFileDWARF::ImportSharedTypeDefinition (uint64_t fingerprint, clang_type_t clang_type)
+{
+    UniqueDWARFASTTypeFingerprintMap &shared_map = UniqueDWARFASTTypeFingerprintMap::GetSharedMap();
+    ClangASTContext &ast = GetClangASTContext();
+    uint64_t bit_size = 0;
+    uint64_t alignment = 0;
+    std::vector<uint64_t> field_bit_offsets;
+    if (!shared_map.ImportDefinition (fingerprint, this, ast, clang_type, bit_size, alignment, field_bit_offsets))
+        return false;
+    m_shared_type_ast = ast.getASTContext();
+
+    LogSP log (LogChannelDWARF::GetLogIfAny(DWARF_LOG_DEBUG_INFO|DWARF_LOG_TYPE_COMPLETION));
+    if (log)
+        GetObjectFile()->GetModule()->LogMessage (log.get(),
+                                                  "SymbolFileDWARF::ImportSharedTypeDefinition (clang_type = %p) imported definition with fingerprint 0x%16.16llx",
+                                                  clang_type,
+                                                  fingerprint);
+
+    // Use the field offsets from the DWARF of the module we imported the
+    // definition from, the fields were imported in the same order.
+    if (field_bit_offsets.empty())
+        return true;
+    clang::QualType qual_type (clang::QualType::getFromOpaquePtr(clang_type));
+    const clang::RecordType *record_type = qual_type->getAs<clang::RecordType>();
+    if (record_type == NULL)
+        return true;
+    const clang::RecordDecl *record_decl = record_type->getDecl();
+    LayoutInfo layout_info;
+    layout_info.bit_size = bit_size;
+    layout_info.alignment = alignment;
+    size_t field_idx = 0;
+    for (clang::RecordDecl::field_iterator field_pos = record_decl->field_begin(), field_end = record_decl->field_end();
+         field_pos != field_end;
+         ++field_pos, ++field_idx)
+    {
+        if (field_idx >= field_bit_offsets.size())
+            return true;
+        layout_info.field_offsets.insert (std::make_pair (*field_pos, field_bit_offsets[field_idx]));
+    }
+    if (field_idx == field_bit_offsets.size())
+        m_record_decl_to_layout_map.insert (std::make_pair (record_decl, layout_info));
+    return true;
+}
+
+void
+SymbolFileDWARF::AddSharedTypeDefinition (uint64_t fingerprint,
+                                          clang_type_t clang_type,
+                                          const LayoutInfo &layout_info)
+{
+    clang::QualType qual_type (clang::QualType::getFromOpaquePtr(clang_type));
+    const clang::TagType *tag_type = qual_type->getAs<clang::TagType>();
+    if (tag_type == NULL)
+        return;
+    clang::TagDecl *tag_decl = tag_type->getDecl();
+
+    // Record the field offsets in declaration order, if we don't have
+    // all of them let clang lay out imported copies itself.
+    std::vector<uint64_t> field_bit_offsets;
+    clang::RecordDecl *record_decl = llvm::dyn_cast<clang::RecordDecl>(tag_decl);
+    if (record_decl && !layout_info.field_offsets.empty())
+    {
+        for (clang::RecordDecl::field_iterator field_pos = record_decl->field_begin(), field_end = record_decl->field_end();
+             field_pos != field_end;
+             ++field_pos)
+        {
+            llvm::DenseMap <const clang::FieldDecl *, uint64_t>::const_iterator offset_pos = layout_info.field_offsets.find (*field_pos);
+            if (offset_pos == layout_info.field_offsets.end())
+            {
+                field_bit_offsets.clear();
+                break;
+            }
+            field_bit_offsets.push_back (offset_pos->second);
+        }
+    }
+
+    m_shared_type_ast = GetClangASTContext().getASTContext();
+    UniqueDWARFASTTypeFingerprintMap::GetSharedMap().Insert (fingerprint,
+                                                             this,
+                                                             tag_decl,
+                                                             layout_info.bit_size,
+                                                             layout_info.alignment,
+                                                             field_bit_offsets);
+}
+
+ModuleSP
+SymbolFileDWARF::GetClangASTModule ()
+{
+    // .o files in a debug map create their types in the AST of the
+    // executable module
+    if (GetDebugMapSymfile ())
+        return m_debug_map_module_wp.lock();
+    return m_obj_file->GetModule();
+}
+
 ClangASTContext &       
 SymbolFileDWARF::GetClangASTContext ()
 {
@@ -407,7 +710,9 @@ SymbolFileDWARF::InitializeObject()
 bool
 SymbolFileDWARF::SupportedVersion(uint16_t version)
 {
-    return version == 2 || version == 3;
+    // DWARF 4 compile units have the same header as DWARF 2 and 3, the
+    // forms it added are all handled by DWARFFormValue.
+    return version >= 2 && version <= 4;
 }
 
 uint32_t
@@ -611,6 +916,12 @@ SymbolFileDWARF::get_apple_objc_data()
     return GetCachedSectionData (flagsGotAppleObjCData, eSectionTypeDWARFAppleObjC, m_data_apple_objc);
 }
 
+const DataExtractor&
+SymbolFileDWARF::get_debug_names_data()
+{
+    return GetCachedSectionData (flagsGotDebugNamesData, eSectionTypeDWARFDebugNames, m_data_debug_names);
+}
+
 
 DWARFDebugAbbrev*
 SymbolFileDWARF::DebugAbbrev()
@@ -1185,6 +1496,7 @@ SymbolFileDWARF::ParseCompileUnitLineTable (const SymbolContext &sc)
                     };
                     uint32_t offset = cu_line_offset;
                     DWARFDebugLine::ParseStatementTable(get_debug_line_data(), &offset, ParseDWARFLineTableCallback, &info);
+                    line_table_ap->Finalize();
                     sc.comp_unit->SetLineTable(line_table_ap.release());
                     return true;
                 }
@@ -1530,7 +1842,8 @@ SymbolFileDWARF::ParseChildMembers
     DelayedPropertyList& delayed_properties,
     AccessType& default_accessibility,
     bool &is_a_class,
-    LayoutInfo &layout_info
+    LayoutInfo &layout_info,
+    const CachedRecordLayout *cached_layout
 )
 {
     if (parent_die == NULL)
@@ -1570,13 +1883,34 @@ SymbolFileDWARF::ParseChildMembers
                     lldb::user_id_t encoding_uid = LLDB_INVALID_UID;
                     AccessType accessibility = eAccessNone;
                     uint32_t member_byte_offset = UINT32_MAX;
+                    uint32_t member_location_offset = UINT32_MAX;
+                    uint32_t member_location_length = 0;
                     size_t byte_size = 0;
                     size_t bit_offset = 0;
                     size_t bit_size = 0;
+                    // With a cached offset for this member, the attributes
+                    // that only locate it or declare it aren't needed
+                    uint64_t cached_bit_offset = UINT64_MAX;
+                    const bool has_cached_bit_offset = cached_layout && cached_layout->FindFieldBitOffset (die->GetOffset(), cached_bit_offset);
                     uint32_t i;
                     for (i=0; i<num_attributes && !is_artificial; ++i)
                     {
                         const dw_attr_t attr = attributes.AttributeAtIndex(i);
+                        if (has_cached_bit_offset)
+                        {
+                            switch (attr)
+                            {
+                            case DW_AT_decl_file:
+                            case DW_AT_decl_line:
+                            case DW_AT_decl_column:
+                            case DW_AT_bit_offset:
+                            case DW_AT_byte_size:
+                            case DW_AT_data_member_location:
+                                continue;
+                            default:
+                                break;
+                            }
+                        }
                         DWARFFormValue form_value;
                         if (attributes.ExtractFormValueAtIndex(this, i, form_value))
                         {
@@ -1591,28 +1925,12 @@ SymbolFileDWARF::ParseChildMembers
                             case DW_AT_bit_size:    bit_size = form_value.Unsigned(); break;
                             case DW_AT_byte_size:   byte_size = form_value.Unsigned(); break;
                             case DW_AT_data_member_location:
+                                // Evaluated below, unless the layout of the
+                                // record came from the index cache
                                 if (form_value.BlockData())
                                 {
-                                    Value initialValue(0);
-                                    Value memberOffset(0);
-                                    const DataExtractor& debug_info_data = get_debug_info_data();
-                                    uint32_t block_length = form_value.Unsigned();
-                                    uint32_t block_offset = form_value.BlockData() - debug_info_data.GetDataStart();
-                                    if (DWARFExpression::Evaluate(NULL, // ExecutionContext *
-                                                                  NULL, // clang::ASTContext *
-                                                                  NULL, // ClangExpressionVariableList *
-                                                                  NULL, // ClangExpressionDeclMap *
-                                                                  NULL, // RegisterContext *
-                                                                  debug_info_data, 
-                                                                  block_offset, 
-                                                                  block_length, 
-                                                                  eRegisterKindDWARF, 
-                                                                  &initialValue, 
-                                                                  memberOffset, 
-                                                                  NULL))
-                                    {
-                                        member_byte_offset = memberOffset.ResolveValue(NULL, NULL).UInt();
-                                    }
+                                    member_location_length = form_value.Unsigned();
+                                    member_location_offset = form_value.BlockData() - get_debug_info_data().GetDataStart();
                                 }
                                 break;
 
@@ -1751,41 +2069,71 @@ SymbolFileDWARF::ParseChildMembers
                                                                                encoding_uid);
                             }
 
-                            if (member_byte_offset != UINT32_MAX || bit_size != 0)
+                            if (field_decl && has_cached_bit_offset)
                             {
-                                /////////////////////////////////////////////////////////////
-                                // How to locate a field given the DWARF debug information
-                                //
-                                // AT_byte_size indicates the size of the word in which the
-                                // bit offset must be interpreted.
-                                //
-                                // AT_data_member_location indicates the byte offset of the
-                                // word from the base address of the structure.
-                                //
-                                // AT_bit_offset indicates how many bits into the word
-                                // (according to the host endianness) the low-order bit of
-                                // the field starts.  AT_bit_offset can be negative.
-                                //
-                                // AT_bit_size indicates the size of the field in bits.
-                                /////////////////////////////////////////////////////////////
+                                // An earlier session saved the layout of this record in
+                                // the index cache, no need to evaluate the member location
+                                layout_info.field_offsets.insert(std::make_pair(field_decl, cached_bit_offset));
+                            }
+                            else
+                            {
+                                if (member_location_offset != UINT32_MAX)
+                                {
+                                    Value initialValue(0);
+                                    Value memberOffset(0);
+                                    if (DWARFExpression::Evaluate(NULL, // ExecutionContext *
+                                                                  NULL, // clang::ASTContext *
+                                                                  NULL, // ClangExpressionVariableList *
+                                                                  NULL, // ClangExpressionDeclMap *
+                                                                  NULL, // RegisterContext *
+                                                                  get_debug_info_data(), 
+                                                                  member_location_offset, 
+                                                                  member_location_length, 
+                                                                  eRegisterKindDWARF, 
+                                                                  &initialValue, 
+                                                                  memberOffset, 
+                                                                  NULL))
+                                    {
+                                        member_byte_offset = memberOffset.ResolveValue(NULL, NULL).UInt();
+                                    }
+                                }
+                            
+                                if (member_byte_offset != UINT32_MAX || bit_size != 0)
+                                {
+                                    /////////////////////////////////////////////////////////////
+                                    // How to locate a field given the DWARF debug information
+                                    //
+                                    // AT_byte_size indicates the size of the word in which the
+                                    // bit offset must be interpreted.
+                                    //
+                                    // AT_data_member_location indicates the byte offset of the
+                                    // word from the base address of the structure.
+                                    //
+                                    // AT_bit_offset indicates how many bits into the word
+                                    // (according to the host endianness) the low-order bit of
+                                    // the field starts.  AT_bit_offset can be negative.
+                                    //
+                                    // AT_bit_size indicates the size of the field in bits.
+                                    /////////////////////////////////////////////////////////////
                                                         
-                                ByteOrder object_endian = GetObjectFile()->GetModule()->GetArchitecture().GetDefaultEndian();
+                                    ByteOrder object_endian = GetObjectFile()->GetModule()->GetArchitecture().GetDefaultEndian();
 
-                                uint64_t total_bit_offset = 0;
+                                    uint64_t total_bit_offset = 0;
                                 
-                                total_bit_offset += (member_byte_offset == UINT32_MAX ? 0 : (member_byte_offset * 8));
+                                    total_bit_offset += (member_byte_offset == UINT32_MAX ? 0 : (member_byte_offset * 8));
                                 
-                                if (object_endian == eByteOrderLittle)
-                                {  
-                                    total_bit_offset += byte_size * 8;
-                                    total_bit_offset -= (bit_offset + bit_size);
-                                }
-                                else
-                                {
-                                    total_bit_offset += bit_offset;
-                                }
+                                    if (object_endian == eByteOrderLittle)
+                                    {  
+                                        total_bit_offset += byte_size * 8;
+                                        total_bit_offset -= (bit_offset + bit_size);
+                                    }
+                                    else
+                                    {
+                                        total_bit_offset += bit_offset;
+                                    }
                                                             
-                                layout_info.field_offsets.insert(std::make_pair(field_decl, total_bit_offset));
+                                    layout_info.field_offsets.insert(std::make_pair(field_decl, total_bit_offset));
+                                }
                             }
                         }
                         
@@ -2036,6 +2384,13 @@ SymbolFileDWARF::HasForwardDeclForClangType (lldb::clang_type_t clang_type)
 lldb::clang_type_t
 SymbolFileDWARF::ResolveClangOpaqueTypeDefinition (lldb::clang_type_t clang_type)
 {
+    // Types can also get completed on the type pre-warm thread, see
+    // Process::StartTypePrewarmThread()
+    Mutex::Locker locker;
+    ModuleSP module_sp (GetClangASTModule());
+    if (module_sp)
+        locker.Lock (module_sp->GetMutex());
+
     // We have a struct/union/class/enum that needs to be fully resolved.
     clang_type_t clang_type_no_qualifiers = ClangASTType::RemoveFastQualifiers(clang_type);
     const DWARFDebugInfoEntry* die = m_forward_decl_clang_type_to_die.lookup (clang_type_no_qualifiers);
@@ -2049,6 +2404,9 @@ SymbolFileDWARF::ResolveClangOpaqueTypeDefinition (lldb::clang_type_t clang_type
     // The type will get resolved when all of the calls to SymbolFileDWARF::ResolveClangOpaqueTypeDefinition
     // are done.
     m_forward_decl_clang_type_to_die.erase (clang_type_no_qualifiers);
+
+    static StatisticsCounter &g_types_completed = Statistics::GetCounter ("dwarf.types-completed");
+    g_types_completed.Add ();
     
 
     // Disable external storage for this type so we don't get anymore 
@@ -2084,6 +2442,21 @@ SymbolFileDWARF::ResolveClangOpaqueTypeDefinition (lldb::clang_type_t clang_type
     case DW_TAG_class_type:
         {
             LayoutInfo layout_info;
+            CachedRecordLayout cached_layout;
+            bool layout_is_cached = false;
+
+            // Identical definitions that another module already parsed can
+            // be imported instead of being parsed again.
+            uint64_t type_fingerprint = 0;
+            const bool share_type = die->HasChildren() &&
+                                    !ClangASTContext::IsObjCClassType (clang_type) &&
+                                    Target::GetDefaultShareTypesAcrossModules();
+            if (share_type)
+            {
+                type_fingerprint = ComputeTypeFingerprint (dwarf_cu, die);
+                if (ImportSharedTypeDefinition (type_fingerprint, clang_type))
+                    return clang_type;
+            }
             
             {
                 if (die->HasChildren())
@@ -2126,6 +2499,9 @@ SymbolFileDWARF::ResolveClangOpaqueTypeDefinition (lldb::clang_type_t clang_type
                                         
                     DelayedPropertyList delayed_properties;
                     
+                    if (!is_objc_class && GetCachedRecordLayout (die, cached_layout))
+                        layout_is_cached = true;
+
                     ParseChildMembers (sc, 
                                        dwarf_cu,
                                        die, 
@@ -2137,7 +2513,8 @@ SymbolFileDWARF::ResolveClangOpaqueTypeDefinition (lldb::clang_type_t clang_type
                                        delayed_properties,
                                        default_accessibility, 
                                        is_a_class,
-                                       layout_info);
+                                       layout_info,
+                                       layout_is_cached ? &cached_layout : NULL);
                     
                     // Now parse any methods if there were any...
                     size_t num_functions = member_function_dies.Size();                
@@ -2249,10 +2626,18 @@ SymbolFileDWARF::ResolveClangOpaqueTypeDefinition (lldb::clang_type_t clang_type
             
             if (!layout_info.field_offsets.empty())
             {
-                if (type)
-                    layout_info.bit_size = type->GetByteSize() * 8;
-                if (layout_info.bit_size == 0)
-                    layout_info.bit_size = die->GetAttributeValueAsUnsigned(this, dwarf_cu, DW_AT_byte_size, 0) * 8;
+                if (layout_is_cached)
+                {
+                    layout_info.bit_size = cached_layout.bit_size;
+                    layout_info.alignment = cached_layout.alignment;
+                }
+                else
+                {
+                    if (type)
+                        layout_info.bit_size = type->GetByteSize() * 8;
+                    if (layout_info.bit_size == 0)
+                        layout_info.bit_size = die->GetAttributeValueAsUnsigned(this, dwarf_cu, DW_AT_byte_size, 0) * 8;
+                }
                 clang::QualType qual_type(clang::QualType::getFromOpaquePtr(clang_type));
                 const clang::RecordType *record_type = clang::dyn_cast<clang::RecordType>(qual_type.getTypePtr());
                 if (record_type)
@@ -2280,8 +2665,13 @@ SymbolFileDWARF::ResolveClangOpaqueTypeDefinition (lldb::clang_type_t clang_type
                         }
                     }
                     m_record_decl_to_layout_map.insert(std::make_pair(record_decl, layout_info));
+                    if (!layout_is_cached)
+                        AddCachedRecordLayout (die, record_decl, layout_info);
                 }
             }
+
+            if (share_type)
+                AddSharedTypeDefinition (type_fingerprint, clang_type, layout_info);
         }
 
         return clang_type;
@@ -2418,15 +2808,7 @@ SymbolFileDWARF::ResolveSymbolContext (const Address& so_addr, uint32_t resolve_
                         if (resolve_scope & (eSymbolContextFunction | eSymbolContextBlock))
                         {
                             DWARFDebugInfoEntry *function_die = NULL;
-                            DWARFDebugInfoEntry *block_die = NULL;
-                            if (resolve_scope & eSymbolContextBlock)
-                            {
-                                dwarf_cu->LookupAddress(file_vm_addr, &function_die, &block_die);
-                            }
-                            else
-                            {
-                                dwarf_cu->LookupAddress(file_vm_addr, &function_die, NULL);
-                            }
+                            dwarf_cu->LookupAddress(file_vm_addr, &function_die, NULL);
 
                             if (function_die != NULL)
                             {
@@ -2452,14 +2834,10 @@ SymbolFileDWARF::ResolveSymbolContext (const Address& so_addr, uint32_t resolve_
 
                                 if (resolve_scope & eSymbolContextBlock)
                                 {
-                                    Block& block = sc.function->GetBlock (true);
-
-                                    if (block_die != NULL)
-                                        sc.block = block.FindBlockByID (MakeUserID(block_die->GetOffset()));
-                                    else
-                                        sc.block = block.FindBlockByID (MakeUserID(function_die->GetOffset()));
-                                    if (sc.block)
-                                        resolved |= eSymbolContextBlock;
+                                    sc.block = sc.function->FindBlockContainingFileAddress (file_vm_addr);
+                                    if (sc.block == NULL)
+                                        sc.block = &sc.function->GetBlock (true);
+                                    resolved |= eSymbolContextBlock;
                                 }
                             }
                         }
@@ -2488,11 +2866,36 @@ SymbolFileDWARF::ResolveSymbolContext(const FileSpec& file_spec, uint32_t line,
         DWARFDebugInfo* debug_info = DebugInfo();
         if (debug_info)
         {
+            // When looking for inlined entries any compile unit can
+            // contribute, but only the ones whose line tables have rows
+            // for a file with a matching name can have results, so only
+            // look at those. Otherwise we would parse the line table of
+            // every compile unit that merely includes the file.
+            DIEArray candidate_cu_idxs;
+            if (check_inlines)
+            {
+                IndexLineTables ();
+                if (m_file_line_index.Find (file_spec.GetFilename(), candidate_cu_idxs) == 0)
+                    return 0;
+                std::sort (candidate_cu_idxs.begin(), candidate_cu_idxs.end());
+                candidate_cu_idxs.erase (std::unique (candidate_cu_idxs.begin(), candidate_cu_idxs.end()), candidate_cu_idxs.end());
+            }
+
             uint32_t cu_idx;
             DWARFCompileUnit* dwarf_cu = NULL;
+            size_t candidate_idx = 0;
 
             for (cu_idx = 0; (dwarf_cu = debug_info->GetCompileUnitAtIndex(cu_idx)) != NULL; ++cu_idx)
             {
+                if (check_inlines)
+                {
+                    if (candidate_idx >= candidate_cu_idxs.size())
+                        break;
+                    if (candidate_cu_idxs[candidate_idx] != cu_idx)
+                        continue;
+                    ++candidate_idx;
+                }
+
                 CompileUnit *dc_cu = GetCompUnitForDWARFCompUnit(dwarf_cu, cu_idx);
                 const bool full_match = file_spec.GetDirectory();
                 bool file_spec_matches_cu_file_spec = dc_cu != NULL && FileSpec::Equal(file_spec, *dc_cu, full_match);
@@ -2540,8 +2943,7 @@ SymbolFileDWARF::ResolveSymbolContext(const FileSpec& file_spec, uint32_t line,
                                             if (file_vm_addr != LLDB_INVALID_ADDRESS)
                                             {
                                                 DWARFDebugInfoEntry *function_die = NULL;
-                                                DWARFDebugInfoEntry *block_die = NULL;
-                                                dwarf_cu->LookupAddress(file_vm_addr, &function_die, resolve_scope & eSymbolContextBlock ? &block_die : NULL);
+                                                dwarf_cu->LookupAddress(file_vm_addr, &function_die, NULL);
 
                                                 if (function_die != NULL)
                                                 {
@@ -2552,12 +2954,9 @@ SymbolFileDWARF::ResolveSymbolContext(const FileSpec& file_spec, uint32_t line,
 
                                                 if (sc.function != NULL)
                                                 {
-                                                    Block& block = sc.function->GetBlock (true);
-
-                                                    if (block_die != NULL)
-                                                        sc.block = block.FindBlockByID (MakeUserID(block_die->GetOffset()));
-                                                    else
-                                                        sc.block = block.FindBlockByID (MakeUserID(function_die->GetOffset()));
+                                                    sc.block = sc.function->FindBlockContainingFileAddress (file_vm_addr);
+                                                    if (sc.block == NULL)
+                                                        sc.block = &sc.function->GetBlock (true);
                                                 }
                                             }
                                         }
@@ -2591,6 +2990,258 @@ SymbolFileDWARF::ResolveSymbolContext(const FileSpec& file_spec, uint32_t line,
     return sc_list.GetSize() - prev_size;
 }
 
+struct IndexDWARFLineTableCallbackInfo
+{
+    NameToDIE *file_line_index;
+    uint32_t cu_idx;
+    std::vector<bool> file_has_rows;
+};
+
+static void
+IndexDWARFLineTableCallback (dw_offset_t offset, const DWARFDebugLine::State& state, void* userData)
+{
+    IndexDWARFLineTableCallbackInfo* info = (IndexDWARFLineTableCallbackInfo*)userData;
+    if (state.row == DWARFDebugLine::State::StartParsingLineTable)
+    {
+        info->file_has_rows.clear();
+    }
+    else if (state.row == DWARFDebugLine::State::DoneParsingLineTable)
+    {
+        // DW_LNE_define_file can add files after the prologue, so wait
+        // until the end to look at the file names. File indexes are one
+        // based.
+        const std::vector<DWARFDebugLine::FileNameEntry> &file_names = state.prologue->file_names;
+        const size_t num_files = std::min<size_t> (file_names.size() + 1, info->file_has_rows.size());
+        for (size_t file_idx = 1; file_idx < num_files; ++file_idx)
+        {
+            if (!info->file_has_rows[file_idx])
+                continue;
+            const char *path = file_names[file_idx - 1].name.c_str();
+            const char *base_name = ::strrchr (path, '/');
+            info->file_line_index->Insert (ConstString (base_name ? base_name + 1 : path), info->cu_idx);
+        }
+    }
+    else
+    {
+        if (state.file >= info->file_has_rows.size())
+            info->file_has_rows.resize (state.file + 1, false);
+        info->file_has_rows[state.file] = true;
+    }
+}
+
+//----------------------------------------------------------------------
+// Build an index from the base names of all files that have line table
+// rows to the compile units whose line tables have those rows. The
+// line table programs are run without creating any LineTable objects,
+// so this is a single cheap pass over .debug_line.
+//----------------------------------------------------------------------
+void
+SymbolFileDWARF::IndexLineTables ()
+{
+    // Lookups on other threads wait here until the index is complete
+    // instead of seeing part of it.
+    Mutex::Locker locker (m_line_index_mutex);
+    if (m_line_indexed)
+        return;
+    Timer scoped_timer (__PRETTY_FUNCTION__,
+                        "SymbolFileDWARF::IndexLineTables (%s)",
+                        GetObjectFile()->GetFileSpec().GetFilename().AsCString());
+
+    if (!LoadLineIndexFromCache ())
+        BuildLineIndex ();
+    m_line_indexed = true;
+}
+
+void
+SymbolFileDWARF::BuildLineIndex ()
+{
+    DWARFDebugInfo* debug_info = DebugInfo();
+    if (debug_info == NULL)
+        return;
+
+    const DataExtractor &debug_line_data = get_debug_line_data();
+    IndexDWARFLineTableCallbackInfo info;
+    info.file_line_index = &m_file_line_index;
+
+    uint32_t cu_idx;
+    DWARFCompileUnit* dwarf_cu = NULL;
+    for (cu_idx = 0; (dwarf_cu = debug_info->GetCompileUnitAtIndex(cu_idx)) != NULL; ++cu_idx)
+    {
+        const DWARFDebugInfoEntry *cu_die = dwarf_cu->GetCompileUnitDIEOnly();
+        if (cu_die == NULL)
+            continue;
+        const dw_offset_t stmt_list = cu_die->GetAttributeValueAsUnsigned(this, dwarf_cu, DW_AT_stmt_list, DW_INVALID_OFFSET);
+        if (stmt_list == DW_INVALID_OFFSET)
+            continue;
+        info.cu_idx = cu_idx;
+        uint32_t offset = stmt_list;
+        DWARFDebugLine::ParseStatementTable (debug_line_data, &offset, IndexDWARFLineTableCallback, &info);
+    }
+
+    m_file_line_index.Finalize();
+    SaveLineIndexToCache ();
+}
+
+//----------------------------------------------------------------------
+// Parallel indexing support.
+//
+// Compile units are indexed in three phases, each of which is run on a
+// small pool of worker threads that pull compile unit indexes from a
+// shared counter:
+//
+//  1 - Extract the DIEs for all compile units in the batch that need it.
+//      This has to complete before any indexing starts so the DIE arrays
+//      don't change while other workers are reading them.
+//  2 - Index each compile unit into the NameToDIE maps that are owned
+//      by the worker, so the maps themselves need no locking. Indexing
+//      a DIE can follow a DW_AT_specification into a compile unit that
+//      is outside of the batch, DWARFCompileUnit::ExtractDIEsIfNeeded()
+//      is thread safe so this is ok.
+//  3 - Clear the DIEs that phase 1 caused to be parsed, along with the
+//      DIEs of any compile unit outside of the batch that phase 2 caused
+//      to be parsed.
+//
+// The compile units are processed in batches whose total .debug_info
+// size stays under DWARF_INDEX_BATCH_DEBUG_INFO_SIZE so the amount of
+// memory used by the DIE arrays stays bounded regardless of how much
+// debug information there is. Once all batches are done, the per worker
+// maps are appended to the maps in SymbolFileDWARF and sorted.
+//----------------------------------------------------------------------
+#define DWARF_INDEX_BATCH_DEBUG_INFO_SIZE   (64 * 1024 * 1024)
+
+enum DWARFIndexPhase
+{
+    eIndexPhaseExtractDIEs,
+    eIndexPhaseIndex,
+    eIndexPhaseClearDIEs
+};
+
+struct DWARFIndexWorkerState
+{
+    DWARFDebugInfo *debug_info;
+    Mutex *mutex;
+    uint32_t *next_cu_idx;
+    uint32_t end_cu_idx;
+    DWARFIndexPhase phase;
+    std::vector<uint8_t> *clear_dies;
+    NameToDIE function_basename_index;
+    NameToDIE function_fullname_index;
+    NameToDIE function_method_index;
+    NameToDIE function_selector_index;
+    NameToDIE objc_class_selectors_index;
+    NameToDIE global_index;
+    NameToDIE type_index;
+    NameToDIE namespace_index;
+};
+
+static lldb::thread_result_t
+DWARFIndexWorkerThread (void *arg)
+{
+    DWARFIndexWorkerState *state = (DWARFIndexWorkerState *)arg;
+    while (1)
+    {
+        uint32_t cu_idx;
+        {
+            Mutex::Locker locker (*state->mutex);
+            cu_idx = (*state->next_cu_idx)++;
+        }
+        if (cu_idx >= state->end_cu_idx)
+            break;
+
+        DWARFCompileUnit* dwarf_cu = state->debug_info->GetCompileUnitAtIndex(cu_idx);
+        switch (state->phase)
+        {
+        case eIndexPhaseExtractDIEs:
+            // Each worker only ever writes the entry for the compile
+            // unit it claimed, so this doesn't need to be locked.
+            (*state->clear_dies)[cu_idx] = dwarf_cu->ExtractDIEsIfNeeded (false) > 1;
+            break;
+
+        case eIndexPhaseIndex:
+            dwarf_cu->Index (cu_idx,
+                             state->function_basename_index,
+                             state->function_fullname_index,
+                             state->function_method_index,
+                             state->function_selector_index,
+                             state->objc_class_selectors_index,
+                             state->global_index,
+                             state->type_index,
+                             state->namespace_index);
+            break;
+
+        case eIndexPhaseClearDIEs:
+            if ((*state->clear_dies)[cu_idx])
+                dwarf_cu->ClearDIEs (true);
+            break;
+        }
+    }
+    return NULL;
+}
+
+static void
+RunDWARFIndexPhase (std::vector<DWARFIndexWorkerState> &workers,
+                    DWARFIndexPhase phase,
+                    uint32_t *next_cu_idx,
+                    uint32_t first_cu_idx,
+                    uint32_t end_cu_idx)
+{
+    *next_cu_idx = first_cu_idx;
+    const size_t num_workers = std::min<size_t> (workers.size(), end_cu_idx - first_cu_idx);
+    for (size_t i=0; i<num_workers; ++i)
+    {
+        workers[i].phase = phase;
+        workers[i].end_cu_idx = end_cu_idx;
+    }
+
+    // The calling thread does the work for the first worker, so only
+    // spawn threads for the rest.
+    std::vector<lldb::thread_t> threads;
+    for (size_t i=1; i<num_workers; ++i)
+    {
+        lldb::thread_t thread = Host::ThreadCreate ("<lldb.dwarf.index>", DWARFIndexWorkerThread, &workers[i], NULL);
+        if (IS_VALID_LLDB_HOST_THREAD(thread))
+            threads.push_back (thread);
+    }
+
+    DWARFIndexWorkerThread (&workers[0]);
+
+    for (size_t i=0; i<threads.size(); ++i)
+        Host::ThreadJoin (threads[i], NULL, NULL);
+}
+
+// Following a DW_AT_specification while indexing can parse the DIEs of a
+// compile unit that was already indexed, or that isn't indexed yet. Clear
+// the DIEs of every compile unit that didn't have them before indexing
+// started so they don't pile up.
+static void
+ClearDIEsParsedWhileIndexing (DWARFDebugInfo *debug_info, const std::vector<uint8_t> &keep_dies)
+{
+    const uint32_t num_compile_units = keep_dies.size();
+    for (uint32_t cu_idx = 0; cu_idx < num_compile_units; ++cu_idx)
+    {
+        if (keep_dies[cu_idx])
+            continue;
+        DWARFCompileUnit* dwarf_cu = debug_info->GetCompileUnitAtIndex(cu_idx);
+        if (dwarf_cu->HasDIEsParsed())
+            dwarf_cu->ClearDIEs (true);
+    }
+}
+
+// Append one of the per worker maps of all the workers to INDEX, growing
+// INDEX only once.
+static void
+AppendWorkerIndexes (const std::vector<DWARFIndexWorkerState> &workers,
+                     NameToDIE DWARFIndexWorkerState::*worker_index,
+                     NameToDIE &index)
+{
+    size_t total_size = index.GetSize();
+    for (size_t i=0; i<workers.size(); ++i)
+        total_size += (workers[i].*worker_index).GetSize();
+    index.Reserve (total_size);
+    for (size_t i=0; i<workers.size(); ++i)
+        index.Append (workers[i].*worker_index);
+}
+
 void
 SymbolFileDWARF::Index ()
 {
@@ -2601,31 +3252,101 @@ SymbolFileDWARF::Index ()
                         "SymbolFileDWARF::Index (%s)",
                         GetObjectFile()->GetFileSpec().GetFilename().AsCString());
 
+    if (LoadIndexFromCache ())
+        return;
+
     DWARFDebugInfo* debug_info = DebugInfo();
     if (debug_info)
     {
-        uint32_t cu_idx = 0;
         const uint32_t num_compile_units = GetNumCompileUnits();
-        for (cu_idx = 0; cu_idx < num_compile_units; ++cu_idx)
+        const uint32_t num_workers = std::min<uint32_t> (Host::GetNumberCPUs(), num_compile_units);
+
+        // DIEs that were parsed before we started indexing are used by
+        // lookups, so they must be left alone.
+        std::vector<uint8_t> keep_dies (num_compile_units, 0);
+        for (uint32_t cu_idx = 0; cu_idx < num_compile_units; ++cu_idx)
+            keep_dies[cu_idx] = debug_info->GetCompileUnitAtIndex(cu_idx)->HasDIEsParsed();
+
+        if (IndexFromDebugNames ())
+        {
+            // The ".debug_names" accelerator tables filled in all of the
+            // indexes without us having to parse a single DIE.
+        }
+        else if (num_workers > 1)
         {
-            DWARFCompileUnit* dwarf_cu = debug_info->GetCompileUnitAtIndex(cu_idx);
+            Mutex cu_idx_mutex (Mutex::eMutexTypeNormal);
+            uint32_t next_cu_idx = 0;
+            std::vector<uint8_t> clear_dies (num_compile_units, 0);
+
+            DWARFIndexWorkerState initial_state;
+            initial_state.debug_info = debug_info;
+            initial_state.mutex = &cu_idx_mutex;
+            initial_state.next_cu_idx = &next_cu_idx;
+            initial_state.end_cu_idx = num_compile_units;
+            initial_state.phase = eIndexPhaseExtractDIEs;
+            initial_state.clear_dies = &clear_dies;
+            std::vector<DWARFIndexWorkerState> workers (num_workers, initial_state);
+
+            uint32_t batch_start_cu_idx = 0;
+            while (batch_start_cu_idx < num_compile_units)
+            {
+                // Always include at least one compile unit in the batch
+                uint32_t batch_end_cu_idx = batch_start_cu_idx;
+                size_t batch_debug_info_size = 0;
+                do
+                {
+                    batch_debug_info_size += debug_info->GetCompileUnitAtIndex(batch_end_cu_idx)->GetDebugInfoSize();
+                    ++batch_end_cu_idx;
+                } while (batch_end_cu_idx < num_compile_units && batch_debug_info_size < DWARF_INDEX_BATCH_DEBUG_INFO_SIZE);
+
+                RunDWARFIndexPhase (workers, eIndexPhaseExtractDIEs, &next_cu_idx, batch_start_cu_idx, batch_end_cu_idx);
+                RunDWARFIndexPhase (workers, eIndexPhaseIndex, &next_cu_idx, batch_start_cu_idx, batch_end_cu_idx);
+                RunDWARFIndexPhase (workers, eIndexPhaseClearDIEs, &next_cu_idx, batch_start_cu_idx, batch_end_cu_idx);
+                ClearDIEsParsedWhileIndexing (debug_info, keep_dies);
+                batch_start_cu_idx = batch_end_cu_idx;
+            }
+
+            AppendWorkerIndexes (workers, &DWARFIndexWorkerState::function_basename_index, m_function_basename_index);
+            AppendWorkerIndexes (workers, &DWARFIndexWorkerState::function_fullname_index, m_function_fullname_index);
+            AppendWorkerIndexes (workers, &DWARFIndexWorkerState::function_method_index, m_function_method_index);
+            AppendWorkerIndexes (workers, &DWARFIndexWorkerState::function_selector_index, m_function_selector_index);
+            AppendWorkerIndexes (workers, &DWARFIndexWorkerState::objc_class_selectors_index, m_objc_class_selectors_index);
+            AppendWorkerIndexes (workers, &DWARFIndexWorkerState::global_index, m_global_index);
+            AppendWorkerIndexes (workers, &DWARFIndexWorkerState::type_index, m_type_index);
+            AppendWorkerIndexes (workers, &DWARFIndexWorkerState::namespace_index, m_namespace_index);
+        }
+        else
+        {
+            size_t batch_debug_info_size = 0;
+            for (uint32_t cu_idx = 0; cu_idx < num_compile_units; ++cu_idx)
+            {
+                DWARFCompileUnit* dwarf_cu = debug_info->GetCompileUnitAtIndex(cu_idx);
 
-            bool clear_dies = dwarf_cu->ExtractDIEsIfNeeded (false) > 1;
+                bool clear_dies = dwarf_cu->ExtractDIEsIfNeeded (false) > 1;
+
+                dwarf_cu->Index (cu_idx,
+                                 m_function_basename_index,
+                                 m_function_fullname_index,
+                                 m_function_method_index,
+                                 m_function_selector_index,
+                                 m_objc_class_selectors_index,
+                                 m_global_index, 
+                                 m_type_index,
+                                 m_namespace_index);
+                
+                // Keep memory down by clearing DIEs if this generate function
+                // caused them to be parsed
+                if (clear_dies)
+                    dwarf_cu->ClearDIEs (true);
 
-            dwarf_cu->Index (cu_idx,
-                             m_function_basename_index,
-                             m_function_fullname_index,
-                             m_function_method_index,
-                             m_function_selector_index,
-                             m_objc_class_selectors_index,
-                             m_global_index, 
-                             m_type_index,
-                             m_namespace_index);
-            
-            // Keep memory down by clearing DIEs if this generate function
-            // caused them to be parsed
-            if (clear_dies)
-                dwarf_cu->ClearDIEs (true);
+                batch_debug_info_size += dwarf_cu->GetDebugInfoSize();
+                if (batch_debug_info_size >= DWARF_INDEX_BATCH_DEBUG_INFO_SIZE)
+                {
+                    ClearDIEsParsedWhileIndexing (debug_info, keep_dies);
+                    batch_debug_info_size = 0;
+                }
+            }
+            ClearDIEsParsedWhileIndexing (debug_info, keep_dies);
         }
         
         m_function_basename_index.Finalize();
@@ -2637,6 +3358,8 @@ SymbolFileDWARF::Index ()
         m_type_index.Finalize();
         m_namespace_index.Finalize();
 
+        SaveIndexToCache ();
+
 #if defined (ENABLE_DEBUG_PRINTF)
         StreamFile s(stdout, false);
         s.Printf ("DWARF index for '%s/%s':", 
@@ -2654,6 +3377,247 @@ SymbolFileDWARF::Index ()
     }
 }
 
+bool
+SymbolFileDWARF::IndexFromDebugNames ()
+{
+    const DataExtractor &debug_names_data = get_debug_names_data();
+    if (debug_names_data.GetByteSize() == 0)
+        return false;
+
+    DWARFDebugNames debug_names (debug_names_data, get_debug_str_data());
+    if (debug_names.Index (m_function_basename_index,
+                           m_function_fullname_index,
+                           m_function_method_index,
+                           m_function_selector_index,
+                           m_objc_class_selectors_index,
+                           m_global_index,
+                           m_type_index,
+                           m_namespace_index))
+        return true;
+
+    // The tables use something we don't support, throw away anything we
+    // managed to index and fall back to parsing the DIEs.
+    m_function_basename_index = NameToDIE();
+    m_function_fullname_index = NameToDIE();
+    m_function_method_index = NameToDIE();
+    m_function_selector_index = NameToDIE();
+    m_objc_class_selectors_index = NameToDIE();
+    m_global_index = NameToDIE();
+    m_type_index = NameToDIE();
+    m_namespace_index = NameToDIE();
+    return false;
+}
+
+// Bump this whenever the contents or the encoding of the indexes change
+#define DWARF_INDEX_CACHE_VERSION   1
+
+bool
+SymbolFileDWARF::LoadIndexFromCache ()
+{
+    Module *module = GetObjectFile()->GetModule().get();
+    if (!IndexCache::IsEnabledForModule (module))
+        return false;
+
+    DataExtractor data;
+    uint32_t offset = 0;
+    if (!IndexCache::Load (module, "dwarf-names", DWARF_INDEX_CACHE_VERSION, data, &offset))
+        return false;
+
+    if (m_function_basename_index.Decode (data, &offset) &&
+        m_function_fullname_index.Decode (data, &offset) &&
+        m_function_method_index.Decode (data, &offset) &&
+        m_function_selector_index.Decode (data, &offset) &&
+        m_objc_class_selectors_index.Decode (data, &offset) &&
+        m_global_index.Decode (data, &offset) &&
+        m_type_index.Decode (data, &offset) &&
+        m_namespace_index.Decode (data, &offset))
+        return true;
+
+    // The cache file was truncated or corrupt, start from scratch
+    m_function_basename_index = NameToDIE();
+    m_function_fullname_index = NameToDIE();
+    m_function_method_index = NameToDIE();
+    m_function_selector_index = NameToDIE();
+    m_objc_class_selectors_index = NameToDIE();
+    m_global_index = NameToDIE();
+    m_type_index = NameToDIE();
+    m_namespace_index = NameToDIE();
+    return false;
+}
+
+void
+SymbolFileDWARF::SaveIndexToCache ()
+{
+    Module *module = GetObjectFile()->GetModule().get();
+    if (!IndexCache::IsEnabledForModule (module))
+        return;
+
+    StreamString strm (Stream::eBinary, sizeof(void *), lldb::endian::InlHostByteOrder());
+    m_function_basename_index.Encode (strm);
+    m_function_fullname_index.Encode (strm);
+    m_function_method_index.Encode (strm);
+    m_function_selector_index.Encode (strm);
+    m_objc_class_selectors_index.Encode (strm);
+    m_global_index.Encode (strm);
+    m_type_index.Encode (strm);
+    m_namespace_index.Encode (strm);
+    IndexCache::Save (module, "dwarf-names", DWARF_INDEX_CACHE_VERSION, strm.GetString());
+}
+
+// Bump this whenever the contents or the encoding of the line index change
+#define DWARF_LINE_INDEX_CACHE_VERSION  1
+
+bool
+SymbolFileDWARF::LoadLineIndexFromCache ()
+{
+    Module *module = GetObjectFile()->GetModule().get();
+    if (!IndexCache::IsEnabledForModule (module))
+        return false;
+
+    DataExtractor data;
+    uint32_t offset = 0;
+    if (!IndexCache::Load (module, "dwarf-lines", DWARF_LINE_INDEX_CACHE_VERSION, data, &offset))
+        return false;
+
+    if (m_file_line_index.Decode (data, &offset))
+        return true;
+
+    // The cache file was truncated or corrupt, start from scratch
+    m_file_line_index = NameToDIE();
+    return false;
+}
+
+void
+SymbolFileDWARF::SaveLineIndexToCache ()
+{
+    Module *module = GetObjectFile()->GetModule().get();
+    if (!IndexCache::IsEnabledForModule (module))
+        return;
+
+    StreamString strm (Stream::eBinary, sizeof(void *), lldb::endian::InlHostByteOrder());
+    m_file_line_index.Encode (strm);
+    IndexCache::Save (module, "dwarf-lines", DWARF_LINE_INDEX_CACHE_VERSION, strm.GetString());
+}
+
+// Bump this whenever the contents or the encoding of the record layouts change
+#define DWARF_RECORD_LAYOUTS_CACHE_VERSION  2
+
+void
+SymbolFileDWARF::LoadRecordLayoutsFromCache ()
+{
+    if (m_record_layouts_loaded)
+        return;
+    m_record_layouts_loaded = true;
+
+    Module *module = GetObjectFile()->GetModule().get();
+    if (!IndexCache::IsEnabledForModule (module))
+        return;
+
+    DataExtractor data;
+    uint32_t offset = 0;
+    if (!IndexCache::Load (module, "dwarf-record-layouts", DWARF_RECORD_LAYOUTS_CACHE_VERSION, data, &offset))
+        return;
+
+    if (!data.ValidOffsetForDataOfSize (offset, 4))
+        return;
+    const uint32_t num_layouts = data.GetU32 (&offset);
+    for (uint32_t i=0; i<num_layouts; ++i)
+    {
+        if (!data.ValidOffsetForDataOfSize (offset, 24))
+            break;
+        const dw_offset_t die_offset = data.GetU32 (&offset);
+        const uint64_t bit_size = data.GetU64 (&offset);
+        const uint64_t alignment = data.GetU64 (&offset);
+        const uint32_t num_fields = data.GetU32 (&offset);
+        if (!data.ValidOffsetForDataOfSize (offset, num_fields * 12))
+            break;
+        CachedRecordLayout &layout = m_cached_record_layouts[die_offset];
+        layout.bit_size = bit_size;
+        layout.alignment = alignment;
+        layout.field_bit_offsets.resize (num_fields);
+        for (uint32_t field_idx=0; field_idx<num_fields; ++field_idx)
+        {
+            layout.field_bit_offsets[field_idx].first = data.GetU32 (&offset);
+            layout.field_bit_offsets[field_idx].second = data.GetU64 (&offset);
+        }
+    }
+}
+
+void
+SymbolFileDWARF::EncodeRecordLayouts (std::string &data)
+{
+    StreamString strm (Stream::eBinary, sizeof(void *), lldb::endian::InlHostByteOrder());
+    strm.PutHex32 (m_cached_record_layouts.size());
+    DIEOffsetToCachedRecordLayout::const_iterator pos, end = m_cached_record_layouts.end();
+    for (pos = m_cached_record_layouts.begin(); pos != end; ++pos)
+    {
+        strm.PutHex32 (pos->first);
+        strm.PutHex64 (pos->second.bit_size);
+        strm.PutHex64 (pos->second.alignment);
+        const size_t num_fields = pos->second.field_bit_offsets.size();
+        strm.PutHex32 (num_fields);
+        for (size_t field_idx=0; field_idx<num_fields; ++field_idx)
+        {
+            strm.PutHex32 (pos->second.field_bit_offsets[field_idx].first);
+            strm.PutHex64 (pos->second.field_bit_offsets[field_idx].second);
+        }
+    }
+    data.swap (strm.GetString());
+}
+
+bool
+SymbolFileDWARF::GetCachedRecordLayout (const DWARFDebugInfoEntry *die, CachedRecordLayout &layout)
+{
+    LoadRecordLayoutsFromCache ();
+    DIEOffsetToCachedRecordLayout::const_iterator pos = m_cached_record_layouts.find (die->GetOffset());
+    if (pos == m_cached_record_layouts.end())
+        return false;
+    layout = pos->second;
+    return true;
+}
+
+void
+SymbolFileDWARF::AddCachedRecordLayout (const DWARFDebugInfoEntry *die,
+                                        const clang::RecordDecl *record_decl,
+                                        const LayoutInfo &layout_info)
+{
+    Module *module = GetObjectFile()->GetModule().get();
+    if (!IndexCache::IsEnabledForModule (module))
+        return;
+
+    LoadRecordLayoutsFromCache ();
+    CachedRecordLayout &layout = m_cached_record_layouts[die->GetOffset()];
+    layout.bit_size = layout_info.bit_size;
+    layout.alignment = layout_info.alignment;
+    layout.field_bit_offsets.clear();
+    // ParseChildMembers() tags each field with the user ID of its member DIE
+    ClangASTContext &ast = GetClangASTContext();
+    clang::RecordDecl::field_iterator field_pos, field_end = record_decl->field_end();
+    for (field_pos = record_decl->field_begin(); field_pos != field_end; ++field_pos)
+    {
+        llvm::DenseMap <const clang::FieldDecl *, uint64_t>::const_iterator offset_pos = layout_info.field_offsets.find (*field_pos);
+        if (offset_pos == layout_info.field_offsets.end())
+            continue;
+        const lldb::user_id_t member_uid = ast.GetMetadata ((uintptr_t)*field_pos);
+        if (member_uid == 0 || !UserIDMatches (member_uid))
+            continue;
+        layout.field_bit_offsets.push_back (CachedRecordLayout::FieldBitOffset ((dw_offset_t)member_uid, offset_pos->second));
+    }
+    std::sort (layout.field_bit_offsets.begin(), layout.field_bit_offsets.end());
+    m_record_layouts_changed = true;
+}
+
+void
+SymbolFileDWARF::SaveToIndexCache (Module *module)
+{
+    if (!m_record_layouts_changed)
+        return;
+    m_record_layouts_changed = false;
+    std::string data;
+    EncodeRecordLayouts (data);
+    IndexCache::Save (module, "dwarf-record-layouts", DWARF_RECORD_LAYOUTS_CACHE_VERSION, data);
+}
+
 bool
 SymbolFileDWARF::NamespaceDeclMatchesThisSymbolFile (const ClangNamespaceDecl *namespace_decl)
 {
@@ -2798,6 +3762,9 @@ SymbolFileDWARF::FindGlobalVariables (const ConstString &name, const lldb_privat
         bool done = false;
         for (size_t i=0; i<num_die_matches && !done; ++i)
         {
+            if (AsyncOperation::ShouldCancel())
+                break;
+
             const dw_offset_t die_offset = die_offsets[i];
             die = debug_info->GetDIEPtrWithCompileUnitHint (die_offset, &dwarf_cu);
 
@@ -2959,6 +3926,11 @@ SymbolFileDWARF::ResolveFunction (DWARFCompileUnit *cu,
     if (die == NULL)
         return false;
 
+    // Each match can pull in a lot of DWARF, so a lookup done for an
+    // operation that was cancelled stops here with what it has so far
+    if (AsyncOperation::ShouldCancel())
+        return false;
+
     // If we were passed a die that is not a function, just return false...
     if (die->Tag() != DW_TAG_subprogram && die->Tag() != DW_TAG_inlined_subroutine)
         return false;
@@ -2981,7 +3953,7 @@ SymbolFileDWARF::ResolveFunction (DWARFCompileUnit *cu,
         // Parse all blocks if needed
         if (inlined_die)
         {
-            sc.block = sc.function->GetBlock (true).FindBlockByID (MakeUserID(inlined_die->GetOffset()));
+            sc.block = sc.function->FindBlockByID (MakeUserID(inlined_die->GetOffset()));
             assert (sc.block != NULL);
             if (sc.block->GetStartAddress (addr) == false)
                 addr.Clear();
@@ -3577,6 +4549,9 @@ SymbolFileDWARF::FindTypes (const SymbolContext& sc,
         DWARFDebugInfo* debug_info = DebugInfo();
         for (size_t i=0; i<num_die_matches; ++i)
         {
+            if (AsyncOperation::ShouldCancel())
+                break;
+
             const dw_offset_t die_offset = die_offsets[i];
             die = debug_info->GetDIEPtrWithCompileUnitHint (die_offset, &dwarf_cu);
 
@@ -4505,82 +5480,67 @@ SymbolFileDWARF::DIEDeclContextsMatch (DWARFCompileUnit* cu1, const DWARFDebugIn
     assert (DebugInfo()->ContainsCompileUnit (cu2));
 #endif
 
-    DWARFDIECollection decl_ctx_1;
-    DWARFDIECollection decl_ctx_2;
-    //The declaration DIE stack is a stack of the declaration context 
-    // DIEs all the way back to the compile unit. If a type "T" is
-    // declared inside a class "B", and class "B" is declared inside
-    // a class "A" and class "A" is in a namespace "lldb", and the
-    // namespace is in a compile unit, there will be a stack of DIEs:
-    //
-    //   [0] DW_TAG_class_type for "B"
-    //   [1] DW_TAG_class_type for "A"
-    //   [2] DW_TAG_namespace  for "lldb"
-    //   [3] DW_TAG_compile_unit for the source file.
-    // 
-    // We grab both contexts and make sure that everything matches 
-    // all the way back to the compiler unit.
-    
-    // First lets grab the decl contexts for both DIEs
-    die1->GetDeclContextDIEs (this, cu1, decl_ctx_1);
-    die2->GetDeclContextDIEs (this, cu2, decl_ctx_2);
-    // Make sure the context arrays have the same size, otherwise
-    // we are done
-    const size_t count1 = decl_ctx_1.Size();
-    const size_t count2 = decl_ctx_2.Size();
-    if (count1 != count2)
-        return false;
-    
-    // Make sure the DW_TAG values match all the way back up the the
-    // compile unit. If they don't, then we are done.
-    const DWARFDebugInfoEntry *decl_ctx_die1;
-    const DWARFDebugInfoEntry *decl_ctx_die2;
-    size_t i;
-    for (i=0; i<count1; i++)
-    {
-        decl_ctx_die1 = decl_ctx_1.GetDIEPtrAtIndex (i);
-        decl_ctx_die2 = decl_ctx_2.GetDIEPtrAtIndex (i);
-        if (decl_ctx_die1->Tag() != decl_ctx_die2->Tag())
-            return false;
+    // The declaration context IDs are interned, two DIEs are declared in
+    // the same context if their parent contexts have the same ID. If a
+    // type "T" is declared inside a class "B", and class "B" is declared
+    // inside a class "A" and class "A" is in a namespace "lldb", both
+    // contexts must be "lldb::A::B" with the same tags all the way back
+    // to the compile unit.
+    const uint32_t decl_ctx_id1 = GetDeclContextID (cu1, die1);
+    const uint32_t decl_ctx_id2 = GetDeclContextID (cu2, die2);
+    return m_decl_ctx_nodes[decl_ctx_id1].parent_id == m_decl_ctx_nodes[decl_ctx_id2].parent_id;
+}
+
+uint32_t
+SymbolFileDWARF::GetDeclContextID (DWARFCompileUnit *cu, const DWARFDebugInfoEntry *die)
+{
+    if (m_decl_ctx_nodes.empty())
+    {
+        // ID zero is the compile unit that all contexts end at
+        DeclContextNode root_node = { DW_TAG_compile_unit, NULL, 0 };
+        m_decl_ctx_nodes.push_back (root_node);
     }
-#if defined LLDB_CONFIGURATION_DEBUG
 
-    // Make sure the top item in the decl context die array is always 
-    // DW_TAG_compile_unit. If it isn't then something went wrong in
-    // the DWARFDebugInfoEntry::GetDeclContextDIEs() function...
-    assert (decl_ctx_1.GetDIEPtrAtIndex (count1 - 1)->Tag() == DW_TAG_compile_unit);
+    if (die == NULL || die->Tag() == DW_TAG_compile_unit)
+        return 0;
 
-#endif
-    // Always skip the compile unit when comparing by only iterating up to
-    // "count - 1". Here we compare the names as we go. 
-    for (i=0; i<count1 - 1; i++)
-    {
-        decl_ctx_die1 = decl_ctx_1.GetDIEPtrAtIndex (i);
-        decl_ctx_die2 = decl_ctx_2.GetDIEPtrAtIndex (i);
-        const char *name1 = decl_ctx_die1->GetName(this, cu1);
-        const char *name2 = decl_ctx_die2->GetName(this, cu2);
-        // If the string was from a DW_FORM_strp, then the pointer will often
-        // be the same!
-        if (name1 == name2)
-            continue;
+    const dw_offset_t die_offset = die->GetOffset();
+    DIEOffsetToDeclContextID::const_iterator pos = m_die_offset_to_decl_ctx_id.find (die_offset);
+    if (pos != m_die_offset_to_decl_ctx_id.end())
+        return pos->second;
+
+    uint32_t parent_id = 0;
+    const DWARFDebugInfoEntry *parent_decl_ctx_die = die->GetParentDeclContextDIE (this, cu);
+    if (parent_decl_ctx_die && parent_decl_ctx_die != die)
+        parent_id = GetDeclContextID (cu, parent_decl_ctx_die);
+
+    DeclContextNode node = { die->Tag(), ConstString (die->GetName (this, cu)).GetCString(), parent_id };
+    uint32_t decl_ctx_id;
+    DeclContextNodeToID::const_iterator node_pos = m_decl_ctx_node_to_id.find (node);
+    if (node_pos != m_decl_ctx_node_to_id.end())
+        decl_ctx_id = node_pos->second;
+    else
+    {
+        decl_ctx_id = m_decl_ctx_nodes.size();
+        m_decl_ctx_nodes.push_back (node);
+        m_decl_ctx_node_to_id[node] = decl_ctx_id;
+    }
+    m_die_offset_to_decl_ctx_id[die_offset] = decl_ctx_id;
+    return decl_ctx_id;
+}
 
-        // Name pointers are not equal, so only compare the strings
-        // if both are not NULL.
-        if (name1 && name2)
-        {
-            // If the strings don't compare, we are done...
-            if (strcmp(name1, name2) != 0)
-                return false;
-        }
-        else
-        {
-            // One name was NULL while the other wasn't
-            return false;
-        }
+void
+SymbolFileDWARF::GetDWARFDeclContext (DWARFCompileUnit *cu,
+                                      const DWARFDebugInfoEntry *die,
+                                      DWARFDeclContext &dwarf_decl_ctx)
+{
+    // Same result as DWARFDebugInfoEntry::GetDWARFDeclContext(), built from
+    // the cached context chain instead of parsing all of the parent DIEs
+    for (uint32_t decl_ctx_id = GetDeclContextID (cu, die); decl_ctx_id != 0; decl_ctx_id = m_decl_ctx_nodes[decl_ctx_id].parent_id)
+    {
+        const DeclContextNode &node = m_decl_ctx_nodes[decl_ctx_id];
+        dwarf_decl_ctx.AppendDeclContext (node.tag, node.name);
     }
-    // We made it through all of the checks and the declaration contexts
-    // are equal.
-    return true;
 }
                                           
 // This function can be used when a DIE is found that is a forward declaration
@@ -4849,7 +5809,7 @@ SymbolFileDWARF::FindDefinitionTypeForDWARFDeclContext (const DWARFDeclContext &
                         if (try_resolving_type)
                         {
                             DWARFDeclContext type_dwarf_decl_ctx;
-                            type_die->GetDWARFDeclContext (this, type_cu, type_dwarf_decl_ctx);
+                            GetDWARFDeclContext (type_cu, type_die, type_dwarf_decl_ctx);
 
                             if (log)
                             {
@@ -5481,7 +6441,7 @@ SymbolFileDWARF::ParseType (const SymbolContext& sc, DWARFCompileUnit* dwarf_cu,
                         }
                     
                         DWARFDeclContext die_decl_ctx;
-                        die->GetDWARFDeclContext(this, dwarf_cu, die_decl_ctx);
+                        GetDWARFDeclContext (dwarf_cu, die, die_decl_ctx);
 
                         //type_sp = FindDefinitionTypeForDIE (dwarf_cu, die, type_name_const_str);
                         type_sp = FindDefinitionTypeForDWARFDeclContext (die_decl_ctx);
@@ -6296,7 +7256,7 @@ SymbolFileDWARF::ParseType (const SymbolContext& sc, DWARFCompileUnit* dwarf_cu,
                 }
                 else if (sc.function != NULL)
                 {
-                    symbol_context_scope = sc.function->GetBlock(true).FindBlockByID(MakeUserID(sc_parent_die->GetOffset()));
+                    symbol_context_scope = sc.function->FindBlockByID (MakeUserID(sc_parent_die->GetOffset()));
                     if (symbol_context_scope == NULL)
                         symbol_context_scope = sc.function;
                 }
@@ -6434,6 +7394,21 @@ SymbolFileDWARF::ParseVariablesForContext (const SymbolContext& sc)
             dw_addr_t func_lo_pc = function_die->GetAttributeValueAsUnsigned (this, dwarf_cu, DW_AT_low_pc, DW_INVALID_ADDRESS);
             if (func_lo_pc != DW_INVALID_ADDRESS)
             {
+                // When asked for the variables of one block, only parse
+                // the variables that are directly in it. Functions can have
+                // thousands of nested scopes and usually only the few that
+                // contain the PC are wanted.
+                if (sc.block)
+                {
+                    const DWARFDebugInfoEntry *block_die = dwarf_cu->GetDIEPtr(sc.block->GetID());
+                    if (block_die)
+                    {
+                        const size_t num_variables = ParseVariables(sc, dwarf_cu, func_lo_pc, block_die->GetFirstChild(), true, false);
+                        sc.block->SetDidParseVariables (true, false);
+                        return num_variables;
+                    }
+                }
+
                 const size_t num_variables = ParseVariables(sc, dwarf_cu, func_lo_pc, function_die->GetFirstChild(), true, true);
             
                 // Let all blocks know they have parse all their variables
@@ -6735,7 +7710,7 @@ SymbolFileDWARF::ParseVariableDIE
                     case DW_TAG_lexical_block:
                         if (sc.function)
                         {
-                            symbol_context_scope = sc.function->GetBlock(true).FindBlockByID(MakeUserID(sc_parent_die->GetOffset()));
+                            symbol_context_scope = sc.function->FindBlockByID (MakeUserID(sc_parent_die->GetOffset()));
                             if (symbol_context_scope == NULL)
                                 symbol_context_scope = sc.function;
                         }
@@ -6917,7 +7892,7 @@ SymbolFileDWARF::ParseVariables
                             {
                                 // Check to see if we already have parsed the variables for the given scope
                                 
-                                Block *block = sc.function->GetBlock(true).FindBlockByID(MakeUserID(sc_parent_die->GetOffset()));
+                                Block *block = sc.function->FindBlockByID (MakeUserID(sc_parent_die->GetOffset()));
                                 if (block == NULL)
                                 {
                                     // This must be a specification or abstract origin with 
@@ -6929,7 +7904,7 @@ SymbolFileDWARF::ParseVariables
                                                                                                                       sc_parent_die->GetOffset(), 
                                                                                                                       &concrete_block_die_cu);
                                     if (concrete_block_die)
-                                        block = sc.function->GetBlock(true).FindBlockByID(MakeUserID(concrete_block_die->GetOffset()));
+                                        block = sc.function->FindBlockByID (MakeUserID(concrete_block_die->GetOffset()));
                                 }
                                 
                                 if (block != NULL)
@@ -7009,7 +7984,16 @@ SymbolFileDWARF::CompleteTagDecl (void *baton, clang::TagDecl *decl)
     SymbolFileDWARF *symbol_file_dwarf = (SymbolFileDWARF *)baton;
     clang_type_t clang_type = symbol_file_dwarf->GetClangASTContext().GetTypeForDecl (decl);
     if (clang_type)
-        symbol_file_dwarf->ResolveClangOpaqueTypeDefinition (clang_type);
+    {
+        if (symbol_file_dwarf->HasForwardDeclForClangType (clang_type))
+            symbol_file_dwarf->ResolveClangOpaqueTypeDefinition (clang_type);
+        else if (symbol_file_dwarf->m_shared_type_ast)
+        {
+            // The declaration came along with a type definition that we
+            // imported from another module
+            UniqueDWARFASTTypeFingerprintMap::GetSharedMap().CompleteImportedTagDecl (decl);
+        }
+    }
 }
 
 void
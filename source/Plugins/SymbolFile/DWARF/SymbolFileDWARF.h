@@ -12,6 +12,7 @@
 
 // C Includes
 // C++ Includes
+#include <algorithm>
 #include <list>
 #include <memory>
 #include <map>
@@ -30,6 +31,7 @@
 #include "lldb/Core/DataExtractor.h"
 #include "lldb/Core/Flags.h"
 #include "lldb/Core/UniqueCStringMap.h"
+#include "lldb/Host/Mutex.h"
 #include "lldb/Symbol/ClangASTContext.h"
 #include "lldb/Symbol/SymbolFile.h"
 #include "lldb/Symbol/SymbolContext.h"
@@ -120,8 +122,12 @@ public:
     virtual uint32_t        FindTypes (const lldb_private::SymbolContext& sc, const lldb_private::ConstString &name, const lldb_private::ClangNamespaceDecl *namespace_decl, bool append, uint32_t max_matches, lldb_private::TypeList& types);
     virtual lldb_private::TypeList *
                             GetTypeList ();
+    virtual void            PreloadSymbols ();
+    virtual void            SaveToIndexCache (lldb_private::Module *module);
+    virtual bool            AppendLookupNames (std::vector<const char *> &names);
     virtual lldb_private::ClangASTContext &
                             GetClangASTContext ();
+    virtual lldb::ModuleSP  GetClangASTModule ();
 
     virtual lldb_private::ClangNamespaceDecl
             FindNamespace (const lldb_private::SymbolContext& sc, 
@@ -177,6 +183,36 @@ public:
 //        llvm::DenseMap <const clang::CXXRecordDecl *, clang::CharUnits> base_offsets;
 //        llvm::DenseMap <const clang::CXXRecordDecl *, clang::CharUnits> vbase_offsets;
     };
+
+    // A record layout saved in the index cache. The field offsets are
+    // keyed by the DW_TAG_member DIE offset and sorted by it, fields
+    // without a location aren't in it.
+    struct CachedRecordLayout
+    {
+        typedef std::pair<dw_offset_t, uint64_t> FieldBitOffset;
+
+        CachedRecordLayout () :
+            bit_size(0),
+            alignment(0),
+            field_bit_offsets()
+        {
+        }
+
+        bool
+        FindFieldBitOffset (dw_offset_t member_die_offset, uint64_t &bit_offset) const
+        {
+            std::vector<FieldBitOffset>::const_iterator pos;
+            pos = std::lower_bound (field_bit_offsets.begin(), field_bit_offsets.end(), FieldBitOffset (member_die_offset, 0));
+            if (pos == field_bit_offsets.end() || pos->first != member_die_offset)
+                return false;
+            bit_offset = pos->second;
+            return true;
+        }
+
+        uint64_t bit_size;
+        uint64_t alignment;
+        std::vector<FieldBitOffset> field_bit_offsets;
+    };
     //------------------------------------------------------------------
     // PluginInterface protocol
     //------------------------------------------------------------------
@@ -208,6 +244,7 @@ public:
     const lldb_private::DataExtractor&      get_apple_types_data ();
     const lldb_private::DataExtractor&      get_apple_namespaces_data ();
     const lldb_private::DataExtractor&      get_apple_objc_data ();
+    const lldb_private::DataExtractor&      get_debug_names_data ();
 
 
     DWARFDebugAbbrev*       DebugAbbrev();
@@ -292,7 +329,8 @@ protected:
         flagsGotAppleNamesData      = (1 << 11),
         flagsGotAppleTypesData      = (1 << 12),
         flagsGotAppleNamespacesData = (1 << 13),
-        flagsGotAppleObjCData       = (1 << 14)
+        flagsGotAppleObjCData       = (1 << 14),
+        flagsGotDebugNamesData      = (1 << 15)
     };
     
     bool                    NamespaceDeclMatchesThisSymbolFile (const lldb_private::ClangNamespaceDecl *namespace_decl);
@@ -348,7 +386,8 @@ protected:
                                 DelayedPropertyList& delayed_properties,
                                 lldb::AccessType &default_accessibility,
                                 bool &is_a_class,
-                                LayoutInfo &layout_info);
+                                LayoutInfo &layout_info,
+                                const CachedRecordLayout *cached_layout);
 
     size_t                  ParseChildParameters(
                                 const lldb_private::SymbolContext& sc,
@@ -439,6 +478,31 @@ protected:
     uint32_t                FindTypes(std::vector<dw_offset_t> die_offsets, uint32_t max_matches, lldb_private::TypeList& types);
 
     void                    Index();
+
+    bool                    IndexFromDebugNames ();
+
+    bool                    LoadIndexFromCache ();
+
+    void                    SaveIndexToCache ();
+
+    void                    IndexLineTables ();
+
+    void                    BuildLineIndex ();
+
+    bool                    LoadLineIndexFromCache ();
+
+    void                    SaveLineIndexToCache ();
+
+    void                    LoadRecordLayoutsFromCache ();
+
+    void                    EncodeRecordLayouts (std::string &data);
+
+    bool                    GetCachedRecordLayout (const DWARFDebugInfoEntry *die,
+                                                   CachedRecordLayout &layout);
+
+    void                    AddCachedRecordLayout (const DWARFDebugInfoEntry *die,
+                                                   const clang::RecordDecl *record_decl,
+                                                   const LayoutInfo &layout_info);
     
     void                    DumpIndexes();
 
@@ -467,6 +531,35 @@ protected:
     UniqueDWARFASTTypeMap &
     GetUniqueDWARFASTTypeMap ();
 
+    //------------------------------------------------------------------
+    // Structural hash of a class, struct or union DIE and all of its
+    // children that is the same for identical definitions in different
+    // modules.
+    //------------------------------------------------------------------
+    uint64_t
+    ComputeTypeFingerprint (DWARFCompileUnit *dwarf_cu,
+                            const DWARFDebugInfoEntry *die);
+
+    void
+    AddDIEToTypeFingerprint (DWARFCompileUnit *dwarf_cu,
+                             const DWARFDebugInfoEntry *die,
+                             uint32_t depth,
+                             uint64_t &fingerprint);
+
+    void
+    AddTypeReferenceToTypeFingerprint (dw_offset_t die_offset,
+                                       uint32_t depth,
+                                       uint64_t &fingerprint);
+
+    bool
+    ImportSharedTypeDefinition (uint64_t fingerprint,
+                                lldb::clang_type_t clang_type);
+
+    void
+    AddSharedTypeDefinition (uint64_t fingerprint,
+                             lldb::clang_type_t clang_type,
+                             const LayoutInfo &layout_info);
+
     void                    LinkDeclContextToDIE (clang::DeclContext *decl_ctx,
                                                   const DWARFDebugInfoEntry *die)
                             {
@@ -524,6 +617,20 @@ protected:
     bool
     DIEDeclContextsMatch (DWARFCompileUnit* cu1, const DWARFDebugInfoEntry *die1,
                           DWARFCompileUnit* cu2, const DWARFDebugInfoEntry *die2);
+
+    //------------------------------------------------------------------
+    // Get the interned ID of the declaration context made up of "die"
+    // and all of its parent declaration contexts. DIEs with the same
+    // tag and name that are declared in the same context get the same
+    // ID. Zero is the compile unit.
+    //------------------------------------------------------------------
+    uint32_t
+    GetDeclContextID (DWARFCompileUnit *cu, const DWARFDebugInfoEntry *die);
+
+    void
+    GetDWARFDeclContext (DWARFCompileUnit *cu,
+                         const DWARFDebugInfoEntry *die,
+                         DWARFDeclContext &dwarf_decl_ctx);
     
     bool
     ClassContainsSelector (DWARFCompileUnit *dwarf_cu,
@@ -554,6 +661,7 @@ protected:
     lldb_private::DataExtractor     m_data_apple_types;
     lldb_private::DataExtractor     m_data_apple_namespaces;
     lldb_private::DataExtractor     m_data_apple_objc;
+    lldb_private::DataExtractor     m_data_debug_names;
 
     // The auto_ptr items below are generated on demand if and when someone accesses
     // them through a non const version of this class.
@@ -572,9 +680,14 @@ protected:
     NameToDIE                           m_global_index;             // Global and static variables
     NameToDIE                           m_type_index;               // All type DIE offsets
     NameToDIE                           m_namespace_index;          // All type DIE offsets
+    NameToDIE                           m_file_line_index;          // File base names to indexes of compile units that have line table rows for them
+    lldb_private::Mutex                 m_line_index_mutex;         // Held while m_file_line_index is being built
+    bool                                m_line_indexed;             // Not a bitfield so it can be set under m_line_index_mutex alone
     bool                                m_indexed:1,
                                         m_is_external_ast_source:1,
-                                        m_using_apple_tables:1;
+                                        m_using_apple_tables:1,
+                                        m_record_layouts_loaded:1,
+                                        m_record_layouts_changed:1;
     lldb_private::LazyBool              m_supports_DW_AT_APPLE_objc_complete_type;
 
     std::auto_ptr<DWARFDebugRanges>     m_ranges;
@@ -594,6 +707,31 @@ protected:
     DIEToClangType m_forward_decl_die_to_clang_type;
     ClangTypeToDIE m_forward_decl_clang_type_to_die;
     RecordDeclToLayoutMap m_record_decl_to_layout_map;
+    typedef llvm::DenseMap<dw_offset_t, CachedRecordLayout> DIEOffsetToCachedRecordLayout;
+    DIEOffsetToCachedRecordLayout m_cached_record_layouts;  // Layouts of completed records, saved in the index cache
+
+    struct DeclContextNode
+    {
+        dw_tag_t tag;
+        const char *name;   // Uniqued with ConstString
+        uint32_t parent_id;
+
+        bool
+        operator< (const DeclContextNode &rhs) const
+        {
+            if (parent_id != rhs.parent_id)
+                return parent_id < rhs.parent_id;
+            if (tag != rhs.tag)
+                return tag < rhs.tag;
+            return name < rhs.name;
+        }
+    };
+    typedef std::map<DeclContextNode, uint32_t> DeclContextNodeToID;
+    typedef llvm::DenseMap<dw_offset_t, uint32_t> DIEOffsetToDeclContextID;
+    std::vector<DeclContextNode> m_decl_ctx_nodes;
+    DeclContextNodeToID m_decl_ctx_node_to_id;
+    DIEOffsetToDeclContextID m_die_offset_to_decl_ctx_id;
+    clang::ASTContext *m_shared_type_ast;   // Our AST if it has put or got types from UniqueDWARFASTTypeFingerprintMap::GetSharedMap()
 };
 
 #endif  // SymbolFileDWARF_SymbolFileDWARF_h_
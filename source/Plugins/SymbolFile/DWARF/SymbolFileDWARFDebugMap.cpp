@@ -9,6 +9,10 @@
 
 #include "SymbolFileDWARFDebugMap.h"
 
+#include <ctype.h>
+#include <algorithm>
+
+#include "lldb/Core/Mangled.h"
 #include "lldb/Core/Module.h"
 #include "lldb/Core/ModuleList.h"
 #include "lldb/Core/PluginManager.h"
@@ -31,6 +35,10 @@
 using namespace lldb;
 using namespace lldb_private;
 
+// The maximum number of .o files that searches may keep open without
+// finding anything in them.
+#define DEBUG_MAP_MAX_UNPINNED_OSO_MODULES  256
+
 // Subclass lldb_private::Module so we can intercept the "Module::GetObjectFile()" 
 // (so we can fixup the object file sections) and also for "Module::GetSymbolVendor()"
 // (so we can fixup the symbol file id.
@@ -425,7 +433,7 @@ SymbolFileDWARFDebugMap::GetModuleByOSOIndex (uint32_t oso_idx)
 }
 
 Module *
-SymbolFileDWARFDebugMap::GetModuleByCompUnitInfo (CompileUnitInfo *comp_unit_info)
+SymbolFileDWARFDebugMap::GetModuleByCompUnitInfo (CompileUnitInfo *comp_unit_info, bool pin)
 {
     if (comp_unit_info->oso_module_sp.get() == NULL && comp_unit_info->symbol_file_supported)
     {
@@ -456,7 +464,14 @@ SymbolFileDWARFDebugMap::GetModuleByCompUnitInfo (CompileUnitInfo *comp_unit_inf
                                                                  m_obj_file->GetModule()->GetArchitecture(),
                                                                  comp_unit_info->oso_object ? &comp_unit_info->oso_object : NULL,
                                                                  0));
+        if (!pin)
+        {
+            m_unpinned_oso_indexes.push_back (GetCompUnitInfoIndex(comp_unit_info));
+            TrimUnpinnedOSOModules ();
+        }
     }
+    if (pin && comp_unit_info->oso_module_sp)
+        PinOSOIndex (GetCompUnitInfoIndex(comp_unit_info));
     return comp_unit_info->oso_module_sp.get();
 }
 
@@ -539,6 +554,213 @@ SymbolFileDWARFDebugMap::GetSymbolFileByCompUnitInfo (CompileUnitInfo *comp_unit
     return NULL;
 }
 
+SymbolFileDWARF *
+SymbolFileDWARFDebugMap::GetSymbolFileForSearchByOSOIndex (uint32_t oso_idx)
+{
+    if (oso_idx >= m_compile_unit_infos.size())
+        return NULL;
+
+    CompileUnitInfo *comp_unit_info = &m_compile_unit_infos[oso_idx];
+    if (comp_unit_info->oso_module_sp && !comp_unit_info->oso_module_pinned)
+    {
+        // Mark the .o file as the most recently used one
+        std::vector<uint32_t>::iterator pos = std::find (m_unpinned_oso_indexes.begin(), m_unpinned_oso_indexes.end(), oso_idx);
+        if (pos != m_unpinned_oso_indexes.end())
+            m_unpinned_oso_indexes.erase (pos);
+        m_unpinned_oso_indexes.push_back (oso_idx);
+    }
+
+    Module *oso_module = GetModuleByCompUnitInfo (comp_unit_info, false);
+    if (oso_module)
+    {
+        SymbolVendor *sym_vendor = oso_module->GetSymbolVendor();
+        if (sym_vendor)
+            return (SymbolFileDWARF *)sym_vendor->GetSymbolFile();
+    }
+    return NULL;
+}
+
+void
+SymbolFileDWARFDebugMap::PinOSOIndex (uint32_t oso_idx)
+{
+    if (oso_idx >= m_compile_unit_infos.size() || m_compile_unit_infos[oso_idx].oso_module_pinned)
+        return;
+    m_compile_unit_infos[oso_idx].oso_module_pinned = true;
+    std::vector<uint32_t>::iterator pos = std::find (m_unpinned_oso_indexes.begin(), m_unpinned_oso_indexes.end(), oso_idx);
+    if (pos != m_unpinned_oso_indexes.end())
+        m_unpinned_oso_indexes.erase (pos);
+}
+
+void
+SymbolFileDWARFDebugMap::TrimUnpinnedOSOModules ()
+{
+    // Nothing that outlives a search refers to a .o file that isn't
+    // pinned, so the least recently used ones can be closed. They get
+    // opened again if a later search needs them.
+    while (m_unpinned_oso_indexes.size() > DEBUG_MAP_MAX_UNPINNED_OSO_MODULES)
+    {
+        const uint32_t oso_idx = m_unpinned_oso_indexes.front();
+        m_unpinned_oso_indexes.erase (m_unpinned_oso_indexes.begin());
+        m_compile_unit_infos[oso_idx].oso_module_sp.reset();
+    }
+}
+
+ConstString
+SymbolFileDWARFDebugMap::GetOSONameKey (const char *name, bool is_function)
+{
+    // Reduce a name to the part that any name that can match it in the
+    // DWARF must have in common with it: the base name of a C or C++
+    // function or variable without namespaces, classes, arguments or
+    // template arguments, or the selector of an ObjC method. If we
+    // can't do that we return an empty string and callers must search
+    // every .o file.
+    if (name == NULL || name[0] == '\0')
+        return ConstString();
+
+    ConstString demangled;
+    if (name[0] == '_' && name[1] == 'Z')
+    {
+        Mangled mangled (ConstString(name), true);
+        demangled = mangled.GetDemangledName();
+        if (!demangled)
+            return ConstString();
+        name = demangled.GetCString();
+    }
+
+    if ((name[0] == '-' || name[0] == '+') && name[1] == '[')
+    {
+        const char *selector_start = ::strchr (name, ' ');
+        const char *selector_end = ::strrchr (name, ']');
+        if (selector_start == NULL || selector_end == NULL || selector_end <= selector_start + 1)
+            return ConstString();
+        return ConstString (selector_start + 1, selector_end - selector_start - 1);
+    }
+
+    // Operator names and lambdas are too hard to take apart
+    if (::strstr (name, "operator") != NULL || ::strchr (name, '{') != NULL)
+        return ConstString();
+
+    // Find the last top level argument list and the start of the last
+    // top level name component.
+    const char *base_name_start = name;
+    const char *args_start = NULL;
+    const char *name_end = name + ::strlen (name);
+    int template_depth = 0;
+    int paren_depth = 0;
+    for (const char *p = name; p < name_end; ++p)
+    {
+        switch (*p)
+        {
+        case '<':
+            ++template_depth;
+            break;
+        case '>':
+            if (template_depth > 0)
+                --template_depth;
+            break;
+        case '(':
+            if (template_depth == 0 && paren_depth == 0)
+                args_start = p;
+            ++paren_depth;
+            break;
+        case ')':
+            if (paren_depth > 0)
+                --paren_depth;
+            break;
+        case ':':
+            if (template_depth == 0 && paren_depth == 0 && p[1] == ':')
+            {
+                base_name_start = p + 2;
+                ++p;
+            }
+            break;
+        }
+    }
+
+    const char *base_name_end = name_end;
+    if (is_function && args_start != NULL && args_start > base_name_start)
+        base_name_end = args_start;
+
+    // Strip any template arguments
+    if (base_name_end > base_name_start && base_name_end[-1] == '>')
+    {
+        template_depth = 0;
+        while (--base_name_end > base_name_start)
+        {
+            if (*base_name_end == '>')
+                ++template_depth;
+            else if (*base_name_end == '<' && --template_depth == 0)
+                break;
+        }
+    }
+
+    if (base_name_end <= base_name_start)
+        return ConstString();
+    for (const char *p = base_name_start; p < base_name_end; ++p)
+    {
+        // Single colons are allowed so that ObjC selectors that are
+        // looked up on their own are keyed the same way as the methods
+        if (!isalnum(*p) && *p != '_' && *p != '$' && *p != '~' && *p != ':')
+            return ConstString();
+    }
+    return ConstString (base_name_start, base_name_end - base_name_start);
+}
+
+void
+SymbolFileDWARFDebugMap::IndexOSONames ()
+{
+    if (m_flags.test(kHaveIndexedOSONames))
+        return;
+    m_flags.set(kHaveIndexedOSONames);
+
+    Timer scoped_timer (__PRETTY_FUNCTION__, "%s", __PRETTY_FUNCTION__);
+    Symtab *symtab = m_obj_file->GetSymtab();
+    if (symtab == NULL || GetNumCompileUnits() == 0)
+        return;
+
+    // Every function and global variable that was linked into the
+    // executable has a debug map symbol that lies within the symbol
+    // range of the .o file that defines it.
+    for (uint32_t pass = 0; pass < 2; ++pass)
+    {
+        const bool is_function = pass == 0;
+        const std::vector<uint32_t> &symbol_indexes = is_function ? m_func_indexes : m_glob_indexes;
+        UniqueCStringMap<uint32_t> &name_index = is_function ? m_oso_function_name_index : m_oso_global_name_index;
+        const size_t num_symbols = symbol_indexes.size();
+        name_index.Reserve (num_symbols);
+        for (size_t i=0; i<num_symbols; ++i)
+        {
+            const Symbol *symbol = symtab->SymbolAtIndex (symbol_indexes[i]);
+            if (symbol == NULL)
+                continue;
+            uint32_t oso_idx = UINT32_MAX;
+            if (GetCompileUnitInfoForSymbolWithIndex (symbol_indexes[i], &oso_idx) == NULL)
+                continue;
+            ConstString key (GetOSONameKey (symbol->GetMangled().GetName().GetCString(), is_function));
+            if (key)
+                name_index.Append (key.GetCString(), oso_idx);
+        }
+        name_index.Sort();
+    }
+}
+
+bool
+SymbolFileDWARFDebugMap::FindOSOIndexesForName (const ConstString &name,
+                                                bool is_function,
+                                                std::vector<uint32_t> &oso_indexes)
+{
+    ConstString key (GetOSONameKey (name.GetCString(), is_function));
+    if (!key)
+        return false;
+
+    IndexOSONames ();
+    UniqueCStringMap<uint32_t> &name_index = is_function ? m_oso_function_name_index : m_oso_global_name_index;
+    name_index.GetValues (key.GetCString(), oso_indexes);
+    std::sort (oso_indexes.begin(), oso_indexes.end());
+    oso_indexes.erase (std::unique (oso_indexes.begin(), oso_indexes.end()), oso_indexes.end());
+    return true;
+}
+
 uint32_t
 SymbolFileDWARFDebugMap::CalculateAbilities ()
 {
@@ -859,10 +1081,35 @@ SymbolFileDWARFDebugMap::FindGlobalVariables (const ConstString &name, const Cla
     // we are appending the results to a variable list.
     const uint32_t original_size = variables.GetSize();
 
+    // Global variables that are defined in a .o file have a debug map
+    // symbol, but constants that were folded away don't. Those are only
+    // found in the .o files that are already open.
+    const uint32_t num_osos = GetNumCompileUnits();
+    std::vector<uint32_t> oso_indexes;
+    if (FindOSOIndexesForName (name, false, oso_indexes))
+    {
+        for (uint32_t oso_idx = 0; oso_idx < num_osos; ++oso_idx)
+        {
+            if (m_compile_unit_infos[oso_idx].oso_module_sp)
+                oso_indexes.push_back (oso_idx);
+        }
+        std::sort (oso_indexes.begin(), oso_indexes.end());
+        oso_indexes.erase (std::unique (oso_indexes.begin(), oso_indexes.end()), oso_indexes.end());
+    }
+    else
+    {
+        for (uint32_t oso_idx = 0; oso_idx < num_osos; ++oso_idx)
+            oso_indexes.push_back (oso_idx);
+    }
+
     uint32_t total_matches = 0;
-    SymbolFileDWARF *oso_dwarf;
-    for (uint32_t oso_idx = 0; ((oso_dwarf = GetSymbolFileByOSOIndex (oso_idx)) != NULL); ++oso_idx)
+    const size_t num_oso_indexes = oso_indexes.size();
+    for (size_t i=0; i<num_oso_indexes; ++i)
     {
+        const uint32_t oso_idx = oso_indexes[i];
+        SymbolFileDWARF *oso_dwarf = GetSymbolFileForSearchByOSOIndex (oso_idx);
+        if (oso_dwarf == NULL)
+            continue;
         const uint32_t oso_matches = oso_dwarf->FindGlobalVariables (name,
                                                                      namespace_decl,
                                                                      true, 
@@ -870,6 +1117,7 @@ SymbolFileDWARFDebugMap::FindGlobalVariables (const ConstString &name, const Cla
                                                                      variables);
         if (oso_matches > 0)
         {
+            PinOSOIndex (oso_idx);
             total_matches += oso_matches;
 
             // Are we getting all matches?
@@ -902,15 +1150,19 @@ SymbolFileDWARFDebugMap::FindGlobalVariables (const RegularExpression& regex, bo
     const uint32_t original_size = variables.GetSize();
 
     uint32_t total_matches = 0;
-    SymbolFileDWARF *oso_dwarf;
-    for (uint32_t oso_idx = 0; ((oso_dwarf = GetSymbolFileByOSOIndex (oso_idx)) != NULL); ++oso_idx)
+    const uint32_t num_osos = GetNumCompileUnits();
+    for (uint32_t oso_idx = 0; oso_idx < num_osos; ++oso_idx)
     {
+        SymbolFileDWARF *oso_dwarf = GetSymbolFileForSearchByOSOIndex (oso_idx);
+        if (oso_dwarf == NULL)
+            continue;
         const uint32_t oso_matches = oso_dwarf->FindGlobalVariables (regex, 
                                                                      true, 
                                                                      max_matches, 
                                                                      variables);
         if (oso_matches > 0)
         {
+            PinOSOIndex (oso_idx);
             total_matches += oso_matches;
 
             // Are we getting all matches?
@@ -1050,13 +1302,22 @@ SymbolFileDWARFDebugMap::FindFunctions(const ConstString &name, const ClangNames
     else
         sc_list.Clear();
 
-    uint32_t oso_idx = 0;
-    SymbolFileDWARF *oso_dwarf;
-    while ((oso_dwarf = GetSymbolFileByOSOIndex (oso_idx++)) != NULL)
+    // Every function that has code has a debug map symbol, so unless we
+    // want inlined functions we only need to look in the .o files with
+    // a symbol that matches the name.
+    std::vector<uint32_t> oso_indexes;
+    const bool use_name_index = !include_inlines && FindOSOIndexesForName (name, true, oso_indexes);
+    const uint32_t num_osos = use_name_index ? oso_indexes.size() : GetNumCompileUnits();
+    for (uint32_t i=0; i<num_osos; ++i)
     {
+        const uint32_t oso_idx = use_name_index ? oso_indexes[i] : i;
+        SymbolFileDWARF *oso_dwarf = GetSymbolFileForSearchByOSOIndex (oso_idx);
+        if (oso_dwarf == NULL)
+            continue;
         uint32_t sc_idx = sc_list.GetSize();
         if (oso_dwarf->FindFunctions(name, namespace_decl, name_type_mask, include_inlines, true, sc_list))
         {
+            PinOSOIndex (oso_idx);
             RemoveFunctionsWithModuleNotEqualTo (m_obj_file->GetModule(), sc_list, sc_idx);
         }
     }
@@ -1078,14 +1339,17 @@ SymbolFileDWARFDebugMap::FindFunctions (const RegularExpression& regex, bool inc
     else
         sc_list.Clear();
 
-    uint32_t oso_idx = 0;
-    SymbolFileDWARF *oso_dwarf;
-    while ((oso_dwarf = GetSymbolFileByOSOIndex (oso_idx++)) != NULL)
+    const uint32_t num_osos = GetNumCompileUnits();
+    for (uint32_t oso_idx = 0; oso_idx < num_osos; ++oso_idx)
     {
+        SymbolFileDWARF *oso_dwarf = GetSymbolFileForSearchByOSOIndex (oso_idx);
+        if (oso_dwarf == NULL)
+            continue;
         uint32_t sc_idx = sc_list.GetSize();
         
         if (oso_dwarf->FindFunctions(regex, include_inlines, true, sc_list))
         {
+            PinOSOIndex (oso_idx);
             RemoveFunctionsWithModuleNotEqualTo (m_obj_file->GetModule(), sc_list, sc_idx);
         }
     }
@@ -1247,8 +1511,11 @@ SymbolFileDWARFDebugMap::GetCompileUnit (SymbolFileDWARF *oso_dwarf)
         const uint32_t cu_count = GetNumCompileUnits();
         for (uint32_t cu_idx=0; cu_idx<cu_count; ++cu_idx)
         {
-            SymbolFileDWARF *oso_symfile = GetSymbolFileByCompUnitInfo (&m_compile_unit_infos[cu_idx]);
-            if (oso_symfile == oso_dwarf)
+            // "oso_dwarf" is open, so don't open any other .o files
+            // while we look for it
+            Module *oso_module = m_compile_unit_infos[cu_idx].oso_module_sp.get();
+            SymbolVendor *sym_vendor = oso_module ? oso_module->GetSymbolVendor() : NULL;
+            if (sym_vendor && sym_vendor->GetSymbolFile() == oso_dwarf)
             {
                 if (!m_compile_unit_infos[cu_idx].oso_compile_unit_sp)
                     m_compile_unit_infos[cu_idx].oso_compile_unit_sp = ParseCompileUnitAtIndex (cu_idx);
@@ -1270,8 +1537,11 @@ SymbolFileDWARFDebugMap::SetCompileUnit (SymbolFileDWARF *oso_dwarf, const CompU
         const uint32_t cu_count = GetNumCompileUnits();
         for (uint32_t cu_idx=0; cu_idx<cu_count; ++cu_idx)
         {
-            SymbolFileDWARF *oso_symfile = GetSymbolFileByCompUnitInfo (&m_compile_unit_infos[cu_idx]);
-            if (oso_symfile == oso_dwarf)
+            // "oso_dwarf" is open, so don't open any other .o files
+            // while we look for it
+            Module *oso_module = m_compile_unit_infos[cu_idx].oso_module_sp.get();
+            SymbolVendor *sym_vendor = oso_module ? oso_module->GetSymbolVendor() : NULL;
+            if (sym_vendor && sym_vendor->GetSymbolFile() == oso_dwarf)
             {
                 if (m_compile_unit_infos[cu_idx].oso_compile_unit_sp)
                 {
@@ -1279,6 +1549,7 @@ SymbolFileDWARFDebugMap::SetCompileUnit (SymbolFileDWARF *oso_dwarf, const CompU
                 }
                 else
                 {
+                    PinOSOIndex (cu_idx);
                     m_compile_unit_infos[cu_idx].oso_compile_unit_sp = cu_sp;
                     m_obj_file->GetModule()->GetSymbolVendor()->SetCompileUnitAtIndex(cu_idx, cu_sp);
                 }
@@ -1305,6 +1576,10 @@ SymbolFileDWARFDebugMap::CompleteTagDecl (void *baton, clang::TagDecl *decl)
                 return;
             }
         }
+
+        // The declaration might have come along with a type definition
+        // that one of our object files imported from another module
+        UniqueDWARFASTTypeFingerprintMap::GetSharedMap().CompleteImportedTagDecl (decl);
     }
 }
 
@@ -16,6 +16,7 @@
 
 #include "clang/AST/CharUnits.h"
 
+#include "lldb/Core/UniqueCStringMap.h"
 #include "lldb/Symbol/SymbolFile.h"
 
 #include "UniqueDWARFASTType.h"
@@ -124,6 +125,7 @@ protected:
     enum
     {
         kHaveInitializedOSOs = (1 << 0),
+        kHaveIndexedOSONames = (1 << 1),
         kNumFlags
     };
 
@@ -148,6 +150,7 @@ protected:
         lldb::CompUnitSP oso_compile_unit_sp;
 //        SymbolFileDWARF *oso_symfile;
         bool symbol_file_supported;
+        bool oso_module_pinned;     // Set once anything other than a failed search used the .o file
 
         CompileUnitInfo() :
             so_file (),
@@ -163,7 +166,8 @@ protected:
             oso_module_sp (),
             oso_compile_unit_sp (),
 //            oso_symfile (NULL),
-            symbol_file_supported (true)
+            symbol_file_supported (true),
+            oso_module_pinned (false)
         {
         }
     };
@@ -189,7 +193,7 @@ protected:
     GetCompUnitInfo (const lldb_private::Module *oso_module);
     
     lldb_private::Module *
-    GetModuleByCompUnitInfo (CompileUnitInfo *comp_unit_info);
+    GetModuleByCompUnitInfo (CompileUnitInfo *comp_unit_info, bool pin = true);
 
     lldb_private::Module *
     GetModuleByOSOIndex (uint32_t oso_idx);
@@ -212,6 +216,33 @@ protected:
     SymbolFileDWARF *
     GetSymbolFileByOSOIndex (uint32_t oso_idx);
 
+    //------------------------------------------------------------------
+    // Searches that would otherwise have to look in every .o file use
+    // these to open only the .o files that can contain a match. A .o
+    // file that is opened for a search and doesn't produce any results
+    // isn't pinned, and is closed again once too many such .o files
+    // are open.
+    //------------------------------------------------------------------
+    static lldb_private::ConstString
+    GetOSONameKey (const char *name, bool is_function);
+
+    void
+    IndexOSONames ();
+
+    bool
+    FindOSOIndexesForName (const lldb_private::ConstString &name,
+                           bool is_function,
+                           std::vector<uint32_t> &oso_indexes);
+
+    SymbolFileDWARF *
+    GetSymbolFileForSearchByOSOIndex (uint32_t oso_idx);
+
+    void
+    PinOSOIndex (uint32_t oso_idx);
+
+    void
+    TrimUnpinnedOSOModules ();
+
     CompileUnitInfo *
     GetCompileUnitInfoForSymbolWithIndex (uint32_t symbol_idx, uint32_t *oso_idx_ptr);
     
@@ -262,6 +293,9 @@ protected:
     std::vector<CompileUnitInfo> m_compile_unit_infos;
     std::vector<uint32_t> m_func_indexes;   // Sorted by address
     std::vector<uint32_t> m_glob_indexes;
+    lldb_private::UniqueCStringMap<uint32_t> m_oso_function_name_index; // Function name key to OSO index
+    lldb_private::UniqueCStringMap<uint32_t> m_oso_global_name_index;   // Global variable name key to OSO index
+    std::vector<uint32_t> m_unpinned_oso_indexes;   // Open .o files that aren't pinned, least recently used first
     UniqueDWARFASTTypeMap m_unique_ast_type_map;
     lldb_private::LazyBool m_supports_DW_AT_APPLE_objc_complete_type;
 };
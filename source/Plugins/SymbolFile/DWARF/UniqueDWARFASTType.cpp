@@ -12,11 +12,20 @@
 // C Includes
 // C++ Includes
 // Other libraries and framework includes
+#include "clang/AST/ASTContext.h"
+#include "clang/AST/Decl.h"
+#include "clang/AST/DeclCXX.h"
+
 // Project includes
+#include "lldb/Symbol/ClangASTContext.h"
+#include "lldb/Symbol/ClangASTImporter.h"
 #include "lldb/Symbol/Declaration.h"
 
 #include "DWARFDebugInfoEntry.h"
 
+using namespace lldb;
+using namespace lldb_private;
+
 bool
 UniqueDWARFASTTypeList::Find 
 (
@@ -92,3 +101,178 @@ UniqueDWARFASTTypeList::Find
     }
     return false;
 }
+
+UniqueDWARFASTTypeFingerprintMap &
+UniqueDWARFASTTypeFingerprintMap::GetSharedMap ()
+{
+    // Leaked on purpose so it outlives any symbol file that is
+    // destroyed during static destruction.
+    static UniqueDWARFASTTypeFingerprintMap *g_shared_map = new UniqueDWARFASTTypeFingerprintMap();
+    return *g_shared_map;
+}
+
+UniqueDWARFASTTypeFingerprintMap::UniqueDWARFASTTypeFingerprintMap () :
+    m_mutex (Mutex::eMutexTypeRecursive),
+    m_collection (),
+    m_importer_ap (new ClangASTImporter()),
+    m_source_asts (),
+    m_destination_asts ()
+{
+}
+
+UniqueDWARFASTTypeFingerprintMap::~UniqueDWARFASTTypeFingerprintMap ()
+{
+}
+
+void
+UniqueDWARFASTTypeFingerprintMap::Insert (uint64_t fingerprint,
+                                          SymbolFileDWARF *symfile,
+                                          clang::TagDecl *decl,
+                                          uint64_t bit_size,
+                                          uint64_t alignment,
+                                          const std::vector<uint64_t> &field_bit_offsets)
+{
+    if (decl == NULL || !decl->isCompleteDefinition())
+        return;
+
+    Mutex::Locker locker (m_mutex);
+    // The first definition we see is as good as any other
+    if (m_collection.find (fingerprint) != m_collection.end())
+        return;
+    Entry &entry = m_collection[fingerprint];
+    entry.symfile = symfile;
+    entry.decl = decl;
+    entry.bit_size = bit_size;
+    entry.alignment = alignment;
+    entry.field_bit_offsets = field_bit_offsets;
+    m_source_asts.insert (&decl->getASTContext());
+}
+
+static AccessType
+AccessSpecifierToAccessType (clang::AccessSpecifier access)
+{
+    switch (access)
+    {
+    case clang::AS_public:      return eAccessPublic;
+    case clang::AS_protected:   return eAccessProtected;
+    case clang::AS_private:     return eAccessPrivate;
+    case clang::AS_none:        break;
+    }
+    return eAccessNone;
+}
+
+bool
+UniqueDWARFASTTypeFingerprintMap::ImportDefinition (uint64_t fingerprint,
+                                                    SymbolFileDWARF *symfile,
+                                                    ClangASTContext &dst_ast,
+                                                    clang_type_t clang_type,
+                                                    uint64_t &bit_size,
+                                                    uint64_t &alignment,
+                                                    std::vector<uint64_t> &field_bit_offsets)
+{
+    clang::QualType qual_type (clang::QualType::getFromOpaquePtr(clang_type));
+    const clang::TagType *tag_type = qual_type->getAs<clang::TagType>();
+    if (tag_type == NULL)
+        return false;
+    clang::TagDecl *dst_decl = tag_type->getDecl();
+    clang::ASTContext *dst_ctx = dst_ast.getASTContext();
+
+    // Definitions get imported member by member into the existing
+    // declaration, which must not have been given any members yet.
+    if (dst_decl == NULL || !dst_decl->decls_empty() || dst_decl->isCompleteDefinition())
+        return false;
+
+    Mutex::Locker locker (m_mutex);
+    collection::const_iterator pos = m_collection.find (fingerprint);
+    if (pos == m_collection.end())
+        return false;
+
+    const Entry &entry = pos->second;
+    clang::ASTContext *src_ctx = &entry.decl->getASTContext();
+    if (entry.symfile == symfile || src_ctx == dst_ctx)
+        return false;
+
+    // C++ declarations have their definition started when they are created
+    // and the importer only brings over the members of a definition that
+    // has been started, add the base classes ourselves.
+    const bool definition_started = dst_decl->isBeingDefined();
+    std::vector<clang::CXXBaseSpecifier *> base_classes;
+    clang::CXXRecordDecl *src_cxx_record = llvm::dyn_cast<clang::CXXRecordDecl>(entry.decl);
+    if (definition_started && src_cxx_record)
+    {
+        clang::CXXRecordDecl::base_class_const_iterator base_pos, base_end = src_cxx_record->bases_end();
+        for (base_pos = src_cxx_record->bases_begin(); base_pos != base_end; ++base_pos)
+        {
+            clang_type_t base_clang_type = m_importer_ap->CopyType (dst_ctx, src_ctx, base_pos->getType().getAsOpaquePtr());
+            clang::CXXBaseSpecifier *base_class = dst_ast.CreateBaseClassSpecifier (base_clang_type,
+                                                                                    AccessSpecifierToAccessType (base_pos->getAccessSpecifier()),
+                                                                                    base_pos->isVirtual(),
+                                                                                    base_pos->isBaseOfClass());
+            if (base_class == NULL)
+            {
+                if (!base_classes.empty())
+                    ClangASTContext::DeleteBaseClassSpecifiers (&base_classes.front(), base_classes.size());
+                return false;
+            }
+            base_classes.push_back (base_class);
+        }
+    }
+
+    if (!m_importer_ap->CompleteTagDeclWithOrigin (dst_decl, entry.decl))
+    {
+        if (!base_classes.empty())
+            ClangASTContext::DeleteBaseClassSpecifiers (&base_classes.front(), base_classes.size());
+        return false;
+    }
+
+    if (!base_classes.empty())
+    {
+        dst_ast.SetBaseClassesForClassType (clang_type, &base_classes.front(), base_classes.size());
+        ClangASTContext::DeleteBaseClassSpecifiers (&base_classes.front(), base_classes.size());
+    }
+    if (definition_started)
+        dst_ast.CompleteTagDeclarationDefinition (clang_type);
+
+    m_destination_asts.insert (dst_ctx);
+    bit_size = entry.bit_size;
+    alignment = entry.alignment;
+    field_bit_offsets = entry.field_bit_offsets;
+    return true;
+}
+
+bool
+UniqueDWARFASTTypeFingerprintMap::CompleteImportedTagDecl (clang::TagDecl *decl)
+{
+    Mutex::Locker locker (m_mutex);
+    if (m_destination_asts.find (&decl->getASTContext()) == m_destination_asts.end())
+        return false;
+    return m_importer_ap->CompleteTagDecl (decl);
+}
+
+void
+UniqueDWARFASTTypeFingerprintMap::RemoveSymbolFile (SymbolFileDWARF *symfile, clang::ASTContext *ast)
+{
+    Mutex::Locker locker (m_mutex);
+    collection::iterator pos = m_collection.begin();
+    while (pos != m_collection.end())
+    {
+        if (pos->second.symfile == symfile)
+            m_collection.erase (pos++);
+        else
+            ++pos;
+    }
+
+    if (ast == NULL)
+        return;
+
+    // Declarations that other modules imported from this AST can't be
+    // completed anymore, they will stay forward declarations.
+    if (m_source_asts.erase (ast))
+    {
+        std::set<clang::ASTContext *>::const_iterator dst_pos, dst_end = m_destination_asts.end();
+        for (dst_pos = m_destination_asts.begin(); dst_pos != dst_end; ++dst_pos)
+            m_importer_ap->ForgetSource (*dst_pos, ast);
+    }
+    if (m_destination_asts.erase (ast))
+        m_importer_ap->ForgetDestination (ast);
+}
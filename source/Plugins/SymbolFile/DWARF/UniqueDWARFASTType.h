@@ -12,14 +12,30 @@
 
 // C Includes
 // C++ Includes
+#include <map>
+#include <memory>
+#include <set>
 #include <vector>
 
 // Other libraries and framework includes
 #include "llvm/ADT/DenseMap.h"
 
 // Project includes
+#include "lldb/Host/Mutex.h"
 #include "lldb/Symbol/Declaration.h"
 
+namespace clang
+{
+    class ASTContext;
+    class TagDecl;
+}
+
+namespace lldb_private
+{
+    class ClangASTContext;
+    class ClangASTImporter;
+}
+
 class DWARFCompileUnit;
 class DWARFDebugInfoEntry;
 class SymbolFileDWARF;
@@ -172,4 +188,88 @@ protected:
     collection m_collection;
 };
 
+//----------------------------------------------------------------------
+// UniqueDWARFASTTypeFingerprintMap
+//
+// Complete class, struct and union definitions keyed by a structural
+// hash of their DIE subtree. A single instance is shared by all
+// SymbolFileDWARF objects so a type that many modules define the same
+// way (std::string for example) only needs to be parsed from the DWARF
+// once. The other modules import the definition into their own AST.
+//----------------------------------------------------------------------
+class UniqueDWARFASTTypeFingerprintMap
+{
+public:
+    static UniqueDWARFASTTypeFingerprintMap &
+    GetSharedMap ();
+
+    UniqueDWARFASTTypeFingerprintMap ();
+
+    ~UniqueDWARFASTTypeFingerprintMap ();
+
+    //------------------------------------------------------------------
+    // Remember the complete definition "decl" that "symfile" parsed.
+    // "field_bit_offsets" contains the bit offset for each field of the
+    // record in declaration order, or is empty if clang should compute
+    // the layout itself.
+    //------------------------------------------------------------------
+    void
+    Insert (uint64_t fingerprint,
+            SymbolFileDWARF *symfile,
+            clang::TagDecl *decl,
+            uint64_t bit_size,
+            uint64_t alignment,
+            const std::vector<uint64_t> &field_bit_offsets);
+
+    //------------------------------------------------------------------
+    // Complete the forward declaration "clang_type" in "dst_ast" by
+    // importing a definition with the same fingerprint that a different
+    // symbol file parsed. Returns false if there is no such definition,
+    // in which case "clang_type" is left untouched.
+    //------------------------------------------------------------------
+    bool
+    ImportDefinition (uint64_t fingerprint,
+                      SymbolFileDWARF *symfile,
+                      lldb_private::ClangASTContext &dst_ast,
+                      lldb::clang_type_t clang_type,
+                      uint64_t &bit_size,
+                      uint64_t &alignment,
+                      std::vector<uint64_t> &field_bit_offsets);
+
+    //------------------------------------------------------------------
+    // Imported definitions only bring in forward declarations for the
+    // types they use, complete one of those from where it came from.
+    //------------------------------------------------------------------
+    bool
+    CompleteImportedTagDecl (clang::TagDecl *decl);
+
+    //------------------------------------------------------------------
+    // Forget all definitions from "symfile" and everything that was
+    // imported into or out of "ast". Called when a symbol file goes away.
+    //------------------------------------------------------------------
+    void
+    RemoveSymbolFile (SymbolFileDWARF *symfile, clang::ASTContext *ast);
+
+protected:
+    struct Entry
+    {
+        SymbolFileDWARF *symfile;
+        clang::TagDecl *decl;
+        uint64_t bit_size;
+        uint64_t alignment;
+        std::vector<uint64_t> field_bit_offsets;
+    };
+
+    typedef std::map<uint64_t, Entry> collection;
+
+    lldb_private::Mutex m_mutex;
+    collection m_collection;
+    std::auto_ptr<lldb_private::ClangASTImporter> m_importer_ap;
+    std::set<clang::ASTContext *> m_source_asts;
+    std::set<clang::ASTContext *> m_destination_asts;
+
+private:
+    DISALLOW_COPY_AND_ASSIGN (UniqueDWARFASTTypeFingerprintMap);
+};
+
 #endif	// lldb_UniqueDWARFASTType_h_
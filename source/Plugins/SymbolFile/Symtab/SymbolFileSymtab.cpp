@@ -296,6 +296,13 @@ SymbolFileSymtab::FindNamespace (const SymbolContext& sc, const ConstString &nam
     return ClangNamespaceDecl();
 }
 
+bool
+SymbolFileSymtab::AppendLookupNames (std::vector<const char *> &names)
+{
+    // Everything this finds comes from the symbol table
+    return true;
+}
+
 uint32_t
 SymbolFileSymtab::ResolveSymbolContext (const Address& so_addr, uint32_t resolve_scope, SymbolContext& sc)
 {
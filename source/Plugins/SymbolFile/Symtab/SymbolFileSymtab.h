@@ -110,6 +110,9 @@ public:
                    const lldb_private::ConstString &name, 
                    const lldb_private::ClangNamespaceDecl *parent_namespace_decl);
 
+    virtual bool
+    AppendLookupNames (std::vector<const char *> &names);
+
     //------------------------------------------------------------------
     // PluginInterface protocol
     //------------------------------------------------------------------
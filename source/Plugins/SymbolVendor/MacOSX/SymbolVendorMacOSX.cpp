@@ -184,7 +184,9 @@ SymbolVendorMacOSX::CreateInstance (const lldb::ModuleSP &module_sp)
                 // No symbol file was specified in the module, lets try and find
                 // one ourselves.
                 const FileSpec &file_spec = obj_file->GetFileSpec();
-                if (file_spec)
+                // Don't search again for a dSYM that a batched search
+                // with Symbols::LocateExecutableSymbolFiles() didn't find
+                if (file_spec && !Symbols::SymbolFileIsKnownMissing (module_sp->GetUUID()))
                 {
                     ModuleSpec module_spec(file_spec, module_sp->GetArchitecture());
                     module_spec.GetUUID() = module_sp->GetUUID();
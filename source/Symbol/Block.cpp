@@ -9,6 +9,8 @@
 
 #include "lldb/Symbol/Block.h"
 
+#include <algorithm>
+
 #include "lldb/lldb-private-log.h"
 
 #include "lldb/Core/Log.h"
@@ -150,6 +152,63 @@ Block::FindBlockByID (user_id_t block_id)
     return matching_block;
 }
 
+void
+Block::AppendInnermostRanges (InnermostBlockRanges &block_ranges,
+                              std::vector<Block *> &blocks)
+{
+    blocks.push_back (this);
+
+    // Gather the ranges of all children in address order. Children are
+    // contained in their parent (AddRange() grows the parent if they
+    // aren't), so what is left of our own ranges belongs to this block.
+    std::vector<Range> child_ranges;
+    collection::const_iterator pos, end = m_children.end();
+    for (pos = m_children.begin(); pos != end; ++pos)
+    {
+        const RangeList &ranges = (*pos)->m_ranges;
+        for (size_t i = 0, n = ranges.GetSize(); i < n; ++i)
+            child_ranges.push_back (ranges.GetEntryRef (i));
+    }
+    std::sort (child_ranges.begin(), child_ranges.end());
+
+    // A child that grew this block may have appended to m_ranges after
+    // it was finalized, so sort our own ranges too and skip any overlap.
+    std::vector<Range> ranges;
+    for (size_t i = 0, n = m_ranges.GetSize(); i < n; ++i)
+        ranges.push_back (m_ranges.GetEntryRef (i));
+    std::sort (ranges.begin(), ranges.end());
+
+    size_t child_idx = 0;
+    const size_t num_child_ranges = child_ranges.size();
+    uint32_t done_end = 0;
+    for (size_t i = 0, n = ranges.size(); i < n; ++i)
+    {
+        const Range &range = ranges[i];
+        uint32_t cursor = std::max (range.GetRangeBase(), done_end);
+        const uint32_t range_end = range.GetRangeEnd();
+        if (cursor >= range_end)
+            continue;
+        done_end = range_end;
+        while (child_idx < num_child_ranges && child_ranges[child_idx].GetRangeEnd() <= cursor)
+            ++child_idx;
+        for (; child_idx < num_child_ranges && child_ranges[child_idx].GetRangeBase() < range_end; ++child_idx)
+        {
+            const Range &child_range = child_ranges[child_idx];
+            if (child_range.GetRangeBase() > cursor)
+                block_ranges.Append (InnermostBlockRanges::Entry (cursor, child_range.GetRangeBase() - cursor, this));
+            if (child_range.GetRangeEnd() > cursor)
+                cursor = child_range.GetRangeEnd();
+            if (cursor >= range_end)
+                break;
+        }
+        if (cursor < range_end)
+            block_ranges.Append (InnermostBlockRanges::Entry (cursor, range_end - cursor, this));
+    }
+
+    for (pos = m_children.begin(); pos != end; ++pos)
+        (*pos)->AppendInnermostRanges (block_ranges, blocks);
+}
+
 void
 Block::CalculateSymbolContext (SymbolContext* sc)
 {
@@ -83,6 +83,13 @@ ClangASTImporter::DeportType (clang::ASTContext *dst_ctx,
                               clang::ASTContext *src_ctx,
                               lldb::clang_type_t type)
 {
+    // Types that came from a module don't need to be copied out of the
+    // source AST, which may already have been deported many times
+    QualType origin_type = CopyTypeFromOrigin(dst_ctx, QualType::getFromOpaquePtr(type));
+    
+    if (!origin_type.isNull())
+        return origin_type.getAsOpaquePtr();
+    
     lldb::clang_type_t result = CopyType(dst_ctx, src_ctx, type);
     
     if (!result)
@@ -120,6 +127,11 @@ ClangASTImporter::DeportDecl (clang::ASTContext *dst_ctx,
                               clang::ASTContext *src_ctx,
                               clang::Decl *decl)
 {
+    clang::Decl *origin_result = CopyDeclFromOrigin(dst_ctx, decl);
+    
+    if (origin_result)
+        return origin_result;
+    
     clang::Decl *result = CopyDecl(dst_ctx, src_ctx, decl);
     
     if (!result)
@@ -269,6 +281,104 @@ ClangASTImporter::GetDeclOrigin(const clang::Decl *decl)
         return DeclOrigin();
 }
 
+clang::Decl *
+ClangASTImporter::CopyDeclFromOrigin (clang::ASTContext *dst_ctx,
+                                      clang::Decl *decl)
+{
+    DeclOrigin decl_origin = GetDeclOrigin(decl);
+    
+    if (!decl_origin.Valid())
+        return NULL;
+    
+    lldb::LogSP log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_EXPRESSIONS));
+    
+    if (log)
+        log->Printf("    [ClangASTImporter] Copying (%sDecl*)%p from its origin (Decl*)%p/(ASTContext*)%p into (ASTContext*)%p",
+                    decl->getDeclKindName(),
+                    decl,
+                    decl_origin.decl,
+                    decl_origin.ctx,
+                    dst_ctx);
+    
+    if (decl_origin.ctx == dst_ctx)
+        return decl_origin.decl;
+    
+    return CopyDecl(dst_ctx, decl_origin.ctx, decl_origin.decl);
+}
+
+clang::QualType
+ClangASTImporter::CopyTypeFromOrigin (clang::ASTContext *dst_ctx,
+                                      clang::QualType type)
+{
+    if (type.isNull())
+        return QualType();
+    
+    Qualifiers qualifiers = type.getLocalQualifiers();
+    const clang::Type *type_ptr = type.getLocalUnqualifiedType().getTypePtr();
+    QualType result;
+    
+    if (const PointerType *pointer_type = dyn_cast<PointerType>(type_ptr))
+    {
+        QualType pointee_type = CopyTypeFromOrigin(dst_ctx, pointer_type->getPointeeType());
+        
+        if (!pointee_type.isNull())
+            result = dst_ctx->getPointerType(pointee_type);
+    }
+    else if (const LValueReferenceType *lvalue_ref_type = dyn_cast<LValueReferenceType>(type_ptr))
+    {
+        QualType pointee_type = CopyTypeFromOrigin(dst_ctx, lvalue_ref_type->getPointeeType());
+        
+        if (!pointee_type.isNull())
+            result = dst_ctx->getLValueReferenceType(pointee_type);
+    }
+    else if (const RValueReferenceType *rvalue_ref_type = dyn_cast<RValueReferenceType>(type_ptr))
+    {
+        QualType pointee_type = CopyTypeFromOrigin(dst_ctx, rvalue_ref_type->getPointeeType());
+        
+        if (!pointee_type.isNull())
+            result = dst_ctx->getRValueReferenceType(pointee_type);
+    }
+    else if (const ObjCObjectPointerType *objc_pointer_type = dyn_cast<ObjCObjectPointerType>(type_ptr))
+    {
+        QualType pointee_type = CopyTypeFromOrigin(dst_ctx, objc_pointer_type->getPointeeType());
+        
+        if (!pointee_type.isNull())
+            result = dst_ctx->getObjCObjectPointerType(pointee_type);
+    }
+    else
+    {
+        TypeDecl *type_decl = NULL;
+        ObjCInterfaceDecl *interface_decl = NULL;
+        
+        if (const TypedefType *typedef_type = dyn_cast<TypedefType>(type_ptr))
+            type_decl = typedef_type->getDecl();
+        else if (const TagType *tag_type = type_ptr->getAs<TagType>())
+            type_decl = tag_type->getDecl();
+        else if (const ObjCInterfaceType *interface_type = type_ptr->getAs<ObjCInterfaceType>())
+            interface_decl = interface_type->getDecl();
+        
+        Decl *copied_decl = NULL;
+        
+        if (type_decl)
+            copied_decl = CopyDeclFromOrigin(dst_ctx, type_decl);
+        else if (interface_decl)
+            copied_decl = CopyDeclFromOrigin(dst_ctx, interface_decl);
+        
+        if (copied_decl)
+        {
+            if (TypeDecl *copied_type_decl = dyn_cast<TypeDecl>(copied_decl))
+                result = dst_ctx->getTypeDeclType(copied_type_decl);
+            else if (ObjCInterfaceDecl *copied_interface_decl = dyn_cast<ObjCInterfaceDecl>(copied_decl))
+                result = dst_ctx->getObjCInterfaceType(copied_interface_decl);
+        }
+    }
+    
+    if (result.isNull())
+        return QualType();
+    
+    return dst_ctx->getQualifiedType(result, qualifiers);
+}
+
 void 
 ClangASTImporter::RegisterNamespaceMap(const clang::NamespaceDecl *decl, 
                                        NamespaceMapSP &namespace_map)
@@ -9,14 +9,18 @@
 
 
 // C Includes
+#include <string.h>
 // C++ Includes
 #include <list>
 
 #include "lldb/Core/Log.h"
 #include "lldb/Core/Section.h"
 #include "lldb/Core/ArchSpec.h"
+#include "lldb/Core/IndexCache.h"
 #include "lldb/Core/Module.h"
 #include "lldb/Core/Section.h"
+#include "lldb/Core/StreamString.h"
+#include "lldb/Host/Endian.h"
 #include "lldb/Host/Host.h"
 #include "lldb/Symbol/DWARFCallFrameInfo.h"
 #include "lldb/Symbol/ObjectFile.h"
@@ -27,6 +31,9 @@
 using namespace lldb;
 using namespace lldb_private;
 
+// Bump this whenever the layout of DWARFCallFrameInfo::FDEEntry changes
+#define CFI_FDE_INDEX_CACHE_VERSION 1
+
 DWARFCallFrameInfo::DWARFCallFrameInfo(ObjectFile& objfile, SectionSP& section_sp, lldb::RegisterKind reg_kind, bool is_eh_frame) :
     m_objfile (objfile),
     m_section_sp (section_sp),
@@ -37,6 +44,7 @@ DWARFCallFrameInfo::DWARFCallFrameInfo(ObjectFile& objfile, SectionSP& section_s
     m_cfi_data_initialized (false),
     m_fde_index (),
     m_fde_index_initialized (false),
+    m_fde_index_mutex (Mutex::eMutexTypeRecursive),
     m_is_eh_frame (is_eh_frame)
 {
 }
@@ -52,7 +60,7 @@ DWARFCallFrameInfo::GetAddressRange (Address addr, AddressRange &range)
     FDEEntry fde_entry;
     if (GetFDEEntryByAddress (addr, fde_entry) == false)
         return false;
-    range = fde_entry.bounds;
+    range = AddressRange (fde_entry.file_addr, fde_entry.byte_size, m_objfile.GetSectionList());
     return true;
 }
 
@@ -70,25 +78,27 @@ DWARFCallFrameInfo::GetFDEEntryByAddress (Address addr, FDEEntry& fde_entry)
 {
     if (m_section_sp.get() == NULL || m_section_sp->IsEncrypted())
         return false;
+
+    // Other threads may be building the index, take the lock so we never
+    // search a half built one
+    Mutex::Locker locker(m_fde_index_mutex);
     GetFDEIndex();
 
-    struct FDEEntry searchfde;
-    searchfde.bounds = AddressRange (addr, 1);
+    if (m_fde_index.empty())
+        return false;
 
-    std::vector<FDEEntry>::const_iterator idx;
-    if (m_fde_index.size() == 0)
+    const addr_t file_addr = addr.GetFileAddress();
+    if (file_addr == LLDB_INVALID_ADDRESS)
         return false;
 
-    idx = std::lower_bound (m_fde_index.begin(), m_fde_index.end(), searchfde);
-    if (idx == m_fde_index.end())
-    {
-        --idx;
-    }
-    if (idx != m_fde_index.begin() && idx->bounds.GetBaseAddress().GetOffset() != addr.GetOffset())
-    {
-       --idx;
-    }
-    if (idx->bounds.ContainsFileAddress (addr))
+    // Find the last FDE that starts at or before the address
+    FDEEntry search_fde;
+    search_fde.file_addr = file_addr;
+    std::vector<FDEEntry>::const_iterator idx = std::upper_bound (m_fde_index.begin(), m_fde_index.end(), search_fde);
+    if (idx == m_fde_index.begin())
+        return false;
+    --idx;
+    if (file_addr - idx->file_addr < idx->byte_size)
     {
         fde_entry = *idx;
         return true;
@@ -100,6 +110,7 @@ DWARFCallFrameInfo::GetFDEEntryByAddress (Address addr, FDEEntry& fde_entry)
 const DWARFCallFrameInfo::CIE*
 DWARFCallFrameInfo::GetCIE(dw_offset_t cie_offset)
 {
+    Mutex::Locker locker(m_fde_index_mutex);
     cie_map_t::iterator pos = m_cie_map.find(cie_offset);
 
     if (pos != m_cie_map.end())
@@ -110,6 +121,20 @@ DWARFCallFrameInfo::GetCIE(dw_offset_t cie_offset)
 
         return pos->second.get();
     }
+
+    // When the FDE index comes from the index cache we haven't seen any
+    // CIEs yet, so parse them as the FDEs ask for them.
+    if (m_fde_index_initialized && m_cfi_data.ValidOffsetForDataOfSize (cie_offset, 8))
+    {
+        uint32_t offset = cie_offset + 4;
+        const dw_offset_t cie_id = m_cfi_data.GetU32 (&offset);
+        if (cie_id == 0 || cie_id == UINT32_MAX)
+        {
+            CIESP cie_sp (ParseCIE (cie_offset));
+            m_cie_map[cie_offset] = cie_sp;
+            return cie_sp.get();
+        }
+    }
     return NULL;
 }
 
@@ -305,6 +330,13 @@ DWARFCallFrameInfo::GetFDEIndex ()
     dw_offset_t offset = 0;
     if (m_cfi_data_initialized == false)
         GetCFIData();
+
+    if (LoadFDEIndexFromCache ())
+    {
+        m_fde_index_initialized = true;
+        return;
+    }
+
     while (m_cfi_data.ValidOffsetForDataOfSize (offset, 8))
     {
         const dw_offset_t current_entry = offset;
@@ -330,7 +362,8 @@ DWARFCallFrameInfo::GetFDEIndex ()
             lldb::addr_t addr = m_cfi_data.GetGNUEHPointer(&offset, cie->ptr_encoding, pc_rel_addr, text_addr, data_addr);
             lldb::addr_t length = m_cfi_data.GetGNUEHPointer(&offset, cie->ptr_encoding & DW_EH_PE_MASK_ENCODING, pc_rel_addr, text_addr, data_addr);
             FDEEntry fde;
-            fde.bounds = AddressRange (addr, length, m_objfile.GetSectionList());
+            fde.file_addr = addr;
+            fde.byte_size = length;
             fde.offset = current_entry;
             m_fde_index.push_back(fde);
         }
@@ -346,6 +379,62 @@ DWARFCallFrameInfo::GetFDEIndex ()
     }
     std::sort (m_fde_index.begin(), m_fde_index.end());
     m_fde_index_initialized = true;
+    SaveFDEIndexToCache ();
+}
+
+bool
+DWARFCallFrameInfo::LoadFDEIndexFromCache ()
+{
+    // Protected function, m_fde_index_mutex must be locked
+    Module *module = m_objfile.GetModule().get();
+    if (!IndexCache::IsEnabledForModule (module))
+        return false;
+
+    DataExtractor data;
+    uint32_t offset = 0;
+    if (!IndexCache::Load (module, m_is_eh_frame ? "eh-frame-fdes" : "debug-frame-fdes", CFI_FDE_INDEX_CACHE_VERSION, data, &offset))
+        return false;
+
+    // Make sure the index was built for the same section contents
+    if (data.GetU64 (&offset) != m_cfi_data.GetByteSize() ||
+        data.GetU64 (&offset) != m_section_sp->GetFileAddress())
+        return false;
+
+    const uint32_t num_fdes = data.GetU32 (&offset);
+    const uint8_t *fde_bytes = data.GetData (&offset, num_fdes * sizeof(FDEEntry));
+    if (num_fdes > 0 && fde_bytes == NULL)
+        return false;
+
+    m_fde_index.resize (num_fdes);
+    if (num_fdes > 0)
+        ::memcpy (&m_fde_index[0], fde_bytes, num_fdes * sizeof(FDEEntry));
+
+    for (uint32_t i=0; i<num_fdes; ++i)
+    {
+        if (!m_cfi_data.ValidOffsetForDataOfSize (m_fde_index[i].offset, 8))
+        {
+            m_fde_index.clear();
+            return false;
+        }
+    }
+    return true;
+}
+
+void
+DWARFCallFrameInfo::SaveFDEIndexToCache ()
+{
+    // Protected function, m_fde_index_mutex must be locked
+    Module *module = m_objfile.GetModule().get();
+    if (!IndexCache::IsEnabledForModule (module))
+        return;
+
+    StreamString strm (Stream::eBinary, sizeof(void *), lldb::endian::InlHostByteOrder());
+    strm.PutHex64 (m_cfi_data.GetByteSize());
+    strm.PutHex64 (m_section_sp->GetFileAddress());
+    strm.PutHex32 (m_fde_index.size());
+    if (!m_fde_index.empty())
+        strm.Write (&m_fde_index[0], m_fde_index.size() * sizeof(FDEEntry));
+    IndexCache::Save (module, m_is_eh_frame ? "eh-frame-fdes" : "debug-frame-fdes", CFI_FDE_INDEX_CACHE_VERSION, strm.GetString());
 }
 
 bool
@@ -15,13 +15,14 @@ using namespace lldb_private;
 void
 Declaration::Dump(Stream *s, bool show_fullpaths) const
 {
-    if (m_file)
+    const FileSpec &file_spec = GetFile();
+    if (file_spec)
     {
         *s << ", decl = ";
         if (show_fullpaths)
-            *s << m_file;
+            *s << file_spec;
         else
-            *s << m_file.GetFilename();
+            *s << file_spec.GetFilename();
         if (m_line > 0)
             s->Printf(":%u", m_line);
 #ifdef LLDB_ENABLE_DECLARATION_COLUMNS
@@ -49,12 +50,13 @@ Declaration::Dump(Stream *s, bool show_fullpaths) const
 bool
 Declaration::DumpStopContext (Stream *s, bool show_fullpaths) const
 {
-    if (m_file)
+    const FileSpec &file_spec = GetFile();
+    if (file_spec)
     {
         if (show_fullpaths || s->GetVerbose())
-            *s << m_file;
+            *s << file_spec;
         else
-            m_file.GetFilename().Dump(s);
+            file_spec.GetFilename().Dump(s);
 
         if (m_line > 0)
             s->Printf(":%u", m_line);
@@ -85,9 +87,12 @@ Declaration::MemorySize() const
 int
 Declaration::Compare(const Declaration& a, const Declaration& b)
 {
-    int result = FileSpec::Compare(a.m_file, b.m_file, true);
-    if (result)
-        return result;
+    if (a.m_file_idx != b.m_file_idx)
+    {
+        int result = FileSpec::Compare(a.GetFile(), b.GetFile(), true);
+        if (result)
+            return result;
+    }
     if (a.m_line < b.m_line)
         return -1;
     else if (a.m_line > b.m_line)
@@ -107,10 +112,10 @@ lldb_private::operator == (const Declaration &lhs, const Declaration &rhs)
 #ifdef LLDB_ENABLE_DECLARATION_COLUMNS
     if (lhs.GetColumn () == rhs.GetColumn ())
         if (lhs.GetLine () == rhs.GetLine ())
-            return lhs.GetFile() == rhs.GetFile();
+            return lhs.GetFileIndex() == rhs.GetFileIndex() || lhs.GetFile() == rhs.GetFile();
 #else
     if (lhs.GetLine () == rhs.GetLine ())
-        return lhs.GetFile() == rhs.GetFile();
+        return lhs.GetFileIndex() == rhs.GetFileIndex() || lhs.GetFile() == rhs.GetFile();
 #endif
     return false;
 }
@@ -29,11 +29,13 @@ FuncUnwinders::FuncUnwinders
 (
     UnwindTable& unwind_table, 
     UnwindAssembly *assembly_profiler, 
-    AddressRange range
+    AddressRange range,
+    bool use_saved_plans
 ) : 
     m_unwind_table(unwind_table), 
     m_assembly_profiler(assembly_profiler), 
     m_range(range), 
+    m_use_saved_plans(use_saved_plans),
     m_mutex (Mutex::eMutexTypeNormal),
     m_unwind_plan_call_site_sp (), 
     m_unwind_plan_non_call_site_sp (), 
@@ -115,8 +117,13 @@ FuncUnwinders::GetUnwindPlanAtNonCallSite (Thread& thread)
     {
         m_tried_unwind_at_non_call_site = true;
         m_unwind_plan_non_call_site_sp.reset (new UnwindPlan (lldb::eRegisterKindGeneric));
-        if (!m_assembly_profiler->GetNonCallSiteUnwindPlanFromAssembly (m_range, thread, *m_unwind_plan_non_call_site_sp))
-            m_unwind_plan_non_call_site_sp.reset();
+        if (!m_use_saved_plans || !m_unwind_table.GetProfiledUnwindPlan (m_range, UnwindTable::eProfiledUnwindPlanNonCallSite, *m_unwind_plan_non_call_site_sp))
+        {
+            if (m_assembly_profiler->GetNonCallSiteUnwindPlanFromAssembly (m_range, thread, *m_unwind_plan_non_call_site_sp))
+                m_unwind_table.AddProfiledUnwindPlan (m_range, UnwindTable::eProfiledUnwindPlanNonCallSite, *m_unwind_plan_non_call_site_sp, thread);
+            else
+                m_unwind_plan_non_call_site_sp.reset();
+        }
     }
     return m_unwind_plan_non_call_site_sp;
 }
@@ -141,8 +148,13 @@ FuncUnwinders::GetUnwindPlanFastUnwind (Thread& thread)
     {
         m_tried_unwind_fast = true;
         m_unwind_plan_fast_sp.reset (new UnwindPlan (lldb::eRegisterKindGeneric));
-        if (!m_assembly_profiler->GetFastUnwindPlan (m_range, thread, *m_unwind_plan_fast_sp))
-            m_unwind_plan_fast_sp.reset();
+        if (!m_use_saved_plans || !m_unwind_table.GetProfiledUnwindPlan (m_range, UnwindTable::eProfiledUnwindPlanFast, *m_unwind_plan_fast_sp))
+        {
+            if (m_assembly_profiler->GetFastUnwindPlan (m_range, thread, *m_unwind_plan_fast_sp))
+                m_unwind_table.AddProfiledUnwindPlan (m_range, UnwindTable::eProfiledUnwindPlanFast, *m_unwind_plan_fast_sp, thread);
+            else
+                m_unwind_plan_fast_sp.reset();
+        }
     }
     return m_unwind_plan_fast_sp;
 }
@@ -8,6 +8,9 @@
 //===----------------------------------------------------------------------===//
 
 #include "lldb/Symbol/Function.h"
+
+#include <algorithm>
+
 #include "lldb/Core/Module.h"
 #include "lldb/Core/Section.h"
 #include "lldb/Host/Host.h"
@@ -214,7 +217,9 @@ Function::Function
     m_range (range),
     m_frame_base (),
     m_flags (),
-    m_prologue_byte_size (0)
+    m_prologue_byte_size (0),
+    m_block_ranges (),
+    m_blocks_by_id ()
 {
     m_block.SetParentScope(this);
     assert(comp_unit != NULL);
@@ -238,7 +243,9 @@ Function::Function
     m_range (range),
     m_frame_base (),
     m_flags (),
-    m_prologue_byte_size (0)
+    m_prologue_byte_size (0),
+    m_block_ranges (),
+    m_blocks_by_id ()
 {
     m_block.SetParentScope(this);
     assert(comp_unit != NULL);
@@ -326,6 +333,74 @@ Function::GetBlock (bool can_create)
     return m_block;
 }
 
+namespace {
+
+    struct BlockIDLessThan
+    {
+        bool
+        operator () (const Block *lhs, const Block *rhs) const
+        {
+            return lhs->GetID() < rhs->GetID();
+        }
+
+        bool
+        operator () (const Block *lhs, lldb::user_id_t rhs) const
+        {
+            return lhs->GetID() < rhs;
+        }
+    };
+
+}
+
+//----------------------------------------------------------------------
+// Returns false if the blocks are still being parsed, in which case the
+// indexes would be missing blocks and can't be built yet.
+//----------------------------------------------------------------------
+bool
+Function::BuildBlockIndexes ()
+{
+    if (m_flags.IsClear(flagsBuiltBlockIndexes))
+    {
+        Block &block = GetBlock (true);
+        if (!block.BlockInfoHasBeenParsed())
+            return false;
+        m_flags.Set(flagsBuiltBlockIndexes);
+        block.AppendInnermostRanges (m_block_ranges, m_blocks_by_id);
+        m_block_ranges.Sort();
+        std::sort (m_blocks_by_id.begin(), m_blocks_by_id.end(), BlockIDLessThan());
+    }
+    return true;
+}
+
+Block *
+Function::FindBlockContainingFileAddress (lldb::addr_t file_addr)
+{
+    if (!m_range.ContainsFileAddress (file_addr))
+        return NULL;
+
+    if (!BuildBlockIndexes ())
+        return &m_block;
+    const addr_t func_offset = file_addr - m_range.GetBaseAddress().GetFileAddress();
+    const Block::InnermostBlockRanges::Entry *entry = m_block_ranges.FindEntryThatContains ((uint32_t)func_offset);
+    if (entry)
+        return entry->data;
+    return &m_block;
+}
+
+Block *
+Function::FindBlockByID (lldb::user_id_t block_id)
+{
+    if (!BuildBlockIndexes ())
+        return m_block.FindBlockByID (block_id);
+    std::vector<Block *>::const_iterator pos = std::lower_bound (m_blocks_by_id.begin(),
+                                                                 m_blocks_by_id.end(),
+                                                                 block_id,
+                                                                 BlockIDLessThan());
+    if (pos != m_blocks_by_id.end() && (*pos)->GetID() == block_id)
+        return *pos;
+    return NULL;
+}
+
 CompileUnit*
 Function::GetCompileUnit()
 {
@@ -8,8 +8,11 @@
 //===----------------------------------------------------------------------===//
 
 #include "lldb/Core/Address.h"
+#include "lldb/Core/DataBufferHeap.h"
 #include "lldb/Core/Section.h"
 #include "lldb/Core/Stream.h"
+#include "lldb/Core/StreamString.h"
+#include "lldb/Host/Endian.h"
 #include "lldb/Symbol/CompileUnit.h"
 #include "lldb/Symbol/LineTable.h"
 #include <algorithm>
@@ -23,7 +26,11 @@ using namespace lldb_private;
 LineTable::LineTable(CompileUnit* comp_unit) :
     m_comp_unit(comp_unit),
     m_section_list(),
-    m_entries()
+    m_entries(),
+    m_blocks(),
+    m_entry_data(),
+    m_num_encoded_entries(0),
+    m_finalized(false)
 {
 }
 
@@ -56,6 +63,8 @@ LineTable::AppendLineEntry
     bool is_terminal_entry
 )
 {
+    if (m_finalized)
+        DecodeAllEntries ();
     uint32_t sect_idx = m_section_list.AddUniqueSection (section_sp);
     Entry entry(sect_idx, section_offset, line, column, file_idx, is_start_of_statement, is_start_of_basic_block, is_prologue_end, is_epilogue_begin, is_terminal_entry);
     m_entries.push_back (entry);
@@ -77,6 +86,8 @@ LineTable::InsertLineEntry
     bool is_terminal_entry
 )
 {
+    if (m_finalized)
+        DecodeAllEntries ();
     SectionSP line_section_sp;
     SectionSP linked_section_sp (section_sp->GetLinkedSection());
     if (linked_section_sp)
@@ -147,16 +158,193 @@ LineTable::GetSectionForEntryIndex (uint32_t idx)
     return NULL;
 }
 
+//----------------------------------------------------------------------
+// Encoded line entries.
+//
+// Each entry starts with a byte of flags. The low five bits are the
+// boolean members of the entry, the high three bits say which of the
+// optional fields follow:
+//
+//  - the section index as a ULEB128, followed by the section offset as
+//    a ULEB128, if the section differs from the previous entry's. Else
+//    the section offset is a SLEB128 delta from the previous entry's.
+//  - the line as a SLEB128 delta from the previous entry's line.
+//  - the column as a ULEB128, if it differs from the previous entry's.
+//  - the file index as a ULEB128, if it differs from the previous
+//    entry's.
+//
+// The first entry of each block is encoded relative to a cleared
+// entry, so blocks can be decoded on their own.
+//----------------------------------------------------------------------
+enum
+{
+    eEncodedStartOfStatement    = (1u << 0),
+    eEncodedStartOfBasicBlock   = (1u << 1),
+    eEncodedPrologueEnd         = (1u << 2),
+    eEncodedEpilogueBegin       = (1u << 3),
+    eEncodedTerminalEntry       = (1u << 4),
+    eEncodedHasSection          = (1u << 5),
+    eEncodedHasColumn           = (1u << 6),
+    eEncodedHasFile             = (1u << 7)
+};
+
+void
+LineTable::Finalize ()
+{
+    if (m_finalized)
+        return;
+
+    const uint32_t count = m_entries.size();
+    StreamString strm (Stream::eBinary, 4, lldb::endian::InlHostByteOrder());
+    block_collection blocks;
+    blocks.reserve ((count + kEntriesPerBlock - 1) / kEntriesPerBlock);
+
+    Entry prev_entry;
+    for (uint32_t idx = 0; idx < count; ++idx)
+    {
+        const Entry &entry = m_entries[idx];
+        if ((idx % kEntriesPerBlock) == 0)
+        {
+            Block block = { entry.sect_idx, entry.sect_offset, (uint32_t)strm.GetSize() };
+            blocks.push_back (block);
+            prev_entry.Clear();
+        }
+
+        uint8_t flags = 0;
+        if (entry.is_start_of_statement)    flags |= eEncodedStartOfStatement;
+        if (entry.is_start_of_basic_block)  flags |= eEncodedStartOfBasicBlock;
+        if (entry.is_prologue_end)          flags |= eEncodedPrologueEnd;
+        if (entry.is_epilogue_begin)        flags |= eEncodedEpilogueBegin;
+        if (entry.is_terminal_entry)        flags |= eEncodedTerminalEntry;
+        if (entry.sect_idx != prev_entry.sect_idx)  flags |= eEncodedHasSection;
+        if (entry.column != prev_entry.column)      flags |= eEncodedHasColumn;
+        if (entry.file_idx != prev_entry.file_idx)  flags |= eEncodedHasFile;
+        strm.Write (&flags, 1);
+
+        if (flags & eEncodedHasSection)
+        {
+            strm.PutULEB128 (entry.sect_idx);
+            strm.PutULEB128 (entry.sect_offset);
+        }
+        else
+        {
+            strm.PutSLEB128 ((int64_t)entry.sect_offset - (int64_t)prev_entry.sect_offset);
+        }
+        strm.PutSLEB128 ((int64_t)entry.line - (int64_t)prev_entry.line);
+        if (flags & eEncodedHasColumn)
+            strm.PutULEB128 (entry.column);
+        if (flags & eEncodedHasFile)
+            strm.PutULEB128 (entry.file_idx);
+
+        prev_entry = entry;
+    }
+
+    m_blocks.swap (blocks);
+    if (strm.GetSize() > 0)
+    {
+        DataBufferSP data_sp (new DataBufferHeap (strm.GetData(), strm.GetSize()));
+        m_entry_data.SetData (data_sp);
+    }
+    else
+    {
+        m_entry_data.Clear();
+    }
+    m_num_encoded_entries = count;
+    m_finalized = true;
+
+    // Don't just clear the vector, we want its memory back.
+    entry_collection().swap (m_entries);
+}
+
+uint32_t
+LineTable::DecodeBlock (uint32_t block_idx, Entry *entries) const
+{
+    if (block_idx >= m_blocks.size())
+        return 0;
+
+    const uint32_t first_idx = block_idx * kEntriesPerBlock;
+    const uint32_t num_entries = std::min<uint32_t> (kEntriesPerBlock, m_num_encoded_entries - first_idx);
+    uint32_t offset = m_blocks[block_idx].data_offset;
+
+    Entry prev_entry;
+    for (uint32_t i = 0; i < num_entries; ++i)
+    {
+        Entry &entry = entries[i];
+        const uint8_t flags = m_entry_data.GetU8 (&offset);
+        entry.is_start_of_statement = (flags & eEncodedStartOfStatement) != 0;
+        entry.is_start_of_basic_block = (flags & eEncodedStartOfBasicBlock) != 0;
+        entry.is_prologue_end = (flags & eEncodedPrologueEnd) != 0;
+        entry.is_epilogue_begin = (flags & eEncodedEpilogueBegin) != 0;
+        entry.is_terminal_entry = (flags & eEncodedTerminalEntry) != 0;
+        if (flags & eEncodedHasSection)
+        {
+            entry.sect_idx = m_entry_data.GetULEB128 (&offset);
+            entry.sect_offset = m_entry_data.GetULEB128 (&offset);
+        }
+        else
+        {
+            entry.sect_idx = prev_entry.sect_idx;
+            entry.sect_offset = prev_entry.sect_offset + m_entry_data.GetSLEB128 (&offset);
+        }
+        entry.line = prev_entry.line + m_entry_data.GetSLEB128 (&offset);
+        entry.column = (flags & eEncodedHasColumn) ? m_entry_data.GetULEB128 (&offset) : prev_entry.column;
+        entry.file_idx = (flags & eEncodedHasFile) ? m_entry_data.GetULEB128 (&offset) : prev_entry.file_idx;
+        prev_entry = entry;
+    }
+    return num_entries;
+}
+
+void
+LineTable::DecodeAllEntries ()
+{
+    if (!m_finalized)
+        return;
+
+    entry_collection entries (m_num_encoded_entries);
+    const uint32_t num_blocks = m_blocks.size();
+    for (uint32_t block_idx = 0; block_idx < num_blocks; ++block_idx)
+        DecodeBlock (block_idx, &entries[block_idx * kEntriesPerBlock]);
+
+    m_entries.swap (entries);
+    block_collection().swap (m_blocks);
+    m_entry_data.Clear();
+    m_num_encoded_entries = 0;
+    m_finalized = false;
+}
+
+LineTable::EntryDecoder::EntryDecoder (const LineTable &line_table) :
+    m_line_table (line_table),
+    m_block_idx (UINT32_MAX)
+{
+}
+
+const LineTable::Entry &
+LineTable::EntryDecoder::GetEntryAtIndex (uint32_t idx)
+{
+    if (!m_line_table.m_finalized)
+        return m_line_table.m_entries[idx];
+
+    const uint32_t block_idx = idx / kEntriesPerBlock;
+    if (block_idx != m_block_idx)
+    {
+        m_line_table.DecodeBlock (block_idx, m_block_entries);
+        m_block_idx = block_idx;
+    }
+    return m_block_entries[idx % kEntriesPerBlock];
+}
+
 uint32_t
 LineTable::GetSize() const
 {
+    if (m_finalized)
+        return m_num_encoded_entries;
     return m_entries.size();
 }
 
 bool
 LineTable::GetLineEntryAtIndex(uint32_t idx, LineEntry& line_entry)
 {
-    if (idx < m_entries.size())
+    if (idx < GetSize())
     {
         ConvertEntryAtIndexToLineEntry (idx, line_entry);
         return true;
@@ -165,6 +353,38 @@ LineTable::GetLineEntryAtIndex(uint32_t idx, LineEntry& line_entry)
     return false;
 }
 
+uint32_t
+LineTable::FindFirstEntryIndexNotBeforeAddress (EntryDecoder &decoder, const Entry &search_entry) const
+{
+    if (!m_finalized)
+    {
+        entry_collection::const_iterator begin_pos = m_entries.begin();
+        entry_collection::const_iterator end_pos = m_entries.end();
+        return std::distance (begin_pos, std::lower_bound (begin_pos, end_pos, search_entry, Entry::EntryAddressLessThan));
+    }
+
+    // Find the first block that doesn't start before the address. Of the
+    // blocks before it, only the last one can have entries that aren't
+    // before the address.
+    const uint32_t count = GetSize();
+    block_collection::const_iterator block_pos = std::lower_bound (m_blocks.begin(),
+                                                                   m_blocks.end(),
+                                                                   search_entry,
+                                                                   Block::BlockAddressLessThan);
+    const uint32_t block_idx = std::distance (m_blocks.begin(), block_pos);
+    if (block_idx > 0)
+    {
+        const uint32_t first_idx = (block_idx - 1) * kEntriesPerBlock;
+        const uint32_t end_idx = std::min<uint32_t> (first_idx + kEntriesPerBlock, count);
+        for (uint32_t idx = first_idx + 1; idx < end_idx; ++idx)
+        {
+            if (!Entry::EntryAddressLessThan (decoder.GetEntryAtIndex (idx), search_entry))
+                return idx;
+        }
+    }
+    return std::min<uint32_t> (block_idx * kEntriesPerBlock, count);
+}
+
 bool
 LineTable::FindLineEntryByAddress (const Address &so_addr, LineEntry& line_entry, uint32_t *index_ptr)
 {
@@ -179,46 +399,46 @@ LineTable::FindLineEntryByAddress (const Address &so_addr, LineEntry& line_entry
         search_entry.sect_idx = sect_idx;
         search_entry.sect_offset = so_addr.GetOffset();
 
-        entry_collection::const_iterator begin_pos = m_entries.begin();
-        entry_collection::const_iterator end_pos = m_entries.end();
-        entry_collection::const_iterator pos = lower_bound(begin_pos, end_pos, search_entry, Entry::EntryAddressLessThan);
-        if (pos != end_pos)
+        EntryDecoder decoder (*this);
+        const uint32_t count = GetSize();
+        uint32_t idx = FindFirstEntryIndexNotBeforeAddress (decoder, search_entry);
+        if (idx < count)
         {
-            if (pos != begin_pos)
+            if (idx != 0)
             {
-                if (pos->sect_offset != search_entry.sect_offset)
-                    --pos;
-                else if (pos->sect_offset == search_entry.sect_offset)
+                if (decoder.GetEntryAtIndex (idx).sect_offset != search_entry.sect_offset)
+                    --idx;
+                else
                 {
                     // If this is a termination entry, it should't match since
-                    // entries with the "is_terminal_entry" member set to true 
-                    // are termination entries that define the range for the 
+                    // entries with the "is_terminal_entry" member set to true
+                    // are termination entries that define the range for the
                     // previous entry.
-                    if (pos->is_terminal_entry)
+                    if (decoder.GetEntryAtIndex (idx).is_terminal_entry)
                     {
                         // The matching entry is a terminal entry, so we skip
                         // ahead to the next entry to see if there is another
                         // entry following this one whose section/offset matches.
-                        ++pos;
-                        if (pos != end_pos)
+                        ++idx;
+                        if (idx < count)
                         {
-                            if (pos->sect_offset != search_entry.sect_offset)
-                                pos = end_pos;
+                            if (decoder.GetEntryAtIndex (idx).sect_offset != search_entry.sect_offset)
+                                idx = count;
                         }
                     }
-                    
-                    if (pos != end_pos)
+
+                    if (idx < count)
                     {
                         // While in the same section/offset backup to find the first
-                        // line entry that matches the address in case there are 
+                        // line entry that matches the address in case there are
                         // multiple
-                        while (pos != begin_pos)
+                        while (idx != 0)
                         {
-                            entry_collection::const_iterator prev_pos = pos - 1;
-                            if (prev_pos->sect_idx    == search_entry.sect_idx &&
-                                prev_pos->sect_offset == search_entry.sect_offset &&
-                                prev_pos->is_terminal_entry == false)
-                                --pos;
+                            const Entry &prev_entry = decoder.GetEntryAtIndex (idx - 1);
+                            if (prev_entry.sect_idx    == search_entry.sect_idx &&
+                                prev_entry.sect_offset == search_entry.sect_offset &&
+                                prev_entry.is_terminal_entry == false)
+                                --idx;
                             else
                                 break;
                         }
@@ -226,15 +446,14 @@ LineTable::FindLineEntryByAddress (const Address &so_addr, LineEntry& line_entry
                 }
 
             }
-            
+
             // Make sure we have a valid match and that the match isn't a terminating
             // entry for a previous line...
-            if (pos != end_pos && pos->is_terminal_entry == false)
+            if (idx < count && decoder.GetEntryAtIndex (idx).is_terminal_entry == false)
             {
-                uint32_t match_idx = std::distance (begin_pos, pos);
-                success = ConvertEntryAtIndexToLineEntry(match_idx, line_entry);
+                success = ConvertEntryAtIndexToLineEntry(decoder, idx, line_entry);
                 if (index_ptr != NULL && success)
-                    *index_ptr = match_idx;
+                    *index_ptr = idx;
             }
         }
     }
@@ -245,14 +464,24 @@ LineTable::FindLineEntryByAddress (const Address &so_addr, LineEntry& line_entry
 bool
 LineTable::ConvertEntryAtIndexToLineEntry (uint32_t idx, LineEntry &line_entry)
 {
-    if (idx < m_entries.size())
+    EntryDecoder decoder (*this);
+    return ConvertEntryAtIndexToLineEntry (decoder, idx, line_entry);
+}
+
+bool
+LineTable::ConvertEntryAtIndexToLineEntry (EntryDecoder &decoder, uint32_t idx, LineEntry &line_entry)
+{
+    const uint32_t count = GetSize();
+    if (idx < count)
     {
-        const Entry& entry = m_entries[idx];
+        // Copy the entry, getting the next entry below may decode a
+        // different block.
+        const Entry entry (decoder.GetEntryAtIndex (idx));
         line_entry.range.GetBaseAddress().SetSection(m_section_list.GetSectionAtIndex (entry.sect_idx));
         line_entry.range.GetBaseAddress().SetOffset(entry.sect_offset);
-        if (!entry.is_terminal_entry && idx + 1 < m_entries.size())
+        if (!entry.is_terminal_entry && idx + 1 < count)
         {
-            const Entry& next_entry = m_entries[idx+1];
+            const Entry& next_entry = decoder.GetEntryAtIndex (idx + 1);
             if (next_entry.sect_idx == entry.sect_idx)
             {
                 line_entry.range.SetByteSize(next_entry.sect_offset - entry.sect_offset);
@@ -279,28 +508,32 @@ LineTable::ConvertEntryAtIndexToLineEntry (uint32_t idx, LineEntry &line_entry)
 }
 
 uint32_t
-LineTable::FindLineEntryIndexByFileIndex 
+LineTable::FindLineEntryIndexByFileIndex
 (
-    uint32_t start_idx, 
-    const std::vector<uint32_t> &file_indexes, 
-    uint32_t line, 
-    bool exact, 
+    uint32_t start_idx,
+    const std::vector<uint32_t> &file_indexes,
+    uint32_t line,
+    bool exact,
     LineEntry* line_entry_ptr
 )
 {
 
-    const size_t count = m_entries.size();
+    const size_t count = GetSize();
     std::vector<uint32_t>::const_iterator begin_pos = file_indexes.begin();
     std::vector<uint32_t>::const_iterator end_pos = file_indexes.end();
     size_t best_match = UINT32_MAX;
+    uint32_t best_match_line = UINT32_MAX;
+    EntryDecoder decoder (*this);
 
     for (size_t idx = start_idx; idx < count; ++idx)
     {
+        const Entry &entry = decoder.GetEntryAtIndex (idx);
+
         // Skip line table rows that terminate the previous row (is_terminal_entry is non-zero)
-        if (m_entries[idx].is_terminal_entry)
+        if (entry.is_terminal_entry)
             continue;
 
-        if (find (begin_pos, end_pos, m_entries[idx].file_idx) == end_pos)
+        if (find (begin_pos, end_pos, entry.file_idx) == end_pos)
             continue;
 
         // Exact match always wins.  Otherwise try to find the closest line > the desired
@@ -308,29 +541,30 @@ LineTable::FindLineEntryIndexByFileIndex
         // FIXME: Maybe want to find the line closest before and the line closest after and
         // if they're not in the same function, don't return a match.
 
-        if (m_entries[idx].line < line)
+        if (entry.line < line)
         {
             continue;
         }
-        else if (m_entries[idx].line == line)
+        else if (entry.line == line)
         {
             if (line_entry_ptr)
-                ConvertEntryAtIndexToLineEntry (idx, *line_entry_ptr);
+                ConvertEntryAtIndexToLineEntry (decoder, idx, *line_entry_ptr);
             return idx;
         }
         else if (!exact)
         {
-            if (best_match == UINT32_MAX)
-                best_match = idx;
-            else if (m_entries[idx].line < m_entries[best_match].line)
+            if (best_match == UINT32_MAX || entry.line < best_match_line)
+            {
                 best_match = idx;
+                best_match_line = entry.line;
+            }
         }
     }
 
     if (best_match != UINT32_MAX)
     {
         if (line_entry_ptr)
-            ConvertEntryAtIndexToLineEntry (best_match, *line_entry_ptr);
+            ConvertEntryAtIndexToLineEntry (decoder, best_match, *line_entry_ptr);
         return best_match;
     }
     return UINT32_MAX;
@@ -339,16 +573,20 @@ LineTable::FindLineEntryIndexByFileIndex
 uint32_t
 LineTable::FindLineEntryIndexByFileIndex (uint32_t start_idx, uint32_t file_idx, uint32_t line, bool exact, LineEntry* line_entry_ptr)
 {
-    const size_t count = m_entries.size();
+    const size_t count = GetSize();
     size_t best_match = UINT32_MAX;
+    uint32_t best_match_line = UINT32_MAX;
+    EntryDecoder decoder (*this);
 
     for (size_t idx = start_idx; idx < count; ++idx)
     {
+        const Entry &entry = decoder.GetEntryAtIndex (idx);
+
         // Skip line table rows that terminate the previous row (is_terminal_entry is non-zero)
-        if (m_entries[idx].is_terminal_entry)
+        if (entry.is_terminal_entry)
             continue;
 
-        if (m_entries[idx].file_idx != file_idx)
+        if (entry.file_idx != file_idx)
             continue;
 
         // Exact match always wins.  Otherwise try to find the closest line > the desired
@@ -356,58 +594,62 @@ LineTable::FindLineEntryIndexByFileIndex (uint32_t start_idx, uint32_t file_idx,
         // FIXME: Maybe want to find the line closest before and the line closest after and
         // if they're not in the same function, don't return a match.
 
-        if (m_entries[idx].line < line)
+        if (entry.line < line)
         {
             continue;
         }
-        else if (m_entries[idx].line == line)
+        else if (entry.line == line)
         {
             if (line_entry_ptr)
-                ConvertEntryAtIndexToLineEntry (idx, *line_entry_ptr);
+                ConvertEntryAtIndexToLineEntry (decoder, idx, *line_entry_ptr);
             return idx;
         }
         else if (!exact)
         {
-            if (best_match == UINT32_MAX)
-                best_match = idx;
-            else if (m_entries[idx].line < m_entries[best_match].line)
+            if (best_match == UINT32_MAX || entry.line < best_match_line)
+            {
                 best_match = idx;
+                best_match_line = entry.line;
+            }
         }
     }
 
     if (best_match != UINT32_MAX)
     {
         if (line_entry_ptr)
-            ConvertEntryAtIndexToLineEntry (best_match, *line_entry_ptr);
+            ConvertEntryAtIndexToLineEntry (decoder, best_match, *line_entry_ptr);
         return best_match;
     }
     return UINT32_MAX;
 }
 
 size_t
-LineTable::FineLineEntriesForFileIndex (uint32_t file_idx, 
+LineTable::FineLineEntriesForFileIndex (uint32_t file_idx,
                                         bool append,
                                         SymbolContextList &sc_list)
 {
-    
+
     if (!append)
         sc_list.Clear();
 
     size_t num_added = 0;
-    const size_t count = m_entries.size();
+    const size_t count = GetSize();
     if (count > 0)
     {
         SymbolContext sc (m_comp_unit);
+        EntryDecoder decoder (*this);
 
         for (size_t idx = 0; idx < count; ++idx)
         {
+            const Entry &entry = decoder.GetEntryAtIndex (idx);
+
             // Skip line table rows that terminate the previous row (is_terminal_entry is non-zero)
-            if (m_entries[idx].is_terminal_entry)
+            if (entry.is_terminal_entry)
                 continue;
-            
-            if (m_entries[idx].file_idx == file_idx)
+
+            if (entry.file_idx == file_idx)
             {
-                if (ConvertEntryAtIndexToLineEntry (idx, sc.line_entry))
+                if (ConvertEntryAtIndexToLineEntry (decoder, idx, sc.line_entry))
                 {
                     ++num_added;
                     sc_list.Append(sc);
@@ -422,12 +664,13 @@ LineTable::FineLineEntriesForFileIndex (uint32_t file_idx,
 void
 LineTable::Dump (Stream *s, Target *target, Address::DumpStyle style, Address::DumpStyle fallback_style, bool show_line_ranges)
 {
-    const size_t count = m_entries.size();
+    const size_t count = GetSize();
     LineEntry line_entry;
     FileSpec prev_file;
+    EntryDecoder decoder (*this);
     for (size_t idx = 0; idx < count; ++idx)
     {
-        ConvertEntryAtIndexToLineEntry (idx, line_entry);
+        ConvertEntryAtIndexToLineEntry (decoder, idx, line_entry);
         line_entry.Dump (s, target, prev_file != line_entry.file, style, fallback_style, show_line_ranges);
         s->EOL();
         prev_file = line_entry.file;
@@ -438,11 +681,12 @@ LineTable::Dump (Stream *s, Target *target, Address::DumpStyle style, Address::D
 void
 LineTable::GetDescription (Stream *s, Target *target, DescriptionLevel level)
 {
-    const size_t count = m_entries.size();
+    const size_t count = GetSize();
     LineEntry line_entry;
+    EntryDecoder decoder (*this);
     for (size_t idx = 0; idx < count; ++idx)
     {
-        ConvertEntryAtIndexToLineEntry (idx, line_entry);
+        ConvertEntryAtIndexToLineEntry (decoder, idx, line_entry);
         line_entry.GetDescription (s, level, m_comp_unit, target, true);
         s->EOL();
     }
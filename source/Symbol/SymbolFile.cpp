@@ -71,3 +71,9 @@ SymbolFile::GetClangASTContext ()
 {
     return m_obj_file->GetModule()->GetClangASTContext();
 }
+
+lldb::ModuleSP
+SymbolFile::GetClangASTModule ()
+{
+    return m_obj_file->GetModule();
+}
@@ -7,11 +7,18 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <string.h>
+
+#include <algorithm>
 #include <map>
 
+#include "lldb/Core/IndexCache.h"
 #include "lldb/Core/Module.h"
+#include "lldb/Core/StreamString.h"
 #include "lldb/Core/RegularExpression.h"
 #include "lldb/Core/Timer.h"
+#include "lldb/Host/Endian.h"
+#include "lldb/Host/Host.h"
 #include "lldb/Symbol/ObjectFile.h"
 #include "lldb/Symbol/Symtab.h"
 #include "lldb/Target/ObjCLanguageRuntime.h"
@@ -25,7 +32,14 @@ Symtab::Symtab(ObjectFile *objfile) :
     m_objfile (objfile),
     m_symbols (),
     m_addr_indexes (),
-    m_name_to_index (),
+    m_file_addr_to_index (),
+    m_pc_lookup_cache (),
+    m_name_hashes (NULL),
+    m_name_symbol_indexes (NULL),
+    m_name_index_size (0),
+    m_name_hash_storage (),
+    m_name_symbol_idx_storage (),
+    m_name_index_data (),
     m_mutex (Mutex::eMutexTypeRecursive),
     m_addr_indexes_computed (false),
     m_name_indexes_computed (false)
@@ -59,8 +73,10 @@ Symtab::AddSymbol(const Symbol& symbol)
     // Clients should grab the mutex from this symbol table and lock it manually
     // when calling this function to avoid performance issues.
     uint32_t symbol_idx = m_symbols.size();
-    m_name_to_index.Clear();
+    ClearNameIndex();
     m_addr_indexes.clear();
+    m_file_addr_to_index.Clear();
+    m_pc_lookup_cache.clear();
     m_symbols.push_back(symbol);
     m_addr_indexes_computed = false;
     m_name_indexes_computed = false;
@@ -249,6 +265,42 @@ Symtab::SymbolAtIndex(uint32_t idx) const
     return NULL;
 }
 
+// Don't bother creating threads to demangle fewer symbols than this
+#define SYMTAB_MIN_SYMBOLS_PER_WORKER   4096
+
+struct SymtabNameWorkerState
+{
+    const Symbol *symbols;
+    uint32_t start_idx;
+    uint32_t end_idx;
+    const char **objc_base_names;
+};
+
+static lldb::thread_result_t
+SymtabNameWorkerThread (void *arg)
+{
+    SymtabNameWorkerState *state = (SymtabNameWorkerState *)arg;
+    for (uint32_t idx = state->start_idx; idx < state->end_idx; ++idx)
+    {
+        const Symbol *symbol = &state->symbols[idx];
+        if (symbol->IsTrampoline())
+            continue;
+
+        // The demangled name is cached in the symbol's Mangled object and
+        // each worker only touches its own range of symbols, so this
+        // doesn't need to be locked.
+        const char *demangled_cstr = symbol->GetMangled().GetDemangledName().GetCString();
+        ConstString objc_base_name;
+        if (ObjCLanguageRuntime::ParseMethodName (demangled_cstr,
+                                                  NULL,
+                                                  NULL,
+                                                  &objc_base_name,
+                                                  NULL))
+            state->objc_base_names[idx] = objc_base_name.GetCString();
+    }
+    return NULL;
+}
+
 //----------------------------------------------------------------------
 // InitNameIndexes
 //----------------------------------------------------------------------
@@ -260,35 +312,51 @@ Symtab::InitNameIndexes()
     {
         m_name_indexes_computed = true;
         Timer scoped_timer (__PRETTY_FUNCTION__, "%s", __PRETTY_FUNCTION__);
-        // Create the name index vector to be able to quickly search by name
-        const size_t count = m_symbols.size();
-#if 1
-        m_name_to_index.Reserve (count);
-#else
-        // TODO: benchmark this to see if we save any memory. Otherwise we
-        // will always keep the memory reserved in the vector unless we pull
-        // some STL swap magic and then recopy...
-        uint32_t actual_count = 0;
-        for (const_iterator pos = m_symbols.begin(), end = m_symbols.end();
-             pos != end; 
-             ++pos)
+        if (LoadNameIndexFromCache ())
+            return;
+
+        const uint32_t count = m_symbols.size();
+
+        // Demangling is by far the most expensive part of building the
+        // name index so do it, along with parsing ObjC method names, up
+        // front on as many threads as it makes sense to use. Adding the
+        // names to the index is done serially below.
+        std::vector<const char *> objc_base_names (count, NULL);
+        const uint32_t num_workers = std::max<uint32_t> (1, std::min<uint32_t> (Host::GetNumberCPUs(), count / SYMTAB_MIN_SYMBOLS_PER_WORKER));
+        std::vector<SymtabNameWorkerState> workers (num_workers);
+        const uint32_t symbols_per_worker = (count + num_workers - 1) / num_workers;
+        for (uint32_t i=0; i<num_workers; ++i)
         {
-            const Mangled &mangled = pos->GetMangled();
-            if (mangled.GetMangledName())
-                ++actual_count;
-            
-            if (mangled.GetDemangledName())
-                ++actual_count;
+            workers[i].symbols = count > 0 ? &m_symbols[0] : NULL;
+            workers[i].start_idx = std::min<uint32_t> (i * symbols_per_worker, count);
+            workers[i].end_idx = std::min<uint32_t> (workers[i].start_idx + symbols_per_worker, count);
+            workers[i].objc_base_names = count > 0 ? &objc_base_names[0] : NULL;
         }
 
-        m_name_to_index.Reserve (actual_count);
-#endif
+        // The calling thread does the work for the first worker, so only
+        // spawn threads for the rest.
+        std::vector<lldb::thread_t> threads;
+        for (uint32_t i=1; i<num_workers; ++i)
+        {
+            lldb::thread_t thread = Host::ThreadCreate ("<lldb.symtab.demangle>", SymtabNameWorkerThread, &workers[i], NULL);
+            if (IS_VALID_LLDB_HOST_THREAD(thread))
+                threads.push_back (thread);
+            else
+                SymtabNameWorkerThread (&workers[i]);
+        }
 
-        NameToIndexMap::Entry entry;
+        SymtabNameWorkerThread (&workers[0]);
+
+        for (size_t i=0; i<threads.size(); ++i)
+            Host::ThreadJoin (threads[i], NULL, NULL);
+
+        std::vector<NameHashEntry> entries;
+        entries.reserve (count * 2);
+        NameHashEntry entry;
 
-        for (entry.value = 0; entry.value < count; ++entry.value)
+        for (entry.symbol_idx = 0; entry.symbol_idx < count; ++entry.symbol_idx)
         {
-            const Symbol *symbol = &m_symbols[entry.value];
+            const Symbol *symbol = &m_symbols[entry.symbol_idx];
 
             // Don't let trampolines get into the lookup by name map
             // If we ever need the trampoline symbols to be searchable by name
@@ -299,33 +367,110 @@ Symtab::InitNameIndexes()
                 continue;
 
             const Mangled &mangled = symbol->GetMangled();
-            entry.cstring = mangled.GetMangledName().GetCString();
-            if (entry.cstring && entry.cstring[0])
-                m_name_to_index.Append (entry);
+            const char *cstr = mangled.GetMangledName().GetCString();
+            if (cstr && cstr[0])
+            {
+                entry.hash = HashName (cstr);
+                entries.push_back (entry);
+            }
 
-            entry.cstring = mangled.GetDemangledName().GetCString();
-            if (entry.cstring && entry.cstring[0])
-                m_name_to_index.Append (entry);
+            cstr = mangled.GetDemangledName().GetCString();
+            if (cstr && cstr[0])
+            {
+                entry.hash = HashName (cstr);
+                entries.push_back (entry);
+            }
                 
             // If the demangled name turns out to be an ObjC name, and
             // is a category name, add the version without categories to the index too.
-            ConstString objc_base_name;
-            if (ObjCLanguageRuntime::ParseMethodName (entry.cstring,
-                                                      NULL,
-                                                      NULL,
-                                                      &objc_base_name,
-                                                      NULL))
+            cstr = objc_base_names[entry.symbol_idx];
+            if (cstr)
             {
-                entry.cstring = objc_base_name.GetCString();
-                m_name_to_index.Append (entry);
+                entry.hash = HashName (cstr);
+                entries.push_back (entry);
             }
-                                                        
         }
-        m_name_to_index.Sort();
-        m_name_to_index.SizeToFit();
+        std::sort (entries.begin(), entries.end());
+
+        const size_t num_entries = entries.size();
+        m_name_hash_storage.resize (num_entries);
+        m_name_symbol_idx_storage.resize (num_entries);
+        for (size_t i=0; i<num_entries; ++i)
+        {
+            m_name_hash_storage[i] = entries[i].hash;
+            m_name_symbol_idx_storage[i] = entries[i].symbol_idx;
+        }
+        m_name_hashes = num_entries ? &m_name_hash_storage[0] : NULL;
+        m_name_symbol_indexes = num_entries ? &m_name_symbol_idx_storage[0] : NULL;
+        m_name_index_size = num_entries;
+        SaveNameIndexToCache ();
     }
 }
 
+uint64_t
+Symtab::HashName (const char *cstr)
+{
+    // 64 bit FNV-1a. The hashes are saved in the index cache so this must
+    // never change without bumping SYMTAB_INDEX_CACHE_VERSION.
+    uint64_t hash = 14695981039346656037ULL;
+    for (const uint8_t *p = (const uint8_t *)cstr; *p; ++p)
+    {
+        hash ^= *p;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+bool
+Symtab::SymbolHasName (const Symbol &symbol, const ConstString &name)
+{
+    const Mangled &mangled = symbol.GetMangled();
+    if (mangled.GetMangledName() == name)
+        return true;
+    // This will demangle the name if the index was loaded from the cache,
+    // but only for the few symbols whose names have the right hash.
+    if (mangled.GetDemangledName() == name)
+        return true;
+    ConstString objc_base_name;
+    if (ObjCLanguageRuntime::ParseMethodName (mangled.GetDemangledName().GetCString(),
+                                              NULL,
+                                              NULL,
+                                              &objc_base_name,
+                                              NULL))
+        return objc_base_name == name;
+    return false;
+}
+
+size_t
+Symtab::GetNameIndexMatches (const ConstString &name, std::vector<uint32_t> &indexes) const
+{
+    // Protected function, no need to lock mutex...
+    const size_t start_size = indexes.size();
+    const uint64_t hash = HashName (name.GetCString());
+    const uint64_t *begin = m_name_hashes;
+    const uint64_t *end = m_name_hashes + m_name_index_size;
+    for (const uint64_t *pos = std::lower_bound (begin, end, hash); pos != end && *pos == hash; ++pos)
+    {
+        // The hashes are only a prefix of the names, so make sure the
+        // symbol really has the name we are looking for.
+        const uint32_t symbol_idx = m_name_symbol_indexes[pos - begin];
+        if (symbol_idx < m_symbols.size() && SymbolHasName (m_symbols[symbol_idx], name))
+            indexes.push_back (symbol_idx);
+    }
+    return indexes.size() - start_size;
+}
+
+void
+Symtab::ClearNameIndex ()
+{
+    m_name_hashes = NULL;
+    m_name_symbol_indexes = NULL;
+    m_name_index_size = 0;
+    m_name_hash_storage.clear();
+    m_name_symbol_idx_storage.clear();
+    m_name_index_data.Clear();
+}
+
 void
 Symtab::AppendSymbolNamesToMap (const IndexCollection &indexes, 
                                 bool add_demangled,
@@ -520,11 +665,10 @@ Symtab::AppendSymbolIndexesWithName (const ConstString& symbol_name, std::vector
     Timer scoped_timer (__PRETTY_FUNCTION__, "%s", __PRETTY_FUNCTION__);
     if (symbol_name)
     {
-        const char *symbol_cstr = symbol_name.GetCString();
         if (!m_name_indexes_computed)
             InitNameIndexes();
 
-        return m_name_to_index.GetValues (symbol_cstr, indexes);
+        return GetNameIndexMatches (symbol_name, indexes);
     }
     return 0;
 }
@@ -541,10 +685,8 @@ Symtab::AppendSymbolIndexesWithName (const ConstString& symbol_name, Debug symbo
         if (!m_name_indexes_computed)
             InitNameIndexes();
 
-        const char *symbol_cstr = symbol_name.GetCString();
-        
         std::vector<uint32_t> all_name_indexes;
-        const size_t name_match_count = m_name_to_index.GetValues (symbol_cstr, all_name_indexes);
+        const size_t name_match_count = GetNameIndexMatches (symbol_name, all_name_indexes);
         for (size_t i=0; i<name_match_count; ++i)
         {
             if (CheckSymbolAtIndex(all_name_indexes[i], symbol_debug_type, symbol_visibility))
@@ -597,25 +739,44 @@ Symtab::AppendSymbolIndexesWithNameAndType (const ConstString& symbol_name, Symb
 uint32_t
 Symtab::AppendSymbolIndexesMatchingRegExAndType (const RegularExpression &regexp, SymbolType symbol_type, std::vector<uint32_t>& indexes)
 {
-    Mutex::Locker locker (m_mutex);
+    return AppendSymbolIndexesMatchingRegExAndType (regexp, symbol_type, eDebugAny, eVisibilityAny, indexes);
+}
 
-    uint32_t prev_size = indexes.size();
-    uint32_t sym_end = m_symbols.size();
+// Running a regular expression over every name of a big symbol table is
+// slow, so big tables are split into shards that are matched on their
+// own threads. Don't split tables with fewer symbols per shard than this.
+#define SYMTAB_MIN_REGEX_SHARD_SIZE 16384
+
+struct Symtab::RegExMatchShards
+{
+    const Symtab *symtab;
+    const RegularExpression *regex;
+    SymbolType symbol_type;
+    Debug symbol_debug_type;
+    Visibility symbol_visibility;
+    std::vector< std::vector<uint32_t> > indexes;
+};
 
-    for (int i = 0; i < sym_end; i++)
+void
+Symtab::MatchRegExInShard (void *baton, uint32_t shard_idx, size_t begin_idx, size_t end_idx)
+{
+    RegExMatchShards *shards = (RegExMatchShards *)baton;
+    const Symtab *symtab = shards->symtab;
+    // Execute() saves the sub-expression matches in the regular
+    // expression, so each shard needs a copy of its own
+    RegularExpression regex (*shards->regex);
+    std::vector<uint32_t> &indexes = shards->indexes[shard_idx];
+    for (size_t i = begin_idx; i < end_idx; ++i)
     {
-        if (symbol_type == eSymbolTypeAny || m_symbols[i].GetType() == symbol_type)
-        {
-            const char *name = m_symbols[i].GetMangled().GetName().AsCString();
-            if (name)
-            {
-                if (regexp.Execute (name))
-                    indexes.push_back(i);
-            }
-        }
+        const Symbol &symbol = symtab->m_symbols[i];
+        if (shards->symbol_type != eSymbolTypeAny && symbol.GetType() != shards->symbol_type)
+            continue;
+        if (symtab->CheckSymbolAtIndex(i, shards->symbol_debug_type, shards->symbol_visibility) == false)
+            continue;
+        const char *name = symbol.GetMangled().GetName().AsCString();
+        if (name && regex.Execute (name))
+            indexes.push_back(i);
     }
-    return indexes.size() - prev_size;
-
 }
 
 uint32_t
@@ -624,25 +785,23 @@ Symtab::AppendSymbolIndexesMatchingRegExAndType (const RegularExpression &regexp
     Mutex::Locker locker (m_mutex);
 
     uint32_t prev_size = indexes.size();
-    uint32_t sym_end = m_symbols.size();
-
-    for (int i = 0; i < sym_end; i++)
-    {
-        if (symbol_type == eSymbolTypeAny || m_symbols[i].GetType() == symbol_type)
-        {
-            if (CheckSymbolAtIndex(i, symbol_debug_type, symbol_visibility) == false)
-                continue;
-
-            const char *name = m_symbols[i].GetMangled().GetName().AsCString();
-            if (name)
-            {
-                if (regexp.Execute (name))
-                    indexes.push_back(i);
-            }
-        }
-    }
+    const size_t num_symbols = m_symbols.size();
+    const uint32_t num_shards = Host::GetNumberOfShards (num_symbols, SYMTAB_MIN_REGEX_SHARD_SIZE);
+
+    RegExMatchShards shards;
+    shards.symtab = this;
+    shards.regex = &regexp;
+    shards.symbol_type = symbol_type;
+    shards.symbol_debug_type = symbol_debug_type;
+    shards.symbol_visibility = symbol_visibility;
+    shards.indexes.resize (num_shards);
+    Host::RunShards (num_symbols, num_shards, MatchRegExInShard, &shards);
+
+    // The shards are in symbol order, so the indexes come out sorted
+    // just like they would from a single pass
+    for (uint32_t i = 0; i < num_shards; ++i)
+        indexes.insert (indexes.end(), shards.indexes[i].begin(), shards.indexes[i].end());
     return indexes.size() - prev_size;
-
 }
 
 Symbol *
@@ -827,25 +986,204 @@ Symtab::InitAddressIndexes()
     if (!m_addr_indexes_computed && !m_symbols.empty())
     {
         m_addr_indexes_computed = true;
+        if (!LoadIndexFromCache ("symtab-addresses", &m_addr_indexes))
+        {
 #if 0
-        // The old was to add only code, trampoline or data symbols...
-        AppendSymbolIndexesWithType (eSymbolTypeCode, m_addr_indexes);
-        AppendSymbolIndexesWithType (eSymbolTypeTrampoline, m_addr_indexes);
-        AppendSymbolIndexesWithType (eSymbolTypeData, m_addr_indexes);
+            // The old was to add only code, trampoline or data symbols...
+            AppendSymbolIndexesWithType (eSymbolTypeCode, m_addr_indexes);
+            AppendSymbolIndexesWithType (eSymbolTypeTrampoline, m_addr_indexes);
+            AppendSymbolIndexesWithType (eSymbolTypeData, m_addr_indexes);
 #else
-        // The new way adds all symbols with valid addresses that are section
-        // offset.
-        const_iterator begin = m_symbols.begin();
-        const_iterator end = m_symbols.end();
-        for (const_iterator pos = m_symbols.begin(); pos != end; ++pos)
+            // The new way adds all symbols with valid addresses that are section
+            // offset.
+            const_iterator begin = m_symbols.begin();
+            const_iterator end = m_symbols.end();
+            for (const_iterator pos = m_symbols.begin(); pos != end; ++pos)
+            {
+                if (pos->ValueIsAddress())
+                    m_addr_indexes.push_back (std::distance(begin, pos));
+            }
+#endif
+            SortSymbolIndexesByValue (m_addr_indexes, false);
+            m_addr_indexes.push_back (UINT32_MAX);   // Terminator for bsearch since we might need to look at the next symbol
+            SaveIndexToCache ("symtab-addresses", &m_addr_indexes);
+        }
+        InitFileAddressRanges ();
+    }
+}
+
+// The number of entries in the direct mapped cache of file address
+// lookups, this must be a power of two.
+#define SYMTAB_PC_LOOKUP_CACHE_SIZE 256
+
+void
+Symtab::InitFileAddressRanges ()
+{
+    // Protected function, no need to lock mutex...
+    m_file_addr_to_index.Clear();
+    m_pc_lookup_cache.assign (SYMTAB_PC_LOOKUP_CACHE_SIZE, PCLookupEntry());
+
+    // Walk the address sorted symbols one group of symbols with the same
+    // address at a time. Symbols that have no size get the distance to the
+    // next group as their size, the same size CalculateSymbolSize() would
+    // give them, and the first symbol of each group gets an entry in the
+    // range table. The last group has no next address, so a symbol there
+    // with no size is taken to extend to the end of the address space.
+    const uint32_t num_symbols = m_symbols.size();
+    const size_t num_addr_indexes = m_addr_indexes.size();
+    size_t group_start = 0;
+    while (group_start < num_addr_indexes && m_addr_indexes[group_start] < num_symbols)
+    {
+        const uint32_t symbol_idx = m_addr_indexes[group_start];
+        const addr_t file_addr = m_symbols[symbol_idx].GetAddress().GetFileAddress();
+
+        size_t group_end = group_start + 1;
+        addr_t next_file_addr = LLDB_INVALID_ADDRESS;
+        for (; group_end < num_addr_indexes && m_addr_indexes[group_end] < num_symbols; ++group_end)
         {
-            if (pos->ValueIsAddress())
-                m_addr_indexes.push_back (std::distance(begin, pos));
+            const addr_t curr_file_addr = m_symbols[m_addr_indexes[group_end]].GetAddress().GetFileAddress();
+            if (curr_file_addr > file_addr)
+            {
+                next_file_addr = curr_file_addr;
+                break;
+            }
         }
-#endif
-        SortSymbolIndexesByValue (m_addr_indexes, false);
-        m_addr_indexes.push_back (UINT32_MAX);   // Terminator for bsearch since we might need to look at the next symbol
+
+        if (next_file_addr != LLDB_INVALID_ADDRESS)
+        {
+            const uint32_t synthesized_size = std::min<addr_t> (next_file_addr - file_addr, UINT32_MAX);
+            for (size_t i = group_start; i < group_end; ++i)
+            {
+                Symbol &symbol = m_symbols[m_addr_indexes[i]];
+                if (!symbol.GetByteSizeIsValid())
+                {
+                    symbol.SetByteSize (synthesized_size);
+                    symbol.SetSizeIsSynthesized (true);
+                }
+            }
+        }
+
+        const Symbol &symbol = m_symbols[symbol_idx];
+        const addr_t byte_size = symbol.GetByteSizeIsValid() ? symbol.GetByteSize() : LLDB_INVALID_ADDRESS - file_addr;
+        m_file_addr_to_index.Append (FileRangeToIndexMap::Entry (file_addr, byte_size, symbol_idx));
+        group_start = group_end;
+    }
+}
+
+// Bump this whenever the contents or the encoding of the indexes change
+#define SYMTAB_INDEX_CACHE_VERSION  2
+
+bool
+Symtab::LoadNameIndexFromCache ()
+{
+    // Protected function, no need to lock mutex...
+    Module *module = m_objfile ? m_objfile->GetModule().get() : NULL;
+    if (!IndexCache::IsEnabledForModule (module))
+        return false;
+
+    DataExtractor data;
+    uint32_t offset = 0;
+    if (!IndexCache::Load (module, "symtab-names", SYMTAB_INDEX_CACHE_VERSION, data, &offset))
+        return false;
+
+    // Symbols can be added to a symbol table after it has been parsed, so
+    // make sure the cached index was built for the same symbols.
+    if (data.GetU32 (&offset) != m_symbols.size())
+        return false;
+
+    const uint32_t num_entries = data.GetU32 (&offset);
+    const uint8_t *hash_bytes = data.GetData (&offset, num_entries * sizeof(uint64_t));
+    const uint8_t *symbol_idx_bytes = data.GetData (&offset, num_entries * sizeof(uint32_t));
+    if (num_entries > 0 && (hash_bytes == NULL || symbol_idx_bytes == NULL))
+        return false;
+
+    if (((uintptr_t)hash_bytes % sizeof(uint64_t)) == 0)
+    {
+        // Use the index straight out of the memory mapped cache file
+        m_name_index_data = data;
+        m_name_hashes = (const uint64_t *)hash_bytes;
+        m_name_symbol_indexes = (const uint32_t *)symbol_idx_bytes;
+    }
+    else
+    {
+        m_name_hash_storage.resize (num_entries);
+        m_name_symbol_idx_storage.resize (num_entries);
+        if (num_entries > 0)
+        {
+            ::memcpy (&m_name_hash_storage[0], hash_bytes, num_entries * sizeof(uint64_t));
+            ::memcpy (&m_name_symbol_idx_storage[0], symbol_idx_bytes, num_entries * sizeof(uint32_t));
+        }
+        m_name_hashes = num_entries ? &m_name_hash_storage[0] : NULL;
+        m_name_symbol_indexes = num_entries ? &m_name_symbol_idx_storage[0] : NULL;
+    }
+    m_name_index_size = num_entries;
+    return true;
+}
+
+void
+Symtab::SaveNameIndexToCache ()
+{
+    // Protected function, no need to lock mutex...
+    Module *module = m_objfile ? m_objfile->GetModule().get() : NULL;
+    if (!IndexCache::IsEnabledForModule (module))
+        return;
+
+    // The cache file header is a multiple of 8 bytes long and so are the
+    // two counts, so the hashes are properly aligned to be used straight
+    // from the memory mapped file when the index is loaded.
+    StreamString strm (Stream::eBinary, sizeof(void *), lldb::endian::InlHostByteOrder());
+    strm.PutHex32 (m_symbols.size());
+    strm.PutHex32 (m_name_index_size);
+    if (m_name_index_size > 0)
+    {
+        strm.Write (m_name_hashes, m_name_index_size * sizeof(uint64_t));
+        strm.Write (m_name_symbol_indexes, m_name_index_size * sizeof(uint32_t));
     }
+    IndexCache::Save (module, "symtab-names", SYMTAB_INDEX_CACHE_VERSION, strm.GetString());
+}
+
+bool
+Symtab::LoadIndexFromCache (const char *index_name, std::vector<uint32_t> *indexes)
+{
+    // Protected function, no need to lock mutex...
+    Module *module = m_objfile ? m_objfile->GetModule().get() : NULL;
+    if (!IndexCache::IsEnabledForModule (module))
+        return false;
+
+    DataExtractor data;
+    uint32_t offset = 0;
+    if (!IndexCache::Load (module, index_name, SYMTAB_INDEX_CACHE_VERSION, data, &offset))
+        return false;
+
+    // Symbols can be added to a symbol table after it has been parsed, so
+    // make sure the cached index was built for the same symbols.
+    if (data.GetU32 (&offset) != m_symbols.size())
+        return false;
+
+    const uint32_t count = data.GetU32 (&offset);
+    if (!data.ValidOffsetForDataOfSize (offset, count * sizeof(uint32_t)))
+        return false;
+    indexes->resize (count);
+    for (uint32_t i=0; i<count; ++i)
+        (*indexes)[i] = data.GetU32 (&offset);
+    return true;
+}
+
+void
+Symtab::SaveIndexToCache (const char *index_name, const std::vector<uint32_t> *indexes)
+{
+    // Protected function, no need to lock mutex...
+    Module *module = m_objfile ? m_objfile->GetModule().get() : NULL;
+    if (!IndexCache::IsEnabledForModule (module))
+        return;
+
+    StreamString strm (Stream::eBinary, sizeof(void *), lldb::endian::InlHostByteOrder());
+    strm.PutHex32 (m_symbols.size());
+    const uint32_t count = indexes->size();
+    strm.PutHex32 (count);
+    for (uint32_t i=0; i<count; ++i)
+        strm.PutHex32 ((*indexes)[i]);
+    IndexCache::Save (module, index_name, SYMTAB_INDEX_CACHE_VERSION, strm.GetString());
 }
 
 size_t
@@ -909,6 +1247,14 @@ Symtab::CalculateSymbolSize (Symbol *symbol)
     return byte_size;
 }
 
+void
+Symtab::PreloadSymbols ()
+{
+    Mutex::Locker locker (m_mutex);
+    if (!m_name_indexes_computed)
+        InitNameIndexes();
+}
+
 Symbol *
 Symtab::FindSymbolWithFileAddress (addr_t file_addr)
 {
@@ -976,6 +1322,18 @@ Symtab::FindSymbolContainingFileAddress (addr_t file_addr)
     if (!m_addr_indexes_computed)
         InitAddressIndexes();
 
-    return FindSymbolContainingFileAddress (file_addr, &m_addr_indexes[0], m_addr_indexes.size());
+    if (m_pc_lookup_cache.empty())
+        return NULL;
+
+    // Symbolicating samples looks up the same addresses over and over, so
+    // remember the results of recent lookups.
+    PCLookupEntry &cache_entry = m_pc_lookup_cache[(file_addr ^ (file_addr >> 12)) & (SYMTAB_PC_LOOKUP_CACHE_SIZE - 1)];
+    if (cache_entry.file_addr != file_addr)
+    {
+        const FileRangeToIndexMap::Entry *entry = m_file_addr_to_index.FindClosestEntryThatContains (file_addr);
+        cache_entry.file_addr = file_addr;
+        cache_entry.symbol_idx = entry ? entry->data : UINT32_MAX;
+    }
+    return SymbolAtIndex (cache_entry.symbol_idx);
 }
 
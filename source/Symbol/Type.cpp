@@ -479,6 +479,17 @@ Type::GetDeclaration () const
 bool
 Type::ResolveClangType (ResolveState clang_type_resolve_state)
 {
+    // Types can be completed by the process' type pre-warm thread while
+    // the main thread is using them, so make sure only one thread at a
+    // time is modifying the clang AST. Lock the module that owns the
+    // AST, which isn't the type's module for .o files in a debug map.
+    Mutex::Locker locker;
+    ModuleSP module_sp;
+    if (m_symbol_file)
+        module_sp = m_symbol_file->GetClangASTModule();
+    if (module_sp)
+        locker.Lock (module_sp->GetMutex());
+
     Type *encoding_type = NULL;
     if (m_clang_type == NULL)
     {
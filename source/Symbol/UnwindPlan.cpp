@@ -10,6 +10,7 @@
 #include "lldb/Symbol/UnwindPlan.h"
 
 #include "lldb/Core/ConstString.h"
+#include "lldb/Core/DataExtractor.h"
 #include "lldb/Target/Process.h"
 #include "lldb/Target/RegisterContext.h"
 #include "lldb/Target/Thread.h"
@@ -17,6 +18,19 @@
 using namespace lldb;
 using namespace lldb_private;
 
+static bool
+ConvertRegisterNumber (RegisterContext *reg_ctx, RegisterKind from_kind, uint32_t reg_num, RegisterKind to_kind, uint32_t &converted_reg_num)
+{
+    if (from_kind == to_kind)
+    {
+        converted_reg_num = reg_num;
+        return true;
+    }
+    if (reg_ctx == NULL)
+        return false;
+    return reg_ctx->ConvertBetweenRegisterKinds (from_kind, reg_num, to_kind, converted_reg_num);
+}
+
 bool
 UnwindPlan::Row::RegisterLocation::operator == (const UnwindPlan::Row::RegisterLocation& rhs) const
 {
@@ -295,6 +309,87 @@ UnwindPlan::Row::SetCFARegister (uint32_t reg_num)
     m_cfa_reg_num = reg_num;
 }
 
+bool
+UnwindPlan::Row::Encode (Stream &strm, RegisterContext *reg_ctx, RegisterKind from_kind, RegisterKind to_kind) const
+{
+    uint32_t cfa_reg_num;
+    if (!ConvertRegisterNumber (reg_ctx, from_kind, m_cfa_reg_num, to_kind, cfa_reg_num))
+        return false;
+
+    strm.PutHex64 (m_offset);
+    strm.PutHex32 (cfa_reg_num);
+    strm.PutHex32 (m_cfa_offset);
+    strm.PutHex32 (m_register_locations.size());
+    for (collection::const_iterator pos = m_register_locations.begin(); pos != m_register_locations.end(); ++pos)
+    {
+        uint32_t reg_num;
+        if (!ConvertRegisterNumber (reg_ctx, from_kind, pos->first, to_kind, reg_num))
+            return false;
+
+        const RegisterLocation &reg_loc = pos->second;
+        uint32_t value = 0;
+        switch (reg_loc.GetLocationType())
+        {
+            case RegisterLocation::unspecified:
+            case RegisterLocation::undefined:
+            case RegisterLocation::same:
+                break;
+
+            case RegisterLocation::atCFAPlusOffset:
+            case RegisterLocation::isCFAPlusOffset:
+                value = reg_loc.GetOffset();
+                break;
+
+            case RegisterLocation::inOtherRegister:
+                if (!ConvertRegisterNumber (reg_ctx, from_kind, reg_loc.GetRegisterNumber(), to_kind, value))
+                    return false;
+                break;
+
+            case RegisterLocation::atDWARFExpression:
+            case RegisterLocation::isDWARFExpression:
+                return false;
+        }
+        strm.PutHex32 (reg_num);
+        strm.PutHex8 (reg_loc.GetLocationType());
+        strm.PutHex32 (value);
+    }
+    return true;
+}
+
+bool
+UnwindPlan::Row::Decode (const DataExtractor &data, uint32_t *offset_ptr)
+{
+    Clear();
+    if (!data.ValidOffsetForDataOfSize (*offset_ptr, 20))
+        return false;
+    m_offset = data.GetU64 (offset_ptr);
+    m_cfa_reg_num = data.GetU32 (offset_ptr);
+    m_cfa_offset = data.GetU32 (offset_ptr);
+    const uint32_t num_locations = data.GetU32 (offset_ptr);
+    for (uint32_t i=0; i<num_locations; ++i)
+    {
+        if (!data.ValidOffsetForDataOfSize (*offset_ptr, 9))
+            return false;
+        const uint32_t reg_num = data.GetU32 (offset_ptr);
+        const uint8_t type = data.GetU8 (offset_ptr);
+        const uint32_t value = data.GetU32 (offset_ptr);
+        RegisterLocation reg_loc;
+        switch (type)
+        {
+            case RegisterLocation::unspecified:     reg_loc.SetUnspecified(); break;
+            case RegisterLocation::undefined:       reg_loc.SetUndefined(); break;
+            case RegisterLocation::same:            reg_loc.SetSame(); break;
+            case RegisterLocation::atCFAPlusOffset: reg_loc.SetAtCFAPlusOffset (value); break;
+            case RegisterLocation::isCFAPlusOffset: reg_loc.SetIsCFAPlusOffset (value); break;
+            case RegisterLocation::inOtherRegister: reg_loc.SetInRegister (value); break;
+            default:
+                return false;
+        }
+        m_register_locations[reg_num] = reg_loc;
+    }
+    return true;
+}
+
 bool
 UnwindPlan::Row::operator == (const UnwindPlan::Row& rhs) const
 {
@@ -407,6 +502,98 @@ UnwindPlan::Dump (Stream& s, Thread *thread, lldb::addr_t base_addr) const
     }
 }
 
+bool
+UnwindPlan::Encode (Stream &strm, const Address &base_addr, RegisterContext *reg_ctx, RegisterKind reg_kind) const
+{
+    uint32_t return_addr_register = LLDB_INVALID_REGNUM;
+    if (m_return_addr_register != LLDB_INVALID_REGNUM &&
+        !ConvertRegisterNumber (reg_ctx, m_register_kind, m_return_addr_register, reg_kind, return_addr_register))
+        return false;
+
+    strm.PutHex32 (reg_kind);
+    strm.PutHex32 (return_addr_register);
+    const char *source_name = m_source_name.AsCString("");
+    strm.Write (source_name, ::strlen (source_name) + 1);
+
+    const addr_t base_file_addr = base_addr.GetFileAddress();
+    const addr_t range_file_addr = m_plan_valid_address_range.GetBaseAddress().GetFileAddress();
+    if (base_file_addr != LLDB_INVALID_ADDRESS && range_file_addr != LLDB_INVALID_ADDRESS && m_plan_valid_address_range.GetByteSize() > 0)
+    {
+        strm.PutHex8 (1);
+        strm.PutHex64 (range_file_addr - base_file_addr);
+        strm.PutHex64 (m_plan_valid_address_range.GetByteSize());
+    }
+    else
+    {
+        strm.PutHex8 (0);
+    }
+
+    strm.PutHex32 (m_row_list.size());
+    for (collection::const_iterator pos = m_row_list.begin(); pos != m_row_list.end(); ++pos)
+    {
+        if (!(*pos)->Encode (strm, reg_ctx, m_register_kind, reg_kind))
+            return false;
+    }
+    return true;
+}
+
+bool
+UnwindPlan::Decode (const DataExtractor &data, uint32_t *offset_ptr, const Address &base_addr)
+{
+    Clear();
+    if (!data.ValidOffsetForDataOfSize (*offset_ptr, 8))
+        return false;
+    m_register_kind = (RegisterKind)data.GetU32 (offset_ptr);
+    m_return_addr_register = data.GetU32 (offset_ptr);
+    const char *source_name = data.GetCStr (offset_ptr);
+    if (source_name == NULL || !data.ValidOffsetForDataOfSize (*offset_ptr, 1))
+    {
+        Clear();
+        return false;
+    }
+    if (source_name[0])
+        m_source_name.SetCString (source_name);
+
+    if (data.GetU8 (offset_ptr))
+    {
+        if (!data.ValidOffsetForDataOfSize (*offset_ptr, 16))
+        {
+            Clear();
+            return false;
+        }
+        const int64_t range_offset = data.GetU64 (offset_ptr);
+        const addr_t range_size = data.GetU64 (offset_ptr);
+        Address range_addr (base_addr);
+        range_addr.SetOffset (range_addr.GetOffset() + range_offset);
+        SetPlanValidAddressRange (AddressRange (range_addr, range_size));
+    }
+
+    if (!data.ValidOffsetForDataOfSize (*offset_ptr, 4))
+    {
+        Clear();
+        return false;
+    }
+    const uint32_t num_rows = data.GetU32 (offset_ptr);
+    // Each row is at least 20 bytes
+    if ((uint64_t)num_rows * 20 > data.GetByteSize())
+    {
+        Clear();
+        return false;
+    }
+    m_row_list.reserve (num_rows);
+    for (uint32_t i=0; i<num_rows; ++i)
+    {
+        RowSP row_sp (new Row);
+        if (!row_sp->Decode (data, offset_ptr))
+        {
+            Clear();
+            return false;
+        }
+        m_row_list.push_back (row_sp);
+    }
+    return true;
+}
+
 void
 UnwindPlan::SetSourceName (const char *source)
 {
@@ -11,12 +11,21 @@
 
 #include <stdio.h>
 
+#include <algorithm>
+#include <vector>
+
+#include "lldb/Core/IndexCache.h"
 #include "lldb/Core/Module.h"
 #include "lldb/Core/Section.h"
+#include "lldb/Core/StreamString.h"
+#include "lldb/Host/Endian.h"
 #include "lldb/Symbol/ObjectFile.h"
 #include "lldb/Symbol/FuncUnwinders.h"
 #include "lldb/Symbol/SymbolContext.h"
 #include "lldb/Symbol/DWARFCallFrameInfo.h"
+#include "lldb/Symbol/UnwindPlan.h"
+#include "lldb/Target/RegisterContext.h"
+#include "lldb/Target/Thread.h"
 #include "lldb/Target/UnwindAssembly.h"
 
 // There is one UnwindTable object per ObjectFile.
@@ -26,10 +35,26 @@
 using namespace lldb;
 using namespace lldb_private;
 
+// The number of FuncUnwinders objects an UnwindTable keeps before it
+// starts to throw away the least recently used quarter of them.
+#define UNWIND_TABLE_MAX_FUNC_UNWINDERS 16384
+
+// Bump this when the encoding of the profiled UnwindPlans changes
+#define PROFILED_UNWIND_PLANS_CACHE_VERSION 1
+
+// Profiled UnwindPlans are written to the cache each time this many new
+// ones have been made, and when the module goes away
+#define PROFILED_UNWIND_PLANS_SAVE_INTERVAL 64
+
 UnwindTable::UnwindTable (ObjectFile& objfile) : 
     m_object_file (objfile), 
     m_unwinds (),
+    m_use_count (0),
+    m_mutex (Mutex::eMutexTypeRecursive),
     m_initialized (false),
+    m_profiled_plans_loaded (false),
+    m_num_unsaved_profiled_plans (0),
+    m_profiled_plans (),
     m_assembly_profiler (NULL),
     m_eh_frame (NULL)
 {
@@ -41,6 +66,7 @@ UnwindTable::UnwindTable (ObjectFile& objfile) :
 void
 UnwindTable::Initialize ()
 {
+    Mutex::Locker locker (m_mutex);
     if (m_initialized)
         return;
 
@@ -73,6 +99,7 @@ UnwindTable::GetFuncUnwindersContainingAddress (const Address& addr, SymbolConte
 {
     FuncUnwindersSP no_unwind_found;
 
+    Mutex::Locker locker (m_mutex);
     Initialize();
 
     // There is an UnwindTable per object file, so we can safely use file handles
@@ -83,11 +110,14 @@ UnwindTable::GetFuncUnwindersContainingAddress (const Address& addr, SymbolConte
     {
         insert_pos = m_unwinds.lower_bound (file_addr);
         iterator pos = insert_pos;
-        if ((pos == m_unwinds.end ()) || (pos != m_unwinds.begin() && pos->second->GetFunctionStartAddress() != addr))
+        if ((pos == m_unwinds.end ()) || (pos != m_unwinds.begin() && pos->second.func_unwinders_sp->GetFunctionStartAddress() != addr))
             --pos;
 
-        if (pos->second->ContainsAddress (addr))
-            return pos->second;
+        if (pos->second.func_unwinders_sp->ContainsAddress (addr))
+        {
+            pos->second.last_use = ++m_use_count;
+            return pos->second.func_unwinders_sp;
+        }
     }
 
     AddressRange range;
@@ -100,13 +130,41 @@ UnwindTable::GetFuncUnwindersContainingAddress (const Address& addr, SymbolConte
         }
     }
 
-    FuncUnwindersSP func_unwinder_sp(new FuncUnwinders(*this, m_assembly_profiler, range));
-    m_unwinds.insert (insert_pos, std::make_pair(range.GetBaseAddress().GetFileAddress(), func_unwinder_sp));
+    FuncUnwindersSP func_unwinder_sp(new FuncUnwinders(*this, m_assembly_profiler, range, true));
+    FuncUnwindersEntry entry;
+    entry.func_unwinders_sp = func_unwinder_sp;
+    entry.last_use = ++m_use_count;
+    m_unwinds.insert (insert_pos, std::make_pair(range.GetBaseAddress().GetFileAddress(), entry));
+    if (m_unwinds.size() > UNWIND_TABLE_MAX_FUNC_UNWINDERS)
+        TrimFuncUnwinders ();
 //    StreamFile s(stdout);
 //    Dump (s);
     return func_unwinder_sp;
 }
 
+void
+UnwindTable::TrimFuncUnwinders ()
+{
+    // Protected function, m_mutex must be locked. Anyone still using a
+    // FuncUnwinders we drop keeps it alive with their shared pointer.
+    std::vector<uint32_t> last_uses;
+    last_uses.reserve (m_unwinds.size());
+    for (const_iterator pos = m_unwinds.begin(); pos != m_unwinds.end(); ++pos)
+        last_uses.push_back (pos->second.last_use);
+    std::vector<uint32_t>::iterator cutoff_pos = last_uses.begin() + last_uses.size() / 4;
+    std::nth_element (last_uses.begin(), cutoff_pos, last_uses.end());
+    const uint32_t cutoff = *cutoff_pos;
+
+    iterator pos = m_unwinds.begin();
+    while (pos != m_unwinds.end())
+    {
+        if (pos->second.last_use < cutoff)
+            m_unwinds.erase (pos++);
+        else
+            ++pos;
+    }
+}
+
 // Ignore any existing FuncUnwinders for this function, create a new one and don't add it to the
 // UnwindTable.  This is intended for use by target modules show-unwind where we want to create 
 // new UnwindPlans, not re-use existing ones.
@@ -115,6 +173,7 @@ FuncUnwindersSP
 UnwindTable::GetUncachedFuncUnwindersContainingAddress (const Address& addr, SymbolContext &sc)
 {
     FuncUnwindersSP no_unwind_found;
+    Mutex::Locker locker (m_mutex);
     Initialize();
 
     AddressRange range;
@@ -127,14 +186,145 @@ UnwindTable::GetUncachedFuncUnwindersContainingAddress (const Address& addr, Sym
         }
     }
 
-    FuncUnwindersSP func_unwinder_sp(new FuncUnwinders(*this, m_assembly_profiler, range));
+    FuncUnwindersSP func_unwinder_sp(new FuncUnwinders(*this, m_assembly_profiler, range, false));
     return func_unwinder_sp;
 }
 
 
+void
+UnwindTable::LoadProfiledUnwindPlans ()
+{
+    // Protected function, m_mutex must be locked
+    if (m_profiled_plans_loaded)
+        return;
+    m_profiled_plans_loaded = true;
+
+    Module *module = m_object_file.GetModule().get();
+    if (!IndexCache::IsEnabledForModule (module))
+        return;
+
+    DataExtractor data;
+    uint32_t offset = 0;
+    if (!IndexCache::Load (module, "profiled-unwind-plans", PROFILED_UNWIND_PLANS_CACHE_VERSION, data, &offset))
+        return;
+
+    if (!data.ValidOffsetForDataOfSize (offset, 4))
+        return;
+    const uint32_t num_entries = data.GetU32 (&offset);
+    for (uint32_t i=0; i<num_entries; ++i)
+    {
+        if (!data.ValidOffsetForDataOfSize (offset, 16))
+            break;
+        const addr_t func_file_addr = data.GetU64 (&offset);
+        ProfiledUnwindPlanEntry entry;
+        entry.byte_size = data.GetU64 (&offset);
+        for (uint32_t kind=0; kind<kNumProfiledUnwindPlanKinds; ++kind)
+        {
+            if (!data.ValidOffsetForDataOfSize (offset, 4))
+                return;
+            const uint32_t plan_size = data.GetU32 (&offset);
+            if (plan_size == 0)
+                continue;
+            const char *plan_bytes = (const char *)data.GetData (&offset, plan_size);
+            if (plan_bytes == NULL)
+                return;
+            entry.encoded_plans[kind].assign (plan_bytes, plan_size);
+        }
+        // Plans made in this session are newer
+        m_profiled_plans.insert (std::make_pair (func_file_addr, entry));
+    }
+}
+
+void
+UnwindTable::EncodeProfiledUnwindPlans (std::string &data)
+{
+    // Protected function, m_mutex must be locked
+    StreamString strm (Stream::eBinary, sizeof(void *), lldb::endian::InlHostByteOrder());
+    strm.PutHex32 (m_profiled_plans.size());
+    ProfiledUnwindPlanMap::const_iterator pos, end = m_profiled_plans.end();
+    for (pos = m_profiled_plans.begin(); pos != end; ++pos)
+    {
+        strm.PutHex64 (pos->first);
+        strm.PutHex64 (pos->second.byte_size);
+        for (uint32_t kind=0; kind<kNumProfiledUnwindPlanKinds; ++kind)
+        {
+            const std::string &plan = pos->second.encoded_plans[kind];
+            strm.PutHex32 (plan.size());
+            strm.Write (plan.data(), plan.size());
+        }
+    }
+    data.swap (strm.GetString());
+}
+
+bool
+UnwindTable::GetProfiledUnwindPlan (const AddressRange &func_range, ProfiledUnwindPlanKind kind, UnwindPlan &unwind_plan)
+{
+    Mutex::Locker locker (m_mutex);
+    LoadProfiledUnwindPlans ();
+
+    ProfiledUnwindPlanMap::const_iterator pos = m_profiled_plans.find (func_range.GetBaseAddress().GetFileAddress());
+    if (pos == m_profiled_plans.end() || pos->second.byte_size != func_range.GetByteSize())
+        return false;
+
+    const std::string &plan = pos->second.encoded_plans[kind];
+    if (plan.empty())
+        return false;
+    DataExtractor data (plan.data(), plan.size(), lldb::endian::InlHostByteOrder(), sizeof(void *));
+    uint32_t offset = 0;
+    return unwind_plan.Decode (data, &offset, func_range.GetBaseAddress());
+}
+
+void
+UnwindTable::AddProfiledUnwindPlan (const AddressRange &func_range, ProfiledUnwindPlanKind kind, const UnwindPlan &unwind_plan, Thread &thread)
+{
+    Module *module = m_object_file.GetModule().get();
+    if (!IndexCache::IsEnabledForModule (module))
+        return;
+
+    // The lldb register numbers the x86 profiler uses depend on the process
+    // plugin, the DWARF ones don't
+    StreamString strm (Stream::eBinary, sizeof(void *), lldb::endian::InlHostByteOrder());
+    if (!unwind_plan.Encode (strm, func_range.GetBaseAddress(), thread.GetRegisterContext().get(), eRegisterKindDWARF))
+        return;
+
+    std::string data;
+    {
+        Mutex::Locker locker (m_mutex);
+        LoadProfiledUnwindPlans ();
+        ProfiledUnwindPlanEntry &entry = m_profiled_plans[func_range.GetBaseAddress().GetFileAddress()];
+        if (entry.byte_size != func_range.GetByteSize())
+        {
+            for (uint32_t i=0; i<kNumProfiledUnwindPlanKinds; ++i)
+                entry.encoded_plans[i].clear();
+            entry.byte_size = func_range.GetByteSize();
+        }
+        entry.encoded_plans[kind].swap (strm.GetString());
+        if (++m_num_unsaved_profiled_plans < PROFILED_UNWIND_PLANS_SAVE_INTERVAL)
+            return;
+        m_num_unsaved_profiled_plans = 0;
+        EncodeProfiledUnwindPlans (data);
+    }
+    IndexCache::Save (module, "profiled-unwind-plans", PROFILED_UNWIND_PLANS_CACHE_VERSION, data);
+}
+
+void
+UnwindTable::SaveProfiledUnwindPlans (Module *module)
+{
+    std::string data;
+    {
+        Mutex::Locker locker (m_mutex);
+        if (m_num_unsaved_profiled_plans == 0)
+            return;
+        m_num_unsaved_profiled_plans = 0;
+        EncodeProfiledUnwindPlans (data);
+    }
+    IndexCache::Save (module, "profiled-unwind-plans", PROFILED_UNWIND_PLANS_CACHE_VERSION, data);
+}
+
 void
 UnwindTable::Dump (Stream &s)
 {
+    Mutex::Locker locker (m_mutex);
     s.Printf("UnwindTable for %s/%s:\n", m_object_file.GetFileSpec().GetDirectory().GetCString(), m_object_file.GetFileSpec().GetFilename().GetCString());
     const_iterator begin = m_unwinds.begin();
     const_iterator end = m_unwinds.end();
@@ -10,16 +10,33 @@
 #include "lldb/Target/Memory.h"
 // C Includes
 // C++ Includes
+#include <set>
+#include <vector>
 // Other libraries and framework includes
 // Project includes
 #include "lldb/Core/DataBufferHeap.h"
 #include "lldb/Core/State.h"
+#include "lldb/Core/Statistics.h"
 #include "lldb/Core/Log.h"
+#include "lldb/Core/Stream.h"
 #include "lldb/Target/Process.h"
 
 using namespace lldb;
 using namespace lldb_private;
 
+// The most cache lines we will read ahead of a sequential access pattern
+#define MAX_PREFETCH_LINES  64
+
+// The smallest page AllocatedMemoryCache asks the process for, so that the
+// code and data of many expressions share a page instead of each one
+// costing an allocation in the process
+#define MIN_ALLOCATED_PAGE_BYTE_SIZE    (64 * 1024)
+
+// The size of each region AllocatedMemoryArena reserves, and the alignment
+// of the blocks it hands out
+#define ARENA_REGION_BYTE_SIZE          (64 * 1024)
+#define ARENA_ALIGNMENT                 16
+
 //----------------------------------------------------------------------
 // MemoryCache constructor
 //----------------------------------------------------------------------
@@ -27,7 +44,13 @@ MemoryCache::MemoryCache(Process &process) :
     m_process (process),
     m_cache_line_byte_size (512),
     m_mutex (Mutex::eMutexTypeRecursive),
+    m_L1_cache (),
     m_cache (),
+    m_lru (),
+    m_cache_byte_size (0),
+    m_next_sequential_addr (LLDB_INVALID_ADDRESS),
+    m_prefetch_lines (0),
+    m_stats (),
     m_invalid_ranges ()
 {
 }
@@ -43,7 +66,21 @@ void
 MemoryCache::Clear()
 {
     Mutex::Locker locker (m_mutex);
+    m_L1_cache.clear();
     m_cache.clear();
+    m_lru.clear();
+    m_cache_byte_size = 0;
+    m_next_sequential_addr = LLDB_INVALID_ADDRESS;
+    m_prefetch_lines = 0;
+}
+
+void
+MemoryCache::AddL1CacheData (addr_t addr, const void *src, size_t src_len)
+{
+    if (src == NULL || src_len == 0)
+        return;
+    Mutex::Locker locker (m_mutex);
+    m_L1_cache[addr] = DataBufferSP (new DataBufferHeap (src, src_len));
 }
 
 void
@@ -53,6 +90,23 @@ MemoryCache::Flush (addr_t addr, size_t size)
         return;
 
     Mutex::Locker locker (m_mutex);
+
+    if (!m_L1_cache.empty())
+    {
+        // Remove any L1 blocks that overlap the flushed range
+        const addr_t flush_end_addr = addr + size;
+        L1CacheMap::iterator pos = m_L1_cache.upper_bound (addr);
+        if (pos != m_L1_cache.begin())
+            --pos;
+        while (pos != m_L1_cache.end() && pos->first < flush_end_addr)
+        {
+            if (pos->first + pos->second->GetByteSize() > addr)
+                m_L1_cache.erase (pos++);
+            else
+                ++pos;
+        }
+    }
+
     if (m_cache.empty())
         return;
 
@@ -68,17 +122,14 @@ MemoryCache::Flush (addr_t addr, size_t size)
     else
         num_cache_lines = (UINT64_MAX - first_cache_line_addr + 1)/cache_line_byte_size;
 
-    //printf ("MemoryCache::Flush (0x%16.16llx, %zu (0x%zx))\n", addr, size, size);
-
     uint32_t cache_idx = 0;
     for (addr_t curr_addr = first_cache_line_addr;
          cache_idx < num_cache_lines;
          curr_addr += cache_line_byte_size, ++cache_idx)
     {
-        //printf ("flushing: 0x%16.16llx\n", curr_addr); /// REMOVE THIS PRIOR TO CHECKIN!!!!
         BlockMap::iterator pos = m_cache.find (curr_addr);
         if (pos != m_cache.end())
-            m_cache.erase(pos);
+            RemoveCacheLine (pos);
     }
 }
 
@@ -111,7 +162,156 @@ MemoryCache::RemoveInvalidRange (lldb::addr_t base_addr, lldb::addr_t byte_size)
     return false;
 }
 
+MemoryCache::Statistics
+MemoryCache::GetStatistics () const
+{
+    Mutex::Locker locker (m_mutex);
+    return m_stats;
+}
+
+size_t
+MemoryCache::GetCachedByteSize () const
+{
+    Mutex::Locker locker (m_mutex);
+    return m_cache_byte_size;
+}
+
+void
+MemoryCache::DumpStatistics (Stream &strm) const
+{
+    Mutex::Locker locker (m_mutex);
+    const uint64_t memory_cache_size = m_process.GetMemoryCacheSize();
+    const uint64_t total_lines = m_stats.line_hits + m_stats.line_misses;
+    strm.Printf ("Cache line size:    %u bytes\n", m_cache_line_byte_size);
+    if (memory_cache_size)
+        strm.Printf ("Cached memory:      %zu bytes (%zu lines) of %llu bytes\n", m_cache_byte_size, m_cache.size(), memory_cache_size);
+    else
+        strm.Printf ("Cached memory:      %zu bytes (%zu lines), no size limit\n", m_cache_byte_size, m_cache.size());
+    strm.Printf ("L1 cached blocks:   %zu\n", m_L1_cache.size());
+    strm.Printf ("L1 hits:            %llu\n", m_stats.l1_hits);
+    strm.Printf ("Cache line hits:    %llu\n", m_stats.line_hits);
+    strm.Printf ("Cache line misses:  %llu\n", m_stats.line_misses);
+    if (total_lines > 0)
+        strm.Printf ("Hit rate:           %.1f%%\n", (double)m_stats.line_hits * 100.0 / (double)total_lines);
+    strm.Printf ("Prefetched lines:   %llu\n", m_stats.prefetched_lines);
+    strm.Printf ("Evicted lines:      %llu\n", m_stats.evicted_lines);
+    strm.Printf ("Process reads:      %llu (%llu bytes)\n", m_stats.process_reads, m_stats.process_bytes);
+}
+
+void
+MemoryCache::AddCacheLine (addr_t line_addr, const DataBufferSP &data_sp)
+{
+    BlockMap::iterator pos = m_cache.find (line_addr);
+    if (pos != m_cache.end())
+        RemoveCacheLine (pos);
+    CacheLine &line = m_cache[line_addr];
+    line.data_sp = data_sp;
+    line.lru_pos = m_lru.insert (m_lru.end(), line_addr);
+    m_cache_byte_size += data_sp->GetByteSize();
+}
+
+void
+MemoryCache::RemoveCacheLine (BlockMap::iterator pos)
+{
+    m_cache_byte_size -= pos->second.data_sp->GetByteSize();
+    m_lru.erase (pos->second.lru_pos);
+    m_cache.erase (pos);
+}
+
+void
+MemoryCache::EvictCacheLinesIfNeeded (size_t num_protected_lines)
+{
+    const uint64_t memory_cache_size = m_process.GetMemoryCacheSize();
+    if (memory_cache_size == 0)
+        return;
+
+    // The most recently used lines are at the end of the LRU list, so
+    // the lines that were just read in are never evicted.
+    while (m_cache_byte_size > memory_cache_size && m_lru.size() > num_protected_lines)
+    {
+        BlockMap::iterator pos = m_cache.find (m_lru.front());
+        assert (pos != m_cache.end());
+        RemoveCacheLine (pos);
+        ++m_stats.evicted_lines;
+    }
+}
+
+size_t
+MemoryCache::ReadCacheLinesFromProcess (addr_t line_addr,
+                                        size_t num_lines,
+                                        size_t num_needed_lines,
+                                        Error &error)
+{
+    const uint32_t cache_line_byte_size = m_cache_line_byte_size;
+
+    // Stop at the first line we already have or that is in an invalid
+    // range so we never read memory twice or read invalid memory.
+    BlockMap::const_iterator next_cached_pos = m_cache.upper_bound (line_addr);
+    size_t num_lines_to_read = 1;
+    while (num_lines_to_read < num_lines)
+    {
+        const addr_t next_line_addr = line_addr + num_lines_to_read * cache_line_byte_size;
+        if (next_line_addr < line_addr)
+            break;  // We wrapped around the end of the address space
+        if (next_cached_pos != m_cache.end() && next_cached_pos->first <= next_line_addr)
+            break;
+        if (m_invalid_ranges.FindEntryThatContains (next_line_addr))
+            break;
+        ++num_lines_to_read;
+    }
+    if (num_needed_lines > num_lines_to_read)
+        num_needed_lines = num_lines_to_read;
+
+    DataBufferHeap data_buffer (num_lines_to_read * cache_line_byte_size, 0);
+    size_t bytes_read = m_process.ReadMemoryFromInferior (line_addr,
+                                                          data_buffer.GetBytes(),
+                                                          data_buffer.GetByteSize(),
+                                                          error);
+    ++m_stats.process_reads;
+    m_stats.process_bytes += bytes_read;
+
+    const size_t needed_byte_size = num_needed_lines * cache_line_byte_size;
+    if (bytes_read < needed_byte_size && num_lines_to_read > num_needed_lines)
+    {
+        // The read ahead might have made the whole read fail, try again
+        // with only the lines that were asked for.
+        num_lines_to_read = num_needed_lines;
+        bytes_read = m_process.ReadMemoryFromInferior (line_addr,
+                                                       data_buffer.GetBytes(),
+                                                       needed_byte_size,
+                                                       error);
+        ++m_stats.process_reads;
+        m_stats.process_bytes += bytes_read;
+    }
+
+    if (bytes_read == 0)
+    {
+        m_next_sequential_addr = LLDB_INVALID_ADDRESS;
+        return 0;
+    }
+
+    size_t num_lines_added = 0;
+    for (size_t offset = 0; offset < bytes_read; offset += cache_line_byte_size)
+    {
+        const size_t line_size = std::min<size_t> (cache_line_byte_size, bytes_read - offset);
+        AddCacheLine (line_addr + offset, DataBufferSP (new DataBufferHeap (data_buffer.GetBytes() + offset, line_size)));
+        ++num_lines_added;
+    }
+
+    static StatisticsCounter &g_line_misses = Statistics::GetCounter ("memory-cache.line-misses");
+    g_line_misses.Add (std::min<size_t> (num_lines_added, num_needed_lines));
+    if (num_lines_added > num_needed_lines)
+    {
+        m_stats.line_misses += num_needed_lines;
+        m_stats.prefetched_lines += num_lines_added - num_needed_lines;
+    }
+    else
+        m_stats.line_misses += num_lines_added;
 
+    m_next_sequential_addr = line_addr + num_lines_added * cache_line_byte_size;
+    EvictCacheLinesIfNeeded (num_lines_added);
+    return num_lines_added;
+}
 
 size_t
 MemoryCache::Read (addr_t addr,  
@@ -119,88 +319,205 @@ MemoryCache::Read (addr_t addr,
                    size_t dst_len,
                    Error &error)
 {
-    size_t bytes_left = dst_len;
-    if (dst && bytes_left > 0)
+    if (dst == NULL || dst_len == 0)
+        return 0;
+
+    Mutex::Locker locker (m_mutex);
+
+    // Serve the read from the L1 cache if a single block contains all of it
+    if (!m_L1_cache.empty())
     {
-        const uint32_t cache_line_byte_size = m_cache_line_byte_size;
-        uint8_t *dst_buf = (uint8_t *)dst;
-        addr_t curr_addr = addr - (addr % cache_line_byte_size);
-        addr_t cache_offset = addr - curr_addr;
-        Mutex::Locker locker (m_mutex);
-        
-        while (bytes_left > 0)
+        L1CacheMap::const_iterator pos = m_L1_cache.upper_bound (addr);
+        if (pos != m_L1_cache.begin())
         {
-            if (m_invalid_ranges.FindEntryThatContains(curr_addr))
-                return dst_len - bytes_left;
-
-            BlockMap::const_iterator pos = m_cache.find (curr_addr);
-            BlockMap::const_iterator end = m_cache.end ();
-            
-            if (pos != end)
-            {
-                size_t curr_read_size = cache_line_byte_size - cache_offset;
-                if (curr_read_size > bytes_left)
-                    curr_read_size = bytes_left;
-                
-                memcpy (dst_buf + dst_len - bytes_left, pos->second->GetBytes() + cache_offset, curr_read_size);
-                
-                bytes_left -= curr_read_size;
-                curr_addr += curr_read_size + cache_offset;
-                cache_offset = 0;
-                
-                if (bytes_left > 0)
-                {
-                    // Get sequential cache page hits
-                    for (++pos; (pos != end) && (bytes_left > 0); ++pos)
-                    {
-                        assert ((curr_addr % cache_line_byte_size) == 0);
-                        
-                        if (pos->first != curr_addr)
-                            break;
-                        
-                        curr_read_size = pos->second->GetByteSize();
-                        if (curr_read_size > bytes_left)
-                            curr_read_size = bytes_left;
-                        
-                        memcpy (dst_buf + dst_len - bytes_left, pos->second->GetBytes(), curr_read_size);
-                        
-                        bytes_left -= curr_read_size;
-                        curr_addr += curr_read_size;
-                        
-                        // We have a cache page that succeeded to read some bytes
-                        // but not an entire page. If this happens, we must cap
-                        // off how much data we are able to read...
-                        if (pos->second->GetByteSize() != cache_line_byte_size)
-                            return dst_len - bytes_left;
-                    }
-                }
-            }
-            
-            // We need to read from the process
-            
-            if (bytes_left > 0)
+            --pos;
+            const addr_t block_end_addr = pos->first + pos->second->GetByteSize();
+            if (addr >= pos->first && addr + dst_len <= block_end_addr)
             {
-                assert ((curr_addr % cache_line_byte_size) == 0);
-                std::auto_ptr<DataBufferHeap> data_buffer_heap_ap(new DataBufferHeap (cache_line_byte_size, 0));
-                size_t process_bytes_read = m_process.ReadMemoryFromInferior (curr_addr, 
-                                                                              data_buffer_heap_ap->GetBytes(), 
-                                                                              data_buffer_heap_ap->GetByteSize(), 
-                                                                              error);
-                if (process_bytes_read == 0)
-                    return dst_len - bytes_left;
-                
-                if (process_bytes_read != cache_line_byte_size)
-                    data_buffer_heap_ap->SetByteSize (process_bytes_read);
-                m_cache[curr_addr] = DataBufferSP (data_buffer_heap_ap.release());
-                // We have read data and put it into the cache, continue through the
-                // loop again to get the data out of the cache...
+                memcpy (dst, pos->second->GetBytes() + (addr - pos->first), dst_len);
+                ++m_stats.l1_hits;
+                static StatisticsCounter &g_l1_hits = Statistics::GetCounter ("memory-cache.l1-hits");
+                g_l1_hits.Add ();
+                return dst_len;
             }
         }
     }
-    
+
+    const uint32_t cache_line_byte_size = m_cache_line_byte_size;
+    uint8_t *dst_buf = (uint8_t *)dst;
+    size_t bytes_left = dst_len;
+    addr_t curr_addr = addr;
+
+    while (bytes_left > 0)
+    {
+        const addr_t line_addr = curr_addr - (curr_addr % cache_line_byte_size);
+        const size_t line_offset = curr_addr - line_addr;
+
+        if (m_invalid_ranges.FindEntryThatContains(line_addr))
+            break;
+
+        BlockMap::iterator pos = m_cache.find (line_addr);
+        if (pos == m_cache.end())
+        {
+            // Read all of the lines this request still needs at once. If
+            // this miss continues where the last read from the process
+            // ended, we are streaming through memory so read ahead and
+            // read further ahead each time the pattern continues.
+            const size_t num_needed_lines = (line_offset + bytes_left + cache_line_byte_size - 1) / cache_line_byte_size;
+            if (line_addr == m_next_sequential_addr)
+                m_prefetch_lines = m_prefetch_lines == 0 ? 1 : std::min<uint32_t> (m_prefetch_lines * 2, MAX_PREFETCH_LINES);
+            else
+                m_prefetch_lines = 0;
+
+            if (ReadCacheLinesFromProcess (line_addr, num_needed_lines + m_prefetch_lines, num_needed_lines, error) == 0)
+                break;
+            pos = m_cache.find (line_addr);
+            if (pos == m_cache.end())
+                break;
+        }
+        else
+        {
+            ++m_stats.line_hits;
+            static StatisticsCounter &g_line_hits = Statistics::GetCounter ("memory-cache.line-hits");
+            g_line_hits.Add ();
+            m_lru.splice (m_lru.end(), m_lru, pos->second.lru_pos);
+        }
+
+        const DataBufferSP &data_sp = pos->second.data_sp;
+        const size_t line_byte_size = data_sp->GetByteSize();
+        if (line_offset >= line_byte_size)
+            break;
+        const size_t curr_read_size = std::min<size_t> (line_byte_size - line_offset, bytes_left);
+        memcpy (dst_buf + dst_len - bytes_left, data_sp->GetBytes() + line_offset, curr_read_size);
+        bytes_left -= curr_read_size;
+        curr_addr += curr_read_size;
+
+        // We have a cache line that succeeded to read some bytes but not
+        // an entire line. If this happens, we must cap off how much data
+        // we are able to read...
+        if (line_byte_size != cache_line_byte_size)
+            break;
+    }
+
     return dst_len - bytes_left;
 }
 
+void
+MemoryCache::Prefetch (addr_t addr, size_t size)
+{
+    if (size == 0)
+        return;
+
+    Mutex::Locker locker (m_mutex);
+
+    // Prefetching isn't part of the access pattern of our clients, don't
+    // let it change how far ahead we read for them.
+    const addr_t next_sequential_addr = m_next_sequential_addr;
+    const uint32_t prefetch_lines = m_prefetch_lines;
+
+    const uint32_t cache_line_byte_size = m_cache_line_byte_size;
+    const addr_t first_line_addr = addr - (addr % cache_line_byte_size);
+    size_t num_lines = (addr - first_line_addr + size + cache_line_byte_size - 1) / cache_line_byte_size;
+    addr_t line_addr = first_line_addr;
+    while (num_lines > 0)
+    {
+        if (m_invalid_ranges.FindEntryThatContains (line_addr))
+            break;
+
+        size_t num_lines_done = 1;
+        if (m_cache.find (line_addr) == m_cache.end())
+        {
+            Error error;
+            num_lines_done = ReadCacheLinesFromProcess (line_addr, num_lines, 1, error);
+            if (num_lines_done == 0)
+                break;
+            // A short read means we ran into memory that can't be read
+            if (m_cache.find (line_addr + (num_lines_done - 1) * cache_line_byte_size)->second.data_sp->GetByteSize() < cache_line_byte_size)
+                break;
+        }
+        if (num_lines_done >= num_lines)
+            break;
+        const addr_t next_line_addr = line_addr + num_lines_done * cache_line_byte_size;
+        if (next_line_addr < line_addr)
+            break;  // We wrapped around the end of the address space
+        line_addr = next_line_addr;
+        num_lines -= num_lines_done;
+    }
+
+    m_next_sequential_addr = next_sequential_addr;
+    m_prefetch_lines = prefetch_lines;
+}
+
+void
+MemoryCache::PrefetchRanges (const MemoryReadRange *ranges, size_t num_ranges)
+{
+    if (ranges == NULL || num_ranges == 0)
+        return;
+
+    Mutex::Locker locker (m_mutex);
+
+    // Find the cache lines that are missing, ranges that are next to
+    // each other often share lines so only read each one once.
+    const uint32_t cache_line_byte_size = m_cache_line_byte_size;
+    std::set<addr_t> missing_lines;
+    for (size_t i=0; i<num_ranges; ++i)
+    {
+        if (ranges[i].size == 0)
+            continue;
+        const addr_t last_addr = ranges[i].addr + ranges[i].size - 1;
+        if (last_addr < ranges[i].addr)
+            continue;   // The range wraps around the end of the address space
+        for (addr_t line_addr = ranges[i].addr - (ranges[i].addr % cache_line_byte_size);
+             ;
+             line_addr += cache_line_byte_size)
+        {
+            if (m_cache.find (line_addr) == m_cache.end() && !m_invalid_ranges.FindEntryThatContains (line_addr))
+                missing_lines.insert (line_addr);
+            if (last_addr - line_addr < cache_line_byte_size)
+                break;
+        }
+    }
+
+    if (missing_lines.empty())
+        return;
+
+    // Read each run of consecutive missing lines as one range
+    DataBufferHeap data_buffer (missing_lines.size() * cache_line_byte_size, 0);
+    uint8_t *dst = data_buffer.GetBytes();
+    std::vector<MemoryReadRange> line_ranges;
+    for (std::set<addr_t>::const_iterator pos = missing_lines.begin(), end = missing_lines.end(); pos != end; ++pos)
+    {
+        if (!line_ranges.empty() && line_ranges.back().addr + line_ranges.back().size == *pos)
+            line_ranges.back().size += cache_line_byte_size;
+        else
+        {
+            MemoryReadRange line_range = { *pos, cache_line_byte_size, dst, 0 };
+            line_ranges.push_back (line_range);
+        }
+        dst += cache_line_byte_size;
+    }
+
+    Error error;
+    const size_t bytes_read = m_process.ReadMemoryRangesFromInferior (&line_ranges[0], line_ranges.size(), error);
+    ++m_stats.process_reads;
+    m_stats.process_bytes += bytes_read;
+
+    size_t num_lines_added = 0;
+    for (size_t i=0; i<line_ranges.size(); ++i)
+    {
+        const MemoryReadRange &line_range = line_ranges[i];
+        const uint8_t *src = (const uint8_t *)line_range.buf;
+        for (size_t offset = 0; offset < line_range.bytes_read; offset += cache_line_byte_size)
+        {
+            const size_t line_size = std::min<size_t> (cache_line_byte_size, line_range.bytes_read - offset);
+            AddCacheLine (line_range.addr + offset, DataBufferSP (new DataBufferHeap (src + offset, line_size)));
+            ++num_lines_added;
+        }
+    }
+    m_stats.prefetched_lines += num_lines_added;
+    EvictCacheLinesIfNeeded (num_lines_added);
+}
+
 
 
 AllocatedBlock::AllocatedBlock (lldb::addr_t addr, 
@@ -386,7 +703,7 @@ AllocatedMemoryCache::AllocatePage (uint32_t byte_size,
     AllocatedBlockSP block_sp;
     const size_t page_size = 4096;
     const size_t num_pages = (byte_size + page_size - 1) / page_size;
-    const size_t page_byte_size = num_pages * page_size;
+    const size_t page_byte_size = std::max<size_t> (num_pages * page_size, MIN_ALLOCATED_PAGE_BYTE_SIZE);
 
     addr_t addr = m_process.DoAllocateMemory(page_byte_size, permissions, error);
 
@@ -420,6 +737,8 @@ AllocatedMemoryCache::AllocateMemory (size_t byte_size,
     for (PermissionsToBlockMap::iterator pos = range.first; pos != range.second; ++pos)
     {
         addr = (*pos).second->ReserveBlock (byte_size);
+        if (addr != LLDB_INVALID_ADDRESS)
+            break;
     }
     
     if (addr == LLDB_INVALID_ADDRESS)
@@ -456,4 +775,125 @@ AllocatedMemoryCache::DeallocateMemory (lldb::addr_t addr)
     return success;
 }
 
+AllocatedMemoryArena::AllocatedMemoryArena (Process &process) :
+    m_process (process),
+    m_mutex (Mutex::eMutexTypeRecursive),
+    m_byte_size (ARENA_REGION_BYTE_SIZE),
+    m_addr (LLDB_INVALID_ADDRESS),
+    m_offset (0),
+    m_epoch_depth (0),
+    m_abandoned_regions ()
+{
+}
+
+AllocatedMemoryArena::~AllocatedMemoryArena ()
+{
+}
+
+void
+AllocatedMemoryArena::Clear()
+{
+    Mutex::Locker locker (m_mutex);
+    if (m_process.IsAlive())
+    {
+        if (m_addr != LLDB_INVALID_ADDRESS)
+            m_process.DoDeallocateMemory (m_addr);
+        for (size_t i = 0; i < m_abandoned_regions.size(); ++i)
+            m_process.DoDeallocateMemory (m_abandoned_regions[i]);
+    }
+    m_addr = LLDB_INVALID_ADDRESS;
+    m_offset = 0;
+    m_abandoned_regions.clear();
+}
+
+void
+AllocatedMemoryArena::BeginEpoch ()
+{
+    Mutex::Locker locker (m_mutex);
+    ++m_epoch_depth;
+}
+
+void
+AllocatedMemoryArena::EndEpoch (bool expression_finished)
+{
+    Mutex::Locker locker (m_mutex);
+    if (m_epoch_depth == 0)
+        return;
+
+    if (!expression_finished && m_addr != LLDB_INVALID_ADDRESS && m_offset > 0)
+    {
+        // The expression was left on the stack and may still use what we
+        // gave it when the process resumes, so nothing in this region can
+        // be handed out again.
+        m_abandoned_regions.push_back (m_addr);
+        m_addr = LLDB_INVALID_ADDRESS;
+        m_offset = 0;
+    }
+
+    if (--m_epoch_depth == 0)
+        m_offset = 0;
+
+    LogSP log (GetLogIfAllCategoriesSet (LIBLLDB_LOG_PROCESS | LIBLLDB_LOG_VERBOSE));
+    if (log)
+        log->Printf ("AllocatedMemoryArena::EndEpoch (expression_finished = %i) => depth = %u, %zu abandoned regions",
+                     expression_finished, m_epoch_depth, m_abandoned_regions.size());
+}
+
+lldb::addr_t
+AllocatedMemoryArena::AllocateMemory (size_t byte_size,
+                                      uint32_t permissions,
+                                      Error &error)
+{
+    Mutex::Locker locker (m_mutex);
+
+    if (m_epoch_depth == 0 || permissions != (ePermissionsReadable | ePermissionsWritable))
+        return LLDB_INVALID_ADDRESS;
+
+    const size_t aligned_byte_size = ((byte_size ? byte_size : 1) + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+
+    // Leave anything big to the allocated memory cache so one large
+    // request doesn't use up the region.
+    if (aligned_byte_size > m_byte_size / 4)
+        return LLDB_INVALID_ADDRESS;
+
+    if (m_addr == LLDB_INVALID_ADDRESS)
+    {
+        m_addr = m_process.DoAllocateMemory (m_byte_size, permissions, error);
+
+        LogSP log (GetLogIfAllCategoriesSet (LIBLLDB_LOG_PROCESS));
+        if (log)
+            log->Printf ("Process::DoAllocateMemory (byte_size = 0x%8.8zx, permissions = %s) => 0x%16.16llx",
+                         m_byte_size,
+                         GetPermissionsAsCString(permissions),
+                         (uint64_t)m_addr);
+
+        if (m_addr == LLDB_INVALID_ADDRESS)
+            return LLDB_INVALID_ADDRESS;
+        m_offset = 0;
+    }
+
+    if (m_offset + aligned_byte_size > m_byte_size)
+        return LLDB_INVALID_ADDRESS;
 
+    const addr_t addr = m_addr + m_offset;
+    m_offset += aligned_byte_size;
+
+    LogSP log (GetLogIfAllCategoriesSet (LIBLLDB_LOG_PROCESS | LIBLLDB_LOG_VERBOSE));
+    if (log)
+        log->Printf ("AllocatedMemoryArena::AllocateMemory (byte_size = 0x%8.8zx) => 0x%16.16llx", byte_size, (uint64_t)addr);
+    return addr;
+}
+
+bool
+AllocatedMemoryArena::Contains (lldb::addr_t addr) const
+{
+    Mutex::Locker locker (m_mutex);
+    if (RegionContains (m_addr, addr))
+        return true;
+    for (size_t i = 0; i < m_abandoned_regions.size(); ++i)
+    {
+        if (RegionContains (m_abandoned_regions[i], addr))
+            return true;
+    }
+    return false;
+}
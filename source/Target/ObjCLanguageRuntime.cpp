@@ -286,6 +286,8 @@ ObjCLanguageRuntime::GetParentClass(ObjCLanguageRuntime::ObjCISA isa)
     if (!IsValidISA(isa))
         return 0;
     
+    UpdateISAToDescriptorMap();
+    
     ISAToDescriptorIterator found = m_isa_to_descriptor_cache.find(isa);
     ISAToDescriptorIterator end = m_isa_to_descriptor_cache.end();
     
@@ -324,6 +326,8 @@ ObjCLanguageRuntime::GetActualTypeName(ObjCLanguageRuntime::ObjCISA isa)
     if (!IsValidISA(isa))
         return ConstString();
     
+    UpdateISAToDescriptorMap();
+    
     ISAToDescriptorIterator found = m_isa_to_descriptor_cache.find(isa);
     ISAToDescriptorIterator end = m_isa_to_descriptor_cache.end();
     
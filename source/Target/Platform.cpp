@@ -10,6 +10,10 @@
 #include "lldb/Target/Platform.h"
 
 // C Includes
+#include <errno.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+
 // C++ Includes
 // Other libraries and framework includes
 // Project includes
@@ -18,6 +22,7 @@
 #include "lldb/Core/Log.h"
 #include "lldb/Core/ModuleSpec.h"
 #include "lldb/Core/PluginManager.h"
+#include "lldb/Core/UUID.h"
 #include "lldb/Host/FileSpec.h"
 #include "lldb/Host/Host.h"
 #include "lldb/Target/Process.h"
@@ -104,6 +109,33 @@ Platform::GetSharedModule (const ModuleSpec &module_spec,
     // remote target, or might implement a download and cache 
     // locally implementation.
     const bool always_create = false;
+
+    // Remote platforms may have a copy of the file in the local module
+    // cache already, or be able to download one there.
+    if (!IsHost() && module_spec.GetFileSpec())
+    {
+        const UUID *uuid_ptr = module_spec.GetUUIDPtr();
+        if (uuid_ptr && !uuid_ptr->IsValid())
+            uuid_ptr = NULL;
+        FileSpec local_file;
+        if (GetFile (module_spec.GetFileSpec(), uuid_ptr, local_file).Success() &&
+            local_file != module_spec.GetFileSpec() &&
+            local_file.Exists())
+        {
+            ModuleSpec local_module_spec (module_spec);
+            local_module_spec.GetFileSpec() = local_file;
+            local_module_spec.GetPlatformFileSpec() = module_spec.GetFileSpec();
+            Error error (ModuleList::GetSharedModule (local_module_spec, 
+                                                      module_sp,
+                                                      module_search_paths_ptr,
+                                                      old_module_sp_ptr,
+                                                      did_create_ptr,
+                                                      always_create));
+            if (module_sp)
+                return error;
+        }
+    }
+
     return ModuleList::GetSharedModule (module_spec, 
                                         module_sp,
                                         module_search_paths_ptr,
@@ -112,6 +144,52 @@ Platform::GetSharedModule (const ModuleSpec &module_spec,
                                         always_create);
 }
 
+bool
+Platform::GetModuleCacheFileSpec (const UUID &uuid,
+                                  const FileSpec &platform_file,
+                                  bool create_directory,
+                                  FileSpec &cache_file)
+{
+    char uuid_cstr[64];
+    const char *platform_filename = platform_file.GetFilename().GetCString();
+    if (!uuid.IsValid() || platform_filename == NULL || !uuid.GetAsCString (uuid_cstr, sizeof(uuid_cstr)))
+        return false;
+
+    std::string cache_dir;
+    const char *env_cache_dir = ::getenv ("LLDB_MODULE_CACHE_DIR");
+    if (env_cache_dir && env_cache_dir[0])
+        cache_dir = env_cache_dir;
+    else
+    {
+        const char *home_dir = ::getenv ("HOME");
+        if (home_dir == NULL || home_dir[0] == '\0')
+            return false;
+        cache_dir = home_dir;
+        cache_dir += "/.lldb/module_cache";
+    }
+    cache_dir += '/';
+    cache_dir += uuid_cstr;
+
+    if (create_directory)
+    {
+        // Make each directory along the way, ignoring the ones that
+        // are already there
+        for (size_t pos = cache_dir.find ('/', 1); ; pos = cache_dir.find ('/', pos + 1))
+        {
+            const std::string dir (cache_dir, 0, pos);
+            if (::mkdir (dir.c_str(), 0755) != 0 && errno != EEXIST)
+                return false;
+            if (pos == std::string::npos)
+                break;
+        }
+    }
+
+    cache_dir += '/';
+    cache_dir += platform_filename;
+    cache_file.SetFile (cache_dir.c_str(), false);
+    return true;
+}
+
 PlatformSP
 Platform::Create (const char *platform_name, Error &error)
 {
@@ -532,6 +610,22 @@ Platform::ConnectRemote (Args& args)
     return error;
 }
 
+Error
+Platform::DownloadFile (const FileSpec &platform_file, const FileSpec &local_file)
+{
+    Error error;
+    error.SetErrorStringWithFormat ("Platform::DownloadFile() is not supported by %s", GetShortPluginName());
+    return error;
+}
+
+Error
+Platform::PutFile (const FileSpec &local_file, const FileSpec &platform_file, uint32_t mode)
+{
+    Error error;
+    error.SetErrorStringWithFormat ("Platform::PutFile() is not supported by %s", GetShortPluginName());
+    return error;
+}
+
 Error
 Platform::DisconnectRemote ()
 {
@@ -9,21 +9,35 @@
 
 #include "lldb/Target/Process.h"
 
+#include <unistd.h>
+#include <algorithm>
+
 #include "lldb/lldb-private-log.h"
 
 #include "lldb/Breakpoint/StoppointCallbackContext.h"
 #include "lldb/Breakpoint/BreakpointLocation.h"
+#include "lldb/Breakpoint/BreakpointLocationCollection.h"
 #include "lldb/Core/Event.h"
 #include "lldb/Core/ConnectionFileDescriptor.h"
+#include "lldb/Core/DataBufferHeap.h"
 #include "lldb/Core/Debugger.h"
 #include "lldb/Core/InputReader.h"
 #include "lldb/Core/Log.h"
 #include "lldb/Core/Module.h"
 #include "lldb/Core/PluginManager.h"
+#include "lldb/Core/Section.h"
 #include "lldb/Core/State.h"
+#include "lldb/Core/Statistics.h"
 #include "lldb/Expression/ClangUserExpression.h"
 #include "lldb/Interpreter/CommandInterpreter.h"
+#include "lldb/Interpreter/ScriptInterpreter.h"
 #include "lldb/Host/Host.h"
+#include "lldb/Symbol/ObjectFile.h"
+#include "lldb/Symbol/SymbolFile.h"
+#include "lldb/Symbol/SymbolVendor.h"
+#include "lldb/Symbol/Type.h"
+#include "lldb/Symbol/Variable.h"
+#include "lldb/Symbol/VariableList.h"
 #include "lldb/Target/ABI.h"
 #include "lldb/Target/DynamicLoader.h"
 #include "lldb/Target/OperatingSystem.h"
@@ -32,6 +46,7 @@
 #include "lldb/Target/ObjCLanguageRuntime.h"
 #include "lldb/Target/Platform.h"
 #include "lldb/Target/RegisterContext.h"
+#include "lldb/Target/StackFrame.h"
 #include "lldb/Target/StopInfo.h"
 #include "lldb/Target/Target.h"
 #include "lldb/Target/TargetList.h"
@@ -89,21 +104,51 @@ public:
     }
 };
 
+static OptionEnumValueElement
+g_stdio_overflow_policies[] =
+{
+    { eStdioOverflowDropOldest, "drop-oldest", "Discard the oldest unread output to make room for new output."},
+    { eStdioOverflowBlock,      "block",       "Briefly stop reading output from the process until the unread output has been read, which slows down a process that writes faster than its output is shown. Output is still buffered if nothing reads it for a while."},
+    { 0, NULL, NULL }
+};
+
 static PropertyDefinition
 g_properties[] =
 {
     { "disable-memory-cache" , OptionValue::eTypeBoolean, false, DISABLE_MEM_CACHE_DEFAULT, NULL, NULL, "Disable reading and caching of memory in fixed-size units." },
     { "extra-startup-command", OptionValue::eTypeArray  , false, OptionValue::eTypeString, NULL, NULL, "A list containing extra commands understood by the particular process plugin used." },
+    { "memory-cache-size"    , OptionValue::eTypeUInt64 , false, 32 * 1024 * 1024, NULL, NULL, "The maximum number of bytes of process memory to keep in the memory cache. The least recently used memory is discarded first. Zero means no limit." },
+    { "non-stop-mode"        , OptionValue::eTypeBoolean, false, false, NULL, NULL, "Ask remote debug servers that support it to only stop the threads that hit breakpoints or get exceptions, and keep the other threads running. Takes effect for the next launch or attach." },
+    { "packet-compression-min-size", OptionValue::eTypeUInt64 , false, 0, NULL, NULL, "Ask remote debug servers that support it to run-length encode packets they send that are at least this many bytes long, which helps over slow connections. Zero disables compression." },
+    { "read-only-memory-from-files", OptionValue::eTypeBoolean, false, false, NULL, NULL, "Read code and constant data of modules that were loaded from files out of the files instead of the process, unless the debugger wrote to it. This saves round trips to remote devices, but shows the wrong bytes if the program changed its own code, or the loader relocated or rewrote it." },
+    { "shared-memory-transport", OptionValue::eTypeBoolean, false, true, NULL, NULL, "Move the packets to and from a debug server that LLDB starts on this host through shared memory instead of a socket. Takes effect for the next launch or attach." },
+    { "simulated-link-bandwidth", OptionValue::eTypeUInt64 , false, 0, NULL, NULL, "Make the connection to a remote debug server no faster than this many bytes per second, to see how LLDB would perform with a far away device. Zero means no limit. Takes effect for the next connection." },
+    { "simulated-link-latency", OptionValue::eTypeUInt64 , false, 0, NULL, NULL, "Add this many microseconds of latency to every packet sent to a remote debug server, to see how LLDB would perform with a far away device. Takes effect for the next connection." },
+    { "stack-prefetch-size"  , OptionValue::eTypeUInt64 , false, 16 * 1024, NULL, NULL, "The number of bytes of stack memory, starting at the stack pointer, to read in a single request when a thread is first unwound after a stop. Zero disables prefetching." },
+    { "stdio-buffer-size"    , OptionValue::eTypeUInt64 , false, 0, NULL, NULL, "The maximum number of bytes of STDOUT, and separately of STDERR, from the process to buffer until they are read. Zero means no limit." },
+    { "stdio-overflow-policy", OptionValue::eTypeEnum   , false, eStdioOverflowDropOldest, NULL, g_stdio_overflow_policies, "What to do when the process writes more output than fits in stdio-buffer-size." },
     {  NULL                  , OptionValue::eTypeInvalid, false, 0, NULL, NULL, NULL  }
 };
 
 enum {
     ePropertyDisableMemCache,
-    ePropertyExtraStartCommand
+    ePropertyExtraStartCommand,
+    ePropertyMemCacheSize,
+    ePropertyNonStopMode,
+    ePropertyPacketCompressionMinSize,
+    ePropertyReadOnlyMemoryFromFiles,
+    ePropertySharedMemoryTransport,
+    ePropertySimulatedLinkBandwidth,
+    ePropertySimulatedLinkLatency,
+    ePropertyStackPrefetchSize,
+    ePropertySTDIOBufferSize,
+    ePropertySTDIOOverflowPolicy
 };
 
 ProcessProperties::ProcessProperties (bool is_global) :
-    Properties ()
+    Properties (),
+    m_disable_memory_cache (ePropertyDisableMemCache, OptionValue::eTypeBoolean),
+    m_read_only_memory_from_files (ePropertyReadOnlyMemoryFromFiles, OptionValue::eTypeBoolean)
 {
     if (is_global)
     {
@@ -126,7 +171,7 @@ bool
 ProcessProperties::GetDisableMemoryCache() const
 {
     const uint32_t idx = ePropertyDisableMemCache;
-    return m_collection_sp->GetPropertyAtIndexAsBoolean (NULL, idx, g_properties[idx].default_uint_value != 0);
+    return m_disable_memory_cache.GetBooleanValue (*m_collection_sp, g_properties[idx].default_uint_value != 0);
 }
 
 Args
@@ -138,6 +183,76 @@ ProcessProperties::GetExtraStartupCommands () const
     return args;
 }
 
+uint64_t
+ProcessProperties::GetMemoryCacheSize () const
+{
+    const uint32_t idx = ePropertyMemCacheSize;
+    return m_collection_sp->GetPropertyAtIndexAsUInt64 (NULL, idx, g_properties[idx].default_uint_value);
+}
+
+bool
+ProcessProperties::GetNonStopModeEnabled () const
+{
+    const uint32_t idx = ePropertyNonStopMode;
+    return m_collection_sp->GetPropertyAtIndexAsBoolean (NULL, idx, g_properties[idx].default_uint_value != 0);
+}
+
+uint32_t
+ProcessProperties::GetPacketCompressionMinSize () const
+{
+    const uint32_t idx = ePropertyPacketCompressionMinSize;
+    return m_collection_sp->GetPropertyAtIndexAsUInt64 (NULL, idx, g_properties[idx].default_uint_value);
+}
+
+bool
+ProcessProperties::GetReadOnlyMemoryFromFiles () const
+{
+    const uint32_t idx = ePropertyReadOnlyMemoryFromFiles;
+    return m_read_only_memory_from_files.GetBooleanValue (*m_collection_sp, g_properties[idx].default_uint_value != 0);
+}
+
+bool
+ProcessProperties::GetSharedMemoryTransportEnabled () const
+{
+    const uint32_t idx = ePropertySharedMemoryTransport;
+    return m_collection_sp->GetPropertyAtIndexAsBoolean (NULL, idx, g_properties[idx].default_uint_value != 0);
+}
+
+uint64_t
+ProcessProperties::GetSimulatedLinkBandwidth () const
+{
+    const uint32_t idx = ePropertySimulatedLinkBandwidth;
+    return m_collection_sp->GetPropertyAtIndexAsUInt64 (NULL, idx, g_properties[idx].default_uint_value);
+}
+
+uint32_t
+ProcessProperties::GetSimulatedLinkLatency () const
+{
+    const uint32_t idx = ePropertySimulatedLinkLatency;
+    return m_collection_sp->GetPropertyAtIndexAsUInt64 (NULL, idx, g_properties[idx].default_uint_value);
+}
+
+uint64_t
+ProcessProperties::GetStackPrefetchSize () const
+{
+    const uint32_t idx = ePropertyStackPrefetchSize;
+    return m_collection_sp->GetPropertyAtIndexAsUInt64 (NULL, idx, g_properties[idx].default_uint_value);
+}
+
+uint64_t
+ProcessProperties::GetSTDIOBufferSize () const
+{
+    const uint32_t idx = ePropertySTDIOBufferSize;
+    return m_collection_sp->GetPropertyAtIndexAsUInt64 (NULL, idx, g_properties[idx].default_uint_value);
+}
+
+StdioOverflowPolicy
+ProcessProperties::GetSTDIOOverflowPolicy () const
+{
+    const uint32_t idx = ePropertySTDIOOverflowPolicy;
+    return (StdioOverflowPolicy)m_collection_sp->GetPropertyAtIndexAsEnumeration (NULL, idx, g_properties[idx].default_uint_value);
+}
+
 void
 ProcessProperties::SetExtraStartupCommands (const Args &args)
 {
@@ -917,13 +1032,23 @@ Process::Process(Target &target, Listener &listener) :
     m_stdio_communication_mutex (Mutex::eMutexTypeRecursive),
     m_stdout_data (),
     m_stderr_data (),
+    m_profile_data (),
     m_memory_cache (*this),
+    m_written_section_ranges (),
+    m_written_section_ranges_mutex (Mutex::eMutexTypeNormal),
     m_allocated_memory_cache (*this),
+    m_expression_arena (*this),
     m_should_detach (false),
+    m_defer_attach_symbols (false),
     m_next_event_action_ap(),
     m_run_lock (),
     m_currently_handling_event(false),
+    m_internal_continue (false),
     m_finalize_called(false),
+    m_type_prewarm_thread (LLDB_INVALID_HOST_THREAD),
+    m_type_prewarm_cancel (false),
+    m_type_prewarm_module_sp (),
+    m_type_prewarm_variables (),
     m_can_jit(eCanJITDontKnow)
 {
     CheckInWithManager ();
@@ -936,12 +1061,14 @@ Process::Process(Target &target, Listener &listener) :
     SetEventName (eBroadcastBitInterrupt, "interrupt");
     SetEventName (eBroadcastBitSTDOUT, "stdout-available");
     SetEventName (eBroadcastBitSTDERR, "stderr-available");
+    SetEventName (eBroadcastBitProfileData, "profile-data-available");
     
     listener.StartListeningForEvents (this,
                                       eBroadcastBitStateChanged |
                                       eBroadcastBitInterrupt |
                                       eBroadcastBitSTDOUT |
-                                      eBroadcastBitSTDERR);
+                                      eBroadcastBitSTDERR |
+                                      eBroadcastBitProfileData);
 
     m_private_state_listener.StartListeningForEvents(&m_private_state_broadcaster,
                                                      eBroadcastBitStateChanged |
@@ -961,6 +1088,7 @@ Process::~Process()
     LogSP log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_OBJECT));
     if (log)
         log->Printf ("%p Process::~Process()", this);
+    StopTypePrewarmThread();
     StopPrivateStateThread();
 }
 
@@ -999,6 +1127,8 @@ Process::Finalize()
             break;
     }
 
+    StopTypePrewarmThread();
+
     // Clear our broadcaster before we proceed with destroying
     Broadcaster::Clear();
 
@@ -1016,7 +1146,12 @@ Process::Finalize()
     m_notifications.swap(empty_notifications);
     m_image_tokens.clear();
     m_memory_cache.Clear();
+    {
+        Mutex::Locker locker (m_written_section_ranges_mutex);
+        m_written_section_ranges.Clear();
+    }
     m_allocated_memory_cache.Clear();
+    m_expression_arena.Clear();
     m_language_runtimes.clear();
     m_next_event_action_ap.reset();
     m_finalize_called = true;
@@ -1067,7 +1202,7 @@ Process::SynchronouslyNotifyStateChanged (StateType state)
 //
 
 StateType
-Process::GetNextEvent (EventSP &event_sp)
+Process::GetNextEvent (EventIntrusiveSP &event_sp)
 {
     StateType state = eStateInvalid;
 
@@ -1084,7 +1219,7 @@ Process::WaitForProcessToStop (const TimeValue *timeout)
     // We can't just wait for a "stopped" event, because the stopped event may have restarted the target.
     // We have to actually check each event, and in the case of a stopped event check the restarted flag
     // on the event.
-    EventSP event_sp;
+    EventIntrusiveSP event_sp;
     StateType state = GetState();
     // If we are exited or detached, we won't ever get back to any
     // other valid state...
@@ -1121,7 +1256,7 @@ Process::WaitForState
     const StateType *match_states, const uint32_t num_match_states
 )
 {
-    EventSP event_sp;
+    EventIntrusiveSP event_sp;
     uint32_t i;
     StateType state = GetState();
     while (state != eStateInvalid)
@@ -1177,7 +1312,7 @@ Process::RestorePrivateProcessEvents ()
 }
 
 StateType
-Process::WaitForStateChangedEvents (const TimeValue *timeout, EventSP &event_sp)
+Process::WaitForStateChangedEvents (const TimeValue *timeout, EventIntrusiveSP &event_sp)
 {
     LogSP log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_PROCESS));
 
@@ -1233,7 +1368,7 @@ Process::PeekAtStateChangedEvents ()
 }
 
 StateType
-Process::WaitForStateChangedEventsPrivate (const TimeValue *timeout, EventSP &event_sp)
+Process::WaitForStateChangedEventsPrivate (const TimeValue *timeout, EventIntrusiveSP &event_sp)
 {
     LogSP log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_PROCESS));
 
@@ -1262,7 +1397,7 @@ Process::WaitForStateChangedEventsPrivate (const TimeValue *timeout, EventSP &ev
 }
 
 bool
-Process::WaitForEventsPrivate (const TimeValue *timeout, EventSP &event_sp, bool control_only)
+Process::WaitForEventsPrivate (const TimeValue *timeout, EventIntrusiveSP &event_sp, bool control_only)
 {
     LogSP log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_PROCESS));
 
@@ -1484,6 +1619,10 @@ Process::SetPrivateState (StateType new_state)
 
     const StateType old_state = m_private_state.GetValueNoLock ();
     state_changed = old_state != new_state;
+
+    // An internal continue only covers the very next state change
+    const bool internal_continue = m_internal_continue;
+    m_internal_continue = false;
     // This code is left commented out in case we ever need to control
     // the private process state with another run lock. Right now it doesn't
     // seem like we need to do this, but if we ever do, we can uncomment and
@@ -1508,6 +1647,16 @@ Process::SetPrivateState (StateType new_state)
             if (log)
                 log->Printf("Process::SetPrivateState (%s) stop_id = %u", StateAsCString(new_state), m_mod_id.GetStopID());
         }
+        
+        if (internal_continue && StateIsRunningState (new_state))
+        {
+            // The private state thread restarted the process itself and
+            // would only suppress this event, so don't wake it up.
+            if (log)
+                log->Printf("Process::SetPrivateState (%s) internal continue, not broadcasting", StateAsCString(new_state));
+            return;
+        }
+
         // Use our target to get a shared pointer to ourselves...
         m_private_state_broadcaster.BroadcastEvent (eBroadcastBitStateChanged, new ProcessEventData (GetTarget().GetProcessSP(), new_state));
     }
@@ -1700,6 +1849,17 @@ Process::GetCPPLanguageRuntime (bool retry_if_null)
     return NULL;
 }
 
+void
+Process::ModulesDidUnload (ModuleList &module_list)
+{
+    LanguageRuntimeCollection::iterator pos, end = m_language_runtimes.end();
+    for (pos = m_language_runtimes.begin(); pos != end; ++pos)
+    {
+        if (pos->second)
+            pos->second->ModulesDidUnload (module_list);
+    }
+}
+
 ObjCLanguageRuntime *
 Process::GetObjCLanguageRuntime (bool retry_if_null)
 {
@@ -1747,11 +1907,8 @@ void
 Process::DisableAllBreakpointSites ()
 {
     m_breakpoint_site_list.SetEnabledForAll (false);
-    size_t num_sites = m_breakpoint_site_list.GetSize();
-    for (size_t i = 0; i < num_sites; i++)
-    {
-        DisableBreakpoint (m_breakpoint_site_list.GetByIndex(i).get());
-    }
+    Error error;
+    DisableBreakpointSites (m_breakpoint_site_list, error);
 }
 
 Error
@@ -1837,6 +1994,61 @@ Process::CreateBreakpointSite (const BreakpointLocationSP &owner, bool use_hardw
 
 }
 
+size_t
+Process::CreateBreakpointSites (const BreakpointLocationCollection &owners, bool use_hardware)
+{
+    // Owners at an address that already has a site just join it, the
+    // others get new sites that are all enabled together.
+    BreakpointSiteList new_sites;
+    size_t num_resolved = 0;
+    const size_t num_owners = owners.GetSize();
+    for (size_t i = 0; i < num_owners; ++i)
+    {
+        BreakpointLocationSP owner (owners.GetByIndex(i));
+        const addr_t load_addr = owner->GetAddress().GetOpcodeLoadAddress (&m_target);
+        if (load_addr == LLDB_INVALID_ADDRESS)
+            continue;
+
+        BreakpointSiteSP bp_site_sp (m_breakpoint_site_list.FindByAddress (load_addr));
+        if (bp_site_sp)
+        {
+            bp_site_sp->AddOwner (owner);
+            owner->SetBreakpointSite (bp_site_sp);
+            ++num_resolved;
+            continue;
+        }
+
+        bp_site_sp = new_sites.FindByAddress (load_addr);
+        if (bp_site_sp)
+            bp_site_sp->AddOwner (owner);
+        else
+            new_sites.Add (BreakpointSiteSP (new BreakpointSite (&m_breakpoint_site_list, owner, load_addr, LLDB_INVALID_THREAD_ID, use_hardware)));
+    }
+
+    if (new_sites.GetSize() == 0)
+        return num_resolved;
+
+    Error error;
+    EnableBreakpointSites (new_sites, error);
+
+    std::vector<BreakpointSiteSP> sites;
+    new_sites.GetSites (sites);
+    for (size_t i = 0; i < sites.size(); ++i)
+    {
+        // Sites that failed to enable go away with their owners unresolved
+        if (!sites[i]->IsEnabled())
+            continue;
+        m_breakpoint_site_list.Add (sites[i]);
+        const size_t num_site_owners = sites[i]->GetNumberOfOwners();
+        for (size_t j = 0; j < num_site_owners; ++j)
+        {
+            sites[i]->GetOwnerAtIndex(j)->SetBreakpointSite (sites[i]);
+            ++num_resolved;
+        }
+    }
+    return num_resolved;
+}
+
 void
 Process::RemoveOwnerFromBreakpointSite (lldb::user_id_t owner_id, lldb::user_id_t owner_loc_id, BreakpointSiteSP &bp_site_sp)
 {
@@ -1848,6 +2060,18 @@ Process::RemoveOwnerFromBreakpointSite (lldb::user_id_t owner_id, lldb::user_id_
     }
 }
 
+void
+Process::RemoveUnownedBreakpointSites (const BreakpointSiteList &bp_sites)
+{
+    Error error;
+    DisableBreakpointSites (bp_sites, error);
+
+    std::vector<BreakpointSiteSP> sites;
+    bp_sites.GetSites (sites);
+    for (size_t i = 0; i < sites.size(); ++i)
+        m_breakpoint_site_list.RemoveByAddress (sites[i]->GetLoadAddress());
+}
+
 
 size_t
 Process::RemoveBreakpointOpcodesFromBuffer (addr_t bp_addr, size_t size, uint8_t *buf) const
@@ -2064,12 +2288,276 @@ Process::DisableSoftwareBreakpoint (BreakpointSite *bp_site)
 
 }
 
+size_t
+Process::EnableBreakpointSites (const BreakpointSiteList &bp_sites, Error &error)
+{
+    std::vector<BreakpointSiteSP> sites;
+    bp_sites.GetSites (sites);
+    size_t num_enabled = 0;
+    for (size_t i = 0; i < sites.size(); ++i)
+    {
+        Error site_error (EnableBreakpoint (sites[i].get()));
+        if (site_error.Success())
+            ++num_enabled;
+        else if (error.Success())
+            error = site_error;
+    }
+    return num_enabled;
+}
+
+size_t
+Process::DisableBreakpointSites (const BreakpointSiteList &bp_sites, Error &error)
+{
+    std::vector<BreakpointSiteSP> sites;
+    bp_sites.GetSites (sites);
+    size_t num_disabled = 0;
+    for (size_t i = 0; i < sites.size(); ++i)
+    {
+        Error site_error (DisableBreakpoint (sites[i].get()));
+        if (site_error.Success())
+            ++num_disabled;
+        else if (error.Success())
+            error = site_error;
+    }
+    return num_disabled;
+}
+
+// Software breakpoint traps in the same block of this many bytes get read,
+// patched and written together.
+#define SOFTWARE_BREAKPOINT_GROUP_SIZE  4096
+
+//----------------------------------------------------------------------
+// Split BP_SITES, which are in address order, into groups of sites whose
+// traps are in the same block of memory and don't overlap. Sites that
+// can't be grouped are handed to the single site version instead.
+//----------------------------------------------------------------------
+static void
+GroupSoftwareBreakpointSites (Process &process,
+                              const std::vector<BreakpointSiteSP> &bp_sites,
+                              bool enable,
+                              std::vector<std::vector<BreakpointSite *> > &groups,
+                              size_t &num_done,
+                              Error &error)
+{
+    addr_t group_addr = LLDB_INVALID_ADDRESS;
+    addr_t group_end = LLDB_INVALID_ADDRESS;
+    for (size_t i = 0; i < bp_sites.size(); ++i)
+    {
+        BreakpointSite *bp_site = bp_sites[i].get();
+        if (bp_site->IsEnabled() == enable)
+        {
+            ++num_done;
+            continue;
+        }
+
+        const addr_t bp_addr = bp_site->GetLoadAddress();
+        size_t bp_opcode_size = 0;
+        if (bp_addr != LLDB_INVALID_ADDRESS && bp_site->GetTrapOpcodeBytes() != NULL)
+        {
+            if (enable)
+                bp_opcode_size = process.GetSoftwareBreakpointTrapOpcode (bp_site);
+            else if (!bp_site->IsHardware())
+                bp_opcode_size = bp_site->GetByteSize();
+        }
+
+        if (bp_opcode_size == 0)
+        {
+            // Let the single site version say what is wrong with this one
+            Error site_error (enable ? process.EnableSoftwareBreakpoint (bp_site) : process.DisableSoftwareBreakpoint (bp_site));
+            if (site_error.Success())
+                ++num_done;
+            else if (error.Success())
+                error = site_error;
+            continue;
+        }
+
+        if (groups.empty() ||
+            bp_addr < group_end ||
+            bp_addr / SOFTWARE_BREAKPOINT_GROUP_SIZE != group_addr / SOFTWARE_BREAKPOINT_GROUP_SIZE)
+        {
+            groups.push_back (std::vector<BreakpointSite *>());
+            group_addr = bp_addr;
+        }
+        groups.back().push_back (bp_site);
+        group_end = bp_addr + bp_opcode_size;
+    }
+}
+
+size_t
+Process::EnableSoftwareBreakpoints (const BreakpointSiteList &bp_sites, Error &error)
+{
+    LogSP log(lldb_private::GetLogIfAnyCategoriesSet (LIBLLDB_LOG_BREAKPOINTS));
+    std::vector<BreakpointSiteSP> sites;
+    bp_sites.GetSites (sites);
+    std::vector<std::vector<BreakpointSite *> > groups;
+    size_t num_enabled = 0;
+    GroupSoftwareBreakpointSites (*this, sites, true, groups, num_enabled, error);
+
+    for (size_t i = 0; i < groups.size(); ++i)
+    {
+        const std::vector<BreakpointSite *> &group = groups[i];
+        const addr_t group_addr = group.front()->GetLoadAddress();
+        const size_t group_size = group.back()->GetLoadAddress() + group.back()->GetByteSize() - group_addr;
+        Error group_error;
+        std::vector<uint8_t> orig_bytes (group_size);
+        if (group.size() == 1 ||
+            DoReadMemory (group_addr, &orig_bytes[0], group_size, group_error) != group_size)
+        {
+            // Fall back on one site at a time so each one gets its own error
+            for (size_t j = 0; j < group.size(); ++j)
+            {
+                Error site_error (EnableSoftwareBreakpoint (group[j]));
+                if (site_error.Success())
+                    ++num_enabled;
+                else if (error.Success())
+                    error = site_error;
+            }
+            continue;
+        }
+
+        // Save the original opcodes and put the traps in their place
+        std::vector<uint8_t> bp_bytes (orig_bytes);
+        for (size_t j = 0; j < group.size(); ++j)
+        {
+            const size_t offset = group[j]->GetLoadAddress() - group_addr;
+            ::memcpy (group[j]->GetSavedOpcodeBytes(), &orig_bytes[offset], group[j]->GetByteSize());
+            ::memcpy (&bp_bytes[offset], group[j]->GetTrapOpcodeBytes(), group[j]->GetByteSize());
+        }
+
+        if (DoWriteMemory (group_addr, &bp_bytes[0], group_size, group_error) != group_size)
+        {
+            // Put back any part of the block that did get written
+            DoWriteMemory (group_addr, &orig_bytes[0], group_size, group_error);
+            if (error.Success())
+                error.SetErrorString("Unable to write breakpoint trap to memory.");
+            continue;
+        }
+
+        std::vector<uint8_t> verify_bytes (group_size);
+        if (DoReadMemory (group_addr, &verify_bytes[0], group_size, group_error) != group_size)
+        {
+            if (error.Success())
+                error.SetErrorString("Unable to read memory to verify breakpoint trap.");
+            continue;
+        }
+
+        for (size_t j = 0; j < group.size(); ++j)
+        {
+            const size_t offset = group[j]->GetLoadAddress() - group_addr;
+            if (::memcmp (&verify_bytes[offset], group[j]->GetTrapOpcodeBytes(), group[j]->GetByteSize()) == 0)
+            {
+                group[j]->SetEnabled(true);
+                group[j]->SetType (BreakpointSite::eSoftware);
+                ++num_enabled;
+            }
+            else if (error.Success())
+                error.SetErrorString("failed to verify the breakpoint trap in memory.");
+        }
+        if (log)
+            log->Printf ("Process::EnableSoftwareBreakpoints () wrote %zu traps in 0x%llx-0x%llx",
+                         group.size(),
+                         (uint64_t)group_addr,
+                         (uint64_t)(group_addr + group_size));
+    }
+    return num_enabled;
+}
+
+size_t
+Process::DisableSoftwareBreakpoints (const BreakpointSiteList &bp_sites, Error &error)
+{
+    LogSP log(lldb_private::GetLogIfAnyCategoriesSet (LIBLLDB_LOG_BREAKPOINTS));
+    std::vector<BreakpointSiteSP> sites;
+    bp_sites.GetSites (sites);
+    std::vector<std::vector<BreakpointSite *> > groups;
+    size_t num_disabled = 0;
+    GroupSoftwareBreakpointSites (*this, sites, false, groups, num_disabled, error);
+
+    for (size_t i = 0; i < groups.size(); ++i)
+    {
+        const std::vector<BreakpointSite *> &group = groups[i];
+        const addr_t group_addr = group.front()->GetLoadAddress();
+        const size_t group_size = group.back()->GetLoadAddress() + group.back()->GetByteSize() - group_addr;
+        Error group_error;
+        std::vector<uint8_t> curr_bytes (group_size);
+        if (group.size() == 1 ||
+            DoReadMemory (group_addr, &curr_bytes[0], group_size, group_error) != group_size)
+        {
+            for (size_t j = 0; j < group.size(); ++j)
+            {
+                Error site_error (DisableSoftwareBreakpoint (group[j]));
+                if (site_error.Success())
+                    ++num_disabled;
+                else if (error.Success())
+                    error = site_error;
+            }
+            continue;
+        }
+
+        // Put back the original opcode of every trap that is still there.
+        // A site whose trap is gone may already have its original opcode
+        // back, which the verify below finds out.
+        std::vector<uint8_t> restored_bytes (curr_bytes);
+        for (size_t j = 0; j < group.size(); ++j)
+        {
+            const size_t offset = group[j]->GetLoadAddress() - group_addr;
+            if (::memcmp (&curr_bytes[offset], group[j]->GetTrapOpcodeBytes(), group[j]->GetByteSize()) == 0)
+                ::memcpy (&restored_bytes[offset], group[j]->GetSavedOpcodeBytes(), group[j]->GetByteSize());
+        }
+
+        std::vector<uint8_t> verify_bytes (group_size);
+        if (restored_bytes != curr_bytes)
+        {
+            if (DoWriteMemory (group_addr, &restored_bytes[0], group_size, group_error) != group_size)
+            {
+                DoWriteMemory (group_addr, &curr_bytes[0], group_size, group_error);
+                if (error.Success())
+                    error.SetErrorString("Memory write failed when restoring original opcode.");
+                continue;
+            }
+        }
+
+        if (DoReadMemory (group_addr, &verify_bytes[0], group_size, group_error) != group_size)
+        {
+            if (error.Success())
+                error.SetErrorString("Failed to read memory to verify that breakpoint trap was restored.");
+            continue;
+        }
+
+        for (size_t j = 0; j < group.size(); ++j)
+        {
+            const size_t offset = group[j]->GetLoadAddress() - group_addr;
+            if (::memcmp (&verify_bytes[offset], group[j]->GetSavedOpcodeBytes(), group[j]->GetByteSize()) == 0)
+            {
+                group[j]->SetEnabled(false);
+                ++num_disabled;
+            }
+            else if (error.Success())
+                error.SetErrorString("Failed to restore original opcode.");
+        }
+        if (log)
+            log->Printf ("Process::DisableSoftwareBreakpoints () restored %zu opcodes in 0x%llx-0x%llx",
+                         group.size(),
+                         (uint64_t)group_addr,
+                         (uint64_t)(group_addr + group_size));
+    }
+    return num_disabled;
+}
+
 // Uncomment to verify memory caching works after making changes to caching code
 //#define VERIFY_MEMORY_READS
 
 size_t
 Process::ReadMemory (addr_t addr, void *buf, size_t size, Error &error)
 {
+    if (buf && size && GetReadOnlyMemoryFromFiles())
+    {
+        if (ReadMemoryFromFiles (addr, buf, size) == size)
+        {
+            error.Clear();
+            return size;
+        }
+    }
+
     if (!GetDisableMemoryCache())
     {        
 #if defined (VERIFY_MEMORY_READS)
@@ -2109,68 +2597,126 @@ Process::ReadMemory (addr_t addr, void *buf, size_t size, Error &error)
         return ReadMemoryFromInferior (addr, buf, size, error);
     }
 }
+
+size_t
+Process::ReadMemoryFromFiles (addr_t addr, void *buf, size_t size)
+{
+    // Stack and heap addresses don't resolve, so most reads that can't
+    // be served from a file stop here
+    Target &target = GetTarget();
+    Address section_addr;
+    if (!target.GetSectionLoadList().ResolveLoadAddress (addr, section_addr))
+        return 0;
+
+    SectionSP section_sp (section_addr.GetSection());
+    if (!section_sp || section_sp->IsEncrypted())
+        return 0;
+    if (section_addr.GetOffset() + size > section_sp->GetByteSize())
+        return 0;
+
+    // Without a UUID there is no telling whether the file is the one the
+    // process loaded. Object files that were read from memory would just
+    // read from us again.
+    ModuleSP module_sp (section_sp->GetModule());
+    if (!module_sp || !module_sp->GetUUID().IsValid())
+        return 0;
+    ObjectFile *objfile = module_sp->GetObjectFile();
+    if (objfile == NULL || objfile->IsInMemory())
+        return 0;
+
+    if (!target.FileCacheMatchesMemory (section_addr, size))
+        return 0;
+
+    if (objfile->ReadSectionData (section_sp.get(), section_addr.GetOffset(), buf, size) != size)
+        return 0;
+
+    static StatisticsCounter &g_file_reads = Statistics::GetCounter ("process.memory.file-reads");
+    static StatisticsCounter &g_file_bytes_read = Statistics::GetCounter ("process.memory.file-bytes-read");
+    g_file_reads.Add ();
+    g_file_bytes_read.Add (size);
+    return size;
+}
+
+void
+Process::PrefetchMemory (addr_t addr, size_t size)
+{
+    if (!GetDisableMemoryCache())
+        m_memory_cache.Prefetch (addr, size);
+}
+
+void
+Process::PrefetchStackMemory (addr_t sp)
+{
+    if (sp == 0 || sp == LLDB_INVALID_ADDRESS)
+        return;
+    const uint64_t prefetch_size = GetStackPrefetchSize();
+    if (prefetch_size > 0)
+        PrefetchMemory (sp, prefetch_size);
+}
     
 size_t
 Process::ReadCStringFromMemory (addr_t addr, std::string &out_str, Error &error)
 {
-    char buf[256];
+    return ReadCStringFromMemory (addr, out_str, SIZE_MAX, error);
+}
+
+// No read of a C string crosses a multiple of this, it is the smallest
+// page size of the architectures we debug
+#define CSTRING_READ_PAGE_SIZE 4096
+
+size_t
+Process::ReadCStringFromMemory (addr_t addr, std::string &out_str, size_t max_len, Error &result_error)
+{
     out_str.clear();
+    result_error.Clear();
+
+    const size_t cache_line_size = m_memory_cache.GetMemoryCacheLineSize();
+    size_t chunk_size = cache_line_size - (addr % cache_line_size);
     addr_t curr_addr = addr;
-    while (1)
+    while (out_str.size() < max_len)
     {
-        size_t length = ReadCStringFromMemory (curr_addr, buf, sizeof(buf), error);
-        if (length == 0)
+        const addr_t page_bytes_left = CSTRING_READ_PAGE_SIZE - (curr_addr % CSTRING_READ_PAGE_SIZE);
+        const size_t offset = out_str.size();
+        const size_t bytes_to_read = std::min<addr_t> (std::min<addr_t> (chunk_size, page_bytes_left), max_len - offset);
+        out_str.resize (offset + bytes_to_read);
+
+        Error error;
+        const size_t bytes_read = ReadMemory (curr_addr, &out_str[offset], bytes_to_read, error);
+        if (bytes_read == 0)
+        {
+            result_error = error;
+            out_str.resize (offset);
             break;
-        out_str.append(buf, length);
-        // If we got "length - 1" bytes, we didn't get the whole C string, we
-        // need to read some more characters
-        if (length == sizeof(buf) - 1)
-            curr_addr += length;
-        else
+        }
+
+        const char *terminator = (const char *)::memchr (&out_str[offset], '\0', bytes_read);
+        if (terminator)
+        {
+            out_str.resize (terminator - out_str.data());
             break;
+        }
+        out_str.resize (offset + bytes_read);
+        if (bytes_read < bytes_to_read)
+            break;
+
+        curr_addr += bytes_read;
+        chunk_size = std::min<size_t> (chunk_size * 2, CSTRING_READ_PAGE_SIZE);
     }
     return out_str.size();
 }
 
-
 size_t
 Process::ReadCStringFromMemory (addr_t addr, char *dst, size_t dst_max_len, Error &result_error)
 {
     size_t total_cstr_len = 0;
     if (dst && dst_max_len)
     {
-        result_error.Clear();
         // NULL out everything just to be safe
         memset (dst, 0, dst_max_len);
-        Error error;
-        addr_t curr_addr = addr;
-        const size_t cache_line_size = m_memory_cache.GetMemoryCacheLineSize();
-        size_t bytes_left = dst_max_len - 1;
-        char *curr_dst = dst;
-        
-        while (bytes_left > 0)
-        {
-            addr_t cache_line_bytes_left = cache_line_size - (curr_addr % cache_line_size);
-            addr_t bytes_to_read = std::min<addr_t>(bytes_left, cache_line_bytes_left);
-            size_t bytes_read = ReadMemory (curr_addr, curr_dst, bytes_to_read, error);
-            
-            if (bytes_read == 0)
-            {
-                result_error = error;
-                dst[total_cstr_len] = '\0';
-                break;
-            }
-            const size_t len = strlen(curr_dst);
-
-            total_cstr_len += len;
-
-            if (len < bytes_to_read)
-                break;
-
-            curr_dst += bytes_read;
-            curr_addr += bytes_read;
-            bytes_left -= bytes_read;
-        }
+        std::string cstr;
+        total_cstr_len = ReadCStringFromMemory (addr, cstr, dst_max_len - 1, result_error);
+        if (total_cstr_len > 0)
+            memcpy (dst, cstr.data(), total_cstr_len);
     }
     else
     {
@@ -2203,6 +2749,11 @@ Process::ReadMemoryFromInferior (addr_t addr, void *buf, size_t size, Error &err
             break;
     }
 
+    static StatisticsCounter &g_reads = Statistics::GetCounter ("process.memory.reads");
+    static StatisticsCounter &g_bytes_read = Statistics::GetCounter ("process.memory.bytes-read");
+    g_reads.Add ();
+    g_bytes_read.Add (bytes_read);
+
     // Replace any software breakpoint opcodes that fall into this range back
     // into "buf" before we return
     if (bytes_read > 0)
@@ -2210,6 +2761,138 @@ Process::ReadMemoryFromInferior (addr_t addr, void *buf, size_t size, Error &err
     return bytes_read;
 }
 
+size_t
+Process::DoReadMemoryRanges (MemoryReadRange *ranges, size_t num_ranges, Error &error)
+{
+    size_t total_bytes_read = 0;
+    for (size_t i=0; i<num_ranges; ++i)
+    {
+        ranges[i].bytes_read = 0;
+        if (ranges[i].buf && ranges[i].size)
+            ranges[i].bytes_read = DoReadMemory (ranges[i].addr, ranges[i].buf, ranges[i].size, error);
+        total_bytes_read += ranges[i].bytes_read;
+    }
+    return total_bytes_read;
+}
+
+size_t
+Process::ReadMemoryRangesFromInferior (MemoryReadRange *ranges, size_t num_ranges, Error &error)
+{
+    if (ranges == NULL || num_ranges == 0)
+        return 0;
+
+    DoReadMemoryRanges (ranges, num_ranges, error);
+    static StatisticsCounter &g_range_reads = Statistics::GetCounter ("process.memory.range-reads");
+    g_range_reads.Add ();
+
+    size_t total_bytes_read = 0;
+    for (size_t i=0; i<num_ranges; ++i)
+    {
+        MemoryReadRange &range = ranges[i];
+        uint8_t *bytes = (uint8_t *)range.buf;
+        if (range.bytes_read > 0)
+        {
+            // Finish ranges that were read short, like ReadMemoryFromInferior() does
+            while (range.bytes_read < range.size)
+            {
+                const size_t curr_size = range.size - range.bytes_read;
+                const size_t curr_bytes_read = DoReadMemory (range.addr + range.bytes_read,
+                                                             bytes + range.bytes_read,
+                                                             curr_size,
+                                                             error);
+                range.bytes_read += curr_bytes_read;
+                if (curr_bytes_read == 0)
+                    break;
+            }
+            RemoveBreakpointOpcodesFromBuffer (range.addr, range.bytes_read, bytes);
+        }
+        total_bytes_read += range.bytes_read;
+    }
+    static StatisticsCounter &g_bytes_read = Statistics::GetCounter ("process.memory.bytes-read");
+    g_bytes_read.Add (total_bytes_read);
+    return total_bytes_read;
+}
+
+size_t
+Process::ReadMemoryRanges (MemoryReadRange *ranges, size_t num_ranges, Error &error)
+{
+    if (ranges == NULL || num_ranges == 0)
+        return 0;
+
+    if (GetDisableMemoryCache())
+        return ReadMemoryRangesFromInferior (ranges, num_ranges, error);
+
+    // Get all of the missing memory into the cache at once, then serve
+    // each range from the cache.
+    m_memory_cache.PrefetchRanges (ranges, num_ranges);
+    size_t total_bytes_read = 0;
+    for (size_t i=0; i<num_ranges; ++i)
+    {
+        ranges[i].bytes_read = m_memory_cache.Read (ranges[i].addr, ranges[i].buf, ranges[i].size, error);
+        total_bytes_read += ranges[i].bytes_read;
+    }
+    return total_bytes_read;
+}
+
+addr_t
+Process::FindInMemory (addr_t start_addr, addr_t end_addr, const uint8_t *pattern, size_t pattern_size, Error &error)
+{
+    error.Clear();
+    if (pattern == NULL || pattern_size == 0)
+    {
+        error.SetErrorString ("empty search pattern");
+        return LLDB_INVALID_ADDRESS;
+    }
+    if (start_addr >= end_addr)
+    {
+        error.SetErrorString ("invalid search range");
+        return LLDB_INVALID_ADDRESS;
+    }
+
+    // Read the range in large chunks that overlap by one byte less than
+    // the pattern so we find matches that straddle two chunks. The memory
+    // cache is bypassed since we won't be reading this memory again.
+    const size_t chunk_size = std::max<size_t> (512 * 1024, pattern_size * 2);
+    DataBufferHeap chunk (chunk_size, 0);
+    uint8_t *chunk_bytes = chunk.GetBytes();
+    addr_t addr = start_addr;
+    while (addr < end_addr && end_addr - addr >= pattern_size)
+    {
+        const size_t read_size = std::min<addr_t> (chunk_size, end_addr - addr);
+        Error read_error;
+        const size_t bytes_read = ReadMemoryFromInferior (addr, chunk_bytes, read_size, read_error);
+        if (bytes_read >= pattern_size)
+        {
+            const uint8_t *match = std::search (chunk_bytes, chunk_bytes + bytes_read, pattern, pattern + pattern_size);
+            if (match != chunk_bytes + bytes_read)
+                return addr + (match - chunk_bytes);
+        }
+
+        if (bytes_read == read_size)
+        {
+            if (end_addr - addr == read_size)
+                break;
+            addr += bytes_read - (pattern_size - 1);
+        }
+        else
+        {
+            // Skip to the next page, or to the end of the unreadable
+            // region if we know where that is
+            const addr_t unreadable_addr = addr + bytes_read;
+            addr_t next_addr = (unreadable_addr + 0x1000) & ~((addr_t)0xfff);
+            MemoryRegionInfo region_info;
+            if (GetMemoryRegionInfo (unreadable_addr, region_info).Success() &&
+                region_info.GetReadable() == MemoryRegionInfo::eNo &&
+                region_info.GetRange().GetRangeEnd() > next_addr)
+                next_addr = region_info.GetRange().GetRangeEnd();
+            if (next_addr <= addr)
+                break;
+            addr = next_addr;
+        }
+    }
+    return LLDB_INVALID_ADDRESS;
+}
+
 uint64_t
 Process::ReadUnsignedIntegerFromMemory (lldb::addr_t vm_addr, size_t integer_byte_size, uint64_t fail_value, Error &error)
 {
@@ -2260,6 +2943,10 @@ Process::WriteMemoryPrivate (addr_t addr, const void *buf, size_t size, Error &e
         if (curr_bytes_written == curr_size || curr_bytes_written == 0)
             break;
     }
+    static StatisticsCounter &g_writes = Statistics::GetCounter ("process.memory.writes");
+    static StatisticsCounter &g_bytes_written = Statistics::GetCounter ("process.memory.bytes-written");
+    g_writes.Add ();
+    g_bytes_written.Add (bytes_written);
     return bytes_written;
 }
 
@@ -2275,6 +2962,18 @@ Process::WriteMemory (addr_t addr, const void *buf, size_t size, Error &error)
 
     m_mod_id.BumpMemoryID();
 
+    // Remember writes to memory that Target::ReadMemory() might otherwise
+    // read from an object file. Writes to the stack and heap don't resolve
+    // to a section and aren't worth keeping track of.
+    Address section_addr;
+    if (GetTarget().GetSectionLoadList().ResolveLoadAddress (addr, section_addr))
+    {
+        Mutex::Locker locker (m_written_section_ranges_mutex);
+        m_written_section_ranges.Append (RangeArray<addr_t, addr_t, 4>::Entry (addr, size));
+        m_written_section_ranges.Sort();
+        m_written_section_ranges.CombineConsecutiveRanges();
+    }
+
     // We need to write any data that would go where any current software traps
     // (enabled software breakpoints) any software traps (breakpoints) that we
     // may have placed in our tasks memory.
@@ -2339,6 +3038,24 @@ Process::WriteMemory (addr_t addr, const void *buf, size_t size, Error &error)
     return bytes_written;
 }
 
+bool
+Process::SectionMemoryWasWritten (addr_t addr, size_t size) const
+{
+    Mutex::Locker locker (m_written_section_ranges_mutex);
+    const addr_t end_addr = addr + size;
+    const size_t num_ranges = m_written_section_ranges.GetSize();
+    for (size_t i = 0; i < num_ranges; ++i)
+    {
+        const RangeArray<addr_t, addr_t, 4>::Entry *range = m_written_section_ranges.GetEntryAtIndex (i);
+        // The ranges are sorted, so none of the rest can intersect
+        if (range->GetRangeBase() >= end_addr)
+            break;
+        if (range->GetRangeEnd() > addr)
+            return true;
+    }
+    return false;
+}
+
 size_t
 Process::WriteScalarToMemory (addr_t addr, const Scalar &scalar, uint32_t byte_size, Error &error)
 {
@@ -2416,6 +3133,26 @@ Process::AllocateMemory(size_t size, uint32_t permissions, Error &error)
 #endif
 }
 
+addr_t
+Process::AllocateExpressionMemory (size_t size, uint32_t permissions, Error &error)
+{
+    if (GetPrivateState() != eStateStopped)
+    {
+        error.SetErrorString ("process must be stopped to allocate expression memory");
+        return LLDB_INVALID_ADDRESS;
+    }
+
+    addr_t addr = m_expression_arena.AllocateMemory (size, permissions, error);
+    if (addr != LLDB_INVALID_ADDRESS)
+        return addr;
+    if (error.Fail())
+        error.Clear();
+    addr = AllocateMemory (size, permissions, error);
+    if (addr == LLDB_INVALID_ADDRESS && error.Success())
+        error.SetErrorStringWithFormat ("couldn't allocate %zu bytes of expression memory", size);
+    return addr;
+}
+
 bool
 Process::CanJIT ()
 {
@@ -2448,6 +3185,9 @@ Error
 Process::DeallocateMemory (addr_t ptr)
 {
     Error error;
+    // Expression arena memory is released when the expression epoch ends
+    if (m_expression_arena.Contains(ptr))
+        return error;
 #if defined (USE_ALLOCATE_MEMORY_CACHE)
     if (!m_allocated_memory_cache.DeallocateMemory(ptr))
     {
@@ -2512,7 +3252,7 @@ Process::DisableWatchpoint (Watchpoint *watchpoint)
 }
 
 StateType
-Process::WaitForProcessStopPrivate (const TimeValue *timeout, EventSP &event_sp)
+Process::WaitForProcessStopPrivate (const TimeValue *timeout, EventIntrusiveSP &event_sp)
 {
     StateType state;
     // Now wait for the process to launch and return control to us, and then
@@ -2538,6 +3278,10 @@ Process::WaitForProcessStopPrivate (const TimeValue *timeout, EventSP &event_sp)
 Error
 Process::Launch (const ProcessLaunchInfo &launch_info)
 {
+    // The executable and its libraries may have been rebuilt since they
+    // were last looked at
+    FileSpec::ClearFileCache();
+
     Error error;
     m_abi_sp.reset();
     m_dyld_ap.reset();
@@ -2586,7 +3330,7 @@ Process::Launch (const ProcessLaunchInfo &launch_info)
                 }
                 else
                 {
-                    EventSP event_sp;
+                    EventIntrusiveSP event_sp;
                     TimeValue timeout_time;
                     timeout_time = TimeValue::Now();
                     timeout_time.OffsetWithSeconds(10);
@@ -2671,7 +3415,7 @@ Process::GetDynamicLoader ()
 
 
 Process::NextEventAction::EventActionResult
-Process::AttachCompletionHandler::PerformAction (lldb::EventSP &event_sp)
+Process::AttachCompletionHandler::PerformAction (lldb::EventIntrusiveSP &event_sp)
 {
     StateType state = ProcessEventData::GetStateFromEvent (event_sp.get());
     switch (state) 
@@ -2726,11 +3470,17 @@ Process::AttachCompletionHandler::GetExitString ()
 Error
 Process::Attach (ProcessAttachInfo &attach_info)
 {
+    FileSpec::ClearFileCache();
+
     m_abi_sp.reset();
     m_process_input_reader.reset();
     m_dyld_ap.reset();
     m_os_ap.reset();
     
+    m_defer_attach_symbols = attach_info.GetDeferSymbolLoading();
+    if (m_defer_attach_symbols)
+        m_target.DeferModuleBreakpoints();
+
     lldb::pid_t attach_pid = attach_info.GetProcessID();
     Error error;
     if (attach_pid == LLDB_INVALID_PROCESS_ID)
@@ -2899,6 +3649,32 @@ Process::CompleteAttach ()
     }
     if (new_executable_module_sp)
         m_target.SetExecutableModule (new_executable_module_sp, false);
+
+    if (m_defer_attach_symbols)
+    {
+        m_defer_attach_symbols = false;
+        modules_locker.Unlock();
+
+        // The first backtraces start in the modules the threads are
+        // stopped in, so parse their symbols first
+        ModuleList stopped_in_modules;
+        const uint32_t num_threads = m_thread_list.GetSize();
+        for (uint32_t i=0; i<num_threads; ++i)
+        {
+            ThreadSP thread_sp (m_thread_list.GetThreadAtIndex (i));
+            RegisterContextSP reg_ctx_sp (thread_sp ? thread_sp->GetRegisterContext() : RegisterContextSP());
+            if (!reg_ctx_sp)
+                continue;
+            Address pc_addr;
+            if (m_target.GetSectionLoadList().ResolveLoadAddress (reg_ctx_sp->GetPC(), pc_addr))
+            {
+                ModuleSP module_sp (pc_addr.GetModule());
+                if (module_sp)
+                    stopped_in_modules.AppendIfNeeded (module_sp);
+            }
+        }
+        m_target.PrioritizeModules (stopped_in_modules);
+    }
 }
 
 Error
@@ -2915,7 +3691,7 @@ Process::ConnectRemote (const char *remote_url)
     {
         if (GetID() != LLDB_INVALID_PROCESS_ID)
         {
-            EventSP event_sp;
+            EventIntrusiveSP event_sp;
             StateType state = WaitForProcessStopPrivate(NULL, event_sp);
         
             if (state == eStateStopped || state == eStateCrashed)
@@ -2950,6 +3726,12 @@ Process::PrivateResume ()
                     StateAsCString(m_public_state.GetValue()),
                     StateAsCString(m_private_state.GetValue()));
 
+    // Breakpoints that a fast attach put off, and the ones in modules
+    // that loaded their debug information on demand, have to be in place
+    // before the process runs
+    m_target.ResolveDeferredModules();
+    m_target.ResolveModulesLoadedOnDemand();
+
     Error error (WillResume());
     // Tell the process it is about to resume before the thread list
     if (error.Success())
@@ -3011,7 +3793,7 @@ Process::Halt ()
     Listener halt_listener ("lldb.process.halt_listener");
     HijackPrivateProcessEvents(&halt_listener);
 
-    EventSP event_sp;
+    EventIntrusiveSP event_sp;
     Error error (WillHalt());
     
     if (error.Success())
@@ -3118,7 +3900,7 @@ Process::Destroy ()
             if (error.Success())
             {
                 // Consume the halt event.
-                EventSP stop_event;
+                EventIntrusiveSP stop_event;
                 TimeValue timeout (TimeValue::Now());
                 timeout.OffsetWithSeconds(1);
                 StateType state = WaitForProcessToStop (&timeout);
@@ -3297,7 +4079,30 @@ Process::ShouldBroadcastEvent (Event *event_ptr)
 
                     if (log)
                         log->Printf ("Process::ShouldBroadcastEvent (%p) Restarting process from state: %s", event_ptr, StateAsCString(state));
-                    PrivateResume ();
+                    
+                    const bool internal_continue = CanContinueInternally ();
+                    if (internal_continue)
+                    {
+                        static StatisticsCounter &g_internal_continues = Statistics::GetCounter ("process.internal-continues");
+                        g_internal_continues.Add (1);
+                        Mutex::Locker locker (m_private_state.GetMutex());
+                        m_internal_continue = true;
+                    }
+                    
+                    Error resume_error (PrivateResume ());
+                    if (internal_continue)
+                    {
+                        if (resume_error.Success())
+                        {
+                            // Do what handling the running event would have done
+                            SynchronouslyNotifyStateChanged (eStateRunning);
+                        }
+                        else
+                        {
+                            Mutex::Locker locker (m_private_state.GetMutex());
+                            m_internal_continue = false;
+                        }
+                    }
                 }
                 else
                 {
@@ -3314,6 +4119,20 @@ Process::ShouldBroadcastEvent (Event *event_ptr)
 }
 
 
+bool
+Process::CanContinueInternally ()
+{
+    if (m_next_event_action_ap.get() != NULL)
+        return false;
+    if (!StateIsRunningState (m_public_state.GetValue()))
+        return false;
+    if (IsHijackedForEvent (eBroadcastBitStateChanged))
+        return false;
+    if (m_private_state_broadcaster.IsHijackedForEvent (eBroadcastBitStateChanged))
+        return false;
+    return true;
+}
+
 bool
 Process::StartPrivateStateThread (bool force)
 {
@@ -3438,7 +4257,7 @@ Process::SendAsyncInterrupt ()
 }
 
 void
-Process::HandlePrivateEvent (EventSP &event_sp)
+Process::HandlePrivateEvent (EventIntrusiveSP &event_sp)
 {
     LogSP log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_PROCESS));
     m_currently_handling_event.SetValue(true, eBroadcastNever);
@@ -3535,7 +4354,7 @@ Process::RunPrivateStateThread ()
     bool exit_now = false;
     while (!exit_now)
     {
-        EventSP event_sp;
+        EventIntrusiveSP event_sp;
         WaitForEventsPrivate (NULL, event_sp, control_only);
         if (event_sp->BroadcasterIs(&m_private_state_control_broadcaster))
         {
@@ -3645,6 +4464,87 @@ Process::ProcessEventData::GetFlavor () const
     return ProcessEventData::GetFlavorString ();
 }
 
+void
+Process::StartTypePrewarmThread ()
+{
+    StopTypePrewarmThread ();
+
+    if (!m_target.GetPrewarmFrameVariableTypes())
+        return;
+
+    ThreadSP thread_sp (m_thread_list.GetSelectedThread());
+    if (!thread_sp)
+        return;
+    StackFrameSP frame_sp (thread_sp->GetSelectedFrame());
+    if (!frame_sp)
+        return;
+
+    // Parse the variables here so the pre-warm thread only has to
+    // complete their types. The module keeps the types alive until
+    // the thread is done with them.
+    const SymbolContext &sc = frame_sp->GetSymbolContext (eSymbolContextModule);
+    VariableList *var_list = frame_sp->GetVariableList (false);
+    if (!sc.module_sp || var_list == NULL || var_list->GetSize() == 0)
+        return;
+
+    // Lock the module that owns the AST the types get completed in. The
+    // symbol file may create its types in another module's AST.
+    m_type_prewarm_module_sp = sc.module_sp;
+    SymbolVendor *sym_vendor = sc.module_sp->GetSymbolVendor();
+    if (sym_vendor && sym_vendor->GetSymbolFile())
+    {
+        ModuleSP ast_module_sp (sym_vendor->GetSymbolFile()->GetClangASTModule());
+        if (ast_module_sp)
+            m_type_prewarm_module_sp = ast_module_sp;
+    }
+    const uint32_t num_vars = var_list->GetSize();
+    for (uint32_t i=0; i<num_vars; ++i)
+        m_type_prewarm_variables.push_back (var_list->GetVariableAtIndex(i));
+
+    m_type_prewarm_cancel.SetValue (false, eBroadcastNever);
+    m_type_prewarm_thread = Host::ThreadCreate ("<lldb.process.type-prewarm>", Process::TypePrewarmThread, this, NULL);
+    if (!IS_VALID_LLDB_HOST_THREAD(m_type_prewarm_thread))
+    {
+        m_type_prewarm_variables.clear();
+        m_type_prewarm_module_sp.reset();
+    }
+}
+
+void
+Process::StopTypePrewarmThread ()
+{
+    if (IS_VALID_LLDB_HOST_THREAD(m_type_prewarm_thread))
+    {
+        m_type_prewarm_cancel.SetValue (true, eBroadcastNever);
+        Host::ThreadJoin (m_type_prewarm_thread, NULL, NULL);
+        m_type_prewarm_thread = LLDB_INVALID_HOST_THREAD;
+    }
+    m_type_prewarm_variables.clear();
+    m_type_prewarm_module_sp.reset();
+}
+
+lldb::thread_result_t
+Process::TypePrewarmThread (void *arg)
+{
+    Process *process = (Process *)arg;
+    Module *module = process->m_type_prewarm_module_sp.get();
+    const size_t num_vars = process->m_type_prewarm_variables.size();
+    for (size_t i=0; i<num_vars; ++i)
+    {
+        if (process->m_type_prewarm_cancel.GetValue())
+            break;
+        // Lazily parsed types aren't resolved through the symbol vendor,
+        // so hold the AST module's lock while we resolve each one. Anyone
+        // else completing types in this AST waits for us in
+        // Type::ResolveClangType().
+        Mutex::Locker locker (module->GetMutex());
+        Type *type = process->m_type_prewarm_variables[i]->GetType();
+        if (type)
+            type->GetClangFullType();
+    }
+    return NULL;
+}
+
 void
 Process::ProcessEventData::DoOnRemoval (Event *event_ptr)
 {
@@ -3745,6 +4645,8 @@ Process::ProcessEventData::DoOnRemoval (Event *event_ptr)
                 m_process_sp->GetTarget().RunStopHooks();
                 if (m_process_sp->GetPrivateState() == eStateRunning)
                     SetRestarted(true);
+                else
+                    m_process_sp->StartTypePrewarmThread();
             }
         }
         
@@ -3873,75 +4775,219 @@ Process::CalculateExecutionContext (ExecutionContext &exe_ctx)
 //    return Host::GetArchSpecForExistingProcess (process_name);
 //}
 //
+void
+Process::StdioBuffer::Append (const char *s, size_t len)
+{
+    // Drop the bytes that have been read before the string grows again
+    if (m_read_pos > 0 && m_read_pos >= m_data.size() / 2)
+    {
+        m_data.erase (0, m_read_pos);
+        m_read_pos = 0;
+    }
+    m_data.append (s, len);
+}
+
+void
+Process::StdioBuffer::Consume (size_t len)
+{
+    m_read_pos += std::min (len, GetBytesAvailable());
+    if (m_read_pos == m_data.size())
+    {
+        m_data.clear();
+        m_read_pos = 0;
+    }
+}
+
 void
 Process::AppendSTDOUT (const char * s, size_t len)
 {
-    Mutex::Locker locker (m_stdio_communication_mutex);
-    m_stdout_data.append (s, len);
-    BroadcastEventIfUnique (eBroadcastBitSTDOUT, new ProcessEventData (GetTarget().GetProcessSP(), GetState()));
+    AppendSTDIOData (m_stdout_data, s, len, eBroadcastBitSTDOUT);
 }
 
 void
 Process::AppendSTDERR (const char * s, size_t len)
 {
-    Mutex::Locker locker (m_stdio_communication_mutex);
-    m_stderr_data.append (s, len);
-    BroadcastEventIfUnique (eBroadcastBitSTDERR, new ProcessEventData (GetTarget().GetProcessSP(), GetState()));
+    AppendSTDIOData (m_stderr_data, s, len, eBroadcastBitSTDERR);
 }
 
-//------------------------------------------------------------------
-// Process STDIO
-//------------------------------------------------------------------
-
-size_t
-Process::GetSTDOUT (char *buf, size_t buf_size, Error &error)
+void
+Process::AppendSTDIOData (StdioBuffer &buffer, const char *s, size_t len, uint32_t event_type)
 {
-    Mutex::Locker locker(m_stdio_communication_mutex);
-    size_t bytes_available = m_stdout_data.size();
-    if (bytes_available > 0)
+    const uint64_t max_size = GetSTDIOBufferSize();
+    bool broadcast = false;
+    
+    // Scope for "locker"
     {
-        LogSP log (lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_PROCESS));
-        if (log)
-            log->Printf ("Process::GetSTDOUT (buf = %p, size = %zu)", buf, buf_size);
-        if (bytes_available > buf_size)
+        Mutex::Locker locker (m_stdio_communication_mutex);
+        
+        if (max_size > 0)
         {
-            memcpy(buf, m_stdout_data.c_str(), buf_size);
-            m_stdout_data.erase(0, buf_size);
-            bytes_available = buf_size;
+            if (GetSTDIOOverflowPolicy() == eStdioOverflowBlock)
+            {
+                // Hold on to the bytes until the reader catches up, which
+                // keeps us from reading more from the process in the mean
+                // time. Don't wait forever, nobody might be reading.
+                for (uint32_t i = 0; i < 100 && buffer.GetBytesAvailable() + len > max_size; ++i)
+                {
+                    locker.Unlock();
+                    usleep (1000);
+                    locker.Lock (m_stdio_communication_mutex);
+                }
+            }
+            else
+            {
+                if (len > max_size)
+                {
+                    s += len - max_size;
+                    len = max_size;
+                }
+                const size_t available = buffer.GetBytesAvailable();
+                if (available + len > max_size)
+                    buffer.Consume (available + len - max_size);
+            }
         }
-        else
+        
+        buffer.Append (s, len);
+        
+        // If the reader hasn't been told about the last bytes yet, it
+        // will read these along with them
+        if (!buffer.notification_pending)
         {
-            memcpy(buf, m_stdout_data.c_str(), bytes_available);
-            m_stdout_data.clear();
+            buffer.notification_pending = true;
+            broadcast = true;
         }
     }
-    return bytes_available;
+    
+    if (broadcast)
+        BroadcastEvent (event_type, new ProcessEventData (GetTarget().GetProcessSP(), GetState()));
 }
 
+size_t
+Process::ReadSTDIOData (StdioBuffer &buffer, char *buf, size_t buf_size)
+{
+    Mutex::Locker locker(m_stdio_communication_mutex);
+    buffer.notification_pending = false;
+    const size_t bytes_read = std::min (buffer.GetBytesAvailable(), buf_size);
+    if (bytes_read > 0)
+    {
+        memcpy (buf, buffer.GetBytes(), bytes_read);
+        buffer.Consume (bytes_read);
+    }
+    return bytes_read;
+}
 
 size_t
-Process::GetSTDERR (char *buf, size_t buf_size, Error &error)
+Process::ReadSTDIOData (StdioBuffer &buffer, Stream &strm)
 {
     Mutex::Locker locker(m_stdio_communication_mutex);
-    size_t bytes_available = m_stderr_data.size();
-    if (bytes_available > 0)
+    buffer.notification_pending = false;
+    const size_t bytes_available = buffer.GetBytesAvailable();
+    if (bytes_available == 0)
+        return 0;
+    const size_t bytes_written = strm.Write (buffer.GetBytes(), bytes_available);
+    buffer.Consume (bytes_written);
+    return bytes_written;
+}
+
+//------------------------------------------------------------------
+// Process STDIO
+//------------------------------------------------------------------
+
+size_t
+Process::GetSTDOUT (char *buf, size_t buf_size, Error &error)
+{
+    LogSP log (lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_PROCESS));
+    if (log)
+        log->Printf ("Process::GetSTDOUT (buf = %p, size = %zu)", buf, buf_size);
+    return ReadSTDIOData (m_stdout_data, buf, buf_size);
+}
+
+
+size_t
+Process::GetSTDERR (char *buf, size_t buf_size, Error &error)
+{
+    LogSP log (lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_PROCESS));
+    if (log)
+        log->Printf ("Process::GetSTDERR (buf = %p, size = %zu)", buf, buf_size);
+    return ReadSTDIOData (m_stderr_data, buf, buf_size);
+}
+
+size_t
+Process::GetSTDOUT (Stream &strm, Error &error)
+{
+    size_t total_bytes = ReadSTDIOData (m_stdout_data, strm);
+    
+    // Plug-ins that don't buffer their output with AppendSTDOUT() override
+    // the buffer version of GetSTDOUT(), so fall back to that
+    if (total_bytes == 0)
     {
-        LogSP log (lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_PROCESS));
-        if (log)
-            log->Printf ("Process::GetSTDERR (buf = %p, size = %zu)", buf, buf_size);
-        if (bytes_available > buf_size)
+        char stdio_buffer[4096];
+        size_t len;
+        while ((len = GetSTDOUT (stdio_buffer, sizeof(stdio_buffer), error)) > 0)
+            total_bytes += strm.Write (stdio_buffer, len);
+    }
+    return total_bytes;
+}
+
+size_t
+Process::GetAsyncProfileData (char *buf, size_t buf_size, Error &error)
+{
+    LogSP log (lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_PROCESS));
+    if (log)
+        log->Printf ("Process::GetAsyncProfileData (buf = %p, size = %zu)", buf, buf_size);
+    return ReadSTDIOData (m_profile_data, buf, buf_size);
+}
+
+void
+Process::BroadcastAsyncProfileData (const char *s, size_t len)
+{
+    const uint64_t max_size = GetSTDIOBufferSize();
+    bool broadcast = false;
+    
+    // Scope for "locker"
+    {
+        Mutex::Locker locker (m_stdio_communication_mutex);
+        
+        // Never hold up the process plug-in for samples, nobody might
+        // be reading them, so drop the oldest ones instead
+        if (max_size > 0)
         {
-            memcpy(buf, m_stderr_data.c_str(), buf_size);
-            m_stderr_data.erase(0, buf_size);
-            bytes_available = buf_size;
+            if (len > max_size)
+            {
+                s += len - max_size;
+                len = max_size;
+            }
+            const size_t available = m_profile_data.GetBytesAvailable();
+            if (available + len > max_size)
+                m_profile_data.Consume (available + len - max_size);
         }
-        else
+        
+        m_profile_data.Append (s, len);
+        
+        if (!m_profile_data.notification_pending)
         {
-            memcpy(buf, m_stderr_data.c_str(), bytes_available);
-            m_stderr_data.clear();
+            m_profile_data.notification_pending = true;
+            broadcast = true;
         }
     }
-    return bytes_available;
+    
+    if (broadcast)
+        BroadcastEvent (eBroadcastBitProfileData, new ProcessEventData (GetTarget().GetProcessSP(), GetState()));
+}
+
+size_t
+Process::GetSTDERR (Stream &strm, Error &error)
+{
+    size_t total_bytes = ReadSTDIOData (m_stderr_data, strm);
+    
+    if (total_bytes == 0)
+    {
+        char stdio_buffer[4096];
+        size_t len;
+        while ((len = GetSTDERR (stdio_buffer, sizeof(stdio_buffer), error)) > 0)
+            total_bytes += strm.Write (stdio_buffer, len);
+    }
+    return total_bytes;
 }
 
 void
@@ -4137,6 +5183,10 @@ Process::RunThreadPlan (ExecutionContext &exe_ctx,
         return eExecutionSetupError;
     }
     
+    // If this thread is batching script callbacks, let go of the script interpreter while
+    // we run, the private state thread may need it (e.g. for an OS plug-in) before we stop
+    ScriptInterpreter::BatchSuspender script_batch_suspender;
+    
     // Save the thread & frame from the exe_ctx for restoration after we run
     const uint32_t thread_idx_id = thread->GetIndexID();
     StackID ctx_frame_id = thread->GetSelectedFrame()->GetStackID();
@@ -4195,7 +5245,7 @@ Process::RunThreadPlan (ExecutionContext &exe_ctx,
     
     Listener listener("lldb.process.listener.run-thread-plan");
     
-    lldb::EventSP event_to_broadcast_sp;
+    lldb::EventIntrusiveSP event_to_broadcast_sp;
     
     {
         // This process event hijacker Hijacks the Public events and its destructor makes sure that the process events get
@@ -4217,7 +5267,7 @@ Process::RunThreadPlan (ExecutionContext &exe_ctx,
         }
         
         bool got_event;
-        lldb::EventSP event_sp;
+        lldb::EventIntrusiveSP event_sp;
         lldb::StateType stop_state = lldb::eStateInvalid;
         
         TimeValue* timeout_ptr = NULL;
@@ -10,7 +10,11 @@
 #include "lldb/Target/SectionLoadList.h"
 
 // C Includes
+#include <sched.h>
+
 // C++ Includes
+#include <algorithm>
+
 // Other libraries and framework includes
 // Project includes
 #include "lldb/Core/Log.h"
@@ -24,20 +28,92 @@
 using namespace lldb;
 using namespace lldb_private;
 
+SectionLoadList::SectionLoadList () :
+    m_addr_to_sect (),
+    m_sect_to_addr (),
+    m_lock (),
+    m_snapshot (new Snapshot()),
+    m_retired_snapshots (),
+    m_snapshot_readers (0),
+    m_snapshot_is_stale (false)
+{
+    m_snapshot->last_hit_idx = 0;
+}
+
+SectionLoadList::~SectionLoadList()
+{
+    std::vector<Snapshot *>::iterator pos, end = m_retired_snapshots.end();
+    for (pos = m_retired_snapshots.begin(); pos != end; ++pos)
+        delete *pos;
+    delete m_snapshot;
+}
+
+void
+SectionLoadList::UpdateSnapshot () const
+{
+    Snapshot *snapshot = new Snapshot();
+    snapshot->last_hit_idx = 0;
+    snapshot->sections.reserve (m_addr_to_sect.size());
+    addr_to_sect_collection::const_iterator pos, end = m_addr_to_sect.end();
+    for (pos = m_addr_to_sect.begin(); pos != end; ++pos)
+    {
+        LoadedSection loaded_section;
+        loaded_section.load_addr = pos->first;
+        loaded_section.section_sp = pos->second;
+        snapshot->sections.push_back (loaded_section);
+    }
+
+    m_retired_snapshots.push_back (m_snapshot);
+    m_snapshot = snapshot;
+    m_snapshot_is_stale = false;
+    __sync_synchronize();
+
+    // Lookups announce themselves before they load the snapshot pointer,
+    // so if there are none right now nobody can be using the old ones.
+    // Lookups are constant, so unlike the Broadcaster we don't wait for
+    // them to drain, the old snapshots just go the next time we get here.
+    if (m_snapshot_readers == 0)
+    {
+        std::vector<Snapshot *>::iterator pos, end = m_retired_snapshots.end();
+        for (pos = m_retired_snapshots.begin(); pos != end; ++pos)
+            delete *pos;
+        m_retired_snapshots.clear();
+    }
+}
+
+const SectionLoadList::Snapshot *
+SectionLoadList::AcquireSnapshot () const
+{
+    if (m_snapshot_is_stale)
+    {
+        ReadWriteLock::WriteLocker locker(m_lock);
+        if (m_snapshot_is_stale)
+            UpdateSnapshot ();
+    }
+    __sync_add_and_fetch (&m_snapshot_readers, 1);
+    return m_snapshot;
+}
+
+void
+SectionLoadList::ReleaseSnapshot () const
+{
+    __sync_sub_and_fetch (&m_snapshot_readers, 1);
+}
 
 bool
 SectionLoadList::IsEmpty() const
 {
-    Mutex::Locker locker(m_mutex);
+    ReadWriteLock::ReadLocker locker(m_lock);
     return m_addr_to_sect.empty();
 }
 
 void
 SectionLoadList::Clear ()
 {
-    Mutex::Locker locker(m_mutex);
+    ReadWriteLock::WriteLocker locker(m_lock);
     m_addr_to_sect.clear();
     m_sect_to_addr.clear();
+    m_snapshot_is_stale = true;
 }
 
 addr_t
@@ -47,7 +123,7 @@ SectionLoadList::GetSectionLoadAddress (const lldb::SectionSP &section) const
     addr_t section_load_addr = LLDB_INVALID_ADDRESS;
     if (section)
     {
-        Mutex::Locker locker(m_mutex);
+        ReadWriteLock::ReadLocker locker(m_lock);
         sect_to_addr_collection::const_iterator pos = m_sect_to_addr.find (section.get());
         
         if (pos != m_sect_to_addr.end())
@@ -78,7 +154,7 @@ SectionLoadList::SetSectionLoadAddress (const lldb::SectionSP &section, addr_t l
         return false; // No change
 
     // Fill in the section -> load_addr map
-    Mutex::Locker locker(m_mutex);
+    ReadWriteLock::WriteLocker locker(m_lock);
     sect_to_addr_collection::iterator sta_pos = m_sect_to_addr.find(section.get());
     if (sta_pos != m_sect_to_addr.end())
     {
@@ -126,6 +202,7 @@ SectionLoadList::SetSectionLoadAddress (const lldb::SectionSP &section, addr_t l
     else
         m_addr_to_sect[load_addr] = section;
 
+    m_snapshot_is_stale = true;
     return true;    // Changed
 }
 
@@ -150,7 +227,7 @@ SectionLoadList::SetSectionUnloaded (const lldb::SectionSP &section_sp)
                          section_sp->GetName().AsCString());
         }
 
-        Mutex::Locker locker(m_mutex);
+        ReadWriteLock::WriteLocker locker(m_lock);
         
         sect_to_addr_collection::iterator sta_pos = m_sect_to_addr.find(section_sp.get());
         if (sta_pos != m_sect_to_addr.end())
@@ -161,6 +238,7 @@ SectionLoadList::SetSectionUnloaded (const lldb::SectionSP &section_sp)
             addr_to_sect_collection::iterator ats_pos = m_addr_to_sect.find(load_addr);
             if (ats_pos != m_addr_to_sect.end())
                 m_addr_to_sect.erase (ats_pos);
+            m_snapshot_is_stale = true;
         }
     }
     return unload_count;
@@ -184,7 +262,7 @@ SectionLoadList::SetSectionUnloaded (const lldb::SectionSP &section_sp, addr_t l
                      load_addr);
     }
     bool erased = false;
-    Mutex::Locker locker(m_mutex);
+    ReadWriteLock::WriteLocker locker(m_lock);
     sect_to_addr_collection::iterator sta_pos = m_sect_to_addr.find(section_sp.get());
     if (sta_pos != m_sect_to_addr.end())
     {
@@ -199,60 +277,86 @@ SectionLoadList::SetSectionUnloaded (const lldb::SectionSP &section_sp, addr_t l
         m_addr_to_sect.erase (ats_pos);
     }
 
+    if (erased)
+        m_snapshot_is_stale = true;
     return erased;
 }
 
 
+// Compares a load address to the start of a loaded section for
+// std::upper_bound()
+bool
+SectionLoadList::LoadAddressLessThanSection (addr_t load_addr, const LoadedSection &loaded_section)
+{
+    return load_addr < loaded_section.load_addr;
+}
+
+bool
+SectionLoadList::SectionContainsLoadAddress (const LoadedSection &loaded_section, addr_t load_addr)
+{
+    return load_addr >= loaded_section.load_addr &&
+           load_addr - loaded_section.load_addr < loaded_section.section_sp->GetByteSize();
+}
+
 bool
 SectionLoadList::ResolveLoadAddress (addr_t load_addr, Address &so_addr) const
 {
-    // First find the top level section that this load address exists in    
-    Mutex::Locker locker(m_mutex);
-    if (!m_addr_to_sect.empty())
+    bool resolved = false;
+    bool found = false;
+    const Snapshot *snapshot = AcquireSnapshot ();
+    const loaded_section_collection &sections = snapshot->sections;
+    if (!sections.empty())
     {
-        addr_to_sect_collection::const_iterator pos = m_addr_to_sect.lower_bound (load_addr);
-        if (pos != m_addr_to_sect.end())
+        // Symbolication, disassembly and the like look up a lot of
+        // addresses in the same section in a row, so check the section
+        // the last lookup found before searching.
+        uint32_t idx = snapshot->last_hit_idx;
+        if (idx < sections.size() && SectionContainsLoadAddress (sections[idx], load_addr))
         {
-            if (load_addr != pos->first && pos != m_addr_to_sect.begin())
-                --pos;
-            if (load_addr >= pos->first)
-            {
-                addr_t offset = load_addr - pos->first;
-                if (offset < pos->second->GetByteSize())
-                {
-                    // We have found the top level section, now we need to find the
-                    // deepest child section.
-                    return pos->second->ResolveContainedAddress (offset, so_addr);
-                }
-            }
+            found = true;
         }
         else
         {
-            // There are no entries that have an address that is >= load_addr,
-            // so we need to check the last entry on our collection.
-            addr_to_sect_collection::const_reverse_iterator rpos = m_addr_to_sect.rbegin();
-            if (load_addr >= rpos->first)
+            // Find the last section that starts at or before load_addr
+            loaded_section_collection::const_iterator pos = std::upper_bound (sections.begin(),
+                                                                              sections.end(),
+                                                                              load_addr,
+                                                                              LoadAddressLessThanSection);
+            if (pos != sections.begin())
             {
-                addr_t offset = load_addr - rpos->first;
-                if (offset < rpos->second->GetByteSize())
+                idx = pos - sections.begin() - 1;
+                if (SectionContainsLoadAddress (sections[idx], load_addr))
                 {
-                    // We have found the top level section, now we need to find the
-                    // deepest child section.
-                    return rpos->second->ResolveContainedAddress (offset, so_addr);
+                    found = true;
+                    snapshot->last_hit_idx = idx;
                 }
             }
         }
+
+        // We have found the top level section, now we need to find the
+        // deepest child section.
+        if (found)
+            resolved = sections[idx].section_sp->ResolveContainedAddress (load_addr - sections[idx].load_addr, so_addr);
     }
-    so_addr.Clear();
-    return false;
+    ReleaseSnapshot ();
+
+    if (!found)
+        so_addr.Clear();
+    return resolved;
 }
 
 void
 SectionLoadList::Dump (Stream &s, Target *target)
 {
-    Mutex::Locker locker(m_mutex);
+    // Dumping a section looks up its load address, so don't hold the
+    // lock while doing it
+    addr_to_sect_collection addr_to_sect;
+    {
+        ReadWriteLock::ReadLocker locker(m_lock);
+        addr_to_sect = m_addr_to_sect;
+    }
     addr_to_sect_collection::const_iterator pos, end;
-    for (pos = m_addr_to_sect.begin(), end = m_addr_to_sect.end(); pos != end; ++pos)
+    for (pos = addr_to_sect.begin(), end = addr_to_sect.end(); pos != end; ++pos)
     {
         s.Printf("addr = 0x%16.16llx, section = %p: ", pos->first, pos->second.get());
         pos->second->Dump (&s, target, 0);
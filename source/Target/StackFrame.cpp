@@ -336,6 +336,11 @@ StackFrame::GetSymbolContext (uint32_t resolve_scope)
         }
 
 
+        // A module that only loads its debug information on demand needs
+        // it once it is in a backtrace
+        if (m_sc.module_sp && (resolve_scope & (eSymbolContextCompUnit | eSymbolContextFunction | eSymbolContextBlock | eSymbolContextLineEntry)))
+            m_sc.module_sp->LoadSymbolsOnDemand();
+
         uint32_t resolved = 0;
         if (m_sc.module_sp)
         {
@@ -524,6 +529,45 @@ StackFrame::GetInScopeVariableList (bool get_file_globals)
     return var_list_sp;
 }
 
+VariableListSP
+StackFrame::GetScopeVariableList (bool get_file_globals)
+{
+    VariableListSP var_list_sp(new VariableList);
+    GetSymbolContext (eSymbolContextCompUnit | eSymbolContextBlock);
+
+    // GetVariableList() has the outermost block's variables first, so
+    // find the blocks out to the function (or inlined function) and add
+    // their variables in reverse.
+    std::vector<Block *> scope_blocks;
+    for (Block *block = m_sc.block; block != NULL; block = block->GetParent())
+    {
+        scope_blocks.push_back (block);
+        if (block->GetInlinedFunctionInfo())
+            break;
+    }
+
+    const bool can_create = true;
+    const bool get_parent_variables = false;
+    const bool stop_if_block_is_inlined_function = true;
+    std::vector<Block *>::reverse_iterator pos, end = scope_blocks.rend();
+    for (pos = scope_blocks.rbegin(); pos != end; ++pos)
+    {
+        (*pos)->AppendVariables (can_create,
+                                 get_parent_variables,
+                                 stop_if_block_is_inlined_function,
+                                 var_list_sp.get());
+    }
+
+    if (m_sc.comp_unit && get_file_globals)
+    {
+        VariableListSP global_variable_list_sp (m_sc.comp_unit->GetVariableList(true));
+        if (global_variable_list_sp)
+            var_list_sp->AddVariables (global_variable_list_sp.get());
+    }
+    
+    return var_list_sp;
+}
+
 
 ValueObjectSP
 StackFrame::GetValueForVariableExpressionPath (const char *var_expr_cstr,
@@ -1261,13 +1305,12 @@ StackFrame::DumpUsingSettingsFormat (Stream *strm)
 
     GetSymbolContext(eSymbolContextEverything);
     ExecutionContext exe_ctx (shared_from_this());
-    const char *end = NULL;
     StreamString s;
-    const char *frame_format = NULL;
+    PromptFormatSP frame_format_sp;
     Target *target = exe_ctx.GetTargetPtr();
     if (target)
-        frame_format = target->GetDebugger().GetFrameFormat();
-    if (frame_format && Debugger::FormatPrompt (frame_format, &m_sc, &exe_ctx, NULL, s, &end))
+        frame_format_sp = target->GetDebugger().GetCompiledFrameFormat();
+    if (frame_format_sp && Debugger::FormatPrompt (*frame_format_sp, &m_sc, &exe_ctx, NULL, s))
     {
         strm->Write(s.GetData(), s.GetSize());
     }
@@ -1333,6 +1376,19 @@ StackFrame::UpdatePreviousFrameFromCurrentFrame (StackFrame &curr_frame)
     m_frame_base.Clear();
     m_frame_base_error.Clear();
 }
+
+void
+StackFrame::UpdateFrameIndexes (uint32_t frame_idx, uint32_t concrete_frame_idx)
+{
+    m_frame_index = frame_idx;
+    m_concrete_frame_index = concrete_frame_idx;
+    // Our register context came from the unwind of the previous stop, a
+    // new one will be made if it is needed.
+    m_reg_context_sp.reset();
+    m_flags.Clear(GOT_FRAME_BASE);
+    m_frame_base.Clear();
+    m_frame_base_error.Clear();
+}
     
 
 bool
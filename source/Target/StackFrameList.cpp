@@ -11,8 +11,10 @@
 
 // C Includes
 // C++ Includes
+#include <algorithm>
 // Other libraries and framework includes
 // Project includes
+#include "lldb/Core/Module.h"
 #include "lldb/Core/StreamFile.h"
 #include "lldb/Core/SourceManager.h"
 #include "lldb/Symbol/Block.h"
@@ -44,6 +46,7 @@ StackFrameList::StackFrameList
     m_prev_frames_sp (prev_frames_sp),
     m_mutex (Mutex::eMutexTypeRecursive),
     m_frames (),
+    m_frame_records (),
     m_selected_frame_idx (0),
     m_concrete_frames_fetched (0),
     m_current_inlined_depth (UINT32_MAX),
@@ -230,11 +233,25 @@ StackFrameList::GetFramesUpTo(uint32_t end_idx)
         }
         
         StackFrameSP unwind_frame_sp;
+        TargetSP target_sp (m_thread.CalculateTarget());
+
+        // If two concrete frames in a row are where they were in the
+        // previous stop's frames, the stack above them hasn't changed and
+        // we can take the rest of the frames from there instead of
+        // unwinding them again.
+        StackFrameList *reusable_frames = NULL;
+        if (m_prev_frames_sp && m_prev_frames_sp->GetAllFramesFetched() && !m_prev_frames_sp->m_frame_records.empty())
+            reusable_frames = m_prev_frames_sp.get();
+        uint32_t prev_search_idx = 0;
+        uint32_t prev_match_idx = UINT32_MAX;
+        uint32_t prev_match_concrete_idx = UINT32_MAX;
+
         do
         {
             uint32_t idx = m_concrete_frames_fetched++;
             lldb::addr_t pc;
             lldb::addr_t cfa;
+            Address lookup_addr;
             if (idx == 0)
             {
                 // We might have already created frame zero, only create it
@@ -267,7 +284,14 @@ StackFrameList::GetFramesUpTo(uint32_t end_idx)
                 {
                     unwind_frame_sp = m_frames.front();
                     cfa = unwind_frame_sp->m_id.GetCallFrameAddress();
+                    pc = unwind_frame_sp->m_id.GetPC();
+                }
+                if (m_frame_records.empty())
+                {
+                    FrameRecord record = { cfa, pc, idx, 0 };
+                    m_frame_records.push_back (record);
                 }
+                lookup_addr = unwind_frame_sp->GetFrameCodeAddress();
             }
             else
             {
@@ -278,39 +302,86 @@ StackFrameList::GetFramesUpTo(uint32_t end_idx)
                     SetAllFramesFetched();
                     break;
                 }
-                unwind_frame_sp.reset (new StackFrame (m_thread.shared_from_this(), m_frames.size(), idx, cfa, pc, NULL));
-                m_frames.push_back (unwind_frame_sp);
+                // Don't make the StackFrame until someone asks for it, all
+                // we need here is which frames are inlined into it. Look it
+                // up the same way StackFrame::GetSymbolContext() would, with
+                // the PC backed up into the call instruction.
+                m_frames.push_back (StackFrameSP());
+                FrameRecord record = { cfa, pc, idx, 0 };
+                m_frame_records.push_back (record);
+
+                if (reusable_frames)
+                {
+                    // The previous frames are sorted by CFA, so we only
+                    // ever need to search forward.
+                    const FrameRecordCollection &prev_records = reusable_frames->m_frame_records;
+                    const uint32_t num_prev_records = std::min<size_t> (prev_records.size(), reusable_frames->m_frames.size());
+                    while (prev_search_idx < num_prev_records && prev_records[prev_search_idx].cfa < cfa)
+                        ++prev_search_idx;
+                    uint32_t match_idx = prev_search_idx;
+                    while (match_idx < num_prev_records &&
+                           prev_records[match_idx].cfa == cfa &&
+                           (prev_records[match_idx].inlined_depth != 0 || prev_records[match_idx].pc != pc))
+                        ++match_idx;
+                    if (match_idx < num_prev_records && prev_records[match_idx].cfa == cfa)
+                    {
+                        // One matching frame isn't enough, it could be a
+                        // function that returned and was called again from
+                        // somewhere else.
+                        if (prev_match_idx != UINT32_MAX &&
+                            prev_match_concrete_idx + 1 == idx &&
+                            prev_records[prev_match_idx].concrete_idx + 1 == prev_records[match_idx].concrete_idx)
+                        {
+                            // Unwind one more frame and make sure the
+                            // caller is the same too before we trust the
+                            // rest of the previous frames. The unwinder
+                            // keeps this frame, so it isn't wasted if we
+                            // end up unwinding further.
+                            lldb::addr_t next_cfa = LLDB_INVALID_ADDRESS;
+                            lldb::addr_t next_pc = LLDB_INVALID_ADDRESS;
+                            const bool has_next = unwinder->GetFrameInfoAtIndex (idx + 1, next_cfa, next_pc);
+                            uint32_t next_idx = match_idx + 1;
+                            while (next_idx < num_prev_records && prev_records[next_idx].inlined_depth != 0)
+                                ++next_idx;
+                            const bool prev_has_next = next_idx < num_prev_records;
+                            if (has_next == prev_has_next &&
+                                (!has_next || (prev_records[next_idx].cfa == next_cfa && prev_records[next_idx].pc == next_pc)))
+                            {
+                                SpliceFrames (*reusable_frames, match_idx);
+                                break;
+                            }
+                        }
+                        prev_match_idx = match_idx;
+                        prev_match_concrete_idx = idx;
+                    }
+                    else
+                    {
+                        prev_match_idx = UINT32_MAX;
+                    }
+                }
+
+                if (target_sp && lookup_addr.SetOpcodeLoadAddress (pc, target_sp.get()))
+                {
+                    if (lookup_addr.GetOffset() > 0)
+                        lookup_addr.SetOffset (lookup_addr.GetOffset() - 1);
+                }
             }
-            
-            SymbolContext unwind_sc = unwind_frame_sp->GetSymbolContext (eSymbolContextBlock | eSymbolContextFunction);
-            Block *unwind_block = unwind_sc.block;
-            if (unwind_block)
+
+            // The module caches the inlined call sites by address, so a
+            // thread that keeps stopping in the same functions doesn't
+            // walk the same blocks each time it unwinds.
+            ModuleSP module_sp (lookup_addr.GetModule());
+            std::vector<Address> call_sites;
+            if (module_sp && module_sp->GetInlinedCallSites (lookup_addr, call_sites))
             {
-                Address curr_frame_address (unwind_frame_sp->GetFrameCodeAddress());
-                // Be sure to adjust the frame address to match the address
-                // that was used to lookup the symbol context above. If we are
-                // in the first concrete frame, then we lookup using the current
-                // address, else we decrement the address by one to get the correct
-                // location.
-                if (idx > 0)
-                    curr_frame_address.Slide(-1);
-                    
-                SymbolContext next_frame_sc;
-                Address next_frame_address;
-                
-                while (unwind_sc.GetParentOfInlinedScope(curr_frame_address, next_frame_sc, next_frame_address))
+                const size_t num_call_sites = call_sites.size();
+                for (size_t i = 0; i < num_call_sites; ++i)
                 {
-                        StackFrameSP frame_sp(new StackFrame (m_thread.shared_from_this(),
-                                                              m_frames.size(),
-                                                              idx,
-                                                              unwind_frame_sp->GetRegisterContextSP (),
-                                                              cfa,
-                                                              next_frame_address,
-                                                              &next_frame_sc));  
-                                                    
-                        m_frames.push_back (frame_sp);
-                        unwind_sc = next_frame_sc;
-                        curr_frame_address = next_frame_address;
+                    // MaterializeFrame() walks out to this scope again
+                    // if the frame is ever asked for.
+                    m_frames.push_back (StackFrameSP());
+                    FrameRecord inlined_record = { cfa, call_sites[i].GetLoadAddress (target_sp.get()), idx, (uint32_t)i + 1 };
+                    m_frame_records.push_back (inlined_record);
                 }
             }
         } while (m_frames.size() - 1 < end_idx);
@@ -352,6 +423,30 @@ StackFrameList::GetFramesUpTo(uint32_t end_idx)
                     s.PutCString("NULL");
 #endif
 
+                // SpliceFrames() took this frame from the previous frames
+                if (curr_frame_sp && curr_frame_sp == prev_frame_sp)
+                    continue;
+
+                if (!curr_frame_sp || !prev_frame_sp)
+                {
+                    // One of the frames was never asked for, compare the
+                    // frame records instead of making StackFrames for them.
+                    if (curr_frame_idx >= curr_frames->m_frame_records.size() ||
+                        prev_frame_idx >= prev_frames->m_frame_records.size())
+                        break;
+                    const FrameRecord &curr_record = curr_frames->m_frame_records[curr_frame_idx];
+                    const FrameRecord &prev_record = prev_frames->m_frame_records[prev_frame_idx];
+                    if (curr_record.cfa != prev_record.cfa ||
+                        curr_record.pc != prev_record.pc ||
+                        curr_record.inlined_depth != prev_record.inlined_depth)
+                        break;
+                    // Nobody asked for the previous frame either, so it has
+                    // nothing cached that we need to hold onto.
+                    if (!prev_frame_sp)
+                        continue;
+                    curr_frame_sp = MaterializeFrame (curr_frame_idx);
+                }
+
                 StackFrame *curr_frame = curr_frame_sp.get();
                 StackFrame *prev_frame = prev_frame_sp.get();
                 
@@ -459,8 +554,9 @@ StackFrameList::GetFrameAtIndex (uint32_t idx)
         {
             if (m_show_inlined_frames)
             {
-                // When inline frames are enabled we actually create all the frames in GetFramesUpTo.
-                frame_sp = m_frames[idx];
+                // When inline frames are enabled GetFramesUpTo figures out
+                // all the frames, but only makes records for them.
+                frame_sp = MaterializeFrame (idx);
             }
             else
             {
@@ -492,6 +588,85 @@ StackFrameList::GetFrameAtIndex (uint32_t idx)
     return frame_sp;
 }
 
+// Replace the concrete frame GetFramesUpTo() just added, and everything
+// older than it, with the previous stop's frames starting at "prev_idx".
+void
+StackFrameList::SpliceFrames (StackFrameList &prev_frames, uint32_t prev_idx)
+{
+    const uint32_t splice_idx = m_frames.size() - 1;
+    const uint32_t concrete_idx = m_frame_records[splice_idx].concrete_idx;
+    const uint32_t prev_concrete_idx = prev_frames.m_frame_records[prev_idx].concrete_idx;
+    m_frames.resize (splice_idx);
+    m_frame_records.resize (splice_idx);
+
+    const uint32_t num_prev_frames = std::min<size_t> (prev_frames.m_frames.size(), prev_frames.m_frame_records.size());
+    for (uint32_t i = prev_idx; i < num_prev_frames; ++i)
+    {
+        FrameRecord record (prev_frames.m_frame_records[i]);
+        record.concrete_idx = record.concrete_idx - prev_concrete_idx + concrete_idx;
+        StackFrameSP frame_sp (prev_frames.m_frames[i]);
+        if (frame_sp)
+            frame_sp->UpdateFrameIndexes (m_frames.size(), record.concrete_idx);
+        m_frames.push_back (frame_sp);
+        m_frame_records.push_back (record);
+    }
+    SetAllFramesFetched();
+}
+
+// Make the StackFrame for a frame that GetFramesUpTo() only made a
+// FrameRecord for.
+StackFrameSP
+StackFrameList::MaterializeFrame (uint32_t idx)
+{
+    StackFrameSP frame_sp;
+    if (idx >= m_frames.size())
+        return frame_sp;
+    frame_sp = m_frames[idx];
+    if (frame_sp || idx >= m_frame_records.size())
+        return frame_sp;
+
+    const FrameRecord &record = m_frame_records[idx];
+    if (record.inlined_depth == 0)
+    {
+        frame_sp.reset (new StackFrame (m_thread.shared_from_this(), idx, record.concrete_idx, record.cfa, record.pc, NULL));
+    }
+    else
+    {
+        if (record.inlined_depth > idx)
+            return frame_sp;
+
+        // Walk out from the concrete frame to the same inlined scope, and
+        // call site address, that GetFramesUpTo() found for this frame.
+        StackFrameSP concrete_frame_sp (MaterializeFrame (idx - record.inlined_depth));
+        if (!concrete_frame_sp)
+            return frame_sp;
+
+        SymbolContext sc (concrete_frame_sp->GetSymbolContext (eSymbolContextBlock | eSymbolContextFunction));
+        Address curr_frame_address (concrete_frame_sp->GetFrameCodeAddress());
+        if (record.concrete_idx > 0)
+            curr_frame_address.Slide(-1);
+
+        SymbolContext next_frame_sc;
+        Address next_frame_address;
+        for (uint32_t depth = 0; depth < record.inlined_depth; ++depth)
+        {
+            if (!sc.GetParentOfInlinedScope (curr_frame_address, next_frame_sc, next_frame_address))
+                return frame_sp;
+            sc = next_frame_sc;
+            curr_frame_address = next_frame_address;
+        }
+        frame_sp.reset (new StackFrame (m_thread.shared_from_this(),
+                                        idx,
+                                        record.concrete_idx,
+                                        concrete_frame_sp->GetRegisterContextSP (),
+                                        record.cfa,
+                                        curr_frame_address,
+                                        &sc));
+    }
+    m_frames[idx] = frame_sp;
+    return frame_sp;
+}
+
 StackFrameSP
 StackFrameList::GetFrameWithConcreteFrameIndex (uint32_t unwind_idx)
 {
@@ -611,6 +786,7 @@ StackFrameList::Clear ()
 {
     Mutex::Locker locker (m_mutex);
     m_frames.clear();
+    m_frame_records.clear();
     m_concrete_frames_fetched = 0;
 }
 
@@ -721,6 +897,11 @@ StackFrameList::Merge (std::auto_ptr<StackFrameList>& curr_ap, lldb::StackFrameL
         s.Printf("\nCurrent frame #0 has a stack ID that is less than the previous frame #0, insert current frame zero in front of previous\n");
 #endif
         prev_sp->m_frames.insert (prev_sp->m_frames.begin(), curr_frame_zero_sp);
+        if (!prev_sp->m_frame_records.empty())
+        {
+            FrameRecord record = { curr_stack_id.GetCallFrameAddress(), curr_stack_id.GetPC(), 0, 0 };
+            prev_sp->m_frame_records.insert (prev_sp->m_frame_records.begin(), record);
+        }
     }
     
     curr_ap.release();
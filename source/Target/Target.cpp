@@ -10,15 +10,20 @@
 #include "lldb/Target/Target.h"
 
 // C Includes
+#include <ctype.h>
 // C++ Includes
+#include <algorithm>
 // Other libraries and framework includes
+#include "clang/AST/ASTContext.h"
 // Project includes
 #include "lldb/Breakpoint/BreakpointResolver.h"
 #include "lldb/Breakpoint/BreakpointResolverAddress.h"
 #include "lldb/Breakpoint/BreakpointResolverFileLine.h"
 #include "lldb/Breakpoint/BreakpointResolverFileRegex.h"
 #include "lldb/Breakpoint/BreakpointResolverName.h"
+#include "lldb/Breakpoint/StoppointCallbackContext.h"
 #include "lldb/Breakpoint/Watchpoint.h"
+#include "lldb/Core/DataVisualization.h"
 #include "lldb/Core/Debugger.h"
 #include "lldb/Core/Event.h"
 #include "lldb/Core/Log.h"
@@ -26,6 +31,7 @@
 #include "lldb/Core/ModuleSpec.h"
 #include "lldb/Core/Section.h"
 #include "lldb/Core/StreamString.h"
+#include "lldb/Core/SymbolPreloader.h"
 #include "lldb/Core/Timer.h"
 #include "lldb/Core/ValueObject.h"
 #include "lldb/Expression/ClangASTSource.h"
@@ -37,15 +43,26 @@
 #include "lldb/Interpreter/OptionValues.h"
 #include "lldb/Interpreter/Property.h"
 #include "lldb/lldb-private-log.h"
+#include "lldb/Symbol/Function.h"
 #include "lldb/Symbol/ObjectFile.h"
+#include "lldb/Symbol/Symbol.h"
 #include "lldb/Target/Process.h"
 #include "lldb/Target/StackFrame.h"
 #include "lldb/Target/Thread.h"
+#include "lldb/Target/ThreadPlan.h"
 #include "lldb/Target/ThreadSpec.h"
 
 using namespace lldb;
 using namespace lldb_private;
 
+// EvaluateExpression() starts over with an empty cache when it would hold
+// more compiled expressions than this.
+#define TARGET_EXPRESSION_CACHE_MAX_SIZE    64
+
+// The most names we remember as not being globals in any module before
+// starting over.
+#define TARGET_MISSING_GLOBAL_NAMES_MAX_SIZE    4096
+
 ConstString &
 Target::GetStaticBroadcasterClass ()
 {
@@ -66,17 +83,30 @@ Target::Target(Debugger &debugger, const ArchSpec &target_arch, const lldb::Plat
     m_arch (target_arch),
     m_images (),
     m_section_load_list (),
+    m_trace_buffer (GetTracepointBufferSize()),
     m_breakpoint_list (false),
     m_internal_breakpoint_list (true),
+    m_function_call_return_break_id (LLDB_INVALID_BREAK_ID),
     m_watchpoint_list (),
     m_process_sp (),
     m_valid (true),
     m_search_filter_sp (),
     m_image_search_paths (ImageSearchPathsChanged, this),
-    m_scratch_ast_context_ap (NULL),
-    m_scratch_ast_source_ap (NULL),
+    m_scratch_ast_context_sp (),
+    m_retired_scratch_ast_contexts (),
+    m_scratch_ast_compacted_size (0),
     m_ast_importer_ap (NULL),
     m_persistent_variables (),
+    m_expression_cache (),
+    m_expression_cache_mutex (Mutex::eMutexTypeNormal),
+    m_missing_global_names (),
+    m_missing_global_names_generation (0),
+    m_missing_global_names_mutex (Mutex::eMutexTypeNormal),
+    m_deferred_modules_mutex (Mutex::eMutexTypeNormal),
+    m_deferred_modules (),
+    m_defer_module_breakpoints (false),
+    m_symbols_on_demand_modules (),
+    m_symbols_on_demand_generation (0),
     m_source_manager(*this),
     m_stop_hooks (),
     m_stop_hook_next_id (0),
@@ -102,6 +132,7 @@ Target::~Target()
     LogSP log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_OBJECT));
     if (log)
         log->Printf ("%p Target::~Target()", this);
+    SymbolPreloader::Cancel (this);
     DeleteCurrentProcess ();
 }
 
@@ -134,6 +165,8 @@ Target::DeleteCurrentProcess ()
 {
     if (m_process_sp.get())
     {
+        // The cached expressions' code lives in this process.
+        ClearExpressionCache();
         m_section_load_list.Clear();
         if (m_process_sp->IsAlive())
             m_process_sp->Destroy();
@@ -145,6 +178,13 @@ Target::DeleteCurrentProcess ()
         // clean up needs some help from the process.
         m_breakpoint_list.ClearAllBreakpointSites();
         m_internal_breakpoint_list.ClearAllBreakpointSites();
+        // The next process loads its modules again
+        {
+            Mutex::Locker deferred_locker (m_deferred_modules_mutex);
+            m_deferred_modules.Clear();
+            m_defer_module_breakpoints = false;
+        }
+        m_symbols_on_demand_modules.Clear();
         // Disable watchpoints just on the debugger side.
         Mutex::Locker locker;
         this->GetWatchpointList().GetListMutex(locker);
@@ -173,6 +213,7 @@ Target::Destroy()
 {
     Mutex::Locker locker (m_mutex);
     m_valid = false;
+    SymbolPreloader::Cancel (this);
     DeleteCurrentProcess ();
     m_platform_sp.reset();
     m_arch.Clear();
@@ -185,14 +226,20 @@ Target::Destroy()
     m_last_created_watchpoint.reset();
     m_search_filter_sp.reset();
     m_image_search_paths.Clear(notify);
-    m_scratch_ast_context_ap.reset();
-    m_scratch_ast_source_ap.reset();
+    m_retired_scratch_ast_contexts.clear();
+    m_scratch_ast_context_sp.reset();
+    m_scratch_ast_compacted_size = 0;
     m_ast_importer_ap.reset();
     m_persistent_variables.Clear();
+    // Cached formatters are keyed by clang types that were just freed
+    DataVisualization::ForceUpdate();
     m_stop_hooks.clear();
     m_stop_hook_next_id = 0;
     m_suppress_stop_hooks = false;
     m_suppress_synthetic_value = false;
+
+    // The modules this target was using may now be orphaned.
+    ModuleList::TrimSharedModuleCache (GetDefaultModuleCacheSize());
 }
 
 
@@ -297,6 +344,52 @@ Target::CreateBreakpoint (lldb::addr_t addr, bool internal)
     return bp_sp;
 }
 
+// Only stop threads that are running a function call, the call's
+// run to address plan is on top of their plan stack
+static bool
+FunctionCallReturnBreakpointHit (void *baton,
+                                 StoppointCallbackContext *context,
+                                 lldb::user_id_t break_id,
+                                 lldb::user_id_t break_loc_id)
+{
+    Thread *thread = context->exe_ctx_ref.GetThreadSP().get();
+    if (thread == NULL)
+        return true;
+    ThreadPlan *plan = thread->GetCurrentPlan();
+    return plan && plan->GetKind() == ThreadPlan::eKindRunToAddress;
+}
+
+BreakpointSP
+Target::GetFunctionCallReturnBreakpoint (lldb::addr_t load_addr)
+{
+    BreakpointSP bp_sp;
+    if (m_function_call_return_break_id != LLDB_INVALID_BREAK_ID)
+    {
+        bp_sp = GetBreakpointByID (m_function_call_return_break_id);
+        if (bp_sp)
+        {
+            // The return address moves if the executable was loaded
+            // somewhere else this time
+            Address so_addr;
+            if (!m_section_load_list.ResolveLoadAddress (load_addr, so_addr))
+                so_addr.SetOffset (load_addr);
+            if (bp_sp->FindLocationByAddress (so_addr))
+                return bp_sp;
+            RemoveBreakpointByID (m_function_call_return_break_id);
+            bp_sp.reset();
+        }
+        m_function_call_return_break_id = LLDB_INVALID_BREAK_ID;
+    }
+
+    bp_sp = CreateBreakpoint (load_addr, true);
+    if (bp_sp)
+    {
+        bp_sp->SetCallback (FunctionCallReturnBreakpointHit, NULL, true);
+        m_function_call_return_break_id = bp_sp->GetID();
+    }
+    return bp_sp;
+}
+
 BreakpointSP
 Target::CreateBreakpoint (Address &addr, bool internal)
 {
@@ -949,9 +1042,12 @@ void
 Target::SetExecutableModule (ModuleSP& executable_sp, bool get_dependent_files)
 {
     m_images.Clear();
-    m_scratch_ast_context_ap.reset();
-    m_scratch_ast_source_ap.reset();
+    m_retired_scratch_ast_contexts.clear();
+    m_scratch_ast_context_sp.reset();
+    m_scratch_ast_compacted_size = 0;
     m_ast_importer_ap.reset();
+    // Cached formatters are keyed by clang types that were just freed
+    DataVisualization::ForceUpdate();
     
     if (executable_sp.get())
     {
@@ -1013,9 +1109,11 @@ Target::SetArchitecture (const ArchSpec &arch_spec)
         m_arch = arch_spec;
         ModuleSP executable_sp = GetExecutableModule ();
         m_images.Clear();
-        m_scratch_ast_context_ap.reset();
-        m_scratch_ast_source_ap.reset();
+        m_retired_scratch_ast_contexts.clear();
+        m_scratch_ast_context_sp.reset();
+        m_scratch_ast_compacted_size = 0;
         m_ast_importer_ap.reset();
+        DataVisualization::ForceUpdate();
         // Need to do something about unsetting breakpoints.
         
         if (executable_sp)
@@ -1051,23 +1149,182 @@ Target::ModuleUpdated (ModuleSP &old_module_sp, ModuleSP &new_module_sp)
 {
     // A module is replacing an already added module
     m_breakpoint_list.UpdateBreakpointsWhenModuleIsReplaced(old_module_sp, new_module_sp);
+    ClearExpressionCache();
+    ClearMissingGlobalNames();
+    // The old module's clang types may be freed along with it
+    DataVisualization::ForceUpdate();
+}
+
+// Modules come from the global shared module list, so check whether
+// another target in any debugger already uses \a module.
+static bool
+ModuleIsUsedByOtherTarget (Module *module, Target *target)
+{
+    const uint32_t num_debuggers = Debugger::GetNumDebuggers();
+    for (uint32_t debugger_idx = 0; debugger_idx < num_debuggers; ++debugger_idx)
+    {
+        DebuggerSP debugger_sp (Debugger::GetDebuggerAtIndex (debugger_idx));
+        if (!debugger_sp)
+            continue;
+        TargetList &target_list = debugger_sp->GetTargetList();
+        const uint32_t num_targets = target_list.GetNumTargets();
+        for (uint32_t target_idx = 0; target_idx < num_targets; ++target_idx)
+        {
+            TargetSP other_target_sp (target_list.GetTargetAtIndex (target_idx));
+            if (other_target_sp && other_target_sp.get() != target && other_target_sp->GetImages().FindModule (module))
+                return true;
+        }
+    }
+    return false;
 }
 
 void
 Target::ModulesDidLoad (ModuleList &module_list)
 {
-    m_breakpoint_list.UpdateBreakpoints (module_list, true);
+    const bool symbols_on_demand = GetSymbolsOnDemand();
+    Module *exe_module = GetExecutableModulePointer();
+    const size_t num_loaded_modules = module_list.GetSize();
+    for (size_t i=0; i<num_loaded_modules; ++i)
+    {
+        ModuleSP module_sp (module_list.GetModuleAtIndex(i));
+        if (!module_sp || module_sp.get() == exe_module)
+            continue;
+        if (symbols_on_demand)
+        {
+            // Only hold back the debug information of a module that no
+            // other target uses, or that another target already holds
+            // back, since the state lives in the shared module
+            if (!module_sp->GetSymbolsOnDemand() && !ModuleIsUsedByOtherTarget (module_sp.get(), this))
+                module_sp->SetSymbolsOnDemand();
+            if (module_sp->GetSymbolsOnDemand())
+                m_symbols_on_demand_modules.AppendIfNeeded (module_sp);
+        }
+        else
+        {
+            // A target that holds back debug information may have loaded
+            // this module first, but this target wants all of it
+            module_sp->LoadSymbolsOnDemand();
+        }
+    }
+
+    bool preload_symbols = GetPreloadSymbols();
+    Mutex::Locker deferred_locker (m_deferred_modules_mutex);
+    if (m_defer_module_breakpoints)
+    {
+        // Only the executable's breakpoints are resolved now, the rest
+        // wait for ResolveDeferredModules()
+        ModuleList resolve_now_list;
+        Module *exe_module = GetExecutableModulePointer();
+        const size_t num_modules = module_list.GetSize();
+        for (size_t i=0; i<num_modules; ++i)
+        {
+            ModuleSP module_sp (module_list.GetModuleAtIndex(i));
+            if (!module_sp)
+                continue;
+            if (module_sp.get() == exe_module)
+                resolve_now_list.Append (module_sp);
+            else
+                m_deferred_modules.AppendIfNeeded (module_sp);
+        }
+        deferred_locker.Unlock();
+        if (resolve_now_list.GetSize() > 0)
+            m_breakpoint_list.UpdateBreakpoints (resolve_now_list, true);
+        preload_symbols = true;
+    }
+    else
+    {
+        deferred_locker.Unlock();
+        m_breakpoint_list.UpdateBreakpoints (module_list, true);
+    }
+    ClearExpressionCache();
+    ClearMissingGlobalNames();
+    if (preload_symbols)
+        SymbolPreloader::Enqueue (module_list, this);
     // TODO: make event data that packages up the module_list
     BroadcastEvent (eBroadcastBitModulesLoaded, NULL);
 }
 
+void
+Target::DeferModuleBreakpoints ()
+{
+    Mutex::Locker locker (m_deferred_modules_mutex);
+    m_defer_module_breakpoints = true;
+}
+
+void
+Target::ResolveDeferredModules ()
+{
+    ModuleList deferred_modules;
+    {
+        Mutex::Locker locker (m_deferred_modules_mutex);
+        if (!m_defer_module_breakpoints)
+            return;
+        m_defer_module_breakpoints = false;
+        deferred_modules = m_deferred_modules;
+        m_deferred_modules.Clear();
+    }
+
+    LogSP log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_BREAKPOINTS));
+    if (log)
+        log->Printf ("Target::ResolveDeferredModules () resolving breakpoints in %zu modules", deferred_modules.GetSize());
+    if (deferred_modules.GetSize() > 0)
+        m_breakpoint_list.UpdateBreakpoints (deferred_modules, true);
+}
+
+void
+Target::PrioritizeModules (ModuleList &module_list)
+{
+    SymbolPreloader::Enqueue (module_list, this, true);
+}
+
+void
+Target::ResolveModulesLoadedOnDemand ()
+{
+    const uint32_t generation = Module::GetSymbolsLoadedOnDemandGeneration();
+    if (generation == m_symbols_on_demand_generation || m_symbols_on_demand_modules.GetSize() == 0)
+        return;
+    m_symbols_on_demand_generation = generation;
+
+    ModuleList loaded_modules;
+    const size_t num_modules = m_symbols_on_demand_modules.GetSize();
+    for (size_t i=0; i<num_modules; ++i)
+    {
+        ModuleSP module_sp (m_symbols_on_demand_modules.GetModuleAtIndex(i));
+        if (module_sp && !module_sp->GetSymbolsOnDemand())
+            loaded_modules.Append (module_sp);
+    }
+    if (loaded_modules.GetSize() == 0)
+        return;
+    m_symbols_on_demand_modules.Remove (loaded_modules);
+
+    // Breakpoints that already have locations in these modules found
+    // them in the symbol table and keep them
+    m_breakpoint_list.UpdateBreakpoints (loaded_modules, true);
+    ClearExpressionCache();
+    ClearMissingGlobalNames();
+}
+
 void
 Target::ModulesDidUnload (ModuleList &module_list)
 {
+    {
+        Mutex::Locker locker (m_deferred_modules_mutex);
+        if (m_deferred_modules.GetSize() > 0)
+            m_deferred_modules.Remove (module_list);
+    }
+    if (m_symbols_on_demand_modules.GetSize() > 0)
+        m_symbols_on_demand_modules.Remove (module_list);
     m_breakpoint_list.UpdateBreakpoints (module_list, false);
 
     // Remove the images from the target image list
     m_images.Remove(module_list);
+    ClearExpressionCache();
+    ClearMissingGlobalNames();
+    // The formatters cached for the clang types of these modules must not
+    // be found again for types that end up at the same addresses
+    DataVisualization::ForceUpdate();
+    if (m_process_sp)
+        m_process_sp->ModulesDidUnload (module_list);
 
     // TODO: make event data that packages up the module_list
     BroadcastEvent (eBroadcastBitModulesUnloaded, NULL);
@@ -1192,7 +1449,8 @@ Target::ReadMemory (const Address& addr,
         resolved_addr = addr;
     
 
-    if (prefer_file_cache)
+    const bool read_file_cache_first = prefer_file_cache && FileCacheMatchesMemory (resolved_addr, dst_len);
+    if (read_file_cache_first)
     {
         bytes_read = ReadMemoryFromFileCache (resolved_addr, dst, dst_len, error);
         if (bytes_read > 0)
@@ -1244,7 +1502,7 @@ Target::ReadMemory (const Address& addr,
         }
     }
     
-    if (!prefer_file_cache && resolved_addr.IsSectionOffset())
+    if (!read_file_cache_first && resolved_addr.IsSectionOffset())
     {
         // If we didn't already try and read from the object file cache, then
         // try it after failing to read from the process.
@@ -1253,6 +1511,54 @@ Target::ReadMemory (const Address& addr,
     return 0;
 }
 
+bool
+Target::FileCacheMatchesMemory (const Address& addr, size_t dst_len)
+{
+    SectionSP section_sp (addr.GetSection());
+    if (!section_sp)
+        return false;
+
+    switch (section_sp->GetType())
+    {
+    case eSectionTypeCode:
+    case eSectionTypeDataCString:
+    case eSectionTypeDebug:
+    case eSectionTypeDWARFDebugAbbrev:
+    case eSectionTypeDWARFDebugAranges:
+    case eSectionTypeDWARFDebugFrame:
+    case eSectionTypeDWARFDebugInfo:
+    case eSectionTypeDWARFDebugLine:
+    case eSectionTypeDWARFDebugLoc:
+    case eSectionTypeDWARFDebugMacInfo:
+    case eSectionTypeDWARFDebugPubNames:
+    case eSectionTypeDWARFDebugPubTypes:
+    case eSectionTypeDWARFDebugRanges:
+    case eSectionTypeDWARFDebugStr:
+    case eSectionTypeDWARFAppleNames:
+    case eSectionTypeDWARFAppleTypes:
+    case eSectionTypeDWARFAppleNamespaces:
+    case eSectionTypeDWARFAppleObjC:
+    case eSectionTypeDWARFDebugNames:
+    case eSectionTypeEHFrame:
+        break;
+
+    default:
+        // Data sections can be written to by the program itself, and
+        // the dynamic loader fixes up pointers, so only the process
+        // knows what is in them.
+        return false;
+    }
+
+    if (ProcessIsValid())
+    {
+        const addr_t load_addr = addr.GetLoadAddress (this);
+        if (load_addr != LLDB_INVALID_ADDRESS &&
+            m_process_sp->SectionMemoryWasWritten (load_addr, dst_len))
+            return false;
+    }
+    return true;
+}
+
 size_t
 Target::ReadScalarIntegerFromMemory (const Address& addr, 
                                      bool prefer_file_cache,
@@ -1347,8 +1653,121 @@ Target::ReadPointerFromMemory (const Address& addr,
     return false;
 }
 
+size_t
+Target::ResolveSymbolContextsForLoadAddresses (const addr_t *load_addrs,
+                                               size_t num_addrs,
+                                               uint32_t resolve_scope,
+                                               SymbolContextList &sc_list)
+{
+    if (load_addrs == NULL || num_addrs == 0)
+        return 0;
+
+    // Sort the addresses, keeping their original positions, so we visit
+    // each module and function once no matter how the addresses were
+    // ordered.
+    typedef std::pair<addr_t, size_t> AddrAndIndex;
+    std::vector<AddrAndIndex> sorted_addrs (num_addrs);
+    for (size_t i=0; i<num_addrs; ++i)
+        sorted_addrs[i] = AddrAndIndex (load_addrs[i], i);
+    std::sort (sorted_addrs.begin(), sorted_addrs.end());
+
+    // Blocks and line entries can change from one address to the next,
+    // everything else is the same for all addresses in a function.
+    const bool share_within_range = (resolve_scope & (eSymbolContextBlock | eSymbolContextLineEntry)) == 0;
+
+    std::vector<SymbolContext> results (num_addrs);
+    size_t num_resolved = 0;
+    SymbolContext prev_sc;
+    addr_t prev_addr = LLDB_INVALID_ADDRESS;
+    addr_t shared_range_start = LLDB_INVALID_ADDRESS;
+    addr_t shared_range_end = LLDB_INVALID_ADDRESS;
+    bool prev_resolved = false;
+
+    for (size_t i=0; i<num_addrs; ++i)
+    {
+        const addr_t load_addr = sorted_addrs[i].first;
+        SymbolContext &sc = results[sorted_addrs[i].second];
+
+        if (load_addr == prev_addr ||
+            (share_within_range && shared_range_start <= load_addr && load_addr < shared_range_end))
+        {
+            sc = prev_sc;
+        }
+        else
+        {
+            prev_addr = load_addr;
+            shared_range_start = LLDB_INVALID_ADDRESS;
+            shared_range_end = LLDB_INVALID_ADDRESS;
+            prev_resolved = false;
+
+            Address so_addr;
+            if (m_section_load_list.ResolveLoadAddress (load_addr, so_addr))
+            {
+                ModuleSP module_sp (so_addr.GetModule());
+                if (module_sp)
+                {
+                    module_sp->ResolveSymbolContextForAddress (so_addr, resolve_scope, sc);
+                    prev_resolved = true;
+
+                    // Find the range of addresses that share this function
+                    // and symbol.
+                    addr_t range_start = 0;
+                    addr_t range_end = LLDB_INVALID_ADDRESS;
+                    if (sc.function)
+                    {
+                        const AddressRange &func_range = sc.function->GetAddressRange();
+                        const addr_t func_load_addr = func_range.GetBaseAddress().GetLoadAddress (this);
+                        if (func_load_addr != LLDB_INVALID_ADDRESS)
+                        {
+                            range_start = std::max<addr_t> (range_start, func_load_addr);
+                            range_end = std::min<addr_t> (range_end, func_load_addr + func_range.GetByteSize());
+                        }
+                        else
+                            range_end = 0;
+                    }
+                    if (sc.symbol && sc.symbol->ValueIsAddress())
+                    {
+                        const addr_t symbol_load_addr = sc.symbol->GetAddress().GetLoadAddress (this);
+                        const addr_t symbol_byte_size = sc.symbol->GetByteSize();
+                        if (symbol_load_addr != LLDB_INVALID_ADDRESS && symbol_byte_size > 0)
+                        {
+                            range_start = std::max<addr_t> (range_start, symbol_load_addr);
+                            range_end = std::min<addr_t> (range_end, symbol_load_addr + symbol_byte_size);
+                        }
+                        else
+                            range_end = 0;
+                    }
+                    if ((sc.function || sc.symbol) && range_start < range_end && range_start <= load_addr && load_addr < range_end)
+                    {
+                        shared_range_start = range_start;
+                        shared_range_end = range_end;
+                    }
+                }
+            }
+            prev_sc = sc;
+        }
+
+        if (prev_resolved)
+            ++num_resolved;
+    }
+
+    for (size_t i=0; i<num_addrs; ++i)
+        sc_list.Append (results[i]);
+    return num_resolved;
+}
+
+TraceBuffer &
+Target::GetTraceBuffer ()
+{
+    // Pick up changes to the setting, which discard the recorded hits.
+    const size_t capacity = GetTracepointBufferSize();
+    if (capacity != m_trace_buffer.GetCapacity())
+        m_trace_buffer.SetCapacity (capacity);
+    return m_trace_buffer;
+}
+
 ModuleSP
-Target::GetSharedModule (const ModuleSpec &module_spec, Error *error_ptr)
+Target::GetSharedModule (const ModuleSpec &module_spec, Error *error_ptr, bool notify)
 {
     ModuleSP module_sp;
 
@@ -1456,8 +1875,11 @@ Target::GetSharedModule (const ModuleSpec &module_spec, Error *error_ptr)
                 old_module_sp.reset();
                 ModuleList::RemoveSharedModuleIfOrphaned (old_module_ptr);
             }
-            else
+            else if (notify)
                 ModuleAdded(module_sp);
+
+            if (did_create_module)
+                ModuleList::TrimSharedModuleCache (GetDefaultModuleCacheSize());
         }
     }
     if (error_ptr)
@@ -1519,19 +1941,136 @@ Target::ImageSearchPathsChanged
     }
 }
 
+namespace {
+
+    // Frees a scratch AST context together with the AST source that
+    // completes its types, once nothing holds on to the context
+    struct ScratchClangASTContextDeleter
+    {
+        ScratchClangASTContextDeleter (ClangASTSource *ast_source) :
+            m_ast_source (ast_source)
+        {
+        }
+
+        void
+        operator() (ClangASTContext *ast_context)
+        {
+            delete ast_context;
+            delete m_ast_source;
+        }
+
+        ClangASTSource *m_ast_source;
+    };
+
+}
+
+static ClangASTContextSP
+CreateScratchClangASTContext (const TargetSP &target_sp, const ArchSpec &arch)
+{
+    ClangASTContext *ast_context = new ClangASTContext(arch.GetTriple().str().c_str());
+    ClangASTSource *ast_source = new ClangASTSource(target_sp);
+    ast_source->InstallASTContext(ast_context->getASTContext());
+    llvm::OwningPtr<clang::ExternalASTSource> proxy_ast_source(ast_source->CreateProxy());
+    ast_context->SetExternalSource(proxy_ast_source);
+    return ClangASTContextSP (ast_context, ScratchClangASTContextDeleter (ast_source));
+}
+
 ClangASTContext *
 Target::GetScratchClangASTContext(bool create_on_demand)
 {
     // Now see if we know the target triple, and if so, create our scratch AST context:
-    if (m_scratch_ast_context_ap.get() == NULL && m_arch.IsValid() && create_on_demand)
+    if (m_scratch_ast_context_sp.get() == NULL && m_arch.IsValid() && create_on_demand)
+        m_scratch_ast_context_sp = CreateScratchClangASTContext (shared_from_this(), m_arch);
+    return m_scratch_ast_context_sp.get();
+}
+
+ClangASTContextSP
+Target::GetScratchClangASTContextSP (clang::ASTContext *clang_ast)
+{
+    if (clang_ast == NULL)
+        return ClangASTContextSP();
+    if (m_scratch_ast_context_sp && m_scratch_ast_context_sp->getASTContext() == clang_ast)
+        return m_scratch_ast_context_sp;
+    for (size_t i = 0; i < m_retired_scratch_ast_contexts.size(); ++i)
     {
-        m_scratch_ast_context_ap.reset (new ClangASTContext(m_arch.GetTriple().str().c_str()));
-        m_scratch_ast_source_ap.reset (new ClangASTSource(shared_from_this()));
-        m_scratch_ast_source_ap->InstallASTContext(m_scratch_ast_context_ap->getASTContext());
-        llvm::OwningPtr<clang::ExternalASTSource> proxy_ast_source(m_scratch_ast_source_ap->CreateProxy());
-        m_scratch_ast_context_ap->SetExternalSource(proxy_ast_source);
+        if (m_retired_scratch_ast_contexts[i]->getASTContext() == clang_ast)
+            return m_retired_scratch_ast_contexts[i];
     }
-    return m_scratch_ast_context_ap.get();
+    return ClangASTContextSP();
+}
+
+void
+Target::CompactScratchClangASTContext ()
+{
+    const uint64_t budget = GetScratchASTMemoryBudget();
+    if (budget == 0 || m_scratch_ast_context_sp.get() == NULL)
+        return;
+
+    clang::ASTContext *old_ast = m_scratch_ast_context_sp->getASTContext();
+    const uint64_t memory_size = old_ast->getASTAllocatedMemory() +
+                                 old_ast->getSideTableAllocatedMemory() +
+                                 m_persistent_variables.GetValueByteSize();
+    if (memory_size <= budget)
+        return;
+
+    // What is left after compacting may already be over the budget, and
+    // compacting again won't free any more until the context has grown
+    if (memory_size < m_scratch_ast_compacted_size + budget / 2)
+        return;
+
+    LogSP log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_EXPRESSIONS));
+
+    ClangASTContextSP new_ast_context_sp (CreateScratchClangASTContext (shared_from_this(), m_arch));
+    clang::ASTContext *new_ast = new_ast_context_sp->getASTContext();
+
+    ClangASTImporter *ast_importer = GetClangASTImporter();
+    if (!m_persistent_variables.MigrateToASTContext (*ast_importer, this, new_ast, old_ast))
+    {
+        if (log)
+            log->Printf ("Target::%s couldn't move the persistent variables to a new scratch AST context", __FUNCTION__);
+        ast_importer->ForgetDestination (new_ast);
+        // Don't try again until the context has grown some more
+        m_scratch_ast_compacted_size = memory_size;
+        return;
+    }
+
+    if (log)
+        log->Printf ("Target::%s replaced a scratch AST context using %llu bytes", __FUNCTION__, memory_size);
+
+    // Expressions that were parsed before refer to the old context
+    ClearExpressionCache ();
+
+    // Free the contexts retired before that no value holds on to any
+    // more. The one retired now is kept until next time, for anything
+    // that uses its types without holding on to it.
+    for (size_t i = 0; i < m_retired_scratch_ast_contexts.size(); )
+    {
+        if (!m_retired_scratch_ast_contexts[i].unique())
+        {
+            ++i;
+            continue;
+        }
+        clang::ASTContext *retired_ast = m_retired_scratch_ast_contexts[i]->getASTContext();
+        ast_importer->ForgetSource (old_ast, retired_ast);
+        ast_importer->ForgetSource (new_ast, retired_ast);
+        for (size_t j = 0; j < m_retired_scratch_ast_contexts.size(); ++j)
+        {
+            if (j != i)
+                ast_importer->ForgetSource (m_retired_scratch_ast_contexts[j]->getASTContext(), retired_ast);
+        }
+        m_retired_scratch_ast_contexts.erase (m_retired_scratch_ast_contexts.begin() + i);
+        ast_importer->ForgetDestination (retired_ast);
+    }
+
+    // Cached formatters are keyed by clang types, which may have been
+    // freed, and the persistent variables have new types
+    DataVisualization::ForceUpdate();
+
+    m_retired_scratch_ast_contexts.push_back (m_scratch_ast_context_sp);
+    m_scratch_ast_context_sp = new_ast_context_sp;
+    m_scratch_ast_compacted_size = new_ast->getASTAllocatedMemory() +
+                                   new_ast->getSideTableAllocatedMemory() +
+                                   m_persistent_variables.GetValueByteSize();
 }
 
 ClangASTImporter *
@@ -1569,6 +2108,42 @@ Target::GetDefaultExecutableSearchPaths ()
     return FileSpecList();
 }
 
+FileSpec
+Target::GetDefaultIndexCachePath ()
+{
+    TargetPropertiesSP properties_sp(Target::GetGlobalProperties());
+    if (properties_sp)
+        return properties_sp->GetIndexCachePath();
+    return FileSpec();
+}
+
+uint64_t
+Target::GetDefaultModuleCacheSize ()
+{
+    TargetPropertiesSP properties_sp(Target::GetGlobalProperties());
+    if (properties_sp)
+        return properties_sp->GetModuleCacheSize();
+    return 0;
+}
+
+bool
+Target::GetDefaultParallelModuleSearch ()
+{
+    TargetPropertiesSP properties_sp(Target::GetGlobalProperties());
+    if (properties_sp)
+        return properties_sp->GetParallelModuleSearch();
+    return false;
+}
+
+bool
+Target::GetDefaultShareTypesAcrossModules ()
+{
+    TargetPropertiesSP properties_sp(Target::GetGlobalProperties());
+    if (properties_sp)
+        return properties_sp->GetShareTypesAcrossModules();
+    return false;
+}
+
 ArchSpec
 Target::GetDefaultArchitecture ()
 {
@@ -1601,6 +2176,70 @@ Target::GetTargetFromContexts (const ExecutionContext *exe_ctx_ptr, const Symbol
     return target;
 }
 
+//----------------------------------------------------------------------
+// Check whether an expression is nothing but a variable path that the
+// frame's variable path engine means the same thing by as the compiler:
+// an optional '*', a variable name, and then any number of ".member",
+// "->member" and "[index]" with a constant index.  Leading and trailing
+// spaces are dropped from the path that is handed back.
+//----------------------------------------------------------------------
+static bool
+IsVariableExpressionPath (const char *expr_cstr, std::string &var_path)
+{
+    while (isspace (*expr_cstr))
+        ++expr_cstr;
+    const char *end = expr_cstr + ::strlen (expr_cstr);
+    while (end > expr_cstr && isspace (end[-1]))
+        --end;
+    
+    const char *p = expr_cstr;
+    if (p < end && *p == '*')
+        ++p;
+
+    bool need_identifier = true;
+    while (p < end)
+    {
+        if (need_identifier)
+        {
+            if (!(isalpha (*p) || *p == '_'))
+                return false;
+            while (p < end && (isalnum (*p) || *p == '_'))
+                ++p;
+            need_identifier = false;
+        }
+        else if (*p == '.')
+        {
+            ++p;
+            need_identifier = true;
+        }
+        else if (*p == '-' && p + 1 < end && p[1] == '>')
+        {
+            p += 2;
+            need_identifier = true;
+        }
+        else if (*p == '[')
+        {
+            // The path engine reads "[1-3]" as a range of children, only
+            // take a single constant index
+            ++p;
+            if (p == end || !isdigit (*p))
+                return false;
+            while (p < end && isdigit (*p))
+                ++p;
+            if (p == end || *p != ']')
+                return false;
+            ++p;
+        }
+        else
+            return false;
+    }
+    
+    if (need_identifier)
+        return false;
+    var_path.assign (expr_cstr, end - expr_cstr);
+    return true;
+}
+
 ExecutionResults
 Target::EvaluateExpression
 (
@@ -1622,6 +2261,10 @@ Target::EvaluateExpression
     if (expr_cstr == NULL || expr_cstr[0] == '\0')
         return execution_results;
 
+    // Make room before the expression adds to the scratch AST context
+    // rather than after, so the result doesn't come from a retired one.
+    CompactScratchClangASTContext ();
+
     // We shouldn't run stop hooks in expressions.
     // Be sure to reset this if you return anywhere within this function.
     bool old_suppress_value = m_suppress_stop_hooks;
@@ -1629,8 +2272,6 @@ Target::EvaluateExpression
 
     ExecutionContext exe_ctx;
 
-    const size_t expr_cstr_len = ::strlen (expr_cstr);
-
     if (frame)
     {
         frame->CalculateExecutionContext(exe_ctx);
@@ -1640,11 +2281,12 @@ Target::EvaluateExpression
                                            StackFrame::eExpressionPathOptionsNoSyntheticChildren;
         lldb::VariableSP var_sp;
         
-        // Make sure we don't have any things that we know a variable expression
-        // won't be able to deal with before calling into it
-        if (::strcspn (expr_cstr, "()+*&|!~<=/^%,?") == expr_cstr_len)
+        // Plain variable paths, which is what most watch expressions are,
+        // can be answered without going through the expression parser.
+        std::string var_path;
+        if (IsVariableExpressionPath (expr_cstr, var_path))
         {
-            result_valobj_sp = frame->GetValueForVariableExpressionPath (expr_cstr, 
+            result_valobj_sp = frame->GetValueForVariableExpressionPath (var_path.c_str(), 
                                                                          use_dynamic, 
                                                                          expr_path_options, 
                                                                          var_sp, 
@@ -1733,16 +2375,77 @@ Target::EvaluateExpression
         else
         {
             const char *prefix = GetExpressionPrefixContentsAsCString();
-                    
-            execution_results = ClangUserExpression::Evaluate (exe_ctx, 
-                                                               execution_policy,
-                                                               lldb::eLanguageTypeUnknown,
-                                                               coerce_to_id ? ClangUserExpression::eResultTypeId : ClangUserExpression::eResultTypeAny,
-                                                               unwind_on_error,
-                                                               expr_cstr, 
-                                                               prefix, 
-                                                               result_valobj_sp,
-                                                               single_thread_timeout_usec);
+            
+            // Expressions that mention a persistent variable may also be
+            // declaring one, so leave those to be parsed every time.
+            if (::strchr (expr_cstr, '$') == NULL)
+            {
+                ExpressionCacheKey key;
+                key.expr_text = expr_cstr;
+                if (prefix)
+                    key.prefix_text = prefix;
+                key.language = lldb::eLanguageTypeUnknown;
+                key.coerce_to_id = coerce_to_id;
+                key.decl_context = NULL;
+                if (frame)
+                {
+                    // The compiled code refers to the variables that were in
+                    // scope where it was parsed.
+                    const SymbolContext &sc (frame->GetSymbolContext (eSymbolContextFunction | eSymbolContextBlock | eSymbolContextSymbol));
+                    if (sc.block)
+                        key.decl_context = sc.block;
+                    else if (sc.function)
+                        key.decl_context = sc.function;
+                    else
+                        key.decl_context = sc.symbol;
+                }
+                
+                // Take the expression out of the cache while it runs, so
+                // another thread evaluating the same text parses its own.
+                ClangUserExpression::ClangUserExpressionSP user_expression_sp;
+                {
+                    Mutex::Locker locker (m_expression_cache_mutex);
+                    ExpressionCache::iterator pos = m_expression_cache.find (key);
+                    if (pos != m_expression_cache.end())
+                    {
+                        user_expression_sp = pos->second;
+                        m_expression_cache.erase (pos);
+                    }
+                }
+                
+                Error error;
+                execution_results = ClangUserExpression::EvaluateWithCache (exe_ctx,
+                                                                            execution_policy,
+                                                                            lldb::eLanguageTypeUnknown,
+                                                                            coerce_to_id ? ClangUserExpression::eResultTypeId : ClangUserExpression::eResultTypeAny,
+                                                                            unwind_on_error,
+                                                                            expr_cstr,
+                                                                            prefix,
+                                                                            user_expression_sp,
+                                                                            result_valobj_sp,
+                                                                            error,
+                                                                            single_thread_timeout_usec);
+                
+                if (user_expression_sp)
+                {
+                    Mutex::Locker locker (m_expression_cache_mutex);
+                    if (m_expression_cache.size() >= TARGET_EXPRESSION_CACHE_MAX_SIZE)
+                        m_expression_cache.clear();
+                    m_expression_cache[key] = user_expression_sp;
+                }
+            }
+            else
+            {
+                execution_results = ClangUserExpression::Evaluate (exe_ctx, 
+                                                                   execution_policy,
+                                                                   lldb::eLanguageTypeUnknown,
+                                                                   coerce_to_id ? ClangUserExpression::eResultTypeId : ClangUserExpression::eResultTypeAny,
+                                                                   unwind_on_error,
+                                                                   expr_cstr, 
+                                                                   prefix, 
+                                                                   result_valobj_sp,
+                                                                   single_thread_timeout_usec);
+            }
         }
     }
     
@@ -1751,6 +2454,64 @@ Target::EvaluateExpression
     return execution_results;
 }
 
+void
+Target::ClearExpressionCache ()
+{
+    Mutex::Locker locker (m_expression_cache_mutex);
+    m_expression_cache.clear();
+}
+
+bool
+Target::IsMissingGlobalName (const ConstString &name)
+{
+    Mutex::Locker locker (m_missing_global_names_mutex);
+    return m_missing_global_names.find (name.GetCString()) != m_missing_global_names.end();
+}
+
+uint32_t
+Target::GetMissingGlobalNamesGeneration ()
+{
+    Mutex::Locker locker (m_missing_global_names_mutex);
+    return m_missing_global_names_generation;
+}
+
+void
+Target::AddMissingGlobalName (const ConstString &name, uint32_t generation)
+{
+    if (!name)
+        return;
+    Mutex::Locker locker (m_missing_global_names_mutex);
+    // Modules were loaded while the name was being looked for, they may
+    // have it
+    if (generation != m_missing_global_names_generation)
+        return;
+    if (m_missing_global_names.size() >= TARGET_MISSING_GLOBAL_NAMES_MAX_SIZE)
+        m_missing_global_names.clear();
+    m_missing_global_names.insert (name.GetCString());
+}
+
+void
+Target::ClearMissingGlobalNames ()
+{
+    Mutex::Locker locker (m_missing_global_names_mutex);
+    m_missing_global_names.clear();
+    ++m_missing_global_names_generation;
+}
+
+bool
+Target::ExpressionCacheKey::operator< (const ExpressionCacheKey &rhs) const
+{
+    if (decl_context != rhs.decl_context)
+        return decl_context < rhs.decl_context;
+    if (language != rhs.language)
+        return language < rhs.language;
+    if (coerce_to_id != rhs.coerce_to_id)
+        return coerce_to_id < rhs.coerce_to_id;
+    if (expr_text != rhs.expr_text)
+        return expr_text < rhs.expr_text;
+    return prefix_text < rhs.prefix_text;
+}
+
 lldb::addr_t
 Target::GetCallableLoadAddress (lldb::addr_t load_addr, AddressClass addr_class) const
 {
@@ -2160,6 +2921,18 @@ g_properties[] =
         "Always checking for inlined breakpoint locations can be expensive (memory and time), so we try to minimize the "
         "times we look for inlined locations. This setting allows you to control exactly which strategy is used when settings "
         "file and line breakpoints." },
+    { "index-cache-path"                   , OptionValue::eTypeFileSpec  , true , 0                         , NULL, NULL, "A directory in which to save the symbol name indexes, record layouts and other data that are built for modules with a UUID, so later sessions can load them instead of building them again. Nothing is saved if this is empty." },
+    { "module-cache-size"                  , OptionValue::eTypeUInt64    , true , 1024 * 1024 * 1024        , NULL, NULL, "The approximate number of bytes of parsed symbol and debug information to keep for modules that no target is using. The least recently used modules have their parsed data freed first, and it is parsed again if they are used again. Zero means no limit." },
+    { "parallel-module-search"             , OptionValue::eTypeBoolean   , true , true                      , NULL, NULL, "Search modules on multiple threads when looking up functions, global variables and types in all modules." },
+    { "share-types-across-modules"         , OptionValue::eTypeBoolean   , true , false                     , NULL, NULL, "When a class, struct or union that another module already parsed is defined the same way in a module, import the existing definition instead of parsing it from the module's debug information again." },
+    { "prewarm-frame-variable-types"       , OptionValue::eTypeBoolean   , false, false                     , NULL, NULL, "After the process stops, complete the types of the variables in the selected frame on a background thread so that displaying them later is faster." },
+    { "preload-symbols"                    , OptionValue::eTypeBoolean   , false, false                     , NULL, NULL, "Build the symbol table and debug information indexes of modules on low priority background threads as soon as they are added to the target, so later lookups by name don't have to wait for them." },
+    { "parallel-backtrace"                 , OptionValue::eTypeBoolean   , false, false                     , NULL, NULL, "When showing the backtraces of many threads, unwind the threads on multiple worker threads before showing them in order." },
+    { "use-fast-stepping"                  , OptionValue::eTypeBoolean   , false, true                      , NULL, NULL, "Use a breakpoint on the next branch instruction to run through the straight-line parts of a stepping range, instead of single-stepping every instruction in it." },
+    { "tracepoint-buffer-size"             , OptionValue::eTypeUInt64    , false, 16384                     , NULL, NULL, "The number of tracepoint hits to keep. Once this many hits are recorded, each new hit replaces the oldest one. Changing it discards the recorded hits." },
+    { "scratch-ast-memory-budget"          , OptionValue::eTypeUInt64    , false, 256 * 1024 * 1024         , NULL, NULL, "The number of bytes the scratch AST that holds the types of expression results, and the values of the persistent variables, can use before the persistent variables and types are moved to a fresh scratch AST and everything else in the old one is thrown away. Zero means no limit." },
+    { "expr-batch-pointer-checks"          , OptionValue::eTypeBoolean   , false, false                     , NULL, NULL, "Check the pointers an expression computes up front once, where they are computed, instead of before every dereference. This makes expressions that loop over data faster, but a bad pointer is reported even if the expression would never have dereferenced it." },
+    { "symbols-on-demand"                  , OptionValue::eTypeBoolean   , false, false                     , NULL, NULL, "Only use the symbol tables of the shared libraries that are loaded, and load their debug information once one of their addresses is in a backtrace, a lookup by name might find something in them, or a file and line lookup uses one of their source files. The executable's debug information is always loaded, and so is that of a shared library another target already uses." },
     { NULL                                 , OptionValue::eTypeInvalid   , false, 0                         , NULL, NULL, NULL }
 };
 enum
@@ -2182,7 +2955,19 @@ enum
     ePropertyErrorPath,
     ePropertyDisableASLR,
     ePropertyDisableSTDIO,
-    ePropertyInlineStrategy
+    ePropertyInlineStrategy,
+    ePropertyIndexCachePath,
+    ePropertyModuleCacheSize,
+    ePropertyParallelModuleSearch,
+    ePropertyShareTypesAcrossModules,
+    ePropertyPrewarmFrameVariableTypes,
+    ePropertyPreloadSymbols,
+    ePropertyParallelBacktrace,
+    ePropertyUseFastStepping,
+    ePropertyTracepointBufferSize,
+    ePropertyScratchASTMemoryBudget,
+    ePropertyExprBatchPointerChecks,
+    ePropertySymbolsOnDemand
 };
 
 
@@ -2286,7 +3071,11 @@ protected:
 };
 
 TargetProperties::TargetProperties (Target *target) :
-    Properties ()
+    Properties (),
+    m_prefer_dynamic (ePropertyPreferDynamic, OptionValue::eTypeEnum),
+    m_enable_synthetic (ePropertyEnableSynthetic, OptionValue::eTypeBoolean),
+    m_max_children_count (ePropertyMaxChildrenCount, OptionValue::eTypeSInt64),
+    m_max_summary_length (ePropertyMaxSummaryLength, OptionValue::eTypeSInt64)
 {
     if (target)
     {
@@ -2327,7 +3116,7 @@ lldb::DynamicValueType
 TargetProperties::GetPreferDynamicValue() const
 {
     const uint32_t idx = ePropertyPreferDynamic;
-    return (lldb::DynamicValueType)m_collection_sp->GetPropertyAtIndexAsEnumeration (NULL, idx, g_properties[idx].default_uint_value);
+    return (lldb::DynamicValueType)m_prefer_dynamic.GetEnumerationValue (*m_collection_sp, g_properties[idx].default_uint_value);
 }
 
 bool
@@ -2415,21 +3204,21 @@ bool
 TargetProperties::GetEnableSyntheticValue () const
 {
     const uint32_t idx = ePropertyEnableSynthetic;
-    return m_collection_sp->GetPropertyAtIndexAsBoolean (NULL, idx, g_properties[idx].default_uint_value != 0);
+    return m_enable_synthetic.GetBooleanValue (*m_collection_sp, g_properties[idx].default_uint_value != 0);
 }
 
 uint32_t
 TargetProperties::GetMaximumNumberOfChildrenToDisplay() const
 {
     const uint32_t idx = ePropertyMaxChildrenCount;
-    return m_collection_sp->GetPropertyAtIndexAsSInt64 (NULL, idx, g_properties[idx].default_uint_value);
+    return m_max_children_count.GetSInt64Value (*m_collection_sp, g_properties[idx].default_uint_value);
 }
 
 uint32_t
 TargetProperties::GetMaximumSizeOfStringSummary() const
 {
     const uint32_t idx = ePropertyMaxSummaryLength;
-    return m_collection_sp->GetPropertyAtIndexAsSInt64 (NULL, idx, g_properties[idx].default_uint_value);
+    return m_max_summary_length.GetSInt64Value (*m_collection_sp, g_properties[idx].default_uint_value);
 }
 
 FileSpec
@@ -2496,6 +3285,90 @@ TargetProperties::GetBreakpointsConsultPlatformAvoidList ()
     return m_collection_sp->GetPropertyAtIndexAsBoolean (NULL, idx, g_properties[idx].default_uint_value != 0);
 }
 
+FileSpec
+TargetProperties::GetIndexCachePath () const
+{
+    const uint32_t idx = ePropertyIndexCachePath;
+    return m_collection_sp->GetPropertyAtIndexAsFileSpec (NULL, idx);
+}
+
+uint64_t
+TargetProperties::GetModuleCacheSize () const
+{
+    const uint32_t idx = ePropertyModuleCacheSize;
+    return m_collection_sp->GetPropertyAtIndexAsUInt64 (NULL, idx, g_properties[idx].default_uint_value);
+}
+
+bool
+TargetProperties::GetParallelModuleSearch () const
+{
+    const uint32_t idx = ePropertyParallelModuleSearch;
+    return m_collection_sp->GetPropertyAtIndexAsBoolean (NULL, idx, g_properties[idx].default_uint_value != 0);
+}
+
+bool
+TargetProperties::GetShareTypesAcrossModules () const
+{
+    const uint32_t idx = ePropertyShareTypesAcrossModules;
+    return m_collection_sp->GetPropertyAtIndexAsBoolean (NULL, idx, g_properties[idx].default_uint_value != 0);
+}
+
+bool
+TargetProperties::GetPrewarmFrameVariableTypes () const
+{
+    const uint32_t idx = ePropertyPrewarmFrameVariableTypes;
+    return m_collection_sp->GetPropertyAtIndexAsBoolean (NULL, idx, g_properties[idx].default_uint_value != 0);
+}
+
+bool
+TargetProperties::GetPreloadSymbols () const
+{
+    const uint32_t idx = ePropertyPreloadSymbols;
+    return m_collection_sp->GetPropertyAtIndexAsBoolean (NULL, idx, g_properties[idx].default_uint_value != 0);
+}
+
+bool
+TargetProperties::GetParallelBacktrace () const
+{
+    const uint32_t idx = ePropertyParallelBacktrace;
+    return m_collection_sp->GetPropertyAtIndexAsBoolean (NULL, idx, g_properties[idx].default_uint_value != 0);
+}
+
+bool
+TargetProperties::GetUseFastStepping () const
+{
+    const uint32_t idx = ePropertyUseFastStepping;
+    return m_collection_sp->GetPropertyAtIndexAsBoolean (NULL, idx, g_properties[idx].default_uint_value != 0);
+}
+
+uint64_t
+TargetProperties::GetTracepointBufferSize () const
+{
+    const uint32_t idx = ePropertyTracepointBufferSize;
+    return m_collection_sp->GetPropertyAtIndexAsUInt64 (NULL, idx, g_properties[idx].default_uint_value);
+}
+
+uint64_t
+TargetProperties::GetScratchASTMemoryBudget () const
+{
+    const uint32_t idx = ePropertyScratchASTMemoryBudget;
+    return m_collection_sp->GetPropertyAtIndexAsUInt64 (NULL, idx, g_properties[idx].default_uint_value);
+}
+
+bool
+TargetProperties::GetExprBatchPointerChecks () const
+{
+    const uint32_t idx = ePropertyExprBatchPointerChecks;
+    return m_collection_sp->GetPropertyAtIndexAsBoolean (NULL, idx, g_properties[idx].default_uint_value != 0);
+}
+
+bool
+TargetProperties::GetSymbolsOnDemand () const
+{
+    const uint32_t idx = ePropertySymbolsOnDemand;
+    return m_collection_sp->GetPropertyAtIndexAsBoolean (NULL, idx, g_properties[idx].default_uint_value != 0);
+}
+
 const TargetPropertiesSP &
 Target::GetGlobalProperties()
 {
@@ -2538,7 +3411,7 @@ Target::TargetEventData::Dump (Stream *s) const
 }
 
 const TargetSP
-Target::TargetEventData::GetTargetFromEvent (const lldb::EventSP &event_sp)
+Target::TargetEventData::GetTargetFromEvent (const lldb::EventIntrusiveSP &event_sp)
 {
     TargetSP target_sp;
 
@@ -9,6 +9,7 @@
 
 #include "lldb/lldb-private-log.h"
 #include "lldb/Breakpoint/BreakpointLocation.h"
+#include "lldb/Breakpoint/BreakpointSite.h"
 #include "lldb/Core/Debugger.h"
 #include "lldb/Core/Log.h"
 #include "lldb/Core/Stream.h"
@@ -58,12 +59,14 @@ g_properties[] =
 {
     { "step-avoid-regexp",  OptionValue::eTypeRegex  , true , REG_EXTENDED, "^std::", NULL, "A regular expression defining functions step-in won't stop in." },
     { "trace-thread",       OptionValue::eTypeBoolean, false, false, NULL, NULL, "If true, this thread will single-step and log execution." },
+    { "trace-file",         OptionValue::eTypeFileSpec, false, 0   , NULL, NULL, "If set, traced threads run from branch to branch instead of single-stepping every instruction, and write a binary trace of the instructions they run to this path with the thread ID appended." },
     {  NULL               , OptionValue::eTypeInvalid, false, 0    , NULL, NULL, NULL  }
 };
 
 enum {
     ePropertyStepAvoidRegex,
-    ePropertyEnableThreadTrace
+    ePropertyEnableThreadTrace,
+    ePropertyThreadTraceFile
 };
 
 
@@ -135,6 +138,13 @@ ThreadProperties::GetTraceEnabledState() const
     return m_collection_sp->GetPropertyAtIndexAsBoolean (NULL, idx, g_properties[idx].default_uint_value != 0);
 }
 
+FileSpec
+ThreadProperties::GetTraceFile() const
+{
+    const uint32_t idx = ePropertyThreadTraceFile;
+    return m_collection_sp->GetPropertyAtIndexAsFileSpec (NULL, idx);
+}
+
 
 Thread::Thread (const ProcessSP &process_sp, lldb::tid_t tid) :
     ThreadProperties (false),
@@ -417,6 +427,27 @@ Thread::ShouldStop (Event* event_ptr)
         return false;
     }
     
+    // Hits of tracepoints are only recorded. Handle them before anything
+    // else looks at this stop, so they don't pay for stack frames, thread
+    // plans or a public stop.
+    StopInfoSP private_stop_info (GetPrivateStopReason());
+    if (private_stop_info && private_stop_info->GetStopReason() == eStopReasonBreakpoint)
+    {
+        ProcessSP process_sp (GetProcess());
+        BreakpointSiteSP bp_site_sp (process_sp->GetBreakpointSiteList().FindByID (private_stop_info->GetValue()));
+        if (bp_site_sp && bp_site_sp->IsTracepointSite())
+        {
+            if (bp_site_sp->ValidForThisThread (this))
+                process_sp->GetTarget().GetTraceBuffer().RecordHit (*this, *bp_site_sp);
+            if (log)
+                log->Printf ("Thread::%s for tid = 0x%4.4llx, should_stop = 0 (tracepoint site %i)", 
+                             __FUNCTION__, 
+                             GetID (), 
+                             bp_site_sp->GetID());
+            return false;
+        }
+    }
+
     // Adjust the stack frame's current inlined depth if it is needed.
     GetStackFrameList()->CalculateCurrentInlinedDepth();
     
@@ -439,7 +470,6 @@ Thread::ShouldStop (Event* event_ptr)
     // First query the stop info's ShouldStopSynchronous.  This handles "synchronous" stop reasons, for example the breakpoint
     // command on internal breakpoints.  If a synchronous stop reason says we should not stop, then we don't have to
     // do any more work on this stop.
-    StopInfoSP private_stop_info (GetPrivateStopReason());
     if (private_stop_info && private_stop_info->ShouldStopSynchronous(event_ptr) == false)
     {
         if (log)
@@ -1227,6 +1257,15 @@ Thread::CalculateExecutionContext (ExecutionContext &exe_ctx)
     exe_ctx.SetContext (shared_from_this());
 }
 
+uint32_t
+Thread::GetFramePCs (lldb::addr_t *pcs, uint32_t max_pcs)
+{
+    Unwind *unwinder = GetUnwinder ();
+    if (unwinder == NULL)
+        return 0;
+    return unwinder->GetFramePCs (pcs, max_pcs);
+}
+
 
 StackFrameListSP
 Thread::GetStackFrameList ()
@@ -1284,15 +1323,13 @@ Thread::DumpUsingSettingsFormat (Stream &strm, uint32_t frame_idx)
         }
     }
 
-    const char *thread_format = exe_ctx.GetTargetRef().GetDebugger().GetThreadFormat();
-    assert (thread_format);
-    const char *end = NULL;
-    Debugger::FormatPrompt (thread_format, 
+    PromptFormatSP thread_format_sp (exe_ctx.GetTargetRef().GetDebugger().GetCompiledThreadFormat());
+    assert (thread_format_sp);
+    Debugger::FormatPrompt (*thread_format_sp, 
                             frame_sp ? &frame_sc : NULL,
                             &exe_ctx, 
                             NULL,
-                            strm, 
-                            &end);
+                            strm);
 }
 
 void
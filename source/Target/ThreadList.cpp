@@ -11,11 +11,13 @@
 #include <algorithm>
 
 #include "lldb/Core/Log.h"
+#include "lldb/Host/Host.h"
 #include "lldb/Target/RegisterContext.h"
 #include "lldb/Target/ThreadList.h"
 #include "lldb/Target/Thread.h"
 #include "lldb/Target/ThreadPlan.h"
 #include "lldb/Target/Process.h"
+#include "lldb/Target/Target.h"
 
 using namespace lldb;
 using namespace lldb_private;
@@ -24,6 +26,7 @@ ThreadList::ThreadList (Process *process) :
     m_process (process),
     m_stop_id (0),
     m_threads(),
+    m_tid_index(),
     m_threads_mutex (Mutex::eMutexTypeRecursive),
     m_selected_tid (LLDB_INVALID_THREAD_ID)
 {
@@ -33,6 +36,7 @@ ThreadList::ThreadList (const ThreadList &rhs) :
     m_process (),
     m_stop_id (),
     m_threads (),
+    m_tid_index (),
     m_threads_mutex (Mutex::eMutexTypeRecursive),
     m_selected_tid ()
 {
@@ -52,6 +56,7 @@ ThreadList::operator = (const ThreadList& rhs)
         m_process = rhs.m_process;
         m_stop_id = rhs.m_stop_id;
         m_threads = rhs.m_threads;
+        m_tid_index = rhs.m_tid_index;
         m_selected_tid = rhs.m_selected_tid;
     }
     return *this;
@@ -80,9 +85,52 @@ void
 ThreadList::AddThread (const ThreadSP &thread_sp)
 {
     Mutex::Locker locker(m_threads_mutex);
+    // Threads usually come in ID order, which keeps the index up to date.
+    // Otherwise it gets rebuilt the next time a thread is looked up.
+    if (m_tid_index.size() == m_threads.size())
+    {
+        const TIDIndexPair entry (thread_sp->GetID(), m_threads.size());
+        if (m_tid_index.empty() || m_tid_index.back() < entry)
+            m_tid_index.push_back (entry);
+        else
+            m_tid_index.clear();
+    }
     m_threads.push_back(thread_sp);
 }
 
+ThreadSP
+ThreadList::RemoveThreadByID (lldb::tid_t tid)
+{
+    Mutex::Locker locker(m_threads_mutex);
+    ThreadSP thread_sp;
+    const uint32_t num_threads = m_threads.size();
+    for (uint32_t idx = 0; idx < num_threads; ++idx)
+    {
+        if (m_threads[idx]->GetID() == tid)
+        {
+            thread_sp = m_threads[idx];
+            m_threads.erase (m_threads.begin() + idx);
+            // The threads after it moved, so the index gets rebuilt the next
+            // time a thread is looked up.
+            m_tid_index.clear();
+            break;
+        }
+    }
+    return thread_sp;
+}
+
+void
+ThreadList::UpdateTIDIndex ()
+{
+    if (m_tid_index.size() == m_threads.size())
+        return;
+    const uint32_t num_threads = m_threads.size();
+    m_tid_index.resize (num_threads);
+    for (uint32_t idx = 0; idx < num_threads; ++idx)
+        m_tid_index[idx] = TIDIndexPair (m_threads[idx]->GetID(), idx);
+    std::sort (m_tid_index.begin(), m_tid_index.end());
+}
+
 uint32_t
 ThreadList::GetSize (bool can_update)
 {
@@ -114,16 +162,10 @@ ThreadList::FindThreadByID (lldb::tid_t tid, bool can_update)
         m_process->UpdateThreadListIfNeeded();
 
     ThreadSP thread_sp;
-    uint32_t idx = 0;
-    const uint32_t num_threads = m_threads.size();
-    for (idx = 0; idx < num_threads; ++idx)
-    {
-        if (m_threads[idx]->GetID() == tid)
-        {
-            thread_sp = m_threads[idx];
-            break;
-        }
-    }
+    UpdateTIDIndex ();
+    tid_index_collection::const_iterator pos = std::lower_bound (m_tid_index.begin(), m_tid_index.end(), TIDIndexPair (tid, 0));
+    if (pos != m_tid_index.end() && pos->first == tid)
+        thread_sp = m_threads[pos->second];
     return thread_sp;
 }
 
@@ -186,16 +228,29 @@ ThreadList::ShouldStop (Event *event_ptr)
 
     collection::iterator pos, end = m_threads.end();
 
+    // Threads without a stop reason never stop, so skip them right away
+    // if the process knows which threads have one
+    std::vector<lldb::tid_t> stopped_tids;
+    const bool only_stopped_threads = m_process->GetThreadsWithStopReason (stopped_tids);
+    if (only_stopped_threads)
+        std::sort (stopped_tids.begin(), stopped_tids.end());
+
     if (log)
     {
         log->PutCString("");
-        log->Printf ("ThreadList::%s: %zu threads", __FUNCTION__, m_threads.size());
+        if (only_stopped_threads)
+            log->Printf ("ThreadList::%s: %zu threads, %zu with a stop reason", __FUNCTION__, m_threads.size(), stopped_tids.size());
+        else
+            log->Printf ("ThreadList::%s: %zu threads", __FUNCTION__, m_threads.size());
     }
 
     for (pos = m_threads.begin(); pos != end; ++pos)
     {
         ThreadSP thread_sp(*pos);
         
+        if (only_stopped_threads && !std::binary_search (stopped_tids.begin(), stopped_tids.end(), thread_sp->GetID()))
+            continue;
+
         const bool thread_should_stop = thread_sp->ShouldStop(event_ptr);
         if (thread_should_stop)
             should_stop |= true;
@@ -230,11 +285,20 @@ ThreadList::ShouldReportStop (Event *event_ptr)
     if (log)
         log->Printf ("ThreadList::%s %zu threads", __FUNCTION__, m_threads.size());
 
+    // Threads without a stop reason have no opinion
+    std::vector<lldb::tid_t> stopped_tids;
+    const bool only_stopped_threads = m_process->GetThreadsWithStopReason (stopped_tids);
+    if (only_stopped_threads)
+        std::sort (stopped_tids.begin(), stopped_tids.end());
+
     // Run through the threads and ask whether we should report this event.
     // For stopping, a YES vote wins over everything.  A NO vote wins over NO opinion.
     for (pos = m_threads.begin(); pos != end; ++pos)
     {
         ThreadSP thread_sp(*pos);
+        if (only_stopped_threads && !std::binary_search (stopped_tids.begin(), stopped_tids.end(), thread_sp->GetID()))
+            continue;
+
         const Vote vote = thread_sp->ShouldReportStop (event_ptr);
         switch (vote)
         {
@@ -313,6 +377,7 @@ ThreadList::Clear()
     Mutex::Locker locker(m_threads_mutex);
     m_stop_id = 0;
     m_threads.clear();
+    m_tid_index.clear();
     m_selected_tid = LLDB_INVALID_THREAD_ID;
 }
 
@@ -585,6 +650,7 @@ ThreadList::Update (ThreadList &rhs)
         m_process = rhs.m_process;
         m_stop_id = rhs.m_stop_id;
         m_threads.swap(rhs.m_threads);
+        m_tid_index.swap(rhs.m_tid_index);
         m_selected_tid = rhs.m_selected_tid;
         
         
@@ -594,23 +660,18 @@ ThreadList::Update (ThreadList &rhs)
         // but the thread won't be of much use. Using std::weak_ptr
         // for all backward references (such as a thread to a process)
         // will eventually solve this issue for us, but for now, we
-        // need to work around the issue
-        collection::iterator rhs_pos, rhs_end = rhs.m_threads.end();
-        for (rhs_pos = rhs.m_threads.begin(); rhs_pos != rhs_end; ++rhs_pos)
+        // need to work around the issue. Both lists are walked in
+        // thread ID order so this stays fast with many threads.
+        UpdateTIDIndex ();
+        rhs.UpdateTIDIndex ();
+        tid_index_collection::const_iterator pos = m_tid_index.begin(), end = m_tid_index.end();
+        tid_index_collection::const_iterator rhs_pos, rhs_end = rhs.m_tid_index.end();
+        for (rhs_pos = rhs.m_tid_index.begin(); rhs_pos != rhs_end; ++rhs_pos)
         {
-            const lldb::tid_t tid = (*rhs_pos)->GetID();
-            bool thread_is_alive = false;
-            const uint32_t num_threads = m_threads.size();
-            for (uint32_t idx = 0; idx < num_threads; ++idx)
-            {
-                if (m_threads[idx]->GetID() == tid)
-                {
-                    thread_is_alive = true;
-                    break;
-                }
-            }
-            if (!thread_is_alive)
-                (*rhs_pos)->DestroyThread();
+            while (pos != end && pos->first < rhs_pos->first)
+                ++pos;
+            if (pos == end || pos->first != rhs_pos->first)
+                rhs.m_threads[rhs_pos->second]->DestroyThread();
         }        
     }
 }
@@ -624,3 +685,78 @@ ThreadList::Flush ()
         (*pos)->Flush ();
 }
 
+namespace {
+
+struct ComputeStackFramesState
+{
+    const std::vector<ThreadSP> *threads;
+    uint32_t num_frames;
+    Mutex *mutex;
+    size_t *next_idx;
+};
+
+} // anonymous namespace
+
+static void *
+ComputeStackFramesWorkerThread (void *arg)
+{
+    ComputeStackFramesState *state = (ComputeStackFramesState *)arg;
+    const size_t num_threads = state->threads->size();
+    while (1)
+    {
+        // Stacks have very different depths, so hand the threads out one
+        // at a time.
+        size_t idx;
+        {
+            Mutex::Locker locker (*state->mutex);
+            idx = (*state->next_idx)++;
+        }
+        if (idx >= num_threads)
+            break;
+        Thread *thread = (*state->threads)[idx].get();
+        if (thread == NULL)
+            continue;
+        // Each thread has its own unwinder and frame list, and these
+        // unwind as far as the requested frame and no further.
+        if (state->num_frames == UINT32_MAX)
+            thread->GetStackFrameCount();
+        else if (state->num_frames > 0)
+            thread->GetStackFrameAtIndex (state->num_frames - 1);
+    }
+    return NULL;
+}
+
+void
+ThreadList::ComputeStackFrames (const std::vector<ThreadSP> &threads, uint32_t num_frames)
+{
+    const size_t num_threads = threads.size();
+    if (num_threads < 2 || num_frames == 0 || !threads[0])
+        return;
+
+    ProcessSP process_sp (threads[0]->GetProcess());
+    if (!process_sp || !process_sp->GetTarget().GetParallelBacktrace())
+        return;
+
+    const uint32_t num_workers = std::min<uint32_t> (Host::GetNumberCPUs(), num_threads);
+    if (num_workers <= 1)
+        return;
+
+    Mutex mutex;
+    size_t next_idx = 0;
+    ComputeStackFramesState state = { &threads, num_frames, &mutex, &next_idx };
+
+    // The calling thread does work too, so only spawn threads for the
+    // rest of the workers.
+    std::vector<lldb::thread_t> worker_threads;
+    for (uint32_t i=1; i<num_workers; ++i)
+    {
+        lldb::thread_t thread = Host::ThreadCreate ("<lldb.thread-list.unwind>", ComputeStackFramesWorkerThread, &state, NULL);
+        if (IS_VALID_LLDB_HOST_THREAD(thread))
+            worker_threads.push_back (thread);
+    }
+
+    ComputeStackFramesWorkerThread (&state);
+
+    for (size_t i=0; i<worker_threads.size(); ++i)
+        Host::ThreadJoin (worker_threads[i], NULL, NULL);
+}
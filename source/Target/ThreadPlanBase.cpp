@@ -40,10 +40,15 @@ ThreadPlanBase::ThreadPlanBase (Thread &thread) :
     // FIXME: need to add a thread settings variable to pix various tracers...
 #define THREAD_PLAN_USE_ASSEMBLY_TRACER 1
 
+    ThreadPlanTracerSP new_tracer_sp;
+    const FileSpec trace_file (m_thread.GetTraceFile());
+    if (trace_file)
+        new_tracer_sp.reset (new ThreadPlanBranchTracer (m_thread, trace_file));
+    else
 #ifdef THREAD_PLAN_USE_ASSEMBLY_TRACER
-    ThreadPlanTracerSP new_tracer_sp (new ThreadPlanAssemblyTracer (m_thread));
+        new_tracer_sp.reset (new ThreadPlanAssemblyTracer (m_thread));
 #else
-    ThreadPlanTracerSP new_tracer_sp (new ThreadPlanTracer (m_thread));
+        new_tracer_sp.reset (new ThreadPlanTracer (m_thread));
 #endif
     new_tracer_sp->EnableTracing (m_thread.GetTraceEnabledState());
     SetThreadPlanTracer(new_tracer_sp);
@@ -461,7 +461,16 @@ ThreadPlanCallFunction::DidPush ()
 //#define SINGLE_STEP_EXPRESSIONS
     
 #ifndef SINGLE_STEP_EXPRESSIONS
-    m_subplan_sp.reset(new ThreadPlanRunToAddress(m_thread, m_start_addr, m_stop_other_threads));
+    // Return to the target's function call breakpoint, which stays set
+    // between calls, and fall back to one of our own if it can't be set
+    TargetSP target_sp (m_thread.CalculateTarget());
+    BreakpointSP return_bp_sp;
+    if (target_sp)
+        return_bp_sp = target_sp->GetFunctionCallReturnBreakpoint (m_start_addr.GetOpcodeLoadAddress (target_sp.get()));
+    if (return_bp_sp)
+        m_subplan_sp.reset(new ThreadPlanRunToAddress(m_thread, m_start_addr, return_bp_sp->GetID(), m_stop_other_threads));
+    else
+        m_subplan_sp.reset(new ThreadPlanRunToAddress(m_thread, m_start_addr, m_stop_other_threads));
     
     m_thread.QueueThreadPlan(m_subplan_sp, false);
     m_subplan_sp->SetPrivate (true);
@@ -37,7 +37,8 @@ ThreadPlanRunToAddress::ThreadPlanRunToAddress
     ThreadPlan (ThreadPlan::eKindRunToAddress, "Run to address plan", thread, eVoteNoOpinion, eVoteNoOpinion),
     m_stop_others (stop_others),
     m_addresses (),
-    m_break_ids ()
+    m_break_ids (),
+    m_owns_breakpoints (true)
 {
     m_addresses.push_back (address.GetOpcodeLoadAddress (m_thread.CalculateTarget().get()));
     SetInitialBreakpoints();
@@ -52,7 +53,8 @@ ThreadPlanRunToAddress::ThreadPlanRunToAddress
     ThreadPlan (ThreadPlan::eKindRunToAddress, "Run to address plan", thread, eVoteNoOpinion, eVoteNoOpinion),
     m_stop_others (stop_others),
     m_addresses (),
-    m_break_ids ()
+    m_break_ids (),
+    m_owns_breakpoints (true)
 {
     m_addresses.push_back(m_thread.CalculateTarget()->GetOpcodeLoadAddress(address));
     SetInitialBreakpoints();
@@ -67,7 +69,8 @@ ThreadPlanRunToAddress::ThreadPlanRunToAddress
     ThreadPlan (ThreadPlan::eKindRunToAddress, "Run to address plan", thread, eVoteNoOpinion, eVoteNoOpinion),
     m_stop_others (stop_others),
     m_addresses (addresses),
-    m_break_ids ()
+    m_break_ids (),
+    m_owns_breakpoints (true)
 {
     // Convert all addressses into opcode addresses to make sure we set 
     // breakpoints at the correct address.
@@ -79,6 +82,23 @@ ThreadPlanRunToAddress::ThreadPlanRunToAddress
     SetInitialBreakpoints();
 }
 
+ThreadPlanRunToAddress::ThreadPlanRunToAddress
+(
+    Thread &thread,
+    Address &address,
+    lldb::break_id_t break_id,
+    bool stop_others
+) :
+    ThreadPlan (ThreadPlan::eKindRunToAddress, "Run to address plan", thread, eVoteNoOpinion, eVoteNoOpinion),
+    m_stop_others (stop_others),
+    m_addresses (),
+    m_break_ids (),
+    m_owns_breakpoints (false)
+{
+    m_addresses.push_back (address.GetOpcodeLoadAddress (m_thread.CalculateTarget().get()));
+    m_break_ids.push_back (break_id);
+}
+
 void
 ThreadPlanRunToAddress::SetInitialBreakpoints ()
 {
@@ -99,6 +119,8 @@ ThreadPlanRunToAddress::SetInitialBreakpoints ()
 
 ThreadPlanRunToAddress::~ThreadPlanRunToAddress ()
 {
+    if (!m_owns_breakpoints)
+        return;
     size_t num_break_ids = m_break_ids.size();
     for (size_t i = 0; i <  num_break_ids; i++)
     {
@@ -234,7 +256,7 @@ ThreadPlanRunToAddress::MischiefManaged ()
         
         for (size_t i = 0; i < num_break_ids; i++)
         {
-            if (m_break_ids[i] != LLDB_INVALID_BREAK_ID)
+            if (m_owns_breakpoints && m_break_ids[i] != LLDB_INVALID_BREAK_ID)
             {
                 m_thread.CalculateTarget()->RemoveBreakpointByID (m_break_ids[i]);
                 m_break_ids[i] = LLDB_INVALID_BREAK_ID;
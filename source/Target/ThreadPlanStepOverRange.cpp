@@ -260,7 +260,8 @@ ThreadPlanStepOverRange::WillResume (lldb::StateType resume_state, bool current_
                     if (frame_block->GetRangeContainingLoadAddress(curr_pc, m_thread.GetProcess()->GetTarget(), my_range))
                     {
                         m_address_ranges.clear();
-                        m_address_ranges.push_back(my_range);
+                        m_instruction_ranges.clear();
+                        AddRange(my_range);
                         if (log)
                         {
                             StreamString s;
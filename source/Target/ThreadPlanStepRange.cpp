@@ -299,17 +299,24 @@ ThreadPlanStepRange::ClearNextBranchBreakpoint()
 bool
 ThreadPlanStepRange::SetNextBranchBreakpoint ()
 {
-    // Stepping through ranges using breakpoints doesn't work yet, but with this off we fall back to instruction
-    // single stepping.
-    return false;
     // Always clear the next branch breakpoint, we don't want to leave one of these stranded.
     ClearNextBranchBreakpoint();
+
+    // If fast stepping is off we fall back to instruction single stepping.
+    if (!GetTarget().GetUseFastStepping())
+        return false;
+
+    // If we are stopped in the middle of an inlined stack, WillResume has to step through the
+    // virtual inlined frames first, and that only happens when we single step.
+    if (m_thread.GetCurrentInlinedDepth() != UINT32_MAX)
+        return false;
+
     lldb::addr_t cur_addr = GetThread().GetRegisterContext()->GetPC();
     // Find the current address in our address ranges, and fetch the disassembly if we haven't already:
     size_t pc_index;
     size_t range_index;
     InstructionList *instructions = GetInstructionsForAddress (cur_addr, range_index, pc_index);
-    if (instructions == NULL)
+    if (instructions == NULL || instructions->GetSize() == 0)
         return false;
     else
     {
@@ -318,18 +325,36 @@ ThreadPlanStepRange::SetNextBranchBreakpoint ()
         
         Address run_to_address;
         
-        // If we didn't find a branch, run to the end of the range.
+        // If we didn't find a branch, run to the last instruction in the range, single stepping that
+        // will take us out of the range.
         if (branch_index == UINT32_MAX)
         {
-            branch_index = instructions->GetSize() - 2;
+            branch_index = instructions->GetSize() - 1;
         }
-        if (branch_index - pc_index > 1)
+        // If we are sitting on the branch (or right before it) just step, stopping at the breakpoint
+        // wouldn't save us anything.
+        if (branch_index > pc_index && branch_index - pc_index > 1)
         {
             const bool is_internal = true;
             run_to_address = instructions->GetInstructionAtIndex(branch_index)->GetAddress();
             m_next_branch_bp_sp = GetTarget().CreateBreakpoint(run_to_address, is_internal);
-            m_next_branch_bp_sp->SetThreadID(m_thread.GetID());
-            return true;
+            if (m_next_branch_bp_sp)
+            {
+                if (m_next_branch_bp_sp->GetNumResolvedLocations() == 0)
+                {
+                    // We couldn't insert the breakpoint, so single step instead.
+                    ClearNextBranchBreakpoint();
+                    return false;
+                }
+                m_next_branch_bp_sp->SetThreadID(m_thread.GetID());
+
+                LogSP log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_STEP));
+                if (log)
+                    log->Printf ("ThreadPlanStepRange::SetNextBranchBreakpoint: running from 0x%llx to the branch at 0x%llx.",
+                                 (uint64_t)cur_addr,
+                                 (uint64_t)run_to_address.GetLoadAddress(&GetTarget()));
+                return true;
+            }
         }
     }
     return false;
@@ -343,6 +368,8 @@ ThreadPlanStepRange::NextRangeBreakpointExplainsStop (lldb::StopInfoSP stop_info
     
     break_id_t bp_site_id = stop_info_sp->GetValue();
     BreakpointSiteSP bp_site_sp = m_thread.GetProcess()->GetBreakpointSiteList().FindByID(bp_site_id);
+    if (!bp_site_sp)
+        return false;
     if (!bp_site_sp->IsBreakpointAtThisSite (m_next_branch_bp_sp->GetID()))
         return false;
     else
@@ -394,6 +421,7 @@ ThreadPlanStepRange::MischiefManaged ()
         LogSP log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_STEP));
         if (log)
             log->Printf("Completed step through range plan.");
+        ClearNextBranchBreakpoint();
         ThreadPlan::MischiefManaged ();
         return true;
     }
@@ -10,10 +10,13 @@
 #include "lldb/Target/ThreadPlan.h"
 
 // C Includes
+#include <limits.h>
 #include <string.h>
 // C++ Includes
 // Other libraries and framework includes
 // Project includes
+#include "lldb/Breakpoint/Breakpoint.h"
+#include "lldb/Breakpoint/BreakpointSite.h"
 #include "lldb/Core/ArchSpec.h"
 #include "lldb/Core/DataBufferHeap.h"
 #include "lldb/Core/Debugger.h"
@@ -21,11 +24,13 @@
 #include "lldb/Core/Log.h"
 #include "lldb/Core/Module.h"
 #include "lldb/Core/State.h"
+#include "lldb/Core/StreamString.h"
 #include "lldb/Core/Value.h"
 #include "lldb/Symbol/TypeList.h"
 #include "lldb/Target/RegisterContext.h"
 #include "lldb/Target/Thread.h"
 #include "lldb/Target/Process.h"
+#include "lldb/Target/StopInfo.h"
 #include "lldb/Target/Target.h"
 
 using namespace lldb;
@@ -195,7 +200,11 @@ ThreadPlanAssemblyTracer::Log ()
     if (disassembler)
     {        
         Error err;
-        process_sp->ReadMemory(pc, buffer, sizeof(buffer), err);
+        const bool prefer_file_cache = true;
+        if (addr_valid)
+            process_sp->GetTarget().ReadMemory (pc_addr, prefer_file_cache, buffer, sizeof(buffer), err);
+        else
+            process_sp->ReadMemory (pc, buffer, sizeof(buffer), err);
         
         if (err.Success())
         {
@@ -278,3 +287,226 @@ ThreadPlanAssemblyTracer::Log ()
     stream->EOL();
     stream->Flush();
 }
+
+#pragma mark ThreadPlanBranchTracer
+
+// The most instructions decoded for one run. A run without a branch in
+// this many instructions ends at the last one.
+#define MAX_RUN_INSTRUCTIONS 64
+
+// How many bytes of records are kept before they are written out.
+#define TRACE_RECORD_BATCH_SIZE (64 * 1024)
+
+ThreadPlanBranchTracer::ThreadPlanBranchTracer (Thread &thread, const FileSpec &trace_file) :
+    ThreadPlanTracer (thread),
+    m_trace_file (trace_file),
+    m_file (),
+    m_records (),
+    m_runs (),
+    m_disassembler_sp (),
+    m_branch_bp_sp (),
+    m_run_start (LLDB_INVALID_ADDRESS),
+    m_run_instructions (0),
+    m_stepping (false),
+    m_explains_stop (false)
+{
+}
+
+ThreadPlanBranchTracer::~ThreadPlanBranchTracer ()
+{
+    ClearBranchBreakpoint ();
+    FlushRecords ();
+}
+
+void
+ThreadPlanBranchTracer::TracingStarted ()
+{
+    // Code might have been loaded or changed since tracing ended.
+    m_runs.clear();
+    m_run_start = LLDB_INVALID_ADDRESS;
+    m_stepping = false;
+    EnableSingleStep (true);
+
+    if (m_file.IsValid())
+        return;
+
+    // Each thread gets a trace file of its own.
+    char path[PATH_MAX];
+    m_trace_file.GetPath (path, sizeof(path));
+    StreamString thread_path;
+    thread_path.Printf ("%s.%llu", path, m_thread.GetID());
+    Error error (m_file.Open (thread_path.GetData(),
+                              File::eOpenOptionWrite | File::eOpenOptionCanCreate | File::eOpenOptionTruncate));
+    if (error.Fail())
+    {
+        LogSP log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_STEP));
+        if (log)
+            log->Printf ("ThreadPlanBranchTracer couldn't open '%s': %s", thread_path.GetData(), error.AsCString());
+        return;
+    }
+
+    const char magic[8] = { 'L', 'L', 'D', 'B', 'B', 'T', 'R', '1' };
+    const uint64_t tid = m_thread.GetID();
+    m_records.insert (m_records.end(), magic, magic + sizeof(magic));
+    m_records.insert (m_records.end(), (const uint8_t *)&tid, (const uint8_t *)&tid + sizeof(tid));
+}
+
+void
+ThreadPlanBranchTracer::TracingEnded ()
+{
+    ClearBranchBreakpoint ();
+    FlushRecords ();
+    m_file.Close ();
+}
+
+bool
+ThreadPlanBranchTracer::TracerExplainsStop ()
+{
+    return TracingEnabled() && m_explains_stop;
+}
+
+void
+ThreadPlanBranchTracer::ClearBranchBreakpoint ()
+{
+    if (m_branch_bp_sp)
+    {
+        TargetSP target_sp (m_thread.CalculateTarget());
+        if (target_sp)
+            target_sp->RemoveBreakpointByID (m_branch_bp_sp->GetID());
+        m_branch_bp_sp.reset();
+    }
+}
+
+const ThreadPlanBranchTracer::Run &
+ThreadPlanBranchTracer::GetRunAtAddress (lldb::addr_t addr)
+{
+    RunMap::iterator pos = m_runs.find (addr);
+    if (pos != m_runs.end())
+        return pos->second;
+
+    // If the instructions can't be decoded, the run is just the one
+    // instruction, which is single-stepped.
+    Run run;
+    run.branch_addr = addr;
+    run.num_instructions = 1;
+
+    Target &target = m_thread.GetProcess()->GetTarget();
+    if (!m_disassembler_sp)
+        m_disassembler_sp = Disassembler::FindPlugin (target.GetArchitecture(), NULL);
+
+    if (m_disassembler_sp)
+    {
+        Address start_addr;
+        if (!target.GetSectionLoadList().ResolveLoadAddress (addr, start_addr))
+            start_addr.SetRawAddress (addr);
+
+        ExecutionContext exe_ctx (m_thread.GetProcess());
+        if (m_disassembler_sp->ParseInstructions (&exe_ctx, start_addr, MAX_RUN_INSTRUCTIONS) > 0)
+        {
+            const InstructionList &instructions = m_disassembler_sp->GetInstructionList();
+            uint32_t branch_index = instructions.GetIndexOfNextBranchInstruction (0);
+            if (branch_index == UINT32_MAX)
+                branch_index = instructions.GetSize() - 1;
+            run.branch_addr = instructions.GetInstructionAtIndex (branch_index)->GetAddress().GetLoadAddress (&target);
+            run.num_instructions = branch_index + 1;
+        }
+    }
+    return m_runs.insert (std::make_pair (addr, run)).first->second;
+}
+
+void
+ThreadPlanBranchTracer::AppendRecord (lldb::addr_t start_addr, uint32_t num_instructions)
+{
+    if (!m_file.IsValid())
+        return;
+    const uint64_t addr = start_addr;
+    m_records.insert (m_records.end(), (const uint8_t *)&addr, (const uint8_t *)&addr + sizeof(addr));
+    m_records.insert (m_records.end(), (const uint8_t *)&num_instructions, (const uint8_t *)&num_instructions + sizeof(num_instructions));
+    if (m_records.size() >= TRACE_RECORD_BATCH_SIZE)
+        FlushRecords ();
+}
+
+void
+ThreadPlanBranchTracer::FlushRecords ()
+{
+    if (m_file.IsValid() && !m_records.empty())
+    {
+        size_t num_bytes = m_records.size();
+        m_file.Write (&m_records[0], num_bytes);
+    }
+    m_records.clear();
+}
+
+void
+ThreadPlanBranchTracer::Log ()
+{
+    m_explains_stop = false;
+
+    RegisterContext *reg_ctx = m_thread.GetRegisterContext().get();
+    if (reg_ctx == NULL)
+        return;
+    const lldb::addr_t pc = reg_ctx->GetPC();
+
+    StopInfoSP stop_info_sp (m_thread.GetStopInfo());
+    if (stop_info_sp)
+    {
+        const StopReason reason = stop_info_sp->GetStopReason();
+        if (reason == eStopReasonTrace)
+        {
+            m_explains_stop = SingleStepEnabled();
+        }
+        else if (reason == eStopReasonBreakpoint && m_branch_bp_sp)
+        {
+            BreakpointSiteSP bp_site_sp (m_thread.GetProcess()->GetBreakpointSiteList().FindByID (stop_info_sp->GetValue()));
+            m_explains_stop = bp_site_sp
+                              && bp_site_sp->IsBreakpointAtThisSite (m_branch_bp_sp->GetID())
+                              && bp_site_sp->GetNumberOfOwners() == 1;
+        }
+    }
+
+    if (m_explains_stop)
+    {
+        if (m_branch_bp_sp)
+        {
+            // Reached the end of the run, step over the branch by itself to
+            // see where it goes.
+            ClearBranchBreakpoint ();
+            m_stepping = true;
+            EnableSingleStep (true);
+            return;
+        }
+        // The last instruction of the run was stepped over, so the whole
+        // run was executed.
+        if (m_stepping && m_run_start != LLDB_INVALID_ADDRESS)
+            AppendRecord (m_run_start, m_run_instructions);
+    }
+    else
+    {
+        // Something else stopped the thread, don't know how much of the
+        // current run was executed. Start over from where the thread is.
+        ClearBranchBreakpoint ();
+    }
+
+    const Run &run = GetRunAtAddress (pc);
+    m_run_start = pc;
+    m_run_instructions = run.num_instructions;
+    m_stepping = false;
+
+    if (run.branch_addr != pc)
+    {
+        const bool is_internal = true;
+        m_branch_bp_sp = m_thread.GetProcess()->GetTarget().CreateBreakpoint (run.branch_addr, is_internal);
+        if (m_branch_bp_sp && m_branch_bp_sp->GetNumResolvedLocations() > 0)
+        {
+            m_branch_bp_sp->SetThreadID (m_thread.GetID());
+            EnableSingleStep (false);
+            return;
+        }
+        // Couldn't set the breakpoint, single-step this instruction as a run
+        // of its own.
+        ClearBranchBreakpoint ();
+        m_run_instructions = 1;
+    }
+    m_stepping = true;
+    EnableSingleStep (true);
+}
@@ -0,0 +1,180 @@
+//===-- TraceBuffer.cpp -----------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "lldb/Target/TraceBuffer.h"
+
+// C Includes
+#include <string.h>
+
+// C++ Includes
+// Other libraries and framework includes
+// Project includes
+#include "lldb/Breakpoint/Breakpoint.h"
+#include "lldb/Breakpoint/BreakpointLocation.h"
+#include "lldb/Breakpoint/BreakpointSite.h"
+#include "lldb/Core/Error.h"
+#include "lldb/Core/Stream.h"
+#include "lldb/Host/TimeValue.h"
+#include "lldb/Target/Process.h"
+#include "lldb/Target/RegisterContext.h"
+#include "lldb/Target/Thread.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+TraceBuffer::TraceBuffer (size_t capacity) :
+    m_mutex (Mutex::eMutexTypeNormal),
+    m_records (),
+    m_capacity (capacity),
+    m_num_hits (0)
+{
+}
+
+TraceBuffer::~TraceBuffer ()
+{
+}
+
+void
+TraceBuffer::RecordHit (Thread &thread, BreakpointSite &bp_site)
+{
+    BreakpointLocationSP loc_sp;
+    if (!bp_site.TracepointWasHit (loc_sp))
+        return;
+
+    // Everything is read before taking the lock so that anyone reading
+    // the records only waits for the copy below.
+    Record record;
+    ::memset (&record, 0, sizeof(record));
+    record.time_usec = TimeValue::Now().GetAsMicroSecondsSinceJan1_1970();
+    record.tid = thread.GetID();
+    record.bp_id = loc_sp->GetBreakpoint().GetID();
+    record.loc_id = loc_sp->GetID();
+    record.pc = bp_site.GetLoadAddress();
+    record.sp = LLDB_INVALID_ADDRESS;
+    record.fp = LLDB_INVALID_ADDRESS;
+    record.ra = LLDB_INVALID_ADDRESS;
+
+    // Only the frame 0 register context is used, the thread is never
+    // unwound.
+    RegisterContextSP reg_ctx_sp (thread.GetRegisterContext());
+    if (reg_ctx_sp)
+    {
+        record.sp = reg_ctx_sp->GetSP();
+        record.fp = reg_ctx_sp->GetFP();
+        record.ra = reg_ctx_sp->GetReturnAddress();
+        for (uint32_t i = 0; i < eNumArgumentRegisters; ++i)
+        {
+            const uint32_t reg = reg_ctx_sp->ConvertRegisterKindToRegisterNumber (eRegisterKindGeneric,
+                                                                                   LLDB_REGNUM_GENERIC_ARG1 + i);
+            if (reg == LLDB_INVALID_REGNUM)
+                break;
+            record.args[i] = reg_ctx_sp->ReadRegisterAsUnsigned (reg, 0);
+            record.num_args = i + 1;
+        }
+    }
+
+    ProcessSP process_sp (thread.GetProcess());
+    if (process_sp && record.sp != LLDB_INVALID_ADDRESS)
+    {
+        Error error;
+        record.stack_size = process_sp->ReadMemory (record.sp, record.stack, sizeof(record.stack), error);
+    }
+
+    Mutex::Locker locker (m_mutex);
+    if (m_capacity == 0)
+        return;
+    record.index = m_num_hits++;
+    if (m_records.size() < m_capacity)
+        m_records.push_back (record);
+    else
+        m_records[record.index % m_capacity] = record;
+}
+
+size_t
+TraceBuffer::GetRecords (std::vector<Record> &records, size_t max_records) const
+{
+    records.clear();
+    Mutex::Locker locker (m_mutex);
+    const size_t num_records = m_records.size();
+    if (num_records == 0)
+        return 0;
+    if (max_records == 0 || max_records > num_records)
+        max_records = num_records;
+    records.reserve (max_records);
+    // Once the buffer has wrapped around, the oldest record is the one
+    // the next hit will replace.
+    const size_t first = num_records < m_capacity ? 0 : (size_t)(m_num_hits % m_capacity);
+    for (size_t i = num_records - max_records; i < num_records; ++i)
+        records.push_back (m_records[(first + i) % num_records]);
+    return records.size();
+}
+
+uint64_t
+TraceBuffer::GetNumHits () const
+{
+    Mutex::Locker locker (m_mutex);
+    return m_num_hits;
+}
+
+size_t
+TraceBuffer::GetCapacity () const
+{
+    Mutex::Locker locker (m_mutex);
+    return m_capacity;
+}
+
+void
+TraceBuffer::SetCapacity (size_t capacity)
+{
+    Mutex::Locker locker (m_mutex);
+    m_capacity = capacity;
+    m_records.clear();
+    m_num_hits = 0;
+}
+
+void
+TraceBuffer::Clear ()
+{
+    Mutex::Locker locker (m_mutex);
+    m_records.clear();
+    m_num_hits = 0;
+}
+
+void
+TraceBuffer::DumpRecord (Stream &s, const Record &record)
+{
+    s.Printf ("#%llu time = %llu.%6.6llu tid = 0x%4.4llx tracepoint = %i.%i pc = 0x%16.16llx sp = 0x%16.16llx fp = 0x%16.16llx ra = 0x%16.16llx",
+              record.index,
+              record.time_usec / 1000000,
+              record.time_usec % 1000000,
+              record.tid,
+              record.bp_id,
+              record.loc_id,
+              record.pc,
+              record.sp,
+              record.fp,
+              record.ra);
+    s.EOL();
+    s.IndentMore();
+    if (record.num_args > 0)
+    {
+        s.Indent ("args:");
+        for (uint32_t i = 0; i < record.num_args; ++i)
+            s.Printf (" 0x%llx", record.args[i]);
+        s.EOL();
+    }
+    if (record.stack_size > 0)
+    {
+        s.Indent ("stack:");
+        for (uint32_t i = 0; i < record.stack_size; ++i)
+            s.Printf (" %2.2x", record.stack[i]);
+        s.EOL();
+    }
+    s.IndentLess();
+}
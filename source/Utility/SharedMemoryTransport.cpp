@@ -0,0 +1,270 @@
+//===-- SharedMemoryTransport.cpp -------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "Utility/SharedMemoryTransport.h"
+
+// C Includes
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// C++ Includes
+#include <algorithm>
+
+// Other libraries and framework includes
+// Project includes
+
+#define SHARED_MEMORY_TRANSPORT_MAGIC   0x6c6c6462  // 'lldb'
+#define SHARED_MEMORY_TRANSPORT_VERSION 1
+
+// The offsets only ever grow and wrap around at 2^32, the number of
+// bytes in a ring is write_offset - read_offset. Each one is on its own
+// cache line so the reader and writer don't fight over them.
+struct SharedMemoryTransport::Ring
+{
+    volatile uint32_t read_offset;
+    uint8_t padding0[60];
+    volatile uint32_t write_offset;
+    uint8_t padding1[60];
+    volatile uint32_t reader_waiting;
+    uint8_t padding2[60];
+};
+
+struct SharedMemoryTransport::Region
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t ring_size;
+    uint8_t padding[52];
+    Ring rings[2];  // Client to server, then server to client
+    // The data for the two rings follows
+};
+
+SharedMemoryTransport::SharedMemoryTransport () :
+    m_name (),
+    m_region (NULL),
+    m_region_size (0),
+    m_ring_size (0),
+    m_read_ring_idx (0),
+    m_unlinked (false)
+{
+}
+
+SharedMemoryTransport::~SharedMemoryTransport ()
+{
+    Close ();
+}
+
+bool
+SharedMemoryTransport::Create (size_t ring_size)
+{
+    Close ();
+    if (ring_size == 0 || (ring_size & (ring_size - 1)) != 0 || ring_size > (1u << 30))
+        return false;
+
+    // Names can be no longer than 31 characters on Mac OS X
+    static uint32_t g_region_id = 0;
+    char name[32];
+    ::snprintf (name, sizeof(name), "/lldb-%i-%u", (int)::getpid(), __sync_add_and_fetch (&g_region_id, 1));
+
+    const int fd = ::shm_open (name, O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+    if (fd < 0)
+        return false;
+    m_name.assign (name);
+
+    const size_t region_size = sizeof(Region) + 2 * ring_size;
+    bool success = ::ftruncate (fd, region_size) == 0 && Map (fd, region_size);
+    ::close (fd);
+    if (!success)
+    {
+        Close ();
+        return false;
+    }
+
+    ::memset (m_region, 0, sizeof(Region));
+    m_region->magic = SHARED_MEMORY_TRANSPORT_MAGIC;
+    m_region->version = SHARED_MEMORY_TRANSPORT_VERSION;
+    m_region->ring_size = ring_size;
+    // The readers start out waiting so the first bytes written in each
+    // direction always wake up the other side, which may have blocked
+    // on the connection before it knew about the region.
+    m_region->rings[0].reader_waiting = 1;
+    m_region->rings[1].reader_waiting = 1;
+    m_ring_size = ring_size;
+    m_read_ring_idx = 1;
+    __sync_synchronize ();
+    return true;
+}
+
+bool
+SharedMemoryTransport::Open (const char *name)
+{
+    Close ();
+    if (name == NULL || name[0] == '\0')
+        return false;
+
+    const int fd = ::shm_open (name, O_RDWR, 0);
+    if (fd < 0)
+        return false;
+    m_name.assign (name);
+    // Only the side that made the region removes its name
+    m_unlinked = true;
+
+    struct stat stat_buf;
+    bool success = ::fstat (fd, &stat_buf) == 0 &&
+                   stat_buf.st_size >= (off_t)sizeof(Region) &&
+                   Map (fd, stat_buf.st_size);
+    ::close (fd);
+    if (success)
+    {
+        const uint32_t ring_size = m_region->ring_size;
+        success = m_region->magic == SHARED_MEMORY_TRANSPORT_MAGIC &&
+                  m_region->version == SHARED_MEMORY_TRANSPORT_VERSION &&
+                  ring_size != 0 && (ring_size & (ring_size - 1)) == 0 &&
+                  sizeof(Region) + 2 * (size_t)ring_size <= m_region_size;
+        m_ring_size = ring_size;
+    }
+    if (!success)
+    {
+        Close ();
+        return false;
+    }
+    m_read_ring_idx = 0;
+    return true;
+}
+
+bool
+SharedMemoryTransport::Map (int fd, size_t region_size)
+{
+    void *addr = ::mmap (NULL, region_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED)
+        return false;
+    m_region = (Region *)addr;
+    m_region_size = region_size;
+    return true;
+}
+
+void
+SharedMemoryTransport::Unlink ()
+{
+    if (!m_unlinked && !m_name.empty())
+    {
+        ::shm_unlink (m_name.c_str());
+        m_unlinked = true;
+    }
+}
+
+void
+SharedMemoryTransport::Close ()
+{
+    Unlink ();
+    if (m_region)
+    {
+        ::munmap (m_region, m_region_size);
+        m_region = NULL;
+    }
+    m_region_size = 0;
+    m_ring_size = 0;
+    m_name.clear();
+    m_unlinked = false;
+}
+
+SharedMemoryTransport::Ring &
+SharedMemoryTransport::GetReadRing ()
+{
+    return m_region->rings[m_read_ring_idx];
+}
+
+SharedMemoryTransport::Ring &
+SharedMemoryTransport::GetWriteRing ()
+{
+    return m_region->rings[m_read_ring_idx ^ 1];
+}
+
+uint8_t *
+SharedMemoryTransport::GetRingData (uint32_t ring_idx)
+{
+    return (uint8_t *)(m_region + 1) + ring_idx * m_ring_size;
+}
+
+size_t
+SharedMemoryTransport::Read (void *dst, size_t dst_len)
+{
+    if (m_region == NULL || dst_len == 0)
+        return 0;
+    Ring &ring = GetReadRing();
+    const uint32_t read_offset = ring.read_offset;
+    const uint32_t write_offset = ring.write_offset;
+    // Don't read the data before the offset that says it is there
+    __sync_synchronize ();
+    const size_t num_bytes = std::min<size_t> (dst_len, write_offset - read_offset);
+    if (num_bytes == 0)
+        return 0;
+
+    const uint8_t *data = GetRingData (m_read_ring_idx);
+    const uint32_t start = read_offset & (m_ring_size - 1);
+    const size_t first_bytes = std::min<size_t> (num_bytes, m_ring_size - start);
+    ::memcpy (dst, data + start, first_bytes);
+    ::memcpy ((uint8_t *)dst + first_bytes, data, num_bytes - first_bytes);
+
+    // Finish reading before the writer can reuse the space
+    __sync_synchronize ();
+    ring.read_offset = read_offset + num_bytes;
+    return num_bytes;
+}
+
+size_t
+SharedMemoryTransport::Write (const void *src, size_t src_len)
+{
+    if (m_region == NULL || src_len == 0)
+        return 0;
+    Ring &ring = GetWriteRing();
+    const uint32_t write_offset = ring.write_offset;
+    const uint32_t read_offset = ring.read_offset;
+    __sync_synchronize ();
+    const size_t num_bytes = std::min<size_t> (src_len, m_ring_size - (write_offset - read_offset));
+    if (num_bytes == 0)
+        return 0;
+
+    uint8_t *data = GetRingData (m_read_ring_idx ^ 1);
+    const uint32_t start = write_offset & (m_ring_size - 1);
+    const size_t first_bytes = std::min<size_t> (num_bytes, m_ring_size - start);
+    ::memcpy (data + start, src, first_bytes);
+    ::memcpy (data, (const uint8_t *)src + first_bytes, num_bytes - first_bytes);
+
+    // The data has to be there before the offset says it is
+    __sync_synchronize ();
+    ring.write_offset = write_offset + num_bytes;
+    return num_bytes;
+}
+
+bool
+SharedMemoryTransport::PrepareToWait ()
+{
+    if (m_region == NULL)
+        return false;
+    Ring &ring = GetReadRing();
+    ring.reader_waiting = 1;
+    // Either the writer sees the flag, or we see its bytes
+    __sync_synchronize ();
+    return ring.write_offset == ring.read_offset;
+}
+
+bool
+SharedMemoryTransport::ShouldWakeReader ()
+{
+    if (m_region == NULL)
+        return false;
+    Ring &ring = GetWriteRing();
+    __sync_synchronize ();
+    return __sync_bool_compare_and_swap (&ring.reader_waiting, 1, 0);
+}
@@ -0,0 +1,128 @@
+//===-- SharedMemoryTransport.h ---------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef utility_SharedMemoryTransport_h_
+#define utility_SharedMemoryTransport_h_
+
+// C Includes
+#include <stddef.h>
+#include <stdint.h>
+
+// C++ Includes
+#include <string>
+
+// Other libraries and framework includes
+// Project includes
+
+//----------------------------------------------------------------------
+// Two byte rings in one POSIX shared memory region, one for each
+// direction of a gdb-remote connection between lldb and a debugserver
+// on the same host. This code is shared by both sides.
+//
+// Each ring has a single reader and a single writer, so moving bytes
+// only takes memory barriers, no locks or system calls. The region
+// doesn't give a way to sleep until there is something to read, so
+// the connection the two sides already have is kept for that: a reader
+// that finds its ring empty says so with PrepareToWait() and blocks
+// reading the connection, and a writer that sees ShouldWakeReader()
+// return true writes a single wake up byte to it. The bytes read from
+// the connection while waiting mean nothing and are thrown away.
+//
+// The side that calls Create() is the client (lldb), the side that
+// calls Open() is the server (debugserver).
+//----------------------------------------------------------------------
+class SharedMemoryTransport
+{
+public:
+    SharedMemoryTransport ();
+
+    ~SharedMemoryTransport ();
+
+    // Make a new region with two rings of RING_SIZE bytes each, which
+    // must be a power of two. The region gets a unique name.
+    bool
+    Create (size_t ring_size);
+
+    // Map a region that the client made with Create().
+    bool
+    Open (const char *name);
+
+    // Remove the name of the region once the other side has it mapped,
+    // so it goes away with the mappings.
+    void
+    Unlink ();
+
+    void
+    Close ();
+
+    bool
+    IsValid () const
+    {
+        return m_region != NULL;
+    }
+
+    const char *
+    GetName () const
+    {
+        return m_name.c_str();
+    }
+
+    // Copy up to DST_LEN bytes out of the ring this side reads from,
+    // returns the number of bytes copied which is zero if it is empty.
+    size_t
+    Read (void *dst, size_t dst_len);
+
+    // Copy up to SRC_LEN bytes into the ring this side writes to,
+    // returns the number of bytes copied which is less than SRC_LEN
+    // if the ring is full.
+    size_t
+    Write (const void *src, size_t src_len);
+
+    // Called by a reader that found its ring empty. Returns false if
+    // bytes came in since, otherwise the reader can block until the
+    // writer wakes it up.
+    bool
+    PrepareToWait ();
+
+    // Called after Write(). Returns true if the reader of the ring is
+    // waiting and a wake up byte needs to be sent to it.
+    bool
+    ShouldWakeReader ();
+
+protected:
+    struct Ring;
+    struct Region;
+
+    Ring &
+    GetReadRing ();
+
+    Ring &
+    GetWriteRing ();
+
+    uint8_t *
+    GetRingData (uint32_t ring_idx);
+
+    bool
+    Map (int fd, size_t region_size);
+
+    std::string m_name;
+    Region *m_region;
+    size_t m_region_size;
+    uint32_t m_ring_size;
+    uint32_t m_read_ring_idx;   // The ring this side reads, the other one it writes
+    bool m_unlinked;
+
+private:
+    // Outlaw copying
+    SharedMemoryTransport (const SharedMemoryTransport &);
+    const SharedMemoryTransport &
+    operator = (const SharedMemoryTransport &);
+};
+
+#endif  // utility_SharedMemoryTransport_h_
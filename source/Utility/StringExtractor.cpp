@@ -11,8 +11,16 @@
 
 // C Includes
 #include <stdlib.h>
+#include <string.h>
+#if defined (__SSE2__)
+#include <emmintrin.h>
+#elif defined (__ARM_NEON__) || defined (__ARM_NEON)
+#include <arm_neon.h>
+#endif
 
 // C++ Includes
+#include <algorithm>
+
 // Other libraries and framework includes
 // Project includes
 
@@ -295,11 +303,174 @@ StringExtractor::GetHexMaxU64 (bool little_endian, uint64_t fail_value)
     return result;
 }
 
+// The value of each hex digit character, 0xff for anything else
+static const uint8_t g_hex_ascii_to_nibble[256] =
+{
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff
+};
+
+static const char g_nibble_to_hex_ascii[16] = { '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f' };
+
+size_t
+StringExtractor::DecodeHexBytes (const char *src, size_t dst_len, uint8_t *dst)
+{
+    size_t i = 0;
+#if defined (__SSE2__)
+    // Each 16 bit lane holds a pair of characters. A character is a
+    // digit if c - '0' is 0-9, or a letter if (c | 0x20) - 'a' is 0-5.
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i ten = _mm_set1_epi8 (10);
+    const __m128i six = _mm_set1_epi8 (6);
+    const __m128i low_byte_mask = _mm_set1_epi16 (0x00ff);
+    for (; i + 8 <= dst_len; i += 8)
+    {
+        const __m128i chars = _mm_loadu_si128 ((const __m128i *)(src + i * 2));
+        const __m128i digits = _mm_sub_epi8 (chars, _mm_set1_epi8 ('0'));
+        const __m128i letters = _mm_sub_epi8 (_mm_or_si128 (chars, _mm_set1_epi8 (0x20)), _mm_set1_epi8 ('a'));
+        const __m128i is_digit = _mm_and_si128 (_mm_cmpgt_epi8 (digits, _mm_set1_epi8 (-1)), _mm_cmplt_epi8 (digits, ten));
+        const __m128i is_letter = _mm_and_si128 (_mm_cmpgt_epi8 (letters, _mm_set1_epi8 (-1)), _mm_cmplt_epi8 (letters, six));
+        if (_mm_movemask_epi8 (_mm_or_si128 (is_digit, is_letter)) != 0xffff)
+            break;
+        const __m128i nibbles = _mm_or_si128 (_mm_and_si128 (is_digit, digits),
+                                              _mm_and_si128 (is_letter, _mm_add_epi8 (letters, ten)));
+        // The first character of each pair is the low byte of its lane
+        const __m128i bytes = _mm_or_si128 (_mm_slli_epi16 (_mm_and_si128 (nibbles, low_byte_mask), 4),
+                                            _mm_srli_epi16 (nibbles, 8));
+        _mm_storel_epi64 ((__m128i *)(dst + i), _mm_packus_epi16 (bytes, zero));
+    }
+#elif defined (__ARM_NEON__) || defined (__ARM_NEON)
+    // vld2 splits the first and second characters of the pairs apart
+    const uint8x8_t ten = vdup_n_u8 (10);
+    for (; i + 8 <= dst_len; i += 8)
+    {
+        const uint8x8x2_t chars = vld2_u8 ((const uint8_t *)(src + i * 2));
+        uint8x8_t nibbles[2];
+        uint8x8_t valid = vdup_n_u8 (0xff);
+        for (int j = 0; j < 2; ++j)
+        {
+            const uint8x8_t digits = vsub_u8 (chars.val[j], vdup_n_u8 ('0'));
+            const uint8x8_t letters = vsub_u8 (vorr_u8 (chars.val[j], vdup_n_u8 (0x20)), vdup_n_u8 ('a'));
+            const uint8x8_t is_digit = vclt_u8 (digits, ten);
+            const uint8x8_t is_letter = vclt_u8 (letters, vdup_n_u8 (6));
+            valid = vand_u8 (valid, vorr_u8 (is_digit, is_letter));
+            nibbles[j] = vbsl_u8 (is_digit, digits, vadd_u8 (letters, ten));
+        }
+        if (vget_lane_u64 (vreinterpret_u64_u8 (valid), 0) != UINT64_MAX)
+            break;
+        vst1_u8 (dst + i, vorr_u8 (vshl_n_u8 (nibbles[0], 4), nibbles[1]));
+    }
+#endif
+    for (; i < dst_len; ++i)
+    {
+        const uint8_t hi_nibble = g_hex_ascii_to_nibble[(uint8_t)src[i * 2]];
+        const uint8_t lo_nibble = g_hex_ascii_to_nibble[(uint8_t)src[i * 2 + 1]];
+        if ((hi_nibble | lo_nibble) == 0xff)
+            break;
+        dst[i] = (hi_nibble << 4) | lo_nibble;
+    }
+    return i;
+}
+
+void
+StringExtractor::EncodeHexBytes (const uint8_t *src, size_t src_len, char *dst)
+{
+    size_t i = 0;
+#if defined (__SSE2__)
+    // 'a' - '0' - 10 is added to the nibbles over 9
+    const __m128i nibble_mask = _mm_set1_epi8 (0x0f);
+    const __m128i nine = _mm_set1_epi8 (9);
+    const __m128i letter_offset = _mm_set1_epi8 ('a' - '0' - 10);
+    const __m128i ascii_zero = _mm_set1_epi8 ('0');
+    for (; i + 16 <= src_len; i += 16)
+    {
+        const __m128i bytes = _mm_loadu_si128 ((const __m128i *)(src + i));
+        const __m128i hi = _mm_and_si128 (_mm_srli_epi16 (bytes, 4), nibble_mask);
+        const __m128i lo = _mm_and_si128 (bytes, nibble_mask);
+        __m128i nibbles = _mm_unpacklo_epi8 (hi, lo);
+        __m128i chars = _mm_add_epi8 (_mm_add_epi8 (nibbles, ascii_zero), _mm_and_si128 (_mm_cmpgt_epi8 (nibbles, nine), letter_offset));
+        _mm_storeu_si128 ((__m128i *)(dst + i * 2), chars);
+        nibbles = _mm_unpackhi_epi8 (hi, lo);
+        chars = _mm_add_epi8 (_mm_add_epi8 (nibbles, ascii_zero), _mm_and_si128 (_mm_cmpgt_epi8 (nibbles, nine), letter_offset));
+        _mm_storeu_si128 ((__m128i *)(dst + i * 2 + 16), chars);
+    }
+#elif defined (__ARM_NEON__) || defined (__ARM_NEON)
+    const uint8x8_t nine = vdup_n_u8 (9);
+    const uint8x8_t letter_offset = vdup_n_u8 ('a' - '0' - 10);
+    const uint8x8_t ascii_zero = vdup_n_u8 ('0');
+    for (; i + 8 <= src_len; i += 8)
+    {
+        const uint8x8_t bytes = vld1_u8 (src + i);
+        uint8x8x2_t chars;
+        chars.val[0] = vshr_n_u8 (bytes, 4);
+        chars.val[1] = vand_u8 (bytes, vdup_n_u8 (0x0f));
+        for (int j = 0; j < 2; ++j)
+            chars.val[j] = vadd_u8 (vadd_u8 (chars.val[j], ascii_zero), vand_u8 (vcgt_u8 (chars.val[j], nine), letter_offset));
+        // vst2 interleaves the high and low nibble characters
+        vst2_u8 ((uint8_t *)(dst + i * 2), chars);
+    }
+#endif
+    for (; i < src_len; ++i)
+    {
+        dst[i * 2] = g_nibble_to_hex_ascii[src[i] >> 4];
+        dst[i * 2 + 1] = g_nibble_to_hex_ascii[src[i] & 0xf];
+    }
+}
+
+uint8_t
+StringExtractor::CalculateChecksum (const char *src, size_t src_len)
+{
+    // Only the low 8 bits of the sum are wanted, so each byte lane can
+    // add with wrap around and the lanes are added together at the end.
+    size_t i = 0;
+    uint8_t checksum = 0;
+#if defined (__SSE2__)
+    __m128i sums = _mm_setzero_si128();
+    for (; i + 16 <= src_len; i += 16)
+        sums = _mm_add_epi8 (sums, _mm_loadu_si128 ((const __m128i *)(src + i)));
+    // psadbw against zero adds up each half of the lanes
+    sums = _mm_sad_epu8 (sums, _mm_setzero_si128());
+    checksum = (uint8_t)(_mm_cvtsi128_si32 (sums) + _mm_cvtsi128_si32 (_mm_srli_si128 (sums, 8)));
+#elif defined (__ARM_NEON__) || defined (__ARM_NEON)
+    uint8x16_t sums = vdupq_n_u8 (0);
+    for (; i + 16 <= src_len; i += 16)
+        sums = vaddq_u8 (sums, vld1q_u8 ((const uint8_t *)(src + i)));
+    const uint64x2_t lane_sums = vpaddlq_u32 (vpaddlq_u16 (vpaddlq_u8 (sums)));
+    checksum = (uint8_t)(vgetq_lane_u64 (lane_sums, 0) + vgetq_lane_u64 (lane_sums, 1));
+#endif
+    for (; i < src_len; ++i)
+        checksum += (uint8_t)src[i];
+    return checksum;
+}
+
 size_t
 StringExtractor::GetHexBytes (void *dst_void, size_t dst_len, uint8_t fail_fill_value)
 {
     uint8_t *dst = (uint8_t*)dst_void;
     size_t bytes_extracted = 0;
+    if (m_index < m_packet.size())
+    {
+        const size_t num_pairs = std::min<size_t> (dst_len, (m_packet.size() - m_index) / 2);
+        bytes_extracted = DecodeHexBytes (m_packet.data() + m_index, num_pairs, dst);
+        m_index += bytes_extracted * 2;
+    }
+
+    // A bad or odd character at the end is handled one byte at a time as
+    // always, so the file position ends up the same
     while (bytes_extracted < dst_len && GetBytesLeft ())
     {
         dst[bytes_extracted] = GetHexU8 (fail_fill_value);
@@ -361,6 +532,38 @@ StringExtractor::GetHexByteString (std::string &str)
     return str.size();
 }
 
+size_t
+StringExtractor::GetEscapedBinaryData (std::string &str)
+{
+    str.clear();
+    const size_t packet_size = m_packet.size();
+    if (m_index < packet_size)
+    {
+        str.reserve (packet_size - m_index);
+        const char *packet_data = m_packet.data();
+        while (m_index < packet_size)
+        {
+            // Copy everything up to the next escape in one go
+            const char *escape = (const char *)::memchr (packet_data + m_index, '}', packet_size - m_index);
+            const size_t run_end = escape ? escape - packet_data : packet_size;
+            str.append (packet_data + m_index, run_end - m_index);
+            m_index = run_end;
+            if (escape == NULL)
+                break;
+            if (m_index + 1 >= packet_size)
+            {
+                // An escape character can't be the last byte
+                m_index = UINT32_MAX;
+                str.clear();
+                return 0;
+            }
+            str.append (1, packet_data[m_index + 1] ^ 0x20);
+            m_index += 2;
+        }
+    }
+    return str.size();
+}
+
 bool
 StringExtractor::GetNameColonValue (std::string &name, std::string &value)
 {
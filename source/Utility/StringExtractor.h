@@ -116,6 +116,36 @@ public:
     size_t
     GetHexByteString (std::string &str);
 
+    //------------------------------------------------------------------
+    // Decode up to DST_LEN bytes from the ASCII hex pairs at SRC, which
+    // must have at least DST_LEN * 2 characters. Stops at the first pair
+    // that isn't valid hex and returns the number of bytes decoded.
+    //
+    // Memory and register data move as hex, so these use SSE2 or NEON
+    // when the compiler has them, 16 characters at a time.
+    //------------------------------------------------------------------
+    static size_t
+    DecodeHexBytes (const char *src, size_t dst_len, uint8_t *dst);
+
+    //------------------------------------------------------------------
+    // Encode SRC_LEN bytes as lower case ASCII hex pairs into DST, which
+    // must have room for SRC_LEN * 2 characters (no NULL is added).
+    //------------------------------------------------------------------
+    static void
+    EncodeHexBytes (const uint8_t *src, size_t src_len, char *dst);
+
+    //------------------------------------------------------------------
+    // The GDB remote protocol checksum of SRC_LEN bytes: their sum
+    // modulo 256. Summed 16 bytes at a time with SSE2 or NEON.
+    //------------------------------------------------------------------
+    static uint8_t
+    CalculateChecksum (const char *src, size_t src_len);
+
+    // Decode the rest of the packet as GDB remote binary data where
+    // '}' escapes the following byte, which is XOR'ed with 0x20.
+    size_t
+    GetEscapedBinaryData (std::string &str);
+
     const char *
     Peek ()
     {
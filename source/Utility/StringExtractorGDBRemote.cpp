@@ -84,6 +84,7 @@ StringExtractorGDBRemote::GetServerPacketType () const
         {
         case 'E':
             if (PACKET_STARTS_WITH ("QEnvironment:"))           return eServerPacketType_QEnvironment; 
+            else if (PACKET_STARTS_WITH ("QEnableCompression:")) return eServerPacketType_QEnableCompression;
             break;
 
         case 'S':
@@ -124,6 +125,10 @@ StringExtractorGDBRemote::GetServerPacketType () const
             if (PACKET_MATCHES ("qLaunchGDBServer"))            return eServerPacketType_qLaunchGDBServer;
             if (PACKET_MATCHES ("qLaunchSuccess"))              return eServerPacketType_qLaunchSuccess;
             break;
+
+        case 'M':
+            if (PACKET_STARTS_WITH ("qModuleUUID:"))            return eServerPacketType_qModuleUUID;
+            break;
             
         case 'P':
             if (PACKET_STARTS_WITH ("qProcessInfoPID:"))        return eServerPacketType_qProcessInfoPID;
@@ -138,6 +143,13 @@ StringExtractorGDBRemote::GetServerPacketType () const
             break;
         }
         break;
+
+    case 'v':
+        if (PACKET_STARTS_WITH ("vFile:open:"))                 return eServerPacketType_vFile_open;
+        else if (PACKET_STARTS_WITH ("vFile:pread:"))           return eServerPacketType_vFile_pread;
+        else if (PACKET_STARTS_WITH ("vFile:pwrite:"))          return eServerPacketType_vFile_pwrite;
+        else if (PACKET_STARTS_WITH ("vFile:close:"))           return eServerPacketType_vFile_close;
+        break;
     }
     return eServerPacketType_unimplemented;
 }
@@ -57,13 +57,19 @@ public:
         eServerPacketType_qProcessInfoPID,
         eServerPacketType_qSpeedTest,
         eServerPacketType_qUserName,
+        eServerPacketType_qModuleUUID,
+        eServerPacketType_QEnableCompression,
         eServerPacketType_QEnvironment,
         eServerPacketType_QSetDisableASLR,
         eServerPacketType_QSetSTDIN,
         eServerPacketType_QSetSTDOUT,
         eServerPacketType_QSetSTDERR,
         eServerPacketType_QSetWorkingDir,
-        eServerPacketType_QStartNoAckMode
+        eServerPacketType_QStartNoAckMode,
+        eServerPacketType_vFile_open,
+        eServerPacketType_vFile_pread,
+        eServerPacketType_vFile_pwrite,
+        eServerPacketType_vFile_close
     };
     
     ServerPacketType
@@ -14,6 +14,7 @@
 #include "lldb/Core/Log.h"
 #include "lldb/Core/PluginManager.h"
 #include "lldb/Core/RegularExpression.h"
+#include "lldb/Core/SymbolPreloader.h"
 #include "lldb/Core/Timer.h"
 #include "lldb/Host/Host.h"
 #include "lldb/Host/Mutex.h"
@@ -36,6 +37,7 @@
 #include "Plugins/UnwindAssembly/InstEmulation/UnwindAssemblyInstEmulation.h"
 #include "Plugins/ObjectFile/PECOFF/ObjectFilePECOFF.h"
 #include "Plugins/DynamicLoader/POSIX-DYLD/DynamicLoaderPOSIXDYLD.h"
+#include "Plugins/Process/elf-core/ProcessElfCore.h"
 #ifndef LLDB_DISABLE_PYTHON
 #include "Plugins/OperatingSystem/Python/OperatingSystemPython.h"
 #endif
@@ -115,6 +117,7 @@ lldb_private::Initialize ()
         EmulateInstructionARM::Initialize ();
         ObjectFilePECOFF::Initialize ();
         DynamicLoaderPOSIXDYLD::Initialize ();
+        ProcessElfCore::Initialize ();
 #endif
 #ifndef LLDB_DISABLE_PYTHON
         OperatingSystemPython::Initialize();
@@ -178,6 +181,9 @@ lldb_private::Terminate ()
 {
     Timer scoped_timer (__PRETTY_FUNCTION__, __PRETTY_FUNCTION__);
     
+    // Stop preloading symbols before the symbol file plug-ins go away
+    SymbolPreloader::Terminate();
+
     // Terminate and unload and loaded system or user LLDB plug-ins
     PluginManager::Terminate();
 
@@ -196,6 +202,7 @@ lldb_private::Terminate ()
     EmulateInstructionARM::Terminate ();
     ObjectFilePECOFF::Terminate ();
     DynamicLoaderPOSIXDYLD::Terminate ();
+    ProcessElfCore::Terminate ();
 #endif
 #ifndef LLDB_DISABLE_PYTHON
     OperatingSystemPython::Terminate();
@@ -305,6 +312,7 @@ lldb_private::GetSectionTypeAsCString (SectionType sect_type)
     case eSectionTypeDWARFAppleTypes: return "apple-types";
     case eSectionTypeDWARFAppleNamespaces: return "apple-namespaces";
     case eSectionTypeDWARFAppleObjC: return "apple-objc";
+    case eSectionTypeDWARFDebugNames: return "dwarf-names";
     case eSectionTypeEHFrame: return "eh-frame";
     case eSectionTypeOther: return "regular";
     }
@@ -11,11 +11,22 @@ Use the following to get only the benchmark results in your terminal output:
 
     ./bench.py -e /Volumes/data/lldb/svn/regression/build/Debug/lldb -x '-F Driver::MainLoop()' 2>&1 | grep -P '^lldb.*benchmark:'
 
+The benchmarks also write their results, one JSON object per line, to the file
+given with '-r' (default: bench-results.json).  To catch regressions, keep the
+results of a good build as a baseline and compare later runs against it:
+
+    ./bench.py -r baseline.json
+    ./bench.py -c baseline.json
+
+which reports every benchmark whose median is more than '-t' percent (default:
+10) worse than the baseline, and exits with status 1 if there were any.
+
 See also bench-history.
 """
 
 import os, sys
 import re
+import json
 from optparse import OptionParser
 
 # dotest.py invocation with no '-e exe-path' uses lldb as the inferior program,
@@ -34,9 +45,63 @@ benches = [
     './dotest.py +b -n -p TestExpressionCmd.py',
 
     # Attach to a spawned process then run disassembly benchmarks.
-    './dotest.py -v +b -n %E -p TestDoAttachThenDisassembly.py'
+    './dotest.py -v +b -n %E -p TestDoAttachThenDisassembly.py',
+
+    # Measure indexing and symbolication of a generated program with 10k compile units.
+    './dotest.py +b -n -p TestIndexingSpeed.py',
+
+    # Measure stopping and backtracing a process with 2000 threads.
+    './dotest.py +b -n -p TestManyThreads.py',
+
+    # Measure memory read throughput.
+    './dotest.py +b -n -p TestMemoryReadThroughput.py',
+
+    # Measure the gdb-remote connection with several simulated link latencies.
+    './dotest.py +b -n -p TestGDBRemoteSpeed.py',
+
+    # Measure attach, stops, backtraces, variables and memory reads against a
+    # process with 5000 threads, 2000 shared libraries and 1GB of debug info.
+    './dotest.py +b -n -p TestScaleBench.py',
+
+    # Measure launching and stopping 16 processes at once from one debugger.
+    './dotest.py +b -n -p TestManyTargets.py'
 ]
 
+def read_results(path):
+    """Read a results file into a dictionary from benchmark name to result.
+    If a benchmark shows up more than once the last result wins."""
+    results = {}
+    with open(path) as f:
+        for line in f:
+            line = line.strip()
+            if line:
+                result = json.loads(line)
+                results[result['name']] = result
+    return results
+
+def compare_results(results, baseline, tolerance):
+    """Print how each result compares to the baseline and return the names of
+    the benchmarks that got more than 'tolerance' percent worse."""
+    regressions = []
+    for name in sorted(results.keys()):
+        result = results[name]
+        if name not in baseline:
+            print "%-60s %12f %-8s (new)" % (name, result['median'], result['unit'])
+            continue
+        base = baseline[name]['median']
+        if base == 0:
+            continue
+        change = (result['median'] - base) * 100.0 / base
+        # Times should go down, rates like 'MB/sec' should go up.
+        if result['unit'] != 'sec':
+            change = -change
+        regressed = change > tolerance
+        if regressed:
+            regressions.append(name)
+        print "%-60s %12f %-8s %+7.1f%%%s" % (name, result['median'], result['unit'],
+                                              change, ' REGRESSION' if regressed else '')
+    return regressions
+
 def main():
     """Read the items from 'benches' and run the command line one by one."""
     parser = OptionParser(usage="""\
@@ -51,12 +116,29 @@ Run the standard benchmarks defined in the list named 'benches'.\
                       type='string', action='store',
                       dest='break_spec',
                       help='The lldb breakpoint spec for the target program.')
+    parser.add_option('-r', '--results',
+                      type='string', action='store',
+                      dest='results', default='bench-results.json',
+                      help='The file to write the results to, one JSON object per line.')
+    parser.add_option('-c', '--compare',
+                      type='string', action='store',
+                      dest='baseline',
+                      help='A results file from an earlier run to compare against.')
+    parser.add_option('-t', '--tolerance',
+                      type='float', action='store',
+                      dest='tolerance', default=10.0,
+                      help='How many percent worse than the baseline a benchmark can get before it is a regression.')
 
     # Parses the options, if any.
     opts, args = parser.parse_args()
                           
     print "Starting bench runner...."
 
+    results_file = os.path.abspath(opts.results)
+    if os.path.exists(results_file):
+        os.remove(results_file)
+    os.environ["LLDB_BENCH_RESULTS"] = results_file
+
     for item in benches:
         command = item.replace('%E',
                                '-e "%s"' % opts.exe if opts.exe else '')
@@ -67,5 +149,17 @@ Run the standard benchmarks defined in the list named 'benches'.\
 
     print "Bench runner done."
 
+    if opts.baseline:
+        if not os.path.exists(results_file):
+            print "No benchmark results were written to %s." % results_file
+            sys.exit(1)
+        print "Comparing %s against %s:" % (results_file, opts.baseline)
+        regressions = compare_results(read_results(results_file),
+                                      read_results(opts.baseline),
+                                      opts.tolerance)
+        if regressions:
+            print "%d benchmarks regressed by more than %.1f%%." % (len(regressions), opts.tolerance)
+            sys.exit(1)
+
 if __name__ == '__main__':
     main()
@@ -27,7 +27,7 @@ class AttachThenDisassemblyBench(BenchBase):
         """Attach to a spawned lldb process then run disassembly benchmarks."""
         print
         self.run_lldb_attach_then_disassembly(self.exe, self.count)
-        print "lldb disassembly benchmark:", self.stopwatch
+        self.recordBenchmark("lldb disassembly", self.stopwatch)
 
     def run_lldb_attach_then_disassembly(self, exe, count):
         target = self.dbg.CreateTarget(exe)
@@ -26,7 +26,7 @@ class ExpressionEvaluationCase(BenchBase):
 
         print
         self.run_lldb_repeated_exprs(self.exe_name, self.count)
-        print "lldb expr cmd benchmark:", self.stopwatch
+        self.recordBenchmark("lldb expr cmd", self.stopwatch)
 
     def run_lldb_repeated_exprs(self, exe_name, count):
         exe = os.path.join(os.getcwd(), exe_name)
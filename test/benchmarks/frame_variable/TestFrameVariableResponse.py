@@ -30,7 +30,7 @@ class FrameVariableResponseBench(BenchBase):
         """Test response time for the 'frame variable' command."""
         print
         self.run_frame_variable_bench(self.exe, self.break_spec, self.count)
-        print "lldb frame variable benchmark:", self.stopwatch
+        self.recordBenchmark("lldb frame variable", self.stopwatch)
 
     def run_frame_variable_bench(self, exe, break_spec, count):
         # Set self.child_prompt, which is "(lldb) ".
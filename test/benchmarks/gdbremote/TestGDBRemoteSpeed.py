@@ -0,0 +1,89 @@
+"""Test the speed of the gdb-remote connection, with and without simulated network latency."""
+
+import os, sys
+import unittest2
+import lldb
+import pexpect
+from lldbbench import *
+
+class GDBRemoteSpeedBench(BenchBase):
+
+    mydir = os.path.join("benchmarks", "gdbremote")
+
+    def setUp(self):
+        BenchBase.setUp(self)
+        self.source = 'main.cpp'
+        self.line_to_break = line_number(self.source, '// Set breakpoint here.')
+        self.count = lldb.bmIterationCount
+        if self.count <= 0:
+            self.count = 20
+        # No added latency, a fast local network, and a device across a WAN.
+        self.latencies_usec = [0, 1000, 50000]
+
+    @unittest2.skipUnless(sys.platform.startswith("darwin"), "requires the gdb-remote process plug-in")
+    @benchmarks_test
+    def test_gdb_remote_speed(self):
+        """Test packet, memory read, register fetch and stop-to-prompt speeds at several link latencies."""
+        self.buildDefault()
+        exe = os.path.join(os.getcwd(), 'a.out')
+        print
+        for latency_usec in self.latencies_usec:
+            self.run_lldb_gdb_remote_speed(exe, latency_usec, self.count)
+            self.recordBenchmark("lldb stepi stop-to-prompt (%u usec latency)" % latency_usec, self.stopwatch)
+
+    def run_lldb_gdb_remote_speed(self, exe, latency_usec, count):
+        # Set self.child_prompt, which is "(lldb) ".
+        self.child_prompt = '(lldb) '
+        prompt = self.child_prompt
+
+        # So that the child gets torn down after the test.
+        self.child = pexpect.spawn('%s %s %s' % (self.lldbHere, self.lldbOption, exe))
+        child = self.child
+
+        # Turn on logging for what the child sends back.
+        if self.TraceOn():
+            child.logfile_read = sys.stdout
+
+        child.expect_exact(prompt)
+        child.sendline('settings set process.simulated-link-latency %u' % latency_usec)
+        child.expect_exact(prompt)
+        child.sendline('breakpoint set -f %s -l %d' % (self.source, self.line_to_break))
+        child.expect_exact(prompt)
+        child.sendline('run')
+        child.expect_exact(prompt, timeout=300)
+
+        # The plug-in benchmarks print their own results.
+        child.sendline('process plugin benchmark packets --count %u' % count)
+        child.expect_exact(prompt, timeout=600)
+        child.sendline('process plugin benchmark register-read --count %u' % count)
+        child.expect_exact(prompt, timeout=600)
+        child.sendline('expr buffer')
+        child.expect('= (0x[0-9a-fA-F]+)')
+        buffer_addr = child.match.group(1)
+        child.expect_exact(prompt)
+        child.sendline('process plugin benchmark memory-read --count %u --address %s' % (count, buffer_addr))
+        child.expect_exact(prompt, timeout=600)
+
+        # Reset the stopwatch now.
+        self.stopwatch.reset()
+        for i in range(count):
+            with self.stopwatch:
+                child.sendline('thread step-inst')
+                child.expect_exact(prompt, timeout=300)
+
+        child.sendline('process kill')
+        child.expect_exact(prompt, timeout=300)
+        child.sendline('quit')
+        try:
+            self.child.expect(pexpect.EOF)
+        except:
+            pass
+
+        self.child = None
+
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
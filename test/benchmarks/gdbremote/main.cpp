@@ -0,0 +1,27 @@
+//===-- main.cpp ------------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+#include <stdio.h>
+#include <stdlib.h>
+
+// Enough memory for the largest memory-read benchmark size
+const size_t g_buffer_size = 1024 * 1024;
+
+int
+main (int argc, char const *argv[])
+{
+    unsigned char *buffer = (unsigned char *)malloc (g_buffer_size);
+    int total = 0;
+    for (size_t i = 0; i < g_buffer_size; ++i)
+        buffer[i] = (unsigned char)i;
+    printf ("buffer = %p\n", buffer); // Set breakpoint here.
+    for (int i = 0; i < 1000000; ++i)
+        total += buffer[i % g_buffer_size];
+    free (buffer);
+    return total;
+}
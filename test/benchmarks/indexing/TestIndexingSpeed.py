@@ -0,0 +1,104 @@
+"""Test how long lldb takes to index and symbolicate a program with a lot of debug info."""
+
+import os, sys
+import unittest2
+import lldb
+import pexpect
+from lldbbench import *
+
+class IndexingSpeedBench(BenchBase):
+
+    mydir = os.path.join("benchmarks", "indexing")
+
+    def setUp(self):
+        BenchBase.setUp(self)
+        self.count = lldb.bmIterationCount
+        if self.count <= 0:
+            self.count = 5
+        # 10k compile units, each instantiating a template 16 levels deep.
+        self.num_cus = 10000
+        self.template_depth = 16
+
+    def build_synthetic_program(self):
+        generated = writeSyntheticSources(os.getcwd(), self.num_cus, self.template_depth)
+        def remove_generated():
+            for path in generated:
+                if os.path.exists(path):
+                    os.remove(path)
+        self.addTearDownHook(remove_generated)
+        self.buildDefault()
+        return os.path.join(os.getcwd(), 'a.out')
+
+    @benchmarks_test
+    def test_indexing(self):
+        """Test the time a fresh lldb takes to set a breakpoint by name in a program with 10k compile units."""
+        exe = self.build_synthetic_program()
+        print
+        self.run_lldb_indexing(exe, self.count)
+        self.recordBenchmark("lldb dwarf indexing (%d CUs)" % self.num_cus, self.stopwatch)
+
+    @benchmarks_test
+    def test_symbolication(self):
+        """Test how fast lldb resolves the address of every function in a program with 10k compile units."""
+        exe = self.build_synthetic_program()
+        print
+        self.run_lldb_symbolication(exe, self.count)
+        self.recordBenchmark("lldb symbolication (%d addresses)" % self.num_cus, self.stopwatch)
+
+    def run_lldb_indexing(self, exe, count):
+        # Set self.child_prompt, which is "(lldb) ".
+        self.child_prompt = '(lldb) '
+        prompt = self.child_prompt
+
+        # Reset the stopwatch now.
+        self.stopwatch.reset()
+        for i in range(count):
+            # Every lap needs a new lldb, a module is only indexed once.
+            self.child = pexpect.spawn('%s %s %s' % (self.lldbHere, self.lldbOption, exe))
+            child = self.child
+
+            # Turn on logging for what the child sends back.
+            if self.TraceOn():
+                child.logfile_read = sys.stdout
+
+            child.expect_exact(prompt)
+            with self.stopwatch:
+                # Looking up a function by name indexes the DWARF of every compile unit.
+                child.sendline('breakpoint set -n function%d' % (self.num_cus - 1))
+                child.expect_exact(prompt)
+
+            child.sendline('quit')
+            try:
+                self.child.expect(pexpect.EOF)
+            except:
+                pass
+
+        self.child = None
+
+    def run_lldb_symbolication(self, exe, count):
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+        module = target.GetModuleAtIndex(0)
+
+        # Gather the addresses of the functions in each compile unit.
+        addresses = []
+        for i in range(module.GetNumSymbols()):
+            symbol = module.GetSymbolAtIndex(i)
+            if symbol.GetType() == lldb.eSymbolTypeCode and 'function' in symbol.GetName():
+                addresses.append(symbol.GetStartAddress())
+        self.assertTrue(len(addresses) >= self.num_cus)
+
+        # Reset the stopwatch now.  The first lap includes parsing the line
+        # tables and functions, the rest show the cost with everything cached.
+        self.stopwatch.reset()
+        for i in range(count):
+            with self.stopwatch:
+                for address in addresses:
+                    target.ResolveSymbolContextForAddress(address, lldb.eSymbolContextEverything)
+
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
@@ -0,0 +1,70 @@
+"""Test how many bytes a second lldb reads from the memory of a process."""
+
+import os, sys
+import unittest2
+import lldb
+from lldbbench import *
+
+class MemoryReadThroughputBench(BenchBase):
+
+    mydir = os.path.join("benchmarks", "memory")
+
+    def setUp(self):
+        BenchBase.setUp(self)
+        self.source = 'main.cpp'
+        self.line_to_break = line_number(self.source, '// Set breakpoint here.')
+        self.count = lldb.bmIterationCount
+        if self.count <= 0:
+            self.count = 10
+
+    @benchmarks_test
+    def test_memory_read_throughput(self):
+        """Test reading memory in large and small pieces with SBProcess.ReadMemory()."""
+        self.buildDefault()
+        print
+        self.run_lldb_memory_reads(os.path.join(os.getcwd(), 'a.out'), self.count)
+
+    def run_lldb_memory_reads(self, exe, count):
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+        breakpoint = target.BreakpointCreateByLocation(self.source, self.line_to_break)
+        self.assertTrue(breakpoint, VALID_BREAKPOINT)
+        process = target.LaunchSimple(None, None, os.getcwd())
+        self.assertTrue(process, PROCESS_IS_VALID)
+
+        frame = process.GetSelectedThread().GetFrameAtIndex(0)
+        buffer_addr = frame.FindVariable('buffer').GetValueAsUnsigned()
+        buffer_size = frame.EvaluateExpression('g_buffer_size').GetValueAsUnsigned()
+        self.assertTrue(buffer_addr != 0 and buffer_size != 0)
+
+        # One big read, which shows the raw transfer speed.
+        error = lldb.SBError()
+        self.stopwatch.reset()
+        for i in range(count):
+            with self.stopwatch:
+                content = process.ReadMemory(buffer_addr, buffer_size, error)
+            self.assertTrue(error.Success() and len(content) == buffer_size)
+        self.recordRate("lldb memory read throughput (16MB reads)", buffer_size / (1024.0 * 1024.0), self.stopwatch, 'MB/sec')
+
+        # Many small reads, like reading variables and stacks does.  Each lap
+        # reads a different megabyte of the buffer, so the memory cache of
+        # the process doesn't already hold what it reads.
+        read_size = 256
+        num_reads = 4096
+        lap_size = read_size * num_reads
+        self.stopwatch.reset()
+        for i in range(count):
+            lap_addr = buffer_addr + (i * lap_size) % buffer_size
+            with self.stopwatch:
+                for j in range(num_reads):
+                    process.ReadMemory(lap_addr + j * read_size, read_size, error)
+        self.recordRate("lldb memory read throughput (%d byte reads)" % read_size, num_reads * read_size / (1024.0 * 1024.0), self.stopwatch, 'MB/sec')
+
+        process.Kill()
+
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
@@ -0,0 +1,24 @@
+//===-- main.cpp ------------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+#include <stdio.h>
+#include <stdlib.h>
+
+// 16MB for the benchmark to read
+const size_t g_buffer_size = 16 * 1024 * 1024;
+
+int
+main (int argc, char const *argv[])
+{
+    unsigned char *buffer = (unsigned char *)malloc (g_buffer_size);
+    for (size_t i = 0; i < g_buffer_size; ++i)
+        buffer[i] = (unsigned char)i;
+    printf ("buffer = %p\n", buffer); // Set breakpoint here.
+    free (buffer);
+    return 0;
+}
@@ -0,0 +1,197 @@
+"""Test how lldb performs against a process as big as the ones we debug in
+production: thousands of threads and shared libraries, a lot of debug info,
+huge STL containers and a deep stack."""
+
+import os, sys, time
+import unittest2
+import lldb
+import pexpect
+from lldbbench import *
+
+class ScaleBench(BenchBase):
+
+    mydir = os.path.join("benchmarks", "scale")
+
+    def setUp(self):
+        BenchBase.setUp(self)
+        self.source = 'main.cpp'
+        self.line_to_break = line_number(self.source, '// Set breakpoint here.')
+        self.count = lldb.bmIterationCount
+        if self.count <= 0:
+            self.count = 5
+        self.num_threads = 5000
+        self.num_libraries = 2000
+        self.num_elements = 10000000
+        self.recursion_depth = 10000
+        # 20k compile units, each instantiating a template 32 levels deep,
+        # which makes on the order of 1GB of debug info.
+        self.num_cus = 20000
+        self.template_depth = 32
+
+    def build_scale_program(self):
+        generated = writeSyntheticSources(os.getcwd(), self.num_cus, self.template_depth, 'call_compile_units')
+        generated += writeSyntheticLibraries(os.getcwd(), self.num_libraries, 'call_libraries')
+        def remove_generated():
+            for path in generated:
+                if os.path.exists(path):
+                    os.remove(path)
+        self.addTearDownHook(remove_generated)
+        self.buildDefault()
+        return os.path.join(os.getcwd(), 'a.out')
+
+    def program_args(self):
+        return [str(self.num_threads), str(self.num_elements), str(self.recursion_depth)]
+
+    @benchmarks_test
+    def test_attach(self):
+        """Test attaching to and detaching from a process with 5000 threads and 2000 shared libraries."""
+        exe = self.build_scale_program()
+        print
+        self.run_lldb_attach(exe, self.count)
+        self.recordBenchmark("lldb attach (%d threads, %d libraries)" % (self.num_threads, self.num_libraries), self.stopwatch)
+
+    @benchmarks_test
+    def test_stop_latency(self):
+        """Test continuing to a breakpoint, backtracing all threads and showing huge containers."""
+        exe = self.build_scale_program()
+        print
+        self.run_lldb_stops(exe, self.count)
+        self.recordBenchmark("lldb continue to breakpoint (%d threads)" % self.num_threads, self.stopwatch)
+        self.recordBenchmark("lldb backtrace all (%d threads, %d deep)" % (self.num_threads, self.recursion_depth), self.stopwatch2)
+        self.recordBenchmark("lldb frame variable (%d elements)" % self.num_elements, self.stopwatch3)
+
+    @benchmarks_test
+    def test_memory_read_throughput(self):
+        """Test reading memory with SBProcess.ReadMemory() from a process with a large memory map."""
+        exe = self.build_scale_program()
+        print
+        self.run_lldb_memory_reads(exe, self.count)
+
+    def run_lldb_attach(self, exe, count):
+        # Spawn the process and give it time to create its threads and
+        # fill its containers before we attach.
+        import subprocess
+        popen = subprocess.Popen([exe] + self.program_args(),
+                                 stdout = open(os.devnull, 'w') if not self.TraceOn() else None)
+        self.addTearDownHook(lambda: popen.kill())
+        time.sleep(30)
+
+        # Set self.child_prompt, which is "(lldb) ".
+        self.child_prompt = '(lldb) '
+        prompt = self.child_prompt
+
+        # So that the child gets torn down after the test.
+        self.child = pexpect.spawn('%s %s' % (self.lldbHere, self.lldbOption))
+        child = self.child
+
+        # Turn on logging for what the child sends back.
+        if self.TraceOn():
+            child.logfile_read = sys.stdout
+
+        child.expect_exact(prompt)
+
+        # Reset the stopwatch now.  Each lap attaches and then detaches
+        # so the next lap attaches to a running process again.
+        self.stopwatch.reset()
+        for i in range(count):
+            with self.stopwatch:
+                child.sendline('process attach -p %d' % popen.pid)
+                child.expect_exact(prompt, timeout=600)
+            child.sendline('process detach')
+            child.expect_exact(prompt, timeout=600)
+
+        child.sendline('quit')
+        try:
+            self.child.expect(pexpect.EOF)
+        except:
+            pass
+
+        self.child = None
+
+    def run_lldb_stops(self, exe, count):
+        # Set self.child_prompt, which is "(lldb) ".
+        self.child_prompt = '(lldb) '
+        prompt = self.child_prompt
+
+        # So that the child gets torn down after the test.
+        self.child = pexpect.spawn('%s %s %s' % (self.lldbHere, self.lldbOption, exe))
+        child = self.child
+
+        # Turn on logging for what the child sends back.
+        if self.TraceOn():
+            child.logfile_read = sys.stdout
+
+        child.expect_exact(prompt)
+        child.sendline('breakpoint set -f %s -l %d' % (self.source, self.line_to_break))
+        child.expect_exact(prompt)
+        child.sendline('process launch -- %s' % ' '.join(self.program_args()))
+        child.expect_exact(prompt, timeout=600)
+
+        # Reset the stopwatches now.
+        self.stopwatch.reset()
+        self.stopwatch2 = Stopwatch()
+        self.stopwatch3 = Stopwatch()
+        for i in range(count):
+            with self.stopwatch:
+                child.sendline('process continue')
+                child.expect_exact(prompt, timeout=600)
+            with self.stopwatch2:
+                child.sendline('thread backtrace all')
+                child.expect_exact(prompt, timeout=600)
+            with self.stopwatch3:
+                child.sendline('frame variable')
+                child.expect_exact(prompt, timeout=600)
+
+        child.sendline('process kill')
+        child.expect_exact(prompt, timeout=600)
+        child.sendline('quit')
+        try:
+            self.child.expect(pexpect.EOF)
+        except:
+            pass
+
+        self.child = None
+
+    def run_lldb_memory_reads(self, exe, count):
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+        breakpoint = target.BreakpointCreateByLocation(self.source, self.line_to_break)
+        self.assertTrue(breakpoint, VALID_BREAKPOINT)
+        process = target.LaunchSimple(self.program_args(), None, os.getcwd())
+        self.assertTrue(process, PROCESS_IS_VALID)
+
+        buffer_addr = target.FindFirstGlobalVariable('g_buffer').GetValueAsUnsigned()
+        buffer_size = target.FindFirstGlobalVariable('g_buffer_size').GetValueAsUnsigned()
+        self.assertTrue(buffer_addr != 0 and buffer_size != 0)
+
+        # One big read, which shows the raw transfer speed.
+        error = lldb.SBError()
+        self.stopwatch.reset()
+        for i in range(count):
+            with self.stopwatch:
+                content = process.ReadMemory(buffer_addr, buffer_size, error)
+            self.assertTrue(error.Success() and len(content) == buffer_size)
+        self.recordRate("lldb memory read throughput (64MB reads, %d threads)" % self.num_threads, buffer_size / (1024.0 * 1024.0), self.stopwatch, 'MB/sec')
+
+        # Many small reads, like showing variables does.  Each lap reads a
+        # different megabyte of the buffer, so the memory cache of the
+        # process doesn't already hold what it reads.
+        read_size = 256
+        num_reads = 4096
+        lap_size = read_size * num_reads
+        self.stopwatch.reset()
+        for i in range(count):
+            lap_addr = buffer_addr + (i * lap_size) % buffer_size
+            with self.stopwatch:
+                for j in range(num_reads):
+                    process.ReadMemory(lap_addr + j * read_size, read_size, error)
+        self.recordRate("lldb memory read throughput (%d byte reads, %d threads)" % (read_size, self.num_threads), num_reads * read_size / (1024.0 * 1024.0), self.stopwatch, 'MB/sec')
+
+        process.Kill()
+
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
@@ -0,0 +1,97 @@
+//===-- main.cpp ------------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+// C includes
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+// C++ includes
+#include <list>
+#include <map>
+#include <vector>
+
+// Written by TestScaleBench.py
+int call_compile_units (int arg);
+int call_libraries (int arg);
+
+pthread_mutex_t g_mutex = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t g_cond = PTHREAD_COND_INITIALIZER;
+int g_done = 0;
+
+size_t g_buffer_size = 64 * 1024 * 1024;
+char *g_buffer = NULL;
+
+void *
+thread_func (void *arg)
+{
+    // Wait forever, the benchmark kills the process.
+    pthread_mutex_lock (&g_mutex);
+    while (!g_done)
+        pthread_cond_wait (&g_cond, &g_mutex);
+    pthread_mutex_unlock (&g_mutex);
+    return NULL;
+}
+
+int
+stop_here (int i, std::vector<int> &vector, std::list<int> &list, std::map<int, int> &map)
+{
+    return i + vector.size() + list.size() + map.size(); // Set breakpoint here.
+}
+
+int
+recurse (int depth, std::vector<int> &vector, std::list<int> &list, std::map<int, int> &map)
+{
+    if (depth > 0)
+        return recurse (depth - 1, vector, list, map) + 1;
+
+    // Keep stopping at the bottom of the recursion until we are killed.
+    int total = 0;
+    for (int i = 0; ; ++i)
+        total += stop_here (i, vector, list, map);
+    return total;
+}
+
+int
+main (int argc, char const *argv[])
+{
+    int num_threads = 5000;
+    int num_elements = 10000000;
+    int recursion_depth = 10000;
+    if (argc > 1)
+        num_threads = atoi (argv[1]);
+    if (argc > 2)
+        num_elements = atoi (argv[2]);
+    if (argc > 3)
+        recursion_depth = atoi (argv[3]);
+
+    // Touch every page of the buffer so memory reads don't fault it in.
+    g_buffer = (char *)malloc (g_buffer_size);
+    memset (g_buffer, 0x55, g_buffer_size);
+
+    std::vector<int> vector;
+    std::list<int> list;
+    std::map<int, int> map;
+    for (int i = 0; i < num_elements; ++i)
+    {
+        vector.push_back (i);
+        list.push_back (i);
+        map[i] = i;
+    }
+
+    for (int i = 0; i < num_threads; ++i)
+    {
+        pthread_t thread;
+        if (pthread_create (&thread, NULL, thread_func, NULL) != 0)
+            break;
+    }
+
+    int total = call_compile_units (argc) + call_libraries (argc);
+    return recurse (recursion_depth, vector, list, map) + total;
+}
@@ -35,9 +35,9 @@ class StartupDelaysBench(BenchBase):
         """Test start up delays creating a target, setting a breakpoint, and run to breakpoint stop."""
         print
         self.run_startup_delays_bench(self.exe, self.break_spec, self.count)
-        print "lldb startup delay (create fresh target) benchmark:", self.stopwatch
-        print "lldb startup delay (set first breakpoint) benchmark:", self.stopwatch2
-        print "lldb startup delay (run to breakpoint) benchmark:", self.stopwatch3
+        self.recordBenchmark("lldb startup delay (create fresh target)", self.stopwatch)
+        self.recordBenchmark("lldb startup delay (set first breakpoint)", self.stopwatch2)
+        self.recordBenchmark("lldb startup delay (run to breakpoint)", self.stopwatch3)
 
     def run_startup_delays_bench(self, exe, break_spec, count):
         # Set self.child_prompt, which is "(lldb) ".
@@ -33,7 +33,7 @@ class SteppingSpeedBench(BenchBase):
         """Test lldb steppings on a large executable."""
         print
         self.run_lldb_steppings(self.exe, self.break_spec, self.count)
-        print "lldb stepping benchmark:", self.stopwatch
+        self.recordBenchmark("lldb stepping", self.stopwatch)
 
     def run_lldb_steppings(self, exe, break_spec, count):
         # Set self.child_prompt, which is "(lldb) ".
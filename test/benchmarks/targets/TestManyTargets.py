@@ -0,0 +1,106 @@
+"""Test how well lldb scales when one SBDebugger debugs many processes at the
+same time, each from its own thread."""
+
+import os, sys
+import threading
+import unittest2
+import lldb
+from lldbbench import *
+
+class ManyTargetsBench(BenchBase):
+
+    mydir = os.path.join("benchmarks", "targets")
+
+    def setUp(self):
+        BenchBase.setUp(self)
+        self.source = 'main.cpp'
+        self.line_to_break = line_number(self.source, '// Set breakpoint here.')
+        self.count = lldb.bmIterationCount
+        if self.count <= 0:
+            self.count = 50
+        self.num_targets = 16
+
+    @benchmarks_test
+    def test_many_targets(self):
+        """Test creating, launching and stopping 1 and then 16 targets concurrently."""
+        self.buildDefault()
+        exe = os.path.join(os.getcwd(), 'a.out')
+        print
+        # Compare against a single target so the results show how close to
+        # linear N independent targets scale.
+        for num_targets in (1, self.num_targets):
+            self.run_lldb_many_targets(exe, num_targets, self.count)
+
+    def run_in_threads(self, num_threads, func):
+        """Run func(index) on num_threads threads at once and fail the test
+        if any of them raised."""
+        errors = []
+        def run(index):
+            try:
+                func(index)
+            except Exception, e:
+                errors.append(e)
+        threads = [threading.Thread(target=run, args=(i,)) for i in range(num_threads)]
+        for thread in threads:
+            thread.start()
+        for thread in threads:
+            thread.join()
+        if errors:
+            raise errors[0]
+
+    def run_lldb_many_targets(self, exe, num_targets, count):
+        targets = [None] * num_targets
+        processes = [None] * num_targets
+
+        # Every thread creates its own target from the same executable and
+        # launches it, which goes through the shared module list and the
+        # plug-in lookups at the same time.
+        def launch(index):
+            target = self.dbg.CreateTarget(exe)
+            self.assertTrue(target, VALID_TARGET)
+            breakpoint = target.BreakpointCreateByLocation(self.source, self.line_to_break)
+            self.assertTrue(breakpoint, VALID_BREAKPOINT)
+            process = target.LaunchSimple(None, None, os.getcwd())
+            self.assertTrue(process, PROCESS_IS_VALID)
+            targets[index] = target
+            processes[index] = process
+
+        self.stopwatch.reset()
+        with self.stopwatch:
+            self.run_in_threads(num_targets, launch)
+        self.recordBenchmark("lldb create and launch (%d targets)" % num_targets, self.stopwatch)
+
+        # Each lap, every thread continues its own process to the breakpoint,
+        # walks the stack, reads the locals and some memory, like a session
+        # driven through the SB API would.
+        def stop(index):
+            process = processes[index]
+            error = lldb.SBError()
+            buffer_addr = targets[index].FindFirstGlobalVariable('g_buffer').GetLoadAddress()
+            for i in range(count):
+                process.Continue()
+                thread = process.GetSelectedThread()
+                for frame in thread:
+                    frame.GetFunctionName()
+                    for value in frame.GetVariables(True, True, False, True):
+                        value.GetValue()
+                process.ReadMemory(buffer_addr, 4096, error)
+
+        stopwatch = Stopwatch()
+        with stopwatch:
+            self.run_in_threads(num_targets, stop)
+        self.recordRate("lldb stops per second (%d targets)" % num_targets, num_targets * count, stopwatch, 'stops/sec')
+
+        for process in processes:
+            if process:
+                process.Kill()
+        for target in targets:
+            if target:
+                self.dbg.DeleteTarget(target)
+
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
@@ -0,0 +1,45 @@
+//===-- main.cpp ------------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+// C includes
+#include <string.h>
+
+// C++ includes
+#include <map>
+#include <string>
+#include <vector>
+
+char g_buffer[1024 * 1024];
+
+int
+stop_here (int i, std::vector<int> &vector, std::map<int, std::string> &map)
+{
+    g_buffer[i % sizeof(g_buffer)] = i;
+    return i + vector.size() + map.size(); // Set breakpoint here.
+}
+
+int
+main (int argc, char const *argv[])
+{
+    memset (g_buffer, 0x55, sizeof(g_buffer));
+
+    std::vector<int> vector;
+    std::map<int, std::string> map;
+    for (int i = 0; i < 100; ++i)
+    {
+        vector.push_back (i);
+        map[i] = "value";
+    }
+
+    // Keep stopping until we are killed.
+    int total = 0;
+    for (int i = 0; ; ++i)
+        total += stop_here (i, vector, map);
+    return total;
+}
@@ -0,0 +1,76 @@
+"""Test how fast lldb stops and walks the threads of a process with 2000 threads."""
+
+import os, sys
+import unittest2
+import lldb
+import pexpect
+from lldbbench import *
+
+class ManyThreadsBench(BenchBase):
+
+    mydir = os.path.join("benchmarks", "threads")
+
+    def setUp(self):
+        BenchBase.setUp(self)
+        self.source = 'main.cpp'
+        self.line_to_break = line_number(self.source, '// Set breakpoint here.')
+        self.num_threads = 2000
+        self.count = lldb.bmIterationCount
+        if self.count <= 0:
+            self.count = 20
+
+    @benchmarks_test
+    def test_run_lldb_many_threads(self):
+        """Test continuing to a breakpoint and backtracing all threads with 2000 threads."""
+        self.buildDefault()
+        print
+        self.run_lldb_many_threads(os.path.join(os.getcwd(), 'a.out'), self.count)
+        self.recordBenchmark("lldb continue to breakpoint (%d threads)" % self.num_threads, self.stopwatch)
+        self.recordBenchmark("lldb backtrace all (%d threads)" % self.num_threads, self.stopwatch2)
+
+    def run_lldb_many_threads(self, exe, count):
+        # Set self.child_prompt, which is "(lldb) ".
+        self.child_prompt = '(lldb) '
+        prompt = self.child_prompt
+
+        # So that the child gets torn down after the test.
+        self.child = pexpect.spawn('%s %s %s' % (self.lldbHere, self.lldbOption, exe))
+        child = self.child
+
+        # Turn on logging for what the child sends back.
+        if self.TraceOn():
+            child.logfile_read = sys.stdout
+
+        child.expect_exact(prompt)
+        child.sendline('breakpoint set -f %s -l %d' % (self.source, self.line_to_break))
+        child.expect_exact(prompt)
+        child.sendline('run')
+        child.expect_exact(prompt, timeout=300)
+
+        # Reset the stopwatches now.
+        self.stopwatch.reset()
+        self.stopwatch2 = Stopwatch()
+        for i in range(count):
+            with self.stopwatch:
+                child.sendline('process continue')
+                child.expect_exact(prompt, timeout=300)
+            with self.stopwatch2:
+                child.sendline('thread backtrace all')
+                child.expect_exact(prompt, timeout=300)
+
+        child.sendline('process kill')
+        child.expect_exact(prompt, timeout=300)
+        child.sendline('quit')
+        try:
+            self.child.expect(pexpect.EOF)
+        except:
+            pass
+
+        self.child = None
+
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
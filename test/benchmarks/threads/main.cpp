@@ -0,0 +1,68 @@
+//===-- main.cpp ------------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+// C includes
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+pthread_mutex_t g_mutex = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t g_cond = PTHREAD_COND_INITIALIZER;
+int g_done = 0;
+
+void *
+thread_func (void *arg)
+{
+    // Wait until main is done being stopped in.
+    pthread_mutex_lock (&g_mutex);
+    while (!g_done)
+        pthread_cond_wait (&g_cond, &g_mutex);
+    pthread_mutex_unlock (&g_mutex);
+    return NULL;
+}
+
+int
+stop_here (int i)
+{
+    return i + 1; // Set breakpoint here.
+}
+
+int
+main (int argc, char const *argv[])
+{
+    int num_threads = 2000;
+    int num_stops = 1000;
+    if (argc > 1)
+        num_threads = atoi (argv[1]);
+
+    pthread_t *threads = new pthread_t[num_threads];
+    for (int i = 0; i < num_threads; ++i)
+    {
+        if (pthread_create (&threads[i], NULL, thread_func, NULL) != 0)
+        {
+            num_threads = i;
+            break;
+        }
+    }
+
+    int total = 0;
+    for (int i = 0; i < num_stops; ++i)
+        total += stop_here (i);
+
+    pthread_mutex_lock (&g_mutex);
+    g_done = 1;
+    pthread_cond_broadcast (&g_cond);
+    pthread_mutex_unlock (&g_mutex);
+
+    for (int i = 0; i < num_threads; ++i)
+        pthread_join (threads[i], NULL);
+    delete [] threads;
+    printf ("%d threads, total = %d\n", num_threads, total);
+    return 0;
+}
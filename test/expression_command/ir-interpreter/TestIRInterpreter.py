@@ -0,0 +1,113 @@
+"""
+Test that expressions the IR interpreter can handle are evaluated in
+the debugger, without running any code in the inferior, and give the
+same answers the JIT would.
+"""
+
+import os, time
+import unittest2
+import lldb
+import lldbutil
+from lldbtest import *
+
+class IRInterpreterTestCase(TestBase):
+
+    mydir = os.path.join("expression_command", "ir-interpreter")
+
+    @unittest2.skipUnless(sys.platform.startswith("darwin"), "requires Darwin")
+    @dsym_test
+    def test_with_dsym(self):
+        """Test expressions that the IR interpreter evaluates."""
+        self.buildDsym()
+        self.ir_interpreter()
+
+    @dwarf_test
+    def test_with_dwarf(self):
+        """Test expressions that the IR interpreter evaluates."""
+        self.buildDwarf()
+        self.ir_interpreter()
+
+    def setUp(self):
+        # Call super's setUp().
+        TestBase.setUp(self)
+        # Find the line number to break for main.c.
+        self.line = line_number('main.c', '// Evaluate expressions here.')
+
+    def ir_interpreter(self):
+        """Test expressions that the IR interpreter evaluates."""
+        exe = os.path.join(os.getcwd(), "a.out")
+        self.runCmd("file " + exe, CURRENT_EXECUTABLE_SET)
+
+        self.expect("breakpoint set -f main.c -l %d" % self.line,
+                    BREAKPOINT_CREATED,
+            startstr = "Breakpoint created: 1: file ='main.c', line = %d" %
+                        self.line)
+
+        self.runCmd("run", RUN_SUCCEEDED)
+
+        frame = lldbutil.get_stopped_thread(self.dbg.GetSelectedTarget().GetProcess(), lldb.eStopReasonBreakpoint).GetFrameAtIndex(0)
+        self.assertTrue(frame.IsValid(), "Got a valid frame")
+
+        # The expression log says whether each expression was evaluated
+        # by the interpreter or had to run in the inferior.
+        self.log_file = os.path.join(os.getcwd(), "ir-interpreter.log")
+        def cleanup():
+            self.runCmd("log disable lldb expr", check=False)
+            if os.path.exists(self.log_file):
+                os.remove(self.log_file)
+        self.addTearDownHook(cleanup)
+
+        expressions = [
+            # PHI nodes and selects
+            ("n < 0 && d > 0", "1"),
+            ("n > 0 || d < 0", "0"),
+            ("n < 0 ? d : n", "2"),
+            # Signed and unsigned integer operations on the IR bit widths
+            ("n / d", "-3"),
+            ("n % d", "-1"),
+            ("n >> 1", "-4"),
+            ("u << 3", "40"),
+            ("(u & 4) | (u ^ 1)", "4"),
+            ("n < d", "1"),
+            ("(unsigned char)(n * 100)", "'D'"),
+            ("(long long)n * 3", "-21"),
+            # Floating point arithmetic, comparisons and conversions
+            ("pi * 2", "7"),
+            ("pi > 3.0", "1"),
+            ("(int)pi", "3"),
+            ("(double)n / 2", "-3.5"),
+            # Null pointers, string literals and the library calls the
+            # interpreter runs itself
+            ("null_str == 0", "1"),
+            ("strlen(str)", "5"),
+            ("strcmp(str, \"hello\")", "0"),
+            ("strncmp(str, \"help\", 3)", "0"),
+            ("memcmp(str, \"hellp\", 5) < 0", "1"),
+            # GEPs into structs
+            ("pt.x + pt.y", "-1"),
+        ]
+
+        for expr, result in expressions:
+            if os.path.exists(self.log_file):
+                os.remove(self.log_file)
+            self.runCmd("log enable -f %s lldb expr" % self.log_file)
+            value = frame.EvaluateExpression(expr)
+            self.runCmd("log disable lldb expr")
+
+            self.assertTrue(value.GetError().Success(), "'%s' evaluated without an error" % expr)
+            self.assertTrue(value.GetValue() == result,
+                            "'%s' is %s, not %s" % (expr, result, value.GetValue()))
+
+            with open(self.log_file, "r") as f:
+                log = f.read()
+            self.assertTrue("Expression evaluated as a constant" in log,
+                            "'%s' was interpreted" % expr)
+            self.assertTrue("Executing expression" not in log,
+                            "'%s' didn't run in the inferior" % expr)
+
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
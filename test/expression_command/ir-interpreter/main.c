@@ -0,0 +1,29 @@
+//===-- main.c --------------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+#include <stdio.h>
+
+struct point
+{
+    int x;
+    int y;
+};
+
+int
+main (int argc, char const *argv[])
+{
+    int n = -7;
+    int d = 2;
+    unsigned int u = 5;
+    double pi = 3.5;
+    const char *str = "hello";
+    const char *null_str = NULL;
+    struct point pt = { 3, -4 };
+    printf ("%d %d %u %f %s %p %d\n", n, d, u, pi, str, null_str, pt.x); // Evaluate expressions here.
+    return 0;
+}
@@ -0,0 +1,99 @@
+"""
+Test that breakpoint conditions the remote stub can evaluate stop at the
+right hit and count the hits they filter out.
+"""
+
+import os, time
+import re
+import unittest2
+import lldb, lldbutil
+from lldbtest import *
+
+class StubBreakpointConditionsTestCase(TestBase):
+
+    mydir = os.path.join("functionalities", "breakpoint", "stub_conditions")
+
+    @unittest2.skipUnless(sys.platform.startswith("darwin"), "requires Darwin")
+    @dsym_test
+    def test_with_dsym(self):
+        """Test the hit counts of a breakpoint with a condition the stub can evaluate."""
+        self.buildDsym()
+        self.stub_conditions()
+
+    @dwarf_test
+    def test_with_dwarf(self):
+        """Test the hit counts of a breakpoint with a condition the stub can evaluate."""
+        self.buildDwarf()
+        self.stub_conditions()
+
+    def setUp(self):
+        # Call super's setUp().
+        TestBase.setUp(self)
+        # Find the line numbers to break at.
+        self.cond_line = line_number('main.c', '// Set conditional breakpoint here.')
+        self.end_line = line_number('main.c', '// Set break point at end of main here.')
+
+    def stub_conditions(self):
+        """Test the hit counts of a breakpoint with a condition the stub can evaluate."""
+        exe = os.path.join(os.getcwd(), "a.out")
+        self.runCmd("file " + exe, CURRENT_EXECUTABLE_SET)
+
+        self.log_file = os.path.join(os.getcwd(), "stub-conditions.log")
+        def cleanup():
+            self.runCmd("log disable gdb-remote packets", check=False)
+            if os.path.exists(self.log_file):
+                os.remove(self.log_file)
+        self.addTearDownHook(cleanup)
+        self.runCmd("log enable -f %s gdb-remote packets" % self.log_file)
+
+        # Stop at main first so we can look up the address of g_value.
+        self.expect("breakpoint set -n main", BREAKPOINT_CREATED,
+            startstr = "Breakpoint created: 1: name = 'main'")
+        self.runCmd("run", RUN_SUCCEEDED)
+
+        target = self.dbg.GetSelectedTarget()
+        value_addr = target.FindFirstGlobalVariable("g_value").GetLoadAddress()
+        self.assertTrue(value_addr != lldb.LLDB_INVALID_ADDRESS, "Found the address of g_value")
+        self.runCmd("breakpoint delete 1")
+
+        # Only memory reads through a cast pointer and literals, so the
+        # condition can be handed to a stub that evaluates conditions.
+        self.expect("breakpoint set -f main.c -l %d" % self.cond_line, BREAKPOINT_CREATED,
+            startstr = "Breakpoint created: 2: file ='main.c', line = %d" % self.cond_line)
+        self.runCmd("breakpoint modify -c '*(int *)0x%x == 7' 2" % value_addr)
+        self.expect("breakpoint set -f main.c -l %d" % self.end_line, BREAKPOINT_CREATED,
+            startstr = "Breakpoint created: 3: file ='main.c', line = %d" % self.end_line)
+
+        self.runCmd("continue", RUN_SUCCEEDED)
+
+        # We stop at the hit where the condition is true, and the hits
+        # before it are counted even if the stub filtered them out.
+        self.expect("expression g_value", VARIABLES_DISPLAYED_CORRECTLY,
+            substrs = ["= 7"])
+        self.expect("breakpoint list -f 2", "Breakpoint hit count includes the filtered hits",
+            substrs = ["hit count = 8"])
+
+        self.runCmd("continue", RUN_SUCCEEDED)
+
+        # All ten hits are counted by the time we get to the end.
+        self.expect("thread backtrace", STOPPED_DUE_TO_BREAKPOINT,
+            patterns = ["frame #0.*main.c:%d" % self.end_line])
+        self.expect("breakpoint list -f 2", "Breakpoint hit count includes the filtered hits",
+            substrs = ["hit count = 10"])
+
+        # When debugserver is the stub, the condition must have been
+        # compiled and sent along with the breakpoint.
+        if sys.platform.startswith("darwin"):
+            with open(self.log_file, "r") as f:
+                log = f.read()
+            self.assertTrue(re.search(r"\$Z0,[0-9a-f]+,[0-9a-f]+;X[0-9a-f]+,[0-9a-f]+#", log),
+                            "The breakpoint condition was sent to the stub")
+            self.assertTrue("bpfiltered:" in log,
+                            "The stub reported the hits it filtered out")
+
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
@@ -0,0 +1,29 @@
+//===-- main.c --------------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+#include <stdio.h>
+
+// Breakpoint conditions that only read memory through a cast pointer can
+// be evaluated by the remote stub. The hits it doesn't stop for must still
+// show up in the breakpoint's hit count.
+
+int g_value = 0;
+
+int
+main (int argc, char const *argv[])
+{
+    int i;
+    int sum = 0;
+    for (i = 0; i < 10; ++i)
+    {
+        g_value = i;
+        sum += g_value; // Set conditional breakpoint here.
+    }
+    printf ("sum = %d\n", sum); // Set break point at end of main here.
+    return 0;
+}
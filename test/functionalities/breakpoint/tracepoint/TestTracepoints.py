@@ -0,0 +1,101 @@
+"""
+Test tracepoints, breakpoints whose hits are recorded without stopping,
+and the 'breakpoint trace' command that shows the recorded hits.
+"""
+
+import os, time
+import re
+import unittest2
+import lldb
+from lldbtest import *
+
+class TracepointTestCase(TestBase):
+
+    mydir = os.path.join("functionalities", "breakpoint", "tracepoint")
+
+    @unittest2.skipUnless(sys.platform.startswith("darwin"), "requires Darwin")
+    @dsym_test
+    def test_tracepoints_with_dsym(self):
+        """Test that tracepoint hits are recorded without stopping."""
+        self.buildDsym()
+        self.tracepoints()
+
+    @dwarf_test
+    def test_tracepoints_with_dwarf(self):
+        """Test that tracepoint hits are recorded without stopping."""
+        self.buildDwarf()
+        self.tracepoints()
+
+    def setUp(self):
+        # Call super's setUp().
+        TestBase.setUp(self)
+        # Find the line numbers for the tracepoint and the breakpoint.
+        self.trace_line = line_number('main.c', '// Set tracepoint here.')
+        self.break_line = line_number('main.c', '// Set break point at this line.')
+
+    def tracepoints(self):
+        """Test that tracepoint hits are recorded without stopping."""
+        exe = os.path.join(os.getcwd(), "a.out")
+        self.runCmd("file " + exe, CURRENT_EXECUTABLE_SET)
+
+        # Keep fewer hits than the loop makes, so the ring buffer wraps.
+        self.runCmd("settings set target.tracepoint-buffer-size 4")
+
+        self.expect("breakpoint set -f main.c -l %d" % self.trace_line, BREAKPOINT_CREATED,
+            startstr = "Breakpoint created: 1: file ='main.c', line = %d, locations = 1" %
+                        self.trace_line)
+        self.runCmd("breakpoint modify --tracepoint true 1")
+        self.expect("breakpoint set -f main.c -l %d" % self.break_line, BREAKPOINT_CREATED,
+            startstr = "Breakpoint created: 2: file ='main.c', line = %d, locations = 1" %
+                        self.break_line)
+
+        # The first stop must be at the breakpoint, not at the tracepoint.
+        self.runCmd("run", RUN_SUCCEEDED)
+        self.expect("thread list", STOPPED_DUE_TO_BREAKPOINT,
+            substrs = ['stopped',
+                       'stop reason = breakpoint 2.1'])
+        self.expect("expression -- g_sum", substrs = ['= 45'])
+
+        # All ten hits are counted, the last four are kept.
+        self.expect("breakpoint list -f 1",
+            substrs = ['resolved, hit count = 10'])
+        self.expect("breakpoint trace",
+            startstr = "10 tracepoint hits recorded, showing the last 4:")
+        records = [line for line in self.res.GetOutput().splitlines() if line.startswith('#')]
+        self.assertTrue(len(records) == 4)
+        for i in range(4):
+            self.assertTrue(records[i].startswith('#%d ' % (i + 6)))
+            self.assertTrue('tracepoint = 1.1' in records[i])
+
+        # The recorded pc is the address of the tracepoint.
+        target = self.dbg.GetSelectedTarget()
+        location = target.FindBreakpointByID(1).GetLocationAtIndex(0)
+        self.assertTrue('pc = 0x%16.16x' % location.GetLoadAddress() in records[3])
+
+        # The first argument register holds the argument of trace_me().
+        if self.getArchitecture() == 'x86_64':
+            self.expect("breakpoint trace --count 1",
+                patterns = ['args: 0x9 '])
+
+        self.expect("breakpoint trace --count 2",
+            startstr = "10 tracepoint hits recorded, showing the last 2:")
+
+        self.runCmd("breakpoint trace --clear")
+        self.expect("breakpoint trace",
+            startstr = "0 tracepoint hits recorded, showing the last 0:")
+
+        # A tracepoint that is made a breakpoint again stops.
+        self.runCmd("breakpoint modify --tracepoint false 1")
+        self.runCmd("process continue")
+        self.expect("thread list", STOPPED_DUE_TO_BREAKPOINT,
+            substrs = ['stopped',
+                       'stop reason = breakpoint 1.1'])
+        self.expect("breakpoint trace",
+            startstr = "0 tracepoint hits recorded")
+
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
@@ -0,0 +1,30 @@
+//===-- main.c --------------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+#include <stdio.h>
+
+int g_sum = 0;
+
+int
+trace_me (int value)
+{
+    g_sum += value; // Set tracepoint here.
+    return g_sum;
+}
+
+int
+main (int argc, char const *argv[])
+{
+    int i;
+    for (i = 0; i < 10; ++i)
+        trace_me (i);
+    printf ("sum = %d\n", g_sum); // Set break point at this line.
+    for (i = 0; i < 3; ++i)
+        trace_me (i);
+    return 0;
+}
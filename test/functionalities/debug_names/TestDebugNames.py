@@ -0,0 +1,78 @@
+"""
+Test that lldb finds functions, variables and types through the DWARF 4
+".debug_names" accelerator tables, and that DWARF 4 line tables and
+offset DW_AT_high_pc values are understood.
+"""
+
+import os, time
+import unittest2
+import lldb
+from lldbtest import *
+
+class DebugNamesTestCase(TestBase):
+
+    mydir = os.path.join("functionalities", "debug_names")
+
+    @unittest2.skipUnless(sys.platform.startswith("linux"), "requires an ELF toolchain that emits .debug_names")
+    @dwarf_test
+    def test_with_dwarf(self):
+        """Test name lookups and stepping in a binary with .debug_names."""
+        self.buildDwarf()
+        self.debug_names()
+
+    def setUp(self):
+        # Call super's setUp().
+        TestBase.setUp(self)
+        # Find the line number to break inside static_func().
+        self.line = line_number('main.c', '// Set break point at this line.')
+
+    def debug_names(self):
+        """Test name lookups and stepping in a binary with .debug_names."""
+        exe = os.path.join(os.getcwd(), "a.out")
+        self.runCmd("file " + exe, CURRENT_EXECUTABLE_SET)
+
+        # Make sure the compiler really emitted the accelerator tables.
+        self.expect("image dump sections a.out",
+            substrs = ['dwarf-names'])
+
+        # Globals and statics come from the name tables.
+        self.expect("target variable g_global g_static", VARIABLES_DISPLAYED_CORRECTLY,
+            substrs = ['g_global = 12',
+                       'g_static = 34'])
+
+        self.expect("image lookup -t point",
+            substrs = ['struct point'])
+
+        # A function name breakpoint needs the function's address range,
+        # which DWARF 4 encodes as an offset DW_AT_high_pc.
+        self.expect("breakpoint set -n static_func", BREAKPOINT_CREATED,
+            substrs = ["Breakpoint created: 1: name = 'static_func', locations = 1"])
+
+        # A file and line breakpoint needs the DWARF 4 line table.
+        self.expect("breakpoint set -f main.c -l %d" % self.line, BREAKPOINT_CREATED,
+            startstr = "Breakpoint created: 2: file ='main.c', line = %d, locations = 1" % self.line)
+
+        self.runCmd("run", RUN_SUCCEEDED)
+
+        self.expect("thread list", STOPPED_DUE_TO_BREAKPOINT,
+            substrs = ['stopped',
+                       'a.out`static_func',
+                       'stop reason = breakpoint'])
+
+        self.runCmd("continue")
+
+        self.expect("thread backtrace", STOPPED_DUE_TO_BREAKPOINT,
+            substrs = ['static_func',
+                       'main.c:%d' % self.line,
+                       'main'])
+
+        self.expect("frame variable *p", VARIABLES_DISPLAYED_CORRECTLY,
+            substrs = ['x = 1',
+                       'y = 2'])
+
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
@@ -0,0 +1,32 @@
+//===-- main.c --------------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+#include <stdio.h>
+
+struct point
+{
+    int x;
+    int y;
+};
+
+int g_global = 12;
+static int g_static = 34;
+
+static int
+static_func (struct point *p)
+{
+    return p->x + p->y + g_static; // Set break point at this line.
+}
+
+int
+main (int argc, char const *argv[])
+{
+    struct point p = { 1, 2 };
+    printf ("%d\n", static_func (&p) + g_global);
+    return 0;
+}
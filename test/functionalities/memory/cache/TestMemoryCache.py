@@ -0,0 +1,137 @@
+"""
+Test that the process memory cache stays under process.memory-cache-size,
+coalesces and prefetches reads from the process, and always returns the
+right bytes.
+"""
+
+import os, time
+import re
+import unittest2
+import lldb
+from lldbtest import *
+import lldbutil
+
+class MemoryCacheTestCase(TestBase):
+
+    mydir = os.path.join("functionalities", "memory", "cache")
+
+    @unittest2.skipUnless(sys.platform.startswith("darwin"), "requires Darwin")
+    @python_api_test
+    @dsym_test
+    def test_memory_cache_with_dsym(self):
+        """Test the memory cache limit, coalescing and prefetching."""
+        self.buildDsym()
+        self.memory_cache()
+
+    @python_api_test
+    @dwarf_test
+    def test_memory_cache_with_dwarf(self):
+        """Test the memory cache limit, coalescing and prefetching."""
+        self.buildDwarf()
+        self.memory_cache()
+
+    def setUp(self):
+        # Call super's setUp().
+        TestBase.setUp(self)
+        # Find the line number to break inside main().
+        self.line = line_number('main.c', '// Set break point at this line.')
+        self.cache_size = 64 * 1024
+
+    def get_cache_stats(self):
+        """Return the counters 'process cache stats' shows as a dictionary."""
+        self.runCmd("process cache stats")
+        output = self.res.GetOutput()
+        stats = {}
+        for name in ['Cache line size', 'Cache line hits', 'Cache line misses',
+                     'Prefetched lines', 'Evicted lines']:
+            match = re.search(name + r':\s+(\d+)', output)
+            self.assertTrue(match, "'%s' is in the cache statistics" % name)
+            stats[name] = int(match.group(1))
+        match = re.search(r'Cached memory:\s+(\d+) bytes', output)
+        self.assertTrue(match, "'Cached memory' is in the cache statistics")
+        stats['Cached memory'] = int(match.group(1))
+        match = re.search(r'Process reads:\s+(\d+)', output)
+        self.assertTrue(match, "'Process reads' is in the cache statistics")
+        stats['Process reads'] = int(match.group(1))
+        return stats
+
+    def check_bytes(self, content, offset):
+        """Check bytes read from g_buffer against the pattern main() wrote."""
+        for i in range(len(content)):
+            if ord(content[i]) != ((offset + i) * 7) & 0xff:
+                self.fail("byte at offset %d of g_buffer is %d, expected %d" %
+                          (offset + i, ord(content[i]), ((offset + i) * 7) & 0xff))
+
+    def memory_cache(self):
+        """Test the memory cache limit, coalescing and prefetching."""
+        exe = os.path.join(os.getcwd(), "a.out")
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+
+        breakpoint = target.BreakpointCreateByLocation('main.c', self.line)
+        self.assertTrue(breakpoint, VALID_BREAKPOINT)
+
+        self.runCmd("settings set target.process.memory-cache-size %d" % self.cache_size)
+
+        process = target.LaunchSimple(None, None, os.getcwd())
+        self.assertTrue(process, PROCESS_IS_VALID)
+        thread = lldbutil.get_stopped_thread(process, lldb.eStopReasonBreakpoint)
+        self.assertTrue(thread, "The thread stopped at the breakpoint")
+
+        buffer_addr = target.FindFirstGlobalVariable('g_buffer').GetLoadAddress()
+        self.assertTrue(buffer_addr != lldb.LLDB_INVALID_ADDRESS)
+        buffer_size = 1024 * 1024
+        error = lldb.SBError()
+
+        # Read the buffer front to back in small reads, like showing
+        # variables does. The cache has to stay under its limit, so
+        # lines get evicted, and the sequential reads get prefetched.
+        stats = self.get_cache_stats()
+        read_size = 256
+        for offset in range(0, buffer_size, read_size):
+            content = process.ReadMemory(buffer_addr + offset, read_size, error)
+            self.assertTrue(error.Success(), "Read of g_buffer + %d succeeded" % offset)
+            self.check_bytes(content, offset)
+        after = self.get_cache_stats()
+        self.assertTrue(after['Cached memory'] <= self.cache_size,
+                        "The cache stays within process.memory-cache-size")
+        self.assertTrue(after['Evicted lines'] > stats['Evicted lines'],
+                        "Cache lines were evicted")
+        self.assertTrue(after['Prefetched lines'] > stats['Prefetched lines'],
+                        "Sequential reads were prefetched")
+        self.assertTrue(after['Process reads'] - stats['Process reads'] < buffer_size / after['Cache line size'],
+                        "The process was read fewer times than there are cache lines")
+
+        # The start of the buffer was evicted, reading it again must still
+        # give the right bytes.
+        content = process.ReadMemory(buffer_addr, 4096, error)
+        self.assertTrue(error.Success())
+        self.check_bytes(content, 0)
+
+        # A read that misses several lines at once is one process read.
+        line_size = after['Cache line size']
+        offset = buffer_size / 2 + line_size / 2
+        stats = self.get_cache_stats()
+        content = process.ReadMemory(buffer_addr + offset, 8 * line_size, error)
+        self.assertTrue(error.Success())
+        self.check_bytes(content, offset)
+        after = self.get_cache_stats()
+        self.assertTrue(after['Cache line misses'] > stats['Cache line misses'])
+        self.assertTrue(after['Process reads'] - stats['Process reads'] == 1,
+                        "Missing cache lines were read with a single process read")
+
+        # Writing memory must not leave stale bytes in the cache.
+        written = process.WriteMemory(buffer_addr + offset, '\xaa\xbb\xcc\xdd', error)
+        self.assertTrue(error.Success() and written == 4)
+        content = process.ReadMemory(buffer_addr + offset, 4, error)
+        self.assertTrue(error.Success() and content == '\xaa\xbb\xcc\xdd',
+                        "Reads see the bytes that were just written")
+
+        process.Kill()
+
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
@@ -0,0 +1,23 @@
+//===-- main.c --------------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+#include <stdio.h>
+
+#define BUFFER_SIZE (1024 * 1024)
+
+unsigned char g_buffer[BUFFER_SIZE];
+
+int
+main (int argc, char const *argv[])
+{
+    unsigned int i;
+    for (i = 0; i < BUFFER_SIZE; ++i)
+        g_buffer[i] = (i * 7) & 0xff;
+    printf ("%p\n", g_buffer); // Set break point at this line.
+    return 0;
+}
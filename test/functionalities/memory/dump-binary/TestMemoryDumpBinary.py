@@ -0,0 +1,87 @@
+"""
+Test 'memory read --binary --outfile' over a range that ends in memory
+that can't be read.
+"""
+
+import os, time
+import unittest2
+import lldb
+from lldbtest import *
+
+class MemoryDumpBinaryTestCase(TestBase):
+
+    mydir = os.path.join("functionalities", "memory", "dump-binary")
+
+    @unittest2.skipUnless(sys.platform.startswith("darwin"), "requires Darwin")
+    @dsym_test
+    def test_memory_dump_binary_with_dsym(self):
+        """Test that unreadable memory at the end of a binary dump is written as zeros."""
+        self.buildDsym()
+        self.memory_dump_binary()
+
+    @dwarf_test
+    def test_memory_dump_binary_with_dwarf(self):
+        """Test that unreadable memory at the end of a binary dump is written as zeros."""
+        self.buildDwarf()
+        self.memory_dump_binary()
+
+    def setUp(self):
+        # Call super's setUp().
+        TestBase.setUp(self)
+        # Find the line number to break inside main().
+        self.line = line_number('main.c', '// Set break point at this line.')
+        self.outfile = os.path.join(os.getcwd(), "memory-dump.bin")
+
+    def memory_dump_binary(self):
+        """Test that unreadable memory at the end of a binary dump is written as zeros."""
+        exe = os.path.join(os.getcwd(), "a.out")
+        self.runCmd("file " + exe, CURRENT_EXECUTABLE_SET)
+
+        self.expect("breakpoint set -f main.c -l %d" % self.line,
+                    BREAKPOINT_CREATED,
+            startstr = "Breakpoint created: 1: file ='main.c', line = %d, locations = 1" %
+                        self.line)
+
+        self.runCmd("run", RUN_SUCCEEDED)
+
+        # The stop reason of the thread should be breakpoint.
+        self.expect("thread list", STOPPED_DUE_TO_BREAKPOINT,
+            substrs = ['stopped', 'stop reason = breakpoint'])
+
+        frame = self.dbg.GetSelectedTarget().GetProcess().GetSelectedThread().GetFrameAtIndex(0)
+        start = frame.FindVariable("g_pages").GetValueAsUnsigned()
+        page_size = frame.FindVariable("g_page_size").GetValueAsUnsigned()
+        self.assertTrue(start != 0 and page_size != 0)
+
+        if os.path.exists(self.outfile):
+            os.remove(self.outfile)
+        self.addTearDownHook(lambda: os.path.exists(self.outfile) and os.remove(self.outfile))
+
+        self.expect("memory read --force --binary --outfile %s 0x%x 0x%x" % (self.outfile, start, start + 2 * page_size),
+            substrs = ['%d bytes written' % page_size,
+                       '%d unreadable bytes were written as zeros' % page_size])
+
+        # The file covers the whole range, with the unreadable page as zeros.
+        with open(self.outfile, "rb") as f:
+            contents = f.read()
+        self.assertTrue(len(contents) == 2 * page_size)
+        self.assertTrue(contents[:page_size] == 'A' * page_size)
+        self.assertTrue(contents[page_size:] == '\0' * page_size)
+
+        # Appending can't leave holes, the unreadable part is written out
+        # as zeros.
+        self.expect("memory read --force --binary --outfile %s --append-outfile 0x%x 0x%x" % (self.outfile, start, start + page_size + 16),
+            substrs = ['%d bytes appended' % page_size,
+                       '16 unreadable bytes were written as zeros'])
+        with open(self.outfile, "rb") as f:
+            contents = f.read()
+        self.assertTrue(len(contents) == 3 * page_size + 16)
+        self.assertTrue(contents[2 * page_size:3 * page_size] == 'A' * page_size)
+        self.assertTrue(contents[3 * page_size:] == '\0' * 16)
+
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
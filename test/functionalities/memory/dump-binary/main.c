@@ -0,0 +1,29 @@
+//===-- main.c --------------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+// Two pages, the second of which can't be read, so a dump of both ends
+// in unreadable memory.
+char *g_pages = NULL;
+size_t g_page_size = 0;
+
+int main (int argc, char const *argv[])
+{
+    g_page_size = getpagesize();
+    g_pages = (char *)mmap (NULL, 2 * g_page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
+    if (g_pages == MAP_FAILED)
+        return 1;
+    memset (g_pages, 'A', g_page_size);
+    mprotect (g_pages + g_page_size, g_page_size, PROT_NONE);
+    printf ("pages at %p\n", g_pages); // Set break point at this line.
+    return 0;
+}
@@ -0,0 +1,88 @@
+"""
+Test 'memory find' and SBProcess.FindInMemory() over a range that takes
+more than one remote search packet.
+"""
+
+import os, time
+import unittest2
+import lldb
+from lldbtest import *
+
+class MemoryFindTestCase(TestBase):
+
+    mydir = os.path.join("functionalities", "memory", "find")
+
+    @unittest2.skipUnless(sys.platform.startswith("darwin"), "requires Darwin")
+    @dsym_test
+    def test_memory_find_with_dsym(self):
+        """Test finding bytes in a large block of memory."""
+        self.buildDsym()
+        self.memory_find()
+
+    @dwarf_test
+    def test_memory_find_with_dwarf(self):
+        """Test finding bytes in a large block of memory."""
+        self.buildDwarf()
+        self.memory_find()
+
+    def setUp(self):
+        # Call super's setUp().
+        TestBase.setUp(self)
+        # Find the line number to break inside main().
+        self.line = line_number('main.c', '// Set break point at this line.')
+
+    def memory_find(self):
+        """Test finding bytes in a large block of memory."""
+        exe = os.path.join(os.getcwd(), "a.out")
+        self.runCmd("file " + exe, CURRENT_EXECUTABLE_SET)
+
+        self.expect("breakpoint set -f main.c -l %d" % self.line,
+                    BREAKPOINT_CREATED,
+            startstr = "Breakpoint created: 1: file ='main.c', line = %d, locations = 1" %
+                        self.line)
+
+        self.runCmd("run", RUN_SUCCEEDED)
+
+        # The stop reason of the thread should be breakpoint.
+        self.expect("thread list", STOPPED_DUE_TO_BREAKPOINT,
+            substrs = ['stopped', 'stop reason = breakpoint'])
+
+        target = self.dbg.GetSelectedTarget()
+        process = target.GetProcess()
+        frame = process.GetSelectedThread().GetFrameAtIndex(0)
+        start = frame.FindVariable("g_buffer").GetValueAsUnsigned()
+        size = frame.FindVariable("g_buffer_size").GetValueAsUnsigned()
+        self.assertTrue(start != 0 and size == 48 * 1024 * 1024)
+        end = start + size
+        chunk_size = 32 * 1024 * 1024
+
+        # The first match straddles the boundary between two search packets.
+        error = lldb.SBError()
+        addr = process.FindInMemory(start, end, 'needle', error)
+        self.assertTrue(error.Success(), error.GetCString())
+        self.assertTrue(addr == start + chunk_size - 3)
+
+        addr = process.FindInMemory(addr + 1, end, 'needle', error)
+        self.assertTrue(error.Success(), error.GetCString())
+        self.assertTrue(addr == end - 16)
+
+        addr = process.FindInMemory(start, end, 'no such bytes', error)
+        self.assertTrue(error.Success(), error.GetCString())
+        self.assertTrue(addr == lldb.LLDB_INVALID_ADDRESS)
+
+        self.expect("memory find --string needle --count 3 0x%x 0x%x" % (start, end),
+            substrs = ['0x%x' % (start + chunk_size - 3), '0x%x' % (end - 16)])
+
+        # The connection must still be in sync after the searches: the next
+        # packets must get their own replies, not a late search result.
+        self.expect("memory read --format char[] --size 12 --count 1 `&g_after`",
+            substrs = ['after search'])
+        self.expect("expression -- g_buffer_size",
+            substrs = ['%d' % size])
+
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
@@ -0,0 +1,30 @@
+//===-- main.c --------------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+#include <stdlib.h>
+#include <string.h>
+
+// Large enough that a remote search needs more than one qSearchMemory packet.
+#define BUFFER_SIZE (48 * 1024 * 1024)
+#define CHUNK_SIZE (32 * 1024 * 1024)
+
+char *g_buffer = NULL;
+unsigned long g_buffer_size = BUFFER_SIZE;
+const char g_after[] = "after search";
+
+int main (int argc, char const *argv[])
+{
+    g_buffer = (char *)calloc (1, BUFFER_SIZE);
+    if (g_buffer == NULL)
+        return 1;
+    // One match straddling the boundary between the first two search
+    // packets and one near the end of the buffer.
+    memcpy (g_buffer + CHUNK_SIZE - 3, "needle", 6);
+    memcpy (g_buffer + BUFFER_SIZE - 16, "needle", 6);
+    return g_buffer[0]; // Set break point at this line.
+}
@@ -0,0 +1,77 @@
+"""
+Test that a "%Stop" notification that arrives while the process is stopped
+in non-stop mode doesn't get taken as the reply to another packet.
+"""
+
+import os, time
+import unittest2
+import lldb
+from lldbtest import *
+
+@unittest2.skipUnless(sys.platform.startswith("darwin"), "requires Darwin")
+class NonStopNotificationsTestCase(TestBase):
+
+    mydir = os.path.join("functionalities", "non-stop")
+
+    @dsym_test
+    def test_notification_while_stopped_with_dsym(self):
+        """Test a stop notification that arrives while the process is stopped."""
+        self.buildDsym()
+        self.notification_while_stopped()
+
+    @dwarf_test
+    def test_notification_while_stopped_with_dwarf(self):
+        """Test a stop notification that arrives while the process is stopped."""
+        self.buildDwarf()
+        self.notification_while_stopped()
+
+    def setUp(self):
+        # Call super's setUp().
+        TestBase.setUp(self)
+        # Find the line numbers to break at.
+        self.line1 = line_number('main.c', '// Set first break point at this line.')
+        self.line2 = line_number('main.c', '// Set second break point at this line.')
+
+    def notification_while_stopped(self):
+        """Test a stop notification that arrives while the process is stopped."""
+        exe = os.path.join(os.getcwd(), "a.out")
+        self.runCmd("file " + exe, CURRENT_EXECUTABLE_SET)
+        self.runCmd("settings set target.process.non-stop-mode true")
+        self.addTearDownHook(
+            lambda: self.runCmd("settings set target.process.non-stop-mode false"))
+
+        self.expect("breakpoint set -f main.c -l %d" % self.line1, BREAKPOINT_CREATED,
+            startstr = "Breakpoint created: 1: file ='main.c', line = %d, locations = 1" %
+                        self.line1)
+        self.expect("breakpoint set -f main.c -l %d" % self.line2, BREAKPOINT_CREATED,
+            startstr = "Breakpoint created: 2: file ='main.c', line = %d, locations = 1" %
+                        self.line2)
+
+        self.runCmd("run", RUN_SUCCEEDED)
+        self.expect("thread list", STOPPED_DUE_TO_BREAKPOINT,
+            substrs = ['stopped', 'stop reason = breakpoint 1.1'])
+
+        # The other thread hits breakpoint 2 while we are stopped, and the
+        # stub sends its "%Stop" notification in between our packets.
+        time.sleep(3)
+
+        # Each of these needs replies to its own packets, a notification
+        # taken as a reply would show up as a wrong or missing value.
+        self.expect("frame variable g_main_value", VARIABLES_DISPLAYED_CORRECTLY,
+            substrs = ['(int) g_main_value = 12'])
+        self.expect("expression g_late_value", VARIABLES_DISPLAYED_CORRECTLY,
+            substrs = ['(int) $0 = 34'])
+        self.expect("memory read --format d --size 4 --count 1 &g_main_value",
+            substrs = ['12'])
+
+        # The queued notification is reported when we continue.
+        self.runCmd("process continue")
+        self.expect("thread list", STOPPED_DUE_TO_BREAKPOINT,
+            substrs = ['stopped', 'stop reason = breakpoint 2.1'])
+
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
@@ -0,0 +1,33 @@
+//===-- main.c --------------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+#include <pthread.h>
+#include <stdio.h>
+#include <unistd.h>
+
+int g_main_value = 12;
+int g_late_value = 34;
+
+void *
+late_thread (void *arg)
+{
+    // Give the debugger time to stop the main thread first, so this
+    // thread stops while the process is already stopped.
+    sleep (1);
+    g_late_value += 1; // Set second break point at this line.
+    return NULL;
+}
+
+int main (int argc, char const *argv[])
+{
+    pthread_t thread;
+    pthread_create (&thread, NULL, late_thread, NULL);
+    printf ("g_main_value = %d\n", g_main_value); // Set first break point at this line.
+    pthread_join (thread, NULL);
+    return 0;
+}
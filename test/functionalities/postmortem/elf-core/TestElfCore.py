@@ -0,0 +1,154 @@
+"""
+Test loading Linux ELF core files with the elf-core process plug-in.
+
+The core files are written by the test itself, so their threads,
+registers and memory are known exactly.
+"""
+
+import os, time
+import signal
+import struct
+import unittest2
+import lldb
+from lldbtest import *
+
+# Where the memory of the fake process is, and what it holds. The string
+# runs across the boundary between the two PT_LOAD segments.
+SEGMENT_SIZE = 0x1000
+SEGMENT_ADDR = 0x10000000
+MEMORY_STRING = "hello from the core file"
+STRING_ADDR = SEGMENT_ADDR + SEGMENT_SIZE - 8
+
+# The threads in the core file: (tid, signal, pc, sp)
+THREADS = [(1234, signal.SIGSEGV, 0x400100, SEGMENT_ADDR + 0x800),
+           (1235, 0, 0x400200, SEGMENT_ADDR + 0x1800)]
+
+class ElfCoreTestCase(TestBase):
+
+    mydir = os.path.join("functionalities", "postmortem", "elf-core")
+
+    def test_x86_64_core(self):
+        """Test loading an x86_64 ELF core file."""
+        core = self.write_core("x86_64.core", is_64_bit=True)
+        self.load_core(core, "x86_64", "rip", "rsp")
+
+    def test_i386_core(self):
+        """Test loading an i386 ELF core file."""
+        core = self.write_core("i386.core", is_64_bit=False)
+        self.load_core(core, "i386", "eip", "esp")
+
+    def test_not_a_core(self):
+        """Test that an ELF file that isn't a core isn't loaded as one."""
+        core = self.write_core("not-a.core", is_64_bit=True, e_type=2)
+        self.expect("target create --core " + core, error=True)
+
+    def prstatus(self, is_64_bit, tid, signo, pc, sp):
+        """Make the description of an NT_PRSTATUS note for a thread."""
+        if is_64_bit:
+            # r15 ... gs from the x86_64 elf_gregset_t, rip is at 16 and rsp at 19
+            regs = [0] * 27
+            regs[16] = pc
+            regs[19] = sp
+            regs[10] = 0x1122334455667788 # rax
+            desc = struct.pack("<12xh18xI76x", signo, tid)
+            desc += struct.pack("<27Q", *regs)
+            desc += struct.pack("<I4x", 0)
+        else:
+            # ebx ... ss from the i386 elf_gregset_t, eip is at 12 and esp at 15
+            regs = [0] * 17
+            regs[12] = pc
+            regs[15] = sp
+            regs[6] = 0x11223344 # eax
+            desc = struct.pack("<12xh10xI44x", signo, tid)
+            desc += struct.pack("<17I", *regs)
+            desc += struct.pack("<I", 0)
+        return desc
+
+    def write_core(self, name, is_64_bit, e_type=4):
+        """Write a core file with two threads and two memory segments."""
+        notes = ""
+        for (tid, signo, pc, sp) in THREADS:
+            desc = self.prstatus(is_64_bit, tid, signo, pc, sp)
+            notes += struct.pack("<III", 5, len(desc), 1) + "CORE\0\0\0\0" + desc
+
+        memory = ["\0" * SEGMENT_SIZE, "\0" * SEGMENT_SIZE]
+        split = SEGMENT_SIZE - (STRING_ADDR - SEGMENT_ADDR)
+        memory[0] = memory[0][:-split] + MEMORY_STRING[:split]
+        memory[1] = MEMORY_STRING[split:] + "\0" + memory[1][len(MEMORY_STRING) - split + 1:]
+
+        if is_64_bit:
+            ehdr_size, phdr_size, machine, elf_class = 64, 56, 62, 2
+        else:
+            ehdr_size, phdr_size, machine, elf_class = 52, 32, 3, 1
+        num_phdrs = 1 + len(memory)
+        notes_offset = ehdr_size + num_phdrs * phdr_size
+        memory_offset = (notes_offset + len(notes) + SEGMENT_SIZE - 1) & ~(SEGMENT_SIZE - 1)
+
+        ident = "\x7fELF" + struct.pack("<BBB9x", elf_class, 1, 1)
+        if is_64_bit:
+            data = ident + struct.pack("<HHIQQQIHHHHHH", e_type, machine, 1, 0, ehdr_size, 0,
+                                       0, ehdr_size, phdr_size, num_phdrs, 0, 0, 0)
+            phdr = lambda type, offset, addr, size: struct.pack("<IIQQQQQQ", type, 4, offset, addr, 0, size, size, 1)
+        else:
+            data = ident + struct.pack("<HHIIIIIHHHHHH", e_type, machine, 1, 0, ehdr_size, 0,
+                                       0, ehdr_size, phdr_size, num_phdrs, 0, 0, 0)
+            phdr = lambda type, offset, addr, size: struct.pack("<IIIIIIII", type, offset, addr, 0, size, size, 4, 1)
+
+        data += phdr(4, notes_offset, 0, len(notes)) # PT_NOTE
+        for i in range(len(memory)):
+            data += phdr(1, memory_offset + i * SEGMENT_SIZE, SEGMENT_ADDR + i * SEGMENT_SIZE, SEGMENT_SIZE) # PT_LOAD
+        data += notes
+        data += "\0" * (memory_offset - len(data))
+        data += "".join(memory)
+
+        path = os.path.join(os.getcwd(), name)
+        f = open(path, "wb")
+        f.write(data)
+        f.close()
+        self.addTearDownHook(lambda: os.remove(path))
+        return path
+
+    def load_core(self, core, arch_name, pc_name, sp_name):
+        """Load a core file and check its threads, registers and memory."""
+        self.expect("target create --core " + core,
+            substrs = ["Core file '%s' (%s) was loaded." % (core, arch_name)])
+
+        process = self.dbg.GetSelectedTarget().GetProcess()
+        self.assertTrue(process.IsValid(), PROCESS_IS_VALID)
+        self.assertTrue(process.GetNumThreads() == len(THREADS))
+
+        for i in range(len(THREADS)):
+            (tid, signo, pc, sp) = THREADS[i]
+            thread = process.GetThreadAtIndex(i)
+            self.assertTrue(thread.GetThreadID() == tid)
+
+            # Threads that weren't the one that crashed are stopped by SIGSTOP
+            self.assertTrue(thread.GetStopReason() == lldb.eStopReasonSignal)
+            expected_signo = signo if signo != 0 else signal.SIGSTOP
+            self.assertTrue(thread.GetStopReasonDataAtIndex(0) == expected_signo)
+
+            frame = thread.GetFrameAtIndex(0)
+            self.assertTrue(frame.FindValue(pc_name, lldb.eValueTypeRegister).GetValueAsUnsigned() == pc)
+            self.assertTrue(frame.FindValue(sp_name, lldb.eValueTypeRegister).GetValueAsUnsigned() == sp)
+
+        if arch_name == "x86_64":
+            self.expect("register read rax", substrs = ['0x1122334455667788'])
+        else:
+            self.expect("register read eax", substrs = ['0x11223344'])
+
+        # A read that runs across both segments
+        error = lldb.SBError()
+        string = process.ReadCStringFromMemory(STRING_ADDR, 256, error)
+        self.assertTrue(error.Success(), error.GetCString())
+        self.assertTrue(string == MEMORY_STRING)
+
+        # Memory that isn't in the core file
+        process.ReadMemory(SEGMENT_ADDR + 2 * SEGMENT_SIZE, 4, error)
+        self.assertTrue(error.Fail())
+
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
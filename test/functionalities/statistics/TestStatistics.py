@@ -0,0 +1,111 @@
+"""
+Test the counters and histograms shown by 'statistics dump' and
+SBDebugger.GetStatistics().
+"""
+
+import os, time
+import json
+import unittest2
+import lldb
+from lldbtest import *
+
+class StatisticsTestCase(TestBase):
+
+    mydir = os.path.join("functionalities", "statistics")
+
+    @unittest2.skipUnless(sys.platform.startswith("darwin"), "requires Darwin")
+    @dsym_test
+    def test_statistics_with_dsym(self):
+        """Test that memory accesses and expressions are counted."""
+        self.buildDsym()
+        self.statistics()
+
+    @dwarf_test
+    def test_statistics_with_dwarf(self):
+        """Test that memory accesses and expressions are counted."""
+        self.buildDwarf()
+        self.statistics()
+
+    def setUp(self):
+        # Call super's setUp().
+        TestBase.setUp(self)
+        # Find the line number to break inside main().
+        self.line = line_number('main.c', '// Set break point at this line.')
+
+    def get_statistics(self):
+        """Return the statistics as a dictionary from 'statistics dump --json'."""
+        self.runCmd("statistics dump --json")
+        return json.loads(self.res.GetOutput())
+
+    def statistics(self):
+        """Test that memory accesses and expressions are counted."""
+        exe = os.path.join(os.getcwd(), "a.out")
+        self.runCmd("file " + exe, CURRENT_EXECUTABLE_SET)
+
+        self.expect("breakpoint set -f main.c -l %d" % self.line, BREAKPOINT_CREATED,
+            startstr = "Breakpoint created: 1: file ='main.c', line = %d, locations = 1" %
+                        self.line)
+
+        self.runCmd("run", RUN_SUCCEEDED)
+        self.expect("thread list", STOPPED_DUE_TO_BREAKPOINT,
+            substrs = ['stopped', 'stop reason = breakpoint'])
+
+        target = self.dbg.GetSelectedTarget()
+        process = target.GetProcess()
+        buffer_addr = target.FindGlobalVariables("g_buffer", 1).GetValueAtIndex(0).AddressOf().GetValueAsUnsigned()
+        value_addr = target.FindGlobalVariables("g_value", 1).GetValueAtIndex(0).AddressOf().GetValueAsUnsigned()
+        self.assertTrue(buffer_addr != 0 and value_addr != 0)
+
+        self.runCmd("statistics reset")
+        stats = self.get_statistics()
+        self.assertTrue(stats['process']['memory']['writes'] == 0)
+        self.assertTrue(stats['process']['memory']['bytes-written'] == 0)
+
+        # Memory that hasn't been read before has to come from the process
+        error = lldb.SBError()
+        process.ReadMemory(buffer_addr, 4096, error)
+        self.assertTrue(error.Success(), error.GetCString())
+        process.WriteMemory(value_addr, '\x02\x00\x00\x00', error)
+        self.assertTrue(error.Success(), error.GetCString())
+
+        stats = self.get_statistics()
+        memory = stats['process']['memory']
+        self.assertTrue(memory['reads'] + memory['range-reads'] >= 1)
+        self.assertTrue(memory['bytes-read'] >= 4096)
+        self.assertTrue(memory['writes'] == 1)
+        self.assertTrue(memory['bytes-written'] == 4)
+
+        # Expressions are timed while they are parsed and counted by how
+        # they were run
+        self.expect("expression -- g_value + 1", substrs = ['= 3'])
+        stats = self.get_statistics()
+        expression = stats['expression']
+        self.assertTrue(expression['parse-usec']['count'] >= 1)
+        self.assertTrue(expression.get('evaluated-statically', 0) + expression.get('jit-compiled', 0) >= 1)
+        self.assertTrue(sum([bucket['count'] for bucket in expression['parse-usec']['buckets']]) ==
+                        expression['parse-usec']['count'])
+
+        # The plain dump shows the same tree
+        self.expect("statistics dump",
+            substrs = ['process:', 'memory:', 'bytes-written: ', 'parse-usec: count = '])
+
+        # The API returns the same JSON object as the command
+        stream = lldb.SBStream()
+        self.assertTrue(lldb.SBDebugger.GetStatistics(stream))
+        api_stats = json.loads(stream.GetData())
+        self.assertTrue(api_stats['process']['memory']['writes'] >= 1)
+        self.assertTrue(api_stats['expression']['parse-usec']['count'] >= 1)
+
+        # Resetting zeroes everything, histograms included
+        self.runCmd("statistics reset")
+        stats = self.get_statistics()
+        self.assertTrue(stats['process']['memory']['writes'] == 0)
+        self.assertTrue(stats['expression']['parse-usec']['count'] == 0)
+        self.assertTrue(stats['expression']['parse-usec']['buckets'] == [])
+
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
@@ -0,0 +1,19 @@
+//===-- main.c --------------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+#include <stdio.h>
+
+char g_buffer[8192];
+int g_value = 1;
+
+int main (int argc, char const *argv[])
+{
+    g_buffer[0] = 'a';
+    printf ("%d %c\n", g_value, g_buffer[0]); // Set break point at this line.
+    return 0;
+}
@@ -0,0 +1,109 @@
+"""
+Test that "target.symbols-on-demand" loads the debug information of a shared
+library for file and line breakpoints, and that it doesn't hold back the debug
+information of a shared library from other targets.
+"""
+
+import os, time
+import unittest2
+import lldb
+from lldbtest import *
+
+class SymbolsOnDemandTestCase(TestBase):
+
+    mydir = os.path.join("functionalities", "symbols-on-demand")
+
+    @unittest2.skipUnless(sys.platform.startswith("darwin"), "requires Darwin")
+    @dsym_test
+    def test_file_line_breakpoint_with_dsym(self):
+        """Test a file and line breakpoint in a shared library that loads its debug information on demand."""
+        self.buildDsym()
+        self.file_line_breakpoint()
+
+    @dwarf_test
+    def test_file_line_breakpoint_with_dwarf(self):
+        """Test a file and line breakpoint in a shared library that loads its debug information on demand."""
+        self.buildDwarf()
+        self.file_line_breakpoint()
+
+    @unittest2.skipUnless(sys.platform.startswith("darwin"), "requires Darwin")
+    @dsym_test
+    def test_other_target_with_dsym(self):
+        """Test that a target without the setting gets the debug information of a shared module."""
+        self.buildDsym()
+        self.other_target()
+
+    @dwarf_test
+    def test_other_target_with_dwarf(self):
+        """Test that a target without the setting gets the debug information of a shared module."""
+        self.buildDwarf()
+        self.other_target()
+
+    def setUp(self):
+        # Call super's setUp().
+        TestBase.setUp(self)
+        # Find the line numbers to break at.
+        self.main_line = line_number('main.c', '// Set break point in main.c at this line.')
+        self.foo_line = line_number('foo.c', '// Set break point in foo.c at this line.')
+
+    def file_line_breakpoint(self):
+        """Test a file and line breakpoint in a shared library that loads its debug information on demand."""
+        exe = os.path.join(os.getcwd(), "a.out")
+        self.runCmd("settings set target.symbols-on-demand true")
+        self.addTearDownHook(
+            lambda: self.runCmd("settings set target.symbols-on-demand false"))
+        self.runCmd("file " + exe, CURRENT_EXECUTABLE_SET)
+
+        # libfoo only has its symbol table until the breakpoint needs the
+        # line table of foo.c.
+        self.expect("breakpoint set -f foo.c -l %d" % self.foo_line, BREAKPOINT_CREATED,
+            startstr = "Breakpoint created: 1: file ='foo.c', line = %d" % self.foo_line)
+
+        self.runCmd("run", RUN_SUCCEEDED)
+        self.expect("thread list", STOPPED_DUE_TO_BREAKPOINT,
+            substrs = ['stopped', 'stop reason = breakpoint 1.1'])
+        self.expect("frame variable value", VARIABLES_DISPLAYED_CORRECTLY,
+            substrs = ['(int) value = 1'])
+
+    def other_target(self):
+        """Test that a target without the setting gets the debug information of a shared module."""
+        exe = os.path.join(os.getcwd(), "a.out")
+
+        # The first target holds back the debug information of libfoo.
+        self.runCmd("settings set target.symbols-on-demand true")
+        self.addTearDownHook(
+            lambda: self.runCmd("settings set target.symbols-on-demand false"))
+        on_demand_target = self.dbg.CreateTarget(exe)
+        self.assertTrue(on_demand_target, VALID_TARGET)
+        breakpoint = on_demand_target.BreakpointCreateByLocation('main.c', self.main_line)
+        self.assertTrue(breakpoint and breakpoint.GetNumLocations() == 1, VALID_BREAKPOINT)
+        on_demand_process = on_demand_target.LaunchSimple(None, None, os.getcwd())
+        self.assertTrue(on_demand_process, PROCESS_IS_VALID)
+        self.addTearDownHook(lambda: on_demand_process.Kill())
+
+        # The second target uses the same libfoo module and wants all of
+        # its debug information.
+        self.runCmd("settings set target.symbols-on-demand false")
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+        breakpoint = target.BreakpointCreateByLocation('main.c', self.main_line)
+        self.assertTrue(breakpoint and breakpoint.GetNumLocations() == 1, VALID_BREAKPOINT)
+        process = target.LaunchSimple(None, None, os.getcwd())
+        self.assertTrue(process, PROCESS_IS_VALID)
+        self.addTearDownHook(lambda: process.Kill())
+
+        contexts = target.FindFunctions('foo_function')
+        self.assertTrue(contexts.GetSize() == 1)
+        self.assertTrue(contexts.GetContextAtIndex(0).GetFunction().IsValid(),
+                        "foo_function should come from the debug information")
+
+        # The breakpoint needs the line table of libfoo in this target.
+        breakpoint = target.BreakpointCreateByLocation('foo.c', self.foo_line)
+        self.assertTrue(breakpoint and breakpoint.GetNumLocations() == 1, VALID_BREAKPOINT)
+
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
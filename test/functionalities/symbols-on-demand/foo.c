@@ -0,0 +1,16 @@
+//===-- foo.c ---------------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+#include "foo.h"
+
+int
+foo_function (int value)
+{
+    int result = value * 2; // Set break point in foo.c at this line.
+    return result;
+}
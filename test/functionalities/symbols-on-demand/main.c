@@ -0,0 +1,18 @@
+//===-- main.c --------------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+#include <stdio.h>
+#include "foo.h"
+
+int
+main (int argc, char const *argv[])
+{
+    int value = foo_function (argc); // Set break point in main.c at this line.
+    printf ("value = %d\n", value);
+    return 0;
+}
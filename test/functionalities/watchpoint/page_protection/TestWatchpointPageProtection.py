@@ -0,0 +1,79 @@
+"""
+Test watchpoints that debugserver emulates with page protection once
+the hardware watchpoint registers are used up. Only the accesses that
+overlap the watched bytes should stop, going by the size of each access.
+"""
+
+import os, time
+import unittest2
+import lldb
+from lldbtest import *
+
+@unittest2.skipUnless(sys.platform.startswith("darwin"), "requires Darwin")
+class WatchpointPageProtectionTestCase(TestBase):
+
+    mydir = os.path.join("functionalities", "watchpoint", "page_protection")
+
+    @dsym_test
+    def test_page_protection_watchpoint_with_dsym(self):
+        """Test that emulated watchpoints use the size of the faulting access."""
+        self.buildDsym()
+        self.page_protection_watchpoint()
+
+    @dwarf_test
+    def test_page_protection_watchpoint_with_dwarf(self):
+        """Test that emulated watchpoints use the size of the faulting access."""
+        self.buildDwarf()
+        self.page_protection_watchpoint()
+
+    def setUp(self):
+        # Call super's setUp().
+        TestBase.setUp(self)
+        # Find the line number to break inside main().
+        self.line = line_number('main.c', '// Set break point at this line.')
+
+    def page_protection_watchpoint(self):
+        """Test that emulated watchpoints use the size of the faulting access."""
+        exe = os.path.join(os.getcwd(), "a.out")
+        self.runCmd("file " + exe, CURRENT_EXECUTABLE_SET)
+
+        self.expect("breakpoint set -f main.c -l %d" % self.line, BREAKPOINT_CREATED,
+            startstr = "Breakpoint created: 1: file ='main.c', line = %d, locations = 1" %
+                       self.line)
+
+        self.runCmd("run", RUN_SUCCEEDED)
+
+        self.expect("thread list", STOPPED_DUE_TO_BREAKPOINT,
+            substrs = ['stopped',
+                       'stop reason = breakpoint'])
+
+        # Use up the hardware watchpoints, then watch one byte.
+        for name in ['g_hw0', 'g_hw1', 'g_hw2', 'g_hw3']:
+            self.expect("watchpoint set variable -w write " + name, WATCHPOINT_CREATED,
+                substrs = ['Watchpoint created'])
+        self.expect("watchpoint set variable -w write g_bytes.watched", WATCHPOINT_CREATED,
+            substrs = ['Watchpoint created', 'size = 1', 'type = w'])
+
+        # Only the sixteen byte store should stop. The one byte store next
+        # to the watched byte and the eight byte store before it shouldn't.
+        self.runCmd("process continue")
+        self.expect("thread list", STOPPED_DUE_TO_WATCHPOINT,
+            substrs = ['stopped',
+                       'stop reason = watchpoint'])
+        self.expect("expression -- g_step", substrs = ['= 3'])
+        self.expect("expression -- (int)g_bytes.watched", substrs = ['= 7'])
+
+        self.runCmd("process continue")
+        self.expect("process status",
+            substrs = ['exited'])
+
+        # The watched byte was written once.
+        self.expect("watchpoint list -v",
+            substrs = ['hit_count = 1'])
+
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
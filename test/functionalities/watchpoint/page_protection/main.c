@@ -0,0 +1,45 @@
+//===-- main.c --------------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+#include <stdio.h>
+#include <stdint.h>
+#include <emmintrin.h>
+
+// These use up the hardware watchpoint registers.
+int32_t g_hw0, g_hw1, g_hw2, g_hw3;
+
+// The watchpoint on 'watched' is emulated with page protection. It shares
+// its page with the bytes around it and with g_step.
+struct bytes
+{
+    char before[9];
+    char watched;
+    char after[6];
+};
+struct bytes g_bytes __attribute__((aligned(16)));
+volatile int g_step = 0;
+
+int main (int argc, char const *argv[])
+{
+    g_step = 1; // Set break point at this line.
+
+    // A one byte store next to the watched byte doesn't hit it.
+    *(volatile char *)&g_bytes.before[8] = 1;
+    g_step = 2;
+
+    // Neither does an eight byte store of the bytes before it.
+    *(volatile uint64_t *)&g_bytes = 0;
+    g_step = 3;
+
+    // A sixteen byte store that starts before it does.
+    _mm_storeu_si128 ((__m128i *)&g_bytes, _mm_set1_epi8 (7));
+    g_step = 4;
+
+    printf ("watched = %d\n", g_bytes.watched);
+    return 0;
+}
@@ -1,4 +1,5 @@
-import time
+import os, time
+import json
 #import numpy
 from lldbtest import *
 
@@ -81,6 +82,35 @@ class Stopwatch(object):
         """Equal to total elapsed time divided by the number of laps."""
         return self.__total_elapsed__ / self.__laps__
 
+    def median(self):
+        """The middle lap time, which a few slow laps don't throw off."""
+        nums = sorted(self.__nums__)
+        middle = len(nums) / 2
+        if len(nums) % 2:
+            return nums[middle]
+        return (nums[middle - 1] + nums[middle]) / 2.0
+
+    def rates(self, amount):
+        """A stopwatch whose laps are 'amount' divided by the lap times of
+        this one, e.g. bytes per second for laps that each read 'amount'
+        bytes."""
+        rates = Stopwatch()
+        for elapsed in self.__nums__:
+            rate = amount / elapsed if elapsed > 0 else 0.0
+            rates.__laps__ += 1
+            rates.__total_elapsed__ += rate
+            rates.__nums__.append(rate)
+        return rates
+
+    def asDict(self):
+        """The measurements as a dictionary, for recording results."""
+        return { 'laps': self.__laps__,
+                 'total': self.__total_elapsed__,
+                 'avg': self.avg(),
+                 'median': self.median(),
+                 'min': min(self.__nums__),
+                 'max': max(self.__nums__) }
+
     #def sigma(self):
     #    """Return the standard deviation of the available samples."""
     #    if self.__laps__ <= 0:
@@ -110,3 +140,127 @@ class BenchBase(TestBase):
         #TestBase.tearDown(self)
         del self.stopwatch
 
+
+    def recordBenchmark(self, name, stopwatch, unit='sec'):
+        """Print the result of the benchmark called 'name' the way bench.py
+        greps for it and, if the LLDB_BENCH_RESULTS environment variable
+        names a file, append it there as one line of JSON.
+
+        bench.py compares those files against a baseline to find
+        regressions.  A unit other than 'sec' (e.g. 'MB/sec') means bigger
+        numbers are better."""
+        print "%s benchmark:" % name, stopwatch
+        results_file = os.environ.get("LLDB_BENCH_RESULTS")
+        if not results_file:
+            return
+        result = stopwatch.asDict()
+        result['name'] = name
+        result['unit'] = unit
+        with open(results_file, 'a') as f:
+            f.write(json.dumps(result) + '\n')
+
+    def recordRate(self, name, amount, stopwatch, unit):
+        """Record a throughput, 'amount' units for each lap of the stopwatch."""
+        self.recordBenchmark(name, stopwatch.rates(amount), unit)
+
+def writeSyntheticSources(directory, num_cus, template_depth=0, entry_point=None):
+    """Write a program with 'num_cus' C++ compile units to 'directory', along
+    with a 'sources.mk' naming them for a Makefile to include.
+
+    Each compile unit has a few classes, a function and global variables,
+    and instantiates a template 'template_depth' levels deep, which is what
+    makes DWARF large for real C++ programs.  main.cpp calls the function
+    of every compile unit so nothing is dead stripped.
+
+    If 'entry_point' is given, the calls are made from a function by that
+    name in synthetic.cpp instead, for programs with a main() of their own."""
+    if not os.path.isdir(directory):
+        os.makedirs(directory)
+    sources = []
+    for i in range(num_cus):
+        name = 'cu%d.cpp' % i
+        sources.append(name)
+        with open(os.path.join(directory, name), 'w') as f:
+            f.write('template <int N, typename T> struct Nested%d\n' % i)
+            f.write('{\n')
+            f.write('    typedef Nested%d<N - 1, Nested%d<N, T> > Next;\n' % (i, i))
+            f.write('    T value;\n')
+            f.write('    static int depth () { return Next::depth () + 1; }\n')
+            f.write('};\n')
+            f.write('template <typename T> struct Nested%d<0, T>\n' % i)
+            f.write('{\n')
+            f.write('    static int depth () { return 0; }\n')
+            f.write('};\n')
+            f.write('struct Point%d { int x; int y; };\n' % i)
+            f.write('struct Rect%d { Point%d origin; Point%d size; };\n' % (i, i, i))
+            f.write('Rect%d g_rect%d = { { %d, %d }, { 10, 20 } };\n' % (i, i, i, i))
+            f.write('int\n')
+            f.write('function%d (int arg)\n' % i)
+            f.write('{\n')
+            f.write('    Rect%d rect = g_rect%d;\n' % (i, i))
+            f.write('    return rect.origin.x + arg + Nested%d<%d, int>::depth ();\n' % (i, template_depth))
+            f.write('}\n')
+    main_name = 'synthetic.cpp' if entry_point else 'main.cpp'
+    with open(os.path.join(directory, main_name), 'w') as f:
+        for i in range(num_cus):
+            f.write('int function%d (int arg);\n' % i)
+        f.write('int\n')
+        if entry_point:
+            f.write('%s (int argc)\n' % entry_point)
+        else:
+            f.write('main (int argc, char const *argv[])\n')
+        f.write('{\n')
+        f.write('    int total = 0;\n')
+        for i in range(num_cus):
+            f.write('    total += function%d (argc);\n' % i)
+        f.write('    return total; // Set breakpoint here.\n')
+        f.write('}\n')
+    sources.append(main_name)
+    with open(os.path.join(directory, 'sources.mk'), 'w') as f:
+        f.write('CXX_SOURCES := \\\n')
+        for name in sources:
+            f.write('    %s \\\n' % name)
+        f.write('\n')
+    # Return the generated files so they can be cleaned up
+    return [os.path.join(directory, name) for name in sources + ['sources.mk']]
+
+def writeSyntheticLibraries(directory, num_libraries, entry_point):
+    """Write the sources of 'num_libraries' shared libraries to 'directory',
+    along with a 'libraries.mk' naming them for a Makefile to include.
+
+    Each library has one function, and 'entry_point' in libraries.cpp calls
+    all of them so the program really links against every library.  The
+    Makefile builds lib<name>.so or lib<name>.dylib from each <name>.cpp
+    in $(SYNTHETIC_LIBRARIES)."""
+    if not os.path.isdir(directory):
+        os.makedirs(directory)
+    names = []
+    for i in range(num_libraries):
+        name = 'synthetic%d' % i
+        names.append(name)
+        with open(os.path.join(directory, name + '.cpp'), 'w') as f:
+            f.write('int\n')
+            f.write('library_function%d (int arg)\n' % i)
+            f.write('{\n')
+            f.write('    return arg + %d;\n' % i)
+            f.write('}\n')
+    with open(os.path.join(directory, 'libraries.cpp'), 'w') as f:
+        for i in range(num_libraries):
+            f.write('int library_function%d (int arg);\n' % i)
+        f.write('int\n')
+        f.write('%s (int arg)\n' % entry_point)
+        f.write('{\n')
+        f.write('    int total = 0;\n')
+        for i in range(num_libraries):
+            f.write('    total += library_function%d (arg);\n' % i)
+        f.write('    return total;\n')
+        f.write('}\n')
+    with open(os.path.join(directory, 'libraries.mk'), 'w') as f:
+        f.write('CXX_SOURCES += libraries.cpp\n')
+        f.write('SYNTHETIC_LIBRARIES := \\\n')
+        for name in names:
+            f.write('    %s \\\n' % name)
+        f.write('\n')
+    # Return the generated files so they can be cleaned up
+    generated = [name + '.cpp' for name in names] + ['libraries.cpp', 'libraries.mk']
+    return [os.path.join(directory, name) for name in generated]
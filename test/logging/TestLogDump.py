@@ -0,0 +1,94 @@
+"""
+Test logs recorded into binary buffers with 'log enable --binary', and
+'log dump' which formats them.
+"""
+
+import os, time
+import re
+import unittest2
+import lldb
+from lldbtest import *
+
+class LogDumpTestCase(TestBase):
+
+    mydir = "logging"
+
+    # <sequence> <seconds>.<microseconds> [<tid>]: <log line>
+    record_regex = re.compile(r'^(\d+) \d+\.\d{6} \[[0-9a-f]{4,}\]: (.*)$')
+
+    def dumped_records(self, output):
+        """Return the (sequence, text) pairs of the records in the output of 'log dump'."""
+        records = []
+        for line in output.splitlines():
+            match = self.record_regex.match(line)
+            self.assertTrue(match, "badly formatted log dump line: '%s'" % line)
+            records.append((int(match.group(1)), match.group(2)))
+        # Records are shown oldest first
+        sequences = [sequence for (sequence, text) in records]
+        self.assertTrue(sequences == sorted(sequences))
+        return records
+
+    def dump(self):
+        """Run 'log dump' and return the (sequence, text) pairs it shows."""
+        self.runCmd("log dump")
+        return self.dumped_records(self.res.GetOutput())
+
+    def test_log_dump(self):
+        """Test that binary log records are formatted by 'log dump'."""
+        # Throw away whatever earlier tests recorded
+        self.runCmd("log dump --clear")
+
+        self.runCmd("log enable --binary lldb commands")
+        self.addTearDownHook(lambda: self.runCmd("log disable lldb commands"))
+        self.runCmd("command alias bp breakpoint")
+        self.runCmd("help bp")
+
+        texts = [text for (sequence, text) in self.dump()]
+        self.assertTrue("Processing command: command alias bp breakpoint" in texts)
+        self.assertTrue("Processing command: help bp" in texts)
+        self.assertTrue(texts.index("Processing command: command alias bp breakpoint") <
+                        texts.index("Processing command: help bp"))
+
+        # The same lines can be written to a file
+        log_file = os.path.join(os.getcwd(), "log-dump.txt")
+        self.addTearDownHook(lambda: os.path.exists(log_file) and os.remove(log_file))
+        self.expect("log dump --file " + log_file,
+            patterns = [r"\d+ log lines written to '%s'" % re.escape(log_file)])
+        f = open(log_file)
+        file_texts = [text for (sequence, text) in self.dumped_records(f.read())]
+        f.close()
+        self.assertTrue("Processing command: help bp" in file_texts)
+
+        # Cleared records aren't shown again, and nothing is recorded once
+        # the log is disabled
+        self.runCmd("log dump --clear")
+        self.runCmd("log disable lldb commands")
+        self.runCmd("help bp")
+        texts = [text for (sequence, text) in self.dump()]
+        self.assertFalse("Processing command: help bp" in texts)
+        self.assertFalse("Processing command: command alias bp breakpoint" in texts)
+
+    def test_log_dump_wraps(self):
+        """Test that a thread's binary log buffer keeps its newest records."""
+        self.runCmd("log dump --clear")
+        self.runCmd("log enable --binary lldb commands")
+        self.addTearDownHook(lambda: self.runCmd("log disable lldb commands"))
+
+        # Each command logs several lines, so this is more than the 1024
+        # records a thread's buffer holds
+        num_commands = 300
+        for i in range(num_commands):
+            self.runCmd("script %d" % i)
+
+        records = self.dump()
+        self.assertTrue(len(records) <= 1024)
+        texts = [text for (sequence, text) in records]
+        self.assertFalse("Processing command: script 0" in texts)
+        self.assertTrue("Processing command: script %d" % (num_commands - 1) in texts)
+
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
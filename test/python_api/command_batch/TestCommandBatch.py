@@ -0,0 +1,84 @@
+"""Test SBCommandBatch and SBCommandInterpreter.HandleCommandBatch()."""
+
+import os
+import unittest2
+import lldb
+from lldbtest import *
+
+class CommandBatchAPITestCase(TestBase):
+
+    mydir = os.path.join("python_api", "command_batch")
+
+    @unittest2.skipUnless(sys.platform.startswith("darwin"), "requires Darwin")
+    @python_api_test
+    @dsym_test
+    def test_command_batch_with_dsym(self):
+        """Test that each command in a batch sees the frame selected before it."""
+        self.buildDsym()
+        self.command_batch()
+
+    @python_api_test
+    @dwarf_test
+    def test_command_batch_with_dwarf(self):
+        """Test that each command in a batch sees the frame selected before it."""
+        self.buildDwarf()
+        self.command_batch()
+
+    def setUp(self):
+        # Call super's setUp().
+        TestBase.setUp(self)
+        # Find the line number to break inside callee().
+        self.line = line_number('main.c', '// Set break point at this line.')
+
+    def command_batch(self):
+        """Test that each command in a batch sees the frame selected before it."""
+        exe = os.path.join(os.getcwd(), "a.out")
+
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+
+        breakpoint = target.BreakpointCreateByLocation('main.c', self.line)
+        self.assertTrue(breakpoint, VALID_BREAKPOINT)
+
+        process = target.LaunchSimple(None, None, os.getcwd())
+        self.assertTrue(process.GetState() == lldb.eStateStopped, PROCESS_STOPPED)
+
+        ci = self.dbg.GetCommandInterpreter()
+        self.assertTrue(ci, VALID_COMMAND_INTERPRETER)
+
+        batch = lldb.SBCommandBatch()
+        batch.AppendCommand("frame variable callee_arg")
+        batch.AppendCommand("frame select 1")
+        batch.AppendCommand("frame variable main_local")
+        batch.AppendCommand("frame select 0")
+        batch.AppendCommand("frame variable callee_arg")
+        self.assertTrue(batch.GetNumCommands() == 5)
+
+        # Run the batch twice, the second run uses the commands that
+        # were looked up the first time.
+        for run in range(2):
+            ci.HandleCommandBatch(batch)
+            self.assertTrue(batch.GetNumCommandsRun() == 5)
+            for i in range(batch.GetNumCommandsRun()):
+                if self.TraceOn():
+                    print batch.GetCommandAtIndex(i)
+                    print batch.GetOutputAtIndex(i), batch.GetErrorAtIndex(i)
+                self.assertTrue(batch.SucceededAtIndex(i),
+                                "'%s' failed: %s" % (batch.GetCommandAtIndex(i), batch.GetErrorAtIndex(i)))
+
+            # "frame variable main_local" only works in main(), which
+            # "frame select 1" selected just before it.
+            self.assertTrue("(int) callee_arg = 42" in batch.GetOutputAtIndex(0))
+            self.assertTrue("(int) main_local = 42" in batch.GetOutputAtIndex(2))
+            self.assertTrue("(int) callee_arg = 42" in batch.GetOutputAtIndex(4))
+
+        # The frame selected by the batch stays selected afterwards, like
+        # it does with HandleCommand().
+        self.assertTrue(process.GetSelectedThread().GetSelectedFrame().GetFrameID() == 0)
+
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
@@ -0,0 +1,22 @@
+//===-- main.c --------------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+#include <stdio.h>
+
+int
+callee (int callee_arg)
+{
+    return callee_arg * 2; // Set break point at this line.
+}
+
+int main (int argc, char const *argv[])
+{
+    int main_local = 42;
+    printf ("callee returned %d\n", callee (main_local));
+    return 0;
+}
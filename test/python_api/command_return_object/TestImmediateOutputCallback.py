@@ -0,0 +1,44 @@
+"""Test SBCommandReturnObject.SetImmediateOutputCallback()."""
+
+import os
+import unittest2
+import lldb
+from lldbtest import *
+
+class ImmediateOutputCallbackTestCase(TestBase):
+
+    mydir = os.path.join("python_api", "command_return_object")
+
+    @python_api_test
+    def test_immediate_output_callback(self):
+        """Test that a Python callable gets the output of a command as it is produced."""
+        ci = self.dbg.GetCommandInterpreter()
+        self.assertTrue(ci, VALID_COMMAND_INTERPRETER)
+
+        chunks = []
+        def output_callback(output):
+            chunks.append(output)
+
+        res = lldb.SBCommandReturnObject()
+        res.SetImmediateOutputCallback(output_callback)
+        ci.HandleCommand("help", res)
+        self.assertTrue(res.Succeeded())
+        self.assertTrue("list of built-in" in "".join(chunks))
+        # Without stream output the text is collected as well.
+        self.assertTrue("list of built-in" in res.GetOutput())
+
+        chunks = []
+        res = lldb.SBCommandReturnObject()
+        res.SetImmediateOutputCallback(output_callback)
+        res.SetStreamOutput(True)
+        ci.HandleCommand("help", res)
+        self.assertTrue(res.Succeeded())
+        self.assertTrue("list of built-in" in "".join(chunks))
+        self.assertFalse(res.GetOutput())
+
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
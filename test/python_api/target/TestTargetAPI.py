@@ -102,6 +102,21 @@ class TargetAPITestCase(TestBase):
         self.buildDwarf()
         self.resolve_symbol_context_with_address()
 
+    @unittest2.skipUnless(sys.platform.startswith("darwin"), "requires Darwin")
+    @python_api_test
+    @dsym_test
+    def test_resolve_load_addresses_with_dsym(self):
+        """Exercise SBTaget.ResolveLoadAddresses() API."""
+        self.buildDsym()
+        self.resolve_load_addresses()
+
+    @python_api_test
+    @dwarf_test
+    def test_resolve_load_addresses_with_dwarf(self):
+        """Exercise SBTarget.ResolveLoadAddresses() API."""
+        self.buildDwarf()
+        self.resolve_load_addresses()
+
     def setUp(self):
         # Call super's setUp().
         TestBase.setUp(self)
@@ -306,6 +321,56 @@ class TargetAPITestCase(TestBase):
         self.assertTrue(desc1 and desc2 and desc1 == desc2,
                         "The two addresses should resolve to the same symbol")
 
+
+    def resolve_load_addresses(self):
+        """Exercise SBTaget.ResolveLoadAddresses() API."""
+        exe = os.path.join(os.getcwd(), "a.out")
+
+        # Create a target by the debugger.
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+
+        breakpoint1 = target.BreakpointCreateByLocation('main.c', self.line1)
+        breakpoint2 = target.BreakpointCreateByName('main', 'a.out')
+        self.assertTrue(breakpoint1 and
+                        breakpoint1.GetNumLocations() == 1,
+                        VALID_BREAKPOINT)
+        self.assertTrue(breakpoint2 and
+                        breakpoint2.GetNumLocations() == 1,
+                        VALID_BREAKPOINT)
+
+        # Launch the process so the addresses are load addresses.
+        process = target.LaunchSimple(None, None, os.getcwd())
+        self.assertTrue(process, PROCESS_IS_VALID)
+        self.assertTrue(process.GetState() == lldb.eStateStopped)
+
+        load_addr1 = breakpoint1.GetLocationAtIndex(0).GetLoadAddress()
+        load_addr2 = breakpoint2.GetLocationAtIndex(0).GetLoadAddress()
+        self.assertTrue(load_addr1 != lldb.LLDB_INVALID_ADDRESS and
+                        load_addr2 != lldb.LLDB_INVALID_ADDRESS)
+
+        # Pass the addresses out of order, with duplicates and with an
+        # address that isn't in any module.
+        addrs = [load_addr2, load_addr1, 0, load_addr1, load_addr2]
+        sc_list = lldb.SBSymbolContextList()
+        num_resolved = target.ResolveLoadAddresses(addrs, lldb.eSymbolContextEverything, sc_list)
+        self.assertTrue(num_resolved == 4)
+        self.assertTrue(sc_list.GetSize() == len(addrs))
+
+        # The batched results must match resolving each address by itself.
+        from lldbutil import get_description
+        for i in range(len(addrs)):
+            context = sc_list.GetContextAtIndex(i)
+            if addrs[i] == 0:
+                self.assertFalse(context.GetModule())
+                continue
+            expected = target.ResolveSymbolContextForAddress(target.ResolveLoadAddress(addrs[i]), lldb.eSymbolContextEverything)
+            self.assertTrue(get_description(context.GetSymbol()) == get_description(expected.GetSymbol()))
+            self.assertTrue(context.GetLineEntry().GetLine() == expected.GetLineEntry().GetLine())
+
+        self.assertTrue(sc_list.GetContextAtIndex(1).GetFunction().GetName() == 'a')
+        self.assertTrue(sc_list.GetContextAtIndex(0).GetFunction().GetName() == 'main')
+
         
 if __name__ == '__main__':
     import atexit
@@ -669,6 +669,56 @@ DNBProcessSignal (nub_process_t pid, int signal)
     return false;
 }
 
+nub_bool_t
+DNBProcessInterrupt (nub_process_t pid)
+{
+    MachProcessSP procSP;
+    if (GetProcessSP (pid, procSP))
+    {
+        return procSP->Interrupt ();
+    }
+    return false;
+}
+
+nub_bool_t
+DNBProcessSetNonStopMode (nub_process_t pid, nub_bool_t enable)
+{
+    MachProcessSP procSP;
+    if (GetProcessSP (pid, procSP))
+    {
+        procSP->SetNonStopMode (enable);
+        return true;
+    }
+    return false;
+}
+
+nub_bool_t
+DNBProcessGetNonStopMode (nub_process_t pid)
+{
+    MachProcessSP procSP;
+    if (GetProcessSP (pid, procSP))
+        return procSP->GetNonStopMode ();
+    return false;
+}
+
+nub_thread_t
+DNBProcessGetNextNonStopStoppedThread (nub_process_t pid)
+{
+    MachProcessSP procSP;
+    if (GetProcessSP (pid, procSP))
+        return procSP->GetNextNonStopStoppedThread ();
+    return INVALID_NUB_THREAD;
+}
+
+nub_bool_t
+DNBProcessSetEnableAsyncProfiling (nub_process_t pid, nub_bool_t enable, uint64_t interval_usec, uint32_t max_frames, uint32_t scan_type)
+{
+    MachProcessSP procSP;
+    if (GetProcessSP (pid, procSP))
+        return procSP->SetEnableAsyncProfiling (enable, interval_usec, max_frames, scan_type);
+    return false;
+}
+
 
 nub_bool_t
 DNBProcessIsAlive (nub_process_t pid)
@@ -1154,6 +1204,19 @@ DNBProcessMemoryRead (nub_process_t pid, nub_addr_t addr, nub_size_t size, void
     return 0;
 }
 
+//----------------------------------------------------------------------
+// Get the pages of several ranges of memory ready to be read with
+// DNBProcessMemoryRead(), using as few kernel calls as possible while
+// the process is stopped.
+//----------------------------------------------------------------------
+void
+DNBProcessMemoryPrefetch (nub_process_t pid, const DNBMemoryRange *ranges, nub_size_t num_ranges)
+{
+    MachProcessSP procSP;
+    if (GetProcessSP (pid, procSP))
+        procSP->PrefetchMemory(ranges, num_ranges);
+}
+
 //----------------------------------------------------------------------
 // Write memory to the address space of process PID. This call will take
 // care of setting and restoring permissions and breaking up the memory
@@ -2066,6 +2129,15 @@ DNBProcessGetAvailableSTDERR (nub_process_t pid, char *buf, nub_size_t buf_size)
     return 0;
 }
 
+nub_size_t
+DNBProcessGetAvailableProfileData (nub_process_t pid, char *buf, nub_size_t buf_size)
+{
+    MachProcessSP procSP;
+    if (GetProcessSP (pid, procSP))
+        return procSP->GetAsyncProfileData (buf, buf_size);
+    return 0;
+}
+
 nub_size_t
 DNBProcessGetStopCount (nub_process_t pid)
 {
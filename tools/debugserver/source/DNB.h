@@ -61,8 +61,16 @@ nub_bool_t      DNBProcessResume        (nub_process_t pid, const DNBThreadResum
 nub_bool_t      DNBProcessHalt          (nub_process_t pid) DNB_EXPORT;
 nub_bool_t      DNBProcessDetach        (nub_process_t pid) DNB_EXPORT;
 nub_bool_t      DNBProcessSignal        (nub_process_t pid, int signal) DNB_EXPORT;
+nub_bool_t      DNBProcessInterrupt     (nub_process_t pid) DNB_EXPORT;
+// Non-stop mode: only the threads that get exceptions stop, and
+// DNBProcessResume can resume stopped threads while others are running.
+nub_bool_t      DNBProcessSetNonStopMode (nub_process_t pid, nub_bool_t enable) DNB_EXPORT;
+nub_bool_t      DNBProcessGetNonStopMode (nub_process_t pid) DNB_EXPORT;
+nub_thread_t    DNBProcessGetNextNonStopStoppedThread (nub_process_t pid) DNB_EXPORT;
+nub_bool_t      DNBProcessSetEnableAsyncProfiling (nub_process_t pid, nub_bool_t enable, uint64_t interval_usec, uint32_t max_frames, uint32_t scan_type) DNB_EXPORT;
 nub_bool_t      DNBProcessKill          (nub_process_t pid) DNB_EXPORT;
 nub_size_t      DNBProcessMemoryRead    (nub_process_t pid, nub_addr_t addr, nub_size_t size, void *buf) DNB_EXPORT;
+void            DNBProcessMemoryPrefetch (nub_process_t pid, const DNBMemoryRange *ranges, nub_size_t num_ranges) DNB_EXPORT;
 nub_size_t      DNBProcessMemoryWrite   (nub_process_t pid, nub_addr_t addr, nub_size_t size, const void *buf) DNB_EXPORT;
 nub_addr_t      DNBProcessMemoryAllocate    (nub_process_t pid, nub_size_t size, uint32_t permissions) DNB_EXPORT;
 nub_bool_t      DNBProcessMemoryDeallocate  (nub_process_t pid, nub_addr_t addr) DNB_EXPORT;
@@ -88,6 +96,7 @@ nub_bool_t      DNBProcessSetSharedLibraryInfoCallback  (nub_process_t pid, DNBC
 nub_addr_t      DNBProcessLookupAddress                 (nub_process_t pid, const char *name, const char *shlib) DNB_EXPORT;
 nub_size_t      DNBProcessGetAvailableSTDOUT            (nub_process_t pid, char *buf, nub_size_t buf_size) DNB_EXPORT;
 nub_size_t      DNBProcessGetAvailableSTDERR            (nub_process_t pid, char *buf, nub_size_t buf_size) DNB_EXPORT;
+nub_size_t      DNBProcessGetAvailableProfileData       (nub_process_t pid, char *buf, nub_size_t buf_size) DNB_EXPORT;
 nub_size_t      DNBProcessGetStopCount                  (nub_process_t pid) DNB_EXPORT;
 uint32_t        DNBProcessGetCPUType                    (nub_process_t pid) DNB_EXPORT; 
 
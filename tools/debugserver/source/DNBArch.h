@@ -82,6 +82,7 @@ public:
     virtual bool            DisableHardwareWatchpoint (uint32_t hw_index) { return false; }
     virtual uint32_t        GetHardwareWatchpointHit() { return INVALID_NUB_HW_INDEX; }
     virtual bool            StepNotComplete () { return false; }
+    virtual nub_size_t      GetMemoryAccessSize () { return 0; }   // Bytes of memory the instruction at the PC accesses, zero if unknown
 
 protected:
     friend class MachThread;
@@ -135,11 +135,24 @@ enum
     eEventSharedLibsStateChange = 1 << 2,       // Shared libraries loaded/unloaded state has changed
     eEventStdioAvailable = 1 << 3,              // Something is available on stdout/stderr
     eEventProcessAsyncInterrupt = 1 << 4,               // Gives the ability for any infinite wait calls to be interrupted
+    eEventNonStopThreadsStopped = 1 << 5,       // Some threads stopped while the rest of the process keeps running (non-stop mode)
+    eEventProfileDataAvailable = 1 << 6,        // Thread samples from async profiling are available
     kAllEventsMask = eEventProcessRunningStateChanged |
                      eEventProcessStoppedStateChanged |
                      eEventSharedLibsStateChange |
                      eEventStdioAvailable |
-                     eEventProcessAsyncInterrupt
+                     eEventProcessAsyncInterrupt |
+                     eEventNonStopThreadsStopped |
+                     eEventProfileDataAvailable
+};
+
+// What async profiling puts in each sample
+enum DNBProfileDataScanType
+{
+    eProfileThreadStacks    = (1u << 0),    // The PC and return addresses of each thread (the task is suspended for these)
+    eProfileThreadsCPU      = (1u << 1),    // The user and system CPU time of each thread
+    eProfileMemory          = (1u << 2),    // The resident and virtual size of the task
+    eProfileAll             = 0xffffffffu
 };
 
 #define LOG_VERBOSE             (1u << 0)
@@ -354,6 +367,12 @@ struct DNBRegionInfo
     uint32_t permissions;
 };
 
+struct DNBMemoryRange
+{
+    nub_addr_t addr;
+    nub_size_t size;
+};
+
 typedef nub_bool_t (*DNBCallbackBreakpointHit)(nub_process_t pid, nub_thread_t tid, nub_break_t breakID, void *baton);
 typedef nub_addr_t (*DNBCallbackNameToAddress)(nub_process_t pid, const char *name, const char *shlib_regex, void *baton);
 typedef nub_size_t (*DNBCallbackCopyExecutableImageInfos)(nub_process_t pid, struct DNBExecutableImageInfo **image_infos, nub_bool_t only_changed, void *baton);
@@ -82,10 +82,22 @@ MachProcess::MachProcess() :
     m_stdio_thread      (0),
     m_stdio_mutex       (PTHREAD_MUTEX_RECURSIVE),
     m_stdout_data       (),
+    m_profile_thread    (0),
+    m_profile_enabled   (false),
+    m_profile_interval_usec (0),
+    m_profile_max_frames (0),
+    m_profile_scan_type (0),
+    m_profile_data_mutex (PTHREAD_MUTEX_RECURSIVE),
+    m_profile_data      (),
     m_thread_actions    (),
     m_thread_list        (),
     m_exception_messages (),
     m_exception_messages_mutex (PTHREAD_MUTEX_RECURSIVE),
+    m_non_stop          (false),
+    m_non_stop_interrupt (false),
+    m_non_stop_stopped_threads (),
+    m_non_stop_unreported_threads (),
+    m_non_stop_exception_messages (),
     m_state             (eStateUnloaded),
     m_state_mutex       (PTHREAD_MUTEX_RECURSIVE),
     m_events            (0, kAllEventsMask),
@@ -272,6 +284,7 @@ MachProcess::Clear()
 {
     // Clear any cached thread list while the pid and task are still valid
 
+    SetEnableAsyncProfiling (false, 0, 0, 0);
     m_task.Clear();
     // Now clear out all member variables
     m_pid = INVALID_NUB_PROCESS;
@@ -285,6 +298,10 @@ MachProcess::Clear()
     {
         PTHREAD_MUTEX_LOCKER(locker, m_exception_messages_mutex);
         m_exception_messages.clear();
+        m_non_stop_interrupt = false;
+        m_non_stop_stopped_threads.clear();
+        m_non_stop_unreported_threads.clear();
+        m_non_stop_exception_messages.clear();
     }
 }
 
@@ -315,9 +332,29 @@ MachProcess::Resume (const DNBThreadResumeActions& thread_actions)
     if (CanResume(state))
     {
         m_thread_actions = thread_actions;
+        if (m_non_stop)
+        {
+            // Remember the threads that were told to stay stopped, they
+            // are resumed on their own later.
+            PTHREAD_MUTEX_LOCKER (locker, m_exception_messages_mutex);
+            m_non_stop_stopped_threads.clear();
+            m_non_stop_unreported_threads.clear();
+            const nub_size_t num_threads = m_thread_list.NumThreads();
+            for (nub_size_t idx = 0; idx < num_threads; ++idx)
+            {
+                const nub_thread_t tid = m_thread_list.ThreadIDAtIndex(idx);
+                const DNBThreadResumeAction *action = thread_actions.GetActionForThread (tid, true);
+                if (action == NULL || action->state == eStateStopped || action->state == eStateSuspended)
+                    m_non_stop_stopped_threads.insert (tid);
+            }
+        }
         PrivateResume();
         return true;
     }
+    else if (m_non_stop && IsRunning(state))
+    {
+        return NonStopResume (thread_actions);
+    }
     else if (state == eStateRunning)
     {
         DNBLogThreadedIf(LOG_PROCESS, "Resume() - task 0x%x is running, ignoring...", m_task.TaskPort());
@@ -343,6 +380,92 @@ MachProcess::Kill (const struct timespec *timeout_abstime)
     return true;
 }
 
+//----------------------------------------------------------------------
+// Resume some of the stopped threads while the rest of the process is
+// running in non-stop mode. Threads that are running keep doing what
+// they were doing, and stopped threads that THREAD_ACTIONS doesn't
+// resume stay stopped.
+//----------------------------------------------------------------------
+bool
+MachProcess::NonStopResume (const DNBThreadResumeActions& thread_actions)
+{
+    DNBLogThreadedIf(LOG_PROCESS, "MachProcess::NonStopResume ()");
+    PTHREAD_MUTEX_LOCKER (locker, m_exception_messages_mutex);
+
+    // Stop everything while the thread states are changed
+    m_task.Suspend();
+    m_thread_list.ProcessDidStop(this);
+
+    DNBThreadResumeActions new_thread_actions;
+    const nub_size_t num_threads = m_thread_list.NumThreads();
+    for (nub_size_t idx = 0; idx < num_threads; ++idx)
+    {
+        const nub_thread_t tid = m_thread_list.ThreadIDAtIndex(idx);
+        if (m_non_stop_stopped_threads.find (tid) != m_non_stop_stopped_threads.end())
+        {
+            const DNBThreadResumeAction *action = thread_actions.GetActionForThread (tid, true);
+            if (action && (action->state == eStateRunning || action->state == eStateStepping))
+            {
+                DNBThreadResumeAction resume_action = *action;
+                resume_action.tid = tid;
+                new_thread_actions.Append (resume_action);
+                m_non_stop_stopped_threads.erase (tid);
+                m_non_stop_unreported_threads.erase (std::remove (m_non_stop_unreported_threads.begin(),
+                                                                  m_non_stop_unreported_threads.end(),
+                                                                  tid),
+                                                     m_non_stop_unreported_threads.end());
+
+                // The exception that stopped the thread gets its reply now
+                for (size_t i = 0; i < m_non_stop_exception_messages.size(); ++i)
+                {
+                    if (m_non_stop_exception_messages[i].state.thread_port == tid)
+                    {
+                        m_exception_messages.push_back (m_non_stop_exception_messages[i]);
+                        m_non_stop_exception_messages.erase (m_non_stop_exception_messages.begin() + i);
+                        break;
+                    }
+                }
+            }
+            else
+            {
+                new_thread_actions.AppendAction (tid, eStateSuspended);
+            }
+        }
+        else
+        {
+            // Running threads can't be stopped by a resume, they keep
+            // running (or stepping) as they were told to last time.
+            const DNBThreadResumeAction *action = m_thread_actions.GetActionForThread (tid, true);
+            if (action && (action->state == eStateRunning || action->state == eStateStepping))
+                new_thread_actions.AppendAction (tid, action->state);
+            else
+                new_thread_actions.AppendAction (tid, eStateRunning);
+        }
+    }
+    // Threads that show up while resuming run
+    new_thread_actions.SetDefaultThreadActionIfNeeded (eStateRunning, 0);
+
+    m_thread_actions = new_thread_actions;
+    PrivateResume();
+    return true;
+}
+
+//----------------------------------------------------------------------
+// Stop the process. In non-stop mode this stops every thread, not just
+// the one that gets the SIGSTOP.
+//----------------------------------------------------------------------
+bool
+MachProcess::Interrupt ()
+{
+    DNBLogThreadedIf(LOG_PROCESS, "MachProcess::Interrupt ()");
+    if (m_non_stop)
+    {
+        PTHREAD_MUTEX_LOCKER (locker, m_exception_messages_mutex);
+        m_non_stop_interrupt = true;
+    }
+    return Signal (SIGSTOP);
+}
+
 bool
 MachProcess::Signal (int signal, const struct timespec *timeout_abstime)
 {
@@ -890,8 +1013,18 @@ MachProcess::DisableWatchpoint(nub_watch_t watchID, bool remove)
                 return true;
             }
         }
-
-        // TODO: clear software watchpoints if we implement them
+        else if (wp->IsEnabled())
+        {
+            // Watchpoints without a hardware index are watching their pages
+            if (m_task.UnwatchPages (addr, wp->ByteSize(), wp->WatchpointRead()))
+            {
+                wp->SetEnabled(false);
+                if (remove)
+                    m_watchpoints.Remove(watchID);
+                DNBLogThreadedIf(LOG_WATCHPOINTS, "MachProcess::Disablewatchpoint ( watchID = %d, remove = %d ) addr = 0x%8.8llx (page protection) => success", watchID, remove, (uint64_t)addr);
+                return true;
+            }
+        }
     }
     else
     {
@@ -1043,12 +1176,59 @@ MachProcess::EnableWatchpoint(nub_watch_t watchID)
                 wp->SetEnabled(true);
                 return true;
             }
-            // TODO: Add software watchpoints by doing page protection tricks.
+
+            // Out of hardware watchpoints, so take away access to the
+            // pages the watchpoint is on and look at each access that
+            // faults on them instead.
+            if (m_task.WatchPages (addr, wp->ByteSize(), wp->WatchpointRead()))
+            {
+                DNBLogThreadedIf(LOG_WATCHPOINTS, "MachProcess::EnableWatchpoint(watchID = %d) addr = 0x%8.8llx: using page protection.", watchID, (uint64_t)addr);
+                wp->SetEnabled(true);
+                return true;
+            }
         }
     }
     return false;
 }
 
+//----------------------------------------------------------------------
+// A thread faulted at FAULT_ADDR on a page that emulates watchpoints
+// with an access of ACCESS_SIZE bytes. Return the watchpoint the access
+// hit, or INVALID_NUB_WATCH_ID if it only touched an unwatched part of
+// the page.
+//
+// The fault address is the first byte of the access that is on a
+// watched page, so the access covers ACCESS_SIZE bytes from there at
+// most. When the size of the access couldn't be decoded, the largest
+// general purpose register access is assumed. A fault on a page without
+// any read watchers must have been a write.
+//----------------------------------------------------------------------
+nub_watch_t
+MachProcess::GetWatchpointHitByPageFault (nub_addr_t fault_addr, nub_size_t access_size)
+{
+    bool watches_read = false;
+    if (!m_task.IsWatchedPage (fault_addr, &watches_read))
+        return INVALID_NUB_WATCH_ID;
+
+    if (access_size == 0)
+        access_size = sizeof(uint64_t);
+    const nub_addr_t access_end = fault_addr + access_size;
+    DNBBreakpoint *wp;
+    for (uint32_t idx = 0; (wp = m_watchpoints.GetByIndex(idx)) != NULL; ++idx)
+    {
+        if (!wp->IsEnabled() || wp->IsHardware())
+            continue;
+        if (!watches_read && !wp->WatchpointWrite())
+            continue;
+        if (fault_addr < wp->Address() + wp->ByteSize() && wp->Address() < access_end)
+        {
+            DNBLogThreadedIf(LOG_WATCHPOINTS, "MachProcess::GetWatchpointHitByPageFault ( fault_addr = 0x%8.8llx, access_size = %llu ) => watchID = %d", (uint64_t)fault_addr, (uint64_t)access_size, wp->GetID());
+            return wp->GetID();
+        }
+    }
+    return INVALID_NUB_WATCH_ID;
+}
+
 // Called by the exception thread when an exception has been received from
 // our process. The exception message is completely filled and the exception
 // data has already been copied.
@@ -1098,6 +1278,26 @@ MachProcess::ExceptionMessageBundleComplete()
         bool step_more = false;
         if (m_thread_list.ShouldStop(step_more))
         {
+            if (m_non_stop)
+            {
+                if (!m_non_stop_interrupt)
+                {
+                    NonStopThreadsDidStop ();
+                    return;
+                }
+
+                // The client interrupted us, so stop every thread. The
+                // exceptions of the threads that were already stopped get
+                // their replies when the process resumes, like the others.
+                m_non_stop_interrupt = false;
+                m_exception_messages.insert (m_exception_messages.end(),
+                                             m_non_stop_exception_messages.begin(),
+                                             m_non_stop_exception_messages.end());
+                m_non_stop_exception_messages.clear();
+                m_non_stop_stopped_threads.clear();
+                m_non_stop_unreported_threads.clear();
+            }
+
             // Wait for the eEventProcessRunningStateChanged event to be reset
             // before changing state to stopped to avoid race condition with
             // very fast start/stops
@@ -1119,6 +1319,62 @@ MachProcess::ExceptionMessageBundleComplete()
     }
 }
 
+//----------------------------------------------------------------------
+// In non-stop mode only the threads that got exceptions stop. Keep them
+// stopped (without replying to their exceptions), let the rest of the
+// process run again, and let our client know which threads stopped.
+//----------------------------------------------------------------------
+void
+MachProcess::NonStopThreadsDidStop ()
+{
+    PTHREAD_MUTEX_LOCKER (locker, m_exception_messages_mutex);
+    DNBLogThreadedIf(LOG_PROCESS | LOG_EXCEPTIONS, "MachProcess::NonStopThreadsDidStop () %zu exception messages", m_exception_messages.size());
+
+    for (size_t i = 0; i < m_exception_messages.size(); ++i)
+    {
+        const nub_thread_t tid = m_exception_messages[i].state.thread_port;
+        if (m_non_stop_stopped_threads.insert (tid).second)
+            m_non_stop_unreported_threads.push_back (tid);
+        m_non_stop_exception_messages.push_back (m_exception_messages[i]);
+    }
+    m_exception_messages.clear();
+
+    DNBThreadResumeActions thread_actions;
+    const nub_size_t num_threads = m_thread_list.NumThreads();
+    for (nub_size_t idx = 0; idx < num_threads; ++idx)
+    {
+        const nub_thread_t tid = m_thread_list.ThreadIDAtIndex(idx);
+        if (m_non_stop_stopped_threads.find (tid) != m_non_stop_stopped_threads.end())
+        {
+            thread_actions.AppendAction (tid, eStateSuspended);
+        }
+        else
+        {
+            const DNBThreadResumeAction *action = m_thread_actions.GetActionForThread (tid, true);
+            if (action && (action->state == eStateRunning || action->state == eStateStepping))
+                thread_actions.AppendAction (tid, action->state);
+            else
+                thread_actions.AppendAction (tid, eStateRunning);
+        }
+    }
+    thread_actions.SetDefaultThreadActionIfNeeded (eStateRunning, 0);
+    m_thread_actions = thread_actions;
+    PrivateResume ();
+
+    m_events.SetEvents (eEventNonStopThreadsStopped);
+}
+
+nub_thread_t
+MachProcess::GetNextNonStopStoppedThread ()
+{
+    PTHREAD_MUTEX_LOCKER (locker, m_exception_messages_mutex);
+    if (m_non_stop_unreported_threads.empty())
+        return INVALID_NUB_THREAD;
+    const nub_thread_t tid = m_non_stop_unreported_threads.front();
+    m_non_stop_unreported_threads.pop_front();
+    return tid;
+}
+
 nub_size_t
 MachProcess::CopyImageInfos ( struct DNBExecutableImageInfo **image_infos, bool only_changed)
 {
@@ -1173,6 +1429,130 @@ MachProcess::GetAvailableSTDOUT (char *buf, size_t buf_size)
     return bytes_available;
 }
 
+bool
+MachProcess::SetEnableAsyncProfiling (bool enable, uint64_t interval_usec, uint32_t max_frames, uint32_t scan_type)
+{
+    DNBLogThreadedIf(LOG_PROCESS, "MachProcess::%s (enable = %i, interval_usec = %llu, max_frames = %u, scan_type = 0x%x)", __FUNCTION__, enable, interval_usec, max_frames, scan_type);
+    if (enable)
+    {
+        if (interval_usec == 0 || scan_type == 0)
+            return false;
+        if ((scan_type & eProfileThreadStacks) && max_frames == 0)
+            return false;
+        m_profile_interval_usec = interval_usec;
+        m_profile_max_frames = max_frames;
+        m_profile_scan_type = scan_type;
+        if (m_profile_thread == 0)
+        {
+            m_profile_enabled = true;
+            if (::pthread_create (&m_profile_thread, NULL, MachProcess::ProfileThread, this) != 0)
+            {
+                m_profile_thread = 0;
+                m_profile_enabled = false;
+                return false;
+            }
+        }
+    }
+    else if (m_profile_thread != 0)
+    {
+        m_profile_enabled = false;
+        ::pthread_join (m_profile_thread, NULL);
+        m_profile_thread = 0;
+        PTHREAD_MUTEX_LOCKER (locker, m_profile_data_mutex);
+        m_profile_data.clear();
+    }
+    return true;
+}
+
+size_t
+MachProcess::GetAsyncProfileData (char *buf, size_t buf_size)
+{
+    DNBLogThreadedIf(LOG_PROCESS, "MachProcess::%s (&%p[%zu]) ...", __FUNCTION__, buf, buf_size);
+    PTHREAD_MUTEX_LOCKER (locker, m_profile_data_mutex);
+    size_t bytes_available = std::min<size_t> (m_profile_data.size(), buf_size);
+    if (bytes_available > 0)
+    {
+        memcpy(buf, m_profile_data.data(), bytes_available);
+        m_profile_data.erase(0, bytes_available);
+    }
+    return bytes_available;
+}
+
+void
+MachProcess::SampleThreads ()
+{
+    // Don't sample when stopped, the client can look at the threads itself
+    if (!IsRunning (GetState()))
+        return;
+
+    const uint32_t scan_type = m_profile_scan_type;
+    char buf[64];
+    snprintf (buf, sizeof(buf), "time:%llx;", DNBTimer::GetTimeOfDay());
+    std::string record (buf);
+    bool sampled = false;
+
+    if (scan_type & eProfileMemory)
+    {
+        // The counters are read without stopping anything
+        struct task_basic_info task_info;
+        if (m_task.BasicInfo (&task_info) == KERN_SUCCESS)
+        {
+            snprintf (buf, sizeof(buf), "memory:%llx,%llx;", (uint64_t)task_info.resident_size, (uint64_t)task_info.virtual_size);
+            record.append (buf);
+            sampled = true;
+        }
+    }
+
+    if (scan_type & eProfileThreadStacks)
+    {
+        // Suspend the task so the stacks don't change under us and all
+        // the threads are sampled at the same point in time
+        task_t task = m_task.TaskPort();
+        DNBError err (::task_suspend (task), DNBError::MachKernel);
+        if (err.Fail())
+        {
+            if (DNBLogCheckLogBit(LOG_PROCESS))
+                err.LogThreaded("::task_suspend ( target_task = 0x%4.4x )", task);
+        }
+        else
+        {
+            if (m_thread_list.SampleThreads (this, scan_type, m_profile_max_frames, record) > 0)
+                sampled = true;
+            ::task_resume (task);
+        }
+    }
+    else if (scan_type & eProfileThreadsCPU)
+    {
+        // The CPU times alone don't need the threads to hold still
+        if (m_thread_list.SampleThreads (this, scan_type, m_profile_max_frames, record) > 0)
+            sampled = true;
+    }
+    record.append (1, '\n');
+
+    if (sampled)
+    {
+        PTHREAD_MUTEX_LOCKER (locker, m_profile_data_mutex);
+        m_profile_data.append (record);
+        m_events.SetEvents(eEventProfileDataAvailable);
+    }
+}
+
+void *
+MachProcess::ProfileThread(void *arg)
+{
+    MachProcess *proc = (MachProcess*) arg;
+    DNBLogThreadedIf(LOG_PROCESS, "MachProcess::%s ( arg = %p ) thread starting...", __FUNCTION__, arg);
+
+    while (proc->m_profile_enabled)
+    {
+        proc->SampleThreads ();
+        ::usleep (proc->m_profile_interval_usec);
+    }
+
+    DNBLogThreadedIf(LOG_PROCESS, "MachProcess::%s (%p): thread exiting...", __FUNCTION__, arg);
+    return NULL;
+}
+
 nub_addr_t
 MachProcess::GetDYLDAllImageInfosAddress ()
 {
@@ -30,6 +30,8 @@
 #include <mach/mach.h>
 #include <sys/signal.h>
 #include <pthread.h>
+#include <deque>
+#include <set>
 #include <vector>
 
 class DNBThreadResumeActions;
@@ -95,9 +97,11 @@ public:
 
     bool                    Resume (const DNBThreadResumeActions& thread_actions);
     bool                    Signal  (int signal, const struct timespec *timeout_abstime = NULL);
+    bool                    Interrupt ();
     bool                    Kill (const struct timespec *timeout_abstime = NULL);
     bool                    Detach ();
     nub_size_t              ReadMemory (nub_addr_t addr, nub_size_t size, void *buf);
+    void                    PrefetchMemory (const DNBMemoryRange *ranges, nub_size_t num_ranges) { m_task.PrefetchMemory (ranges, num_ranges); }
     nub_size_t              WriteMemory (nub_addr_t addr, nub_size_t size, const void *buf);
 
     //----------------------------------------------------------------------
@@ -130,6 +134,7 @@ public:
     bool                    DisableWatchpoint (nub_watch_t watchID, bool remove);
     nub_size_t              DisableAllWatchpoints (bool remove);
     bool                    EnableWatchpoint (nub_watch_t watchID);
+    nub_watch_t             GetWatchpointHitByPageFault (nub_addr_t fault_addr, nub_size_t access_size);
     void                    DumpWatchpoint(nub_watch_t watchID) const;
     uint32_t                GetNumSupportedHardwareWatchpoints () const;
     DNBBreakpointList&      Watchpoints() { return m_watchpoints; }
@@ -140,6 +145,8 @@ public:
     //----------------------------------------------------------------------
     bool                    StartSTDIOThread ();
     static void *           STDIOThread (void *arg);
+    static void *           ProfileThread (void *arg);
+    void                    SampleThreads ();
     void                    ExceptionMessageReceived (const MachException::Message& exceptionMessage);
     void                    ExceptionMessageBundleComplete ();
     void                    SharedLibrariesUpdated ();
@@ -237,6 +244,22 @@ public:
                             }
 
     bool                    ProcessUsingSpringBoard() const { return (m_flags & eMachProcessFlagsUsingSBS) != 0; }
+
+    //----------------------------------------------------------------------
+    // Non-stop mode: only the threads that get exceptions stop, the rest
+    // of the process keeps running while the stopped threads are looked at
+    //----------------------------------------------------------------------
+    void                    SetNonStopMode (bool enable) { m_non_stop = enable; }
+    bool                    GetNonStopMode () const { return m_non_stop; }
+    nub_thread_t            GetNextNonStopStoppedThread ();
+
+    //----------------------------------------------------------------------
+    // Async profiling: while the process runs, a thread periodically
+    // samples the threads and the task (see DNBProfileDataScanType) and
+    // queues the records up for the client
+    //----------------------------------------------------------------------
+    bool                    SetEnableAsyncProfiling (bool enable, uint64_t interval_usec, uint32_t max_frames, uint32_t scan_type);
+    size_t                  GetAsyncProfileData (char *buf, size_t buf_size);
 private:
     enum
     {
@@ -247,6 +270,8 @@ private:
     void                    Clear ();
     void                    ReplyToAllExceptions ();
     void                    PrivateResume ();
+    void                    NonStopThreadsDidStop ();
+    bool                    NonStopResume (const DNBThreadResumeActions& thread_actions);
     nub_size_t              RemoveTrapsFromBuffer (nub_addr_t addr, nub_size_t size, uint8_t *buf) const;
 
     uint32_t                Flags () const { return m_flags; }
@@ -266,10 +291,23 @@ private:
     pthread_t                   m_stdio_thread;             // Thread ID for the thread that watches for child process stdio
     PThreadMutex                m_stdio_mutex;              // Multithreaded protection for stdio
     std::string                 m_stdout_data;
+    pthread_t                   m_profile_thread;           // Thread ID for the thread that samples the threads for async profiling
+    bool                        m_profile_enabled;          // Set to false to make the profile thread exit
+    uint64_t                    m_profile_interval_usec;    // Time between two samples
+    uint32_t                    m_profile_max_frames;       // Maximum number of PCs per thread in each sample
+    uint32_t                    m_profile_scan_type;        // What goes in each sample (DNBProfileDataScanType bits)
+    PThreadMutex                m_profile_data_mutex;       // Multithreaded protection for m_profile_data
+    std::string                 m_profile_data;             // Sample records that haven't been sent yet
     DNBThreadResumeActions      m_thread_actions;           // The thread actions for the current MachProcess::Resume() call
     MachException::Message::collection
                                 m_exception_messages;       // A collection of exception messages caught when listening to the exception port
-    PThreadMutex                m_exception_messages_mutex; // Multithreaded protection for m_exception_messages
+    PThreadMutex                m_exception_messages_mutex; // Multithreaded protection for m_exception_messages and the non-stop members below
+    bool                        m_non_stop;                 // Only stop the threads that get exceptions
+    bool                        m_non_stop_interrupt;       // The process was interrupted in non-stop mode, so the next stop stops every thread
+    std::set<nub_thread_t>      m_non_stop_stopped_threads; // The threads that are stopped while the rest of the process runs
+    std::deque<nub_thread_t>    m_non_stop_unreported_threads; // Stopped threads the client hasn't been told about yet
+    MachException::Message::collection
+                                m_non_stop_exception_messages; // The exceptions of the stopped threads, replied to when they resume
 
     MachThreadList              m_thread_list;               // A list of threads that is maintained/updated after each stop
     nub_state_t                 m_state;                    // The state of our process
@@ -30,6 +30,7 @@
 #include "DNBError.h"
 #include "DNBLog.h"
 #include "MachProcess.h"
+#include "MachVMRegion.h"
 #include "DNBDataRef.h"
 #include "stack_logging.h"
 
@@ -49,7 +50,9 @@ MachTask::MachTask(MachProcess *process) :
     m_task (TASK_NULL),
     m_vm_memory (),
     m_exception_thread (0),
-    m_exception_port (MACH_PORT_NULL)
+    m_exception_port (MACH_PORT_NULL),
+    m_watched_pages (),
+    m_watched_pages_mutex (PTHREAD_MUTEX_RECURSIVE)
 {
     memset(&m_exc_port_info, 0, sizeof(m_exc_port_info));
 
@@ -90,6 +93,9 @@ MachTask::Resume()
 	if (task == TASK_NULL)
 		return KERN_INVALID_ARGUMENT;
 
+    // Memory can change once the task runs
+    m_vm_memory.ClearCache();
+
     DNBError err;
     err = BasicInfo(task, &task_info);
 
@@ -137,7 +143,9 @@ MachTask::Clear()
     m_task = TASK_NULL;
     m_exception_thread = 0;
     m_exception_port = MACH_PORT_NULL;
-
+    m_vm_memory.ClearCache();
+    PThreadMutex::Locker locker (m_watched_pages_mutex);
+    m_watched_pages.clear();
 }
 
 
@@ -170,7 +178,11 @@ MachTask::ReadMemory (nub_addr_t addr, nub_size_t size, void *buf)
     task_t task = TaskPort();
     if (task != TASK_NULL)
     {
-        n = m_vm_memory.Read(task, addr, buf, size);
+        // Pages that emulate read watchpoints can't be read until their
+        // protections are put back
+        SuspendPageWatches (addr, size);
+        n = m_vm_memory.Read(task, addr, buf, size, UseMemoryCache());
+        ResumePageWatches (addr, size);
 
         DNBLogThreadedIf(LOG_MEMORY, "MachTask::ReadMemory ( addr = 0x%8.8llx, size = %zu, buf = %p) => %zu bytes read", (uint64_t)addr, size, buf, n);
         if (DNBLogCheckLogBit(LOG_MEMORY_DATA_LONG) || (DNBLogCheckLogBit(LOG_MEMORY_DATA_SHORT) && size <= 8))
@@ -183,6 +195,43 @@ MachTask::ReadMemory (nub_addr_t addr, nub_size_t size, void *buf)
 }
 
 
+//----------------------------------------------------------------------
+// MachTask::PrefetchMemory
+//
+// Read the pages of several ranges into the memory cache with as few
+// calls as possible, so reading the ranges one at a time afterwards
+// doesn't go to the kernel for each one.
+//----------------------------------------------------------------------
+void
+MachTask::PrefetchMemory (const DNBMemoryRange *ranges, nub_size_t num_ranges)
+{
+    task_t task = TaskPort();
+    if (task == TASK_NULL || !UseMemoryCache())
+        return;
+    nub_size_t i;
+    for (i = 0; i < num_ranges; ++i)
+        SuspendPageWatches (ranges[i].addr, ranges[i].size);
+    m_vm_memory.PrefetchPages (task, ranges, num_ranges);
+    for (i = 0; i < num_ranges; ++i)
+        ResumePageWatches (ranges[i].addr, ranges[i].size);
+}
+
+//----------------------------------------------------------------------
+// MachTask::UseMemoryCache
+//
+// Memory can only be cached while nothing in the task can change it,
+// which is while the whole process is stopped. In non-stop mode other
+// threads keep running.
+//----------------------------------------------------------------------
+bool
+MachTask::UseMemoryCache ()
+{
+    if (m_process == NULL || m_process->GetNonStopMode())
+        return false;
+    const nub_state_t state = m_process->GetState();
+    return state == eStateStopped || state == eStateCrashed;
+}
+
 //----------------------------------------------------------------------
 // MachTask::WriteMemory
 //----------------------------------------------------------------------
@@ -225,6 +274,197 @@ MachTask::GetMemoryRegionInfo (nub_addr_t addr, DNBRegionInfo *region_info)
 }
 
 
+//----------------------------------------------------------------------
+// MachTask::WatchPages
+//
+// Watchpoints that don't get a hardware watchpoint register are emulated
+// by taking write access away from the pages they are on, and read
+// access too for watchpoints that watch reads. Any access that faults on
+// one of those pages is checked against the watchpoints by MachProcess,
+// and the thread steps over the faulting instruction with the page
+// watches suspended.
+//----------------------------------------------------------------------
+bool
+MachTask::WatchPages (nub_addr_t addr, nub_size_t size, bool watch_read)
+{
+    task_t task = TaskPort();
+    if (task == TASK_NULL || size == 0)
+        return false;
+
+    PThreadMutex::Locker locker (m_watched_pages_mutex);
+    const nub_size_t page_size = m_vm_memory.PageSize();
+    if (page_size == 0)
+        return false;
+    const nub_addr_t end_addr = addr + size;
+    nub_addr_t page_addr;
+
+    // Find out the protections of the pages that aren't watched yet before
+    // changing anything, so a range that isn't all mapped changes nothing.
+    watched_page_collection new_pages;
+    for (page_addr = addr & ~(page_size - 1); page_addr < end_addr; page_addr += page_size)
+    {
+        if (m_watched_pages.find (page_addr) != m_watched_pages.end())
+            continue;
+        MachVMRegion region (task);
+        if (!region.GetRegionForAddress (page_addr))
+        {
+            DNBLogThreadedIf(LOG_WATCHPOINTS, "MachTask::WatchPages ( addr = 0x%8.8llx, size = %llu ) page 0x%8.8llx isn't mapped", (uint64_t)addr, (uint64_t)size, (uint64_t)page_addr);
+            return false;
+        }
+        WatchedPage page = { region.GetProtection(), 0, 0, 0 };
+        new_pages[page_addr] = page;
+    }
+    m_watched_pages.insert (new_pages.begin(), new_pages.end());
+
+    bool success = true;
+    for (page_addr = addr & ~(page_size - 1); page_addr < end_addr; page_addr += page_size)
+    {
+        WatchedPage &page = m_watched_pages[page_addr];
+        ++page.num_watchers;
+        if (watch_read)
+            ++page.num_read_watchers;
+        if (!ProtectWatchedPage (page_addr, page))
+            success = false;
+    }
+
+    if (!success)
+        UnwatchPages (addr, size, watch_read);
+    return success;
+}
+
+//----------------------------------------------------------------------
+// MachTask::UnwatchPages
+//
+// Undo a WatchPages call with the same arguments. Pages that nothing
+// watches anymore get their original protections back.
+//----------------------------------------------------------------------
+bool
+MachTask::UnwatchPages (nub_addr_t addr, nub_size_t size, bool watch_read)
+{
+    if (size == 0)
+        return false;
+
+    PThreadMutex::Locker locker (m_watched_pages_mutex);
+    const nub_size_t page_size = m_vm_memory.PageSize();
+    if (page_size == 0)
+        return false;
+    const nub_addr_t end_addr = addr + size;
+    bool success = true;
+    for (nub_addr_t page_addr = addr & ~(page_size - 1); page_addr < end_addr; page_addr += page_size)
+    {
+        watched_page_collection::iterator pos = m_watched_pages.find (page_addr);
+        if (pos == m_watched_pages.end())
+        {
+            success = false;
+            continue;
+        }
+        WatchedPage &page = pos->second;
+        if (page.num_watchers > 0)
+            --page.num_watchers;
+        if (watch_read && page.num_read_watchers > 0)
+            --page.num_read_watchers;
+        if (page.num_watchers == 0)
+        {
+            page.suspend_count = 1;
+            if (TaskPort() != TASK_NULL && !ProtectWatchedPage (page_addr, page))
+                success = false;
+            m_watched_pages.erase (pos);
+        }
+        else if (!ProtectWatchedPage (page_addr, page))
+        {
+            success = false;
+        }
+    }
+    return success;
+}
+
+//----------------------------------------------------------------------
+// MachTask::IsWatchedPage
+//
+// Returns true if the page that contains ADDR has its protections lowered
+// to emulate watchpoints. WATCHES_READ is set to true if reads from the
+// page fault as well as writes to it.
+//----------------------------------------------------------------------
+bool
+MachTask::IsWatchedPage (nub_addr_t addr, bool *watches_read)
+{
+    PThreadMutex::Locker locker (m_watched_pages_mutex);
+    if (m_watched_pages.empty())
+        return false;
+    const nub_size_t page_size = m_vm_memory.PageSize();
+    watched_page_collection::const_iterator pos = m_watched_pages.find (addr & ~(page_size - 1));
+    if (pos == m_watched_pages.end())
+        return false;
+    if (watches_read)
+        *watches_read = pos->second.num_read_watchers > 0;
+    return true;
+}
+
+//----------------------------------------------------------------------
+// MachTask::SuspendPageWatches
+//
+// Give the watched pages in [ADDR, ADDR+SIZE) their original protections
+// back until the matching ResumePageWatches call. Calls nest.
+//----------------------------------------------------------------------
+void
+MachTask::SuspendPageWatches (nub_addr_t addr, nub_size_t size)
+{
+    PThreadMutex::Locker locker (m_watched_pages_mutex);
+    if (m_watched_pages.empty() || size == 0)
+        return;
+    const nub_size_t page_size = m_vm_memory.PageSize();
+    watched_page_collection::iterator pos = m_watched_pages.lower_bound (addr & ~(page_size - 1));
+    watched_page_collection::iterator end = m_watched_pages.lower_bound (addr + size);
+    for (; pos != end; ++pos)
+    {
+        if (pos->second.suspend_count++ == 0)
+            ProtectWatchedPage (pos->first, pos->second);
+    }
+}
+
+//----------------------------------------------------------------------
+// MachTask::ResumePageWatches
+//----------------------------------------------------------------------
+void
+MachTask::ResumePageWatches (nub_addr_t addr, nub_size_t size)
+{
+    PThreadMutex::Locker locker (m_watched_pages_mutex);
+    if (m_watched_pages.empty() || size == 0)
+        return;
+    const nub_size_t page_size = m_vm_memory.PageSize();
+    watched_page_collection::iterator pos = m_watched_pages.lower_bound (addr & ~(page_size - 1));
+    watched_page_collection::iterator end = m_watched_pages.lower_bound (addr + size);
+    for (; pos != end; ++pos)
+    {
+        if (pos->second.suspend_count > 0 && --pos->second.suspend_count == 0)
+            ProtectWatchedPage (pos->first, pos->second);
+    }
+}
+
+//----------------------------------------------------------------------
+// MachTask::ProtectWatchedPage
+//
+// Set the protections of a watched page: its original protections while
+// its watches are suspended, else without write access, and without
+// read access too if any of its watchpoints watch reads.
+//----------------------------------------------------------------------
+bool
+MachTask::ProtectWatchedPage (nub_addr_t page_addr, const WatchedPage &page)
+{
+    vm_prot_t prot = page.protection;
+    if (page.suspend_count == 0)
+    {
+        prot &= ~VM_PROT_WRITE;
+        if (page.num_read_watchers > 0)
+            prot &= ~VM_PROT_READ;
+    }
+    DNBError err;
+    err = ::mach_vm_protect (TaskPort(), page_addr, m_vm_memory.PageSize(), 0, prot);
+    if (DNBLogCheckLogBit(LOG_WATCHPOINTS) || err.Fail())
+        err.LogThreaded("::mach_vm_protect ( task = 0x%4.4x, addr = 0x%8.8llx, size = %llu, set_max = %i, prot = %u )", TaskPort(), (uint64_t)page_addr, (uint64_t)m_vm_memory.PageSize(), 0, prot);
+    return err.Success();
+}
+
 //----------------------------------------------------------------------
 // MachTask::TaskPortForProcessID
 //----------------------------------------------------------------------
@@ -698,6 +938,9 @@ MachTask::DeallocateMemory (nub_addr_t addr)
     if (task == TASK_NULL)
         return false;
 
+    // The pages we had cached may be gone
+    m_vm_memory.ClearCache();
+
     // We have to stash away sizes for the allocations...
     allocation_collection::iterator pos, end = m_allocations.end();
     for (pos = m_allocations.begin(); pos != end; pos++)
@@ -63,9 +63,17 @@ public:
             kern_return_t   Resume ();
 
             nub_size_t      ReadMemory (nub_addr_t addr, nub_size_t size, void *buf);
+            void            PrefetchMemory (const DNBMemoryRange *ranges, nub_size_t num_ranges);
             nub_size_t      WriteMemory (nub_addr_t addr, nub_size_t size, const void *buf);
             int             GetMemoryRegionInfo (nub_addr_t addr, DNBRegionInfo *region_info);
 
+            bool            WatchPages (nub_addr_t addr, nub_size_t size, bool watch_read);
+            bool            UnwatchPages (nub_addr_t addr, nub_size_t size, bool watch_read);
+            bool            IsWatchedPage (nub_addr_t addr, bool *watches_read = NULL);
+            void            SuspendPageWatches (nub_addr_t addr, nub_size_t size);
+            void            ResumePageWatches (nub_addr_t addr, nub_size_t size);
+            nub_size_t      PageSize () { return m_vm_memory.PageSize(); }
+
             nub_addr_t      AllocateMemory (nub_size_t size, uint32_t permissions);
             nub_bool_t      DeallocateMemory (nub_addr_t addr);
 
@@ -111,6 +119,8 @@ public:
                                                    uint32_t *count);
 
 protected:
+            bool            UseMemoryCache ();
+
             MachProcess *   m_process;                  // The mach process that owns this MachTask
             task_t          m_task;
             MachVMMemory    m_vm_memory;                // Special mach memory reading class that will take care of watching for page and region boundaries
@@ -122,6 +132,20 @@ protected:
             typedef std::map <mach_vm_address_t, size_t> allocation_collection;
             allocation_collection m_allocations;
 
+            // A page whose protections were lowered to emulate watchpoints
+            struct WatchedPage
+            {
+                vm_prot_t   protection;         // The protections the page had before it was watched
+                uint32_t    num_watchers;       // The number of watchpoints on this page
+                uint32_t    num_read_watchers;  // How many of those also watch reads
+                uint32_t    suspend_count;      // Non-zero while the page has its original protections back
+            };
+            typedef std::map <nub_addr_t, WatchedPage> watched_page_collection;
+            watched_page_collection m_watched_pages;
+            PThreadMutex    m_watched_pages_mutex;
+
+            bool            ProtectWatchedPage (nub_addr_t page_addr, const WatchedPage &page);
+
 private:
     MachTask(const MachTask&); // Outlaw
     MachTask& operator=(const MachTask& rhs);// Outlaw
@@ -15,6 +15,7 @@
 #include "MachProcess.h"
 #include "DNBLog.h"
 #include "DNB.h"
+#include <mach/mach_vm.h>
 
 static uint32_t
 GetSequenceID()
@@ -30,6 +31,11 @@ MachThread::MachThread (MachProcess *process, thread_t tid) :
     m_state (eStateUnloaded),
     m_state_mutex (PTHREAD_MUTEX_RECURSIVE),
     m_break_id (INVALID_NUB_BREAK_ID),
+    m_stepping_over_break (false),
+    m_watch_fault_addr (INVALID_NUB_ADDRESS),
+    m_watch_hit_id (INVALID_NUB_WATCH_ID),
+    m_stepping_over_watched_page (false),
+    m_resume_state (eStateInvalid),
     m_suspend_count (0),
     m_stop_exception (),
     m_arch_ap (DNBArchProtocol::Create (this)),
@@ -331,6 +337,67 @@ MachThread::GetSP(uint64_t failValue)
     return m_arch_ap->GetSP(failValue);
 }
 
+//----------------------------------------------------------------------
+// Grab the PC and up to "max_frames - 1" return addresses by following
+// the frame pointer chain. This is used for profiling samples which are
+// taken while the task is suspended but not stopped, so the registers
+// are always re-read and the stack is read directly from the task
+// without going through the process memory cache.
+//----------------------------------------------------------------------
+uint32_t
+MachThread::SampleStack(uint32_t max_frames, std::vector<nub_addr_t> &pcs)
+{
+    pcs.clear();
+    if (max_frames == 0)
+        return 0;
+
+    if (!GetRegisterState (REGISTER_SET_ALL, true))
+        return 0;
+
+    const nub_addr_t pc = GetPC(INVALID_NUB_ADDRESS);
+    if (pc == INVALID_NUB_ADDRESS)
+        return 0;
+    pcs.push_back(pc);
+
+    DNBRegisterValue fp_value;
+    if (!GetRegisterValue (REGISTER_SET_GENERIC, GENERIC_REGNUM_FP, &fp_value))
+        return pcs.size();
+
+    const uint32_t addr_size = fp_value.info.size == 8 ? 8 : 4;
+    mach_vm_address_t fp = addr_size == 8 ? fp_value.value.uint64 : fp_value.value.uint32;
+    const task_t task = m_process->Task().TaskPort();
+    while (pcs.size() < max_frames && fp != 0 && (fp & (addr_size - 1)) == 0)
+    {
+        // The saved frame pointer is at [fp] and the return address follows it
+        uint8_t frame[16];
+        mach_vm_size_t bytes_read = 0;
+        if (::mach_vm_read_overwrite (task, fp, addr_size * 2, (mach_vm_address_t)frame, &bytes_read) != KERN_SUCCESS ||
+            bytes_read != addr_size * 2)
+            break;
+
+        mach_vm_address_t next_fp;
+        nub_addr_t return_addr;
+        if (addr_size == 8)
+        {
+            next_fp = *(uint64_t *)frame;
+            return_addr = *(uint64_t *)(frame + 8);
+        }
+        else
+        {
+            next_fp = *(uint32_t *)frame;
+            return_addr = *(uint32_t *)(frame + 4);
+        }
+        if (return_addr == 0)
+            break;
+        pcs.push_back(return_addr);
+        // Stacks grow down, so a frame that doesn't move up is garbage
+        if (next_fp <= fp)
+            break;
+        fp = next_fp;
+    }
+    return pcs.size();
+}
+
 nub_process_t
 MachThread::ProcessID() const
 {
@@ -396,7 +463,52 @@ MachThread::ThreadWillResume(const DNBThreadResumeAction *thread_action, bool ot
         break;
     }
     m_arch_ap->ThreadWillResume();
-    m_stop_exception.Clear();
+    // Threads held stopped in non-stop mode still have to report why they
+    // stopped while the rest of the process runs
+    if (!(thread_action->state == eStateSuspended && m_process->GetNonStopMode()))
+        m_stop_exception.Clear();
+    m_resume_state = thread_action->state;
+}
+
+//----------------------------------------------------------------------
+// A breakpoint callback told us not to stop at the breakpoint this
+// thread is sitting at, so take the breakpoint out of the way and single
+// step this thread alone over it. ThreadDidStop() puts the breakpoint
+// back, and ShouldStop() then decides whether to keep going based on
+// what the client asked this thread to do in THREAD_ACTION.
+//----------------------------------------------------------------------
+void
+MachThread::ThreadWillStepOverBreakpoint (const DNBThreadResumeAction *thread_action)
+{
+    DNBLogThreadedIf(LOG_THREAD | LOG_BREAKPOINTS, "MachThread::%s ( ) tid = 0x%4.4x stepping over breakpoint %d", __FUNCTION__, m_tid, m_break_id);
+    m_process->DisableBreakpoint (m_break_id, false);
+
+    DNBThreadResumeAction step_action = { m_tid, eStateStepping, 0, INVALID_NUB_ADDRESS };
+    ThreadWillResume (&step_action, true);
+    m_stepping_over_break = true;
+    m_resume_state = thread_action->state;
+}
+
+//----------------------------------------------------------------------
+// This thread faulted on a page whose protections were lowered to
+// emulate watchpoints. Put back the protections of the page, and of the
+// pages on either side of it in case the access straddles them, and
+// single step this thread alone over the access. ThreadDidStop() lowers
+// the protections again, and ShouldStop() reports the watchpoint the
+// access hit, if any.
+//----------------------------------------------------------------------
+void
+MachThread::ThreadWillStepOverWatchedPage (const DNBThreadResumeAction *thread_action)
+{
+    DNBLogThreadedIf(LOG_THREAD | LOG_WATCHPOINTS, "MachThread::%s ( ) tid = 0x%4.4x stepping over access at 0x%8.8llx", __FUNCTION__, m_tid, (uint64_t)m_watch_fault_addr);
+    MachTask &task = m_process->Task();
+    const nub_size_t page_size = task.PageSize();
+    task.SuspendPageWatches ((m_watch_fault_addr & ~(page_size - 1)) - page_size, 3 * page_size);
+
+    DNBThreadResumeAction step_action = { m_tid, eStateStepping, 0, INVALID_NUB_ADDRESS };
+    ThreadWillResume (&step_action, true);
+    m_stepping_over_watched_page = true;
+    m_resume_state = thread_action->state;
 }
 
 nub_break_t
@@ -405,9 +517,82 @@ MachThread::CurrentBreakpoint()
     return m_process->Breakpoints().FindIDByAddress(GetPC());
 }
 
+//----------------------------------------------------------------------
+// The hardware watchpoint this thread stopped for, if the access it
+// stopped for has already happened. The arch plug-ins piggyback the
+// hardware index on the exception data of watchpoint hits.
+//----------------------------------------------------------------------
+nub_watch_t
+MachThread::CurrentWatchpoint()
+{
+#if defined (__arm__)
+    // ARM stops before the instruction that accesses the watched memory
+    // runs, so there is nothing we could check yet.
+    return INVALID_NUB_WATCH_ID;
+#else
+    const MachException::Data &exc = GetStopException();
+    if (exc.IsValid() && exc.exc_type == EXC_BREAKPOINT && exc.exc_data.size() == 3 && exc.exc_data[0] == 1)
+        return m_process->Watchpoints().FindIDByAddress(exc.exc_data[1]);
+    return INVALID_NUB_WATCH_ID;
+#endif
+}
+
 bool
 MachThread::ShouldStop(bool &step_more)
 {
+    const bool stepped_over_break = m_stepping_over_break;
+    m_stepping_over_break = false;
+
+    if (m_stepping_over_watched_page)
+    {
+        m_stepping_over_watched_page = false;
+        const nub_watch_t watchID = m_watch_hit_id;
+        m_watch_hit_id = INVALID_NUB_WATCH_ID;
+
+        // A real crash or a signal during the step wins over the watchpoint
+        if (GetStopException().IsValid() && !GetStopException().IsBreakpoint())
+            return true;
+
+        const DNBBreakpoint *wp = NUB_WATCH_ID_IS_VALID(watchID) ? Process()->Watchpoints().FindByID(watchID) : NULL;
+        // The watchpoint's condition, if it has one, sees the value
+        // after the access.
+        if (wp && !Process()->Watchpoints().ShouldStop(ProcessID(), ThreadID(), watchID))
+            wp = NULL;
+        if (wp)
+        {
+            // Report the access the same way a hardware watchpoint hit
+            // is reported, with the address of the watchpoint.
+            m_stop_exception.task_port = Process()->Task().TaskPort();
+            m_stop_exception.thread_port = m_tid;
+            m_stop_exception.exc_type = EXC_BREAKPOINT;
+            m_stop_exception.exc_data.clear();
+#if defined (__arm__)
+            m_stop_exception.exc_data.push_back(EXC_ARM_DA_DEBUG);
+#else
+            m_stop_exception.exc_data.push_back(1); // EXC_I386_SGL
+#endif
+            m_stop_exception.exc_data.push_back(wp->Address());
+            return true;
+        }
+
+        // The access only touched unwatched memory on the page, or the
+        // watchpoint's condition was false. Stop only if the client asked
+        // for this step, else keep going.
+        return m_resume_state == eStateStepping && GetStopException().IsValid();
+    }
+
+    // Ask the watchpoint this thread hit, if any, whether we should be
+    // stopping here. The access has already happened, so there is nothing
+    // to step over if we keep going.
+    const nub_watch_t watchID = CurrentWatchpoint();
+    if (NUB_WATCH_ID_IS_VALID(watchID))
+    {
+        if (Process()->Watchpoints().ShouldStop(ProcessID(), ThreadID(), watchID))
+            return true;
+        // A single step that ran into the watchpoint is still done
+        return m_resume_state == eStateStepping;
+    }
+
     // See if this thread is at a breakpoint?
     nub_break_t breakID = CurrentBreakpoint();
 
@@ -427,8 +612,25 @@ MachThread::ShouldStop(bool &step_more)
             // be a SIGINT signal).
             if (GetStopException().IsValid() && !GetStopException().IsBreakpoint())
                 return true;
+
+            if (GetStopException().IsValid())
+            {
+                // This thread really stopped at the breakpoint. If we were
+                // single stepping it, the step is done and our client needs
+                // to hear about it. Otherwise we need to step over the
+                // breakpoint when we resume, or we will just hit it again.
+                if (m_resume_state == eStateStepping)
+                    return true;
+                m_break_id = breakID;
+            }
         }
     }
+    else if (stepped_over_break && m_resume_state == eStateRunning)
+    {
+        // We are past the breakpoint we stepped over, keep going unless
+        // the step ran into some other kind of exception.
+        return GetStopException().IsValid() && !GetStopException().IsBreakpoint();
+    }
     else
     {
         if (m_arch_ap->StepNotComplete())
@@ -500,6 +702,21 @@ MachThread::ThreadDidStop()
     // Update the basic information for a thread
     MachThread::GetBasicInfo(m_tid, &m_basic_info);
 
+    // Put back the breakpoint we just single stepped over.
+    if (m_stepping_over_break)
+        m_process->EnableBreakpoint(m_break_id);
+    m_break_id = INVALID_NUB_BREAK_ID;
+
+    // Take access to the watched pages around the access we just single
+    // stepped over away again.
+    if (m_stepping_over_watched_page)
+    {
+        MachTask &task = m_process->Task();
+        const nub_size_t page_size = task.PageSize();
+        task.ResumePageWatches ((m_watch_fault_addr & ~(page_size - 1)) - page_size, 3 * page_size);
+    }
+    m_watch_fault_addr = INVALID_NUB_ADDRESS;
+
 #if ENABLE_AUTO_STEPPING_OVER_BP
     // See if we were at a breakpoint when we last resumed that we disabled,
     // re-enable it.
@@ -552,6 +769,23 @@ MachThread::ThreadDidStop()
 bool
 MachThread::NotifyException(MachException::Data& exc)
 {
+    // A fault on a page whose protections were lowered to emulate
+    // watchpoints isn't a crash. Remember the access, this thread has to
+    // step over it with the page's protections put back before we know
+    // whether it needs to stop. A fault while stepping over such an
+    // access happened with the protections put back, so it is real.
+    if (!m_stepping_over_watched_page &&
+        exc.exc_type == EXC_BAD_ACCESS &&
+        exc.exc_data.size() >= 2 &&
+        exc.exc_data[0] == KERN_PROTECTION_FAILURE &&
+        m_process->Task().IsWatchedPage (exc.exc_data[1]))
+    {
+        m_watch_fault_addr = exc.exc_data[1];
+        m_watch_hit_id = m_process->GetWatchpointHitByPageFault (m_watch_fault_addr, m_arch_ap->GetMemoryAccessSize());
+        DNBLogThreadedIf(LOG_WATCHPOINTS, "MachThread::NotifyException ( ) tid = 0x%4.4x faulted on watched page at 0x%8.8llx (watchID = %d)", m_tid, (uint64_t)m_watch_fault_addr, m_watch_hit_id);
+        return true;
+    }
+
     // Allow the arch specific protocol to process (MachException::Data &)exc
     // first before possible reassignment of m_stop_exception with exc.
     // See also MachThread::GetStopException().
@@ -59,8 +59,10 @@ public:
     uint64_t        GetPC(uint64_t failValue = INVALID_NUB_ADDRESS);    // Get program counter
     bool            SetPC(uint64_t value);                              // Set program counter
     uint64_t        GetSP(uint64_t failValue = INVALID_NUB_ADDRESS);    // Get stack pointer
+    uint32_t        SampleStack(uint32_t max_frames, std::vector<nub_addr_t> &pcs); // Get the PC and return addresses, the task must be suspended
 
     nub_break_t     CurrentBreakpoint();
+    nub_watch_t     CurrentWatchpoint();
     uint32_t        EnableHardwareBreakpoint (const DNBBreakpoint *breakpoint);
     uint32_t        EnableHardwareWatchpoint (const DNBBreakpoint *watchpoint);
     bool            DisableHardwareBreakpoint (const DNBBreakpoint *breakpoint);
@@ -73,6 +75,12 @@ public:
     void            SetState(nub_state_t state);
 
     void            ThreadWillResume (const DNBThreadResumeAction *thread_action, bool others_stopped = false);
+    void            ThreadWillStepOverBreakpoint (const DNBThreadResumeAction *thread_action);
+    nub_break_t     BreakpointToStepOver() const { return m_break_id; }
+    void            ClearBreakpointToStepOver() { m_break_id = INVALID_NUB_BREAK_ID; }
+    void            ThreadWillStepOverWatchedPage (const DNBThreadResumeAction *thread_action);
+    nub_addr_t      WatchedPageToStepOver() const { return m_watch_fault_addr; }
+    void            ClearWatchedPageToStepOver() { m_watch_fault_addr = INVALID_NUB_ADDRESS; m_watch_hit_id = INVALID_NUB_WATCH_ID; }
     bool            ShouldStop(bool &step_more);
     bool            IsStepping();
     bool            ThreadDidStop();
@@ -120,7 +128,12 @@ protected:
     uint32_t                        m_seq_id;       // A Sequential ID that increments with each new thread
     nub_state_t                     m_state;        // The state of our process
     PThreadMutex                    m_state_mutex;  // Multithreaded protection for m_state
-    nub_break_t                     m_break_id;     // Breakpoint that this thread is (stopped)/was(running) at (NULL for none)
+    nub_break_t                     m_break_id;     // Breakpoint that this thread is (stopped)/was(running) at and needs to step over (NULL for none)
+    bool                            m_stepping_over_break; // True if we are single stepping this thread over m_break_id
+    nub_addr_t                      m_watch_fault_addr; // Address this thread faulted at on a page that emulates watchpoints (INVALID_NUB_ADDRESS for none)
+    nub_watch_t                     m_watch_hit_id; // The watchpoint the access at m_watch_fault_addr hit, if any
+    bool                            m_stepping_over_watched_page; // True if we are single stepping this thread over the access at m_watch_fault_addr
+    nub_state_t                     m_resume_state; // The state the client last asked this thread to resume with
     struct thread_basic_info        m_basic_info;   // Basic information for a thread used to see if a thread is valid
     int32_t                         m_suspend_count; // The current suspend count > 0 means we have suspended m_suspendCount times,
                                                     //                           < 0 means we have resumed it m_suspendCount times.
@@ -278,6 +278,81 @@ MachThreadList::UpdateThreadList(MachProcess *process, bool update, MachThreadLi
 }
 
 
+//----------------------------------------------------------------------
+// Append the profiling entries for all threads in the task to "record":
+//
+//   thread:<tid>,<pc>,<pc>...;             (eProfileThreadStacks)
+//   threadcpu:<tid>,<user usec>,<system usec>;  (eProfileThreadsCPU)
+//
+// with all numbers in hex. The task must be suspended for the stacks. The
+// thread list is only updated when the process stops, so threads that
+// were created since then are sampled with a temporary MachThread.
+//----------------------------------------------------------------------
+uint32_t
+MachThreadList::SampleThreads (MachProcess *process, uint32_t scan_type, uint32_t max_frames, std::string &record)
+{
+    PTHREAD_MUTEX_LOCKER (locker, m_threads_mutex);
+
+    thread_array_t thread_list = NULL;
+    mach_msg_type_number_t thread_list_count = 0;
+    task_t task = process->Task().TaskPort();
+    DNBError err(::task_threads (task, &thread_list, &thread_list_count), DNBError::MachKernel);
+    if (err.Fail())
+    {
+        if (DNBLogCheckLogBit(LOG_THREAD))
+            err.LogThreaded("::task_threads ( task = 0x%4.4x, thread_list => %p, thread_list_count => %u )", task, thread_list, thread_list_count);
+        return 0;
+    }
+
+    char buf[64];
+    uint32_t num_sampled = 0;
+    std::vector<nub_addr_t> pcs;
+    for (mach_msg_type_number_t idx = 0; idx < thread_list_count; ++idx)
+    {
+        const thread_t tid = thread_list[idx];
+        MachThreadSP thread_sp (GetThreadByID (tid));
+        if (!thread_sp)
+            thread_sp.reset(new MachThread(process, tid));
+
+        bool sampled = false;
+        if ((scan_type & eProfileThreadStacks) && thread_sp->SampleStack (max_frames, pcs) > 0)
+        {
+            snprintf (buf, sizeof(buf), "thread:%x", tid);
+            record.append(buf);
+            for (size_t i = 0; i < pcs.size(); ++i)
+            {
+                snprintf (buf, sizeof(buf), ",%llx", (uint64_t)pcs[i]);
+                record.append(buf);
+            }
+            record.append(1, ';');
+            sampled = true;
+        }
+
+        if (scan_type & eProfileThreadsCPU)
+        {
+            const struct thread_basic_info *basic_info = thread_sp->GetBasicInfo();
+            if (basic_info)
+            {
+                const uint64_t user_usec = (uint64_t)basic_info->user_time.seconds * 1000000ull + basic_info->user_time.microseconds;
+                const uint64_t system_usec = (uint64_t)basic_info->system_time.seconds * 1000000ull + basic_info->system_time.microseconds;
+                snprintf (buf, sizeof(buf), "threadcpu:%x,%llx,%llx;", tid, user_usec, system_usec);
+                record.append(buf);
+                sampled = true;
+            }
+        }
+
+        if (sampled)
+            ++num_sampled;
+    }
+
+    // Free the vm memory given to us by ::task_threads()
+    vm_size_t thread_list_size = (vm_size_t) (thread_list_count * sizeof (thread_t));
+    ::vm_deallocate (::mach_task_self(),
+                     (vm_address_t)thread_list,
+                     thread_list_size);
+    return num_sampled;
+}
+
 void
 MachThreadList::CurrentThread (MachThreadSP& thread_sp)
 {
@@ -345,13 +420,34 @@ MachThreadList::ProcessWillResume(MachProcess *process, const DNBThreadResumeAct
 
     UpdateThreadList(process, true, &new_threads);
 
+    const uint32_t num_new_threads = new_threads.size();
+    const uint32_t num_threads = m_threads.size();
+
+    // If a breakpoint callback told us not to stop at a breakpoint that a
+    // thread is sitting at, or a thread faulted on a page that emulates
+    // watchpoints, that thread has to step over the breakpoint or the
+    // access on its own before anything else gets to run. Any other threads
+    // that need to do the same will get their turn on the next resume.
+    MachThread *step_over_thread = NULL;
+    for (uint32_t idx = 0; step_over_thread == NULL && idx < num_threads; ++idx)
+    {
+        MachThread *thread = m_threads[idx].get();
+        if (NUB_BREAK_ID_IS_VALID(thread->BreakpointToStepOver()) ||
+            thread->WatchedPageToStepOver() != INVALID_NUB_ADDRESS)
+        {
+            const DNBThreadResumeAction *thread_action = thread_actions.GetActionForThread (thread->ThreadID(), true);
+            if (thread_action &&
+                thread_action->addr == INVALID_NUB_ADDRESS &&
+                (thread_action->state == eStateRunning || thread_action->state == eStateStepping))
+                step_over_thread = thread;
+        }
+    }
+
     DNBThreadResumeAction resume_new_threads = { -1U, eStateRunning, 0, INVALID_NUB_ADDRESS };
     // If we are planning to run only one thread, any new threads should be suspended.
-    if (run_one_thread)
+    if (run_one_thread || step_over_thread)
         resume_new_threads.state = eStateSuspended;
 
-    const uint32_t num_new_threads = new_threads.size();
-    const uint32_t num_threads = m_threads.size();
     for (uint32_t idx = 0; idx < num_threads; ++idx)
     {
         MachThread *thread = m_threads[idx].get();
@@ -371,10 +467,25 @@ MachThreadList::ProcessWillResume(MachProcess *process, const DNBThreadResumeAct
             const DNBThreadResumeAction *thread_action = thread_actions.GetActionForThread (thread->ThreadID(), true);
             // There must always be a thread action for every thread.
             assert (thread_action);
-            bool others_stopped = false;
-            if (solo_thread == thread->ThreadID())
-                others_stopped = true;
-            thread->ThreadWillResume (thread_action, others_stopped);
+            if (step_over_thread == thread)
+            {
+                if (NUB_BREAK_ID_IS_VALID(thread->BreakpointToStepOver()))
+                    thread->ThreadWillStepOverBreakpoint (thread_action);
+                else
+                    thread->ThreadWillStepOverWatchedPage (thread_action);
+            }
+            else if (step_over_thread)
+            {
+                DNBThreadResumeAction suspend_thread = { thread->ThreadID(), eStateSuspended, 0, INVALID_NUB_ADDRESS };
+                thread->ThreadWillResume (&suspend_thread);
+            }
+            else
+            {
+                bool others_stopped = false;
+                if (solo_thread == thread->ThreadID())
+                    others_stopped = true;
+                thread->ThreadWillResume (thread_action, others_stopped);
+            }
         }
     }
     
@@ -425,6 +536,18 @@ MachThreadList::ShouldStop(bool &step_more)
     {
         should_stop = m_threads[idx]->ShouldStop(step_more);
     }
+
+    // If we are stopping, our client will decide how to get the threads
+    // past any breakpoints they are sitting at. Threads that faulted on a
+    // watched page will just fault again when they are resumed.
+    if (should_stop)
+    {
+        for (uint32_t idx = 0; idx < num_threads; ++idx)
+        {
+            m_threads[idx]->ClearBreakpointToStepOver();
+            m_threads[idx]->ClearWatchedPageToStepOver();
+        }
+    }
     return should_stop;
 }
 
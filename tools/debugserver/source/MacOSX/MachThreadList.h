@@ -51,6 +51,7 @@ public:
     uint32_t        EnableHardwareWatchpoint (const DNBBreakpoint *wp) const;
     bool            DisableHardwareWatchpoint (const DNBBreakpoint *wp) const;
     uint32_t        NumSupportedHardwareWatchpoints () const;
+    uint32_t        SampleThreads (MachProcess *process, uint32_t scan_type, uint32_t max_frames, std::string &record);
 
     uint32_t        GetThreadIndexForThreadStoppedWithSignal (const int signo) const;
 
@@ -15,15 +15,24 @@
 #include "MachVMRegion.h"
 #include "DNBLog.h"
 #include <mach/mach_vm.h>
+#include <algorithm>
+#include <vector>
+
+// The most memory we keep in the page cache before starting over
+#define MAX_PAGE_CACHE_BYTES    (8 * 1024 * 1024)
 
 MachVMMemory::MachVMMemory() :
     m_page_size    (kInvalidPageSize),
-    m_err        (0)
+    m_err        (0),
+    m_page_cache_mutex (PTHREAD_MUTEX_RECURSIVE),
+    m_page_cache (),
+    m_page_cache_bytes (0)
 {
 }
 
 MachVMMemory::~MachVMMemory()
 {
+    ClearCache();
 }
 
 nub_size_t
@@ -89,11 +98,164 @@ MachVMMemory::GetMemoryRegionInfo(task_t task, nub_addr_t address, DNBRegionInfo
 }
 
 nub_size_t
-MachVMMemory::Read(task_t task, nub_addr_t address, void *data, nub_size_t data_count)
+MachVMMemory::Read(task_t task, nub_addr_t address, void *data, nub_size_t data_count, bool use_cache)
 {
     if (data == NULL || data_count == 0)
         return 0;
 
+    const nub_size_t page_size = PageSize();
+    if (!use_cache || page_size == 0)
+        return ReadFromTask(task, address, data, data_count);
+
+    PThreadMutex::Locker locker (m_page_cache_mutex);
+    nub_size_t total_bytes_read = 0;
+    uint8_t *curr_data = (uint8_t*)data;
+    while (total_bytes_read < data_count)
+    {
+        const nub_addr_t curr_addr = address + total_bytes_read;
+        page_cache_collection::const_iterator pos = m_page_cache.upper_bound(curr_addr);
+        if (pos != m_page_cache.begin())
+        {
+            --pos;
+            if (curr_addr < pos->first + pos->second.size)
+            {
+                const nub_size_t num_bytes = std::min<nub_size_t> (data_count - total_bytes_read, pos->first + pos->second.size - curr_addr);
+                ::memcpy (curr_data + total_bytes_read, (const uint8_t *)pos->second.data + (curr_addr - pos->first), num_bytes);
+                total_bytes_read += num_bytes;
+                continue;
+            }
+        }
+
+        // Read all the pages up to the end of this read, or up to the
+        // next pages we already have, with one call
+        const nub_addr_t page_addr = curr_addr & ~(nub_addr_t)(page_size - 1);
+        nub_addr_t end_addr = (address + data_count + page_size - 1) & ~(nub_addr_t)(page_size - 1);
+        pos = m_page_cache.lower_bound(page_addr);
+        if (pos != m_page_cache.end() && pos->first < end_addr)
+            end_addr = pos->first;
+        if (!ReadPagesIntoCache(task, page_addr, end_addr - page_addr))
+        {
+            // Some page can't be read, get what we can a page at a time
+            return total_bytes_read + ReadFromTask(task, curr_addr, curr_data + total_bytes_read, data_count - total_bytes_read);
+        }
+    }
+    return total_bytes_read;
+}
+
+void
+MachVMMemory::PrefetchPages(task_t task, const DNBMemoryRange *ranges, nub_size_t num_ranges)
+{
+    const nub_size_t page_size = PageSize();
+    if (page_size == 0 || ranges == NULL || num_ranges == 0)
+        return;
+
+    // The page spans the ranges cover, with the ones that touch or
+    // overlap merged together so each is read with one call
+    std::vector<std::pair<nub_addr_t, nub_addr_t> > spans;
+    for (nub_size_t i = 0; i < num_ranges; ++i)
+    {
+        if (ranges[i].size == 0)
+            continue;
+        const nub_addr_t start = ranges[i].addr & ~(nub_addr_t)(page_size - 1);
+        const nub_addr_t end = (ranges[i].addr + ranges[i].size + page_size - 1) & ~(nub_addr_t)(page_size - 1);
+        if (end > start)
+            spans.push_back (std::make_pair (start, end));
+    }
+    std::sort (spans.begin(), spans.end());
+
+    PThreadMutex::Locker locker (m_page_cache_mutex);
+    size_t i = 0;
+    while (i < spans.size())
+    {
+        nub_addr_t span_start = spans[i].first;
+        const nub_addr_t span_end_limit = span_start + MAX_PAGE_CACHE_BYTES;
+        nub_addr_t span_end = spans[i].second;
+        for (++i; i < spans.size() && spans[i].first <= span_end && spans[i].second <= span_end_limit; ++i)
+            span_end = std::max (span_end, spans[i].second);
+
+        // Read the parts of the span that aren't cached yet
+        while (span_start < span_end)
+        {
+            page_cache_collection::const_iterator pos = m_page_cache.upper_bound(span_start);
+            if (pos != m_page_cache.begin())
+            {
+                page_cache_collection::const_iterator prev = pos;
+                --prev;
+                if (span_start < prev->first + prev->second.size)
+                {
+                    span_start = prev->first + prev->second.size;
+                    continue;
+                }
+            }
+            const nub_addr_t read_end = (pos != m_page_cache.end() && pos->first < span_end) ? pos->first : span_end;
+            // If the pages can't all be read, Read() gets what it can later
+            ReadPagesIntoCache(task, span_start, read_end - span_start);
+            span_start = read_end;
+        }
+    }
+}
+
+bool
+MachVMMemory::ReadPagesIntoCache(task_t task, nub_addr_t page_addr, mach_vm_size_t size)
+{
+    vm_offset_t vm_memory = NULL;
+    mach_msg_type_number_t bytes_read = 0;
+    m_err = ::mach_vm_read (task, page_addr, size, &vm_memory, &bytes_read);
+    if (DNBLogCheckLogBit(LOG_MEMORY))
+        m_err.LogThreaded("::mach_vm_read ( task = 0x%4.4x, addr = 0x%8.8llx, size = %llu, data => %8.8p, dataCnt => %i ) for the page cache", task, (uint64_t)page_addr, (uint64_t)size, vm_memory, bytes_read);
+    if (m_err.Fail())
+        return false;
+    if (bytes_read != size)
+    {
+        ::vm_deallocate (mach_task_self (), vm_memory, bytes_read);
+        return false;
+    }
+
+    if (m_page_cache_bytes + size > MAX_PAGE_CACHE_BYTES)
+        ClearCache();
+    CachedPages pages = { vm_memory, size };
+    m_page_cache[page_addr] = pages;
+    m_page_cache_bytes += size;
+    return true;
+}
+
+void
+MachVMMemory::ClearCache()
+{
+    PThreadMutex::Locker locker (m_page_cache_mutex);
+    page_cache_collection::iterator pos, end = m_page_cache.end();
+    for (pos = m_page_cache.begin(); pos != end; ++pos)
+        ::vm_deallocate (mach_task_self (), pos->second.data, pos->second.size);
+    m_page_cache.clear();
+    m_page_cache_bytes = 0;
+}
+
+void
+MachVMMemory::InvalidateCache(nub_addr_t address, nub_size_t size)
+{
+    PThreadMutex::Locker locker (m_page_cache_mutex);
+    if (m_page_cache.empty() || size == 0)
+        return;
+    page_cache_collection::iterator pos = m_page_cache.upper_bound(address);
+    if (pos != m_page_cache.begin())
+    {
+        page_cache_collection::iterator prev = pos;
+        --prev;
+        if (address < prev->first + prev->second.size)
+            pos = prev;
+    }
+    while (pos != m_page_cache.end() && pos->first < address + size)
+    {
+        ::vm_deallocate (mach_task_self (), pos->second.data, pos->second.size);
+        m_page_cache_bytes -= pos->second.size;
+        m_page_cache.erase (pos++);
+    }
+}
+
+nub_size_t
+MachVMMemory::ReadFromTask(task_t task, nub_addr_t address, void *data, nub_size_t data_count)
+{
+
     nub_size_t total_bytes_read = 0;
     nub_addr_t curr_addr = address;
     uint8_t *curr_data = (uint8_t*)data;
@@ -134,6 +296,10 @@ MachVMMemory::Write(task_t task, nub_addr_t address, const void *data, nub_size_
 {
     MachVMRegion vmRegion(task);
 
+    // Changing the protections to write can copy the pages, so just
+    // drop the cached ones and read them again if they are wanted
+    InvalidateCache(address, data_count);
+
     nub_size_t total_bytes_written = 0;
     nub_addr_t curr_addr = address;
     const uint8_t *curr_data = (const uint8_t*)data;
@@ -16,7 +16,9 @@
 
 #include "DNBDefs.h"
 #include "DNBError.h"
+#include "PThreadMutex.h"
 #include <mach/mach.h>
+#include <map>
 
 class MachVMMemory
 {
@@ -24,17 +26,41 @@ public:
     enum { kInvalidPageSize = ~0 };
     MachVMMemory();
     ~MachVMMemory();
-    nub_size_t Read(task_t task, nub_addr_t address, void *data, nub_size_t data_count);
+    nub_size_t Read(task_t task, nub_addr_t address, void *data, nub_size_t data_count, bool use_cache = false);
     nub_size_t Write(task_t task, nub_addr_t address, const void *data, nub_size_t data_count);
     nub_size_t PageSize();
     nub_bool_t GetMemoryRegionInfo(task_t task, nub_addr_t address, DNBRegionInfo *region_info);
 
+    // While the task is suspended, whole pages are read into a cache
+    // with as few mach_vm_read calls as possible and later reads of the
+    // same pages are copied out of it. The cache has to be cleared when
+    // the task runs or its memory map changes, writes keep it up to date.
+    void       PrefetchPages(task_t task, const DNBMemoryRange *ranges, nub_size_t num_ranges);
+    void       ClearCache();
+
 protected:
     nub_size_t MaxBytesLeftInPage(nub_addr_t addr, nub_size_t count);
 
+    nub_size_t ReadFromTask(task_t task, nub_addr_t address, void *data, nub_size_t data_count);
+    bool       ReadPagesIntoCache(task_t task, nub_addr_t page_addr, mach_vm_size_t size);
+    void       InvalidateCache(nub_addr_t address, nub_size_t size);
+
     nub_size_t WriteRegion(task_t task, const nub_addr_t address, const void *data, const nub_size_t data_count);
+
+    // Page aligned copies of the task's memory as mach_vm_read gave
+    // them to us, by the address they start at. They never overlap.
+    struct CachedPages
+    {
+        vm_offset_t data;
+        mach_vm_size_t size;
+    };
+    typedef std::map<nub_addr_t, CachedPages> page_cache_collection;
+
     vm_size_t        m_page_size;
     DNBError    m_err;
+    PThreadMutex     m_page_cache_mutex;
+    page_cache_collection m_page_cache;
+    mach_vm_size_t   m_page_cache_bytes;
 };
 
 
@@ -47,6 +47,12 @@ public:
     uint32_t
     GetDNBPermissions () const;
 
+    vm_prot_t
+    GetProtection () const
+    {
+        return m_data.protection;
+    }
+
     const DNBError &
     GetError ()
     {
@@ -976,6 +976,21 @@ DNBArchImplI386::GetHardwareWatchpointHit(nub_addr_t &addr)
     return INVALID_NUB_HW_INDEX;
 }
 
+//----------------------------------------------------------------------
+// Returns the number of bytes of memory the instruction at the PC of
+// this thread accesses, or zero if that isn't known.
+//----------------------------------------------------------------------
+nub_size_t
+DNBArchImplI386::GetMemoryAccessSize ()
+{
+    const nub_addr_t pc = GetPC(INVALID_NUB_ADDRESS);
+    if (pc == INVALID_NUB_ADDRESS)
+        return 0;
+    uint8_t opcode[15];
+    const nub_size_t opcode_size = m_thread->Process()->ReadMemory(pc, sizeof(opcode), opcode);
+    return DNBArchImplX86_64::DecodeMemoryAccessSize (opcode, opcode_size, false);
+}
+
 // Set the single step bit in the processor status register.
 kern_return_t
 DNBArchImplI386::EnableHardwareSingleStep (bool enable)
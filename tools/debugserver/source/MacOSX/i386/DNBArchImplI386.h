@@ -58,6 +58,7 @@ public:
     virtual bool            DisableHardwareWatchpoint (uint32_t hw_break_index);
     virtual void            HardwareWatchpointStateChanged ();
     virtual uint32_t        GetHardwareWatchpointHit(nub_addr_t &addr);
+    virtual nub_size_t      GetMemoryAccessSize ();
 
 protected:
     kern_return_t           EnableHardwareSingleStep (bool enable);
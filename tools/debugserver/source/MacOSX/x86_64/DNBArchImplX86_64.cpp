@@ -951,6 +951,226 @@ DNBArchImplX86_64::GetHardwareWatchpointHit(nub_addr_t &addr)
     return INVALID_NUB_HW_INDEX;
 }
 
+//----------------------------------------------------------------------
+// Returns the number of bytes of memory the instruction at the PC of
+// this thread accesses, or zero if that isn't known. Used to find out
+// which watchpoints an access that faulted on a watched page hit.
+//----------------------------------------------------------------------
+nub_size_t
+DNBArchImplX86_64::GetMemoryAccessSize ()
+{
+    const nub_addr_t pc = GetPC(INVALID_NUB_ADDRESS);
+    if (pc == INVALID_NUB_ADDRESS)
+        return 0;
+    uint8_t opcode[15];
+    const nub_size_t opcode_size = m_thread->Process()->ReadMemory(pc, sizeof(opcode), opcode);
+    return DecodeMemoryAccessSize (opcode, opcode_size, true);
+}
+
+//----------------------------------------------------------------------
+// Decode the size of the memory operand of the x86 or x86_64 instruction
+// in OPCODE. String instructions access one element per iteration. Only
+// the general purpose, x87, SSE and AVX forms that move data to or from
+// memory are decoded, zero is returned for anything else.
+//----------------------------------------------------------------------
+nub_size_t
+DNBArchImplX86_64::DecodeMemoryAccessSize (const uint8_t *opcode, nub_size_t opcode_size, bool is_64_bit)
+{
+    nub_size_t idx = 0;
+    bool opsize_prefix = false;
+    uint8_t simd_prefix = 0;    // The last of 0x66, 0xF2 or 0xF3
+    bool rex_w = false;
+
+    // Legacy prefixes
+    for (; idx < opcode_size; ++idx)
+    {
+        const uint8_t byte = opcode[idx];
+        if (byte == 0x66)
+        {
+            opsize_prefix = true;
+            simd_prefix = byte;
+        }
+        else if (byte == 0xF2 || byte == 0xF3)
+            simd_prefix = byte;
+        else if (byte != 0xF0 && byte != 0x67 &&
+                 byte != 0x26 && byte != 0x2E && byte != 0x36 && byte != 0x3E &&
+                 byte != 0x64 && byte != 0x65)
+            break;
+    }
+    if (is_64_bit && idx < opcode_size && (opcode[idx] & 0xF0) == 0x40)
+        rex_w = (opcode[idx++] & 0x08) != 0;
+    if (idx >= opcode_size)
+        return 0;
+
+    const nub_size_t osize = rex_w ? 8 : (opsize_prefix ? 2 : 4);
+    const nub_size_t ptr_size = is_64_bit ? 8 : 4;
+    const nub_size_t stack_size = opsize_prefix ? 2 : ptr_size;
+    const uint8_t op = opcode[idx++];
+    const uint8_t reg = idx < opcode_size ? (opcode[idx] >> 3) & 7 : 0;
+
+    // VEX encoded AVX instructions. In 32 bit code 0xC4 and 0xC5 are LES
+    // and LDS unless the byte after them looks like a register ModRM.
+    if ((op == 0xC4 || op == 0xC5) && idx < opcode_size && (is_64_bit || (opcode[idx] & 0xC0) == 0xC0))
+    {
+        uint8_t map = 1, vex_pp, vex_l;
+        bool vex_w = false;
+        if (op == 0xC5)
+        {
+            if (idx + 1 >= opcode_size)
+                return 0;
+            vex_pp = opcode[idx] & 3;
+            vex_l = (opcode[idx] >> 2) & 1;
+            idx += 1;
+        }
+        else
+        {
+            if (idx + 2 >= opcode_size)
+                return 0;
+            map = opcode[idx] & 0x1F;
+            vex_w = (opcode[idx + 1] & 0x80) != 0;
+            vex_pp = opcode[idx + 1] & 3;
+            vex_l = (opcode[idx + 1] >> 2) & 1;
+            idx += 2;
+        }
+        const nub_size_t vector_size = vex_l ? 32 : 16;
+        if (map != 1)
+            return vector_size;
+        const uint8_t vex_op = opcode[idx];
+        switch (vex_op)
+        {
+        case 0x10: case 0x11:
+            return vex_pp == 2 ? 4 : (vex_pp == 3 ? 8 : vector_size);
+        case 0x12: case 0x13: case 0x16: case 0x17: case 0xD6:
+            return 8;
+        case 0x6E: case 0x7E:
+            return (vex_op == 0x7E && vex_pp == 2) ? 8 : (vex_w ? 8 : 4);
+        default:
+            if (vex_op >= 0x51 && vex_op <= 0x5F && vex_pp >= 2)
+                return vex_pp == 2 ? 4 : 8;
+            return vector_size;
+        }
+    }
+
+    if (op == 0x0F)
+    {
+        if (idx >= opcode_size)
+            return 0;
+        const uint8_t op2 = opcode[idx++];
+        const uint8_t reg2 = idx < opcode_size ? (opcode[idx] >> 3) & 7 : 0;
+        switch (op2)
+        {
+        case 0x10: case 0x11:       // movups, movupd, movss, movsd
+        case 0x51: case 0x52: case 0x53: case 0x54: case 0x55: case 0x56: case 0x57:
+        case 0x58: case 0x59: case 0x5A: case 0x5B: case 0x5C: case 0x5D: case 0x5E: case 0x5F:
+            if (simd_prefix == 0xF3)
+                return 4;
+            if (simd_prefix == 0xF2)
+                return 8;
+            return 16;
+        case 0x12: case 0x13: case 0x16: case 0x17:     // movlps, movhps, movlpd, movhpd
+            return 8;
+        case 0x14: case 0x15: case 0x28: case 0x29: case 0x2B:
+            return 16;
+        case 0x2A:
+            return (simd_prefix == 0xF2 || simd_prefix == 0xF3) ? (rex_w ? 8 : 4) : 8;
+        case 0x2C: case 0x2D:
+            return simd_prefix == 0xF3 ? 4 : (simd_prefix == 0x66 ? 16 : 8);
+        case 0x2E: case 0x2F:       // ucomiss, comiss, ucomisd, comisd
+            return simd_prefix == 0x66 ? 8 : 4;
+        case 0x6E:                  // movd, movq
+            return rex_w ? 8 : 4;
+        case 0x7E:
+            return simd_prefix == 0xF3 ? 8 : (rex_w ? 8 : 4);
+        case 0x6F: case 0x7F:
+            return simd_prefix ? 16 : 8;
+        case 0xD6:                  // movq
+            return 8;
+        case 0xB0: case 0xC0:       // cmpxchg, xadd
+        case 0xB6: case 0xBE:       // movzx, movsx
+            return 1;
+        case 0xB7: case 0xBF:
+            return 2;
+        case 0xB1: case 0xC1: case 0xC3:
+        case 0xA3: case 0xAB: case 0xB3: case 0xBB: case 0xBA:
+        case 0xA4: case 0xA5: case 0xAC: case 0xAD: case 0xAF:
+            return osize;
+        case 0xC7:                  // cmpxchg8b, cmpxchg16b
+            return reg2 == 1 ? (rex_w ? 16 : 8) : 0;
+        default:
+            if (op2 >= 0x40 && op2 <= 0x4F)     // cmovcc
+                return osize;
+            if (op2 >= 0x90 && op2 <= 0x9F)     // setcc
+                return 1;
+            if ((op2 >= 0x60 && op2 <= 0x6D) || (op2 >= 0x70 && op2 <= 0x76) || op2 >= 0xD0)
+                return simd_prefix == 0x66 ? 16 : 8;
+            return 0;
+        }
+    }
+
+    // Arithmetic and logical instructions, even opcodes work on bytes
+    if (op < 0x40 && (op & 7) < 4)
+        return (op & 1) ? osize : 1;
+
+    switch (op)
+    {
+    case 0x50: case 0x51: case 0x52: case 0x53: case 0x54: case 0x55: case 0x56: case 0x57:
+    case 0x58: case 0x59: case 0x5A: case 0x5B: case 0x5C: case 0x5D: case 0x5E: case 0x5F:
+    case 0x68: case 0x6A: case 0x8F: case 0x9C: case 0x9D:
+    case 0xC2: case 0xC3: case 0xC9: case 0xE8:
+        return stack_size;
+    case 0x63:                      // movsxd, or arpl in 32 bit code
+        return is_64_bit ? 4 : 2;
+    case 0x69: case 0x6B: case 0x81: case 0x83: case 0x85: case 0x87: case 0x89: case 0x8B:
+    case 0xA1: case 0xA3: case 0xA5: case 0xA7: case 0xAB: case 0xAD: case 0xAF:
+    case 0xC1: case 0xC7: case 0xD1: case 0xD3: case 0xF7:
+        return osize;
+    case 0x80: case 0x82: case 0x84: case 0x86: case 0x88: case 0x8A:
+    case 0xA0: case 0xA2: case 0xA4: case 0xA6: case 0xAA: case 0xAC: case 0xAE:
+    case 0xC0: case 0xC6: case 0xD0: case 0xD2: case 0xF6: case 0xFE:
+        return 1;
+    case 0x8C: case 0x8E:
+        return 2;
+    case 0xFF:
+        // inc and dec, else call, jmp and push through memory
+        return reg < 2 ? osize : stack_size;
+    case 0xD8: case 0xDA: case 0xDC: case 0xDE:
+        // x87 arithmetic: 32 bit float, 32 bit int, 64 bit float, 16 bit int
+        return op == 0xDC ? 8 : (op == 0xDE ? 2 : 4);
+    case 0xD9:
+        switch (reg)
+        {
+        case 0: case 2: case 3: return 4;       // fld, fst, fstp m32
+        case 5: case 7:         return 2;       // fldcw, fnstcw
+        case 4: case 6:         return 28;      // fldenv, fnstenv
+        }
+        return 0;
+    case 0xDB:
+        switch (reg)
+        {
+        case 0: case 1: case 2: case 3: return 4;   // fild, fisttp, fist, fistp m32
+        case 5: case 7:                 return 10;  // fld, fstp m80
+        }
+        return 0;
+    case 0xDD:
+        switch (reg)
+        {
+        case 0: case 1: case 2: case 3: return 8;   // fld, fisttp, fst, fstp m64
+        case 4: case 6:                 return 108; // frstor, fnsave
+        case 7:                         return 2;   // fnstsw
+        }
+        return 0;
+    case 0xDF:
+        switch (reg)
+        {
+        case 0: case 1: case 2: case 3: return 2;   // fild, fisttp, fist, fistp m16
+        case 4: case 6:                 return 10;  // fbld, fbstp
+        case 5: case 7:                 return 8;   // fild, fistp m64
+        }
+        return 0;
+    }
+    return 0;
+}
+
 // Set the single step bit in the processor status register.
 kern_return_t
 DNBArchImplX86_64::EnableHardwareSingleStep (bool enable)
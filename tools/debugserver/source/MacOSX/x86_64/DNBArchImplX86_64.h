@@ -57,6 +57,9 @@ public:
     virtual bool            DisableHardwareWatchpoint (uint32_t hw_break_index);
     virtual void            HardwareWatchpointStateChanged ();
     virtual uint32_t        GetHardwareWatchpointHit(nub_addr_t &addr);
+    virtual nub_size_t      GetMemoryAccessSize ();
+
+    static nub_size_t       DecodeMemoryAccessSize (const uint8_t *opcode, nub_size_t opcode_size, bool is_64_bit);
 
 protected:
     kern_return_t           EnableHardwareSingleStep (bool enable);
@@ -32,12 +32,16 @@ public:
         event_read_packet_available     = 0x10,
         event_read_thread_running       = 0x20, // Sticky
         event_read_thread_exiting       = 0x40,
+        event_proc_threads_stopped      = 0x80, // Some threads stopped in non-stop mode
+        event_proc_profile_data         = 0x100,
 
         normal_event_bits   = event_proc_state_changed |
                               event_proc_thread_exiting |
                               event_proc_stdio_available |
                               event_read_packet_available |
-                              event_read_thread_exiting,
+                              event_read_thread_exiting |
+                              event_proc_threads_stopped |
+                              event_proc_profile_data,
 
         sticky_event_bits   = event_proc_thread_running |
                               event_read_thread_running,
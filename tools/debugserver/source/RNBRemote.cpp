@@ -14,9 +14,11 @@
 #include "RNBRemote.h"
 
 #include <errno.h>
+#include <limits.h>
 #include <unistd.h>
 #include <signal.h>
 #include <mach/exception_types.h>
+#include <mach-o/loader.h>
 #include <sys/stat.h>
 #include <sys/sysctl.h>
 
@@ -28,6 +30,7 @@
 #include "RNBSocket.h"
 #include "Utility/StringExtractor.h"
 
+#include <algorithm>
 #include <iomanip>
 #include <sstream>
 
@@ -74,11 +77,13 @@ RNBRemote::RNBRemote () :
     m_rx_pthread(0),
     m_breakpoints(),
     m_max_payload_size(DEFAULT_GDB_REMOTE_PROTOCOL_BUFSIZE - 4),
+    m_compression_min_size(0),
     m_extended_mode(false),
     m_noack_mode(false),
     m_use_native_regs (false),
     m_thread_suffix_supported (false),
-    m_list_threads_in_stop_reply (false)
+    m_list_threads_in_stop_reply (false),
+    m_non_stop_notification_pending (false)
 {
     DNBLogThreadedIf (LOG_RNB_REMOTE, "%s", __PRETTY_FUNCTION__);
     CreatePacketTable ();
@@ -115,6 +120,7 @@ RNBRemote::CreatePacketTable  ()
     t.push_back (Packet (ack,                           NULL,                                   NULL, "+", "ACK"));
     t.push_back (Packet (nack,                          NULL,                                   NULL, "-", "!ACK"));
     t.push_back (Packet (read_memory,                   &RNBRemote::HandlePacket_m,             NULL, "m", "Read memory"));
+    t.push_back (Packet (read_memory_binary,            &RNBRemote::HandlePacket_x,             NULL, "x", "Read memory (binary)"));
     t.push_back (Packet (read_register,                 &RNBRemote::HandlePacket_p,             NULL, "p", "Read one register"));
     t.push_back (Packet (read_general_regs,             &RNBRemote::HandlePacket_g,             NULL, "g", "Read registers"));
     t.push_back (Packet (write_memory,                  &RNBRemote::HandlePacket_M,             NULL, "M", "Write memory"));
@@ -164,17 +170,23 @@ RNBRemote::CreatePacketTable  ()
     // syntax: qThreadStopInfoTTTT
     //  TTTT is hex thread ID
     t.push_back (Packet (query_thread_stop_info,        &RNBRemote::HandlePacket_qThreadStopInfo,   NULL, "qThreadStopInfo", "Get detailed info on why the specified thread stopped"));
+    t.push_back (Packet (query_threads_stop_info,       &RNBRemote::HandlePacket_qThreadsStopInfo,  NULL, "qThreadsStopInfo", "Get detailed info on why all threads stopped in a single packet"));
     t.push_back (Packet (query_thread_extra_info,       &RNBRemote::HandlePacket_qThreadExtraInfo,NULL, "qThreadExtraInfo", "Get printable status of a thread"));
 //  t.push_back (Packet (query_image_offsets,           &RNBRemote::HandlePacket_UNIMPLEMENTED, NULL, "qOffsets", "Report offset of loaded program"));
     t.push_back (Packet (query_launch_success,          &RNBRemote::HandlePacket_qLaunchSuccess,NULL, "qLaunchSuccess", "Report the success or failure of the launch attempt"));
     t.push_back (Packet (query_register_info,           &RNBRemote::HandlePacket_qRegisterInfo, NULL, "qRegisterInfo", "Dynamically discover remote register context information."));
     t.push_back (Packet (query_shlib_notify_info_addr,  &RNBRemote::HandlePacket_qShlibInfoAddr,NULL, "qShlibInfoAddr", "Returns the address that contains info needed for getting shared library notifications"));
+    t.push_back (Packet (query_shlib_infos,             &RNBRemote::HandlePacket_qShlibInfos,NULL, "qShlibInfos:", "Returns the paths, mach headers, UUIDs and segments of the shared libraries in a dyld_image_info array"));
     t.push_back (Packet (query_step_packet_supported,   &RNBRemote::HandlePacket_qStepPacketSupported,NULL, "qStepPacketSupported", "Replys with OK if the 's' packet is supported."));
     t.push_back (Packet (query_vattachorwait_supported, &RNBRemote::HandlePacket_qVAttachOrWaitSupported,NULL, "qVAttachOrWaitSupported", "Replys with OK if the 'vAttachOrWait' packet is supported."));
     t.push_back (Packet (query_sync_thread_state_supported, &RNBRemote::HandlePacket_qSyncThreadStateSupported,NULL, "qSyncThreadStateSupported", "Replys with OK if the 'QSyncThreadState:' packet is supported."));
+    t.push_back (Packet (query_breakpoint_conditions_supported, &RNBRemote::HandlePacket_qBreakpointConditionsSupported,NULL, "qBreakpointConditionsSupported", "Replys with OK if 'Z0' through 'Z4' packets can have agent expression conditions."));
     t.push_back (Packet (query_host_info,               &RNBRemote::HandlePacket_qHostInfo,     NULL, "qHostInfo", "Replies with multiple 'key:value;' tuples appended to each other."));
+    t.push_back (Packet (query_supported,               &RNBRemote::HandlePacket_qSupported,    NULL, "qSupported", "Replies with the largest packet size " DEBUGSERVER_PROGRAM_NAME " can handle."));
 //  t.push_back (Packet (query_symbol_lookup,           &RNBRemote::HandlePacket_UNIMPLEMENTED, NULL, "qSymbol", "Notify that host debugger is ready to do symbol lookups"));
     t.push_back (Packet (start_noack_mode,              &RNBRemote::HandlePacket_QStartNoAckMode        , NULL, "QStartNoAckMode", "Request that " DEBUGSERVER_PROGRAM_NAME " stop acking remote protocol packets"));
+    t.push_back (Packet (enable_compression,            &RNBRemote::HandlePacket_QEnableCompression     , NULL, "QEnableCompression:", "Request that " DEBUGSERVER_PROGRAM_NAME " run-length encode large packets it sends"));
+    t.push_back (Packet (start_shared_memory,           &RNBRemote::HandlePacket_QStartSharedMemory     , NULL, "QStartSharedMemory:", "Move all packets after the reply through a shared memory region made by a debugger on the same host"));
     t.push_back (Packet (prefix_reg_packets_with_tid,   &RNBRemote::HandlePacket_QThreadSuffixSupported , NULL, "QThreadSuffixSupported", "Check if thread specifc packets (register packets 'g', 'G', 'p', and 'P') support having the thread ID appended to the end of the command"));
     t.push_back (Packet (set_logging_mode,              &RNBRemote::HandlePacket_QSetLogging            , NULL, "QSetLogging:", "Check if register packets ('g', 'G', 'p', and 'P' support having the thread ID prefix"));
     t.push_back (Packet (set_max_packet_size,           &RNBRemote::HandlePacket_QSetMaxPacketSize      , NULL, "QSetMaxPacketSize:", "Tell " DEBUGSERVER_PROGRAM_NAME " the max sized packet gdb can handle"));
@@ -189,10 +201,17 @@ RNBRemote::CreatePacketTable  ()
     t.push_back (Packet (set_working_dir,               &RNBRemote::HandlePacket_QSetWorkingDir         , NULL, "QSetWorkingDir:", "Set the working directory for a process to be launched with the 'A' packet"));
     t.push_back (Packet (set_list_threads_in_stop_reply,&RNBRemote::HandlePacket_QListThreadsInStopReply , NULL, "QListThreadsInStopReply", "Set if the 'threads' key should be added to the stop reply packets with a list of all thread IDs."));
     t.push_back (Packet (sync_thread_state,             &RNBRemote::HandlePacket_QSyncThreadState , NULL, "QSyncThreadState:", "Do whatever is necessary to make sure 'thread' is in a safe state to call functions on."));
+    t.push_back (Packet (set_non_stop,                  &RNBRemote::HandlePacket_QNonStop         , NULL, "QNonStop:", "Only stop the threads that hit breakpoints or get exceptions, and report them with '%Stop' notifications."));
+    t.push_back (Packet (non_stop_stopped,              &RNBRemote::HandlePacket_vStopped         , NULL, "vStopped", "Get the stop reply for the next thread that stopped in non-stop mode."));
+    t.push_back (Packet (set_enable_async_profiling,    &RNBRemote::HandlePacket_QSetEnableAsyncProfiling, NULL, "QSetEnableAsyncProfiling", "Periodically sample the thread stacks, thread CPU times and task memory while the process runs and send the samples in 'A' packets."));
 //  t.push_back (Packet (pass_signals_to_inferior,      &RNBRemote::HandlePacket_UNIMPLEMENTED, NULL, "QPassSignals:", "Specify which signals are passed to the inferior"));
     t.push_back (Packet (allocate_memory,               &RNBRemote::HandlePacket_AllocateMemory, NULL, "_M", "Allocate memory in the inferior process."));
     t.push_back (Packet (deallocate_memory,             &RNBRemote::HandlePacket_DeallocateMemory, NULL, "_m", "Deallocate memory in the inferior process."));
+    // "qMemoryRegionInfos:" must come before "qMemoryRegionInfo" since packets are matched by prefix
+    t.push_back (Packet (memory_region_infos,           &RNBRemote::HandlePacket_MemoryRegionInfos, NULL, "qMemoryRegionInfos:", "Return the start, size and permissions of all mapped memory regions at or above the given address"));
     t.push_back (Packet (memory_region_info,            &RNBRemote::HandlePacket_MemoryRegionInfo, NULL, "qMemoryRegionInfo", "Return size and attributes of a memory region that contains the given address"));
+    t.push_back (Packet (search_memory,                 &RNBRemote::HandlePacket_qSearchMemory, NULL, "qSearchMemory:", "Search a range of memory for a byte pattern"));
+    t.push_back (Packet (multi_memory_read,             &RNBRemote::HandlePacket_qMultiMemRead, NULL, "qMultiMemRead:", "Read several ranges of memory"));
     t.push_back (Packet (watchpoint_support_info,       &RNBRemote::HandlePacket_WatchpointSupportInfo, NULL, "qWatchpointSupportInfo", "Return the number of supported hardware watchpoints"));
 
 }
@@ -226,6 +245,28 @@ RNBRemote::FlushSTDIO ()
     }
 }
 
+//----------------------------------------------------------------------
+// Send any queued profiling samples to the client. The records are
+// hex encoded like the 'O' packets so they can't clash with the
+// packet framing.
+//----------------------------------------------------------------------
+void
+RNBRemote::SendAsyncProfileData ()
+{
+    if (m_ctx.HasValidProcessID())
+    {
+        nub_process_t pid = m_ctx.ProcessID();
+        char buf[1024];
+        nub_size_t count;
+        do
+        {
+            count = DNBProcessGetAvailableProfileData(pid, buf, sizeof(buf));
+            if (count > 0)
+                SendHexEncodedBytePacket ("A", buf, count, NULL);
+        } while (count > 0);
+    }
+}
+
 rnb_err_t
 RNBRemote::SendHexEncodedBytePacket (const char *header, const void *buf, size_t buf_len, const char *footer)
 {
@@ -262,12 +303,53 @@ RNBRemote::SendSTDERRPacket (char *buf, nub_size_t buf_size)
     return SendHexEncodedBytePacket("O", buf, buf_size, NULL);
 }
 
+/* Run-length encode a packet payload as described in the gdb remote
+   protocol documentation: a run of identical characters is sent as the
+   character, a '*', and a repeat count character that is the number of
+   additional copies plus 29.  Repeat counts of 6 and 7 would give '#'
+   and '$', so those runs are split.  The payload must not contain a '*'
+   of its own.  */
+
+static std::string
+run_length_encode (const std::string &s)
+{
+    std::string encoded;
+    encoded.reserve (s.size());
+    const size_t size = s.size();
+    size_t i = 0;
+    while (i < size)
+    {
+        const char ch = s[i];
+        size_t repeats = 0;
+        while (i + repeats + 1 < size && s[i + repeats + 1] == ch && repeats < 126 - 29)
+            ++repeats;
+        if (repeats == 6 || repeats == 7)
+            repeats = 5;
+        encoded.push_back (ch);
+        if (repeats >= 3)
+        {
+            encoded.push_back ('*');
+            encoded.push_back ((char)(repeats + 29));
+        }
+        else
+        {
+            encoded.append (repeats, ch);
+        }
+        i += repeats + 1;
+    }
+    return encoded;
+}
+
 rnb_err_t
 RNBRemote::SendPacket (const std::string &s)
 {
     DNBLogThreadedIf (LOG_RNB_MAX, "%8d RNBRemote::%s (%s) called", (uint32_t)m_comm.Timer().ElapsedMicroSeconds(true), __FUNCTION__, s.c_str());
-    std::string sendpacket = "$" + s + "#";
-    int cksum = 0;
+    std::string encoded;
+    const bool compress = m_compression_min_size > 0 && s.size() >= m_compression_min_size && s.find ('*') == std::string::npos;
+    if (compress)
+        encoded = run_length_encode (s);
+    const std::string &payload = compress ? encoded : s;
+    std::string sendpacket = "$" + payload + "#";
     char hexbuf[5];
 
     if (m_noack_mode)
@@ -276,9 +358,7 @@ RNBRemote::SendPacket (const std::string &s)
     }
     else
     {
-        for (int i = 0; i != s.size(); ++i)
-            cksum += s[i];
-        snprintf (hexbuf, sizeof hexbuf, "%02x", cksum & 0xff);
+        snprintf (hexbuf, sizeof hexbuf, "%02x", StringExtractor::CalculateChecksum (payload.data(), payload.size()));
         sendpacket += hexbuf;
     }
 
@@ -371,15 +451,9 @@ RNBRemote::GetPacketPayload (std::string &return_packet)
             if (!m_noack_mode)
             {
                 // Compute the checksum
-                int computed_checksum = 0;
-                for (std::string::iterator it = return_packet.begin ();
-                     it != return_packet.end ();
-                     ++it)
-                {
-                    computed_checksum += *it;
-                }
+                const int computed_checksum = StringExtractor::CalculateChecksum (return_packet.data(), return_packet.size());
 
-                if (packet_checksum == (computed_checksum & 0xff))
+                if (packet_checksum == computed_checksum)
                 {
                     //DNBLogThreadedIf (LOG_RNB_MEDIUM, "%8u RNBRemote::%s sending ACK for '%s'", (uint32_t)m_comm.Timer().ElapsedMicroSeconds(true), __FUNCTION__, return_packet.c_str());
                     m_comm.Write ("+", 1);
@@ -517,6 +591,28 @@ RNBRemote::HandleAsyncPacket(PacketEnum *type)
     return err;
 }
 
+//----------------------------------------------------------------------
+// Notifications are like packets but start with '%' and are never acked,
+// the client asks for the rest of the information with a normal packet.
+//----------------------------------------------------------------------
+rnb_err_t
+RNBRemote::SendNotification (const std::string &s)
+{
+    DNBLogThreadedIf (LOG_RNB_MAX, "%8d RNBRemote::%s (%s) called", (uint32_t)m_comm.Timer().ElapsedMicroSeconds(true), __FUNCTION__, s.c_str());
+    std::string notification = "%" + s + "#";
+    if (m_noack_mode)
+    {
+        notification += "00";
+    }
+    else
+    {
+        char hexbuf[5];
+        snprintf (hexbuf, sizeof hexbuf, "%02x", StringExtractor::CalculateChecksum (s.data(), s.size()));
+        notification += hexbuf;
+    }
+    return m_comm.Write (notification.c_str(), notification.size());
+}
+
 rnb_err_t
 RNBRemote::HandleReceivedPacket(PacketEnum *type)
 {
@@ -532,6 +628,12 @@ RNBRemote::HandleReceivedPacket(PacketEnum *type)
     {
         DNBLogThreadedIf (LOG_RNB_REMOTE, "HandleReceivedPacket (\"%s\");", packet_data.c_str());
         HandlePacketCallback packet_callback = packet_info.normal;
+        // Packets are handled normally while the process runs in non-stop
+        // mode, except for the interrupt which has to stop the process
+        if (packet_info.async != NULL &&
+            m_ctx.ProcessStateRunning() &&
+            DNBProcessGetNonStopMode (m_ctx.ProcessID()))
+            packet_callback = packet_info.async;
         if (packet_callback != NULL)
         {
             if (type != NULL)
@@ -1130,10 +1232,34 @@ RNBRemote::InitializeRegisters ()
 void
 RNBRemote::NotifyThatProcessStopped (void)
 {
+    // A full stop answers any "%Stop" notification we were waiting on
+    m_non_stop_notification_pending = false;
     RNBRemote::HandlePacket_last_signal (NULL);
     return;
 }
 
+//----------------------------------------------------------------------
+// Some threads stopped in non-stop mode. Tell the client about the first
+// one with a "%Stop" notification, it asks for the others with
+// "vStopped". Only one notification is outstanding at a time.
+//----------------------------------------------------------------------
+void
+RNBRemote::NotifyThatThreadsStopped (void)
+{
+    if (m_non_stop_notification_pending)
+        return;
+    const nub_process_t pid = m_ctx.ProcessID();
+    const nub_thread_t tid = DNBProcessGetNextNonStopStoppedThread (pid);
+    if (tid == INVALID_NUB_THREAD)
+        return;
+    std::ostringstream ostrm;
+    if (AppendStopReplyForThread (ostrm, pid, tid, true))
+    {
+        m_non_stop_notification_pending = true;
+        SendNotification ("Stop:" + ostrm.str());
+    }
+}
+
 
 /* 'A arglen,argnum,arg,...'
  Update the inferior context CTX with the program name and arg
@@ -1312,6 +1438,25 @@ RNBRemote::HandlePacket_qSyncThreadStateSupported (const char *p)
     return SendPacket("OK");
 }
 
+rnb_err_t
+RNBRemote::HandlePacket_qBreakpointConditionsSupported (const char *p)
+{
+    // We evaluate ";X<len>,<bytecode>" conditions on breakpoint and
+    // watchpoint packets and only stop when one of them is true.
+    return SendPacket("OK");
+}
+
+rnb_err_t
+RNBRemote::HandlePacket_qSupported (const char *p)
+{
+    // We don't use any of the features gdb lists after the colon, we only
+    // tell it how big a packet we can take so memory can be moved in big
+    // pieces.
+    char buf[64];
+    snprintf (buf, sizeof(buf), "PacketSize=%x;QNonStop+", DEBUGSERVER_MAX_PACKET_SIZE);
+    return SendPacket (buf);
+}
+
 rnb_err_t
 RNBRemote::HandlePacket_qVAttachOrWaitSupported (const char *p)
 {
@@ -1327,6 +1472,31 @@ RNBRemote::HandlePacket_qThreadStopInfo (const char *p)
     return SendStopReplyPacketForThread (tid);
 }
 
+// APPLE LOCAL: qThreadsStopInfo
+// syntax: qThreadsStopInfo
+// Replies with the qThreadStopInfo reply of every thread, separated by
+// '|', so the debugger doesn't need one round trip per thread after each
+// stop.
+rnb_err_t
+RNBRemote::HandlePacket_qThreadsStopInfo (const char *p)
+{
+    const nub_process_t pid = m_ctx.ProcessID();
+    if (pid == INVALID_NUB_PROCESS)
+        return SendPacket("E50");
+
+    std::ostringstream ostrm;
+    const nub_size_t numthreads = DNBProcessGetNumThreads (pid);
+    for (nub_size_t i = 0; i < numthreads; ++i)
+    {
+        const nub_thread_t tid = DNBProcessGetThreadAtIndex (pid, i);
+        if (i > 0)
+            ostrm << '|';
+        if (!AppendStopReplyForThread (ostrm, pid, tid, false))
+            return SendPacket("E51");
+    }
+    return SendPacket (ostrm.str ());
+}
+
 rnb_err_t
 RNBRemote::HandlePacket_qThreadInfo (const char *p)
 {
@@ -1788,6 +1958,52 @@ RNBRemote::HandlePacket_QStartNoAckMode (const char *p)
     return result;
 }
 
+rnb_err_t
+RNBRemote::HandlePacket_QStartSharedMemory (const char *p)
+{
+    /* QStartSharedMemory:<name>;
+       The debugger made a POSIX shared memory region called <name> with
+       a ring for each direction. Once we reply OK over the socket every
+       byte both ways goes through the rings, and the socket only wakes
+       up the side that is waiting.  Only allowed in no-ack mode so no
+       ack can be left on the socket when the switch happens.  */
+    p += sizeof ("QStartSharedMemory:") - 1;
+    const char *end = strchr (p, ';');
+    if (end == NULL || end == p)
+        return HandlePacket_ILLFORMED (__FILE__, __LINE__, p, "No name in QStartSharedMemory packet");
+    if (!m_noack_mode)
+        return SendPacket ("E74");
+    const std::string name (p, end - p);
+    if (m_comm.OpenSharedMemory (name.c_str()) != rnb_success)
+        return SendPacket ("E75");
+    rnb_err_t result = SendPacket ("OK");
+    m_comm.StartWritingSharedMemory ();
+    return result;
+}
+
+rnb_err_t
+RNBRemote::HandlePacket_QEnableCompression (const char *p)
+{
+    /* QEnableCompression:type:rle;minsize:<hex size>;
+       Packets we send from now on whose payload is at least minsize
+       characters long are run-length encoded.  A minsize of zero
+       turns compression back off.  */
+    p += sizeof ("QEnableCompression:") - 1;
+    if (strstr (p, "type:rle;") == NULL)
+        return HandlePacket_UNIMPLEMENTED (p);
+    const char *minsize = strstr (p, "minsize:");
+    if (minsize == NULL)
+        return HandlePacket_ILLFORMED (__FILE__, __LINE__, p, "No minsize in QEnableCompression packet");
+    errno = 0;
+    uint32_t size = strtoul (minsize + sizeof ("minsize:") - 1, NULL, 16);
+    if (errno != 0 && size == 0)
+        return HandlePacket_ILLFORMED (__FILE__, __LINE__, p, "Invalid minsize in QEnableCompression packet");
+    // Send the OK packet before we start compressing
+    rnb_err_t result = SendPacket ("OK");
+    m_compression_min_size = size;
+    return result;
+}
+
 
 rnb_err_t
 RNBRemote::HandlePacket_QSetLogging (const char *p)
@@ -1913,6 +2129,110 @@ RNBRemote::HandlePacket_QSyncThreadState (const char *p)
         return SendPacket ("E61");
 }
 
+/* 'QNonStop:1' / 'QNonStop:0'
+ Turn non-stop mode on or off. In non-stop mode only the threads that hit
+ breakpoints or get exceptions stop, resume packets get an "OK" reply
+ right away, and stopped threads are reported with "%Stop" notifications
+ (the rest of them are fetched with "vStopped").  An interrupt still
+ stops every thread and gets a normal stop reply.  */
+
+rnb_err_t
+RNBRemote::HandlePacket_QNonStop (const char *p)
+{
+    if (!m_ctx.HasValidProcessID())
+        return SendPacket ("E72");
+
+    p += strlen("QNonStop:");
+    if (*p != '0' && *p != '1')
+        return HandlePacket_ILLFORMED (__FILE__, __LINE__, p, "Invalid value in QNonStop packet");
+    if (!DNBProcessSetNonStopMode (m_ctx.ProcessID(), *p == '1'))
+        return SendPacket ("E73");
+    return SendPacket ("OK");
+}
+
+/* 'QSetEnableAsyncProfiling;enable:1;interval_usec:1000;frames:16;scan_type:0x7;'
+ Start or stop sampling the process while it runs. Every "interval_usec"
+ microseconds one record is taken with the entries selected by the
+ "scan_type" bits (DNBProfileDataScanType, only the stacks when it is
+ missing). The records are sent to the client in hex encoded 'A'
+ packets, one line each:
+
+ time:<usec>;memory:<resident>,<virtual>;thread:<tid>,<pc>,<pc>...;threadcpu:<tid>,<user usec>,<system usec>;...\n
+
+ The "thread" entries hold the PC and up to "frames - 1" return
+ addresses; the task is only suspended while they are read.  */
+
+rnb_err_t
+RNBRemote::HandlePacket_QSetEnableAsyncProfiling (const char *p)
+{
+    if (!m_ctx.HasValidProcessID())
+        return SendPacket ("E72");
+
+    bool enable = false;
+    uint64_t interval_usec = 1000;
+    uint32_t max_frames = 16;
+    uint32_t scan_type = eProfileThreadStacks;
+
+    p += strlen("QSetEnableAsyncProfiling");
+    while (*p == ';')
+    {
+        ++p;
+        const char *value = strchr (p, ':');
+        if (value == NULL)
+            break;
+        ++value;
+        char *end = NULL;
+        const uint64_t n = strtoull (value, &end, 0);
+        if (end == value)
+            return HandlePacket_ILLFORMED (__FILE__, __LINE__, p, "Invalid value in QSetEnableAsyncProfiling packet");
+
+        if (strncmp (p, "enable:", strlen("enable:")) == 0)
+            enable = n != 0;
+        else if (strncmp (p, "interval_usec:", strlen("interval_usec:")) == 0)
+            interval_usec = n;
+        else if (strncmp (p, "frames:", strlen("frames:")) == 0)
+            max_frames = n;
+        else if (strncmp (p, "scan_type:", strlen("scan_type:")) == 0)
+            scan_type = n;
+        p = end;
+    }
+
+    if (!DNBProcessSetEnableAsyncProfiling (m_ctx.ProcessID(), enable, interval_usec, max_frames, scan_type))
+        return SendPacket ("E76");
+    return SendPacket ("OK");
+}
+
+/* 'vStopped'
+ Reply with the stop reply for the next thread that stopped in non-stop
+ mode, or "OK" when they have all been reported.  */
+
+rnb_err_t
+RNBRemote::HandlePacket_vStopped (const char *p)
+{
+    const nub_process_t pid = m_ctx.ProcessID();
+    const nub_thread_t tid = DNBProcessGetNextNonStopStoppedThread (pid);
+    if (tid == INVALID_NUB_THREAD)
+    {
+        m_non_stop_notification_pending = false;
+        return SendPacket ("OK");
+    }
+    return SendStopReplyPacketForThread (tid);
+}
+
+//----------------------------------------------------------------------
+// Resume packets are answered with a stop reply when the process stops,
+// except in non-stop mode where stops are sent as notifications and the
+// resume itself is acknowledged.
+//----------------------------------------------------------------------
+rnb_err_t
+RNBRemote::SendResumeReply (nub_process_t pid)
+{
+    if (DNBProcessGetNonStopMode (pid))
+        return SendPacket ("OK");
+    // Don't send an "OK" packet; response is the stopped/exited message.
+    return rnb_success;
+}
+
 rnb_err_t
 RNBRemote::HandlePacket_QListThreadsInStopReply (const char *p)
 {
@@ -2060,8 +2380,9 @@ append_hex_value (std::ostream& ostrm, const uint8_t* buf, size_t buf_size, bool
     }
     else
     {
-        for (i = 0; i < buf_size; i++)
-            ostrm << RAWHEX8(buf[i]);
+        std::string hex (buf_size * 2, '\0');
+        StringExtractor::EncodeHexBytes (buf, buf_size, &hex[0]);
+        ostrm << hex;
     }
 }
 
@@ -2126,13 +2447,258 @@ gdb_regnum_with_fixed_width_hex_register_value (std::ostream& ostrm,
     }
 }
 
+// The number of bytes of stack memory, starting at the stack pointer, and
+// the number of frames in the frame pointer chain that we expedite in stop
+// reply packets.
+#define EXPEDITED_STACK_MEMORY_SIZE     256
+#define MAX_EXPEDITED_FRAMES            16
+
+static bool
+get_generic_register_value (nub_process_t pid, nub_thread_t tid, uint32_t generic_regnum, nub_addr_t &value, uint32_t &value_size)
+{
+    DNBRegisterValue reg_value;
+    if (!DNBThreadGetRegisterValueByID (pid, tid, REGISTER_SET_GENERIC, generic_regnum, &reg_value))
+        return false;
+    value_size = reg_value.info.size;
+    if (value_size == 8)
+        value = reg_value.value.uint64;
+    else if (value_size == 4)
+        value = reg_value.value.uint32;
+    else
+        return false;
+    return true;
+}
+
+static void
+append_expedited_memory (std::ostream& ostrm, nub_addr_t addr, const uint8_t *buf, nub_size_t buf_size)
+{
+    ostrm << "memory:" << std::hex << addr << '=';
+    append_hex_value (ostrm, buf, buf_size, false);
+    ostrm << ';';
+}
+
+// Send the memory at the top of the stack and the saved frame pointer and
+// return address of each frame in the frame pointer chain so the debugger
+// can backtrace without reading memory.
+static void
+append_expedited_stack_memory (std::ostream& ostrm, nub_process_t pid, nub_thread_t tid)
+{
+    nub_addr_t sp, fp;
+    uint32_t sp_size, fp_size;
+    if (!get_generic_register_value (pid, tid, GENERIC_REGNUM_SP, sp, sp_size) ||
+        !get_generic_register_value (pid, tid, GENERIC_REGNUM_FP, fp, fp_size))
+        return;
+
+    uint8_t stack_bytes[EXPEDITED_STACK_MEMORY_SIZE];
+    nub_size_t stack_bytes_read = DNBProcessMemoryRead (pid, sp, sizeof(stack_bytes), stack_bytes);
+    if (stack_bytes_read > 0)
+        append_expedited_memory (ostrm, sp, stack_bytes, stack_bytes_read);
+    const nub_addr_t stack_bytes_end = sp + stack_bytes_read;
+
+    const nub_size_t frame_record_size = fp_size * 2;
+    for (uint32_t i = 0; i < MAX_EXPEDITED_FRAMES && fp != 0; ++i)
+    {
+        uint8_t frame_record[16];
+        if (DNBProcessMemoryRead (pid, fp, frame_record_size, frame_record) != frame_record_size)
+            break;
+        if (fp < sp || fp + frame_record_size > stack_bytes_end)
+            append_expedited_memory (ostrm, fp, frame_record, frame_record_size);
+
+        nub_addr_t next_fp;
+        if (fp_size == 8)
+        {
+            uint64_t fp64;
+            memcpy (&fp64, frame_record, sizeof(fp64));
+            next_fp = fp64;
+        }
+        else
+        {
+            uint32_t fp32;
+            memcpy (&fp32, frame_record, sizeof(fp32));
+            next_fp = fp32;
+        }
+        // The stack grows down, so the frame chain must move up
+        if (next_fp <= fp)
+            break;
+        fp = next_fp;
+    }
+}
+
+// Read the NULL terminated string at "addr" in the inferior into "str".
+static bool
+read_inferior_cstring (nub_process_t pid, nub_addr_t addr, std::string &str)
+{
+    str.clear();
+    char buf[256];
+    while (str.size() < PATH_MAX)
+    {
+        nub_size_t bytes_read = DNBProcessMemoryRead (pid, addr, sizeof(buf), buf);
+        if (bytes_read == 0)
+            return false;
+        const char *nul = (const char *)memchr (buf, '\0', bytes_read);
+        if (nul)
+        {
+            str.append (buf, nul - buf);
+            return true;
+        }
+        str.append (buf, bytes_read);
+        addr += bytes_read;
+    }
+    return false;
+}
+
+static void
+append_segment (std::ostream& ostrm, const char *segname, uint64_t vmaddr, uint64_t vmsize, uint64_t fileoff, uint64_t filesize, uint32_t maxprot, uint32_t initprot, uint32_t nsects, uint32_t flags)
+{
+    ostrm << "segment:" << std::hex << vmaddr << ',' << vmsize << ',' << fileoff << ',' << filesize << ','
+          << maxprot << ',' << initprot << ',' << nsects << ',' << flags << ',';
+    append_hex_value (ostrm, (const uint8_t *)segname, strnlen (segname, 16), false);
+    ostrm << ';';
+}
+
+// Append the mach header, UUID and segments of the image whose mach
+// header is at "addr" in the format of a qShlibInfos reply.
+static void
+append_image_load_commands (std::ostream& ostrm, nub_process_t pid, nub_addr_t addr)
+{
+    struct mach_header_64 header;
+    if (DNBProcessMemoryRead (pid, addr, sizeof(header), &header) != sizeof(header))
+        return;
+
+    nub_addr_t load_cmd_addr;
+    if (header.magic == MH_MAGIC_64)
+        load_cmd_addr = addr + sizeof(struct mach_header_64);
+    else if (header.magic == MH_MAGIC)
+        load_cmd_addr = addr + sizeof(struct mach_header);
+    else
+        return;
+
+    std::vector<uint8_t> load_cmds (header.sizeofcmds);
+    if (load_cmds.empty() || DNBProcessMemoryRead (pid, load_cmd_addr, load_cmds.size(), &load_cmds[0]) != load_cmds.size())
+        return;
+
+    ostrm << "header:" << std::hex << header.magic << ',' << (uint32_t)header.cputype << ',' << (uint32_t)header.cpusubtype << ','
+          << header.filetype << ',' << header.ncmds << ',' << header.sizeofcmds << ',' << header.flags << ';';
+
+    uint32_t offset = 0;
+    for (uint32_t i = 0; i < header.ncmds && offset + sizeof(struct load_command) <= load_cmds.size(); ++i)
+    {
+        struct load_command lc;
+        memcpy (&lc, &load_cmds[offset], sizeof(lc));
+        if (lc.cmdsize < sizeof(lc) || offset + lc.cmdsize > load_cmds.size())
+            break;
+
+        switch (lc.cmd)
+        {
+        case LC_SEGMENT:
+            if (lc.cmdsize >= sizeof(struct segment_command))
+            {
+                struct segment_command seg;
+                memcpy (&seg, &load_cmds[offset], sizeof(seg));
+                append_segment (ostrm, seg.segname, seg.vmaddr, seg.vmsize, seg.fileoff, seg.filesize, seg.maxprot, seg.initprot, seg.nsects, seg.flags);
+            }
+            break;
+
+        case LC_SEGMENT_64:
+            if (lc.cmdsize >= sizeof(struct segment_command_64))
+            {
+                struct segment_command_64 seg;
+                memcpy (&seg, &load_cmds[offset], sizeof(seg));
+                append_segment (ostrm, seg.segname, seg.vmaddr, seg.vmsize, seg.fileoff, seg.filesize, seg.maxprot, seg.initprot, seg.nsects, seg.flags);
+            }
+            break;
+
+        case LC_UUID:
+            if (lc.cmdsize >= sizeof(struct uuid_command))
+            {
+                struct uuid_command uuid;
+                memcpy (&uuid, &load_cmds[offset], sizeof(uuid));
+                ostrm << "uuid:";
+                append_hex_value (ostrm, uuid.uuid, sizeof(uuid.uuid), false);
+                ostrm << ';';
+            }
+            break;
+
+        default:
+            break;
+        }
+        offset += lc.cmdsize;
+    }
+}
+
+/* qShlibInfos:<image infos address>,<image count>
+   Read the dyld_image_info array at the address (which the debugger
+   found in dyld_all_image_infos) and send the load address,
+   modification date, path, mach header, UUID and segments of each
+   image.  All of this is read locally so the debugger doesn't need a
+   handful of memory reads per image.  */
+
 rnb_err_t
-RNBRemote::SendStopReplyPacketForThread (nub_thread_t tid)
+RNBRemote::HandlePacket_qShlibInfos (const char *p)
 {
+    if (!m_ctx.HasValidProcessID())
+        return SendPacket ("E68");
+
+    p += sizeof ("qShlibInfos:") - 1;
+    char *end = NULL;
+    errno = 0;
+    nub_addr_t infos_addr = strtoull (p, &end, 16);
+    if (errno != 0 || end == p || *end != ',')
+        return HandlePacket_ILLFORMED (__FILE__, __LINE__, p, "Invalid address in qShlibInfos packet");
+    p = end + 1;
+    uint32_t infos_count = strtoul (p, &end, 16);
+    if (errno != 0 || end == p || infos_count == 0)
+        return HandlePacket_ILLFORMED (__FILE__, __LINE__, p, "Invalid count in qShlibInfos packet");
+
     const nub_process_t pid = m_ctx.ProcessID();
-    if (pid == INVALID_NUB_PROCESS)
-        return SendPacket("E50");
+    const uint32_t addr_size = (DNBProcessGetCPUType (pid) & CPU_ARCH_ABI64) ? 8 : 4;
+
+    // Each dyld_image_info is the image's load address, the address of
+    // its path and its modification date
+    std::vector<uint8_t> infos (infos_count * 3 * addr_size);
+    if (DNBProcessMemoryRead (pid, infos_addr, infos.size(), &infos[0]) != infos.size())
+        return SendPacket ("E69");
+
+    std::ostringstream ostrm;
+    std::string path;
+    for (uint32_t i = 0; i < infos_count; ++i)
+    {
+        nub_addr_t image_info[3];
+        for (uint32_t j = 0; j < 3; ++j)
+        {
+            const uint8_t *src = &infos[(i * 3 + j) * addr_size];
+            if (addr_size == 8)
+            {
+                uint64_t value;
+                memcpy (&value, src, sizeof(value));
+                image_info[j] = value;
+            }
+            else
+            {
+                uint32_t value;
+                memcpy (&value, src, sizeof(value));
+                image_info[j] = value;
+            }
+        }
+        ostrm << "address:" << std::hex << image_info[0] << ";mod_date:" << image_info[2] << ';';
+        if (read_inferior_cstring (pid, image_info[1], path))
+        {
+            ostrm << "path:";
+            append_hex_value (ostrm, (const uint8_t *)path.data(), path.size(), false);
+            ostrm << ';';
+        }
+        append_image_load_commands (ostrm, pid, image_info[0]);
+    }
+    return SendPacket (ostrm.str());
+}
 
+// Append the 'T' stop reply for one thread to "ostrm". When
+// "include_process_info" is false, only the information about this
+// thread is appended, which is what the records in a qThreadsStopInfo
+// reply contain.
+bool
+RNBRemote::AppendStopReplyForThread (std::ostream &ostrm, nub_process_t pid, nub_thread_t tid, bool include_process_info)
+{
     struct DNBThreadStopInfo tid_stop_info;
 
     /* Fill the remaining space in this packet with as many registers
@@ -2140,7 +2706,6 @@ RNBRemote::SendStopReplyPacketForThread (nub_thread_t tid)
 
     if (DNBThreadGetStopReason (pid, tid, &tid_stop_info))
     {
-        std::ostringstream ostrm;
         // Output the T packet with the thread
         ostrm << 'T';
         int signum = tid_stop_info.details.signal.signo;
@@ -2174,7 +2739,8 @@ RNBRemote::SendStopReplyPacketForThread (nub_thread_t tid)
         {
             size_t thread_name_len = strlen(thread_name);
             
-            if (::strcspn (thread_name, "$#+-;:") == thread_name_len)
+            // '|' separates the records of a qThreadsStopInfo reply
+            if (::strcspn (thread_name, "$#+-;:|") == thread_name_len)
                 ostrm << std::hex << "name:" << thread_name << ';';
             else
             {
@@ -2203,7 +2769,7 @@ RNBRemote::SendStopReplyPacketForThread (nub_thread_t tid)
         // stop reply packet, so it must be enabled only on systems where there
         // are no limits on packet lengths.
         
-        if (m_list_threads_in_stop_reply)
+        if (include_process_info && m_list_threads_in_stop_reply)
         {
             const nub_size_t numthreads = DNBProcessGetNumThreads (pid);
             if (numthreads > 0)
@@ -2236,6 +2802,53 @@ RNBRemote::SendStopReplyPacketForThread (nub_thread_t tid)
                     gdb_regnum_with_fixed_width_hex_register_value (ostrm, pid, tid, &g_reg_entries[reg], &reg_value);
                 }
             }
+
+            // When there are no limits on packet lengths, also send the
+            // PC, SP and FP of every other thread and the stack memory of
+            // the stopped thread so that backtracing doesn't require any
+            // more packets. The registers for other threads are sent as:
+            //  "thread-regs:<tid>,<regnum>=<value>,<regnum>=<value>;"
+            if (include_process_info && m_list_threads_in_stop_reply)
+            {
+                const nub_size_t numthreads = DNBProcessGetNumThreads (pid);
+                for (nub_size_t i = 0; i < numthreads; ++i)
+                {
+                    nub_thread_t th = DNBProcessGetThreadAtIndex (pid, i);
+                    if (th == tid)
+                        continue;
+                    ostrm << "thread-regs:" << std::hex << th;
+                    for (uint32_t reg = 0; reg < g_num_reg_entries; reg++)
+                    {
+                        const uint32_t reg_generic = g_reg_entries[reg].nub_info.reg_generic;
+                        if (reg_generic != GENERIC_REGNUM_PC &&
+                            reg_generic != GENERIC_REGNUM_SP &&
+                            reg_generic != GENERIC_REGNUM_FP)
+                            continue;
+                        if (!DNBThreadGetRegisterValueByID (pid, th, g_reg_entries[reg].nub_info.set, g_reg_entries[reg].nub_info.reg, &reg_value))
+                            continue;
+                        ostrm << ',' << RAWHEX8(g_reg_entries[reg].gdb_regnum) << '=';
+                        register_value_in_hex_fixed_width (ostrm, pid, th, &g_reg_entries[reg], &reg_value);
+                    }
+                    ostrm << ';';
+                }
+
+                append_expedited_stack_memory (ostrm, pid, tid);
+            }
+        }
+
+        // Tell the debugger about the hits of breakpoints whose conditions
+        // were false since the last stop, so it can count them:
+        //  "bpfiltered:<addr>,<count>;"
+        if (include_process_info)
+        {
+            for (BreakpointMapIter pos = m_breakpoints.begin(); pos != m_breakpoints.end(); ++pos)
+            {
+                if (pos->second.m_filteredHits == 0)
+                    continue;
+                const uint32_t filtered_hits = __sync_lock_test_and_set (&pos->second.m_filteredHits, 0);
+                if (filtered_hits > 0)
+                    ostrm << "bpfiltered:" << std::hex << pos->first << ',' << filtered_hits << ';';
+            }
         }
 
         if (tid_stop_info.details.exception.type)
@@ -2245,8 +2858,21 @@ RNBRemote::SendStopReplyPacketForThread (nub_thread_t tid)
             for (int i = 0; i < tid_stop_info.details.exception.data_count; ++i)
                 ostrm << "medata:" << std::hex << tid_stop_info.details.exception.data[i] << ";";
         }
-        return SendPacket (ostrm.str ());
+        return true;
     }
+    return false;
+}
+
+rnb_err_t
+RNBRemote::SendStopReplyPacketForThread (nub_thread_t tid)
+{
+    const nub_process_t pid = m_ctx.ProcessID();
+    if (pid == INVALID_NUB_PROCESS)
+        return SendPacket("E50");
+
+    std::ostringstream ostrm;
+    if (AppendStopReplyForThread (ostrm, pid, tid, true))
+        return SendPacket (ostrm.str ());
     return SendPacket("E51");
 }
 
@@ -2374,26 +3000,14 @@ RNBRemote::HandlePacket_M (const char *p)
         return SendPacket ("OK");
     }
 
-    uint8_t *buf = (uint8_t *) alloca (datalen / 2);
-    uint8_t *i = buf;
-
-    while (*p != '\0' && *(p + 1) != '\0')
+    // Writes can be as large as our packet size, too big for the stack
+    std::vector<uint8_t> buf (datalen / 2 + 1);
+    if (StringExtractor::DecodeHexBytes (p, datalen / 2, &buf[0]) != datalen / 2)
     {
-        char hexbuf[3];
-        hexbuf[0] = *p;
-        hexbuf[1] = *(p + 1);
-        hexbuf[2] = '\0';
-        errno = 0;
-        uint8_t byte = strtoul (hexbuf, NULL, 16);
-        if (errno != 0 && byte == 0)
-        {
-            return HandlePacket_ILLFORMED (__FILE__, __LINE__, p, "Invalid hex byte in M packet");
-        }
-        *i++ = byte;
-        p += 2;
+        return HandlePacket_ILLFORMED (__FILE__, __LINE__, p, "Invalid hex byte in M packet");
     }
 
-    nub_size_t wrote = DNBProcessMemoryWrite (m_ctx.ProcessID(), addr, length, buf);
+    nub_size_t wrote = DNBProcessMemoryWrite (m_ctx.ProcessID(), addr, length, &buf[0]);
     if (wrote != length)
         return SendPacket ("E09");
     else
@@ -2436,8 +3050,9 @@ RNBRemote::HandlePacket_m (const char *p)
         return SendPacket ("");
     }
 
-    uint8_t buf[length];
-    int bytes_read = DNBProcessMemoryRead (m_ctx.ProcessID(), addr, length, buf);
+    // Reads can be as large as our packet size, too big for the stack
+    std::vector<uint8_t> buf (length);
+    int bytes_read = DNBProcessMemoryRead (m_ctx.ProcessID(), addr, length, &buf[0]);
     if (bytes_read == 0)
     {
         return SendPacket ("E08");
@@ -2447,10 +3062,81 @@ RNBRemote::HandlePacket_m (const char *p)
     //  to read only part of the region of memory."
     length = bytes_read;
 
-    std::ostringstream ostrm;
-    for (int i = 0; i < length; i++)
-        ostrm << RAWHEX8(buf[i]);
-    return SendPacket (ostrm.str ());
+    std::string hex (length * 2, '\0');
+    StringExtractor::EncodeHexBytes (&buf[0], length, &hex[0]);
+    return SendPacket (hex);
+}
+
+// Read memory, sent it up as binary data.
+// Usage:  xADDR,LEN
+// ADDR and LEN are both base 16.
+//
+// A zero length read is answered with "OK" so clients can detect
+// support for the packet.
+
+rnb_err_t
+RNBRemote::HandlePacket_x (const char *p)
+{
+    if (p == NULL || p[0] == '\0' || strlen (p) < 3)
+    {
+        return HandlePacket_ILLFORMED (__FILE__, __LINE__, p, "Too short x packet");
+    }
+
+    char *c;
+    p++;
+    errno = 0;
+    nub_addr_t addr = strtoull (p, &c, 16);
+    if (errno != 0)
+    {
+        return HandlePacket_ILLFORMED (__FILE__, __LINE__, p, "Invalid address in x packet");
+    }
+    if (*c != ',')
+    {
+        return HandlePacket_ILLFORMED (__FILE__, __LINE__, p, "Comma sep missing in x packet");
+    }
+
+    /* Advance 'p' to the number of bytes to be read.  */
+    p += (c - p) + 1;
+
+    errno = 0;
+    uint32_t length = strtoul (p, NULL, 16);
+    if (errno != 0)
+    {
+        return HandlePacket_ILLFORMED (__FILE__, __LINE__, p, "Invalid length in x packet");
+    }
+    if (length == 0)
+    {
+        return SendPacket ("OK");
+    }
+
+    std::vector<uint8_t> buf (length);
+    int bytes_read = DNBProcessMemoryRead (m_ctx.ProcessID(), addr, length, &buf[0]);
+    if (bytes_read == 0)
+    {
+        return SendPacket ("E08");
+    }
+
+    // Escape the packet framing characters, the escape character itself
+    // and the run length encoding character. We also escape a leading 'E',
+    // 'O', '+' or '-' so that the data can never be mistaken for an "Exx"
+    // error, an "OK" response or an ACK or NACK.
+    std::string packet;
+    packet.reserve (bytes_read + bytes_read / 8);
+    for (int i = 0; i < bytes_read; i++)
+    {
+        const char ch = buf[i];
+        if (ch == '#' || ch == '$' || ch == '}' || ch == '*' ||
+            (i == 0 && (ch == 'E' || ch == 'O' || ch == '+' || ch == '-')))
+        {
+            packet.push_back ('}');
+            packet.push_back (ch ^ 0x20);
+        }
+        else
+        {
+            packet.push_back (ch);
+        }
+    }
+    return SendPacket (packet);
 }
 
 rnb_err_t
@@ -2842,7 +3528,7 @@ RNBRemote::HandlePacket_v (const char *p)
         // then we should stop the threads
         thread_actions.SetDefaultThreadActionIfNeeded (eStateStopped, 0);
         DNBProcessResume(m_ctx.ProcessID(), thread_actions.GetFirst (), thread_actions.GetSize());
-        return rnb_success;
+        return SendResumeReply (m_ctx.ProcessID());
     }
     else if (strstr (p, "vAttach") == p)
     {
@@ -2959,6 +3645,229 @@ RNBRemote::HandlePacket_T (const char *p)
 }
 
 
+// Limits on the breakpoint condition bytecodes we are willing to run, so
+// a bad expression can't hang the inferior or blow our stack.
+#define AGENT_EXPRESSION_MAX_STACK  64
+#define AGENT_EXPRESSION_MAX_STEPS  4096
+
+//----------------------------------------------------------------------
+// Run a GDB agent expression BYTECODE for thread TID, leaving the value
+// on the top of the stack in RESULT. Only the opcodes that lldb uses
+// for breakpoint conditions are handled. Returns false if the bytecode
+// couldn't be evaluated, for instance because it read unreadable memory.
+//----------------------------------------------------------------------
+static bool
+EvaluateAgentExpression (nub_process_t pid, nub_thread_t tid, const std::string &bytecode, uint64_t &result)
+{
+    const uint8_t *code = (const uint8_t *)bytecode.data();
+    const size_t code_size = bytecode.size();
+    std::vector<uint64_t> stack;
+    size_t pc = 0;
+    for (uint32_t steps = 0; steps < AGENT_EXPRESSION_MAX_STEPS; ++steps)
+    {
+        if (pc >= code_size || stack.size() > AGENT_EXPRESSION_MAX_STACK)
+            return false;
+
+        const uint8_t op = code[pc++];
+
+        // All the opcodes from 'add' up to 'less_unsigned' pop two values
+        // and push one, except for 'log_not' and 'bit_not'.
+        uint64_t a = 0, b = 0;
+        if ((op >= 0x02 && op <= 0x0b) || (op >= 0x0f && op <= 0x11) || (op >= 0x13 && op <= 0x15) || op == 0x2b)
+        {
+            if (stack.size() < 2)
+                return false;
+            b = stack.back(); stack.pop_back();
+            a = stack.back(); stack.pop_back();
+        }
+        else if (op == 0x0e || op == 0x12 || (op >= 0x16 && op <= 0x1a) || op == 0x20 || (op >= 0x27 && op <= 0x2a))
+        {
+            if (stack.empty())
+                return false;
+        }
+
+        switch (op)
+        {
+        case 0x02: stack.push_back (a + b); break;                               // add
+        case 0x03: stack.push_back (a - b); break;                               // sub
+        case 0x04: stack.push_back (a * b); break;                               // mul
+        case 0x05:                                                               // div_signed
+        case 0x06:                                                               // div_unsigned
+        case 0x07:                                                               // rem_signed
+        case 0x08:                                                               // rem_unsigned
+            if (b == 0)
+                return false;
+            if (op == 0x05)
+                stack.push_back ((int64_t)b == -1 ? -a : (int64_t)a / (int64_t)b);
+            else if (op == 0x06)
+                stack.push_back (a / b);
+            else if (op == 0x07)
+                stack.push_back ((int64_t)b == -1 ? 0 : (int64_t)a % (int64_t)b);
+            else
+                stack.push_back (a % b);
+            break;
+        case 0x09: stack.push_back (b < 64 ? a << b : 0); break;                 // lsh
+        case 0x0a: stack.push_back ((int64_t)a >> (b < 64 ? b : 63)); break;     // rsh_signed
+        case 0x0b: stack.push_back (b < 64 ? a >> b : 0); break;                 // rsh_unsigned
+        case 0x0e: stack.back() = stack.back() == 0; break;                      // log_not
+        case 0x0f: stack.push_back (a & b); break;                               // bit_and
+        case 0x10: stack.push_back (a | b); break;                               // bit_or
+        case 0x11: stack.push_back (a ^ b); break;                               // bit_xor
+        case 0x12: stack.back() = ~stack.back(); break;                          // bit_not
+        case 0x13: stack.push_back (a == b); break;                              // equal
+        case 0x14: stack.push_back ((int64_t)a < (int64_t)b); break;             // less_signed
+        case 0x15: stack.push_back (a < b); break;                               // less_unsigned
+
+        case 0x16:  // ext n
+        case 0x2a:  // zero_ext n
+            {
+                if (pc + 1 > code_size)
+                    return false;
+                const uint8_t bits = code[pc++];
+                if (bits > 0 && bits < 64)
+                {
+                    const uint64_t mask = (1ull << bits) - 1;
+                    uint64_t value = stack.back() & mask;
+                    if (op == 0x16 && (value & (1ull << (bits - 1))))
+                        value |= ~mask;
+                    stack.back() = value;
+                }
+            }
+            break;
+
+        case 0x17:  // ref8
+        case 0x18:  // ref16
+        case 0x19:  // ref32
+        case 0x1a:  // ref64
+            {
+                const nub_size_t size = 1u << (op - 0x17);
+                uint8_t buf[8];
+                if (DNBProcessMemoryRead (pid, stack.back(), size, buf) != size)
+                    return false;
+                uint64_t value = 0;
+                switch (size)
+                {
+                case 1: value = buf[0]; break;
+                case 2: { uint16_t v; memcpy (&v, buf, sizeof(v)); value = v; } break;
+                case 4: { uint32_t v; memcpy (&v, buf, sizeof(v)); value = v; } break;
+                case 8: { uint64_t v; memcpy (&v, buf, sizeof(v)); value = v; } break;
+                }
+                stack.back() = value;
+            }
+            break;
+
+        case 0x20:  // if_goto offset
+        case 0x21:  // goto offset
+            {
+                if (pc + 2 > code_size)
+                    return false;
+                const size_t target = (code[pc] << 8) | code[pc + 1];
+                pc += 2;
+                bool jump = true;
+                if (op == 0x20)
+                {
+                    jump = stack.back() != 0;
+                    stack.pop_back();
+                }
+                if (jump)
+                    pc = target;
+            }
+            break;
+
+        case 0x22:  // const8
+        case 0x23:  // const16
+        case 0x24:  // const32
+        case 0x25:  // const64
+            {
+                const size_t size = 1u << (op - 0x22);
+                if (pc + size > code_size)
+                    return false;
+                uint64_t value = 0;
+                for (size_t i = 0; i < size; ++i)
+                    value = (value << 8) | code[pc++];
+                stack.push_back (value);
+            }
+            break;
+
+        case 0x26:  // reg n
+            {
+                if (pc + 2 > code_size)
+                    return false;
+                const uint32_t reg = (code[pc] << 8) | code[pc + 1];
+                pc += 2;
+                if (reg >= g_num_reg_entries || g_reg_entries[reg].nub_info.reg == INVALID_NUB_REGNUM)
+                    return false;
+                const DNBRegisterInfo &reg_info = g_reg_entries[reg].nub_info;
+                DNBRegisterValue reg_value;
+                if (!DNBThreadGetRegisterValueByID (pid, tid, reg_info.set, reg_info.reg, &reg_value))
+                    return false;
+                switch (reg_info.size)
+                {
+                case 1: stack.push_back (reg_value.value.uint8); break;
+                case 2: stack.push_back (reg_value.value.uint16); break;
+                case 4: stack.push_back (reg_value.value.uint32); break;
+                case 8: stack.push_back (reg_value.value.uint64); break;
+                default: return false;
+                }
+            }
+            break;
+
+        case 0x27:  // end
+            result = stack.back();
+            return true;
+
+        case 0x28:  // dup
+            stack.push_back (stack.back());
+            break;
+
+        case 0x29:  // pop
+            stack.pop_back();
+            break;
+
+        case 0x2b:  // swap
+            stack.push_back (b);
+            stack.push_back (a);
+            break;
+
+        default:
+            return false;
+        }
+    }
+    return false;
+}
+
+//----------------------------------------------------------------------
+// Breakpoint callback for breakpoints and watchpoints that were set with
+// conditions. BATON is the RNBRemote::Breakpoint with the condition
+// bytecodes, and we stop if any of them is true, or if we can't tell.
+// Hits we don't stop for are counted so the next stop reply can tell
+// the debugger about them.
+//----------------------------------------------------------------------
+nub_bool_t
+RNBRemote::BreakpointConditionsSayStop (nub_process_t pid, nub_thread_t tid, nub_break_t breakID, void *baton)
+{
+    Breakpoint *breakpoint = (Breakpoint *)baton;
+    if (breakpoint == NULL || breakpoint->m_conditions.empty())
+        return true;
+    const std::vector<std::string> *conditions = &breakpoint->m_conditions;
+
+    const size_t num_conditions = conditions->size();
+    for (size_t i = 0; i < num_conditions; ++i)
+    {
+        uint64_t result = 0;
+        if (!EvaluateAgentExpression (pid, tid, (*conditions)[i], result))
+        {
+            DNBLogThreadedIf (LOG_BREAKPOINTS, "BreakpointConditionsSayStop (breakID = %d, tid = 0x%4.4x): condition %zu could not be evaluated", breakID, tid, i);
+            return true;
+        }
+        if (result != 0)
+            return true;
+    }
+    DNBLogThreadedIf (LOG_BREAKPOINTS, "BreakpointConditionsSayStop (breakID = %d, tid = 0x%4.4x): conditions are false, continuing", breakID, tid);
+    __sync_fetch_and_add (&breakpoint->m_filteredHits, 1);
+    return false;
+}
+
 rnb_err_t
 RNBRemote::HandlePacket_z (const char *p)
 {
@@ -2988,6 +3897,34 @@ RNBRemote::HandlePacket_z (const char *p)
     uint32_t byte_size = strtoul (p, &c, 16);
     if (errno != 0 && byte_size == 0)
         return HandlePacket_ILLFORMED (__FILE__, __LINE__, p, "Invalid length in z packet");
+    p = c;
+
+    // Breakpoints can have one or more conditions, "X" options with the
+    // length and hex bytes of an agent expression. Any other options
+    // (like "cmds:") we don't evaluate, so we stop on every hit.
+    std::vector<std::string> conditions;
+    if (packet_cmd == 'Z' && *p == ';')
+    {
+        StringExtractor packet (p);
+        bool unknown_option = false;
+        while (packet.GetChar() == ';')
+        {
+            if (packet.GetChar() != 'X')
+            {
+                unknown_option = true;
+                break;
+            }
+            const uint32_t length = packet.GetHexMaxU32 (false, 0);
+            if (length == 0 || packet.GetChar() != ',' || length > packet.GetBytesLeft() / 2)
+                return HandlePacket_ILLFORMED (__FILE__, __LINE__, p, "Invalid condition in Z packet");
+            std::string bytecode (length, '\0');
+            if (packet.GetHexBytes (&bytecode[0], length, 0) != length)
+                return HandlePacket_ILLFORMED (__FILE__, __LINE__, p, "Invalid condition in Z packet");
+            conditions.push_back (bytecode);
+        }
+        if (unknown_option)
+            conditions.clear();
+    }
 
     if (packet_cmd == 'Z')
     {
@@ -3008,6 +3945,19 @@ RNBRemote::HandlePacket_z (const char *p)
                     // We do already have a breakpoint at this address, increment
                     // its reference count and return OK
                     pos->second.Retain();
+
+                    // Stop when any of the users of the breakpoint wants
+                    // us to, which is always if any of them has no
+                    // conditions.
+                    if (pos->second.m_conditions.empty() || conditions.empty())
+                    {
+                        pos->second.m_conditions.clear();
+                        DNBBreakpointSetCallback (pid, pos->second.BreakID(), NULL, NULL);
+                    }
+                    else
+                    {
+                        pos->second.m_conditions.insert (pos->second.m_conditions.end(), conditions.begin(), conditions.end());
+                    }
                     return SendPacket ("OK");
                 }
                 else
@@ -3022,6 +3972,16 @@ RNBRemote::HandlePacket_z (const char *p)
                         // map.
                         Breakpoint rnbBreakpoint(break_id);
                         m_breakpoints[addr] = rnbBreakpoint;
+                        if (!conditions.empty())
+                        {
+                            // The conditions refer to registers by their
+                            // 'p' packet numbers.
+                            if (g_num_reg_entries == 0)
+                                InitializeRegisters ();
+                            Breakpoint &breakpoint = m_breakpoints[addr];
+                            breakpoint.m_conditions.swap (conditions);
+                            DNBBreakpointSetCallback (pid, break_id, BreakpointConditionsSayStop, &breakpoint);
+                        }
                         return SendPacket ("OK");
                     }
                     else
@@ -3053,6 +4013,18 @@ RNBRemote::HandlePacket_z (const char *p)
                     // We do already have a watchpoint at this address, increment
                     // its reference count and return OK
                     pos->second.Retain();
+
+                    // Stop when any of the users of the watchpoint wants
+                    // us to, like we do for breakpoints.
+                    if (pos->second.m_conditions.empty() || conditions.empty())
+                    {
+                        pos->second.m_conditions.clear();
+                        DNBWatchpointSetCallback (pid, pos->second.BreakID(), NULL, NULL);
+                    }
+                    else
+                    {
+                        pos->second.m_conditions.insert (pos->second.m_conditions.end(), conditions.begin(), conditions.end());
+                    }
                     return SendPacket ("OK");
                 }
                 else
@@ -3067,6 +4039,17 @@ RNBRemote::HandlePacket_z (const char *p)
                         // map.
                         Breakpoint rnbWatchpoint(watch_id);
                         m_watchpoints[addr] = rnbWatchpoint;
+                        if (!conditions.empty())
+                        {
+                            // The watchpoint is only checked after the
+                            // access on targets that report it after the
+                            // instruction runs, see MachThread::ShouldStop().
+                            if (g_num_reg_entries == 0)
+                                InitializeRegisters ();
+                            Breakpoint &watchpoint = m_watchpoints[addr];
+                            watchpoint.m_conditions.swap (conditions);
+                            DNBWatchpointSetCallback (pid, watch_id, BreakpointConditionsSayStop, &watchpoint);
+                        }
                         return SendPacket ("OK");
                     }
                     else
@@ -3356,8 +4339,7 @@ RNBRemote::HandlePacket_c (const char *p)
     thread_actions.SetDefaultThreadActionIfNeeded(eStateRunning, 0);
     if (!DNBProcessResume (pid, thread_actions.GetFirst(), thread_actions.GetSize()))
         return SendPacket ("E25");
-    // Don't send an "OK" packet; response is the stopped/exited message.
-    return rnb_success;
+    return SendResumeReply (pid);
 }
 
 rnb_err_t
@@ -3427,6 +4409,239 @@ RNBRemote::HandlePacket_MemoryRegionInfo (const char *p)
     return SendPacket (ostrm.str());
 }
 
+// The maximum number of regions we will return in one "qMemoryRegionInfos"
+// response before asking the debugger to continue with another packet
+#define MAX_REGIONS_PER_PACKET 1024
+
+rnb_err_t
+RNBRemote::HandlePacket_MemoryRegionInfos (const char *p)
+{
+    /* Return the start, size and permissions of every mapped region at
+       or above an address so the debugger can build its region map with
+       one packet instead of one "qMemoryRegionInfo" packet per lookup.
+       Memory that isn't listed isn't mapped, or has no permissions.
+
+       If the regions don't all fit in one reply, it ends with a "next"
+       key and the debugger sends another packet starting there.
+
+       Examples of use:
+          qMemoryRegionInfos:0
+          start:1000;size:2000;permissions:rx;start:3000;size:1000;permissions:rw;
+
+          qMemoryRegionInfos:0   (with more than MAX_REGIONS_PER_PACKET regions)
+          start:1000;size:2000;permissions:rx;...;next:7fff5fc00000;
+    */
+
+    p += sizeof ("qMemoryRegionInfos:") - 1;
+    errno = 0;
+    nub_addr_t addr = strtoull (p, NULL, 16);
+    if (errno != 0 && addr == 0)
+        return HandlePacket_ILLFORMED (__FILE__, __LINE__, p, "Invalid address in qMemoryRegionInfos packet");
+
+    if (!m_ctx.HasValidProcessID())
+        return SendPacket ("E70");
+    const nub_process_t pid = m_ctx.ProcessID();
+
+    std::ostringstream ostrm;
+    ostrm << std::hex;
+    uint32_t num_regions = 0;
+    while (true)
+    {
+        DNBRegionInfo region_info = { 0, 0, 0 };
+        if (DNBProcessMemoryRegionInfo (pid, addr, &region_info) != 1)
+            break;
+
+        // Unmapped memory with no region after it is reported with a byte
+        // size of 1, which means we have seen all the regions
+        if (region_info.permissions == 0 && region_info.size <= 1)
+            break;
+
+        if (region_info.permissions)
+        {
+            if (num_regions == MAX_REGIONS_PER_PACKET)
+            {
+                ostrm << "next:" << region_info.addr << ';';
+                break;
+            }
+            ostrm << "start:" << region_info.addr << ";size:" << region_info.size << ";permissions:";
+            if (region_info.permissions & eMemoryPermissionsReadable)
+                ostrm << 'r';
+            if (region_info.permissions & eMemoryPermissionsWritable)
+                ostrm << 'w';
+            if (region_info.permissions & eMemoryPermissionsExecutable)
+                ostrm << 'x';
+            ostrm << ';';
+            ++num_regions;
+        }
+
+        const nub_addr_t next_addr = region_info.addr + region_info.size;
+        if (next_addr <= addr)
+            break;
+        addr = next_addr;
+    }
+    // An empty reply means the packet isn't supported, so say "OK" if
+    // there were no regions to list
+    if (num_regions == 0)
+        return SendPacket ("OK");
+    return SendPacket (ostrm.str());
+}
+
+rnb_err_t
+RNBRemote::HandlePacket_qSearchMemory (const char *p)
+{
+    /* Search memory for the first occurrence of a byte pattern without
+       sending the memory to the debugger.  Memory that can't be read is
+       skipped.
+
+       qSearchMemory:<addr>,<length>:<hex pattern>
+
+       The reply is "1,<addr>" with the address of the first match, or
+       "0" if the pattern wasn't found.
+
+       Examples of use:
+          qSearchMemory:100000000,200000000:efbeadde
+          1,1003048a0  */
+
+    p += sizeof ("qSearchMemory:") - 1;
+    char *c;
+    errno = 0;
+    nub_addr_t addr = strtoull (p, &c, 16);
+    if ((errno != 0 && addr == 0) || *c != ',')
+        return HandlePacket_ILLFORMED (__FILE__, __LINE__, p, "Invalid address in qSearchMemory packet");
+    p = c + 1;
+    errno = 0;
+    nub_addr_t length = strtoull (p, &c, 16);
+    if ((errno != 0 && length == 0) || *c != ':')
+        return HandlePacket_ILLFORMED (__FILE__, __LINE__, p, "Invalid length in qSearchMemory packet");
+    p = c + 1;
+
+    std::vector<uint8_t> pattern;
+    while (isxdigit (p[0]) && isxdigit (p[1]))
+    {
+        char hexbuf[3] = { p[0], p[1], '\0' };
+        pattern.push_back (strtoul (hexbuf, NULL, 16));
+        p += 2;
+    }
+    if (pattern.empty() || *p != '\0')
+        return HandlePacket_ILLFORMED (__FILE__, __LINE__, p, "Invalid pattern in qSearchMemory packet");
+
+    if (!m_ctx.HasValidProcessID())
+        return SendPacket ("E70");
+    const nub_process_t pid = m_ctx.ProcessID();
+
+    // Read the range in large chunks that overlap by one byte less than
+    // the pattern so we find matches that straddle two chunks
+    const nub_size_t pattern_size = pattern.size();
+    const nub_size_t chunk_size = std::max<nub_size_t> (1024 * 1024, pattern_size * 2);
+    std::vector<uint8_t> chunk (chunk_size);
+    const nub_addr_t end_addr = addr + length < addr ? INVALID_NUB_ADDRESS : addr + length;
+    while (addr < end_addr && end_addr - addr >= pattern_size)
+    {
+        const nub_size_t read_size = std::min<nub_addr_t> (chunk_size, end_addr - addr);
+        const nub_size_t bytes_read = DNBProcessMemoryRead (pid, addr, read_size, &chunk[0]);
+        if (bytes_read >= pattern_size)
+        {
+            std::vector<uint8_t>::iterator match = std::search (chunk.begin(), chunk.begin() + bytes_read, pattern.begin(), pattern.end());
+            if (match != chunk.begin() + bytes_read)
+            {
+                std::ostringstream ostrm;
+                ostrm << "1," << std::hex << addr + (match - chunk.begin());
+                return SendPacket (ostrm.str());
+            }
+        }
+
+        if (bytes_read == read_size)
+        {
+            if (end_addr - addr == read_size)
+                break;
+            addr += bytes_read - (pattern_size - 1);
+        }
+        else
+        {
+            // Skip to the next page, or to the end of the unreadable
+            // region if we know where that is
+            const nub_addr_t unreadable_addr = addr + bytes_read;
+            nub_addr_t next_addr = (unreadable_addr + 0x1000) & ~((nub_addr_t)0xfff);
+            DNBRegionInfo region_info = { 0, 0, 0 };
+            if (DNBProcessMemoryRegionInfo (pid, unreadable_addr, &region_info) == 1 &&
+                (region_info.permissions & eMemoryPermissionsReadable) == 0 &&
+                region_info.addr + region_info.size > next_addr)
+                next_addr = region_info.addr + region_info.size;
+            if (next_addr <= addr)
+                break;
+            addr = next_addr;
+        }
+    }
+    return SendPacket ("0");
+}
+
+rnb_err_t
+RNBRemote::HandlePacket_qMultiMemRead (const char *p)
+{
+    /* Read several ranges of memory with one packet so the debugger
+       doesn't pay a round trip for each small object it reads.
+
+       qMultiMemRead:<addr>,<length>;<addr>,<length>;...
+
+       The reply is the number of bytes that could be read from each
+       range followed by all of the bytes as hex:
+       "<count>,<count>,...;<hex bytes>"
+
+       Examples of use:
+          qMultiMemRead:100001000,4;100002000,8;
+          4,8;cffaedfe0700000103000080  */
+
+    p += sizeof ("qMultiMemRead:") - 1;
+    std::vector<DNBMemoryRange> ranges;
+    nub_size_t total_size = 0;
+    while (*p != '\0')
+    {
+        char *c;
+        errno = 0;
+        nub_addr_t addr = strtoull (p, &c, 16);
+        if ((errno != 0 && addr == 0) || *c != ',')
+            return HandlePacket_ILLFORMED (__FILE__, __LINE__, p, "Invalid address in qMultiMemRead packet");
+        p = c + 1;
+        errno = 0;
+        nub_size_t length = strtoull (p, &c, 16);
+        if ((errno != 0 && length == 0) || *c != ';')
+            return HandlePacket_ILLFORMED (__FILE__, __LINE__, p, "Invalid length in qMultiMemRead packet");
+        p = c + 1;
+        DNBMemoryRange range = { addr, length };
+        ranges.push_back (range);
+        total_size += length;
+    }
+    if (ranges.empty())
+        return HandlePacket_ILLFORMED (__FILE__, __LINE__, p, "No ranges in qMultiMemRead packet");
+
+    if (!m_ctx.HasValidProcessID())
+        return SendPacket ("E70");
+    const nub_process_t pid = m_ctx.ProcessID();
+
+    // Don't let a single request make us allocate an unreasonable
+    // amount of memory
+    if (total_size > 4 * 1024 * 1024)
+        return SendPacket ("E71");
+
+    // Read the pages of all the ranges at once, then copy each range
+    DNBProcessMemoryPrefetch (pid, &ranges[0], ranges.size());
+    std::vector<uint8_t> buf (total_size > 0 ? total_size : 1);
+    std::vector<nub_size_t> counts (ranges.size());
+    nub_size_t offset = 0;
+    for (size_t i = 0; i < ranges.size(); ++i)
+    {
+        counts[i] = ranges[i].size > 0 ? DNBProcessMemoryRead (pid, ranges[i].addr, ranges[i].size, &buf[offset]) : 0;
+        offset += counts[i];
+    }
+
+    std::ostringstream ostrm;
+    for (size_t i = 0; i < counts.size(); ++i)
+        ostrm << std::hex << counts[i] << (i + 1 < counts.size() ? ',' : ';');
+    if (offset > 0)
+        append_hex_value (ostrm, &buf[0], offset, false);
+    return SendPacket (ostrm.str());
+}
+
 rnb_err_t
 RNBRemote::HandlePacket_WatchpointSupportInfo (const char *p)
 {
@@ -3492,8 +4707,7 @@ RNBRemote::HandlePacket_C (const char *p)
         return SendPacket ("E52");
     if (!DNBProcessResume (pid, thread_actions.GetFirst(), thread_actions.GetSize()))
         return SendPacket ("E38");
-    /* Don't send an "OK" packet; response is the stopped/exited message.  */
-    return rnb_success;
+    return SendResumeReply (pid);
 }
 
 //----------------------------------------------------------------------
@@ -3525,7 +4739,7 @@ RNBRemote::HandlePacket_k (const char *p)
 rnb_err_t
 RNBRemote::HandlePacket_stop_process (const char *p)
 {
-    DNBProcessSignal (m_ctx.ProcessID(), SIGSTOP);
+    DNBProcessInterrupt (m_ctx.ProcessID());
     //DNBProcessSignal (m_ctx.ProcessID(), SIGINT);
     // Do not send any response packet! Wait for the stop reply packet to naturally happen
     return rnb_success;
@@ -3556,8 +4770,7 @@ RNBRemote::HandlePacket_s (const char *p)
     thread_actions.SetDefaultThreadActionIfNeeded (eStateStopped, 0);
     if (!DNBProcessResume (pid, thread_actions.GetFirst(), thread_actions.GetSize()))
         return SendPacket ("E49");
-    // Don't send an "OK" packet; response is the stopped/exited message.
-    return rnb_success;
+    return SendResumeReply (pid);
 }
 
 /* 'S sig [;addr]'
@@ -3607,8 +4820,7 @@ RNBRemote::HandlePacket_S (const char *p)
     if (!DNBProcessResume (pid, thread_actions.GetFirst(), thread_actions.GetSize()))
         return SendPacket ("E39");
 
-    // Don't send an "OK" packet; response is the stopped/exited message.
-    return rnb_success;
+    return SendResumeReply (pid);
 }
 
 rnb_err_t
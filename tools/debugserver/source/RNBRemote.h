@@ -53,6 +53,7 @@ public:
         signal_and_step_inf_one_cycle,  // 'I'
         kill,                           // 'k'
         read_memory,                    // 'm'
+        read_memory_binary,             // 'x'
         write_memory,                   // 'M'
         read_register,                  // 'p'
         write_register,                 // 'P'
@@ -86,17 +87,23 @@ public:
         query_thread_ids_subsequent,    // 'qsThreadInfo'
         query_thread_extra_info,        // 'qThreadExtraInfo'
         query_thread_stop_info,         // 'qThreadStopInfo'
+        query_threads_stop_info,        // 'qThreadsStopInfo'
         query_image_offsets,            // 'qOffsets'
         query_symbol_lookup,            // 'gSymbols'
         query_launch_success,           // 'qLaunchSuccess'
         query_register_info,            // 'qRegisterInfo'
         query_shlib_notify_info_addr,   // 'qShlibInfoAddr'
+        query_shlib_infos,              // 'qShlibInfos:'
         query_step_packet_supported,    // 'qStepPacketSupported'
         query_vattachorwait_supported,  // 'qVAttachOrWaitSupported'
         query_sync_thread_state_supported,// 'QSyncThreadState'
+        query_breakpoint_conditions_supported,// 'qBreakpointConditionsSupported'
         query_host_info,                // 'qHostInfo'
+        query_supported,                // 'qSupported'
         pass_signals_to_inferior,       // 'QPassSignals'
         start_noack_mode,               // 'QStartNoAckMode'
+        enable_compression,             // 'QEnableCompression:'
+        start_shared_memory,            // 'QStartSharedMemory:'
         prefix_reg_packets_with_tid,    // 'QPrefixRegisterPacketsWithThreadID
         set_logging_mode,               // 'QSetLogging:'
         set_max_packet_size,            // 'QSetMaxPacketSize:'
@@ -111,7 +118,13 @@ public:
         set_working_dir,                // 'QSetWorkingDir:'
         set_list_threads_in_stop_reply, // 'QListThreadsInStopReply:'
         sync_thread_state,              // 'QSyncThreadState:'
+        set_non_stop,                   // 'QNonStop:'
+        non_stop_stopped,               // 'vStopped'
+        set_enable_async_profiling,     // 'QSetEnableAsyncProfiling;'
+        memory_region_infos,            // 'qMemoryRegionInfos:'
         memory_region_info,             // 'qMemoryRegionInfo:'
+        search_memory,                  // 'qSearchMemory:'
+        multi_memory_read,              // 'qMultiMemRead:'
         watchpoint_support_info,        // 'qWatchpointSupportInfo:'
         allocate_memory,                // '_M'
         deallocate_memory,              // '_m'
@@ -159,6 +172,7 @@ public:
     void            StopReadRemoteDataThread ();
 
     void NotifyThatProcessStopped (void);
+    void NotifyThatThreadsStopped (void);
 
     rnb_err_t HandlePacket_A (const char *p);
     rnb_err_t HandlePacket_H (const char *p);
@@ -167,14 +181,20 @@ public:
     rnb_err_t HandlePacket_qLaunchSuccess (const char *p);
     rnb_err_t HandlePacket_qRegisterInfo (const char *p);
     rnb_err_t HandlePacket_qShlibInfoAddr (const char *p);
+    rnb_err_t HandlePacket_qShlibInfos (const char *p);
     rnb_err_t HandlePacket_qStepPacketSupported (const char *p);
     rnb_err_t HandlePacket_qVAttachOrWaitSupported (const char *p);
     rnb_err_t HandlePacket_qSyncThreadStateSupported (const char *p);
+    rnb_err_t HandlePacket_qBreakpointConditionsSupported (const char *p);
     rnb_err_t HandlePacket_qThreadInfo (const char *p);
     rnb_err_t HandlePacket_qThreadExtraInfo (const char *p);
     rnb_err_t HandlePacket_qThreadStopInfo (const char *p);
+    rnb_err_t HandlePacket_qThreadsStopInfo (const char *p);
     rnb_err_t HandlePacket_qHostInfo (const char *p);
+    rnb_err_t HandlePacket_qSupported (const char *p);
     rnb_err_t HandlePacket_QStartNoAckMode (const char *p);
+    rnb_err_t HandlePacket_QEnableCompression (const char *p);
+    rnb_err_t HandlePacket_QStartSharedMemory (const char *p);
     rnb_err_t HandlePacket_QThreadSuffixSupported (const char *p);
     rnb_err_t HandlePacket_QSetLogging (const char *p);
     rnb_err_t HandlePacket_QSetDisableASLR (const char *p);
@@ -187,9 +207,13 @@ public:
     rnb_err_t HandlePacket_QLaunchArch (const char *p);
     rnb_err_t HandlePacket_QListThreadsInStopReply (const char *p);
     rnb_err_t HandlePacket_QSyncThreadState (const char *p);
+    rnb_err_t HandlePacket_QNonStop (const char *p);
+    rnb_err_t HandlePacket_vStopped (const char *p);
+    rnb_err_t HandlePacket_QSetEnableAsyncProfiling (const char *p);
     rnb_err_t HandlePacket_QPrefixRegisterPacketsWithThreadID (const char *p);
     rnb_err_t HandlePacket_last_signal (const char *p);
     rnb_err_t HandlePacket_m (const char *p);
+    rnb_err_t HandlePacket_x (const char *p);
     rnb_err_t HandlePacket_M (const char *p);
     rnb_err_t HandlePacket_X (const char *p);
     rnb_err_t HandlePacket_g (const char *p);
@@ -210,15 +234,22 @@ public:
     rnb_err_t HandlePacket_AllocateMemory (const char *p);
     rnb_err_t HandlePacket_DeallocateMemory (const char *p);
     rnb_err_t HandlePacket_MemoryRegionInfo (const char *p);
+    rnb_err_t HandlePacket_MemoryRegionInfos (const char *p);
+    rnb_err_t HandlePacket_qSearchMemory (const char *p);
+    rnb_err_t HandlePacket_qMultiMemRead (const char *p);
     rnb_err_t HandlePacket_WatchpointSupportInfo (const char *p);
 
     rnb_err_t HandlePacket_stop_process (const char *p);
 
     rnb_err_t SendStopReplyPacketForThread (nub_thread_t tid);
+    rnb_err_t SendNotification (const std::string &s);
+    rnb_err_t SendResumeReply (nub_process_t pid);
+    bool AppendStopReplyForThread (std::ostream &ostrm, nub_process_t pid, nub_thread_t tid, bool include_process_info);
     rnb_err_t SendHexEncodedBytePacket (const char *header, const void *buf, size_t buf_len, const char *footer);
     rnb_err_t SendSTDOUTPacket (char *buf, nub_size_t buf_size);
     rnb_err_t SendSTDERRPacket (char *buf, nub_size_t buf_size);
     void      FlushSTDIO ();
+    void      SendAsyncProfileData ();
 
     RNBContext&     Context() { return m_ctx; }
     RNBSocket&      Comm() { return m_comm; }
@@ -298,19 +329,25 @@ protected:
     {
         Breakpoint(nub_break_t breakID) :
             m_breakID(breakID),
-            m_refCount(1)
+            m_refCount(1),
+            m_conditions(),
+            m_filteredHits(0)
         {
         }
 
         Breakpoint() :
             m_breakID(INVALID_NUB_BREAK_ID),
-            m_refCount(0)
+            m_refCount(0),
+            m_conditions(),
+            m_filteredHits(0)
         {
         }
 
         Breakpoint(const Breakpoint& rhs) :
             m_breakID(rhs.m_breakID),
-            m_refCount(rhs.m_refCount)
+            m_refCount(rhs.m_refCount),
+            m_conditions(rhs.m_conditions),
+            m_filteredHits(rhs.m_filteredHits)
         {
         }
 
@@ -321,7 +358,12 @@ protected:
 
         nub_break_t m_breakID;
         uint32_t m_refCount;
+        std::vector<std::string> m_conditions; // Agent expression bytecodes, stop if any is true (stop always if empty)
+        volatile uint32_t m_filteredHits;       // Hits the conditions were false for that we haven't reported yet
     };
+
+    static nub_bool_t BreakpointConditionsSayStop (nub_process_t pid, nub_thread_t tid, nub_break_t breakID, void *baton);
+
     typedef std::map<nub_addr_t, Breakpoint> BreakpointMap;
     typedef BreakpointMap::iterator          BreakpointMapIter;
     typedef BreakpointMap::const_iterator    BreakpointMapConstIter;
@@ -339,6 +381,7 @@ protected:
     BreakpointMap   m_breakpoints;
     BreakpointMap   m_watchpoints;
     uint32_t        m_max_payload_size;  // the maximum sized payload we should send to gdb
+    uint32_t        m_compression_min_size; // run-length encode packets we send that are at least this big, zero for never
     bool            m_extended_mode;   // are we in extended mode?
     bool            m_noack_mode;      // are we in no-ack mode?
     bool            m_use_native_regs; // Use native registers by querying DNB layer for register definitions?
@@ -348,6 +391,7 @@ protected:
                                                                 // "$g;thread:TTTT" instead of "$g"
                                                                 // "$GVVVVVVVVVVVVVV;thread:TTTT;#00 instead of "$GVVVVVVVVVVVVVV"
     bool            m_list_threads_in_stop_reply;
+    bool            m_non_stop_notification_pending; // A "%Stop" notification was sent and the client hasn't drained the stops with "vStopped" yet
 };
 
 /* We translate the /usr/include/mach/exception_types.h exception types
@@ -368,5 +412,8 @@ protected:
    how many bytes gdb can *receive* from debugserver -- it tells us nothing
    about how many bytes gdb might try to send in a single packet.  */
 #define DEFAULT_GDB_REMOTE_PROTOCOL_BUFSIZE 399
+/* The largest packet we say we can take in our qSupported reply. Clients
+   size their memory reads and writes by this.  */
+#define DEBUGSERVER_MAX_PACKET_SIZE (256 * 1024)
 
 #endif // #ifndef __RNBRemote_h__
@@ -19,6 +19,7 @@
 #include <netinet/in.h>
 #include <netinet/tcp.h>
 #include <termios.h>
+#include <unistd.h>
 #include "DNBLog.h"
 #include "DNBError.h"
 
@@ -238,6 +239,10 @@ RNBSocket::Disconnect (bool save_errno)
     if (m_fd_from_lockdown)
         m_fd_from_lockdown = false;
 #endif
+    // The read thread may still be in the shared memory, it is unmapped
+    // when this object goes away
+    m_shm_reading = false;
+    m_shm_writing = false;
     return ClosePort (m_fd, save_errno);
 }
 
@@ -254,27 +259,47 @@ RNBSocket::Read (std::string &p)
     if (m_fd == -1)
         return rnb_err;
 
-    //DNBLogThreadedIf(LOG_RNB_COMM, "%8u RNBSocket::%s calling read()", (uint32_t)m_timer.ElapsedMicroSeconds(true), __FUNCTION__);
-    DNBError err;
-    int bytesread = read (m_fd, buf, sizeof (buf));
-    if (bytesread <= 0)
-        err.SetError(errno, DNBError::POSIX);
-    else
-        p.append(buf, bytesread);
+    while (true)
+    {
+        if (m_shm_reading)
+        {
+            size_t shm_bytes;
+            while ((shm_bytes = m_shm.Read (buf, sizeof (buf))) > 0)
+                p.append(buf, shm_bytes);
+            if (!p.empty())
+                break;
+            if (!m_shm.PrepareToWait())
+                continue;
+        }
 
-    if (err.Fail() || DNBLogCheckLogBit(LOG_RNB_COMM))
-        err.LogThreaded("::read ( %i, %p, %zu ) => %i", m_fd, buf, sizeof (buf), bytesread);
+        //DNBLogThreadedIf(LOG_RNB_COMM, "%8u RNBSocket::%s calling read()", (uint32_t)m_timer.ElapsedMicroSeconds(true), __FUNCTION__);
+        DNBError err;
+        int bytesread = read (m_fd, buf, sizeof (buf));
+        if (bytesread <= 0)
+            err.SetError(errno, DNBError::POSIX);
 
-    // Our port went away - we have to mark this so IsConnected will return the truth.
-    if (bytesread == 0)
-    {
-        m_fd = -1;
-        return rnb_not_connected;
-    }
-    else if (bytesread == -1)
-    {
-        m_fd = -1;
-        return rnb_err;
+        if (err.Fail() || DNBLogCheckLogBit(LOG_RNB_COMM))
+            err.LogThreaded("::read ( %i, %p, %zu ) => %i", m_fd, buf, sizeof (buf), bytesread);
+
+        // Our port went away - we have to mark this so IsConnected will return the truth.
+        if (bytesread == 0)
+        {
+            m_fd = -1;
+            return rnb_not_connected;
+        }
+        else if (bytesread == -1)
+        {
+            m_fd = -1;
+            return rnb_err;
+        }
+
+        // Once the packets go through shared memory, the bytes on the
+        // socket are only there to wake us up
+        if (!m_shm_reading)
+        {
+            p.append(buf, bytesread);
+            break;
+        }
     }
     // Strip spaces from the end of the buffer
     while (!p.empty() && isspace (p[p.size() - 1]))
@@ -291,6 +316,9 @@ RNBSocket::Write (const void *buffer, size_t length)
     if (m_fd == -1)
         return rnb_err;
 
+    if (m_shm_writing)
+        return WriteSharedMemory (buffer, length);
+
     DNBError err;
     int bytessent = write (m_fd, buffer, length);
     if (bytessent < 0)
@@ -312,6 +340,60 @@ RNBSocket::Write (const void *buffer, size_t length)
 }
 
 
+rnb_err_t
+RNBSocket::OpenSharedMemory (const char *name)
+{
+    if (m_fd == -1 || !m_shm.Open (name))
+    {
+        DNBLogThreadedIf(LOG_RNB_COMM, "RNBSocket::%s (\"%s\") failed to map the shared memory", __FUNCTION__, name);
+        return rnb_err;
+    }
+    __sync_synchronize ();
+    m_shm_reading = true;
+    return rnb_success;
+}
+
+void
+RNBSocket::StartWritingSharedMemory ()
+{
+    __sync_synchronize ();
+    m_shm_writing = true;
+}
+
+rnb_err_t
+RNBSocket::WriteSharedMemory (const void *buffer, size_t length)
+{
+    PThreadMutex::Locker locker (m_shm_write_mutex);
+    size_t total_written = 0;
+    while (total_written < length)
+    {
+        const size_t bytes_written = m_shm.Write ((const uint8_t *)buffer + total_written, length - total_written);
+        total_written += bytes_written;
+        if (bytes_written > 0 && m_shm.ShouldWakeReader())
+        {
+            const char wake_up_byte = '\0';
+            if (write (m_fd, &wake_up_byte, 1) != 1)
+            {
+                DNBError err;
+                err.SetError(errno, DNBError::POSIX);
+                err.LogThreaded("::write ( socket = %i, wake up byte ) failed", m_fd);
+                return rnb_err;
+            }
+        }
+        // Give lldb a chance to empty the ring if it is full
+        if (total_written < length)
+        {
+            if (m_fd == -1)
+                return rnb_not_connected;
+            usleep (50);
+        }
+    }
+
+    DNBLogThreadedIf(LOG_RNB_PACKETS, "putpkt: %*s", (int)length, (char *)buffer);   // All data is string based in debugserver, so this is safe
+    DNBLogThreadedIf(LOG_RNB_COMM, "sent: %*s", (int)length, (char *)buffer);
+    return rnb_success;
+}
+
 rnb_err_t
 RNBSocket::ClosePort (int& fd, bool save_errno)
 {
@@ -19,6 +19,8 @@
 #include <sys/types.h>
 #include <string>
 #include "DNBTimer.h"
+#include "PThreadMutex.h"
+#include "Utility/SharedMemoryTransport.h"
 
 class RNBSocket
 {
@@ -30,7 +32,11 @@ public:
 #ifdef WITH_LOCKDOWN
         m_fd_from_lockdown (false),
 #endif
-        m_timer (true)      // Make a thread safe timer
+        m_timer (true),     // Make a thread safe timer
+        m_shm (),
+        m_shm_write_mutex (),
+        m_shm_reading (false),
+        m_shm_writing (false)
     {
     }
     ~RNBSocket (void)
@@ -51,6 +57,13 @@ public:
     rnb_err_t Read (std::string &p);
     rnb_err_t Write (const void *buffer, size_t length);
 
+    // Map the shared memory region lldb made and read from it from now
+    // on, the socket only wakes us up. Writes go through it once
+    // StartWritingSharedMemory() is called, which is after the reply
+    // that tells lldb to switch over.
+    rnb_err_t OpenSharedMemory (const char *name);
+    void StartWritingSharedMemory ();
+
     bool IsConnected () const { return m_fd != -1; }
     void SaveErrno (int curr_errno);
     DNBTimer& Timer() { return m_timer; }
@@ -62,6 +75,7 @@ private:
 
 protected:
     rnb_err_t ClosePort (int& fd, bool save_errno);
+    rnb_err_t WriteSharedMemory (const void *buffer, size_t length);
 
     int m_fd;    // Socket we use to communicate once conn established
 
@@ -70,6 +84,11 @@ protected:
 #endif
 
     DNBTimer m_timer;
+
+    SharedMemoryTransport m_shm;
+    PThreadMutex m_shm_write_mutex;
+    volatile bool m_shm_reading;
+    volatile bool m_shm_writing;
 };
 
 
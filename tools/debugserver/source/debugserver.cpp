@@ -444,6 +444,7 @@ HandleProcessStateChange (RNBRemote *remote, bool initialize)
                 if (pid_stop_count_changed)
                 {
                     remote->FlushSTDIO();
+                    remote->SendAsyncProfileData();
 
                     if (ctx.GetProcessStopCount() == 1)
                     {
@@ -498,8 +499,8 @@ RNBRunLoopInferiorExecuting (RNBRemote *remote)
 
         if (!ctx.ProcessStateRunning())
         {
-            // Clear the stdio bits if we are not running so we don't send any async packets
-            event_mask &= ~RNBContext::event_proc_stdio_available;
+            // Clear the stdio and profile bits if we are not running so we don't send any async packets
+            event_mask &= ~(RNBContext::event_proc_stdio_available | RNBContext::event_proc_profile_data);
         }
 
         // We want to make sure we consume all process state changes and have
@@ -519,13 +520,20 @@ RNBRunLoopInferiorExecuting (RNBRemote *remote)
                 remote->FlushSTDIO();
             }
 
+            if (set_events & RNBContext::event_proc_profile_data)
+            {
+                remote->SendAsyncProfileData();
+            }
+
             if (set_events & RNBContext::event_read_packet_available)
             {
                 // handleReceivedPacket will take care of resetting the
                 // event_read_packet_available events when there are no more...
                 set_events ^= RNBContext::event_read_packet_available;
 
-                if (ctx.ProcessStateRunning())
+                // In non-stop mode the stopped threads can be looked at and
+                // resumed while the rest of the process runs
+                if (ctx.ProcessStateRunning() && !DNBProcessGetNonStopMode (ctx.ProcessID()))
                 {
                     if (remote->HandleAsyncPacket() == rnb_not_connected)
                     {
@@ -541,6 +549,13 @@ RNBRunLoopInferiorExecuting (RNBRemote *remote)
                 }
             }
 
+            if (set_events & RNBContext::event_proc_threads_stopped)
+            {
+                remote->NotifyThatThreadsStopped ();
+                ctx.Events().ResetEvents(RNBContext::event_proc_threads_stopped);
+                set_events ^= RNBContext::event_proc_threads_stopped;
+            }
+
             if (set_events & RNBContext::event_proc_state_changed)
             {
                 mode = HandleProcessStateChange (remote, false);
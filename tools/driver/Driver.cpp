@@ -20,6 +20,7 @@
 #include <limits.h>
 #include <fcntl.h>
 
+#include "DriverBatch.h"
 #include "IOChannel.h"
 #include "lldb/API/SBBreakpoint.h"
 #include "lldb/API/SBCommandInterpreter.h"
@@ -70,6 +71,14 @@ Driver::GetCrashLogFilename() const
     return m_option_data.m_crash_log.c_str();
 }
 
+const char *
+Driver::GetBatchFilename() const
+{
+    if (m_option_data.m_batch_file.empty())
+        return NULL;
+    return m_option_data.m_batch_file.c_str();
+}
+
 lldb::ScriptLanguage
 Driver::GetScriptLanguage() const
 {
@@ -313,6 +322,32 @@ Driver::MainLoop ()
 	SBDebugger::Destroy (m_debugger);
 }
 
+void
+Driver::RunBatch ()
+{
+    m_debugger = SBDebugger::Create(false);
+    m_debugger.SetErrorFileHandle (stderr, false);
+    m_debugger.SetOutputFileHandle (stdout, false);
+
+    const char *batch_file = GetBatchFilename();
+    FILE *in = ::strcmp (batch_file, "-") == 0 ? stdin : ::fopen (batch_file, "r");
+    if (in == NULL)
+    {
+        ::fprintf (stderr, "error: unable to open '%s'\n", batch_file);
+    }
+    else
+    {
+        // The symbolicator deletes its targets when it goes out of scope,
+        // which has to happen before the debugger is destroyed.
+        BatchSymbolicator symbolicator (m_debugger, GetFilename(), m_option_data.m_batch_workers);
+        SBError error;
+        if (!symbolicator.Run (in, stdout, error))
+            ::fprintf (stderr, "error: %s\n", error.GetCString());
+        if (in != stdin)
+            ::fclose (in);
+    }
+    SBDebugger::Destroy (m_debugger);
+}
 
 void
 Driver::ReadyForCommand ()
@@ -356,7 +391,10 @@ main (int argc, char const *argv[], const char *envp[])
         }
         else if (!exit)
         {
-            driver.Initialize();
+            if (driver.GetBatchFilename())
+                driver.RunBatch();
+            else
+                driver.Initialize();
         }
     }
 
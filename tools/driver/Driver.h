@@ -54,6 +54,9 @@ public:
     void
     MainLoop ();
 
+    void
+    RunBatch ();
+
     void
     PutSTDIN (const char *src, size_t src_len);
 
@@ -78,6 +81,9 @@ public:
     const char *
     GetCrashLogFilename() const;
 
+    const char *
+    GetBatchFilename() const;
+
     const char *
     GetArchName() const;
 
@@ -109,6 +115,8 @@ public:
         lldb::ScriptLanguage m_script_lang;
         std::string m_core_file;
         std::string m_crash_log;
+        std::string m_batch_file;       // Crash logs and core files to symbolicate with --batch
+        uint32_t m_batch_workers;
         std::vector<std::string> m_source_command_files;
         bool m_debug_mode;
         bool m_print_version;
@@ -0,0 +1,528 @@
+//===-- DriverBatch.cpp -----------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "DriverBatch.h"
+
+#ifdef _WIN32
+#include "lldb/lldb-windows.h"
+#endif
+
+#include <ctype.h>
+#include <limits.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+
+#include "lldb/API/SBAddress.h"
+#include "lldb/API/SBFileSpec.h"
+#include "lldb/API/SBFrame.h"
+#include "lldb/API/SBFunction.h"
+#include "lldb/API/SBHostOS.h"
+#include "lldb/API/SBLineEntry.h"
+#include "lldb/API/SBListener.h"
+#include "lldb/API/SBModule.h"
+#include "lldb/API/SBProcess.h"
+#include "lldb/API/SBSection.h"
+#include "lldb/API/SBStream.h"
+#include "lldb/API/SBSymbol.h"
+#include "lldb/API/SBSymbolContext.h"
+#include "lldb/API/SBSymbolContextList.h"
+#include "lldb/API/SBThread.h"
+
+using namespace lldb;
+
+// How many jobs are read in for each worker before the results of those
+// jobs are written out. This bounds the memory that is used for the
+// results while still keeping all workers busy.
+#define BATCH_JOBS_PER_WORKER 16
+
+// The most frames that are shown for each thread of a core file.
+#define BATCH_MAX_CORE_FRAMES 256
+
+static void
+AppendFormat (std::string &s, const char *format, ...)
+{
+    char buf[1024];
+    va_list args;
+    va_start (args, format);
+    int len = ::vsnprintf (buf, sizeof(buf), format, args);
+    va_end (args);
+    if (len < 0)
+        return;
+    if ((size_t)len < sizeof(buf))
+    {
+        s.append (buf, len);
+    }
+    else
+    {
+        std::vector<char> big_buf (len + 1);
+        va_start (args, format);
+        ::vsnprintf (&big_buf[0], big_buf.size(), format, args);
+        va_end (args);
+        s.append (&big_buf[0], len);
+    }
+}
+
+static bool
+ReadFileContents (const char *path, size_t max_size, std::string &contents)
+{
+    FILE *file = ::fopen (path, "rb");
+    if (file == NULL)
+        return false;
+    char buf[8192];
+    while (contents.size() < max_size)
+    {
+        const size_t bytes_read = ::fread (buf, 1, std::min<size_t> (sizeof(buf), max_size - contents.size()), file);
+        if (bytes_read == 0)
+            break;
+        contents.append (buf, bytes_read);
+    }
+    ::fclose (file);
+    return true;
+}
+
+static bool
+IsCoreFile (const std::string &header)
+{
+    if (header.size() < 4)
+        return false;
+    const unsigned char *magic = (const unsigned char *)header.data();
+    // ELF
+    if (magic[0] == 0x7f && magic[1] == 'E' && magic[2] == 'L' && magic[3] == 'F')
+        return true;
+    // Mach-O, 32 and 64 bit, either byte order
+    if ((magic[0] == 0xfe && magic[1] == 0xed && magic[2] == 0xfa && (magic[3] == 0xce || magic[3] == 0xcf)) ||
+        ((magic[0] == 0xce || magic[0] == 0xcf) && magic[1] == 0xfa && magic[2] == 0xed && magic[3] == 0xfe))
+        return true;
+    return false;
+}
+
+static const char *
+ParseHexAddress (const char *p, uint64_t &addr)
+{
+    if (p[0] != '0' || (p[1] != 'x' && p[1] != 'X'))
+        return NULL;
+    char *end = NULL;
+    addr = ::strtoull (p, &end, 16);
+    if (end == p + 2)
+        return NULL;
+    return end;
+}
+
+//----------------------------------------------------------------------
+// Parse a crash log frame line like:
+//
+//   "3   libsystem_c.dylib   0x00007fff8a8d7d0d abort + 129"
+//
+// and get the frame index, the address, and the offset in the line just
+// past the address.
+//----------------------------------------------------------------------
+static bool
+ParseFrameLine (const std::string &line, uint32_t &frame_idx, uint64_t &addr, size_t &addr_end)
+{
+    const char *start = line.c_str();
+    const char *p = start;
+    if (!isdigit(*p))
+        return false;
+    frame_idx = 0;
+    while (isdigit(*p))
+        frame_idx = frame_idx * 10 + (*p++ - '0');
+    if (!isspace(*p))
+        return false;
+    while (isspace(*p))
+        ++p;
+    // The image name
+    if (*p == '\0')
+        return false;
+    while (*p && !isspace(*p))
+        ++p;
+    while (isspace(*p))
+        ++p;
+    p = ParseHexAddress (p, addr);
+    if (p == NULL)
+        return false;
+    addr_end = p - start;
+    return true;
+}
+
+//----------------------------------------------------------------------
+// Parse a line from the "Binary Images:" section of a crash log like:
+//
+//   "0x100000000 - 0x100000ff7 +a.out (??? - ???) <UUID> /tmp/a.out"
+//
+// and get the address the image was loaded at and its path.
+//----------------------------------------------------------------------
+static bool
+ParseImageLine (const std::string &line, uint64_t &load_addr, std::string &path)
+{
+    const char *p = line.c_str();
+    while (isspace(*p))
+        ++p;
+    p = ParseHexAddress (p, load_addr);
+    if (p == NULL)
+        return false;
+    while (isspace(*p) || *p == '-')
+        ++p;
+    uint64_t end_addr;
+    p = ParseHexAddress (p, end_addr);
+    if (p == NULL)
+        return false;
+    const char *slash = strchr (p, '/');
+    if (slash == NULL)
+        return false;
+    path.assign (slash);
+    while (!path.empty() && isspace(path[path.size() - 1]))
+        path.erase (path.size() - 1);
+    return true;
+}
+
+static std::string
+DescribeSymbolContext (SBTarget &target, SBSymbolContext &sc, uint64_t addr)
+{
+    std::string desc;
+    const char *name = NULL;
+    uint64_t start_addr = LLDB_INVALID_ADDRESS;
+    SBFunction function (sc.GetFunction());
+    SBSymbol symbol (sc.GetSymbol());
+    if (function.IsValid())
+    {
+        name = function.GetName();
+        start_addr = function.GetStartAddress().GetLoadAddress (target);
+    }
+    else if (symbol.IsValid())
+    {
+        name = symbol.GetName();
+        start_addr = symbol.GetStartAddress().GetLoadAddress (target);
+    }
+    if (name == NULL)
+        return desc;
+
+    desc.append (name);
+    if (start_addr != LLDB_INVALID_ADDRESS && addr > start_addr)
+        AppendFormat (desc, " + %llu", addr - start_addr);
+    SBLineEntry line_entry (sc.GetLineEntry());
+    if (line_entry.IsValid())
+    {
+        const char *filename = line_entry.GetFileSpec().GetFilename();
+        if (filename)
+            AppendFormat (desc, " (%s:%u)", filename, line_entry.GetLine());
+    }
+    return desc;
+}
+
+BatchSymbolicator::BatchSymbolicator (SBDebugger &debugger,
+                                      const char *exe_path,
+                                      uint32_t num_workers) :
+    m_debugger (debugger),
+    m_exe_path (exe_path ? exe_path : ""),
+    m_warm_target (),
+    m_num_workers (num_workers),
+    m_jobs (),
+    m_next_job (0)
+{
+    if (m_num_workers == 0)
+    {
+#if defined (_SC_NPROCESSORS_ONLN)
+        const long num_cpus = ::sysconf (_SC_NPROCESSORS_ONLN);
+        m_num_workers = num_cpus > 0 ? num_cpus : 1;
+#else
+        m_num_workers = 1;
+#endif
+    }
+}
+
+BatchSymbolicator::~BatchSymbolicator ()
+{
+    if (m_warm_target.IsValid())
+        m_debugger.DeleteTarget (m_warm_target);
+}
+
+bool
+BatchSymbolicator::Run (FILE *in, FILE *out, SBError &error)
+{
+    // Load the program and its shared libraries once, the target of each
+    // job will find them in the shared module list.
+    m_warm_target = m_debugger.CreateTarget (m_exe_path.c_str());
+    if (!m_warm_target.IsValid())
+    {
+        error.SetErrorStringWithFormat ("unable to create a target for '%s'", m_exe_path.c_str());
+        return false;
+    }
+
+    const size_t max_jobs = m_num_workers * BATCH_JOBS_PER_WORKER;
+    char line[PATH_MAX + 1];
+    bool done = false;
+    while (!done)
+    {
+        m_jobs.clear();
+        while (m_jobs.size() < max_jobs)
+        {
+            if (::fgets (line, sizeof(line), in) == NULL)
+            {
+                done = true;
+                break;
+            }
+            size_t len = strlen (line);
+            while (len > 0 && isspace(line[len - 1]))
+                line[--len] = '\0';
+            if (len == 0)
+                continue;
+            m_jobs.push_back (Job());
+            m_jobs.back().path = line;
+        }
+
+        if (m_jobs.empty())
+            break;
+
+        RunJobs ();
+
+        for (size_t i=0; i<m_jobs.size(); ++i)
+            ::fwrite (m_jobs[i].output.data(), 1, m_jobs[i].output.size(), out);
+        ::fflush (out);
+    }
+    m_jobs.clear();
+    return true;
+}
+
+void
+BatchSymbolicator::RunJobs ()
+{
+    m_next_job = 0;
+    const uint32_t num_workers = std::min<uint32_t> (m_num_workers, m_jobs.size());
+    if (num_workers <= 1)
+    {
+        WorkerThread (this);
+        return;
+    }
+
+    std::vector<lldb::thread_t> workers;
+    for (uint32_t i=0; i<num_workers; ++i)
+    {
+        lldb::thread_t worker = SBHostOS::ThreadCreate ("<lldb.driver.batch-symbolicate>", WorkerThread, this, NULL);
+        if (worker != LLDB_INVALID_HOST_THREAD)
+            workers.push_back (worker);
+    }
+    // If no worker could be started, do the work on this thread
+    if (workers.empty())
+        WorkerThread (this);
+    for (size_t i=0; i<workers.size(); ++i)
+        SBHostOS::ThreadJoin (workers[i], NULL, NULL);
+}
+
+lldb::thread_result_t
+BatchSymbolicator::WorkerThread (void *baton)
+{
+    BatchSymbolicator *symbolicator = (BatchSymbolicator *)baton;
+    while (1)
+    {
+        const uint32_t job_idx = __sync_fetch_and_add (&symbolicator->m_next_job, 1);
+        if (job_idx >= symbolicator->m_jobs.size())
+            break;
+        symbolicator->SymbolicateJob (symbolicator->m_jobs[job_idx]);
+    }
+    return 0;
+}
+
+void
+BatchSymbolicator::SymbolicateJob (Job &job)
+{
+    std::string header;
+    if (!ReadFileContents (job.path.c_str(), 4, header))
+    {
+        AppendFormat (job.output, "error: unable to open '%s'\n", job.path.c_str());
+        return;
+    }
+
+    // Every job gets its own target so that it can have its own load
+    // addresses and process. The modules come from the warm target.
+    SBTarget target (m_debugger.CreateTarget (m_exe_path.c_str()));
+    if (!target.IsValid())
+    {
+        AppendFormat (job.output, "error: unable to create a target for '%s'\n", job.path.c_str());
+        return;
+    }
+
+    if (IsCoreFile (header))
+    {
+        AppendFormat (job.output, "Core file '%s':\n", job.path.c_str());
+        SymbolicateCoreFile (target, job);
+    }
+    else
+    {
+        std::string contents;
+        ReadFileContents (job.path.c_str(), UINT32_MAX, contents);
+        AppendFormat (job.output, "Crash log '%s':\n", job.path.c_str());
+        SymbolicateCrashLog (target, contents, job);
+    }
+    job.output.append ("\n");
+
+    m_debugger.DeleteTarget (target);
+}
+
+void
+BatchSymbolicator::SymbolicateCoreFile (SBTarget &target, Job &job)
+{
+    // Nothing waits for the process events of a core file, give them to a
+    // listener that goes away with the job.
+    SBListener listener ("lldb.driver.batch-symbolicate.listener");
+    SBError error;
+    SBProcess process (target.LoadCore (listener, job.path.c_str(), error));
+    if (error.Fail() || !process.IsValid())
+    {
+        AppendFormat (job.output, "error: %s\n", error.GetCString() ? error.GetCString() : "unable to load the core file");
+        return;
+    }
+
+    SBStream strm;
+    const uint32_t num_threads = process.GetNumThreads();
+    for (uint32_t thread_idx=0; thread_idx<num_threads; ++thread_idx)
+    {
+        SBThread thread (process.GetThreadAtIndex (thread_idx));
+        char stop_desc[256];
+        if (thread.GetStopDescription (stop_desc, sizeof(stop_desc)) == 0)
+            stop_desc[0] = '\0';
+        AppendFormat (job.output, "thread #%u: tid = 0x%4.4llx", thread.GetIndexID(), thread.GetThreadID());
+        if (stop_desc[0])
+            AppendFormat (job.output, ", stop reason = %s", stop_desc);
+        job.output.append ("\n");
+
+        const uint32_t num_frames = std::min<uint32_t> (thread.GetNumFrames(), BATCH_MAX_CORE_FRAMES);
+        for (uint32_t frame_idx=0; frame_idx<num_frames; ++frame_idx)
+        {
+            SBFrame frame (thread.GetFrameAtIndex (frame_idx));
+            strm.Clear();
+            frame.GetDescription (strm);
+            const char *frame_desc = strm.GetData();
+            const size_t frame_desc_len = strm.GetSize();
+            if (frame_desc == NULL || frame_desc_len == 0)
+                continue;
+            job.output.append ("  ");
+            job.output.append (frame_desc, frame_desc_len);
+            if (frame_desc[frame_desc_len - 1] != '\n')
+                job.output.append ("\n");
+        }
+    }
+    process.Destroy();
+}
+
+void
+BatchSymbolicator::SymbolicateCrashLog (SBTarget &target, const std::string &contents, Job &job)
+{
+    std::vector<std::string> lines;
+    size_t pos = 0;
+    while (pos < contents.size())
+    {
+        size_t eol = contents.find ('\n', pos);
+        if (eol == std::string::npos)
+            eol = contents.size();
+        size_t len = eol - pos;
+        if (len > 0 && contents[pos + len - 1] == '\r')
+            --len;
+        lines.push_back (contents.substr (pos, len));
+        pos = eol + 1;
+    }
+
+    // Every module is loaded at its file address, unless the "Binary
+    // Images:" section says where it was loaded.
+    const uint32_t num_modules = target.GetNumModules();
+    for (uint32_t i=0; i<num_modules; ++i)
+    {
+        SBModule module (target.GetModuleAtIndex (i));
+        target.SetModuleLoadAddress (module, 0);
+    }
+
+    bool in_images = false;
+    for (size_t i=0; i<lines.size(); ++i)
+    {
+        const std::string &line = lines[i];
+        if (line.compare (0, 14, "Binary Images:") == 0)
+        {
+            in_images = true;
+            continue;
+        }
+        if (!in_images)
+            continue;
+        if (line.empty())
+        {
+            in_images = false;
+            continue;
+        }
+        uint64_t load_addr;
+        std::string path;
+        if (ParseImageLine (line, load_addr, path))
+        {
+            SBModule module (target.FindModule (SBFileSpec (path.c_str(), false)));
+            if (module.IsValid())
+            {
+                SBSection text_section (module.FindSection ("__TEXT"));
+                if (!text_section.IsValid() && module.GetNumSections() > 0)
+                    text_section = module.GetSectionAtIndex (0);
+                if (text_section.IsValid())
+                    target.SetModuleLoadAddress (module, load_addr - text_section.GetFileAddress());
+            }
+        }
+    }
+
+    // Symbolicate all the frames at once
+    std::vector<size_t> frame_lines;
+    std::vector<uint64_t> frame_addrs;
+    std::vector<size_t> frame_addr_ends;
+    std::vector<uint64_t> lookup_addrs;
+    for (size_t i=0; i<lines.size(); ++i)
+    {
+        uint32_t frame_idx;
+        uint64_t addr;
+        size_t addr_end;
+        if (ParseFrameLine (lines[i], frame_idx, addr, addr_end))
+        {
+            frame_lines.push_back (i);
+            frame_addrs.push_back (addr);
+            frame_addr_ends.push_back (addr_end);
+            // Frames above the first one hold return addresses, look up
+            // the call instead since it can be in a different function or
+            // on a different line.
+            lookup_addrs.push_back (frame_idx > 0 && addr > 0 ? addr - 1 : addr);
+        }
+    }
+
+    SBSymbolContextList sc_list;
+    if (!lookup_addrs.empty())
+        target.ResolveLoadAddresses (&lookup_addrs[0],
+                                     lookup_addrs.size(),
+                                     eSymbolContextModule | eSymbolContextFunction | eSymbolContextSymbol | eSymbolContextLineEntry,
+                                     sc_list);
+
+    size_t frame_pos = 0;
+    for (size_t i=0; i<lines.size(); ++i)
+    {
+        const std::string &line = lines[i];
+        if (frame_pos < frame_lines.size() && frame_lines[frame_pos] == i)
+        {
+            SBSymbolContext sc (sc_list.GetContextAtIndex (frame_pos));
+            std::string desc (DescribeSymbolContext (target, sc, frame_addrs[frame_pos]));
+            const size_t addr_end = frame_addr_ends[frame_pos];
+            ++frame_pos;
+            if (!desc.empty())
+            {
+                job.output.append (line, 0, addr_end);
+                job.output.append (" ");
+                job.output.append (desc);
+                job.output.append ("\n");
+                continue;
+            }
+        }
+        job.output.append (line);
+        job.output.append ("\n");
+    }
+}
@@ -0,0 +1,82 @@
+//===-- DriverBatch.h -------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef lldb_DriverBatch_h_
+#define lldb_DriverBatch_h_
+
+#include <stdio.h>
+
+#include <string>
+#include <vector>
+
+#include "lldb/API/SBDefines.h"
+#include "lldb/API/SBDebugger.h"
+#include "lldb/API/SBError.h"
+#include "lldb/API/SBTarget.h"
+
+//----------------------------------------------------------------------
+// Symbolicates a stream of crash logs and core files for one program.
+//
+// The program and its shared libraries are loaded once into a target
+// that lives as long as the BatchSymbolicator, which keeps the parsed
+// modules in the shared module list. Each crash log or core file gets a
+// target of its own, so it can have its own load addresses or process,
+// and finds all of its modules already parsed. Several crash logs and
+// core files are symbolicated at the same time, and the results are
+// written out in the order they were read in.
+//----------------------------------------------------------------------
+class BatchSymbolicator
+{
+public:
+    BatchSymbolicator (lldb::SBDebugger &debugger,
+                       const char *exe_path,
+                       uint32_t num_workers);
+
+    ~BatchSymbolicator ();
+
+    //------------------------------------------------------------------
+    // Read the paths of crash logs and core files, one per line, from
+    // "in" until it ends, and write what each one symbolicates to, in
+    // the same order, to "out". Returns false if the program couldn't
+    // be loaded.
+    //------------------------------------------------------------------
+    bool
+    Run (FILE *in, FILE *out, lldb::SBError &error);
+
+private:
+    struct Job
+    {
+        std::string path;
+        std::string output;
+    };
+
+    static lldb::thread_result_t
+    WorkerThread (void *baton);
+
+    void
+    RunJobs ();
+
+    void
+    SymbolicateJob (Job &job);
+
+    void
+    SymbolicateCoreFile (lldb::SBTarget &target, Job &job);
+
+    void
+    SymbolicateCrashLog (lldb::SBTarget &target, const std::string &contents, Job &job);
+
+    lldb::SBDebugger m_debugger;
+    std::string m_exe_path;
+    lldb::SBTarget m_warm_target;   // Keeps the program's modules parsed for all jobs
+    uint32_t m_num_workers;
+    std::vector<Job> m_jobs;        // The jobs being symbolicated right now
+    uint32_t m_next_job;            // The index of the next job for a worker to take
+};
+
+#endif // lldb_DriverBatch_h_
@@ -34,6 +34,15 @@
 
 using namespace lldb;
 
+// Writes command output as the command produces it, so a long listing
+// starts showing up right away
+static void
+StreamCommandOutput (const char *output, void *baton)
+{
+    IOChannel *io_channel = (IOChannel *)baton;
+    io_channel->OutWrite (output, ::strlen (output), NO_ASYNC);
+}
+
 // This function handles events that were broadcast by the process.
 void
 Driver::HandleBreakpointEvent (const SBEvent &event)
@@ -201,6 +210,8 @@ Driver::HandleIOEvent (const SBEvent &event)
         
         // We don't want the result to bypass the OutWrite function in IOChannel, as this can result in odd
         // output orderings and problems with the prompt.
+        result.SetImmediateOutputCallback (StreamCommandOutput, m_io_channel_ap.get());
+        result.SetStreamOutput (true);
         m_debugger.GetCommandInterpreter().HandleCommand (command_string, result, true);
 
         if (result.GetOutputSize() > 0)
@@ -39,10 +39,10 @@ static OptionDefinition g_options[] =
         "Prints out the usage information for the LLDB debugger." },
     { LLDB_OPT_SET_2,    true , "version"        , 'v', no_argument      , NULL,  eArgTypeNone,         
         "Prints out the current version number of the LLDB debugger." },
-    { LLDB_OPT_SET_3,    true , "arch"           , 'a', required_argument, NULL,  eArgTypeArchitecture, 
+    { LLDB_OPT_SET_3|LLDB_OPT_SET_6, true , "arch", 'a', required_argument, NULL,  eArgTypeArchitecture, 
         "Tells the debugger to use the specified architecture when starting and running the program.  <architecture> must "
         "be one of the architectures for which the program was compiled." },
-    { LLDB_OPT_SET_3,    true , "file"           , 'f', required_argument, NULL,  eArgTypeFilename,     
+    { LLDB_OPT_SET_3|LLDB_OPT_SET_6, true , "file", 'f', required_argument, NULL,  eArgTypeFilename,     
         "Tells the debugger to use the file <filename> as the program to be debugged." },
     { LLDB_OPT_SET_4,    true , "attach-name"    , 'n', required_argument, NULL,  eArgTypeProcessName,  
         "Tells the debugger to attach to a process with the given name." },
@@ -62,6 +62,13 @@ static OptionDefinition g_options[] =
         "Tells the debugger to open source files using the host's \"external editor\" mechanism." },
     { LLDB_3_TO_5,       false, "no-lldbinit"    , 'x', no_argument      , NULL,  eArgTypeNone,         
         "Do not automatically parse any '.lldbinit' files." },
+    { LLDB_OPT_SET_6,    true , "batch"          , 'b', required_argument, NULL,  eArgTypeFilename,     
+        "Tells the debugger to symbolicate the crash logs and core files named, one per line, in <filename> (or on "
+        "standard input if <filename> is '-') for the program given with --file, and then exit.  The program is "
+        "only loaded once for all of them." },
+    { LLDB_OPT_SET_6,    false, "jobs"           , 'j', required_argument, NULL,  eArgTypeCount,        
+        "The number of crash logs and core files to symbolicate at the same time in --batch mode.  Defaults to the "
+        "number of CPUs." },
     { 0,                 false, NULL             , 0  , 0                , NULL,  eArgTypeNone,         NULL }
 };
 
@@ -298,6 +305,8 @@ Driver::OptionData::OptionData () :
     m_args(),
     m_script_lang (lldb::eScriptLanguageDefault),
     m_crash_log (),
+    m_batch_file (),
+    m_batch_workers (0),
     m_source_command_files (),
     m_debug_mode (false),
     m_print_version (false),
@@ -319,6 +328,8 @@ Driver::OptionData::Clear ()
 {
     m_args.clear ();
     m_script_lang = lldb::eScriptLanguageDefault;
+    m_batch_file.erase();
+    m_batch_workers = 0;
     m_source_command_files.clear ();
     m_debug_mode = false;
     m_print_help = false;
@@ -465,6 +476,19 @@ Driver::ParseArgs (int argc, const char *argv[], FILE *out_fh, bool &exit)
                         m_option_data.m_crash_log = optarg;
                         break;
 
+                    case 'b':
+                        m_option_data.m_batch_file = optarg;
+                        break;
+
+                    case 'j':
+                        {
+                            char *remainder;
+                            m_option_data.m_batch_workers = strtoul (optarg, &remainder, 0);
+                            if (remainder == optarg || *remainder != '\0' || m_option_data.m_batch_workers == 0)
+                                error.SetErrorStringWithFormat ("invalid job count in the -j or --jobs option: '%s'", optarg);
+                        }
+                        break;
+
                     case 'e':
                         m_option_data.m_use_external_editor = true;
                         break;
@@ -566,6 +590,15 @@ Driver::ParseArgs (int argc, const char *argv[], FILE *out_fh, bool &exit)
         ::fprintf (out_fh, "%s\n", m_debugger.GetVersionString());
         exit = true;
     }
+    else if (! m_option_data.m_batch_file.empty())
+    {
+        if (m_option_data.m_args.empty())
+        {
+            error.SetErrorStringWithFormat ("--batch (-b) needs the program to symbolicate for, given with --file (-f)");
+            ShowUsage (out_fh, g_options, m_option_data);
+            exit = true;
+        }
+    }
     else if (! m_option_data.m_crash_log.empty())
     {
         // Handle crash log stuff here.